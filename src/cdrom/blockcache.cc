@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/blockcache.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+PCSX::BlockCache::BlockCache(unsigned blockSize, uint32_t blockCount, DecoderFactory&& factory, unsigned workers)
+    : m_blockSize(blockSize), m_blockCount(blockCount) {
+    if (workers == 0) workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    m_depth = workers * 2;
+    // Enough for what's being read ahead, on top of a few blocks behind the current one
+    m_slots.resize(m_depth + 8);
+    for (auto& slot : m_slots) slot.data.reset(new uint8_t[blockSize]);
+    m_decoder = factory();
+    for (unsigned i = 0; i < workers; i++) {
+        m_workers.emplace_back([this, decoder = factory()]() mutable { worker(decoder); });
+    }
+}
+
+PCSX::BlockCache::~BlockCache() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work.notify_all();
+    for (auto& worker : m_workers) worker.join();
+}
+
+PCSX::BlockCache::Slot* PCSX::BlockCache::findSlot(uint32_t block) {
+    for (auto& slot : m_slots) {
+        if ((slot.state != Slot::State::EMPTY) && (slot.block == block)) return &slot;
+    }
+    return nullptr;
+}
+
+PCSX::BlockCache::Slot* PCSX::BlockCache::claimSlot(uint32_t block) {
+    Slot* victim = nullptr;
+    for (auto& slot : m_slots) {
+        if (slot.state == Slot::State::LOADING) continue;
+        if (slot.state == Slot::State::EMPTY) {
+            victim = &slot;
+            break;
+        }
+        if (!victim || (slot.lastUse < victim->lastUse)) victim = &slot;
+    }
+    if (!victim) return nullptr;
+    victim->block = block;
+    victim->state = Slot::State::LOADING;
+    return victim;
+}
+
+void PCSX::BlockCache::scheduleAhead(uint32_t block) {
+    if (block == m_lastBlock) return;
+    m_lastBlock = block;
+    // Anything still queued was for wherever we were reading before
+    m_queue.clear();
+    for (uint32_t next = block + 1; (next <= block + m_depth) && (next < m_blockCount); next++) {
+        if (!findSlot(next)) m_queue.push_back(next);
+    }
+    if (!m_queue.empty()) m_work.notify_all();
+}
+
+bool PCSX::BlockCache::read(uint32_t block, unsigned offset, void* data, unsigned size) {
+    if ((block >= m_blockCount) || (offset + size > m_blockSize)) return false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot* slot = findSlot(block);
+    // A worker's on it already
+    while (slot && (slot->state == Slot::State::LOADING)) {
+        m_loaded.wait(lock);
+        slot = findSlot(block);
+    }
+    if (slot) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        slot = claimSlot(block);
+        if (!slot) return false;
+        lock.unlock();
+        const bool success = m_decoder(block, slot->data.get());
+        lock.lock();
+        slot->state = success ? Slot::State::READY : Slot::State::EMPTY;
+        m_loaded.notify_all();
+        if (!success) return false;
+    }
+    memcpy(data, slot->data.get() + offset, size);
+    slot->lastUse = ++m_useCounter;
+    scheduleAhead(block);
+    return true;
+}
+
+void PCSX::BlockCache::worker(Decoder& decoder) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_work.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_stop) return;
+        const uint32_t block = m_queue.front();
+        m_queue.pop_front();
+        if (findSlot(block)) continue;
+        Slot* slot = claimSlot(block);
+        if (!slot) continue;
+        lock.unlock();
+        const bool success = decoder(block, slot->data.get());
+        lock.lock();
+        slot->state = success ? Slot::State::READY : Slot::State::EMPTY;
+        slot->lastUse = ++m_useCounter;
+        m_loaded.notify_all();
+    }
+}
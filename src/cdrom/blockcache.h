@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PCSX {
+
+// Keeps the last blocks of a compressed disc image that got decoded, and has a few worker threads decode
+// the blocks following the last one that got read, so that reading sequentially mostly never has to wait
+// on decompression, and reading the rest of a block after seeking into it is free. Each thread, the one
+// calling read() included, gets its own decoder out of the factory, all made by the constructor, so they
+// can keep their own state, such as a z_stream. They still need to do their own locking around reading
+// the image.
+class BlockCache {
+  public:
+    using Decoder = std::function<bool(uint32_t block, uint8_t* data)>;
+    using DecoderFactory = std::function<Decoder()>;
+
+    // With 0 workers, picks a number based on the host's cores.
+    BlockCache(unsigned blockSize, uint32_t blockCount, DecoderFactory&& factory, unsigned workers = 0);
+    ~BlockCache();
+
+    // Copies size bytes, starting at offset within this block, into data. Only one thread at a time may
+    // call this.
+    bool read(uint32_t block, unsigned offset, void* data, unsigned size);
+
+    // How many reads were from a block that was already decoded, or that had to be decoded.
+    uint64_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+
+  private:
+    struct Slot {
+        enum class State { EMPTY, LOADING, READY } state = State::EMPTY;
+        uint32_t block = 0;
+        uint64_t lastUse = 0;
+        std::unique_ptr<uint8_t[]> data;
+    };
+
+    Slot* findSlot(uint32_t block);
+    Slot* claimSlot(uint32_t block);
+    void scheduleAhead(uint32_t block);
+    void worker(Decoder& decoder);
+
+    const unsigned m_blockSize;
+    const uint32_t m_blockCount;
+    Decoder m_decoder;
+
+    std::mutex m_mutex;
+    std::condition_variable m_loaded;
+    std::condition_variable m_work;
+    std::vector<Slot> m_slots;
+    std::deque<uint32_t> m_queue;
+    std::vector<std::thread> m_workers;
+    uint32_t m_lastBlock = ~0u;
+    uint64_t m_useCounter = 0;
+    unsigned m_depth = 0;
+    bool m_stop = false;
+
+    std::atomic<uint64_t> m_hits = 0;
+    std::atomic<uint64_t> m_misses = 0;
+};
+
+}  // namespace PCSX
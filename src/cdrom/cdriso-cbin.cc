@@ -62,7 +62,6 @@ bool PCSX::CDRIso::handlecbin(const char *isofile) {
     if (m_compr_img == NULL) goto fail_io;
 
     m_compr_img->block_shift = 0;
-    m_compr_img->current_block = (unsigned int)-1;
 
     m_compr_img->index_len = ciso_hdr.total_bytes / ciso_hdr.block_size;
     m_compr_img->index_table =
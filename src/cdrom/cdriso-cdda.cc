@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/cdriso.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define CDDA_X86
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CDDA_NEON
+#include <arm_neon.h>
+#endif
+
+// A raw sector is 147 blocks of 16 bytes, so none of the versions need a tail.
+static_assert(PCSX::IEC60908b::FRAMESIZE_RAW % 16 == 0);
+
+void PCSX::CDRIso::swapCDDAEndianness(uint8_t *sector) {
+#if defined(CDDA_X86)
+    for (unsigned i = 0; i < IEC60908b::FRAMESIZE_RAW; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sector + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sector + i), v);
+    }
+#elif defined(CDDA_NEON)
+    for (unsigned i = 0; i < IEC60908b::FRAMESIZE_RAW; i += 16) {
+        vst1q_u8(sector + i, vrev16q_u8(vld1q_u8(sector + i)));
+    }
+#else
+    for (unsigned i = 0; i < IEC60908b::FRAMESIZE_RAW; i += 2) {
+        uint8_t tmp = sector[i];
+        sector[i] = sector[i + 1];
+        sector[i + 1] = tmp;
+    }
+#endif
+}
+
+bool PCSX::CDRIso::streamCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
+    if (!canReadAhead()) return readCDDA(msf, buffer);
+    return m_cddaReadAhead->read(msf.toLBA(), buffer);
+}
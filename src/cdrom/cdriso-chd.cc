@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (C) 2022 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include "cdrom/cdriso.h"
+
+bool PCSX::CDRIso::handlechd(const char *isofile) {
+    char magic[8];
+    if ((m_cdHandle->readAt(magic, sizeof(magic), 0) != sizeof(magic)) || (memcmp(magic, "MComprHD", 8) != 0)) {
+        return false;
+    }
+
+    m_chd.reset(new CHD(m_cdHandle));
+    if (m_chd->failed()) {
+        PCSX::g_system->printf("%s: %s\n", isofile, m_chd->error());
+        m_chd.reset();
+        return false;
+    }
+
+    const auto &tracks = m_chd->tracks();
+    if (tracks.size() >= MAXTRACKS) {
+        PCSX::g_system->printf("%s: too many tracks\n", isofile);
+        m_chd.reset();
+        return false;
+    }
+
+    // The audio samples are stored big endian, and the pregaps and postgaps aren't necessarily in the image.
+    m_cddaBigEndian = true;
+    m_numtracks = tracks.size();
+    int64_t end = 0;
+    for (unsigned i = 0; i < tracks.size(); i++) {
+        const auto &track = tracks[i];
+        const uint32_t stored = track.pregapStored ? track.pregap : 0;
+        // The first track's pregap is the 2 seconds before the start of the disc, which we don't count.
+        const int64_t index1 = i == 0 ? 0 : end + track.pregap;
+        auto &ti = m_ti[i + 1];
+        ti.type = track.type == CHD::Track::Type::AUDIO ? TrackType::CDDA : TrackType::DATA;
+        ti.start = IEC60908b::MSF(index1 + 150);
+        ti.pregap = IEC60908b::MSF(i == 0 ? 0 : track.pregap);
+        ti.length = IEC60908b::MSF(track.frames - stored);
+        ti.start_offset = index1 * IEC60908b::FRAMESIZE_RAW;
+        end = index1 + track.frames - stored + track.postgap;
+        if (track.subcode) {
+            m_subChanMixed = true;
+            if (track.subcodeRaw) m_subChanRaw = true;
+        }
+    }
+    m_ti[1].handle = m_cdHandle;
+
+    return true;
+}
+
+ssize_t PCSX::CDRIso::cdread_chd(IO<File> f, unsigned int base, void *dest, int sector) {
+    const int64_t lba = int64_t(base / IEC60908b::FRAMESIZE_RAW) + sector;
+    if (lba < 0) return -1;
+    const auto &tracks = m_chd->tracks();
+
+    unsigned track = tracks.size() - 1;
+    while (track > 0) {
+        const int64_t index1 = m_ti[track + 1].start.toLBA() - 150;
+        if (lba >= index1 - int64_t(tracks[track].pregap)) break;
+        track--;
+    }
+    const auto &t = tracks[track];
+    const int64_t first = int64_t(m_ti[track + 1].start.toLBA()) - 150 - (t.pregapStored ? t.pregap : 0);
+
+    // Gaps that aren't in the image are silent, and have no subcode.
+    if ((lba < first) || (lba >= first + t.frames)) {
+        memset(dest, 0, IEC60908b::FRAMESIZE_RAW);
+        if (t.subcode) memset(m_subbuffer.raw, 0, IEC60908b::SUB_FRAMESIZE);
+        return IEC60908b::FRAMESIZE_RAW;
+    }
+
+    uint8_t frame[CHD::c_frameSize];
+    if (!m_chd->readFrame(t.firstFrame + (lba - first), frame)) return -1;
+    memcpy(dest, frame, IEC60908b::FRAMESIZE_RAW);
+    if (t.subcode) {
+        memcpy(m_subbuffer.raw, frame + IEC60908b::FRAMESIZE_RAW, IEC60908b::SUB_FRAMESIZE);
+        if (t.subcodeRaw) decodeRawSubData();
+    }
+
+    return IEC60908b::FRAMESIZE_RAW;
+}
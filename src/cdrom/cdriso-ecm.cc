@@ -19,18 +19,17 @@
 
 #include "cdrom/cdriso.h"
 #include "core/cdrom.h"
-
-static constexpr unsigned ECM_HEADER_SIZE = 4;
+#include "tracy/Tracy.hpp"
 
 /* Adapted from ecm.c:unecmify() (C) Neill Corlett */
 ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int sector) {
+    ZoneScoped;
     uint32_t b = 0, writebytecount = 0, num;
     uint32_t sectorcount = 0;
     int8_t type = 0;  // mode type 0 (META) or 1, 2 or 3 for CDROM type
     uint8_t sector_buffer[PCSX::IEC60908b::FRAMESIZE_RAW];
     // this flag tells if to decode all sectors or just skip to wanted sector
     bool processsectors = (bool)m_decoded_ecm_sectors;
-    ECMFILELUT *pos = &(m_ecm_savetable[0]);  // points always to beginning of ECM DATA
 
     // If not pointing to ECM file but CDDA file or some other track
     if (f != m_cdHandle) {
@@ -42,27 +41,11 @@ ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int s
         // printf("ReadSector %i %i\n", sector, savedsectors);
         return (*this.*m_cdimg_read_func_o)(m_decoded_ecm, base, dest, sector);
     }
-    // To prevent invalid seek
-    /* else if (sector > m_len_ecm_savetable) {
-            PCSX::g_system->printf("ECM: invalid sector requested\n");
-            return -1;
-    }*/
-    // printf("SeekSector %i %i %i %i\n", sector, pos->sector, m_prevsector, base);
 
-    if (sector <= m_len_ecm_savetable) {
-        // get sector from LUT which points to wanted sector or close to
-        // TODO: What would be optimal maximum to search near sector?
-        //       Might cause slowdown if too small but too big also..
-        for (sectorcount = sector; ((sectorcount > 0) && ((sector - sectorcount) <= 50000)); sectorcount--) {
-            if (m_ecm_savetable[sectorcount].filepos >= ECM_HEADER_SIZE) {
-                pos = &(m_ecm_savetable[sectorcount]);
-                // printf("LUTSector %i %i %i %i\n", sector, pos->sector, m_prevsector, base);
-                break;
-            }
-        }
-        // if suitable sector was not found from LUT use last sector if less than wanted sector
-        if (pos->filepos <= ECM_HEADER_SIZE && sector > m_prevsector) pos = &(m_ecm_savetable[m_prevsector]);
-    }
+    // Start decoding from the closest place the index knows of, which may be in the middle of a record
+    ECMIndex::Checkpoint pos;
+    const uint32_t startsector = m_ecmIndex->find(sector, pos);
+    // printf("SeekSector %i %i %i\n", sector, startsector, base);
 
     auto reconstructSector = [](uint8_t *sector, int8_t type) {
         auto ref32 = [sector](uint32_t offset) -> uint32_t & { return *reinterpret_cast<uint32_t *>(sector + offset); };
@@ -109,39 +92,43 @@ ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int s
         IEC60908b::computeEDCECC(sector);
     };
 
-    writebytecount = pos->sector * PCSX::IEC60908b::FRAMESIZE_RAW;
-    sectorcount = pos->sector;
+    writebytecount = startsector * PCSX::IEC60908b::FRAMESIZE_RAW;
+    sectorcount = startsector;
     if (m_decoded_ecm_sectors) m_decoded_ecm->rSeek(writebytecount, SEEK_SET);  // rewind to last pos
-    f->rSeek(/*base+*/ pos->filepos, SEEK_SET);
+    f->rSeek(/*base+*/ pos.filepos, SEEK_SET);
+    // A checkpoint in the middle of a record means we already know what's left of it
+    type = pos.type;
+    num = pos.remaining;
     while (sector >= sectorcount) {  // decode ecm file until we are past wanted sector
-        int c = f->getc();
-        int bits = 5;
-        if (c == EOF) {
-            goto error_in;
-        }
-        type = c & 3;
-        num = (c >> 2) & 0x1F;
-        // printf("ECM1 file; count %x\n", c);
-        while (c & 0x80) {
-            c = f->getc();
-            // printf("ECM2 file; count %x\n", c);
+        if (!num) {
+            int c = f->getc();
+            int bits = 5;
             if (c == EOF) {
                 goto error_in;
             }
-            if ((bits > 31) || ((uint32_t)(c & 0x7F)) >= (((uint32_t)0x80000000LU) >> (bits - 1))) {
-                // PCSX::g_system->message(_("Corrupt ECM file; invalid sector count\n"));
-                goto error;
+            type = c & 3;
+            num = (c >> 2) & 0x1F;
+            // printf("ECM1 file; count %x\n", c);
+            while (c & 0x80) {
+                c = f->getc();
+                // printf("ECM2 file; count %x\n", c);
+                if (c == EOF) {
+                    goto error_in;
+                }
+                if ((bits > 31) || ((uint32_t)(c & 0x7F)) >= (((uint32_t)0x80000000LU) >> (bits - 1))) {
+                    // PCSX::g_system->message(_("Corrupt ECM file; invalid sector count\n"));
+                    goto error;
+                }
+                num |= ((uint32_t)(c & 0x7F)) << bits;
+                bits += 7;
             }
-            num |= ((uint32_t)(c & 0x7F)) << bits;
-            bits += 7;
-        }
-        if (num == 0xFFFFFFFF) {
-            // End indicator
-            m_len_decoded_ecm_buffer = writebytecount;
-            m_len_ecm_savetable = m_len_decoded_ecm_buffer / PCSX::IEC60908b::FRAMESIZE_RAW;
-            break;
+            if (num == 0xFFFFFFFF) {
+                // End indicator
+                m_len_decoded_ecm_buffer = writebytecount;
+                break;
+            }
+            num++;
         }
-        num++;
         while (num) {
             if (!processsectors && sectorcount >= (sector - 1)) {  // ensure that we read the sector we are supposed to
                 processsectors = true;
@@ -151,7 +138,7 @@ ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int s
                 break;
             }
             /*printf("Type %i Num %i SeekSector %i ProcessedSectors %i(%i) Bytecount %i Pos %li Write %u\n",
-                            type, num, sector, sectorcount, pos->sector, writebytecount, ftell(f),
+                            type, num, sector, sectorcount, startsector, writebytecount, ftell(f),
                processsectors);*/
             switch (type) {
                 case 0:  // META
@@ -228,11 +215,10 @@ ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int s
             sectorcount = ((writebytecount / PCSX::IEC60908b::FRAMESIZE_RAW) - 0);
             num -= b;
         }
-        if (type && sectorcount > 0 && m_ecm_savetable[sectorcount].filepos <= ECM_HEADER_SIZE) {
-            m_ecm_savetable[sectorcount].filepos = f->rTell() /*-base*/;
-            m_ecm_savetable[sectorcount].sector = sectorcount;
-            // printf("Marked %i at pos %i\n", m_ecm_savetable[sectorcount].sector,
-            // m_ecm_savetable[sectorcount].filepos);
+        // Only a record we went all the way through leaves us on the header of the next one
+        if (type && !num && sectorcount > 0 && (writebytecount % PCSX::IEC60908b::FRAMESIZE_RAW) == 0) {
+            m_ecmIndex->add(sectorcount, {uint32_t(f->rTell() /*-base*/), 0, 0});
+            // printf("Marked %i at pos %i\n", sectorcount, f->rTell());
         }
     }
 
@@ -245,7 +231,6 @@ ssize_t PCSX::CDRIso::ecmDecode(IO<File> f, unsigned int base, void *dest, int s
     }
 
     memcpy(dest, sector_buffer, PCSX::IEC60908b::FRAMESIZE_RAW);
-    m_prevsector = sectorcount;
     // printf("OK: Frame decoded %i %i\n", sectorcount-1, writebytecount);
     return num;
 
@@ -254,7 +239,7 @@ error:
 error_out:
     // memset(dest, 0x0, PCSX::CDRomCD_FRAMESIZE_RAW);
     PCSX::g_system->printf("Error decoding ECM image: WantedSector %i Type %i Base %i Sectors %i(%i) Pos %i(%li)\n",
-                           sector, type, base, sectorcount, pos->sector, writebytecount, f->rTell());
+                           sector, type, base, sectorcount, startsector, writebytecount, f->rTell());
     return -1;
 }
 
@@ -270,29 +255,30 @@ bool PCSX::CDRIso::handleecm(const char *isoname, IO<File> cdh, int32_t *accurat
         // Function used to decode ECM data
         m_cdimg_read_func = &CDRIso::ecmDecode;
 
-        // Last accessed sector
-        m_prevsector = 0;
-
         // Already analyzed during this session, use cached results
         if (m_ecm_file_detected) {
-            if (accurate_length) *accurate_length = m_len_ecm_savetable;
+            if (accurate_length) *accurate_length = m_ecmIndex->sectors();
             return 0;
         }
 
         PCSX::g_system->printf(_("\nDetected ECM file with proper header and filename suffix.\n"));
 
-        // Reserve maximum known sector ammount for LUT (80MIN CD)
-        m_len_ecm_savetable = 75 * 80 * 60;  // 2*(accurate_length/PCSX::CDRomCD_FRAMESIZE_RAW);
-
-        // Index 0 always points to beginning of ECM data
-        m_ecm_savetable = (ECMFILELUT *)calloc(m_len_ecm_savetable, sizeof(ECMFILELUT));  // calloc returns nulled data
-        m_ecm_savetable[0].filepos = ECM_HEADER_SIZE;
+        // The index gets its own handle, as it's built in the background while the image is already in use
+        std::filesystem::path sidecar = m_isoPath;
+        sidecar += ".idx";
+        m_ecmIndex.reset(new ECMIndex(IO<File>(cdh->dup()), sidecar));
+        if (m_ecmIndex->load()) {
+            PCSX::g_system->printf("[+idx]");
+        } else if (accurate_length) {
+            if (m_ecmIndex->build()) m_ecmIndex->save();
+        } else {
+            m_ecmIndex->start();
+        }
+        if (accurate_length) *accurate_length = m_ecmIndex->sectors();
 
-        if (accurate_length || m_decoded_ecm_sectors) {
+        if (m_decoded_ecm_sectors) {
             uint8_t tbuf1[PCSX::IEC60908b::FRAMESIZE_RAW];
-            m_len_ecm_savetable = 0;             // indicates to cdread_ecm_decode that no lut has been built yet
-            ecmDecode(cdh, 0U, tbuf1, INT_MAX);  // builds LUT completely
-            if (accurate_length) *accurate_length = m_len_ecm_savetable;
+            ecmDecode(cdh, 0U, tbuf1, INT_MAX);  // decodes the whole image
         }
 
         // Full image decoded? Needs fmemopen()
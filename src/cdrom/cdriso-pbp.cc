@@ -155,7 +155,6 @@ bool PCSX::CDRIso::handlepbp(const char *isofile) {
     if (m_compr_img == NULL) goto fail_io;
 
     m_compr_img->block_shift = 4;
-    m_compr_img->current_block = (unsigned int)-1;
 
     m_compr_img->index_len = (0x100000 - 0x4000) / sizeof(index_entry);
     m_compr_img->index_table =
@@ -175,6 +174,8 @@ bool PCSX::CDRIso::handlepbp(const char *isofile) {
         m_compr_img->index_table[i] = cdimg_base + index_entry.offset;
     }
     m_compr_img->index_table[i] = cdimg_base + index_entry.offset + index_entry.size;
+    // The index has room for more entries than the image has blocks
+    m_compr_img->index_len = i;
 
     return true;
 
@@ -20,6 +20,7 @@
 #include "cdrom/cdriso.h"
 
 #include "supportpsx/iec-60908b.h"
+#include "tracy/Tracy.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -66,13 +67,14 @@
 //
 
 PCSX::CDRIso::CDRIso() {
-    m_zstr.next_in = Z_NULL;
-    m_zstr.avail_in = 0;
-    m_zstr.zalloc = Z_NULL;
-    m_zstr.zfree = Z_NULL;
-    m_zstr.opaque = Z_NULL;
-    auto ret = inflateInit2(&m_zstr, -15);
-    if (ret != Z_OK) throw("Unable to initialize zlib context");
+    m_cddaReadAhead.reset(new SectorReadAhead(IEC60908b::FRAMESIZE_RAW, c_cddaReadAheadSectors,
+                                              [this](uint32_t sector, uint8_t *data) {
+                                                  return readCDDA(IEC60908b::MSF(sector), data);
+                                              }));
+    m_dataReadAhead.reset(new SectorReadAhead(
+        c_dataReadAheadSectorSize, c_dataReadAheadSectors,
+        [this](uint32_t sector, uint8_t *data) { return readDataSector(static_cast<int>(sector), data); }));
+    setReadAheadSpeed(1);
 }
 
 // this function tries to get the .sub file of the given .img
@@ -144,67 +146,59 @@ static int uncompress2_internal(void *out, unsigned long *out_size, void *in, un
     return ret == 1 ? 0 : ret;
 }
 
-ssize_t PCSX::CDRIso::cdread_compressed(IO<File> f, unsigned int base, void *dest, int sector) {
-    unsigned long cdbuffer_size, cdbuffer_size_expect;
-    unsigned int start_byte, size;
-    int is_compressed;
-    int ret, block;
-
-    if (base) sector += base / 2352;
+void PCSX::CDRIso::startCompressedCache() {
+    const unsigned blockSize = IEC60908b::FRAMESIZE_RAW << m_compr_img->block_shift;
+    m_compressedCache.reset(
+        new BlockCache(blockSize, m_compr_img->index_len, [this, blockSize]() -> BlockCache::Decoder {
+            // Each thread gets its own zlib context, and buffer for the compressed data
+            std::shared_ptr<z_stream> z(new z_stream{}, [](z_stream *z) {
+                inflateEnd(z);
+                delete z;
+            });
+            if (inflateInit2(z.get(), -15) != Z_OK) throw std::runtime_error("Unable to initialize zlib context");
+            std::shared_ptr<uint8_t[]> compressed(new uint8_t[blockSize + 100]);
+            return [this, blockSize, z, compressed](uint32_t block, uint8_t *dest) {
+                return decompressBlock(block, dest, blockSize, z.get(), compressed.get());
+            };
+        }));
+}
 
-    block = sector >> m_compr_img->block_shift;
-    m_compr_img->sector_in_blk = sector & ((1 << m_compr_img->block_shift) - 1);
+bool PCSX::CDRIso::decompressBlock(uint32_t block, uint8_t *dest, unsigned blockSize, z_stream *z,
+                                   uint8_t *compressed) {
+    ZoneScoped;
+    const unsigned start_byte = m_compr_img->index_table[block] & 0x7fffffff;
+    const bool is_compressed = !(m_compr_img->index_table[block] & 0x80000000);
+    const unsigned size = (m_compr_img->index_table[block + 1] & 0x7fffffff) - start_byte;
+    if (size > (is_compressed ? blockSize + 100 : blockSize)) return false;
 
-    if (block == m_compr_img->current_block) {
-        // printf("hit sect %d\n", sector);
-        goto finish;
+    {
+        std::unique_lock<std::mutex> lock(m_compressedFileMutex);
+        if (m_cdHandle->readAt(is_compressed ? compressed : dest, size, start_byte) != ssize_t(size)) return false;
     }
+    if (!is_compressed) return true;
 
-    if (sector >= m_compr_img->index_len * 16) {
-        PCSX::g_system->printf("sector %d is past img end\n", sector);
-        return -1;
-    }
+    unsigned long cdbuffer_size = blockSize;
+    if (uncompress2_internal(dest, &cdbuffer_size, compressed, size, z) != 0) return false;
+    // A short block leaves the end of it zeroed, like a short image would.
+    if (cdbuffer_size != blockSize) memset(dest + cdbuffer_size, 0, blockSize - cdbuffer_size);
+    return true;
+}
 
-    start_byte = m_compr_img->index_table[block] & 0x7fffffff;
-    if (m_cdHandle->rSeek(start_byte, SEEK_SET) != 0) {
-        PCSX::g_system->printf("seek error for block %d at %x: ", block, start_byte);
-        perror(NULL);
-        return -1;
-    }
+ssize_t PCSX::CDRIso::cdread_compressed(IO<File> f, unsigned int base, void *dest, int sector) {
+    if (base) sector += base / 2352;
 
-    is_compressed = !(m_compr_img->index_table[block] & 0x80000000);
-    size = (m_compr_img->index_table[block + 1] & 0x7fffffff) - start_byte;
-    if (size > sizeof(m_compr_img->buff_compressed)) {
-        PCSX::g_system->printf("block %d is too large: %u\n", block, size);
-        return -1;
-    }
+    const unsigned block = sector >> m_compr_img->block_shift;
+    const unsigned sector_in_blk = sector & ((1 << m_compr_img->block_shift) - 1);
 
-    if (m_cdHandle->read(is_compressed ? m_compr_img->buff_compressed : m_compr_img->buff_raw[0], size) != size) {
-        PCSX::g_system->printf("read error for block %d at %x: ", block, start_byte);
-        perror(NULL);
+    if ((sector < 0) || (block >= m_compr_img->index_len)) {
+        PCSX::g_system->printf("sector %d is past img end\n", sector);
         return -1;
     }
 
-    if (is_compressed) {
-        cdbuffer_size_expect = sizeof(m_compr_img->buff_raw[0]) << m_compr_img->block_shift;
-        cdbuffer_size = cdbuffer_size_expect;
-        ret =
-            uncompress2_internal(m_compr_img->buff_raw[0], &cdbuffer_size, m_compr_img->buff_compressed, size, &m_zstr);
-        if (ret != 0) {
-            PCSX::g_system->printf("uncompress failed with %d for block %d, sector %d\n", ret, block, sector);
-            return -1;
-        }
-        if (cdbuffer_size != cdbuffer_size_expect)
-            PCSX::g_system->printf("cdbuffer_size: %lu != %lu, sector %d\n", cdbuffer_size, cdbuffer_size_expect,
-                                   sector);
+    if (!m_compressedCache->read(block, sector_in_blk * IEC60908b::FRAMESIZE_RAW, dest, IEC60908b::FRAMESIZE_RAW)) {
+        PCSX::g_system->printf("failed to read block %d, sector %d\n", block, sector);
+        return -1;
     }
-
-    // done at last!
-    m_compr_img->current_block = block;
-
-finish:
-    if (dest != m_cdbuffer)  // copy avoid HACK
-        memcpy(dest, m_compr_img->buff_raw[m_compr_img->sector_in_blk], IEC60908b::FRAMESIZE_RAW);
     return IEC60908b::FRAMESIZE_RAW;
 }
 
@@ -238,13 +232,7 @@ ssize_t PCSX::CDRIso::cdread_2048(IO<File> f, unsigned int base, void *dest_, in
     return ret;
 }
 
-uint8_t *PCSX::CDRIso::getBuffer() {
-    if (m_useCompressed) {
-        return m_compr_img->buff_raw[m_compr_img->sector_in_blk] + 12;
-    } else {
-        return m_cdbuffer + 12;
-    }
-}
+uint8_t *PCSX::CDRIso::getBuffer() { return m_cdbuffer + 12; }
 
 void PCSX::CDRIso::printTracks() {
     for (int i = 1; i <= m_numtracks; i++) {
@@ -261,10 +249,16 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
     m_cdHandle = isoFile;
     if (m_cdHandle->failed()) {
         m_cdHandle.reset();
+        updateTrackPositions();
         return false;
     }
     if (g_emulator->settings.get<Emulator::SettingFullCaching>() && m_cdHandle.isA<UvFile>()) {
         m_cdHandle.asA<UvFile>()->startCaching();
+    } else if (m_cdHandle.isA<UvFile>()) {
+        // Without caching, map the image instead of going through the uv loop for every sector. The
+        // cue, toc and mds parsers will still open their own files for the tracks if they find any.
+        IO<File> mapped(new MappedFile(m_cdHandle->filename()));
+        if (!mapped->failed()) m_cdHandle = mapped;
     }
 
     PCSX::g_system->printf(_("Loaded CD Image: %s"), m_isoPath.string());
@@ -276,7 +270,6 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
     m_cdrIsoMultidiskCount = 1;
     m_multifile = false;
 
-    m_useCompressed = false;
     m_cdimg_read_func = &CDRIso::cdread_normal;
 
     for (auto &i : m_ti) {
@@ -295,14 +288,17 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
     // TODO Is it possible that cue/ccd+ecm? otherwise use else if below to supressn extra checks
     if (handlepbp(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[pbp]");
-        m_useCompressed = true;
+        startCompressedCache();
         m_cdimg_read_func = &CDRIso::cdread_compressed;
     } else if (handlecbin(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
         PCSX::g_system->printf("[cbin]");
-        m_useCompressed = true;
+        startCompressedCache();
         m_cdimg_read_func = &CDRIso::cdread_compressed;
     } else if ((handleecm(reinterpret_cast<const char *>(m_isoPath.string().c_str()), m_cdHandle, NULL))) {
         PCSX::g_system->printf("[+ecm]");
+    } else if (handlechd(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
+        PCSX::g_system->printf("[chd]");
+        m_cdimg_read_func = &CDRIso::cdread_chd;
     }
 
     if (!m_subChanMixed && opensubfile(reinterpret_cast<const char *>(m_isoPath.string().c_str()))) {
@@ -312,7 +308,7 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
         PCSX::g_system->printf("[+sbi]");
     }
 
-    if (!m_ecm_file_detected) {
+    if (!m_ecm_file_detected && !m_chd) {
         // guess whether it is mode1/2048
         if (m_cdHandle->size() % 2048 == 0) {
             unsigned int modeTest = m_cdHandle->readAt<uint32_t>(0);
@@ -348,17 +344,23 @@ bool PCSX::CDRIso::open(IO<File> isoFile) {
     }
 
     // make sure we have another handle open for cdda
-    if (m_numtracks > 1 && !m_ti[1].handle) {
+    if (m_numtracks > 1 && !m_ti[1].handle && m_cdHandle.isA<MappedFile>()) {
+        m_ti[1].handle.setFile(m_cdHandle->dup());
+    } else if (m_numtracks > 1 && !m_ti[1].handle) {
         m_ti[1].handle.setFile(new UvFile(m_isoPath));
         if (g_emulator->settings.get<Emulator::SettingFullCaching>()) {
             m_ti[1].handle.asA<UvFile>()->startCaching();
         }
     }
 
+    updateTrackPositions();
+
     return true;
 }
 
 void PCSX::CDRIso::close() {
+    // The decompression workers read through the image and its index
+    m_compressedCache.reset();
     m_cdHandle.reset();
     m_subHandle.reset();
 
@@ -378,10 +380,9 @@ void PCSX::CDRIso::close() {
     m_ti[1].type = TrackType::CLOSED;
 
     memset(m_cdbuffer, 0, sizeof(m_cdbuffer));
-    m_useCompressed = false;
     // ECM LUT
-    free(m_ecm_savetable);
-    m_ecm_savetable = nullptr;
+    m_ecmIndex.reset();
+    m_chd.reset();
 
     if (m_decoded_ecm) {
         m_decoded_ecm.reset();
@@ -424,21 +425,22 @@ PCSX::IEC60908b::MSF PCSX::CDRIso::getPregap(uint8_t track) {
 
 // Decode 'raw' subchannel data from being packed bitwise.
 // Essentially is a bitwise matrix transposition.
-void PCSX::CDRIso::decodeRawSubData() {
+void PCSX::CDRIso::decodeRawSubData(IEC60908b::Sub &sub) {
     unsigned char subQData[12];
     memset(subQData, 0, sizeof(subQData));
 
     for (int i = 0; i < 8 * 12; i++) {
-        if (m_subbuffer.raw[i] & (1 << 6)) {  // only subchannel Q is needed
+        if (sub.raw[i] & (1 << 6)) {  // only subchannel Q is needed
             subQData[i >> 3] |= (1 << (7 - (i & 7)));
         }
     }
 
-    memcpy(&m_subbuffer.Q, subQData, 12);
+    memcpy(&sub.Q, subQData, 12);
 }
 
 // read track
 bool PCSX::CDRIso::readTrack(const IEC60908b::MSF time) {
+    ZoneScoped;
     int sector = time.toLBA() - 150;
     long ret;
 
@@ -453,25 +455,107 @@ bool PCSX::CDRIso::readTrack(const IEC60908b::MSF time) {
         }
     }
 
-    ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, m_cdbuffer, sector);
-    if (ret < 0) return false;
-
-    if (m_subHandle) {
-        m_subHandle->rSeek(sector * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
-        m_subHandle->read(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE);
+    if (canReadAhead()) {
+        if (!m_dataReadAhead->read(sector, m_readAheadBuffer)) return false;
+        memcpy(m_cdbuffer, m_readAheadBuffer, IEC60908b::FRAMESIZE_RAW);
+        if (m_subHandle) {
+            memcpy(m_subbuffer.raw, m_readAheadBuffer + IEC60908b::FRAMESIZE_RAW, IEC60908b::SUB_FRAMESIZE);
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(m_readMutex);
+        ret = (*this.*m_cdimg_read_func)(m_cdHandle, 0, m_cdbuffer, sector);
+        if (ret < 0) return false;
 
-        if (m_subChanRaw) decodeRawSubData();
+        if (m_subHandle) {
+            m_subHandle->rSeek(sector * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
+            m_subHandle->read(m_subbuffer.raw, IEC60908b::SUB_FRAMESIZE);
+        }
     }
+    if (m_subHandle && m_subChanRaw) decodeRawSubData();
 
     m_ppf.maybePatchSector(m_cdbuffer, time);
 
     return true;
 }
 
+unsigned PCSX::CDRIso::readTrackSectors(const IEC60908b::MSF time, Sector *sectors, unsigned count) {
+    static_assert(sizeof(Sector) == c_dataReadAheadSectorSize);
+    ZoneScoped;
+    int sector = time.toLBA() - 150;
+
+    if (!m_cdHandle || m_cdHandle->failed()) {
+        return 0;
+    }
+    if (m_pregapOffset) {
+        if (sector >= m_pregapOffset) {
+            sector -= 2 * 75;
+        } else {
+            // The pregap isn't in the image, so the sectors after it are further back than the ones before.
+            count = std::min(count, m_pregapOffset - sector);
+        }
+    }
+
+    unsigned actual = 0;
+    if (canReadAhead()) {
+        actual = m_dataReadAhead->read(sector, reinterpret_cast<uint8_t *>(sectors), count);
+    } else {
+        std::unique_lock<std::mutex> lock(m_readMutex);
+        for (; actual < count; actual++) {
+            Sector &s = sectors[actual];
+            if ((*this.*m_cdimg_read_func)(m_cdHandle, 0, s.data, sector + actual) < 0) break;
+            if (m_subHandle) {
+                m_subHandle->rSeek((sector + actual) * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
+                m_subHandle->read(s.sub.raw, IEC60908b::SUB_FRAMESIZE);
+            } else if (m_subChanMixed) {
+                // the mixed readers leave it there, already decoded
+                s.sub = m_subbuffer;
+            }
+        }
+    }
+
+    const uint32_t lba = time.toLBA();
+    for (unsigned i = 0; i < actual; i++) {
+        if (m_subHandle && m_subChanRaw) decodeRawSubData(sectors[i].sub);
+        m_ppf.maybePatchSector(sectors[i].data, IEC60908b::MSF(lba + i));
+    }
+
+    return actual;
+}
+
+bool PCSX::CDRIso::hasSubchannel(const IEC60908b::MSF time) const {
+    if (!m_subHandle && !m_subChanMixed) return false;
+    if (!m_pregapOffset) return true;
+    int sector = time.toLBA() - 150;
+    if (sector < m_pregapOffset) return true;
+    return sector - 2 * 75 >= m_pregapOffset;
+}
+
+void PCSX::CDRIso::updateTrackPositions() {
+    const unsigned tracks = getTN();
+    for (unsigned track = 0; track < MAXTRACKS; track++) {
+        auto &position = m_trackPositions[track];
+        position.start = getTD(track).toLBA();
+        position.last = track + 1 > tracks;
+        position.next = position.last ? 0 : getTD(track + 1).toLBA();
+    }
+}
+
+bool PCSX::CDRIso::readDataSector(int sector, uint8_t *data) {
+    std::unique_lock<std::mutex> lock(m_readMutex);
+    if ((*this.*m_cdimg_read_func)(m_cdHandle, 0, data, sector) < 0) return false;
+    if (m_subHandle) {
+        m_subHandle->rSeek(sector * IEC60908b::SUB_FRAMESIZE, SEEK_SET);
+        m_subHandle->read(data + IEC60908b::FRAMESIZE_RAW, IEC60908b::SUB_FRAMESIZE);
+    }
+    return true;
+}
+
 unsigned PCSX::CDRIso::readSectors(uint32_t lba, void *buffer_, unsigned count) {
+    ZoneScoped;
     unsigned actual = 0;
     uint8_t *buffer = reinterpret_cast<uint8_t *>(buffer_);
 
+    std::unique_lock<std::mutex> lock(m_readMutex);
     if (m_cdHandle->failed()) {
         return 0;
     }
@@ -484,7 +568,7 @@ unsigned PCSX::CDRIso::readSectors(uint32_t lba, void *buffer_, unsigned count)
             m_ppf.maybePatchSector(ptr, time);
             if (ret < 0) return actual;
         } else {
-            if (!readCDDA(IEC60908b::MSF(lba++), ptr)) return actual;
+            if (!readCDDAUnlocked(IEC60908b::MSF(lba++), ptr)) return actual;
         }
         actual++;
     }
@@ -503,6 +587,12 @@ const PCSX::IEC60908b::Sub *PCSX::CDRIso::getBufferSub() {
 
 // read CDDA sector into buffer
 bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
+    std::unique_lock<std::mutex> lock(m_readMutex);
+    return readCDDAUnlocked(msf, buffer);
+}
+
+bool PCSX::CDRIso::readCDDAUnlocked(IEC60908b::MSF msf, unsigned char *buffer) {
+    ZoneScoped;
     unsigned int file, track, track_start = 0;
     int ret;
 
@@ -541,17 +631,9 @@ bool PCSX::CDRIso::readCDDA(IEC60908b::MSF msf, unsigned char *buffer) {
         return false;
     }
 
-    if (m_cddaBigEndian) {
-        unsigned char tmp;
-
-        for (int i = 0; i < IEC60908b::FRAMESIZE_RAW / 2; i++) {
-            tmp = buffer[i * 2];
-            buffer[i * 2] = buffer[i * 2 + 1];
-            buffer[i * 2 + 1] = tmp;
-        }
-    }
+    if (m_cddaBigEndian) swapCDDAEndianness(buffer);
 
     return true;
 }
 
-bool PCSX::CDRIso::failed() { return !m_cdHandle && !m_ecm_savetable && !m_decoded_ecm; }
+bool PCSX::CDRIso::failed() { return !m_cdHandle && !m_ecmIndex && !m_decoded_ecm; }
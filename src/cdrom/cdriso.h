@@ -23,8 +23,14 @@
 #include <zlib.h>
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
+#include "cdrom/blockcache.h"
+#include "cdrom/chd.h"
+#include "cdrom/ecmindex.h"
 #include "cdrom/ppf.h"
+#include "cdrom/readahead.h"
 #include "core/psxemulator.h"
 #include "support/uvfile.h"
 #include "supportpsx/iec-60908b.h"
@@ -42,8 +48,10 @@ class CDRIso {
         open(isoFile);
     }
     ~CDRIso() {
+        // the read-ahead workers read through this object, so they need to be gone before it gets torn down
+        m_cddaReadAhead.reset();
+        m_dataReadAhead.reset();
         close();
-        inflateEnd(&m_zstr);
     }
     enum class TrackType { CLOSED = 0, DATA = 1, CDDA = 2 };
     TrackType getTrackType(unsigned track) { return m_ti[track].type; }
@@ -53,10 +61,46 @@ class CDRIso {
     IEC60908b::MSF getLength(uint8_t track);
     IEC60908b::MSF getPregap(uint8_t track);
     bool readTrack(const IEC60908b::MSF time);
+    // A data sector along with its subchannel data, laid out the same way they get read ahead.
+    struct Sector {
+        uint8_t data[IEC60908b::FRAMESIZE_RAW];
+        IEC60908b::Sub sub;
+    };
+    // Same as readTrack, for up to count sectors in a row starting at time, without going through getBuffer and
+    // getBufferSub. Returns how many sectors got read, stopping at the first one which fails. The subchannel data
+    // is only meaningful for the sectors hasSubchannel is true for.
+    unsigned readTrackSectors(const IEC60908b::MSF time, Sector* sectors, unsigned count);
+    // Whether the image has the subchannel data for the sector at this time, the way getBufferSub tells after
+    // readTrack.
+    bool hasSubchannel(const IEC60908b::MSF time) const;
+    // Where a track starts, and where the one after it does, as getTD gives them, in LBA. They're worked out when
+    // the image gets opened, so that following the position of the drive doesn't need getTD for every sector.
+    struct TrackPosition {
+        uint32_t start = 0;
+        // Only set when there's a track after this one; the end of the disc is up to the caller.
+        uint32_t next = 0;
+        bool last = true;
+    };
+    const TrackPosition& getTrackPosition(unsigned track) const { return m_trackPositions[track]; }
     unsigned readSectors(uint32_t lba, void* buffer, unsigned count);
     uint8_t* getBuffer();
     const IEC60908b::Sub* getBufferSub();
     bool readCDDA(const IEC60908b::MSF msf, unsigned char* buffer);
+    // Same as readCDDA, for playing audio: as long as the sectors are asked for in order, they come from a
+    // read-ahead buffer that a worker thread keeps filled, instead of from the disc image directly. Anything
+    // else costs a normal read, and restarts the read-ahead from there.
+    bool streamCDDA(const IEC60908b::MSF msf, unsigned char* buffer);
+    // Swaps the bytes of all the 16 bits samples of a raw sector, for the images dumped in big endian.
+    static void swapCDDAEndianness(uint8_t* sector);
+    // How far ahead to read the data sectors, following the drive's speed; 1 for single speed, 2 for double.
+    void setReadAheadSpeed(unsigned speed) { m_dataReadAhead->setDepth(speed * c_dataReadAheadPerSpeed); }
+    const SectorReadAhead& getDataReadAhead() const { return *m_dataReadAhead; }
+    SectorReadAhead& getDataReadAhead() { return *m_dataReadAhead; }
+    // Stops the read-ahead workers until the next reads, so that no thread is left reading through this object.
+    void stopReadAhead() {
+        m_cddaReadAhead->stop();
+        m_dataReadAhead->stop();
+    }
     PPF* getPPF() { return &m_ppf; }
 
     bool failed();
@@ -70,13 +114,27 @@ class CDRIso {
     CDRIso();
     bool open(IO<File> isoFile);
     void close();
+    bool readCDDAUnlocked(const IEC60908b::MSF msf, unsigned char* buffer);
+    bool readDataSector(int sector, uint8_t* data);
+
+    // Reading sectors only ever happens with this held, since the CDDA read-ahead runs on its own thread.
+    std::mutex m_readMutex;
+
+    // Only plain images can be read ahead: the other readers keep some state around, which the sectors
+    // returned by getBuffer and getBufferSub come from.
+    bool canReadAhead() const { return m_cdimg_read_func == &CDRIso::cdread_normal; }
+    static constexpr unsigned c_cddaReadAheadSectors = 32;
+    static constexpr unsigned c_dataReadAheadPerSpeed = 16;
+    static constexpr unsigned c_dataReadAheadSectors = 2 * c_dataReadAheadPerSpeed;
+    // The data sectors are read ahead with their subchannel data right after them.
+    static constexpr unsigned c_dataReadAheadSectorSize = IEC60908b::FRAMESIZE_RAW + IEC60908b::SUB_FRAMESIZE;
+    std::unique_ptr<SectorReadAhead> m_cddaReadAhead;
+    std::unique_ptr<SectorReadAhead> m_dataReadAhead;
+    uint8_t m_readAheadBuffer[c_dataReadAheadSectorSize];
 
     std::filesystem::path m_isoPath;
     typedef ssize_t (CDRIso::*read_func_t)(IO<File> f, unsigned int base, void* dest, int sector);
 
-    bool m_useCompressed = false;
-    z_stream m_zstr;
-
     IO<File> m_cdHandle;
     IO<File> m_subHandle;
 
@@ -99,24 +157,21 @@ class CDRIso {
 
     // compressed image stuff
     struct compr_img_t {
-        unsigned char buff_raw[16][2352];
-        unsigned char buff_compressed[2352 * 16 + 100];
         unsigned int* index_table;
         unsigned int index_len;
         unsigned int block_shift;
-        unsigned int current_block;
-        unsigned int sector_in_blk;
     }* m_compr_img = nullptr;
+    // Blocks of the compressed image get decompressed ahead of the one being read, by worker threads
+    std::unique_ptr<BlockCache> m_compressedCache;
+    std::mutex m_compressedFileMutex;
 
     read_func_t m_cdimg_read_func = nullptr;
 
     uint32_t m_len_decoded_ecm_buffer = 0;  // same as decoded ECM file length or 2x size
-    uint32_t m_len_ecm_savetable = 0;       // same as sector count of decoded ECM file or 2x count
 
     uint32_t m_decoded_ecm_sectors = 0;  // disabled
 
     bool m_ecm_file_detected = false;
-    uint32_t m_prevsector;
 
     IO<File> m_decoded_ecm = nullptr;
     void* m_decoded_ecm_buffer = nullptr;
@@ -124,12 +179,9 @@ class CDRIso {
     // Function that is used to read CD normally
     read_func_t m_cdimg_read_func_o = nullptr;
 
-    struct ECMFILELUT {
-        int32_t sector;
-        int32_t filepos;
-    };
+    std::unique_ptr<ECMIndex> m_ecmIndex;
 
-    ECMFILELUT* m_ecm_savetable = nullptr;
+    std::unique_ptr<CHD> m_chd;
 
     static inline const size_t ECM_SECTOR_SIZE[4] = {1, 2352, 2336, 2336};
     static inline const uint8_t ZEROADDRESS[4] = {0, 0, 0, 0};
@@ -148,12 +200,15 @@ class CDRIso {
 
     int m_numtracks = 0;
     struct trackinfo m_ti[MAXTRACKS];
+    TrackPosition m_trackPositions[MAXTRACKS];
+    void updateTrackPositions();
 
     // redump.org SBI files
     uint8_t sbitime[256][3], sbicount;
     PPF m_ppf;
 
-    void decodeRawSubData();
+    void decodeRawSubData() { decodeRawSubData(m_subbuffer); }
+    static void decodeRawSubData(IEC60908b::Sub& sub);
     bool parsetoc(const char* isofile);
     bool parsecue(const char* isofile);
     bool parseccd(const char* isofile);
@@ -161,6 +216,9 @@ class CDRIso {
     bool handlepbp(const char* isofile);
     bool handlecbin(const char* isofile);
     bool handleecm(const char* isoname, IO<File> cdh, int32_t* accurate_length);
+    bool handlechd(const char* isofile);
+    void startCompressedCache();
+    bool decompressBlock(uint32_t block, uint8_t* dest, unsigned blockSize, z_stream* z, uint8_t* compressed);
     bool opensubfile(const char* isoname);
     bool opensbifile(const char* isoname);
 
@@ -171,6 +229,7 @@ class CDRIso {
     ssize_t cdread_compressed(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t cdread_2048(IO<File> f, unsigned int base, void* dest, int sector);
     ssize_t ecmDecode(IO<File> f, unsigned int base, void* dest, int sector);
+    ssize_t cdread_chd(IO<File> f, unsigned int base, void* dest, int sector);
 
     void printTracks();
     void UnloadSBI();
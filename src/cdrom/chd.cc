@@ -0,0 +1,673 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/chd.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "support/flacdecoder.h"
+#include "support/lzmadecoder.h"
+#include "tracy/Tracy.hpp"
+
+namespace {
+
+constexpr uint32_t makeTag(const char (&tag)[5]) {
+    return (uint32_t(uint8_t(tag[0])) << 24) | (uint32_t(uint8_t(tag[1])) << 16) | (uint32_t(uint8_t(tag[2])) << 8) |
+           uint32_t(uint8_t(tag[3]));
+}
+
+constexpr uint32_t c_codecZlib = makeTag("zlib");
+constexpr uint32_t c_codecLZMA = makeTag("lzma");
+constexpr uint32_t c_codecCDZlib = makeTag("cdzl");
+constexpr uint32_t c_codecCDLZMA = makeTag("cdlz");
+constexpr uint32_t c_codecCDFLAC = makeTag("cdfl");
+constexpr uint32_t c_metaTrack = makeTag("CHTR");
+constexpr uint32_t c_metaTrack2 = makeTag("CHT2");
+
+constexpr unsigned c_headerSize = 124;
+constexpr unsigned c_mapEntrySize = 12;
+
+// How each hunk is stored, as found in the map
+enum Compression : uint8_t {
+    TYPE_0 = 0,
+    TYPE_1 = 1,
+    TYPE_2 = 2,
+    TYPE_3 = 3,
+    NONE = 4,
+    SELF = 5,
+    PARENT = 6,
+    // Only used while decoding the compressed map
+    RLE_SMALL = 7,
+    RLE_LARGE = 8,
+    SELF_0 = 9,
+    SELF_1 = 10,
+    PARENT_SELF = 11,
+    PARENT_0 = 12,
+    PARENT_1 = 13,
+    // Our own, for uncompressed images, which don't have hunk checksums
+    UNCOMPRESSED = 14,
+    ZEROES = 15,
+};
+
+constexpr uint8_t c_syncHeader[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+
+uint16_t be16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+uint32_t be24(const uint8_t* p) { return (p[0] << 16) | (p[1] << 8) | p[2]; }
+uint32_t be32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | be24(p + 1); }
+uint64_t be48(const uint8_t* p) { return (uint64_t(be16(p)) << 32) | be32(p + 2); }
+uint64_t be64(const uint8_t* p) { return (uint64_t(be32(p)) << 32) | be32(p + 4); }
+
+std::string tagName(uint32_t tag) {
+    std::string name;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        char c = tag >> shift;
+        name += ((c >= 0x20) && (c < 0x7f)) ? c : '?';
+    }
+    return name;
+}
+
+// CRC-16/CCITT, which the map uses for itself and for each hunk
+uint16_t crc16(const uint8_t* data, size_t length) {
+    static const auto table = []() {
+        std::array<uint16_t, 256> table;
+        for (unsigned i = 0; i < 256; i++) {
+            uint16_t crc = i << 8;
+            for (unsigned j = 0; j < 8; j++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+            table[i] = crc;
+        }
+        return table;
+    }();
+    uint16_t crc = 0xffff;
+    while (length--) crc = (crc << 8) ^ table[(crc >> 8) ^ *data++];
+    return crc;
+}
+
+// Reads the map's bitstream most significant bit first. Reading past the end yields zeroes.
+class BitReader {
+  public:
+    BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+    uint32_t peek(unsigned bits) {
+        if (bits == 0) return 0;
+        while (m_bits < bits) {
+            uint64_t byte = m_offset < m_size ? m_data[m_offset] : 0;
+            m_offset++;
+            m_buffer |= byte << (56 - m_bits);
+            m_bits += 8;
+        }
+        return m_buffer >> (64 - bits);
+    }
+    void remove(unsigned bits) {
+        m_buffer <<= bits;
+        m_bits -= bits;
+    }
+    uint32_t read(unsigned bits) {
+        uint32_t r = peek(bits);
+        remove(bits);
+        return r;
+    }
+    bool overflowed() const { return m_offset - m_bits / 8 > m_size; }
+
+  private:
+    const uint8_t* m_data;
+    const size_t m_size;
+    size_t m_offset = 0;
+    uint64_t m_buffer = 0;
+    unsigned m_bits = 0;
+};
+
+// The canonical Huffman coding the compressed map uses for the compression types: 16 codes of at most 8 bits.
+class HuffmanDecoder {
+  public:
+    bool importTreeRLE(BitReader& bits) {
+        unsigned node = 0;
+        while (node < c_codes) {
+            unsigned length = bits.read(4);
+            if (length != 1) {
+                m_lengths[node++] = length;
+                continue;
+            }
+            length = bits.read(4);
+            if (length == 1) {
+                m_lengths[node++] = length;
+                continue;
+            }
+            unsigned repeat = bits.read(4) + 3;
+            if (node + repeat > c_codes) return false;
+            while (repeat--) m_lengths[node++] = length;
+        }
+        return assignCodes();
+    }
+    unsigned decode(BitReader& bits) {
+        const uint16_t lookup = m_lookup[bits.peek(c_maxBits)];
+        bits.remove(lookup & 0x1f);
+        return lookup >> 5;
+    }
+
+  private:
+    static constexpr unsigned c_codes = 16;
+    static constexpr unsigned c_maxBits = 8;
+
+    bool assignCodes() {
+        unsigned histogram[33] = {};
+        for (unsigned node = 0; node < c_codes; node++) {
+            if (m_lengths[node] > c_maxBits) return false;
+            histogram[m_lengths[node]]++;
+        }
+        unsigned start = 0;
+        for (unsigned length = 32; length > 0; length--) {
+            const unsigned next = (start + histogram[length]) >> 1;
+            if ((length != 1) && ((next * 2) != (start + histogram[length]))) return false;
+            histogram[length] = start;
+            start = next;
+        }
+        uint16_t codes[c_codes] = {};
+        for (unsigned node = 0; node < c_codes; node++) {
+            if (m_lengths[node]) codes[node] = histogram[m_lengths[node]]++;
+        }
+        for (unsigned node = 0; node < c_codes; node++) {
+            const unsigned length = m_lengths[node];
+            if (!length) continue;
+            const unsigned shift = c_maxBits - length;
+            const uint16_t value = (node << 5) | length;
+            for (unsigned i = codes[node] << shift; i < ((codes[node] + 1u) << shift); i++) m_lookup[i] = value;
+        }
+        return true;
+    }
+
+    uint8_t m_lengths[c_codes] = {};
+    uint16_t m_lookup[1 << c_maxBits] = {};
+};
+
+// The ECC of a mode 1 or mode 2 form 1 sector, for the frames which had theirs removed since it could be
+// computed back
+void generateECC(uint8_t* sector) {
+    static const auto tables = []() {
+        std::array<std::array<uint8_t, 256>, 2> tables;
+        for (unsigned i = 0; i < 256; i++) {
+            const unsigned j = (i << 1) ^ ((i & 0x80) ? 0x11d : 0);
+            tables[0][i] = j;
+            tables[1][i ^ j] = i;
+        }
+        return tables;
+    }();
+    const auto& f = tables[0];
+    const auto& b = tables[1];
+    auto computeBlock = [&f, &b](const uint8_t* src, unsigned majorCount, unsigned minorCount, unsigned majorMult,
+                                 unsigned minorInc, uint8_t* dest) {
+        const unsigned size = majorCount * minorCount;
+        for (unsigned major = 0; major < majorCount; major++) {
+            unsigned index = (major >> 1) * majorMult + (major & 1);
+            uint8_t eccA = 0;
+            uint8_t eccB = 0;
+            for (unsigned minor = 0; minor < minorCount; minor++) {
+                const uint8_t temp = src[index];
+                index += minorInc;
+                if (index >= size) index -= size;
+                eccA ^= temp;
+                eccB ^= temp;
+                eccA = f[eccA];
+            }
+            eccA = b[f[eccA] ^ eccB];
+            dest[major] = eccA;
+            dest[major + majorCount] = eccA ^ eccB;
+        }
+    };
+    // Mode 2 sectors compute their ECC as if their header was zeroes
+    uint8_t header[4];
+    memcpy(header, sector + 0xc, sizeof(header));
+    if (sector[0xf] == 2) memset(sector + 0xc, 0, sizeof(header));
+    // P first, as Q covers it
+    computeBlock(sector + 0xc, 86, 24, 2, 86, sector + 0x81c);
+    computeBlock(sector + 0xc, 52, 43, 86, 88, sector + 0x8c8);
+    memcpy(sector + 0xc, header, sizeof(header));
+}
+
+}  // namespace
+
+class PCSX::CHD::Decompressor {
+  public:
+    Decompressor(unsigned framesPerHunk) : m_frames(framesPerHunk * (c_sectorSize + c_subcodeSize)) {
+        for (auto z : {&m_base, &m_subcode}) {
+            z->zalloc = Z_NULL;
+            z->zfree = Z_NULL;
+            z->opaque = Z_NULL;
+            z->avail_in = 0;
+            z->next_in = Z_NULL;
+            if (inflateInit2(z, -MAX_WBITS) != Z_OK) throw std::runtime_error("inflateInit2 didn't work");
+        }
+    }
+    ~Decompressor() {
+        inflateEnd(&m_base);
+        inflateEnd(&m_subcode);
+    }
+
+    // Raw deflate, which needs to fill the destination exactly
+    static bool inflate(z_stream& z, const uint8_t* src, uint32_t srcLength, uint8_t* dest, uint32_t destLength) {
+        if (inflateReset(&z) != Z_OK) return false;
+        z.next_in = const_cast<Bytef*>(src);
+        z.avail_in = srcLength;
+        z.next_out = dest;
+        z.avail_out = destLength;
+        const int r = ::inflate(&z, Z_FINISH);
+        return ((r == Z_STREAM_END) || (r == Z_OK) || (r == Z_BUF_ERROR)) && (z.avail_out == 0);
+    }
+
+    z_stream m_base;
+    z_stream m_subcode;
+    // With the properties chdman's LZMA encoder always uses; the dictionary is the whole hunk anyway
+    LZMADecoder m_lzma;
+    FLACDecoder m_flac;
+    std::vector<uint8_t> m_compressed;
+    std::vector<uint8_t> m_frames;
+};
+
+PCSX::CHD::CHD(IO<File> file, unsigned workers) : m_file(file) {
+    if (!parseHeader() || !readMap() || !readMetadata()) return;
+
+    m_cache.reset(new BlockCache(
+        m_hunkBytes, m_hunkCount,
+        [this]() -> BlockCache::Decoder {
+            std::shared_ptr<Decompressor> decompressor(new Decompressor(m_framesPerHunk));
+            return [this, decompressor](uint32_t hunk, uint8_t* dest) {
+                return decompressHunk(hunk, dest, *decompressor);
+            };
+        },
+        workers));
+}
+
+bool PCSX::CHD::parseHeader() {
+    uint8_t header[c_headerSize];
+    if ((m_file->readAt(header, c_headerSize, 0) != c_headerSize) || (memcmp(header, "MComprHD", 8) != 0)) {
+        m_error = "Not a CHD file";
+        return false;
+    }
+    const uint32_t version = be32(header + 12);
+    if ((version != 5) || (be32(header + 8) < c_headerSize)) {
+        m_error = "Unsupported CHD version " + std::to_string(version) + ", only version 5 is supported";
+        return false;
+    }
+    for (unsigned i = 0; i < 4; i++) m_codecs[i] = be32(header + 16 + i * 4);
+    m_logicalBytes = be64(header + 32);
+    m_mapOffset = be64(header + 40);
+    m_metaOffset = be64(header + 48);
+    m_hunkBytes = be32(header + 56);
+    const uint32_t unitBytes = be32(header + 60);
+    if (std::any_of(header + 104, header + 124, [](uint8_t b) { return b != 0; })) {
+        m_error = "CHD images depending on a parent image aren't supported";
+        return false;
+    }
+    if ((unitBytes != c_frameSize) || (m_hunkBytes == 0) || ((m_hunkBytes % c_frameSize) != 0)) {
+        m_error = "This CHD file isn't a CD image";
+        return false;
+    }
+    const uint64_t hunkCount = (m_logicalBytes + m_hunkBytes - 1) / m_hunkBytes;
+    // Far more than even a DVD would need
+    if ((hunkCount == 0) || (hunkCount > (1 << 24))) {
+        m_error = "Invalid CHD file size";
+        return false;
+    }
+    m_hunkCount = hunkCount;
+    m_framesPerHunk = m_hunkBytes / c_frameSize;
+    return true;
+}
+
+bool PCSX::CHD::readMap() {
+    m_map.resize(m_hunkCount);
+    if (m_codecs[0] != 0) return readCompressedMap();
+
+    // Uncompressed images just have the position of each hunk, in hunks
+    std::vector<uint8_t> raw(m_hunkCount * 4);
+    if (m_file->readAt(raw.data(), raw.size(), m_mapOffset) != ssize_t(raw.size())) {
+        m_error = "Couldn't read the CHD map";
+        return false;
+    }
+    for (uint32_t hunk = 0; hunk < m_hunkCount; hunk++) {
+        const uint32_t offset = be32(raw.data() + hunk * 4);
+        m_map[hunk] = {uint64_t(offset) * m_hunkBytes, m_hunkBytes, 0, offset ? UNCOMPRESSED : ZEROES};
+    }
+    return true;
+}
+
+bool PCSX::CHD::readCompressedMap() {
+    uint8_t header[16];
+    if (m_file->readAt(header, sizeof(header), m_mapOffset) != sizeof(header)) {
+        m_error = "Couldn't read the CHD map";
+        return false;
+    }
+    const uint32_t mapBytes = be32(header);
+    uint64_t offset = be48(header + 4);
+    const uint16_t mapCRC = be16(header + 10);
+    const unsigned lengthBits = header[12];
+    const unsigned selfBits = header[13];
+    const unsigned parentBits = header[14];
+    std::vector<uint8_t> compressed(mapBytes);
+    if ((lengthBits > 32) || (selfBits > 32) || (parentBits > 32) ||
+        (m_file->readAt(compressed.data(), mapBytes, m_mapOffset + sizeof(header)) != ssize_t(mapBytes))) {
+        m_error = "Couldn't read the CHD map";
+        return false;
+    }
+
+    BitReader bits(compressed.data(), compressed.size());
+    HuffmanDecoder decoder;
+    if (!decoder.importTreeRLE(bits)) {
+        m_error = "Corrupted CHD map";
+        return false;
+    }
+
+    // First, all of the compression types, with runs of the same one compressed...
+    uint8_t last = TYPE_0;
+    unsigned repeat = 0;
+    for (auto& entry : m_map) {
+        if (repeat > 0) {
+            entry.compression = last;
+            repeat--;
+            continue;
+        }
+        const unsigned value = decoder.decode(bits);
+        if (value == RLE_SMALL) {
+            entry.compression = last;
+            repeat = 2 + decoder.decode(bits);
+        } else if (value == RLE_LARGE) {
+            entry.compression = last;
+            repeat = 2 + 16 + (decoder.decode(bits) << 4);
+            repeat += decoder.decode(bits);
+        } else {
+            entry.compression = last = value;
+        }
+    }
+
+    // ... then what each of them needs to be found
+    uint64_t lastSelf = 0;
+    uint64_t lastParent = 0;
+    std::vector<uint8_t> raw(m_hunkCount * c_mapEntrySize);
+    for (uint32_t hunk = 0; hunk < m_hunkCount; hunk++) {
+        auto& entry = m_map[hunk];
+        entry.offset = offset;
+        entry.length = 0;
+        entry.crc = 0;
+        switch (entry.compression) {
+            case TYPE_0:
+            case TYPE_1:
+            case TYPE_2:
+            case TYPE_3:
+                entry.length = bits.read(lengthBits);
+                offset += entry.length;
+                entry.crc = bits.read(16);
+                break;
+            case NONE:
+                entry.length = m_hunkBytes;
+                offset += entry.length;
+                entry.crc = bits.read(16);
+                break;
+            case SELF:
+                entry.offset = lastSelf = bits.read(selfBits);
+                break;
+            case PARENT:
+                entry.offset = lastParent = bits.read(parentBits);
+                break;
+            case SELF_1:
+                lastSelf++;
+                [[fallthrough]];
+            case SELF_0:
+                entry.compression = SELF;
+                entry.offset = lastSelf;
+                break;
+            case PARENT_SELF:
+                entry.compression = PARENT;
+                entry.offset = lastParent = (uint64_t(hunk) * m_hunkBytes) / c_frameSize;
+                break;
+            case PARENT_1:
+                lastParent += m_hunkBytes / c_frameSize;
+                [[fallthrough]];
+            case PARENT_0:
+                entry.compression = PARENT;
+                entry.offset = lastParent;
+                break;
+            default:
+        m_error = "Corrupted CHD map";
+                return false;
+        }
+        // The checksum is over the map as it'd be stored uncompressed
+        uint8_t* rawEntry = raw.data() + hunk * c_mapEntrySize;
+        rawEntry[0] = entry.compression;
+        for (unsigned i = 0; i < 3; i++) rawEntry[1 + i] = entry.length >> (16 - i * 8);
+        for (unsigned i = 0; i < 6; i++) rawEntry[4 + i] = entry.offset >> (40 - i * 8);
+        rawEntry[10] = entry.crc >> 8;
+        rawEntry[11] = entry.crc;
+    }
+    if (bits.overflowed() || (crc16(raw.data(), raw.size()) != mapCRC)) {
+        m_error = "Corrupted CHD map";
+        return false;
+    }
+
+    std::string unsupported;
+    for (const auto& entry : m_map) {
+        if (entry.compression == PARENT) {
+            m_error = "CHD images depending on a parent image aren't supported";
+            return false;
+        }
+        if (entry.compression > TYPE_3) continue;
+        const uint32_t codec = m_codecs[entry.compression];
+        if ((codec == c_codecZlib) || (codec == c_codecLZMA) || (codec == c_codecCDZlib) ||
+            (codec == c_codecCDLZMA) || (codec == c_codecCDFLAC)) {
+            continue;
+        }
+        if (unsupported.find(tagName(codec)) == std::string::npos) {
+            if (!unsupported.empty()) unsupported += ", ";
+            unsupported += tagName(codec);
+        }
+    }
+    if (!unsupported.empty()) {
+        m_error =
+            "Unsupported CHD compression: " + unsupported + "; only zlib, lzma, cdzl, cdlz and cdfl are supported";
+        return false;
+    }
+    return true;
+}
+
+bool PCSX::CHD::readMetadata() {
+    uint32_t frame = 0;
+    uint64_t offset = m_metaOffset;
+    // The metadata are a linked list, which could loop if corrupted
+    for (unsigned entries = 0; offset && (entries < 1024); entries++) {
+        uint8_t header[16];
+        if (m_file->readAt(header, sizeof(header), offset) != sizeof(header)) {
+            m_error = "Couldn't read the CHD metadata";
+            return false;
+        }
+        const uint32_t tag = be32(header);
+        const uint32_t length = be24(header + 5);
+        const uint64_t next = be64(header + 8);
+        if ((tag == c_metaTrack) || (tag == c_metaTrack2)) {
+            std::string text(length, '\0');
+            if (m_file->readAt(text.data(), length, offset + sizeof(header)) != ssize_t(length)) {
+                m_error = "Couldn't read the CHD metadata";
+                return false;
+            }
+            int number = 0, frames = 0, pregap = 0, postgap = 0;
+            char type[32] = {}, subtype[32] = {}, pregapType[32] = {}, pregapSubtype[32] = {};
+            int fields = 0;
+            if (tag == c_metaTrack2) {
+                fields = sscanf(text.c_str(),
+                                "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d PREGAP:%d PGTYPE:%31s PGSUB:%31s POSTGAP:%d",
+                                &number, type, subtype, &frames, &pregap, pregapType, pregapSubtype, &postgap);
+            } else {
+                fields = sscanf(text.c_str(), "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d", &number, type, subtype,
+                                &frames);
+            }
+            if ((fields < 4) || (number != int(m_tracks.size() + 1)) || (frames <= 0) || (pregap < 0) ||
+                (postgap < 0)) {
+                m_error = "Invalid CHD track metadata";
+                return false;
+            }
+            Track track;
+            if (strcmp(type, "AUDIO") == 0) {
+                track.type = Track::Type::AUDIO;
+            } else if ((strcmp(type, "MODE1_RAW") == 0) || (strcmp(type, "MODE2_RAW") == 0)) {
+                track.type = Track::Type::DATA;
+            } else {
+                m_error = std::string("Unsupported CHD track type ") + type + ", only raw tracks are supported";
+                return false;
+            }
+            track.subcodeRaw = strcmp(subtype, "RW_RAW") == 0;
+            track.subcode = track.subcodeRaw || (strcmp(subtype, "RW") == 0);
+            track.frames = frames;
+            track.pregap = pregap;
+            // The pregap is only in the image if its type says so
+            track.pregapStored = pregapType[0] == 'V';
+            track.postgap = postgap;
+            track.firstFrame = frame;
+            if (track.pregapStored && (track.pregap > track.frames)) {
+                m_error = "Invalid CHD track metadata";
+                return false;
+            }
+            frame += (track.frames + 3) & ~3;
+            m_tracks.push_back(track);
+        }
+        offset = next;
+    }
+    if (m_tracks.empty()) {
+        m_error = "This CHD file doesn't have any CD tracks";
+        return false;
+    }
+    if (m_tracks.back().firstFrame + m_tracks.back().frames > uint64_t(m_hunkCount) * m_framesPerHunk) {
+        m_error = "The CHD tracks go beyond the end of the image";
+        return false;
+    }
+    return true;
+}
+
+bool PCSX::CHD::readCompressed(uint64_t offset, uint32_t length, std::vector<uint8_t>& buffer) {
+    buffer.resize(length);
+    std::unique_lock<std::mutex> lock(m_fileMutex);
+    return m_file->readAt(buffer.data(), length, offset) == ssize_t(length);
+}
+
+bool PCSX::CHD::decompressHunk(uint32_t hunk, uint8_t* dest, Decompressor& decompressor) {
+    ZoneScoped;
+    const auto& entry = m_map[hunk];
+    auto& compressed = decompressor.m_compressed;
+    switch (entry.compression) {
+        case ZEROES:
+            memset(dest, 0, m_hunkBytes);
+            return true;
+        case UNCOMPRESSED: {
+            std::unique_lock<std::mutex> lock(m_fileMutex);
+            return m_file->readAt(dest, m_hunkBytes, entry.offset) == ssize_t(m_hunkBytes);
+        }
+        case NONE: {
+            std::unique_lock<std::mutex> lock(m_fileMutex);
+            if (m_file->readAt(dest, m_hunkBytes, entry.offset) != ssize_t(m_hunkBytes)) return false;
+            break;
+        }
+        case SELF:
+            // A copy of a hunk we've seen before
+            if (entry.offset >= hunk) return false;
+            return decompressHunk(entry.offset, dest, decompressor);
+        case TYPE_0:
+        case TYPE_1:
+        case TYPE_2:
+        case TYPE_3: {
+            if (!readCompressed(entry.offset, entry.length, compressed)) return false;
+            const uint32_t codec = m_codecs[entry.compression];
+            if (codec == c_codecZlib) {
+                if (!Decompressor::inflate(decompressor.m_base, compressed.data(), entry.length, dest, m_hunkBytes)) {
+                    return false;
+                }
+            } else if (codec == c_codecLZMA) {
+                if (!decompressor.m_lzma.decode(compressed.data(), entry.length, dest, m_hunkBytes)) return false;
+            } else if (!decompressCD(codec, compressed.data(), entry.length, dest, decompressor)) {
+                return false;
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+    return crc16(dest, m_hunkBytes) == entry.crc;
+}
+
+// The CD codecs compress the sectors and the subcodes separately, the subcodes always with deflate. cdzl and cdlz
+// also flag the sectors which had their sync header and ECC removed, which need to be computed back. cdfl is only
+// ever used for audio, which has neither, and its subcodes start right where the last FLAC frame ends.
+bool PCSX::CHD::decompressCD(uint32_t codec, const uint8_t* src, uint32_t length, uint8_t* dest,
+                             Decompressor& decompressor) {
+    const unsigned frames = m_framesPerHunk;
+    uint8_t* sectors = decompressor.m_frames.data();
+    uint8_t* subcodes = sectors + frames * c_sectorSize;
+    unsigned headerBytes = 0;
+    uint32_t baseLength = 0;
+
+    if (codec == c_codecCDFLAC) {
+        // Stereo samples of 16 bits, which the sectors store as big endian
+        int16_t* samples = reinterpret_cast<int16_t*>(sectors);
+        baseLength = decompressor.m_flac.decode(src, length, samples, frames * c_sectorSize / 4);
+        if (baseLength == 0) return false;
+        for (unsigned i = 0; i < frames * c_sectorSize / 2; i++) {
+            const uint16_t sample = samples[i];
+            sectors[i * 2] = sample >> 8;
+            sectors[i * 2 + 1] = sample;
+        }
+    } else {
+        const unsigned lengthBytes = (m_hunkBytes < 65536) ? 2 : 3;
+        const unsigned eccBytes = (frames + 7) / 8;
+        headerBytes = eccBytes + lengthBytes;
+        if (length < headerBytes) return false;
+        baseLength = be16(src + eccBytes);
+        if (lengthBytes > 2) baseLength = (baseLength << 8) | src[eccBytes + 2];
+        if (headerBytes + baseLength > length) return false;
+        const uint8_t* base = src + headerBytes;
+        if (codec == c_codecCDZlib) {
+            if (!Decompressor::inflate(decompressor.m_base, base, baseLength, sectors, frames * c_sectorSize)) {
+                return false;
+            }
+        } else if (codec == c_codecCDLZMA) {
+            if (!decompressor.m_lzma.decode(base, baseLength, sectors, frames * c_sectorSize)) return false;
+        } else {
+            return false;
+        }
+    }
+
+    const uint32_t subcodeOffset = headerBytes + baseLength;
+    if (!Decompressor::inflate(decompressor.m_subcode, src + subcodeOffset, length - subcodeOffset, subcodes,
+                               frames * c_subcodeSize)) {
+        return false;
+    }
+    for (unsigned frame = 0; frame < frames; frame++) {
+        uint8_t* out = dest + frame * c_frameSize;
+        memcpy(out, sectors + frame * c_sectorSize, c_sectorSize);
+        memcpy(out + c_sectorSize, subcodes + frame * c_subcodeSize, c_subcodeSize);
+        if (headerBytes && (src[frame / 8] & (1 << (frame % 8)))) {
+            memcpy(out, c_syncHeader, sizeof(c_syncHeader));
+            generateECC(out);
+        }
+    }
+    return true;
+}
+
+bool PCSX::CHD::readFrame(uint32_t frame, uint8_t* dest) {
+    if (failed()) return false;
+    return m_cache->read(frame / m_framesPerHunk, (frame % m_framesPerHunk) * c_frameSize, dest, c_frameSize);
+}
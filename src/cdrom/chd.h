@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cdrom/blockcache.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// Reads CD images in MAME's CHD format, version 5. The image is split in hunks of a few frames each, which
+// are compressed independently, and go through a BlockCache, so that reading sequentially mostly never has
+// to wait on decompression. The zlib, LZMA and FLAC based codecs are supported, which is what chdman uses for
+// CDs by default: images having hunks compressed with anything else, such as zstd, or referring to a parent image,
+// will fail to open.
+class CHD {
+  public:
+    // Each frame holds a 2352 bytes sector, followed by its 96 bytes of raw subcode.
+    static constexpr unsigned c_frameSize = 2448;
+    static constexpr unsigned c_sectorSize = 2352;
+    static constexpr unsigned c_subcodeSize = 96;
+
+    struct Track {
+        enum class Type { DATA, AUDIO } type = Type::DATA;
+        // The subcode is either deinterleaved already, or raw, as it's on the disc.
+        bool subcode = false;
+        bool subcodeRaw = false;
+        // The frames stored in the image, including the pregap if pregapStored is set.
+        uint32_t frames = 0;
+        uint32_t pregap = 0;
+        bool pregapStored = false;
+        uint32_t postgap = 0;
+        // The frame of the image the track starts at; tracks are padded to a multiple of 4 frames.
+        uint32_t firstFrame = 0;
+    };
+
+    // With 0 workers, picks a number based on the host's cores.
+    CHD(IO<File> file, unsigned workers = 0);
+
+    bool failed() const { return !m_error.empty(); }
+    const std::string& error() const { return m_error; }
+    const std::vector<Track>& tracks() const { return m_tracks; }
+
+    // Copies c_frameSize bytes of this frame into dest. Only one thread at a time may call this.
+    bool readFrame(uint32_t frame, uint8_t* dest);
+
+    // How many frames were read from a hunk that was already decompressed, or that had to be decompressed.
+    uint64_t hits() const { return m_cache ? m_cache->hits() : 0; }
+    uint64_t misses() const { return m_cache ? m_cache->misses() : 0; }
+
+  private:
+    struct MapEntry {
+        uint64_t offset;
+        uint32_t length;
+        uint16_t crc;
+        uint8_t compression;
+    };
+    class Decompressor;
+
+    bool parseHeader();
+    bool readMap();
+    bool readCompressedMap();
+    bool readMetadata();
+    bool decompressHunk(uint32_t hunk, uint8_t* dest, Decompressor& decompressor);
+    bool decompressCD(uint32_t codec, const uint8_t* src, uint32_t length, uint8_t* dest, Decompressor& decompressor);
+    bool readCompressed(uint64_t offset, uint32_t length, std::vector<uint8_t>& buffer);
+
+    IO<File> m_file;
+    std::mutex m_fileMutex;
+    std::string m_error;
+
+    uint32_t m_codecs[4] = {};
+    uint64_t m_logicalBytes = 0;
+    uint64_t m_mapOffset = 0;
+    uint64_t m_metaOffset = 0;
+    uint32_t m_hunkBytes = 0;
+    uint32_t m_hunkCount = 0;
+    uint32_t m_framesPerHunk = 0;
+    std::vector<MapEntry> m_map;
+    std::vector<Track> m_tracks;
+
+    // Last, so that its workers are gone before anything they use
+    std::unique_ptr<BlockCache> m_cache;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/dischasher.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+
+#include "cdrom/cdriso.h"
+#include "support/hashing.h"
+#include "support/md5.h"
+#include "support/sha1.h"
+
+PCSX::DiscHasher::DiscHasher(std::vector<uint32_t> trackSectors, Reader&& reader) : m_reader(std::move(reader)) {
+    m_tracks.resize(trackSectors.size());
+    for (unsigned t = 0; t < trackSectors.size(); t++) {
+        m_tracks[t].sectors = trackSectors[t];
+        m_totalSectors += trackSectors[t];
+    }
+    for (auto& chunk : m_chunks) chunk.data.reset(new uint8_t[c_chunkSectors * c_sectorSize]);
+    m_running = HASH_COUNT + 1;
+    m_threads.emplace_back([this]() { readerThread(); });
+    for (unsigned h = 0; h < HASH_COUNT; h++) m_threads.emplace_back([this, h]() { hasherThread(Hash(h)); });
+}
+
+PCSX::DiscHasher::DiscHasher(std::shared_ptr<CDRIso> iso)
+    : DiscHasher(
+          [&iso]() {
+              std::vector<uint32_t> trackSectors;
+              for (unsigned t = 1; t <= iso->getTN(); t++) trackSectors.push_back(iso->getLength(t).toLBA());
+              return trackSectors;
+          }(),
+          [iso](uint32_t lba, uint8_t* data, unsigned count) { return iso->readSectors(lba, data, count) == count; }) {
+}
+
+PCSX::DiscHasher::~DiscHasher() {
+    cancel();
+    for (auto& thread : m_threads) thread.join();
+}
+
+void PCSX::DiscHasher::cancel() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cancel.store(true, std::memory_order_relaxed);
+    }
+    m_cv.notify_all();
+}
+
+float PCSX::DiscHasher::progress() const {
+    if (m_totalSectors == 0) return 1.0f;
+    uint32_t slowest = m_totalSectors;
+    for (auto& hashed : m_sectorsHashed) slowest = std::min(slowest, hashed.load(std::memory_order_relaxed));
+    return float(slowest) / float(m_totalSectors);
+}
+
+uint32_t PCSX::DiscHasher::fullCRC32() const {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    for (auto& track : m_tracks) {
+        crc = crc32_combine(crc, track.crc32, z_off_t(track.sectors) * c_sectorSize);
+    }
+    return crc;
+}
+
+std::string PCSX::DiscHasher::toHex(const uint8_t* digest, unsigned size) {
+    static const char c_digits[] = "0123456789abcdef";
+    std::string ret;
+    for (unsigned i = 0; i < size; i++) {
+        ret += c_digits[digest[i] >> 4];
+        ret += c_digits[digest[i] & 15];
+    }
+    return ret;
+}
+
+void PCSX::DiscHasher::readerThread() {
+    uint32_t lba = 0;
+    uint64_t n = 0;
+    bool failed = false;
+
+    auto publish = [this, &n](unsigned track, unsigned sectors, bool lastOfTrack) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto& chunk = m_chunks[n % c_slots];
+        chunk.track = track;
+        chunk.sectors = sectors;
+        chunk.lastOfTrack = lastOfTrack;
+        m_read = ++n;
+        m_cv.notify_all();
+    };
+    auto waitForSlot = [this, &n]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this, &n]() {
+            if (m_cancel.load(std::memory_order_relaxed)) return true;
+            if (n < c_slots) return true;
+            return std::all_of(std::begin(m_hashed), std::end(m_hashed),
+                               [&n](uint64_t hashed) { return hashed > n - c_slots; });
+        });
+        return !m_cancel.load(std::memory_order_relaxed);
+    };
+
+    for (unsigned t = 0; (t < m_tracks.size()) && !failed; t++) {
+        uint32_t left = m_tracks[t].sectors;
+        // Empty tracks still need their hashes finished
+        if (left == 0) {
+            if (!waitForSlot()) break;
+            publish(t, 0, true);
+            continue;
+        }
+        while (left) {
+            if (!waitForSlot()) {
+                failed = true;
+                break;
+            }
+            const unsigned sectors = std::min(left, c_chunkSectors);
+            uint8_t* data = m_chunks[n % c_slots].data.get();
+            for (unsigned s = 0; s < sectors; s += c_readSectors) {
+                const unsigned count = std::min(sectors - s, c_readSectors);
+                if (m_cancel.load(std::memory_order_relaxed) || !m_reader(lba + s, data + s * c_sectorSize, count)) {
+                    failed = true;
+                    break;
+                }
+            }
+            if (failed) break;
+            lba += sectors;
+            left -= sectors;
+            publish(t, sectors, left == 0);
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (failed && !m_cancel.load(std::memory_order_relaxed)) {
+            m_status.store(Status::FAILED, std::memory_order_release);
+            m_cancel.store(true, std::memory_order_relaxed);
+        }
+        m_readerDone = true;
+    }
+    m_cv.notify_all();
+    finished();
+}
+
+void PCSX::DiscHasher::hasherThread(Hash hash) {
+    uint32_t crc = 0;
+    MD5 md5;
+    SHA1 sha1;
+
+    for (uint64_t n = 0;; n++) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this, n]() {
+                return m_cancel.load(std::memory_order_relaxed) || m_readerDone || (m_read > n);
+            });
+            if (m_cancel.load(std::memory_order_relaxed) || (m_read <= n)) break;
+        }
+
+        // The reader won't touch this slot until we're done with it, so it can be worked on without the lock
+        const auto& chunk = m_chunks[n % c_slots];
+        const uint8_t* data = chunk.data.get();
+        const unsigned size = chunk.sectors * c_sectorSize;
+        auto& track = m_tracks[chunk.track];
+        switch (hash) {
+            case HASH_CRC32:
+                crc = Hashing::crc32(crc, data, size);
+                if (chunk.lastOfTrack) {
+                    track.crc32 = crc;
+                    crc = 0;
+                }
+                break;
+            case HASH_MD5:
+                md5.update(data, size);
+                if (chunk.lastOfTrack) {
+                    md5.finish(track.md5);
+                    md5 = MD5();
+                }
+                break;
+            case HASH_SHA1:
+                sha1.update(data, size);
+                if (chunk.lastOfTrack) {
+                    sha1.finish(track.sha1);
+                    sha1 = SHA1();
+                }
+                break;
+        }
+        m_sectorsHashed[hash].fetch_add(chunk.sectors, std::memory_order_relaxed);
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_hashed[hash] = n + 1;
+        }
+        m_cv.notify_all();
+    }
+
+    finished();
+}
+
+void PCSX::DiscHasher::finished() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (--m_running) return;
+    if (m_status.load(std::memory_order_relaxed) != Status::RUNNING) return;
+    m_status.store(m_cancel.load(std::memory_order_relaxed) ? Status::CANCELLED : Status::DONE,
+                   std::memory_order_release);
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PCSX {
+
+class CDRIso;
+
+// Hashes every track of a disc image in the background, like redump lists them: the CRC32, MD5 and SHA1
+// of the raw sectors of each track. One thread reads the image in chunks, and each of the three hashes
+// gets its own thread going through these chunks in order, so that a disc only takes about as long as its
+// slowest hash. Everything is started by the constructor, and the rest can be polled from any thread.
+class DiscHasher {
+  public:
+    // Reads count raw sectors starting at lba into data, and returns false if any of them couldn't be read.
+    using Reader = std::function<bool(uint32_t lba, uint8_t* data, unsigned count)>;
+    enum class Status { RUNNING, DONE, CANCELLED, FAILED };
+
+    struct TrackHashes {
+        uint32_t sectors = 0;
+        uint32_t crc32 = 0;
+        uint8_t md5[16] = {};
+        uint8_t sha1[20] = {};
+
+        std::string md5String() const { return toHex(md5, sizeof(md5)); }
+        std::string sha1String() const { return toHex(sha1, sizeof(sha1)); }
+    };
+
+    // The tracks are back to back, starting at lba 0, and are this many sectors long.
+    DiscHasher(std::vector<uint32_t> trackSectors, Reader&& reader);
+    DiscHasher(std::shared_ptr<CDRIso> iso);
+    ~DiscHasher();
+
+    void cancel();
+    Status status() const { return m_status.load(std::memory_order_acquire); }
+    float progress() const;
+    // These are only valid once the status is DONE. Track 1 is at index 0.
+    const std::vector<TrackHashes>& tracks() const { return m_tracks; }
+    uint32_t fullCRC32() const;
+
+  private:
+    // A little over half a megabyte per chunk, but read c_readSectors at a time, so that whoever else is
+    // reading the image, such as the emulated drive, doesn't wait too long for its turn.
+    static constexpr unsigned c_chunkSectors = 256;
+    static constexpr unsigned c_readSectors = 16;
+    static constexpr unsigned c_slots = 8;
+    static constexpr unsigned c_sectorSize = 2352;
+    enum Hash { HASH_CRC32, HASH_MD5, HASH_SHA1, HASH_COUNT };
+
+    static std::string toHex(const uint8_t* digest, unsigned size);
+
+    struct Chunk {
+        unsigned track = 0;
+        unsigned sectors = 0;
+        bool lastOfTrack = false;
+        std::unique_ptr<uint8_t[]> data;
+    };
+
+    void readerThread();
+    void hasherThread(Hash hash);
+    void finished();
+
+    Reader m_reader;
+    std::vector<TrackHashes> m_tracks;
+    uint32_t m_totalSectors = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    Chunk m_chunks[c_slots];
+    // How many chunks were read, and how many each hash went through; chunk n lives in slot n % c_slots,
+    // which the reader can only reuse once every hash is done with the chunk that was there before.
+    uint64_t m_read = 0;
+    uint64_t m_hashed[HASH_COUNT] = {};
+    bool m_readerDone = false;
+    unsigned m_running = 0;
+
+    std::atomic<bool> m_cancel = false;
+    std::atomic<Status> m_status = Status::RUNNING;
+    std::atomic<uint32_t> m_sectorsHashed[HASH_COUNT] = {};
+    std::vector<std::thread> m_threads;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,247 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/ecmindex.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+constexpr char c_magic[8] = {'P', 'C', 'S', 'X', 'E', 'C', 'M', 'I'};
+constexpr uint32_t c_version = 1;
+// Each checkpoint is saved as its filepos, remaining and type, little endian
+constexpr size_t c_entrySize = 9;
+constexpr uint64_t c_sectorSize = 2352;
+
+}  // namespace
+
+PCSX::ECMIndex::ECMIndex(IO<File> file, const std::filesystem::path& sidecar)
+    : m_file(file), m_sidecar(sidecar), m_checkpoints(c_maxSectors) {
+    m_checkpoints[0].filepos = c_headerSize;
+}
+
+void PCSX::ECMIndex::start() {
+    if (m_thread.joinable() || complete()) return;
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this]() {
+        if (build()) save();
+    });
+}
+
+void PCSX::ECMIndex::stop() {
+    m_stop.store(true, std::memory_order_relaxed);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool PCSX::ECMIndex::build() {
+    constexpr size_t c_chunkSize = 65536;
+    const uint64_t fileSize = m_file->size();
+    std::vector<uint8_t> buffer(c_chunkSize);
+    uint64_t bufferStart = 0;
+    size_t bufferSize = 0;
+    // Only the record headers get read, through a buffer, as they're mostly a single byte each.
+    auto getc = [&](uint64_t pos) -> int {
+        if ((pos < bufferStart) || (pos >= bufferStart + bufferSize)) {
+            if (pos >= fileSize) return -1;
+            bufferStart = pos;
+            ssize_t r = m_file->readAt(buffer.data(), std::min(c_chunkSize, size_t(fileSize - pos)), pos);
+            bufferSize = std::max(r, ssize_t(0));
+            if (bufferSize == 0) return -1;
+        }
+        return buffer[pos - bufferStart];
+    };
+
+    // Committing them in batches, so that the decoder doesn't wait on us too often.
+    std::vector<std::pair<uint32_t, Checkpoint>> batch;
+    auto flush = [&]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (auto& [sector, checkpoint] : batch) {
+            if (!m_checkpoints[sector].filepos) m_checkpoints[sector] = checkpoint;
+        }
+        batch.clear();
+    };
+    auto mark = [&](uint64_t decoded, uint64_t filepos, uint64_t remaining, int8_t type) {
+        batch.emplace_back(uint32_t(decoded / c_sectorSize), Checkpoint{uint32_t(filepos), uint32_t(remaining), type});
+        if (batch.size() >= 4096) flush();
+    };
+
+    uint64_t decoded = 0;
+    uint64_t pos = c_headerSize;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        int c = getc(pos++);
+        if (c < 0) break;
+        const int8_t type = c & 3;
+        uint32_t num = (c >> 2) & 0x1f;
+        int bits = 5;
+        bool corrupt = false;
+        while (c & 0x80) {
+            c = getc(pos++);
+            if ((c < 0) || (bits > 31) || ((uint32_t)(c & 0x7f)) >= (((uint32_t)0x80000000LU) >> (bits - 1))) {
+                corrupt = true;
+                break;
+            }
+            num |= ((uint32_t)(c & 0x7f)) << bits;
+            bits += 7;
+        }
+        if (corrupt) break;
+        if (num == 0xffffffff) {
+            flush();
+            m_sectors.store(decoded / c_sectorSize, std::memory_order_release);
+            m_complete.store(true, std::memory_order_release);
+            return true;
+        }
+
+        const uint64_t count = uint64_t(num) + 1;
+        const uint64_t decodedEnd = decoded + count * c_decodedSizes[type];
+        const uint64_t end = pos + count * c_encodedSizes[type];
+        if ((decodedEnd > c_maxSectors * c_sectorSize) || (end > fileSize) || (end > UINT32_MAX)) break;
+        if (type == 0) {
+            // Raw bytes can be resumed from anywhere
+            for (uint64_t offset = (decoded + c_sectorSize - 1) / c_sectorSize * c_sectorSize; offset < decodedEnd;
+                 offset += c_sectorSize) {
+                mark(offset, pos + offset - decoded, decodedEnd - offset, 0);
+            }
+        } else {
+            // Sectors can be resumed from any of them, but mode 2 ones don't always end on a sector boundary
+            for (uint64_t i = 0; i < count; i++) {
+                const uint64_t offset = decoded + i * c_decodedSizes[type];
+                if ((offset % c_sectorSize) == 0) mark(offset, pos + i * c_encodedSizes[type], count - i, type);
+            }
+        }
+        pos = end;
+        decoded = decodedEnd;
+    }
+    flush();
+    return false;
+}
+
+uint32_t PCSX::ECMIndex::tailChecksum() {
+    const size_t size = m_file->size();
+    const size_t length = std::min(size, size_t(65536));
+    std::vector<uint8_t> tail(length);
+    if (m_file->readAt(tail.data(), length, size - length) != ssize_t(length)) return 0;
+    return crc32(0L, tail.data(), length);
+}
+
+bool PCSX::ECMIndex::load() {
+    IO<File> in(new PosixFile(m_sidecar));
+    if (in->failed()) return false;
+    if (in->readString(sizeof(c_magic)) != std::string(c_magic, sizeof(c_magic))) return false;
+    if (in->read<uint32_t>() != c_version) return false;
+    const uint32_t sectors = in->read<uint32_t>();
+    const uint64_t fileSize = in->read<uint64_t>();
+    const uint32_t checksum = in->read<uint32_t>();
+    const uint32_t compressedSize = in->read<uint32_t>();
+    if ((sectors == 0) || (sectors > c_maxSectors) || (compressedSize == 0)) return false;
+    // A cheap way to tell whether the sidecar is still for the same image
+    if ((fileSize != m_file->size()) || (checksum != tailChecksum())) return false;
+
+    std::vector<uint8_t> compressed(compressedSize);
+    if (in->read(compressed.data(), compressedSize) != ssize_t(compressedSize)) return false;
+    uLongf rawSize = sectors * c_entrySize;
+    std::vector<uint8_t> raw(rawSize);
+    if (uncompress(raw.data(), &rawSize, compressed.data(), compressedSize) != Z_OK) return false;
+    if (rawSize != sectors * c_entrySize) return false;
+
+    auto read32 = [](const uint8_t* p) -> uint32_t {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+    };
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (uint32_t sector = 0; sector < sectors; sector++) {
+        const uint8_t* entry = raw.data() + sector * c_entrySize;
+        auto& checkpoint = m_checkpoints[sector];
+        checkpoint.filepos = read32(entry);
+        checkpoint.remaining = read32(entry + 4);
+        checkpoint.type = entry[8] & 3;
+    }
+    m_checkpoints[0] = {c_headerSize, 0, 0};
+    m_sectors.store(sectors, std::memory_order_release);
+    m_complete.store(true, std::memory_order_release);
+    return true;
+}
+
+bool PCSX::ECMIndex::save() {
+    if (!complete()) return false;
+    const uint32_t sectors = m_sectors.load(std::memory_order_acquire);
+    if (sectors == 0) return false;
+    std::vector<uint8_t> raw(sectors * c_entrySize);
+    auto write32 = [](uint8_t* p, uint32_t v) {
+        p[0] = v;
+        p[1] = v >> 8;
+        p[2] = v >> 16;
+        p[3] = v >> 24;
+    };
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (uint32_t sector = 0; sector < sectors; sector++) {
+            uint8_t* entry = raw.data() + sector * c_entrySize;
+            const auto& checkpoint = m_checkpoints[sector];
+            write32(entry, checkpoint.filepos);
+            write32(entry + 4, checkpoint.remaining);
+            entry[8] = checkpoint.type;
+        }
+    }
+    uLongf compressedSize = compressBound(raw.size());
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, raw.data(), raw.size(), Z_BEST_COMPRESSION) != Z_OK) {
+        return false;
+    }
+
+    // Writing it whole somewhere else first, so that there's never half of a sidecar file lying around.
+    std::filesystem::path temporary = m_sidecar;
+    temporary += ".tmp";
+    {
+        IO<File> out(new PosixFile(temporary, FileOps::TRUNCATE));
+        if (out->failed()) return false;
+        out->write(c_magic, sizeof(c_magic));
+        out->write<uint32_t>(c_version);
+        out->write<uint32_t>(sectors);
+        out->write<uint64_t>(m_file->size());
+        out->write<uint32_t>(tailChecksum());
+        out->write<uint32_t>(compressedSize);
+        out->write(compressed.data(), compressedSize);
+        out->close();
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, m_sidecar, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+uint32_t PCSX::ECMIndex::find(uint32_t sector, Checkpoint& checkpoint) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    sector = std::min(sector, c_maxSectors - 1);
+    while ((sector > 0) && !m_checkpoints[sector].filepos) sector--;
+    checkpoint = m_checkpoints[sector];
+    return sector;
+}
+
+void PCSX::ECMIndex::add(uint32_t sector, const Checkpoint& checkpoint) {
+    if (sector >= c_maxSectors) return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_checkpoints[sector].filepos) m_checkpoints[sector] = checkpoint;
+}
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// Knows where to pick up decoding an ECM stream for any of its sectors, so that seeking doesn't mean going
+// through all of the sectors before the one we want. The stream is a list of records, each holding either
+// raw bytes, or a run of sectors of the same type, and a checkpoint can be either the header of a record,
+// or a sector boundary in the middle of one. Building the whole index means going through all of the
+// record headers once, which happens on a thread of its own, and the result gets saved in a file next to
+// the image, so it only ever needs to be done once. Until then, the decoder makes do with what's there.
+class ECMIndex {
+  public:
+    struct Checkpoint {
+        // Where to resume reading the stream. 0 means the sector doesn't have a checkpoint.
+        uint32_t filepos = 0;
+        // How many sectors, or bytes for raw records, are left in the record at filepos. If 0, filepos
+        // is the header of a record, and the type is meaningless.
+        uint32_t remaining = 0;
+        int8_t type = 0;
+    };
+
+    static constexpr uint32_t c_headerSize = 4;
+    // The longest known CD, 80 minutes
+    static constexpr uint32_t c_maxSectors = 75 * 80 * 60;
+    // How many bytes each unit of a record type takes in the stream, and once decoded
+    static constexpr uint32_t c_encodedSizes[4] = {1, 0x803, 0x804, 0x918};
+    static constexpr uint32_t c_decodedSizes[4] = {1, 2352, 2336, 2336};
+
+    // The file needs to be a handle of its own, as the thread building the index moves its read pointer.
+    ECMIndex(IO<File> file, const std::filesystem::path& sidecar);
+    ~ECMIndex() { stop(); }
+
+    // Builds the index on a thread of its own, then saves it.
+    void start();
+    void stop();
+    // Same as what the thread does, synchronously. Returns false if the stream ended unexpectedly.
+    bool build();
+    // Loads the index from the sidecar file. Returns false if there's none, or if it's for another image.
+    bool load();
+    bool save();
+
+    // Finds the closest checkpoint at or before this sector, and returns the sector it's for. The
+    // beginning of the stream is always a checkpoint, for sector 0.
+    uint32_t find(uint32_t sector, Checkpoint& checkpoint);
+    // Remembers a checkpoint the decoder found on its own, unless the sector already has one.
+    void add(uint32_t sector, const Checkpoint& checkpoint);
+
+    bool complete() const { return m_complete.load(std::memory_order_acquire); }
+    // How many sectors the image holds, once the index is complete.
+    uint32_t sectors() const { return m_sectors.load(std::memory_order_acquire); }
+
+  private:
+    uint32_t tailChecksum();
+
+    IO<File> m_file;
+    const std::filesystem::path m_sidecar;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::vector<Checkpoint> m_checkpoints;
+    std::atomic<uint32_t> m_sectors = 0;
+    std::atomic<bool> m_complete = false;
+    std::atomic<bool> m_stop = false;
+};
+
+}  // namespace PCSX
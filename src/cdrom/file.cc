@@ -22,7 +22,7 @@
 #include <magic_enum_all.hpp>
 
 #include "cdrom/cdriso.h"
-#include "iec-60908b/edcecc.h"
+#include "supportpsx/iec-60908b.h"
 
 PCSX::CDRIsoFile::CDRIsoFile(std::shared_ptr<CDRIso> iso, uint32_t lba, int32_t size, SectorMode mode)
     : File(RW_SEEKABLE), m_iso(iso), m_lba(lba) {
@@ -202,7 +202,7 @@ ssize_t PCSX::CDRIsoFile::write(const void* buffer_, size_t size) {
         switch (m_mode) {
             case SectorMode::M2_FORM1:
             case SectorMode::M2_FORM2:
-                compute_edcecc(patched);
+                IEC60908b::computeEDCECC(patched);
                 break;
         }
         ppf->calculatePatch(m_cachedSector, patched, msf);
@@ -19,9 +19,10 @@
 
 #include "cdrom/iso9660-builder.h"
 
+#include <algorithm>
 #include <stdexcept>
-
-#include "iec-60908b/edcecc.h"
+#include <thread>
+#include <vector>
 
 void PCSX::ISO9660Builder::writeLicense(IO<File> licenseFile) {
     if (licenseFile && !licenseFile->failed()) {
@@ -50,56 +51,134 @@ void PCSX::ISO9660Builder::writeLicense(IO<File> licenseFile) {
     }
 }
 
-PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeSectorAt(const uint8_t* sectorData, PCSX::IEC60908b::MSF msf,
-                                                         SectorMode mode) {
-    if (failed()) return {0, 0, 0};
-    Slice slice;
-    uint8_t* ptr;
-    static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
-    uint32_t lba = msf.toLBA() - 150;
+unsigned PCSX::ISO9660Builder::payloadSize(SectorMode mode) {
     switch (mode) {
         case SectorMode::RAW:
-            m_out->writeAt(sectorData, IEC60908b::FRAMESIZE_RAW, lba * IEC60908b::FRAMESIZE_RAW);
-            break;
+            return IEC60908b::FRAMESIZE_RAW;
         case SectorMode::M2_RAW:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            memcpy(ptr + 16, sectorData, 2336);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
+            return 2336;
         case SectorMode::M2_FORM1:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            ptr[16] = ptr[20] = 0;
-            ptr[17] = ptr[21] = 0;
-            ptr[18] = ptr[22] = 8;
-            ptr[19] = ptr[23] = 0;
-            memcpy(ptr + 24, sectorData, 2048);
-            compute_edcecc(ptr);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
+            return 2048;
         case SectorMode::M2_FORM2:
-            slice.resize(IEC60908b::FRAMESIZE_RAW);
-            ptr = slice.mutableData<uint8_t>();
-            memcpy(ptr, c_sync, sizeof(c_sync));
-            msf.toBCD(ptr + 12);
-            ptr[15] = 2;
-            ptr[16] = ptr[20] = 0;
-            ptr[17] = ptr[21] = 0;
-            ptr[18] = ptr[22] = 8;
-            ptr[19] = ptr[23] = 0;
-            memcpy(ptr + 24, sectorData, 2324);
-            compute_edcecc(ptr);
-            m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
-            break;
+            return 2324;
         default:
-            return {0, 0, 0};
+            return 0;
+    }
+}
+
+unsigned PCSX::ISO9660Builder::payloadOffset(SectorMode mode) {
+    switch (mode) {
+        case SectorMode::RAW:
+            return 0;
+        case SectorMode::M2_RAW:
+            return 16;
+        default:
+            return 24;
+    }
+}
+
+void PCSX::ISO9660Builder::writeHeader(uint8_t* ptr, IEC60908b::MSF msf, SectorMode mode) {
+    static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    if (mode == SectorMode::RAW) return;
+    memcpy(ptr, c_sync, sizeof(c_sync));
+    msf.toBCD(ptr + 12);
+    ptr[15] = 2;
+    if (mode == SectorMode::M2_RAW) return;
+    ptr[16] = ptr[20] = 0;
+    ptr[17] = ptr[21] = 0;
+    ptr[18] = ptr[22] = 8;
+    ptr[19] = ptr[23] = 0;
+}
+
+void PCSX::ISO9660Builder::computeEDCECC(uint8_t* sectors, unsigned count, SectorMode mode) {
+    if ((mode != SectorMode::M2_FORM1) && (mode != SectorMode::M2_FORM2)) return;
+    auto compute = [sectors](unsigned first, unsigned last) {
+        for (unsigned i = first; i < last; i++) IEC60908b::computeEDCECC(sectors + i * IEC60908b::FRAMESIZE_RAW);
+    };
+    unsigned threads = m_threads ? m_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::clamp(count / c_minSectorsPerThread, 1u, threads);
+    const unsigned perThread = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (unsigned first = perThread; first < count; first += perThread) {
+        workers.emplace_back(compute, first, std::min(first + perThread, count));
+    }
+    compute(0, std::min(perThread, count));
+    for (auto& worker : workers) worker.join();
+}
+
+void PCSX::ISO9660Builder::writeBatch(Slice&& batch, unsigned count, IEC60908b::MSF msf, SectorMode mode) {
+    uint8_t* sectors = batch.mutableData<uint8_t>();
+    const uint32_t lba = msf.toLBA() - 150;
+    for (unsigned i = 0; i < count; i++) writeHeader(sectors + i * IEC60908b::FRAMESIZE_RAW, msf++, mode);
+    computeEDCECC(sectors, count, mode);
+    m_out->writeAt(std::move(batch), lba * IEC60908b::FRAMESIZE_RAW);
+    if (msf > m_location) m_location = msf;
+}
+
+PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeSectors(const uint8_t* sectorData, unsigned count,
+                                                        SectorMode mode) {
+    const unsigned size = payloadSize(mode);
+    if (failed() || (size == 0)) return {0, 0, 0};
+    const auto ret = m_location;
+    const unsigned offset = payloadOffset(mode);
+    for (unsigned done = 0; done < count; done += c_batchSectors) {
+        const unsigned batchCount = std::min(count - done, c_batchSectors);
+        Slice batch;
+        batch.resize(batchCount * IEC60908b::FRAMESIZE_RAW);
+        uint8_t* sectors = batch.mutableData<uint8_t>();
+        for (unsigned i = 0; i < batchCount; i++) {
+            memcpy(sectors + i * IEC60908b::FRAMESIZE_RAW + offset, sectorData + (done + i) * size, size);
+        }
+        writeBatch(std::move(batch), batchCount, m_location, mode);
+    }
+    return ret;
+}
+PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeFile(IO<File> file, SectorMode mode) {
+    const unsigned size = payloadSize(mode);
+    if (failed() || (size == 0) || !file || file->failed()) return {0, 0, 0};
+    const auto ret = m_location;
+    const unsigned offset = payloadOffset(mode);
+    bool eof = false;
+    while (!eof) {
+        Slice batch;
+        batch.resize(c_batchSectors * IEC60908b::FRAMESIZE_RAW);
+        uint8_t* sectors = batch.mutableData<uint8_t>();
+        unsigned count = 0;
+        while ((count < c_batchSectors) && !eof) {
+            uint8_t* payload = sectors + count * IEC60908b::FRAMESIZE_RAW + offset;
+            ssize_t r = file->read(payload, size);
+            if (r <= 0) break;
+            if (r < size) {
+                memset(payload + r, 0, size - r);
+                eof = true;
+            }
+            count++;
+        }
+        if (count == 0) break;
+        if (count < c_batchSectors) {
+            eof = true;
+            batch.resize(count * IEC60908b::FRAMESIZE_RAW);
+        }
+        writeBatch(std::move(batch), count, m_location, mode);
+    }
+    return ret;
+}
+
+PCSX::IEC60908b::MSF PCSX::ISO9660Builder::writeSectorAt(const uint8_t* sectorData, PCSX::IEC60908b::MSF msf,
+                                                         SectorMode mode) {
+    const unsigned size = payloadSize(mode);
+    if (failed() || (size == 0)) return {0, 0, 0};
+    uint32_t lba = msf.toLBA() - 150;
+    if (mode == SectorMode::RAW) {
+        m_out->writeAt(sectorData, IEC60908b::FRAMESIZE_RAW, lba * IEC60908b::FRAMESIZE_RAW);
+    } else {
+        Slice slice;
+        slice.resize(IEC60908b::FRAMESIZE_RAW);
+        uint8_t* ptr = slice.mutableData<uint8_t>();
+        writeHeader(ptr, msf, mode);
+        memcpy(ptr + payloadOffset(mode), sectorData, size);
+        if ((mode == SectorMode::M2_FORM1) || (mode == SectorMode::M2_FORM2)) IEC60908b::computeEDCECC(ptr);
+        m_out->writeAt(std::move(slice), lba * IEC60908b::FRAMESIZE_RAW);
     }
     auto ret = msf;
     msf++;
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "cdrom/common.h"
 #include "support/file.h"
 #include "supportpsx/iec-60908b.h"
@@ -35,14 +37,36 @@ class ISO9660Builder {
         return writeSectorAt(sectorData, m_location, mode);
     }
     IEC60908b::MSF writeSectorAt(const uint8_t* sectorData, IEC60908b::MSF msf, SectorMode mode);
+    // Writes count consecutive sectors at the current location, in large writes, computing the EDC and
+    // ECC of the mode 2 sectors on several threads. Returns the location of the first sector.
+    IEC60908b::MSF writeSectors(const uint8_t* sectorData, unsigned count, SectorMode mode);
+    // Same, for the rest of this file, the last sector being padded with zeroes. The file gets read
+    // straight into the sectors about to be written.
+    IEC60908b::MSF writeFile(IO<File> file, SectorMode mode);
+    // How many threads writeSectors and writeFile may use; 0 means one per core.
+    void setThreads(unsigned threads) { m_threads = threads; }
     void close() {
         m_out->close();
         m_out = nullptr;
     }
 
   private:
+    static constexpr unsigned c_batchSectors = 256;
+    // Below this, computing the EDC and ECC is faster than waking up another thread.
+    static constexpr unsigned c_minSectorsPerThread = 32;
+
+    // How many bytes of the sector the caller provides, or 0 if this mode can't be written.
+    static unsigned payloadSize(SectorMode mode);
+    static unsigned payloadOffset(SectorMode mode);
+    static void writeHeader(uint8_t* sector, IEC60908b::MSF msf, SectorMode mode);
+    void computeEDCECC(uint8_t* sectors, unsigned count, SectorMode mode);
+    // Fills the headers and the EDC and ECC of this batch, whose payloads are already in place, and
+    // writes it at msf.
+    void writeBatch(Slice&& batch, unsigned count, IEC60908b::MSF msf, SectorMode mode);
+
     IO<File> m_out;
     IEC60908b::MSF m_location = {0, 2, 0};
+    unsigned m_threads = 0;
 };
 
 }  // namespace PCSX
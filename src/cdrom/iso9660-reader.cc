@@ -19,6 +19,8 @@
 
 #include "cdrom/iso9660-reader.h"
 
+#include <unordered_set>
+
 #include "cdrom/file.h"
 #include "cdrom/iso9660-lowlevel.h"
 #include "support/strings-helpers.h"
@@ -56,43 +58,73 @@ PCSX::ISO9660Reader::ISO9660Reader(std::shared_ptr<CDRIso> iso) : m_iso(iso) {
 }
 
 PCSX::File *PCSX::ISO9660Reader::open(const std::string_view &filename) {
-    auto entry = findEntry(filename);
-    if (!entry.has_value()) return new FailedFile();
-
-    return new CDRIsoFile(m_iso, entry.value().first.get<ISO9660LowLevel::DirEntry_LBA>(),
-                          entry.value().first.get<ISO9660LowLevel::DirEntry_Size>());
+    if (m_failed) return new FailedFile();
+    // The root directory isn't part of the index
+    if (StringsHelpers::split(filename, "/").empty()) {
+        const auto &root = m_pvd.get<ISO9660LowLevel::PVD_RootDir>();
+        return new CDRIsoFile(m_iso, root.get<ISO9660LowLevel::DirEntry_LBA>(),
+                              root.get<ISO9660LowLevel::DirEntry_Size>());
+    }
+    auto index = findIndex(filename);
+    if (!index.has_value()) return new FailedFile();
+    return open(index.value());
 }
 
-std::optional<PCSX::ISO9660Reader::FullDirEntry> PCSX::ISO9660Reader::findEntry(const std::string_view &filename) {
-    if (m_failed) return {};
-    auto parts = StringsHelpers::split(filename, "/");
-
-    FullDirEntry current;
-    current.first = m_pvd.get<ISO9660LowLevel::PVD_RootDir>();
-
-    for (auto &part : parts) {
-        auto entries = listAllEntriesFrom(current.first);
-        for (auto &entry : entries) {
-            const auto &entryFilename = entry.first.get<ISO9660LowLevel::DirEntry_Filename>().value;
-            if (entryFilename == part) {
-                current = entry;
-                break;
-            }
-        }
+PCSX::File *PCSX::ISO9660Reader::open(size_t index) {
+    buildIndex();
+    if (index >= m_index.size()) return new FailedFile();
+    const auto &entry = m_index[index];
+    return new CDRIsoFile(m_iso, entry.lba, entry.size);
+}
 
-        if (current.first.get<ISO9660LowLevel::DirEntry_Filename>() != part) return {};
+std::optional<size_t> PCSX::ISO9660Reader::findIndex(const std::string_view &path) {
+    buildIndex();
+    // Same path, without the extra slashes, so that "/DIR//FILE;1" finds "DIR/FILE;1"
+    std::string normalized;
+    for (auto &part : StringsHelpers::split(path, "/")) {
+        if (!normalized.empty()) normalized += '/';
+        normalized += part;
     }
+    auto it = m_paths.find(normalized);
+    if (it == m_paths.end()) return {};
+    return it->second;
+}
 
-    return current;
+void PCSX::ISO9660Reader::buildIndex() {
+    if (m_indexed || m_failed) return;
+    m_indexed = true;
+
+    // Breadth first, with the index itself as the queue; a directory only gets listed once, even if
+    // a broken or malicious image has several entries pointing to it, or entries pointing to a parent.
+    std::unordered_set<uint32_t> listed;
+    auto addEntries = [&](uint32_t lba, uint32_t size, const std::string &prefix) {
+        if (!listed.insert(lba).second) return;
+        for (auto &entry : listAllEntriesFrom(lba, size)) {
+            const std::string &filename = entry.first.get<ISO9660LowLevel::DirEntry_Filename>().value;
+            // The . and .. entries
+            if (filename.empty() || ((filename.size() == 1) && (filename[0] == 0 || filename[0] == 1))) continue;
+            std::string path = prefix.empty() ? filename : prefix + '/' + filename;
+            // Like a directory scan would, the first entry of a given name wins
+            if (m_paths.contains(path)) continue;
+            m_paths.emplace(path, m_index.size());
+            m_index.push_back({std::move(path), entry.first.get<ISO9660LowLevel::DirEntry_LBA>(),
+                               entry.first.get<ISO9660LowLevel::DirEntry_Size>(),
+                               (entry.first.get<ISO9660LowLevel::DirEntry_Flags>().value & 2) != 0});
+        }
+    };
+
+    const auto &root = m_pvd.get<ISO9660LowLevel::PVD_RootDir>();
+    addEntries(root.get<ISO9660LowLevel::DirEntry_LBA>(), root.get<ISO9660LowLevel::DirEntry_Size>(), "");
+    for (size_t i = 0; i < m_index.size(); i++) {
+        if (!m_index[i].isDirectory) continue;
+        // m_index may grow, so the path needs copying
+        addEntries(m_index[i].lba, m_index[i].size, std::string(m_index[i].path));
+    }
 }
 
-std::vector<PCSX::ISO9660Reader::FullDirEntry> PCSX::ISO9660Reader::listAllEntriesFrom(
-    const ISO9660LowLevel::DirEntry &dirEntry) {
+std::vector<PCSX::ISO9660Reader::FullDirEntry> PCSX::ISO9660Reader::listAllEntriesFrom(uint32_t lba, uint32_t size) {
     if (m_failed) return {};
-    if ((dirEntry.get<ISO9660LowLevel::DirEntry_Flags>().value & 2) == 0) return {};
-
-    IO<File> dir(new CDRIsoFile(m_iso, dirEntry.get<ISO9660LowLevel::DirEntry_LBA>(),
-                                dirEntry.get<ISO9660LowLevel::DirEntry_Size>()));
+    IO<File> dir(new CDRIsoFile(m_iso, lba, size));
 
     std::vector<FullDirEntry> ret;
     while (!dir->eof()) {
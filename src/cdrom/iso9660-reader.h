@@ -21,6 +21,8 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cdrom/file.h"
@@ -32,9 +34,31 @@ class CDRIso;
 
 class ISO9660Reader {
   public:
+    struct Entry {
+        // The full path, without any leading slash, and with the ;1 suffixes of the files.
+        std::string path;
+        uint32_t lba;
+        uint32_t size;
+        bool isDirectory;
+    };
+
     ISO9660Reader(std::shared_ptr<CDRIso>);
     bool failed() { return m_failed; }
     File* open(const std::string_view& filename);
+
+    // The first call to any of these walks the whole directory tree once, and remembers where everything
+    // is, so that looking up and opening files afterwards doesn't read any sector. Each directory comes
+    // before its contents, which are in the order the disc lists them.
+    size_t countEntries() {
+        buildIndex();
+        return m_index.size();
+    }
+    const Entry& getEntry(size_t index) {
+        buildIndex();
+        return m_index[index];
+    }
+    std::optional<size_t> findIndex(const std::string_view& path);
+    File* open(size_t index);
     std::string_view getLabel() {
         if (m_failed) return "";
         return std::string_view(m_pvd.get<ISO9660LowLevel::PVD_VolumeIdent>());
@@ -45,9 +69,13 @@ class ISO9660Reader {
     bool m_failed = false;
     typedef std::pair<ISO9660LowLevel::DirEntry, ISO9660LowLevel::DirEntry_XA> FullDirEntry;
 
-    std::optional<FullDirEntry> findEntry(const std::string_view& filename);
-    std::vector<FullDirEntry> listAllEntriesFrom(const ISO9660LowLevel::DirEntry& entry);
+    std::vector<FullDirEntry> listAllEntriesFrom(uint32_t lba, uint32_t size);
+    void buildIndex();
     ISO9660LowLevel::PVD m_pvd;
+
+    bool m_indexed = false;
+    std::vector<Entry> m_index;
+    std::unordered_map<std::string, size_t> m_paths;
 };
 
 }  // namespace PCSX
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "cdrom/readahead.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+
+PCSX::SectorReadAhead::SectorReadAhead(unsigned sectorSize, unsigned capacity, Reader&& reader)
+    : m_sectorSize(sectorSize),
+      m_capacity(capacity),
+      m_reader(std::move(reader)),
+      m_data(new uint8_t[sectorSize * capacity]),
+      m_success(new bool[capacity]),
+      m_depth(capacity) {}
+
+bool PCSX::SectorReadAhead::read(uint32_t sector, uint8_t* data) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_started) {
+        m_started = true;
+        // The reader may need to get to the emulator it's reading for, to log errors for instance.
+        m_thread = std::thread([this, context = EmulatorContext::current()]() {
+            EmulatorContext::Scope scope(context);
+            worker();
+        });
+    }
+
+    if ((m_count != 0) && (m_sector == sector)) {
+        // The worker only ever writes past the end of the ring, so the head is ours until we give it back.
+        const unsigned head = m_head;
+        lock.unlock();
+        memcpy(data, m_data.get() + head * m_sectorSize, m_sectorSize);
+        const bool success = m_success[head];
+        lock.lock();
+        m_head = (m_head + 1) % m_capacity;
+        m_count--;
+        m_sector++;
+        lock.unlock();
+        m_cv.notify_one();
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return success;
+    }
+
+    // Not what we read ahead, because of a seek, or because the worker didn't keep up.
+    m_head = 0;
+    m_count = 0;
+    m_sector = sector + 1;
+    m_generation++;
+    lock.unlock();
+    m_cv.notify_one();
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    const auto start = Clock::now();
+    const bool success = m_reader(sector, data);
+    m_stallTime.fetch_add((Clock::now() - start).count(), std::memory_order_relaxed);
+    return success;
+}
+
+unsigned PCSX::SectorReadAhead::read(uint32_t sector, uint8_t* data, unsigned count) {
+    if (count == 0) return 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_started || (m_count == 0) || (m_sector != sector)) {
+        lock.unlock();
+        return read(sector, data) ? 1 : 0;
+    }
+
+    const unsigned head = m_head;
+    const unsigned available = std::min(count, m_count);
+    lock.unlock();
+    // Same as above: everything from the head to the end of the ring is ours until we give it back.
+    unsigned taken = 0;
+    unsigned actual = 0;
+    while (taken < available) {
+        const unsigned slot = (head + taken) % m_capacity;
+        // A failed sector is left in the ring for the next read, unless it's the first one.
+        if (!m_success[slot]) {
+            if (taken == 0) taken++;
+            break;
+        }
+        taken++;
+        memcpy(data + actual * m_sectorSize, m_data.get() + slot * m_sectorSize, m_sectorSize);
+        actual++;
+    }
+    lock.lock();
+    m_head = (m_head + taken) % m_capacity;
+    m_count -= taken;
+    m_sector += taken;
+    lock.unlock();
+    m_cv.notify_one();
+    m_hits.fetch_add(taken, std::memory_order_relaxed);
+    return actual;
+}
+
+void PCSX::SectorReadAhead::setDepth(unsigned depth) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_depth = std::clamp(depth, 1u, m_capacity);
+    }
+    m_cv.notify_one();
+}
+
+void PCSX::SectorReadAhead::stop() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = false;
+    m_started = false;
+}
+
+void PCSX::SectorReadAhead::worker() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        // Nothing to do until the ring restarts somewhere, or until a sector got consumed.
+        m_cv.wait(lock, [this]() { return m_stop || ((m_generation != 0) && (m_count < m_depth)); });
+        if (m_stop) return;
+
+        const uint32_t generation = m_generation;
+        const uint32_t sector = m_sector + m_count;
+        const unsigned slot = (m_head + m_count) % m_capacity;
+        lock.unlock();
+        const bool success = m_reader(sector, m_data.get() + slot * m_sectorSize);
+        lock.lock();
+        // If the ring restarted in the meantime, the slot is still past its end, and will simply get read again.
+        if (generation == m_generation) {
+            m_success[slot] = success;
+            m_count++;
+        }
+    }
+}
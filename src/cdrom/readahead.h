@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace PCSX {
+
+// Keeps a ring of the sectors following the last one that got read, filled by a worker thread, so that
+// reading sequentially doesn't have to wait on the disc image. Anything but the next sector in line costs
+// a synchronous read, and restarts the read-ahead from there. The reader is called from both the worker
+// and the thread calling read(), so it needs to do its own locking.
+class SectorReadAhead {
+  public:
+    using Reader = std::function<bool(uint32_t sector, uint8_t* data)>;
+    using Clock = std::chrono::steady_clock;
+
+    SectorReadAhead(unsigned sectorSize, unsigned capacity, Reader&& reader);
+    ~SectorReadAhead() { stop(); }
+
+    // Copies sectorSize bytes of this sector into data, and returns what the reader returned for it.
+    // The worker thread only starts on the first call.
+    bool read(uint32_t sector, uint8_t* data);
+    // Same, for up to count sectors in a row, stored one after the other into data. All of the ones already read
+    // ahead get taken at once, stopping before the first one the reader failed on; a miss reads only the first
+    // one. Returns how many sectors got read successfully, which is 0 if the first one failed.
+    unsigned read(uint32_t sector, uint8_t* data, unsigned count);
+    // How many sectors the worker reads ahead, at most the capacity.
+    void setDepth(unsigned depth);
+    // Waits for the worker thread to be gone. What it read ahead is kept, and it starts again on the next read().
+    void stop();
+
+    uint64_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+    // The total time read() spent reading synchronously, because of misses.
+    Clock::duration stallTime() const { return Clock::duration(m_stallTime.load(std::memory_order_relaxed)); }
+    void resetCounters() {
+        m_hits.store(0, std::memory_order_relaxed);
+        m_misses.store(0, std::memory_order_relaxed);
+        m_stallTime.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    void worker();
+
+    const unsigned m_sectorSize;
+    const unsigned m_capacity;
+    Reader m_reader;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::unique_ptr<uint8_t[]> m_data;
+    std::unique_ptr<bool[]> m_success;
+    // The ring holds m_count sectors, starting at m_head, which is for m_sector.
+    unsigned m_head = 0;
+    unsigned m_count = 0;
+    unsigned m_depth;
+    uint32_t m_sector = 0;
+    // Bumped whenever the ring restarts somewhere else, so the worker drops the sector it was reading.
+    uint32_t m_generation = 0;
+    bool m_started = false;
+    bool m_stop = false;
+
+    std::atomic<uint64_t> m_hits = 0;
+    std::atomic<uint64_t> m_misses = 0;
+    std::atomic<Clock::rep> m_stallTime = 0;
+};
+
+}  // namespace PCSX
@@ -18,6 +18,7 @@
  ***************************************************************************/
 
 #pragma once
+#include "core/dynarec-codecache.h"
 #include "core/r3000a.h"
 #ifdef DYNAREC_AA64
 #include "support/windowswrapper.h"
@@ -37,12 +38,14 @@ constexpr size_t allocSize = codeCacheSize + 0x1000;
 // This has to be static so JIT code will be close enough to the executable to address stuff with pc-relative accesses
 alignas(4096) static uint8_t s_codeCache[allocSize];
 
-class Emitter : public MacroAssembler {
+class Emitter : public PCSX::CodeCacheClaim, public MacroAssembler {
   public:
 #ifdef __APPLE__
-    Emitter() : MacroAssembler(reinterpret_cast<uint8_t*>(makeBuffer()), allocSize) {}
+    Emitter() : MacroAssembler(reinterpret_cast<uint8_t*>(makeBuffer(ownsCodeCache())), allocSize) {}
 
-    static void* makeBuffer() {
+    static void* makeBuffer(bool owned) {
+        // Someone else's code is living there, so leave it be; this emitter won't be used anyway.
+        if (!owned) return s_codeCache;
         void* ptr = mmap(s_codeCache, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
         return (ptr == MAP_FAILED) ? nullptr : ptr;
     }
@@ -66,6 +69,7 @@ class Emitter : public MacroAssembler {
     void ready() { FinalizeCode(); }
 
     bool setRWX() {
+        if (!ownsCodeCache()) return false;
 #if defined(_WIN32)
         DWORD oldProtect;  // Unused, but VirtualProtect wants somewhere to store it anyways.
         return VirtualProtect(s_codeCache, allocSize, PAGE_EXECUTE_READWRITE, &oldProtect) != 0;
@@ -80,6 +84,9 @@ class Emitter : public MacroAssembler {
 
     void align() { GetBuffer()->Align(); }
 
+    // Move the code pointer back to "offset" bytes from the start of the buffer, so the code after it can be reused
+    void rewind(size_t offset) { GetBuffer()->Rewind(offset); }
+
 #define MAKE_CONDITIONAL_BRANCH(properName, alias)      \
     void b##properName(Label& l) { b(&l, properName); } \
     void b##alias(Label& l) { b##properName(l); }
@@ -183,15 +183,9 @@ void DynaRecCPU::recMTC2(uint32_t code) {
     }
 }
 
-static uint32_t MFC2Wrapper(int reg) { return PCSX::g_emulator->m_gte->MFC2(reg); }
-
-void DynaRecCPU::recMFC2(uint32_t code) {
-    if (_Rt_) {
-        allocateRegWithoutLoad(_Rt_);
-        m_gprs[_Rt_].setWriteback(true);
-    }
-
-    switch (_Rd_) {
+// IRGB/ORGB read back as IR1-3, saturated to 5 bits each. Uses w0 and w3, so dest can't be either of them
+void DynaRecCPU::loadGTEDataRegister(Register dest, int index) {
+    switch (index) {
         case 1:
         case 3:
         case 5:
@@ -199,9 +193,7 @@ void DynaRecCPU::recMFC2(uint32_t code) {
         case 9:
         case 10:
         case 11:
-            if (_Rt_) {
-                gen.Ldrsh(m_gprs[_Rt_].allocatedReg, MemOperand(contextPointer, COP2_DATA_OFFSET(_Rd_)));
-            }
+            gen.Ldrsh(dest, MemOperand(contextPointer, COP2_DATA_OFFSET(index)));
             break;
 
         case 7:
@@ -209,37 +201,42 @@ void DynaRecCPU::recMFC2(uint32_t code) {
         case 17:
         case 18:
         case 19:
-            if (_Rt_) {
-                gen.Ldrh(m_gprs[_Rt_].allocatedReg, MemOperand(contextPointer, COP2_DATA_OFFSET(_Rd_)));
-            }
+            gen.Ldrh(dest, MemOperand(contextPointer, COP2_DATA_OFFSET(index)));
             break;
 
         case 15:  // Return SXY2 from SXYP
-            if (_Rt_) {
-                gen.Ldr(m_gprs[_Rt_].allocatedReg, MemOperand(contextPointer, COP2_DATA_OFFSET(14)));
-            }
+            gen.Ldr(dest, MemOperand(contextPointer, COP2_DATA_OFFSET(14)));
             break;
 
         case 28:
-        case 29:  // Fallback for IRGB/ORGB
-            gen.Mov(arg1, _Rd_);
-            call(MFC2Wrapper);  // result in w0
-
-            if (_Rt_) {
-                allocateRegWithoutLoad(_Rt_);  // Reallocate the reg in case the call thrashed it
-                m_gprs[_Rt_].setWriteback(true);
-                gen.Mov(m_gprs[_Rt_].allocatedReg, w0);
+        case 29:
+            for (int component = 0; component < 3; component++) {
+                gen.Ldrsh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(9 + component)));
+                gen.Asr(w0, w0, 7);
+                emitGTELimit(w0, w3, 0, 0x1f, 0, false);
+                if (component == 0) {
+                    gen.Mov(dest, w0);
+                } else {
+                    gen.Orr(dest, dest, Operand(w0, LSL, component * 5));
+                }
             }
+            gen.Str(dest, MemOperand(contextPointer, COP2_DATA_OFFSET(index)));
             break;
 
         default:
-            if (_Rt_) {
-                gen.Ldr(m_gprs[_Rt_].allocatedReg, MemOperand(contextPointer, COP2_DATA_OFFSET(_Rd_)));
-            }
+            gen.Ldr(dest, MemOperand(contextPointer, COP2_DATA_OFFSET(index)));
             break;
     }
 }
 
+void DynaRecCPU::recMFC2(uint32_t code) {
+    if (!_Rt_) return;
+
+    allocateRegWithoutLoad(_Rt_);
+    m_gprs[_Rt_].setWriteback(true);
+    loadGTEDataRegister(m_gprs[_Rt_].allocatedReg, _Rd_);
+}
+
 void DynaRecCPU::recCFC2(uint32_t code) {
     if (_Rt_) {
         maybeCancelDelayedLoad(_Rt_);
@@ -259,10 +256,10 @@ void DynaRecCPU::recLWC2(uint32_t code) {
 
     call(read32Wrapper);
     switch (_Rt_) {
-        case 15:
-        case 30:
-            fmt::print("Unimplemented LWC2 to GTE data register {}\n", _Rt_);
-            abort();
+        case 15:                                                            // SXYP
+            gen.Ldr(x1, MemOperand(contextPointer, COP2_DATA_OFFSET(13)));  // SXY0 = SXY1 and SXY1 = SXY2
+            gen.Str(x1, MemOperand(contextPointer, COP2_DATA_OFFSET(12)));
+            gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(14)));  // SXY2 = val
             break;
 
         case 28:                    // IRGB
@@ -277,6 +274,12 @@ void DynaRecCPU::recLWC2(uint32_t code) {
             gen.And(w1, w1, 0xf80);
             gen.Str(w1, MemOperand(contextPointer, COP2_DATA_OFFSET(11)));
             break;
+
+        case 30:
+            gen.Eor(w1, w0, Operand(w0, ASR, 31));  // value = ~value if the msb is set
+            gen.Clz(w1, w1);                         // Count leading Zeros
+            gen.Str(w1, MemOperand(contextPointer, COP2_DATA_OFFSET(31)));  // Write result to LZCR
+            break;
     }
 
     if (_Rt_ != 31) {
@@ -285,9 +288,7 @@ void DynaRecCPU::recLWC2(uint32_t code) {
 }
 
 void DynaRecCPU::recSWC2(uint32_t code) {
-    gen.Mov(arg1, _Rt_);
-    call(MFC2Wrapper);  // Fetch the COP2 data reg in w0
-    gen.Mov(arg2, w0);  // Value to write in arg2
+    loadGTEDataRegister(arg2, _Rt_);  // Value to write in arg2
 
     // Address in arg1
     if (m_gprs[_Rs_].isConst()) {
@@ -300,6 +301,502 @@ void DynaRecCPU::recSWC2(uint32_t code) {
     call(write32Wrapper);
 }
 
+// Scratch registers for the native GTE commands. None of them can be allocated to guest registers.
+// x0 holds the MAC being computed, x1 is only used for short-lived values
+static const Register gteFlag = w2;  // FLAG, written back once the command is done
+static const Register gteTemp1 = x6;
+static const Register gteTemp2 = x7;
+
+static constexpr bool gteSF(uint32_t code) { return (code >> 19) & 1; }
+static constexpr bool gteLM(uint32_t code) { return (code >> 10) & 1; }
+// The FLAG bits raised by Lm_B1-3 when limiting IR1-3
+static constexpr uint32_t gteIRFlag(int row) { return row == 2 ? (1 << 22) : (1u << 31) | (1 << (24 - row)); }
+
+// Whether the FLAG computed by the GTE command being compiled can be read. We only look at the rest of the block, as
+// the dispatcher may run anything between two blocks.
+bool DynaRecCPU::isGTEFlagLive() {
+    if constexpr (!ENABLE_GTE_FLAG_ELISION) return true;
+    if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecGTEFlagElision>()) return true;
+    if (m_inDelaySlot) return true;  // The next instruction to run is the branch target, not the one after us
+
+    return PCSX::GTE::isFlagLive(m_pc, m_instructionsLeft);
+}
+
+// The native commands are opt-in, same as on x64. The rest of the time they call into the C++ version.
+bool DynaRecCPU::useNativeGTE() {
+    return PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecNativeGTE>();
+}
+
+// Offset from contextPointer of a 16-bit element of one of the GTE matrices (0 = rotation, 1 = light, 2 = light color)
+uintptr_t DynaRecCPU::gteMatrixOffset(int matrix, int row, int column) {
+    const int element = row * 3 + column;
+    return COP2_CONTROL_OFFSET((matrix << 3) + (element >> 1)) + (element & 1) * sizeof(int16_t);
+}
+
+// Offset from contextPointer of a component of V0-V2, or of IR1-3 for vector 3
+uintptr_t DynaRecCPU::gteVectorOffset(int vector, int component) {
+    if (vector == 3) return COP2_DATA_OFFSET(9 + component);
+
+    const int element = vector * 4 + component;
+    return COP2_DATA_OFFSET(element >> 1) + (element & 1) * sizeof(int16_t);
+}
+
+// Saturate value to [min, max], raising flagBits in FLAG if it had to be saturated. Without flags, this is branchless
+void DynaRecCPU::emitGTELimit(Register value, Register scratch, int32_t min, int32_t max, uint32_t flagBits,
+                              bool trackFlags) {
+    if (!trackFlags || flagBits == 0) {
+        gen.Mov(scratch, (uint32_t)max);
+        gen.Cmp(value, scratch);
+        gen.Csel(value, scratch, value, gt);
+        gen.Mov(scratch, (uint32_t)min);
+        gen.Cmp(value, scratch);
+        gen.Csel(value, scratch, value, lt);
+        return;
+    }
+
+    Label checkIfBelowMin, end;
+    gen.Mov(scratch, (uint32_t)max);
+    gen.Cmp(value, scratch);
+    gen.ble(checkIfBelowMin);
+    gen.Mov(value, scratch);
+    gen.Orr(gteFlag, gteFlag, flagBits);
+    gen.B(&end);
+
+    gen.L(checkIfBelowMin);
+    gen.Mov(scratch, (uint32_t)min);
+    gen.Cmp(value, scratch);
+    gen.bge(end);
+    gen.Mov(value, scratch);
+    gen.Orr(gteFlag, gteFlag, flagBits);
+    gen.L(end);
+}
+
+// Raise the FLAG bits of F(x0), the MAC0 overflow checks
+void DynaRecCPU::emitGTEMAC0Flags() {
+    Label notAboveMax, notBelowMin;
+    gen.Cmp(x0, 0x7fffffff);
+    gen.ble(notAboveMax);
+    gen.Orr(gteFlag, gteFlag, (1u << 31) | (1 << 16));
+    gen.L(notAboveMax);
+
+    gen.Cmp(x0, -INT64_C(0x80000000));
+    gen.bge(notBelowMin);
+    gen.Orr(gteFlag, gteFlag, (1u << 31) | (1 << 15));
+    gen.L(notBelowMin);
+}
+
+// x0 = translation + matrix[row] * vector, going through the GTE's 44-bit adders like the int44 class does.
+// translation is the control register holding the translation vector (which gets shifted left by 12), or -1 for none.
+// Without a translation, the sum can't overflow 44 bits, so there's nothing to wrap or check.
+void DynaRecCPU::emitGTEMatrixRow(int matrix, int vector, int translation, int row, bool trackFlags) {
+    const bool checkOverflows = trackFlags && translation >= 0;
+
+    if (translation >= 0) {
+        gen.Ldrsw(x0, MemOperand(contextPointer, COP2_CONTROL_OFFSET(translation + row)));
+        gen.Lsl(x0, x0, 12);
+    } else {
+        gen.Mov(x0, 0);
+    }
+
+    for (int column = 0; column < 3; column++) {
+        gen.Ldrsh(gteTemp1.W(), MemOperand(contextPointer, gteMatrixOffset(matrix, row, column)));
+        gen.Ldrsh(gteTemp2.W(), MemOperand(contextPointer, gteVectorOffset(vector, column)));
+        gen.Smaddl(x0, gteTemp1.W(), gteTemp2.W(), x0);
+
+        if (checkOverflows) {
+            Label noPositiveOverflow, noNegativeOverflow;
+            // The sum fits in 45 bits, so its top bits are 0 or -1 if it fits in 44 bits,
+            // 1 if it overflowed above 0x7ffffffffff, and -2 if it overflowed below -0x80000000000
+            gen.Asr(gteTemp2, x0, 43);
+            gen.Sbfx(x0, x0, 0, 44);  // Wrap the sum to 44 bits before the next addition
+
+            gen.Cmp(gteTemp2, 1);
+            gen.bne(noPositiveOverflow);
+            gen.Orr(gteFlag, gteFlag, (1u << 31) | (1 << (30 - row)));
+            gen.L(noPositiveOverflow);
+
+            gen.Cmp(gteTemp2, -2);
+            gen.bne(noNegativeOverflow);
+            gen.Orr(gteFlag, gteFlag, (1u << 31) | (1 << (27 - row)));
+            gen.L(noNegativeOverflow);
+        }
+    }
+
+    // If we don't need the overflow flags, wrapping once at the end gives the same result as wrapping every addition
+    if (translation >= 0 && !checkOverflows) {
+        gen.Sbfx(x0, x0, 0, 44);
+    }
+}
+
+// MAC1-3 = A1-3(translation + matrix * vector), then IR1-3 = Lm_B1-3(MAC1-3).
+// For RTPS, IR3 is limited with Lm_B3_sf instead, and the unshifted MAC3 is left in x1 for the Z FIFO.
+void DynaRecCPU::emitGTEMatrixVectorProduct(int matrix, int vector, int translation, bool sf, bool lm, bool trackFlags,
+                                            bool rtps) {
+    for (int row = 0; row < 3; row++) {
+        emitGTEMatrixRow(matrix, vector, translation, row, trackFlags);
+        if (rtps && row == 2) {
+            gen.Mov(x1, x0);
+        }
+        if (sf) {
+            gen.Asr(x0, x0, 12);
+        }
+        gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(25 + row)));
+    }
+
+    // The IRs are only written once all 3 MACs are done, as the vector might be IR1-3 itself
+    const int32_t min = lm ? 0 : -0x8000;
+    for (int row = 0; row < 3; row++) {
+        gen.Ldr(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(25 + row)));
+
+        if (rtps && row == 2) {
+            if (trackFlags) {  // Lm_B3_sf checks MAC3 >> 12 for overflows no matter what sf is
+                Label outOfRange, inRange;
+                gen.Asr(gteTemp2, x1, 12);
+                gen.Cmp(gteTemp2.W(), 0x7fff);
+                gen.bgt(outOfRange);
+                gen.Cmp(gteTemp2.W(), -0x8000);
+                gen.bge(inRange);
+                gen.L(outOfRange);
+                gen.Orr(gteFlag, gteFlag, 1 << 22);
+                gen.L(inRange);
+            }
+            emitGTELimit(w0, gteTemp1.W(), min, 0x7fff, 0, false);
+        } else {
+            emitGTELimit(w0, gteTemp1.W(), min, 0x7fff, gteIRFlag(row), trackFlags);
+        }
+
+        gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(9 + row)));
+    }
+}
+
+// gteTemp2 = gte_divide(gteTemp1, gteTemp2), for a zero-extended 16-bit numerator and denominator. Uses x0 and x1
+void DynaRecCPU::emitGTEDivide(bool trackFlags) {
+    const Register numerator = gteTemp1.W();
+    const Register denominator = gteTemp2.W();
+    Label noOverflow, end;
+
+    gen.Lsl(w0, denominator, 1);  // The division overflows if numerator >= denominator * 2
+    gen.Cmp(numerator, w0);
+    gen.blo(noOverflow);
+    gen.Mov(denominator, 0x1ffff);
+    if (trackFlags) {
+        gen.Orr(gteFlag, gteFlag, (1u << 31) | (1 << 17));
+    }
+    gen.B(&end);
+
+    // The denominator can't be 0 if we got here. Shift both operands left by its leading zero count
+    gen.L(noOverflow);
+    gen.Clz(w1, denominator);
+    gen.Sub(w1, w1, 16);
+    gen.Lsl(numerator, numerator, w1);
+    gen.Lsl(denominator, denominator, w1);
+
+    // w0 = r2 = s_reciprocalTable[(r1 + 0x40) >> 7] + 0x101, with r1 = (denominator << shift) & 0x7fff
+    gen.And(denominator, denominator, 0x7fff);
+    gen.Add(w0, denominator, 0x40);
+    gen.Lsr(w0, w0, 7);
+    gen.Mov(x1, (uintptr_t)PCSX::GTE::s_reciprocalTable);
+    gen.Ldrb(w0, MemOperand(x1, x0));
+    gen.Add(w0, w0, 0x101);
+
+    // w1 = r3 = ((0x80 - r2 * (r1 + 0x8000)) >> 8) & 0x1ffff
+    gen.Add(denominator, denominator, 0x8000);
+    gen.Mul(denominator, denominator, w0);
+    gen.Mov(w1, 0x80);
+    gen.Sub(w1, w1, denominator);
+    gen.Asr(w1, w1, 8);
+    gen.And(w1, w1, 0x1ffff);
+
+    // reciprocal = (r2 * r3 + 0x80) >> 8, result = min((reciprocal * (numerator << shift) + 0x8000) >> 16, 0x1ffff)
+    gen.Mul(w0, w0, w1);
+    gen.Add(w0, w0, 0x80);
+    gen.Lsr(w0, w0, 8);
+    gen.Mul(x0, x0, gteTemp1);
+    gen.Add(x0, x0, 0x8000);
+    gen.Lsr(x0, x0, 16);
+    gen.Mov(denominator, 0x1ffff);
+    gen.Cmp(w0, denominator);
+    gen.Csel(denominator, w0, denominator, lo);
+    gen.L(end);
+}
+
+// One RTPS step for vertex V<vertex>: transform it and push the result to the screen coordinate FIFOs.
+// Leaves H / SZ3 in gteTemp2 for the depth cueing that follows the last vertex
+void DynaRecCPU::emitGTEPerspectiveTransform(int vertex, bool sf, bool lm, bool trackFlags) {
+    emitGTEMatrixVectorProduct(0, vertex, 5, sf, lm, trackFlags, true);
+
+    // Push Lm_D(MAC3 >> 12) to the Z FIFO
+    gen.Asr(x1, x1, 12);
+    emitGTELimit(w1, gteTemp1.W(), 0, 0xffff, (1u << 31) | (1 << 18), trackFlags);
+    for (int i = 16; i < 19; i++) {
+        gen.Ldrh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(i + 1)));
+        gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(i)));
+    }
+    gen.Strh(w1, MemOperand(contextPointer, COP2_DATA_OFFSET(19)));
+
+    // gteTemp2 = H / SZ3
+    gen.Ldrh(gteTemp1.W(), MemOperand(contextPointer, COP2_CONTROL_OFFSET(26)));
+    gen.Uxth(gteTemp2.W(), w1);
+    emitGTEDivide(trackFlags);
+
+    gen.Ldr(x0, MemOperand(contextPointer, COP2_DATA_OFFSET(13)));  // SXY0 = SXY1 and SXY1 = SXY2
+    gen.Str(x0, MemOperand(contextPointer, COP2_DATA_OFFSET(12)));
+
+    // SX2 = Lm_G1(F(OFX + IR1 * H / SZ3) >> 16), SY2 = Lm_G2(F(OFY + IR2 * H / SZ3) >> 16)
+    for (int axis = 0; axis < 2; axis++) {
+        gen.Ldrsw(x0, MemOperand(contextPointer, COP2_CONTROL_OFFSET(24 + axis)));
+        gen.Ldrsh(x1, MemOperand(contextPointer, COP2_DATA_OFFSET(9 + axis)));
+        gen.Madd(x0, x1, gteTemp2, x0);
+        if (trackFlags) {
+            emitGTEMAC0Flags();
+        }
+        gen.Asr(x0, x0, 16);
+        emitGTELimit(w0, w1, -0x400, 0x3ff, (1u << 31) | (1 << (14 - axis)), trackFlags);
+        gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(14) + axis * sizeof(int16_t)));
+    }
+}
+
+// RGB0 = RGB1, RGB1 = RGB2, RGB2 = CODE and Lm_C1-3(MAC1-3 >> 4)
+void DynaRecCPU::emitGTEColorFIFO(bool trackFlags) {
+    gen.Ldr(x0, MemOperand(contextPointer, COP2_DATA_OFFSET(21)));
+    gen.Str(x0, MemOperand(contextPointer, COP2_DATA_OFFSET(20)));
+    gen.Ldrb(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(6) + 3));
+    gen.Strb(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(22) + 3));
+
+    for (int component = 0; component < 3; component++) {
+        gen.Ldr(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(25 + component)));
+        gen.Asr(w0, w0, 4);
+        emitGTELimit(w0, gteTemp1.W(), 0, 0xff, 1 << (21 - component), trackFlags);
+        gen.Strb(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(22) + component));
+    }
+}
+
+// The NCS/NCCS step for normal vector V<vector>: IR = LLM * V, IR = BK + LCM * IR, optionally multiplied by RGB, and
+// push the resulting color to the color FIFO
+void DynaRecCPU::emitGTENormalColor(int vector, bool sf, bool lm, bool trackFlags, bool colorMultiply) {
+    emitGTEMatrixVectorProduct(1, vector, -1, sf, lm, trackFlags);
+    emitGTEMatrixVectorProduct(2, 3, 13, sf, lm, trackFlags);
+
+    if (colorMultiply) {  // MAC1-3 = A1-3((RGB << 4) * IR1-3). This can't overflow, so only the limiters raise flags
+        const int32_t min = lm ? 0 : -0x8000;
+        for (int row = 0; row < 3; row++) {
+            gen.Ldrb(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(6) + row));
+            gen.Lsl(w0, w0, 4);
+            gen.Ldrsh(gteTemp1.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(9 + row)));
+            gen.Mul(w0, w0, gteTemp1.W());
+            if (sf) {
+                gen.Asr(w0, w0, 12);
+            }
+            gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(25 + row)));
+            emitGTELimit(w0, gteTemp1.W(), min, 0x7fff, gteIRFlag(row), trackFlags);
+            gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(9 + row)));
+        }
+    }
+
+    emitGTEColorFIFO(trackFlags);
+}
+
+#define GTE_WRAPPER(name) \
+    static void name##Wrapper(uint32_t instruction) { PCSX::g_emulator->m_gte->name(instruction); }
+
+// The native commands go back to these for the cases they don't handle, or when they're turned off
+GTE_WRAPPER(MVMVA);
+GTE_WRAPPER(NCCS);
+GTE_WRAPPER(NCCT);
+GTE_WRAPPER(NCLIP);
+GTE_WRAPPER(NCS);
+GTE_WRAPPER(NCT);
+GTE_WRAPPER(RTPS);
+GTE_WRAPPER(RTPT);
+
+#undef GTE_WRAPPER
+
+template <bool isAVSZ4>
+void DynaRecCPU::recAVSZ(uint32_t code) {
+    const bool trackFlags = isGTEFlagLive();
+    const Register scaleFactor = gteTemp2;
+
+    if constexpr (isAVSZ4) {  // Load SZF4 into scaleFactor if this is AVSZ4
+        gen.Ldrsh(scaleFactor, MemOperand(contextPointer, COP2_CONTROL_OFFSET(30)));
+    } else {  // Otherwise, load SZF3
+        gen.Ldrsh(scaleFactor, MemOperand(contextPointer, COP2_CONTROL_OFFSET(29)));
+    }
+
+    // x0 = SZ1 + SZ2 + SZ3
+    gen.Ldrh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(17)));
+    gen.Ldrh(gteTemp1.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(18)));
+    gen.Add(x0, x0, gteTemp1);
+    gen.Ldrh(gteTemp1.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(19)));
+    gen.Add(x0, x0, gteTemp1);
+
+    // x0 += SZ0 for AVSZ4
+    if constexpr (isAVSZ4) {
+        gen.Ldrh(gteTemp1.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(16)));
+        gen.Add(x0, x0, gteTemp1);
+    }
+
+    // x0 = (Sum of Z values) * scaleFactor
+    gen.Mul(x0, x0, scaleFactor);
+    // Set MAC0
+    gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(24)));
+    // Calculate flags if MAC0 result is larger than 31 bits
+    if (trackFlags) {
+        gen.Mov(gteFlag, 0);
+        emitGTEMAC0Flags();
+    }
+
+    // Saturate MAC0 >> 12 to [0, 0xffff] and set OTZ to the saturated value
+    gen.Asr(x0, x0, 12);
+    emitGTELimit(w0, gteTemp1.W(), 0, 0xffff, (1u << 31) | (1 << 18), trackFlags);
+    gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(7)));
+
+    if (trackFlags) {
+        gen.Str(gteFlag, MemOperand(contextPointer, COP2_CONTROL_OFFSET(31)));  // Writeback FLAG
+    }
+}
+
+void DynaRecCPU::recAVSZ3(uint32_t code) { recAVSZ<false>(code); }
+void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
+
+void DynaRecCPU::recNCLIP(uint32_t code) {
+    // With PGXP on, NCLIP may use the precise screen coordinates instead, which only the C++ version knows about
+    if (m_pgxpMode != 0 || !useNativeGTE()) {
+        gen.Mov(arg1, code);
+        call(NCLIPWrapper);
+        return;
+    }
+
+    const bool trackFlags = isGTEFlagLive();
+    // The (SXn, SYm) products, the first 3 are added and the last 3 subtracted
+    constexpr int terms[6][2] = {{0, 1}, {1, 2}, {2, 0}, {0, 2}, {1, 0}, {2, 1}};
+
+    gen.Mov(x0, 0);
+    for (int i = 0; i < 6; i++) {
+        gen.Ldrsh(gteTemp1.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(12 + terms[i][0])));
+        gen.Ldrsh(gteTemp2.W(), MemOperand(contextPointer, COP2_DATA_OFFSET(12 + terms[i][1]) + sizeof(int16_t)));
+        if (i < 3) {
+            gen.Smaddl(x0, gteTemp1.W(), gteTemp2.W(), x0);
+        } else {
+            gen.Smsubl(x0, gteTemp1.W(), gteTemp2.W(), x0);
+        }
+    }
+
+    gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(24)));  // Set MAC0
+    if (trackFlags) {
+        gen.Mov(gteFlag, 0);
+        emitGTEMAC0Flags();
+        gen.Str(gteFlag, MemOperand(contextPointer, COP2_CONTROL_OFFSET(31)));  // Writeback FLAG
+    }
+}
+
+void DynaRecCPU::recMVMVA(uint32_t code) {
+    const int mx = (code >> 17) & 3;
+    const int v = (code >> 15) & 3;
+    const int cv = (code >> 13) & 3;
+
+    // The garbage matrix and the buggy far color translation are rarely ever used, leave them to the C++ version
+    if (mx == 3 || cv == 2 || !useNativeGTE()) {
+        gen.Mov(arg1, code);
+        call(MVMVAWrapper);
+        return;
+    }
+
+    const bool trackFlags = isGTEFlagLive();
+    if (trackFlags) {
+        gen.Mov(gteFlag, 0);
+    }
+
+    // Translation vector 0 is TR, 1 is BK and 3 is none
+    emitGTEMatrixVectorProduct(mx, v, cv == 3 ? -1 : (cv << 3) + 5, gteSF(code), gteLM(code), trackFlags);
+
+    if (trackFlags) {
+        gen.Str(gteFlag, MemOperand(contextPointer, COP2_CONTROL_OFFSET(31)));  // Writeback FLAG
+    }
+}
+
+template <bool isRTPT>
+void DynaRecCPU::recRTP(uint32_t code) {
+    Label fallback, end;
+    const bool trackFlags = isGTEFlagLive();
+
+    // The widescreen hack and PGXP are only handled by the C++ version. They can be toggled at any point, so check
+    // them at runtime. Flush the volatile registers for both paths, so the register allocator state stays the same.
+    prepareForCall();
+    load<8, false>(w0, &PCSX::g_emulator->config().Widescreen);
+    gen.Cbnz(w0, &fallback);
+    load<8, false>(w0, &PCSX::g_emulator->config().PGXP_GTE);
+    gen.Cbnz(w0, &fallback);
+
+    if (trackFlags) {
+        gen.Mov(gteFlag, 0);
+    }
+
+    constexpr int vertexCount = isRTPT ? 3 : 1;
+    for (int vertex = 0; vertex < vertexCount; vertex++) {
+        emitGTEPerspectiveTransform(vertex, gteSF(code), gteLM(code), trackFlags);
+    }
+
+    // MAC0 = F(DQB + DQA * H / SZ3), IR0 = Lm_H(MAC0 >> 12)
+    gen.Ldrsw(x0, MemOperand(contextPointer, COP2_CONTROL_OFFSET(28)));
+    gen.Ldrsh(x1, MemOperand(contextPointer, COP2_CONTROL_OFFSET(27)));
+    gen.Madd(x0, x1, gteTemp2, x0);
+    if (trackFlags) {
+        emitGTEMAC0Flags();
+    }
+    gen.Str(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(24)));
+    gen.Asr(x0, x0, 12);
+    emitGTELimit(w0, w1, 0, 0x1000, 1 << 12, trackFlags);
+    gen.Strh(w0, MemOperand(contextPointer, COP2_DATA_OFFSET(8)));
+
+    if (trackFlags) {
+        gen.Str(gteFlag, MemOperand(contextPointer, COP2_CONTROL_OFFSET(31)));  // Writeback FLAG
+    }
+    gen.B(&end);
+
+    gen.L(fallback);
+    gen.Mov(arg1, code);
+    if constexpr (isRTPT) {
+        call(RTPTWrapper);
+    } else {
+        call(RTPSWrapper);
+    }
+    gen.L(end);
+}
+
+void DynaRecCPU::recNormalColor(uint32_t code, int vectorCount, bool colorMultiply) {
+    const bool trackFlags = isGTEFlagLive();
+    if (trackFlags) {
+        gen.Mov(gteFlag, 0);
+    }
+
+    for (int vector = 0; vector < vectorCount; vector++) {
+        emitGTENormalColor(vector, gteSF(code), gteLM(code), trackFlags, colorMultiply);
+    }
+
+    if (trackFlags) {
+        gen.Str(gteFlag, MemOperand(contextPointer, COP2_CONTROL_OFFSET(31)));  // Writeback FLAG
+    }
+}
+
+#define GTE_NATIVE(name, native)                \
+    void DynaRecCPU::rec##name(uint32_t code) { \
+        if (useNativeGTE()) {                   \
+            native;                             \
+            return;                             \
+        }                                       \
+        gen.Mov(arg1, code);                    \
+        call(name##Wrapper);                    \
+    }
+
+GTE_NATIVE(RTPS, recRTP<false>(code));
+GTE_NATIVE(RTPT, recRTP<true>(code));
+GTE_NATIVE(NCS, recNormalColor(code, 1, false));
+GTE_NATIVE(NCT, recNormalColor(code, 3, false));
+GTE_NATIVE(NCCS, recNormalColor(code, 1, true));
+GTE_NATIVE(NCCT, recNormalColor(code, 3, true));
+
+#undef GTE_NATIVE
+
 #define GTE_FALLBACK(name)                                                                          \
     static void name##Wrapper(uint32_t instruction) { PCSX::g_emulator->m_gte->name(instruction); } \
                                                                                                     \
@@ -308,8 +805,6 @@ void DynaRecCPU::recSWC2(uint32_t code) {
         call(name##Wrapper);                                                                        \
     }
 
-GTE_FALLBACK(AVSZ3);
-GTE_FALLBACK(AVSZ4);
 GTE_FALLBACK(CC);
 GTE_FALLBACK(CDP);
 GTE_FALLBACK(DCPL);
@@ -318,17 +813,10 @@ GTE_FALLBACK(DPCT);
 GTE_FALLBACK(GPF);
 GTE_FALLBACK(GPL);
 GTE_FALLBACK(INTPL);
-GTE_FALLBACK(MVMVA);
-GTE_FALLBACK(NCCS);
-GTE_FALLBACK(NCCT);
 GTE_FALLBACK(NCDS);
 GTE_FALLBACK(NCDT);
-GTE_FALLBACK(NCLIP);
-GTE_FALLBACK(NCS);
-GTE_FALLBACK(NCT);
 GTE_FALLBACK(OP);
-GTE_FALLBACK(RTPS);
-GTE_FALLBACK(RTPT);
 GTE_FALLBACK(SQR);
 
-#endif  // DYNAREC_X86_64
+#undef GTE_FALLBACK
+#endif  // DYNAREC_AA64
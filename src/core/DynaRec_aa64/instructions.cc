@@ -124,8 +124,9 @@ void DynaRecCPU::recBEQ(uint32_t code) {
         return;
     }
 
-    if (m_gprs[_Rs_].isConst() && m_gprs[_Rt_].isConst()) {
-        if (m_gprs[_Rs_].val == m_gprs[_Rt_].val) {
+    // Comparing a register against itself or 2 constants has a known outcome, so the branch can be folded and linked
+    if (_Rs_ == _Rt_ || (m_gprs[_Rs_].isConst() && m_gprs[_Rt_].isConst())) {
+        if (_Rs_ == _Rt_ || m_gprs[_Rs_].val == m_gprs[_Rt_].val) {
             m_pcWrittenBack = true;
             m_stopCompiling = true;
             gen.Mov(w0, target);
@@ -231,8 +232,8 @@ void DynaRecCPU::recBNE(uint32_t code) {
         return;
     }
 
-    if (m_gprs[_Rs_].isConst() && m_gprs[_Rt_].isConst()) {
-        if (m_gprs[_Rs_].val != m_gprs[_Rt_].val) {
+    if (_Rs_ == _Rt_ || (m_gprs[_Rs_].isConst() && m_gprs[_Rt_].isConst())) {
+        if (_Rs_ != _Rt_ && m_gprs[_Rs_].val != m_gprs[_Rt_].val) {
             m_pcWrittenBack = true;
             m_stopCompiling = true;
             gen.Mov(w0, target);
@@ -1016,6 +1017,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 allocateReg(_Rt_);
                 store<8>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
@@ -1056,6 +1058,7 @@ void DynaRecCPU::recSH(uint32_t code) {
                 allocateReg(_Rt_);
                 store<16>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
@@ -1126,6 +1129,7 @@ void DynaRecCPU::recSW(uint32_t code) {
                 allocateReg(_Rt_);
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
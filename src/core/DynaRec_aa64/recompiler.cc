@@ -20,6 +20,7 @@
 #include "recompiler.h"
 
 #if defined(DYNAREC_AA64)
+#include "core/pgxp_cpu.h"
 
 bool DynaRecCPU::Init() {
     // Initialize recompiler memory
@@ -74,10 +75,17 @@ bool DynaRecCPU::Init() {
     emitDispatcher();  // Emit our assembly dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
 
+    m_codeStart = gen.getSize();  // Blocks are emitted after the dispatcher
+    resetCodeSegments();
+
     for (int i = 0; i < 0x10000 / 4; i++) {  // Mark all dummy blocks as invalid
         m_dummyBlocks[i] = m_invalidBlock;
     }
 
+    if constexpr (ENABLE_PROFILER) {
+        m_profiler.init();
+    }
+
     m_gprs[0].markConst(0);  // $zero is always zero
 
 #if defined(__APPLE__)
@@ -104,6 +112,10 @@ void DynaRecCPU::Shutdown() {
     delete[] m_dummyBlocks;
 
     gen.dumpBuffer();  // dump buffer on shutdown/hard-reset for diagnostics
+
+    if constexpr (ENABLE_PROFILER) {
+        dumpProfileData();
+    }
 }
 
 /// Params: A program counter value
@@ -122,6 +134,15 @@ void DynaRecCPU::signalShellReached(DynaRecCPU* that) {
     }
 }
 
+void DynaRecCPU::pgxpHookWrapper(DynaRecCPU* that, uint32_t code) { PGXP_DynarecHook(code, &that->m_regs); }
+
+void DynaRecCPU::idleLoopWrapper(DynaRecCPU* that, uint32_t start, uint32_t branchPC) {
+    if ((that->m_regs.pc == start) && PCSX::g_emulator->settings.get<PCSX::Emulator::SettingIdleSkipping>() &&
+        that->isIdleLoop(start, branchPC)) {
+        that->skipIdleLoop();
+    }
+}
+
 void DynaRecCPU::error() {
     PCSX::g_system->hardReset();
     PCSX::g_system->pause();
@@ -138,10 +159,49 @@ void DynaRecCPU::uncompileAll() {
     }
 }
 
-void DynaRecCPU::flushCache() {
-    gen.Reset();       // Reset the emitter's code pointer and code size variables
-    emitDispatcher();  // Re-emit dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+void DynaRecCPU::resetCodeSegments() {
+    for (auto& segment : m_codeSegments) {
+        segment.clear();
+    }
+    m_freeCodeEnd = codeCacheSize;  // Nothing has been compiled yet, so everything after the dispatcher is free
+}
+
+// Uncompile every block that overlaps the given segment of the code cache, so that its space can be reused
+// Blocks that were recompiled elsewhere since are left alone, and links into the segment are guarded by a check of
+// the target's LUT entry, so they'll fall back to the dispatcher from now on
+void DynaRecCPU::evictCodeSegment(size_t segment) {
+    for (const auto& block : m_codeSegments[segment]) {
+        if (*block.entry == block.code) {
+            *block.entry = m_uncompiledBlock;
+        }
+    }
+
+    m_codeSegments[segment].clear();
+    m_freeCodeEnd = std::min((segment + 1) * CODE_SEGMENT_SIZE, codeCacheSize);
+    if constexpr (ENABLE_PROFILER) {
+        m_profiler.codeEvictions()++;
+    }
+}
+
+// Make sure there's enough space in the code cache to compile a new block (or chain of linked blocks)
+// If we've reached the end of the cache, wrap around to the start and evict the oldest code in front of us
+void DynaRecCPU::reserveCodeSpace() {
+    if (gen.getSize() + CODE_CACHE_MARGIN > codeCacheSize) {
+        gen.rewind(m_codeStart);
+        m_freeCodeEnd = m_codeStart;
+    }
+
+    while (m_freeCodeEnd < gen.getSize() + CODE_CACHE_MARGIN) {
+        evictCodeSegment(m_freeCodeEnd / CODE_SEGMENT_SIZE);
+    }
+}
+
+// Remember which segments the code in [start, end) is in, so the block can be uncompiled when they're evicted
+void DynaRecCPU::registerBlock(DynarecCallback* entry, DynarecCallback code, size_t start, size_t end) {
+    const auto lastSegment = std::min((end - 1) / CODE_SEGMENT_SIZE, CODE_SEGMENT_COUNT - 1);
+    for (auto segment = start / CODE_SEGMENT_SIZE; segment <= lastSegment; segment++) {
+        m_codeSegments[segment].push_back({entry, code});
+    }
 }
 
 void DynaRecCPU::emitBlockLookup() {
@@ -235,6 +295,7 @@ void DynaRecCPU::emitDispatcher() {
 // Compile a block, write address of compiled code to *callback
 // Returns the address of the compiled block
 DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bool align) {
+    ZoneScoped;
     m_stopCompiling = false;
     m_inDelaySlot = false;
     m_nextIsDelaySlot = false;
@@ -251,16 +312,21 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
     gen.setRW();  // Mark code cache as readable/writeable before emitting code
 #endif
 
+    // Linked blocks are compiled straight after their parent, which already reserved space for the whole chain
     if (align) {
+        reserveCodeSpace();
         gen.align();  // Align next block
     }
 
-    if (gen.getSize() > codeCacheSize) {  // Flush JIT cache if we've gone above the acceptable size
-        flushCache();
-    }
-
     const auto blockStart = gen.getCurr<DynarecCallback>();
+    const auto blockStartOffset = gen.getSize();
     *callback = blockStart;
+    if constexpr (ENABLE_PROFILER) {
+        if (startProfiling(m_pc)) {  // Uncompile all blocks if the profiler data overflowed
+            uncompileAll();
+            *callback = blockStart;
+        }
+    }
     handleKernelCall();  // Check if this is a kernel call vector, emit some extra code in that case.
 
     auto shouldContinue = [&]() {
@@ -288,6 +354,15 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
         uint32_t code = m_regs.code = *p;  // Actually read the instruction
         m_pc += 4;                         // Increment recompiler PC
         count++;                           // Increment instruction count
+        m_instructionsLeft = count < MAX_BLOCK_SIZE ? MAX_BLOCK_SIZE - count : 0;
+
+        // The hook looks at the guest registers in memory, as they are before the instruction runs
+        if (PGXP_DynarecHasHook(m_pgxpMode, code)) {
+            flushRegs();
+            loadThisPointer(arg1.X());
+            gen.Mov(arg2, code);
+            call(pgxpHookWrapper);
+        }
 
         const auto func = m_recBSC[code >> 26];  // Look up the opcode in our decoding LUT
         (*this.*func)(code);                     // Jump into the handler to recompile it
@@ -304,10 +379,23 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
         m_linkedPC = std::nullopt;
     }
 
+    if constexpr (ENABLE_PROFILER) {
+        endProfiling();
+    }
+
     gen.Ldr(x0, MemOperand(contextPointer, CYCLE_OFFSET));  // Fetch cycle count from memory
     gen.Add(x0, x0, count * PCSX::Emulator::BIAS);          // Add block cycles
     gen.Str(x0, MemOperand(contextPointer, CYCLE_OFFSET));  // Store cycles back to memory
 
+    // A block branching back to its own start might be an idle loop. Whether the branch got taken, and what
+    // the loop loads from, are only known at runtime.
+    if (isIdleLoop(startingPC, m_pc - 8, false)) {
+        loadThisPointer(arg1.X());
+        gen.Mov(arg2, startingPC);
+        gen.Mov(arg3, m_pc - 8);
+        call(idleLoopWrapper);
+    }
+
     // Link block else return to dispatcher
     if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
         handleLinking();
@@ -315,6 +403,9 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
         jmp((void*)m_returnFromBlock);
     }
 
+    // This covers any blocks that were linked after this one too, which is fine since they'd be evicted together
+    registerBlock(callback, blockStart, blockStartOffset, gen.getSize());
+
     // Clear stale instruction cache contents.
     __builtin___clear_cache(reinterpret_cast<char*>(blockStart), gen.getCurr<char*>());
     gen.ready();
@@ -326,7 +417,8 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
 }
 
 // Checks if the block being compiled is one of the kernel call vectors
-// If so, emit a call to "InterceptBIOS", which handles the kernel call debugger features
+// If so, emit a call to "InterceptBIOS", which handles the kernel call debugger features, and leave the block if
+// the call got emulated natively, as the pc is then already back to $ra
 // Also handles fast booting by intercepting the shell reached signal and setting pc to $ra if fastboot is on
 void DynaRecCPU::handleKernelCall() {
     if (m_pc == 0x80030000) {
@@ -354,46 +446,66 @@ void DynaRecCPU::handleKernelCall() {
             loadThisPointer(arg1.X());
             call(interceptKernelCallWrapper<0xC0>);
             break;
+
+        default:
+            return;
+    }
+
+    Label notEmulated;
+    gen.Cbz(w0, &notEmulated);
+    if constexpr (ENABLE_PROFILER) {
+        endProfiling();
     }
+    jmp((void*)m_returnFromBlock);
+    gen.L(notEmulated);
 }
 
 // Emits a jump to the dispatcher if there's no block to link to.
 // Otherwise, handle linking blocks
 void DynaRecCPU::handleLinking() {
-    vixl::aarch64::Label returnFromBlock;
-    // Don't link unless the next PC is valid, and there's over 1MB of free space in the code cache
-    if (isPcValid(m_linkedPC.value()) && gen.getRemainingSize() > 0x100000) {
+    // Don't link unless the next PC is valid, and there's enough free space in the code cache for the next block
+    if (isPcValid(m_linkedPC.value()) && getFreeCodeSpace() > (int64_t)CODE_CACHE_MARGIN / 2) {
         const auto nextPC = m_linkedPC.value();
         const auto nextBlockPointer = getBlockPointer(nextPC);
-        const auto nextBlockOffset = (size_t)nextBlockPointer - (size_t)this;
+
+        gen.Mov(x0, (uintptr_t)nextBlockPointer);
+        gen.Ldr(x0, MemOperand(x0));  // x0 = block pointer currently stored in the LUT
 
         if (*nextBlockPointer == m_uncompiledBlock) {  // If the next block hasn't been compiled yet
-            // Check that the block hasn't been invalidated/moved
-            // The value will be patched later. Since all code is within the same 32MB segment,
-            // We can get away with only checking the low 32 bits of the block pointer
-            gen.Mov(x0, (uintptr_t)nextBlockPointer);
-            gen.Ldr(x0, MemOperand(x0));
-            // Move value to compare against into w1
-            gen.Mov(w1, 0xcccccccc);
-            gen.Cmp(w0, w1);
-
-            const auto pointer = gen.getCurr<uint8_t*>();
-            gen.bne(returnFromBlock);  // Return if the block addr changed
+            Label linkTaken, nextBlock;
+            // Compile the next block right after this one, and fall through to it as long as the LUT still points
+            // to it. If it gets invalidated or evicted, the LUT entry will change and we'll go to the dispatcher
+            gen.Adr(x1, &nextBlock);
+            gen.Cmp(x0, x1);
+            gen.beq(linkTaken);
+
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkMisses());
+            }
+            jmp((void*)m_returnFromBlock);
 
-            recompile(nextBlockPointer, nextPC, false);  // Fallthrough to next block
+            gen.L(linkTaken);
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkHits());
+            }
 
-            *(uint32_t*)(pointer - 4) = (uint32_t)(uintptr_t)*nextBlockPointer;  // Patch comparison value
+            gen.L(nextBlock);
+            recompile(nextBlockPointer, nextPC, false);  // Fallthrough to next block
         } else {  // If it has already been compiled, link by jumping to the compiled code
-            gen.Mov(x0, (uintptr_t)nextBlockPointer);
-            gen.Ldr(x0, MemOperand(x0));
-            // Move value to compare against into w1
-            gen.Mov(w1, (uint32_t)(uintptr_t)*nextBlockPointer);
-            gen.Cmp(w0, w1);
+            Label returnFromBlock;
+            gen.Mov(x1, (uintptr_t)*nextBlockPointer);
+            gen.Cmp(x0, x1);
+            gen.bne(returnFromBlock);  // Return if the block addr changed
 
-            gen.bne(returnFromBlock);       // Return if the block addr changed
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkHits());
+            }
             jmp((void*)*nextBlockPointer);  // Jump to linked block otherwise
 
             gen.L(returnFromBlock);
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkMisses());
+            }
             jmp((void*)m_returnFromBlock);
         }
     } else {  // Can't link, so return to dispatcher
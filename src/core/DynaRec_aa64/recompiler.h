@@ -26,7 +26,9 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "core/dynarec-profiler.h"
 #include "emitter.h"
 #include "fmt/format.h"
 #include "regAllocation.h"
@@ -112,12 +114,31 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback m_invalidBlock;     // Pointer to the code that will be executed the PC is invalid
 
     uint32_t m_pc;
+    uint32_t m_pgxpMode = 0;  // PGXP mode the compiled code calls the hooks of. 0 when PGXP is off
     Emitter gen;
 
+    // The code cache is used as a ring buffer split in fixed-size segments. Once it fills up, we wrap around to the
+    // start and evict the oldest segments one by one, instead of throwing away every compiled block at once
+    static constexpr size_t CODE_SEGMENT_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t CODE_SEGMENT_COUNT = codeCacheSize / CODE_SEGMENT_SIZE;
+    static constexpr size_t CODE_CACHE_MARGIN = 0x100000;  // Space that must be free before we start a new block
+    static_assert(codeCacheSize % CODE_SEGMENT_SIZE == 0, "Code cache must be made of whole segments");
+
+    struct SegmentBlock {
+        DynarecCallback* entry;  // The block LUT entry that points to this block
+        DynarecCallback code;    // The entry's value when the block was compiled
+    };
+
+    std::array<std::vector<SegmentBlock>, CODE_SEGMENT_COUNT> m_codeSegments;  // Blocks overlapping each segment
+
+    size_t m_codeStart = 0;    // Offset of the first block in the code cache, right after the dispatcher
+    size_t m_freeCodeEnd = 0;  // Code can be emitted up to this offset without overwriting live blocks
+
     bool m_stopCompiling;  // Should we stop compiling code?
     bool m_pcWrittenBack;  // Has the PC been written back already by a jump?
     uint32_t m_ramSize;    // RAM is 2MB on retail units, 8MB on some DTL units (Can be toggled in GUI)
     const int MAX_BLOCK_SIZE = 50;
+    unsigned m_instructionsLeft = 0;  // How many more instructions the block being compiled can hold
 
     enum class RegState { Unknown, Constant };
     enum class LoadingMode { DoNotLoad, Load };
@@ -186,7 +207,11 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback* getBlockPointer(uint32_t pc);
     DynarecCallback recompile(DynarecCallback* callback, uint32_t pc, bool align = true);
     void error();
-    void flushCache();
+    void resetCodeSegments();
+    void reserveCodeSpace();
+    void evictCodeSegment(size_t segment);
+    void registerBlock(DynarecCallback* entry, DynarecCallback code, size_t start, size_t end);
+    int64_t getFreeCodeSpace() { return (int64_t)m_freeCodeEnd - (int64_t)gen.getSize(); }
     void handleLinking();
     void handleShellReached();
     void handleKernelCall();
@@ -201,13 +226,15 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static void recErrorWrapper(DynaRecCPU* that) { that->error(); }
 
     static void signalShellReached(DynaRecCPU* that);
+    static void pgxpHookWrapper(DynaRecCPU* that, uint32_t code);
+    static void idleLoopWrapper(DynaRecCPU* that, uint32_t start, uint32_t branchPC);
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, DynarecCallback* callback) {
         return that->recompile(callback, that->m_regs.pc);
     }
 
     template <uint32_t pc>
-    static void interceptKernelCallWrapper(DynaRecCPU* that) {
-        that->InterceptBIOS<false>(pc);
+    static bool interceptKernelCallWrapper(DynaRecCPU* that) {
+        return that->InterceptBIOS<false>(pc);
     }
 
     // TODO: This is currently un-unsed in x64 DynaRec. Check this.
@@ -221,7 +248,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
 
   public:
     DynaRecCPU() : R3000Acpu("Dynarec (arm64)") {}
-    virtual bool Implemented() final { return true; }
+    // Another emulator of the process may own the code cache already.
+    virtual bool Implemented() final { return gen.ownsCodeCache(); }
     virtual bool Init() final;
     virtual void Reset() final;
     virtual void Execute() final {
@@ -237,15 +265,17 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     virtual void Shutdown() final;
     virtual bool isDynarec() final { return true; }
 
+    // The PGXP hooks are part of the emitted code, so switching modes throws away everything compiled so far
     virtual void SetPGXPMode(uint32_t pgxpMode) final {
-        if (pgxpMode != 0) {
-            throw std::runtime_error("PGXP not supported in x64 JIT");
-        }
+        if (pgxpMode == m_pgxpMode) return;
+        m_pgxpMode = pgxpMode;
+        uncompileAll();
     }
 
     // For the GUI dynarec disassembly widget
     virtual const uint8_t* getBufferPtr() final { return gen.getCode<const uint8_t*>(); }
     virtual const size_t getBufferSize() final { return gen.getSize(); }
+    virtual const size_t getBufferCapacity() final { return codeCacheSize; }
 
   private:
     // Calculate the number of instructions between the current PC and the branch target
@@ -293,6 +323,15 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // For stores to a constant address: marks the RAM page behind the pointer as dirty, if it's in RAM at all
+    void markRAMPageDirty(const void* pointer) {
+        const auto& memory = PCSX::g_emulator->m_mem;
+        const uintptr_t offset = reinterpret_cast<const uint8_t*>(pointer) - memory->m_wram;
+        if (offset >= PCSX::Memory::c_ramSize) return;
+        auto& dirtyRAM = memory->getDirtyRAM();
+        store<8>(1, dirtyRAM.data() + (offset >> dirtyRAM.pageShift()));
+    }
+
     // Prepare for a call to a C++ function and then actually emit it
     template <typename T>
     void call(T& func) {
@@ -433,6 +472,25 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
 
     template <bool isAVSZ4>
     void recAVSZ(uint32_t code);
+    template <bool isRTPT>
+    void recRTP(uint32_t code);
+    void recNormalColor(uint32_t code, int vectorCount, bool colorMultiply);
+    void loadGTEDataRegister(Register dest, int index);
+
+    // Building blocks of the native GTE commands
+    bool useNativeGTE();
+    bool isGTEFlagLive();
+    uintptr_t gteMatrixOffset(int matrix, int row, int column);
+    uintptr_t gteVectorOffset(int vector, int component);
+    void emitGTELimit(Register value, Register scratch, int32_t min, int32_t max, uint32_t flagBits, bool trackFlags);
+    void emitGTEMAC0Flags();
+    void emitGTEMatrixRow(int matrix, int vector, int translation, int row, bool trackFlags);
+    void emitGTEMatrixVectorProduct(int matrix, int vector, int translation, bool sf, bool lm, bool trackFlags,
+                                    bool rtps = false);
+    void emitGTEDivide(bool trackFlags);
+    void emitGTEPerspectiveTransform(int vertex, bool sf, bool lm, bool trackFlags);
+    void emitGTEColorFIFO(bool trackFlags);
+    void emitGTENormalColor(int vector, bool sf, bool lm, bool trackFlags, bool colorMultiply);
 
     template <bool loadSR>
     void testSoftwareInterrupt();
@@ -497,7 +555,21 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         &DynaRecCPU::recUnknown, &DynaRecCPU::recGPF,     &DynaRecCPU::recGPL,     &DynaRecCPU::recNCCT,     // 3c
     };
 
-    static constexpr bool ENABLE_BLOCK_LINKING = false;
+    RecompilerProfiler<10000000> m_profiler;
+
+    bool startProfiling(uint32_t pc);
+    void endProfiling();
+    void dumpProfileData();
+    void countLink(uint64_t& counter) {
+        gen.Mov(x0, (uintptr_t)&counter);
+        gen.Ldr(x1, MemOperand(x0));
+        gen.Add(x1, x1, 1);
+        gen.Str(x1, MemOperand(x0));
+    }
+
+    static constexpr bool ENABLE_BLOCK_LINKING = true;
+    static constexpr bool ENABLE_PROFILER = false;
+    static constexpr bool ENABLE_GTE_FLAG_ELISION = true;
 };
 
 #endif  // DYNAREC_AA64
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "recompiler.h"
+
+#if defined(DYNAREC_X86_64)
+#include <cstring>
+#include <vector>
+
+#include "support/file.h"
+#include "support/hashing.h"
+
+// Block hints file layout, all little endian: the magic, then the version and the entry count as u32s, followed by
+// the entries, each one being its pc (u32), size in bytes (u32), hash (u64) and flags (u32), with no padding
+static constexpr char c_blockHintsMagic[8] = {'P', 'C', 'S', 'X', 'J', 'I', 'T', 'H'};
+static constexpr uint32_t c_blockHintsVersion = 3;
+static constexpr size_t c_blockHintsHeaderSize = sizeof(c_blockHintsMagic) + 4 + 4;
+static constexpr size_t c_blockHintEntrySize = 4 + 4 + 8 + 4;
+
+uint64_t DynaRecCPU::hashGuestCode(uint32_t pc, uint32_t size) {
+    const auto& memory = PCSX::g_emulator->m_mem;
+    std::vector<uint32_t> words;
+    words.reserve(size / 4);
+    for (uint32_t offset = 0; offset < size; offset += 4) {
+        const auto word = memory->getPointer<uint32_t>(pc + offset);
+        if (word == nullptr) break;
+        words.push_back(*word);
+    }
+    return PCSX::Hashing::xxh64(words.data(), words.size() * sizeof(uint32_t));
+}
+
+// Returns the flags to compile the block at pc with, if we have a hint for it and the code hasn't changed since
+std::optional<uint32_t> DynaRecCPU::findBlockHint(uint32_t pc) {
+    const auto hint = m_blockHints.find(pc);
+    if (hint == m_blockHints.end()) return std::nullopt;
+    if (hint->second.hash != hashGuestCode(pc, hint->second.size)) return std::nullopt;
+    return hint->second.flags;
+}
+
+void DynaRecCPU::recordBlockHint(uint32_t pc, uint32_t size, uint32_t flags) {
+    if (m_blockHintsPath.empty()) return;
+    m_blockHints[pc] = {hashGuestCode(pc, size), size, flags};
+}
+
+void DynaRecCPU::loadBlockHints() {
+    m_blockHints.clear();
+    m_blockHintsPath = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecBlockHints>().value;
+    if (m_blockHintsPath.empty()) return;
+
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(m_blockHintsPath));
+    if (file->failed()) return;
+
+    char magic[sizeof(c_blockHintsMagic)] = {};
+    file->read(magic, sizeof(magic));
+    const uint32_t version = file->read<uint32_t>();
+    const uint32_t count = file->read<uint32_t>();
+    if (std::memcmp(magic, c_blockHintsMagic, sizeof(magic)) != 0 || version != c_blockHintsVersion ||
+        file->size() != c_blockHintsHeaderSize + size_t(count) * c_blockHintEntrySize) {
+        PCSX::g_system->log(PCSX::LogClass::CPU, "[Dynarec] Ignoring invalid block hints file %s\n",
+                            m_blockHintsPath.string());
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t pc = file->read<uint32_t>();
+        const uint32_t size = file->read<uint32_t>();
+        const uint64_t hash = file->read<uint64_t>();
+        const uint32_t flags = file->read<uint32_t>();
+        // Only traces get hints, so anything empty, unaligned, longer than a trace, or outside of the memory we
+        // compile code from didn't come from us
+        if ((size == 0) || ((size % 4) != 0) || (size > MAX_TRACE_SIZE * 4)) continue;
+        if (((pc % 4) != 0) || !isPcValid(pc) || !isPcValid(pc + size - 4)) continue;
+        m_blockHints[pc] = {hash, size, flags};
+    }
+}
+
+void DynaRecCPU::saveBlockHints() {
+    if (m_blockHintsPath.empty() || m_blockHints.empty()) return;
+
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(m_blockHintsPath, PCSX::FileOps::TRUNCATE));
+    if (file->failed()) {
+        PCSX::g_system->log(PCSX::LogClass::CPU, "[Dynarec] Failed to write block hints file %s\n",
+                            m_blockHintsPath.string());
+        return;
+    }
+
+    file->write(c_blockHintsMagic, sizeof(c_blockHintsMagic));
+    file->write<uint32_t>(c_blockHintsVersion);
+    file->write<uint32_t>(m_blockHints.size());
+    for (const auto& [pc, hint] : m_blockHints) {
+        file->write<uint32_t>(pc);
+        file->write<uint32_t>(hint.size);
+        file->write<uint64_t>(hint.hash);
+        file->write<uint32_t>(hint.flags);
+    }
+}
+
+#endif  // DYNAREC_X86_64
@@ -18,6 +18,7 @@
  ***************************************************************************/
 
 #pragma once
+#include "core/dynarec-codecache.h"
 #include "core/r3000a.h"
 
 #ifdef DYNAREC_X86_64
@@ -38,7 +39,7 @@ constexpr size_t allocSize = codeCacheSize + 0x1000;
 // This has to be static so JIT code will be close enough to the executable to address stuff with rip-relative accesses
 alignas(4096) static uint8_t s_codeCache[allocSize];
 
-struct Emitter final : public CodeGenerator {
+struct Emitter final : public PCSX::CodeCacheClaim, public CodeGenerator {
     bool hasAVX = false;
     bool hasBMI2 = false;
     bool hasLZCNT = false;
@@ -228,6 +229,7 @@ struct Emitter final : public CodeGenerator {
     // Tries to mark the emitter memory as readable/writeable/executable without throwing an exception.
     // Returns whether or not it succeeded
     bool setRWX() {
+        if (!ownsCodeCache()) return false;
 #ifdef __APPLE__  // MacOS doesn't like marking static memory as executable the way Xbyak does, so we do it ourselves
         return mmap(s_codeCache, allocSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
                     -1, 0) != MAP_FAILED;
@@ -378,14 +378,381 @@ void DynaRecCPU::recSWC2(uint32_t code) {
     callMemoryFunc(&PCSX::Memory::write32);
 }
 
-template <bool isAVSZ4>
-void DynaRecCPU::recAVSZ(uint32_t code) {
-    Xbyak::Label noOverflow, label1, end, checkIfBelowLim, notBelowLim;
+// Scratch registers for the native GTE commands. None of them can be allocated to guest registers.
+// rax holds the MAC being computed, rcx is only used for short-lived values as variable shifts need their count in cl
+static constexpr Reg32 gteFlag = edx;  // FLAG, written back once the command is done
+static constexpr Reg64 gteTemp1 = isWindows() ? r8 : rdi;
+static constexpr Reg64 gteTemp2 = isWindows() ? r9 : rsi;
+
+static constexpr bool gteSF(uint32_t code) { return (code >> 19) & 1; }
+static constexpr bool gteLM(uint32_t code) { return (code >> 10) & 1; }
+// The FLAG bits raised by Lm_B1-3 when limiting IR1-3
+static constexpr uint32_t gteIRFlag(int row) { return row == 2 ? (1 << 22) : (1 << 31) | (1 << (24 - row)); }
+
+// Whether the FLAG computed by the GTE command being compiled can be read. We only look at the instructions the
+// liveness analysis covered for this block, as those are guaranteed to run right after this one.
+bool DynaRecCPU::isGTEFlagLive() {
+    if constexpr (!ENABLE_GTE_FLAG_ELISION) return true;
+    if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecGTEFlagElision>()) return true;
+    if (m_inDelaySlot) return true;  // The next instruction to run is the branch target, not the one after us
+    if (m_livenessIndex >= m_livenessCount) return true;
+
+    return PCSX::GTE::isFlagLive(m_pc, m_livenessCount - m_livenessIndex);
+}
+
+// The commands emitted natively are opt-in for now, the rest of the time they call into the C++ version, like the
+// commands without a native version do. Blocks compiled before toggling this keep the code they got.
+bool DynaRecCPU::useNativeGTE() {
+    return PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecNativeGTE>();
+}
 
-    constexpr Reg32 flag = arg1;  // Register for FLAG
-    const Reg64 scaleFactor = arg2.cvt64();
+// Offset from contextPointer of a 16-bit element of one of the GTE matrices (0 = rotation, 1 = light, 2 = light color)
+uintptr_t DynaRecCPU::gteMatrixOffset(int matrix, int row, int column) {
+    const int element = row * 3 + column;
+    return COP2_CONTROL_OFFSET((matrix << 3) + (element >> 1)) + (element & 1) * sizeof(int16_t);
+}
+
+// Offset from contextPointer of a component of V0-V2, or of IR1-3 for vector 3
+uintptr_t DynaRecCPU::gteVectorOffset(int vector, int component) {
+    if (vector == 3) return COP2_DATA_OFFSET(9 + component);
 
-    gen.xor_(flag, flag);  // Set FLAG to 0
+    const int element = vector * 4 + component;
+    return COP2_DATA_OFFSET(element >> 1) + (element & 1) * sizeof(int16_t);
+}
+
+// Saturate value to [min, max], raising flagBits in FLAG if it had to be saturated. Without flags, this is branchless
+void DynaRecCPU::emitGTELimit(Reg32 value, Reg32 scratch, int32_t min, int32_t max, uint32_t flagBits,
+                              bool trackFlags) {
+    if (!trackFlags || flagBits == 0) {
+        gen.mov(scratch, (uint32_t)max);
+        gen.cmp(value, scratch);
+        gen.cmovg(value, scratch);
+        gen.mov(scratch, (uint32_t)min);
+        gen.cmp(value, scratch);
+        gen.cmovl(value, scratch);
+        return;
+    }
+
+    Label checkIfBelowMin, end;
+    gen.cmp(value, (uint32_t)max);
+    gen.jle(checkIfBelowMin);
+    gen.mov(value, (uint32_t)max);
+    gen.or_(gteFlag, flagBits);
+    gen.jmp(end);
+
+    gen.L(checkIfBelowMin);
+    gen.cmp(value, (uint32_t)min);
+    gen.jge(end);
+    gen.mov(value, (uint32_t)min);
+    gen.or_(gteFlag, flagBits);
+    gen.L(end);
+}
+
+// Raise the FLAG bits of F(rax), the MAC0 overflow checks
+void DynaRecCPU::emitGTEMAC0Flags() {
+    Label notAboveMax, notBelowMin;
+    gen.cmp(rax, 0x7fffffff);
+    gen.jle(notAboveMax);
+    gen.or_(gteFlag, (1 << 31) | (1 << 16));
+    gen.L(notAboveMax);
+
+    gen.cmp(rax, 0x80000000);
+    gen.jge(notBelowMin);
+    gen.or_(gteFlag, (1 << 31) | (1 << 15));
+    gen.L(notBelowMin);
+}
+
+// rax = translation + matrix[row] * vector, going through the GTE's 44-bit adders like the int44 class does.
+// translation is the control register holding the translation vector (which gets shifted left by 12), or -1 for none.
+// Without a translation, the sum can't overflow 44 bits, so there's nothing to wrap or check.
+void DynaRecCPU::emitGTEMatrixRow(int matrix, int vector, int translation, int row, bool trackFlags) {
+    const bool checkOverflows = trackFlags && translation >= 0;
+
+    if (translation >= 0) {
+        gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET(translation + row)]);
+        gen.shl(rax, 12);
+    } else {
+        gen.xor_(eax, eax);
+    }
+
+    for (int column = 0; column < 3; column++) {
+        gen.movsx(gteTemp1, word[contextPointer + gteMatrixOffset(matrix, row, column)]);
+        gen.movsx(gteTemp2, word[contextPointer + gteVectorOffset(vector, column)]);
+        gen.imul(gteTemp1, gteTemp2);
+        gen.add(rax, gteTemp1);
+
+        if (checkOverflows) {
+            Label noPositiveOverflow, noNegativeOverflow;
+            // The sum fits in 45 bits, so its top bits are 0 or -1 if it fits in 44 bits,
+            // 1 if it overflowed above 0x7ffffffffff, and -2 if it overflowed below -0x80000000000
+            gen.mov(gteTemp2, rax);
+            gen.sar(gteTemp2, 43);
+            gen.shl(rax, 20);  // Wrap the sum to 44 bits before the next addition
+            gen.sar(rax, 20);
+
+            gen.cmp(gteTemp2, 1);
+            gen.jne(noPositiveOverflow);
+            gen.or_(gteFlag, (1 << 31) | (1 << (30 - row)));
+            gen.L(noPositiveOverflow);
+
+            gen.cmp(gteTemp2, -2);
+            gen.jne(noNegativeOverflow);
+            gen.or_(gteFlag, (1 << 31) | (1 << (27 - row)));
+            gen.L(noNegativeOverflow);
+        }
+    }
+
+    // If we don't need the overflow flags, wrapping once at the end gives the same result as wrapping every addition
+    if (translation >= 0 && !checkOverflows) {
+        gen.shl(rax, 20);
+        gen.sar(rax, 20);
+    }
+}
+
+// MAC1-3 = A1-3(translation + matrix * vector), then IR1-3 = Lm_B1-3(MAC1-3).
+// For RTPS, IR3 is limited with Lm_B3_sf instead, and the unshifted MAC3 is left in rcx for the Z FIFO.
+void DynaRecCPU::emitGTEMatrixVectorProduct(int matrix, int vector, int translation, bool sf, bool lm, bool trackFlags,
+                                            bool rtps) {
+    for (int row = 0; row < 3; row++) {
+        emitGTEMatrixRow(matrix, vector, translation, row, trackFlags);
+        if (rtps && row == 2) {
+            gen.mov(rcx, rax);
+        }
+        if (sf) {
+            gen.sar(rax, 12);
+        }
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + row)], eax);
+    }
+
+    // The IRs are only written once all 3 MACs are done, as the vector might be IR1-3 itself
+    const int32_t min = lm ? 0 : -0x8000;
+    for (int row = 0; row < 3; row++) {
+        gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(25 + row)]);
+
+        if (rtps && row == 2) {
+            if (trackFlags) {  // Lm_B3_sf checks MAC3 >> 12 for overflows no matter what sf is
+                Label outOfRange, inRange;
+                gen.mov(gteTemp2, rcx);
+                gen.sar(gteTemp2, 12);
+                gen.cmp(gteTemp2.cvt32(), 0x7fff);
+                gen.jg(outOfRange);
+                gen.cmp(gteTemp2.cvt32(), (uint32_t)-0x8000);
+                gen.jge(inRange);
+                gen.L(outOfRange);
+                gen.or_(gteFlag, 1 << 22);
+                gen.L(inRange);
+            }
+            emitGTELimit(eax, gteTemp1.cvt32(), min, 0x7fff, 0, false);
+        } else {
+            emitGTELimit(eax, gteTemp1.cvt32(), min, 0x7fff, gteIRFlag(row), trackFlags);
+        }
+
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(9 + row)], ax);
+    }
+}
+
+// gteTemp2 = gte_divide(gteTemp1, gteTemp2), for a zero-extended 16-bit numerator and denominator. Uses rax and rcx
+void DynaRecCPU::emitGTEDivide(bool trackFlags) {
+    const Reg32 numerator = gteTemp1.cvt32();
+    const Reg32 denominator = gteTemp2.cvt32();
+    Label noOverflow, end;
+
+    gen.lea(eax, dword[gteTemp2 + gteTemp2]);  // The division overflows if numerator >= denominator * 2
+    gen.cmp(numerator, eax);
+    gen.jb(noOverflow);
+    gen.mov(denominator, 0x1ffff);
+    if (trackFlags) {
+        gen.or_(gteFlag, (1 << 31) | (1 << 17));
+    }
+    gen.jmp(end);
+
+    // The denominator can't be 0 if we got here. Shift both operands left by its leading zero count
+    gen.L(noOverflow);
+    if (gen.hasLZCNT) {
+        gen.lzcnt(ecx, denominator);
+        gen.sub(ecx, 16);
+    } else {
+        gen.bsr(ecx, denominator);  // Bit index from 0 to 15, so 15 - index = index ^ 15
+        gen.xor_(ecx, 15);
+    }
+    gen.shl(numerator, cl);
+    gen.shl(denominator, cl);
+
+    // eax = r2 = s_reciprocalTable[(r1 + 0x40) >> 7] + 0x101, with r1 = (denominator << shift) & 0x7fff
+    gen.and_(denominator, 0x7fff);
+    gen.lea(eax, dword[gteTemp2 + 0x40]);
+    gen.shr(eax, 7);
+    loadAddress(rcx, (void*)PCSX::GTE::s_reciprocalTable);
+    gen.movzx(eax, Xbyak::util::byte[rcx + rax]);
+    gen.add(eax, 0x101);
+
+    // ecx = r3 = ((0x80 - r2 * (r1 + 0x8000)) >> 8) & 0x1ffff
+    gen.add(denominator, 0x8000);
+    gen.imul(denominator, eax);
+    gen.mov(ecx, 0x80);
+    gen.sub(ecx, denominator);
+    gen.sar(ecx, 8);
+    gen.and_(ecx, 0x1ffff);
+
+    // reciprocal = (r2 * r3 + 0x80) >> 8, result = min((reciprocal * (numerator << shift) + 0x8000) >> 16, 0x1ffff)
+    gen.imul(eax, ecx);
+    gen.add(eax, 0x80);
+    gen.shr(eax, 8);
+    gen.imul(rax, gteTemp1);
+    gen.add(rax, 0x8000);
+    gen.shr(rax, 16);
+    gen.mov(denominator, 0x1ffff);
+    gen.cmp(eax, denominator);
+    gen.cmovb(denominator, eax);
+    gen.L(end);
+}
+
+// One RTPS step for vertex V<vertex>: transform it and push the result to the screen coordinate FIFOs.
+// Leaves H / SZ3 in gteTemp2 for the depth cueing that follows the last vertex
+void DynaRecCPU::emitGTEPerspectiveTransform(int vertex, bool sf, bool lm, bool trackFlags) {
+    emitGTEMatrixVectorProduct(0, vertex, 5, sf, lm, trackFlags, true);
+
+    // Push Lm_D(MAC3 >> 12) to the Z FIFO
+    gen.sar(rcx, 12);
+    emitGTELimit(ecx, gteTemp1.cvt32(), 0, 0xffff, (1 << 31) | (1 << 18), trackFlags);
+    for (int i = 16; i < 19; i++) {
+        gen.movzx(eax, word[contextPointer + COP2_DATA_OFFSET(i + 1)]);
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(i)], ax);
+    }
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(19)], cx);
+
+    // gteTemp2 = H / SZ3
+    gen.movzx(gteTemp1.cvt32(), word[contextPointer + COP2_CONTROL_OFFSET(26)]);
+    gen.movzx(gteTemp2.cvt32(), cx);
+    emitGTEDivide(trackFlags);
+
+    gen.mov(rax, qword[contextPointer + COP2_DATA_OFFSET(13)]);  // SXY0 = SXY1 and SXY1 = SXY2
+    gen.mov(qword[contextPointer + COP2_DATA_OFFSET(12)], rax);
+
+    // SX2 = Lm_G1(F(OFX + IR1 * H / SZ3) >> 16), SY2 = Lm_G2(F(OFY + IR2 * H / SZ3) >> 16)
+    for (int axis = 0; axis < 2; axis++) {
+        gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET(24 + axis)]);
+        gen.movsx(rcx, word[contextPointer + COP2_DATA_OFFSET(9 + axis)]);
+        gen.imul(rcx, gteTemp2);
+        gen.add(rax, rcx);
+        if (trackFlags) {
+            emitGTEMAC0Flags();
+        }
+        gen.sar(rax, 16);
+        emitGTELimit(eax, ecx, -0x400, 0x3ff, (1 << 31) | (1 << (14 - axis)), trackFlags);
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(14) + axis * sizeof(int16_t)], ax);
+    }
+}
+
+// RGB0 = RGB1, RGB1 = RGB2, RGB2 = CODE and Lm_C1-3(MAC1-3 >> 4)
+void DynaRecCPU::emitGTEColorFIFO(bool trackFlags) {
+    gen.mov(rax, qword[contextPointer + COP2_DATA_OFFSET(21)]);
+    gen.mov(qword[contextPointer + COP2_DATA_OFFSET(20)], rax);
+    gen.mov(al, Xbyak::util::byte[contextPointer + COP2_DATA_OFFSET(6) + 3]);
+    gen.mov(Xbyak::util::byte[contextPointer + COP2_DATA_OFFSET(22) + 3], al);
+
+    for (int component = 0; component < 3; component++) {
+        gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(25 + component)]);
+        gen.sar(eax, 4);
+        emitGTELimit(eax, gteTemp1.cvt32(), 0, 0xff, 1 << (21 - component), trackFlags);
+        gen.mov(Xbyak::util::byte[contextPointer + COP2_DATA_OFFSET(22) + component], al);
+    }
+}
+
+// MAC1-3 = A1-3((RGB << 4) * IR1-3), IR1-3 = Lm_B1-3(MAC1-3). This can't overflow, so only the limiters raise flags
+void DynaRecCPU::emitGTEColorMultiply(bool sf, bool lm, bool trackFlags) {
+    const int32_t min = lm ? 0 : -0x8000;
+    for (int row = 0; row < 3; row++) {
+        gen.movzx(eax, Xbyak::util::byte[contextPointer + COP2_DATA_OFFSET(6) + row]);
+        gen.shl(eax, 4);
+        gen.movsx(gteTemp1.cvt32(), word[contextPointer + COP2_DATA_OFFSET(9 + row)]);
+        gen.imul(eax, gteTemp1.cvt32());
+        if (sf) {
+            gen.sar(eax, 12);
+        }
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + row)], eax);
+        emitGTELimit(eax, gteTemp1.cvt32(), min, 0x7fff, gteIRFlag(row), trackFlags);
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(9 + row)], ax);
+    }
+}
+
+// MAC1-3 = A1-3((RGB << 4) * IR1-3 + IR0 * Lm_B1-3(A1-3((FC << 12) - (RGB << 4) * IR1-3), 0)), IR1-3 = Lm_B1-3(MAC1-3)
+// Only the far color difference can overflow 44 bits. It isn't wrapped, and gets truncated to 32 bits once shifted
+void DynaRecCPU::emitGTEDepthCue(bool sf, bool lm, bool trackFlags) {
+    const int32_t min = lm ? 0 : -0x8000;
+    for (int row = 0; row < 3; row++) {
+        // gteTemp1 = (RGB << 4) * IR
+        gen.movzx(eax, Xbyak::util::byte[contextPointer + COP2_DATA_OFFSET(6) + row]);
+        gen.shl(eax, 4);
+        gen.movsx(gteTemp1.cvt32(), word[contextPointer + COP2_DATA_OFFSET(9 + row)]);
+        gen.imul(eax, gteTemp1.cvt32());
+        gen.movsxd(gteTemp1, eax);
+
+        gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET(21 + row)]);
+        gen.shl(rax, 12);
+        gen.sub(rax, gteTemp1);
+        if (trackFlags) {  // Same as in emitGTEMatrixRow, the top bits are 1 or -2 if the difference overflowed
+            Label noPositiveOverflow, noNegativeOverflow;
+            gen.mov(gteTemp2, rax);
+            gen.sar(gteTemp2, 43);
+
+            gen.cmp(gteTemp2, 1);
+            gen.jne(noPositiveOverflow);
+            gen.or_(gteFlag, (1 << 31) | (1 << (30 - row)));
+            gen.L(noPositiveOverflow);
+
+            gen.cmp(gteTemp2, -2);
+            gen.jne(noNegativeOverflow);
+            gen.or_(gteFlag, (1 << 31) | (1 << (27 - row)));
+            gen.L(noNegativeOverflow);
+        }
+        if (sf) {
+            gen.sar(rax, 12);
+        }
+        emitGTELimit(eax, gteTemp2.cvt32(), -0x8000, 0x7fff, gteIRFlag(row), trackFlags);
+
+        // The interpolation stays within 32 bits, so it can't overflow either
+        gen.movsx(gteTemp2.cvt32(), word[contextPointer + COP2_DATA_OFFSET(8)]);
+        gen.imul(eax, gteTemp2.cvt32());
+        gen.add(eax, gteTemp1.cvt32());
+        if (sf) {
+            gen.sar(eax, 12);
+        }
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + row)], eax);
+        emitGTELimit(eax, gteTemp1.cvt32(), min, 0x7fff, gteIRFlag(row), trackFlags);
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(9 + row)], ax);
+    }
+}
+
+// The steps the lighting commands share once they have their light intensities in IR1-3: IR = BK + LCM * IR, then
+// the color step, and push the resulting color to the color FIFO
+void DynaRecCPU::emitGTEColor(bool sf, bool lm, bool trackFlags, GTEColorStep step) {
+    emitGTEMatrixVectorProduct(2, 3, 13, sf, lm, trackFlags);
+
+    switch (step) {
+        case GTEColorStep::None:
+            break;
+        case GTEColorStep::Multiply:
+            emitGTEColorMultiply(sf, lm, trackFlags);
+            break;
+        case GTEColorStep::DepthCue:
+            emitGTEDepthCue(sf, lm, trackFlags);
+            break;
+    }
+
+    emitGTEColorFIFO(trackFlags);
+}
+
+// The NCS/NCCS/NCDS step for normal vector V<vector>: IR = LLM * V, then the rest of the lighting
+void DynaRecCPU::emitGTENormalColor(int vector, bool sf, bool lm, bool trackFlags, GTEColorStep step) {
+    emitGTEMatrixVectorProduct(1, vector, -1, sf, lm, trackFlags);
+    emitGTEColor(sf, lm, trackFlags, step);
+}
+
+template <bool isAVSZ4>
+void DynaRecCPU::recAVSZ(uint32_t code) {
+    const bool trackFlags = isGTEFlagLive();
+    const Reg64 scaleFactor = gteTemp2;
 
     if constexpr (isAVSZ4) {  // Load SZF4 into scaleFactor if this is AVSZ4
         gen.movsx(scaleFactor, word[contextPointer + COP2_CONTROL_OFFSET(30)]);
@@ -395,15 +762,15 @@ void DynaRecCPU::recAVSZ(uint32_t code) {
 
     // eax = SZ1 + SZ2 + SZ3
     gen.movzx(eax, word[contextPointer + COP2_DATA_OFFSET(17)]);
-    gen.movzx(arg3, word[contextPointer + COP2_DATA_OFFSET(18)]);
-    gen.add(rax, arg3.cvt64());
-    gen.movzx(arg3, word[contextPointer + COP2_DATA_OFFSET(19)]);
-    gen.add(rax, arg3.cvt64());
+    gen.movzx(gteTemp1.cvt32(), word[contextPointer + COP2_DATA_OFFSET(18)]);
+    gen.add(rax, gteTemp1);
+    gen.movzx(gteTemp1.cvt32(), word[contextPointer + COP2_DATA_OFFSET(19)]);
+    gen.add(rax, gteTemp1);
 
     // eax += SZ0 for AVSZ4
     if constexpr (isAVSZ4) {
-        gen.movzx(arg3.cvt64(), word[contextPointer + COP2_DATA_OFFSET(16)]);
-        gen.add(rax, arg3.cvt64());
+        gen.movzx(gteTemp1.cvt32(), word[contextPointer + COP2_DATA_OFFSET(16)]);
+        gen.add(rax, gteTemp1);
     }
 
     // rax = (Sum of Z values) * scaleFactor
@@ -411,43 +778,180 @@ void DynaRecCPU::recAVSZ(uint32_t code) {
     // Set MAC0
     gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);
     // Calculate flags if MAC0 result is larger than 31 bits
-    gen.cmp(rax, 0x7fffffff);
-    gen.jle(label1);
-    gen.mov(flag, (1 << 31) | (1 << 16));
-    gen.jmp(noOverflow);
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+        emitGTEMAC0Flags();
+    }
 
-    gen.L(label1);
-    gen.cmp(rax, 0x80000000);
-    gen.jge(noOverflow);
-    gen.mov(flag, (1 << 31) | (1 << 15));
-    gen.L(noOverflow);
+    // Saturate MAC0 >> 12 to [0, 0xffff] and set OTZ to the saturated value
+    gen.sar(rax, 12);
+    emitGTELimit(eax, gteTemp1.cvt32(), 0, 0xffff, (1 << 31) | (1 << 18), trackFlags);
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(7)], ax);
 
-    gen.shr(rax, 12);
-    // Saturate eax to [0, 0xffff] and set OTZ to the saturated value
+    if (trackFlags) {
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
+}
 
-    gen.cmp(eax, 0x10000);    // Check if above 0xffff
-    gen.jl(checkIfBelowLim);  // If not, check if below
-    // Set FLAG, set OTZ to 0xffff is MAC0 > 0xffff
-    gen.or_(flag, (1 << 31) | (1 << 18));
-    gen.mov(word[contextPointer + COP2_DATA_OFFSET(7)], 0xffff);
-    gen.jmp(end);
+void DynaRecCPU::recAVSZ3(uint32_t code) { recAVSZ<false>(code); }
+void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
+
+void DynaRecCPU::recNCLIP(uint32_t code) {
+    // With PGXP on, NCLIP may use the precise screen coordinates instead, which only the C++ version knows about
+    if (m_pgxpMode != 0 || !useNativeGTE()) {
+        gen.mov(arg2, code);
+        callGTEFunc(&PCSX::GTE::NCLIP);
+        return;
+    }
+
+    const bool trackFlags = isGTEFlagLive();
+    // The (SXn, SYm) products, the first 3 are added and the last 3 subtracted
+    constexpr int terms[6][2] = {{0, 1}, {1, 2}, {2, 0}, {0, 2}, {1, 0}, {2, 1}};
+
+    gen.xor_(eax, eax);
+    for (int i = 0; i < 6; i++) {
+        gen.movsx(gteTemp1, word[contextPointer + COP2_DATA_OFFSET(12 + terms[i][0])]);
+        gen.movsx(gteTemp2, word[contextPointer + COP2_DATA_OFFSET(12 + terms[i][1]) + sizeof(int16_t)]);
+        gen.imul(gteTemp1, gteTemp2);
+        if (i < 3) {
+            gen.add(rax, gteTemp1);
+        } else {
+            gen.sub(rax, gteTemp1);
+        }
+    }
+
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);  // Set MAC0
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+        emitGTEMAC0Flags();
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
+}
+
+void DynaRecCPU::recMVMVA(uint32_t code) {
+    const int mx = (code >> 17) & 3;
+    const int v = (code >> 15) & 3;
+    const int cv = (code >> 13) & 3;
+
+    // The garbage matrix and the buggy far color translation are rarely ever used, leave them to the C++ version
+    if (mx == 3 || cv == 2 || !useNativeGTE()) {
+        gen.mov(arg2, code);
+        callGTEFunc(&PCSX::GTE::MVMVA);
+        return;
+    }
+
+    const bool trackFlags = isGTEFlagLive();
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+    }
+
+    // Translation vector 0 is TR, 1 is BK and 3 is none
+    emitGTEMatrixVectorProduct(mx, v, cv == 3 ? -1 : (cv << 3) + 5, gteSF(code), gteLM(code), trackFlags);
 
-    gen.L(checkIfBelowLim);  // Check if below 0
+    if (trackFlags) {
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
+}
+
+template <bool isRTPT>
+void DynaRecCPU::recRTP(uint32_t code) {
+    Label fallback, end;
+    const bool trackFlags = isGTEFlagLive();
+
+    // The widescreen hack and PGXP are only handled by the C++ version. They can be toggled at any point, so check
+    // them at runtime. Flush the volatile registers for both paths, so the register allocator state stays the same.
+    prepareForCall();
+    load<8, false>(eax, &PCSX::g_emulator->config().Widescreen);
+    gen.test(eax, eax);
+    gen.jnz(fallback);
+    load<8, false>(eax, &PCSX::g_emulator->config().PGXP_GTE);
     gen.test(eax, eax);
-    gen.jns(notBelowLim);
-    // Set FLAG, and set OTZ to 0 if MAC0 < 0
-    gen.or_(flag, (1 << 31) | (1 << 18));
-    gen.mov(word[contextPointer + COP2_DATA_OFFSET(7)], 0);
+    gen.jnz(fallback);
+
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+    }
+
+    constexpr int vertexCount = isRTPT ? 3 : 1;
+    for (int vertex = 0; vertex < vertexCount; vertex++) {
+        emitGTEPerspectiveTransform(vertex, gteSF(code), gteLM(code), trackFlags);
+    }
+
+    // MAC0 = F(DQB + DQA * H / SZ3), IR0 = Lm_H(MAC0 >> 12)
+    gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET(28)]);
+    gen.movsx(rcx, word[contextPointer + COP2_CONTROL_OFFSET(27)]);
+    gen.imul(rcx, gteTemp2);
+    gen.add(rax, rcx);
+    if (trackFlags) {
+        emitGTEMAC0Flags();
+    }
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);
+    gen.sar(rax, 12);
+    emitGTELimit(eax, ecx, 0, 0x1000, 1 << 12, trackFlags);
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(8)], ax);
+
+    if (trackFlags) {
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
     gen.jmp(end);
 
-    gen.L(notBelowLim);  // handle the case where eax doesn't need to be saturated
-    gen.mov(word[contextPointer + COP2_DATA_OFFSET(7)], ax);
+    gen.L(fallback);
+    gen.mov(arg2, code);
+    emitMemberFunctionCall(isRTPT ? &PCSX::GTE::RTPT : &PCSX::GTE::RTPS, PCSX::g_emulator->m_gte.get());
     gen.L(end);
-    gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], flag);  // Writeback FLAG
 }
 
-void DynaRecCPU::recAVSZ3(uint32_t code) { recAVSZ<false>(code); }
-void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
+void DynaRecCPU::recNormalColor(uint32_t code, int vectorCount, GTEColorStep step) {
+    const bool trackFlags = isGTEFlagLive();
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+    }
+
+    for (int vector = 0; vector < vectorCount; vector++) {
+        emitGTENormalColor(vector, gteSF(code), gteLM(code), trackFlags, step);
+    }
+
+    if (trackFlags) {
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
+}
+
+// CC and CDP light the intensities already in IR1-3 instead of a normal vector
+void DynaRecCPU::recColor(uint32_t code, GTEColorStep step) {
+    const bool trackFlags = isGTEFlagLive();
+    if (trackFlags) {
+        gen.xor_(gteFlag, gteFlag);
+    }
+
+    emitGTEColor(gteSF(code), gteLM(code), trackFlags, step);
+
+    if (trackFlags) {
+        gen.mov(dword[contextPointer + COP2_CONTROL_OFFSET(31)], gteFlag);  // Writeback FLAG
+    }
+}
+
+#define GTE_NATIVE(name, native)                \
+    void DynaRecCPU::rec##name(uint32_t code) { \
+        if (useNativeGTE()) {                   \
+            native;                             \
+            return;                             \
+        }                                       \
+        gen.mov(arg2, code);                    \
+        callGTEFunc(&PCSX::GTE::name);          \
+    }
+
+GTE_NATIVE(RTPS, recRTP<false>(code));
+GTE_NATIVE(RTPT, recRTP<true>(code));
+GTE_NATIVE(NCS, recNormalColor(code, 1, GTEColorStep::None));
+GTE_NATIVE(NCT, recNormalColor(code, 3, GTEColorStep::None));
+GTE_NATIVE(NCCS, recNormalColor(code, 1, GTEColorStep::Multiply));
+GTE_NATIVE(NCCT, recNormalColor(code, 3, GTEColorStep::Multiply));
+GTE_NATIVE(NCDS, recNormalColor(code, 1, GTEColorStep::DepthCue));
+GTE_NATIVE(NCDT, recNormalColor(code, 3, GTEColorStep::DepthCue));
+GTE_NATIVE(CC, recColor(code, GTEColorStep::Multiply));
+GTE_NATIVE(CDP, recColor(code, GTEColorStep::DepthCue));
+
+#undef GTE_NATIVE
 
 #define GTE_FALLBACK(name)                      \
     void DynaRecCPU::rec##name(uint32_t code) { \
@@ -455,25 +959,13 @@ void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
         callGTEFunc(&PCSX::GTE::name);          \
     }
 
-GTE_FALLBACK(CC);
-GTE_FALLBACK(CDP);
 GTE_FALLBACK(DCPL);
 GTE_FALLBACK(DPCS);
 GTE_FALLBACK(DPCT);
 GTE_FALLBACK(GPF);
 GTE_FALLBACK(GPL);
 GTE_FALLBACK(INTPL);
-GTE_FALLBACK(MVMVA);
-GTE_FALLBACK(NCCS);
-GTE_FALLBACK(NCCT);
-GTE_FALLBACK(NCDS);
-GTE_FALLBACK(NCDT);
-GTE_FALLBACK(NCLIP);
-GTE_FALLBACK(NCS);
-GTE_FALLBACK(NCT);
 GTE_FALLBACK(OP);
-GTE_FALLBACK(RTPS);
-GTE_FALLBACK(RTPT);
 GTE_FALLBACK(SQR);
 
 #undef GTE_FALLBACK
@@ -683,26 +683,135 @@ void DynaRecCPU::recMULTU(uint32_t code) {
     gen.mov(dword[contextPointer + HI_OFFSET], edx);
 }
 
-template <int size, bool signExtend>
-void DynaRecCPU::recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType type) {
-    if (m_gprs[_Rs_].isConst()) {
-        gen.mov(arg2, m_gprs[_Rs_].val + _Imm_);
-    } else {
-        allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
+// Look up the page of the address in arg2 in one of the memory LUTs. Jumps to slowPath if the page isn't mapped
+// or if the address is in the msan range, which the LUTs also cover but needs the checks done in Memory.
+// Otherwise returns the page pointer in rcx and the offset into the page in eax.
+void DynaRecCPU::emitLUTLookup(uint8_t** lut, Label& slowPath) {
+    gen.mov(eax, arg2);
+    gen.sub(eax, PCSX::Memory::c_msanStart);
+    gen.cmp(eax, PCSX::Memory::c_msanSize);
+    gen.jb(slowPath, CodeGenerator::T_NEAR);
+
+    gen.mov(eax, arg2);
+    gen.shr(eax, 16);
+    loadAddress(rcx, lut);
+    gen.mov(rcx, qword[rcx + rax * 8]);
+    gen.test(rcx, rcx);
+    gen.jz(slowPath, CodeGenerator::T_NEAR);
+    gen.movzx(eax, arg2.cvt16());
+}
+
+template <int size>
+void DynaRecCPU::emitMemoryRead(bool useLUT) {
+    static_assert(size == 8 || size == 16 || size == 32);
+    const auto& memory = PCSX::g_emulator->m_mem;
+    Label slowPath, done;
+
+    // Flush volatiles for both paths, so the register cache is in the same state no matter which one got taken
+    prepareForCall();
+    if (ENABLE_INLINE_MEMORY_ACCESS && useLUT) {
+        emitLUTLookup(memory->m_readLUT, slowPath);
+        switch (size) {
+            case 8:
+                gen.movzx(eax, Xbyak::util::byte[rcx + rax]);
+                break;
+            case 16:
+                gen.movzx(eax, word[rcx + rax]);
+                break;
+            case 32:
+                gen.mov(eax, dword[rcx + rax]);
+                break;
+        }
+        gen.add(qword[contextPointer + CYCLE_OFFSET], 1);  // Same as the Memory read handlers
+        gen.jmp(done, CodeGenerator::T_NEAR);
+        gen.L(slowPath);
+    }
+
+    switch (size) {
+        case 8:
+            emitMemberFunctionCall(&PCSX::Memory::read8, memory.get());
+            break;
+        case 16:
+            emitMemberFunctionCall(&PCSX::Memory::read16, memory.get());
+            break;
+        case 32:
+            emitMemberFunctionCall(&PCSX::Memory::read32, memory.get());
+            break;
+    }
+    gen.L(done);
+}
+
+template <int size>
+void DynaRecCPU::emitMemoryWrite(bool useLUT) {
+    static_assert(size == 8 || size == 16 || size == 32);
+    const auto& memory = PCSX::g_emulator->m_mem;
+    Label slowPath, done;
+
+    prepareForCall();
+    if (ENABLE_INLINE_MEMORY_ACCESS && useLUT) {
+        emitLUTLookup(memory->m_writeLUT, slowPath);
+        switch (size) {
+            case 8:
+                gen.mov(Xbyak::util::byte[rcx + rax], arg3.cvt8());
+                break;
+            case 16:
+                gen.mov(word[rcx + rax], arg3.cvt16());
+                break;
+            case 32:
+                gen.mov(dword[rcx + rax], arg3);
+                break;
+        }
+
+        gen.add(qword[contextPointer + CYCLE_OFFSET], 1);
+
+        // Only go through Clear() if the code bitmap says there's compiled code at the written word
+        gen.add(rcx, rax);
+        loadAddress(rax, memory->m_wram);
+        gen.sub(rcx, rax);  // rcx = offset of the written word in RAM
+
+        // Mark the page as dirty. Masking keeps writes going through the LUT somewhere else than RAM, such as
+        // the msan memory, inside the map, at the cost of a spurious dirty page
+        auto& dirtyRAM = memory->getDirtyRAM();
+        gen.mov(arg3, ecx);
+        gen.shr(arg3, dirtyRAM.pageShift());
+        gen.and_(arg3, dirtyRAM.pageCount() - 1);
+        loadAddress(rax, dirtyRAM.data());
+        gen.mov(Xbyak::util::byte[rax + arg3.cvt64()], 1);
+
+        gen.shr(ecx, 2);
+        loadAddress(rax, m_codeBitmap);
+        gen.bt(dword[rax], ecx);
+        gen.jnc(done, CodeGenerator::T_NEAR);
+        loadThisPointer(arg1.cvt64());
+        gen.callFunc(recClearWrapper);  // Address is still in arg2
+        gen.jmp(done, CodeGenerator::T_NEAR);
+        gen.L(slowPath);
     }
 
     switch (size) {
         case 8:
-            callMemoryFunc(&PCSX::Memory::read8);
+            emitMemberFunctionCall(&PCSX::Memory::write8, memory.get());
             break;
         case 16:
-            callMemoryFunc(&PCSX::Memory::read16);
+            emitMemberFunctionCall(&PCSX::Memory::write16, memory.get());
             break;
         case 32:
-            callMemoryFunc(&PCSX::Memory::read32);
+            emitMemberFunctionCall(&PCSX::Memory::write32, memory.get());
             break;
     }
+    gen.L(done);
+}
+
+template <int size, bool signExtend>
+void DynaRecCPU::recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType type) {
+    if (m_gprs[_Rs_].isConst()) {
+        gen.mov(arg2, m_gprs[_Rs_].val + _Imm_);
+    } else {
+        allocateReg(_Rs_);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
+    }
+
+    emitMemoryRead<size>(!m_gprs[_Rs_].isConst());
 
     if (_Rt_) {
         m_delayedLoadInfo[m_currentDelayedLoad].active = true;
@@ -762,17 +871,7 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
         gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
     }
 
-    switch (size) {
-        case 8:
-            callMemoryFunc(&PCSX::Memory::read8);
-            break;
-        case 16:
-            callMemoryFunc(&PCSX::Memory::read16);
-            break;
-        case 32:
-            callMemoryFunc(&PCSX::Memory::read32);
-            break;
-    }
+    emitMemoryRead<size>(!m_gprs[_Rs_].isConst());
 
     if (_Rt_) {
         allocateRegWithoutLoad(_Rt_);  // Allocate $rt after calling the read function, otherwise call() might flush it.
@@ -996,6 +1095,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 allocateReg(_Rt_);
                 store<8>(m_gprs[_Rt_].allocatedReg.cvt8(), pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
@@ -1020,8 +1120,8 @@ void DynaRecCPU::recSB(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write8);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        emitMemoryWrite<8>(true);
     }
 }
 
@@ -1036,6 +1136,7 @@ void DynaRecCPU::recSH(uint32_t code) {
                 allocateReg(_Rt_);
                 store<16>(m_gprs[_Rt_].allocatedReg.cvt16(), pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
@@ -1088,8 +1189,8 @@ void DynaRecCPU::recSH(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write16);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        emitMemoryWrite<16>(true);
     }
 }
 
@@ -1104,6 +1205,7 @@ void DynaRecCPU::recSW(uint32_t code) {
                 allocateReg(_Rt_);
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
+            markRAMPageDirty(pointer);
 
             return;
         }
@@ -1128,8 +1230,8 @@ void DynaRecCPU::recSW(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write32);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        emitMemoryWrite<32>(true);
     }
 }
 
@@ -1477,6 +1579,7 @@ void DynaRecCPU::recBNE(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmovne(eax, ecx);    // if not equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_conditionalTargets = std::make_pair(target, m_pc + 4);
 }
 
 void DynaRecCPU::recJ(uint32_t code) {
@@ -1575,6 +1678,7 @@ void DynaRecCPU::recREGIMM(uint32_t code) {
     }
 
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_conditionalTargets = std::make_pair(target, m_pc + 4);
 }
 
 void DynaRecCPU::recBEQ(uint32_t code) {
@@ -1612,6 +1716,7 @@ void DynaRecCPU::recBEQ(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmove(eax, ecx);     // if equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_conditionalTargets = std::make_pair(target, m_pc + 4);
 }
 
 void DynaRecCPU::recBGTZ(uint32_t code) {
@@ -1645,6 +1750,7 @@ void DynaRecCPU::recBGTZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovg(eax, ecx);     // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_conditionalTargets = std::make_pair(target, m_pc + 4);
 }
 
 void DynaRecCPU::recBLEZ(uint32_t code) {
@@ -1678,6 +1784,7 @@ void DynaRecCPU::recBLEZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovle(eax, ecx);    // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_conditionalTargets = std::make_pair(target, m_pc + 4);
 }
 
 void DynaRecCPU::recDIV(uint32_t code) {
@@ -1882,7 +1989,58 @@ void DynaRecCPU::recException(Exception e) {
     call(exceptionWrapper);  // Call the exception wrapper
 }
 
-void DynaRecCPU::recSYSCALL(uint32_t code) { recException(Exception::Syscall); }
+// Games go through syscalls all the time, for their critical sections, so the exception is raised in the block's
+// epilogue once the registers got flushed, without calling out, and the block links to the exception handler.
+void DynaRecCPU::recSYSCALL(uint32_t code) {
+    m_pcWrittenBack = true;
+    m_stopCompiling = true;
+    m_linkedPC = std::nullopt;  // A branch we're in the delay slot of doesn't get to go anywhere
+    m_conditionalTargets = std::nullopt;
+    m_syscall = {m_pc - 4, m_inDelaySlot};
+}
+
+// Same as R3000Acpu::exception, for the syscall ending the block. A first chance exception set for syscalls goes
+// through it instead, and so does the handler in the BIOS, which isn't linked to.
+void DynaRecCPU::emitSyscall() {
+    const auto [pc, bd] = m_syscall.value();
+    auto& firstChance = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+                            .get<PCSX::Emulator::DebugSettings::FirstChanceException>()
+                            .value;
+    const uint32_t code = static_cast<uint32_t>(Exception::Syscall) << 2;
+    const auto inISROffset = (uintptr_t)&m_inISR - (uintptr_t)this;
+    Label generic, linked;
+
+    loadAddress(rax, &firstChance);
+    gen.test(dword[rax], 1 << static_cast<uint32_t>(Exception::Syscall));
+    gen.jnz(generic, CodeGenerator::T_NEAR);
+
+    gen.mov(dword[contextPointer + COP0_OFFSET(14)], bd ? pc - 4 : pc);              // EPC
+    gen.mov(dword[contextPointer + COP0_OFFSET(13)], code | (bd ? 0x80000000 : 0));  // Cause
+    gen.mov(eax, dword[contextPointer + COP0_OFFSET(12)]);  // Push the interrupt enable and user mode bits of SR
+    gen.mov(ecx, eax);
+    gen.and_(eax, ~0x3f);
+    gen.and_(ecx, 0xf);
+    gen.shl(ecx, 2);
+    gen.or_(eax, ecx);
+    gen.mov(dword[contextPointer + COP0_OFFSET(12)], eax);
+    gen.mov(Xbyak::util::byte[contextPointer + inISROffset], 1);
+    gen.mov(dword[contextPointer + PC_OFFSET], 0x80000080);
+    gen.test(eax, 0x400000);  // BEV
+    gen.jz(linked, CodeGenerator::T_NEAR);
+    gen.mov(dword[contextPointer + PC_OFFSET], 0xbfc00180);
+    gen.jmp((void*)m_returnFromBlock);
+
+    gen.L(generic);
+    gen.mov(dword[contextPointer + PC_OFFSET], pc);
+    loadThisPointer(arg1.cvt64());
+    gen.moveImm(arg2, code);
+    gen.moveImm(arg3, (int32_t)bd);
+    gen.callFunc(exceptionWrapper);
+    gen.jmp((void*)m_returnFromBlock);
+
+    gen.L(linked);
+    m_linkedPC = 0x80000080;
+}
 
 void DynaRecCPU::recBREAK(uint32_t code) {
     flushRegs();  // For PCDRV support, we need to flush all registers before handling the exception.
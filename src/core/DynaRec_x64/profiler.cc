@@ -17,7 +17,7 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
-#include "profiler.h"
+#include "core/dynarec-profiler.h"
 
 #include <algorithm>
 #include <functional>
@@ -86,6 +86,18 @@ void DynaRecCPU::dumpProfileData() {
                             percentage, entry.timesInvoked);
     }
 
+    data += fmt::format("\nBlock links taken: {}\nBlock links missed: {}\n", m_profiler.linkHits(),
+                        m_profiler.linkMisses());
+
+    // Pages with the most self-modifying code or code overlays written over them
+    std::vector<std::pair<uint32_t, uint64_t>> pages(m_profiler.pageInvalidations().begin(),
+                                                     m_profiler.pageInvalidations().end());
+    std::sort(pages.begin(), pages.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    data += "\nRAM Page               Code Invalidations\n";
+    for (size_t i = 0; i < std::min<size_t>(100, pages.size()); i++) {
+        data += fmt::format("{:08X}               {}\n", pages[i].first, pages[i].second);
+    }
+
     std::ofstream out("DynarecProfileData.txt");
     out << data;
 
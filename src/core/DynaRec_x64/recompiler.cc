@@ -20,7 +20,15 @@
 #include "recompiler.h"
 
 #if defined(DYNAREC_X86_64)
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "core/debug.h"
+#include "core/guestcoverage.h"
+#include "core/pgxp_cpu.h"
+#include "support/sharedmem.h"
 
 bool DynaRecCPU::Init() {
     // Initialize recompiler memory
@@ -40,8 +48,11 @@ bool DynaRecCPU::Init() {
     m_ramBlocks = new DynarecCallback[m_ramSize / 4];
     m_biosBlocks = new DynarecCallback[biosSize / 4];
     m_dummyBlocks = new DynarecCallback[0x10000 / 4];  // Allocate one page worth of dummy blocks
+    m_blockHeat = new uint16_t[m_ramSize / 4]();
+    m_codeBitmap = new uint64_t[m_ramSize / 4 / 64]();
+    m_codePages = new std::vector<CodeRange>[m_ramSize / CODE_PAGE_SIZE];
 
-    gen.reset();
+    resetCodeRegions();
 
     for (int page = 0; page < 0x10000; page++) {  // Default all pages to dummy blocks
         m_recompilerLUT[page] = &m_dummyBlocks[0];
@@ -67,8 +78,16 @@ bool DynaRecCPU::Init() {
         PCSX::g_system->message("[Dynarec] Failed to allocate executable memory.\nTry disabling the Dynarec CPU.");
         return false;
     }
+    if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingLargePages>()) {
+        // The code buffer is static, so the most it can get is transparent huge pages.
+        const bool advised = PCSX::SharedMem::adviseLargePages(s_codeCache, allocSize);
+        PCSX::g_system->printf("[Dynarec] Code buffer is using %s\n",
+                               PCSX::SharedMem::describe(advised ? PCSX::SharedMem::Pages::Advised
+                                                                 : PCSX::SharedMem::Pages::Regular));
+    }
     emitDispatcher();  // Emit our assembly dispatcher
     uncompileAll();    // Mark all blocks as uncompiled
+    loadBlockHints();
 
     for (int i = 0; i < 0x10000 / 4; i++) {  // Mark all dummy blocks as invalid
         m_dummyBlocks[i] = m_invalidBlock;
@@ -85,14 +104,20 @@ bool DynaRecCPU::Init() {
     m_gprs[0].markConst(0);  // $zero is always zero
     m_currentDelayedLoad = 0;
     m_runtimeLoadDelay.active = false;
+    m_loadDelayStats = {};
     return true;
 }
 
 void DynaRecCPU::Shutdown() {
+    saveBlockHints();
     delete[] m_recompilerLUT;
     delete[] m_ramBlocks;
     delete[] m_biosBlocks;
     delete[] m_dummyBlocks;
+    delete[] m_blockHeat;
+    delete[] m_codeBitmap;
+    m_codeBitmap = nullptr;
+    delete[] m_codePages;
 
     if constexpr (ENABLE_SYMBOLS) {
         std::ofstream out("DynarecOutput.map");
@@ -130,14 +155,62 @@ void DynaRecCPU::signalShellReached(DynaRecCPU* that) {
     }
 }
 
+void DynaRecCPU::pgxpHookWrapper(DynaRecCPU* that, uint32_t code) { PGXP_DynarecHook(code, &that->m_regs); }
+
+void DynaRecCPU::idleLoopWrapper(DynaRecCPU* that, uint32_t start, uint32_t branchPC) {
+    if ((that->m_regs.pc == start) && PCSX::g_emulator->settings.get<PCSX::Emulator::SettingIdleSkipping>() &&
+        that->isIdleLoop(start, branchPC)) {
+        that->skipIdleLoop();
+    }
+}
+
+// Returns whether an execution breakpoint paused the emulation, in which case the block needs to be left before
+// running anything. Once resumed, the same block gets entered again, and mustn't break again straight away.
+bool DynaRecCPU::checkExecBreakpoint(DynaRecCPU* that, uint32_t pc) {
+    const bool resumed = that->m_resumedBreakpoint == pc;
+    that->m_resumedBreakpoint = std::nullopt;
+    if (resumed) return false;
+    if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+             .get<PCSX::Emulator::DebugSettings::Debug>()) {
+        return false;
+    }
+
+    PCSX::g_emulator->m_debug->checkExecBreakpoint(pc);
+    if (PCSX::g_system->running()) return false;
+    that->m_resumedBreakpoint = pc;
+    return true;
+}
+
+void DynaRecCPU::invalidateBreakpoint(uint32_t address, uint32_t width) {
+    constexpr int biosSize = 0x80000;
+    if ((address & 0x1fffffff) >= 0x1fc00000) {  // BIOS code isn't tracked, so drop all of it
+        for (auto i = 0; i < biosSize / 4; i++) {
+            m_biosBlocks[i] = m_uncompiledBlock;
+        }
+        return;
+    }
+    Clear(address & ~3, ((address & 3) + width + 3) / 4);
+}
+
 void DynaRecCPU::error() {
     PCSX::g_system->hardReset();
     PCSX::g_system->pause();
     PCSX::g_system->message("Unrecoverable error while running recompiler\nProgram counter: %08X\n", m_pc);
 }
 
+// A single store, when the guest coverage is running. Starting or stopping it throws away all of the compiled
+// code, so whether the store is there or not always matches.
+void DynaRecCPU::emitCoverageMark(uint32_t pc) {
+    uint8_t* entry = PCSX::g_emulator->m_guestCoverage->entry(pc);
+    if (!entry) return;
+    loadAddress(rax, entry);
+    gen.mov(Xbyak::util::byte[rax], 1);
+}
+
 void DynaRecCPU::uncompileAll() {
     constexpr int biosSize = 0x80000;
+    resetCodeTracking();
+    m_fullLoadDelayBlocks.clear();
     for (auto i = 0; i < m_ramSize / 4; i++) {  // Mark all RAM blocks as uncompiled
         m_ramBlocks[i] = m_uncompiledBlock;
     }
@@ -146,10 +219,165 @@ void DynaRecCPU::uncompileAll() {
     }
 }
 
-void DynaRecCPU::flushCache() {
-    gen.reset();       // Reset the emitter's code pointer and code size variables
-    emitDispatcher();  // Re-emit dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+void DynaRecCPU::resetCodeTracking() {
+    memset(m_codeBitmap, 0, m_ramSize / 4 / 8);
+    for (uint32_t page = 0; page < m_ramSize / CODE_PAGE_SIZE; page++) {
+        m_codePages[page].clear();
+    }
+    m_codeEntryPages.clear();
+}
+
+// Add the RAM range [start, end) to the code belonging to the block at "entry"
+void DynaRecCPU::registerCode(uint32_t entry, uint32_t start, uint32_t end) {
+    auto& pages = m_codeEntryPages[entry];
+    while (start < end) {
+        const uint32_t page = start >> CODE_PAGE_SHIFT;
+        const uint32_t pageEnd = std::min(end, (page + 1) << CODE_PAGE_SHIFT);
+        m_codePages[page].push_back({entry, start, pageEnd});
+        if (std::find(pages.begin(), pages.end(), page) == pages.end()) pages.push_back(page);
+        markCode(start, pageEnd);
+        start = pageEnd;
+    }
+}
+
+void DynaRecCPU::markCode(uint32_t start, uint32_t end) {
+    for (uint32_t word = start >> 2; word < (end + 3) >> 2; word++) {
+        m_codeBitmap[word / 64] |= 1ull << (word % 64);
+    }
+}
+
+bool DynaRecCPU::containsCode(uint32_t start, uint32_t end) {
+    for (uint32_t word = start >> 2; word < (end + 3) >> 2; word++) {
+        if (m_codeBitmap[word / 64] & (1ull << (word % 64))) return true;
+    }
+    return false;
+}
+
+// Mark every block with code in the RAM range [start, end) as uncompiled
+void DynaRecCPU::invalidateCode(uint32_t start, uint32_t end) {
+    if (start >= end) return;
+
+    std::vector<uint32_t> entries;
+    for (uint32_t page = start >> CODE_PAGE_SHIFT; page <= (end - 1) >> CODE_PAGE_SHIFT; page++) {
+        const auto& ranges = m_codePages[page];
+        const uint32_t writeStart = std::max(start, page << CODE_PAGE_SHIFT);
+        const uint32_t writeEnd = std::min(end, (page + 1) << CODE_PAGE_SHIFT);
+        if (ranges.empty() || !containsCode(writeStart, writeEnd)) continue;
+
+        for (const auto& range : ranges) {
+            if (range.start < writeEnd && range.end > writeStart) entries.push_back(range.entry);
+        }
+
+        if constexpr (ENABLE_PROFILER) {
+            m_profiler.pageInvalidations()[page << CODE_PAGE_SHIFT]++;
+        }
+    }
+    if (entries.empty()) return;
+
+    // The blocks may have code in other pages than the written ones, which have to forget about them too
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    std::vector<uint32_t> pages;
+    for (const auto entry : entries) {
+        m_ramBlocks[entry >> 2] = m_uncompiledBlock;
+        auto it = m_codeEntryPages.find(entry);
+        if (it == m_codeEntryPages.end()) continue;
+        pages.insert(pages.end(), it->second.begin(), it->second.end());
+        m_codeEntryPages.erase(it);
+    }
+    std::sort(pages.begin(), pages.end());
+    pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+    for (const auto page : pages) {
+        std::erase_if(m_codePages[page], [&entries](const CodeRange& range) {
+            return std::binary_search(entries.begin(), entries.end(), range.entry);
+        });
+        rebuildCodeBitmap(page);
+    }
+}
+
+// Rebuild a page's part of the bitmap from the code that's left in it
+void DynaRecCPU::rebuildCodeBitmap(uint32_t page) {
+    constexpr uint32_t bitmapWordsPerPage = CODE_PAGE_SIZE / 4 / 64;
+    memset(&m_codeBitmap[page * bitmapWordsPerPage], 0, bitmapWordsPerPage * sizeof(uint64_t));
+    for (const auto& range : m_codePages[page]) {
+        markCode(range.start, range.end);
+    }
+}
+
+void DynaRecCPU::resetCodeRegions() {
+    gen.reset();  // Reset the emitter's code pointer and code size variables
+    size_t start = 0;
+    const auto region = [&start](const char* name, size_t size) {
+        const CodeRegionState state = {name, start, start + size, start, 0, 0, 0};
+        start += size;
+        return state;
+    };
+    m_codeRegions = {region("Stubs", STUBS_REGION_SIZE), region("BIOS", BIOS_REGION_SIZE),
+                     region("Hot", HOT_REGION_SIZE),
+                     region("Cold", codeCacheSize - STUBS_REGION_SIZE - BIOS_REGION_SIZE - HOT_REGION_SIZE)};
+    m_currentRegion = CodeRegion::Stubs;  // For the dispatcher, which gets emitted next
+    m_fallthrough = false;
+}
+
+// Puts the emitter at the cursor of another region, flushing that one first if it's running out of room
+void DynaRecCPU::switchCodeRegion(CodeRegion region) {
+    auto& current = codeRegion(m_currentRegion);
+    current.bytes += gen.getSize() - current.cursor;
+    current.cursor = gen.getSize();
+    m_currentRegion = region;
+
+    auto& next = codeRegion(region);
+    if (next.end - next.cursor < REGION_MARGIN) {
+        flushCodeRegion(region);
+    }
+    gen.setSize(next.cursor);
+}
+
+// Throws away the blocks compiled into a region. Links into them from the other regions check where their target
+// lives before jumping there, so they go back through the dispatcher on their own.
+void DynaRecCPU::flushCodeRegion(CodeRegion which) {
+    constexpr int biosSize = 0x80000;
+    auto& region = codeRegion(which);
+    const uintptr_t start = (uintptr_t)gen.getCode() + region.start;
+    const uintptr_t end = (uintptr_t)gen.getCode() + region.end;
+    const auto flush = [this, start, end](DynarecCallback& block) {
+        if ((uintptr_t)block >= start && (uintptr_t)block < end) block = m_uncompiledBlock;
+    };
+    for (auto i = 0; i < m_ramSize / 4; i++) {
+        flush(m_ramBlocks[i]);
+    }
+    for (auto i = 0; i < biosSize / 4; i++) {
+        flush(m_biosBlocks[i]);
+    }
+
+    // Forget about the code of the blocks which are gone, so that writes to it don't invalidate anything
+    for (uint32_t page = 0; page < m_ramSize / CODE_PAGE_SIZE; page++) {
+        const auto removed = std::erase_if(m_codePages[page], [this](const CodeRange& range) {
+            return m_ramBlocks[range.entry >> 2] == m_uncompiledBlock;
+        });
+        if (removed != 0) rebuildCodeBitmap(page);
+    }
+    std::erase_if(m_codeEntryPages,
+                  [this](const auto& item) { return m_ramBlocks[item.first >> 2] == m_uncompiledBlock; });
+
+    // The blocks the full load delay variants are for might get compiled again at the same address
+    m_fullLoadDelayBlocks.clear();
+
+    region.cursor = region.start;
+    region.flushes++;
+}
+
+std::vector<PCSX::R3000Acpu::CodeBufferRegion> DynaRecCPU::getCodeBufferRegions() {
+    std::vector<CodeBufferRegion> ret;
+    for (size_t i = 0; i < m_codeRegions.size(); i++) {
+        const auto& region = m_codeRegions[i];
+        // The cursor of the region being written into only gets updated when switching away from it
+        const size_t cursor = (i == size_t(m_currentRegion)) ? gen.getSize() : region.cursor;
+        ret.push_back({region.name, region.start, cursor - region.start, region.end - region.start, region.compiles,
+                       region.bytes + (cursor - region.cursor), region.flushes});
+    }
+    return ret;
 }
 
 void DynaRecCPU::emitBlockLookup() {
@@ -234,6 +462,14 @@ void DynaRecCPU::emitDispatcher() {
     gen.callFunc(recRecompileWrapper);  // Call recompilation function. Returns pointer to emitted code
     gen.jmp(rax);
 
+    // Code for when a block got hot enough to be recompiled as a trace
+    gen.align(16);
+    m_promoteBlock = gen.getCurr<DynarecCallback>();
+
+    loadThisPointer(arg1.cvt64());
+    gen.callFunc(recPromoteWrapper);  // Call trace compilation function. Returns pointer to emitted code
+    gen.jmp(rax);
+
     // Code for when the block we've jumped to is invalid. Throws an error and exits
     gen.align(16);
     m_invalidBlock = gen.getCurr<DynarecCallback>();
@@ -302,19 +538,35 @@ void DynaRecCPU::emitDispatcher() {
         gen.dq((uintptr_t)m_uncompiledBlock);
     }
 
-    // Code to recompile the current block with full load delay emulation if necessary
+    // Code to enter the current block through its variant with full load delay emulation
     gen.align(16);
     m_needFullLoadDelays = gen.getCurr<DynarecCallback>();
     loadThisPointer(arg1.cvt64());
-    gen.mov(arg2, 1);                   // Fully emulate load delays
-    gen.callFunc(recRecompileWrapper);  // Call recompilation function. Returns pointer to emitted code
+    gen.callFunc(recFullLoadDelaysWrapper);  // Returns pointer to the variant, compiling it if needed
     gen.jmp(rax);
 }
 
 // Compile a block, write address of compiled code to *callback
 // Returns the address of the compiled block
-DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align) {
+// When "trace" is set, the block keeps going past branches with a known likely successor, up to
+// MAX_TRACE_SIZE instructions. Conditional branches get a side exit for the unlikely path, which
+// flushes the register cache as it was at that point, so guest registers can stay in host registers
+// along the whole trace.
+// With "fullLoadDelayEmulation", this compiles the variant of the block that getFullLoadDelayBlock keeps on the
+// side, and the block itself is left alone.
+DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align, bool trace) {
+    ZoneScoped;
+    if (!trace && !fullLoadDelayEmulation && !m_blockHints.empty()) {
+        if (const auto hint = findBlockHint(pc & ~3)) {  // Compile the block the way it ended up last run
+            trace = (hint.value() & HintTrace) != 0;
+        }
+    }
+    const bool fallthrough = std::exchange(m_fallthrough, false);
     m_stopCompiling = false;
+    m_compilingTrace = trace;
+    m_conditionalTargets = std::nullopt;
+    m_syscall = std::nullopt;
+    m_loadDelayCrossesBlock = false;
     m_inDelaySlot = false;
     m_nextIsDelaySlot = false;
     m_pcWrittenBack = false;
@@ -330,17 +582,23 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     if (!isPcValid(m_pc)) return m_invalidBlock;
 
     const auto startingPC = m_pc;
-    unsigned count = 0;                                 // How many instructions have we compiled?
-    DynarecCallback* callback = getBlockPointer(m_pc);  // Pointer to where we'll store the addr of the emitted code
+    unsigned count = 0;  // How many instructions have we compiled?
+    DynarecCallback variant = nullptr;
+    // Pointer to where we'll store the addr of the emitted code
+    DynarecCallback* callback = m_fullLoadDelayEmulation ? &variant : getBlockPointer(m_pc);
+
+    // Traces only come out of blocks hot enough to get promoted, and the BIOS keeps on running the same code, so
+    // they both get a region of their own. A block falling through from the one being linked stays right behind it.
+    if (!fallthrough) {
+        const bool bios = (m_pc & 0x1fffffff) >= 0x1fc00000;
+        switchCodeRegion(trace ? CodeRegion::Hot : (bios ? CodeRegion::Bios : CodeRegion::Cold));
+    }
+    codeRegion(m_currentRegion).compiles++;
 
     if (align) {
         gen.align(16);  // Align next block
     }
 
-    if (gen.getSize() > codeCacheSize) {  // Flush JIT cache if we've gone above the acceptable size
-        flushCache();
-    }
-
     if constexpr (ENABLE_SYMBOLS) {
         m_symbols += fmt::format("{} recompile_{:08X}\n", gen.getCurr<void*>(), m_pc);
         // This is unnecessary, but it acts as a hint to the decompiler about the context pointer's value
@@ -356,22 +614,66 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
 
     if (!m_fullLoadDelayEmulation) {
         const auto isActiveOffset = (uintptr_t)&m_runtimeLoadDelay.active - (uintptr_t)this;
-
-        // Check if there's a pending load at the start of the block. If so we need to
-        // Recompile the block with full load delay support
+        const auto indexOffset = (uintptr_t)&m_runtimeLoadDelay.index - (uintptr_t)this;
+
+        // The kernel call vectors, the shell and execution breakpoints look at the registers before the first
+        // instruction runs, so they need the load to still be pending.
+        const uint32_t physical = m_pc & 0x1fffffff;
+        const bool hooked = physical == 0xa0 || physical == 0xb0 || physical == 0xc0 || m_pc == 0x80030000 ||
+                            PCSX::g_emulator->m_debug->hasExecBreakpoint(m_pc);
+        const uint32_t conflicts = hooked ? 0xffffffff : getLoadDelayConflicts(m_pc);
+
+        // Check if there's a pending load at the start of the block. If the first instruction doesn't care about
+        // its register, the load can land right away. Otherwise, we need the variant of the block with full load
+        // delay support.
+        Label noDelayedLoad;
         gen.cmp(Xbyak::util::byte[contextPointer + isActiveOffset], 0);
-        gen.jne((void*)m_needFullLoadDelays);
+        gen.je(noDelayedLoad, CodeGenerator::T_NEAR);
+        if (conflicts == 0xffffffff) {
+            gen.jmp((void*)m_needFullLoadDelays);
+        } else {
+            if (conflicts != 0) {
+                gen.mov(eax, dword[contextPointer + indexOffset]);
+                gen.mov(edx, conflicts);
+                gen.bt(edx, eax);
+                gen.jc((void*)m_needFullLoadDelays);
+            }
+            loadAddress(rax, &m_loadDelayStats.resolvedAtEntry);
+            gen.inc(qword[rax]);
+            gen.call((void*)m_loadDelayHandler);
+        }
+        gen.L(noDelayedLoad);
+
+        // Count down entries into RAM blocks, and promote the block to a trace once it's hot
+        if (!trace && (m_pc & 0x1fffffff) < m_ramSize) {
+            uint16_t* heat = &m_blockHeat[(m_pc & 0x1fffffff) >> 2];
+            *heat = TRACE_HEAT_THRESHOLD;
+            loadAddress(rax, heat);
+            gen.sub(word[rax], 1);
+            gen.jz((void*)m_promoteBlock, CodeGenerator::T_NEAR);
+        }
+    }
+    auto& coverage = PCSX::g_emulator->m_guestCoverage;
+    emitCoverageMark(startingPC);
+    auto& debug = PCSX::g_emulator->m_debug;
+    if (debug->hasExecBreakpoint(startingPC)) {
+        handleExecBreakpoint(startingPC);
     }
     handleKernelCall();  // Check if this is a kernel call vector, emit some extra code in that case.
 
-    const auto shouldContinue = [this, &count]() {
+    const int maxBlockSize = trace ? MAX_TRACE_SIZE : MAX_BLOCK_SIZE;
+    const auto shouldContinue = [this, &count, &debug, maxBlockSize]() {
         if (m_nextIsDelaySlot) {
             return true;
         }
         if (m_stopCompiling) {
             return false;
         }
-        if (count >= MAX_BLOCK_SIZE && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
+        // End the block before a breakpoint, so that the next one checks it, unless a load is still in flight
+        if (!m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active && debug->hasExecBreakpoint(m_pc)) {
+            return false;
+        }
+        if (count >= maxBlockSize && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
             return false;
         }
         return true;
@@ -402,6 +704,18 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         uint32_t code = m_regs.code = *ptr;
         m_pc += 4;  // Increment recompiler PC
         count++;    // Increment instruction count
+        const bool analyzed = m_livenessIndex < m_livenessCount;
+        m_liveRegs = analyzed ? m_liveness[m_livenessIndex] : 0xffffffff;
+        const bool pgxpUnused = analyzed && m_pgxpUnused[m_livenessIndex];
+        m_livenessIndex++;
+
+        // The hook looks at the guest registers in memory, as they are before the instruction runs
+        if (PGXP_DynarecHasHook(m_pgxpMode, code) && !pgxpUnused) {
+            flushRegs();
+            loadThisPointer(arg1.cvt64());
+            gen.mov(arg2, code);
+            call(pgxpHookWrapper);
+        }
 
         const auto func = m_recBSC[code >> 26];  // Look up the opcode in our decoding LUT
         (*this.*func)(code);                     // Jump into the handler to recompile it
@@ -422,6 +736,7 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         gen.L(noDelayedLoad);
     };
 
+    analyzeLiveness(m_pc, maxBlockSize);
     // For the first instruction in the block: Check if there's a pending load as well
     if (!compileInstruction()) {
         return m_invalidBlock;
@@ -430,11 +745,87 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     processDelayedLoad();
     m_firstInstruction = false;
 
-    while (shouldContinue()) {
-        if (!compileInstruction()) {
-            return m_invalidBlock;
+    struct TraceExit {
+        Label label;
+        Register gprs[32];
+        std::array<HostRegister, ALLOCATEABLE_REG_COUNT> hostRegs;
+        unsigned int allocatedRegisters;
+        unsigned count;
+    };
+    TraceExit exits[MAX_TRACE_EXITS];
+    unsigned exitCount = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> codeRanges;  // Guest code the block was compiled from, end exclusive
+    uint32_t segmentStart = startingPC;
+    const auto isRamPc = [this](uint32_t pc) { return (pc & 0x1fffffff) < m_ramSize; };
+
+    // Called when the block would otherwise end. Returns whether we carried on into the likely successor
+    const auto extendTrace = [&, this]() -> bool {
+        if (!m_compilingTrace || m_loadDelayCrossesBlock || count >= MAX_TRACE_SIZE) return false;
+        if (m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active) return false;
+
+        uint32_t next;
+        if (m_conditionalTargets) {
+            if (exitCount >= MAX_TRACE_EXITS) return false;
+            const auto [taken, notTaken] = m_conditionalTargets.value();
+            next = (taken < notTaken) ? taken : notTaken;  // Backward branches are loops, assume those get taken
+        } else if (m_linkedPC) {
+            next = m_linkedPC.value() & ~3;
+        } else {
+            return false;
+        }
+
+        // Blocks starting at these addresses need the entry code emitted by handleKernelCall
+        const uint32_t physical = next & 0x1fffffff;
+        const bool isKernelVector = physical == 0xa0 || physical == 0xb0 || physical == 0xc0;
+        if (next == startingPC || next == 0x80030000 || isKernelVector || !isPcValid(next)) return false;
+        if (debug->hasExecBreakpoint(next)) return false;
+        if (isRamPc(next) != isRamPc(startingPC)) return false;  // Keep traces within RAM or within the BIOS
+
+        if (m_conditionalTargets) {
+            auto& exit = exits[exitCount++];
+            std::copy(std::begin(m_gprs), std::end(m_gprs), std::begin(exit.gprs));
+            exit.hostRegs = m_hostRegs;
+            exit.allocatedRegisters = m_allocatedRegisters;
+            exit.count = count;
+            gen.cmp(dword[contextPointer + PC_OFFSET], next);
+            gen.jne(exit.label, CodeGenerator::T_NEAR);
+        }
+
+        codeRanges.emplace_back(segmentStart, m_pc);
+        segmentStart = next;
+        m_pc = next;
+        emitCoverageMark(next);  // Past the side exit, so only when the trace carries on
+        analyzeLiveness(m_pc, MAX_TRACE_SIZE - count);
+        m_stopCompiling = false;
+        m_pcWrittenBack = false;
+        m_linkedPC = std::nullopt;
+        m_conditionalTargets = std::nullopt;
+        return true;
+    };
+
+    do {
+        while (shouldContinue()) {
+            if (!compileInstruction()) {
+                return m_invalidBlock;
+            }
+            processDelayedLoad();
+        }
+    } while (extendTrace());
+    m_compilingTrace = false;
+    m_liveRegs = 0xffffffff;  // Everything has to be written back when leaving the block
+    codeRanges.emplace_back(segmentStart, m_pc);
+    for (const auto [start, end] : codeRanges) coverage->setLength(start, (end - start) / 4);
+
+    if (trace) {
+        recordBlockHint(startingPC, codeRanges[0].second - codeRanges[0].first, HintTrace);
+    }
+
+    if (isRamPc(startingPC)) {  // Track which RAM the block came from, so writes to it can invalidate the block
+        const uint32_t entry = startingPC & 0x1fffffff;
+        for (const auto [start, end] : codeRanges) {
+            const uint32_t physicalStart = start & 0x1fffffff;
+            registerCode(entry, physicalStart, std::min(physicalStart + (end - start), m_ramSize));
         }
-        processDelayedLoad();
     }
 
     flushRegs();
@@ -451,6 +842,43 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     }
 
     gen.add(qword[contextPointer + CYCLE_OFFSET], count * PCSX::Emulator::BIAS);  // Add block cycles;
+
+    // A block branching back to its own start might be an idle loop. Whether the branch got taken, and what
+    // the loop loads from, are only known at runtime.
+    const bool loopsBack = (m_linkedPC && m_linkedPC.value() == startingPC) ||
+                           (m_conditionalTargets && m_conditionalTargets.value().first == startingPC);
+    if (loopsBack && exitCount == 0 && codeRanges.size() == 1 && isIdleLoop(startingPC, m_pc - 8, false)) {
+        loadThisPointer(arg1.cvt64());
+        gen.mov(arg2, startingPC);
+        gen.mov(arg3, m_pc - 8);
+        call(idleLoopWrapper);
+    }
+
+    if (m_syscall) {
+        emitSyscall();
+    }
+
+    // Side exits of the trace. Each one writes back the register cache the way it was at its branch.
+    // The PC has already been written by the branch itself.
+    if (exitCount != 0) {
+        Label mainPath;
+        gen.jmp(mainPath, CodeGenerator::T_NEAR);
+        for (unsigned i = 0; i < exitCount; i++) {
+            auto& exit = exits[i];
+            gen.L(exit.label);
+            std::copy(std::begin(exit.gprs), std::end(exit.gprs), std::begin(m_gprs));
+            m_hostRegs = exit.hostRegs;
+            m_allocatedRegisters = exit.allocatedRegisters;
+            flushRegs();
+            if constexpr (ENABLE_PROFILER) {
+                endProfiling();
+            }
+            gen.add(qword[contextPointer + CYCLE_OFFSET], exit.count * PCSX::Emulator::BIAS);
+            gen.jmp((void*)m_returnFromBlock);
+        }
+        gen.L(mainPath);
+    }
+
     if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
         handleLinking();
     } else {
@@ -468,7 +896,8 @@ void DynaRecCPU::recSpecial(uint32_t code) {
 }
 
 // Checks if the block being compiled is one of the kernel call vectors
-// If so, emit a call to "InterceptBIOS", which handles the kernel call debugger features
+// If so, emit a call to "InterceptBIOS", which handles the kernel call debugger features, and leave the block if
+// the call got emulated natively, as the pc is then already back to $ra
 // Also handles fast booting by intercepting the shell reached signal and setting pc to $ra if fastboot is on
 void DynaRecCPU::handleKernelCall() {
     if (m_pc == 0x80030000) {
@@ -482,21 +911,30 @@ void DynaRecCPU::handleKernelCall() {
         return;  // Mask out the segment, return if not a kernel call vector
 
     if (pc == 0xA0 || pc == 0xB0 || pc == 0xC0) {
+        Xbyak::Label notEmulated;
         gen.mov(arg2, m_pc);
         emitMemberFunctionCall(&PCSX::R3000Acpu::InterceptBIOS<false>, this);
+        gen.test(al, al);
+        gen.jz(notEmulated);
+        if constexpr (ENABLE_PROFILER) {
+            endProfiling();
+        }
+        gen.jmp((void*)m_returnFromBlock);
+        gen.L(notEmulated);
     }
 }
 
 // Emits a jump to the dispatcher if there's no block to link to.
 // Otherwise, handle linking blocks
 void DynaRecCPU::handleLinking() {
-    // Don't link unless the next PC is valid, and there's over 1MB of free space in the code cache
-    if (isPcValid(m_linkedPC.value()) && gen.getRemainingSize() > 0x100000) {
+    // Don't link unless the next PC is valid, and there's enough room left in the region for it to fall through
+    if (isPcValid(m_linkedPC.value()) && regionRemaining() > REGION_MARGIN) {
         const auto nextPC = m_linkedPC.value();
         const auto nextBlockPointer = getBlockPointer(nextPC);
         const auto nextBlockOffset = (size_t)nextBlockPointer - (size_t)this;
 
         if (*nextBlockPointer == m_uncompiledBlock) {  // If the next block hasn't been compiled yet
+            Label miss;
             // Check that the block hasn't been invalidated/moved
             // The value will be patched later. Since all code is within the same 32MB segment,
             // We can get away with only checking the low 32 bits of the block pointer
@@ -508,26 +946,101 @@ void DynaRecCPU::handleLinking() {
             }
 
             const auto pointer = gen.getCurr<uint8_t*>();
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            recompile(nextPC, false);           // Fallthrough to next block
+            if constexpr (ENABLE_PROFILER) {
+                gen.jne(miss, CodeGenerator::T_NEAR);
+                countLink(m_profiler.linkHits());
+            } else {
+                gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
+            }
+            m_fallthrough = true;
+            recompile(nextPC, false);  // Fallthrough to next block
 
             *(uint32_t*)(pointer - 4) = (uint32_t)(uintptr_t)*nextBlockPointer;  // Patch comparison value
+
+            if constexpr (ENABLE_PROFILER) {
+                gen.L(miss);
+                countLink(m_profiler.linkMisses());
+                gen.jmp((void*)m_returnFromBlock);
+            }
         } else {  // If it has already been compiled, link by jumping to the compiled code
+            Label relink;
+            // Both the comparison value and the jump displacement are patched in place by relinkBlock,
+            // so they need to keep their 32-bit encodings regardless of the initial target.
             if (Xbyak::inner::IsInInt32(nextBlockOffset)) {
-                gen.cmp(dword[contextPointer + nextBlockOffset], (uint32_t)(uintptr_t)*nextBlockPointer);
+                gen.cmp(dword[contextPointer + nextBlockOffset], 0xcccccccc);
             } else {
                 loadAddress(rax, nextBlockPointer);
-                gen.cmp(dword[rax], (uint32_t)(uintptr_t)*nextBlockPointer);
+                gen.cmp(dword[rax], 0xcccccccc);
             }
-
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            gen.jmp((void*)*nextBlockPointer);  // Jump to linked block otherwise
+            const auto comparison = gen.getCurr<uint8_t*>();
+            gen.jne(relink, CodeGenerator::T_NEAR);  // Try to relink if the block addr changed
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkHits());
+            }
+            gen.jmp((void*)*nextBlockPointer, CodeGenerator::T_NEAR);  // Jump to linked block otherwise
+            const auto jump = gen.getCurr<uint8_t*>();
+            *(uint32_t*)(comparison - 4) = (uint32_t)(uintptr_t)*nextBlockPointer;
+
+            // The successor got invalidated. Point this link at wherever it lives now, if it has been
+            // recompiled already, then go through the dispatcher this one time.
+            gen.L(relink);
+            if constexpr (ENABLE_PROFILER) {
+                countLink(m_profiler.linkMisses());
+            }
+            gen.mov(arg2.cvt64(), (uintptr_t)comparison);
+            gen.mov(arg3.cvt64(), (uintptr_t)jump);
+            gen.mov(arg4, nextPC);
+            loadThisPointer(arg1.cvt64());
+            gen.callFunc(recRelinkWrapper);
+            gen.jmp((void*)m_returnFromBlock);
         }
     } else {  // Can't link, so return to dispatcher
         gen.jmp((void*)m_returnFromBlock);
     }
 }
 
+// Entered from a block whose first instruction conflicts with a load left pending by the previous block. Returns
+// the variant of that block emulating load delays, compiling it the first time around.
+DynarecCallback DynaRecCPU::getFullLoadDelayBlock(uint32_t pc) {
+    pc &= ~3;
+    const auto block = *getBlockPointer(pc);
+    m_loadDelayStats.fullEntries++;
+    const auto variant = m_fullLoadDelayBlocks.find(pc);
+    if (variant != m_fullLoadDelayBlocks.end() && variant->second.block == block) return variant->second.code;
+
+    m_loadDelayStats.fullCompiles++;
+    const auto code = recompile(pc, true);
+    // Compiling might have flushed the region of the block, which then needs compiling again anyway
+    if (code != m_invalidBlock && *getBlockPointer(pc) == block) m_fullLoadDelayBlocks[pc] = {block, code};
+    return code;
+}
+
+// Called by a link site whose successor block moved. "comparison" and "jump" point right past
+// the imm32 of the link's cmp and the rel32 of its jmp respectively.
+void DynaRecCPU::relinkBlock(uint8_t* comparison, uint8_t* jump, uint32_t pc) {
+    const auto target = *getBlockPointer(pc);
+    if (target == m_uncompiledBlock || target == m_invalidBlock) return;  // Will try again on the next miss
+
+    *(uint32_t*)(comparison - 4) = (uint32_t)(uintptr_t)target;
+    *(int32_t*)(jump - 4) = (int32_t)((intptr_t)target - (intptr_t)jump);
+}
+
+// Emits a check of the execution breakpoints at the start of a block, bailing out of it if one paused
+void DynaRecCPU::handleExecBreakpoint(uint32_t pc) {
+    Xbyak::Label noBreak;
+
+    loadThisPointer(arg1.cvt64());
+    gen.mov(arg2, pc);
+    call(checkExecBreakpoint);
+    gen.test(al, al);
+    gen.jz(noBreak);
+    if constexpr (ENABLE_PROFILER) {
+        endProfiling();
+    }
+    gen.jmp((void*)m_returnFromBlock);
+    gen.L(noBreak);
+}
+
 void DynaRecCPU::handleShellReached() {
     Xbyak::Label alreadyReached;
 
@@ -546,7 +1059,10 @@ void DynaRecCPU::handleShellReached() {
 // If it does, we need to emulate the load delay
 DynaRecCPU::LoadDelayDependencyType DynaRecCPU::getLoadDelayDependencyType(int index) {
     // Always emulate load delays when there's a load in a branch delay slot
-    if (m_stopCompiling && index != 0) return LoadDelayDependencyType::DependencyAcrossBlocks;
+    if (m_stopCompiling && index != 0) {
+        m_loadDelayCrossesBlock = true;
+        return LoadDelayDependencyType::DependencyAcrossBlocks;
+    }
 
     if (index == 0) {  // Loads to $zero go to the void, so don't bother emulating it as a delayed load
         return LoadDelayDependencyType::NoDependency;
@@ -23,17 +23,21 @@
 #if defined(DYNAREC_X86_64)
 #include <array>
 #include <cassert>
+#include <filesystem>
 #include <fstream>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "core/dynarec-profiler.h"
 #include "core/gpu.h"
 #include "emitter.h"
 #include "fmt/format.h"
-#include "profiler.h"
 #include "regAllocation.h"
 #include "spu/interface.h"
+#include "support/flathashtable.h"
 #include "tracy/Tracy.hpp"
 
 #define HOST_REG_CACHE_OFFSET(x) ((uintptr_t) & m_hostRegisterCache[(x)] - (uintptr_t)this)
@@ -104,6 +108,48 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback* m_biosBlocks;  // Pointers to compiled BIOS blocks
     DynarecCallback* m_dummyBlocks;  // This is where invalid pages will point
 
+    // Self-modifying code tracking. The bitmap has a bit per RAM word, set if a compiled block was compiled from it.
+    // Each 4KB page of RAM also keeps the ranges of code it holds and which block they belong to, so that writes
+    // only invalidate the blocks they actually overlap. Blocks also remember the pages they have code in, since
+    // they can span several of them, all of which have to let go of an invalidated block.
+    struct CodeRange {
+        uint32_t entry;  // RAM offset of the start of the block this code belongs to
+        uint32_t start;  // RAM offsets of the code, end is exclusive. Never crosses a page boundary
+        uint32_t end;
+    };
+    static constexpr uint32_t CODE_PAGE_SHIFT = 12;
+    static constexpr uint32_t CODE_PAGE_SIZE = 1 << CODE_PAGE_SHIFT;
+    uint64_t* m_codeBitmap = nullptr;
+    std::vector<CodeRange>* m_codePages;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_codeEntryPages;
+
+    void registerCode(uint32_t entry, uint32_t start, uint32_t end);
+    void markCode(uint32_t start, uint32_t end);
+    bool containsCode(uint32_t start, uint32_t end);
+    void invalidateCode(uint32_t start, uint32_t end);
+    void rebuildCodeBitmap(uint32_t page);
+    void resetCodeTracking();
+
+    // Optional hints persisted across runs, for blocks that got promoted to traces or needed full load delay
+    // emulation. They are keyed by start PC and a hash of the guest code, and let the next run compile those blocks
+    // the right way straight away. A stale hint only costs performance, never correctness.
+    struct BlockHint {
+        uint64_t hash;
+        uint32_t size;  // Bytes of guest code covered by the hash
+        uint32_t flags;
+    };
+    // HintFullLoadDelay is no longer recorded, as blocks keep their full load delay variant on the side now, and
+    // is ignored in the files written before that.
+    enum BlockHintFlags : uint32_t { HintTrace = 1, HintFullLoadDelay = 2 };
+    PCSX::FlatHashTable<uint32_t, BlockHint> m_blockHints;
+    std::filesystem::path m_blockHintsPath;
+
+    uint64_t hashGuestCode(uint32_t pc, uint32_t size);
+    std::optional<uint32_t> findBlockHint(uint32_t pc);
+    void recordBlockHint(uint32_t pc, uint32_t size, uint32_t flags);
+    void loadBlockHints();
+    void saveBlockHints();
+
     // Functions written in raw assembly
     DynarecCallback m_dispatcher;       // Pointer to our assembly dispatcher
     DynarecCallback m_returnFromBlock;  // Pointer to the code that will be executed when returning from a block
@@ -111,16 +157,47 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback m_invalidBlock;     // Pointer to the code that will be executed the PC is invalid
     DynarecCallback m_invalidateBlocks;  // Pointer to the code that will invalidate all RAM code blocks
     DynarecCallback m_loadDelayHandler;  // Pointer to the code that will handle load delays at the start of a block
-    // Pointer to the code that will be executed when a block needs to be recompiled with full load delay support
+    // Pointer to the code that will be executed when a block needs its variant with full load delay support
     DynarecCallback m_needFullLoadDelays;
+    DynarecCallback m_promoteBlock;  // Pointer to the code that recompiles a hot block as a trace
 
     Emitter gen;
     uint32_t m_pc;  // Recompiler PC
 
+    // The code buffer is split in regions, which fill up and get flushed on their own, so that running out of room
+    // only throws away the blocks of one of them: the stubs emitted along the dispatcher, the BIOS, the traces hot
+    // blocks got promoted to, and everything else, which is where overlays churn. The emitter only writes into one
+    // region at a time; the cursors of the others are kept here.
+    enum class CodeRegion { Stubs, Bios, Hot, Cold, Count };
+    struct CodeRegionState {
+        const char* name;
+        size_t start;
+        size_t end;
+        size_t cursor;
+        uint64_t compiles;
+        uint64_t bytes;
+        uint64_t flushes;
+    };
+    static constexpr size_t STUBS_REGION_SIZE = 64 * 1024;
+    static constexpr size_t BIOS_REGION_SIZE = 3 * 1024 * 1024;
+    static constexpr size_t HOT_REGION_SIZE = 8 * 1024 * 1024;
+    // A block, and the ones falling through from it, need this much room left in their region to get compiled
+    static constexpr size_t REGION_MARGIN = 256 * 1024;
+    std::array<CodeRegionState, size_t(CodeRegion::Count)> m_codeRegions;
+    CodeRegion m_currentRegion = CodeRegion::Stubs;
+    bool m_fallthrough = false;  // Set while linking, as the next block has to be emitted right behind this one
+
+    CodeRegionState& codeRegion(CodeRegion region) { return m_codeRegions[size_t(region)]; }
+    size_t regionRemaining() { return codeRegion(m_currentRegion).end - gen.getSize(); }
+    void resetCodeRegions();
+    void switchCodeRegion(CodeRegion region);
+    void flushCodeRegion(CodeRegion region);
+
     bool m_stopCompiling;  // Should we stop compiling code?
     bool m_pcWrittenBack;  // Has the PC been written back already by a jump?
     bool m_firstInstruction;
     bool m_fullLoadDelayEmulation;
+    uint32_t m_pgxpMode = 0;  // PGXP mode the compiled code calls the hooks of. 0 when PGXP is off
     uint32_t m_ramSize;  // RAM is 2MB on retail units, 8MB on some DTL units (Can be toggled in GUI)
 
     // Used to hold info when we've got a load delay between the end of a block and the start of another
@@ -131,8 +208,30 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         uint32_t value;
     } m_runtimeLoadDelay;
 
+    // Blocks only get compiled with full load delay emulation for the entries where a load left pending by the
+    // previous block conflicts with their first instruction, see getFullLoadDelayBlock. That variant is kept here,
+    // by PC, along with the block it's for, and dropped when the block changes.
+    struct FullLoadDelayBlock {
+        DynarecCallback block;
+        DynarecCallback code;
+    };
+    PCSX::FlatHashTable<uint32_t, FullLoadDelayBlock> m_fullLoadDelayBlocks;
+    LoadDelayStats m_loadDelayStats;
+    DynarecCallback getFullLoadDelayBlock(uint32_t pc);
+
     const int MAX_BLOCK_SIZE = 50;
 
+    // Hot RAM blocks get recompiled as traces spanning several guest blocks, see recompile()
+    static constexpr int MAX_TRACE_SIZE = 200;
+    static constexpr int MAX_TRACE_EXITS = 8;
+    static constexpr uint16_t TRACE_HEAT_THRESHOLD = 1000;  // Block entries before promotion to a trace
+    uint16_t* m_blockHeat;  // Per-entrypoint countdown, indexed like m_ramBlocks
+    bool m_compilingTrace = false;
+    bool m_loadDelayCrossesBlock = false;  // A branch delay slot left a load pending for the next block
+    std::optional<std::pair<uint32_t, uint32_t>> m_conditionalTargets;  // {taken, not taken} of the last branch
+    // {pc, in delay slot} of a syscall ending the block. Its exception is raised in the epilogue, see emitSyscall()
+    std::optional<std::pair<uint32_t, bool>> m_syscall;
+
     enum class RegState { Unknown, Constant };
     enum class LoadingMode { DoNotLoad, Load };
     enum class LoadDelayDependencyType { NoDependency, DependencyInsideBlock, DependencyAcrossBlocks };
@@ -176,6 +275,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     Register m_gprs[32];
     std::array<HostRegister, ALLOCATEABLE_REG_COUNT> m_hostRegs;
     std::optional<uint32_t> m_linkedPC = std::nullopt;
+    // The block at this PC got left by its execution breakpoint pausing, and gets to run once without checking
+    std::optional<uint32_t> m_resumedBreakpoint = std::nullopt;
 
     template <LoadingMode mode = LoadingMode::Load>
     void reserveReg(int index);
@@ -194,15 +295,32 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void spillRegisterCache();
     unsigned int m_allocatedRegisters = 0;  // how many registers have been allocated in this block?
 
+    // Guest register liveness for the instructions ahead, filled in by analyzeLiveness before compiling.
+    // Bit n of an entry is set if the value of $n might still be read before it's overwritten.
+    // Writing back dead registers when spilling mid-block is pointless, so the spill paths skip them.
+    std::array<uint32_t, MAX_TRACE_SIZE> m_liveness;
+    unsigned m_livenessCount = 0;      // How many entries of m_liveness are valid
+    unsigned m_livenessIndex = 0;      // Index of the instruction being compiled in m_liveness
+    uint32_t m_liveRegs = 0xffffffff;  // Liveness of the instruction being compiled. Everything is live at block end
+    // In full PGXP mode, set for the ALU instructions whose result is overwritten before it can be stored, moved to
+    // the GTE, or leave the block. Their PGXP hook is skipped, as nothing would ever look at what it tracked.
+    std::array<bool, MAX_TRACE_SIZE> m_pgxpUnused;
+
+    void analyzeLiveness(uint32_t pc, unsigned maxInstructions);
+    uint32_t getLoadDelayConflicts(uint32_t pc);
+    bool needsWriteback(int reg) { return (m_liveRegs & (1u << reg)) != 0; }
+
     void prepareForCall();
     void handleKernelCall();
     void emitDispatcher();
     void uncompileAll();
+    void emitCoverageMark(uint32_t pc);
 
   public:
     DynaRecCPU() : R3000Acpu("Dynarec (x86-64)") {}
 
-    virtual bool Implemented() final { return true; }
+    // Another emulator of the process may own the code cache already.
+    virtual bool Implemented() final { return gen.ownsCodeCache(); }
     virtual bool Init() final;
     virtual void Reset() final;
     virtual void Shutdown() final;
@@ -213,33 +331,48 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     }
     // For the GUI dynarec disassembly widget
     virtual const uint8_t* getBufferPtr() final { return gen.getCode<const uint8_t*>(); }
-    virtual const size_t getBufferSize() final { return gen.getSize(); }
+    virtual const size_t getBufferSize() final {
+        size_t used = 0;
+        for (const auto& region : getCodeBufferRegions()) used += region.used;
+        return used;
+    }
+    virtual const size_t getBufferCapacity() final { return codeCacheSize; }
+    virtual std::vector<CodeBufferRegion> getCodeBufferRegions() final;
+    virtual LoadDelayStats getLoadDelayStats() final { return m_loadDelayStats; }
+    virtual std::span<const uint64_t> getCodeCoverage() final {
+        if (!m_codeBitmap) return {};
+        return {m_codeBitmap, m_ramSize / 4 / 64};
+    }
 
-    // TODO: Make it less slow and bad
-    // Possibly clear blocks more aggressively
+    // Invalidate every block that was compiled from code within the written range (size is in words).
     // Note: This relies on the behavior in psxmem.cc which calls Clear after force-aligning the address
     virtual void Clear(uint32_t addr, uint32_t size) final {
-        auto pointer = getBlockPointer(addr);
-        for (auto i = 0; i < size; i++) {
-            *pointer++ = m_uncompiledBlock;
-        }
+        const auto& memory = PCSX::g_emulator->m_mem;
+        const auto pointer = memory->getPointer<uint8_t>(addr);
+        if (pointer == nullptr || pointer < memory->m_wram || pointer >= memory->m_wram + m_ramSize) return;
+
+        const uint32_t offset = pointer - memory->m_wram;
+        invalidateCode(offset, std::min<uint32_t>(offset + size * 4, m_ramSize));
     }
 
     virtual void invalidateCache() override final {
-        memset(m_regs.iCacheAddr, 0xff, sizeof(m_regs.iCacheAddr));
-        memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
+        invalidateICache();
         m_invalidateBlocks();
+        resetCodeTracking();
     }
 
+    virtual void invalidateBreakpoint(uint32_t address, uint32_t width) override final;
+
+    // The PGXP hooks are part of the emitted code, so switching modes throws away everything compiled so far
     virtual void SetPGXPMode(uint32_t pgxpMode) final {
-        if (pgxpMode != 0) {
-            throw std::runtime_error("PGXP not supported in x64 JIT");
-        }
+        if (pgxpMode == m_pgxpMode) return;
+        m_pgxpMode = pgxpMode;
+        uncompileAll();
     }
 
     void dumpBuffer() const {
         std::ofstream file("DynarecOutput.dump", std::ios::binary);  // Make a file for our dump
-        file.write(gen.getCode<const char*>(), gen.getSize());       // Write the code buffer to the dump
+        file.write(gen.getCode<const char*>(), codeCacheSize);       // Write the code buffer to the dump
     }
 
   private:
@@ -282,6 +415,15 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // For stores to a constant address: marks the RAM page behind the pointer as dirty, if it's in RAM at all
+    void markRAMPageDirty(const void* pointer) {
+        const auto& memory = PCSX::g_emulator->m_mem;
+        const uintptr_t offset = reinterpret_cast<const uint8_t*>(pointer) - memory->m_wram;
+        if (offset >= PCSX::Memory::c_ramSize) return;
+        auto& dirtyRAM = memory->getDirtyRAM();
+        store<8>(1, dirtyRAM.data() + (offset >> dirtyRAM.pageShift()));
+    }
+
     // Stores a value of "size" bits from "source" to the given pointer
     // Tries to use base pointer relative addressing, otherwise uses movabs
     template <int size, typename T>
@@ -365,19 +507,33 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static void recErrorWrapper(DynaRecCPU* that) { that->error(); }
 
     static void signalShellReached(DynaRecCPU* that);
+    static bool checkExecBreakpoint(DynaRecCPU* that, uint32_t pc);
+    static void pgxpHookWrapper(DynaRecCPU* that, uint32_t code);
+    static void idleLoopWrapper(DynaRecCPU* that, uint32_t start, uint32_t branchPC);
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, bool fullLoadDelayEmulation) {
         return that->recompile(that->m_regs.pc, fullLoadDelayEmulation);
     }
+    static DynarecCallback recFullLoadDelaysWrapper(DynaRecCPU* that) {
+        return that->getFullLoadDelayBlock(that->m_regs.pc);
+    }
+    static DynarecCallback recPromoteWrapper(DynaRecCPU* that) {
+        return that->recompile(that->m_regs.pc, false, true, true);
+    }
+    static void recClearWrapper(DynaRecCPU* that, uint32_t address) { that->Clear(address & ~3, 1); }
+    static void recRelinkWrapper(DynaRecCPU* that, uint8_t* comparison, uint8_t* jump, uint32_t pc) {
+        that->relinkBlock(comparison, jump, pc);
+    }
 
     // Check if we're executing from valid memory
     inline bool isPcValid(uint32_t addr) { return m_recompilerLUT[addr >> 16] != m_dummyBlocks; }
 
     DynarecCallback* getBlockPointer(uint32_t pc);
-    DynarecCallback recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align = true);
+    DynarecCallback recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align = true, bool trace = false);
     void error();
-    void flushCache();
     void handleLinking();
+    void relinkBlock(uint8_t* comparison, uint8_t* jump, uint32_t pc);
     void handleShellReached();
+    void handleExecBreakpoint(uint32_t pc);
     void emitBlockLookup();
 
     std::string m_symbols;
@@ -387,6 +543,10 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     bool startProfiling(uint32_t pc);
     void endProfiling();
     void dumpProfileData();
+    void countLink(uint64_t& counter) {
+        loadAddress(rax, &counter);
+        gen.inc(qword[rax]);
+    }
 
     void maybeCancelDelayedLoad(int index) {
         if (m_fullLoadDelayEmulation && m_firstInstruction) {
@@ -478,6 +638,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void recXOR(uint32_t code);
     void recXORI(uint32_t code);
     void recException(Exception e);
+    void emitSyscall();
 
     // GTE instructions
     void recGTEMove(uint32_t code);
@@ -506,8 +667,33 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
 
     template <bool isAVSZ4>
     void recAVSZ(uint32_t code);
+    template <bool isRTPT>
+    void recRTP(uint32_t code);
+    // What the lighting commands do to the color they computed before pushing it: NCS and NCT push it as is, NCCS,
+    // NCCT and CC multiply it by RGB, and NCDS, NCDT and CDP also blend it towards the far color
+    enum class GTEColorStep { None, Multiply, DepthCue };
+    void recNormalColor(uint32_t code, int vectorCount, GTEColorStep step);
+    void recColor(uint32_t code, GTEColorStep step);
     void loadGTEDataRegister(Reg32 dest, int index);
 
+    // Building blocks of the native GTE commands
+    bool useNativeGTE();
+    bool isGTEFlagLive();
+    uintptr_t gteMatrixOffset(int matrix, int row, int column);
+    uintptr_t gteVectorOffset(int vector, int component);
+    void emitGTELimit(Reg32 value, Reg32 scratch, int32_t min, int32_t max, uint32_t flagBits, bool trackFlags);
+    void emitGTEMAC0Flags();
+    void emitGTEMatrixRow(int matrix, int vector, int translation, int row, bool trackFlags);
+    void emitGTEMatrixVectorProduct(int matrix, int vector, int translation, bool sf, bool lm, bool trackFlags,
+                                    bool rtps = false);
+    void emitGTEDivide(bool trackFlags);
+    void emitGTEPerspectiveTransform(int vertex, bool sf, bool lm, bool trackFlags);
+    void emitGTEColorFIFO(bool trackFlags);
+    void emitGTEColorMultiply(bool sf, bool lm, bool trackFlags);
+    void emitGTEDepthCue(bool sf, bool lm, bool trackFlags);
+    void emitGTEColor(bool sf, bool lm, bool trackFlags, GTEColorStep step);
+    void emitGTENormalColor(int vector, bool sf, bool lm, bool trackFlags, GTEColorStep step);
+
     template <bool readSR>
     void testSoftwareInterrupt();
 
@@ -526,6 +712,14 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     template <int size, bool signExtend>
     void recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType dependencyType);
 
+    // Memory accesses with the address in arg2 and, for writes, the value in arg3. Reads return in eax.
+    // With useLUT, RAM accesses are done inline through the memory LUTs, and only the rest calls into Memory
+    template <int size>
+    void emitMemoryRead(bool useLUT);
+    template <int size>
+    void emitMemoryWrite(bool useLUT);
+    void emitLUTLookup(uint8_t** lut, Label& slowPath);
+
     const recompilationFunc m_recBSC[64] = {
         &DynaRecCPU::recSpecial, &DynaRecCPU::recREGIMM,  &DynaRecCPU::recJ,       &DynaRecCPU::recJAL,      // 00
         &DynaRecCPU::recBEQ,     &DynaRecCPU::recBNE,     &DynaRecCPU::recBLEZ,    &DynaRecCPU::recBGTZ,     // 04
@@ -586,5 +780,8 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static constexpr bool ENABLE_BLOCK_LINKING = true;
     static constexpr bool ENABLE_PROFILER = false;
     static constexpr bool ENABLE_SYMBOLS = false;
+    static constexpr bool ENABLE_LIVENESS_ANALYSIS = true;
+    static constexpr bool ENABLE_INLINE_MEMORY_ACCESS = true;
+    static constexpr bool ENABLE_GTE_FLAG_ELISION = true;
 };
 #endif  // DYNAREC_X86_64
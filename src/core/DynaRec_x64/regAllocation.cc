@@ -19,6 +19,7 @@
 
 #include "regAllocation.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "recompiler.h"
@@ -47,16 +48,18 @@ void DynaRecCPU::reserveReg(int index) {
 void DynaRecCPU::flushRegs() {
     for (auto i = 1; i < 32; i++) {
         if (m_gprs[i].isConst()) {  // If const: Write the value directly, mark as unknown
-            gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].val);
+            if (needsWriteback(i)) {
+                gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].val);
+            }
             m_gprs[i].markUnknown();
         }
 
         else if (m_gprs[i].isAllocated()) {  // If it's been allocated to a register, unallocate
             m_gprs[i].allocated = false;
-            if (m_gprs[i].writeback) {  // And if writeback was specified, write the value back
+            if (m_gprs[i].writeback && needsWriteback(i)) {  // And if writeback was specified, write the value back
                 gen.mov(dword[contextPointer + GPR_OFFSET(i)], m_gprs[i].allocatedReg);
-                m_gprs[i].writeback = false;  // And turn writeback off
             }
+            m_gprs[i].writeback = false;  // And turn writeback off
         }
     }
 
@@ -73,10 +76,11 @@ void DynaRecCPU::prepareForCall() {
         for (auto i = ALLOCATEABLE_NON_VOLATILE_COUNT; i < m_allocatedRegisters; i++) {  // iterate volatile regs
             if (m_hostRegs[i].mappedReg) {  // Unallocate and spill to guest regs as appropriate
                 const auto previous = m_hostRegs[i].mappedReg.value();  // Get previously allocated register
-                if (m_gprs[previous].writeback) {                       // Spill to guest reg if writeback is enabled
+                // Spill to guest reg if writeback is enabled and the value is still needed
+                if (m_gprs[previous].writeback && needsWriteback(previous)) {
                     gen.mov(dword[contextPointer + GPR_OFFSET(previous)], allocateableRegisters[i]);
-                    m_gprs[previous].writeback = false;
                 }
+                m_gprs[previous].writeback = false;
 
                 m_gprs[previous].allocated = false;  // Unallocate it
                 m_hostRegs[i].mappedReg = std::nullopt;
@@ -96,10 +100,11 @@ void DynaRecCPU::spillRegisterCache() {
         if (m_hostRegs[i].mappedReg) {  // Check if the register is still allocated to a guest register
             const auto previous = m_hostRegs[i].mappedReg.value();  // Get the reg it's allocated to
 
-            if (m_gprs[previous].writeback) {  // Spill to guest register if writeback is enabled and disable writeback
+            // Spill to guest register if writeback is enabled and the value is still needed, then disable writeback
+            if (m_gprs[previous].writeback && needsWriteback(previous)) {
                 gen.mov(dword[contextPointer + GPR_OFFSET(previous)], allocateableRegisters[i]);
-                m_gprs[previous].writeback = false;
             }
+            m_gprs[previous].writeback = false;
 
             m_hostRegs[i].mappedReg = std::nullopt;  // Unallocate it
             m_gprs[previous].allocated = false;
@@ -109,6 +114,254 @@ void DynaRecCPU::spillRegisterCache() {
     m_allocatedRegisters = 0;  // Nothing is allocated anymore
 }
 
+namespace {
+struct RegisterUsage {
+    uint32_t uses = 0;   // Registers the instruction reads
+    uint32_t kills = 0;  // Registers the instruction overwrites without reading
+    bool isBranch = false;
+    bool isBarrier = false;  // Instruction might leave the block or look at the whole register file
+};
+
+// Which guest registers an instruction touches. Anything not handled here is treated as a barrier.
+// Writes that go through a load delay (loads, MFC0, MFC2, CFC2) or that link a return address are
+// not counted as kills, which keeps the analysis conservative.
+RegisterUsage getRegisterUsage(uint32_t code) {
+    RegisterUsage usage;
+    const uint32_t rs = 1u << ((code >> 21) & 0x1f);
+    const uint32_t rt = 1u << ((code >> 16) & 0x1f);
+    const uint32_t rd = 1u << ((code >> 11) & 0x1f);
+
+    switch (code >> 26) {
+        case 0x00:  // SPECIAL
+            switch (code & 0x3f) {
+                case 0x00:
+                case 0x02:
+                case 0x03:  // SLL, SRL, SRA
+                    usage.uses = rt;
+                    usage.kills = rd;
+                    break;
+                case 0x04:
+                case 0x06:
+                case 0x07:  // SLLV, SRLV, SRAV
+                    usage.uses = rt | rs;
+                    usage.kills = rd;
+                    break;
+                case 0x08:
+                case 0x09:  // JR, JALR
+                    usage.uses = rs;
+                    usage.isBranch = true;
+                    break;
+                case 0x10:
+                case 0x12:  // MFHI, MFLO
+                    usage.kills = rd;
+                    break;
+                case 0x11:
+                case 0x13:  // MTHI, MTLO
+                    usage.uses = rs;
+                    break;
+                case 0x18:
+                case 0x19:
+                case 0x1a:
+                case 0x1b:  // MULT, MULTU, DIV, DIVU
+                    usage.uses = rs | rt;
+                    break;
+                case 0x20:
+                case 0x21:
+                case 0x22:
+                case 0x23:  // ADD, ADDU, SUB, SUBU
+                case 0x24:
+                case 0x25:
+                case 0x26:
+                case 0x27:  // AND, OR, XOR, NOR
+                case 0x2a:
+                case 0x2b:  // SLT, SLTU
+                    usage.uses = rs | rt;
+                    usage.kills = rd;
+                    break;
+                default:  // SYSCALL, BREAK and invalid instructions
+                    usage.isBarrier = true;
+                    break;
+            }
+            break;
+
+        case 0x01:  // REGIMM
+            usage.uses = rs;
+            usage.isBranch = true;
+            break;
+        case 0x02:
+        case 0x03:  // J, JAL
+            usage.isBranch = true;
+            break;
+        case 0x04:
+        case 0x05:  // BEQ, BNE
+            usage.uses = rs | rt;
+            usage.isBranch = true;
+            break;
+        case 0x06:
+        case 0x07:  // BLEZ, BGTZ
+            usage.uses = rs;
+            usage.isBranch = true;
+            break;
+
+        case 0x08:
+        case 0x09:
+        case 0x0a:
+        case 0x0b:  // ADDI, ADDIU, SLTI, SLTIU
+        case 0x0c:
+        case 0x0d:
+        case 0x0e:  // ANDI, ORI, XORI
+            usage.uses = rs;
+            usage.kills = rt;
+            break;
+        case 0x0f:  // LUI
+            usage.kills = rt;
+            break;
+
+        case 0x12:  // COP2
+            if ((code & (1 << 25)) == 0) {
+                const auto op = (code >> 21) & 0x1f;
+                if (op == 4 || op == 6) {  // MTC2, CTC2
+                    usage.uses = rt;
+                } else if (op != 0 && op != 2) {  // Anything other than MFC2 and CFC2
+                    usage.isBarrier = true;
+                }
+            }
+            break;
+
+        case 0x20:
+        case 0x21:
+        case 0x23:
+        case 0x24:
+        case 0x25:  // LB, LH, LW, LBU, LHU
+        case 0x32:                                              // LWC2
+            usage.uses = rs;
+            break;
+        case 0x22:
+        case 0x26:  // LWL, LWR
+            usage.uses = rs | rt;
+            break;
+        case 0x28:
+        case 0x29:
+        case 0x2a:
+        case 0x2b:
+        case 0x2e:  // SB, SH, SWL, SW, SWR
+            usage.uses = rs | rt;
+            break;
+        case 0x3a:  // SWC2
+            usage.uses = rs;
+            break;
+
+        default:  // COP0 can fire interrupts and end the block, the rest is invalid
+            usage.isBarrier = true;
+            break;
+    }
+
+    usage.uses &= ~1u;  // $zero is never allocated
+    usage.kills &= ~1u;
+    return usage;
+}
+
+// The registers whose PGXP tracking an instruction looks at. Branches, and the base register of memory accesses,
+// only need the value.
+uint32_t getPGXPReads(uint32_t code, const RegisterUsage& usage) {
+    if (usage.isBranch) return 0;
+    switch (code >> 26) {
+        case 0x20:
+        case 0x21:
+        case 0x22:
+        case 0x23:
+        case 0x24:
+        case 0x25:
+        case 0x26:  // LB, LH, LWL, LW, LBU, LHU, LWR
+        case 0x32:  // LWC2
+        case 0x3a:  // SWC2
+            return 0;
+        case 0x28:
+        case 0x29:
+        case 0x2a:
+        case 0x2b:
+        case 0x2e:  // SB, SH, SWL, SW, SWR
+            return (1u << ((code >> 16) & 0x1f)) & ~1u;
+    }
+    return usage.uses;
+}
+}  // namespace
+
+// Backwards liveness pass over the instructions starting at pc, up until the end of the block.
+// The block end, and anything beyond what we scanned, is treated as reading every register.
+void DynaRecCPU::analyzeLiveness(uint32_t pc, unsigned maxInstructions) {
+    m_livenessIndex = 0;
+    m_livenessCount = 0;
+    if constexpr (!ENABLE_LIVENESS_ANALYSIS) {
+        return;
+    }
+
+    auto& memory = PCSX::g_emulator->m_mem;
+    std::array<RegisterUsage, MAX_TRACE_SIZE> usages;
+    std::array<uint32_t, MAX_TRACE_SIZE> codes;
+    unsigned count = 0;
+    bool inDelaySlot = false;
+    maxInstructions = std::min<unsigned>(maxInstructions, MAX_TRACE_SIZE);
+
+    while (count < maxInstructions) {
+        const uint32_t* ptr = memory->getPointer<uint32_t>(pc);
+        if (!ptr) break;
+        pc += 4;
+
+        codes[count] = *ptr;
+        auto& usage = usages[count++] = getRegisterUsage(*ptr);
+        if (usage.isBarrier || inDelaySlot) {
+            if (usage.isBarrier || usage.isBranch) usage.uses = 0xffffffff;
+            break;
+        }
+        inDelaySlot = usage.isBranch;
+    }
+
+    uint32_t live = 0xffffffff;
+    uint32_t pgxpLive = 0xffffffff;  // Registers whose PGXP tracking might still be looked at
+    for (unsigned i = count; i-- > 0;) {
+        const auto& usage = usages[i];
+        // The registers an instruction touches count as live while compiling it, as the emitted code might
+        // spill halfway through, after some of its results have been produced
+        m_liveness[i] = live | usage.uses | usage.kills;
+        live = (live & ~usage.kills) | usage.uses;
+
+        // Only ALU instructions kill registers. Skipping the hook of one leaves stale tracking behind for its
+        // destination, which PGXP notices when validating it against the actual value, if it ever gets there.
+        m_pgxpUnused[i] = (m_pgxpMode >= 2) && usage.kills && !(pgxpLive & usage.kills);
+        if (usage.kills) {
+            pgxpLive &= ~usage.kills;
+            if (!m_pgxpUnused[i]) pgxpLive |= usage.uses;
+        } else {
+            pgxpLive |= getPGXPReads(codes[i], usage);
+        }
+    }
+    m_livenessCount = count;
+}
+
+// The registers a load left pending by the previous block can't land in before the instruction at pc runs: the
+// ones it reads, which still have to hold their old value, and the ones it loads into itself, as that cancels the
+// pending load while keeping the old value around for one more instruction. Overwriting one of them right away
+// cancels the pending load too, which makes no difference either way.
+uint32_t DynaRecCPU::getLoadDelayConflicts(uint32_t pc) {
+    const uint32_t* ptr = PCSX::g_emulator->m_mem->getPointer<uint32_t>(pc);
+    if (!ptr) return 0xffffffff;
+    const uint32_t code = *ptr;
+    const auto usage = getRegisterUsage(code);
+    if (usage.isBarrier) return 0xffffffff;
+
+    uint32_t conflicts = usage.uses;
+    const uint32_t rt = 1u << ((code >> 16) & 0x1f);
+    const auto opcode = code >> 26;
+    if (opcode >= 0x20 && opcode <= 0x26) {  // LB, LH, LWL, LW, LBU, LHU, LWR
+        conflicts |= rt;
+    } else if (opcode == 0x12 && (code & (1 << 25)) == 0) {
+        const auto op = (code >> 21) & 0x1f;
+        if (op == 0 || op == 2) conflicts |= rt;  // MFC2, CFC2
+    }
+    return conflicts & ~1u;
+}
+
 void DynaRecCPU::allocateReg(int reg) {
     if (!m_gprs[reg].isAllocated()) {
         if (m_allocatedRegisters >= ALLOCATEABLE_REG_COUNT) {
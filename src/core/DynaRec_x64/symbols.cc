@@ -105,9 +105,16 @@ void DynaRecCPU::makeSymbols() {
 
     REGISTER_FUNCTION(exceptionWrapper, "fire_exception");
     REGISTER_FUNCTION(signalShellReached, "signal_shell_reached");
+    REGISTER_FUNCTION(checkExecBreakpoint, "check_exec_breakpoint");
+    REGISTER_FUNCTION(pgxpHookWrapper, "pgxp_hook_wrapper");
+    REGISTER_FUNCTION(idleLoopWrapper, "idle_loop_wrapper");
     REGISTER_FUNCTION(SPU_writeRegisterWrapper, "spu_write_register");
     REGISTER_FUNCTION(recErrorWrapper, "recompiler_error_wrapper");
     REGISTER_FUNCTION(recRecompileWrapper, "recompiler_compile_wrapper");
+    REGISTER_FUNCTION(recRelinkWrapper, "recompiler_relink_wrapper");
+    REGISTER_FUNCTION(recClearWrapper, "recompiler_clear_wrapper");
+    REGISTER_FUNCTION(recPromoteWrapper, "recompiler_promote_wrapper");
+    REGISTER_FUNCTION(recFullLoadDelaysWrapper, "recompiler_full_load_delays_wrapper");
 
     m_symbols += fmt::format("{} dispatcher_entry\n", (void*)m_dispatcher);
     m_symbols += fmt::format("{} return_from_block\n", (void*)m_returnFromBlock);
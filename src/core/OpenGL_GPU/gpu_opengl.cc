@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 
 #include "core/debug.h"
@@ -29,18 +30,42 @@
 #include "core/system.h"
 #include "fmt/format.h"
 #include "gui/gui.h"
+#include "support/imgui-helpers.h"
 #include "tracy/Tracy.hpp"
 
 std::unique_ptr<PCSX::GPU> PCSX::GPU::getOpenGL() { return std::unique_ptr<PCSX::GPU>(new PCSX::OpenGL_GPU()); }
 
+namespace {
+
+// Whether decoding a paletted texture page, through its CLUT, reads anything from the given part of the VRAM.
+bool pageReads(uint32_t key, int x, int y, int w, int h) {
+    const unsigned texpage = key >> 16;
+    const unsigned clut = key & 0xffff;
+    const auto overlaps = [x, y, w, h](int rx, int ry, int rw, int rh) {
+        return (rx < x + w) && (x < rx + rw) && (ry < y + h) && (y < ry + rh);
+    };
+    const bool eightBits = texpage & 0x80;
+    const int pageX = (texpage & 0xf) * 64;
+    const int pageY = ((texpage >> 4) & 1) * 256;
+    const int pageWidth = eightBits ? 128 : 64;
+    // Pages on the right edge of the VRAM wrap around to its left edge
+    return overlaps(pageX, pageY, pageWidth, 256) || overlaps(pageX - 1024, pageY, pageWidth, 256) ||
+           overlaps((clut & 0x3f) * 16, clut >> 6, eightBits ? 256 : 16, 1);
+}
+
+}  // namespace
+
 void PCSX::OpenGL_GPU::resetBackend() {
     m_gpustat = 0x14802000;
 
     m_lastTransparency = Transparency::Opaque;
-    m_lastBlendingMode = -1;
+    m_lastBlendingMode = 0;
+    m_subtractiveBatch = false;
+    m_vertexBlend = 0;
     m_drawMode = 0;
     m_rectTexpage = 0;
-    m_vertexCount = 0;
+    // Whatever is before m_batchStart may still be in use by the GPU
+    m_vertexCount = m_batchStart;
     m_syncVRAM = true;
     m_display.reset();
 
@@ -69,6 +94,8 @@ void PCSX::OpenGL_GPU::clearVRAM(float r, float g, float b, float a) {
     OpenGL::setClearColor(r, g, b, a);
     OpenGL::clearColor();
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFBO);
+    markVRAMDirty(0, 0, 1024, 512);
+    m_dirtyRect.add(0, 0, vramWidth, vramHeight);
 
     if (oldScissor) OpenGL::enableScissor();
 }
@@ -78,10 +105,23 @@ void PCSX::OpenGL_GPU::clearVRAM() { clearVRAM(0.f, 0.f, 0.f, 1.f); }
 // Do not forget to call this with an active OpenGL context.
 int PCSX::OpenGL_GPU::initBackend(UI *ui) {
     m_gui = dynamic_cast<GUI *>(ui);
-    // Reserve some size for vertices & vram transfers to avoid dynamic allocations later.
-    m_vertices.resize(vertexBufferSize);
-
-    m_vbo.createFixedSize(sizeof(Vertex) * vertexBufferSize, GL_STREAM_DRAW);
+    // Write the vertices straight into a persistently mapped buffer when the driver lets us, instead of copying
+    // them over for each batch. Otherwise, reserve some size for vertices to avoid dynamic allocations later.
+    m_persistentVertices = false;
+    if (!gl3wIsCppThrower(reinterpret_cast<GL3WglProc>(glBufferStorage))) {
+        m_mappedVertices = reinterpret_cast<Vertex *>(
+            m_vbo.createPersistentMapped(sizeof(Vertex) * vertexBufferSize * c_vertexSegments));
+        m_persistentVertices = m_mappedVertices != nullptr;
+    }
+    if (m_persistentVertices) {
+        m_vertices = m_mappedVertices;
+    } else {
+        m_vertexStorage.resize(vertexBufferSize);
+        m_vertices = m_vertexStorage.data();
+        m_vbo.createFixedSize(sizeof(Vertex) * vertexBufferSize, GL_STREAM_DRAW);
+    }
+    m_segment = 0;
+    m_vertexCount = m_batchStart = 0;
     m_vbo.bind();
     m_vao.create();
     m_vao.bind();
@@ -102,23 +142,65 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
     m_vao.setAttributeFloat<GLushort>(4, 2, sizeof(Vertex), offsetof(Vertex, uv));
     m_vao.enableAttribute(4);
 
-    // Make VRAM texture and attach it to draw frambuffer
+    m_sampleTexture.create(vramWidth, vramHeight, GL_RGBA8);
+    m_sampleFBO.createWithTexture(m_sampleTexture);
+    m_dirtyRect.clear();
+    m_vramShadow.assign(vramWidth * vramHeight, 0);
+    m_readbackRect.clear();
+    m_readbackRect.add(0, 0, vramWidth, vramHeight);
+    m_readbackInFlight.clear();
+    m_readbackFramesLeft = 0;
+    glGenBuffers(1, &m_readbackBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_readbackBuffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, vramWidth * vramHeight * sizeof(uint16_t), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_snapshotTexture.create(vramWidth, vramHeight, GL_RGBA8);
+    m_snapshotFBO.createWithTexture(m_snapshotTexture);
+    m_snapshot.assign(vramWidth * vramHeight, 0);
+    m_snapshotValid = false;
+    m_snapshotIndex = 0;
+    m_snapshotFramesLeft = 0;
+    glGenBuffers(2, m_snapshotBuffers.data());
+    for (auto buffer : m_snapshotBuffers) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, vramWidth * vramHeight * sizeof(uint16_t), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_pageCacheEnabled = g_emulator->settings.get<Emulator::SettingTexturePageCache>();
+    m_pageCache.clear();
+    m_pageCacheLayersByKey.clear();
+    m_pendingDecodes.clear();
+    glDeleteTextures(1, &m_pageCacheTexture);
+    glGenTextures(1, &m_pageCacheTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_pageCacheTexture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, 256, 256, c_pageCacheLayers);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    m_pageCacheFBO.create();
+
+    // Make VRAM texture and attach it to draw frambuffer. When upscaling, everything gets drawn m_scale times
+    // larger, and only goes back to the native resolution when sampled or read back.
+    m_scale = std::clamp(g_emulator->settings.get<Emulator::SettingInternalResolution>().value, 1, 8);
+    const int scaledWidth = vramWidth * m_scale;
+    const int scaledHeight = vramHeight * m_scale;
     const int msaaSampleCount = g_emulator->settings.get<Emulator::SettingMSAA>();
     if (msaaSampleCount > 1 && glTexStorage2DMultisample != nullptr) {
-        m_vramTexture.createMSAA(vramWidth, vramHeight, GL_RGBA8, msaaSampleCount);
+        m_vramTexture.createMSAA(scaledWidth, scaledHeight, GL_RGBA8, msaaSampleCount);
         m_fbo.createWithTextureMSAA(m_vramTexture);
 
-        m_vramTextureNoMSAA.create(vramWidth, vramHeight, GL_RGBA8);
+        m_vramTextureNoMSAA.create(scaledWidth, scaledHeight, GL_RGBA8);
         m_fboNoMSAA.createWithTexture(m_vramTextureNoMSAA);
         m_multisampled = true;
     } else {
-        m_vramTexture.create(vramWidth, vramHeight, GL_RGBA8);
+        m_vramTexture.create(scaledWidth, scaledHeight, GL_RGBA8);
         m_fbo.createWithTexture(m_vramTexture);
         m_multisampled = false;
     }
 
-    m_sampleTexture.create(vramWidth, vramHeight, GL_RGBA8);
-
+    m_fbo.bind(OpenGL::DrawFramebuffer);
     if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         throw std::runtime_error("Non-complete framebuffer");
     }
@@ -149,6 +231,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         // inClut: The CLUT (palette) for textured primitives
         // inTexpage: The texpage. We use bit 15 for indicating an untextured primitive (1 = untextured). This
         // lets us batch untextured and textured primitives together. Bit 15 is unused by hardware, so this is a possible optimization
+        // Bit 14, equally unused, is set for semi-transparent primitives, with the blending mode in bits 5-6
         // inUV: The UVs (texture coordinates) for textured primitives
 
         layout (location = 0) in ivec2 inPos;
@@ -162,9 +245,14 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         flat out ivec2 clutBase;
         flat out ivec2 texpageBase;
         flat out int texMode;
+        flat out int pageLayer;
+        flat out vec4 semiFactors;
 
         // We always apply a 0.5 offset in addition to the drawing offsets, to cover up OpenGL inaccuracies
         uniform vec2 u_vertexOffsets = vec2(+0.5, -0.5);
+        // Subtractive blending is drawn in two passes, each with its own factors
+        uniform vec4 u_blendFactors;
+        uniform vec4 u_blendFactorsIfOpaque = vec4(1.0, 1.0, 1.0, 0.0);
 
         void main() {
            // Normalize coords to [0, 2]
@@ -185,8 +273,28 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
            gl_Position = vec4(xx, yy, 1.0, 1.0);
            vertexColor = vec4(color / 255.0, 1.0);
 
+           // rgb: The factor to multiply the source colour with, a: the factor to multiply the destination with
+           if ((inTexpage & 0x4000) == 0) {
+               semiFactors = u_blendFactorsIfOpaque;
+           } else {
+               int blendingMode = (inTexpage >> 5) & 3;
+               if (blendingMode == 0) { // B/2 + F/2
+                   semiFactors = vec4(0.5, 0.5, 0.5, 0.5);
+               } else if (blendingMode == 1) { // B + F
+                   semiFactors = vec4(1.0, 1.0, 1.0, 1.0);
+               } else if (blendingMode == 2) { // B - F
+                   semiFactors = u_blendFactors;
+               } else { // B + F/4
+                   semiFactors = vec4(0.25, 0.25, 0.25, 1.0);
+               }
+           }
+
            if ((inTexpage & 0x8000) != 0) { // Untextured primitive
                texMode = 4;
+           } else if ((inTexpage & 0x2000) != 0) { // Paletted texture, already decoded in the page cache
+               texMode = 5;
+               texCoords = inUV;
+               pageLayer = inClut;
            } else {
                texMode = (inTexpage >> 7) & 3;
                texCoords = inUV;
@@ -203,6 +311,8 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         flat in ivec2 clutBase;
         flat in ivec2 texpageBase;
         flat in int texMode;
+        flat in int pageLayer;
+        flat in vec4 semiFactors;
 
         // We use dual-source blending in order to emulate the fact that the GPU can enable blending per-pixel
         // FragColor: The colour of the pixel before alpha blending comes into play
@@ -215,7 +325,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         // z, w components: masks to | coords with
         uniform ivec4 u_texWindow;
         uniform sampler2D u_vramTex;
-        uniform vec4 u_blendFactors;
+        uniform sampler2DArray u_pageCache;
         uniform vec4 u_blendFactorsIfOpaque = vec4(1.0, 1.0, 1.0, 0.0);
 
         int floatToU5(float f) {
@@ -247,7 +357,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
         void main() {
            if (texMode == 4) { // Untextured primitive
                FragColor = vertexColor;
-               BlendColor = u_blendFactors;
+               BlendColor = semiFactors;
                return;
            }
 
@@ -255,7 +365,13 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
            ivec2 UV = ivec2(floor(texCoords + vec2(0.0001, 0.0001))) & ivec2(0xff);
            UV = (UV & u_texWindow.xy) | u_texWindow.zw;
 
-           if (texMode == 0) { // 4bpp texture
+           if (texMode == 5) { // Paletted texture from the page cache
+               FragColor = texelFetch(u_pageCache, ivec3(UV, pageLayer), 0);
+
+               if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
+               BlendColor = FragColor.a >= 0.5 ? semiFactors : u_blendFactorsIfOpaque;
+               FragColor = texBlend(FragColor, vertexColor);
+           } else if (texMode == 0) { // 4bpp texture
                ivec2 texelCoord = ivec2(UV.x >> 2, UV.y) + texpageBase;
 
                int sample = sample16(texelCoord);
@@ -266,7 +382,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
                FragColor = texelFetch(u_vramTex, sampleCoords, 0);
 
                if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
-               BlendColor = FragColor.a >= 0.5 ? u_blendFactors : u_blendFactorsIfOpaque;
+               BlendColor = FragColor.a >= 0.5 ? semiFactors : u_blendFactorsIfOpaque;
                FragColor = texBlend(FragColor, vertexColor);
            } else if (texMode == 1) { // 8bpp texture
                ivec2 texelCoord = ivec2(UV.x >> 1, UV.y) + texpageBase;
@@ -279,7 +395,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
                FragColor = texelFetch(u_vramTex, sampleCoords, 0);
 
                if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
-               BlendColor = FragColor.a >= 0.5 ? u_blendFactors : u_blendFactorsIfOpaque;
+               BlendColor = FragColor.a >= 0.5 ? semiFactors : u_blendFactorsIfOpaque;
                FragColor = texBlend(FragColor, vertexColor);
            } else { // Texture depth 2 and 3 both indicate 16bpp textures
                ivec2 texelCoord = UV + texpageBase;
@@ -287,7 +403,7 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
 
                if (FragColor.rgb == vec3(0.0, 0.0, 0.0)) discard;
                FragColor = texBlend(FragColor, vertexColor);
-               BlendColor = u_blendFactors;
+               BlendColor = semiFactors;
            }
         }
     )";
@@ -307,6 +423,71 @@ int PCSX::OpenGL_GPU::initBackend(UI *ui) {
 
     const auto vramSamplerLoc = OpenGL::uniformLocation(m_program, "u_vramTex");
     glUniform1i(vramSamplerLoc, 0);  // Make the fragment shader read from currently binded texture
+    glUniform1i(OpenGL::uniformLocation(m_program, "u_pageCache"), 1);
+
+    static const char *decodeVertSource = R"(
+        #version 330 core
+
+        void main() {
+           // A single triangle covering the whole layer
+           vec2 position = vec2(float((gl_VertexID & 1) * 4 - 1), float((gl_VertexID & 2) * 2 - 1));
+           gl_Position = vec4(position, 0.0, 1.0);
+        }
+    )";
+
+    static const char *decodeFragSource = R"(
+        #version 330 core
+
+        // Decodes a whole 4 or 8-bit texture page through its CLUT, one texel per fragment
+        uniform sampler2D u_vramTex;
+        uniform int u_texpage;
+        uniform int u_clut;
+        out vec4 FragColor;
+
+        int floatToU5(float f) {
+            return int(floor(f * 31.0 + 0.5));
+        }
+
+        int sample16(ivec2 coords) {
+            vec4 colour = texelFetch(u_vramTex, coords & ivec2(1023, 511), 0);
+            int r = floatToU5(colour.r);
+            int g = floatToU5(colour.g);
+            int b = floatToU5(colour.b);
+            int msb = int(ceil(colour.a)) << 15;
+            return r | (g << 5) | (b << 10) | msb;
+        }
+
+        void main() {
+           ivec2 UV = ivec2(gl_FragCoord.xy);
+           ivec2 texpageBase = ivec2((u_texpage & 0xf) * 64, ((u_texpage >> 4) & 0x1) * 256);
+           ivec2 clutBase = ivec2((u_clut & 0x3f) * 16, u_clut >> 6);
+
+           int clutIndex;
+           if (((u_texpage >> 7) & 3) == 0) { // 4bpp texture
+               int sample = sample16(ivec2(UV.x >> 2, UV.y) + texpageBase);
+               clutIndex = (sample >> ((UV.x & 3) << 2)) & 0xf;
+           } else { // 8bpp texture
+               int sample = sample16(ivec2(UV.x >> 1, UV.y) + texpageBase);
+               clutIndex = (sample >> ((UV.x & 1) << 3)) & 0xff;
+           }
+           FragColor = texelFetch(u_vramTex, ivec2(clutBase.x + clutIndex, clutBase.y), 0);
+        }
+    )";
+
+    {
+        OpenGL::Shader vs, ps;
+        status = vs.create(decodeVertSource, OpenGL::Vertex);
+        if (!status.isOk()) return -1;
+        status = ps.create(decodeFragSource, OpenGL::Fragment);
+        if (!status.isOk()) return -1;
+        status = m_pageDecodeProgram.create({vs, ps});
+        if (!status.isOk()) return -1;
+    }
+    m_pageDecodeProgram.use();
+    glUniform1i(OpenGL::uniformLocation(m_pageDecodeProgram, "u_vramTex"), 0);
+    m_pageDecodeTexpageLoc = OpenGL::uniformLocation(m_pageDecodeProgram, "u_texpage");
+    m_pageDecodeClutLoc = OpenGL::uniformLocation(m_pageDecodeProgram, "u_clut");
+    m_program.use();
 
     m_vramTexture24.create(1024, 512, GL_RGBA8);
     m_fbo24.createWithDrawTexture(m_vramTexture24);
@@ -426,7 +607,25 @@ void PCSX::OpenGL_GPU::setLinearFiltering() {
     m_display.setLinearFiltering();
 }
 
-int PCSX::OpenGL_GPU::shutdown() { return 0; }
+int PCSX::OpenGL_GPU::shutdown() {
+    for (auto &fence : m_segmentFences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    for (auto &fence : m_snapshotFences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    glDeleteBuffers(2, m_snapshotBuffers.data());
+    m_snapshotBuffers = {};
+    if (m_readbackFence) glDeleteSync(m_readbackFence);
+    m_readbackFence = nullptr;
+    glDeleteBuffers(1, &m_readbackBuffer);
+    m_readbackBuffer = 0;
+    glDeleteTextures(1, &m_pageCacheTexture);
+    m_pageCacheTexture = 0;
+    return 0;
+}
 
 uint32_t PCSX::OpenGL_GPU::readStatusInternal() {
     return 0b01011110100000000000000000000000;
@@ -450,6 +649,7 @@ bool PCSX::OpenGL_GPU::configure() {
 
             const auto vramSamplerLoc = OpenGL::uniformLocation(m_program, "u_vramTex");
             glUniform1i(vramSamplerLoc, 0);  // Make the fragment shader read from currently bound texture
+            glUniform1i(OpenGL::uniformLocation(m_program, "u_pageCache"), 1);
             glUniform4f(m_blendFactorsIfOpaqueLoc, 1.0, 1.0, 1.0, 0.0);
             glUniform4f(m_blendFactorsLoc, m_blendFactors.x(), m_blendFactors.x(), m_blendFactors.x(),
                         m_blendFactors.y());
@@ -475,6 +675,27 @@ bool PCSX::OpenGL_GPU::configure() {
             ImGui::EndCombo();
         }
 
+        int scale = g_emulator->settings.get<Emulator::SettingInternalResolution>();
+        const auto scaleString = scale == 1 ? _("Native") : fmt::format(f_("{}x native"), scale);
+
+        if (ImGui::BeginCombo(_("Internal resolution"), scaleString.c_str())) {
+            if (ImGui::Selectable(_("Native"))) {
+                g_emulator->settings.get<Emulator::SettingInternalResolution>() = 1;
+                changed = true;
+            }
+
+            for (int i = 2; i <= 8; i++) {
+                auto str = fmt::format(f_("{}x native"), i);
+                if (ImGui::Selectable(str.c_str())) {
+                    g_emulator->settings.get<Emulator::SettingInternalResolution>() = i;
+                    changed = true;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGuiHelpers::ShowHelpMarker(_("The internal resolution and MSAA settings take effect the next time the "
+                                       "emulator starts."));
+
         int msaaSampleCount = g_emulator->settings.get<Emulator::SettingMSAA>();
         const auto msaaString = msaaSampleCount == 1 ? _("No MSAA") : fmt::format(f_("{}x MSAA"), msaaSampleCount);
 
@@ -501,6 +722,14 @@ bool PCSX::OpenGL_GPU::configure() {
             changed = true;
             setLinearFiltering();
         }
+        if (ImGui::Checkbox(_("Cache decoded texture pages"),
+                            &g_emulator->settings.get<Emulator::SettingTexturePageCache>().value)) {
+            changed = true;
+            m_pageCacheEnabled = g_emulator->settings.get<Emulator::SettingTexturePageCache>();
+        }
+        ImGuiHelpers::ShowHelpMarker(_("Decodes 4 and 8-bit textures ahead of drawing, so that each texel only "
+                                       "costs a single texture fetch. This helps slower GPUs in heavily textured "
+                                       "scenes, but costs extra work when games keep changing their textures."));
         ImGui::Checkbox(_("Edit OpenGL GPU shaders"), &m_shaderEditor.m_show);
         ImGui::End();
     }
@@ -534,6 +763,9 @@ void PCSX::OpenGL_GPU::setOpenGLContext() {
     m_vbo.bind();
     m_vao.bind();
     m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_pageCacheTexture);
+    glActiveTexture(GL_TEXTURE0);
     m_sampleTexture.bind();
     OpenGL::setViewport(m_vramTexture.width(), m_vramTexture.height());
     OpenGL::enableScissor();
@@ -561,7 +793,8 @@ void PCSX::OpenGL_GPU::updateDrawArea() {
 
 // Set the OpenGL scissor based on our PS1's drawing area.
 void PCSX::OpenGL_GPU::setScissorArea() {
-    OpenGL::setScissor(m_scissorBox.x, m_scissorBox.y, m_scissorBox.width, m_scissorBox.height);
+    OpenGL::setScissor(m_scissorBox.x * m_scale, m_scissorBox.y * m_scale, m_scissorBox.width * m_scale,
+                       m_scissorBox.height * m_scale);
 }
 
 GLuint PCSX::OpenGL_GPU::getVRAMTexture() {
@@ -574,6 +807,7 @@ GLuint PCSX::OpenGL_GPU::getVRAMTexture() {
 
 // Called at the end of a frame
 void PCSX::OpenGL_GPU::vblank(bool fromGui) {
+    ZoneScoped;
     renderBatch();
 
     // Set the fill mode to fill before passing the OpenGL context to the GUI
@@ -584,10 +818,15 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
     // Disable scissor before passing the GPU to the frontend. This is also necessary as scissor testing affects
     // glBlitFramebuffer
     OpenGL::disableScissor();
-    if (m_lastTransparency == Transparency::Transparent) {
-        m_lastTransparency = Transparency::Opaque;
-        m_lastBlendingMode = -1;
-        OpenGL::disableBlend();
+    OpenGL::disableBlend();
+
+    if (m_snapshotFramesLeft > 0) {
+        m_snapshotFramesLeft--;
+        captureSnapshot();
+    }
+    if (m_readbackFramesLeft > 0) {
+        m_readbackFramesLeft--;
+        if (finishReadback(false)) startReadback();
     }
 
     GLuint texture;
@@ -598,7 +837,9 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
         if (m_multisampled) {
             m_fbo.bind(OpenGL::ReadFramebuffer);
             m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
-            glBlitFramebuffer(0, 0, 1024, 512, 0, 0, 1024, 512, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+            const int width = m_vramTexture.width();
+            const int height = m_vramTexture.height();
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
             texture = m_vramTextureNoMSAA.handle();
         } else {
             texture = m_vramTexture.handle();
@@ -611,6 +852,11 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
     float height = m_display.sizeNormalized.y();
 
     if (m_display.info.depth == CtrlDisplayMode::CD_24BITS) {
+        // 24-bit pixels straddle VRAM pixels, so they get decoded from the native copy
+        if (m_display.enabled) {
+            syncSampleTexture();
+            texture = m_sampleTexture.handle();
+        }
         m_fbo24.bind(OpenGL::DrawFramebuffer);
         OpenGL::setViewport(1024, 512);
         m_shaderEditor24.render(m_gui, texture, {0, 0}, {1, 1}, {1024, 512}, {lua_Number(m_display.start.x() * 2)});
@@ -625,66 +871,423 @@ void PCSX::OpenGL_GPU::vblank(bool fromGui) {
 }
 
 void PCSX::OpenGL_GPU::renderBatch() {
+    ZoneScoped;
     if (m_vertexCount > 0) {
         if (m_syncVRAM) {
             m_syncVRAM = false;
-            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, vramWidth, vramHeight);
+            syncSampleTexture();
         }
+        if (!m_pendingDecodes.empty()) decodePendingPages();
 
         if (m_updateDrawOffset) {
             m_updateDrawOffset = false;
             setDrawOffset(m_lastDrawOffsetSetting);
         }
-        m_vbo.bufferVertsSub(&m_vertices[0], m_vertexCount);
+
+        GLint first = 0;
+        const GLsizei count = m_vertexCount - m_batchStart;
+        if (m_persistentVertices) {
+            first = m_segment * vertexBufferSize + m_batchStart;
+        } else {
+            m_vbo.bufferVertsSub(m_vertices, m_vertexCount);
+        }
+
+        // Blending stays enabled, with the shaders sending out factors that leave the opaque pixels untouched
+        OpenGL::enableBlend();
+        OpenGL::setBlendFactor(GL_SRC1_COLOR, GL_SRC1_ALPHA, GL_ONE, GL_ZERO);
 
         // Special handling if we're using subtractive blending
-        if (m_lastBlendingMode == 2) {
+        if (m_subtractiveBatch) {
             // Draw opaque only
             OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
             setBlendFactors(0.0, 1.0);
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::draw(OpenGL::Triangles, first, count);
 
             // Draw transparent only
             OpenGL::setBlendEquation(OpenGL::BlendEquation::ReverseSub, OpenGL::BlendEquation::Add);
             setBlendFactors(1.0, 1.0);
             glUniform4f(m_blendFactorsIfOpaqueLoc, 0.0, 0.0, 0.0, 1.0);
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::draw(OpenGL::Triangles, first, count);
 
             glUniform4f(m_blendFactorsIfOpaqueLoc, 1.0, 1.0, 1.0, 0.0);
         } else {
-            OpenGL::draw(OpenGL::Triangles, m_vertexCount);
+            OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
+            OpenGL::draw(OpenGL::Triangles, first, count);
+        }
+        m_dirtyRect.add(m_scissorBox.x, m_scissorBox.y, m_scissorBox.width, m_scissorBox.height);
+        m_batchSerial++;
+        m_flushes.store(m_flushes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (m_persistentVertices) {
+            m_batchStart = m_vertexCount;
+        } else {
+            m_vertexCount = 0;
         }
-        m_vertexCount = 0;
     }
 }
 
+// Brings m_sampleTexture up to date with what got drawn since the last time. This is where a multisampled draw
+// target gets resolved, and where an upscaled one gets scaled back down, but only over the dirty part of the VRAM,
+// so that a game drawing in a small area doesn't cost a copy of the whole upscaled VRAM.
+void PCSX::OpenGL_GPU::syncSampleTexture() {
+    if (m_dirtyRect.empty()) return;
+    const int s = m_scale;
+    const int left = m_dirtyRect.left;
+    const int top = m_dirtyRect.top;
+    const int right = m_dirtyRect.right;
+    const int bottom = m_dirtyRect.bottom;
+    m_dirtyRect.clear();
+
+    const auto oldDrawFBO = OpenGL::getDrawFramebuffer();
+    const auto oldReadFBO = OpenGL::getReadFramebuffer();
+    const auto oldScissor = OpenGL::scissorEnabled();
+    OpenGL::disableScissor();  // Scissor testing affects glBlitFramebuffer
+
+    m_fbo.bind(OpenGL::ReadFramebuffer);
+    if (m_multisampled) {
+        // A multisampled framebuffer can only be blitted at the same size, so resolve it first
+        m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(left * s, top * s, right * s, bottom * s, left * s, top * s, right * s, bottom * s,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_fboNoMSAA.bind(OpenGL::ReadFramebuffer);
+    }
+    // Nearest filtering, so that the texels keep colours the shaders can decode as 16-bit values
+    m_sampleFBO.bind(OpenGL::DrawFramebuffer);
+    glBlitFramebuffer(left * s, top * s, right * s, bottom * s, left, top, right, bottom, GL_COLOR_BUFFER_BIT,
+                      GL_NEAREST);
+    m_readbackRect.add(left, top, right - left, bottom - top);
+    invalidatePageCache(left, top, right - left, bottom - top);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldDrawFBO);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, oldReadFBO);
+    if (oldScissor) OpenGL::enableScissor();
+}
+
+// Starts reading the VRAM back into the next pixel buffer, scaled down to its native resolution. This is called
+// with scissor testing off, at the end of a frame.
+void PCSX::OpenGL_GPU::captureSnapshot() {
+    const unsigned index = m_snapshotIndex;
+    // Rather than waiting on a readback which is still in flight, this frame just doesn't get captured
+    if (m_snapshotFences[index] && !collectSnapshot(index)) return;
+
+    const int width = m_vramTexture.width();
+    const int height = m_vramTexture.height();
+    m_fbo.bind(OpenGL::ReadFramebuffer);
+    if (m_multisampled) {
+        m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        m_fboNoMSAA.bind(OpenGL::ReadFramebuffer);
+    }
+    m_snapshotFBO.bind(OpenGL::DrawFramebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, vramWidth, vramHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    m_snapshotFBO.bind(OpenGL::ReadFramebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_snapshotBuffers[index]);
+    glReadPixels(0, 0, vramWidth, vramHeight, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_snapshotFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_snapshotIndex ^= 1;
+    m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
+}
+
+// Copies a readback out of its pixel buffer, unless the GPU isn't done writing it yet.
+bool PCSX::OpenGL_GPU::collectSnapshot(unsigned index) {
+    auto &fence = m_snapshotFences[index];
+    const auto status = glClientWaitSync(fence, 0, 0);
+    if ((status != GL_ALREADY_SIGNALED) && (status != GL_CONDITION_SATISFIED)) return false;
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    static constexpr GLsizeiptr size = vramWidth * vramHeight * sizeof(uint16_t);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_snapshotBuffers[index]);
+    const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (data) {
+        memcpy(m_snapshot.data(), data, size);
+        m_snapshotValid = true;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+// Points the attributes of a paletted primitive at the layer of the page cache holding this page decoded through
+// this CLUT, queueing it up for decoding if it isn't already. Must be called after making room for the vertices.
+// Consecutive sprites mostly share their page and CLUT, which the last lookup is kept around for. When all of the
+// layers are used by the batch being built, the primitive samples the VRAM directly instead of ending the batch.
+void PCSX::OpenGL_GPU::usePageCache(uint16_t &texpage, uint16_t &clut) {
+    const uint32_t key = (uint32_t(texpage & Vertex::c_texpageMask) << 16) | clut;
+    unsigned layer = m_lastPageLayer;
+    if ((layer >= m_pageCache.size()) || (m_pageCache[layer].key != key)) {
+        auto it = m_pageCacheLayersByKey.find(key);
+        if (it != m_pageCacheLayersByKey.end()) {
+            layer = it->second;
+        } else if (m_pageCache.size() < c_pageCacheLayers) {
+            layer = m_pageCache.size();
+            m_pageCache.push_back({key, false, 0});
+            m_pageCacheLayersByKey.emplace(key, layer);
+        } else {
+            // Out of layers: recycle the one which went unused for the longest, as long as it's not in this batch
+            layer = 0;
+            for (unsigned i = 1; i < c_pageCacheLayers; i++) {
+                if (m_pageCache[i].batch < m_pageCache[layer].batch) layer = i;
+            }
+            if (m_pageCache[layer].batch == m_batchSerial) return;
+            m_pageCacheLayersByKey.erase(m_pageCache[layer].key);
+            m_pageCache[layer] = {key, false, 0};
+            m_pageCacheLayersByKey.emplace(key, layer);
+        }
+        m_lastPageLayer = layer;
+    }
+
+    auto &entry = m_pageCache[layer];
+    entry.batch = m_batchSerial;
+    if (!entry.decoded) {
+        entry.decoded = true;
+        m_pendingDecodes.push_back(layer);
+    }
+    clut = layer;
+    texpage |= Vertex::c_cachedTexpage;
+}
+
+// Called when part of m_sampleTexture changes.
+void PCSX::OpenGL_GPU::invalidatePageCache(int x, int y, int w, int h) {
+    const bool pendingVertices = m_vertexCount != m_batchStart;
+    for (unsigned layer = 0; layer < m_pageCache.size(); layer++) {
+        auto &entry = m_pageCache[layer];
+        if (!entry.decoded || !pageReads(entry.key, x, y, w, h)) continue;
+        // The batch about to be drawn still uses this page, so it needs decoding again before drawing
+        if (pendingVertices && (entry.batch == m_batchSerial)) {
+            m_pendingDecodes.push_back(layer);
+        } else {
+            entry.decoded = false;
+        }
+    }
+}
+
+void PCSX::OpenGL_GPU::decodePendingPages() {
+    const auto oldScissor = OpenGL::scissorEnabled();
+    OpenGL::disableScissor();
+    OpenGL::disableBlend();
+    if (m_polygonMode != OpenGL::FillPoly) OpenGL::setFillMode(OpenGL::FillPoly);
+    m_pageDecodeProgram.use();
+    m_pageCacheFBO.bind(OpenGL::DrawFramebuffer);
+    OpenGL::setViewport(256, 256);
+
+    for (auto layer : m_pendingDecodes) {
+        const uint32_t key = m_pageCache[layer].key;
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_pageCacheTexture, 0, layer);
+        glUniform1i(m_pageDecodeTexpageLoc, key >> 16);
+        glUniform1i(m_pageDecodeClutLoc, key & 0xffff);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    m_pendingDecodes.clear();
+
+    m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
+    OpenGL::setViewport(m_vramTexture.width(), m_vramTexture.height());
+    if (m_polygonMode != OpenGL::FillPoly) OpenGL::setFillMode(m_polygonMode);
+    m_program.use();
+    if (oldScissor) OpenGL::enableScissor();
+}
+
+// Called when the current segment of the vertex buffer is full
+void PCSX::OpenGL_GPU::nextVertexSegment() {
+    renderBatch();
+    if (!m_persistentVertices) return;
+
+    m_segmentFences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_segment = (m_segment + 1) % c_vertexSegments;
+
+    // Only actually waits if the GPU is still drawing from the segment we're about to overwrite
+    auto &fence = m_segmentFences[m_segment];
+    if (fence) {
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    m_vertices = m_mappedVertices + m_segment * vertexBufferSize;
+    m_vertexCount = m_batchStart = 0;
+}
+
 void PCSX::OpenGL_GPU::setDisplayEnable(bool enabled) { m_display.enabled = enabled; }
 
-PCSX::Slice PCSX::OpenGL_GPU::getVRAM(Ownership) {
-    static constexpr uint32_t texSize = 1024 * 512 * sizeof(uint16_t);
-    uint16_t *pixels = (uint16_t *)malloc(texSize);
-    glFlush();
-    const auto oldTex = OpenGL::getTex2D();
-    glBindTexture(GL_TEXTURE_2D, getVRAMTexture());
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, pixels);
-    glBindTexture(GL_TEXTURE_2D, oldTex);
+// Starts reading the part of the VRAM which changed on the GPU since the last readback into the pixel buffer, at
+// the same place as in the shadow copy.
+void PCSX::OpenGL_GPU::startReadback() {
+    syncSampleTexture();
+    if (m_readbackRect.empty()) return;
+    const int left = m_readbackRect.left;
+    const int top = m_readbackRect.top;
+    const auto oldReadFBO = OpenGL::getReadFramebuffer();
+    m_sampleFBO.bind(OpenGL::ReadFramebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_readbackBuffer);
+    glPixelStorei(GL_PACK_ROW_LENGTH, vramWidth);
+    glReadPixels(left, top, m_readbackRect.right - left, m_readbackRect.bottom - top, GL_RGBA,
+                 GL_UNSIGNED_SHORT_1_5_5_5_REV,
+                 reinterpret_cast<void *>(uintptr_t((top * vramWidth + left) * sizeof(uint16_t))));
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, oldReadFBO);
+    m_readbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_readbackInFlight = m_readbackRect;
+    m_readbackRect.clear();
+}
+
+// Copies the readback in flight into the shadow copy. Unless told to wait, this gives up if the GPU isn't done
+// writing it yet.
+bool PCSX::OpenGL_GPU::finishReadback(bool wait) {
+    if (!m_readbackFence) return true;
+    if (wait) {
+        while (glClientWaitSync(m_readbackFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+    } else {
+        const auto status = glClientWaitSync(m_readbackFence, 0, 0);
+        if ((status != GL_ALREADY_SIGNALED) && (status != GL_CONDITION_SATISFIED)) return false;
+    }
+    glDeleteSync(m_readbackFence);
+    m_readbackFence = nullptr;
+
+    const int left = m_readbackInFlight.left;
+    const int top = m_readbackInFlight.top;
+    const int rows = m_readbackInFlight.bottom - top;
+    const GLintptr offset = top * vramWidth * sizeof(uint16_t);
+    const GLsizeiptr size = rows * vramWidth * sizeof(uint16_t);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_readbackBuffer);
+    const auto data =
+        static_cast<const uint16_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, offset, size, GL_MAP_READ_BIT));
+    if (data) {
+        for (int line = 0; line < rows; line++) {
+            memcpy(m_vramShadow.data() + (top + line) * vramWidth + left, data + line * vramWidth + left,
+                   (m_readbackInFlight.right - left) * sizeof(uint16_t));
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        // Try again with the next readback
+        m_readbackRect.add(left, top, m_readbackInFlight.right - left, rows);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_readbackInFlight.clear();
+    return true;
+}
+
+// Reading the whole VRAM back from the GPU for each VRAM to CPU transfer would stall the pipeline for 1MB at a
+// time, so only the part of it that changed on the GPU since the last read gets read back into the shadow copy.
+// This goes through the pixel buffer, which the end of the frame usually already filled. Only what got drawn since
+// then needs waiting on, since the guest is about to look at it.
+PCSX::Slice PCSX::OpenGL_GPU::getVRAM(Ownership ownership) {
+    m_readbackFramesLeft = c_snapshotFrames;
+    finishReadback(true);
+    startReadback();
+    finishReadback(true);
 
     Slice slice;
-    slice.acquire(pixels, texSize);
+    if (ownership == Ownership::BORROW) {
+        slice.borrow(m_vramShadow.data(), vramWidth * vramHeight * sizeof(uint16_t));
+    } else {
+        slice.copy(m_vramShadow.data(), vramWidth * vramHeight * sizeof(uint16_t));
+    }
     return slice;
 }
 
+PCSX::Slice PCSX::OpenGL_GPU::getVRAMSnapshot() {
+    m_snapshotFramesLeft = c_snapshotFrames;
+    // Oldest first, so that a newer readback never gets overwritten by an older one
+    for (unsigned i = 0; i < 2; i++) {
+        const unsigned index = m_snapshotIndex ^ i;
+        if (m_snapshotFences[index] && !collectSnapshot(index)) break;
+    }
+    // Nothing got captured yet, so the very first snapshot has to wait
+    if (!m_snapshotValid) {
+        auto vram = getVRAM(Ownership::BORROW);
+        memcpy(m_snapshot.data(), vram.data(), vram.size());
+        m_snapshotValid = true;
+    }
+
+    Slice slice;
+    slice.borrow(m_snapshot.data(), vramWidth * vramHeight * sizeof(uint16_t));
+    return slice;
+}
+
+PCSX::GPU::ScreenShot PCSX::OpenGL_GPU::takeScreenShot() {
+    const Slice vram = getVRAMSnapshot();
+    const auto bytes = vram.data<uint8_t>();
+    const int startX = m_display.start.x();
+    const int startY = m_display.start.y();
+    const int width = std::clamp(m_display.size.x(), 0, vramWidth - startX);
+    const int height = std::clamp(m_display.size.y(), 0, vramHeight - startY);
+    const bool rgb24 = m_display.info.depth == CtrlDisplayMode::CD_24BITS;
+
+    ScreenShot ss;
+    ss.width = width;
+    ss.height = height;
+    ss.bpp = rgb24 ? ScreenShot::BPP_24 : ScreenShot::BPP_16;
+    const unsigned lineSize = width * (rgb24 ? 3 : 2);
+    char *pixels = reinterpret_cast<char *>(calloc(lineSize * height, 1));
+    ss.data.acquire(pixels, lineSize * height);
+    for (int i = 0; i < height; i++) {
+        // 24-bit lines are longer than the display width in VRAM pixels, but can't go past the end of the line
+        const unsigned offset = ((startY + i) * vramWidth + startX) * sizeof(uint16_t);
+        const unsigned available = (vramWidth - startX) * sizeof(uint16_t);
+        memcpy(pixels, bytes + offset, std::min(lineSize, available));
+        pixels += lineSize;
+    }
+
+    return ss;
+}
+
+uint64_t PCSX::OpenGL_GPU::hashDisplay() {
+    if (!m_display.enabled) return 0;
+    // Only what got drawn to since the last readback comes back from the GPU
+    const Slice vram = getVRAM();
+    return hashVRAMArea(vram.data<uint8_t>(), m_display.start.x(), m_display.start.y(), m_display.size.x(),
+                        m_display.size.y(), m_display.info.depth == CtrlDisplayMode::CD_24BITS);
+}
+
 void PCSX::OpenGL_GPU::partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels,
                                          PartialUpdateVram updateType) {
     renderBatch();
+    markVRAMDirty(x, y, w, h);
+    // A readback in flight predates this upload, so it has to land in the shadow copy first
+    DirtyRect upload;
+    upload.add(x, y, w, h);
+    if ((upload.left < m_readbackInFlight.right) && (m_readbackInFlight.left < upload.right) &&
+        (upload.top < m_readbackInFlight.bottom) && (m_readbackInFlight.top < upload.bottom)) {
+        finishReadback(true);
+    }
+    for (int line = 0; line < h; line++) {
+        memcpy(m_vramShadow.data() + (y + line) * vramWidth + x, pixels + line * w, w * sizeof(uint16_t));
+    }
+    invalidatePageCache(x, y, w, h);
 
     OpenGL::bindScreenFramebuffer();
     const auto oldTex = updateType == PartialUpdateVram::Asynchronous ? OpenGL::getTex2D() : GLint(-1);
-    m_vramTexture.bind();
+    m_sampleTexture.bind();
 
     glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, pixels);
 
     if (updateType == PartialUpdateVram::Asynchronous) glBindTexture(GL_TEXTURE_2D, oldTex);
+
+    // The pixels land in the native copy, and get scaled up from there into the draw target. Multisampled
+    // framebuffers can't be blitted into with scaling, so these go through the resolved copy first.
+    const int s = m_scale;
+    const auto oldScissor = OpenGL::scissorEnabled();
+    OpenGL::disableScissor();
+    m_sampleFBO.bind(OpenGL::ReadFramebuffer);
+    if (m_multisampled) {
+        m_fboNoMSAA.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(x, y, x + w, y + h, x * s, y * s, (x + w) * s, (y + h) * s, GL_COLOR_BUFFER_BIT,
+                          GL_NEAREST);
+        m_fboNoMSAA.bind(OpenGL::ReadFramebuffer);
+        m_fbo.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(x * s, y * s, (x + w) * s, (y + h) * s, x * s, y * s, (x + w) * s, (y + h) * s,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    } else {
+        m_fbo.bind(OpenGL::DrawFramebuffer);
+        glBlitFramebuffer(x, y, x + w, y + h, x * s, y * s, (x + w) * s, (y + h) * s, GL_COLOR_BUFFER_BIT,
+                          GL_NEAREST);
+    }
+    if (oldScissor) OpenGL::enableScissor();
     m_fbo.bind(OpenGL::DrawAndReadFramebuffer);
 
     m_syncVRAM = true;
@@ -692,17 +1295,9 @@ void PCSX::OpenGL_GPU::partialUpdateVRAM(int x, int y, int w, int h, const uint1
 
 template <PCSX::OpenGL_GPU::Transparency setting>
 void PCSX::OpenGL_GPU::setTransparency() {
-    // Check if we had transparency previously disabled and it just got enabled or vice versa
     if (m_lastTransparency != setting) {
-        renderBatch();
-        if constexpr (setting == Transparency::Opaque) {
-            m_lastBlendingMode = -1;
-            OpenGL::disableBlend();
-        } else {
-            OpenGL::enableBlend();
-        }
-
         m_lastTransparency = setting;
+        updateVertexBlend();
     }
 }
 
@@ -710,27 +1305,25 @@ void PCSX::OpenGL_GPU::setBlendingModeFromTexpage(uint32_t texpage) {
     const auto newBlendingMode = (texpage >> 5) & 3;
 
     if (m_lastBlendingMode != newBlendingMode) {
-        renderBatch();  // This must be executed before we set the new blend mode
         m_lastBlendingMode = newBlendingMode;
-        OpenGL::setBlendFactor(GL_SRC1_COLOR, GL_SRC1_ALPHA, GL_ONE, GL_ZERO);
+        updateVertexBlend();
+    }
+}
 
-        switch (newBlendingMode) {
-            case 0:  // B/2 + F/2
-                OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
-                setBlendFactors(0.5, 0.5);
-                break;
-            case 1:  // B + F
-                OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
-                setBlendFactors(1.0, 1.0);
-                break;
-            case 2:  // B - F. We special handle this in the renderBatch() function
-                break;
-            case 3:  // B + F/4
-                OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
-                setBlendFactors(0.25, 1.0);
-                break;
-        }
+// The factors of the 3 additive modes are picked by the vertex shader out of the texpage attribute, so only going
+// from or to subtractive blending needs to end the batch. B - F is special handled in the renderBatch() function
+void PCSX::OpenGL_GPU::updateVertexBlend() {
+    if (m_lastTransparency == Transparency::Opaque) {
+        m_vertexBlend = 0;
+        return;
+    }
+
+    const bool subtractive = m_lastBlendingMode == 2;
+    if (m_subtractiveBatch != subtractive) {
+        renderBatch();  // This must be executed before we set the new blend mode
+        m_subtractiveBatch = subtractive;
     }
+    m_vertexBlend = Vertex::c_semiTransparentTexpage | (m_lastBlendingMode << 5);
 }
 
 void PCSX::OpenGL_GPU::setBlendFactors(float sourceFactor, float destFactor) {
@@ -745,14 +1338,16 @@ void PCSX::OpenGL_GPU::setBlendFactors(float sourceFactor, float destFactor) {
 void PCSX::OpenGL_GPU::drawTri(int *x, int *y, uint32_t *colors) {
     maybeRenderBatch<3>();
 
-    m_vertices[m_vertexCount++] = Vertex(x[0], y[0], colors[0]);
-    m_vertices[m_vertexCount++] = Vertex(x[1], y[1], colors[1]);
-    m_vertices[m_vertexCount++] = Vertex(x[2], y[2], colors[2]);
+    m_vertices[m_vertexCount++] = Vertex(x[0], y[0], colors[0], m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x[1], y[1], colors[1], m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x[2], y[2], colors[2], m_vertexBlend);
 }
 
 void PCSX::OpenGL_GPU::drawTriTextured(int *x, int *y, uint32_t *colors, uint16_t clut, uint16_t texpage, unsigned *u,
                                        unsigned *v) {
     maybeRenderBatch<3>();
+    texpage = (texpage & Vertex::c_texpageMask) | m_vertexBlend;
+    if (m_pageCacheEnabled && ((texpage & 0x100) == 0)) usePageCache(texpage, clut);
 
     m_vertices[m_vertexCount++] = Vertex(x[0], y[0], colors[0], clut, texpage, u[0], v[0]);
     m_vertices[m_vertexCount++] = Vertex(x[1], y[1], colors[1], clut, texpage, u[1], v[1]);
@@ -761,18 +1356,19 @@ void PCSX::OpenGL_GPU::drawTriTextured(int *x, int *y, uint32_t *colors, uint16_
 
 void PCSX::OpenGL_GPU::drawRect(int x, int y, int w, int h, uint32_t color) {
     maybeRenderBatch<6>();
-    m_vertices[m_vertexCount++] = Vertex(x, y, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x, y + h, color);
-    m_vertices[m_vertexCount++] = Vertex(x, y, color);
+    m_vertices[m_vertexCount++] = Vertex(x, y, color, m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x + w, y, color, m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color, m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color, m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x, y + h, color, m_vertexBlend);
+    m_vertices[m_vertexCount++] = Vertex(x, y, color, m_vertexBlend);
 }
 
 void PCSX::OpenGL_GPU::drawRectTextured(int x, int y, int w, int h, uint32_t color, uint16_t clut, unsigned u,
                                         unsigned v) {
     maybeRenderBatch<6>();
-    const uint32_t texpage = m_rectTexpage;
+    uint16_t texpage = (m_rectTexpage & Vertex::c_texpageMask) | m_vertexBlend;
+    if (m_pageCacheEnabled && ((texpage & 0x100) == 0)) usePageCache(texpage, clut);
     m_vertices[m_vertexCount++] = Vertex(x, y, color, clut, texpage, u, v);
     m_vertices[m_vertexCount++] = Vertex(x + w, y, color, clut, texpage, u + w, v);
     m_vertices[m_vertexCount++] = Vertex(x + w, y + h, color, clut, texpage, u + w, v + h);
@@ -792,13 +1388,13 @@ void PCSX::OpenGL_GPU::drawLine(int x1, int y1, uint32_t color1, int x2, int y2,
 
     // Both vertices coincide, render 1x1 rectangle with the colour and coords of v1
     if (dx == 0 && dy == 0) {
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1);
+        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1, m_vertexBlend);
 
-        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1 + 1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
+        m_vertices[m_vertexCount++] = Vertex(x1 + 1, y1 + 1, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1, y1 + 1, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1, m_vertexBlend);
     } else {
         int xOffset, yOffset;
         if (absDx > absDy) {  // x-major line
@@ -815,13 +1411,13 @@ void PCSX::OpenGL_GPU::drawLine(int x1, int y1, uint32_t color1, int x2, int y2,
             dy > 0 ? y2++ : y1++;
         }
 
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
-        m_vertices[m_vertexCount++] = Vertex(x2, y2, color2);
-        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2);
+        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x2, y2, color2, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2, m_vertexBlend);
 
-        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2);
-        m_vertices[m_vertexCount++] = Vertex(x1 + xOffset, y1 + yOffset, color1);
-        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1);
+        m_vertices[m_vertexCount++] = Vertex(x2 + xOffset, y2 + yOffset, color2, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1 + xOffset, y1 + yOffset, color1, m_vertexBlend);
+        m_vertices[m_vertexCount++] = Vertex(x1, y1, color1, m_vertexBlend);
     }
 }
 
@@ -899,6 +1495,7 @@ void PCSX::OpenGL_GPU::write0(DrawingOffset *prim) {
 }
 
 void PCSX::OpenGL_GPU::write0(FastFill *prim) {
+    ZoneScoped;
     renderBatch();
     const auto colour = prim->color;
     const float r = float(colour & 0xff) / 255.f;
@@ -906,12 +1503,14 @@ void PCSX::OpenGL_GPU::write0(FastFill *prim) {
     const float b = float((colour >> 16) & 0xff) / 255.f;
 
     OpenGL::setClearColor(r, g, b, 1.f);
-    OpenGL::setScissor(prim->x, prim->y, prim->w, prim->h);
+    OpenGL::setScissor(prim->x * m_scale, prim->y * m_scale, prim->w * m_scale, prim->h * m_scale);
     OpenGL::clearColor();
     setScissorArea();
+    m_dirtyRect.add(prim->x, prim->y, prim->w, prim->h);
 }
 
 void PCSX::OpenGL_GPU::write0(BlitVramVram *prim) {
+    ZoneScoped;
     renderBatch();
     OpenGL::disableScissor();  // We disable scissor testing because it affects glBlitFramebuffer
 
@@ -927,9 +1526,12 @@ void PCSX::OpenGL_GPU::write0(BlitVramVram *prim) {
     width = ((width - 1) & 0x3ff) + 1;
     height = ((height - 1) & 0x1ff) + 1;
 
-    glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, destX, destY, destX + width, destY + height,
-                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    // The copy happens in the upscaled VRAM, so that it doesn't lose its resolution
+    const int s = m_scale;
+    glBlitFramebuffer(srcX * s, srcY * s, (srcX + width) * s, (srcY + height) * s, destX * s, destY * s,
+                      (destX + width) * s, (destY + height) * s, GL_COLOR_BUFFER_BIT, GL_NEAREST);
     OpenGL::enableScissor();
+    m_dirtyRect.add(destX, destY, width, height);
 }
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::Shape shape, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend,
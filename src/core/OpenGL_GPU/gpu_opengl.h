@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 
 #include "core/gpu.h"
@@ -44,6 +47,10 @@ class OpenGL_GPU final : public GPU {
     GLuint getVRAMTexture() override;
     void setLinearFiltering() override;
     Slice getVRAM(Ownership) override;
+    Slice getVRAMSnapshot() override;
+    ScreenShot takeScreenShot() override;
+    uint64_t hashDisplay() override;
+    uint64_t flushCount() override { return m_flushes.load(std::memory_order_relaxed); }
     void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels, PartialUpdateVram) override;
     void restoreStatus(uint32_t status) { m_gpustat = status; }
 
@@ -58,6 +65,14 @@ class OpenGL_GPU final : public GPU {
 
         // We use bit 15 of the texpage attribute (normally unused) to indicate an untextured prim.
         static constexpr uint16_t c_untexturedPrimitiveTexpage = 0x8000;
+        // Bit 14 (also unused) marks the semi-transparent prims, whose blending mode then lives in bits 5-6. This
+        // lets the shaders pick the blending factors themselves, so that a change of mode doesn't end a batch.
+        static constexpr uint16_t c_semiTransparentTexpage = 0x4000;
+        // What the vertices keep from the texpage: the texpage base and the texture depth.
+        static constexpr uint16_t c_texpageMask = 0x19f;
+        // Bit 13 marks paletted textures read from the page cache, in which case the clut attribute holds the
+        // layer of the cache instead.
+        static constexpr uint16_t c_cachedTexpage = 0x2000;
 
         Vertex() : Vertex(0, 0, 0) {}
 
@@ -68,6 +83,10 @@ class OpenGL_GPU final : public GPU {
             texpage = c_untexturedPrimitiveTexpage;
         }
 
+        Vertex(int x, int y, uint32_t col, uint16_t blend) : Vertex(x, y, col) {
+            texpage = c_untexturedPrimitiveTexpage | blend;
+        }
+
         Vertex(int x, int y, uint32_t col, uint16_t clut, uint16_t texpage, unsigned u, unsigned v)
             : colour(col), clut(clut), texpage(texpage) {
             positions.x() = x;
@@ -86,7 +105,10 @@ class OpenGL_GPU final : public GPU {
 
     static constexpr int vramWidth = 1024;
     static constexpr int vramHeight = 512;
-    static constexpr int vertexBufferSize = 0x100000;
+    // The size of one segment of the vertex buffer. When the buffer can be persistently mapped, there are
+    // c_vertexSegments of them, used in turn, and the CPU only waits on a segment it wraps around to.
+    static constexpr int vertexBufferSize = 0x40000;
+    static constexpr int c_vertexSegments = 3;
 
     OpenGL::Program m_program;
     OpenGL::VertexArray m_vao;
@@ -100,15 +122,98 @@ class OpenGL_GPU final : public GPU {
     OpenGL::Framebuffer m_fboNoMSAA;
     Widgets::ShaderEditor m_shaderEditor = {"hw-renderer"};
 
-    // For CPU->VRAM texture transfers
+    // The VRAM at its native resolution, which the shaders sample textures from, and which CPU<->VRAM transfers
+    // go through. When upscaling, the draw target above is m_scale times larger than this.
     OpenGL::Texture m_sampleTexture;
+    OpenGL::Framebuffer m_sampleFBO;
+    int m_scale = 1;
+
+    // The part of the draw target that changed since m_sampleTexture was last brought up to date, in native
+    // coordinates. Only this part gets resolved back, instead of the whole of the upscaled VRAM.
+    struct DirtyRect {
+        int left = 0, top = 0, right = 0, bottom = 0;
+        bool empty() const { return (left >= right) || (top >= bottom); }
+        void clear() { left = top = right = bottom = 0; }
+        void add(int x, int y, int w, int h) {
+            const int r = std::min(x + w, vramWidth);
+            const int b = std::min(y + h, vramHeight);
+            x = std::max(x, 0);
+            y = std::max(y, 0);
+            if ((x >= r) || (y >= b)) return;
+            if (empty()) {
+                left = x;
+                top = y;
+                right = r;
+                bottom = b;
+            } else {
+                left = std::min(left, x);
+                top = std::min(top, y);
+                right = std::max(right, r);
+                bottom = std::max(bottom, b);
+            }
+        }
+    };
+    DirtyRect m_dirtyRect;
+
+    // A CPU copy of m_sampleTexture, for getVRAM. Uploads get written into it directly, and m_readbackRect is the
+    // part that got synced from the draw target since the last read, which is all that needs to be read back.
+    std::vector<uint16_t> m_vramShadow;
+    DirtyRect m_readbackRect;
+    // Games reading the VRAM back tend to do it frame after frame, so once one did, what changed gets read back
+    // at the end of each frame into a pixel buffer, which the next read only has to copy out of.
+    GLuint m_readbackBuffer = 0;
+    GLsync m_readbackFence = nullptr;
+    DirtyRect m_readbackInFlight;
+    unsigned m_readbackFramesLeft = 0;
+
+    // For getVRAMSnapshot: while snapshots are being asked for, the VRAM gets read back at the end of each frame
+    // into one of two pixel buffers in turn, and copied out once its fence says the GPU is done with it.
+    static constexpr unsigned c_snapshotFrames = 60;
+    OpenGL::Texture m_snapshotTexture;
+    OpenGL::Framebuffer m_snapshotFBO;
+    std::array<GLuint, 2> m_snapshotBuffers = {};
+    std::array<GLsync, 2> m_snapshotFences = {};
+    unsigned m_snapshotIndex = 0;
+    unsigned m_snapshotFramesLeft = 0;
+    std::vector<uint16_t> m_snapshot;
+    bool m_snapshotValid = false;
+
+    // Decoded 4 and 8-bit texture pages, so that the shaders do a single fetch per texel instead of two dependent
+    // ones. Each layer holds a whole page, decoded through a given CLUT. Entries get decoded right before the batch
+    // using them is drawn, and again whenever the part of m_sampleTexture they come from changes under that batch.
+    static constexpr unsigned c_pageCacheLayers = 32;
+    struct PageCacheEntry {
+        uint32_t key;  // The texpage in the upper 16 bits, the CLUT in the lower ones
+        bool decoded;
+        uint64_t batch;  // The last batch using this entry
+    };
+    bool m_pageCacheEnabled = false;
+    GLuint m_pageCacheTexture = 0;
+    OpenGL::Framebuffer m_pageCacheFBO;
+    OpenGL::Program m_pageDecodeProgram;
+    GLint m_pageDecodeTexpageLoc;
+    GLint m_pageDecodeClutLoc;
+    std::vector<PageCacheEntry> m_pageCache;
+    std::unordered_map<uint32_t, unsigned> m_pageCacheLayersByKey;
+    std::vector<unsigned> m_pendingDecodes;
+    unsigned m_lastPageLayer = 0;
+    uint64_t m_batchSerial = 0;
+    // The batches drawn so far, for the GPU counters, which get read from the emulation thread.
+    std::atomic<uint64_t> m_flushes = 0;
 
     // For the 16-bits to 24-bits conversion
     OpenGL::Framebuffer m_fbo24;
     OpenGL::Texture m_vramTexture24;
     Widgets::ShaderEditor m_shaderEditor24 = {"16-to-24"};
 
-    std::vector<Vertex> m_vertices;
+    // Points either in the mapped segment currently being filled, or in m_vertexStorage when the driver can't
+    // map buffers persistently, in which case the vertices get uploaded by each batch.
+    Vertex *m_vertices = nullptr;
+    Vertex *m_mappedVertices = nullptr;
+    std::vector<Vertex> m_vertexStorage;
+    std::array<GLsync, c_vertexSegments> m_segmentFences = {};
+    bool m_persistentVertices = false;
+    int m_segment = 0;
     OpenGL::Rect m_scissorBox;
     int m_drawAreaLeft, m_drawAreaRight, m_drawAreaTop, m_drawAreaBottom;
 
@@ -130,6 +235,7 @@ class OpenGL_GPU final : public GPU {
     GLint m_blendFactorsIfOpaqueLoc;
 
     int m_vertexCount = 0;
+    int m_batchStart = 0;  // The first vertex of the segment which hasn't been drawn yet
     bool m_updateDrawOffset = false;
     bool m_syncVRAM = true;
     uint32_t m_rectTexpage = 0;  // Rects have their own texpage settings
@@ -139,9 +245,18 @@ class OpenGL_GPU final : public GPU {
 
     template <int count>
     void maybeRenderBatch() {
-        if ((m_vertexCount + count) >= vertexBufferSize) renderBatch();
+        if ((m_vertexCount + count) >= vertexBufferSize) nextVertexSegment();
     }
     void renderBatch();
+    void syncSampleTexture();
+    void captureSnapshot();
+    void startReadback();
+    bool finishReadback(bool wait);
+    void usePageCache(uint16_t &texpage, uint16_t &clut);
+    void invalidatePageCache(int x, int y, int w, int h);
+    void decodePendingPages();
+    bool collectSnapshot(unsigned index);
+    void nextVertexSegment();
     void clearVRAM(float r, float g, float b, float a = 1.0);
     void updateDrawArea();
     void setScissorArea();
@@ -162,9 +277,13 @@ class OpenGL_GPU final : public GPU {
     // 1: Back + Front
     // 2: Back - Front
     // 3: Back + Front / 4
-    // -1: Transparency was previously disabled
-    int m_lastBlendingMode = -1;
+    int m_lastBlendingMode = 0;
     Transparency m_lastTransparency;
+    // Subtractive blending needs two passes with a different blending equation, so the semi-transparent prims
+    // using it can't share a batch with the ones using the 3 other modes. Opaque prims go along with either.
+    bool m_subtractiveBatch = false;
+    // The texpage bits telling the shaders how to blend the vertices being emitted
+    uint16_t m_vertexBlend = 0;
 
     // We can emulate raw texture primitives as primitives with texture blending enabled
     // And 0x808080 as the blend colour
@@ -180,6 +299,7 @@ class OpenGL_GPU final : public GPU {
     void setTransparency();
 
     void setBlendingModeFromTexpage(uint32_t texpage);
+    void updateVertexBlend();
     void setBlendFactors(float sourceFactor, float destFactor);
 
     void write0(ClearCache *) override;
@@ -19,6 +19,7 @@
 
 #include "core/arguments.h"
 
+#include <algorithm>
 #include <filesystem>
 
 PCSX::Arguments::Arguments(const CommandLine::args& args) {
@@ -27,11 +28,18 @@ PCSX::Arguments::Arguments(const CommandLine::args& args) {
     }
     if (args.get<bool>("stdout") && !args.get<bool>("tui")) m_stdoutEnabled = true;
     if (args.get<bool>("no-ui") || args.get<bool>("cli")) m_stdoutEnabled = true;
+    if (args.get<bool>("no-ui") || args.get<bool>("cli")) m_headless = true;
+    if (m_headless && args.get<bool>("unthrottled")) m_unthrottled = true;
+    auto frameSkip = args.get<int>("frameskip");
+    if (frameSkip.has_value()) m_frameSkip = std::max(frameSkip.value(), 0);
+    if (args.get<bool>("nullgpu")) m_nullGPU = true;
     if (args.get<bool>("testmode") || args.get<bool>("no-gui-log")) m_guiLogsEnabled = false;
     if (args.get<bool>("testmode")) m_testModeEnabled = true;
     if (args.get<bool>("portable")) m_portable = true;
     auto portablePath = args.get<std::string_view>("portable");
     if (portablePath.has_value()) m_portablePath = portablePath.value();
+    auto audioDumpPath = args.get<std::string_view>("audiodump");
+    if (audioDumpPath.has_value()) m_audioDumpPath = audioDumpPath.value();
     if (std::filesystem::exists("pcsx.json")) m_portable = true;
     if (std::filesystem::exists(std::filesystem::path("vsprojects") / "pcsx-redux.sln")) m_portable = true;
     if (std::filesystem::exists(std::filesystem::path("..") / "pcsx-redux.sln")) m_portable = true;
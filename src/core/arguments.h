@@ -48,6 +48,10 @@ class Arguments {
     // Disabled with -testmode or -no-gui-log.
     bool isGUILogsEnabled() const { return m_guiLogsEnabled; }
 
+    // Returns true if there's no GUI, and thus no OpenGL context.
+    // Enabled with the flags -no-ui or -cli.
+    bool isHeadless() const { return m_headless; }
+
     // Returns true if the the flag -testmode was used.
     bool isTestModeEnabled() const { return m_testModeEnabled; }
 
@@ -81,10 +85,34 @@ class Arguments {
     // Set with the flag -portable.
     std::string_view getPortablePath() const { return m_portablePath; }
 
+    // Returns the path of the WAV file to dump the audio output into, instead of
+    // playing it, without the emulation being throttled, or an empty string.
+    // Set with the flag -audiodump.
+    std::string_view getAudioDumpPath() const { return m_audioDumpPath; }
+
+    // Returns true if a headless emulator should run as fast as it can, instead of following the audio. The
+    // audio then gets thrown away, unless it's being dumped.
+    // Enabled with the flag -unthrottled, along with -no-ui or -cli.
+    bool isUnthrottled() const { return m_unthrottled; }
+
+    // Returns how many frames not to draw to the screen, out of each this many plus one.
+    // Set with the flag -frameskip.
+    unsigned getFrameSkip() const { return m_frameSkip; }
+
+    // Returns true if the GPU should only keep track of its state and of the VRAM transfers, without
+    // drawing anything, nor displaying anything.
+    // Enabled with the flag -nullgpu.
+    bool isNullGPU() const { return m_nullGPU; }
+
   private:
     std::string m_portablePath = "";
+    std::string m_audioDumpPath = "";
     bool m_luaStdoutEnabled = false;
     bool m_stdoutEnabled = false;
+    bool m_headless = false;
+    bool m_unthrottled = false;
+    unsigned m_frameSkip = 0;
+    bool m_nullGPU = false;
     bool m_guiLogsEnabled = true;
     bool m_testModeEnabled = false;
     bool m_portable = false;
@@ -0,0 +1,389 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/bpcondition.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+namespace {
+
+const char* const c_registerNames[32] = {"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2",
+                                         "t3",   "t4", "t5", "t6", "t7", "s0", "s1", "s2", "s3", "s4", "s5",
+                                         "s6",   "s7", "t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra"};
+
+}  // namespace
+
+class PCSX::BreakpointCondition::Parser {
+  public:
+    Parser(std::string_view str, std::vector<Instruction>& program) : m_str(str), m_program(program) {}
+
+    bool parse(std::string& error) {
+        parseOr();
+        skipSpaces();
+        if (m_error.empty() && (m_pos != m_str.size())) fail("unexpected character");
+        if (m_error.empty() && (m_maxDepth > c_maxDepth)) m_error = "expression is too complex";
+        error = m_error;
+        return m_error.empty();
+    }
+
+  private:
+    struct BinaryOperator {
+        const char* token;
+        Op op;
+    };
+
+    void fail(const char* what) {
+        if (m_error.empty()) m_error = fmt::format("{} at position {}", what, m_pos);
+    }
+    void skipSpaces() {
+        while ((m_pos < m_str.size()) && isspace(static_cast<unsigned char>(m_str[m_pos]))) m_pos++;
+    }
+    bool accept(std::string_view token) {
+        skipSpaces();
+        if (m_str.substr(m_pos, token.size()) != token) return false;
+        m_pos += token.size();
+        return true;
+    }
+    void emit(Op op, int64_t value, int depthChange) {
+        m_program.push_back({op, value});
+        m_depth += depthChange;
+        m_maxDepth = std::max(m_maxDepth, m_depth);
+    }
+
+    // Each level goes through its operators in order, so the longer tokens need to come first
+    template <size_t N>
+    void parseLevel(void (Parser::*next)(), const BinaryOperator (&operators)[N]) {
+        (this->*next)();
+        while (m_error.empty()) {
+            const BinaryOperator* found = nullptr;
+            for (auto& o : operators) {
+                if (isPrefixOfLonger(o.token)) continue;
+                if (accept(o.token)) {
+                    found = &o;
+                    break;
+                }
+            }
+            if (!found) return;
+            (this->*next)();
+            emit(found->op, 0, -1);
+        }
+    }
+    // Keeps "&" from eating the first half of "&&", and "<" the first half of "<<" or "<="
+    bool isPrefixOfLonger(std::string_view token) {
+        skipSpaces();
+        if (m_str.substr(m_pos, token.size()) != token) return false;
+        static const char* const c_longer[] = {"||", "&&", "==", "!=", "<=", ">=", "<<", ">>"};
+        for (auto longer : c_longer) {
+            std::string_view l = longer;
+            if ((l.size() > token.size()) && l.starts_with(token) && (m_str.substr(m_pos, l.size()) == l)) return true;
+        }
+        return false;
+    }
+
+    void parseOr() {
+        static const BinaryOperator c_operators[] = {{"||", Op::LogicalOr}};
+        parseLevel(&Parser::parseAnd, c_operators);
+    }
+    void parseAnd() {
+        static const BinaryOperator c_operators[] = {{"&&", Op::LogicalAnd}};
+        parseLevel(&Parser::parseComparison, c_operators);
+    }
+    void parseComparison() {
+        static const BinaryOperator c_operators[] = {
+            {"==", Op::Equal},     {"!=", Op::NotEqual}, {"<=", Op::LessEqual},
+            {">=", Op::GreaterEqual}, {"<", Op::Less},      {">", Op::Greater},
+        };
+        parseLevel(&Parser::parseBitOr, c_operators);
+    }
+    void parseBitOr() {
+        static const BinaryOperator c_operators[] = {{"|", Op::BitOr}};
+        parseLevel(&Parser::parseBitXor, c_operators);
+    }
+    void parseBitXor() {
+        static const BinaryOperator c_operators[] = {{"^", Op::BitXor}};
+        parseLevel(&Parser::parseBitAnd, c_operators);
+    }
+    void parseBitAnd() {
+        static const BinaryOperator c_operators[] = {{"&", Op::BitAnd}};
+        parseLevel(&Parser::parseShift, c_operators);
+    }
+    void parseShift() {
+        static const BinaryOperator c_operators[] = {{"<<", Op::ShiftLeft}, {">>", Op::ShiftRight}};
+        parseLevel(&Parser::parseSum, c_operators);
+    }
+    void parseSum() {
+        static const BinaryOperator c_operators[] = {{"+", Op::Add}, {"-", Op::Subtract}};
+        parseLevel(&Parser::parseProduct, c_operators);
+    }
+    void parseProduct() {
+        static const BinaryOperator c_operators[] = {{"*", Op::Multiply}, {"/", Op::Divide}, {"%", Op::Modulo}};
+        parseLevel(&Parser::parseUnary, c_operators);
+    }
+    void parseUnary() {
+        if (isPrefixOfLonger("!")) {
+            // "!=" can't start an operand
+            fail("unexpected operator");
+        } else if (accept("!")) {
+            parseUnary();
+            emit(Op::Not, 0, 0);
+        } else if (accept("-")) {
+            parseUnary();
+            emit(Op::Negate, 0, 0);
+        } else if (accept("~")) {
+            parseUnary();
+            emit(Op::Complement, 0, 0);
+        } else {
+            parsePrimary();
+        }
+    }
+    void parsePrimary() {
+        skipSpaces();
+        if (m_pos == m_str.size()) {
+            fail("unexpected end of expression");
+            return;
+        }
+        if (accept("(")) {
+            parseOr();
+            if (!accept(")")) fail("expected )");
+            return;
+        }
+        char c = m_str[m_pos];
+        if (isdigit(static_cast<unsigned char>(c))) {
+            parseNumber();
+            return;
+        }
+        if (!isalpha(static_cast<unsigned char>(c))) {
+            fail("unexpected character");
+            return;
+        }
+        size_t start = m_pos;
+        while ((m_pos < m_str.size()) && isalnum(static_cast<unsigned char>(m_str[m_pos]))) m_pos++;
+        std::string_view word = m_str.substr(start, m_pos - start);
+
+        static const std::pair<std::string_view, Op> c_loads[] = {
+            {"u8", Op::LoadU8}, {"u16", Op::LoadU16}, {"u32", Op::LoadU32}, {"s8", Op::LoadS8}, {"s16", Op::LoadS16},
+        };
+        for (auto& [name, op] : c_loads) {
+            if (word != name) continue;
+            if (!accept("[")) {
+                // s8 is a register too
+                if (word == "s8") break;
+                fail("expected [");
+                return;
+            }
+            parseOr();
+            if (!accept("]")) fail("expected ]");
+            emit(op, 0, 0);
+            return;
+        }
+        if (word == "pc") return emit(Op::PC, 0, 1);
+        if (word == "lo") return emit(Op::Register, 32, 1);
+        if (word == "hi") return emit(Op::Register, 33, 1);
+        if (word == "address") return emit(Op::Address, 0, 1);
+        if (word == "width") return emit(Op::Width, 0, 1);
+        if (word == "hits") return emit(Op::Hits, 0, 1);
+        if (word == "s8") return emit(Op::Register, 30, 1);
+        for (unsigned i = 0; i < 32; i++) {
+            if ((word == c_registerNames[i]) || (word == fmt::format("r{}", i))) return emit(Op::Register, i, 1);
+        }
+        m_pos = start;
+        fail("unknown name");
+    }
+    void parseNumber() {
+        int base = 10;
+        if ((m_str.substr(m_pos, 2) == "0x") || (m_str.substr(m_pos, 2) == "0X")) {
+            base = 16;
+            m_pos += 2;
+        }
+        uint64_t value = 0;
+        size_t start = m_pos;
+        while (m_pos < m_str.size()) {
+            char c = tolower(static_cast<unsigned char>(m_str[m_pos]));
+            int digit;
+            if ((c >= '0') && (c <= '9')) {
+                digit = c - '0';
+            } else if ((base == 16) && (c >= 'a') && (c <= 'f')) {
+                digit = c - 'a' + 10;
+            } else {
+                break;
+            }
+            value = value * base + digit;
+            if (value > 0xffffffffull) {
+                fail("number is too large");
+                return;
+            }
+            m_pos++;
+        }
+        if (m_pos == start) {
+            fail("expected a number");
+            return;
+        }
+        if ((m_pos < m_str.size()) && isalnum(static_cast<unsigned char>(m_str[m_pos]))) {
+            fail("unexpected character");
+            return;
+        }
+        emit(Op::Push, int64_t(value), 1);
+    }
+
+    std::string_view m_str;
+    std::vector<Instruction>& m_program;
+    size_t m_pos = 0;
+    int m_depth = 0;
+    int m_maxDepth = 0;
+    std::string m_error;
+};
+
+std::unique_ptr<PCSX::BreakpointCondition> PCSX::BreakpointCondition::compile(std::string_view expression,
+                                                                              std::string& error) {
+    std::unique_ptr<BreakpointCondition> condition(new BreakpointCondition());
+    condition->m_expression = expression;
+    Parser parser(expression, condition->m_program);
+    if (!parser.parse(error)) return nullptr;
+    return condition;
+}
+
+bool PCSX::BreakpointCondition::evaluate(const Context& context) const {
+    int64_t stack[c_maxDepth];
+    unsigned sp = 0;
+    auto load = [&context](int64_t address, unsigned size) -> uint32_t {
+        if (!context.memory) return 0;
+        uint32_t value = 0;
+        for (unsigned i = 0; i < size; i++) {
+            // Each byte on its own, as an access can straddle two mappings
+            const uint8_t* ptr = context.memory(uint32_t(address) + i);
+            if (!ptr) return 0;
+            value |= uint32_t(*ptr) << (i * 8);
+        }
+        return value;
+    };
+    for (auto& instruction : m_program) {
+        switch (instruction.op) {
+            case Op::Push:
+                stack[sp++] = instruction.value;
+                continue;
+            case Op::Register:
+                stack[sp++] = context.registers[instruction.value];
+                continue;
+            case Op::PC:
+                stack[sp++] = context.pc;
+                continue;
+            case Op::Address:
+                stack[sp++] = context.address;
+                continue;
+            case Op::Width:
+                stack[sp++] = context.width;
+                continue;
+            case Op::Hits:
+                stack[sp++] = int64_t(context.hits);
+                continue;
+            case Op::LoadU8:
+                stack[sp - 1] = load(stack[sp - 1], 1);
+                continue;
+            case Op::LoadU16:
+                stack[sp - 1] = load(stack[sp - 1], 2);
+                continue;
+            case Op::LoadU32:
+                stack[sp - 1] = load(stack[sp - 1], 4);
+                continue;
+            case Op::LoadS8:
+                stack[sp - 1] = int8_t(load(stack[sp - 1], 1));
+                continue;
+            case Op::LoadS16:
+                stack[sp - 1] = int16_t(load(stack[sp - 1], 2));
+                continue;
+            case Op::Not:
+                stack[sp - 1] = !stack[sp - 1];
+                continue;
+            case Op::Negate:
+                stack[sp - 1] = -stack[sp - 1];
+                continue;
+            case Op::Complement:
+                stack[sp - 1] = ~stack[sp - 1];
+                continue;
+            default:
+                break;
+        }
+        const int64_t b = stack[--sp];
+        int64_t& a = stack[sp - 1];
+        switch (instruction.op) {
+            case Op::Multiply:
+                a = int64_t(uint64_t(a) * uint64_t(b));
+                break;
+            case Op::Divide:
+                a = ((b == 0) || ((b == -1) && (a == INT64_MIN))) ? 0 : a / b;
+                break;
+            case Op::Modulo:
+                a = ((b == 0) || (b == -1)) ? 0 : a % b;
+                break;
+            case Op::Add:
+                a = int64_t(uint64_t(a) + uint64_t(b));
+                break;
+            case Op::Subtract:
+                a = int64_t(uint64_t(a) - uint64_t(b));
+                break;
+            case Op::ShiftLeft:
+                a = int64_t(uint64_t(a) << (b & 63));
+                break;
+            case Op::ShiftRight:
+                a >>= (b & 63);
+                break;
+            case Op::BitAnd:
+                a &= b;
+                break;
+            case Op::BitXor:
+                a ^= b;
+                break;
+            case Op::BitOr:
+                a |= b;
+                break;
+            case Op::Equal:
+                a = a == b;
+                break;
+            case Op::NotEqual:
+                a = a != b;
+                break;
+            case Op::Less:
+                a = a < b;
+                break;
+            case Op::LessEqual:
+                a = a <= b;
+                break;
+            case Op::Greater:
+                a = a > b;
+                break;
+            case Op::GreaterEqual:
+                a = a >= b;
+                break;
+            case Op::LogicalAnd:
+                a = a && b;
+                break;
+            case Op::LogicalOr:
+                a = a || b;
+                break;
+            default:
+                break;
+        }
+    }
+    return (sp != 0) && (stack[sp - 1] != 0);
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PCSX {
+
+// A condition attached to a breakpoint, so that what the breakpoint does, such as calling into Lua, only happens
+// when the condition holds. The expression gets parsed once into a small postfix program, which then runs at
+// every hit, without allocating anything, so that a breakpoint on hot code or data stays cheap until it fires.
+//
+// Expressions are C-like, over 64 bits signed integers:
+//   - numbers, in decimal, or in hex with 0x
+//   - registers: r0 to r31 or their names (zero, at, v0, ... ra), as well as pc, hi and lo
+//   - address and width: which address was accessed, and the size of the access
+//   - hits: how many times the breakpoint was hit, this one included
+//   - memory: u8[...], u16[...], u32[...], s8[...] and s16[...]; only RAM, the BIOS and the scratchpad can
+//     be looked at this way, everything else reads as 0, so that a condition never has side effects
+//   - operators, from the loosest to the tightest: ||, &&, == != < <= > >=, |, ^, &, << >>, + -, * / %,
+//     and the unary ! - ~; dividing by zero gives 0
+class BreakpointCondition {
+  public:
+    struct Context {
+        // The 32 general purpose registers, then lo and hi, the way psxGPRRegs has them
+        const uint32_t* registers = nullptr;
+        uint32_t pc = 0;
+        uint32_t address = 0;
+        unsigned width = 0;
+        uint64_t hits = 0;
+        // Where this address lives in the host memory, if it can be read as is
+        const uint8_t* (*memory)(uint32_t address) = nullptr;
+    };
+
+    // Returns nullptr and sets the error if the expression doesn't parse
+    static std::unique_ptr<BreakpointCondition> compile(std::string_view expression, std::string& error);
+    bool evaluate(const Context& context) const;
+    const std::string& expression() const { return m_expression; }
+
+  private:
+    enum class Op : uint8_t {
+        Push,
+        Register,
+        PC,
+        Address,
+        Width,
+        Hits,
+        LoadU8,
+        LoadU16,
+        LoadU32,
+        LoadS8,
+        LoadS16,
+        Not,
+        Negate,
+        Complement,
+        Multiply,
+        Divide,
+        Modulo,
+        Add,
+        Subtract,
+        ShiftLeft,
+        ShiftRight,
+        BitAnd,
+        BitXor,
+        BitOr,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        LogicalAnd,
+        LogicalOr,
+    };
+    struct Instruction {
+        Op op;
+        int64_t value = 0;
+    };
+    static constexpr unsigned c_maxDepth = 32;
+
+    class Parser;
+    std::vector<Instruction> m_program;
+    std::string m_expression;
+};
+
+}  // namespace PCSX
@@ -40,7 +40,37 @@ static void normalLog(const char* format, const Args&... args) {
     PCSX::g_system->log(PCSX::LogClass::SYSTEM, format, args...);
 }
 
-void PCSX::CallStacks::setSP(uint32_t oldSP, uint32_t newSP) {
+void PCSX::CallStacks::subscribe() {
+    if (m_subscribers++ != 0) return;
+    m_stackPool.reserve(c_preallocatedStacks);
+    m_callPool.reserve(c_preallocatedCalls);
+}
+
+void PCSX::CallStacks::unsubscribe() {
+    if (m_subscribers == 0) return;
+    if (--m_subscribers == 0) clear();
+}
+
+void PCSX::CallStacks::destroyCallStack(CallStack* callstack) {
+    while (!callstack->calls.empty()) destroyCall(&*callstack->calls.begin());
+    m_stackPool.destroy(callstack);
+}
+
+void PCSX::CallStacks::destroyAll(ListType& callstacks) {
+    while (!callstacks.empty()) destroyCallStack(&*callstacks.begin());
+}
+
+void PCSX::CallStacks::clear() {
+    ListType todelete;
+    for (auto& callstack : m_callstacks) todelete.push_back(&callstack);
+    destroyAll(todelete);
+    m_current = nullptr;
+    m_currentSP = 0;
+    m_stackPool.clear();
+    m_callPool.clear();
+}
+
+void PCSX::CallStacks::doSetSP(uint32_t oldSP, uint32_t newSP) {
     debugLog("[CSDBG] setSP(0x%08x, 0x%08x)\n", oldSP, newSP);
     m_current = nullptr;
     auto callstack = m_callstacks.find(newSP, TreeType::INTERVAL_SEARCH);
@@ -61,17 +91,17 @@ void PCSX::CallStacks::setSP(uint32_t oldSP, uint32_t newSP) {
         }
         callstack++;
     }
-    todelete.destroyAll();
+    destroyAll(todelete);
 }
 
-void PCSX::CallStacks::offsetSP(uint32_t oldSP, int32_t offset) {
+void PCSX::CallStacks::doOffsetSP(uint32_t oldSP, int32_t offset) {
     uint32_t lowSP = oldSP + offset;
     uint32_t highSP = oldSP;
     m_currentSP = lowSP;
     debugLog("[CSDBG] offsetSP: moving stack from 0x%08x to 0x%08x\n", oldSP, lowSP);
     if (!m_current) {
         debugLog("[CSDBG] offsetSP: no current stack, creating a new one\n");
-        m_current = new CallStack();
+        m_current = createCallStack();
     } else {
         highSP = m_current->getHigh();
         debugLog("[CSDBG] offsetSP: adjusting high pointer to 0x%08x\n", highSP);
@@ -88,7 +118,7 @@ void PCSX::CallStacks::offsetSP(uint32_t oldSP, int32_t offset) {
         todelete.push_back(&*callstacks);
         callstacks++;
     }
-    todelete.destroyAll();
+    destroyAll(todelete);
     m_callstacks.insert(lowSP, highSP, m_current);
     auto& calls = m_current->calls;
     CallStack::Call* maybeShadow = nullptr;
@@ -100,21 +130,21 @@ void PCSX::CallStacks::offsetSP(uint32_t oldSP, int32_t offset) {
         if (maybeShadow) {
             debugLog("[CSDBG] offsetSP: deleting shadow space call to 0x%08x from 0x%08x\n", maybeShadow->ra,
                      maybeShadow->sp);
-            delete maybeShadow;
+            destroyCall(maybeShadow);
             maybeShadow = nullptr;
         }
         if (last->shadow) {
             maybeShadow = &*last;
         } else {
             debugLog("[CSDBG] offsetSP: deleting call to 0x%08x from 0x%08x\n", last->ra, last->sp);
-            delete &*last;
+            destroyCall(&*last);
             m_current->ra = 0;
             m_current->fp = 0;
         }
     }
 }
 
-void PCSX::CallStacks::storeRA(uint32_t sp, uint32_t ra) {
+void PCSX::CallStacks::doStoreRA(uint32_t sp, uint32_t ra) {
     if (!m_current) {
         normalLog("[CS] Got 0x%08x written to 0x%08x, but we don't have a callstack for it.\n", ra, sp);
         return;
@@ -143,10 +173,10 @@ void PCSX::CallStacks::storeRA(uint32_t sp, uint32_t ra) {
     } else {
         debugLog("[CSDBG] storeRA: creating call to 0x%08x from 0x%08x on stack 0x%08x\n", ra, sp, high);
     }
-    m_current->calls.push_back(new CallStack::Call(sp, fp, ra, shadow));
+    m_current->calls.push_back(createCall(sp, fp, ra, shadow));
 }
 
-void PCSX::CallStacks::loadRA(uint32_t sp) {
+void PCSX::CallStacks::doLoadRA(uint32_t sp) {
     if (!m_current) {
         debugLog("[CSDBG] Got a RA load from 0x%08x, but we don't have any active stack.\n", sp);
         return;
@@ -163,9 +193,9 @@ void PCSX::CallStacks::loadRA(uint32_t sp) {
     }
 }
 
-void PCSX::CallStacks::potentialRA(uint32_t ra, uint32_t sp) {
+void PCSX::CallStacks::doPotentialRA(uint32_t ra, uint32_t sp) {
     if (!m_current && m_currentSP) {
-        offsetSP(m_currentSP, 0);
+        doOffsetSP(m_currentSP, 0);
     }
     if (m_current) {
         debugLog("[CSDBG] potentialRA: to 0x%08x\n", ra);
@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include "core/system.h"
+#include "support/arena.h"
 #include "support/eventbus.h"
 #include "support/list.h"
 #include "support/tree.h"
@@ -30,6 +31,10 @@ namespace PCSX {
 
 struct SaveStateWrapper;
 
+// Reconstructs the call stacks of the guest from what the interpreter sees happening to the stack pointer and
+// the return address register. This only happens while something is interested in them: the Callstacks widget,
+// the guest profiler, or Lua. Without any subscriber, the interpreter hooks don't do anything, and whatever got
+// tracked so far is dropped; the stacks are then rebuilt from scratch, as the guest goes, on the next subscription.
 class CallStacks {
   public:
     struct CallStack;
@@ -47,7 +52,6 @@ class CallStacks {
             uint32_t sp, fp, ra;
             bool shadow;
         };
-        ~CallStack() { calls.destroyAll(); }
         ListType calls;
         uint32_t ra = 0, fp = 0;
     };
@@ -56,30 +60,62 @@ class CallStacks {
     const CallStack& getCurrent() { return *m_current; }
     const TreeType& getCallstacks() { return m_callstacks; }
 
+    void subscribe();
+    void unsubscribe();
+    bool tracking() const { return m_subscribers != 0; }
+
     void serialize(SaveStateWrapper*);
     void deserialize(const SaveStateWrapper*);
 
   private:
+    static constexpr size_t c_preallocatedCalls = 1024;
+    static constexpr size_t c_preallocatedStacks = 64;
+
+    CallStack* createCallStack() { return m_stackPool.create(); }
+    CallStack::Call* createCall(uint32_t sp, uint32_t fp, uint32_t ra, bool shadow) {
+        return m_callPool.create(sp, fp, ra, shadow);
+    }
+    void destroyCall(CallStack::Call* call) { m_callPool.destroy(call); }
+    void destroyCallStack(CallStack* callstack);
+    void destroyAll(ListType& callstacks);
+    void clear();
+
+    void doSetSP(uint32_t oldSP, uint32_t newSP);
+    void doOffsetSP(uint32_t oldSP, int32_t offset);
+    void doStoreRA(uint32_t sp, uint32_t ra);
+    void doLoadRA(uint32_t sp);
+    void doPotentialRA(uint32_t ra, uint32_t sp);
+
     TreeType m_callstacks;
     CallStack* m_current = nullptr;
     uint32_t m_currentSP = 0;
+    unsigned m_subscribers = 0;
+
+    Pool<CallStack> m_stackPool{c_preallocatedStacks};
+    Pool<CallStack::Call> m_callPool{c_preallocatedCalls};
 
     EventBus::Listener m_listener;
 
   public:
     CallStacks() : m_listener(g_system->m_eventBus) {
-        m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
-            m_callstacks.clear();
-            m_current = nullptr;
-            m_currentSP = 0;
-        });
+        m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { clear(); });
+    }
+    ~CallStacks() { clear(); }
+    void setSP(uint32_t oldSP, uint32_t newSP) {
+        if (m_subscribers) doSetSP(oldSP, newSP);
+    }
+    void offsetSP(uint32_t oldSP, int32_t offset) {
+        if (m_subscribers) doOffsetSP(oldSP, offset);
+    }
+    void storeRA(uint32_t sp, uint32_t ra) {
+        if (m_subscribers) doStoreRA(sp, ra);
+    }
+    void loadRA(uint32_t sp) {
+        if (m_subscribers) doLoadRA(sp);
+    }
+    void potentialRA(uint32_t ra, uint32_t sp) {
+        if (m_subscribers) doPotentialRA(ra, sp);
     }
-    ~CallStacks() { m_callstacks.destroyAll(); }
-    void setSP(uint32_t oldSP, uint32_t newSP);
-    void offsetSP(uint32_t oldSP, int32_t offset);
-    void storeRA(uint32_t sp, uint32_t ra);
-    void loadRA(uint32_t sp);
-    void potentialRA(uint32_t ra, uint32_t sp);
 };
 
 }  // namespace PCSX
@@ -23,6 +23,7 @@
 
 #include "core/cdrom.h"
 
+#include <algorithm>
 #include <magic_enum_all.hpp>
 
 #include "cdrom/iso9660-reader.h"
@@ -182,10 +183,33 @@ class CDRomImpl : public PCSX::CDRom {
         PCSX::g_emulator->m_cpu->scheduleInterrupt(PCSX::PSXINT_CDRDMA, eCycle);
     }
 
+    // However fast the reads go, the game needs the time to take each sector out of the drive before the next
+    // one replaces it.
+    static constexpr uint32_t c_fastCDMinDelay = 0x2000;
+
+    // Shortens a seek or read delay when the fast CD mode applies, and accounts for the time saved.
+    uint32_t fastCDDelay(uint32_t delay) {
+        if ((m_mode & MODE_STRSND) || !fastCDActive()) return delay;
+        const uint32_t speed =
+            std::min(PCSX::g_emulator->settings.get<PCSX::Emulator::SettingFastCDSpeed>().value, c_maxFastCDSpeed);
+        const uint32_t fast = std::max(delay / speed, c_fastCDMinDelay);
+        if (fast >= delay) return delay;
+        m_fastCDLoadSaved += delay - fast;
+        return fast;
+    }
+
     inline void StopReading() {
         if (m_reading) {
             m_reading = 0;
             PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_CDREAD);
+            if (m_fastCDLoadSaved != 0) {
+                m_fastCDStats.totalSaved += m_fastCDLoadSaved;
+                m_fastCDStats.lastSaved = m_fastCDLoadSaved;
+                m_fastCDStats.lastSectors = m_fastCDLoadSectors;
+                m_fastCDStats.loads++;
+            }
+            m_fastCDLoadSaved = 0;
+            m_fastCDLoadSectors = 0;
         }
         m_statP &= ~(STATUS_READ | STATUS_SEEK);
     }
@@ -357,7 +381,7 @@ class CDRomImpl : public PCSX::CDRom {
         current = time.toLBA();
 
         for (m_curTrack = 1; m_curTrack < m_iso->getTN(); m_curTrack++) {
-            sect = static_cast<int>(m_iso->getTD(m_curTrack + 1).toLBA());
+            sect = static_cast<int>(m_iso->getTrackPosition(m_curTrack).next);
             if (sect - current >= 150) break;
         }
         CDROM_LOG("Find_CurTrack *** %02d %02d\n", m_curTrack, current);
@@ -367,20 +391,18 @@ class CDRomImpl : public PCSX::CDRom {
         unsigned int this_s, start_s, next_s, pregap;
         int relative_s;
 
-        MSF start = m_iso->getTD(m_curTrack);
-        MSF next;
-        if (m_curTrack + 1 <= m_iso->getTN()) {
+        const auto &track = m_iso->getTrackPosition(m_curTrack);
+        if (!track.last) {
             pregap = 150;
-            next = m_iso->getTD(m_curTrack + 1);
+            next_s = track.next;
         } else {
             // last track - cd size
             pregap = 0;
-            next = m_setSectorEnd;
+            next_s = m_setSectorEnd.toLBA();
         }
 
         this_s = time.toLBA();
-        start_s = start.toLBA();
-        next_s = next.toLBA();
+        start_s = track.start;
 
         m_trackChanged = false;
 
@@ -402,6 +424,25 @@ class CDRomImpl : public PCSX::CDRom {
         time.toBCD(m_subq.absolute);
     }
 
+    // Points m_sector to the sector at this time, out of the sectors read last if it's one of them, or else
+    // reading the next few sectors of the track from there.
+    bool readSector(MSF time) {
+        const uint32_t lba = time.toLBA();
+        if ((lba < m_sectorsStart) || (lba - m_sectorsStart >= m_sectorsCount)) {
+            unsigned count = (m_mode & MODE_SPEED) ? c_sectorsBatch : c_sectorsBatch / 2;
+            // past the end of the track, it's audio, or more pregap
+            const auto &track = m_iso->getTrackPosition(m_curTrack);
+            if (!track.last && (track.next > lba)) count = std::min(count, track.next - lba);
+            m_sectorsStart = lba;
+            m_sectorsCount = m_iso->readTrackSectors(time, m_sectors, count);
+            if (m_sectorsCount == 0) return false;
+        }
+        m_sector = &m_sectors[lba - m_sectorsStart];
+        return true;
+    }
+
+    const uint8_t *getSectorData() const { return m_sector ? m_sector->data + 12 : nullptr; }
+
     void readTrack(MSF time) {
         if (m_prev == time) return;
 
@@ -411,11 +452,11 @@ class CDRomImpl : public PCSX::CDRom {
         if (m_iso->getTrackType(m_curTrack) == PCSX::CDRIso::TrackType::CDDA) {
             m_suceeded = false;
         } else {
-            m_suceeded = m_iso->readTrack(time);
+            m_suceeded = readSector(time);
             if (m_suceeded) m_prev = time;
         }
 
-        const PCSX::IEC60908b::Sub *sub = m_iso->getBufferSub();
+        const PCSX::IEC60908b::Sub *sub = (m_sector && m_iso->hasSubchannel(time)) ? &m_sector->sub : nullptr;
         if (sub && m_curTrack == 1) {
             uint16_t calcCRC = PCSX::IEC60908b::subqCRC(sub->Q);
             uint16_t actualCRC = sub->CRC[0];
@@ -536,7 +577,7 @@ class CDRomImpl : public PCSX::CDRom {
             m_trackChanged = true;
         }
 
-        m_iso->readCDDA(m_setSectorPlay, m_transfer);
+        m_iso->streamCDDA(m_setSectorPlay, m_transfer);
         if (!m_irq && !m_stat && (m_mode & (MODE_AUTOPAUSE | MODE_REPORT))) cdrPlayInterrupt_Autopause();
 
         if (!m_play) return;
@@ -872,7 +913,7 @@ class CDRomImpl : public PCSX::CDRom {
                 Rockman X5 = 0.5-4x
                 - fix capcom logo
                 */
-                scheduleCDPlayIRQ(m_seeked == SEEK_DONE ? 0x800 : cdReadTime * 4);
+                scheduleCDPlayIRQ(m_seeked == SEEK_DONE ? 0x800 : fastCDDelay(cdReadTime * 4));
                 m_seeked = SEEK_PENDING;
                 start_rotating = 1;
                 break;
@@ -971,6 +1012,8 @@ class CDRomImpl : public PCSX::CDRom {
                     goto do_CdlPlay;
                 }
 
+                // twice as many sectors go by every second at double speed, so the image is read further ahead
+                m_iso->setReadAheadSpeed((m_mode & MODE_SPEED) ? 2 : 1);
                 m_reading = 1;
                 m_firstSector = 1;
 
@@ -981,7 +1024,7 @@ class CDRomImpl : public PCSX::CDRom {
                 // Crusaders of Might and Magic - update getlocl now
                 // - fixes cutscene speech
                 {
-                    uint8_t *buf = m_iso->getBuffer();
+                    const uint8_t *buf = getSectorData();
                     if (buf != NULL) memcpy(m_transfer, buf, 8);
                 }
 
@@ -1018,7 +1061,7 @@ class CDRomImpl : public PCSX::CDRom {
                     m_statP |= STATUS_READ;
                     m_statP &= ~STATUS_SEEK;
 
-                    scheduleCDReadIRQ((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2);
+                    scheduleCDReadIRQ(fastCDDelay((m_mode & 0x80) ? (cdReadTime) : cdReadTime * 2));
                 }
 
                 m_result[0] = m_statP;
@@ -1105,7 +1148,7 @@ class CDRomImpl : public PCSX::CDRom {
     }
 
     void readInterrupt() final {
-        uint8_t *buf;
+        const uint8_t *buf;
 
         if (!m_reading) return;
 
@@ -1134,7 +1177,7 @@ class CDRomImpl : public PCSX::CDRom {
 
         readTrack(m_setSectorPlay);
 
-        buf = m_iso->getBuffer();
+        buf = getSectorData();
         if (buf == NULL) m_suceeded = false;
 
         if (!m_suceeded) {
@@ -1179,13 +1222,14 @@ class CDRomImpl : public PCSX::CDRom {
         m_setSectorPlay++;
         m_read = 0;
         m_readRescheduled = 0;
+        m_fastCDLoadSectors++;
 
         uint32_t delay = (m_mode & MODE_SPEED) ? (cdReadTime / 2) : cdReadTime;
         if (m_locationChanged) {
-            scheduleCDReadIRQ(delay * 30);
+            scheduleCDReadIRQ(fastCDDelay(delay * 30));
             m_locationChanged = false;
         } else {
-            scheduleCDReadIRQ(delay);
+            scheduleCDReadIRQ(fastCDDelay(delay));
         }
 
         /*
@@ -1470,6 +1514,7 @@ class CDRomImpl : public PCSX::CDRom {
                         .get<PCSX::Emulator::DebugSettings::Debug>()) {
                     PCSX::g_emulator->m_debug->checkDMAwrite(3, madr, cdsize);
                 }
+                PCSX::g_emulator->m_mem->msanCheckDMA(3, madr, cdsize, true);
                 PCSX::g_emulator->m_cpu->Clear(madr, cdsize / 4);
                 // burst vs normal
                 if (chcr == 0x11400100) {
@@ -1517,6 +1562,8 @@ class CDRomImpl : public PCSX::CDRom {
         m_setlocPending = 0;
         m_locationChanged = false;
         m_reading = 0;
+        m_fastCDLoadSaved = 0;
+        m_fastCDLoadSectors = 0;
 
         m_setSectorPlay.reset();
         m_setSectorEnd.reset();
@@ -1668,6 +1715,13 @@ class CDRomImpl : public PCSX::CDRom {
 }  // namespace
 
 PCSX::CDRom *PCSX::CDRom::factory() { return new CDRomImpl; }
+
+bool PCSX::CDRom::fastCDActive() {
+    auto &settings = g_emulator->settings;
+    if (settings.get<Emulator::SettingFastCDSpeed>() <= 1) return false;
+    const auto &exclusions = settings.get<Emulator::SettingFastCDExclusions>().value;
+    return std::find(exclusions.begin(), exclusions.end(), m_cdromId) == exclusions.end();
+}
 void PCSX::CDRom::check() {
     m_cdromId.clear();
     m_cdromLabel.clear();
@@ -52,21 +52,41 @@ class CDRom {
     static CDRom* factory();
     bool isLidOpened() { return m_lidOpenTime < 0 || m_lidOpenTime > (int64_t)time(nullptr); }
     void setLidOpenTime(int64_t time) { m_lidOpenTime = time; }
+    // -1 when opened until further notice, 0 when closed, or the time at which it's going to close.
+    int64_t getLidOpenTime() const { return m_lidOpenTime; }
     void check();
 
     std::shared_ptr<CDRIso> getIso() { return m_iso; }
     void clearIso() {
         m_iso.reset();
+        m_sectorsCount = 0;
         g_system->m_eventBus->signal(Events::IsoMounted{});
     }
     void setIso(CDRIso* iso) {
         m_iso.reset(iso);
+        m_sectorsCount = 0;
         g_system->m_eventBus->signal(Events::IsoMounted{});
     }
 
     const std::string& getCDRomID() { return m_cdromId; }
     const std::string& getCDRomLabel() { return m_cdromLabel; }
 
+    // The fast CD mode shortens the seeks and the data reads, while the commands, their responses and their
+    // interrupts still come in the same order. XA streams keep their pace, as the audio needs it.
+    static constexpr int c_maxFastCDSpeed = 32;
+    // The emulated time the fast CD mode saved, in cycles. A load goes from the first seek or read after the
+    // previous one stopped reading, to the command stopping it.
+    struct FastCDStats {
+        uint64_t totalSaved = 0;
+        uint64_t lastSaved = 0;
+        uint32_t lastSectors = 0;
+        uint32_t loads = 0;
+    };
+    // Whether the fast CD mode applies to the disc in the drive.
+    bool fastCDActive();
+    const FastCDStats& getFastCDStats() const { return m_fastCDStats; }
+    void resetFastCDStats() { m_fastCDStats = {}; }
+
     virtual void reset() = 0;
     virtual void attenuate(int16_t* buf, int samples, int stereo) = 0;
 
@@ -93,6 +113,14 @@ class CDRom {
 
   protected:
     std::shared_ptr<CDRIso> m_iso;
+    // While reading, the data sectors come out of the image a few at a time, and get consumed from here. At double
+    // speed, twice as many are read at once.
+    static constexpr unsigned c_sectorsBatch = 8;
+    CDRIso::Sector m_sectors[c_sectorsBatch];
+    uint32_t m_sectorsStart = 0;
+    unsigned m_sectorsCount = 0;
+    // The last sector the drive read, in m_sectors.
+    const CDRIso::Sector* m_sector = nullptr;
     // savestate stuff starts here
     uint8_t m_reg1Mode;
     uint8_t m_reg2;
@@ -161,6 +189,11 @@ class CDRom {
     // end savestate
     friend SaveStates::SaveState SaveStates::constructSaveState();
 
+    FastCDStats m_fastCDStats;
+    // What the load in progress saved so far.
+    uint64_t m_fastCDLoadSaved = 0;
+    uint32_t m_fastCDLoadSectors = 0;
+
   private:
     friend class Widgets::IsoBrowser;
     std::string m_cdromId;
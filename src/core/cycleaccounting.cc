@@ -0,0 +1,324 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/cycleaccounting.h"
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "fmt/format.h"
+#include "supportpsx/memory.h"
+
+namespace {
+
+// The symbols, keyed by physical address, so that a function counts the same whichever segment it got named in.
+struct PhysicalSymbols {
+    std::map<uint32_t, const std::string*> ram;
+    std::map<uint32_t, const std::string*> bios;
+
+    explicit PhysicalSymbols(const PCSX::CycleAccounting::Symbols& symbols) {
+        for (const auto& [address, name] : symbols) {
+            PCSX::PSXAddress psx(address);
+            if (psx.type == PCSX::PSXAddress::Type::RAM) {
+                ram.emplace(psx.physical & 0x7fffff, &name);
+            } else if (psx.type == PCSX::PSXAddress::Type::ROM) {
+                bios.emplace(psx.physical & 0x7ffff, &name);
+            }
+        }
+    }
+
+    // The symbol this offset is in, if any, along with where it starts.
+    static std::pair<uint32_t, const std::string*> find(const std::map<uint32_t, const std::string*>& symbols,
+                                                        uint32_t offset) {
+        auto symbol = symbols.upper_bound(offset);
+        if (symbol == symbols.begin()) return {0, nullptr};
+        symbol--;
+        return *symbol;
+    }
+};
+
+uint32_t readBCR(unsigned channel) {
+    auto& mem = PCSX::g_emulator->m_mem;
+    switch (channel) {
+        case 0:
+            return mem->getBCR<0>();
+        case 1:
+            return mem->getBCR<1>();
+        case 2:
+            return mem->getBCR<2>();
+        case 3:
+            return mem->getBCR<3>();
+        case 4:
+            return mem->getBCR<4>();
+        case 5:
+            return mem->getBCR<5>();
+        case 6:
+            return mem->getBCR<6>();
+    }
+    return 0;
+}
+
+}  // namespace
+
+uint32_t PCSX::CycleCostModel::memoryCost(uint32_t address, unsigned width, bool write) {
+    PSXAddress psx(address);
+    switch (psx.type) {
+        case PSXAddress::Type::RAM:
+        case PSXAddress::Type::MSAN:
+            return write ? 0 : 4;
+        case PSXAddress::Type::ScratchPad:
+        case PSXAddress::Type::Internal:
+            return 0;
+        case PSXAddress::Type::HardwareRegisters:
+            return write ? 1 : 2;
+        case PSXAddress::Type::ROM:
+        case PSXAddress::Type::EXP1:
+        case PSXAddress::Type::EXP2:
+        case PSXAddress::Type::EXP3:
+            // 8 bits wide buses, with the BIOS's default delays; a word is four accesses back to back.
+            if (write) return 0;
+            return width * 6;
+    }
+    return 0;
+}
+
+uint32_t PCSX::CycleCostModel::fetchCost(uint32_t address) {
+    PSXAddress psx(address);
+    if (psx.segment != PSXAddress::Segment::KSEG1) return 0;
+    switch (psx.type) {
+        case PSXAddress::Type::RAM:
+            return 4;
+        case PSXAddress::Type::ROM:
+            return 24;
+        default:
+            return 0;
+    }
+}
+
+uint32_t PCSX::CycleCostModel::gteCost(uint32_t code) {
+    if ((code >> 26) != 0x12) return 0;
+    if ((code & 0x02000000) == 0) return 0;
+    switch (code & 0x3f) {
+        case 0x01:  // RTPS
+            return 15;
+        case 0x06:  // NCLIP
+            return 8;
+        case 0x0c:  // OP
+            return 6;
+        case 0x10:  // DPCS
+            return 8;
+        case 0x11:  // INTPL
+            return 8;
+        case 0x12:  // MVMVA
+            return 8;
+        case 0x13:  // NCDS
+            return 19;
+        case 0x14:  // CDP
+            return 13;
+        case 0x16:  // NCDT
+            return 44;
+        case 0x1b:  // NCCS
+            return 17;
+        case 0x1c:  // CC
+            return 11;
+        case 0x1e:  // NCS
+            return 14;
+        case 0x20:  // NCT
+            return 30;
+        case 0x28:  // SQR
+            return 5;
+        case 0x29:  // DCPL
+            return 8;
+        case 0x2a:  // DPCT
+            return 17;
+        case 0x2d:  // AVSZ3
+            return 5;
+        case 0x2e:  // AVSZ4
+            return 6;
+        case 0x30:  // RTPT
+            return 23;
+        case 0x3d:  // GPF
+            return 5;
+        case 0x3e:  // GPL
+            return 5;
+        case 0x3f:  // NCCT
+            return 39;
+    }
+    return 0;
+}
+
+uint32_t PCSX::CycleCostModel::dmaCost(uint32_t bcr, uint32_t chcr) {
+    if (chcr & 0x100) return 0;
+    uint32_t blockSize = bcr & 0xffff;
+    switch ((chcr >> 9) & 3) {
+        case 0:
+            return blockSize ? blockSize : 0x10000;
+        case 1:
+            return blockSize * (bcr >> 16);
+        default:
+            return 0;
+    }
+}
+
+void PCSX::CycleAccounting::enable() {
+    if (m_ram.empty()) {
+        m_ram.resize(c_ramWords);
+        m_bios.resize(c_biosWords);
+    }
+    m_blockStart = true;
+    m_enabled = true;
+}
+
+void PCSX::CycleAccounting::clear() {
+    for (auto& counter : m_ram) counter = {};
+    for (auto& counter : m_bios) counter = {};
+    m_totals = {};
+    m_maxCycles = 0;
+    m_blockStart = true;
+}
+
+PCSX::CycleAccounting::Counter* PCSX::CycleAccounting::counter(uint32_t address) {
+    if (m_ram.empty()) return nullptr;
+    PSXAddress psx(address);
+    switch (psx.type) {
+        case PSXAddress::Type::RAM:
+            return &m_ram[(psx.physical & 0x7fffff) >> 2];
+        case PSXAddress::Type::ROM:
+            return &m_bios[(psx.physical & 0x7ffff) >> 2];
+        default:
+            return nullptr;
+    }
+}
+
+void PCSX::CycleAccounting::account(uint32_t pc, uint32_t code, const uint32_t* gpr) {
+    record(pc, CycleCostModel::cost(pc, code, gpr, readBCR));
+}
+
+void PCSX::CycleAccounting::record(uint32_t pc, const CycleCost& cost) {
+    m_totals.instructions++;
+    m_totals.base += cost.base;
+    m_totals.memory += cost.memory;
+    m_totals.gte += cost.gte;
+    m_totals.dma += cost.dma;
+    Counter* c = counter(pc);
+    if (c) {
+        c->cycles += cost.total();
+        c->executions++;
+        if (m_blockStart) c->leader = true;
+        m_maxCycles = std::max(m_maxCycles, c->cycles);
+    }
+    m_blockStart = false;
+}
+
+uint64_t PCSX::CycleAccounting::cycles(uint32_t address) const {
+    auto c = counter(address);
+    return c ? c->cycles : 0;
+}
+
+uint64_t PCSX::CycleAccounting::executions(uint32_t address) const {
+    auto c = counter(address);
+    return c ? c->executions : 0;
+}
+
+template <typename Callback>
+void PCSX::CycleAccounting::forEachCounter(Callback&& callback) const {
+    for (uint32_t i = 0; i < m_ram.size(); i++) {
+        if (m_ram[i].executions) callback(0x80000000 | (i << 2), m_ram[i], false);
+    }
+    for (uint32_t i = 0; i < m_bios.size(); i++) {
+        if (m_bios[i].executions) callback(0xbfc00000 | (i << 2), m_bios[i], true);
+    }
+}
+
+std::vector<PCSX::CycleAccounting::Entry> PCSX::CycleAccounting::blocks(const Symbols& symbols) const {
+    PhysicalSymbols physical(symbols);
+    std::vector<Entry> ret;
+    uint32_t next = 0;
+    forEachCounter([&](uint32_t address, const Counter& counter, bool bios) {
+        const uint32_t offset = address & (bios ? 0x7ffff : 0x7fffff);
+        auto [start, name] = PhysicalSymbols::find(bios ? physical.bios : physical.ram, offset);
+        const bool functionStart = name && (start == offset);
+        if (ret.empty() || counter.leader || functionStart || (address != next)) {
+            std::string blockName;
+            if (name) {
+                blockName = (start == offset) ? *name : fmt::format("{}+0x{:x}", *name, offset - start);
+            }
+            ret.push_back(Entry{address, 0, 0, counter.executions, std::move(blockName)});
+        }
+        auto& block = ret.back();
+        block.size += 4;
+        block.cycles += counter.cycles;
+        next = address + 4;
+    });
+    return ret;
+}
+
+std::vector<PCSX::CycleAccounting::Entry> PCSX::CycleAccounting::functions(const Symbols& symbols) const {
+    PhysicalSymbols physical(symbols);
+    std::map<uint32_t, Entry> functions;
+    // Code outside of any symbol counts as a function of its own for each of its blocks, which is the best
+    // guess there is without symbols.
+    for (auto& block : blocks(symbols)) {
+        const bool bios = (block.address >> 29) == 5;
+        const uint32_t base = bios ? 0xbfc00000 : 0x80000000;
+        auto [start, name] = PhysicalSymbols::find(bios ? physical.bios : physical.ram, block.address - base);
+        if (!name) {
+            block.name = fmt::format("0x{:08x}", block.address);
+            functions.emplace(block.address, std::move(block));
+            continue;
+        }
+        const uint32_t address = base + start;
+        auto [entry, inserted] = functions.try_emplace(address, Entry{address, 0, 0, 0, *name});
+        entry->second.cycles += block.cycles;
+        entry->second.size = block.address + block.size - address;
+        if (block.address == address) entry->second.executions = block.executions;
+    }
+    std::vector<Entry> ret;
+    ret.reserve(functions.size());
+    for (auto& [address, entry] : functions) ret.push_back(std::move(entry));
+    std::stable_sort(ret.begin(), ret.end(), [](const Entry& a, const Entry& b) { return a.cycles > b.cycles; });
+    return ret;
+}
+
+void PCSX::CycleAccounting::writeReport(IO<File> file, const Symbols& symbols, unsigned maxBlocks) const {
+    const uint64_t total = m_totals.total();
+    auto percent = [total](uint64_t cycles) { return total ? 100.0 * cycles / total : 0.0; };
+    file->writeString(fmt::format("instructions: {}\n", m_totals.instructions));
+    file->writeString(fmt::format("cycles: {}\n", total));
+    file->writeString(fmt::format("  base: {} ({:.2f}%)\n", m_totals.base, percent(m_totals.base)));
+    file->writeString(fmt::format("  memory: {} ({:.2f}%)\n", m_totals.memory, percent(m_totals.memory)));
+    file->writeString(fmt::format("  gte: {} ({:.2f}%)\n", m_totals.gte, percent(m_totals.gte)));
+    file->writeString(fmt::format("  dma: {} ({:.2f}%)\n", m_totals.dma, percent(m_totals.dma)));
+
+    file->writeString("\nfunctions:\n");
+    for (const auto& entry : functions(symbols)) {
+        file->writeString(fmt::format("{:08x} {:>6} {:>12} {:6.2f}% {:>10} {}\n", entry.address, entry.size,
+                                      entry.cycles, percent(entry.cycles), entry.executions, entry.name));
+    }
+
+    auto sorted = blocks(symbols);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return a.cycles > b.cycles; });
+    if (sorted.size() > maxBlocks) sorted.resize(maxBlocks);
+    file->writeString("\nblocks:\n");
+    for (const auto& entry : sorted) {
+        file->writeString(fmt::format("{:08x} {:>6} {:>12} {:6.2f}% {:>10} {}\n", entry.address, entry.size,
+                                      entry.cycles, percent(entry.cycles), entry.executions, entry.name));
+    }
+}
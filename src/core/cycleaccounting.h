@@ -0,0 +1,198 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// What an instruction costs on the real console, as opposed to the flat BIAS the emulator charges for each of them.
+// The figures come from the hardware documentation, and are the typical case: loads wait on the bus of the region
+// they read from, stores go through the write queue, the instruction cache is assumed to hit for cached code, and
+// uncached code pays for its fetch. MULT and DIV are charged in full when issued, instead of when reading HI/LO.
+struct CycleCost {
+    uint32_t base = 0;
+    uint32_t memory = 0;
+    uint32_t gte = 0;
+    uint32_t dma = 0;
+    uint32_t total() const { return base + memory + gte + dma; }
+};
+
+class CycleCostModel {
+  public:
+    // The extra cycles a load or store of this many bytes at this address waits for, on top of the instruction.
+    static uint32_t memoryCost(uint32_t address, unsigned width, bool write);
+    // The extra cycles the fetch of an instruction at this address costs.
+    static uint32_t fetchCost(uint32_t address);
+    // The latency of the GTE command of a COP2 instruction, or 0 for anything else.
+    static uint32_t gteCost(uint32_t code);
+    // How long the CPU is held off the bus when a DMA channel starts with this control value. Linked list
+    // transfers can't be sized up front, and chopped transfers let the CPU run in between, so both cost nothing.
+    static uint32_t dmaCost(uint32_t bcr, uint32_t chcr);
+
+    // The cost of executing this instruction at this pc, with these registers, as they are before it runs.
+    // The BCR of the DMA channels is only looked up when the instruction starts one of them.
+    template <typename BCRLookup>
+    static CycleCost cost(uint32_t pc, uint32_t code, const uint32_t* gpr, BCRLookup&& bcr);
+};
+
+// Attributes the cost of each instruction the interpreter runs to its address in RAM or BIOS, and groups them by
+// basic block and by function on request. This doesn't change the emulated timings in any way. The dynarec
+// doesn't go through here, so nothing gets recorded while it runs.
+class CycleAccounting {
+  public:
+    using Symbols = std::map<uint32_t, std::string>;
+
+    struct Totals {
+        uint64_t instructions = 0;
+        uint64_t base = 0;
+        uint64_t memory = 0;
+        uint64_t gte = 0;
+        uint64_t dma = 0;
+        uint64_t total() const { return base + memory + gte + dma; }
+    };
+
+    // A range of code, and what it cost. The address is virtual, in KSEG0 for RAM and KSEG1 for the BIOS.
+    struct Entry {
+        uint32_t address;
+        uint32_t size;
+        uint64_t cycles;
+        uint64_t executions;
+        std::string name;
+    };
+
+    // Enabling allocates the counters, and disabling keeps them until the next clear, so they can be looked at.
+    void enable();
+    void disable() { m_enabled = false; }
+    bool enabled() const { return m_enabled; }
+    void clear();
+
+    // From the interpreter, before running the instruction at pc, and when a block ends after its delay slot.
+    void account(uint32_t pc, uint32_t code, const uint32_t* gpr);
+    void endBlock() { m_blockStart = true; }
+    // Same as account, with an already computed cost.
+    void record(uint32_t pc, const CycleCost& cost);
+
+    const Totals& totals() const { return m_totals; }
+    uint64_t cycles(uint32_t address) const;
+    uint64_t executions(uint32_t address) const;
+    // The most any single instruction cost so far, to scale the heat of the others against.
+    uint64_t maxCycles() const { return m_maxCycles; }
+
+    // Most expensive first. A function spans from its symbol to the next one, and addresses outside of any symbol
+    // are grouped on their own. A block starts after a delay slot, or wherever execution jumps into.
+    std::vector<Entry> functions(const Symbols& symbols) const;
+    std::vector<Entry> blocks(const Symbols& symbols) const;
+
+    // The totals, then the functions and the blocks, as text.
+    void writeReport(IO<File> file, const Symbols& symbols, unsigned maxBlocks = 100) const;
+
+  private:
+    struct Counter {
+        uint64_t cycles = 0;
+        uint32_t executions = 0;
+        bool leader = false;
+    };
+    static constexpr uint32_t c_ramWords = 0x00800000 / 4;
+    static constexpr uint32_t c_biosWords = 0x00080000 / 4;
+
+    Counter* counter(uint32_t address);
+    const Counter* counter(uint32_t address) const {
+        return const_cast<CycleAccounting*>(this)->counter(address);
+    }
+    template <typename Callback>
+    void forEachCounter(Callback&& callback) const;
+
+    std::vector<Counter> m_ram;
+    std::vector<Counter> m_bios;
+    Totals m_totals;
+    uint64_t m_maxCycles = 0;
+    bool m_enabled = false;
+    bool m_blockStart = true;
+};
+
+}  // namespace PCSX
+
+template <typename BCRLookup>
+PCSX::CycleCost PCSX::CycleCostModel::cost(uint32_t pc, uint32_t code, const uint32_t* gpr, BCRLookup&& bcr) {
+    CycleCost cost;
+    cost.base = 1;
+    cost.memory = fetchCost(pc);
+    const uint32_t op = code >> 26;
+    const uint32_t rs = (code >> 21) & 0x1f;
+    const uint32_t rt = (code >> 16) & 0x1f;
+    const uint32_t address = gpr[rs] + int16_t(code);
+    switch (op) {
+        case 0x00:  // SPECIAL
+            switch (code & 0x3f) {
+                case 0x18:  // MULT
+                case 0x19:  // MULTU
+                    cost.base += 8;
+                    break;
+                case 0x1a:  // DIV
+                case 0x1b:  // DIVU
+                    cost.base += 35;
+                    break;
+            }
+            break;
+        case 0x12:  // COP2
+            cost.gte = gteCost(code);
+            break;
+        case 0x20:  // LB
+        case 0x24:  // LBU
+            cost.memory += memoryCost(address, 1, false);
+            break;
+        case 0x21:  // LH
+        case 0x25:  // LHU
+            cost.memory += memoryCost(address, 2, false);
+            break;
+        case 0x22:  // LWL
+        case 0x23:  // LW
+        case 0x26:  // LWR
+        case 0x32:  // LWC2
+            cost.memory += memoryCost(address, 4, false);
+            break;
+        case 0x28:  // SB
+            cost.memory += memoryCost(address, 1, true);
+            break;
+        case 0x29:  // SH
+            cost.memory += memoryCost(address, 2, true);
+            break;
+        case 0x2b:  // SW
+            // Writing the start bit of a channel's CHCR is what kicks a DMA off.
+            if (((address & 0x1fffff8f) == 0x1f801088) && (address & 0x70) != 0x70) {
+                const uint32_t chcr = gpr[rt];
+                if (chcr & 0x01000000) cost.dma = dmaCost(bcr((address >> 4) & 7), chcr);
+            }
+            [[fallthrough]];
+        case 0x2a:  // SWL
+        case 0x2e:  // SWR
+        case 0x3a:  // SWC2
+            cost.memory += memoryCost(address, 4, true);
+            break;
+    }
+    return cost;
+}
@@ -24,6 +24,7 @@
 
 #include "core/callstacks.h"
 #include "core/disr3000a.h"
+#include "core/eventqueue.h"
 #include "core/gpu.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
@@ -280,6 +281,7 @@ bool PCSX::Debug::triggerBP(Breakpoint* bp, uint32_t address, unsigned width, co
     m_lastBP = nullptr;
     if (bp) {
         name = bp->name();
+        g_emulator->m_eventQueue->push(EventQueue::Type::Breakpoint, address, width);
         keepBP = bp->trigger(address, width, cause);
         if (keepBP) m_lastBP = bp;
     } else {
@@ -292,6 +294,35 @@ bool PCSX::Debug::triggerBP(Breakpoint* bp, uint32_t address, unsigned width, co
     return keepBP;
 }
 
+bool PCSX::Debug::Breakpoint::condition(std::string_view expression, std::string& error) const {
+    if (expression.empty()) {
+        m_condition.reset();
+        m_hits = 0;
+        return true;
+    }
+    auto condition = BreakpointCondition::compile(expression, error);
+    if (!condition) return false;
+    m_condition = std::move(condition);
+    m_hits = 0;
+    return true;
+}
+
+bool PCSX::Debug::Breakpoint::conditionHolds(uint32_t address, unsigned width) {
+    // A disabled breakpoint doesn't do anything when triggered, so there's nothing to count nor to check
+    if (!m_enabled) return true;
+    m_hits++;
+    if (!m_condition) return true;
+    auto& regs = g_emulator->m_cpu->m_regs;
+    BreakpointCondition::Context context;
+    context.registers = regs.GPR.r;
+    context.pc = regs.pc;
+    context.address = address;
+    context.width = width;
+    context.hits = m_hits;
+    context.memory = [](uint32_t address) { return g_emulator->m_mem->getPointer<const uint8_t>(address); };
+    return m_condition->evaluate(context);
+}
+
 void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause) {
     auto& cpu = g_emulator->m_cpu;
     auto& regs = cpu->m_regs;
@@ -316,15 +347,15 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
         }
     }
 
-    auto end = m_breakpoints.end();
+    if (m_breakpoints.empty()) return;
     uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    if (!pagesWatched(type, normalizedAddress, normalizedAddress + width - 1)) return;
 
     BreakpointTemporaryListType torun;
-    for (auto it = m_breakpoints.find(normalizedAddress, normalizedAddress + width - 1); it != end; it++) {
-        if (it->type() != type) continue;
-        auto bp = &*it;
-        torun.push_back(bp);
-    }
+    m_breakpointsByType[static_cast<unsigned>(type)].forEachOverlapping(
+        normalizedAddress, normalizedAddress + width - 1, [&](Breakpoint* bp) {
+            if (bp->conditionHolds(address, width)) torun.push_back(bp);
+        });
 
     while (!torun.empty()) {
         auto it = torun.begin();
@@ -334,6 +365,51 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
     }
 }
 
+bool PCSX::Debug::hasExecBreakpoint(uint32_t address) {
+    if (m_breakpoints.empty()) return false;
+    uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    if (!pagesWatched(BreakpointType::Exec, normalizedAddress, normalizedAddress + 3)) return false;
+    const auto& exec = m_breakpointsByType[static_cast<unsigned>(BreakpointType::Exec)];
+    return exec.overlaps(normalizedAddress, normalizedAddress + 3);
+}
+
+void PCSX::Debug::breakpointAdded(const Breakpoint* bp) {
+    auto& cpu = g_emulator->m_cpu;
+    if (cpu && bp->type() == BreakpointType::Exec) cpu->invalidateBreakpoint(bp->address(), bp->width());
+}
+
+void PCSX::Debug::watchPages(BreakpointType type, uint32_t low, uint32_t high) {
+    auto& bitmap = m_watchedPages[static_cast<unsigned>(type)];
+    for (uint32_t page = low >> c_watchPageShift; page <= high >> c_watchPageShift; page++) {
+        bitmap[page / 64] |= uint64_t(1) << (page % 64);
+    }
+}
+
+void PCSX::Debug::refreshLookups() {
+    if (m_breakpoints.generation() == m_lookupsGeneration) return;
+    memset(m_watchedPages, 0, sizeof(m_watchedPages));
+    for (auto it = m_breakpoints.begin(); it != m_breakpoints.end(); it++) {
+        watchPages(it->type(), it->getLow(), it->getHigh());
+    }
+    for (unsigned type = 0; type < 3; type++) {
+        m_breakpointsByType[type].rebuild(m_breakpoints, [type](const Breakpoint& bp) {
+            return static_cast<unsigned>(bp.type()) == type;
+        });
+    }
+    m_lookupsGeneration = m_breakpoints.generation();
+}
+
+bool PCSX::Debug::pagesWatched(BreakpointType type, uint32_t low, uint32_t high) {
+    refreshLookups();
+    // An access wrapping around the end of the address space only needs its first page checked
+    if (high < low) high = low;
+    const auto& bitmap = m_watchedPages[static_cast<unsigned>(type)];
+    for (uint32_t page = low >> c_watchPageShift; page <= high >> c_watchPageShift; page++) {
+        if (bitmap[page / 64] & (uint64_t(1) << (page % 64))) return true;
+    }
+    return false;
+}
+
 std::string PCSX::Debug::generateFlowIDC() {
     std::stringstream ss;
     ss << "#include <idc.idc>\r\n\r\n";
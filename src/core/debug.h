@@ -20,8 +20,11 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 
+#include "core/bpcondition.h"
 #include "core/psxemulator.h"
 #include "core/system.h"
 #include "fmt/format.h"
@@ -47,6 +50,11 @@ class Debug {
         checkBP(address, BreakpointType::Write, len, cause.c_str());
     }
 
+    // The dynarec doesn't call process(), and instead checks execution breakpoints when entering the blocks
+    // starting at their address, splitting blocks so that there's one for each of them.
+    bool hasExecBreakpoint(uint32_t address);
+    void checkExecBreakpoint(uint32_t address) { checkBP(address, BreakpointType::Exec, 4); }
+
   private:
     void checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause = "");
 
@@ -87,8 +95,15 @@ class Debug {
         const std::string& label() const { return m_label; }
         void label(const std::string& label) const { m_label = label; }
         uint32_t base() const { return m_base; }
+        // An empty expression removes the condition; returns false, and keeps the previous one, if it doesn't
+        // parse. Changing the condition resets the hit count.
+        bool condition(std::string_view expression, std::string& error) const;
+        const BreakpointCondition* condition() const { return m_condition.get(); }
+        uint64_t hits() const { return m_hits; }
 
       private:
+        // Counts the hit, and tells if the breakpoint needs to be triggered for it
+        bool conditionHolds(uint32_t address, unsigned width);
         bool trigger(uint32_t address, unsigned width, const char* cause) {
             if (m_enabled) return m_invoker(this, address, width, strlen(cause) > 0 ? cause : m_source.c_str());
             return true;
@@ -100,6 +115,8 @@ class Debug {
         mutable std::string m_label;
         uint32_t m_base;
         mutable bool m_enabled = true;
+        mutable std::unique_ptr<BreakpointCondition> m_condition;
+        mutable uint64_t m_hits = 0;
 
         friend class Debug;
     };
@@ -140,7 +157,9 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        auto bp = &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        breakpointAdded(bp);
+        return bp;
     }
     inline Breakpoint* addBreakpoint(
         uint32_t address, BreakpointType type, unsigned width, const std::string& source, std::string label,
@@ -150,7 +169,10 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        auto bp =
+            &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        breakpointAdded(bp);
+        return bp;
     }
     const BreakpointTreeType& getTree() { return m_breakpoints; }
     const Breakpoint* lastBP() { return m_lastBP; }
@@ -160,6 +182,21 @@ class Debug {
     }
 
   private:
+    // Tells the CPU about execution breakpoints, as code compiled before they existed doesn't check for them.
+    // Removing one doesn't need this, as a check finding nothing is harmless.
+    void breakpointAdded(const Breakpoint* bp);
+    // One bit per 4KB page and per breakpoint type, set when the page may contain a breakpoint of that type,
+    // so that most accesses can skip the lookup, and a flattened copy of the breakpoints of each type for
+    // the ones which can't. Breakpoints get deleted from places which don't go through us, so both get
+    // rebuilt whenever the tree's generation has moved since.
+    static constexpr unsigned c_watchPageShift = 12;
+    static constexpr unsigned c_watchWords = (1 << (32 - c_watchPageShift)) / 64;
+    uint64_t m_watchedPages[3][c_watchWords] = {};
+    IntervalSnapshot<uint32_t, Breakpoint> m_breakpointsByType[3];
+    uint64_t m_lookupsGeneration = 0;
+    void refreshLookups();
+    void watchPages(BreakpointType type, uint32_t low, uint32_t high);
+    bool pagesWatched(BreakpointType type, uint32_t low, uint32_t high);
     bool triggerBP(Breakpoint* bp, uint32_t address, unsigned width, const char* reason = "");
     BreakpointTreeType m_breakpoints;
 
@@ -23,14 +23,15 @@
 
 #include "core/decode_xa.h"
 
-// #define FIXED
-
-#define NOT(_X_) (!(_X_))
-#define XACLAMP(_X_, _MI_, _MA_)    \
-    {                               \
-        if (_X_ < _MI_) _X_ = _MI_; \
-        if (_X_ > _MA_) _X_ = _MA_; \
-    }
+#include <algorithm>
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define DECODEXA_X86
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DECODEXA_NEON
+#include <arm_neon.h>
+#endif
 
 #define SH 4
 #define SHC 10
@@ -39,15 +40,10 @@
 //===  ADPCM DECODING ROUTINES
 //============================================
 
-#ifndef FIXED
-static const double s_K0[4] = {0.0, 0.9375, 1.796875, 1.53125};
-
-static const double s_K1[4] = {0.0, 0.0, -0.8125, -0.859375};
-#else
-static const int s_K0[4] = {0.0 * (1 << SHC), 0.9375 * (1 << SHC), 1.796875 * (1 << SHC), 1.53125 * (1 << SHC)};
-
-static const int s_K1[4] = {0.0 * (1 << SHC), 0.0 * (1 << SHC), -0.8125 * (1 << SHC), -0.859375 * (1 << SHC)};
-#endif
+// The filters' coefficients, negated, in 10 bits fixed point: 0.0, 0.9375, 1.796875, 1.53125 and
+// 0.0, 0.0, -0.8125, -0.859375. Only the bottom two bits of the filter number matter.
+static constexpr int s_IK0[4] = {0, -960, -1840, -1568};
+static constexpr int s_IK1[4] = {0, 0, 832, 880};
 
 #define BLKSIZ 28 /* block size (32 - 4 nibbles) */
 
@@ -58,194 +54,174 @@ static void ADPCM_InitDecode(ADPCM_Decode_t *decp) {
 }
 
 //===========================================
-#ifndef FIXED
-#define IK0(fid) ((int)((-s_K0[fid]) * (1 << SHC)))
-#define IK1(fid) ((int)((-s_K1[fid]) * (1 << SHC)))
+// Extracts the 28 samples of unit i of a sound group, and scales them according to the unit's range. Sample n
+// of the unit is in the byte at datap[i + 4 * (n / step)], in its top nibble if high is set; step is 1 for
+// 4 bits units, which get a byte per sample, and 2 for the two units of a level A group, which get a nibble
+// per sample. There's no dependency between the samples, so this can be done 4 at a time: each 32 bits
+// word of the sound data holds one byte of each of the 4 units sharing it. The destination needs room for
+// 32 samples.
+#if defined(DECODEXA_X86)
+static inline void ADPCM_UnpackUnit(uint8_t filter_range, const uint8_t *datap, int i, int step, bool high,
+                                    int32_t *destp) {
+    // move the nibble to the top of its word, then back down as a signed value, like (short)(nibble << 12)
+    const __m128i right = _mm_cvtsi32_si128(16 + (filter_range & 0x0f));
+    const __m128i top = _mm_set1_epi32(0xf0000000);
+    if (step == 1) {
+        const __m128i left = _mm_cvtsi32_si128(28 - 8 * i - (high ? 4 : 0));
+        for (int q = 0; q < 7; q++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(datap + q * 16));
+            v = _mm_sra_epi32(_mm_and_si128(_mm_sll_epi32(v, left), top), right);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destp + q * 4), _mm_slli_epi32(v, SH));
+        }
+    } else {
+        const __m128i leftLow = _mm_cvtsi32_si128(28 - 8 * i);
+        const __m128i leftHigh = _mm_cvtsi32_si128(24 - 8 * i);
+        const __m128i even = _mm_set_epi32(0, -1, 0, -1);
+        auto unpack = [&](__m128i v) {
+            v = _mm_or_si128(_mm_and_si128(even, _mm_sll_epi32(v, leftLow)),
+                             _mm_andnot_si128(even, _mm_sll_epi32(v, leftHigh)));
+            return _mm_slli_epi32(_mm_sra_epi32(_mm_and_si128(v, top), right), SH);
+        };
+        for (int q = 0; q < 4; q++) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(datap + q * 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destp + q * 8), unpack(_mm_unpacklo_epi32(v, v)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destp + q * 8 + 4), unpack(_mm_unpackhi_epi32(v, v)));
+        }
+    }
+}
+#elif defined(DECODEXA_NEON)
+static inline void ADPCM_UnpackUnit(uint8_t filter_range, const uint8_t *datap, int i, int step, bool high,
+                                    int32_t *destp) {
+    // move the nibble to the top of its word, then back down as a signed value, like (short)(nibble << 12)
+    const int32x4_t right = vdupq_n_s32(-16 - (filter_range & 0x0f));
+    const int32x4_t top = vdupq_n_s32(0xf0000000);
+    if (step == 1) {
+        const int32x4_t left = vdupq_n_s32(28 - 8 * i - (high ? 4 : 0));
+        for (int q = 0; q < 7; q++) {
+            int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(datap + q * 16));
+            v = vshlq_s32(vandq_s32(vshlq_s32(v, left), top), right);
+            vst1q_s32(destp + q * 4, vshlq_n_s32(v, SH));
+        }
+    } else {
+        const int32_t shifts[4] = {28 - 8 * i, 24 - 8 * i, 28 - 8 * i, 24 - 8 * i};
+        const int32x4_t left = vld1q_s32(shifts);
+        auto unpack = [&](int32x4_t v) {
+            return vshlq_n_s32(vshlq_s32(vandq_s32(vshlq_s32(v, left), top), right), SH);
+        };
+        for (int q = 0; q < 4; q++) {
+            const int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(datap + q * 16));
+            const int32x4x2_t pairs = vzipq_s32(v, v);
+            vst1q_s32(destp + q * 8, unpack(pairs.val[0]));
+            vst1q_s32(destp + q * 8 + 4, unpack(pairs.val[1]));
+        }
+    }
+}
 #else
-#define IK0(fid) (-s_K0[fid])
-#define IK1(fid) (-s_K1[fid])
+static inline void ADPCM_UnpackUnit(uint8_t filter_range, const uint8_t *datap, int i, int step, bool high,
+                                    int32_t *destp) {
+    const int range = filter_range & 0x0f;
+    for (int n = 0; n < BLKSIZ; n++) {
+        const int shift = step == 1 ? (high ? 4 : 0) : ((n & 1) ? 4 : 0);
+        const uint16_t nibble = (datap[i + 4 * (n / step)] >> shift) & 0x0f;
+        destp[n] = ((short)(nibble << 12) >> range) << SH;
+    }
+}
 #endif
 
-static inline void ADPCM_DecodeBlock16(ADPCM_Decode_t *decp, uint8_t filter_range, const void *vblockp, short *destp,
-                                       int inc) {
-    int range, filterid;
-    int32_t fy0, fy1;
-    const uint16_t *blockp;
-
-    blockp = (const unsigned short *)vblockp;
-    filterid = (filter_range >> 4) & 0x0f;
-    range = (filter_range >> 0) & 0x0f;
-
-    fy0 = decp->y0;
-    fy1 = decp->y1;
-
-    for (int i = BLKSIZ / 4; i; --i) {
-        int32_t y;
-        int32_t x0, x1, x2, x3;
-
-        y = *blockp++;
-        x3 = (short)(y & 0xf000) >> range;
-        x3 <<= SH;
-        x2 = (short)((y << 4) & 0xf000) >> range;
-        x2 <<= SH;
-        x1 = (short)((y << 8) & 0xf000) >> range;
-        x1 <<= SH;
-        x0 = (short)((y << 12) & 0xf000) >> range;
-        x0 <<= SH;
-
-        x0 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x0;
-        x1 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x1;
-        x2 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x2;
-        x3 -= (IK0(filterid) * fy0 + (IK1(filterid) * fy1)) >> SHC;
-        fy1 = fy0;
-        fy0 = x3;
-
-        XACLAMP(x0, -32768 << SH, 32767 << SH);
-        *destp = x0 >> SH;
-        destp += inc;
-        XACLAMP(x1, -32768 << SH, 32767 << SH);
-        *destp = x1 >> SH;
-        destp += inc;
-        XACLAMP(x2, -32768 << SH, 32767 << SH);
-        *destp = x2 >> SH;
-        destp += inc;
-        XACLAMP(x3, -32768 << SH, 32767 << SH);
-        *destp = x3 >> SH;
-        destp += inc;
+static inline int32_t ADPCM_FilterSample(int32_t x, int k0, int k1, int32_t &fy0, int32_t &fy1) {
+    x -= (k0 * fy0 + k1 * fy1) >> SHC;
+    fy1 = fy0;
+    fy0 = x;
+    return std::clamp(x, -32768 << SH, 32767 << SH) >> SH;
+}
+
+// Runs an unpacked unit through its prediction filter. This is where the time goes, and there's no way
+// around it: each sample needs the two previous ones, and each unit starts off where the previous one ended.
+// The best that can be done is to keep the multiplications off the critical path, with each filter getting
+// its own loop, so the compiler sees constant coefficients.
+template <int filterid>
+static void ADPCM_FilterUnit(ADPCM_Decode_t *decp, const int32_t *srcp, short *destp) {
+    int32_t fy0 = decp->y0;
+    int32_t fy1 = decp->y1;
+
+    for (int n = 0; n < BLKSIZ; n++) {
+        destp[n] = ADPCM_FilterSample(srcp[n], s_IK0[filterid], s_IK1[filterid], fy0, fy1);
     }
+
     decp->y0 = fy0;
     decp->y1 = fy1;
 }
 
+// The left and right channels of a stereo sector are independent from each other though, so running both
+// filters in the same loop lets the CPU overlap the two dependency chains. The output is interleaved.
+template <int filteridl, int filteridr>
+static void ADPCM_FilterUnitStereo(xa_decode_t *xdp, const int32_t *srcl, const int32_t *srcr, short *destp) {
+    int32_t fy0l = xdp->left.y0;
+    int32_t fy1l = xdp->left.y1;
+    int32_t fy0r = xdp->right.y0;
+    int32_t fy1r = xdp->right.y1;
+
+    for (int n = 0; n < BLKSIZ; n++) {
+        destp[n * 2 + 0] = ADPCM_FilterSample(srcl[n], s_IK0[filteridl], s_IK1[filteridl], fy0l, fy1l);
+        destp[n * 2 + 1] = ADPCM_FilterSample(srcr[n], s_IK0[filteridr], s_IK1[filteridr], fy0r, fy1r);
+    }
+
+    xdp->left.y0 = fy0l;
+    xdp->left.y1 = fy1l;
+    xdp->right.y0 = fy0r;
+    xdp->right.y1 = fy1r;
+}
+
+typedef void (*ADPCM_FilterUnit_t)(ADPCM_Decode_t *, const int32_t *, short *);
+typedef void (*ADPCM_FilterUnitStereo_t)(xa_decode_t *, const int32_t *, const int32_t *, short *);
+
+static const ADPCM_FilterUnit_t s_filterUnit[4] = {
+    ADPCM_FilterUnit<0>,
+    ADPCM_FilterUnit<1>,
+    ADPCM_FilterUnit<2>,
+    ADPCM_FilterUnit<3>,
+};
+
+static const ADPCM_FilterUnitStereo_t s_filterUnitStereo[4][4] = {
+    {ADPCM_FilterUnitStereo<0, 0>, ADPCM_FilterUnitStereo<0, 1>, ADPCM_FilterUnitStereo<0, 2>,
+     ADPCM_FilterUnitStereo<0, 3>},
+    {ADPCM_FilterUnitStereo<1, 0>, ADPCM_FilterUnitStereo<1, 1>, ADPCM_FilterUnitStereo<1, 2>,
+     ADPCM_FilterUnitStereo<1, 3>},
+    {ADPCM_FilterUnitStereo<2, 0>, ADPCM_FilterUnitStereo<2, 1>, ADPCM_FilterUnitStereo<2, 2>,
+     ADPCM_FilterUnitStereo<2, 3>},
+    {ADPCM_FilterUnitStereo<3, 0>, ADPCM_FilterUnitStereo<3, 1>, ADPCM_FilterUnitStereo<3, 2>,
+     ADPCM_FilterUnitStereo<3, 3>},
+};
+
 static const int s_headtable[4] = {0, 2, 8, 10};
 
 //===========================================
+// Decodes the 18 sound groups of a sector in one go, straight into xdp->pcm. Each group has a 16 bytes
+// header holding the filter and range of its units, followed by 112 bytes of interleaved sound data.
 static void xa_decode_data(xa_decode_t *xdp, unsigned char *srcp) {
-    const uint8_t *sound_groupsp;
-    const uint8_t *sound_datap, *sound_datap2;
-    int i, j, k, nbits;
-    uint16_t data[4096], *datap;
-    short *destp;
-
-    destp = xdp->pcm;
-    nbits = xdp->nbits == 4 ? 4 : 2;
-
-    if (xdp->stereo) {                                    // stereo
-        if ((xdp->nbits == 8) && (xdp->freq == 37800)) {  // level A
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp + 0, 2);
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->right, sound_groupsp[s_headtable[i] + 1], data, destp + 1, 2);
-
-                    destp += 28 * 2;
-                }
-            }
-        } else {  // level B/C
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] & 0x0f) | ((uint16_t)(sound_datap2[4] & 0x0f) << 4) |
-                                     ((uint16_t)(sound_datap2[8] & 0x0f) << 8) |
-                                     ((uint16_t)(sound_datap2[12] & 0x0f) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp + 0, 2);
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] >> 4) | ((uint16_t)(sound_datap2[4] >> 4) << 4) |
-                                     ((uint16_t)(sound_datap2[8] >> 4) << 8) |
-                                     ((uint16_t)(sound_datap2[12] >> 4) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->right, sound_groupsp[s_headtable[i] + 1], data, destp + 1, 2);
-
-                    destp += 28 * 2;
-                }
-            }
-        }
-    } else {                                              // mono
-        if ((xdp->nbits == 8) && (xdp->freq == 37800)) {  // level A
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp, 1);
-
-                    destp += 28;
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 14; k++, sound_datap2 += 8) {
-                        *(datap++) = (uint16_t)sound_datap2[0] | (uint16_t)(sound_datap2[4] << 8);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 1], data, destp, 1);
-
-                    destp += 28;
-                }
-            }
-        } else {  // level B/C
-            for (j = 0; j < 18; j++) {
-                sound_groupsp = srcp + j * 128;    // sound groups header
-                sound_datap = sound_groupsp + 16;  // sound data just after the header
-
-                for (i = 0; i < nbits; i++) {
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] & 0x0f) | ((uint16_t)(sound_datap2[4] & 0x0f) << 4) |
-                                     ((uint16_t)(sound_datap2[8] & 0x0f) << 8) |
-                                     ((uint16_t)(sound_datap2[12] & 0x0f) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 0], data, destp, 1);
-
-                    destp += 28;
-
-                    datap = data;
-                    sound_datap2 = sound_datap + i;
-                    for (k = 0; k < 7; k++, sound_datap2 += 16) {
-                        *(datap++) = (uint16_t)(sound_datap2[0] >> 4) | ((uint16_t)(sound_datap2[4] >> 4) << 4) |
-                                     ((uint16_t)(sound_datap2[8] >> 4) << 8) |
-                                     ((uint16_t)(sound_datap2[12] >> 4) << 12);
-                    }
-                    ADPCM_DecodeBlock16(&xdp->left, sound_groupsp[s_headtable[i] + 1], data, destp, 1);
-
-                    destp += 28;
-                }
+    // level A sectors only get two units per group, with the left and right ones sharing the same data
+    const bool levelA = (xdp->nbits == 8) && (xdp->freq == 37800);
+    const int units = xdp->nbits == 4 ? 4 : 2;
+    const int step = levelA ? 2 : 1;
+    short *destp = xdp->pcm;
+
+    for (int j = 0; j < 18; j++) {
+        const uint8_t *sound_groupsp = srcp + j * 128;    // sound groups header
+        const uint8_t *sound_datap = sound_groupsp + 16;  // sound data just after the header
+
+        for (int i = 0; i < units; i++) {
+            const uint8_t filter0 = sound_groupsp[s_headtable[i] + 0];
+            const uint8_t filter1 = sound_groupsp[s_headtable[i] + 1];
+            int32_t unpacked[2][32];
+            ADPCM_UnpackUnit(filter0, sound_datap, i, step, false, unpacked[0]);
+            ADPCM_UnpackUnit(filter1, sound_datap, i, step, !levelA, unpacked[1]);
+            if (xdp->stereo) {
+                s_filterUnitStereo[(filter0 >> 4) & 3][(filter1 >> 4) & 3](xdp, unpacked[0], unpacked[1], destp);
+            } else {
+                s_filterUnit[(filter0 >> 4) & 3](&xdp->left, unpacked[0], destp);
+                s_filterUnit[(filter1 >> 4) & 3](&xdp->left, unpacked[1], destp + BLKSIZ);
             }
+            destp += BLKSIZ * 2;
         }
     }
 }
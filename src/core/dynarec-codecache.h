@@ -0,0 +1,46 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+namespace PCSX {
+
+// The dynarecs emit their code into a static buffer, so that it sits close enough to the executable for rip- or
+// pc-relative accesses to reach it. There's only one such buffer in the process, so only one emulator at a time may
+// own it; the others have to make do with the interpreter. The emitters inherit this first, so the claim is settled
+// before they get to touch the buffer.
+class CodeCacheClaim {
+  public:
+    CodeCacheClaim() : m_owned(!s_claimed.exchange(true, std::memory_order_acquire)) {}
+    ~CodeCacheClaim() {
+        if (m_owned) s_claimed.store(false, std::memory_order_release);
+    }
+    CodeCacheClaim(const CodeCacheClaim&) = delete;
+    CodeCacheClaim& operator=(const CodeCacheClaim&) = delete;
+
+    bool ownsCodeCache() const { return m_owned; }
+
+  private:
+    const bool m_owned;
+    static inline std::atomic<bool> s_claimed = false;
+};
+
+}  // namespace PCSX
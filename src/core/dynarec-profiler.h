@@ -20,13 +20,15 @@
 #pragma once
 
 #include "core/r3000a.h"
-#if defined(DYNAREC_X86_64)
+#if defined(DYNAREC_X86_64) || defined(DYNAREC_AA64)
 #include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <functional>
 #include <vector>
 
+#include "support/flathashtable.h"
+
 struct ProfilerEntry {
     uint32_t pc;
     uint64_t cyclesSpent = 0;   // Total amount of CPU cycles spent in this block
@@ -47,6 +49,10 @@ class RecompilerProfiler {
     int m_entryCount;
     std::vector<ProfilerEntry> m_entries;
     uint64_t m_totalCycles;
+    uint64_t m_linkHits = 0;       // Times a block jumped straight into its linked successor
+    uint64_t m_linkMisses = 0;     // Times a link had to fall back to the dispatcher
+    uint64_t m_codeEvictions = 0;  // Code cache segments evicted to make room for new blocks
+    PCSX::FlatHashTable<uint32_t, uint64_t> m_pageInvalidations;  // Code invalidations per 4KB RAM page
 
   public:
     void init() {
@@ -55,7 +61,13 @@ class RecompilerProfiler {
         m_entryCount = 0;
     }
 
-    void reset() { m_entryCount = 0; }
+    void reset() {
+        m_entryCount = 0;
+        m_linkHits = 0;
+        m_linkMisses = 0;
+        m_codeEvictions = 0;
+        m_pageInvalidations.clear();
+    }
 
     // Returns if there's enough space to fit an extra entry
     bool hasSpace() { return m_entryCount < maxEntryCount; }
@@ -78,6 +90,10 @@ class RecompilerProfiler {
     }
 
     uint64_t& totalCycles() { return m_totalCycles; }
+    uint64_t& linkHits() { return m_linkHits; }
+    uint64_t& linkMisses() { return m_linkMisses; }
+    uint64_t& codeEvictions() { return m_codeEvictions; }
+    PCSX::FlatHashTable<uint32_t, uint64_t>& pageInvalidations() { return m_pageInvalidations; }
     ProfilerEntry& operator[](int i) { return m_entries[i]; }
 };
-#endif  // DYNAREC_X86_64
+#endif  // DYNAREC_X86_64 || DYNAREC_AA64
@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/eventqueue.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/system.h"
+
+PCSX::EventQueue::EventQueue() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](const auto& event) {
+        m_ring.frame++;
+        push(Type::VSync);
+    });
+}
+
+void PCSX::EventQueue::enable(uint32_t capacity) {
+    capacity = std::bit_ceil(std::max(capacity, 16u));
+    m_records.reset(new Record[capacity]);
+    m_ring.records = m_records.get();
+    m_ring.capacity = capacity;
+    m_ring.head = m_ring.tail = 0;
+    m_ring.dropped = 0;
+}
+
+void PCSX::EventQueue::disable() {
+    m_ring.records = nullptr;
+    m_ring.capacity = 0;
+    m_ring.head = m_ring.tail = 0;
+    m_records.reset();
+}
+
+void PCSX::EventQueue::record(Type type, uint32_t address, uint32_t value) {
+    if (m_ring.head - m_ring.tail >= m_ring.capacity) {
+        m_ring.dropped++;
+        return;
+    }
+    auto& record = m_ring.records[m_ring.head & (m_ring.capacity - 1)];
+    record.type = type;
+    record.frame = m_ring.frame;
+    record.pc = g_emulator->m_cpu->m_regs.pc;
+    record.address = address;
+    record.value = value;
+    m_ring.head++;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Events recorded for Lua scripts to drain once per frame, instead of calling into a Lua listener for each one of
+// them, which costs a coroutine resume and a table every time. Nothing gets recorded until a script enables the
+// queue. The records sit in a preallocated ring which the FFI reads in place; when the script doesn't keep up, the
+// newest events get dropped, and counted.
+class EventQueue {
+  public:
+    enum class Type : uint32_t { VSync, Breakpoint, KernelCall };
+    struct Record {
+        Type type;
+        // How many vblanks the queue had seen when this got recorded
+        uint32_t frame;
+        uint32_t pc;
+        // Breakpoint: the address and width of what triggered it. KernelCall: the vector, 0xa0, 0xb0 or 0xc0,
+        // and the call number.
+        uint32_t address;
+        uint32_t value;
+    };
+    // Shared with the FFI as is. Only push() moves the head, and only the script moves the tail; both keep
+    // counting up, and get wrapped by the capacity, which is a power of two, when indexing the records.
+    struct Ring {
+        Record* records = nullptr;
+        uint32_t capacity = 0;
+        uint32_t head = 0;
+        uint32_t tail = 0;
+        uint32_t dropped = 0;
+        uint32_t frame = 0;
+    };
+
+    EventQueue();
+    // Throws away whatever was pending, if the queue was already enabled.
+    void enable(uint32_t capacity);
+    void disable();
+    bool enabled() const { return m_ring.records != nullptr; }
+    Ring* ring() { return &m_ring; }
+
+    void push(Type type, uint32_t address = 0, uint32_t value = 0) {
+        if (enabled()) record(type, address, value);
+    }
+
+  private:
+    void record(Type type, uint32_t address, uint32_t value);
+
+    Ring m_ring;
+    std::unique_ptr<Record[]> m_records;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
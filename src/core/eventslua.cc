@@ -19,7 +19,9 @@
 
 #include "core/eventslua.h"
 
+#include "core/framestats.h"
 #include "core/logger.h"
+#include "core/psxemulator.h"
 #include "core/system.h"
 #include "support/eventbus.h"
 
@@ -112,6 +114,7 @@ void createListener(PCSX::Lua L) {
         L.getfield("callback");
         pushEvent(L, e);
         try {
+            PCSX::FrameStats::Scope scope(*PCSX::g_emulator->m_frameStats, PCSX::FrameStats::Counter::Lua);
             L.pcall(1);
         } catch (std::exception& e) {
             PCSX::g_system->log(PCSX::LogClass::LUA, "Error in event listener: %s", e.what());
@@ -183,6 +186,8 @@ void PCSX::LuaBindings::open_events(Lua L) {
             auto name = L.tostring(1);
             if (name == "Quitting") {
                 createListener<Events::Quitting>(L);
+            } else if (name == "SettingsChanged") {
+                createListener<Events::SettingsChanged>(L);
             } else if (name == "IsoMounted") {
                 createListener<Events::IsoMounted>(L);
             } else if (name == "GPU::Vsync") {
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/framehashes.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "core/gpu.h"
+#include "core/psxemulator.h"
+#include "core/system.h"
+
+PCSX::FrameHashes::FrameHashes() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::GPU::VSync>([this](const auto& event) {
+        if (recording() || m_comparing) frame(g_emulator->m_gpu->hashDisplay());
+    });
+}
+
+bool PCSX::FrameHashes::record(IO<File> file) {
+    m_file.reset();
+    if (!file || file->failed() || !file->writable()) return false;
+    m_file = file;
+    m_file->write(c_magic, sizeof(c_magic));
+    return true;
+}
+
+bool PCSX::FrameHashes::compare(IO<File> golden) {
+    m_golden.clear();
+    m_comparing = false;
+    m_frame = 0;
+    m_mismatch.reset();
+    if (!golden || golden->failed()) return false;
+    const std::string data = golden->readStringAt(golden->size(), 0);
+    if ((data.size() < sizeof(c_magic)) || (memcmp(data.data(), c_magic, sizeof(c_magic)) != 0)) {
+        g_system->printf(_("Not a valid frame hashes file.\n"));
+        return false;
+    }
+    m_golden.resize((data.size() - sizeof(c_magic)) / sizeof(uint64_t));
+    const char* bytes = data.data() + sizeof(c_magic);
+    for (auto& hash : m_golden) {
+        hash = 0;
+        for (unsigned i = 0; i < 8; i++) hash |= uint64_t(uint8_t(*bytes++)) << (i * 8);
+    }
+    m_comparing = true;
+    return true;
+}
+
+void PCSX::FrameHashes::stop() {
+    m_file.reset();
+    m_golden.clear();
+    m_comparing = false;
+    m_frame = 0;
+    m_mismatch.reset();
+}
+
+bool PCSX::FrameHashes::frame(uint64_t hash) {
+    const uint64_t frame = m_frame++;
+    if (m_file) {
+        uint8_t bytes[8];
+        for (unsigned i = 0; i < 8; i++) bytes[i] = hash >> (i * 8);
+        m_file->write(bytes, sizeof(bytes));
+    }
+    if (!m_comparing) return true;
+    if (frame >= m_golden.size()) {
+        g_system->printf(_("The golden frame hashes end at frame %llu, nothing left to compare against.\n"),
+                         (unsigned long long)frame);
+        m_comparing = false;
+        return true;
+    }
+    if (m_golden[frame] == hash) return true;
+
+    m_mismatch = frame;
+    m_comparing = false;
+    g_system->printf(_("Frame %llu doesn't match the golden run: its hash is %016llx instead of %016llx.\n"),
+                     (unsigned long long)frame, (unsigned long long)hash, (unsigned long long)m_golden[frame]);
+    if (g_system->getArgs().isTestModeEnabled()) {
+        g_system->quit(1);
+    } else {
+        g_system->pause();
+    }
+    return false;
+}
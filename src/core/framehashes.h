@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// Hashes what's displayed at the end of each frame, with GPU::hashDisplay(), to check a run against a golden
+// one much more cheaply than comparing screenshots. The hashes can be logged to a file, 8 bytes per frame after
+// a small header, and a run can be compared against such a log, stopping at the first frame which differs:
+// the emulator then quits with an error in test mode, and pauses otherwise.
+//
+// Only the frames emulated for real count, the way movies see them. Frame skipping changes what gets drawn, so
+// logs made with it won't match the ones made without.
+class FrameHashes {
+  public:
+    FrameHashes();
+
+    // Logs the hash of every frame from now on into this file, which needs to be writable.
+    bool record(IO<File> file);
+    // Checks every frame from now on against a log made by record(). Both can go on at the same time.
+    bool compare(IO<File> golden);
+    void stop();
+
+    // What happens at the end of each frame, with its hash. Returns false when it didn't match the golden log.
+    bool frame(uint64_t hash);
+
+    bool recording() const { return !!m_file; }
+    bool comparing() const { return m_comparing; }
+    uint64_t frames() const { return m_frame; }
+    // The first frame which didn't match the golden log, if any.
+    std::optional<uint64_t> mismatch() const { return m_mismatch; }
+
+  private:
+    static constexpr char c_magic[8] = {'P', 'C', 'S', 'X', 'F', 'H', 'S', '1'};
+
+    IO<File> m_file;
+    std::vector<uint64_t> m_golden;
+    bool m_comparing = false;
+    uint64_t m_frame = 0;
+    std::optional<uint64_t> m_mismatch;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/framestats.h"
+
+namespace {
+
+struct Current {
+    PCSX::FrameStats* stats = nullptr;
+    PCSX::FrameStats::Counter counter = PCSX::FrameStats::Counter::CPU;
+    PCSX::FrameStats::Clock::time_point since;
+};
+
+thread_local Current s_current;
+
+// Charges what the running counter of this thread got so far, and starts it over from now.
+PCSX::FrameStats::Clock::time_point flushCurrent() {
+    const auto now = PCSX::FrameStats::Clock::now();
+    if (s_current.stats) s_current.stats->add(s_current.counter, now - s_current.since);
+    s_current.since = now;
+    return now;
+}
+
+}  // namespace
+
+PCSX::FrameStats::Scope::Scope(FrameStats& stats, Counter counter)
+    : m_previousStats(s_current.stats), m_previousCounter(s_current.counter) {
+    flushCurrent();
+    s_current.stats = &stats;
+    s_current.counter = counter;
+}
+
+PCSX::FrameStats::Scope::~Scope() {
+    flushCurrent();
+    s_current.stats = m_previousStats;
+    s_current.counter = m_previousCounter;
+}
+
+void PCSX::FrameStats::endFrame() {
+    const auto now = flushCurrent();
+    auto& history = m_history;
+    const unsigned index = history.index;
+    for (unsigned i = 0; i < c_counters; i++) {
+        history.counters[i][index] = m_accumulated[i].exchange(0, std::memory_order_relaxed) / 1000000.0f;
+    }
+    history.frameTime[index] = std::chrono::duration<float, std::milli>(now - m_lastFrame).count();
+    const uint32_t vsyncs = m_vsyncs.exchange(0, std::memory_order_relaxed);
+    history.vsyncs[index] = vsyncs > 255 ? 255 : vsyncs;
+    history.index = (index + 1) % c_frames;
+    if (history.frames < c_frames) history.frames++;
+    m_lastFrame = now;
+}
+
+float PCSX::FrameStats::hostFPS() const {
+    float total = 0.0f;
+    for (auto time : m_history.frameTime) total += time;
+    return total > 0.0f ? m_history.frames * 1000.0f / total : 0.0f;
+}
+
+float PCSX::FrameStats::emulatedFPS() const {
+    float total = 0.0f;
+    unsigned vsyncs = 0;
+    for (unsigned i = 0; i < c_frames; i++) {
+        total += m_history.frameTime[i];
+        vsyncs += m_history.vsyncs[i];
+    }
+    return total > 0.0f ? vsyncs * 1000.0f / total : 0.0f;
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace PCSX {
+
+// Where the host's time goes, frame by frame, for the performance overlay. Unlike the profiler zones, this is always
+// on, so it needs to stay cheap: a couple of clock reads whenever the work changes hands between two subsystems,
+// and a relaxed atomic add. Each thread only ever charges one counter at a time, the innermost scope's, so nested
+// scopes never count the same time twice, and the counters of one thread add up to the time it was busy.
+class FrameStats {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr unsigned c_frames = 240;
+
+    enum class Counter : unsigned {
+        // The main loop running the CPU, with everything the CPU calls into which isn't counted separately.
+        CPU,
+        // The GPU's DMA and vblank on the emulation thread, plus the command thread, if any.
+        GPU,
+        // The mixer, on the emulation thread in synchronous mode, and its own thread otherwise.
+        SPU,
+        Lua,
+        GUI,
+        // Swapping buffers, which is where the host's vsync waits.
+        Present,
+        Count,
+    };
+    static constexpr unsigned c_counters = static_cast<unsigned>(Counter::Count);
+
+    // Charges the time until it goes out of scope to a counter, pausing whichever counter was being charged on
+    // this thread until then.
+    class Scope {
+      public:
+        Scope(FrameStats& stats, Counter counter);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        FrameStats* m_previousStats;
+        Counter m_previousCounter;
+    };
+
+    // The last frames, in milliseconds. These are rings, the next frame going at index, so index is also where the
+    // oldest one is. Only the thread calling endFrame() may look at them.
+    struct History {
+        float counters[c_counters][c_frames] = {};
+        float frameTime[c_frames] = {};
+        // How many frames the emulated machine displayed during each host frame.
+        uint8_t vsyncs[c_frames] = {};
+        unsigned index = 0;
+        unsigned frames = 0;
+    };
+
+    void add(Counter counter, Clock::duration duration) {
+        m_accumulated[static_cast<unsigned>(counter)].fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+    }
+    // From the emulator, for each frame emulated for real.
+    void vsync() { m_vsyncs.fetch_add(1, std::memory_order_relaxed); }
+    // From the GUI, once per host frame.
+    void endFrame();
+
+    const History& history() const { return m_history; }
+    // Averaged over the whole history.
+    float hostFPS() const;
+    float emulatedFPS() const;
+
+  private:
+    std::atomic<uint64_t> m_accumulated[c_counters] = {};
+    std::atomic<uint32_t> m_vsyncs = 0;
+    Clock::time_point m_lastFrame = Clock::now();
+    History m_history;
+};
+
+}  // namespace PCSX
@@ -20,7 +20,9 @@
 #include "core/gdb-server.h"
 
 #include <assert.h>
+#include <string.h>
 
+#include <algorithm>
 #include <magic_enum_all.hpp>
 
 #include "core/cdrom.h"
@@ -51,32 +53,26 @@ void PCSX::GdbServer::stopServer() {
     assert(m_serverStatus == SERVER_STARTED);
     m_serverStatus = SERVER_STOPPING;
     for (auto& client : m_clients) client.close();
-    uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
+    reapClients();
+    m_fifoListener.stop();
 }
 
 void PCSX::GdbServer::startServer(uv_loop_t* loop, int port) {
     assert(m_serverStatus == SERVER_STOPPED);
-
-    uv_tcp_init(loop, &m_server);
-    m_server.data = this;
-
-    struct sockaddr_in bindAddr;
-    int result = uv_ip4_addr("0.0.0.0", port, &bindAddr);
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
-    result = uv_tcp_bind(&m_server, reinterpret_cast<const sockaddr*>(&bindAddr), 0);
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
-    result = uv_listen((uv_stream_t*)&m_server, 16, onNewConnectionTrampoline);
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
     m_serverStatus = SERVER_STARTED;
+    uv_check_init(loop, &m_poll);
+    m_poll.data = this;
+    uv_check_start(&m_poll, [](uv_check_t* handle) { static_cast<GdbServer*>(handle->data)->poll(); });
+    uv_unref(reinterpret_cast<uv_handle_t*>(&m_poll));
+    m_fifoListener.start(port, loop, &m_async, [this](UvFifo* fifo) {
+        if (fifo) {
+            onNewConnection(fifo);
+        } else {
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_poll), nullptr);
+            m_async.data = this;
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_async), closeCB);
+        }
+    });
 }
 
 void PCSX::GdbServer::closeCB(uv_handle_t* handle) {
@@ -84,25 +80,32 @@ void PCSX::GdbServer::closeCB(uv_handle_t* handle) {
     self->m_serverStatus = SERVER_STOPPED;
 }
 
-void PCSX::GdbServer::onNewConnectionTrampoline(uv_stream_t* handle, int status) {
-    GdbServer* self = static_cast<GdbServer*>(handle->data);
-    self->onNewConnection(status);
+void PCSX::GdbServer::onNewConnection(UvFifo* fifo) {
+    if (m_serverStatus != SERVER_STARTED) {
+        IO<UvFifo> closing(fifo);
+        return;
+    }
+    m_clients.push_back(new GdbClient(fifo));
 }
 
-void PCSX::GdbServer::onNewConnection(int status) {
-    if (status < 0) return;
-    GdbClient* client = new GdbClient(&m_server);
-    if (client->accept(&m_server)) {
-        m_clients.push_back(client);
-    } else {
-        delete client;
+void PCSX::GdbServer::poll() {
+    for (auto& client : m_clients) client.poll();
+    reapClients();
+}
+
+void PCSX::GdbServer::reapClients() {
+    for (auto client = m_clients.begin(); client != m_clients.end();) {
+        if (!client->closed()) {
+            client++;
+            continue;
+        }
+        GdbClient* closed = &*client;
+        client = m_clients.erase(client);
+        delete closed;
     }
 }
 
-PCSX::GdbClient::GdbClient(uv_tcp_t* srv) : m_listener(g_system->m_eventBus) {
-    m_loop = srv->loop;
-    uv_tcp_init(m_loop, &m_tcp);
-    m_tcp.data = this;
+PCSX::GdbClient::GdbClient(UvFifo* fifo) : m_fifo(fifo), m_listener(g_system->m_eventBus) {
     m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) { m_exception = false; });
     m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) {
         m_exception = event.exception;
@@ -396,6 +399,55 @@ void PCSX::GdbClient::writePaged(const std::string& out, const std::string& curs
     }
 }
 
+void PCSX::GdbClient::writeBinary(char prefix, const std::string& data) {
+    std::string escaped;
+    escaped.reserve(data.length() + data.length() / 16 + 1);
+    escaped += prefix;
+    for (auto c : data) {
+        if ((c == '#') || (c == '$') || (c == '}') || (c == '*')) {
+            escaped += '}';
+            escaped += c ^ ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    write(std::move(escaped));
+}
+
+std::string PCSX::GdbClient::readMemory(uint32_t address, uint32_t length) {
+    std::string data;
+    data.resize(length);
+    char* dest = data.data();
+    IO<File> memFile;
+    while (length) {
+        uint32_t chunk = std::min(length, 0x10000 - (address & 0xffff));
+        // Straight from the memory pages where there's one, and through the memory file, which knows about
+        // the hardware registers and the holes, everywhere else.
+        auto ptr = g_emulator->m_mem->getPointer<const char>(address);
+        if (ptr) {
+            memcpy(dest, ptr, chunk);
+        } else {
+            if (!memFile) memFile = g_emulator->m_mem->getMemoryAsFile();
+            memFile->rSeek(address);
+            memFile->read(dest, chunk);
+        }
+        address += chunk;
+        dest += chunk;
+        length -= chunk;
+    }
+    return data;
+}
+
+void PCSX::GdbClient::writeMemory(uint32_t address, const std::string& data) {
+    if (((address == 0x8000f800) && (data.size() == 0x800)) || ((address == 0x8000ffea) && (data.size() == 22))) {
+        // heuristic for our ps-exe.ld and cpe.ld
+        return;
+    }
+    IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
+    memFile->wSeek(address);
+    memFile->write(data.data(), data.size());
+}
+
 void PCSX::GdbClient::writeEscaped(const std::string& out) {
     std::string escaped;
     escaped.reserve(out.length() * 2 + 1);
@@ -540,40 +592,49 @@ void PCSX::GdbClient::processCommand() {
         m_canReceiveLogs = true;
         g_system->resume();
         m_waitingForTrap = true;
-    } else if (m_cmd[0] == 'M') {
-        // write memory
-        auto elements = StringsHelpers::split(m_cmd, ":");
-        auto [off, len] = parseCursor(elements[0].substr(1));
-        if (((off == 0x8000f800) && (len == 0x800)) || ((off == 0x8000ffea) && (len == 22))) {
-            // heuristic for our ps-exe.ld and cpe.ld
-            write("OK");
+    } else if ((m_cmd[0] == 'M') || (m_cmd[0] == 'X')) {
+        // write memory, in hex or in binary; the binary data is already unescaped
+        auto colon = m_cmd.find(':');
+        if (colon == std::string::npos) {
+            write("E00");
             return;
         }
-        size_t i = 0;
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->wSeek(off);
-        while (len--) {
-            uint8_t c = fromHexChar(elements[1][i * 2 + 0]);
-            c <<= 4;
-            c |= fromHexChar(elements[1][i * 2 + 1]);
-            memFile->write(c);
-            i++;
+        auto [off, len] = parseCursor(m_cmd.substr(1, colon - 1));
+        std::string data;
+        if (m_cmd[0] == 'X') {
+            data = m_cmd.substr(colon + 1);
+        } else {
+            data.resize((m_cmd.length() - colon - 1) / 2);
+            for (size_t i = 0; i < data.size(); i++) {
+                uint8_t c = fromHexChar(m_cmd[colon + 1 + i * 2 + 0]);
+                c <<= 4;
+                c |= fromHexChar(m_cmd[colon + 1 + i * 2 + 1]);
+                data[i] = c;
+            }
         }
+        if (data.size() != len) {
+            write("E00");
+            return;
+        }
+        writeMemory(off, data);
         write("OK");
-    } else if (m_cmd[0] == 'm') {
-        // read memory
+    } else if ((m_cmd[0] == 'm') || (m_cmd[0] == 'x')) {
+        // read memory, in hex or in binary
         auto [off, len] = parseCursor(m_cmd.substr(1));
-        startStream();
-        IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
-        memFile->rSeek(off);
-        while (len--) {
-            uint8_t v = memFile->read<uint8_t>();
-            char s[3] = {0, 0, 0};
-            s[0] = toHex[v >> 4];
-            s[1] = toHex[(v & 0x0f)];
-            stream(s);
+        len = std::min<uint64_t>(len, m_cmd[0] == 'm' ? c_packetSize / 2 : c_packetSize);
+        std::string data = readMemory(off, len);
+        if (m_cmd[0] == 'x') {
+            writeBinary('b', data);
+        } else {
+            std::string hex;
+            hex.resize(data.size() * 2);
+            for (size_t i = 0; i < data.size(); i++) {
+                uint8_t v = data[i];
+                hex[i * 2 + 0] = toHex[v >> 4];
+                hex[i * 2 + 1] = toHex[v & 0x0f];
+            }
+            write(std::move(hex));
         }
-        stopStream();
     } else if ((m_cmd[0] == 'z') || (m_cmd[0] == 'Z')) {
         // insert or remove breakpoint
         enum class Action {
@@ -668,7 +729,7 @@ void PCSX::GdbClient::processCommand() {
                 multiprocess = true;
             }
         }
-        std::string answer = "PacketSize=47ff;qXfer:threads:read+;QStartNoAckMode+";
+        std::string answer = fmt::format("PacketSize={:x};qXfer:threads:read+;QStartNoAckMode+", c_packetSize);
         if (multiprocess) {
             answer += ";multiprocess+";
         }
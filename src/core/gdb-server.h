@@ -27,64 +27,62 @@
 #include "core/debug.h"
 #include "core/psxemulator.h"
 #include "support/eventbus.h"
-#include "support/hashtable.h"
 #include "support/list.h"
 #include "support/slice.h"
+#include "support/uvfile.h"
 
 namespace PCSX {
 
+// The socket itself lives on the uv thread; the client gets polled by the server, at the same safe points the
+// main loop runs at, which is where everything touching the emulator happens.
 class GdbClient : public Intrusive::List<GdbClient>::Node {
   public:
-    GdbClient(uv_tcp_t* srv);
-    ~GdbClient() {
-        assert(m_requests.size() == 0);
-        m_breakpoints.destroyAll();
-    }
+    GdbClient(UvFifo* fifo);
+    ~GdbClient() { m_breakpoints.destroyAll(); }
     typedef Intrusive::List<GdbClient> ListType;
 
-    bool accept(uv_tcp_t* srv) {
-        assert(m_status == CLOSED);
-        if (uv_accept(reinterpret_cast<uv_stream_t*>(srv), reinterpret_cast<uv_stream_t*>(&m_tcp)) == 0) {
-            uv_read_start(reinterpret_cast<uv_stream_t*>(&m_tcp), allocTrampoline, readTrampoline);
-            m_status = OPEN;
-        }
-        return m_status == OPEN;
-    }
+    // The client goes away at the server's next poll.
     void close() {
         if (m_status != OPEN) return;
-        m_status = CLOSING;
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_tcp), closeCB);
+        m_status = CLOSED;
+        m_fifo->close();
+    }
+    bool closed() const { return m_status != OPEN; }
+    void poll() {
+        while ((m_status == OPEN) && (m_fifo->size() != 0)) {
+            auto nread = m_fifo->read(m_buffer, sizeof(m_buffer));
+            if (nread <= 0) break;
+            Slice slice;
+            slice.borrow(m_buffer, nread);
+            processData(slice);
+        }
+        if ((m_status == OPEN) && m_fifo->eof()) close();
     }
 
   private:
-    void write(const Slice& slice) {
-        auto* req = new WriteRequest();
-        req->m_slice = slice;
-        req->enqueue(this);
-    }
+    void write(const Slice& slice) { enqueue(Slice(slice)); }
     void write(const std::string& msg) {
-        auto* req = new WriteRequest();
         assert(msg.size() <= std::numeric_limits<uint32_t>::max());
-        req->m_slice.copy(msg);
-        req->enqueue(this);
+        Slice slice;
+        slice.copy(msg);
+        enqueue(std::move(slice));
     }
     void write(std::string&& msg) {
-        auto* req = new WriteRequest();
         assert(msg.size() <= std::numeric_limits<uint32_t>::max());
-        req->m_slice.acquire(std::move(msg));
-        req->enqueue(this);
+        Slice slice;
+        slice.acquire(std::move(msg));
+        enqueue(std::move(slice));
     }
     template <size_t L>
     void write(const char (&str)[L]) {
-        auto* req = new WriteRequest();
         static_assert((L - 1) <= std::numeric_limits<uint32_t>::max());
-        req->m_slice.borrow(str, L - 1);
-        req->enqueue(this);
+        Slice slice;
+        slice.borrow(str, L - 1);
+        enqueue(std::move(slice));
     }
     void writef(const char* fmt, ...) {
         va_list a;
         va_start(a, fmt);
-        auto* req = new WriteRequest();
         size_t len;
         char* msg;
 #ifdef _WIN32
@@ -94,137 +92,98 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
 #else
         len = vasprintf(&msg, fmt, a);
 #endif
-        req->m_slice.acquire(msg, len);
-        req->enqueue(this);
+        Slice slice;
+        slice.acquire(msg, len);
+        enqueue(std::move(slice));
         va_end(a);
     }
     void writePaged(const std::string& out, const std::string& cursorStr);
+    // Binary packets need the framing characters escaped, on top of what enqueue() does
+    void writeBinary(char prefix, const std::string& data);
     void writeEscaped(const std::string& out);
     void sendAck() {
-        auto* req = new WriteRequest();
-        req->m_slice.copy("+", 1);
-        req->enqueueRaw(this);
+        Slice slice;
+        slice.copy("+", 1);
+        enqueueRaw(std::move(slice));
     }
 
     void startStream() {
         m_crc = 0;
-        auto* req = new WriteRequest();
-        req->m_slice.copy("$", 1);
-        req->enqueueRaw(this);
+        Slice slice;
+        slice.copy("$", 1);
+        enqueueRaw(std::move(slice));
     }
 
     void stream(const std::string& data) {
         for (int i = 0; i < data.length(); i++) {
             m_crc += data[i];
         }
-        auto* req = new WriteRequest();
-        req->m_slice.copy(data.data(), data.size());
-        req->enqueueRaw(this);
+        Slice slice;
+        slice.copy(data.data(), data.size());
+        enqueueRaw(std::move(slice));
     }
 
     void stopStream() {
-        auto* req = new WriteRequest();
         char end[3] = {'#'};
         end[1] = toHex[m_crc >> 4];
         end[2] = toHex[m_crc & 0x0f];
-        req->m_slice.copy(end, 3);
-        req->enqueueRaw(this);
+        Slice slice;
+        slice.copy(end, 3);
+        enqueueRaw(std::move(slice));
     }
 
     static const char toHex[];
-    struct WriteRequest : public Intrusive::HashTable<uintptr_t, WriteRequest>::Node {
-        void enqueue(GdbClient* client) {
-            if (g_emulator->settings.get<Emulator::SettingDebugSettings>()
-                    .get<Emulator::DebugSettings::GdbServerTrace>()) {
-                std::string msg((const char*)m_slice.data(), m_slice.size());
-                g_system->log(LogClass::GDB, "GDB <-- PCSX %s\n", msg.c_str());
-            }
-            m_bufs[0].base = &m_before;
-            m_bufs[0].len = 1;
-            m_bufs[1].base = static_cast<char*>(const_cast<void*>(m_slice.data()));
-            m_bufs[1].len = m_slice.size();
-            m_bufs[2].base = m_after;
-            m_bufs[2].len = 3;
-            uint8_t chksum = 0;
-            auto data = m_bufs[1].base;
-            auto len = m_bufs[1].len;
-            for (int i = 0; i < len; i++) {
-                chksum += *data++;
-            }
-            m_after[1] = toHex[chksum >> 4];
-            m_after[2] = toHex[chksum & 0x0f];
-            client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
-            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), m_bufs, 3, writeCB);
-        }
-        void enqueueRaw(GdbClient* client) {
-            if (g_emulator->settings.get<Emulator::SettingDebugSettings>()
-                    .get<Emulator::DebugSettings::GdbServerTrace>()) {
-                std::string msg((const char*)m_slice.data(), m_slice.size());
-                g_system->log(LogClass::GDB, "GDB <-- PCSX %s\n", msg.c_str());
-            }
-            m_bufs[0].base = static_cast<char*>(const_cast<void*>(m_slice.data()));
-            m_bufs[0].len = m_slice.size();
-            client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
-            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), m_bufs, 1, writeCB);
+    // Sends the slice as a packet, in between its framing characters, without copying it.
+    void enqueue(Slice&& slice) {
+        trace(slice);
+        uint8_t chksum = 0;
+        auto data = slice.data<uint8_t>();
+        auto len = slice.size();
+        for (int i = 0; i < len; i++) {
+            chksum += *data++;
         }
-        static void writeCB(uv_write_t* request, int status) {
-            GdbClient* client = static_cast<GdbClient*>(request->handle->data);
-            auto self = client->m_requests.find(reinterpret_cast<uintptr_t>(request));
-            delete &*self;
-            if (status != 0) client->close();
-        }
-        uv_write_t m_req;
-        char m_before = '$';
-        char m_after[3] = {'#'};
-        uv_buf_t m_bufs[3];
-        Slice m_slice;
-    };
-    friend struct WriteRequest;
-    Intrusive::HashTable<uintptr_t, WriteRequest> m_requests;
-    static constexpr size_t BUFFER_SIZE = 256;
-    static void allocTrampoline(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
-        GdbClient* client = static_cast<GdbClient*>(handle->data);
-        client->alloc(suggestedSize, buf);
-    }
-    void alloc(size_t suggestedSize, uv_buf_t* buf) {
-        assert(!m_allocated);
-        m_allocated = true;
-        buf->base = m_buffer;
-        buf->len = sizeof(m_buffer);
-    }
-    static void readTrampoline(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-        GdbClient* client = static_cast<GdbClient*>(stream->data);
-        client->read(nread, buf);
-    }
-    void read(ssize_t nread, const uv_buf_t* buf) {
-        m_allocated = false;
-        if (nread <= 0) {
-            close();
-            return;
+        char after[3] = {'#'};
+        after[1] = toHex[chksum >> 4];
+        after[2] = toHex[chksum & 0x0f];
+        SliceChain chain;
+        chain.append("$");
+        chain.append(std::move(slice));
+        Slice end;
+        end.copy(after, 3);
+        chain.append(std::move(end));
+        if (m_status == OPEN) m_fifo->write(std::move(chain));
+    }
+    void enqueueRaw(Slice&& slice) {
+        trace(slice);
+        if (m_status == OPEN) m_fifo->write(std::move(slice));
+    }
+    void trace(const Slice& slice) {
+        if (g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                .get<Emulator::DebugSettings::GdbServerTrace>()) {
+            std::string msg((const char*)slice.data(), slice.size());
+            g_system->log(LogClass::GDB, "GDB <-- PCSX %s\n", msg.c_str());
         }
-        Slice slice;
-        slice.borrow(m_buffer, nread);
-        processData(slice);
-    }
-    static void closeCB(uv_handle_t* handle) {
-        GdbClient* client = static_cast<GdbClient*>(handle->data);
-        delete client;
     }
+    // What we tell the client it can send us, and how much memory we'll send back in one go. Memory views
+    // and dumps go in reads of about this size, so the larger, the fewer round trips.
+    static constexpr size_t c_packetSize = 0x20000;
+    static constexpr size_t BUFFER_SIZE = 16384;
     void processData(const Slice& slice);
     void processCommand();
     void processMonitorCommand(const std::string&);
     Slice passthroughData(Slice slice);
     std::pair<uint64_t, uint64_t> parseCursor(const std::string& cursorStr);
+    std::string readMemory(uint32_t address, uint32_t length);
+    void writeMemory(uint32_t address, const std::string& data);
 
     std::string dumpOneRegister(int n);
     void setOneRegister(int n, uint32_t value);
     static std::string dumpValue(uint32_t value);
 
-    uv_tcp_t m_tcp;
-    enum { CLOSED, OPEN, CLOSING } m_status = CLOSED;
+    IO<UvFifo> m_fifo;
+    enum { OPEN, CLOSED } m_status = OPEN;
 
     char m_buffer[BUFFER_SIZE];
-    bool m_allocated = false;
     enum {
         WAIT_FOR_ACK,
         WAIT_FOR_DOLLAR,
@@ -244,7 +203,6 @@ class GdbClient : public Intrusive::List<GdbClient>::Node {
     std::string m_cmd;
     uint8_t m_crc;
     EventBus::Listener m_listener;
-    uv_loop_t* m_loop;
     Debug::BreakpointUserListType m_breakpoints;
 };
 
@@ -258,15 +216,20 @@ class GdbServer {
     };
     GdbServerStatus getServerStatus() { return m_serverStatus; }
 
+    // The connections are accepted and served on the uv thread; the loop is where the clients get polled, at each
+    // of its iterations.
     void startServer(uv_loop_t* loop, int port = 3333);
     void stopServer();
 
   private:
-    static void onNewConnectionTrampoline(uv_stream_t* server, int status);
-    void onNewConnection(int status);
+    void onNewConnection(UvFifo* fifo);
+    void poll();
+    void reapClients();
     static void closeCB(uv_handle_t* handle);
     GdbServerStatus m_serverStatus = SERVER_STOPPED;
-    uv_tcp_t m_server;
+    UvFifoListener m_fifoListener;
+    uv_async_t m_async;
+    uv_check_t m_poll;
     GdbClient::ListType m_clients;
     EventBus::Listener m_listener;
     std::string m_gotError;
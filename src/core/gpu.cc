@@ -24,12 +24,14 @@
 #include <magic_enum_all.hpp>
 
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpulogger.h"
-#include "core/pgxp_mem.h"
 #include "core/psxdma.h"
 #include "core/psxhw.h"
 #include "imgui/imgui.h"
 #include "imgui/imgui_internal.h"
+#include "support/hashing.h"
+#include "tracy/Tracy.hpp"
 
 #define GPUSTATUS_READYFORVRAM 0x08000000
 #define GPUSTATUS_IDLE 0x04000000  // CMD ready
@@ -37,6 +39,15 @@
 
 namespace PCSX {
 
+namespace {
+
+uint64_t triangleArea(int x0, int y0, int x1, int y1, int x2, int y2) {
+    const int64_t cross = int64_t(x1 - x0) * (y2 - y0) - int64_t(x2 - x0) * (y1 - y0);
+    return (cross < 0 ? -cross : cross) / 2;
+}
+
+}  // namespace
+
 // clang-format off
 // clang-format doesn't understand duff's device pattern...
 template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
@@ -87,6 +98,46 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
             }
         }
     }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Poly<shading, shape, textured, blend, modulation>::processPacket(const uint32_t * packet, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
+    for (unsigned i = 0; i < count; i++) {
+        // The first color is in the command word, even for flat shaded polygons
+        if ((shading == Shading::Gouraud) || (i == 0)) {
+            const uint32_t value = SWAP_LE32(*packet++);
+            if constexpr ((textured == Textured::Yes) && (modulation == Modulation::Off)) {
+                colors[i] = 0x808080;
+            } else {
+                colors[i] = value & 0xffffff;
+            }
+        } else {
+            colors[i] = colors[0];
+        }
+        const uint32_t xy = SWAP_LE32(*packet++);
+        x[i] = GPU::signExtend<int, 11>(xy & 0xffff);
+        y[i] = GPU::signExtend<int, 11>(xy >> 16);
+        if constexpr (textured == Textured::Yes) {
+            uint32_t value = SWAP_LE32(*packet++);
+            u[i] = value & 0xff;
+            v[i] = (value >> 8) & 0xff;
+            value >>= 16;
+            if (i == 0) {
+                clutraw = value;
+            } else if (i == 1) {
+                value &= 0b0000100111111111;
+                tpage = TPage(value);
+                uint32_t lastTPage = m_gpu->m_lastTPage.raw & ~0b0000100111111111;
+                m_gpu->m_lastTPage = TPage(lastTPage | value);
+            }
+        }
+    }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Shading shading, GPU::Shape shape, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Poly<shading, shape, textured, blend, modulation>::finish(Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     m_count = 0;
     m_state = READ_COLOR;
     if constexpr (textured == Textured::Yes) {
@@ -95,6 +146,11 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    m_gpu->markDrawingAreaDirty();
+    uint64_t pixels = triangleArea(x[0], y[0], x[1], y[1], x[2], y[2]);
+    if constexpr (shape == Shape::Quad) pixels += triangleArea(x[1], y[1], x[2], y[2], x[3], y[3]);
+    m_gpu->count(Counter::Triangles, shape == Shape::Quad ? 2 : 1);
+    m_gpu->count(Counter::Pixels, pixels);
     m_gpu->write0(this);
 }
 
@@ -145,6 +201,27 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
             }
         }
     }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
+void GPU::Line<shading, lineType, blend>::processPacket(const uint32_t * packet, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
+    static_assert(lineType == LineType::Simple, "Poly lines don't have a fixed size");
+    for (unsigned i = 0; i < 2; i++) {
+        if ((shading == Shading::Gouraud) || (i == 0)) {
+            colors[i] = SWAP_LE32(*packet++) & 0xffffff;
+        } else {
+            colors[i] = colors[0];
+        }
+        const uint32_t xy = SWAP_LE32(*packet++);
+        x[i] = GPU::signExtend<int, 11>(xy & 0xffff);
+        y[i] = GPU::signExtend<int, 11>(xy >> 16);
+    }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Shading shading, GPU::LineType lineType, GPU::Blend blend>
+void GPU::Line<shading, lineType, blend>::finish(Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     if constexpr (lineType == LineType::Simple) {
         m_count = 0;
     }
@@ -153,6 +230,13 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
     m_gpu->m_defaultProcessor.setActive();
     if ((colors.size() >= 2) && ((colors.size() == x.size()))) {
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+        m_gpu->markDrawingAreaDirty();
+        uint64_t pixels = 0;
+        for (size_t i = 1; i < x.size(); i++) {
+            pixels += std::max(std::abs(x[i] - x[i - 1]), std::abs(y[i] - y[i - 1])) + 1;
+        }
+        m_gpu->count(Counter::Lines, x.size() - 1);
+        m_gpu->count(Counter::Pixels, pixels);
         m_gpu->write0(this);
     } else {
         g_system->log(LogClass::GPU, "Got an invalid line command...\n");
@@ -213,6 +297,43 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
                 h = value >> 16;
             }
     }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Rect<size, textured, blend, modulation>::processPacket(const uint32_t * packet, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
+    const uint32_t value = SWAP_LE32(*packet++);
+    if constexpr ((textured == Textured::No) || (modulation == Modulation::On)) {
+        color = value & 0xffffff;
+    }
+    const uint32_t xy = SWAP_LE32(*packet++);
+    x = GPU::signExtend<int, 11>(xy & 0xffff);
+    y = GPU::signExtend<int, 11>(xy >> 16);
+    if constexpr (textured == Textured::Yes) {
+        const uint32_t uv = SWAP_LE32(*packet++);
+        u = uv & 0xff;
+        v = (uv >> 8) & 0xff;
+        clutraw = uv >> 16;
+    }
+    if constexpr (size == Size::S1) {
+        h = 1;
+        w = 1;
+    } else if constexpr (size == Size::S8) {
+        h = 8;
+        w = 8;
+    } else if constexpr (size == Size::S16) {
+        h = 16;
+        w = 16;
+    } else {
+        const uint32_t hw = SWAP_LE32(*packet++);
+        w = hw & 0xffff;
+        h = hw >> 16;
+    }
+    finish(origin, origvalue, length);
+}
+
+template <GPU::Size size, GPU::Textured textured, GPU::Blend blend, GPU::Modulation modulation>
+void GPU::Rect<size, textured, blend, modulation>::finish(Logged::Origin origin, uint32_t origvalue, uint32_t length) {
     m_state = READ_COLOR;
     if constexpr (textured == Textured::Yes) {
         tpage = TPage(m_gpu->m_lastTPage.raw);
@@ -221,12 +342,69 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    m_gpu->markDrawingAreaDirty();
+    m_gpu->count(Counter::Rectangles);
+    m_gpu->count(Counter::Pixels, uint64_t(w) * h);
     m_gpu->write0(this);
 }
 // clang-format on
 
 namespace {
 
+// The number of words of a GP0 packet that can be decoded in one go, or 0 if it has to go through the state machines
+constexpr unsigned packetLength(uint8_t opcode) {
+    const uint8_t command = opcode & 0x1f;
+    const bool gouraud = command & 0x10;
+    const bool textured = command & 0x04;
+    switch (opcode >> 5) {
+        case 1: {  // Polygon primitive
+            const unsigned vertices = (command & 0x08) ? 4 : 3;
+            return vertices * (textured ? 2 : 1) + (gouraud ? vertices : 1);
+        }
+        case 2:  // Line primitive, poly lines are terminated by a marker instead
+            if (command & 0x08) return 0;
+            return gouraud ? 4 : 3;
+        case 3: {  // Rectangle primitive
+            const bool variableSize = (command & 0x18) == 0;
+            return 2 + (textured ? 1 : 0) + (variableSize ? 1 : 0);
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+template <uint8_t opcode>
+void GPU::parsePacket(GPU *gpu, const uint32_t *packet, Logged::Origin origin, uint32_t value, uint32_t length) {
+    constexpr uint8_t command = opcode & 0x1f;
+    constexpr Shading shading = (command & 0x10) ? Shading::Gouraud : Shading::Flat;
+    constexpr Textured textured = (command & 0x04) ? Textured::Yes : Textured::No;
+    constexpr Blend blend = (command & 0x02) ? Blend::Semi : Blend::Off;
+    constexpr Modulation modulation = (command & 0x01) ? Modulation::Off : Modulation::On;
+    // These have to match the instances the constructor puts in m_polygons, m_lines and m_rects
+    if constexpr ((opcode >> 5) == 1) {
+        constexpr Shape shape = (command & 0x08) ? Shape::Quad : Shape::Tri;
+        using Primitive = Poly<shading, shape, textured, blend, modulation>;
+        static_cast<Primitive *>(gpu->m_polygons[command])->processPacket(packet, origin, value, length);
+    } else if constexpr ((opcode >> 5) == 2) {
+        using Primitive = Line<shading, LineType::Simple, blend>;
+        static_cast<Primitive *>(gpu->m_lines[command])->processPacket(packet, origin, value, length);
+    } else if constexpr ((opcode >> 5) == 3) {
+        constexpr Size sizes[4] = {Size::Variable, Size::S1, Size::S8, Size::S16};
+        using Primitive = Rect<sizes[command >> 3], textured, blend, modulation>;
+        static_cast<Primitive *>(gpu->m_rects[command])->processPacket(packet, origin, value, length);
+    }
+}
+
+constexpr std::array<GPU::PacketParser, 256> GPU::generatePacketParsers() {
+    return []<size_t... opcodes>(std::index_sequence<opcodes...>) {
+        return std::array<PacketParser, 256>{
+            PacketParser{packetLength(opcodes), packetLength(opcodes) != 0 ? &parsePacket<opcodes> : nullptr}...};
+    }(std::make_index_sequence<256>());
+}
+
+namespace {
+
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Off, GPU::Modulation::On> s_poly00;
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Off, GPU::Modulation::Off> s_poly01;
 GPU::Poly<GPU::Shading::Flat, GPU::Shape::Tri, GPU::Textured::No, GPU::Blend::Semi, GPU::Modulation::On> s_poly02;
@@ -415,6 +593,8 @@ int PCSX::GPU::init(UI *ui) {
     m_drawingStartRaw = 0;
     m_drawingEndRaw = 0;
     m_drawingOffsetRaw = 0;
+    m_maskBitRaw = 0;
+    m_lastTPage = TPage(0);
     m_dataRet = 0x400;
     return initBackend(ui);
 }
@@ -434,57 +614,8 @@ inline bool PCSX::GPU::CheckForEndlessLoop(uint32_t laddr) {
     return false;
 }
 
-uint32_t PCSX::GPU::gpuDmaChainSize(uint32_t addr) {
-    uint32_t size;
-    uint32_t DMACommandCounter = 0;
-    bool usingMsan = g_emulator->m_mem->msanInitialized();
-
-    s_usedAddr[0] = s_usedAddr[1] = s_usedAddr[2] = 0xffffff;
-
-    // initial linked list s_ptr (word)
-    size = 1;
-
-    do {
-        uint32_t header;
-        if (usingMsan && PCSX::Memory::inMsanRange(addr)) {
-            addr &= 0xfffffffc;
-            switch (g_emulator->m_mem->msanGetStatus<4>(addr)) {
-                case PCSX::MsanStatus::UNINITIALIZED:
-                    g_system->log(LogClass::GPU, _("GPU DMA went into usable but uninitialized msan memory: %8.8lx\n"),
-                                  addr);
-                    g_system->pause();
-                    return size;
-                case PCSX::MsanStatus::UNUSABLE:
-                    g_system->log(LogClass::GPU, _("GPU DMA went into unusable msan memory: %8.8lx\n"), addr);
-                    g_system->pause();
-                    return size;
-                case PCSX::MsanStatus::OK:
-                    header = *(uint32_t *)(g_emulator->m_mem->m_msanRAM + (addr - PCSX::Memory::c_msanStart));
-                    break;
-            }
-        } else {
-            addr &= g_emulator->getRamMask<4>();
-            header = SWAP_LEu32(*g_emulator->m_mem->getPointer<uint32_t>(addr));
-        }
-
-        if (DMACommandCounter++ > 2000000) break;
-        if (CheckForEndlessLoop(addr)) break;
-
-        // # 32-bit blocks to transfer
-        size += (header >> 24) + 1;
-
-        // next 32-bit pointer
-        uint32_t nextAddr = header & 0xffffff;
-        if (usingMsan && nextAddr == PCSX::Memory::c_msanChainMarker) {
-            addr = g_emulator->m_mem->msanGetChainPtr(addr);
-            continue;
-        }
-        addr = nextAddr;
-    } while (!(addr & 0x800000));  // contrary to some documentation, the end-of-linked-list marker is not actually
-    return size;  // 0xFF'FFFF any pointer with bit 23 set will do.
-}
-
 uint32_t PCSX::GPU::readStatus() {
+    syncCommands();
     uint32_t ret = readStatusInternal();  // Get status from GPU core
 
 // Gameshark Lite - wants to see VRAM busy
@@ -513,17 +644,13 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
             // BA blocks * BS words (word = 32-bits)
             size = (bcr >> 16) * (bcr & 0xffff);
             directDMARead(ptr, size, madr);
+            g_emulator->m_mem->msanCheckDMA(2, madr, size * 4, true);
             g_emulator->m_cpu->Clear(madr, size);
+            g_emulator->m_mem->markRAMDirty(madr, size * 4);
             if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
                 g_emulator->m_debug->checkDMAwrite(2, madr, size * 4);
             }
-#if 1
-            // already 32-bit word size ((size * 4) / 4)
-            scheduleGPUDMAIRQ(size);
-#else
-            // Experimental burst dma transfer (0.333x max)
-            scheduleGPUDMAIRQ(size / 3);
-#endif
+            scheduleGPUDMAIRQ(DMACost::gpuDownload(size));
             return;
 
         case 0x01000201:  // mem2vram
@@ -531,32 +658,17 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
             size = (bcr >> 16) * bs;  // BA blocks * BS words (word = 32-bits)
             PSXDMA_LOG("*** DMA 2 - GPU mem2vram *** %lx addr = %lxh, BCR %lxh => size %d = BA(%d) * BS(%xh)\n", chcr,
                        madr, bcr, size, size / bs, size / (bcr >> 16));
-            ptr = g_emulator->m_mem->getPointer<uint32_t>(madr);
-            if (ptr == nullptr) {
-                PSXDMA_LOG("*** DMA2 GPU - mem2vram *** NULL Pointer!!!\n");
-                break;
+            if (const uint32_t cycles = stepUploadDMA()) {
+                scheduleGPUDMAIRQ(cycles);
+                return;
             }
-            if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-                g_emulator->m_debug->checkDMAread(2, madr, size * 4);
-            }
-            pgxpMemory(PGXP_ConvertAddress(madr), PGXP_GetMem());
-            directDMAWrite(ptr, size, madr);
-
-#if 0
-            // already 32-bit word size ((size * 4) / 4)
-            scheduleGPUDMAIRQ(size);
-#else
-            // X-Files video interlace. Experimental delay depending of BS.
-            scheduleGPUDMAIRQ((7 * size) / bs);
-#endif
-            return;
+            break;
 
         case 0x00000401:  // Vampire Hunter D: title screen linked list update (see psxhw.c)
         case 0x01000401:  // dma chain
             PSXDMA_LOG("*** DMA 2 - GPU dma chain *** %8.8lx addr = %lx size = %lx\n", chcr, madr, bcr);
 
-            size = gpuDmaChainSize(madr);
-            chainedDMAWrite((uint32_t *)PCSX::g_emulator->m_mem->m_wram, madr);
+            size = chainedDMAWrite((uint32_t *)PCSX::g_emulator->m_mem->m_wram, madr);
 
             // Tekken 3 = use 1.0 only (not 1.5x)
 
@@ -575,8 +687,33 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
     gpuInterrupt();
 }
 
+// Large uploads go to the GPU a chunk at a time, see stepBlockDMA.
+uint32_t PCSX::GPU::stepUploadDMA() {
+    return stepBlockDMA<2>(
+        [](uint32_t madr, uint32_t words) {
+            uint32_t *ptr = g_emulator->m_mem->getPointer<uint32_t>(madr);
+            if (ptr == nullptr) {
+                PSXDMA_LOG("*** DMA2 GPU - mem2vram *** NULL Pointer!!!\n");
+                return;
+            }
+            if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+                g_emulator->m_debug->checkDMAread(2, madr, words * 4);
+            }
+            g_emulator->m_mem->msanCheckDMA(2, madr, words * 4, false);
+            g_emulator->m_gpu->directDMAWrite(ptr, words, madr);
+        },
+        DMACost::gpuUpload);
+}
+
 void PCSX::GPU::gpuInterrupt() {
     auto &mem = g_emulator->m_mem;
+    // Whatever is left of an upload goes on, unless it got stopped in the meantime.
+    if (mem->getCHCR<2>() == 0x01000201) {
+        if (const uint32_t cycles = stepUploadDMA()) {
+            scheduleGPUDMAIRQ(cycles);
+            return;
+        }
+    }
     mem->clearDMABusy<2>();
     mem->dmaInterrupt<2>();
 }
@@ -585,7 +722,12 @@ void PCSX::GPU::writeStatus(uint32_t value) {
     uint32_t cmd = (value >> 24) & 0xff;
     bool gotUnknown = false;
 
+    // The control port shares its state with the command stream, so it's simpler to process it in place.
+    syncCommands();
     m_statusControl[cmd] = value;
+    if (m_capture) [[unlikely]] {
+        m_capture->events.push_back({uint32_t(m_capture->words.size()), GPUCapture::Event::Type::GP1, value});
+    }
 
     switch (cmd) {
         case 0: {
@@ -599,6 +741,7 @@ void PCSX::GPU::writeStatus(uint32_t value) {
             m_drawingStartRaw = 0;
             m_drawingEndRaw = 0;
             m_drawingOffsetRaw = 0;
+            m_maskBitRaw = 0;
             m_dataRet = 0x400;
         } break;
         case 1: {
@@ -657,6 +800,7 @@ void PCSX::GPU::writeStatus(uint32_t value) {
 }
 
 uint32_t PCSX::GPU::readData() {
+    syncCommands();
     if (m_readFifo->size() == 0) {
         return m_dataRet;
     }
@@ -681,11 +825,24 @@ void PCSX::GPU::write1(CtrlQuery *ctrl) {
 }
 
 void PCSX::GPU::writeData(uint32_t value) {
+    const uint32_t word = SWAP_LE32(value);
+    captureGP0(&word, 1);
+    if (queueingCommands()) {
+        queueCommands(Logged::Origin::DATAWRITE, value, 1, &word, 1);
+        m_commandRing->publish();
+        return;
+    }
     Buffer buf(value);
     m_processor->processWrite(buf, Logged::Origin::DATAWRITE, value, 1);
 }
 
 void PCSX::GPU::directDMAWrite(const uint32_t *feed, int transferSize, uint32_t hwAddr) {
+    captureGP0(feed, transferSize);
+    if (queueingCommands()) {
+        queueCommands(Logged::Origin::DIRECT_DMA, hwAddr, transferSize, feed, transferSize);
+        m_commandRing->publish();
+        return;
+    }
     Buffer buf(feed, transferSize);
     while (!buf.isEmpty()) {
         m_processor->processWrite(buf, Logged::Origin::DIRECT_DMA, hwAddr, transferSize);
@@ -693,6 +850,7 @@ void PCSX::GPU::directDMAWrite(const uint32_t *feed, int transferSize, uint32_t
 }
 
 void PCSX::GPU::directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr) {
+    syncCommands();
     auto size = m_readFifo->size();
     m_readFifo->read(dest, transferSize * 4);
     transferSize -= size / 4;
@@ -702,12 +860,18 @@ void PCSX::GPU::directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr)
     }
 }
 
-void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
+// Walks the linked list once, collecting the packets' payloads where they sit in memory, and returns the size of
+// the whole chain in words, headers included, which is what the DMA interrupt gets scheduled from.
+uint32_t PCSX::GPU::gatherDMAChain(const uint32_t *memory, uint32_t hwAddr) {
     uint32_t addr = hwAddr;
     uint32_t DMACommandCounter = 0;
     bool usingMsan = g_emulator->m_mem->msanInitialized();
 
     s_usedAddr[0] = s_usedAddr[1] = s_usedAddr[2] = 0xffffff;
+    m_chainPackets.clear();
+
+    // initial linked list s_ptr (word)
+    uint32_t size = 1;
 
     do {
         uint32_t header;
@@ -720,11 +884,11 @@ void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
                     g_system->log(LogClass::GPU, _("GPU DMA went into usable but uninitialized msan memory: %8.8lx\n"),
                                   addr);
                     g_system->pause();
-                    return;
+                    return size;
                 case PCSX::MsanStatus::UNUSABLE:
                     g_system->log(LogClass::GPU, _("GPU DMA went into unusable msan memory: %8.8lx\n"), addr);
                     g_system->pause();
-                    return;
+                    return size;
                 case PCSX::MsanStatus::OK:
                     break;
             }
@@ -741,10 +905,9 @@ void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
 
         // # 32-bit blocks to transfer
         uint32_t transferWords = header >> 24;
-        Buffer buf(feed, transferWords);
-        while (!buf.isEmpty()) {
-            m_processor->processWrite(buf, Logged::Origin::CHAIN_DMA, addr, transferWords);
-        }
+        size += transferWords + 1;
+        // Empty nodes are only there to link the ordering table together, the parser has nothing to do with them
+        if (transferWords != 0) m_chainPackets.push_back({addr, std::span<const uint32_t>(feed, transferWords)});
 
         // next 32-bit pointer
         uint32_t nextAddr = header & 0xffffff;
@@ -754,10 +917,186 @@ void PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
         }
         addr = nextAddr;
     } while (!(addr & 0x800000));  // contrary to some documentation, the end-of-linked-list marker is not actually
-}  // 0xFF'FFFF any pointer with bit 23 set will do.
+    return size;  // 0xFF'FFFF any pointer with bit 23 set will do.
+}
+
+uint32_t PCSX::GPU::chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr) {
+    const uint32_t size = gatherDMAChain(memory, hwAddr);
+    count(Counter::DMAChains);
+    count(Counter::DMAChainPackets, m_chainPackets.size());
+    count(Counter::DMAChainWords, size);
+    if (m_capture) [[unlikely]] {
+        for (const auto &packet : m_chainPackets) captureGP0(packet.words.data(), packet.words.size());
+    }
+
+    // The command thread gets its own copy of the packets, as the game is free to reuse the chain once the DMA
+    // is done with it.
+    if (queueingCommands()) {
+        for (const auto &packet : m_chainPackets) {
+            const uint32_t transferWords = packet.words.size();
+            queueCommands(Logged::Origin::CHAIN_DMA, packet.addr, transferWords, packet.words.data(), transferWords);
+        }
+        m_commandRing->publish();
+        return size;
+    }
+
+    // Nothing the parser does can write back to main RAM, so the packets can't change under our feet
+    for (const auto &packet : m_chainPackets) {
+        const uint32_t transferWords = packet.words.size();
+        Buffer buf(packet.words.data(), transferWords);
+        while (!buf.isEmpty()) {
+            m_processor->processWrite(buf, Logged::Origin::CHAIN_DMA, packet.addr, transferWords);
+        }
+    }
+
+    return size;
+}
+
+void PCSX::GPU::startCapture() {
+    syncCommands();
+    m_capture = std::make_unique<GPUCapture>();
+    auto vram = getVRAM(Ownership::BORROW);
+    auto pixels = reinterpret_cast<const uint16_t *>(vram.data());
+    m_capture->vram.assign(pixels, pixels + GPUCapture::c_vramPixels);
+    // The same order restoring a save state goes with
+    for (unsigned cmd : {3, 8, 6, 7, 5, 4}) {
+        m_capture->events.push_back({0, GPUCapture::Event::Type::GP1, m_statusControl[cmd]});
+    }
+    m_capture->words = {
+        0xe1000000 | (m_lastTPage.raw & 0xffffff), 0xe2000000 | m_textureWindowRaw, 0xe3000000 | m_drawingStartRaw,
+        0xe4000000 | m_drawingEndRaw,              0xe5000000 | m_drawingOffsetRaw,  0xe6000000 | m_maskBitRaw,
+    };
+}
+
+std::unique_ptr<PCSX::GPUCapture> PCSX::GPU::stopCapture() { return std::move(m_capture); }
+
+void PCSX::GPU::countersVSync() {
+    // The backend is the only one to know about its flushes, so they get picked up from there.
+    m_counterTotals[static_cast<unsigned>(Counter::Flushes)].store(flushCount(), std::memory_order_relaxed);
+    for (unsigned i = 0; i < c_counters; i++) {
+        const uint64_t total = m_counterTotals[i].load(std::memory_order_relaxed);
+        m_lastFrameCounters[i] = total - m_previousTotals[i];
+        m_previousTotals[i] = total;
+    }
+}
+
+std::string_view PCSX::GPU::counterName(Counter counter) {
+    switch (counter) {
+        case Counter::Triangles:
+            return "triangles";
+        case Counter::Lines:
+            return "lines";
+        case Counter::Rectangles:
+            return "rectangles";
+        case Counter::Fills:
+            return "fills";
+        case Counter::VRAMCopies:
+            return "vramCopies";
+        case Counter::Pixels:
+            return "pixels";
+        case Counter::VRAMUploadBytes:
+            return "vramUploadBytes";
+        case Counter::VRAMDownloadBytes:
+            return "vramDownloadBytes";
+        case Counter::DMAChains:
+            return "dmaChains";
+        case Counter::DMAChainPackets:
+            return "dmaChainPackets";
+        case Counter::DMAChainWords:
+            return "dmaChainWords";
+        case Counter::Flushes:
+            return "flushes";
+        case Counter::Count:
+            break;
+    }
+    return "";
+}
+
+namespace {
+
+thread_local bool s_onCommandThread = false;
+
+}  // namespace
+
+void PCSX::GPU::startCommandThread() {
+    stopCommandThread();
+    if (!m_commandRing) m_commandRing.reset(new CommandRing());
+    m_commandThreadStopping = false;
+    m_commandThread = std::thread([this, context = EmulatorContext::current()]() {
+        EmulatorContext::Scope scope(context);
+        commandThreadLoop();
+    });
+}
+
+void PCSX::GPU::stopCommandThread() {
+    if (!m_commandThread.joinable()) return;
+    m_commandRing->drain();
+    m_commandThreadStopping = true;
+    m_commandRing->wakeConsumer();
+    m_commandThread.join();
+}
+
+void PCSX::GPU::syncCommands() {
+    if (s_onCommandThread || !m_commandThread.joinable()) return;
+    m_commandRing->drain();
+}
+
+// The logger needs to run on the main thread, so enabling it moves the command stream back there, right after
+// whatever is still in the ring.
+bool PCSX::GPU::queueingCommands() {
+    if (!m_commandThread.joinable()) return false;
+    if (!g_emulator->m_gpuLogger->isEnabled()) return true;
+    m_commandRing->drain();
+    return false;
+}
+
+// Large transfers are cut into several records; the parsers are already able to deal with packets split across
+// buffers, the same way they are when split across DMA chain nodes.
+void PCSX::GPU::queueCommands(Logged::Origin origin, uint32_t originValue, uint32_t length, const uint32_t *words,
+                              size_t count) {
+    while (count != 0) {
+        const size_t chunk = std::min(count, c_maxCommandRecord);
+        const uint32_t header[3] = {static_cast<uint32_t>(chunk) | (static_cast<uint32_t>(origin) << 28), originValue,
+                                    length};
+        m_commandRing->reserve(chunk + 3);
+        m_commandRing->write(header, 3);
+        m_commandRing->write(words, chunk);
+        words += chunk;
+        count -= chunk;
+    }
+}
+
+void PCSX::GPU::commandThreadLoop() {
+    s_onCommandThread = true;
+    auto &ring = *m_commandRing;
+    // Records are published whole, so seeing the first word of one means all of it is there.
+    while (ring.waitForData(m_commandThreadStopping)) {
+        const uint32_t header = ring.peek(0);
+        const uint32_t originValue = ring.peek(1);
+        const uint32_t length = ring.peek(2);
+        const size_t count = header & 0x0fffffff;
+        const auto origin = static_cast<Logged::Origin>(header >> 28);
+        ZoneScopedN("GPU commands");
+        FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::GPU);
+        ring.read(3, count, [this, origin, originValue, length](const uint32_t *words, size_t size) {
+            Buffer buf(words, size);
+            while (!buf.isEmpty()) m_processor->processWrite(buf, origin, originValue, length);
+        });
+        ring.release(count + 3);
+    }
+}
 
 void PCSX::GPU::Command::processWrite(Buffer &buf, Logged::Origin origin, uint32_t originValue, uint32_t length) {
+    static constexpr auto c_packetParsers = generatePacketParsers();
     while (!buf.isEmpty()) {
+        // Only packets straddling the end of the buffer, e.g. split across DMA chain nodes, need the state machines
+        const auto &parser = c_packetParsers[SWAP_LE32(*buf.data()) >> 24];
+        if ((parser.length != 0) && (buf.size() >= parser.length)) {
+            parser.parse(m_gpu, buf.data(), origin, originValue, length);
+            buf.consume(parser.length);
+            continue;
+        }
+
         uint32_t value = buf.get();
         bool gotUnknown = false;
         const uint8_t cmdType = value >> 29;           // 3 topmost bits = command "type"
@@ -846,6 +1185,7 @@ void PCSX::GPU::Command::processWrite(Buffer &buf, Logged::Origin origin, uint32
                     } break;
                     case 6: {  // mask bit
                         MaskBit prim(packetInfo);
+                        m_gpu->m_maskBitRaw = packetInfo & 3;
                         g_emulator->m_gpuLogger->addNode(prim, origin, originValue, length);
                         m_gpu->write0(&prim);
                     } break;
@@ -889,6 +1229,9 @@ void PCSX::GPU::FastFill::processWrite(Buffer &buf, Logged::Origin origin, uint3
             m_state = READ_COLOR;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->markVRAMDirty(x, y, w, h);
+            m_gpu->count(Counter::Fills);
+            m_gpu->count(Counter::Pixels, uint64_t(raw.w) * raw.h);
             m_gpu->write0(this);
             return;
     }
@@ -930,6 +1273,9 @@ void PCSX::GPU::BlitVramVram::processWrite(Buffer &buf, Logged::Origin origin, u
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->markVRAMDirty(dX, dY, w, h);
+            m_gpu->count(Counter::VRAMCopies);
+            m_gpu->count(Counter::Pixels, uint64_t(raw.w) * raw.h);
             m_gpu->write0(this);
             return;
     }
@@ -956,13 +1302,24 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
             w = value & 0xffff;
             h = value >> 16;
             size = (w * h + 1) / 2;
+            data.reset();
             m_data.clear();
-            m_data.reserve(size * 4);
+            m_consumed = 0;
+            // Without the logger wanting the whole upload, the pixels can go straight to VRAM as they come, as long
+            // as none of them get clipped.
+            m_direct = !g_emulator->m_gpuLogger->isEnabled() && (w != 0) && (h != 0);
+            if (m_direct) {
+                auto cx = x, cy = y, cw = w, ch = h;
+                m_direct = !GPU::clip(cx, cy, cw, ch);
+            }
+            m_data.reserve(m_direct ? w * 2 : size * 4);
             m_state = READ_PIXELS;
             if (buf.isEmpty()) return;
             [[fallthrough]];
         case READ_PIXELS:
-            if ((buf.size() >= size) && (m_data.empty())) {
+            if (m_direct) {
+                done = writeDirect(buf);
+            } else if ((buf.size() >= size) && (m_data.empty())) {
                 data.borrow(buf.data(), size * 4);
                 buf.consume(size);
                 done = true;
@@ -971,10 +1328,8 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
                 m_data.append(reinterpret_cast<const char *>(buf.data()), toConsume * 4);
                 done = m_data.size() == size * 4;
                 buf.consume(toConsume);
-                if (done) {
-                    data.acquire(std::move(m_data));
-                    m_data.clear();
-                }
+                // The buffer stays around for the next upload to reuse, and the logger makes its own copy.
+                if (done) data.borrow(m_data.data(), size * 4);
             }
             break;
     }
@@ -986,11 +1341,49 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
         clipped = GPU::clip(x, y, w, h);
         m_state = READ_COMMAND;
         m_gpu->m_defaultProcessor.setActive();
+        m_gpu->count(Counter::VRAMUploadBytes, uint64_t(raw.w) * raw.h * 2);
+        if (m_direct) return;
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
         m_gpu->partialUpdateVRAM(x, y, w, h, data.data<uint16_t>(), PartialUpdateVram::Synchronous);
     }
 }
 
+// Writes the rows the buffer completes straight out of it, and keeps whatever it ends with of the next row until
+// that one completes too. Buffers are whole words, so they always start on an even pixel.
+bool PCSX::GPU::BlitRamVram::writeDirect(Buffer &buf) {
+    const unsigned pixels = w * h;
+    const size_t words = std::min(buf.size(), size_t((pixels + 1) / 2 - m_consumed));
+    const uint16_t *src = reinterpret_cast<const uint16_t *>(buf.data());
+    const unsigned first = m_consumed * 2;
+    // The last word may only have half of a pixel for us.
+    unsigned available = std::min(unsigned(words * 2), pixels - first);
+    unsigned row = first / w;
+    buf.consume(words);
+    m_consumed += words;
+
+    if (!m_data.empty()) {
+        const unsigned missing = w - m_data.size() / 2;
+        const unsigned take = std::min(missing, available);
+        m_data.append(reinterpret_cast<const char *>(src), take * 2);
+        if (take < missing) return false;
+        src += take;
+        available -= take;
+        m_gpu->partialUpdateVRAM(x, y + row, w, 1, reinterpret_cast<const uint16_t *>(m_data.data()),
+                                 PartialUpdateVram::Synchronous);
+        m_data.clear();
+        row++;
+    }
+    const unsigned rows = available / w;
+    if (rows != 0) {
+        m_gpu->partialUpdateVRAM(x, y + row, w, rows, src, PartialUpdateVram::Synchronous);
+        src += rows * w;
+        available -= rows * w;
+        row += rows;
+    }
+    if (available != 0) m_data.append(reinterpret_cast<const char *>(src), available * 2);
+    return row == h;
+}
+
 void PCSX::GPU::BlitRamVram::execute(GPU *gpu) { gpu->partialUpdateVRAM(x, y, w, h, data.data<uint16_t>()); }
 
 void PCSX::GPU::BlitVramRam::processWrite(Buffer &buf, Logged::Origin origin, uint32_t origvalue, uint32_t length) {
@@ -1020,6 +1413,7 @@ void PCSX::GPU::BlitVramRam::processWrite(Buffer &buf, Logged::Origin origin, ui
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->count(Counter::VRAMDownloadBytes, uint64_t(w) * h * 2);
             m_gpu->m_vramReadSlice = m_gpu->getVRAM();
             for (auto l = y; l < y + h; l++) {
                 Slice slice;
@@ -1508,3 +1902,13 @@ bool PCSX::GPU::Logged::isInsideLine(int x, int y, int x1, int y1, int x2, int y
     int o1 = (x - x1) * (y2 - y1) - (y - y1) * (x2 - x1);
     return o1 == 0;
 }
+
+uint64_t PCSX::GPU::hashVRAMArea(const uint8_t *vram, int x, int y, int width, int height, bool rgb24) {
+    x = std::clamp(x, 0, 1023);
+    const size_t lineSize = std::min(size_t(std::max(width, 0)) * (rgb24 ? 3 : 2), size_t(1024 - x) * 2);
+    uint64_t hash = 0;
+    for (int i = 0; i < height; i++) {
+        hash = Hashing::xxh64(vram + ((y + i) & 511) * c_vramStride + x * 2, lineSize, hash);
+    }
+    return hash;
+}
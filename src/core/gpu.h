@@ -21,23 +21,33 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <functional>
 #include <magic_enum_all.hpp>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "core/gpucapture.h"
+#include "core/pgxp_vertexcache.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
+#include "support/dirtypages.h"
 #include "support/eventbus.h"
 #include "support/file.h"
 #include "support/list.h"
 #include "support/opengl.h"
 #include "support/polyfills.h"
 #include "support/slice.h"
+#include "support/spsc.h"
 
 namespace PCSX {
 class UI;
@@ -56,6 +66,7 @@ class GPU {
     uint32_t readStatus();
     void dma(uint32_t madr, uint32_t bcr, uint32_t chcr);
     static void gpuInterrupt();
+    static uint32_t stepUploadDMA();
 
     // These functions do not touch GPUSTAT. GPU backends should mirror the IRQ status into GPUSTAT
     // when readStatus is called
@@ -70,11 +81,21 @@ class GPU {
 
     void serialize(SaveStateWrapper *);
     void deserialize(const SaveStateWrapper *);
+    // Like deserialize(), but only puts back the lines of VRAM written to since the dirty map got cleared.
+    void rollback(const SaveStateWrapper *);
 
   private:
+    void restoreControl(const uint8_t *control);
     uint32_t s_usedAddr[3];
     bool CheckForEndlessLoop(uint32_t laddr);
-    uint32_t gpuDmaChainSize(uint32_t addr);
+    uint32_t gatherDMAChain(const uint32_t *memory, uint32_t hwAddr);
+
+    // The payloads of the chained DMA packets, pointing straight into main RAM, each with its header's address
+    struct ChainPacket {
+        uint32_t addr;
+        std::span<const uint32_t> words;
+    };
+    std::vector<ChainPacket> m_chainPackets;
     virtual void resetBackend() = 0;
 
   public:
@@ -82,12 +103,16 @@ class GPU {
     int init(UI *);
     virtual int initBackend(UI *) = 0;
     virtual int shutdown() = 0;
+    // Only the calling thread survives a fork, so backends running threads of their own stop them before,
+    // and start them again after, in both the parent and the child.
+    virtual void prepareFork() {}
+    virtual void afterFork() {}
     uint32_t readData();
     virtual uint32_t readStatusInternal() = 0;
     void writeData(uint32_t gdata);
     void directDMAWrite(const uint32_t *feed, int transferSize, uint32_t hwAddr);
     void directDMARead(uint32_t *dest, int transferSize, uint32_t hwAddr);
-    void chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr);
+    uint32_t chainedDMAWrite(const uint32_t *memory, uint32_t hwAddr);
     void writeStatus(uint32_t gdata);
     virtual void setOpenGLContext() {}
 
@@ -97,13 +122,16 @@ class GPU {
     virtual void addVertex(short sx, short sy, int64_t fx, int64_t fy, int64_t fz) {
         throw std::runtime_error("Not yet implemented");
     }
-    virtual void pgxpMemory(unsigned int addr, unsigned char *pVRAM) {}
-    virtual void pgxpCacheVertex(short sx, short sy, const unsigned char *_pVertex) {
-        throw std::runtime_error("Not yet implemented");
-    }
+    // PGXP leaves the precise coordinates of the vertices it projects here, for the renderer to find them back by
+    // their screen coordinates, until the next vsync.
+    void pgxpCacheVertex(short sx, short sy, const PGXP_value &vertex) { m_pgxpVertexCache.insert(sx, sy, vertex); }
+    const PGXP_value *pgxpGetCachedVertex(short sx, short sy) { return m_pgxpVertexCache.find(sx, sy); }
+    void pgxpNewFrame() { m_pgxpVertexCache.newFrame(); }
+    const PGXPVertexCache::Stats &pgxpCacheStats() const { return m_pgxpVertexCache.stats(); }
 
     virtual void setDither(int setting) = 0;
     void reset() {
+        syncCommands();
         resetBackend();
         m_dataRet = 0;
         m_readFifo->reset();
@@ -114,12 +142,22 @@ class GPU {
     virtual GLuint getVRAMTexture() = 0;
     virtual void setLinearFiltering() = 0;
     virtual void setCachedDithering(bool value) = 0;
+    // Skips drawing to the screen in this many frames out of each frames + 1. Whatever else goes to the VRAM
+    // still happens, uploads, copies, fills, and drawing to smaller areas, since the game may be reading these
+    // back, or using them as textures. Only the software renderer does this.
+    virtual void setFrameSkip(unsigned frames) {}
 
     static std::unique_ptr<GPU> getSoft();
+    // The software GPU, minus its rasterizer, for runs only interested in what the CPU computes.
+    static std::unique_ptr<GPU> getNull();
     static std::unique_ptr<GPU> getOpenGL();
 
     enum class Ownership { BORROW, ACQUIRE };
     virtual Slice getVRAM(Ownership = Ownership::BORROW) = 0;
+    // The VRAM as of a recent frame, for whatever only looks at it from outside of the emulation, like the web
+    // server or the memory editor. Backends for which reading the VRAM back stalls return data a frame or two
+    // old instead of waiting; the others return the same as getVRAM.
+    virtual Slice getVRAMSnapshot() { return getVRAM(); }
     enum class PartialUpdateVram : bool { Synchronous, Asynchronous };
     virtual void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels,
                                    PartialUpdateVram = PartialUpdateVram::Asynchronous) = 0;
@@ -130,6 +168,89 @@ class GPU {
         enum { BPP_16, BPP_24 } bpp;
     };
     virtual ScreenShot takeScreenShot() { throw std::runtime_error("Not yet implemented"); }
+    // The xxh64 of the displayed area of VRAM, as of the last vblank, for telling frames apart without reading
+    // them back whole. The lines of 24-bit displays get hashed as bytes. A disabled display hashes to 0.
+    virtual uint64_t hashDisplay() { return 0; }
+
+    // Waits until the command thread is done with everything submitted so far. Whatever looks at the GPU state
+    // from outside of the command stream needs to call this first. Does nothing when called from the command
+    // thread itself, or when it isn't running.
+    void syncCommands();
+
+    // Records everything going into GP0 and GP1 from now on, and the vsyncs, starting from the current VRAM
+    // and GPU state, for replaying it later on through GPUCapture::replay. This is best started in between
+    // frames, as a command being sent at this point will be missing its start.
+    void startCapture();
+    // Returns what got recorded since startCapture, or nullptr if nothing was being recorded.
+    std::unique_ptr<GPUCapture> stopCapture();
+    bool capturing() const { return !!m_capture; }
+    void captureVSync() {
+        if (m_capture) [[unlikely]] {
+            m_capture->events.push_back({uint32_t(m_capture->words.size()), GPUCapture::Event::Type::VSync, 0});
+        }
+    }
+
+    // What the game asked the GPU to do, frame by frame. Unlike the logger's GPUStats, these are always on, so
+    // they need to stay cheap: the parser adds to running totals as it goes, and each vsync turns them into the
+    // counts of the frame which just ended.
+    enum class Counter : unsigned {
+        // Quads count as two.
+        Triangles,
+        // Each segment of a polyline counts as one.
+        Lines,
+        Rectangles,
+        Fills,
+        VRAMCopies,
+        // The primitives' areas, before clipping, culling or masking.
+        Pixels,
+        VRAMUploadBytes,
+        VRAMDownloadBytes,
+        DMAChains,
+        DMAChainPackets,
+        DMAChainWords,
+        // How many times the backend had to wait for the work it had queued up, for the ones which queue any.
+        Flushes,
+        Count,
+    };
+    static constexpr unsigned c_counters = static_cast<unsigned>(Counter::Count);
+    using FrameCounters = std::array<uint64_t, c_counters>;
+    // Each counter only ever has one thread adding to it: the DMA ones get counted by the emulation thread, and
+    // the rest by whichever thread parses the commands. So there's no need for anything heavier than relaxed
+    // loads and stores.
+    void count(Counter counter, uint64_t amount = 1) {
+        auto &total = m_counterTotals[static_cast<unsigned>(counter)];
+        total.store(total.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    // From the emulator, at each vsync. When the command thread is running late, what it hasn't parsed yet gets
+    // counted in the next frame.
+    void countersVSync();
+    const FrameCounters &lastFrameCounters() const { return m_lastFrameCounters; }
+    // The names the counters go by in Lua and the web server.
+    static std::string_view counterName(Counter counter);
+
+    // Which 4KB pages of VRAM, that is, pairs of lines, may have been written to since the last clear. Primitives
+    // mark the whole drawing area, rather than what they actually cover. The command thread marks pages, so
+    // syncCommands() needs to be called before looking at them or clearing them.
+    static constexpr uint32_t c_vramSize = 1024 * 512 * sizeof(uint16_t);
+    static constexpr uint32_t c_vramStride = 1024 * sizeof(uint16_t);
+    DirtyPages &getDirtyVRAM() { return m_dirtyVRAM; }
+    void markVRAMDirty(int x, int y, int w, int h) {
+        if ((w <= 0) || (h <= 0)) return;
+        if (h >= 512) {
+            m_dirtyVRAM.markAll();
+            return;
+        }
+        y &= 511;
+        const int end = y + h;
+        m_dirtyVRAM.markRange(y * c_vramStride, (std::min(end, 512) - y) * c_vramStride);
+        // Writes wrap around the bottom of VRAM
+        if (end > 512) m_dirtyVRAM.markRange(0, (end - 512) * c_vramStride);
+    }
+    void markDrawingAreaDirty() {
+        const int top = (m_drawingStartRaw >> 10) & 0x1ff;
+        const int bottom = (m_drawingEndRaw >> 10) & 0x1ff;
+        if (bottom >= top) markVRAMDirty(0, top, 1024, bottom - top + 1);
+    }
 
     struct GPUStats {
         unsigned triangles = 0;
@@ -243,6 +364,17 @@ class GPU {
         friend class GPU;
     };
 
+    // Primitives with a fixed packet size can be decoded in a single call when the whole packet is in the buffer,
+    // without going through the incremental state machines. The table is indexed by the packet's first byte, and
+    // a length of 0 means the command always goes through the incremental path.
+    struct PacketParser {
+        unsigned length = 0;
+        void (*parse)(GPU *, const uint32_t *packet, Logged::Origin, uint32_t value, uint32_t length) = nullptr;
+    };
+    template <uint8_t opcode>
+    static void parsePacket(GPU *, const uint32_t *packet, Logged::Origin, uint32_t value, uint32_t length);
+    static constexpr std::array<PacketParser, 256> generatePacketParsers();
+
   public:
     template <typename T, T wMax = 1024, T hMax = 512>
     static bool clip(T &x, T &y, T &w, T &h) {
@@ -397,8 +529,14 @@ class GPU {
         bool clipped = false;
 
       private:
+        bool writeDirect(Buffer &);
+
         enum { READ_COMMAND, READ_XY, READ_HW, READ_PIXELS } m_state = READ_COMMAND;
+        // Where the pixels get gathered when they come in pieces. Reused from one upload to the next.
         std::string m_data;
+        bool m_direct = false;
+        // How many words of pixels came in so far, for the direct writes.
+        size_t m_consumed = 0;
     };
 
     struct BlitVramRam final : public Command, public Logged {
@@ -535,6 +673,7 @@ class GPU {
         void getVertices(AddTri &&, PixelOp) override;
         Poly() {}
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *packet, Logged::Origin, uint32_t value, uint32_t length);
         void reset() override {
             m_state = READ_COLOR;
             m_count = 0;
@@ -585,6 +724,7 @@ class GPU {
         }
 
       private:
+        void finish(Logged::Origin, uint32_t value, uint32_t length);
         GPUStats stats;
         unsigned m_count = 0;
         enum { READ_COLOR, READ_XY, READ_UV } m_state = READ_COLOR;
@@ -602,6 +742,7 @@ class GPU {
             if constexpr (lineType == LineType::Simple) m_count = 0;
         }
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *packet, Logged::Origin, uint32_t value, uint32_t length);
         void reset() override {
             m_state = READ_COLOR;
             if constexpr (lineType == LineType::Simple) {
@@ -635,6 +776,7 @@ class GPU {
         DrawingOffset offset;
 
       private:
+        void finish(Logged::Origin, uint32_t value, uint32_t length);
         GPUStats stats;
         struct Empty {};
         POLYFILL_NO_UNIQUE_ADDRESS
@@ -652,6 +794,7 @@ class GPU {
         void getVertices(AddTri &&, PixelOp) override;
         Rect() {}
         void processWrite(Buffer &, Logged::Origin, uint32_t value, uint32_t length) override;
+        void processPacket(const uint32_t *packet, Logged::Origin, uint32_t value, uint32_t length);
         void reset() override { m_state = READ_COLOR; }
         bool isInside(unsigned x, unsigned y) override {
             return (x >= (this->x + offset.x)) && (y >= (this->y + offset.y)) && (x < (this->x + offset.x) + this->w) &&
@@ -695,6 +838,7 @@ class GPU {
         }
 
       private:
+        void finish(Logged::Origin, uint32_t value, uint32_t length);
         enum { READ_COLOR, READ_XY, READ_UV, READ_HW } m_state = READ_COLOR;
     };
 
@@ -854,6 +998,17 @@ class GPU {
     };
     Display m_display;
 
+  protected:
+    // Hashes an area of a 1024x512 VRAM, line by line, each line being the seed of the next one. The width is in
+    // pixels, which are 3 bytes each when rgb24 is set, without going past the end of their line.
+    static uint64_t hashVRAMArea(const uint8_t *vram, int x, int y, int width, int height, bool rgb24);
+
+    // Moves the processing of the GP0 command stream to a thread of its own, fed through a ring buffer by
+    // writeData and the DMA functions. Backends able to draw from another thread opt into this, and need to
+    // stop it before tearing themselves down.
+    void startCommandThread();
+    void stopCommandThread();
+
   private:
     Command m_defaultProcessor = {this};
 
@@ -867,6 +1022,18 @@ class GPU {
 
     Command *m_processor = &m_defaultProcessor;
 
+    // Each record in the ring is a 3 words header, holding the amount of words and their origin, then the origin
+    // value and length for the logger, followed by the words themselves, as they would be in memory.
+    static constexpr size_t c_commandRingSize = 1024 * 1024;
+    static constexpr size_t c_maxCommandRecord = c_commandRingSize / 4;
+    using CommandRing = SPSC<uint32_t, c_commandRingSize>;
+    std::unique_ptr<CommandRing> m_commandRing;
+    std::thread m_commandThread;
+    std::atomic<bool> m_commandThreadStopping = false;
+    bool queueingCommands();
+    void queueCommands(Logged::Origin, uint32_t originValue, uint32_t length, const uint32_t *words, size_t count);
+    void commandThreadLoop();
+
     IO<Fifo> m_readFifo = new Fifo();
     Slice m_vramReadSlice;
 
@@ -879,6 +1046,24 @@ class GPU {
     uint32_t m_drawingStartRaw = 0;
     uint32_t m_drawingEndRaw = 0;
     uint32_t m_drawingOffsetRaw = 0;
+    uint32_t m_maskBitRaw = 0;
+
+    PGXPVertexCache m_pgxpVertexCache;
+
+    // The running total of the backend's flushes, if it has such a thing.
+    virtual uint64_t flushCount() { return 0; }
+    std::atomic<uint64_t> m_counterTotals[c_counters] = {};
+    FrameCounters m_previousTotals = {};
+    FrameCounters m_lastFrameCounters = {};
+
+    std::unique_ptr<GPUCapture> m_capture;
+    void captureGP0(const uint32_t *words, size_t count) {
+        if (m_capture) [[unlikely]] {
+            m_capture->words.insert(m_capture->words.end(), words, words + count);
+        }
+    }
+
+    DirtyPages m_dirtyVRAM = DirtyPages(c_vramSize);
 
     virtual void write0(ClearCache *) = 0;
     virtual void write0(FastFill *) = 0;
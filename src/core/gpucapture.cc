@@ -0,0 +1,382 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gpucapture.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <magic_enum_all.hpp>
+#include <map>
+
+#include "core/gpu.h"
+#include "fmt/format.h"
+
+namespace {
+
+struct Vertex {
+    int x, y;
+};
+
+Vertex vertex(uint32_t word) {
+    // Coordinates are signed 11 bits
+    return {int32_t(word << 21) >> 21, int32_t(word << 5) >> 21};
+}
+
+uint64_t triangleArea(Vertex a, Vertex b, Vertex c) {
+    const int64_t cross = int64_t(b.x - a.x) * (c.y - a.y) - int64_t(c.x - a.x) * (b.y - a.y);
+    return std::abs(cross) / 2;
+}
+
+// The GPU skips whatever spans more than this, instead of drawing it
+bool tooLarge(Vertex a, Vertex b) { return std::abs(a.x - b.x) >= 1024 || std::abs(a.y - b.y) >= 512; }
+
+uint64_t lineLength(Vertex a, Vertex b) {
+    if (tooLarge(a, b)) return 0;
+    return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)) + 1;
+}
+
+bool isLineTerminator(uint32_t word) { return (word & 0xf000f000) == 0x50005000; }
+
+}  // namespace
+
+std::string PCSX::GP0Packet::category() const {
+    std::string ret;
+    switch (kind) {
+        case Kind::Other:
+            return "other";
+        case Kind::Environment:
+            return "environment";
+        case Kind::Fill:
+            return "fill";
+        case Kind::BlitVramVram:
+            return "blit-vram-vram";
+        case Kind::BlitRamVram:
+            return "blit-ram-vram";
+        case Kind::BlitVramRam:
+            return "blit-vram-ram";
+        case Kind::Poly:
+            ret = gouraud ? "poly-gouraud" : "poly-flat";
+            break;
+        case Kind::Line:
+            ret = gouraud ? "line-gouraud" : "line-flat";
+            break;
+        case Kind::Rect:
+            ret = "rect";
+            break;
+    }
+    if (textured) {
+        static constexpr const char* c_depths[] = {"-tex4", "-tex8", "-tex15", "-tex15"};
+        ret += c_depths[texDepth & 3];
+    }
+    if (semiTrans) ret += fmt::format("-blend{}", blendFunction);
+    return ret;
+}
+
+std::vector<PCSX::GP0Packet> PCSX::splitGP0(std::span<const uint32_t> words) {
+    std::vector<GP0Packet> packets;
+    uint32_t tpage = 0;
+    size_t offset = 0;
+
+    while (offset < words.size()) {
+        GP0Packet packet;
+        packet.offset = offset;
+        const uint32_t* feed = words.data() + offset;
+        const size_t left = words.size() - offset;
+        const uint32_t header = feed[0];
+        const uint32_t command = header >> 24;
+        // How many words the command needs at least, past which it's safe to look at its fields
+        size_t size = 1;
+
+        switch (command >> 5) {
+            case 0:
+                if (command == 0x02) {
+                    packet.kind = GP0Packet::Kind::Fill;
+                    size = 3;
+                    if (size > left) break;
+                    const uint32_t w = ((feed[2] & 0x3ff) + 0xf) & ~0xf;
+                    const uint32_t h = (feed[2] >> 16) & 0x1ff;
+                    packet.pixels = w * h;
+                }
+                break;
+            case 1: {
+                packet.kind = GP0Packet::Kind::Poly;
+                packet.gouraud = command & 0x10;
+                packet.textured = command & 0x04;
+                packet.semiTrans = command & 0x02;
+                const unsigned count = (command & 0x08) ? 4 : 3;
+                const unsigned stride = 1 + (packet.gouraud ? 1 : 0) + (packet.textured ? 1 : 0);
+                size = 1 + count * stride - (packet.gouraud ? 1 : 0);
+                if (size > left) break;
+                Vertex vertices[4];
+                // With gouraud shading, each vertex after the first comes with its colour in front of it, and
+                // the first one's is in the header; the texture coordinates follow the vertex.
+                for (unsigned i = 0; i < count; i++) vertices[i] = vertex(feed[1 + i * stride]);
+                // The tpage is in the second vertex's texture coordinates, and sticks for what comes next
+                if (packet.textured) tpage = (tpage & ~0x9ff) | ((feed[2 + stride] >> 16) & 0x9ff);
+                packet.pixels = triangleArea(vertices[0], vertices[1], vertices[2]);
+                if (tooLarge(vertices[0], vertices[1]) || tooLarge(vertices[1], vertices[2]) ||
+                    tooLarge(vertices[0], vertices[2])) {
+                    packet.pixels = 0;
+                }
+                if (count == 4) {
+                    uint64_t second = triangleArea(vertices[1], vertices[2], vertices[3]);
+                    if (tooLarge(vertices[1], vertices[3]) || tooLarge(vertices[2], vertices[3])) second = 0;
+                    packet.pixels += second;
+                }
+            } break;
+            case 2: {
+                packet.kind = GP0Packet::Kind::Line;
+                packet.gouraud = command & 0x10;
+                packet.semiTrans = command & 0x02;
+                const unsigned stride = packet.gouraud ? 2 : 1;
+                size = 3 + (packet.gouraud ? 1 : 0);
+                if (size > left) break;
+                Vertex last = vertex(feed[1]);
+                const Vertex second = vertex(feed[size - 1]);
+                packet.pixels = lineLength(last, second);
+                last = second;
+                if ((command & 0x08) == 0) break;
+                // Polylines go on until a terminator shows up where the next colour or vertex would be
+                while (true) {
+                    if (size >= left) {
+                        size = left + 1;
+                        break;
+                    }
+                    if (isLineTerminator(feed[size])) {
+                        size++;
+                        break;
+                    }
+                    if (size + stride > left) {
+                        size += stride;
+                        break;
+                    }
+                    const Vertex next = vertex(feed[size + stride - 1]);
+                    packet.pixels += lineLength(last, next);
+                    last = next;
+                    size += stride;
+                }
+            } break;
+            case 3: {
+                packet.kind = GP0Packet::Kind::Rect;
+                packet.textured = command & 0x04;
+                packet.semiTrans = command & 0x02;
+                const unsigned shape = (command >> 3) & 3;
+                size = 2 + (packet.textured ? 1 : 0) + (shape == 0 ? 1 : 0);
+                if (size > left) break;
+                static constexpr uint64_t c_sizes[] = {0, 1, 8 * 8, 16 * 16};
+                packet.pixels = c_sizes[shape];
+                if (shape == 0) {
+                    const uint32_t dimensions = feed[size - 1];
+                    packet.pixels = uint64_t(dimensions & 0x3ff) * ((dimensions >> 16) & 0x1ff);
+                }
+            } break;
+            case 4: {
+                packet.kind = GP0Packet::Kind::BlitVramVram;
+                size = 4;
+                if (size > left) break;
+                const uint32_t w = ((feed[3] - 1) & 0x3ff) + 1;
+                const uint32_t h = (((feed[3] >> 16) - 1) & 0x1ff) + 1;
+                packet.pixels = w * h;
+            } break;
+            case 5: {
+                packet.kind = GP0Packet::Kind::BlitRamVram;
+                size = 3;
+                if (size > left) break;
+                const uint32_t w = ((feed[2] - 1) & 0x3ff) + 1;
+                const uint32_t h = (((feed[2] >> 16) - 1) & 0x1ff) + 1;
+                packet.pixels = w * h;
+                size += (packet.pixels + 1) / 2;
+            } break;
+            case 6:
+                packet.kind = GP0Packet::Kind::BlitVramRam;
+                size = 3;
+                break;
+            case 7:
+                if ((command >= 0xe1) && (command <= 0xe6)) packet.kind = GP0Packet::Kind::Environment;
+                if (command == 0xe1) tpage = header & 0xffffff;
+                break;
+        }
+
+        if (size > left) {
+            packet = GP0Packet();
+            packet.offset = offset;
+            size = left;
+        }
+        if (packet.kind == GP0Packet::Kind::Poly || packet.kind == GP0Packet::Kind::Line ||
+            packet.kind == GP0Packet::Kind::Rect) {
+            packet.texDepth = (tpage >> 7) & 3;
+            packet.blendFunction = (tpage >> 5) & 3;
+        }
+        packet.size = size;
+        packets.push_back(packet);
+        offset += size;
+    }
+
+    return packets;
+}
+
+void PCSX::GPUCapture::save(IO<File> file) const {
+    file->write<uint32_t>(c_magic);
+    file->write<uint32_t>(c_version);
+    file->write<uint32_t>(words.size());
+    file->write<uint32_t>(events.size());
+    file->write(vram.data(), vram.size() * sizeof(uint16_t));
+    file->write(words.data(), words.size() * sizeof(uint32_t));
+    for (const auto& event : events) {
+        file->write<uint32_t>(event.position);
+        file->write<uint32_t>(magic_enum::enum_integer(event.type));
+        file->write<uint32_t>(event.value);
+    }
+}
+
+bool PCSX::GPUCapture::load(IO<File> file) {
+    if (file->failed()) return false;
+    if (file->read<uint32_t>() != c_magic) return false;
+    if (file->read<uint32_t>() != c_version) return false;
+    const uint32_t wordCount = file->read<uint32_t>();
+    const uint32_t eventCount = file->read<uint32_t>();
+    vram.resize(c_vramPixels);
+    words.resize(wordCount);
+    const ssize_t vramSize = c_vramPixels * sizeof(uint16_t);
+    const ssize_t wordsSize = wordCount * sizeof(uint32_t);
+    if (file->read(vram.data(), vramSize) != vramSize) return false;
+    if (file->read(words.data(), wordsSize) != wordsSize) return false;
+    events.clear();
+    events.reserve(eventCount);
+    for (uint32_t i = 0; i < eventCount; i++) {
+        if (file->eof()) return false;
+        Event event;
+        event.position = file->read<uint32_t>();
+        auto type = magic_enum::enum_cast<Event::Type>(file->read<uint32_t>());
+        if (!type.has_value()) return false;
+        event.type = type.value();
+        event.value = file->read<uint32_t>();
+        events.push_back(event);
+    }
+    return true;
+}
+
+nlohmann::json PCSX::GPUCapture::replay(GPU* gpu, unsigned iterations, bool perPacket) const {
+    using Clock = std::chrono::steady_clock;
+    struct Totals {
+        uint64_t count = 0;
+        uint64_t pixels = 0;
+        Clock::duration time = {};
+    };
+
+    const auto packets = splitGP0(words);
+    std::map<std::string, unsigned> indices;
+    std::vector<unsigned> packetIndices;
+    packetIndices.reserve(packets.size());
+    for (const auto& packet : packets) {
+        packetIndices.push_back(indices.try_emplace(packet.category(), indices.size()).first->second);
+    }
+    const unsigned gp1Index = indices.try_emplace("gp1", indices.size()).first->second;
+    const unsigned vsyncIndex = indices.try_emplace("vsync", indices.size()).first->second;
+
+    std::vector<Totals> totals(indices.size());
+    Clock::duration total = {};
+    auto timed = [&](unsigned index, uint64_t pixels, auto&& send) {
+        if (!perPacket) {
+            send();
+            return;
+        }
+        const auto start = Clock::now();
+        send();
+        // Borrowing the VRAM waits for the command thread and the rasterizer threads to be done with it
+        gpu->getVRAM();
+        const auto time = Clock::now() - start;
+        auto& entry = totals[index];
+        entry.count++;
+        entry.pixels += pixels;
+        entry.time += time;
+    };
+
+    for (unsigned i = 0; i < iterations; i++) {
+        gpu->reset();
+        gpu->partialUpdateVRAM(0, 0, 1024, 512, vram.data(), GPU::PartialUpdateVram::Synchronous);
+        const auto start = Clock::now();
+        auto event = events.begin();
+        auto sendEvents = [&](uint32_t position) {
+            for (; (event != events.end()) && (event->position <= position); event++) {
+                if (event->type == Event::Type::GP1) {
+                    timed(gp1Index, 0, [&]() { gpu->writeStatus(event->value); });
+                } else {
+                    timed(vsyncIndex, 0, [&]() { gpu->vblank(); });
+                }
+            }
+        };
+        for (size_t p = 0; p < packets.size(); p++) {
+            const auto& packet = packets[p];
+            sendEvents(packet.offset);
+            if (packet.kind == GP0Packet::Kind::BlitVramRam) continue;
+            timed(packetIndices[p], packet.pixels,
+                  [&]() { gpu->directDMAWrite(words.data() + packet.offset, packet.size, 0); });
+        }
+        sendEvents(~0u);
+        gpu->getVRAM();
+        total += Clock::now() - start;
+    }
+
+    auto seconds = [](Clock::duration time) { return std::chrono::duration<double>(time).count(); };
+    nlohmann::json ret = nlohmann::json::object();
+    ret["iterations"] = iterations;
+    ret["packets"] = packets.size();
+    ret["words"] = words.size();
+    ret["events"] = events.size();
+    ret["seconds"] = seconds(total);
+    if (!perPacket) return ret;
+
+    nlohmann::json categories = nlohmann::json::object();
+    for (const auto& [name, index] : indices) {
+        const auto& entry = totals[index];
+        if (entry.count == 0) continue;
+        const double time = seconds(entry.time);
+        categories[name] = {
+            {"count", entry.count},
+            {"pixels", entry.pixels},
+            {"seconds", time},
+            {"packetsPerSecond", time > 0 ? entry.count / time : 0},
+            {"pixelsPerSecond", time > 0 ? entry.pixels / time : 0},
+        };
+    }
+    ret["categories"] = std::move(categories);
+    return ret;
+}
+
+nlohmann::json PCSX::GPUCapture::compareVRAM(const uint16_t* a, const uint16_t* b) {
+    uint64_t pixels = 0;
+    unsigned left = 1024, top = 512, right = 0, bottom = 0;
+    for (unsigned y = 0; y < 512; y++) {
+        for (unsigned x = 0; x < 1024; x++) {
+            const unsigned i = y * 1024 + x;
+            if (a[i] == b[i]) continue;
+            pixels++;
+            left = std::min(left, x);
+            top = std::min(top, y);
+            right = std::max(right, x);
+            bottom = std::max(bottom, y);
+        }
+    }
+    nlohmann::json ret = {{"pixels", pixels}};
+    if (pixels != 0) ret["area"] = {{"left", left}, {"top", top}, {"right", right}, {"bottom", bottom}};
+    return ret;
+}
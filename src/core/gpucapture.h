@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "support/file.h"
+
+namespace PCSX {
+
+class GPU;
+
+// What a game sent to the GPU over some amount of frames, along with the VRAM it started drawing onto, so
+// that the same drawing can be replayed against either GPU backend without the rest of the emulator, for
+// measuring how fast it goes through a real workload, or for comparing what the backends draw. The GP0
+// words are all in one stream, with the GP1 writes and the vsyncs as events in between. The state at the
+// start of the capture is at the front, as the GP1 writes and the environment commands which would set it.
+struct GPUCapture {
+    static constexpr uint32_t c_magic = 0x43555047;  // "GPUC"
+    static constexpr uint32_t c_version = 1;
+    static constexpr size_t c_vramPixels = 1024 * 512;
+
+    struct Event {
+        enum class Type : uint32_t { GP1, VSync };
+        // How many GP0 words came before this event
+        uint32_t position = 0;
+        Type type = Type::VSync;
+        uint32_t value = 0;
+        bool operator==(const Event&) const = default;
+    };
+
+    std::vector<uint16_t> vram;
+    std::vector<uint32_t> words;
+    std::vector<Event> events;
+
+    void save(IO<File> file) const;
+    // Returns false if the file isn't a capture, or is cut short.
+    bool load(IO<File> file);
+
+    // Replays the capture this many times, starting from the captured VRAM each time, and returns how long it
+    // took. Events go through at the first packet boundary past their position. Reads from VRAM are skipped,
+    // as nothing reads them back.
+    //
+    // With perPacket, each packet gets drawn before the next one goes in, so that the time spent in each
+    // category of packets, as GP0Packet::category(), can be told apart. Otherwise, the whole stream goes
+    // through as fast as the backend can take it, and only the total time is known.
+    nlohmann::json replay(GPU* gpu, unsigned iterations = 1, bool perPacket = true) const;
+
+    // Counts the pixels which differ between two VRAM images, and where they are.
+    static nlohmann::json compareVRAM(const uint16_t* a, const uint16_t* b);
+};
+
+// One command of a GP0 stream, as split by splitGP0.
+struct GP0Packet {
+    enum class Kind { Other, Environment, Fill, Poly, Line, Rect, BlitVramVram, BlitRamVram, BlitVramRam };
+    Kind kind = Kind::Other;
+    uint32_t offset = 0;
+    uint32_t size = 1;
+    bool gouraud = false;
+    bool textured = false;
+    bool semiTrans = false;
+    // Taken from the tpage of the command for textured polygons, and from the last tpage otherwise.
+    unsigned texDepth = 0;
+    unsigned blendFunction = 0;
+    // How many pixels the command covers, before clipping to the drawing area. Commands the GPU rejects for
+    // being too large cover none.
+    uint64_t pixels = 0;
+
+    // For grouping the packets in a report, such as "poly-gouraud-tex8-blend1" or "rect-tex4".
+    std::string category() const;
+};
+
+// Splits a stream of GP0 words into its commands, tracking the tpage along the way, the same way the GPU
+// would. A command cut short at the end of the stream becomes a Kind::Other packet.
+std::vector<GP0Packet> splitGP0(std::span<const uint32_t> words);
+
+}  // namespace PCSX
@@ -19,6 +19,8 @@
 
 #include "core/gpulogger.h"
 
+#include <algorithm>
+
 #include "core/gpu.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
@@ -63,19 +65,28 @@ void main() {
 PCSX::GPULogger::GPULogger() : m_listener(g_system->m_eventBus) {
     m_listener.listen<Events::GPU::VSync>([this](auto event) {
         m_frameCounter++;
+        drawHeatmaps();
         if (m_breakOnVSync) {
             g_system->pause();
         }
     });
 }
 
+void PCSX::GPULogger::syncCommands() {
+    auto& gpu = g_emulator->m_gpu;
+    if (gpu) gpu->syncCommands();
+}
+
 void PCSX::GPULogger::enable() {
+    syncCommands();
+    m_enabled = true;
+
     GLint textureUnits;
     glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &textureUnits);
     if (textureUnits < 5) return;
 
     if (!m_vbo.exists()) {
-        m_vbo.createFixedSize(sizeof(OpenGL::ivec2) * m_vertices.size(), GL_STREAM_DRAW);
+        m_vbo.createFixedSize(sizeof(OpenGL::ivec2) * c_vboVertices, GL_STREAM_DRAW);
     }
     m_vbo.bind();
     if (!m_vao.exists()) {
@@ -117,44 +128,79 @@ void PCSX::GPULogger::enable() {
 }
 
 void PCSX::GPULogger::disable() {
+    syncCommands();
+    m_enabled = false;
     m_hasFramebuffers = false;
-    m_vram.reset();
+    m_pendingWritten.clear();
+    m_pendingRead.clear();
+    for (auto& frame : m_frames) frame.vram.reset();
 }
 
-void PCSX::GPULogger::addTri(OpenGL::ivec2& v1, OpenGL::ivec2& v2, OpenGL::ivec2& v3) {
-    if ((m_verticesCount + 3) >= m_vertices.size()) flush();
-    m_vertices[m_verticesCount++] = v1;
-    m_vertices[m_verticesCount++] = v2;
-    m_vertices[m_verticesCount++] = v3;
+void PCSX::GPULogger::clearFrameLog() {
+    syncCommands();
+    destroyFrames();
 }
 
-void PCSX::GPULogger::flush() {
-    if (m_verticesCount == 0) return;
-    m_vbo.bufferVertsSub(&m_vertices[0], m_verticesCount);
-    OpenGL::draw(OpenGL::Triangles, m_verticesCount);
-    m_verticesCount = 0;
+void PCSX::GPULogger::destroyFrames() {
+    while (!m_list.empty()) destroyNode(&*m_list.begin());
+    for (auto& frame : m_frames) {
+        frame.arena.reset();
+        frame.frame = std::numeric_limits<uint64_t>::max();
+    }
 }
 
-void PCSX::GPULogger::addNodeInternal(GPU::Logged* node, GPU::Logged::Origin origin, uint32_t value, uint32_t length) {
-    auto frame = m_frameCounter;
+void PCSX::GPULogger::setFramesToKeep(unsigned frames) {
+    frames = std::max(frames, 1u);
+    if (frames == m_frames.size()) return;
+    clearFrameLog();
+    m_frames = std::vector<Frame>(frames);
+}
 
-    bool gotNewFrame = false;
-    for (auto i = m_list.begin(); (i != m_list.end()) && (i->frame != frame); i = m_list.begin()) {
-        delete &*i;
-        gotNewFrame = true;
+void PCSX::GPULogger::draw(std::vector<OpenGL::ivec2>& vertices) {
+    for (size_t offset = 0; offset < vertices.size(); offset += c_vboVertices) {
+        const size_t count = std::min(vertices.size() - offset, c_vboVertices);
+        m_vbo.bufferVertsSub(&vertices[offset], count);
+        OpenGL::draw(OpenGL::Triangles, count);
     }
-    if (gotNewFrame) startNewFrame();
+    vertices.clear();
+}
 
+PCSX::Arena& PCSX::GPULogger::checkNewFrame() {
+    const auto frame = m_frameCounter;
+    auto& slot = m_frames[frame % m_frames.size()];
+    if (slot.frame == frame) return slot.arena;
+
+    // The list is sorted by frame, and everything too old to be kept includes whatever still lives in this arena
+    while (!m_list.empty() && ((frame - m_list.begin()->frame) >= m_frames.size())) destroyNode(&*m_list.begin());
+    slot.arena.reset();
+    slot.frame = frame;
+    startNewFrame(slot.vram);
+    return slot.arena;
+}
+
+void PCSX::GPULogger::addNodeInternal(GPU::Logged* node, GPU::Logged::Origin origin, uint32_t value, uint32_t length) {
     node->origin = origin;
     node->value = value;
     node->length = length;
     node->pc = g_emulator->m_cpu->m_regs.pc;
-    node->frame = frame;
+    node->frame = m_frameCounter;
     node->generateStatsInfo();
     m_list.push_back(node);
 
     if (!m_hasFramebuffers) return;
 
+    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(m_pendingWritten, v1, v2, v3); },
+                      GPU::Logged::PixelOp::WRITE);
+    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(m_pendingRead, v1, v2, v3); },
+                      GPU::Logged::PixelOp::READ);
+    // Frames can get very long when nothing ends them, such as when stepping through the code.
+    if (std::max(m_pendingWritten.size(), m_pendingRead.size()) >= c_vboVertices) drawHeatmaps();
+}
+
+void PCSX::GPULogger::drawHeatmaps() {
+    if (!m_hasFramebuffers) return;
+    if (m_pendingWritten.empty() && m_pendingRead.empty()) return;
+
     const auto oldFBO = OpenGL::getDrawFramebuffer();
 
     m_vbo.bind();
@@ -164,22 +210,24 @@ void PCSX::GPULogger::addNodeInternal(GPU::Logged* node, GPU::Logged::Origin ori
 
     OpenGL::setViewport(m_writtenHeatmapTex.width(), m_writtenHeatmapTex.height());
     m_writtenHeatmapFB.bind(OpenGL::DrawFramebuffer);
-    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::WRITE);
-    flush();
+    draw(m_pendingWritten);
 
     OpenGL::setViewport(m_readHeatmapTex.width(), m_readHeatmapTex.height());
     m_readHeatmapFB.bind(OpenGL::DrawFramebuffer);
-    node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::READ);
-    flush();
+    draw(m_pendingRead);
 
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFBO);
     g_emulator->m_gpu->setOpenGLContext();
 }
 
-void PCSX::GPULogger::startNewFrame() { m_vram = g_emulator->m_gpu->getVRAM(GPU::Ownership::ACQUIRE); }
+void PCSX::GPULogger::startNewFrame(Slice& vram) { vram = g_emulator->m_gpu->getVRAM(GPU::Ownership::ACQUIRE); }
 
 void PCSX::GPULogger::replay(GPU* gpu) {
-    if (m_vram.data()) gpu->partialUpdateVRAM(0, 0, 1024, 512, m_vram.data<uint16_t>());
+    // Replaying starts from the VRAM as it was at the beginning of the oldest frame we still have
+    if (!m_list.empty()) {
+        const auto& vram = m_frames[m_list.begin()->frame % m_frames.size()].vram;
+        if (vram.data()) gpu->partialUpdateVRAM(0, 0, 1024, 512, vram.data<uint16_t>());
+    }
     for (auto& node : m_list) {
         if (node.enabled) node.execute(gpu);
     }
@@ -201,33 +249,36 @@ void PCSX::GPULogger::highlight(GPU::Logged* node, bool only) {
     OpenGL::setClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     OpenGL::clearColor();
     if (node) {
-        node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::WRITE);
+        node->getVertices([this](auto v1, auto v2, auto v3) { addTri(m_vertices, v1, v2, v3); },
+                          GPU::Logged::PixelOp::WRITE);
     }
     if (!only) {
         for (auto& node : m_list) {
             if (node.highlight) {
-                node.getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); },
+                node.getVertices([this](auto v1, auto v2, auto v3) { addTri(m_vertices, v1, v2, v3); },
                                  GPU::Logged::PixelOp::WRITE);
             }
         }
     }
-    flush();
+    draw(m_vertices);
 
     OpenGL::setViewport(m_readHighlightTex.width(), m_readHighlightTex.height());
     m_readHighlightFB.bind(OpenGL::DrawFramebuffer);
     OpenGL::setClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     OpenGL::clearColor();
     if (node) {
-        node->getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::READ);
+        node->getVertices([this](auto v1, auto v2, auto v3) { addTri(m_vertices, v1, v2, v3); },
+                          GPU::Logged::PixelOp::READ);
     }
     if (!only) {
         for (auto& node : m_list) {
             if (node.highlight) {
-                node.getVertices([this](auto v1, auto v2, auto v3) { addTri(v1, v2, v3); }, GPU::Logged::PixelOp::READ);
+                node.getVertices([this](auto v1, auto v2, auto v3) { addTri(m_vertices, v1, v2, v3); },
+                                 GPU::Logged::PixelOp::READ);
             }
         }
     }
-    flush();
+    draw(m_vertices);
 
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldFBO);
     g_emulator->m_gpu->setOpenGLContext();
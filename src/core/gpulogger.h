@@ -22,8 +22,12 @@
 #include <stdint.h>
 
 #include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
 
 #include "core/gpu.h"
+#include "support/arena.h"
 #include "support/eventbus.h"
 #include "support/opengl.h"
 #include "support/slice.h"
@@ -37,38 +41,64 @@ class GPULogger;
 class GPULogger {
   public:
     GPULogger();
-    void clearFrameLog() { m_list.destroyAll(); }
+    ~GPULogger() { destroyFrames(); }
+    void clearFrameLog();
     template <typename T>
     void addNode(const T& data, GPU::Logged::Origin origin, uint32_t value, uint32_t length) {
         if (m_enabled) {
-            addNodeInternal(new T(data), origin, value, length);
+            auto& arena = checkNewFrame();
+            addNodeInternal(arena.create<T>(data), origin, value, length);
         }
     }
+    // How many frames worth of commands are kept, each of them in its own arena
+    unsigned getFramesToKeep() const { return m_frames.size(); }
+    void setFramesToKeep(unsigned frames);
     void replay(GPU*);
     void highlight(GPU::Logged* node, bool only = false);
     void enable();
     void disable();
+    bool isEnabled() const { return m_enabled; }
+    // Draws the heatmaps' triangles of the nodes logged since the last time. This happens by itself at each frame,
+    // but anything looking at the heatmaps in the middle of one needs to call this first.
+    void drawHeatmaps();
     void bindWrittenHeatmap() { m_writtenHeatmapTex.bind(); }
     void bindReadHeatmap() { m_readHeatmapTex.bind(); }
     void bindWrittenHighlight() { m_writtenHighlightTex.bind(); }
     void bindReadHighlight() { m_readHighlightTex.bind(); }
 
   private:
-    void startNewFrame();
+    void startNewFrame(Slice& vram);
+    Arena& checkNewFrame();
+    void destroyNode(GPU::Logged* node) { node->~Logged(); }
     void addNodeInternal(GPU::Logged* node, GPU::Logged::Origin, uint32_t value, uint32_t length);
+    // The GPU's command thread may still be logging whatever it had been handed before the logger got toggled,
+    // so this needs to run before changing the state, or touching the arenas.
+    void syncCommands();
+    void destroyFrames();
 
     EventBus::Listener m_listener;
-    bool m_enabled = false;
+    std::atomic<bool> m_enabled = false;
     bool m_breakOnVSync = false;
     bool m_hasFramebuffers = false;
     uint64_t m_frameCounter = 0;
+
+    // The nodes are allocated in a ring of per-frame arenas, indexed by the frame counter. A frame's arena is reset
+    // wholesale when its slot gets reused, after destroying the nodes that are too old to be kept around.
+    struct Frame {
+        Arena arena;
+        uint64_t frame = std::numeric_limits<uint64_t>::max();
+        Slice vram;
+    };
+    std::vector<Frame> m_frames = std::vector<Frame>(1);
     GPU::LoggedList m_list;
-    Slice m_vram;
     float m_impact = 1.0f / 256.0f;
     float m_decayRate = 1.0f / 1024.0f;
 
-    std::array<OpenGL::ivec2, 3 * 0x10000> m_vertices;
-    unsigned m_verticesCount = 0;
+    static constexpr size_t c_vboVertices = 3 * 0x10000;
+    // The heatmaps' triangles pile up as the nodes get logged, to be drawn all at once.
+    std::vector<OpenGL::ivec2> m_pendingWritten;
+    std::vector<OpenGL::ivec2> m_pendingRead;
+    std::vector<OpenGL::ivec2> m_vertices;
 
     OpenGL::Framebuffer m_writtenHeatmapFB, m_readHeatmapFB, m_writtenHighlightFB, m_readHighlightFB;
     OpenGL::Texture m_writtenHeatmapTex, m_readHeatmapTex, m_writtenHighlightTex, m_readHighlightTex;
@@ -76,8 +106,11 @@ class GPULogger {
     OpenGL::VertexBuffer m_vbo;
     OpenGL::Program m_program;
 
-    void addTri(OpenGL::ivec2& v1, OpenGL::ivec2& v2, OpenGL::ivec2& v3);
-    void flush();
+    static void addTri(std::vector<OpenGL::ivec2>& vertices, OpenGL::ivec2 v1, OpenGL::ivec2 v2, OpenGL::ivec2 v3) {
+        vertices.insert(vertices.end(), {v1, v2, v3});
+    }
+    // Uploads the vertices and draws them, a buffer's worth at a time, and empties them.
+    void draw(std::vector<OpenGL::ivec2>& vertices);
 
     friend class Widgets::GPULogger;
 };
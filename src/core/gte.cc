@@ -9,6 +9,7 @@
 
 #include <algorithm>
 
+#include "core/gte_simd.h"
 #include "core/pgxp_debug.h"
 #include "core/pgxp_gte.h"
 #include "core/psxmem.h"
@@ -267,6 +268,9 @@
 #define CV2(n) (n < 3 ? PCSX::g_emulator->m_cpu->m_regs.CP2C.p[(n << 3) + 6].sd : 0)
 #define CV3(n) (n < 3 ? PCSX::g_emulator->m_cpu->m_regs.CP2C.p[(n << 3) + 7].sd : 0)
 
+// RTPT, NCCT and NCDT do their matrix * vector products for all 3 vertices at once, using the best SIMD kernel available
+static const PCSX::GTESIMD::TripleProductKernel s_tripleProduct = PCSX::GTESIMD::getTripleProductKernel();
+
 static int32_t LIM(int32_t value, int32_t max, int32_t min, uint32_t flag) {
     if (value > max) {
         FLAG |= flag;
@@ -379,33 +383,74 @@ int32_t PCSX::GTE::BOUNDS(int44 value, int max_flag, int min_flag) {
     return gte_shift(value.value(), s_sf);
 }
 
+const uint8_t PCSX::GTE::s_reciprocalTable[0x101] = {
+    0xff, 0xfd, 0xfb, 0xf9, 0xf7, 0xf5, 0xf3, 0xf1, 0xef, 0xee, 0xec, 0xea, 0xe8, 0xe6, 0xe4, 0xe3, 0xe1, 0xdf,
+    0xdd, 0xdc, 0xda, 0xd8, 0xd6, 0xd5, 0xd3, 0xd1, 0xd0, 0xce, 0xcd, 0xcb, 0xc9, 0xc8, 0xc6, 0xc5, 0xc3, 0xc1,
+    0xc0, 0xbe, 0xbd, 0xbb, 0xba, 0xb8, 0xb7, 0xb5, 0xb4, 0xb2, 0xb1, 0xb0, 0xae, 0xad, 0xab, 0xaa, 0xa9, 0xa7,
+    0xa6, 0xa4, 0xa3, 0xa2, 0xa0, 0x9f, 0x9e, 0x9c, 0x9b, 0x9a, 0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90,
+    0x8f, 0x8d, 0x8c, 0x8b, 0x8a, 0x89, 0x87, 0x86, 0x85, 0x84, 0x83, 0x82, 0x81, 0x7f, 0x7e, 0x7d, 0x7c, 0x7b,
+    0x7a, 0x79, 0x78, 0x77, 0x75, 0x74, 0x73, 0x72, 0x71, 0x70, 0x6f, 0x6e, 0x6d, 0x6c, 0x6b, 0x6a, 0x69, 0x68,
+    0x67, 0x66, 0x65, 0x64, 0x63, 0x62, 0x61, 0x60, 0x5f, 0x5e, 0x5d, 0x5d, 0x5c, 0x5b, 0x5a, 0x59, 0x58, 0x57,
+    0x56, 0x55, 0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4f, 0x4e, 0x4d, 0x4d, 0x4c, 0x4b, 0x4a, 0x49, 0x48, 0x48,
+    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3f, 0x3f, 0x3e, 0x3d, 0x3c, 0x3c, 0x3b, 0x3a, 0x39,
+    0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2f, 0x2e, 0x2e, 0x2d, 0x2c,
+    0x2c, 0x2b, 0x2a, 0x2a, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, 0x24, 0x23, 0x22, 0x22, 0x21, 0x20,
+    0x20, 0x1f, 0x1e, 0x1e, 0x1d, 0x1d, 0x1c, 0x1b, 0x1b, 0x1a, 0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15,
+    0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, 0x10, 0x0f, 0x0f, 0x0e, 0x0e, 0x0d, 0x0d, 0x0c, 0x0c, 0x0b,
+    0x0a, 0x0a, 0x09, 0x09, 0x08, 0x08, 0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02,
+    0x01, 0x01, 0x00, 0x00, 0x00};
+
+bool PCSX::GTE::isFlagLive(uint32_t pc, unsigned count) {
+    auto& memory = PCSX::g_emulator->m_mem;
+    for (unsigned i = 0; i < count; i++, pc += 4) {
+        const uint32_t* ptr = memory->getPointer<uint32_t>(pc);
+        if (!ptr) return true;
+        const uint32_t code = *ptr;
+
+        switch (code >> 26) {
+            case 0x00:  // SPECIAL: Stop at jumps, syscalls and breaks
+                switch (code & 0x3f) {
+                    case 0x08:
+                    case 0x09:
+                    case 0x0c:
+                    case 0x0d:
+                        return true;
+                }
+                break;
+
+            case 0x01:  // Branches and jumps
+            case 0x02:
+            case 0x03:
+            case 0x04:
+            case 0x05:
+            case 0x06:
+            case 0x07:
+            case 0x10:  // COP0, which can enable interrupts or return from an exception
+                return true;
+
+            case 0x12: {  // COP2
+                const uint32_t funct = code & 0x3f;
+                if (funct != 0) return !isCommand(funct);  // Another command will overwrite FLAG
+                if (_fRd_(code) == 31 && _fRs_(code) == 2) return true;   // CFC2 from FLAG
+                if (_fRd_(code) == 31 && _fRs_(code) == 6) return false;  // CTC2 to FLAG
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
 static uint32_t gte_divide(uint16_t numerator, uint16_t denominator) {
     if (numerator >= denominator * 2) {  // Division overflow
         FLAG |= (1 << 31) | (1 << 17);
         return 0x1ffff;
     }
 
-    static uint8_t table[] = {
-        0xff, 0xfd, 0xfb, 0xf9, 0xf7, 0xf5, 0xf3, 0xf1, 0xef, 0xee, 0xec, 0xea, 0xe8, 0xe6, 0xe4, 0xe3, 0xe1, 0xdf,
-        0xdd, 0xdc, 0xda, 0xd8, 0xd6, 0xd5, 0xd3, 0xd1, 0xd0, 0xce, 0xcd, 0xcb, 0xc9, 0xc8, 0xc6, 0xc5, 0xc3, 0xc1,
-        0xc0, 0xbe, 0xbd, 0xbb, 0xba, 0xb8, 0xb7, 0xb5, 0xb4, 0xb2, 0xb1, 0xb0, 0xae, 0xad, 0xab, 0xaa, 0xa9, 0xa7,
-        0xa6, 0xa4, 0xa3, 0xa2, 0xa0, 0x9f, 0x9e, 0x9c, 0x9b, 0x9a, 0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90,
-        0x8f, 0x8d, 0x8c, 0x8b, 0x8a, 0x89, 0x87, 0x86, 0x85, 0x84, 0x83, 0x82, 0x81, 0x7f, 0x7e, 0x7d, 0x7c, 0x7b,
-        0x7a, 0x79, 0x78, 0x77, 0x75, 0x74, 0x73, 0x72, 0x71, 0x70, 0x6f, 0x6e, 0x6d, 0x6c, 0x6b, 0x6a, 0x69, 0x68,
-        0x67, 0x66, 0x65, 0x64, 0x63, 0x62, 0x61, 0x60, 0x5f, 0x5e, 0x5d, 0x5d, 0x5c, 0x5b, 0x5a, 0x59, 0x58, 0x57,
-        0x56, 0x55, 0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4f, 0x4e, 0x4d, 0x4d, 0x4c, 0x4b, 0x4a, 0x49, 0x48, 0x48,
-        0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3f, 0x3f, 0x3e, 0x3d, 0x3c, 0x3c, 0x3b, 0x3a, 0x39,
-        0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2f, 0x2e, 0x2e, 0x2d, 0x2c,
-        0x2c, 0x2b, 0x2a, 0x2a, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, 0x24, 0x23, 0x22, 0x22, 0x21, 0x20,
-        0x20, 0x1f, 0x1e, 0x1e, 0x1d, 0x1d, 0x1c, 0x1b, 0x1b, 0x1a, 0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15,
-        0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, 0x10, 0x0f, 0x0f, 0x0e, 0x0e, 0x0d, 0x0d, 0x0c, 0x0c, 0x0b,
-        0x0a, 0x0a, 0x09, 0x09, 0x08, 0x08, 0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02,
-        0x01, 0x01, 0x00, 0x00, 0x00};
-
     int shift = PCSX::GTE::countLeadingZeros16(denominator);
 
     int r1 = (denominator << shift) & 0x7fff;
-    int r2 = table[((r1 + 0x40) >> 7)] + 0x101;
+    int r2 = PCSX::GTE::s_reciprocalTable[((r1 + 0x40) >> 7)] + 0x101;
     int r3 = ((0x80 - (r2 * (r1 + 0x8000))) >> 8) & 0x1ffff;
     uint32_t reciprocal = ((r2 * r3) + 0x80) >> 8;
 
@@ -493,6 +538,32 @@ static int32_t Lm_H(int64_t value, int sf) {
     return std::clamp<int32_t>(value_12, min, max);
 }
 
+PCSX::GTE::int44 PCSX::GTE::tripleProductMAC(const GTESIMD::TripleProduct& product, int v, int row) {
+    return int44(product.mac[v][row], product.positiveOverflow[v][row], product.negativeOverflow[v][row]);
+}
+
+// The lighting steps shared by NCCT and NCDT: for each of the 3 normal vectors, IR = LLM * V, then
+// colors = BK + LCM * IR. The FLAG bits of the first step are raised here, the ones of the second one by the caller.
+void PCSX::GTE::lightVertices(int lm, GTESIMD::TripleProduct& colors) {
+    const int16_t light[3][3] = {{L11, L12, L13}, {L21, L22, L23}, {L31, L32, L33}};
+    const int16_t lightColor[3][3] = {{LR1, LR2, LR3}, {LG1, LG2, LG3}, {LB1, LB2, LB3}};
+    const int64_t noTranslation[3] = {0, 0, 0};
+    const int64_t background[3] = {(int64_t)RBK << 12, (int64_t)GBK << 12, (int64_t)BBK << 12};
+    const int16_t normals[3][3] = {{VX(0), VY(0), VZ(0)}, {VX(1), VY(1), VZ(1)}, {VX(2), VY(2), VZ(2)}};
+
+    GTESIMD::TripleProduct intensities;
+    s_tripleProduct(light, noTranslation, normals, intensities);
+
+    int16_t irs[3][3];
+    for (int v = 0; v < 3; v++) {
+        irs[v][0] = Lm_B1(A1(tripleProductMAC(intensities, v, 0)), lm);
+        irs[v][1] = Lm_B2(A2(tripleProductMAC(intensities, v, 1)), lm);
+        irs[v][2] = Lm_B3(A3(tripleProductMAC(intensities, v, 2)), lm);
+    }
+
+    s_tripleProduct(lightColor, background, irs, colors);
+}
+
 void PCSX::GTE::RTPS(uint32_t op) {
     GTE_LOG("%08x GTE: RTPS|", op);
 
@@ -693,16 +764,13 @@ void PCSX::GTE::NCDT(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
+    GTESIMD::TripleProduct colors;
+    lightVertices(lm, colors);
+
     for (int v = 0; v < 3; v++) {
-        MAC1 = A1((int64_t)(L11 * VX(v)) + (L12 * VY(v)) + (L13 * VZ(v)));
-        MAC2 = A2((int64_t)(L21 * VX(v)) + (L22 * VY(v)) + (L23 * VZ(v)));
-        MAC3 = A3((int64_t)(L31 * VX(v)) + (L32 * VY(v)) + (L33 * VZ(v)));
-        IR1 = Lm_B1(MAC1, lm);
-        IR2 = Lm_B2(MAC2, lm);
-        IR3 = Lm_B3(MAC3, lm);
-        MAC1 = A1(int44((int64_t)RBK << 12) + (LR1 * IR1) + (LR2 * IR2) + (LR3 * IR3));
-        MAC2 = A2(int44((int64_t)GBK << 12) + (LG1 * IR1) + (LG2 * IR2) + (LG3 * IR3));
-        MAC3 = A3(int44((int64_t)BBK << 12) + (LB1 * IR1) + (LB2 * IR2) + (LB3 * IR3));
+        MAC1 = A1(tripleProductMAC(colors, v, 0));
+        MAC2 = A2(tripleProductMAC(colors, v, 1));
+        MAC3 = A3(tripleProductMAC(colors, v, 2));
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3(MAC3, lm);
@@ -921,10 +989,16 @@ void PCSX::GTE::RTPT(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
+    const int16_t rotation[3][3] = {{R11, R12, R13}, {R21, R22, R23}, {R31, R32, R33}};
+    const int64_t translation[3] = {(int64_t)TRX << 12, (int64_t)TRY << 12, (int64_t)TRZ << 12};
+    const int16_t vertices[3][3] = {{VX(0), VY(0), VZ(0)}, {VX(1), VY(1), VZ(1)}, {VX(2), VY(2), VZ(2)}};
+    GTESIMD::TripleProduct positions;
+    s_tripleProduct(rotation, translation, vertices, positions);
+
     for (int v = 0; v < 3; v++) {
-        MAC1 = A1(int44((int64_t)TRX << 12) + (R11 * VX(v)) + (R12 * VY(v)) + (R13 * VZ(v)));
-        MAC2 = A2(int44((int64_t)TRY << 12) + (R21 * VX(v)) + (R22 * VY(v)) + (R23 * VZ(v)));
-        MAC3 = A3(int44((int64_t)TRZ << 12) + (R31 * VX(v)) + (R32 * VY(v)) + (R33 * VZ(v)));
+        MAC1 = A1(tripleProductMAC(positions, v, 0));
+        MAC2 = A2(tripleProductMAC(positions, v, 1));
+        MAC3 = A3(tripleProductMAC(positions, v, 2));
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3_sf(s_mac3, s_sf, lm);
@@ -997,16 +1071,13 @@ void PCSX::GTE::NCCT(uint32_t op) {
     s_sf = GTE_SF(gteop(op));
     FLAG = 0;
 
+    GTESIMD::TripleProduct colors;
+    lightVertices(lm, colors);
+
     for (int v = 0; v < 3; v++) {
-        MAC1 = A1((int64_t)(L11 * VX(v)) + (L12 * VY(v)) + (L13 * VZ(v)));
-        MAC2 = A2((int64_t)(L21 * VX(v)) + (L22 * VY(v)) + (L23 * VZ(v)));
-        MAC3 = A3((int64_t)(L31 * VX(v)) + (L32 * VY(v)) + (L33 * VZ(v)));
-        IR1 = Lm_B1(MAC1, lm);
-        IR2 = Lm_B2(MAC2, lm);
-        IR3 = Lm_B3(MAC3, lm);
-        MAC1 = A1(int44((int64_t)RBK << 12) + (LR1 * IR1) + (LR2 * IR2) + (LR3 * IR3));
-        MAC2 = A2(int44((int64_t)GBK << 12) + (LG1 * IR1) + (LG2 * IR2) + (LG3 * IR3));
-        MAC3 = A3(int44((int64_t)BBK << 12) + (LB1 * IR1) + (LB2 * IR2) + (LB3 * IR3));
+        MAC1 = A1(tripleProductMAC(colors, v, 0));
+        MAC2 = A2(tripleProductMAC(colors, v, 1));
+        MAC3 = A3(tripleProductMAC(colors, v, 2));
         IR1 = Lm_B1(MAC1, lm);
         IR2 = Lm_B2(MAC2, lm);
         IR3 = Lm_B3(MAC3, lm);
@@ -20,6 +20,7 @@
 #pragma once
 #include <bit>
 
+#include "core/gte_simd.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
 
@@ -115,7 +116,20 @@ class GTE {
         return count - 16;
     }
 
+    // Reciprocal approximations used by the RTPS/RTPT division, shared with the dynarecs' native versions of them
+    static const uint8_t s_reciprocalTable[0x101];
+
+    // Whether the function field of a COP2 instruction is one of the GTE commands
+    static constexpr bool isCommand(uint32_t funct) { return (c_commands >> (funct & 0x3f)) & 1; }
+
+    // Every GTE command starts by clearing FLAG, so the dynarecs don't compute it if the code that follows overwrites
+    // it before anything gets to read it. Looks at the count instructions from pc, which have to be guaranteed to run
+    // right after the command, and stops at the first one which might not be.
+    static bool isFlagLive(uint32_t pc, unsigned count);
+
   private:
+    static constexpr uint64_t c_commands = 0xe0016701585f1042;
+
     class int44 {
       public:
         int44(int64_t value)
@@ -150,6 +164,9 @@ class GTE {
     int32_t A3(int44 a);
     int64_t F(int64_t a);
 
+    int44 tripleProductMAC(const GTESIMD::TripleProduct& product, int v, int row);
+    void lightVertices(int lm, GTESIMD::TripleProduct& colors);
+
     uint32_t MFC2_internal(int reg);
     void MTC2_internal(uint32_t value, int reg);
     void CTC2_internal(uint32_t value, int reg);
@@ -0,0 +1,208 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gte_simd.h"
+
+#include "support/cpufeatures.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define GTE_SIMD_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GTE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr int64_t c_mask44 = 0xfffffffffff;
+constexpr int64_t c_sign44 = 0x80000000000;
+
+// The reference implementation, which does exactly what chaining int44 additions does
+void tripleProductScalar(const int16_t matrix[3][3], const int64_t translation[3], const int16_t vectors[3][3],
+                         PCSX::GTESIMD::TripleProduct& out) {
+    for (int v = 0; v < 3; v++) {
+        for (int row = 0; row < 3; row++) {
+            int64_t acc = translation[row];
+            bool positive = false;
+            bool negative = false;
+            for (int column = 0; column < 3; column++) {
+                const int64_t product = (int32_t)matrix[row][column] * (int32_t)vectors[v][column];
+                const int64_t sum = (((acc + product) & c_mask44) ^ c_sign44) - c_sign44;
+                positive |= sum < 0 && acc >= 0 && product >= 0;
+                negative |= sum >= 0 && acc < 0 && product < 0;
+                acc = sum;
+            }
+            out.mac[v][row] = acc;
+            out.positiveOverflow[v][row] = positive;
+            out.negativeOverflow[v][row] = negative;
+        }
+    }
+}
+
+// The vector implementations all work the same way: each 64-bit lane holds the accumulator of one vector.
+// There's no 64-bit arithmetic shift before AVX-512, so wrapping to 44 bits is done with ((x & mask) ^ sign) - sign,
+// and overflows are detected from the sign bits of the operands and the result, without any comparisons:
+// positive overflow = ~acc & ~product & sum, negative overflow = acc & product & ~sum
+
+#if defined(GTE_SIMD_X86)
+PCSX_TARGET("sse4.1")
+void tripleProductSSE41(const int16_t matrix[3][3], const int64_t translation[3], const int16_t vectors[3][3],
+                        PCSX::GTESIMD::TripleProduct& out) {
+    const __m128i mask = _mm_set1_epi64x(c_mask44);
+    const __m128i sign = _mm_set1_epi64x(c_sign44);
+
+    // Vectors 0 and 1 go in the first register, vector 2 in the low lane of the second one
+    __m128i components[2][3];
+    for (int column = 0; column < 3; column++) {
+        components[0][column] = _mm_set_epi64x(vectors[1][column], vectors[0][column]);
+        components[1][column] = _mm_set_epi64x(0, vectors[2][column]);
+    }
+
+    for (int row = 0; row < 3; row++) {
+        for (int half = 0; half < 2; half++) {
+            __m128i acc = _mm_set1_epi64x(translation[row]);
+            __m128i positive = _mm_setzero_si128();
+            __m128i negative = _mm_setzero_si128();
+            for (int column = 0; column < 3; column++) {
+                // pmuldq multiplies the sign extended low 32 bits of each lane into a 64-bit product
+                const __m128i product = _mm_mul_epi32(_mm_set1_epi64x(matrix[row][column]), components[half][column]);
+                __m128i sum = _mm_add_epi64(acc, product);
+                sum = _mm_sub_epi64(_mm_xor_si128(_mm_and_si128(sum, mask), sign), sign);
+                positive = _mm_or_si128(positive, _mm_andnot_si128(_mm_or_si128(acc, product), sum));
+                negative = _mm_or_si128(negative, _mm_andnot_si128(sum, _mm_and_si128(acc, product)));
+                acc = sum;
+            }
+
+            alignas(16) int64_t macs[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(macs), acc);
+            const int positiveMask = _mm_movemask_pd(_mm_castsi128_pd(positive));
+            const int negativeMask = _mm_movemask_pd(_mm_castsi128_pd(negative));
+            const int lanes = half == 0 ? 2 : 1;
+            for (int lane = 0; lane < lanes; lane++) {
+                const int v = half * 2 + lane;
+                out.mac[v][row] = macs[lane];
+                out.positiveOverflow[v][row] = (positiveMask >> lane) & 1;
+                out.negativeOverflow[v][row] = (negativeMask >> lane) & 1;
+            }
+        }
+    }
+}
+
+PCSX_TARGET("avx2")
+void tripleProductAVX2(const int16_t matrix[3][3], const int64_t translation[3], const int16_t vectors[3][3],
+                       PCSX::GTESIMD::TripleProduct& out) {
+    const __m256i mask = _mm256_set1_epi64x(c_mask44);
+    const __m256i sign = _mm256_set1_epi64x(c_sign44);
+
+    // All 3 vectors fit in one register, the top lane is unused
+    __m256i components[3];
+    for (int column = 0; column < 3; column++) {
+        components[column] = _mm256_set_epi64x(0, vectors[2][column], vectors[1][column], vectors[0][column]);
+    }
+
+    for (int row = 0; row < 3; row++) {
+        __m256i acc = _mm256_set1_epi64x(translation[row]);
+        __m256i positive = _mm256_setzero_si256();
+        __m256i negative = _mm256_setzero_si256();
+        for (int column = 0; column < 3; column++) {
+            const __m256i product = _mm256_mul_epi32(_mm256_set1_epi64x(matrix[row][column]), components[column]);
+            __m256i sum = _mm256_add_epi64(acc, product);
+            sum = _mm256_sub_epi64(_mm256_xor_si256(_mm256_and_si256(sum, mask), sign), sign);
+            positive = _mm256_or_si256(positive, _mm256_andnot_si256(_mm256_or_si256(acc, product), sum));
+            negative = _mm256_or_si256(negative, _mm256_andnot_si256(sum, _mm256_and_si256(acc, product)));
+            acc = sum;
+        }
+
+        alignas(32) int64_t macs[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(macs), acc);
+        const int positiveMask = _mm256_movemask_pd(_mm256_castsi256_pd(positive));
+        const int negativeMask = _mm256_movemask_pd(_mm256_castsi256_pd(negative));
+        for (int v = 0; v < 3; v++) {
+            out.mac[v][row] = macs[v];
+            out.positiveOverflow[v][row] = (positiveMask >> v) & 1;
+            out.negativeOverflow[v][row] = (negativeMask >> v) & 1;
+        }
+    }
+}
+
+#endif  // GTE_SIMD_X86
+
+#if defined(GTE_SIMD_NEON)
+// NEON is mandatory on AArch64, so there's nothing to detect
+void tripleProductNEON(const int16_t matrix[3][3], const int64_t translation[3], const int16_t vectors[3][3],
+                       PCSX::GTESIMD::TripleProduct& out) {
+    const int64x2_t mask = vdupq_n_s64(c_mask44);
+    const int64x2_t sign = vdupq_n_s64(c_sign44);
+
+    // Vectors 0 and 1 go in the first register, vector 2 in the low lane of the second one
+    int32x2_t components[2][3];
+    for (int column = 0; column < 3; column++) {
+        const int32_t low[2] = {vectors[0][column], vectors[1][column]};
+        const int32_t high[2] = {vectors[2][column], 0};
+        components[0][column] = vld1_s32(low);
+        components[1][column] = vld1_s32(high);
+    }
+
+    for (int row = 0; row < 3; row++) {
+        for (int half = 0; half < 2; half++) {
+            int64x2_t acc = vdupq_n_s64(translation[row]);
+            int64x2_t positive = vdupq_n_s64(0);
+            int64x2_t negative = vdupq_n_s64(0);
+            for (int column = 0; column < 3; column++) {
+                const int64x2_t product = vmull_s32(vdup_n_s32(matrix[row][column]), components[half][column]);
+                int64x2_t sum = vaddq_s64(acc, product);
+                sum = vsubq_s64(veorq_s64(vandq_s64(sum, mask), sign), sign);
+                positive = vorrq_s64(positive, vbicq_s64(sum, vorrq_s64(acc, product)));
+                negative = vorrq_s64(negative, vbicq_s64(vandq_s64(acc, product), sum));
+                acc = sum;
+            }
+
+            const int64_t macs[2] = {vgetq_lane_s64(acc, 0), vgetq_lane_s64(acc, 1)};
+            const int64_t positiveLanes[2] = {vgetq_lane_s64(positive, 0), vgetq_lane_s64(positive, 1)};
+            const int64_t negativeLanes[2] = {vgetq_lane_s64(negative, 0), vgetq_lane_s64(negative, 1)};
+            const int lanes = half == 0 ? 2 : 1;
+            for (int lane = 0; lane < lanes; lane++) {
+                const int v = half * 2 + lane;
+                out.mac[v][row] = macs[lane];
+                out.positiveOverflow[v][row] = positiveLanes[lane] < 0;
+                out.negativeOverflow[v][row] = negativeLanes[lane] < 0;
+            }
+        }
+    }
+}
+#endif  // GTE_SIMD_NEON
+
+}  // namespace
+
+std::vector<PCSX::GTESIMD::TripleProductImplementation> PCSX::GTESIMD::getSupportedTripleProductImplementations() {
+    std::vector<TripleProductImplementation> implementations = {{"Scalar", tripleProductScalar}};
+#if defined(GTE_SIMD_X86)
+    if (CPUFeatures::hasSSE41()) implementations.push_back({"SSE4.1", tripleProductSSE41});
+    if (CPUFeatures::hasAVX2()) implementations.push_back({"AVX2", tripleProductAVX2});
+#elif defined(GTE_SIMD_NEON)
+    implementations.push_back({"NEON", tripleProductNEON});
+#endif
+    return implementations;
+}
+
+PCSX::GTESIMD::TripleProductKernel PCSX::GTESIMD::getTripleProductKernel() {
+    static const TripleProductKernel kernel = getSupportedTripleProductImplementations().back().kernel;
+    return kernel;
+}
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+namespace GTESIMD {
+
+// The MAC1-3 accumulators of 3 matrix * vector products, the way the GTE's 44-bit adders see them
+struct TripleProduct {
+    int64_t mac[3][3];            // [vector][row], sign extended from 44 bits
+    bool positiveOverflow[3][3];  // Did an addition overflow above 0x7ffffffffff?
+    bool negativeOverflow[3][3];  // Did an addition overflow below -0x80000000000?
+};
+
+// Computes, for each vector v and row r:
+// translation[r] + matrix[r][0] * vectors[v][0] + matrix[r][1] * vectors[v][1] + matrix[r][2] * vectors[v][2]
+// Each addition is done in that order and wraps to 44 bits, tracking overflows like the GTE's int44 class.
+// The translation has to fit in 44 bits, which is always the case for a 32-bit control register shifted by 12.
+using TripleProductKernel = void (*)(const int16_t matrix[3][3], const int64_t translation[3],
+                                     const int16_t vectors[3][3], TripleProduct& out);
+
+struct TripleProductImplementation {
+    const char* name;
+    TripleProductKernel kernel;
+};
+
+// All the implementations the host CPU can run, from the slowest (the scalar one) to the fastest
+std::vector<TripleProductImplementation> getSupportedTripleProductImplementations();
+
+// The fastest implementation the host CPU can run. Feature detection only happens on the first call.
+TripleProductKernel getTripleProductKernel();
+
+}  // namespace GTESIMD
+
+}  // namespace PCSX
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guestcoverage.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+void PCSX::GuestCoverage::start(uint32_t ramMask) {
+    // Keeping what got marked already if the RAM stays the same, so that runs can be accumulated.
+    if (ramMask != m_ramMask) {
+        m_ramMask = ramMask;
+        m_entries.assign((ramMask + 1) / 4, 0);
+        m_lengths.assign((ramMask + 1) / 4, 0);
+    }
+    m_running = true;
+}
+
+// The lengths describe the code compiled so far, which stays, so only the entries go.
+void PCSX::GuestCoverage::clear() { std::fill(m_entries.begin(), m_entries.end(), 0); }
+
+void PCSX::GuestCoverage::setLength(uint32_t pc, uint32_t count) {
+    if (!m_running || ((pc & 0x1fffffff) >= c_ramRegion)) return;
+    // A block starting here may get compiled again with another length, for instance because of a breakpoint;
+    // the last one compiled is the one running from now on.
+    m_lengths[(pc & m_ramMask) >> 2] = std::min<uint32_t>(count, UINT16_MAX);
+}
+
+std::vector<bool> PCSX::GuestCoverage::covered() const {
+    std::vector<bool> ret(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        if (!m_entries[i]) continue;
+        const size_t end = std::min(m_entries.size(), i + std::max<size_t>(m_lengths[i], 1));
+        for (size_t j = i; j < end; j++) ret[j] = true;
+    }
+    return ret;
+}
+
+uint64_t PCSX::GuestCoverage::coveredInstructions() const {
+    const auto words = covered();
+    return std::count(words.begin(), words.end(), true);
+}
+
+void PCSX::GuestCoverage::writeLcov(IO<File> file, const Symbols& symbols) const {
+    const auto words = covered();
+    const uint32_t count = words.size();
+    auto writeRecord = [&](const std::string& name, uint32_t first, uint32_t last) {
+        std::string record = fmt::format("SF:{}\nFN:1,{}\nFNDA:{},{}\nFNF:1\nFNH:{}\n", name, name,
+                                         words[first] ? 1 : 0, name, words[first] ? 1 : 0);
+        unsigned hits = 0;
+        for (uint32_t i = first; i < last; i++) {
+            record += fmt::format("DA:{},{}\n", i - first + 1, words[i] ? 1 : 0);
+            if (words[i]) hits++;
+        }
+        record += fmt::format("LF:{}\nLH:{}\nend_of_record\n", last - first, hits);
+        file->writeString(record);
+    };
+
+    // The symbols in RAM, by word, whichever mirror of it they got declared in.
+    std::map<uint32_t, const std::string*> inRam;
+    for (const auto& [address, name] : symbols) {
+        if ((address & 0x1fffffff) >= c_ramRegion) continue;
+        inRam.try_emplace((address & m_ramMask) >> 2, &name);
+    }
+
+    std::vector<bool> claimed(count);
+    for (auto symbol = inRam.begin(); symbol != inRam.end(); symbol++) {
+        const uint32_t first = symbol->first;
+        uint32_t last = std::min(count, first + c_maxSymbolSize / 4);
+        auto next = std::next(symbol);
+        if (next != inRam.end()) last = std::min(last, next->first);
+        writeRecord(*symbol->second, first, last);
+        for (uint32_t i = first; i < last; i++) claimed[i] = true;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!words[i] || claimed[i]) continue;
+        uint32_t last = i;
+        while ((last < count) && words[last] && !claimed[last]) last++;
+        writeRecord(fmt::format("0x{:08x}", 0x80000000 | (i * 4)), i, last);
+        i = last;
+    }
+}
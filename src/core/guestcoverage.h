@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// Which instructions of the guest's RAM ran, for code coverage reports. Marking costs a single store: the
+// interpreter marks every instruction it runs, and the dynarec marks the entry of each block, and of each
+// segment of its traces, remembering how many instructions these hold. Reports then expand the entries back
+// into instructions, assuming that code which got entered ran to the end of its block.
+//
+// Compiled code holds pointers into the entries, so the CPU needs to throw away what it compiled whenever
+// the coverage starts or stops.
+class GuestCoverage {
+  public:
+    using Symbols = std::map<uint32_t, std::string>;
+
+    // The mask is the one of the RAM's mirrors, see Emulator::getRamMask.
+    void start(uint32_t ramMask);
+    void stop() { m_running = false; }
+    void clear();
+    bool running() const { return m_running; }
+
+    // Null if the address isn't in RAM, or if the coverage isn't running.
+    uint8_t* entry(uint32_t pc) {
+        if (!m_running || ((pc & 0x1fffffff) >= c_ramRegion)) return nullptr;
+        return &m_entries[(pc & m_ramMask) >> 2];
+    }
+    void mark(uint32_t pc) {
+        auto e = entry(pc);
+        if (e) *e = 1;
+    }
+    // From the dynarec, once it knows how many instructions there are in the code starting at this address.
+    void setLength(uint32_t pc, uint32_t count);
+
+    // One per word of RAM.
+    std::vector<bool> covered() const;
+    uint64_t coveredInstructions() const;
+
+    // An lcov tracefile, with a record per symbol in RAM, each instruction of which being a line. Symbols span
+    // up to the next one, or 64KB at most. Code which ran outside of any symbol gets a record for each of its
+    // contiguous runs, named after their address. There's no source to point at, so the file names are the
+    // ones of the symbols.
+    void writeLcov(IO<File> file, const Symbols& symbols) const;
+
+  private:
+    static constexpr uint32_t c_ramRegion = 8 * 1024 * 1024;
+    static constexpr uint32_t c_maxSymbolSize = 64 * 1024;
+
+    std::vector<uint8_t> m_entries;
+    std::vector<uint16_t> m_lengths;
+    uint32_t m_ramMask = 0;
+    bool m_running = false;
+};
+
+}  // namespace PCSX
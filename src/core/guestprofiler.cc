@@ -0,0 +1,232 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guestprofiler.h"
+
+#include <algorithm>
+
+#include "core/callstacks.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "fmt/format.h"
+#include "support/zfile.h"
+#include "supportpsx/memory.h"
+
+namespace {
+
+using Symbol = std::pair<const uint32_t, std::string>;
+
+// Same as R3000Acpu::findContainingSymbol, but for any set of symbols.
+const Symbol* findSymbol(const PCSX::GuestProfile::Symbols& symbols, uint32_t address) {
+    auto symbol = symbols.upper_bound(address);
+    if (symbol == symbols.begin()) return nullptr;
+    symbol--;
+    if (symbol->first == address) return &*symbol;
+    if (PCSX::PSXAddress(address).segment != PCSX::PSXAddress(symbol->first).segment) return nullptr;
+    return &*symbol;
+}
+
+std::string frameName(const PCSX::GuestProfile::Symbols& symbols, uint32_t address) {
+    auto symbol = findSymbol(symbols, address);
+    if (!symbol) return fmt::format("0x{:08x}", address);
+    std::string name = symbol->second;
+    std::replace(name.begin(), name.end(), ';', ':');
+    return name;
+}
+
+// Just enough of the protobuf wire format for profile.proto.
+class ProtobufWriter {
+  public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            m_data += char(value | 0x80);
+            value >>= 7;
+        }
+        m_data += char(value);
+    }
+    void integer(unsigned field, uint64_t value) {
+        if (value == 0) return;
+        varint(field << 3);
+        varint(value);
+    }
+    void bytes(unsigned field, std::string_view value) {
+        varint((field << 3) | 2);
+        varint(value.size());
+        m_data += value;
+    }
+    void packed(unsigned field, std::span<const uint64_t> values) {
+        ProtobufWriter payload;
+        for (auto value : values) payload.varint(value);
+        bytes(field, payload.data());
+    }
+    const std::string& data() const { return m_data; }
+
+  private:
+    std::string m_data;
+};
+
+class StringTable {
+  public:
+    StringTable() { get(""); }
+    uint64_t get(const std::string& str) {
+        auto [it, inserted] = m_indices.try_emplace(str, m_strings.size());
+        if (inserted) m_strings.push_back(str);
+        return it->second;
+    }
+    const std::vector<std::string>& strings() const { return m_strings; }
+
+  private:
+    std::map<std::string, uint64_t> m_indices;
+    std::vector<std::string> m_strings;
+};
+
+}  // namespace
+
+void PCSX::GuestProfile::addSample(std::span<const uint32_t> chain) {
+    m_chains[std::vector<uint32_t>(chain.begin(), chain.end())]++;
+    m_samples++;
+}
+
+void PCSX::GuestProfile::writeCollapsed(IO<File> file, const Symbols& symbols) const {
+    std::map<std::string, uint64_t> stacks;
+    for (const auto& [chain, count] : m_chains) {
+        std::string stack;
+        for (auto address : chain) {
+            if (!stack.empty()) stack += ';';
+            stack += frameName(symbols, address);
+        }
+        stacks[stack] += count;
+    }
+    for (const auto& [stack, count] : stacks) file->writeString(fmt::format("{} {}\n", stack, count));
+}
+
+void PCSX::GuestProfile::writePprof(IO<File> file, const Symbols& symbols, uint32_t interval) const {
+    StringTable strings;
+    ProtobufWriter profile;
+    auto valueType = [&strings](const char* type, const char* unit) {
+        ProtobufWriter message;
+        message.integer(1, strings.get(type));
+        message.integer(2, strings.get(unit));
+        return message.data();
+    };
+    profile.bytes(1, valueType("samples", "count"));
+    profile.bytes(1, valueType("cycles", "cycles"));
+
+    // Addresses outside of any symbol get a function of their own.
+    std::map<uint32_t, uint64_t> functions;
+    std::map<uint32_t, uint64_t> locations;
+    ProtobufWriter entries;
+    auto location = [&](uint32_t address) {
+        auto [it, inserted] = locations.try_emplace(address, locations.size() + 1);
+        if (!inserted) return it->second;
+        auto symbol = findSymbol(symbols, address);
+        const uint32_t start = symbol ? symbol->first : address;
+        auto [function, newFunction] = functions.try_emplace(start, functions.size() + 1);
+        if (newFunction) {
+            ProtobufWriter message;
+            message.integer(1, function->second);
+            const auto name = strings.get(frameName(symbols, address));
+            message.integer(2, name);
+            message.integer(3, name);
+            entries.bytes(5, message.data());
+        }
+        ProtobufWriter line;
+        line.integer(1, function->second);
+        ProtobufWriter message;
+        message.integer(1, it->second);
+        message.integer(3, address);
+        message.bytes(4, line.data());
+        entries.bytes(4, message.data());
+        return it->second;
+    };
+
+    std::vector<uint64_t> ids;
+    for (const auto& [chain, count] : m_chains) {
+        // The leaf comes first here
+        ids.clear();
+        for (auto address = chain.rbegin(); address != chain.rend(); address++) ids.push_back(location(*address));
+        const uint64_t values[2] = {count, count * interval};
+        ProtobufWriter sample;
+        sample.packed(1, ids);
+        sample.packed(2, values);
+        profile.bytes(2, sample.data());
+    }
+
+    ProtobufWriter periodType;
+    periodType.integer(1, strings.get("cycles"));
+    periodType.integer(2, strings.get("cycles"));
+    std::string data = profile.data() + entries.data();
+    for (const auto& str : strings.strings()) {
+        ProtobufWriter message;
+        message.bytes(6, str);
+        data += message.data();
+    }
+    ProtobufWriter trailer;
+    trailer.bytes(11, periodType.data());
+    trailer.integer(12, interval);
+    data += trailer.data();
+
+    IO<File> out(new ZWriter(file, ZWriter::GZIP));
+    out->writeString(data);
+    out->close();
+}
+
+PCSX::GuestProfiler::GuestProfiler() : m_listener(g_system->m_eventBus) {
+    // Both of these replace the pending events of the scheduler
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { schedule(); });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) { schedule(); });
+}
+
+void PCSX::GuestProfiler::start(uint32_t interval) {
+    m_interval = std::max(interval, 1u);
+    if (!m_running) g_emulator->m_callStacks->subscribe();
+    m_running = true;
+    schedule();
+}
+
+void PCSX::GuestProfiler::stop() {
+    if (m_running) g_emulator->m_callStacks->unsubscribe();
+    m_running = false;
+}
+
+void PCSX::GuestProfiler::schedule() {
+    if (m_running) g_emulator->m_cpu->scheduleInterrupt(PSXINT_PROFILER, m_interval);
+}
+
+void PCSX::GuestProfiler::sample() {
+    // A save state may have one of these pending from a previous session
+    if (!m_running) return;
+    auto& callStacks = g_emulator->m_callStacks;
+    m_chain.clear();
+    if (callStacks->hasCurrent()) {
+        // The return addresses point past the delay slots of the calls
+        for (const auto& call : callStacks->getCurrent().calls) m_chain.push_back(call.ra - 8);
+    }
+    m_chain.push_back(g_emulator->m_cpu->m_regs.pc);
+    m_profile.addSample(m_chain);
+    schedule();
+}
+
+void PCSX::GuestProfiler::writeCollapsed(IO<File> file) const {
+    m_profile.writeCollapsed(file, g_emulator->m_cpu->m_symbols);
+}
+
+void PCSX::GuestProfiler::writePprof(IO<File> file) const {
+    m_profile.writePprof(file, g_emulator->m_cpu->m_symbols, m_interval);
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// How many times the guest got caught in each of its call chains, each being a list of addresses, going from the
+// outermost caller to where the CPU was. Symbols only get involved when writing the profile out, so any symbol
+// loaded afterwards still counts.
+class GuestProfile {
+  public:
+    using Symbols = std::map<uint32_t, std::string>;
+
+    void addSample(std::span<const uint32_t> chain);
+    void clear() {
+        m_chains.clear();
+        m_samples = 0;
+    }
+    uint64_t samples() const { return m_samples; }
+
+    // One line per distinct chain of functions, these separated by semicolons, then the number of samples, which
+    // is what flamegraph.pl and speedscope read. Addresses outside of any symbol show as themselves.
+    void writeCollapsed(IO<File> file, const Symbols& symbols) const;
+    // The gzipped protobuf format of pprof, with a location per address, and a function per symbol. Each sample
+    // counts for this many cycles.
+    void writePprof(IO<File> file, const Symbols& symbols, uint32_t interval) const;
+
+  private:
+    std::map<std::vector<uint32_t>, uint64_t> m_chains;
+    uint64_t m_samples = 0;
+};
+
+// Samples the guest every so many emulated cycles, whether running under the interpreter or the dynarec. The call
+// chains come from the CallStacks, which only the interpreter keeps track of, and which the profiler subscribes to
+// while it runs; under the dynarec, each sample only has the pc.
+class GuestProfiler {
+  public:
+    // A thousand samples per emulated second.
+    static constexpr uint32_t c_defaultInterval = 33868800 / 1000;
+
+    GuestProfiler();
+
+    void start(uint32_t interval = c_defaultInterval);
+    void stop();
+    bool running() const { return m_running; }
+    uint32_t interval() const { return m_interval; }
+    GuestProfile& profile() { return m_profile; }
+
+    // From the scheduler.
+    void sample();
+
+    void writeCollapsed(IO<File> file) const;
+    void writePprof(IO<File> file) const;
+
+  private:
+    void schedule();
+
+    GuestProfile m_profile;
+    std::vector<uint32_t> m_chain;
+    uint32_t m_interval = c_defaultInterval;
+    bool m_running = false;
+
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
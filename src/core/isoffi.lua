@@ -41,13 +41,42 @@ IsoReader* createIsoReader(LuaIso* wrapper);
 void deleteIsoReader(IsoReader* isoReader);
 bool isReaderFailed(IsoReader* reader);
 LuaFile* readerOpen(IsoReader* reader, const char* path);
+uint32_t readerCountEntries(IsoReader* reader);
+const char* readerGetEntryPath(IsoReader* reader, uint32_t index);
+uint32_t readerGetEntryLBA(IsoReader* reader, uint32_t index);
+uint32_t readerGetEntrySize(IsoReader* reader, uint32_t index);
+bool readerIsEntryDirectory(IsoReader* reader, uint32_t index);
+int32_t readerFindIndex(IsoReader* reader, const char* path);
+LuaFile* readerOpenIndex(IsoReader* reader, uint32_t index);
 LuaFile* fileisoOpen(LuaIso* wrapper, uint32_t lba, uint32_t size, enum SectorMode mode);
 
+enum DiscHasherStatus {
+    RUNNING,
+    DONE,
+    CANCELLED,
+    FAILED,
+};
+
+typedef struct { char opaque[?]; } DiscHasher;
+DiscHasher* createDiscHasher(LuaIso* wrapper);
+void deleteDiscHasher(DiscHasher* hasher);
+void hasherCancel(DiscHasher* hasher);
+enum DiscHasherStatus hasherStatus(DiscHasher* hasher);
+float hasherProgress(DiscHasher* hasher);
+uint32_t hasherFullCRC32(DiscHasher* hasher);
+uint32_t hasherTrackCount(DiscHasher* hasher);
+uint32_t hasherTrackSectors(DiscHasher* hasher, uint32_t track);
+uint32_t hasherTrackCRC32(DiscHasher* hasher, uint32_t track);
+void hasherTrackMD5(DiscHasher* hasher, uint32_t track, char* hex);
+void hasherTrackSHA1(DiscHasher* hasher, uint32_t track, char* hex);
+
 typedef struct { char opaque[?]; } ISO9660Builder;
 ISO9660Builder* createIsoBuilder(LuaFile* out);
 void deleteIsoBuilder(ISO9660Builder* builder);
 void isoBuilderWriteLicense(ISO9660Builder* builder, LuaFile*);
 void isoBuilderWriteSector(ISO9660Builder* builder, const uint8_t* sectorData, enum SectorMode mode);
+void isoBuilderWriteSectors(ISO9660Builder* builder, const uint8_t* sectorData, uint32_t count, enum SectorMode mode);
+void isoBuilderWriteFile(ISO9660Builder* builder, LuaFile* file, enum SectorMode mode);
 void isoBuilderClose(ISO9660Builder* builder);
 
 ]]
@@ -57,16 +86,74 @@ local C = ffi.load 'CORE_ISO'
 local function createIsoReaderWrapper(isoReader)
     local reader = {
         _wrapper = ffi.gc(isoReader, C.deleteIsoReader),
-        open = function(self, fname) return Support.File._createFileWrapper(C.readerOpen(self._wrapper, fname)) end,
+        open = function(self, fname)
+            if type(fname) == 'number' then
+                return Support.File._createFileWrapper(C.readerOpenIndex(self._wrapper, fname - 1))
+            end
+            return Support.File._createFileWrapper(C.readerOpen(self._wrapper, fname))
+        end,
+        -- Entries are numbered from 1, and can be given to open() instead of their path.
+        count = function(self) return C.readerCountEntries(self._wrapper) end,
+        entry = function(self, index)
+            if index < 1 or index > C.readerCountEntries(self._wrapper) then return nil end
+            index = index - 1
+            return {
+                path = ffi.string(C.readerGetEntryPath(self._wrapper, index)),
+                lba = C.readerGetEntryLBA(self._wrapper, index),
+                size = C.readerGetEntrySize(self._wrapper, index),
+                isDirectory = C.readerIsEntryDirectory(self._wrapper, index),
+            }
+        end,
+        find = function(self, fname)
+            local index = C.readerFindIndex(self._wrapper, fname)
+            if index < 0 then return nil end
+            return index + 1
+        end,
+        entries = function(self)
+            local ret = {}
+            for i = 1, self:count() do ret[i] = self:entry(i) end
+            return ret
+        end,
     }
     return reader
 end
 
+local hasherStatuses = { [0] = 'RUNNING', 'DONE', 'CANCELLED', 'FAILED' }
+
+local function createDiscHasherWrapper(wrapper)
+    local hasher = {
+        _wrapper = ffi.gc(wrapper, C.deleteDiscHasher),
+        cancel = function(self) C.hasherCancel(self._wrapper) end,
+        status = function(self) return hasherStatuses[tonumber(C.hasherStatus(self._wrapper))] end,
+        progress = function(self) return C.hasherProgress(self._wrapper) end,
+        -- Only once the status is DONE; track 1 is at index 1.
+        results = function(self)
+            if self:status() ~= 'DONE' then return nil end
+            local ret = { crc32 = C.hasherFullCRC32(self._wrapper), tracks = {} }
+            local hex = ffi.new('char[41]')
+            for t = 0, C.hasherTrackCount(self._wrapper) - 1 do
+                local track = {
+                    sectors = C.hasherTrackSectors(self._wrapper, t),
+                    crc32 = C.hasherTrackCRC32(self._wrapper, t),
+                }
+                C.hasherTrackMD5(self._wrapper, t, hex)
+                track.md5 = ffi.string(hex)
+                C.hasherTrackSHA1(self._wrapper, t, hex)
+                track.sha1 = ffi.string(hex)
+                ret.tracks[t + 1] = track
+            end
+            return ret
+        end,
+    }
+    return hasher
+end
+
 local function createIsoWrapper(wrapper)
     local iso = {
         _wrapper = ffi.gc(wrapper, C.deleteIso),
         failed = function(self) return C.isIsoFailed(self._wrapper) end,
         createReader = function(self) return createIsoReaderWrapper(C.createIsoReader(self._wrapper)) end,
+        createHasher = function(self) return createDiscHasherWrapper(C.createDiscHasher(self._wrapper)) end,
         clearPPF = function(self) C.isoClearPPF(self._wrapper) end,
         savePPF = function(self) C.isoSavePPF(self._wrapper) end,
         open = function(self, lba, size, mode)
@@ -97,6 +184,15 @@ local function createIsoBuilderWrapper(wrapper)
             if Support.isLuaBuffer(sectorData) then sectorData = sectorData.data end
             C.isoBuilderWriteSector(self._wrapper, sectorData, mode)
         end,
+        writeSectors = function(self, sectorData, count, mode)
+            if not mode then mode = 'M2_FORM1' end
+            if Support.isLuaBuffer(sectorData) then sectorData = sectorData.data end
+            C.isoBuilderWriteSectors(self._wrapper, sectorData, count, mode)
+        end,
+        writeFile = function(self, file, mode)
+            if not mode then mode = 'M2_FORM1' end
+            C.isoBuilderWriteFile(self._wrapper, file._wrapper, mode)
+        end,
         close = function(self) C.isoBuilderClose(self._wrapper) end,
     }
     return iso
@@ -17,6 +17,7 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include "core/eventqueue.h"
 #include "core/kernel.h"
 #include "core/r3000a.h"
 
@@ -1277,3 +1278,7 @@ void PCSX::R3000Acpu::logC0KernelCall(uint32_t call) {
     }
     g_system->log(LogClass::KERNEL, " from 0x%08x\n", n.ra);
 }
+
+void PCSX::R3000Acpu::queueKernelCall(uint32_t vector, uint32_t call) {
+    g_emulator->m_eventQueue->push(EventQueue::Type::KernelCall, vector, call);
+}
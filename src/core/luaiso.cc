@@ -19,9 +19,12 @@
 
 #include "core/luaiso.h"
 
+#include <string.h>
+
 #include <memory>
 
 #include "cdrom/cdriso.h"
+#include "cdrom/dischasher.h"
 #include "cdrom/file.h"
 #include "cdrom/iso9660-builder.h"
 #include "cdrom/iso9660-reader.h"
@@ -53,10 +56,44 @@ bool isReaderFailed(PCSX::ISO9660Reader* reader) { return reader->failed(); }
 PCSX::LuaFFI::LuaFile* readerOpen(PCSX::ISO9660Reader* reader, const char* path) {
     return new PCSX::LuaFFI::LuaFile(reader->open(path));
 }
+uint32_t readerCountEntries(PCSX::ISO9660Reader* reader) { return reader->countEntries(); }
+const char* readerGetEntryPath(PCSX::ISO9660Reader* reader, uint32_t index) {
+    return reader->getEntry(index).path.c_str();
+}
+uint32_t readerGetEntryLBA(PCSX::ISO9660Reader* reader, uint32_t index) { return reader->getEntry(index).lba; }
+uint32_t readerGetEntrySize(PCSX::ISO9660Reader* reader, uint32_t index) { return reader->getEntry(index).size; }
+bool readerIsEntryDirectory(PCSX::ISO9660Reader* reader, uint32_t index) {
+    return reader->getEntry(index).isDirectory;
+}
+int32_t readerFindIndex(PCSX::ISO9660Reader* reader, const char* path) {
+    auto index = reader->findIndex(path);
+    return index.has_value() ? index.value() : -1;
+}
+PCSX::LuaFFI::LuaFile* readerOpenIndex(PCSX::ISO9660Reader* reader, uint32_t index) {
+    return new PCSX::LuaFFI::LuaFile(reader->open(size_t(index)));
+}
 PCSX::LuaFFI::LuaFile* fileisoOpen(LuaIso* wrapper, uint32_t lba, uint32_t size, PCSX::SectorMode mode) {
     return new PCSX::LuaFFI::LuaFile(new PCSX::CDRIsoFile(wrapper->iso, lba, size, mode));
 }
 
+PCSX::DiscHasher* createDiscHasher(LuaIso* wrapper) { return new PCSX::DiscHasher(wrapper->iso); }
+void deleteDiscHasher(PCSX::DiscHasher* hasher) { delete hasher; }
+void hasherCancel(PCSX::DiscHasher* hasher) { hasher->cancel(); }
+PCSX::DiscHasher::Status hasherStatus(PCSX::DiscHasher* hasher) { return hasher->status(); }
+float hasherProgress(PCSX::DiscHasher* hasher) { return hasher->progress(); }
+uint32_t hasherFullCRC32(PCSX::DiscHasher* hasher) { return hasher->fullCRC32(); }
+uint32_t hasherTrackCount(PCSX::DiscHasher* hasher) { return hasher->tracks().size(); }
+uint32_t hasherTrackSectors(PCSX::DiscHasher* hasher, uint32_t track) { return hasher->tracks()[track].sectors; }
+uint32_t hasherTrackCRC32(PCSX::DiscHasher* hasher, uint32_t track) { return hasher->tracks()[track].crc32; }
+void hasherTrackMD5(PCSX::DiscHasher* hasher, uint32_t track, char* hex) {
+    auto str = hasher->tracks()[track].md5String();
+    memcpy(hex, str.c_str(), str.size() + 1);
+}
+void hasherTrackSHA1(PCSX::DiscHasher* hasher, uint32_t track, char* hex) {
+    auto str = hasher->tracks()[track].sha1String();
+    memcpy(hex, str.c_str(), str.size() + 1);
+}
+
 PCSX::ISO9660Builder* createIsoBuilder(PCSX::LuaFFI::LuaFile* wrapper) {
     return new PCSX::ISO9660Builder(wrapper->file);
 }
@@ -67,6 +104,13 @@ void isoBuilderWriteLicense(PCSX::ISO9660Builder* builder, PCSX::LuaFFI::LuaFile
 void isoBuilderWriteSector(PCSX::ISO9660Builder* builder, const uint8_t* sectorData, PCSX::SectorMode mode) {
     builder->writeSector(sectorData, mode);
 }
+void isoBuilderWriteSectors(PCSX::ISO9660Builder* builder, const uint8_t* sectorData, uint32_t count,
+                            PCSX::SectorMode mode) {
+    builder->writeSectors(sectorData, count, mode);
+}
+void isoBuilderWriteFile(PCSX::ISO9660Builder* builder, PCSX::LuaFFI::LuaFile* wrapper, PCSX::SectorMode mode) {
+    builder->writeFile(wrapper->file, mode);
+}
 void isoBuilderClose(PCSX::ISO9660Builder* builder) { builder->close(); }
 
 }  // namespace
@@ -96,12 +140,33 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, deleteIsoReader);
     REGISTER(L, isReaderFailed);
     REGISTER(L, readerOpen);
+    REGISTER(L, readerCountEntries);
+    REGISTER(L, readerGetEntryPath);
+    REGISTER(L, readerGetEntryLBA);
+    REGISTER(L, readerGetEntrySize);
+    REGISTER(L, readerIsEntryDirectory);
+    REGISTER(L, readerFindIndex);
+    REGISTER(L, readerOpenIndex);
     REGISTER(L, fileisoOpen);
 
+    REGISTER(L, createDiscHasher);
+    REGISTER(L, deleteDiscHasher);
+    REGISTER(L, hasherCancel);
+    REGISTER(L, hasherStatus);
+    REGISTER(L, hasherProgress);
+    REGISTER(L, hasherFullCRC32);
+    REGISTER(L, hasherTrackCount);
+    REGISTER(L, hasherTrackSectors);
+    REGISTER(L, hasherTrackCRC32);
+    REGISTER(L, hasherTrackMD5);
+    REGISTER(L, hasherTrackSHA1);
+
     REGISTER(L, createIsoBuilder);
     REGISTER(L, deleteIsoBuilder);
     REGISTER(L, isoBuilderWriteLicense);
     REGISTER(L, isoBuilderWriteSector);
+    REGISTER(L, isoBuilderWriteSectors);
+    REGISTER(L, isoBuilderWriteFile);
     REGISTER(L, isoBuilderClose);
 
     L.settable();
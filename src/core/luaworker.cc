@@ -0,0 +1,273 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/luaworker.h"
+
+#include <chrono>
+#include <memory>
+
+#include "core/luaiso.h"
+#include "core/system.h"
+#include "lua/extra.h"
+#include "lua/luafile.h"
+#include "lua/zlibffi.h"
+#include "luafilesystem/src/lfs.h"
+#include "supportpsx/adpcmlua.h"
+
+extern "C" int luaopen_lpeg(lua_State* L);
+
+namespace {
+
+// How many instructions a stopped script gets to run between two errors, in case it catches them.
+constexpr int c_stopHookCount = 1000000;
+
+void stopHook(lua_State* L, lua_Debug*) { luaL_error(L, "worker stopped"); }
+
+}  // namespace
+
+PCSX::LuaWorker::LuaWorker(std::string code, std::string name)
+    : m_thread([this, code = std::move(code), name = std::move(name)]() mutable {
+          run(std::move(code), std::move(name));
+      }) {}
+
+PCSX::LuaWorker::~LuaWorker() {
+    stop();
+    m_thread.join();
+}
+
+void PCSX::LuaWorker::send(std::string message) {
+    std::unique_lock lock(m_mutex);
+    m_inbox.push_back(std::move(message));
+    m_cv.notify_all();
+}
+
+std::optional<std::string> PCSX::LuaWorker::receive() {
+    std::unique_lock lock(m_mutex);
+    if (m_outbox.empty()) return {};
+    auto message = std::move(m_outbox.front());
+    m_outbox.pop_front();
+    return message;
+}
+
+std::optional<std::string> PCSX::LuaWorker::receiveLog() {
+    std::unique_lock lock(m_mutex);
+    if (m_logs.empty()) return {};
+    auto message = std::move(m_logs.front());
+    m_logs.pop_front();
+    return message;
+}
+
+std::string PCSX::LuaWorker::error() {
+    std::unique_lock lock(m_mutex);
+    return m_error;
+}
+
+void PCSX::LuaWorker::stop() {
+    std::unique_lock lock(m_mutex);
+    if (m_stopping) return;
+    m_stopping = true;
+    // lua_sethook is the one call which is fine to make from another thread than the state's
+    if (m_state) lua_sethook(m_state, stopHook, LUA_MASKCOUNT, c_stopHookCount);
+    m_cv.notify_all();
+}
+
+std::optional<std::string> PCSX::LuaWorker::wait(double timeout) {
+    std::unique_lock lock(m_mutex);
+    const auto ready = [this]() { return m_stopping || !m_inbox.empty(); };
+    if (timeout < 0) {
+        m_cv.wait(lock, ready);
+    } else {
+        m_cv.wait_for(lock, std::chrono::duration<double>(timeout), ready);
+    }
+    if (m_stopping || m_inbox.empty()) return {};
+    auto message = std::move(m_inbox.front());
+    m_inbox.pop_front();
+    return message;
+}
+
+void PCSX::LuaWorker::post(std::string message) {
+    std::unique_lock lock(m_mutex);
+    m_outbox.push_back(std::move(message));
+}
+
+void PCSX::LuaWorker::log(std::string message) {
+    std::unique_lock lock(m_mutex);
+    m_logs.push_back(std::move(message));
+}
+
+void PCSX::LuaWorker::openLibraries(Lua L) {
+    L.openlibs();
+    L.load("ffi = require('ffi')", "internal:setffi.lua");
+    LuaFFI::open_zlib(L);
+    L.wrap_open(luaopen_lfs);
+    L.wrap_open(luaopen_lpeg);
+    LuaFFI::open_file(L);
+    L.load("PCSX = {}", "internal:worker.lua");
+    LuaFFI::open_iso(L);
+    // There's no emulator on this thread
+    L.load("PCSX.getCurrentIso = nil", "internal:worker.lua");
+    LuaFFI::open_extra(L);
+    LuaSupportPSX::open_adpcm(L);
+
+    L.getfieldtable("Worker", LUA_GLOBALSINDEX);
+    L.declareFunc(
+        "send",
+        [this](Lua L) -> int {
+            if (L.gettop() != 1 || !L.isstring(1)) return L.error("Worker.send: expected a string");
+            post(L.tostring(1));
+            return 0;
+        },
+        -1);
+    L.declareFunc(
+        "receive",
+        [this](Lua L) -> int {
+            const double timeout = (L.gettop() >= 1 && L.isnumber(1)) ? L.tonumber(1) : -1.0;
+            auto message = wait(timeout);
+            if (message) {
+                L.push(*message);
+            } else {
+                L.push();
+            }
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "stopping",
+        [this](Lua L) -> int {
+            std::unique_lock lock(m_mutex);
+            L.push(m_stopping);
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "_log",
+        [this](Lua L) -> int {
+            log(L.tostring(1));
+            return 0;
+        },
+        -1);
+    L.pop();
+    L.load(R"(
+print = function(...)
+    local s = {}
+    for i = 1, select('#', ...) do s[#s + 1] = tostring(select(i, ...)) end
+    Worker._log(table.concat(s, ' '))
+end
+)",
+           "internal:worker.lua");
+}
+
+void PCSX::LuaWorker::run(std::string code, std::string name) {
+    Lua L;
+    {
+        std::unique_lock lock(m_mutex);
+        m_state = L.getState();
+        if (m_stopping) lua_sethook(m_state, stopHook, LUA_MASKCOUNT, c_stopHookCount);
+    }
+
+    // Lua::pcall reports errors through the printers, which belong to the main thread, so this doesn't use it
+    std::string error;
+    try {
+        openLibraries(L);
+        auto state = L.getState();
+        if (luaL_loadbuffer(state, code.data(), code.size(), name.c_str()) || lua_pcall(state, 0, 0, 0)) {
+            error = L.isstring(-1) ? L.tostring(-1) : "unknown error";
+        }
+    } catch (std::exception& e) {
+        error = e.what();
+    }
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_state = nullptr;
+        m_error = std::move(error);
+    }
+    lua_sethook(L.getState(), nullptr, 0, 0);
+    L.close();
+    m_finished.store(true, std::memory_order_release);
+}
+
+namespace {
+
+void relayLogs(PCSX::LuaWorker& worker) {
+    while (auto line = worker.receiveLog()) PCSX::g_system->luaMessage(*line, false);
+}
+
+}  // namespace
+
+void PCSX::LuaBindings::open_workers(Lua L) {
+    L.getfieldtable("PCSX", LUA_GLOBALSINDEX);
+    L.declareFunc(
+        "createWorker",
+        [](Lua L) -> int {
+            if (L.gettop() < 1 || !L.isstring(1)) {
+                return L.error("createWorker: 1st argument needs to be a string");
+            }
+            const std::string name = (L.gettop() >= 2 && L.isstring(2)) ? L.tostring(2) : "worker";
+            // The methods share the worker, which stops and joins its thread once they're all collected
+            auto worker = std::make_shared<LuaWorker>(L.tostring(1), name);
+            L.newtable();
+            L.declareFunc(
+                "send",
+                [worker](Lua L) -> int {
+                    if (L.gettop() != 2 || !L.isstring(2)) return L.error("send: expected a string");
+                    worker->send(L.tostring(2));
+                    return 0;
+                },
+                -1);
+            L.declareFunc(
+                "receive",
+                [worker](Lua L) -> int {
+                    relayLogs(*worker);
+                    auto message = worker->receive();
+                    if (message) {
+                        L.push(*message);
+                    } else {
+                        L.push();
+                    }
+                    return 1;
+                },
+                -1);
+            L.declareFunc(
+                "isRunning",
+                [worker](Lua L) -> int {
+                    relayLogs(*worker);
+                    L.push(!worker->finished());
+                    return 1;
+                },
+                -1);
+            L.declareFunc(
+                "getError",
+                [worker](Lua L) -> int {
+                    L.push(worker->error());
+                    return 1;
+                },
+                -1);
+            L.declareFunc(
+                "stop",
+                [worker](Lua L) -> int {
+                    worker->stop();
+                    return 0;
+                },
+                -1);
+            return 1;
+        },
+        -1);
+    L.pop();
+}
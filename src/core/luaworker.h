@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "lua/luawrapper.h"
+
+namespace PCSX {
+
+// A Lua state running a script on a thread of its own, for long analysis jobs which would otherwise freeze the
+// emulator and the GUI while they run. The state is isolated, and only gets the libraries which don't need the
+// emulator or the main loop: files and buffers, ISO readers, zlib, the ADPCM encoders, lfs, lpeg, and the extras.
+// Downloads and network FIFOs need the main loop, and aren't usable from a worker.
+//
+// The script talks with the main state by passing strings around, through the Worker global: Worker.send()
+// posts to the main state, Worker.receive() waits for what the main state sent, and Worker.stopping() tells if
+// the main state wants the script to end. Whatever it prints gets relayed to the main state's console.
+class LuaWorker {
+  public:
+    LuaWorker(std::string code, std::string name);
+    ~LuaWorker();
+    LuaWorker(const LuaWorker&) = delete;
+    LuaWorker& operator=(const LuaWorker&) = delete;
+
+    // From the main state. Nothing here waits on the script.
+    void send(std::string message);
+    std::optional<std::string> receive();
+    std::optional<std::string> receiveLog();
+    bool finished() const { return m_finished.load(std::memory_order_acquire); }
+    std::string error();
+    // Asks the script to end. If it doesn't check Worker.stopping() by itself, it errors out a little later,
+    // although JIT-compiled loops may not notice until they call back into the interpreter.
+    void stop();
+
+  private:
+    void run(std::string code, std::string name);
+    void openLibraries(Lua L);
+    // From the worker's thread. Waits for a message for that many seconds, or forever if negative; returns
+    // nothing if none came, or if the worker got stopped.
+    std::optional<std::string> wait(double timeout);
+    void post(std::string message);
+    void log(std::string message);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_inbox;
+    std::deque<std::string> m_outbox;
+    std::deque<std::string> m_logs;
+    std::string m_error;
+    bool m_stopping = false;
+    lua_State* m_state = nullptr;
+    std::atomic<bool> m_finished = false;
+    std::thread m_thread;
+};
+
+namespace LuaBindings {
+void open_workers(Lua);
+}
+
+}  // namespace PCSX
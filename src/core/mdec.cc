@@ -23,158 +23,17 @@
 #include "core/debug.h"
 #include "core/psxemulator.h"
 
-#define AAN_CONST_BITS 12
 #define AAN_PRESCALE_BITS 16
 
-#define AAN_CONST_SIZE 24
-#define AAN_CONST_SCALE (AAN_CONST_SIZE - AAN_CONST_BITS)
-
 #define AAN_PRESCALE_SIZE 20
 #define AAN_PRESCALE_SCALE (AAN_PRESCALE_SIZE - AAN_PRESCALE_BITS)
 #define AAN_EXTRA 12
 
-#define SCALE(x, n) ((x) >> (n))
 #define SCALER(x, n) (((x) + ((1 << (n)) >> 1)) >> (n))
 
-#define MULS(var, const) (SCALE((var) * (const), AAN_CONST_BITS))
-
 #define RLE_RUN(a) ((a) >> 10)
 #define RLE_VAL(a) (((int)(a) << (sizeof(int) * 8 - 10)) >> (sizeof(int) * 8 - 10))
 
-#define FIX_1_082392200 SCALER(18159528, AAN_CONST_SCALE)  // B6
-#define FIX_1_414213562 SCALER(23726566, AAN_CONST_SCALE)  // A4
-#define FIX_1_847759065 SCALER(31000253, AAN_CONST_SCALE)  // A2
-#define FIX_2_613125930 SCALER(43840978, AAN_CONST_SCALE)  // B2
-
-static inline void fillcol(int *blk, int val) {
-    blk[0 * PCSX::MDEC::DSIZE] = blk[1 * PCSX::MDEC::DSIZE] = blk[2 * PCSX::MDEC::DSIZE] = blk[3 * PCSX::MDEC::DSIZE] =
-        blk[4 * PCSX::MDEC::DSIZE] = blk[5 * PCSX::MDEC::DSIZE] = blk[6 * PCSX::MDEC::DSIZE] =
-            blk[7 * PCSX::MDEC::DSIZE] = val;
-}
-
-static inline void fillrow(int *blk, int val) {
-    blk[0] = blk[1] = blk[2] = blk[3] = blk[4] = blk[5] = blk[6] = blk[7] = val;
-}
-
-static void idct(int *block, int used_col) {
-    int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
-    int z5, z10, z11, z12, z13;
-    int *ptr;
-
-    // the block has only the DC coefficient
-    if (used_col == -1) {
-        int v = block[0];
-        for (int i = 0; i < PCSX::MDEC::DSIZE2; i++) block[i] = v;
-        return;
-    }
-
-    // last_col keeps track of the highest column with non zero coefficients
-    ptr = block;
-    for (int i = 0; i < PCSX::MDEC::DSIZE; i++, ptr++) {
-        if ((used_col & (1 << i)) == 0) {
-            // the column is empty or has only the DC coefficient
-            if (ptr[PCSX::MDEC::DSIZE * 0]) {
-                fillcol(ptr, ptr[0]);
-                used_col |= (1 << i);
-            }
-            continue;
-        }
-
-        // further optimization could be made by keeping track of
-        // last_row in rl2blk
-        z10 = ptr[PCSX::MDEC::DSIZE * 0] + ptr[PCSX::MDEC::DSIZE * 4];  // s04
-        z11 = ptr[PCSX::MDEC::DSIZE * 0] - ptr[PCSX::MDEC::DSIZE * 4];  // d04
-        z13 = ptr[PCSX::MDEC::DSIZE * 2] + ptr[PCSX::MDEC::DSIZE * 6];  // s26
-        z12 = MULS(ptr[PCSX::MDEC::DSIZE * 2] - ptr[PCSX::MDEC::DSIZE * 6], FIX_1_414213562) - z13;
-        //^^^^  d26=d26*2*A4-s26
-
-        tmp0 = z10 + z13;  // os07 = s04 + s26
-        tmp3 = z10 - z13;  // os34 = s04 - s26
-        tmp1 = z11 + z12;  // os16 = d04 + d26
-        tmp2 = z11 - z12;  // os25 = d04 - d26
-
-        z13 = ptr[PCSX::MDEC::DSIZE * 3] + ptr[PCSX::MDEC::DSIZE * 5];  // s53
-        z10 = ptr[PCSX::MDEC::DSIZE * 3] - ptr[PCSX::MDEC::DSIZE * 5];  //-d53
-        z11 = ptr[PCSX::MDEC::DSIZE * 1] + ptr[PCSX::MDEC::DSIZE * 7];  // s17
-        z12 = ptr[PCSX::MDEC::DSIZE * 1] - ptr[PCSX::MDEC::DSIZE * 7];  // d17
-
-        tmp7 = z11 + z13;  // od07 = s17 + s53
-
-        z5 = (z12 - z10) * (FIX_1_847759065);
-        tmp6 = SCALE(z10 * (FIX_2_613125930) + z5, AAN_CONST_BITS) - tmp7;
-        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
-        tmp4 = SCALE(z12 * (FIX_1_082392200)-z5, AAN_CONST_BITS) + tmp5;
-
-        // path #1
-        // z5 = (z12 - z10)* FIX_1_847759065;
-        // tmp0 = (d17 + d53) * 2*A2
-
-        // tmp6 = DESCALE(z10*FIX_2_613125930 + z5, CONST_BITS) - tmp7;
-        // od16 = (d53*-2*B2 + tmp0) - od07
-
-        // tmp4 = DESCALE(z12*FIX_1_082392200 - z5, CONST_BITS) + tmp5;
-        // od34 = (d17*2*B6 - tmp0) + od25
-
-        // path #2
-
-        // od34 = d17*2*(B6-A2) - d53*2*A2
-        // od16 = d53*2*(A2-B2) + d17*2*A2
-
-        // end
-
-        //    tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
-        // od25 = (s17 - s53)*2*A4 - od16
-
-        ptr[PCSX::MDEC::DSIZE * 0] = (tmp0 + tmp7);  // os07 + od07
-        ptr[PCSX::MDEC::DSIZE * 7] = (tmp0 - tmp7);  // os07 - od07
-        ptr[PCSX::MDEC::DSIZE * 1] = (tmp1 + tmp6);  // os16 + od16
-        ptr[PCSX::MDEC::DSIZE * 6] = (tmp1 - tmp6);  // os16 - od16
-        ptr[PCSX::MDEC::DSIZE * 2] = (tmp2 + tmp5);  // os25 + od25
-        ptr[PCSX::MDEC::DSIZE * 5] = (tmp2 - tmp5);  // os25 - od25
-        ptr[PCSX::MDEC::DSIZE * 4] = (tmp3 + tmp4);  // os34 + od34
-        ptr[PCSX::MDEC::DSIZE * 3] = (tmp3 - tmp4);  // os34 - od34
-    }
-
-    ptr = block;
-    if (used_col == 1) {
-        for (int i = 0; i < PCSX::MDEC::DSIZE; i++)
-            fillrow(block + PCSX::MDEC::DSIZE * i, block[PCSX::MDEC::DSIZE * i]);
-    } else {
-        for (int i = 0; i < PCSX::MDEC::DSIZE; i++, ptr += PCSX::MDEC::DSIZE) {
-            z10 = ptr[0] + ptr[4];
-            z11 = ptr[0] - ptr[4];
-            z13 = ptr[2] + ptr[6];
-            z12 = MULS(ptr[2] - ptr[6], FIX_1_414213562) - z13;
-
-            tmp0 = z10 + z13;
-            tmp3 = z10 - z13;
-            tmp1 = z11 + z12;
-            tmp2 = z11 - z12;
-
-            z13 = ptr[3] + ptr[5];
-            z10 = ptr[3] - ptr[5];
-            z11 = ptr[1] + ptr[7];
-            z12 = ptr[1] - ptr[7];
-
-            tmp7 = z11 + z13;
-            z5 = (z12 - z10) * FIX_1_847759065;
-            tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
-            tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
-            tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
-
-            ptr[0] = tmp0 + tmp7;
-
-            ptr[7] = tmp0 - tmp7;
-            ptr[1] = tmp1 + tmp6;
-            ptr[6] = tmp1 - tmp6;
-            ptr[2] = tmp2 + tmp5;
-            ptr[5] = tmp2 - tmp5;
-            ptr[4] = tmp3 + tmp4;
-            ptr[3] = tmp3 - tmp4;
-        }
-    }
-}
-
 enum {
     // mdec0: command register
     MDEC0_STP = 0x02000000,
@@ -235,32 +94,15 @@ unsigned short *PCSX::MDEC::rl2blk(int *blk, unsigned short *mdec_rl) {
         // at least one non zero cofficient in the rows 1-7
         // single coefficients in row 0 are treted specially
         // in the idtc function
-        idct(blk, used_col);
+        m_kernels.idct(blk, used_col);
         blk += DSIZE2;
     }
     return mdec_rl;
 }
 
-// full scale (JPEG)
-// Y/Cb/Cr[0...255] -> R/G/B[0...255]
-// R = 1.000 * (Y) + 1.400 * (Cr - 128)
-// G = 1.000 * (Y) - 0.343 * (Cb - 128) - 0.711 (Cr - 128)
-// B = 1.000 * (Y) + 1.765 * (Cb - 128)
-#define MULR(a) ((1434 * (a)))
-#define MULB(a) ((1807 * (a)))
-#define MULG2(a, b) ((-351 * (a) - 728 * (b)))
-#define MULY(a) ((a) << 10)
-
-#define MAKERGB15(r, g, b, a) (SWAP_LE16(a | ((b) << 10) | ((g) << 5) | (r)))
-#define SCALE8(c) SCALER(c, 20)
-#define SCALE5(c) SCALER(c, 23)
-
 #define CLAMP5(c) (((c) < -16) ? 0 : (((c) > (31 - 16)) ? 31 : ((c) + 16)))
 #define CLAMP8(c) (((c) < -128) ? 0 : (((c) > (255 - 128)) ? 255 : ((c) + 128)))
 
-#define CLAMP_SCALE8(a) (CLAMP8(SCALE8(a)))
-#define CLAMP_SCALE5(a) (CLAMP5(SCALE5(a)))
-
 inline void PCSX::MDEC::putlinebw15(uint16_t *image, int *Yblk) {
     int A = (mdec.reg0 & MDEC0_STP) ? 0x8000 : 0;
 
@@ -271,37 +113,11 @@ inline void PCSX::MDEC::putlinebw15(uint16_t *image, int *Yblk) {
     }
 }
 
-inline void PCSX::MDEC::putquadrgb15(uint16_t *image, int *Yblk, int Cr, int Cb) {
-    int Y, R, G, B;
-    int A = (mdec.reg0 & MDEC0_STP) ? 0x8000 : 0;
-    R = MULR(Cr);
-    G = MULG2(Cb, Cr);
-    B = MULB(Cb);
-
-    // added transparency
-    Y = MULY(Yblk[0]);
-    image[0] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
-    Y = MULY(Yblk[1]);
-    image[1] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
-    Y = MULY(Yblk[8]);
-    image[16] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
-    Y = MULY(Yblk[9]);
-    image[17] = MAKERGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
-}
-
 inline void PCSX::MDEC::yuv2rgb15(int *blk, unsigned short *image) {
     int *Yblk = blk + DSIZE2 * 2;
-    int *Crblk = blk;
-    int *Cbblk = blk + DSIZE2;
 
     if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingBnWMdec>()) {
-        for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 24) {
-            if (y == 8) Yblk += DSIZE2;
-            for (int x = 0; x < 4; x++, image += 2, Crblk++, Cbblk++, Yblk += 2) {
-                putquadrgb15(image, Yblk, *Crblk, *Cbblk);
-                putquadrgb15(image + 8, Yblk + DSIZE2, *(Crblk + 4), *(Cbblk + 4));
-            }
-        }
+        m_kernels.rgb15(blk, image, (mdec.reg0 & MDEC0_STP) ? 0x8000 : 0);
     } else {
         for (int y = 0; y < 16; y++, Yblk += 8, image += 16) {
             if (y == 8) Yblk += DSIZE2;
@@ -320,44 +136,11 @@ static inline void putlinebw24(uint8_t *image, int *Yblk) {
     }
 }
 
-static inline void putquadrgb24(uint8_t *image, int *Yblk, int Cr, int Cb) {
-    int Y, R, G, B;
-
-    R = MULR(Cr);
-    G = MULG2(Cb, Cr);
-    B = MULB(Cb);
-
-    Y = MULY(Yblk[0]);
-    image[0 * 3 + 0] = CLAMP_SCALE8(Y + R);
-    image[0 * 3 + 1] = CLAMP_SCALE8(Y + G);
-    image[0 * 3 + 2] = CLAMP_SCALE8(Y + B);
-    Y = MULY(Yblk[1]);
-    image[1 * 3 + 0] = CLAMP_SCALE8(Y + R);
-    image[1 * 3 + 1] = CLAMP_SCALE8(Y + G);
-    image[1 * 3 + 2] = CLAMP_SCALE8(Y + B);
-    Y = MULY(Yblk[8]);
-    image[16 * 3 + 0] = CLAMP_SCALE8(Y + R);
-    image[16 * 3 + 1] = CLAMP_SCALE8(Y + G);
-    image[16 * 3 + 2] = CLAMP_SCALE8(Y + B);
-    Y = MULY(Yblk[9]);
-    image[17 * 3 + 0] = CLAMP_SCALE8(Y + R);
-    image[17 * 3 + 1] = CLAMP_SCALE8(Y + G);
-    image[17 * 3 + 2] = CLAMP_SCALE8(Y + B);
-}
-
-void yuv2rgb24(int *blk, uint8_t *image) {
-    int *Yblk = blk + PCSX::MDEC::DSIZE2 * 2;
-    int *Crblk = blk;
-    int *Cbblk = blk + PCSX::MDEC::DSIZE2;
+inline void PCSX::MDEC::yuv2rgb24(int *blk, uint8_t *image) {
+    int *Yblk = blk + DSIZE2 * 2;
 
     if (!PCSX::g_emulator->settings.get<PCSX::Emulator::SettingBnWMdec>()) {
-        for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 8 * 3 * 3) {
-            if (y == 8) Yblk += PCSX::MDEC::DSIZE2;
-            for (int x = 0; x < 4; x++, image += 6, Crblk++, Cbblk++, Yblk += 2) {
-                putquadrgb24(image, Yblk, *Crblk, *Cbblk);
-                putquadrgb24(image + 8 * 3, Yblk + PCSX::MDEC::DSIZE2, *(Crblk + 4), *(Cbblk + 4));
-            }
-        }
+        m_kernels.rgb24(blk, image);
     } else {
         for (int y = 0; y < 16; y++, Yblk += 8, image += 16 * 3) {
             if (y == 8) Yblk += PCSX::MDEC::DSIZE2;
@@ -409,6 +192,7 @@ void PCSX::MDEC::dma0(uint32_t adr, uint32_t bcr, uint32_t chcr) {
     if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
         g_emulator->m_debug->checkDMAread(0, adr, size * 4);
     }
+    g_emulator->m_mem->msanCheckDMA(0, adr, size * 4, false);
 
     switch (cmd >> 28) {
         case 0x3:  // decode
@@ -483,6 +267,7 @@ void PCSX::MDEC::dma1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
     if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
         g_emulator->m_debug->checkDMAwrite(1, adr, size);
     }
+    g_emulator->m_mem->msanCheckDMA(1, adr, size, true);
 
     if (!(mdec.reg1 & MDEC1_BUSY)) {
         /* add to pending */
@@ -492,6 +277,7 @@ void PCSX::MDEC::dma1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
         /* do not free the dma */
     } else {
         image = g_emulator->m_mem->getPointer<uint8_t>(adr);
+        g_emulator->m_mem->markRAMDirty(adr, dmacnt);
 
         if (mdec.reg0 & MDEC0_RGB24) {
             /* 16 bits decoding
@@ -22,6 +22,7 @@
 #include "core/psxdma.h"
 #include "core/psxemulator.h"
 #include "core/psxhw.h"
+#include "core/mdec_simd.h"
 #include "core/r3000a.h"
 
 namespace PCSX {
@@ -79,6 +80,9 @@ class MDEC {
 
     int iq_y[DSIZE2], iq_uv[DSIZE2];
 
+    // The IDCT and colour conversion kernels, picked once for the host CPU
+    const MDECSIMD::Implementation &m_kernels = MDECSIMD::getImplementation();
+
     static inline const int zscan[DSIZE2] = {
         0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,   // 00
         12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,  // 10
@@ -98,8 +102,8 @@ class MDEC {
     };
 
     void putlinebw15(uint16_t *image, int *Yblk);
-    void putquadrgb15(uint16_t *image, int *Yblk, int Cr, int Cb);
     void yuv2rgb15(int *blk, unsigned short *image);
+    void yuv2rgb24(int *blk, uint8_t *image);
     void iqtab_init(int *iqtab, unsigned char *iq_y);
     unsigned short *rl2blk(int *blk, unsigned short *mdec_rl);
 };
@@ -0,0 +1,746 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/mdec_simd.h"
+
+#include <string.h>
+
+#include "support/cpufeatures.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define MDEC_SIMD_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MDEC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define AAN_CONST_BITS 12
+#define AAN_CONST_SIZE 24
+#define AAN_CONST_SCALE (AAN_CONST_SIZE - AAN_CONST_BITS)
+
+#define SCALE(x, n) ((x) >> (n))
+#define SCALER(x, n) (((x) + ((1 << (n)) >> 1)) >> (n))
+
+#define MULS(var, const) (SCALE((var) * (const), AAN_CONST_BITS))
+
+#define FIX_1_082392200 SCALER(18159528, AAN_CONST_SCALE)  // B6
+#define FIX_1_414213562 SCALER(23726566, AAN_CONST_SCALE)  // A4
+#define FIX_1_847759065 SCALER(31000253, AAN_CONST_SCALE)  // A2
+#define FIX_2_613125930 SCALER(43840978, AAN_CONST_SCALE)  // B2
+
+// full scale (JPEG)
+// Y/Cb/Cr[0...255] -> R/G/B[0...255]
+// R = 1.000 * (Y) + 1.400 * (Cr - 128)
+// G = 1.000 * (Y) - 0.343 * (Cb - 128) - 0.711 (Cr - 128)
+// B = 1.000 * (Y) + 1.765 * (Cb - 128)
+#define MULR(a) ((1434 * (a)))
+#define MULB(a) ((1807 * (a)))
+#define MULG2(a, b) ((-351 * (a) - 728 * (b)))
+#define MULY(a) ((a) << 10)
+
+#define SCALE8(c) SCALER(c, 20)
+#define SCALE5(c) SCALER(c, 23)
+
+#define CLAMP5(c) (((c) < -16) ? 0 : (((c) > (31 - 16)) ? 31 : ((c) + 16)))
+#define CLAMP8(c) (((c) < -128) ? 0 : (((c) > (255 - 128)) ? 255 : ((c) + 128)))
+
+#define CLAMP_SCALE8(a) (CLAMP8(SCALE8(a)))
+#define CLAMP_SCALE5(a) (CLAMP5(SCALE5(a)))
+
+namespace {
+
+constexpr unsigned DSIZE = 8;
+constexpr unsigned DSIZE2 = DSIZE * DSIZE;
+
+inline uint16_t makeRGB15(int r, int g, int b, uint16_t a) {
+    uint16_t pixel = a | (b << 10) | (g << 5) | r;
+#if defined(__BIGENDIAN__)
+    pixel = (pixel >> 8) | (pixel << 8);
+#endif
+    return pixel;
+}
+
+// The reference implementations, which are what the MDEC code always did
+
+inline void fillcol(int32_t* blk, int32_t val) {
+    for (unsigned i = 0; i < DSIZE; i++) blk[i * DSIZE] = val;
+}
+
+inline void fillrow(int32_t* blk, int32_t val) {
+    for (unsigned i = 0; i < DSIZE; i++) blk[i] = val;
+}
+
+void idctScalar(int32_t* block, int used_col) {
+    int tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7;
+    int z5, z10, z11, z12, z13;
+    int32_t* ptr;
+
+    // the block has only the DC coefficient
+    if (used_col == -1) {
+        int v = block[0];
+        for (unsigned i = 0; i < DSIZE2; i++) block[i] = v;
+        return;
+    }
+
+    // last_col keeps track of the highest column with non zero coefficients
+    ptr = block;
+    for (unsigned i = 0; i < DSIZE; i++, ptr++) {
+        if ((used_col & (1 << i)) == 0) {
+            // the column is empty or has only the DC coefficient
+            if (ptr[DSIZE * 0]) {
+                fillcol(ptr, ptr[0]);
+                used_col |= (1 << i);
+            }
+            continue;
+        }
+
+        // further optimization could be made by keeping track of
+        // last_row in rl2blk
+        z10 = ptr[DSIZE * 0] + ptr[DSIZE * 4];  // s04
+        z11 = ptr[DSIZE * 0] - ptr[DSIZE * 4];  // d04
+        z13 = ptr[DSIZE * 2] + ptr[DSIZE * 6];  // s26
+        z12 = MULS(ptr[DSIZE * 2] - ptr[DSIZE * 6], FIX_1_414213562) - z13;
+        //^^^^  d26=d26*2*A4-s26
+
+        tmp0 = z10 + z13;  // os07 = s04 + s26
+        tmp3 = z10 - z13;  // os34 = s04 - s26
+        tmp1 = z11 + z12;  // os16 = d04 + d26
+        tmp2 = z11 - z12;  // os25 = d04 - d26
+
+        z13 = ptr[DSIZE * 3] + ptr[DSIZE * 5];  // s53
+        z10 = ptr[DSIZE * 3] - ptr[DSIZE * 5];  //-d53
+        z11 = ptr[DSIZE * 1] + ptr[DSIZE * 7];  // s17
+        z12 = ptr[DSIZE * 1] - ptr[DSIZE * 7];  // d17
+
+        tmp7 = z11 + z13;  // od07 = s17 + s53
+
+        z5 = (z12 - z10) * (FIX_1_847759065);
+        tmp6 = SCALE(z10 * (FIX_2_613125930) + z5, AAN_CONST_BITS) - tmp7;
+        tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        tmp4 = SCALE(z12 * (FIX_1_082392200)-z5, AAN_CONST_BITS) + tmp5;
+
+        // path #1
+        // z5 = (z12 - z10)* FIX_1_847759065;
+        // tmp0 = (d17 + d53) * 2*A2
+
+        // tmp6 = DESCALE(z10*FIX_2_613125930 + z5, CONST_BITS) - tmp7;
+        // od16 = (d53*-2*B2 + tmp0) - od07
+
+        // tmp4 = DESCALE(z12*FIX_1_082392200 - z5, CONST_BITS) + tmp5;
+        // od34 = (d17*2*B6 - tmp0) + od25
+
+        // path #2
+
+        // od34 = d17*2*(B6-A2) - d53*2*A2
+        // od16 = d53*2*(A2-B2) + d17*2*A2
+
+        // end
+
+        //    tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+        // od25 = (s17 - s53)*2*A4 - od16
+
+        ptr[DSIZE * 0] = (tmp0 + tmp7);  // os07 + od07
+        ptr[DSIZE * 7] = (tmp0 - tmp7);  // os07 - od07
+        ptr[DSIZE * 1] = (tmp1 + tmp6);  // os16 + od16
+        ptr[DSIZE * 6] = (tmp1 - tmp6);  // os16 - od16
+        ptr[DSIZE * 2] = (tmp2 + tmp5);  // os25 + od25
+        ptr[DSIZE * 5] = (tmp2 - tmp5);  // os25 - od25
+        ptr[DSIZE * 4] = (tmp3 + tmp4);  // os34 + od34
+        ptr[DSIZE * 3] = (tmp3 - tmp4);  // os34 - od34
+    }
+
+    ptr = block;
+    if (used_col == 1) {
+        for (unsigned i = 0; i < DSIZE; i++) fillrow(block + DSIZE * i, block[DSIZE * i]);
+    } else {
+        for (unsigned i = 0; i < DSIZE; i++, ptr += DSIZE) {
+            z10 = ptr[0] + ptr[4];
+            z11 = ptr[0] - ptr[4];
+            z13 = ptr[2] + ptr[6];
+            z12 = MULS(ptr[2] - ptr[6], FIX_1_414213562) - z13;
+
+            tmp0 = z10 + z13;
+            tmp3 = z10 - z13;
+            tmp1 = z11 + z12;
+            tmp2 = z11 - z12;
+
+            z13 = ptr[3] + ptr[5];
+            z10 = ptr[3] - ptr[5];
+            z11 = ptr[1] + ptr[7];
+            z12 = ptr[1] - ptr[7];
+
+            tmp7 = z11 + z13;
+            z5 = (z12 - z10) * FIX_1_847759065;
+            tmp6 = SCALE(z10 * FIX_2_613125930 + z5, AAN_CONST_BITS) - tmp7;
+            tmp5 = MULS(z11 - z13, FIX_1_414213562) - tmp6;
+            tmp4 = SCALE(z12 * FIX_1_082392200 - z5, AAN_CONST_BITS) + tmp5;
+
+            ptr[0] = tmp0 + tmp7;
+
+            ptr[7] = tmp0 - tmp7;
+            ptr[1] = tmp1 + tmp6;
+            ptr[6] = tmp1 - tmp6;
+            ptr[2] = tmp2 + tmp5;
+            ptr[5] = tmp2 - tmp5;
+            ptr[4] = tmp3 + tmp4;
+            ptr[3] = tmp3 - tmp4;
+        }
+    }
+}
+
+inline void putquadrgb15(uint16_t* image, const int32_t* Yblk, int Cr, int Cb, uint16_t A) {
+    int Y, R, G, B;
+    R = MULR(Cr);
+    G = MULG2(Cb, Cr);
+    B = MULB(Cb);
+
+    Y = MULY(Yblk[0]);
+    image[0] = makeRGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[1]);
+    image[1] = makeRGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[8]);
+    image[16] = makeRGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+    Y = MULY(Yblk[9]);
+    image[17] = makeRGB15(CLAMP_SCALE5(Y + R), CLAMP_SCALE5(Y + G), CLAMP_SCALE5(Y + B), A);
+}
+
+void rgb15Scalar(const int32_t* blk, uint16_t* image, uint16_t alpha) {
+    const int32_t* Yblk = blk + DSIZE2 * 2;
+    const int32_t* Crblk = blk;
+    const int32_t* Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 24) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 2, Crblk++, Cbblk++, Yblk += 2) {
+            putquadrgb15(image, Yblk, *Crblk, *Cbblk, alpha);
+            putquadrgb15(image + 8, Yblk + DSIZE2, *(Crblk + 4), *(Cbblk + 4), alpha);
+        }
+    }
+}
+
+inline void putquadrgb24(uint8_t* image, const int32_t* Yblk, int Cr, int Cb) {
+    int Y, R, G, B;
+
+    R = MULR(Cr);
+    G = MULG2(Cb, Cr);
+    B = MULB(Cb);
+
+    Y = MULY(Yblk[0]);
+    image[0 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[0 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[0 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[1]);
+    image[1 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[1 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[1 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[8]);
+    image[16 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[16 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[16 * 3 + 2] = CLAMP_SCALE8(Y + B);
+    Y = MULY(Yblk[9]);
+    image[17 * 3 + 0] = CLAMP_SCALE8(Y + R);
+    image[17 * 3 + 1] = CLAMP_SCALE8(Y + G);
+    image[17 * 3 + 2] = CLAMP_SCALE8(Y + B);
+}
+
+void rgb24Scalar(const int32_t* blk, uint8_t* image) {
+    const int32_t* Yblk = blk + DSIZE2 * 2;
+    const int32_t* Crblk = blk;
+    const int32_t* Cbblk = blk + DSIZE2;
+
+    for (int y = 0; y < 16; y += 2, Crblk += 4, Cbblk += 4, Yblk += 8, image += 8 * 3 * 3) {
+        if (y == 8) Yblk += DSIZE2;
+        for (int x = 0; x < 4; x++, image += 6, Crblk++, Cbblk++, Yblk += 2) {
+            putquadrgb24(image, Yblk, *Crblk, *Cbblk);
+            putquadrgb24(image + 8 * 3, Yblk + DSIZE2, *(Crblk + 4), *(Cbblk + 4));
+        }
+    }
+}
+
+// The vector implementations run the exact same integer operations as the scalar ones, without any shortcut
+// but the DC only one: the scalar shortcuts only skip work whose result is known in advance. Products keep
+// their low 32 bits and shifts are arithmetic, the same as what the scalar code compiles to.
+// The IDCT does the column pass with each vector holding a row, transposes the block, does the row pass the
+// same way, and transposes it back. The colour conversion goes through a row of 16 pixels at a time, the
+// chroma being sampled once for each pair of pixels, and clamps after narrowing to 16 bits, which loses
+// nothing since the scaled values are at most 12 bits wide.
+
+// Where the 4 Y blocks of a macroblock are for a given row of pixels, and whichever 8 chroma samples cover it
+inline const int32_t* lumaRow(const int32_t* blk, int y) { return blk + DSIZE2 * (2 + (y >> 3) * 2) + (y & 7) * 8; }
+inline const int32_t* chromaRow(const int32_t* blk, int y) { return blk + (y >> 1) * 8; }
+
+// Writes 16 pixels whose bytes are 0x00BBGGRR out as packed 24 bits triplets
+inline void storeRGB24(uint8_t* image, const uint32_t* pixels) {
+    for (unsigned i = 0; i < 16; i++) {
+        image[i * 3 + 0] = pixels[i];
+        image[i * 3 + 1] = pixels[i] >> 8;
+        image[i * 3 + 2] = pixels[i] >> 16;
+    }
+}
+
+#if defined(MDEC_SIMD_X86)
+// SSE2 is part of x86-64 itself, so there's nothing to detect, but it doesn't have a 32 bits multiplication
+// keeping the low half of the products, which needs two 32x32->64 ones instead.
+inline __m128i mulSSE2(__m128i a, int32_t constant) {
+    const __m128i c = _mm_set1_epi32(constant);
+    const __m128i even = _mm_mul_epu32(a, c);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), c);
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline void aanSSE2(__m128i v[8]) {
+    __m128i z10 = _mm_add_epi32(v[0], v[4]);
+    __m128i z11 = _mm_sub_epi32(v[0], v[4]);
+    __m128i z13 = _mm_add_epi32(v[2], v[6]);
+    __m128i z12 = _mm_sub_epi32(_mm_srai_epi32(mulSSE2(_mm_sub_epi32(v[2], v[6]), FIX_1_414213562), 12), z13);
+
+    const __m128i tmp0 = _mm_add_epi32(z10, z13);
+    const __m128i tmp3 = _mm_sub_epi32(z10, z13);
+    const __m128i tmp1 = _mm_add_epi32(z11, z12);
+    const __m128i tmp2 = _mm_sub_epi32(z11, z12);
+
+    z13 = _mm_add_epi32(v[3], v[5]);
+    z10 = _mm_sub_epi32(v[3], v[5]);
+    z11 = _mm_add_epi32(v[1], v[7]);
+    z12 = _mm_sub_epi32(v[1], v[7]);
+
+    const __m128i tmp7 = _mm_add_epi32(z11, z13);
+    const __m128i z5 = mulSSE2(_mm_sub_epi32(z12, z10), FIX_1_847759065);
+    const __m128i tmp6 =
+        _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(mulSSE2(z10, FIX_2_613125930), z5), 12), tmp7);
+    const __m128i tmp5 = _mm_sub_epi32(_mm_srai_epi32(mulSSE2(_mm_sub_epi32(z11, z13), FIX_1_414213562), 12), tmp6);
+    const __m128i tmp4 =
+        _mm_add_epi32(_mm_srai_epi32(_mm_sub_epi32(mulSSE2(z12, FIX_1_082392200), z5), 12), tmp5);
+
+    v[0] = _mm_add_epi32(tmp0, tmp7);
+    v[7] = _mm_sub_epi32(tmp0, tmp7);
+    v[1] = _mm_add_epi32(tmp1, tmp6);
+    v[6] = _mm_sub_epi32(tmp1, tmp6);
+    v[2] = _mm_add_epi32(tmp2, tmp5);
+    v[5] = _mm_sub_epi32(tmp2, tmp5);
+    v[4] = _mm_add_epi32(tmp3, tmp4);
+    v[3] = _mm_sub_epi32(tmp3, tmp4);
+}
+
+inline void transpose4SSE2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    const __m128i ab0 = _mm_unpacklo_epi32(a, b);
+    const __m128i ab1 = _mm_unpackhi_epi32(a, b);
+    const __m128i cd0 = _mm_unpacklo_epi32(c, d);
+    const __m128i cd1 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(ab0, cd0);
+    b = _mm_unpackhi_epi64(ab0, cd0);
+    c = _mm_unpacklo_epi64(ab1, cd1);
+    d = _mm_unpackhi_epi64(ab1, cd1);
+}
+
+// The block is held as its left and right halves; transposing it transposes the four 4x4 quarters, and swaps
+// the top right one with the bottom left one.
+inline void transposeSSE2(__m128i left[8], __m128i right[8]) {
+    transpose4SSE2(left[0], left[1], left[2], left[3]);
+    transpose4SSE2(left[4], left[5], left[6], left[7]);
+    transpose4SSE2(right[0], right[1], right[2], right[3]);
+    transpose4SSE2(right[4], right[5], right[6], right[7]);
+    for (unsigned i = 0; i < 4; i++) {
+        const __m128i t = left[i + 4];
+        left[i + 4] = right[i];
+        right[i] = t;
+    }
+}
+
+void idctSSE2(int32_t* block, int usedColumns) {
+    if (usedColumns == -1) {
+        const __m128i dc = _mm_set1_epi32(block[0]);
+        for (unsigned i = 0; i < DSIZE2; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(block + i), dc);
+        return;
+    }
+    __m128i left[8], right[8];
+    for (unsigned i = 0; i < DSIZE; i++) {
+        left[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * DSIZE));
+        right[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * DSIZE + 4));
+    }
+    aanSSE2(left);
+    aanSSE2(right);
+    transposeSSE2(left, right);
+    aanSSE2(left);
+    aanSSE2(right);
+    transposeSSE2(left, right);
+    for (unsigned i = 0; i < DSIZE; i++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(block + i * DSIZE), left[i]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(block + i * DSIZE + 4), right[i]);
+    }
+}
+
+// Scales and clamps 8 pixels worth of one channel, given as two vectors of 4 pixels. With 23 as the shift,
+// the result is [-16, 15] biased to [0, 31], and with 20 it's [-128, 127] biased to [0, 255].
+template <int shift, int bias>
+inline __m128i scaleClampSSE2(__m128i lo, __m128i hi) {
+    const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, round), shift);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, round), shift);
+    const __m128i v = _mm_add_epi16(_mm_packs_epi32(lo, hi), _mm_set1_epi16(bias));
+    return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(bias * 2 - 1));
+}
+
+// Computes the R, G and B channels of 8 pixels as 16 bits integers, from 8 luma and 4 chroma samples.
+template <int shift, int bias>
+inline void channelsSSE2(const int32_t* luma, const int32_t* cr, const int32_t* cb, __m128i& r, __m128i& g,
+                         __m128i& b) {
+    const __m128i crs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cr));
+    const __m128i cbs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb));
+    const __m128i crLo = _mm_unpacklo_epi32(crs, crs);
+    const __m128i crHi = _mm_unpackhi_epi32(crs, crs);
+    const __m128i cbLo = _mm_unpacklo_epi32(cbs, cbs);
+    const __m128i cbHi = _mm_unpackhi_epi32(cbs, cbs);
+    const __m128i yLo = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(luma)), 10);
+    const __m128i yHi = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(luma + 4)), 10);
+
+    r = scaleClampSSE2<shift, bias>(_mm_add_epi32(yLo, mulSSE2(crLo, 1434)), _mm_add_epi32(yHi, mulSSE2(crHi, 1434)));
+    const __m128i gLo = _mm_sub_epi32(mulSSE2(cbLo, -351), mulSSE2(crLo, 728));
+    const __m128i gHi = _mm_sub_epi32(mulSSE2(cbHi, -351), mulSSE2(crHi, 728));
+    g = scaleClampSSE2<shift, bias>(_mm_add_epi32(yLo, gLo), _mm_add_epi32(yHi, gHi));
+    b = scaleClampSSE2<shift, bias>(_mm_add_epi32(yLo, mulSSE2(cbLo, 1807)), _mm_add_epi32(yHi, mulSSE2(cbHi, 1807)));
+}
+
+void rgb15SSE2(const int32_t* blk, uint16_t* image, uint16_t alpha) {
+    const __m128i a = _mm_set1_epi16(alpha);
+    for (int y = 0; y < 16; y++, image += 16) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        for (unsigned half = 0; half < 2; half++) {
+            __m128i r, g, b;
+            channelsSSE2<23, 16>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            const __m128i pixels =
+                _mm_or_si128(_mm_or_si128(r, _mm_slli_epi16(g, 5)), _mm_or_si128(_mm_slli_epi16(b, 10), a));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(image + half * 8), pixels);
+        }
+    }
+}
+
+void rgb24SSE2(const int32_t* blk, uint8_t* image) {
+    alignas(16) uint32_t pixels[16];
+    for (int y = 0; y < 16; y++, image += 16 * 3) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        for (unsigned half = 0; half < 2; half++) {
+            __m128i r, g, b;
+            channelsSSE2<20, 128>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+            _mm_store_si128(reinterpret_cast<__m128i*>(pixels + half * 8), _mm_unpacklo_epi16(rg, b));
+            _mm_store_si128(reinterpret_cast<__m128i*>(pixels + half * 8 + 4), _mm_unpackhi_epi16(rg, b));
+        }
+        storeRGB24(image, pixels);
+    }
+}
+
+PCSX_TARGET("avx2")
+inline void aanAVX2(__m256i v[8]) {
+    const __m256i a4 = _mm256_set1_epi32(FIX_1_414213562);
+    __m256i z10 = _mm256_add_epi32(v[0], v[4]);
+    __m256i z11 = _mm256_sub_epi32(v[0], v[4]);
+    __m256i z13 = _mm256_add_epi32(v[2], v[6]);
+    __m256i z12 = _mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(v[2], v[6]), a4), 12), z13);
+
+    const __m256i tmp0 = _mm256_add_epi32(z10, z13);
+    const __m256i tmp3 = _mm256_sub_epi32(z10, z13);
+    const __m256i tmp1 = _mm256_add_epi32(z11, z12);
+    const __m256i tmp2 = _mm256_sub_epi32(z11, z12);
+
+    z13 = _mm256_add_epi32(v[3], v[5]);
+    z10 = _mm256_sub_epi32(v[3], v[5]);
+    z11 = _mm256_add_epi32(v[1], v[7]);
+    z12 = _mm256_sub_epi32(v[1], v[7]);
+
+    const __m256i tmp7 = _mm256_add_epi32(z11, z13);
+    const __m256i z5 = _mm256_mullo_epi32(_mm256_sub_epi32(z12, z10), _mm256_set1_epi32(FIX_1_847759065));
+    const __m256i tmp6 = _mm256_sub_epi32(
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(z10, _mm256_set1_epi32(FIX_2_613125930)), z5), 12),
+        tmp7);
+    const __m256i tmp5 =
+        _mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(z11, z13), a4), 12), tmp6);
+    const __m256i tmp4 = _mm256_add_epi32(
+        _mm256_srai_epi32(_mm256_sub_epi32(_mm256_mullo_epi32(z12, _mm256_set1_epi32(FIX_1_082392200)), z5), 12),
+        tmp5);
+
+    v[0] = _mm256_add_epi32(tmp0, tmp7);
+    v[7] = _mm256_sub_epi32(tmp0, tmp7);
+    v[1] = _mm256_add_epi32(tmp1, tmp6);
+    v[6] = _mm256_sub_epi32(tmp1, tmp6);
+    v[2] = _mm256_add_epi32(tmp2, tmp5);
+    v[5] = _mm256_sub_epi32(tmp2, tmp5);
+    v[4] = _mm256_add_epi32(tmp3, tmp4);
+    v[3] = _mm256_sub_epi32(tmp3, tmp4);
+}
+
+PCSX_TARGET("avx2")
+inline void transposeAVX2(__m256i v[8]) {
+    __m256i t[8], u[8];
+    for (unsigned i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+    }
+    for (unsigned i = 0; i < 8; i += 4) {
+        u[i + 0] = _mm256_unpacklo_epi64(t[i + 0], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i + 0], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        v[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        v[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+PCSX_TARGET("avx2")
+void idctAVX2(int32_t* block, int usedColumns) {
+    if (usedColumns == -1) {
+        const __m256i dc = _mm256_set1_epi32(block[0]);
+        for (unsigned i = 0; i < DSIZE2; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i), dc);
+        return;
+    }
+    __m256i rows[8];
+    for (unsigned i = 0; i < DSIZE; i++) {
+        rows[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * DSIZE));
+    }
+    aanAVX2(rows);
+    transposeAVX2(rows);
+    aanAVX2(rows);
+    transposeAVX2(rows);
+    for (unsigned i = 0; i < DSIZE; i++) _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i * DSIZE), rows[i]);
+}
+
+template <int shift, int bias>
+PCSX_TARGET("avx2")
+inline __m256i scaleClampAVX2(__m256i v) {
+    v = _mm256_srai_epi32(_mm256_add_epi32(v, _mm256_set1_epi32(1 << (shift - 1))), shift);
+    v = _mm256_add_epi32(v, _mm256_set1_epi32(bias));
+    return _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(bias * 2 - 1));
+}
+
+// Computes the R, G and B channels of 8 pixels as 32 bits integers, from 8 luma and 4 chroma samples.
+// AVX2 has 32 bits min and max, so there's no need to narrow anything before clamping.
+template <int shift, int bias>
+PCSX_TARGET("avx2")
+inline void channelsAVX2(const int32_t* luma, const int32_t* cr, const int32_t* cb, __m256i& r, __m256i& g,
+                         __m256i& b) {
+    const __m256i pairs = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i crs = _mm256_permutevar8x32_epi32(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cr))), pairs);
+    const __m256i cbs = _mm256_permutevar8x32_epi32(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cb))), pairs);
+    const __m256i ys = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(luma)), 10);
+
+    r = scaleClampAVX2<shift, bias>(_mm256_add_epi32(ys, _mm256_mullo_epi32(crs, _mm256_set1_epi32(1434))));
+    const __m256i gs = _mm256_sub_epi32(_mm256_mullo_epi32(cbs, _mm256_set1_epi32(-351)),
+                                        _mm256_mullo_epi32(crs, _mm256_set1_epi32(728)));
+    g = scaleClampAVX2<shift, bias>(_mm256_add_epi32(ys, gs));
+    b = scaleClampAVX2<shift, bias>(_mm256_add_epi32(ys, _mm256_mullo_epi32(cbs, _mm256_set1_epi32(1807))));
+}
+
+PCSX_TARGET("avx2")
+void rgb15AVX2(const int32_t* blk, uint16_t* image, uint16_t alpha) {
+    const __m256i a = _mm256_set1_epi32(alpha);
+    for (int y = 0; y < 16; y++, image += 16) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        __m256i halves[2];
+        for (unsigned half = 0; half < 2; half++) {
+            __m256i r, g, b;
+            channelsAVX2<23, 16>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            halves[half] = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 5)),
+                                           _mm256_or_si256(_mm256_slli_epi32(b, 10), a));
+        }
+        // Packing works within each 128 bits lane, which interleaves the two halves by groups of 4 pixels
+        const __m256i pixels = _mm256_permute4x64_epi64(_mm256_packus_epi32(halves[0], halves[1]), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(image), pixels);
+    }
+}
+
+PCSX_TARGET("avx2")
+void rgb24AVX2(const int32_t* blk, uint8_t* image) {
+    alignas(32) uint32_t pixels[16];
+    for (int y = 0; y < 16; y++, image += 16 * 3) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        for (unsigned half = 0; half < 2; half++) {
+            __m256i r, g, b;
+            channelsAVX2<20, 128>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            const __m256i p = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)), _mm256_slli_epi32(b, 16));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(pixels + half * 8), p);
+        }
+        storeRGB24(image, pixels);
+    }
+}
+
+#endif  // MDEC_SIMD_X86
+
+#if defined(MDEC_SIMD_NEON)
+// NEON is mandatory on AArch64, so there's nothing to detect
+inline void aanNEON(int32x4_t v[8]) {
+    int32x4_t z10 = vaddq_s32(v[0], v[4]);
+    int32x4_t z11 = vsubq_s32(v[0], v[4]);
+    int32x4_t z13 = vaddq_s32(v[2], v[6]);
+    int32x4_t z12 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(v[2], v[6]), FIX_1_414213562), 12), z13);
+
+    const int32x4_t tmp0 = vaddq_s32(z10, z13);
+    const int32x4_t tmp3 = vsubq_s32(z10, z13);
+    const int32x4_t tmp1 = vaddq_s32(z11, z12);
+    const int32x4_t tmp2 = vsubq_s32(z11, z12);
+
+    z13 = vaddq_s32(v[3], v[5]);
+    z10 = vsubq_s32(v[3], v[5]);
+    z11 = vaddq_s32(v[1], v[7]);
+    z12 = vsubq_s32(v[1], v[7]);
+
+    const int32x4_t tmp7 = vaddq_s32(z11, z13);
+    const int32x4_t z5 = vmulq_n_s32(vsubq_s32(z12, z10), FIX_1_847759065);
+    const int32x4_t tmp6 = vsubq_s32(vshrq_n_s32(vaddq_s32(vmulq_n_s32(z10, FIX_2_613125930), z5), 12), tmp7);
+    const int32x4_t tmp5 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(z11, z13), FIX_1_414213562), 12), tmp6);
+    const int32x4_t tmp4 = vaddq_s32(vshrq_n_s32(vsubq_s32(vmulq_n_s32(z12, FIX_1_082392200), z5), 12), tmp5);
+
+    v[0] = vaddq_s32(tmp0, tmp7);
+    v[7] = vsubq_s32(tmp0, tmp7);
+    v[1] = vaddq_s32(tmp1, tmp6);
+    v[6] = vsubq_s32(tmp1, tmp6);
+    v[2] = vaddq_s32(tmp2, tmp5);
+    v[5] = vsubq_s32(tmp2, tmp5);
+    v[4] = vaddq_s32(tmp3, tmp4);
+    v[3] = vsubq_s32(tmp3, tmp4);
+}
+
+inline void transpose4NEON(int32x4_t& a, int32x4_t& b, int32x4_t& c, int32x4_t& d) {
+    const int32x4x2_t ab = vtrnq_s32(a, b);
+    const int32x4x2_t cd = vtrnq_s32(c, d);
+    a = vcombine_s32(vget_low_s32(ab.val[0]), vget_low_s32(cd.val[0]));
+    b = vcombine_s32(vget_low_s32(ab.val[1]), vget_low_s32(cd.val[1]));
+    c = vcombine_s32(vget_high_s32(ab.val[0]), vget_high_s32(cd.val[0]));
+    d = vcombine_s32(vget_high_s32(ab.val[1]), vget_high_s32(cd.val[1]));
+}
+
+// Same as the SSE2 version, the block is held as its left and right halves
+inline void transposeNEON(int32x4_t left[8], int32x4_t right[8]) {
+    transpose4NEON(left[0], left[1], left[2], left[3]);
+    transpose4NEON(left[4], left[5], left[6], left[7]);
+    transpose4NEON(right[0], right[1], right[2], right[3]);
+    transpose4NEON(right[4], right[5], right[6], right[7]);
+    for (unsigned i = 0; i < 4; i++) {
+        const int32x4_t t = left[i + 4];
+        left[i + 4] = right[i];
+        right[i] = t;
+    }
+}
+
+void idctNEON(int32_t* block, int usedColumns) {
+    if (usedColumns == -1) {
+        const int32x4_t dc = vdupq_n_s32(block[0]);
+        for (unsigned i = 0; i < DSIZE2; i += 4) vst1q_s32(block + i, dc);
+        return;
+    }
+    int32x4_t left[8], right[8];
+    for (unsigned i = 0; i < DSIZE; i++) {
+        left[i] = vld1q_s32(block + i * DSIZE);
+        right[i] = vld1q_s32(block + i * DSIZE + 4);
+    }
+    aanNEON(left);
+    aanNEON(right);
+    transposeNEON(left, right);
+    aanNEON(left);
+    aanNEON(right);
+    transposeNEON(left, right);
+    for (unsigned i = 0; i < DSIZE; i++) {
+        vst1q_s32(block + i * DSIZE, left[i]);
+        vst1q_s32(block + i * DSIZE + 4, right[i]);
+    }
+}
+
+template <int shift, int bias>
+inline int16x8_t scaleClampNEON(int32x4_t lo, int32x4_t hi) {
+    const int32x4_t round = vdupq_n_s32(1 << (shift - 1));
+    lo = vshrq_n_s32(vaddq_s32(lo, round), shift);
+    hi = vshrq_n_s32(vaddq_s32(hi, round), shift);
+    const int16x8_t v = vaddq_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)), vdupq_n_s16(bias));
+    return vminq_s16(vmaxq_s16(v, vdupq_n_s16(0)), vdupq_n_s16(bias * 2 - 1));
+}
+
+template <int shift, int bias>
+inline void channelsNEON(const int32_t* luma, const int32_t* cr, const int32_t* cb, int16x8_t& r, int16x8_t& g,
+                         int16x8_t& b) {
+    const int32x4x2_t crs = vzipq_s32(vld1q_s32(cr), vld1q_s32(cr));
+    const int32x4x2_t cbs = vzipq_s32(vld1q_s32(cb), vld1q_s32(cb));
+    const int32x4_t yLo = vshlq_n_s32(vld1q_s32(luma), 10);
+    const int32x4_t yHi = vshlq_n_s32(vld1q_s32(luma + 4), 10);
+
+    r = scaleClampNEON<shift, bias>(vmlaq_n_s32(yLo, crs.val[0], 1434), vmlaq_n_s32(yHi, crs.val[1], 1434));
+    const int32x4_t gLo = vmlsq_n_s32(vmulq_n_s32(cbs.val[0], -351), crs.val[0], 728);
+    const int32x4_t gHi = vmlsq_n_s32(vmulq_n_s32(cbs.val[1], -351), crs.val[1], 728);
+    g = scaleClampNEON<shift, bias>(vaddq_s32(yLo, gLo), vaddq_s32(yHi, gHi));
+    b = scaleClampNEON<shift, bias>(vmlaq_n_s32(yLo, cbs.val[0], 1807), vmlaq_n_s32(yHi, cbs.val[1], 1807));
+}
+
+void rgb15NEON(const int32_t* blk, uint16_t* image, uint16_t alpha) {
+    const uint16x8_t a = vdupq_n_u16(alpha);
+    for (int y = 0; y < 16; y++, image += 16) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        for (unsigned half = 0; half < 2; half++) {
+            int16x8_t r, g, b;
+            channelsNEON<23, 16>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            uint16x8_t pixels = vorrq_u16(vreinterpretq_u16_s16(r), a);
+            pixels = vorrq_u16(pixels, vshlq_n_u16(vreinterpretq_u16_s16(g), 5));
+            pixels = vorrq_u16(pixels, vshlq_n_u16(vreinterpretq_u16_s16(b), 10));
+            vst1q_u16(image + half * 8, pixels);
+        }
+    }
+}
+
+void rgb24NEON(const int32_t* blk, uint8_t* image) {
+    for (int y = 0; y < 16; y++, image += 16 * 3) {
+        const int32_t* luma = lumaRow(blk, y);
+        const int32_t* cr = chromaRow(blk, y);
+        for (unsigned half = 0; half < 2; half++) {
+            int16x8_t r, g, b;
+            channelsNEON<20, 128>(luma + half * DSIZE2, cr + half * 4, cr + DSIZE2 + half * 4, r, g, b);
+            uint8x8x3_t pixels;
+            pixels.val[0] = vqmovun_s16(r);
+            pixels.val[1] = vqmovun_s16(g);
+            pixels.val[2] = vqmovun_s16(b);
+            vst3_u8(image + half * 8 * 3, pixels);
+        }
+    }
+}
+#endif  // MDEC_SIMD_NEON
+
+}  // namespace
+
+std::vector<PCSX::MDECSIMD::Implementation> PCSX::MDECSIMD::getSupportedImplementations() {
+    std::vector<Implementation> implementations = {{"Scalar", idctScalar, rgb15Scalar, rgb24Scalar}};
+#if defined(MDEC_SIMD_X86)
+    implementations.push_back({"SSE2", idctSSE2, rgb15SSE2, rgb24SSE2});
+    if (CPUFeatures::hasAVX2()) implementations.push_back({"AVX2", idctAVX2, rgb15AVX2, rgb24AVX2});
+#elif defined(MDEC_SIMD_NEON)
+    implementations.push_back({"NEON", idctNEON, rgb15NEON, rgb24NEON});
+#endif
+    return implementations;
+}
+
+const PCSX::MDECSIMD::Implementation& PCSX::MDECSIMD::getImplementation() {
+    static const Implementation implementation = getSupportedImplementations().back();
+    return implementation;
+}
@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+namespace MDECSIMD {
+
+// Runs the AAN inverse DCT in place on an 8x8 block of dequantized coefficients, columns first, then rows.
+// usedColumns is what rl2blk tracks: -1 if the block only has its DC coefficient, otherwise a bitmask of
+// the columns having non-zero coefficients below the first row. The scalar implementation uses it to skip
+// work, the vector ones only look for the DC case, and all of them give the exact same integers.
+using IDCTKernel = void (*)(int32_t* block, int usedColumns);
+
+// Convert a decoded macroblock, which is the Cr, Cb, then the 4 Y blocks out of rl2blk, into 16x16 pixels,
+// row by row. The 15 bits version ORs alpha into every pixel, which is 0x8000 when the STP bit is requested.
+using RGB15Kernel = void (*)(const int32_t* blocks, uint16_t* image, uint16_t alpha);
+using RGB24Kernel = void (*)(const int32_t* blocks, uint8_t* image);
+
+struct Implementation {
+    const char* name;
+    IDCTKernel idct;
+    RGB15Kernel rgb15;
+    RGB24Kernel rgb24;
+};
+
+// All the implementations the host CPU can run, from the slowest (the scalar one) to the fastest
+std::vector<Implementation> getSupportedImplementations();
+
+// The fastest implementation the host CPU can run. Feature detection only happens on the first call.
+const Implementation& getImplementation();
+
+}  // namespace MDECSIMD
+
+}  // namespace PCSX
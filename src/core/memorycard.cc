@@ -87,9 +87,45 @@ uint8_t PCSX::MemoryCard::transceive(uint8_t value) {
     return data_out;
 }
 
+// The bytes sent back from tick 5 to tick 137 of a read: the acknowledge, the sector number, its data, the checksum,
+// and the final status.
+void PCSX::MemoryCard::prepareReadResponse() {
+    uint8_t* out = m_response;
+    *out++ = Responses::CommandAcknowledge2;
+    *out++ = m_sector >> 8;
+    *out++ = m_sector & 0xff;
+    uint8_t checksum = (m_sector >> 8) ^ (m_sector & 0xff);
+    if (m_sector >= 1024) {
+        memset(out, Responses::BadSector, c_sectorSize);
+    } else {
+        memcpy(out, &m_mcdData[m_sector * c_sectorSize], c_sectorSize);
+    }
+    for (unsigned i = 0; i < c_sectorSize; i++) checksum ^= out[i];
+    out += c_sectorSize;
+    *out++ = checksum;
+    *out++ = Responses::GoodReadWrite;
+    m_responseSector = m_sector;
+    m_responseReady = true;
+}
+
 uint8_t PCSX::MemoryCard::tickReadCommand(uint8_t value) {
     uint8_t data_out = 0xFF;
 
+    // Past the sector number, the bytes come out of the prepared response, only keeping the state the byte by
+    // byte path would have, in case the fast path gets turned off halfway, or the state gets saved.
+    if (m_responseReady && (m_responseSector == m_sector) && (m_commandTicks >= 5) && (m_commandTicks <= 137)) {
+        data_out = m_response[m_commandTicks - 5];
+        if (m_commandTicks == 7) {
+            m_checksumOut = (m_sector >> 8) ^ (m_sector & 0xff);
+        } else if ((m_commandTicks >= 8) && (m_commandTicks <= 135)) {
+            if (m_sector < 1024) m_dataOffset++;
+            m_checksumOut ^= data_out;
+        }
+        m_commandTicks++;
+        acknowledge();
+        return data_out;
+    }
+
     switch (m_commandTicks) {
         case 0:
             data_out = Responses::ID1;
@@ -113,6 +149,7 @@ uint8_t PCSX::MemoryCard::tickReadCommand(uint8_t value) {
             m_sector |= value;
             m_dataOffset = m_sector * 128;
             data_out = Responses::CommandAcknowledge1;
+            if (m_sio->m_fastPath) prepareReadResponse();
             break;
 
         case 5:  // 00h
@@ -245,7 +282,9 @@ uint8_t PCSX::MemoryCard::tickWriteCommand(uint8_t value) {
             m_directoryFlag = Flags::DirectoryRead;
             data_out = Responses::GoodReadWrite;
             memcpy(&m_mcdData[m_sector * 128], &m_tempBuffer, c_sectorSize);
+            m_dirtySectors[m_sector] = true;
             m_savedToDisk = false;
+            m_sectorWritten = true;
             break;
     }
 
@@ -334,6 +373,10 @@ uint8_t PCSX::MemoryCard::tickPS_GetVersion(uint8_t value) {
 
 // To-do: "All the code starting here is terrible and needs to be rewritten"
 void PCSX::MemoryCard::loadMcd(PCSX::u8string mcd) {
+    // Whatever is still pending belongs to the card being swapped out.
+    flush();
+    waitFlush();
+    m_dirtySectors.reset();
     char *data = m_mcdData;
     if (std::filesystem::path(mcd).is_relative()) {
         mcd = (g_system->getPersistentDir() / mcd).u8string();
@@ -390,6 +433,10 @@ void PCSX::MemoryCard::loadMcd(PCSX::u8string mcd) {
 }
 
 void PCSX::MemoryCard::saveMcd(PCSX::u8string mcd, const char *data, uint32_t adr, size_t size) {
+    // The files belong to the emulator this one got forked from.
+    if (g_emulator->isFork()) return;
+    // An older write back landing after this one would undo it.
+    waitFlush();
     if (std::filesystem::path(mcd).is_relative()) {
         mcd = (g_system->getPersistentDir() / mcd).u8string();
     }
@@ -425,6 +472,66 @@ void PCSX::MemoryCard::saveMcd(PCSX::u8string mcd, const char *data, uint32_t ad
     }
 }
 
+void PCSX::MemoryCard::idle() {
+    if (m_flush.valid() && (m_flush.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) waitFlush();
+    if (m_savedToDisk || m_flushPath.empty()) return;
+    if (++m_idleFrames >= c_flushDelay) flush();
+}
+
+void PCSX::MemoryCard::flush() {
+    if (m_savedToDisk || m_flushPath.empty()) return;
+    if (g_emulator->isFork()) return;
+    waitFlush();
+    PCSX::u8string mcd = m_flushPath;
+    if (std::filesystem::path(mcd).is_relative()) {
+        mcd = (g_system->getPersistentDir() / mcd).u8string();
+    }
+    PCSX::g_system->printf(_("Saving %i changed sectors of memory card %s\n"), int(m_dirtySectors.count()),
+                           reinterpret_cast<const char *>(mcd.c_str()));
+    m_dirtySectors.reset();
+    m_savedToDisk = true;
+    m_idleFrames = 0;
+    m_flush = std::async(std::launch::async,
+                         [path = std::filesystem::path(mcd), data = std::string(m_mcdData, c_cardSize)]() {
+                             return writeCardFile(path, data);
+                         });
+}
+
+void PCSX::MemoryCard::waitFlush() {
+    if (!m_flush.valid()) return;
+    if (!m_flush.get()) PCSX::g_system->printf(_("Failed to save memory card\n"));
+}
+
+bool PCSX::MemoryCard::writeCardFile(const std::filesystem::path &path, const std::string &data) {
+    // Keep the VGS or DexDrive header the card may have.
+    std::string header;
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (!ec && ((size == c_cardSize + 64) || (size == c_cardSize + 3904))) {
+        header.resize(size - c_cardSize);
+        FILE *f = fopen(reinterpret_cast<const char *>(path.u8string().c_str()), "rb");
+        if (f == nullptr) return false;
+        const bool read = fread(header.data(), 1, header.size(), f) == header.size();
+        fclose(f);
+        if (!read) return false;
+    }
+
+    auto temp = path;
+    temp += ".tmp";
+    FILE *f = fopen(reinterpret_cast<const char *>(temp.u8string().c_str()), "wb");
+    if (f == nullptr) return false;
+    bool written = fwrite(header.data(), 1, header.size(), f) == header.size();
+    written = written && (fwrite(data.data(), 1, data.size(), f) == data.size());
+    written = (fflush(f) == 0) && written;
+    fclose(f);
+    if (written) std::filesystem::rename(temp, path, ec);
+    if (!written || ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
 void PCSX::MemoryCard::createMcd(PCSX::u8string mcd) {
     if (std::filesystem::path(mcd).is_relative()) {
         mcd = (g_system->getPersistentDir() / mcd).u8string();
@@ -21,6 +21,12 @@
 
 #include <stdint.h>
 
+#include <bitset>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <utility>
+
 #include "core/sstate.h"
 
 namespace PCSX {
@@ -40,22 +46,36 @@ class MemoryCard {
         m_dataOffset = 0;
         m_sector = 0;
         m_spdr = Responses::IdleHighZ;
+        m_responseReady = false;
     }
 
     // File system / data manipulation
+    // Writes from the guest only land in memory. Committing merely remembers where they need to go; the card
+    // gets written back as a whole once it hasn't been written to for a few frames, see idle().
     void commit(const PCSX::u8string path) {
-        if (!m_savedToDisk) {
-            saveMcd(path);
-        }
+        m_flushPath = path;
+        m_idleFrames = 0;
     }
+    // Called on every vsync, and starts writing back the changes once the card went quiet.
+    void idle();
+    // Starts writing back whatever changed right away, on a worker thread, into a temporary file which then
+    // gets renamed over the card, so a crash never leaves a half written card behind.
+    void flush();
+    // Waits for the write back in flight, if any.
+    void waitFlush();
     void createMcd(PCSX::u8string mcd);
     bool dataChanged() { return !m_savedToDisk; }
+    // Whether the guest wrote a sector since the last call, which is when the card needs committing.
+    bool sectorWritten() { return std::exchange(m_sectorWritten, false); }
     void disablePocketstation() { m_pocketstationEnabled = false; };
     void enablePocketstation() { m_pocketstationEnabled = true; };
     char *getMcdData() { return m_mcdData; }
     void loadMcd(PCSX::u8string mcd);
     void saveMcd(PCSX::u8string mcd, const char *data, uint32_t adr, size_t size);
-    void saveMcd(PCSX::u8string mcd) { saveMcd(mcd, m_mcdData, 0, c_cardSize); }
+    void saveMcd(PCSX::u8string mcd) {
+        saveMcd(mcd, m_mcdData, 0, c_cardSize);
+        m_dirtySectors.reset();
+    }
 
   private:
     enum Commands : uint8_t {
@@ -100,19 +120,29 @@ class MemoryCard {
     static constexpr size_t c_sectorSize = 8 * 16;
     static constexpr size_t c_blockSize = 8192;
     static constexpr size_t c_cardSize = 1024 * c_sectorSize;
+    static constexpr size_t c_sectorCount = c_cardSize / c_sectorSize;
+    static constexpr unsigned c_flushDelay = 30;
 
     // State machine / handlers
     uint8_t transceive(uint8_t value);
     uint8_t tickReadCommand(uint8_t value);
+    void prepareReadResponse();
     uint8_t tickWriteCommand(uint8_t value);
     uint8_t tickPS_GetDirIndex(uint8_t value);   // 5Ah
     uint8_t tickPS_GetVersion(uint8_t value);    // 58h
     uint8_t tickPS_PrepFileExec(uint8_t value);  // 59h
     uint8_t tickPS_ExecCustom(uint8_t value);    // 5Dh
 
+    static bool writeCardFile(const std::filesystem::path &path, const std::string &data);
+
     char m_mcdData[c_cardSize];
     uint8_t m_tempBuffer[c_sectorSize];
     bool m_savedToDisk = false;
+    bool m_sectorWritten = false;
+    std::bitset<c_sectorCount> m_dirtySectors;
+    PCSX::u8string m_flushPath;
+    unsigned m_idleFrames = 0;
+    std::future<bool> m_flush;
 
     uint8_t m_checksumIn = 0, m_checksumOut = 0;
     uint16_t m_commandTicks = 0;
@@ -124,6 +154,12 @@ class MemoryCard {
 
     uint8_t m_spdr = Responses::IdleHighZ;
 
+    // Once the sector of a read is known, everything the card sends back until the end of the command is, so
+    // it all gets prepared at once, for the sector it was prepared for.
+    uint8_t m_response[c_sectorSize + 5];
+    uint16_t m_responseSector = 0;
+    bool m_responseReady = false;
+
     // PocketStation Specific
     bool m_pocketstationEnabled = false;
     uint16_t m_directoryIndex = 0;
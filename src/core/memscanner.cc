@@ -0,0 +1,624 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/memscanner.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+
+#include "support/cpufeatures.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define MEMSCANNER_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MEMSCANNER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using PCSX::MemScanner;
+using ScanType = MemScanner::ScanType;
+using ValueType = MemScanner::ValueType;
+using Criterion = MemScanner::Criterion;
+using NarrowKernel = MemScanner::NarrowKernel;
+
+template <typename T>
+T convert(double value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(value);
+    } else {
+        return static_cast<T>(static_cast<int64_t>(value));
+    }
+}
+
+// Each set of operations works on a vector of values, and comes with the comparisons the scan types are made of.
+// The floating point ones are all ordered, except for ne, so that a NaN is never equal, greater, or lesser than
+// anything, like in C++.
+template <typename Ops, ScanType scanType>
+typename Ops::Mask predicate(typename Ops::Vec current, typename Ops::Vec previous, typename Ops::Vec value,
+                             typename Ops::Vec high) {
+    if constexpr (scanType == ScanType::ExactValue) return Ops::eq(current, value);
+    if constexpr (scanType == ScanType::GreaterThan) return Ops::gt(current, value);
+    if constexpr (scanType == ScanType::LessThan) return Ops::gt(value, current);
+    if constexpr (scanType == ScanType::InRange) return Ops::both(Ops::ge(current, value), Ops::ge(high, current));
+    if constexpr (scanType == ScanType::Changed) return Ops::ne(current, previous);
+    if constexpr (scanType == ScanType::Unchanged) return Ops::eq(current, previous);
+    if constexpr (scanType == ScanType::Increased) return Ops::gt(current, previous);
+    if constexpr (scanType == ScanType::Decreased) return Ops::gt(previous, current);
+    if constexpr (scanType == ScanType::UnknownInitialValue) return Ops::all();
+}
+
+// Ops::group returns the matches of the next Ops::c_lanes values, as the bottom bits of its result
+template <typename Ops, ScanType scanType>
+struct Kernel {
+    static void narrow(const uint8_t* current, const uint8_t* previous, const Criterion& criterion, uint64_t* words,
+                       unsigned count) {
+        constexpr unsigned c_size = sizeof(typename Ops::Scalar);
+        const auto value = Ops::broadcast(criterion.value);
+        const auto high = Ops::broadcast(criterion.high);
+        for (unsigned w = 0; w < count; w++, current += 64 * c_size, previous += 64 * c_size) {
+            if (!words[w]) continue;
+            uint64_t matches = 0;
+            for (unsigned i = 0; i < 64; i += Ops::c_lanes) {
+                matches |= Ops::template group<scanType>(current + i * c_size, previous + i * c_size, value, high)
+                           << i;
+            }
+            words[w] &= matches;
+        }
+    }
+};
+
+template <template <typename, ScanType> class Kernel, typename Ops>
+NarrowKernel selectScanType(ScanType scanType) {
+    switch (scanType) {
+        case ScanType::ExactValue:
+            return Kernel<Ops, ScanType::ExactValue>::narrow;
+        case ScanType::GreaterThan:
+            return Kernel<Ops, ScanType::GreaterThan>::narrow;
+        case ScanType::LessThan:
+            return Kernel<Ops, ScanType::LessThan>::narrow;
+        case ScanType::InRange:
+            return Kernel<Ops, ScanType::InRange>::narrow;
+        case ScanType::Changed:
+            return Kernel<Ops, ScanType::Changed>::narrow;
+        case ScanType::Unchanged:
+            return Kernel<Ops, ScanType::Unchanged>::narrow;
+        case ScanType::Increased:
+            return Kernel<Ops, ScanType::Increased>::narrow;
+        case ScanType::Decreased:
+            return Kernel<Ops, ScanType::Decreased>::narrow;
+        case ScanType::UnknownInitialValue:
+            return Kernel<Ops, ScanType::UnknownInitialValue>::narrow;
+    }
+    throw std::runtime_error("Invalid scan type.");
+}
+
+template <template <typename, ScanType> class Kernel, template <typename> class Ops>
+NarrowKernel selectValueType(ValueType valueType, ScanType scanType) {
+    switch (valueType) {
+        case ValueType::Char:
+            return selectScanType<Kernel, Ops<int8_t>>(scanType);
+        case ValueType::Uchar:
+            return selectScanType<Kernel, Ops<uint8_t>>(scanType);
+        case ValueType::Short:
+            return selectScanType<Kernel, Ops<int16_t>>(scanType);
+        case ValueType::Ushort:
+            return selectScanType<Kernel, Ops<uint16_t>>(scanType);
+        case ValueType::Int:
+            return selectScanType<Kernel, Ops<int32_t>>(scanType);
+        case ValueType::Uint:
+            return selectScanType<Kernel, Ops<uint32_t>>(scanType);
+        case ValueType::Float:
+            return selectScanType<Kernel, Ops<float>>(scanType);
+    }
+    throw std::runtime_error("Invalid value type.");
+}
+
+// The reference implementation, one value at a time
+template <typename T>
+struct ScalarOps {
+    using Scalar = T;
+    using Vec = T;
+    using Mask = bool;
+    static constexpr unsigned c_lanes = 1;
+
+    static Vec load(const uint8_t* p) {
+        T value;
+        memcpy(&value, p, sizeof(T));
+        return value;
+    }
+    static Vec broadcast(double value) { return convert<T>(value); }
+    static Mask eq(Vec a, Vec b) { return a == b; }
+    static Mask ne(Vec a, Vec b) { return !(a == b); }
+    static Mask gt(Vec a, Vec b) { return a > b; }
+    static Mask ge(Vec a, Vec b) { return a >= b; }
+    static Mask both(Mask a, Mask b) { return a && b; }
+    static Mask all() { return true; }
+
+    template <ScanType scanType>
+    static uint64_t group(const uint8_t* current, const uint8_t* previous, Vec value, Vec high) {
+        return predicate<ScalarOps, scanType>(load(current), load(previous), value, high) ? 1 : 0;
+    }
+};
+
+NarrowKernel selectScalar(ValueType valueType, ScanType scanType) {
+    return selectValueType<Kernel, ScalarOps>(valueType, scanType);
+}
+
+#if defined(MEMSCANNER_X86)
+// Everything here needs to be marked for AVX2, including the shared predicate and kernel, or GCC and Clang
+// won't let the intrinsics get inlined into them.
+template <typename Ops, ScanType scanType>
+PCSX_TARGET("avx2")
+typename Ops::Mask predicateAVX2(typename Ops::Vec current, typename Ops::Vec previous, typename Ops::Vec value,
+                                 typename Ops::Vec high) {
+    if constexpr (scanType == ScanType::ExactValue) return Ops::eq(current, value);
+    if constexpr (scanType == ScanType::GreaterThan) return Ops::gt(current, value);
+    if constexpr (scanType == ScanType::LessThan) return Ops::gt(value, current);
+    if constexpr (scanType == ScanType::InRange) return Ops::both(Ops::ge(current, value), Ops::ge(high, current));
+    if constexpr (scanType == ScanType::Changed) return Ops::ne(current, previous);
+    if constexpr (scanType == ScanType::Unchanged) return Ops::eq(current, previous);
+    if constexpr (scanType == ScanType::Increased) return Ops::gt(current, previous);
+    if constexpr (scanType == ScanType::Decreased) return Ops::gt(previous, current);
+    if constexpr (scanType == ScanType::UnknownInitialValue) return Ops::all();
+}
+
+template <typename Ops, ScanType scanType>
+struct KernelAVX2 {
+    PCSX_TARGET("avx2")
+    static void narrow(const uint8_t* current, const uint8_t* previous, const Criterion& criterion, uint64_t* words,
+                       unsigned count) {
+        constexpr unsigned c_size = sizeof(typename Ops::Scalar);
+        const auto value = Ops::broadcast(criterion.value);
+        const auto high = Ops::broadcast(criterion.high);
+        for (unsigned w = 0; w < count; w++, current += 64 * c_size, previous += 64 * c_size) {
+            if (!words[w]) continue;
+            const uint64_t low = Ops::template group<scanType>(current, previous, value, high);
+            const uint64_t top = Ops::template group<scanType>(current + 32 * c_size, previous + 32 * c_size, value,
+                                                               high);
+            words[w] &= low | (top << 32);
+        }
+    }
+};
+
+// AVX2 only has signed comparisons, so the unsigned types get their sign bit flipped as they're loaded, which
+// orders them the same way. Each group is 32 values, which is one register for bytes, two for shorts, and four
+// for ints; the masks get packed down to one bit per value.
+template <typename T>
+struct AVX2IntOps {
+    using Scalar = T;
+    using Vec = __m256i;
+    using Mask = __m256i;
+    static constexpr unsigned c_lanes = 32;
+
+    PCSX_TARGET("avx2") static __m256i bias() {
+        if constexpr (std::is_signed_v<T>) {
+            return _mm256_setzero_si256();
+        } else if constexpr (sizeof(T) == 1) {
+            return _mm256_set1_epi8(static_cast<char>(0x80));
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm256_set1_epi16(static_cast<short>(0x8000));
+        } else {
+            return _mm256_set1_epi32(static_cast<int>(0x80000000));
+        }
+    }
+    PCSX_TARGET("avx2") static Vec load(const uint8_t* p) {
+        return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), bias());
+    }
+    PCSX_TARGET("avx2") static Vec broadcast(double value) {
+        const T scalar = convert<T>(value);
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_xor_si256(_mm256_set1_epi8(static_cast<char>(scalar)), bias());
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm256_xor_si256(_mm256_set1_epi16(static_cast<short>(scalar)), bias());
+        } else {
+            return _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(scalar)), bias());
+        }
+    }
+    PCSX_TARGET("avx2") static Mask eq(Vec a, Vec b) {
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_cmpeq_epi8(a, b);
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        } else {
+            return _mm256_cmpeq_epi32(a, b);
+        }
+    }
+    PCSX_TARGET("avx2") static Mask gt(Vec a, Vec b) {
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_cmpgt_epi8(a, b);
+        } else if constexpr (sizeof(T) == 2) {
+            return _mm256_cmpgt_epi16(a, b);
+        } else {
+            return _mm256_cmpgt_epi32(a, b);
+        }
+    }
+    PCSX_TARGET("avx2") static Mask all() { return _mm256_set1_epi32(-1); }
+    PCSX_TARGET("avx2") static Mask ne(Vec a, Vec b) { return _mm256_xor_si256(eq(a, b), all()); }
+    PCSX_TARGET("avx2") static Mask ge(Vec a, Vec b) { return _mm256_xor_si256(gt(b, a), all()); }
+    PCSX_TARGET("avx2") static Mask both(Mask a, Mask b) { return _mm256_and_si256(a, b); }
+
+    template <ScanType scanType>
+    PCSX_TARGET("avx2")
+    static Mask match(const uint8_t* current, const uint8_t* previous, Vec value, Vec high) {
+        return predicateAVX2<AVX2IntOps, scanType>(load(current), load(previous), value, high);
+    }
+
+    template <ScanType scanType>
+    PCSX_TARGET("avx2")
+    static uint64_t group(const uint8_t* current, const uint8_t* previous, Vec value, Vec high) {
+        if constexpr (sizeof(T) == 1) {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(match<scanType>(current, previous, value, high)));
+        } else if constexpr (sizeof(T) == 2) {
+            // The packing works within each half of the registers, so the quarters need putting back in order
+            const __m256i packed = _mm256_packs_epi16(match<scanType>(current, previous, value, high),
+                                                      match<scanType>(current + 32, previous + 32, value, high));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_permute4x64_epi64(packed, 0xd8)));
+        } else {
+            uint64_t bits = 0;
+            for (unsigned i = 0; i < 4; i++) {
+                const Mask mask = match<scanType>(current + i * 32, previous + i * 32, value, high);
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))) << (i * 8);
+            }
+            return bits;
+        }
+    }
+};
+
+struct AVX2FloatOps {
+    using Scalar = float;
+    using Vec = __m256;
+    using Mask = __m256;
+    static constexpr unsigned c_lanes = 32;
+
+    PCSX_TARGET("avx2") static Vec load(const uint8_t* p) {
+        return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+    }
+    PCSX_TARGET("avx2") static Vec broadcast(double value) { return _mm256_set1_ps(convert<float>(value)); }
+    PCSX_TARGET("avx2") static Mask eq(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    PCSX_TARGET("avx2") static Mask ne(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    PCSX_TARGET("avx2") static Mask gt(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    PCSX_TARGET("avx2") static Mask ge(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    PCSX_TARGET("avx2") static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    PCSX_TARGET("avx2") static Mask all() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+
+    template <ScanType scanType>
+    PCSX_TARGET("avx2")
+    static uint64_t group(const uint8_t* current, const uint8_t* previous, Vec value, Vec high) {
+        uint64_t bits = 0;
+        for (unsigned i = 0; i < 4; i++) {
+            const Mask match = predicateAVX2<AVX2FloatOps, scanType>(load(current + i * 32),
+                                                                     load(previous + i * 32), value, high);
+            bits |= static_cast<uint64_t>(_mm256_movemask_ps(match)) << (i * 8);
+        }
+        return bits;
+    }
+};
+
+template <typename T>
+using AVX2Ops = std::conditional_t<std::is_floating_point_v<T>, AVX2FloatOps, AVX2IntOps<T>>;
+
+NarrowKernel selectAVX2(ValueType valueType, ScanType scanType) {
+    return selectValueType<KernelAVX2, AVX2Ops>(valueType, scanType);
+}
+
+#endif  // MEMSCANNER_X86
+
+#if defined(MEMSCANNER_NEON)
+// NEON is mandatory on AArch64, so there's nothing to detect. Each group is a single register, and the masks get
+// turned into bits by giving each lane its own bit, then adding the lanes up.
+template <typename T>
+struct NEONTypes;
+
+template <>
+struct NEONTypes<int8_t> {
+    using Vec = int8x16_t;
+    static Vec load(const uint8_t* p) { return vld1q_s8(reinterpret_cast<const int8_t*>(p)); }
+    static Vec dup(int8_t value) { return vdupq_n_s8(value); }
+};
+template <>
+struct NEONTypes<uint8_t> {
+    using Vec = uint8x16_t;
+    static Vec load(const uint8_t* p) { return vld1q_u8(p); }
+    static Vec dup(uint8_t value) { return vdupq_n_u8(value); }
+};
+template <>
+struct NEONTypes<int16_t> {
+    using Vec = int16x8_t;
+    static Vec load(const uint8_t* p) { return vld1q_s16(reinterpret_cast<const int16_t*>(p)); }
+    static Vec dup(int16_t value) { return vdupq_n_s16(value); }
+};
+template <>
+struct NEONTypes<uint16_t> {
+    using Vec = uint16x8_t;
+    static Vec load(const uint8_t* p) { return vld1q_u16(reinterpret_cast<const uint16_t*>(p)); }
+    static Vec dup(uint16_t value) { return vdupq_n_u16(value); }
+};
+template <>
+struct NEONTypes<int32_t> {
+    using Vec = int32x4_t;
+    static Vec load(const uint8_t* p) { return vld1q_s32(reinterpret_cast<const int32_t*>(p)); }
+    static Vec dup(int32_t value) { return vdupq_n_s32(value); }
+};
+template <>
+struct NEONTypes<uint32_t> {
+    using Vec = uint32x4_t;
+    static Vec load(const uint8_t* p) { return vld1q_u32(reinterpret_cast<const uint32_t*>(p)); }
+    static Vec dup(uint32_t value) { return vdupq_n_u32(value); }
+};
+template <>
+struct NEONTypes<float> {
+    using Vec = float32x4_t;
+    static Vec load(const uint8_t* p) { return vld1q_f32(reinterpret_cast<const float*>(p)); }
+    static Vec dup(float value) { return vdupq_n_f32(value); }
+};
+
+uint8x16_t eqNEON(int8x16_t a, int8x16_t b) { return vceqq_s8(a, b); }
+uint8x16_t eqNEON(uint8x16_t a, uint8x16_t b) { return vceqq_u8(a, b); }
+uint16x8_t eqNEON(int16x8_t a, int16x8_t b) { return vceqq_s16(a, b); }
+uint16x8_t eqNEON(uint16x8_t a, uint16x8_t b) { return vceqq_u16(a, b); }
+uint32x4_t eqNEON(int32x4_t a, int32x4_t b) { return vceqq_s32(a, b); }
+uint32x4_t eqNEON(uint32x4_t a, uint32x4_t b) { return vceqq_u32(a, b); }
+uint32x4_t eqNEON(float32x4_t a, float32x4_t b) { return vceqq_f32(a, b); }
+
+uint8x16_t gtNEON(int8x16_t a, int8x16_t b) { return vcgtq_s8(a, b); }
+uint8x16_t gtNEON(uint8x16_t a, uint8x16_t b) { return vcgtq_u8(a, b); }
+uint16x8_t gtNEON(int16x8_t a, int16x8_t b) { return vcgtq_s16(a, b); }
+uint16x8_t gtNEON(uint16x8_t a, uint16x8_t b) { return vcgtq_u16(a, b); }
+uint32x4_t gtNEON(int32x4_t a, int32x4_t b) { return vcgtq_s32(a, b); }
+uint32x4_t gtNEON(uint32x4_t a, uint32x4_t b) { return vcgtq_u32(a, b); }
+uint32x4_t gtNEON(float32x4_t a, float32x4_t b) { return vcgtq_f32(a, b); }
+
+uint8x16_t geNEON(int8x16_t a, int8x16_t b) { return vcgeq_s8(a, b); }
+uint8x16_t geNEON(uint8x16_t a, uint8x16_t b) { return vcgeq_u8(a, b); }
+uint16x8_t geNEON(int16x8_t a, int16x8_t b) { return vcgeq_s16(a, b); }
+uint16x8_t geNEON(uint16x8_t a, uint16x8_t b) { return vcgeq_u16(a, b); }
+uint32x4_t geNEON(int32x4_t a, int32x4_t b) { return vcgeq_s32(a, b); }
+uint32x4_t geNEON(uint32x4_t a, uint32x4_t b) { return vcgeq_u32(a, b); }
+uint32x4_t geNEON(float32x4_t a, float32x4_t b) { return vcgeq_f32(a, b); }
+
+uint8x16_t notNEON(uint8x16_t a) { return vmvnq_u8(a); }
+uint16x8_t notNEON(uint16x8_t a) { return vmvnq_u16(a); }
+uint32x4_t notNEON(uint32x4_t a) { return vmvnq_u32(a); }
+
+uint8x16_t andNEON(uint8x16_t a, uint8x16_t b) { return vandq_u8(a, b); }
+uint16x8_t andNEON(uint16x8_t a, uint16x8_t b) { return vandq_u16(a, b); }
+uint32x4_t andNEON(uint32x4_t a, uint32x4_t b) { return vandq_u32(a, b); }
+
+uint64_t bitsNEON(uint8x16_t mask) {
+    static const uint8_t c_weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t weighted = vandq_u8(mask, vld1q_u8(c_weights));
+    return vaddv_u8(vget_low_u8(weighted)) | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(weighted))) << 8);
+}
+uint64_t bitsNEON(uint16x8_t mask) {
+    static const uint16_t c_weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    return vaddvq_u16(vandq_u16(mask, vld1q_u16(c_weights)));
+}
+uint64_t bitsNEON(uint32x4_t mask) {
+    static const uint32_t c_weights[4] = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(mask, vld1q_u32(c_weights)));
+}
+
+template <typename T>
+struct NEONOps {
+    using Scalar = T;
+    using Vec = typename NEONTypes<T>::Vec;
+    using Mask = decltype(eqNEON(Vec{}, Vec{}));
+    static constexpr unsigned c_lanes = 16 / sizeof(T);
+
+    static Vec load(const uint8_t* p) { return NEONTypes<T>::load(p); }
+    static Vec broadcast(double value) { return NEONTypes<T>::dup(convert<T>(value)); }
+    static Mask eq(Vec a, Vec b) { return eqNEON(a, b); }
+    static Mask ne(Vec a, Vec b) { return notNEON(eqNEON(a, b)); }
+    static Mask gt(Vec a, Vec b) { return gtNEON(a, b); }
+    static Mask ge(Vec a, Vec b) { return geNEON(a, b); }
+    static Mask both(Mask a, Mask b) { return andNEON(a, b); }
+    static Mask all() {
+        const Vec zero = NEONTypes<T>::dup(0);
+        return eqNEON(zero, zero);
+    }
+
+    template <ScanType scanType>
+    static uint64_t group(const uint8_t* current, const uint8_t* previous, Vec value, Vec high) {
+        return bitsNEON(predicate<NEONOps, scanType>(load(current), load(previous), value, high));
+    }
+};
+
+NarrowKernel selectNEON(ValueType valueType, ScanType scanType) {
+    return selectValueType<Kernel, NEONOps>(valueType, scanType);
+}
+#endif  // MEMSCANNER_NEON
+
+bool isRelative(ScanType scanType) {
+    switch (scanType) {
+        case ScanType::Changed:
+        case ScanType::Unchanged:
+        case ScanType::Increased:
+        case ScanType::Decreased:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::vector<PCSX::MemScanner::Implementation> PCSX::MemScanner::getSupportedImplementations() {
+    std::vector<Implementation> implementations = {{"Scalar", selectScalar}};
+#if defined(MEMSCANNER_X86)
+    if (CPUFeatures::hasAVX2()) implementations.push_back({"AVX2", selectAVX2});
+#elif defined(MEMSCANNER_NEON)
+    implementations.push_back({"NEON", selectNEON});
+#endif
+    return implementations;
+}
+
+unsigned PCSX::MemScanner::getStride(ValueType valueType) {
+    switch (valueType) {
+        case ValueType::Char:
+        case ValueType::Uchar:
+            return 1;
+        case ValueType::Short:
+        case ValueType::Ushort:
+            return 2;
+        case ValueType::Int:
+        case ValueType::Uint:
+        case ValueType::Float:
+            return 4;
+    }
+    throw std::runtime_error("Invalid value type.");
+}
+
+PCSX::MemScanner::MemScanner() : m_select(getSupportedImplementations().back().select) {}
+
+PCSX::MemScanner::~MemScanner() { join(); }
+
+void PCSX::MemScanner::join() {
+    if (m_worker.joinable()) m_worker.join();
+}
+
+void PCSX::MemScanner::reset() {
+    join();
+    clear();
+}
+
+void PCSX::MemScanner::clear() {
+    m_started = false;
+    m_size = 0;
+    m_count = 0;
+    m_snapshot.clear();
+    m_blocks.clear();
+    m_blockCounts.clear();
+}
+
+void PCSX::MemScanner::firstScan(std::vector<uint8_t>&& snapshot, ValueType valueType, const Criterion& criterion) {
+    clear();
+    m_valueType = valueType;
+    m_started = true;
+    m_size = snapshot.size();
+
+    const unsigned stride = getStride(valueType);
+    const size_t values = m_size / stride;
+    const size_t blocks = (values + c_valuesPerBlock - 1) / c_valuesPerBlock;
+    snapshot.resize(blocks * c_valuesPerBlock * stride);
+    m_blocks.resize(blocks);
+    m_blockCounts.assign(blocks, 0);
+    for (size_t b = 0; b < blocks; b++) {
+        m_blocks[b] = std::make_unique<uint64_t[]>(c_wordsPerBlock);
+        uint64_t* words = m_blocks[b].get();
+        // Only the values which are entirely within RAM are candidates
+        const size_t first = b * c_valuesPerBlock;
+        for (unsigned w = 0; w < c_wordsPerBlock; w++) {
+            const size_t start = first + w * 64;
+            if (start + 64 <= values) {
+                words[w] = ~uint64_t(0);
+            } else if (start < values) {
+                words[w] = (uint64_t(1) << (values - start)) - 1;
+            } else {
+                words[w] = 0;
+            }
+        }
+    }
+
+    Criterion initial = criterion;
+    if (isRelative(initial.scanType)) initial.scanType = ScanType::UnknownInitialValue;
+    narrow(snapshot, snapshot, initial);
+    m_snapshot = std::move(snapshot);
+}
+
+void PCSX::MemScanner::nextScan(std::vector<uint8_t>&& snapshot, const Criterion& criterion) {
+    if (!m_started) return;
+    snapshot.resize(m_snapshot.size());
+    narrow(snapshot, m_snapshot, criterion);
+    m_snapshot = std::move(snapshot);
+}
+
+void PCSX::MemScanner::firstScanAsync(std::vector<uint8_t>&& snapshot, ValueType valueType,
+                                      const Criterion& criterion) {
+    runAsync([this, snapshot = std::move(snapshot), valueType, criterion]() mutable {
+        firstScan(std::move(snapshot), valueType, criterion);
+    });
+}
+
+void PCSX::MemScanner::nextScanAsync(std::vector<uint8_t>&& snapshot, const Criterion& criterion) {
+    runAsync([this, snapshot = std::move(snapshot), criterion]() mutable { nextScan(std::move(snapshot), criterion); });
+}
+
+void PCSX::MemScanner::runAsync(std::function<void()>&& scan) {
+    join();
+    m_busy.store(true, std::memory_order_relaxed);
+    m_worker = std::thread([this, scan = std::move(scan)]() {
+        scan();
+        m_busy.store(false, std::memory_order_release);
+    });
+}
+
+bool PCSX::MemScanner::poll() {
+    if (!m_worker.joinable() || busy()) return false;
+    m_worker.join();
+    return true;
+}
+
+void PCSX::MemScanner::narrow(const std::vector<uint8_t>& current, const std::vector<uint8_t>& previous,
+                              const Criterion& criterion) {
+    const NarrowKernel kernel = m_select(m_valueType, criterion.scanType);
+    const size_t blockSize = size_t(c_valuesPerBlock) * getStride(m_valueType);
+    m_count = 0;
+    for (size_t b = 0; b < m_blocks.size(); b++) {
+        auto& block = m_blocks[b];
+        if (!block) continue;
+        uint64_t* words = block.get();
+        kernel(current.data() + b * blockSize, previous.data() + b * blockSize, criterion, words, c_wordsPerBlock);
+        uint32_t count = 0;
+        for (unsigned w = 0; w < c_wordsPerBlock; w++) count += std::popcount(words[w]);
+        m_blockCounts[b] = count;
+        m_count += count;
+        if (count == 0) block.reset();
+    }
+}
+
+std::vector<uint32_t> PCSX::MemScanner::getOffsets(size_t first, size_t limit) const {
+    std::vector<uint32_t> offsets;
+    const unsigned stride = getStride(m_valueType);
+    size_t b = 0;
+    while (b < m_blocks.size() && first >= m_blockCounts[b]) first -= m_blockCounts[b++];
+    for (; b < m_blocks.size() && offsets.size() < limit; b++) {
+        if (!m_blocks[b]) continue;
+        const uint64_t* words = m_blocks[b].get();
+        for (unsigned w = 0; w < c_wordsPerBlock && offsets.size() < limit; w++) {
+            uint64_t word = words[w];
+            while (word && offsets.size() < limit) {
+                const unsigned bit = std::countr_zero(word);
+                word &= word - 1;
+                if (first) {
+                    first--;
+                    continue;
+                }
+                offsets.push_back(static_cast<uint32_t>(((b * c_wordsPerBlock + w) * 64 + bit) * stride));
+            }
+        }
+    }
+    return offsets;
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace PCSX {
+
+// The engine behind the memory observer's delta-over-time search. The candidates are kept as one bit per
+// aligned value over the whole of RAM, in blocks which get dropped as soon as they don't hold any candidate
+// anymore, so that the later scans of a search only ever look at the few places still in the running.
+// Each scan runs against a snapshot of RAM, which becomes the previous values the next scan compares to.
+class MemScanner {
+  public:
+    enum class ValueType { Char, Uchar, Short, Ushort, Int, Uint, Float };
+    enum class ScanType {
+        ExactValue,
+        GreaterThan,
+        LessThan,
+        InRange,
+        Changed,
+        Unchanged,
+        Increased,
+        Decreased,
+        UnknownInitialValue
+    };
+
+    struct Criterion {
+        ScanType scanType = ScanType::ExactValue;
+        // Converted to the scanned type the same way a cast would; high is only used by InRange, which
+        // includes both ends.
+        double value = 0;
+        double high = 0;
+    };
+
+    // Narrows down count words of candidates, each covering 64 values in a row of current and previous.
+    // Words which are already 0 are skipped altogether.
+    using NarrowKernel = void (*)(const uint8_t* current, const uint8_t* previous, const Criterion& criterion,
+                                  uint64_t* words, unsigned count);
+    using KernelSelector = NarrowKernel (*)(ValueType valueType, ScanType scanType);
+
+    struct Implementation {
+        const char* name;
+        KernelSelector select;
+    };
+
+    // All the implementations the host CPU can run, from the slowest (the scalar one) to the fastest
+    static std::vector<Implementation> getSupportedImplementations();
+    static unsigned getStride(ValueType valueType);
+
+    MemScanner();
+    ~MemScanner();
+
+    // Starts a new search over a snapshot of RAM; every aligned value matching the criterion is a candidate.
+    // The relative scan types have nothing to compare to yet, so they behave like UnknownInitialValue.
+    void firstScan(std::vector<uint8_t>&& snapshot, ValueType valueType, const Criterion& criterion);
+    // Keeps only the candidates matching the criterion in this new snapshot, which needs to be the same size.
+    void nextScan(std::vector<uint8_t>&& snapshot, const Criterion& criterion);
+    // The same as the above, but on a worker thread. Until poll() says the scan is over, the only other
+    // methods which may be called are busy() and poll().
+    void firstScanAsync(std::vector<uint8_t>&& snapshot, ValueType valueType, const Criterion& criterion);
+    void nextScanAsync(std::vector<uint8_t>&& snapshot, const Criterion& criterion);
+    bool busy() const { return m_busy.load(std::memory_order_acquire); }
+    // Returns true once, when the asynchronous scan in flight is over.
+    bool poll();
+    void reset();
+
+    bool started() const { return m_started; }
+    ValueType valueType() const { return m_valueType; }
+    size_t count() const { return m_count; }
+    // The offsets in RAM of the candidates ranked first to first + count - 1, in increasing order.
+    std::vector<uint32_t> getOffsets(size_t first, size_t count) const;
+    // What RAM looked like at the last scan.
+    const std::vector<uint8_t>& getSnapshot() const { return m_snapshot; }
+
+  private:
+    static constexpr unsigned c_wordsPerBlock = 64;
+    static constexpr unsigned c_valuesPerBlock = c_wordsPerBlock * 64;
+
+    void narrow(const std::vector<uint8_t>& current, const std::vector<uint8_t>& previous,
+                const Criterion& criterion);
+    void clear();
+    void runAsync(std::function<void()>&& scan);
+    void join();
+
+    const KernelSelector m_select;
+    ValueType m_valueType = ValueType::Short;
+    bool m_started = false;
+    size_t m_size = 0;
+    size_t m_count = 0;
+    // Padded up to a whole number of blocks, so that the kernels never have to care about the end of RAM
+    std::vector<uint8_t> m_snapshot;
+    // Empty blocks are nullptr
+    std::vector<std::unique_ptr<uint64_t[]>> m_blocks;
+    std::vector<uint32_t> m_blockCounts;
+
+    std::thread m_worker;
+    std::atomic<bool> m_busy = false;
+};
+
+}  // namespace PCSX
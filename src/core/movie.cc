@@ -0,0 +1,175 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movie.h"
+
+#include <algorithm>
+
+#include "core/cdrom.h"
+#include "core/pad.h"
+#include "core/psxemulator.h"
+#include "core/sstate.h"
+#include "core/system.h"
+
+PCSX::Movie::Movie() : m_listener(g_system->m_eventBus) {
+    // The pads are read during the frame, so this is the start of the next one
+    m_listener.listen<Events::GPU::VSync>([this](const auto& event) {
+        if (m_recording) recordFrame();
+        if (m_playing) playFrame();
+    });
+    // Anything else changing the machine means it isn't following the movie anymore
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) {
+        if (!m_loading) stop();
+    });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) {
+        if (!m_loading) stop();
+    });
+}
+
+bool PCSX::Movie::record(IO<File> file, unsigned keyframeInterval) {
+    stop();
+    if (!file || file->failed() || !file->writable()) return false;
+    m_file = file;
+    m_writer = MovieLog::Writer();
+    m_keyframeInterval = std::max(keyframeInterval, 1u);
+    m_frame = 0;
+    m_closeLidAt.reset();
+
+    // The first keyframe needs to know where the lid is
+    auto& cdrom = g_emulator->m_cdrom;
+    m_lastLidTime = cdrom->getLidOpenTime();
+    if (m_lastLidTime > 0) {
+        cdrom->setLidOpenTime(-1);
+        m_lastLidTime = -1;
+        m_closeLidAt = c_lidCloseFrames;
+    }
+    if (m_lastLidTime < 0) m_writer.lid({true, false});
+    m_recording = true;
+    return true;
+}
+
+bool PCSX::Movie::play(IO<File> file) {
+    stop();
+    if (!file || file->failed()) return false;
+    if (!m_reader.open(file->readStringAt(file->size(), 0)) || m_reader.keyframes().empty() ||
+        (m_reader.frames() == 0)) {
+        g_system->printf(_("Not a valid movie file.\n"));
+        return false;
+    }
+    m_playing = true;
+    if (!loadKeyframe(0)) return false;
+    playFrame();
+    return m_playing;
+}
+
+bool PCSX::Movie::seek(uint64_t frame) {
+    if (!m_playing) return false;
+    if (!loadKeyframe(m_reader.findKeyframe(frame))) return false;
+    m_stopAt = std::min(frame, m_reader.frames() - 1);
+    // The keyframe got saved right before the input of its frame was applied
+    playFrame();
+    return m_playing;
+}
+
+bool PCSX::Movie::loadKeyframe(size_t index) {
+    const auto& keyframe = m_reader.keyframes()[index];
+    m_loading = true;
+    const bool loaded = SaveStates::load(m_reader.keyframeState(index));
+    m_loading = false;
+    if (!loaded) {
+        g_system->printf(_("Unable to load the movie keyframe at frame %llu.\n"), (unsigned long long)keyframe.frame);
+        stop();
+        return false;
+    }
+    g_emulator->m_cdrom->setLidOpenTime(keyframe.lidOpen ? -1 : 0);
+    m_reader.seek(index);
+    m_frame = keyframe.frame;
+    m_stopAt.reset();
+    return true;
+}
+
+void PCSX::Movie::stop() {
+    if (!m_recording && !m_playing) return;
+    m_recording = false;
+    m_playing = false;
+    m_stopAt.reset();
+    m_file.reset();
+    m_reader = MovieLog::Reader();
+    g_emulator->m_pads->releaseInput(Pads::Port::Port1);
+    g_emulator->m_pads->releaseInput(Pads::Port::Port2);
+}
+
+void PCSX::Movie::recordFrame() {
+    auto& cdrom = g_emulator->m_cdrom;
+    const int64_t lidTime = cdrom->getLidOpenTime();
+    if (lidTime != m_lastLidTime) {
+        m_closeLidAt.reset();
+        if (lidTime > 0) {
+            // Wall clock time wouldn't play back the same way
+            cdrom->setLidOpenTime(-1);
+            m_closeLidAt = m_frame + c_lidCloseFrames;
+        }
+        m_writer.lid({lidTime != 0, true});
+        m_lastLidTime = cdrom->getLidOpenTime();
+    }
+
+    if ((m_frame % m_keyframeInterval) == 0) m_writer.keyframe(m_frame, SaveStates::save());
+
+    MovieLog::Inputs inputs;
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        const auto port = Pads::Port(i);
+        inputs[i] = g_emulator->m_pads->readInput(port);
+        g_emulator->m_pads->forceInput(port, inputs[i]);
+    }
+    m_writer.frame(inputs);
+
+    if (m_closeLidAt && (*m_closeLidAt == m_frame)) {
+        m_closeLidAt.reset();
+        cdrom->setLidOpenTime(0);
+        m_lastLidTime = 0;
+        m_writer.lid({false, false});
+    }
+
+    m_frame++;
+    const std::string data = m_writer.flush();
+    if (m_file->write(data.data(), data.size()) != ssize_t(data.size())) {
+        g_system->printf(_("Unable to write to the movie file, recording stopped.\n"));
+        stop();
+    }
+}
+
+void PCSX::Movie::playFrame() {
+    MovieLog::Inputs inputs;
+    if (!m_reader.next(inputs, m_lids)) {
+        g_system->printf(_("Movie playback finished.\n"));
+        stop();
+        return;
+    }
+    for (unsigned i = 0; i < inputs.size(); i++) g_emulator->m_pads->forceInput(Pads::Port(i), inputs[i]);
+    auto& cdrom = g_emulator->m_cdrom;
+    for (const auto& lid : m_lids) {
+        cdrom->setLidOpenTime(lid.open ? -1 : 0);
+        if (lid.interrupt) cdrom->lidInterrupt();
+    }
+    if (m_stopAt && (*m_stopAt == m_frame)) {
+        m_stopAt.reset();
+        g_system->pause();
+    }
+    m_frame++;
+}
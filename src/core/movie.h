@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "core/movielog.h"
+#include "support/eventbus.h"
+#include "support/file.h"
+
+namespace PCSX {
+
+// Records what the pads do at each frame, along with the lid of the CD-ROM drive, into a MovieLog, so that the
+// same run can be played back later on. While recording, the pads get sampled once at the start of each frame,
+// and the emulator sees that for the whole frame, the same way it will when playing back. Opening the lid
+// until a certain time gets turned into closing it a number of frames later.
+//
+// A keyframe gets saved every so many frames, which is where playback starts from, and what seeking goes to.
+class Movie {
+  public:
+    static constexpr unsigned c_defaultKeyframeInterval = 600;
+    // Roughly two seconds, like the "open and close lid" menu.
+    static constexpr unsigned c_lidCloseFrames = 120;
+
+    Movie();
+
+    // Starts recording from the current state of the emulator, into a file which needs to be writable.
+    bool record(IO<File> file, unsigned keyframeInterval = c_defaultKeyframeInterval);
+    // Loads the whole movie, and goes to its first frame.
+    bool play(IO<File> file);
+    // Goes to this frame of the movie being played, by loading the keyframe before it, and playing until
+    // reaching it, at which point the emulator pauses.
+    bool seek(uint64_t frame);
+    void stop();
+
+    bool recording() const { return m_recording; }
+    bool playing() const { return m_playing; }
+    // How many frames got recorded or played so far. Seeking to a frame pauses with its input applied, so this
+    // is one past it then.
+    uint64_t frame() const { return m_frame; }
+    uint64_t frames() const { return m_recording ? m_frame : m_reader.frames(); }
+
+  private:
+    bool loadKeyframe(size_t index);
+    void recordFrame();
+    void playFrame();
+
+    IO<File> m_file;
+    MovieLog::Writer m_writer;
+    MovieLog::Reader m_reader;
+    bool m_recording = false;
+    bool m_playing = false;
+    bool m_loading = false;
+    uint64_t m_frame = 0;
+    unsigned m_keyframeInterval = c_defaultKeyframeInterval;
+    int64_t m_lastLidTime = 0;
+    std::optional<uint64_t> m_closeLidAt;
+    std::optional<uint64_t> m_stopAt;
+    std::vector<MovieLog::Lid> m_lids;
+
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
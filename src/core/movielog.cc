@@ -0,0 +1,249 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movielog.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr char c_signature[8] = {'P', 'C', 'S', 'X', 'M', 'O', 'V', 'I'};
+constexpr size_t c_headerSize = sizeof(c_signature) + 4;
+constexpr uint8_t c_frameTag = 0x00;
+constexpr uint8_t c_lidTag = 0x10;
+constexpr uint8_t c_keyframeTag = 0x20;
+constexpr size_t c_inputSize = 6;
+// tag, frame, kind, size, deflated size
+constexpr size_t c_keyframeHeaderSize = 1 + 8 + 1 + 4 + 4;
+
+enum KeyframeKind : uint8_t { FULL = 0, DELTA = 1 };
+
+void putU32(std::string& out, uint32_t value) {
+    for (unsigned i = 0; i < 4; i++) out.push_back(char(value >> (i * 8)));
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (unsigned i = 0; i < 8; i++) out.push_back(char(value >> (i * 8)));
+}
+
+uint64_t get(const std::string& data, size_t offset, unsigned size) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < size; i++) value |= uint64_t(uint8_t(data[offset + i])) << (i * 8);
+    return value;
+}
+
+void xorInto(std::string& data, std::string_view reference) {
+    const size_t size = std::min(data.size(), reference.size());
+    for (size_t i = 0; i < size; i++) data[i] ^= reference[i];
+}
+
+}  // namespace
+
+PCSX::MovieLog::Writer::Writer() {
+    m_pending.append(c_signature, sizeof(c_signature));
+    putU32(m_pending, c_version);
+}
+
+void PCSX::MovieLog::Writer::frame(const Inputs& inputs) {
+    uint8_t tag = c_frameTag;
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        if (!(inputs[i] == m_previous[i])) tag |= 1 << i;
+    }
+    m_pending.push_back(char(tag));
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        if (!(tag & (1 << i))) continue;
+        const auto& input = inputs[i];
+        m_pending.push_back(char(input.buttons));
+        m_pending.push_back(char(input.buttons >> 8));
+        m_pending.push_back(char(input.rightJoyX));
+        m_pending.push_back(char(input.rightJoyY));
+        m_pending.push_back(char(input.leftJoyX));
+        m_pending.push_back(char(input.leftJoyY));
+    }
+    m_previous = inputs;
+}
+
+void PCSX::MovieLog::Writer::lid(const Lid& lid) {
+    m_pending.push_back(char(c_lidTag));
+    m_pending.push_back(char((lid.open ? 1 : 0) | (lid.interrupt ? 2 : 0)));
+}
+
+void PCSX::MovieLog::Writer::keyframe(uint64_t frame, std::string_view state) {
+    const bool full = m_lastFull.empty() || (++m_sinceFull >= c_fullKeyframeInterval);
+    std::string payload(state);
+    if (full) {
+        m_lastFull = payload;
+        m_sinceFull = 0;
+    } else {
+        // Mostly zeroes past this point, since the emulator doesn't change all that much in a few seconds.
+        xorInto(payload, m_lastFull);
+    }
+
+    uLongf deflatedSize = compressBound(payload.size());
+    std::string deflated(deflatedSize, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(deflated.data()), &deflatedSize,
+                  reinterpret_cast<const Bytef*>(payload.data()), payload.size(), Z_BEST_SPEED) != Z_OK) {
+        throw std::runtime_error("Unable to deflate movie keyframe");
+    }
+
+    m_pending.push_back(char(c_keyframeTag));
+    putU64(m_pending, frame);
+    m_pending.push_back(char(full ? FULL : DELTA));
+    putU32(m_pending, payload.size());
+    putU32(m_pending, deflatedSize);
+    m_pending.append(deflated.data(), deflatedSize);
+    m_previous = {};
+}
+
+std::string PCSX::MovieLog::Writer::flush() {
+    std::string ret;
+    ret.swap(m_pending);
+    return ret;
+}
+
+bool PCSX::MovieLog::Reader::parse(size_t& offset, Inputs& inputs, Record& record) const {
+    if (offset >= m_data.size()) return false;
+    const size_t left = m_data.size() - offset;
+    record.tag = m_data[offset];
+    if ((record.tag & 0xf0) == c_frameTag) {
+        if (record.tag & ~3) return false;
+        size_t size = 1;
+        for (unsigned i = 0; i < inputs.size(); i++) {
+            if (!(record.tag & (1 << i))) continue;
+            if (left < size + c_inputSize) return false;
+            auto& input = inputs[i];
+            input.buttons = get(m_data, offset + size, 2);
+            input.rightJoyX = m_data[offset + size + 2];
+            input.rightJoyY = m_data[offset + size + 3];
+            input.leftJoyX = m_data[offset + size + 4];
+            input.leftJoyY = m_data[offset + size + 5];
+            size += c_inputSize;
+        }
+        offset += size;
+        return true;
+    }
+    if (record.tag == c_lidTag) {
+        if (left < 2) return false;
+        const uint8_t flags = m_data[offset + 1];
+        record.lid.open = flags & 1;
+        record.lid.interrupt = flags & 2;
+        offset += 2;
+        return true;
+    }
+    if (record.tag == c_keyframeTag) {
+        if (left < c_keyframeHeaderSize) return false;
+        const uint8_t kind = m_data[offset + 9];
+        const uint64_t deflatedSize = get(m_data, offset + 14, 4);
+        if ((kind != FULL) && (kind != DELTA)) return false;
+        if (left - c_keyframeHeaderSize < deflatedSize) return false;
+        record.frame = get(m_data, offset + 1, 8);
+        inputs = {};
+        offset += c_keyframeHeaderSize + deflatedSize;
+        return true;
+    }
+    return false;
+}
+
+bool PCSX::MovieLog::Reader::open(std::string&& data) {
+    m_data = std::move(data);
+    m_keyframes.clear();
+    m_frames = 0;
+    m_offset = c_headerSize;
+    m_inputs = {};
+    if (m_data.size() < c_headerSize) return false;
+    if (memcmp(m_data.data(), c_signature, sizeof(c_signature)) != 0) return false;
+    if (get(m_data, sizeof(c_signature), 4) != c_version) return false;
+
+    size_t offset = c_headerSize;
+    Inputs inputs;
+    Record record;
+    size_t lastFull = 0;
+    bool lidOpen = false;
+    while (offset < m_data.size()) {
+        const size_t start = offset;
+        if (!parse(offset, inputs, record)) return false;
+        if (record.tag == c_keyframeTag) {
+            // Each keyframe comes right before the frame it's for.
+            if (record.frame != m_frames) return false;
+            const bool full = m_data[start + 9] == FULL;
+            if (!full && m_keyframes.empty()) return false;
+            if (full) lastFull = m_keyframes.size();
+            m_keyframes.push_back({record.frame, start, lastFull, lidOpen});
+        } else if (record.tag == c_lidTag) {
+            lidOpen = record.lid.open;
+        } else {
+            m_frames++;
+        }
+    }
+    return true;
+}
+
+size_t PCSX::MovieLog::Reader::findKeyframe(uint64_t frame) const {
+    auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), frame,
+                               [](uint64_t frame, const Keyframe& keyframe) { return frame < keyframe.frame; });
+    return it == m_keyframes.begin() ? 0 : (it - m_keyframes.begin()) - 1;
+}
+
+std::string PCSX::MovieLog::Reader::inflateKeyframe(size_t offset) const {
+    const uLongf size = get(m_data, offset + 10, 4);
+    const uLong deflatedSize = get(m_data, offset + 14, 4);
+    std::string ret(size, '\0');
+    uLongf inflatedSize = size;
+    if ((uncompress(reinterpret_cast<Bytef*>(ret.data()), &inflatedSize,
+                    reinterpret_cast<const Bytef*>(m_data.data() + offset + c_keyframeHeaderSize),
+                    deflatedSize) != Z_OK) ||
+        (inflatedSize != size)) {
+        throw std::runtime_error("Corrupted movie keyframe");
+    }
+    return ret;
+}
+
+std::string PCSX::MovieLog::Reader::keyframeState(size_t index) const {
+    const auto& keyframe = m_keyframes[index];
+    std::string state = inflateKeyframe(keyframe.offset);
+    if (keyframe.reference != index) xorInto(state, inflateKeyframe(m_keyframes[keyframe.reference].offset));
+    return state;
+}
+
+void PCSX::MovieLog::Reader::seek(size_t keyframe) {
+    m_offset = m_keyframes[keyframe].offset;
+    m_inputs = {};
+}
+
+bool PCSX::MovieLog::Reader::next(Inputs& inputs, std::vector<Lid>& lids) {
+    lids.clear();
+    Record record;
+    while (true) {
+        if (!parse(m_offset, m_inputs, record)) return false;
+        if (record.tag == c_lidTag) lids.push_back(record.lid);
+        if ((record.tag & 0xf0) == c_frameTag) break;
+    }
+    inputs = m_inputs;
+    size_t offset = m_offset;
+    Inputs ignored;
+    while (parse(offset, ignored, record) && (record.tag == c_lidTag)) {
+        lids.push_back(record.lid);
+        m_offset = offset;
+    }
+    return true;
+}
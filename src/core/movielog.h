@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/pad.h"
+
+namespace PCSX {
+
+// The binary format of the input movies. After an 8 bytes signature, and the version, come the records, each
+// starting with a tag byte:
+//  - a frame, the most common by far: the low bits of the tag say which pads have their input following, as
+//    6 bytes each; the others didn't change since the previous frame, so that most frames fit in a byte,
+//  - a lid event, with a byte saying whether the lid opened, and whether the drive got told about it,
+//  - a keyframe, that is, a save state of the emulator right before the next frame got applied, for seeking
+//    through the movie without replaying it from the start. Most of these are XORed against the last full
+//    keyframe before getting deflated. The input of the first frame after it is always complete.
+// The lid events come after the frame they happened in.
+class MovieLog {
+  public:
+    static constexpr unsigned c_version = 1;
+    using Inputs = std::array<Pads::Input, 2>;
+
+    struct Lid {
+        bool open = false;
+        // Whether the drive got interrupted about it right away, or gets to notice it on its own.
+        bool interrupt = true;
+    };
+
+    class Writer {
+      public:
+        // One keyframe out of this many is saved whole.
+        static constexpr unsigned c_fullKeyframeInterval = 10;
+
+        Writer();
+        void frame(const Inputs& inputs);
+        void lid(const Lid& lid);
+        void keyframe(uint64_t frame, std::string_view state);
+        // Hands over what got logged since the last call, signature included the first time.
+        std::string flush();
+
+      private:
+        std::string m_pending;
+        Inputs m_previous;
+        std::string m_lastFull;
+        unsigned m_sinceFull = 0;
+    };
+
+    class Reader {
+      public:
+        struct Keyframe {
+            uint64_t frame;
+            size_t offset;
+            // The full keyframe this one was made against, or its own index if it's a full one.
+            size_t reference;
+            // Save states don't have the lid in them.
+            bool lidOpen;
+        };
+
+        // Returns false if this isn't a movie, or if it's damaged. Checks everything once, so that reading the
+        // records afterwards can't go wrong.
+        bool open(std::string&& data);
+
+        uint64_t frames() const { return m_frames; }
+        const std::vector<Keyframe>& keyframes() const { return m_keyframes; }
+        // The last keyframe at, or before, this frame.
+        size_t findKeyframe(uint64_t frame) const;
+        std::string keyframeState(size_t index) const;
+
+        // Goes back to the keyframe, so that next() returns the frame right after it.
+        void seek(size_t keyframe);
+        // Reads the next frame, along with the lid events happening in it. Returns false past the end.
+        bool next(Inputs& inputs, std::vector<Lid>& lids);
+
+      private:
+        struct Record {
+            uint8_t tag;
+            Lid lid;
+            uint64_t frame;
+        };
+        // Reads the record at this offset, and moves past it. The inputs follow the frames and keyframes.
+        bool parse(size_t& offset, Inputs& inputs, Record& record) const;
+        std::string inflateKeyframe(size_t offset) const;
+
+        std::string m_data;
+        std::vector<Keyframe> m_keyframes;
+        uint64_t m_frames = 0;
+        size_t m_offset = 0;
+        Inputs m_inputs;
+    };
+};
+
+}  // namespace PCSX
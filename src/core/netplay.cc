@@ -0,0 +1,394 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/netplay.h"
+
+#include <thread>
+
+#include "core/movie.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/spu.h"
+#include "core/sstate.h"
+#include "core/system.h"
+#include "support/hashing.h"
+
+namespace {
+
+// Everything goes over the wire as little endian.
+void put(std::string& out, uint64_t value, unsigned bytes) {
+    for (unsigned i = 0; i < bytes; i++) out.push_back(char(value >> (i * 8)));
+}
+
+uint64_t get(const char* in, unsigned bytes) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < bytes; i++) value |= uint64_t(uint8_t(in[i])) << (i * 8);
+    return value;
+}
+
+}  // namespace
+
+PCSX::Netplay::Netplay() : m_listener(g_system->m_eventBus) {
+    // Anything else changing the machine means both sides aren't running the same one anymore
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { stop(); });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) {
+        if (!m_loading) stop();
+    });
+    m_listener.listen<Events::Quitting>([this](const auto& event) { stop(); });
+}
+
+void PCSX::Netplay::host(unsigned port) {
+    stop();
+    if (m_asyncOpen) {
+        g_system->printf(_("Netplay is still closing its previous listener.\n"));
+        return;
+    }
+    m_host = true;
+    m_status = Status::Listening;
+    m_asyncOpen = true;
+    m_fifoListener.start(port, g_system->getLoop(), &m_async, [this](UvFifo* fifo) {
+        if (!fifo) {
+            m_async.data = this;
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_async), [](uv_handle_t* handle) {
+                Netplay* netplay = reinterpret_cast<Netplay*>(handle->data);
+                netplay->m_asyncOpen = false;
+            });
+            return;
+        }
+        // There's only room for one other side
+        IO<UvFifo> connection(fifo);
+        if (m_status != Status::Listening) return;
+        m_fifoListener.stop();
+        start(fifo);
+    });
+}
+
+void PCSX::Netplay::connect(std::string_view address, unsigned port) {
+    stop();
+    m_host = false;
+    start(new UvFifo(address, port));
+}
+
+void PCSX::Netplay::start(UvFifo* fifo) {
+    m_fifo = fifo;
+    m_status = Status::Connecting;
+    m_incoming.clear();
+    m_helloSent = false;
+}
+
+void PCSX::Netplay::startPlaying() {
+    g_emulator->m_movie->stop();
+    m_status = Status::Playing;
+    m_frame = 0;
+    m_localSent = 0;
+    m_remoteReceived = 0;
+    m_anchor.reset();
+    m_snapshot.clear();
+    m_mispredicted = false;
+    m_replayUntil.reset();
+    m_pendingHashes.clear();
+    m_localHashes.clear();
+    m_remoteHashes.clear();
+    m_stats = {};
+    g_system->printf(_("Netplay started, as player %i.\n"), m_host ? 1 : 2);
+}
+
+void PCSX::Netplay::stop() {
+    if (m_status == Status::Stopped) return;
+    if (m_status == Status::Listening) m_fifoListener.stop();
+    if (m_status == Status::Playing) {
+        g_emulator->m_pads->releaseInput(Pads::Port::Port1);
+        g_emulator->m_pads->releaseInput(Pads::Port::Port2);
+    }
+    if (m_replayUntil) g_emulator->m_spu->setAudioSuppressed(false);
+    m_replayUntil.reset();
+    m_anchor.reset();
+    m_snapshot.clear();
+    if (m_fifo) m_fifo->close();
+    m_fifo.reset();
+    m_status = Status::Stopped;
+}
+
+void PCSX::Netplay::failed(const char* reason) {
+    g_system->printf(_("Netplay stopped: %s\n"), reason);
+    stop();
+}
+
+void PCSX::Netplay::handshake() {
+    if (m_fifo->failed()) {
+        failed(_("unable to connect to the other side."));
+        return;
+    }
+    if (m_fifo->isConnecting()) return;
+    if (!m_helloSent) {
+        std::string out;
+        out.push_back(char(Message::Hello));
+        put(out, c_version, 4);
+        // The client starts from wherever the host is at
+        if (m_host) {
+            const auto state = SaveStates::save();
+            out.push_back(char(Message::State));
+            put(out, state.size(), 4);
+            out += state;
+        }
+        send(out);
+        m_helloSent = true;
+        if (m_host) {
+            startPlaying();
+            return;
+        }
+    }
+    receive();
+}
+
+bool PCSX::Netplay::receive() {
+    if (!m_fifo || m_fifo->failed()) {
+        failed(_("the connection failed."));
+        return false;
+    }
+    const size_t available = m_fifo->size();
+    if (available) {
+        const size_t size = m_incoming.size();
+        m_incoming.resize(size + available);
+        m_incoming.resize(size + std::max(m_fifo->read(m_incoming.data() + size, available), ssize_t(0)));
+    } else if (m_fifo->isClosed()) {
+        failed(_("the other side disconnected."));
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < m_incoming.size()) {
+        const char* message = m_incoming.data() + offset;
+        const size_t left = m_incoming.size() - offset;
+        const auto type = Message(message[0]);
+        size_t length = 0;
+        switch (type) {
+            case Message::Hello:
+                length = 5;
+                break;
+            case Message::State:
+                length = left >= 5 ? 5 + get(message + 1, 4) : 5;
+                break;
+            case Message::Input:
+                length = 11;
+                break;
+            case Message::Hash:
+                length = 13;
+                break;
+            default:
+                failed(_("got garbage from the other side."));
+                return false;
+        }
+        if (left < length) break;
+
+        switch (type) {
+            case Message::Hello:
+                if (get(message + 1, 4) != c_version) {
+                    failed(_("the other side runs a different version of netplay."));
+                    return false;
+                }
+                break;
+            case Message::State: {
+                if (m_host || playing()) {
+                    failed(_("got a state from the other side out of turn."));
+                    return false;
+                }
+                m_loading = true;
+                const bool loaded = SaveStates::load(std::string_view(message + 5, length - 5));
+                m_loading = false;
+                if (!loaded) {
+                    failed(_("unable to load the state of the host."));
+                    return false;
+                }
+                startPlaying();
+                break;
+            }
+            case Message::Input: {
+                const uint32_t frame = get(message + 1, 4);
+                if (!playing() || (frame != m_remoteReceived)) {
+                    failed(_("got the inputs of the other side out of order."));
+                    return false;
+                }
+                // The slots still in use go back to the anchor, at most c_maxRollback frames back
+                if (frame >= m_frame + c_window - c_maxRollback) {
+                    failed(_("the other side got too far ahead."));
+                    return false;
+                }
+                Pads::Input input;
+                input.buttons = get(message + 5, 2);
+                input.rightJoyX = message[7];
+                input.rightJoyY = message[8];
+                input.leftJoyX = message[9];
+                input.leftJoyY = message[10];
+                auto& s = slot(frame);
+                s.remote = input;
+                if ((frame < m_frame) && s.wasPredicted && !(s.predicted == input)) m_mispredicted = true;
+                m_remoteReceived++;
+                break;
+            }
+            case Message::Hash:
+                m_remoteHashes[get(message + 1, 4)] = get(message + 5, 8);
+                break;
+        }
+        offset += length;
+    }
+    m_incoming.erase(0, offset);
+    compareHashes();
+    return true;
+}
+
+void PCSX::Netplay::sendInputs() {
+    const auto input = g_emulator->m_pads->readInput(m_host ? Pads::Port::Port1 : Pads::Port::Port2);
+    std::string out;
+    for (; m_localSent <= m_frame + m_inputDelay; m_localSent++) {
+        slot(m_localSent).local = input;
+        out.push_back(char(Message::Input));
+        put(out, m_localSent, 4);
+        put(out, input.buttons, 2);
+        out.push_back(char(input.rightJoyX));
+        out.push_back(char(input.rightJoyY));
+        out.push_back(char(input.leftJoyX));
+        out.push_back(char(input.leftJoyY));
+    }
+    if (!out.empty()) send(out);
+}
+
+void PCSX::Netplay::sendHashes() {
+    // With all of the inputs leading to a frame known, and matching what got used, its hash can't change anymore
+    std::string out;
+    while (!m_pendingHashes.empty() && (m_pendingHashes.begin()->first <= m_remoteReceived)) {
+        const auto [frame, hash] = *m_pendingHashes.begin();
+        m_pendingHashes.erase(m_pendingHashes.begin());
+        m_localHashes[frame] = hash;
+        out.push_back(char(Message::Hash));
+        put(out, frame, 4);
+        put(out, hash, 8);
+    }
+    if (out.empty()) return;
+    send(out);
+    compareHashes();
+}
+
+void PCSX::Netplay::compareHashes() {
+    for (auto local = m_localHashes.begin(); local != m_localHashes.end();) {
+        const auto remote = m_remoteHashes.find(local->first);
+        if (remote == m_remoteHashes.end()) {
+            local++;
+            continue;
+        }
+        if ((remote->second != local->second) && !m_stats.desync) {
+            m_stats.desync = local->first;
+            g_system->printf(_("Netplay: both sides went out of sync at frame %u.\n"), local->first);
+        }
+        m_remoteHashes.erase(remote);
+        local = m_localHashes.erase(local);
+    }
+}
+
+bool PCSX::Netplay::waitForRemote() {
+    const uint32_t received = m_remoteReceived;
+    const auto until = Clock::now() + c_timeout;
+    while (Clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!receive()) return false;
+        if (m_remoteReceived != received) return true;
+    }
+    failed(_("the other side stopped answering."));
+    return false;
+}
+
+void PCSX::Netplay::rollbackToAnchor() {
+    m_replayStart = Clock::now();
+    SaveStates::rollback(m_snapshot);
+    m_replayUntil = m_frame;
+    m_frame = *m_anchor;
+    m_anchor.reset();
+    m_mispredicted = false;
+    g_emulator->m_spu->setAudioSuppressed(true);
+    m_stats.rollbacks++;
+}
+
+void PCSX::Netplay::beginFrame() {
+    const uint32_t frame = m_frame++;
+    auto& s = slot(frame);
+    s.wasPredicted = frame >= m_remoteReceived;
+    if (s.wasPredicted) {
+        if (!m_anchor) {
+            m_anchor = frame;
+            m_snapshot = SaveStates::snapshot();
+        }
+        s.predicted = m_remoteReceived ? slot(m_remoteReceived - 1).remote : Pads::Input();
+    }
+    if ((frame % c_hashInterval) == 0) {
+        m_pendingHashes[frame] = Hashing::xxh64(g_emulator->m_mem->m_wram, g_emulator->getRamMask() + 1);
+    }
+    auto& pads = g_emulator->m_pads;
+    pads->forceInput(m_host ? Pads::Port::Port1 : Pads::Port::Port2, s.local);
+    pads->forceInput(m_host ? Pads::Port::Port2 : Pads::Port::Port1, s.wasPredicted ? s.predicted : s.remote);
+}
+
+bool PCSX::Netplay::vsync() {
+    if ((m_status == Status::Stopped) || (m_status == Status::Listening)) return true;
+    if (m_status == Status::Connecting) {
+        handshake();
+        if (!playing()) return true;
+    }
+
+    if (m_replayUntil) {
+        if (m_frame < *m_replayUntil) {
+            m_stats.framesReplayed++;
+            beginFrame();
+            return false;
+        }
+        // Caught up, and this frame gets presented in place of the one which was wrong
+        m_replayUntil.reset();
+        g_emulator->m_spu->setAudioSuppressed(false);
+        m_stats.lastRollback =
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_replayStart).count();
+    }
+
+    // Ours go first, so that both sides waiting on each other still get what they wait for
+    if (!receive()) return true;
+    sendInputs();
+    bool stalled = false;
+    while (true) {
+        if (m_mispredicted) {
+            rollbackToAnchor();
+            beginFrame();
+            return false;
+        }
+        if (m_anchor && (m_remoteReceived >= m_frame)) {
+            m_anchor.reset();
+            m_snapshot.clear();
+        }
+        if (!m_anchor || (m_frame - *m_anchor < c_maxRollback)) break;
+        // Out of frames to go ahead with; some of the other side's inputs coming in moves the anchor forward
+        if (m_remoteReceived > *m_anchor) {
+            rollbackToAnchor();
+            beginFrame();
+            return false;
+        }
+        if (!stalled) m_stats.stalls++;
+        stalled = true;
+        if (!waitForRemote()) return true;
+    }
+    sendHashes();
+    beginFrame();
+    return true;
+}
@@ -0,0 +1,158 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "core/pad.h"
+#include "support/eventbus.h"
+#include "support/file.h"
+#include "support/uvfile.h"
+
+namespace PCSX {
+
+// Plays against another emulator over TCP, each side owning one of the pads: the host gets the first one, and
+// the client the second one. On connecting, the host sends its machine over to the client, and both go on from
+// there, from frame 0, exchanging the input of their own pad for each frame.
+//
+// The local pad gets sampled at the start of each frame, and is applied that many frames later on both sides,
+// which is the input delay. It can be changed at any time, on either side. When the input of the other side for
+// a frame isn't in yet, its last known one gets used instead, and the frame goes on. Once the real one comes in
+// and turns out to be different, the machine goes back to the first frame which didn't have it, and gets emulated
+// again up to where it was, without presenting anything or outputting audio. Going back is SaveStates::rollback(),
+// out of a snapshot taken at that first frame, the same way run-ahead does, which is why run-ahead is off while
+// playing. Getting too far ahead of the other side waits for it instead.
+//
+// Both sides hash the main RAM at the start of every so many frames, and send it over once all of the inputs
+// leading there are known, to catch the two machines going different ways.
+class Netplay {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr unsigned c_maxInputDelay = 15;
+    static constexpr unsigned c_maxRollback = 8;
+    static constexpr unsigned c_hashInterval = 60;
+    static constexpr std::chrono::seconds c_timeout{5};
+
+    enum class Status { Stopped, Listening, Connecting, Playing };
+
+    struct Stats {
+        uint64_t rollbacks = 0;
+        uint64_t framesReplayed = 0;
+        // How many times this side waited for the other one.
+        uint64_t stalls = 0;
+        // How long the last rollback took, from going back to catching up, in microseconds.
+        float lastRollback = 0.0f;
+        // The first frame the two sides had different RAM at, if any.
+        std::optional<uint32_t> desync;
+    };
+
+    Netplay();
+
+    void host(unsigned port);
+    void connect(std::string_view address, unsigned port);
+    void stop();
+
+    void setInputDelay(unsigned frames) { m_inputDelay = std::min(frames, c_maxInputDelay); }
+    unsigned inputDelay() const { return m_inputDelay; }
+
+    Status status() const { return m_status; }
+    bool playing() const { return m_status == Status::Playing; }
+    // The frame about to be emulated.
+    uint32_t frame() const { return m_frame; }
+    const Stats& stats() const { return m_stats; }
+
+    // Called by the emulator at each vsync, before anything else gets to see the frame which just ended. Returns
+    // false when that frame got emulated again after a rollback, which means it isn't to be presented, nor to go
+    // through anything else a frame normally does.
+    bool vsync();
+
+  private:
+    static constexpr unsigned c_window = 64;
+    static constexpr uint32_t c_version = 1;
+    enum class Message : uint8_t { Hello = 'N', State = 'S', Input = 'I', Hash = 'H' };
+
+    struct Slot {
+        Pads::Input local;
+        Pads::Input remote;
+        // What got used for the other side, while its input wasn't in yet.
+        Pads::Input predicted;
+        bool wasPredicted = false;
+    };
+    Slot& slot(uint32_t frame) { return m_slots[frame % c_window]; }
+
+    void start(UvFifo* fifo);
+    void startPlaying();
+    void handshake();
+    // Reads whatever came in, and returns false if the connection got lost, or went wrong.
+    bool receive();
+    void send(std::string_view data) { m_fifo->write(data.data(), data.size()); }
+    void sendInputs();
+    void sendHashes();
+    void compareHashes();
+    bool waitForRemote();
+    void rollbackToAnchor();
+    void beginFrame();
+    void failed(const char* reason);
+
+    Status m_status = Status::Stopped;
+    bool m_host = false;
+    IO<UvFifo> m_fifo;
+    uv_async_t m_async;
+    // Until the listener is done closing, it can't be started again.
+    bool m_asyncOpen = false;
+    UvFifoListener m_fifoListener;
+    std::string m_incoming;
+    bool m_helloSent = false;
+    bool m_loading = false;
+
+    unsigned m_inputDelay = 2;
+    uint32_t m_frame = 0;
+    // How many frames of input got sent, and received, so far; both go in order.
+    uint32_t m_localSent = 0;
+    uint32_t m_remoteReceived = 0;
+    std::array<Slot, c_window> m_slots;
+
+    // The first frame which got emulated without the input of the other side, with a snapshot from its start.
+    std::optional<uint32_t> m_anchor;
+    std::string m_snapshot;
+    bool m_mispredicted = false;
+    // While emulating again after a rollback, the frame where it was at.
+    std::optional<uint32_t> m_replayUntil;
+    Clock::time_point m_replayStart;
+
+    // Our hashes stay pending until all of the inputs before their frame are known, as a rollback could still
+    // change them. Then they get sent, and both sides' are kept by frame until they get compared.
+    std::map<uint32_t, uint64_t> m_pendingHashes;
+    std::map<uint32_t, uint64_t> m_localHashes;
+    std::map<uint32_t, uint64_t> m_remoteHashes;
+
+    Stats m_stats;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -26,7 +26,10 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
+#include <chrono>
 #include <cmath>
+#include <optional>
 #include <magic_enum_all.hpp>
 
 #include "core/psxemulator.h"
@@ -47,6 +50,7 @@ class PadsImpl : public PCSX::Pads {
     void shutdown() override;
     uint8_t startPoll(Port port) override;
     uint8_t poll(uint8_t value, Port port, uint32_t& padState) override;
+    void pollResponse(Port port, uint8_t* dest, size_t size) override;
 
     json getCfg() override;
     void setCfg(const json& j) override;
@@ -67,8 +71,31 @@ class PadsImpl : public PCSX::Pads {
         }
     }
 
+    Input readInput(Port port) override;
+    void forceInput(Port port, const Input& input) override;
+    void releaseInput(Port port) override;
+    InputLatency inputLatency() const override;
+
   private:
+    using Clock = std::chrono::steady_clock;
+
+    // The keyboard as the host last reported it. This gets updated straight from the key callback, instead of
+    // going through ImGui, whose input queue only gets applied when the next GUI frame starts, and trickles
+    // events down to one per frame when they pile up. Pads sample it right when the guest starts polling them.
+    struct KeyboardState {
+        std::bitset<GLFW_KEY_LAST + 1> down;
+        Clock::time_point changed;
+        uint64_t serial = 0;
+    };
+    static constexpr unsigned c_latencySamples = 32;
+
+    void measureLatency(unsigned index, uint16_t previousButtons);
+
     PCSX::EventBus::Listener m_listener;
+    KeyboardState m_keyboard;
+    float m_latencies[c_latencySamples] = {};
+    unsigned m_latencyIndex = 0;
+    unsigned m_latencyCount = 0;
     // This is a list of all of the valid GLFW gamepad IDs that we have found querying GLFW.
     // A value of -1 means that there is no gamepad at that index.
     int m_gamepadsMap[16] = {0};
@@ -163,8 +190,9 @@ class PadsImpl : public PCSX::Pads {
         uint8_t startPoll();
         uint8_t read();
         uint8_t poll(uint8_t value, uint32_t& padState);
+        void pollResponse(uint8_t* dest, size_t size);
         uint8_t doDualshockCommand(uint32_t& padState);
-        void getButtons();
+        void getButtons(const KeyboardState& keyboard);
         bool isControllerButtonPressed(int button, GLFWgamepadstate* state);
         bool isControllerConnected() { return m_settings.get<SettingConnected>(); }
 
@@ -183,6 +211,11 @@ class PadsImpl : public PCSX::Pads {
         PadType m_type;
         PadData m_data;
 
+        std::optional<Input> m_forced;
+        // The keyboard state the last poll saw, and whether the buttons came from the keyboard.
+        uint64_t m_keyboardSerial = 0;
+        bool m_fromKeyboard = false;
+
         int m_padID = -1;
         int m_buttonToWait = -1;
         bool m_changed = false;
@@ -205,7 +238,7 @@ class PadsImpl : public PCSX::Pads {
     unsigned m_selectedPadForConfig = 0;
 };
 
-static PadsImpl* s_pads = nullptr;
+static thread_local PadsImpl* s_pads = nullptr;
 
 static ImGuiKey GlfwKeyToImGuiKey(int key) {
     switch (key) {
@@ -457,6 +490,14 @@ void PadsImpl::shutdown() {
 
 PadsImpl::PadsImpl() : m_listener(PCSX::g_system->m_eventBus) {
     m_listener.listen<PCSX::Events::Keyboard>([this](const auto& event) {
+        if ((event.key >= 0) && (event.key <= GLFW_KEY_LAST) && (event.action != GLFW_REPEAT)) {
+            const bool down = event.action == GLFW_PRESS;
+            if (m_keyboard.down[event.key] != down) {
+                m_keyboard.down[event.key] = down;
+                m_keyboard.changed = Clock::now();
+                m_keyboard.serial++;
+            }
+        }
         if (m_showCfg) {
             m_pads[m_selectedPadForConfig].keyboardEvent(event);
         }
@@ -566,8 +607,9 @@ bool PadsImpl::Pad::isControllerButtonPressed(int button, GLFWgamepadstate* stat
 
 static constexpr float π(float fraction = 1.0f) { return fraction * M_PI; }
 
-void PadsImpl::Pad::getButtons() {
+void PadsImpl::Pad::getButtons(const KeyboardState& keyboard) {
     PadData& pad = m_data;
+    m_fromKeyboard = false;
     if (!m_settings.get<SettingConnected>()) {
         pad.buttonStatus = 0xffff;
         pad.leftJoyX = pad.rightJoyX = pad.leftJoyY = pad.rightJoyY = 0x80;
@@ -578,12 +620,13 @@ void PadsImpl::Pad::getButtons() {
     int hasPad = GLFW_FALSE;
     const auto& inputType = m_settings.get<SettingInputType>();
 
-    auto getKeyboardButtons = [this]() -> uint16_t {
+    auto getKeyboardButtons = [this, &keyboard]() -> uint16_t {
+        m_fromKeyboard = true;
         uint16_t result = 0;
         for (unsigned i = 0; i < 16; i++) {
-            auto key = GlfwKeyToImGuiKey(m_scancodes[i]);
-            if (key == ImGuiKey_None) continue;
-            result |= (ImGui::IsKeyDown(key)) << i;
+            const int key = m_scancodes[i];
+            if ((key < 0) || (key > GLFW_KEY_LAST)) continue;
+            result |= keyboard.down[key] << i;
         }
         return result ^ 0xffff;  // Controls are inverted, so 0 = pressed
     };
@@ -680,15 +723,61 @@ void PadsImpl::Pad::getButtons() {
 
 uint8_t PadsImpl::startPoll(Port port) {
     int index = magic_enum::enum_integer(port);
-    m_pads[index].getButtons();
+    const uint16_t previousButtons = m_pads[index].m_data.buttonStatus;
+    m_pads[index].getButtons(m_keyboard);
+    measureLatency(index, previousButtons);
     return m_pads[index].startPoll();
 }
 
+// A poll which sees the buttons change after the keyboard did is the one picking up that change, so the time
+// since then is how long it waited for the guest.
+void PadsImpl::measureLatency(unsigned index, uint16_t previousButtons) {
+    auto& pad = m_pads[index];
+    if (!pad.m_fromKeyboard || (pad.m_keyboardSerial == m_keyboard.serial)) return;
+    pad.m_keyboardSerial = m_keyboard.serial;
+    if (pad.m_data.buttonStatus == previousButtons) return;
+    const std::chrono::duration<float, std::milli> latency = Clock::now() - m_keyboard.changed;
+    m_latencies[m_latencyIndex] = latency.count();
+    m_latencyIndex = (m_latencyIndex + 1) % c_latencySamples;
+    m_latencyCount = std::min(m_latencyCount + 1, c_latencySamples);
+}
+
+PCSX::Pads::InputLatency PadsImpl::inputLatency() const {
+    InputLatency ret;
+    ret.samples = m_latencyCount;
+    if (m_latencyCount == 0) return ret;
+    ret.last = m_latencies[(m_latencyIndex + c_latencySamples - 1) % c_latencySamples];
+    float total = 0.0f;
+    for (unsigned i = 0; i < m_latencyCount; i++) {
+        total += m_latencies[i];
+        ret.max = std::max(ret.max, m_latencies[i]);
+    }
+    ret.average = total / m_latencyCount;
+    return ret;
+}
+
 uint8_t PadsImpl::poll(uint8_t value, Port port, uint32_t& padState) {
     int index = magic_enum::enum_integer(port);
     return m_pads[index].poll(value, padState);
 }
 
+void PadsImpl::pollResponse(Port port, uint8_t* dest, size_t size) {
+    int index = magic_enum::enum_integer(port);
+    m_pads[index].pollResponse(dest, size);
+}
+
+PCSX::Pads::Input PadsImpl::readInput(Port port) {
+    auto& pad = m_pads[magic_enum::enum_integer(port)];
+    pad.getButtons(m_keyboard);
+    const PadData& data = pad.m_data;
+    return {uint16_t(data.buttonStatus & data.overrides), data.rightJoyX, data.rightJoyY, data.leftJoyX,
+            data.leftJoyY};
+}
+
+void PadsImpl::forceInput(Port port, const Input& input) { m_pads[magic_enum::enum_integer(port)].m_forced = input; }
+
+void PadsImpl::releaseInput(Port port) { m_pads[magic_enum::enum_integer(port)].m_forced.reset(); }
+
 uint8_t PadsImpl::Pad::poll(uint8_t value, uint32_t& padState) {
     if (m_currentByte == 0) {
         m_cmd = value;
@@ -749,6 +838,13 @@ uint8_t PadsImpl::Pad::poll(uint8_t value, uint32_t& padState) {
     return m_buf[m_currentByte++];
 }
 
+void PadsImpl::Pad::pollResponse(uint8_t* dest, size_t size) {
+    const int available = std::clamp(m_bufferLen - m_currentByte, 0, int(size));
+    std::memcpy(dest, m_buf + m_currentByte, available);
+    std::memset(dest + available, 0xff, size - available);
+    m_currentByte += available;
+}
+
 uint8_t PadsImpl::Pad::doDualshockCommand(uint32_t& padState) {
     m_bufferLen = 8;
 
@@ -806,8 +902,15 @@ uint8_t PadsImpl::Pad::startPoll() {
 }
 
 uint8_t PadsImpl::Pad::read() {
-    const PadData& pad = m_data;
+    PadData pad = m_data;
     uint16_t buttonStatus = pad.buttonStatus & pad.overrides;
+    if (m_forced) {
+        buttonStatus = m_forced->buttons;
+        pad.rightJoyX = m_forced->rightJoyX;
+        pad.rightJoyY = m_forced->rightJoyY;
+        pad.leftJoyX = m_forced->leftJoyX;
+        pad.leftJoyY = m_forced->leftJoyY;
+    }
     if (!m_settings.get<SettingConnected>()) {
         m_bufferLen = 0;
         return 0xff;
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <stdio.h>
 
 #include "json.hpp"
@@ -40,6 +41,9 @@ class Pads {
     virtual void shutdown() = 0;
     virtual uint8_t startPoll(Port port) = 0;
     virtual uint8_t poll(uint8_t value, Port port, uint32_t& padState) = 0;
+    // Once a read command got polled, the rest of the response no longer depends on what the console sends,
+    // and this copies the next size bytes of it at once, the same as polling them one by one would.
+    virtual void pollResponse(Port port, uint8_t* dest, size_t size) = 0;
 
     virtual json getCfg() = 0;
     virtual void setCfg(const json& j) = 0;
@@ -52,6 +56,26 @@ class Pads {
 
     virtual bool isPadConnected(int pad) = 0;
 
+    // What a pad sends back when read: the buttons, where 0 means pressed, and the sticks, at 0x80 when centered.
+    struct Input {
+        uint16_t buttons = 0xffff;
+        uint8_t rightJoyX = 0x80, rightJoyY = 0x80, leftJoyX = 0x80, leftJoyY = 0x80;
+        bool operator==(const Input&) const = default;
+    };
+    // Samples the live input of a pad, Lua overrides included, even while it's forced.
+    virtual Input readInput(Port port) = 0;
+    // The pad reports this instead of its live input, until released. The mouse isn't covered.
+    virtual void forceInput(Port port, const Input& input) = 0;
+    virtual void releaseInput(Port port) = 0;
+
+    // How long keyboard input waited between the host reporting it and the guest polling it, over the last few
+    // changes, in milliseconds.
+    struct InputLatency {
+        float last = 0.0f, average = 0.0f, max = 0.0f;
+        unsigned samples = 0;
+    };
+    virtual InputLatency inputLatency() const = 0;
+
     bool m_showCfg = false;
 
     enum {
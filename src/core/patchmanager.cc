@@ -19,14 +19,21 @@
 
 #include "core/patchmanager.h"
 
+#include <algorithm>
+
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/system.h"
+
+PCSX::PatchManager::PatchManager() : m_listener(g_system->m_eventBus) {
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) { reapply(); });
+}
 
 int PCSX::PatchManager::registerPatch(uint32_t address, Patch::Type type) {
     int index = (int)m_patches.size();
-    uint32_t org0 = g_emulator->m_mem->read32(address);
-    uint32_t org1 = (type == Patch::Type::Return) ? g_emulator->m_mem->read32(address + 4) : 0;
+    uint32_t org0 = peek(address);
+    uint32_t org1 = (type == Patch::Type::Return) ? peek(address + 4) : 0;
     Patch patch = Patch(address, type, org0, org1);
     doPatch(patch);
     m_patches.push_back(patch);
@@ -34,17 +41,53 @@ int PCSX::PatchManager::registerPatch(uint32_t address, Patch::Type type) {
     return index;
 }
 
+uint32_t PCSX::PatchManager::peek(uint32_t address) {
+    auto pointer = reinterpret_cast<const uint8_t*>(g_emulator->m_mem->pointerRead(address));
+    if (!pointer) return g_emulator->m_mem->read32(address);
+    return pointer[0] | (pointer[1] << 8) | (pointer[2] << 16) | (uint32_t(pointer[3]) << 24);
+}
+
+void PCSX::PatchManager::poke(uint32_t address, uint32_t value) {
+    const bool ram = (address & 0x1fffffff) < Memory::c_ramSize;
+    auto pointer = reinterpret_cast<uint8_t*>(const_cast<void*>(g_emulator->m_mem->pointerRead(address)));
+    if (!ram || !pointer) {
+        g_emulator->m_mem->write32(address, value);
+        return;
+    }
+    for (unsigned i = 0; i < 4; i++) pointer[i] = value >> (i * 8);
+    g_emulator->m_mem->markRAMDirty(address, 4);
+    m_pendingInvalidations.push_back(address & ~3);
+    if (m_batchDepth == 0) flushInvalidations();
+}
+
+void PCSX::PatchManager::endBatch() {
+    if ((m_batchDepth > 0) && (--m_batchDepth == 0)) flushInvalidations();
+}
+
+void PCSX::PatchManager::flushInvalidations() {
+    auto& pending = m_pendingInvalidations;
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+    for (size_t i = 0; i < pending.size();) {
+        size_t words = 1;
+        while (((i + words) < pending.size()) && (pending[i + words] == (pending[i] + words * 4))) words++;
+        g_emulator->m_cpu->Clear(pending[i], words);
+        i += words;
+    }
+    pending.clear();
+}
+
 void PCSX::PatchManager::doPatch(Patch& patch) {
     switch (patch.type) {
         case PatchManager::Patch::Type::Return:
-            g_emulator->m_mem->write32(patch.addr, 0x03e00008);
-            g_emulator->m_mem->write32(patch.addr + 4, 0);
-            g_emulator->m_cpu->invalidateCache();
+            beginBatch();
+            poke(patch.addr, 0x03e00008);
+            poke(patch.addr + 4, 0);
+            endBatch();
             break;
 
         case PatchManager::Patch::Type::NOP:
-            g_emulator->m_mem->write32(patch.addr, 0);
-            g_emulator->m_cpu->invalidateCache();
+            poke(patch.addr, 0);
             break;
 
         default:
@@ -56,14 +99,14 @@ void PCSX::PatchManager::doPatch(Patch& patch) {
 void PCSX::PatchManager::undoPatch(Patch& patch) {
     switch (patch.type) {
         case PatchManager::Patch::Type::Return:
-            g_emulator->m_mem->write32(patch.addr, patch.org0);
-            g_emulator->m_mem->write32(patch.addr + 4, patch.org1);
-            g_emulator->m_cpu->invalidateCache();
+            beginBatch();
+            poke(patch.addr, patch.org0);
+            poke(patch.addr + 4, patch.org1);
+            endBatch();
             break;
 
         case PatchManager::Patch::Type::NOP:
-            g_emulator->m_mem->write32(patch.addr, patch.org0);
-            g_emulator->m_cpu->invalidateCache();
+            poke(patch.addr, patch.org0);
             break;
 
         default:
@@ -72,12 +115,38 @@ void PCSX::PatchManager::undoPatch(Patch& patch) {
     patch.active = false;
 }
 
+// The state may have been saved with or without the patches in, or even be running different code at these
+// addresses, so what gets restored when undoing a patch is whatever the state has there, unless it's the
+// patch itself.
+void PCSX::PatchManager::reapply() {
+    beginBatch();
+    for (Patch& patch : m_patches) {
+        if (!patch.active) continue;
+        switch (patch.type) {
+            case PatchManager::Patch::Type::Return:
+                if ((peek(patch.addr) != 0x03e00008) || (peek(patch.addr + 4) != 0)) {
+                    patch.org0 = peek(patch.addr);
+                    patch.org1 = peek(patch.addr + 4);
+                }
+                break;
+            case PatchManager::Patch::Type::NOP:
+                if (peek(patch.addr) != 0) patch.org0 = peek(patch.addr);
+                break;
+            default:
+                break;
+        }
+        doPatch(patch);
+    }
+    endBatch();
+}
+
 int PCSX::PatchManager::findPatch(uint32_t address) const {
     int idx = 0;
     for (const Patch& patch : m_patches) {
         if (patch.addr == address) {
             return idx;
         }
+        idx++;
     }
     return -1;
 }
@@ -93,17 +162,21 @@ void PCSX::PatchManager::deleteAllPatches() {
 }
 
 void PCSX::PatchManager::deactivateAll() {
+    beginBatch();
     for (Patch& patch : m_patches) {
         if (patch.active) {
             undoPatch(patch);
         }
     }
+    endBatch();
 }
 
 void PCSX::PatchManager::activateAll() {
+    beginBatch();
     for (Patch& patch : m_patches) {
         if (!patch.active) {
             doPatch(patch);
         }
     }
+    endBatch();
 }
@@ -23,10 +23,17 @@
 
 #include <vector>
 
+#include "support/eventbus.h"
+
 namespace PCSX {
 
+// Patches are written straight into the RAM, without going through the CPU bus, so that they don't cost
+// emulated cycles, and only the words they touch get invalidated in the CPU caches. Active patches get
+// written again after loading a save state, with the words they replace taken from the state.
 class PatchManager {
   public:
+    PatchManager();
+
     struct Patch {
         enum class Type : uint8_t { None, Return, NOP };
 
@@ -57,11 +64,23 @@ class PatchManager {
     void doPatch(int index) { doPatch(m_patches[index]); }
     void undoPatch(int index) { undoPatch(m_patches[index]); }
 
+    // While a batch is open, the words being patched only get invalidated once it gets closed, merged
+    // into runs of consecutive words. Batches can be nested.
+    void beginBatch() { m_batchDepth++; }
+    void endBatch();
+
   private:
     void doPatch(Patch& patch);
     void undoPatch(Patch& patch);
+    void poke(uint32_t address, uint32_t value);
+    uint32_t peek(uint32_t address);
+    void flushInvalidations();
+    void reapply();
 
     std::vector<Patch> m_patches;
+    std::vector<uint32_t> m_pendingInvalidations;
+    unsigned m_batchDepth = 0;
+    EventBus::Listener m_listener;
 };
 
 }  // namespace PCSX
@@ -58,10 +58,13 @@ uint8_t* getScratchPtr();
 psxRegisters* getRegisters();
 uint8_t** getReadLUT();
 uint8_t** getWriteLUT();
+uint32_t getRamSize();
 Breakpoint* addBreakpoint(uint32_t address, enum BreakpointType type, unsigned width, const char* cause, bool (*invoker)(uint32_t address, unsigned width, const char* cause), const char* label);
 void enableBreakpoint(Breakpoint*);
 void disableBreakpoint(Breakpoint*);
 bool breakpointEnabled(Breakpoint*);
+bool setBreakpointCondition(Breakpoint*, const char* expression);
+uint64_t getBreakpointHits(Breakpoint*);
 void removeBreakpoint(Breakpoint*);
 void pauseEmulator();
 void resumeEmulator();
@@ -73,6 +76,18 @@ void jumpToPC(uint32_t address);
 void jumpToMemory(uint32_t address, unsigned width);
 void invalidateCache();
 
+typedef struct {
+    uint32_t type, frame, pc, address, value;
+} EventRecord;
+
+typedef struct {
+    EventRecord* records;
+    uint32_t capacity, head, tail, dropped, frame;
+} EventRing;
+
+EventRing* enableEventQueue(uint32_t capacity);
+void disableEventQueue();
+
 typedef enum { BPP_16, BPP_24 } ScreenShotBPP;
 
 typedef struct {
@@ -87,8 +102,91 @@ LuaSlice* createSaveState();
 void loadSaveStateFromSlice(LuaSlice*);
 void loadSaveStateFromFile(LuaFile*);
 
+bool rewindEmulator(uint32_t steps);
+uint32_t getRewindCount();
+uint64_t getRewindMemoryUsed();
+uint64_t getRewindDropped();
+void clearRewind();
+
+void getFastCDStats(uint64_t* stats);
+void resetFastCDStats();
+
+bool recordMovie(LuaFile*, uint32_t keyframeInterval);
+bool playMovie(LuaFile*);
+bool seekMovie(uint64_t frame);
+void stopMovie();
+bool isMovieRecording();
+bool isMoviePlaying();
+uint64_t getMovieFrame();
+uint64_t getMovieFrames();
+
+void hostNetplay(uint32_t port);
+void connectNetplay(const char* address, uint32_t port);
+void stopNetplay();
+void setNetplayInputDelay(uint32_t frames);
+uint32_t getNetplayInputDelay();
+uint32_t getNetplayStatus();
+uint32_t getNetplayFrame();
+uint64_t getNetplayRollbacks();
+uint64_t getNetplayFramesReplayed();
+uint64_t getNetplayStalls();
+float getNetplayLastRollback();
+int64_t getNetplayDesync();
+
+typedef struct {
+    uint32_t pc, code, address, value;
+    bool memory;
+    uint8_t changedCount;
+    uint8_t changed[34];
+    uint32_t values[34];
+    uint32_t registers[34];
+} TraceRecord;
+typedef struct { uint8_t opaque[?]; } TraceReader;
+
+bool startTrace(LuaFile*);
+void stopTrace();
+bool isTracing();
+uint64_t getTraceInstructions();
+TraceReader* openTrace(LuaFile*);
+void deleteTrace(TraceReader*);
+uint64_t getTraceSize(TraceReader*);
+bool readTraceRecord(TraceReader*, uint64_t index, TraceRecord*);
+
+void enableCallStacks(bool enabled);
+bool isCallStacksEnabled();
+unsigned getCallStack(uint32_t* ras, unsigned max);
+void startProfiler(uint32_t interval);
+void stopProfiler();
+void clearProfile();
+bool isProfilerRunning();
+uint64_t getProfileSamples();
+void writeProfileCollapsed(LuaFile*);
+void writeProfilePprof(LuaFile*);
+void startCoverage();
+void stopCoverage();
+void clearCoverage();
+bool isCoverageRunning();
+uint64_t getCoveredInstructions();
+void writeCoverageLcov(LuaFile*);
+void enableCycleAccounting(bool enabled);
+bool isCycleAccountingEnabled();
+void clearCycleAccounting();
+void getCycleAccountingTotals(uint64_t* totals);
+uint64_t getCycleAccountingCycles(uint32_t address);
+uint64_t getCycleAccountingExecutions(uint32_t address);
+void writeCycleAccountingReport(LuaFile*, uint32_t maxBlocks);
+void startGPUCapture();
+bool isCapturingGPU();
+bool stopGPUCapture(LuaFile*);
+uint32_t getGPUCounterCount();
+const char* getGPUCounterName(uint32_t index);
+void getGPUCounters(uint64_t* counters);
+
 LuaFile* getMemoryAsFile();
 
+int forkEmulator();
+bool isForkedEmulator();
+
 void quit(int code);
 ]]
 
@@ -146,6 +244,8 @@ local function addBreakpoint(address, bptype, width, cause, invoker, label)
         enable = function(bp) C.enableBreakpoint(bp._wrapper) end,
         disable = function(bp) C.disableBreakpoint(bp._wrapper) end,
         isEnabled = function(bp) return C.breakpointEnabled(bp._wrapper) end,
+        setCondition = function(bp, expression) return C.setBreakpointCondition(bp._wrapper, expression or '') end,
+        getHits = function(bp) return tonumber(C.getBreakpointHits(bp._wrapper)) end,
         remove = function(bp) removeBreakpoint(bp) end,
     }
     -- Use a proxy instead of doing this on the wrapper directly using ffi.gc, because of a bug in LuaJIT,
@@ -154,6 +254,40 @@ local function addBreakpoint(address, bptype, width, cause, invoker, label)
     return bp
 end
 
+local eventRing = nil
+
+-- Iterates over the events recorded since the last drain. The records live in the ring, and get overwritten
+-- once drained, so copy out whatever needs to be kept around.
+local function drainEvents()
+    local ring = eventRing
+    if ring == nil then error 'PCSX.drainEvents: event batching needs to be enabled first' end
+    local mask = ring.capacity - 1
+    local head = bit.tobit(ring.head)
+    local tail = bit.tobit(ring.tail)
+    return function()
+        if tail == head then return nil end
+        local record = ring.records[bit.band(tail, mask)]
+        tail = bit.tobit(tail + 1)
+        ring.tail = tail
+        return record
+    end
+end
+
+-- Typed arrays over a memory region, without any bounds checking: indices are in elements of each type, and
+-- wrapping them within the region, using the mask, is up to the caller.
+local function createMemoryView(ptr, size)
+    return {
+        u8 = ffi.cast('uint8_t*', ptr),
+        s8 = ffi.cast('int8_t*', ptr),
+        u16 = ffi.cast('uint16_t*', ptr),
+        s16 = ffi.cast('int16_t*', ptr),
+        u32 = ffi.cast('uint32_t*', ptr),
+        s32 = ffi.cast('int32_t*', ptr),
+        size = size,
+        mask = size - 1,
+    }
+end
+
 local function printLike(callback, ...)
     local s = ''
     for i, v in ipairs({ ... }) do s = s .. tostring(v) .. ' ' end
@@ -181,12 +315,22 @@ PCSX = {
     getRegisters = function() return C.getRegisters() end,
     getReadLUT = function() return C.getReadLUT() end,
     getWriteLUT = function() return C.getWriteLUT() end,
+    getRamView = function() return createMemoryView(C.getMemPtr(), C.getRamSize()) end,
+    getScratchpadView = function() return createMemoryView(C.getScratchPtr(), 1024) end,
     addBreakpoint = addBreakpoint,
     pauseEmulator = function() C.pauseEmulator() end,
     resumeEmulator = function() C.resumeEmulator() end,
     softResetEmulator = function() C.softResetEmulator() end,
     hardResetEmulator = function() C.hardResetEmulator() end,
     invalidateCache = function() C.invalidateCache() end,
+    EventTypes = { VSync = 0, Breakpoint = 1, KernelCall = 2 },
+    startEventBatching = function(capacity) eventRing = C.enableEventQueue(capacity or 4096) end,
+    stopEventBatching = function()
+        C.disableEventQueue()
+        eventRing = nil
+    end,
+    drainEvents = drainEvents,
+    getDroppedEvents = function() return eventRing and eventRing.dropped or 0 end,
     log = function(...) printLike(function(msg) C.luaLog(msg .. '\n') end, ...) end,
     GUI = { jumpToPC = jumpToPC, jumpToMemory = jumpToMemory },
     nextTick = function(f)
@@ -206,6 +350,20 @@ PCSX = {
                 bpp = ss.bpp,
             }
         end,
+        startCapture = function() C.startGPUCapture() end,
+        isCapturing = function() return C.isCapturingGPU() end,
+        stopCapture = function(file)
+            if type(file) ~= 'table' or file._type ~= 'File' then error('stopCapture: requires a File as input') end
+            return C.stopGPUCapture(file._wrapper)
+        end,
+        getCounters = function()
+            local count = C.getGPUCounterCount()
+            local counters = ffi.new('uint64_t[?]', count)
+            C.getGPUCounters(counters)
+            local ret = {}
+            for i = 0, count - 1 do ret[ffi.string(C.getGPUCounterName(i))] = tonumber(counters[i]) end
+            return ret
+        end,
     },
     createSaveState = function()
         local slice = C.createSaveState()
@@ -221,7 +379,166 @@ PCSX = {
             error('loadSaveState: requires a Slice or File as input')
         end
     end,
+    rewind = function(steps) return C.rewindEmulator(steps or 1) end,
+    getRewindInfo = function()
+        return {
+            count = C.getRewindCount(),
+            memoryUsed = tonumber(C.getRewindMemoryUsed()),
+            dropped = tonumber(C.getRewindDropped()),
+        }
+    end,
+    clearRewind = function() C.clearRewind() end,
+    getFastCDStats = function()
+        local stats = ffi.new('uint64_t[4]')
+        C.getFastCDStats(stats)
+        return {
+            totalSaved = tonumber(stats[0]),
+            lastSaved = tonumber(stats[1]),
+            lastSectors = tonumber(stats[2]),
+            loads = tonumber(stats[3]),
+        }
+    end,
+    resetFastCDStats = function() C.resetFastCDStats() end,
+    recordMovie = function(file, keyframeInterval)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('recordMovie: requires a File as input') end
+        return C.recordMovie(file._wrapper, keyframeInterval or 600)
+    end,
+    playMovie = function(file)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('playMovie: requires a File as input') end
+        return C.playMovie(file._wrapper)
+    end,
+    seekMovie = function(frame) return C.seekMovie(frame) end,
+    stopMovie = function() C.stopMovie() end,
+    getMovieInfo = function()
+        return {
+            recording = C.isMovieRecording(),
+            playing = C.isMoviePlaying(),
+            frame = tonumber(C.getMovieFrame()),
+            frames = tonumber(C.getMovieFrames()),
+        }
+    end,
+    hostNetplay = function(port)
+        if type(port) ~= 'number' then error('hostNetplay: requires a port') end
+        C.hostNetplay(port)
+    end,
+    connectNetplay = function(address, port)
+        if type(address) ~= 'string' or type(port) ~= 'number' then
+            error('connectNetplay: requires an address and a port')
+        end
+        C.connectNetplay(address, port)
+    end,
+    stopNetplay = function() C.stopNetplay() end,
+    setNetplayInputDelay = function(frames) C.setNetplayInputDelay(frames) end,
+    getNetplayInfo = function()
+        local statuses = { 'stopped', 'listening', 'connecting', 'playing' }
+        local desync = tonumber(C.getNetplayDesync())
+        return {
+            status = statuses[C.getNetplayStatus() + 1],
+            frame = C.getNetplayFrame(),
+            inputDelay = C.getNetplayInputDelay(),
+            rollbacks = tonumber(C.getNetplayRollbacks()),
+            framesReplayed = tonumber(C.getNetplayFramesReplayed()),
+            stalls = tonumber(C.getNetplayStalls()),
+            lastRollback = C.getNetplayLastRollback(),
+            desync = desync >= 0 and desync or nil,
+        }
+    end,
+    startTrace = function(file)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('startTrace: requires a File as input') end
+        return C.startTrace(file._wrapper)
+    end,
+    stopTrace = function() C.stopTrace() end,
+    getTraceInfo = function()
+        return {
+            recording = C.isTracing(),
+            instructions = tonumber(C.getTraceInstructions()),
+        }
+    end,
+    openTrace = function(file)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('openTrace: requires a File as input') end
+        local wrapper = C.openTrace(file._wrapper)
+        if wrapper == nil then return nil end
+        local trace = { _wrapper = ffi.gc(wrapper, C.deleteTrace), _type = 'Trace' }
+        trace.size = function(self) return tonumber(C.getTraceSize(self._wrapper)) end
+        -- Records are numbered from 0. The registers in them are the ones from right before the instruction ran.
+        trace.read = function(self, index)
+            local record = ffi.new('TraceRecord')
+            if not C.readTraceRecord(self._wrapper, index, record) then return nil end
+            return record
+        end
+        return trace
+    end,
+    -- Call stacks are only tracked while something needs them; they start out empty when enabling them.
+    enableCallStacks = function(enabled) C.enableCallStacks(enabled ~= false) end,
+    isCallStacksEnabled = function() return C.isCallStacksEnabled() end,
+    getCallStack = function()
+        local ras = ffi.new('uint32_t[256]')
+        local count = C.getCallStack(ras, 256)
+        local ret = {}
+        for i = 0, count - 1 do ret[#ret + 1] = ras[i] end
+        return ret
+    end,
+    startProfiler = function(interval) C.startProfiler(interval or 33868) end,
+    stopProfiler = function() C.stopProfiler() end,
+    clearProfile = function() C.clearProfile() end,
+    getProfilerInfo = function()
+        return {
+            running = C.isProfilerRunning(),
+            samples = tonumber(C.getProfileSamples()),
+        }
+    end,
+    writeProfile = function(file, format)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('writeProfile: requires a File as input') end
+        if format == nil or format == 'collapsed' then
+            C.writeProfileCollapsed(file._wrapper)
+        elseif format == 'pprof' then
+            C.writeProfilePprof(file._wrapper)
+        else
+            error('writeProfile: unknown format ' .. tostring(format))
+        end
+    end,
+    startCoverage = function() C.startCoverage() end,
+    stopCoverage = function() C.stopCoverage() end,
+    clearCoverage = function() C.clearCoverage() end,
+    getCoverageInfo = function()
+        return {
+            running = C.isCoverageRunning(),
+            instructions = tonumber(C.getCoveredInstructions()),
+        }
+    end,
+    writeCoverage = function(file)
+        if type(file) ~= 'table' or file._type ~= 'File' then error('writeCoverage: requires a File as input') end
+        C.writeCoverageLcov(file._wrapper)
+    end,
+    enableCycleAccounting = function(enabled) C.enableCycleAccounting(enabled ~= false) end,
+    clearCycleAccounting = function() C.clearCycleAccounting() end,
+    getCycleAccountingInfo = function()
+        local totals = ffi.new('uint64_t[5]')
+        C.getCycleAccountingTotals(totals)
+        local info = {
+            enabled = C.isCycleAccountingEnabled(),
+            instructions = tonumber(totals[0]),
+            base = tonumber(totals[1]),
+            memory = tonumber(totals[2]),
+            gte = tonumber(totals[3]),
+            dma = tonumber(totals[4]),
+        }
+        info.cycles = info.base + info.memory + info.gte + info.dma
+        return info
+    end,
+    getCycleAccountingCost = function(address)
+        return tonumber(C.getCycleAccountingCycles(address)), tonumber(C.getCycleAccountingExecutions(address))
+    end,
+    writeCycleAccountingReport = function(file, maxBlocks)
+        if type(file) ~= 'table' or file._type ~= 'File' then
+            error('writeCycleAccountingReport: requires a File as input')
+        end
+        C.writeCycleAccountingReport(file._wrapper, maxBlocks or 100)
+    end,
     getMemoryAsFile = function() return Support.File._createFileWrapper(C.getMemoryAsFile()) end,
+    getMemoryView = function(address, size) return PCSX.getMemoryAsFile():view(address, size) end,
+    fork = function() return C.forkEmulator() end,
+    isFork = function() return C.isForkedEmulator() end,
     quit = function(code) C.quit(code or 0) end,
 }
 
@@ -19,12 +19,22 @@
 
 #include "core/pcsxlua.h"
 
+#include "core/callstacks.h"
+#include "core/cdrom.h"
+#include "core/cycleaccounting.h"
 #include "core/debug.h"
+#include "core/eventqueue.h"
 #include "core/gpu.h"
+#include "core/guestcoverage.h"
+#include "core/guestprofiler.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/movie.h"
+#include "core/netplay.h"
+#include "core/rewind.h"
 #include "core/sstate.h"
+#include "core/tracerecorder.h"
 #include "lua/luafile.h"
 #include "lua/luawrapper.h"
 
@@ -42,6 +52,7 @@ void* getScratchPtr() { return PCSX::g_emulator->m_mem->m_hard; }
 void* getRegisters() { return &PCSX::g_emulator->m_cpu->m_regs; }
 void* getReadLUT() { return PCSX::g_emulator->m_mem->m_readLUT; }
 void* getWriteLUT() { return PCSX::g_emulator->m_mem->m_writeLUT; }
+uint32_t getRamSize() { return PCSX::g_emulator->getRamMask() + 1; }
 
 LuaBreakpoint* addBreakpoint(uint32_t address, PCSX::Debug::BreakpointType type, unsigned width, const char* cause,
                              bool (*invoker)(uint32_t address, unsigned width, const char* cause), const char* label) {
@@ -72,6 +83,17 @@ bool breakpointEnabled(LuaBreakpoint* wrapper) {
     if (wrapper->wrapper.size() == 0) return false;
     return wrapper->wrapper.begin()->enabled();
 }
+bool setBreakpointCondition(LuaBreakpoint* wrapper, const char* expression) {
+    if (wrapper->wrapper.size() == 0) return false;
+    std::string error;
+    if (wrapper->wrapper.begin()->condition(expression, error)) return true;
+    PCSX::g_system->luaMessage(fmt::format("Invalid breakpoint condition: {}", error), true);
+    return false;
+}
+uint64_t getBreakpointHits(LuaBreakpoint* wrapper) {
+    if (wrapper->wrapper.size() == 0) return 0;
+    return wrapper->wrapper.begin()->hits();
+}
 void removeBreakpoint(LuaBreakpoint* wrapper) {
     if (!wrapper) return;
     wrapper->wrapper.destroyAll();
@@ -89,6 +111,13 @@ void jumpToMemory(uint32_t address, unsigned width) {
 }
 void invalidateCache() { PCSX::g_emulator->m_cpu->invalidateCache(); }
 
+void* enableEventQueue(uint32_t capacity) {
+    auto& queue = PCSX::g_emulator->m_eventQueue;
+    queue->enable(capacity);
+    return queue->ring();
+}
+void disableEventQueue() { PCSX::g_emulator->m_eventQueue->disable(); }
+
 struct LuaScreenShot {
     PCSX::Slice* data;
     uint16_t width, height;
@@ -117,10 +146,186 @@ void loadSaveStateFromFile(PCSX::LuaFFI::LuaFile* file) {
     PCSX::SaveStates::load(data.asStringView());
 }
 
+bool rewindEmulator(uint32_t steps) { return PCSX::SaveStates::rewind(steps); }
+uint32_t getRewindCount() { return PCSX::g_emulator->m_rewind->count(); }
+uint64_t getRewindMemoryUsed() { return PCSX::g_emulator->m_rewind->memoryUsed(); }
+uint64_t getRewindDropped() { return PCSX::g_emulator->m_rewind->dropped(); }
+void clearRewind() { PCSX::g_emulator->m_rewind->clear(); }
+
+void getFastCDStats(uint64_t* stats) {
+    auto& s = PCSX::g_emulator->m_cdrom->getFastCDStats();
+    stats[0] = s.totalSaved;
+    stats[1] = s.lastSaved;
+    stats[2] = s.lastSectors;
+    stats[3] = s.loads;
+}
+void resetFastCDStats() { PCSX::g_emulator->m_cdrom->resetFastCDStats(); }
+
+bool recordMovie(PCSX::LuaFFI::LuaFile* file, uint32_t keyframeInterval) {
+    return PCSX::g_emulator->m_movie->record(file->file, keyframeInterval);
+}
+bool playMovie(PCSX::LuaFFI::LuaFile* file) { return PCSX::g_emulator->m_movie->play(file->file); }
+bool seekMovie(uint64_t frame) { return PCSX::g_emulator->m_movie->seek(frame); }
+void stopMovie() { PCSX::g_emulator->m_movie->stop(); }
+bool isMovieRecording() { return PCSX::g_emulator->m_movie->recording(); }
+bool isMoviePlaying() { return PCSX::g_emulator->m_movie->playing(); }
+uint64_t getMovieFrame() { return PCSX::g_emulator->m_movie->frame(); }
+uint64_t getMovieFrames() { return PCSX::g_emulator->m_movie->frames(); }
+
+void hostNetplay(uint32_t port) { PCSX::g_emulator->m_netplay->host(port); }
+void connectNetplay(const char* address, uint32_t port) { PCSX::g_emulator->m_netplay->connect(address, port); }
+void stopNetplay() { PCSX::g_emulator->m_netplay->stop(); }
+void setNetplayInputDelay(uint32_t frames) { PCSX::g_emulator->m_netplay->setInputDelay(frames); }
+uint32_t getNetplayInputDelay() { return PCSX::g_emulator->m_netplay->inputDelay(); }
+uint32_t getNetplayStatus() { return uint32_t(PCSX::g_emulator->m_netplay->status()); }
+uint32_t getNetplayFrame() { return PCSX::g_emulator->m_netplay->frame(); }
+uint64_t getNetplayRollbacks() { return PCSX::g_emulator->m_netplay->stats().rollbacks; }
+uint64_t getNetplayFramesReplayed() { return PCSX::g_emulator->m_netplay->stats().framesReplayed; }
+uint64_t getNetplayStalls() { return PCSX::g_emulator->m_netplay->stats().stalls; }
+float getNetplayLastRollback() { return PCSX::g_emulator->m_netplay->stats().lastRollback; }
+int64_t getNetplayDesync() {
+    const auto& desync = PCSX::g_emulator->m_netplay->stats().desync;
+    return desync ? int64_t(*desync) : -1;
+}
+
+struct LuaTraceRecord {
+    uint32_t pc, code, address, value;
+    bool memory;
+    uint8_t changedCount;
+    uint8_t changed[PCSX::TraceRecorder::c_registers];
+    uint32_t values[PCSX::TraceRecorder::c_registers];
+    uint32_t registers[PCSX::TraceRecorder::c_registers];
+};
+
+bool startTrace(PCSX::LuaFFI::LuaFile* file) {
+    return PCSX::g_emulator->m_traceRecorder->start(file->file, PCSX::g_emulator->m_cpu->m_regs.GPR.r);
+}
+void stopTrace() { PCSX::g_emulator->m_traceRecorder->stop(); }
+bool isTracing() { return PCSX::g_emulator->m_traceRecorder->recording(); }
+uint64_t getTraceInstructions() { return PCSX::g_emulator->m_traceRecorder->instructions(); }
+PCSX::TraceRecorder::Reader* openTrace(PCSX::LuaFFI::LuaFile* file) {
+    auto reader = new PCSX::TraceRecorder::Reader();
+    if (reader->open(file->file)) return reader;
+    delete reader;
+    return nullptr;
+}
+void deleteTrace(PCSX::TraceRecorder::Reader* reader) { delete reader; }
+uint64_t getTraceSize(PCSX::TraceRecorder::Reader* reader) { return reader->size(); }
+bool readTraceRecord(PCSX::TraceRecorder::Reader* reader, uint64_t index, LuaTraceRecord* out) {
+    PCSX::TraceRecorder::Record record;
+    PCSX::TraceRecorder::Registers registers;
+    if (!reader->read(index, record, &registers)) return false;
+    out->pc = record.pc;
+    out->code = record.code;
+    out->address = record.address;
+    out->value = record.value;
+    out->memory = record.memory;
+    out->changedCount = record.changedCount;
+    for (unsigned i = 0; i < record.changedCount; i++) {
+        out->changed[i] = record.changed[i];
+        out->values[i] = record.values[i];
+    }
+    for (unsigned i = 0; i < PCSX::TraceRecorder::c_registers; i++) out->registers[i] = registers[i];
+    return true;
+}
+
+bool s_luaCallStacks = false;
+void enableCallStacks(bool enabled) {
+    if (enabled == s_luaCallStacks) return;
+    s_luaCallStacks = enabled;
+    if (enabled) {
+        PCSX::g_emulator->m_callStacks->subscribe();
+    } else {
+        PCSX::g_emulator->m_callStacks->unsubscribe();
+    }
+}
+bool isCallStacksEnabled() { return s_luaCallStacks; }
+// The return addresses of the current call stack, outermost first.
+unsigned getCallStack(uint32_t* ras, unsigned max) {
+    auto& callStacks = PCSX::g_emulator->m_callStacks;
+    if (!callStacks->hasCurrent()) return 0;
+    unsigned count = 0;
+    for (const auto& call : callStacks->getCurrent().calls) {
+        if (count == max) break;
+        ras[count++] = call.ra;
+    }
+    return count;
+}
+
+void startProfiler(uint32_t interval) { PCSX::g_emulator->m_guestProfiler->start(interval); }
+void stopProfiler() { PCSX::g_emulator->m_guestProfiler->stop(); }
+void clearProfile() { PCSX::g_emulator->m_guestProfiler->profile().clear(); }
+bool isProfilerRunning() { return PCSX::g_emulator->m_guestProfiler->running(); }
+uint64_t getProfileSamples() { return PCSX::g_emulator->m_guestProfiler->profile().samples(); }
+void writeProfileCollapsed(PCSX::LuaFFI::LuaFile* file) {
+    PCSX::g_emulator->m_guestProfiler->writeCollapsed(file->file);
+}
+void writeProfilePprof(PCSX::LuaFFI::LuaFile* file) { PCSX::g_emulator->m_guestProfiler->writePprof(file->file); }
+
+void startCoverage() {
+    PCSX::g_emulator->m_guestCoverage->start(PCSX::g_emulator->getRamMask());
+    PCSX::g_emulator->m_cpu->invalidateCache();
+}
+void stopCoverage() {
+    PCSX::g_emulator->m_guestCoverage->stop();
+    PCSX::g_emulator->m_cpu->invalidateCache();
+}
+void clearCoverage() { PCSX::g_emulator->m_guestCoverage->clear(); }
+bool isCoverageRunning() { return PCSX::g_emulator->m_guestCoverage->running(); }
+uint64_t getCoveredInstructions() { return PCSX::g_emulator->m_guestCoverage->coveredInstructions(); }
+void writeCoverageLcov(PCSX::LuaFFI::LuaFile* file) {
+    PCSX::g_emulator->m_guestCoverage->writeLcov(file->file, PCSX::g_emulator->m_cpu->m_symbols);
+}
+
+void enableCycleAccounting(bool enabled) {
+    if (enabled) {
+        PCSX::g_emulator->m_cycleAccounting->enable();
+    } else {
+        PCSX::g_emulator->m_cycleAccounting->disable();
+    }
+}
+bool isCycleAccountingEnabled() { return PCSX::g_emulator->m_cycleAccounting->enabled(); }
+void clearCycleAccounting() { PCSX::g_emulator->m_cycleAccounting->clear(); }
+void getCycleAccountingTotals(uint64_t* totals) {
+    auto& t = PCSX::g_emulator->m_cycleAccounting->totals();
+    totals[0] = t.instructions;
+    totals[1] = t.base;
+    totals[2] = t.memory;
+    totals[3] = t.gte;
+    totals[4] = t.dma;
+}
+uint64_t getCycleAccountingCycles(uint32_t address) { return PCSX::g_emulator->m_cycleAccounting->cycles(address); }
+uint64_t getCycleAccountingExecutions(uint32_t address) {
+    return PCSX::g_emulator->m_cycleAccounting->executions(address);
+}
+void writeCycleAccountingReport(PCSX::LuaFFI::LuaFile* file, uint32_t maxBlocks) {
+    PCSX::g_emulator->m_cycleAccounting->writeReport(file->file, PCSX::g_emulator->m_cpu->m_symbols, maxBlocks);
+}
+
+void startGPUCapture() { PCSX::g_emulator->m_gpu->startCapture(); }
+bool isCapturingGPU() { return PCSX::g_emulator->m_gpu->capturing(); }
+bool stopGPUCapture(PCSX::LuaFFI::LuaFile* file) {
+    auto capture = PCSX::g_emulator->m_gpu->stopCapture();
+    if (!capture) return false;
+    capture->save(file->file);
+    return true;
+}
+uint32_t getGPUCounterCount() { return PCSX::GPU::c_counters; }
+const char* getGPUCounterName(uint32_t index) {
+    return PCSX::GPU::counterName(static_cast<PCSX::GPU::Counter>(index)).data();
+}
+void getGPUCounters(uint64_t* counters) {
+    auto& last = PCSX::g_emulator->m_gpu->lastFrameCounters();
+    for (unsigned i = 0; i < PCSX::GPU::c_counters; i++) counters[i] = last[i];
+}
+
 PCSX::LuaFFI::LuaFile* getMemoryAsFile() {
     return new PCSX::LuaFFI::LuaFile(PCSX::g_emulator->m_mem->getMemoryAsFile());
 }
 
+int forkEmulator() { return PCSX::g_emulator->fork(); }
+bool isForkedEmulator() { return PCSX::g_emulator->isFork(); }
+
 void quit(int code) { PCSX::g_system->quit(code); }
 
 }  // namespace
@@ -146,10 +351,13 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, getRegisters);
     REGISTER(L, getReadLUT);
     REGISTER(L, getWriteLUT);
+    REGISTER(L, getRamSize);
     REGISTER(L, addBreakpoint);
     REGISTER(L, enableBreakpoint);
     REGISTER(L, disableBreakpoint);
     REGISTER(L, breakpointEnabled);
+    REGISTER(L, setBreakpointCondition);
+    REGISTER(L, getBreakpointHits);
     REGISTER(L, removeBreakpoint);
     REGISTER(L, pauseEmulator);
     REGISTER(L, resumeEmulator);
@@ -160,11 +368,79 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, jumpToPC);
     REGISTER(L, jumpToMemory);
     REGISTER(L, invalidateCache);
+    REGISTER(L, enableEventQueue);
+    REGISTER(L, disableEventQueue);
     REGISTER(L, takeScreenShot);
     REGISTER(L, createSaveState);
     REGISTER(L, loadSaveStateFromSlice);
     REGISTER(L, loadSaveStateFromFile);
+    REGISTER(L, rewindEmulator);
+    REGISTER(L, getRewindCount);
+    REGISTER(L, getRewindMemoryUsed);
+    REGISTER(L, getRewindDropped);
+    REGISTER(L, clearRewind);
+    REGISTER(L, getFastCDStats);
+    REGISTER(L, resetFastCDStats);
+    REGISTER(L, recordMovie);
+    REGISTER(L, playMovie);
+    REGISTER(L, seekMovie);
+    REGISTER(L, stopMovie);
+    REGISTER(L, isMovieRecording);
+    REGISTER(L, isMoviePlaying);
+    REGISTER(L, getMovieFrame);
+    REGISTER(L, getMovieFrames);
+    REGISTER(L, hostNetplay);
+    REGISTER(L, connectNetplay);
+    REGISTER(L, stopNetplay);
+    REGISTER(L, setNetplayInputDelay);
+    REGISTER(L, getNetplayInputDelay);
+    REGISTER(L, getNetplayStatus);
+    REGISTER(L, getNetplayFrame);
+    REGISTER(L, getNetplayRollbacks);
+    REGISTER(L, getNetplayFramesReplayed);
+    REGISTER(L, getNetplayStalls);
+    REGISTER(L, getNetplayLastRollback);
+    REGISTER(L, getNetplayDesync);
+    REGISTER(L, startTrace);
+    REGISTER(L, stopTrace);
+    REGISTER(L, isTracing);
+    REGISTER(L, getTraceInstructions);
+    REGISTER(L, openTrace);
+    REGISTER(L, deleteTrace);
+    REGISTER(L, getTraceSize);
+    REGISTER(L, readTraceRecord);
+    REGISTER(L, enableCallStacks);
+    REGISTER(L, isCallStacksEnabled);
+    REGISTER(L, getCallStack);
+    REGISTER(L, startProfiler);
+    REGISTER(L, stopProfiler);
+    REGISTER(L, clearProfile);
+    REGISTER(L, isProfilerRunning);
+    REGISTER(L, getProfileSamples);
+    REGISTER(L, writeProfileCollapsed);
+    REGISTER(L, writeProfilePprof);
+    REGISTER(L, startCoverage);
+    REGISTER(L, stopCoverage);
+    REGISTER(L, clearCoverage);
+    REGISTER(L, isCoverageRunning);
+    REGISTER(L, getCoveredInstructions);
+    REGISTER(L, writeCoverageLcov);
+    REGISTER(L, enableCycleAccounting);
+    REGISTER(L, isCycleAccountingEnabled);
+    REGISTER(L, clearCycleAccounting);
+    REGISTER(L, getCycleAccountingTotals);
+    REGISTER(L, getCycleAccountingCycles);
+    REGISTER(L, getCycleAccountingExecutions);
+    REGISTER(L, writeCycleAccountingReport);
+    REGISTER(L, startGPUCapture);
+    REGISTER(L, isCapturingGPU);
+    REGISTER(L, stopGPUCapture);
+    REGISTER(L, getGPUCounterCount);
+    REGISTER(L, getGPUCounterName);
+    REGISTER(L, getGPUCounters);
     REGISTER(L, getMemoryAsFile);
+    REGISTER(L, forkEmulator);
+    REGISTER(L, isForkedEmulator);
     REGISTER(L, quit);
     L.settable();
     L.pop();
@@ -201,6 +477,7 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
             uint32_t address = L.checknumber(1);
             auto name = L.tostring(2);
             g_emulator->m_cpu->m_symbols[address] = name;
+            g_emulator->m_cpu->symbolsChanged();
             return 0;
         },
         -1);
@@ -222,7 +499,10 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
                     i++;
                 }
             }
-            if (i != symbols.end()) symbols.erase(i);
+            if (i != symbols.end()) {
+                symbols.erase(i);
+                g_emulator->m_cpu->symbolsChanged();
+            }
             return 0;
         },
         -1);
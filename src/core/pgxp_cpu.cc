@@ -2,8 +2,11 @@
 #include "core/pgxp_cpu.h"
 
 #include "core/pgxp_debug.h"
+#include "core/pgxp_gte.h"
 #include "core/pgxp_mem.h"
 #include "core/pgxp_value.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
 
 // CPU registers
 static PGXP_value s_CPU_reg_mem[34];
@@ -1281,3 +1284,314 @@ void PGXP_CP0_CTC0(uint32_t instr, uint32_t rdVal, uint32_t rtVal) {
 }
 
 void PGXP_CP0_RFE(uint32_t instr) {}
+
+////////////////////////////////////
+// Dynarec support
+////////////////////////////////////
+
+bool PGXP_DynarecHasHook(uint32_t mode, uint32_t code) {
+    if (mode == 0) return false;
+    const bool full = mode >= 2;
+
+    switch (op(code)) {
+        case 0x00:  // SPECIAL
+            if (!full) return false;
+            switch (func(code)) {
+                case 0x00:
+                case 0x02:
+                case 0x03:  // SLL, SRL, SRA
+                case 0x04:
+                case 0x06:
+                case 0x07:  // SLLV, SRLV, SRAV
+                case 0x10:
+                case 0x12:  // MFHI, MFLO
+                case 0x20:
+                case 0x21:
+                case 0x22:
+                case 0x23:  // ADD, ADDU, SUB, SUBU
+                case 0x24:
+                case 0x25:
+                case 0x26:
+                case 0x27:  // AND, OR, XOR, NOR
+                case 0x2a:
+                case 0x2b:  // SLT, SLTU
+                    return rd(code) != 0;
+                case 0x11:
+                case 0x13:  // MTHI, MTLO
+                case 0x18:
+                case 0x19:
+                case 0x1a:
+                case 0x1b:  // MULT, MULTU, DIV, DIVU
+                    return true;
+            }
+            return false;
+
+        case 0x08:
+        case 0x09:
+        case 0x0a:
+        case 0x0b:  // ADDI, ADDIU, SLTI, SLTIU
+        case 0x0c:
+        case 0x0d:
+        case 0x0e:
+        case 0x0f:  // ANDI, ORI, XORI, LUI
+            return full && rt(code) != 0;
+
+        case 0x10:  // COP0
+        case 0x12:  // COP2
+            if (code & (1 << 25)) return false;
+            switch (rs(code)) {
+                case 0x00:  // MFC0, MFC2
+                    return rt(code) != 0;
+                case 0x02:  // CFC2
+                    return op(code) == 0x12 && rt(code) != 0;
+                case 0x04:  // MTC0, MTC2
+                    return true;
+                case 0x06:  // CTC2
+                    return op(code) == 0x12;
+            }
+            return false;
+
+        case 0x20:
+        case 0x21:
+        case 0x22:
+        case 0x23:  // LB, LH, LWL, LW
+        case 0x24:
+        case 0x25:
+        case 0x26:  // LBU, LHU, LWR
+        case 0x28:
+        case 0x29:
+        case 0x2a:
+        case 0x2b:
+        case 0x2e:  // SB, SH, SWL, SW, SWR
+        case 0x32:  // LWC2
+        case 0x3a:  // SWC2
+            return true;
+    }
+    return false;
+}
+
+namespace {
+
+// What a load is about to read, without the side effects an actual read could have. Hardware registers read as 0.
+uint32_t PeekMem(uint32_t addr, unsigned width) {
+    auto p = reinterpret_cast<const uint8_t*>(PCSX::g_emulator->m_mem->pointerRead(addr & ~(width - 1)));
+    uint32_t value = 0;
+    if (p) {
+        for (unsigned i = 0; i < width; i++) value |= uint32_t(p[i]) << (i * 8);
+    }
+    return value;
+}
+
+void DynarecSpecialHook(uint32_t instr, const PCSX::psxRegisters* regs) {
+    const uint32_t rsVal = regs->GPR.r[rs(instr)];
+    const uint32_t rtVal = regs->GPR.r[rt(instr)];
+    const uint32_t hiVal = regs->GPR.n.hi;
+    const uint32_t loVal = regs->GPR.n.lo;
+
+    switch (func(instr)) {
+        case 0x00:
+            PGXP_CPU_SLL(instr, rtVal << sa(instr), rtVal);
+            break;
+        case 0x02:
+            PGXP_CPU_SRL(instr, rtVal >> sa(instr), rtVal);
+            break;
+        case 0x03:
+            PGXP_CPU_SRA(instr, uint32_t(int32_t(rtVal) >> sa(instr)), rtVal);
+            break;
+        case 0x04:
+            PGXP_CPU_SLLV(instr, rtVal << (rsVal & 0x1f), rtVal, rsVal);
+            break;
+        case 0x06:
+            PGXP_CPU_SRLV(instr, rtVal >> (rsVal & 0x1f), rtVal, rsVal);
+            break;
+        case 0x07:
+            PGXP_CPU_SRAV(instr, uint32_t(int32_t(rtVal) >> (rsVal & 0x1f)), rtVal, rsVal);
+            break;
+        case 0x10:
+            PGXP_CPU_MFHI(instr, hiVal, hiVal);
+            break;
+        // Same values as the interpreter passes
+        case 0x11:
+            PGXP_CPU_MTHI(instr, rsVal, regs->GPR.r[rd(instr)]);
+            break;
+        case 0x12:
+            PGXP_CPU_MFLO(instr, loVal, loVal);
+            break;
+        case 0x13:
+            PGXP_CPU_MTLO(instr, rsVal, regs->GPR.r[rd(instr)]);
+            break;
+        case 0x18: {
+            const uint64_t res = int64_t(int32_t(rsVal)) * int64_t(int32_t(rtVal));
+            PGXP_CPU_MULT(instr, uint32_t(res >> 32), uint32_t(res), rsVal, rtVal);
+            break;
+        }
+        case 0x19: {
+            const uint64_t res = uint64_t(rsVal) * uint64_t(rtVal);
+            PGXP_CPU_MULTU(instr, uint32_t(res >> 32), uint32_t(res), rsVal, rtVal);
+            break;
+        }
+        case 0x1a: {
+            uint32_t hi, lo;
+            if (rtVal == 0) {
+                hi = rsVal;
+                lo = (rsVal & 0x80000000) ? 1 : 0xffffffff;
+            } else if (rsVal == 0x80000000 && rtVal == 0xffffffff) {
+                hi = 0;
+                lo = 0x80000000;
+            } else {
+                hi = uint32_t(int32_t(rsVal) % int32_t(rtVal));
+                lo = uint32_t(int32_t(rsVal) / int32_t(rtVal));
+            }
+            PGXP_CPU_DIV(instr, hi, lo, rsVal, rtVal);
+            break;
+        }
+        case 0x1b: {
+            const uint32_t hi = rtVal ? rsVal % rtVal : rsVal;
+            const uint32_t lo = rtVal ? rsVal / rtVal : 0xffffffff;
+            PGXP_CPU_DIVU(instr, hi, lo, rsVal, rtVal);
+            break;
+        }
+        case 0x20:
+            PGXP_CPU_ADD(instr, rsVal + rtVal, rsVal, rtVal);
+            break;
+        case 0x21:
+            PGXP_CPU_ADDU(instr, rsVal + rtVal, rsVal, rtVal);
+            break;
+        case 0x22:
+            PGXP_CPU_SUB(instr, rsVal - rtVal, rsVal, rtVal);
+            break;
+        case 0x23:
+            PGXP_CPU_SUBU(instr, rsVal - rtVal, rsVal, rtVal);
+            break;
+        case 0x24:
+            PGXP_CPU_AND(instr, rsVal & rtVal, rsVal, rtVal);
+            break;
+        case 0x25:
+            PGXP_CPU_OR(instr, rsVal | rtVal, rsVal, rtVal);
+            break;
+        case 0x26:
+            PGXP_CPU_XOR(instr, rsVal ^ rtVal, rsVal, rtVal);
+            break;
+        case 0x27:
+            PGXP_CPU_NOR(instr, ~(rsVal | rtVal), rsVal, rtVal);
+            break;
+        case 0x2a:
+            PGXP_CPU_SLT(instr, int32_t(rsVal) < int32_t(rtVal), rsVal, rtVal);
+            break;
+        case 0x2b:
+            PGXP_CPU_SLTU(instr, rsVal < rtVal, rsVal, rtVal);
+            break;
+    }
+}
+
+}  // namespace
+
+void PGXP_DynarecHook(uint32_t instr, const PCSX::psxRegisters* regs) {
+    static constexpr uint32_t c_lwlMask[4] = {0x00ffffff, 0x0000ffff, 0x000000ff, 0x00000000};
+    static constexpr uint32_t c_lwrMask[4] = {0x00000000, 0xff000000, 0xffff0000, 0xffffff00};
+
+    const uint32_t rsVal = regs->GPR.r[rs(instr)];
+    const uint32_t rtVal = regs->GPR.r[rt(instr)];
+    const uint32_t immVal = imm(instr);
+    const uint32_t simmVal = uint32_t(int32_t(int16_t(immVal)));
+    const uint32_t addr = rsVal + simmVal;
+    const uint32_t shift = addr & 3;
+
+    switch (op(instr)) {
+        case 0x00:
+            DynarecSpecialHook(instr, regs);
+            break;
+
+        case 0x08:
+            PGXP_CPU_ADDI(instr, rsVal + simmVal, rsVal);
+            break;
+        case 0x09:
+            PGXP_CPU_ADDIU(instr, rsVal + simmVal, rsVal);
+            break;
+        case 0x0a:
+            PGXP_CPU_SLTI(instr, int32_t(rsVal) < int32_t(simmVal), rsVal);
+            break;
+        case 0x0b:
+            PGXP_CPU_SLTIU(instr, rsVal < simmVal, rsVal);
+            break;
+        case 0x0c:
+            PGXP_CPU_ANDI(instr, rsVal & immVal, rsVal);
+            break;
+        case 0x0d:
+            PGXP_CPU_ORI(instr, rsVal | immVal, rsVal);
+            break;
+        case 0x0e:
+            PGXP_CPU_XORI(instr, rsVal ^ immVal, rsVal);
+            break;
+        case 0x0f:
+            PGXP_CPU_LUI(instr, immVal << 16);
+            break;
+
+        case 0x10:
+            if (rs(instr) == 0x00) {
+                PGXP_CP0_MFC0(instr, regs->CP0.r[rd(instr)], regs->CP0.r[rd(instr)]);
+            } else {
+                PGXP_CP0_MTC0(instr, rtVal, rtVal);
+            }
+            break;
+        case 0x12:
+            switch (rs(instr)) {
+                case 0x00:
+                    PGXP_GTE_MFC2(instr, regs->CP2D.r[rd(instr)], regs->CP2D.r[rd(instr)]);
+                    break;
+                case 0x02:
+                    PGXP_GTE_CFC2(instr, regs->CP2C.r[rd(instr)], regs->CP2C.r[rd(instr)]);
+                    break;
+                case 0x04:
+                    PGXP_GTE_MTC2(instr, rtVal, rtVal);
+                    break;
+                case 0x06:
+                    PGXP_GTE_CTC2(instr, rtVal, rtVal);
+                    break;
+            }
+            break;
+
+        case 0x20:
+            PGXP_CPU_LB(instr, uint8_t(PeekMem(addr, 1)), addr);
+            break;
+        case 0x21:
+            PGXP_CPU_LH(instr, uint16_t(PeekMem(addr, 2)), addr);
+            break;
+        case 0x22:
+            PGXP_CPU_LWL(instr, (rtVal & c_lwlMask[shift]) | (PeekMem(addr, 4) << (24 - shift * 8)), addr);
+            break;
+        case 0x23:
+            PGXP_CPU_LW(instr, PeekMem(addr, 4), addr);
+            break;
+        case 0x24:
+            PGXP_CPU_LBU(instr, uint8_t(PeekMem(addr, 1)), addr);
+            break;
+        case 0x25:
+            PGXP_CPU_LHU(instr, uint16_t(PeekMem(addr, 2)), addr);
+            break;
+        case 0x26:
+            PGXP_CPU_LWR(instr, (rtVal & c_lwrMask[shift]) | (PeekMem(addr, 4) >> (shift * 8)), addr);
+            break;
+        case 0x28:
+            PGXP_CPU_SB(instr, uint8_t(rtVal), addr);
+            break;
+        case 0x29:
+            PGXP_CPU_SH(instr, uint16_t(rtVal), addr);
+            break;
+        case 0x2a:
+            PGXP_CPU_SWL(instr, rtVal, addr);
+            break;
+        case 0x2b:
+            PGXP_CPU_SW(instr, rtVal, addr);
+            break;
+        case 0x2e:
+            PGXP_CPU_SWR(instr, rtVal, addr);
+            break;
+        case 0x32:
+            PGXP_GTE_LWC2(instr, PeekMem(addr, 4), addr);
+            break;
+        case 0x3a:
+            PGXP_GTE_SWC2(instr, regs->CP2D.r[rt(instr)], addr);
+            break;
+    }
+}
@@ -33,6 +33,10 @@
 struct PGXP_value_Tag;
 typedef struct PGXP_value_Tag PGXP_value;
 
+namespace PCSX {
+struct psxRegisters;
+}
+
 extern PGXP_value* const g_CPU_reg;
 extern PGXP_value* const g_CP0_reg;
 #define CPU_Hi g_CPU_reg[33]
@@ -119,4 +123,12 @@ void PGXP_CP0_CFC0(uint32_t instr, uint32_t rtVal, uint32_t rdVal);
 void PGXP_CP0_CTC0(uint32_t instr, uint32_t rdVal, uint32_t rtVal);
 void PGXP_CP0_RFE(uint32_t instr);
 
+// -- Dynarec support
+// The dynarecs don't have a PGXP flavour of each instruction handler like the interpreter does. Instead, they call
+// PGXP_DynarecHook right before an instruction which has a hook in the current mode, once the guest registers
+// are written back. The values the instruction is about to produce get worked out from those registers, and loads
+// peek at memory, without the side effects of an actual read.
+bool PGXP_DynarecHasHook(uint32_t mode, uint32_t code);
+void PGXP_DynarecHook(uint32_t code, const PCSX::psxRegisters* regs);
+
 #endif  //_PGXP_CPU_H_
@@ -1,16 +1,28 @@
 #include "core/pgxp_mem.h"
 
+#include <memory>
+
 #include "core/pgxp_cpu.h"
 #include "core/pgxp_gte.h"
 #include "core/pgxp_value.h"
 
-static PGXP_value s_mem[3 * 2048 * 1024 / 4];  // mirror 2MB in 32-bit words * 3
+// One PGXP_value per 32-bit word of RAM (up to 8MB), scratchpad, and hardware registers. This is sparse: each page
+// only gets allocated the first time something is written into it, and reading from a page which never got written
+// to sees zeroes, which is what the whole thing used to be cleared to. Resetting frees all of the pages.
+static const uint32_t s_pageShift = 10;  // 1024 words, so 4kB of PSX memory per page
+static const uint32_t s_pageSize = 1 << s_pageShift;
 static const uint32_t s_userMemOffset = 0;
-static const uint32_t s_scratchOffset = 2048 * 1024 / 4;
-static const uint32_t s_registerOffset = 2 * 2048 * 1024 / 4;
-static const uint32_t s_invalidAddress = 3 * 2048 * 1024 / 4;
+static const uint32_t s_scratchOffset = 8 * 1024 * 1024 / 4;
+static const uint32_t s_registerOffset = s_scratchOffset + s_pageSize;
+static const uint32_t s_invalidAddress = s_registerOffset + 0xf000 / 4;
+static const uint32_t s_pageCount = s_invalidAddress >> s_pageShift;
+
+static std::unique_ptr<PGXP_value[]> s_pages[s_pageCount];
+static PGXP_value s_unwritten;
 
-void PGXP_InitMem() { memset(s_mem, 0, sizeof(s_mem)); }
+void PGXP_InitMem() {
+    for (auto& page : s_pages) page.reset();
+}
 
 void PGXP_Init() {
     PGXP_InitMem();
@@ -18,10 +30,6 @@ void PGXP_Init() {
     PGXP_InitGTE();
 }
 
-uint8_t* PGXP_GetMem() {
-    return (uint8_t*)(s_mem);  // PCSX::g_emulator->config().PGXP_GTE ? (char*)(s_mem) : NULL;
-}
-
 /*  Playstation Memory Map (from Playstation doc by Joshua Walker)
 0x0000_0000-0x0000_ffff     Kernel (64K)
 0x0001_0000-0x001f_ffff     User Memory (1.9 Meg)
@@ -78,8 +86,8 @@ uint32_t PGXP_ConvertAddress(uint32_t addr) {
         case 0x80:
         case 0xa0:
         case 0x00:
-            // RAM further mirrored over 8MB
-            paddr = ((paddr & 0x7FFFFF) % 0x200000) >> 2;
+            // RAM further mirrored over 8MB, unless there's 8MB of it
+            paddr = (paddr & PCSX::g_emulator->getRamMask()) >> 2;
             paddr = s_userMemOffset + paddr;
             break;
         default:
@@ -109,13 +117,26 @@ uint32_t PGXP_ConvertAddress(uint32_t addr) {
 
 PGXP_value* PGXP_GetPtr(uint32_t addr) {
     addr = PGXP_ConvertAddress(addr);
+    if (addr == s_invalidAddress) return NULL;
 
-    if (addr != s_invalidAddress) return &s_mem[addr];
-    return NULL;
+    auto& page = s_pages[addr >> s_pageShift];
+    if (page) return &page[addr & (s_pageSize - 1)];
+    // Whatever got done to the previous caller's copy doesn't matter
+    s_unwritten = {};
+    return &s_unwritten;
 }
 
 PGXP_value* PGXP_ReadMem(uint32_t addr) { return PGXP_GetPtr(addr); }
 
+static PGXP_value* PGXP_WritePtr(uint32_t addr) {
+    addr = PGXP_ConvertAddress(addr);
+    if (addr == s_invalidAddress) return NULL;
+
+    auto& page = s_pages[addr >> s_pageShift];
+    if (!page) page.reset(new PGXP_value[s_pageSize]());
+    return &page[addr & (s_pageSize - 1)];
+}
+
 void ValidateAndCopyMem(PGXP_value* dest, uint32_t addr, uint32_t value) {
     PGXP_value* pMem = PGXP_GetPtr(addr);
     if (pMem != NULL) {
@@ -167,13 +188,13 @@ void ValidateAndCopyMem16(PGXP_value* dest, uint32_t addr, uint32_t value, int s
 }
 
 void WriteMem(PGXP_value* value, uint32_t addr) {
-    PGXP_value* pMem = PGXP_GetPtr(addr);
+    PGXP_value* pMem = PGXP_WritePtr(addr);
 
     if (pMem) *pMem = *value;
 }
 
 void WriteMem16(PGXP_value* src, uint32_t addr) {
-    PGXP_value* dest = PGXP_GetPtr(addr);
+    PGXP_value* dest = PGXP_WritePtr(addr);
     psx_value* pVal = NULL;
 
     if (dest) {
@@ -30,13 +30,14 @@
 
 #include "core/psxemulator.h"
 
-void PGXP_Init();        // initialise memory
-uint8_t* PGXP_GetMem();  // return pointer to precision memory
+void PGXP_Init();  // initialise memory
 uint32_t PGXP_ConvertAddress(uint32_t addr);
 
 struct PGXP_value_Tag;
 typedef struct PGXP_value_Tag PGXP_value;
 
+// Pages which never got written to read as zeroes, through a scratch value that gets cleared on each call,
+// so writing through these pointers doesn't stick; use WriteMem and WriteMem16 for that.
 PGXP_value* PGXP_GetPtr(uint32_t addr);
 PGXP_value* PGXP_ReadMem(uint32_t addr);
 
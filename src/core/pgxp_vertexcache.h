@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/pgxp_value.h"
+
+namespace PCSX {
+
+// Where PGXP leaves the precise coordinates of the vertices the GTE projects, for the renderer to find them back
+// from the screen coordinates the game then hands to the GPU. This is a direct-mapped hash of the screen
+// coordinates, with a generation per frame: entries of older generations are as good as empty, so starting a new
+// frame doesn't clear anything. A vertex evicting another one of the same frame counts as a collision. Two
+// different vertices landing on the same screen coordinates in the same frame make these ambiguous, and they won't
+// be found anymore until the next frame.
+class PGXPVertexCache {
+  public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t collisions = 0;
+    };
+
+    void insert(int16_t sx, int16_t sy, const PGXP_value& vertex) {
+        const uint32_t key = makeKey(sx, sy);
+        auto& entry = m_entries[slot(key)];
+        if (entry.generation == m_generation) {
+            if (entry.key != key) {
+                m_stats.collisions++;
+            } else if (entry.ambiguous || !sameCoordinates(entry.vertex, vertex)) {
+                entry.ambiguous = true;
+                return;
+            }
+        }
+        entry.key = key;
+        entry.generation = m_generation;
+        entry.ambiguous = false;
+        entry.vertex = vertex;
+    }
+    const PGXP_value* find(int16_t sx, int16_t sy) {
+        const uint32_t key = makeKey(sx, sy);
+        auto& entry = m_entries[slot(key)];
+        if ((entry.generation != m_generation) || (entry.key != key) || entry.ambiguous) {
+            m_stats.misses++;
+            return nullptr;
+        }
+        m_stats.hits++;
+        return &entry.vertex;
+    }
+    void newFrame() {
+        if (++m_generation != 0) return;
+        // Only once every few years of frames
+        for (auto& entry : m_entries) entry.generation = 0;
+        m_generation = 1;
+    }
+    const Stats& stats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+  private:
+    // Games rarely project more than a few thousands of vertices per frame.
+    static constexpr unsigned c_bits = 15;
+    struct Entry {
+        uint32_t key = 0;
+        uint32_t generation = 0;
+        bool ambiguous = false;
+        PGXP_value vertex;
+    };
+
+    static uint32_t makeKey(int16_t sx, int16_t sy) { return (uint32_t(uint16_t(sx)) << 16) | uint16_t(sy); }
+    static uint32_t slot(uint32_t key) { return (key * 0x9e3779b1) >> (32 - c_bits); }
+    static bool sameCoordinates(const PGXP_value& a, const PGXP_value& b) {
+        return (a.x == b.x) && (a.y == b.y) && (a.z == b.z);
+    }
+
+    std::vector<Entry> m_entries = std::vector<Entry>(1 << c_bits);
+    uint32_t m_generation = 1;
+    Stats m_stats;
+};
+
+}  // namespace PCSX
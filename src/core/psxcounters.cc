@@ -25,6 +25,7 @@
 
 #include "core/debug.h"
 #include "core/gpu.h"
+#include "core/runahead.h"
 #include "core/sio1.h"
 #include "fmt/printf.h"
 #include "spu/interface.h"
@@ -69,11 +70,22 @@ inline uint32_t PCSX::Counters::readCounterInternal(uint32_t index) {
     return count;
 }
 
+// Whether the counter reaching its target or overflowing can raise an interrupt. The others don't need to be woken
+// up at all: their value and flags only matter when read, and get computed then by catchUp().
+bool PCSX::Counters::needsEvents(uint32_t index) const {
+    if (index == 3) return true;
+    const auto &rcnt = m_rcnts[index];
+    // One-shot interrupts only come back with a new mode
+    if (rcnt.irqState && !(rcnt.mode & RcIrqRegenerate)) return false;
+    return rcnt.mode & (RcIrqOnTarget | RcIrqOnOverflow);
+}
+
 void PCSX::Counters::set() {
     m_psxNextCounter = PCSX::g_emulator->m_cpu->m_regs.cycle;
     uint64_t next = 0x7fffffffffffffff;
 
     for (int i = 0; i < CounterQuantity; ++i) {
+        if (!needsEvents(i)) continue;
         int64_t countToUpdate = m_rcnts[i].cycle - (m_psxNextCounter - m_rcnts[i].cycleStart);
 
         if (countToUpdate < 0) {
@@ -87,9 +99,31 @@ void PCSX::Counters::set() {
     }
 
     m_psxNextCounter += next;
+    PCSX::g_emulator->m_cpu->scheduleEventTarget(m_psxNextCounter);
 }
 
 void PCSX::Counters::reset(uint32_t index) {
+    wrap(index);
+    set();
+}
+
+// Brings a counter which doesn't get scheduled up to date, since it may have gone around many times since the
+// last look. Counting to a short target is the usual case of this, and gets wrapped in one go.
+void PCSX::Counters::catchUp(uint32_t index) {
+    auto &rcnt = m_rcnts[index];
+    const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
+    while ((cycle - rcnt.cycleStart) >= rcnt.cycle) {
+        if ((rcnt.counterState == CountToTarget) && (rcnt.mode & RcCountToTarget) && (rcnt.target != 0)) {
+            const uint64_t count = (cycle - rcnt.cycleStart) / rcnt.rate;
+            writeCounterInternal(index, count % rcnt.target);
+            rcnt.mode |= RcCountEqTarget | RcIrqRequest;
+        } else {
+            wrap(index);
+        }
+    }
+}
+
+void PCSX::Counters::wrap(uint32_t index) {
     uint64_t count;
 
     if (m_rcnts[index].counterState == CountToTarget) {
@@ -133,14 +167,13 @@ void PCSX::Counters::reset(uint32_t index) {
     }
 
     m_rcnts[index].mode |= RcIrqRequest;
-
-    set();
 }
 
 void PCSX::Counters::update() {
     const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
 
-    {
+    // The frames emulated ahead need to go as fast as they can; the frames emulated for real make up for them
+    if (!g_emulator->m_runAhead->isAhead()) {
         uint64_t prev = g_emulator->m_cpu->m_regs.previousCycles;
         uint64_t diff = cycle - prev;
         diff *= 4410000;
@@ -158,19 +191,14 @@ void PCSX::Counters::update() {
         }
     }
 
-    // rcnt 0.
-    if (cycle - m_rcnts[0].cycleStart >= m_rcnts[0].cycle) {
-        reset(0);
-    }
-
-    // rcnt 1.
-    if (cycle - m_rcnts[1].cycleStart >= m_rcnts[1].cycle) {
-        reset(1);
-    }
-
-    // rcnt 2.
-    if (cycle - m_rcnts[2].cycleStart >= m_rcnts[2].cycle) {
-        reset(2);
+    // rcnt 0 to 2.
+    for (uint32_t i = 0; i < 3; i++) {
+        if (cycle - m_rcnts[i].cycleStart < m_rcnts[i].cycle) continue;
+        if (needsEvents(i)) {
+            reset(i);
+        } else {
+            catchUp(i);
+        }
     }
     // rcnt base.
     if (cycle - m_rcnts[3].cycleStart >= m_rcnts[3].cycle) {
@@ -35,6 +35,9 @@ class Counters {
 
     void set();
     void reset(uint32_t index);
+    void wrap(uint32_t index);
+    void catchUp(uint32_t index);
+    bool needsEvents(uint32_t index) const;
     void calculateHsync();
 
     struct Rcnt {
@@ -21,69 +21,77 @@
 
 #include "core/debug.h"
 #include "spu/interface.h"
+#include "tracy/Tracy.hpp"
+
+namespace {
+
+uint32_t stepSPUDMA() {
+    auto &mem = PCSX::g_emulator->m_mem;
+    const bool toSPU = mem->getCHCR<4>() == 0x01000201;
+    return stepBlockDMA<4>(
+        [toSPU](uint32_t madr, uint32_t words) {
+            uint16_t *ptr = PCSX::g_emulator->m_mem->getPointer<uint16_t>(madr);
+            if (ptr == nullptr) {
+                PSXDMA_LOG("*** DMA4 SPU *** NULL Pointer!!!\n");
+                return;
+            }
+            const bool debug = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+                                   .get<PCSX::Emulator::DebugSettings::Debug>();
+            PCSX::g_emulator->m_mem->msanCheckDMA(4, madr, words * 4, !toSPU);
+            if (toSPU) {
+                PCSX::g_emulator->m_spu->writeDMAMem(ptr, words * 2);
+                if (debug) PCSX::g_emulator->m_debug->checkDMAread(4, madr, words * 4);
+            } else {
+                PCSX::g_emulator->m_spu->readDMAMem(ptr, words * 2);
+                if (debug) PCSX::g_emulator->m_debug->checkDMAwrite(4, madr, words * 4);
+                PCSX::g_emulator->m_cpu->Clear(madr, words * 4);
+                PCSX::g_emulator->m_mem->markRAMDirty(madr, words * 4);
+            }
+        },
+        DMACost::spu);
+}
+
+}  // namespace
 
 void spuInterrupt() {
     auto &mem = PCSX::g_emulator->m_mem;
+    // Whatever is left of a block transfer goes on, unless it got stopped in the meantime.
+    const uint32_t chcr = mem->getCHCR<4>();
+    if ((chcr & 0x01000000) && ((chcr & ~1) == 0x01000200)) {
+        if (const uint32_t cycles = stepSPUDMA()) {
+            scheduleSPUDMAIRQ(cycles);
+            return;
+        }
+    }
     mem->clearDMABusy<4>();
     mem->dmaInterrupt<4>();
 }
 
 void dma4(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // SPU
-    uint16_t *ptr = PCSX::g_emulator->m_mem->getPointer<uint16_t>(madr);
-    uint32_t size;
+    ZoneScopedN("DMA4 SPU");
 
     switch (chcr) {
         case 0x01000201:  // cpu to spu transfer
             PSXDMA_LOG("*** DMA4 SPU - mem2spu *** %x addr = %x size = %x\n", chcr, madr, bcr);
-            if (ptr == nullptr) {
-                PSXDMA_LOG("*** DMA4 SPU - mem2spu *** NULL Pointer!!!\n");
-                break;
-            }
-            size = (bcr >> 16) * (bcr & 0xffff) * 2;
-            PCSX::g_emulator->m_spu->writeDMAMem(ptr, size);
-            if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
-                    .get<PCSX::Emulator::DebugSettings::Debug>()) {
-                PCSX::g_emulator->m_debug->checkDMAread(4, madr, size * 2);
-            }
-
-            // Jungle Book - max 0.333x DMA length
-            // Harry Potter and the Philosopher's Stone - max 0.5x DMA length
-            // uint32_t dmalen=64 + ((bcr >> 18) * (bcr & 0xffff)); // less linear to DMA length which should work with
-            // both games above?
-            scheduleSPUDMAIRQ((bcr >> 16) * (bcr & 0xffff) / 2);
-            return;
-
+            break;
         case 0x01000200:  // spu to cpu transfer
             PSXDMA_LOG("*** DMA4 SPU - spu2mem *** %x addr = %x size = %x\n", chcr, madr, bcr);
-            if (ptr == nullptr) {
-                PSXDMA_LOG("*** DMA4 SPU - spu2mem *** NULL Pointer!!!\n");
-                break;
-            }
-            size = (bcr >> 16) * (bcr & 0xffff) * 2;
-            PCSX::g_emulator->m_spu->readDMAMem(ptr, size);
-            if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
-                    .get<PCSX::Emulator::DebugSettings::Debug>()) {
-                PCSX::g_emulator->m_debug->checkDMAwrite(4, madr, size * 2);
-            }
-            PCSX::g_emulator->m_cpu->Clear(madr, size * 2);
-
-#if 1
-            scheduleSPUDMAIRQ((bcr >> 16) * (bcr & 0xffff) / 2);
-#else
-            // Experimental burst dma transfer (0.333x max)
-            scheduleSPUDMAIRQ((bcr >> 16) * (bcr & 0xffff) / 3);
-#endif
-            return;
-
+            break;
         default:
             PSXDMA_LOG("*** DMA4 SPU - unknown *** %x addr = %x size = %x\n", chcr, madr, bcr);
-            break;
+            spuInterrupt();
+            return;
     }
 
-    spuInterrupt();
+    if (const uint32_t cycles = stepSPUDMA()) {
+        scheduleSPUDMAIRQ(cycles);
+    } else {
+        spuInterrupt();
+    }
 }
 
 void dma6(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    ZoneScopedN("DMA6 OT");
     uint32_t size;
     uint32_t *mem = PCSX::g_emulator->m_mem->getPointer<uint32_t>(madr);
 
@@ -100,14 +108,16 @@ void dma6(uint32_t madr, uint32_t bcr, uint32_t chcr) {
         size = bcr;
 
         if (PCSX::g_emulator->m_mem->msanInitialized() && PCSX::Memory::inMsanRange(madr)) {
+            // The whole table gets validated and marked as initialized in one go
+            PCSX::g_emulator->m_mem->msanCheckDMA(6, madr - (size - 1) * 4, size * 4, true);
             while (bcr--) {
-                // use write32 instead of the direct pointer so that the msan memory gets marked as usable
-                PCSX::g_emulator->m_mem->write32(madr, PCSX::Memory::c_msanChainMarker);
+                *mem-- = PCSX::Memory::c_msanChainMarker;
                 PCSX::g_emulator->m_mem->msanSetChainPtr(madr, madr - 4, 0);
                 madr -= 4;
             }
             madr += 4;
-            PCSX::g_emulator->m_mem->write32(madr, 0xffffff);
+            mem++;
+            *mem = 0xffffff;
         } else {
             while (bcr--) {
                 *mem-- = SWAP_LE32((madr - 4) & 0xffffff);
@@ -115,18 +125,14 @@ void dma6(uint32_t madr, uint32_t bcr, uint32_t chcr) {
             }
             mem++;
             *mem = 0xffffff;
+            PCSX::g_emulator->m_mem->markRAMDirty(madr, size * 4);
         }
         if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                 .get<PCSX::Emulator::DebugSettings::Debug>()) {
             PCSX::g_emulator->m_debug->checkDMAwrite(6, madr, size * 4);
         }
 
-#if 1
-        scheduleGPUOTCDMAIRQ(size);
-#else
-        // Experimental burst dma transfer (0.333x max)
-        scheduleGPUOTCDMAIRQ(size / 3);
-#endif
+        scheduleGPUOTCDMAIRQ(DMACost::otc(size));
         return;
     } else {
         // Unknown option
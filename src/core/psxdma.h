@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "core/psxemulator.h"
+#include "core/psxmem.h"
 #include "core/r3000a.h"
 
 static inline void scheduleGPUDMAIRQ(uint32_t eCycle) {
@@ -42,6 +45,41 @@ static inline void scheduleGPUOTCDMAIRQ(uint32_t eCycle) {
     PCSX::g_emulator->m_cpu->scheduleInterrupt(PCSX::PSXINT_GPUOTCDMA, eCycle);
 }
 
+// How long the transfers of each channel take, in cycles, out of their size in 32 bits words.
+namespace DMACost {
+// Jungle Book - max 0.333x DMA length
+// Harry Potter and the Philosopher's Stone - max 0.5x DMA length
+inline uint32_t spu(uint32_t blocks, uint32_t blockSize) { return blocks * blockSize / 2; }
+// X-Files video interlace. Experimental delay depending of BS.
+inline uint32_t gpuUpload(uint32_t blocks, uint32_t blockSize) { return 7 * blocks; }
+inline uint32_t gpuDownload(uint32_t words) { return words; }
+inline uint32_t otc(uint32_t words) { return words; }
+}  // namespace DMACost
+
+// Block transfers (sync mode 1) move their data a chunk of blocks at a time, each chunk on the event ending
+// the previous one, so that a large transfer gets spread over the time it takes, with the CPU running along,
+// instead of happening all at once. As on the hardware, the progress lives in the registers of the channel:
+// MADR moves forward, and the block count of BCR goes down, which also keeps it in save states.
+// The transfer function gets called with the address and the amount of words of the chunk, and the returned
+// value is how long the chunk takes, or 0 when there's nothing left to move.
+static constexpr uint32_t c_dmaChunkWords = 0x800;
+
+template <unsigned n, typename Transfer>
+uint32_t stepBlockDMA(Transfer &&transfer, uint32_t (*cost)(uint32_t blocks, uint32_t blockSize)) {
+    auto &mem = PCSX::g_emulator->m_mem;
+    const uint32_t bcr = mem->template getBCR<n>();
+    const uint32_t blockSize = bcr & 0xffff;
+    const uint32_t blocks = bcr >> 16;
+    if ((blocks == 0) || (blockSize == 0)) return 0;
+    uint32_t madr = mem->template getMADR<n>();
+    if (!mem->msanInitialized() || !PCSX::Memory::inMsanRange(madr)) madr &= 0x7ffffc;
+    const uint32_t chunk = std::min(blocks, std::max(1u, c_dmaChunkWords / blockSize));
+    transfer(madr, chunk * blockSize);
+    mem->template setMADR<n>(madr + chunk * blockSize * 4);
+    mem->template setBCR<n>(((blocks - chunk) << 16) | blockSize);
+    return std::max(1u, cost(chunk, blockSize));
+}
+
 void dma4(uint32_t madr, uint32_t bcr, uint32_t chcr);
 void dma6(uint32_t madr, uint32_t bcr, uint32_t chcr);
 void spuInterrupt();
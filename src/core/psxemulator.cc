@@ -19,24 +19,41 @@
 
 #include "core/psxemulator.h"
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <unistd.h>
+#endif
+
 #include "core/callstacks.h"
 #include "core/cdrom.h"
+#include "core/cycleaccounting.h"
 #include "core/debug.h"
+#include "core/eventqueue.h"
 #include "core/eventslua.h"
+#include "core/framehashes.h"
+#include "core/framestats.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
 #include "core/gte.h"
+#include "core/guestcoverage.h"
+#include "core/guestprofiler.h"
 #include "core/luaiso.h"
+#include "core/luaworker.h"
 #include "core/mdec.h"
+#include "core/movie.h"
+#include "core/netplay.h"
 #include "core/pad.h"
 #include "core/patchmanager.h"
 #include "core/pcsxlua.h"
 #include "core/pio-cart.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
+#include "core/runahead.h"
 #include "core/sio.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
+#include "core/sstate.h"
+#include "core/tracerecorder.h"
 #include "core/web-server.h"
 #include "gpu/soft/interface.h"
 #include "lua/extra.h"
@@ -48,9 +65,11 @@ extern "C" {
 #include <luv.h>
 }
 #include "spu/interface.h"
+#include "support/uvfile.h"
 #include "supportpsx/adpcmlua.h"
 #include "supportpsx/assembler.h"
 #include "supportpsx/binlua.h"
+#include "tracy/Tracy.hpp"
 
 extern "C" int luaopen_lpeg(lua_State* L);
 
@@ -58,10 +77,16 @@ PCSX::Emulator::Emulator()
     : m_callStacks(new PCSX::CallStacks),
       m_cdrom(PCSX::CDRom::factory()),
       m_counters(new PCSX::Counters()),
+      m_cycleAccounting(new PCSX::CycleAccounting()),
       m_debug(new PCSX::Debug()),
+      m_eventQueue(new PCSX::EventQueue()),
+      m_frameHashes(new PCSX::FrameHashes()),
+      m_frameStats(new PCSX::FrameStats()),
       m_gdbServer(new PCSX::GdbServer()),
       m_gpuLogger(new PCSX::GPULogger()),
       m_gte(new PCSX::GTE()),
+      m_guestCoverage(new PCSX::GuestCoverage()),
+      m_guestProfiler(new PCSX::GuestProfiler()),
       m_hw(new PCSX::HW()),
       m_lua(new PCSX::Lua()),
       m_mdec(new PCSX::MDEC()),
@@ -69,14 +94,20 @@ PCSX::Emulator::Emulator()
       m_pads(PCSX::Pads::factory()),
       m_patchManager(new PatchManager()),
       m_pioCart(new PCSX::PIOCart),
+      m_rewind(new PCSX::Rewind()),
+      m_runAhead(new PCSX::RunAhead()),
+      m_movie(new PCSX::Movie()),
+      m_netplay(new PCSX::Netplay()),
       m_sio(new PCSX::SIO()),
       m_sio1(new PCSX::SIO1()),
       m_sio1Server(new PCSX::SIO1Server()),
       m_sio1Client(new PCSX::SIO1Client()),
       m_spu(new PCSX::SPU::impl()),
+      m_traceRecorder(new PCSX::TraceRecorder()),
       m_webServer(new PCSX::WebServer()) {
     auto L = *m_lua;
     L.openlibs();
+    s_instances.fetch_add(1, std::memory_order_relaxed);
 }
 
 void PCSX::Emulator::setLua() {
@@ -108,6 +139,7 @@ void PCSX::Emulator::setLua() {
     LuaFFI::open_iso(L);
     LuaFFI::open_extra(L);
     LuaBindings::open_events(L);
+    LuaBindings::open_workers(L);
     LuaSupportPSX::open_adpcm(L);
     LuaSupportPSX::open_assembler(L);
     LuaSupportPSX::open_binaries(L);
@@ -137,6 +169,7 @@ void PCSX::Emulator::setLua() {
 PCSX::Emulator::~Emulator() {
     // TODO: move Lua to g_system.
     m_lua->close();
+    s_instances.fetch_sub(1, std::memory_order_relaxed);
 }
 
 int PCSX::Emulator::init() {
@@ -146,7 +179,11 @@ int PCSX::Emulator::init() {
 
     const auto& args = g_system->getArgs();
 
-    m_gpu = settings.get<SettingHardwareRenderer>() ? GPU::getOpenGL() : GPU::getSoft();
+    if (args.isNullGPU()) {
+        m_gpu = GPU::getNull();
+    } else {
+        m_gpu = settings.get<SettingHardwareRenderer>() ? GPU::getOpenGL() : GPU::getSoft();
+    }
 
     setPGXPMode(m_config.PGXP_Mode);
     m_sio->init();
@@ -173,15 +210,109 @@ void PCSX::Emulator::shutdown() {
 }
 
 void PCSX::Emulator::vsync() {
-    m_gpu->vblank();
+#ifdef TRACY_ENABLE
+    const uint64_t cycle = m_cpu->m_regs.cycle;
+    TracyPlot("Emulated cycles/frame", int64_t(cycle - m_lastVSyncCycle));
+    m_lastVSyncCycle = cycle;
+#endif
+    {
+        FrameStats::Scope scope(*m_frameStats, FrameStats::Counter::GPU);
+        m_gpu->captureVSync();
+        m_gpu->pgxpNewFrame();
+        m_gpu->countersVSync();
+        m_gpu->vblank();
+    }
+    // The frames emulated ahead are only there to be presented, once the last of them is done
+    if (m_runAhead->isAhead()) {
+        if (m_runAhead->frameDone()) {
+            g_system->update(true);
+            m_runAhead->finish();
+        }
+        return;
+    }
+    // Frames emulated again after a netplay rollback are in the past already
+    if (!m_netplay->vsync()) return;
+    m_frameStats->vsync();
     g_system->m_eventBus->signal<Events::GPU::VSync>({});
-    g_system->update(true);
+    // Breakpoints could hit while running ahead, so the debugger doesn't get to see these frames at all, and
+    // netplay does its own rolling back
+    const int runAhead = settings.get<SettingDebugSettings>().get<DebugSettings::Debug>() || m_netplay->playing()
+                             ? 0
+                             : std::min(settings.get<SettingRunAhead>().value, int(RunAhead::c_maxFrames));
+    if (runAhead <= 0) g_system->update(true);
 
-    if (m_config.RewindInterval > 0 && !(++m_rewind_counter % m_config.RewindInterval)) {
-        // CreateRewindState();
+    if (settings.get<SettingRewind>() &&
+        !(++m_rewind_counter % std::max(settings.get<SettingRewindInterval>().value, 1))) {
+        m_rewind->setMemoryBudget(size_t(std::max(settings.get<SettingRewindMemoryBudget>().value, 1)) * 1024 * 1024);
+        m_rewind->setKeyframeInterval(std::max(settings.get<SettingRewindKeyframeInterval>().value, 1));
+        m_rewind->capture(SaveStates::save());
     }
+
+    if (runAhead > 0) m_runAhead->start(runAhead);
 }
 
 void PCSX::Emulator::setPGXPMode(uint32_t pgxpMode) { m_cpu->psxSetPGXPMode(pgxpMode); }
 
-PCSX::Emulator* PCSX::g_emulator;
+int PCSX::Emulator::fork() {
+#if defined(_WIN32) || defined(_WIN64)
+    return -1;
+#else
+    // The GUI and its OpenGL context can't be carried over to another process, and neither can the threads
+    // running the other emulators of this one.
+    if (!g_system->getArgs().isHeadless() || (instances() > 1)) return -1;
+
+    // Only the calling thread makes it into the child, so nothing else can be left running, or holding a lock.
+    m_gpu->prepareFork();
+    m_spu->prepareFork();
+    m_rewind->prepareFork();
+    m_traceRecorder->prepareFork();
+    m_sio->prepareFork();
+    m_cdrom->getIso()->stopReadAhead();
+    UvThreadOp::prepareFork();
+    fflush(nullptr);
+
+    const pid_t pid = ::fork();
+    const bool child = pid == 0;
+    if (child) {
+        uv_loop_fork(g_system->getLoop());
+        // Everything else is copy-on-write already, but RAM is in a shared memory segment.
+        if (!m_mem->unshareRAM()) {
+            g_system->printf(_("Forked emulator couldn't get a copy of RAM of its own\n"));
+            _Exit(-1);
+        }
+        m_isFork = true;
+    }
+
+    UvThreadOp::afterFork();
+    m_traceRecorder->afterFork(child);
+    m_rewind->afterFork(child);
+    m_spu->afterFork(child);
+    m_gpu->afterFork();
+
+    if (child) {
+        // The listening sockets are the parent's.
+        if (m_webServer->getServerStatus() == WebServer::SERVER_STARTED) m_webServer->stopServer();
+        if (m_gdbServer->getServerStatus() == GdbServer::SERVER_STARTED) m_gdbServer->stopServer();
+        if (m_sio1Server->getServerStatus() == SIO1Server::SIO1ServerStatus::SERVER_STARTED) {
+            m_sio1Server->stopServer();
+        }
+        settings.get<SettingRewind>().value = false;
+    }
+    return pid;
+#endif
+}
+
+std::atomic<unsigned> PCSX::Emulator::s_instances = 0;
+thread_local PCSX::Emulator* PCSX::g_emulator;
+
+PCSX::EmulatorContext PCSX::EmulatorContext::current() { return {g_system, g_emulator}; }
+
+PCSX::EmulatorContext::Scope::Scope(const EmulatorContext& context) : m_previous(current()) {
+    g_system = context.system;
+    g_emulator = context.emulator;
+}
+
+PCSX::EmulatorContext::Scope::~Scope() {
+    g_system = m_previous.system;
+    g_emulator = m_previous.emulator;
+}
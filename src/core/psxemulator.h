@@ -40,6 +40,7 @@
 #include <time.h>
 #include <zlib.h>
 
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -69,11 +70,17 @@ namespace PCSX {
 class CallStacks;
 class CDRom;
 class Counters;
+class CycleAccounting;
 class Debug;
+class EventQueue;
+class FrameHashes;
+class FrameStats;
 class GdbServer;
 class GPU;
 class GPULogger;
 class GTE;
+class GuestCoverage;
+class GuestProfiler;
 class HW;
 class Lua;
 class MDEC;
@@ -81,9 +88,14 @@ class Memory;
 class Pads;
 class PatchManager;
 class R3000Acpu;
+class Rewind;
+class RunAhead;
+class Movie;
+class Netplay;
 class SIO;
 class SPUInterface;
 class System;
+class TraceRecorder;
 class WebServer;
 class SIO1;
 class SIO1Server;
@@ -91,7 +103,32 @@ class SIO1Client;
 class PIOCart;
 
 class Emulator;
-extern Emulator* g_emulator;
+extern thread_local Emulator* g_emulator;
+
+// The emulator a thread is working on, along with its system object. Each emulator in the process is only ever
+// worked on by one thread at a time, which may change from one step to the next; the threads an emulator starts
+// of its own, such as the GPU command thread or the SPU mixer, get to inherit its context.
+struct EmulatorContext {
+    System* system = nullptr;
+    Emulator* emulator = nullptr;
+
+    static EmulatorContext current();
+
+    // Switches the calling thread over to another emulator, and back when going out of scope.
+    class Scope;
+};
+
+// Defined out of line, as the context it saves needs to be a complete type.
+class EmulatorContext::Scope {
+  public:
+    explicit Scope(const EmulatorContext& context);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    EmulatorContext m_previous;
+};
 
 class Emulator {
   public:
@@ -143,12 +180,15 @@ class Emulator {
             Raw,
         };
         typedef Setting<SIO1Mode, TYPESTRING("SIO1Mode"), SIO1Mode::Protobuf> SIO1ModeSetting;
+        typedef Setting<bool, TYPESTRING("SIO1Batching"), false> SIO1Batching;
+        // In microseconds of emulated time
+        typedef Setting<int, TYPESTRING("SIO1BatchLatency"), 500> SIO1BatchLatency;
         typedef Settings<Debug, Trace, KernelLog, FirstChanceException, SkipISR, LoggingCDROM, GdbServer, GdbManifest,
                          GdbLogSetting, GdbServerPort, GdbServerTrace, WebServer, WebServerPort, KernelCallA0_00_1f,
                          KernelCallA0_20_3f, KernelCallA0_40_5f, KernelCallA0_60_7f, KernelCallA0_80_9f,
                          KernelCallA0_a0_bf, KernelCallB0_00_1f, KernelCallB0_20_3f, KernelCallB0_40_5f,
                          KernelCallC0_00_1f, PCdrv, PCdrvBase, SIO1Server, SIO1ServerPort, SIO1Client, SIO1ClientHost,
-                         SIO1ClientPort, SIO1ModeSetting>
+                         SIO1ClientPort, SIO1ModeSetting, SIO1Batching, SIO1BatchLatency>
             type;
     };
     typedef SettingNested<TYPESTRING("Debug"), DebugSettings::type> SettingDebugSettings;
@@ -171,16 +211,28 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("Mcd2Inserted"), true> SettingMcd2Inserted;
     typedef Setting<bool, TYPESTRING("Dynarec"), true> SettingDynarec;
     typedef Setting<bool, TYPESTRING("8Megs"), false> Setting8MB;
+    typedef Setting<bool, TYPESTRING("LargePages"), false> SettingLargePages;
+    typedef SettingPath<TYPESTRING("DynarecBlockHints")> SettingDynarecBlockHints;
+    // Whether the dynarec emits the common GTE commands itself, and skips computing the FLAG nobody reads
+    typedef Setting<bool, TYPESTRING("DynarecNativeGTE"), false> SettingDynarecNativeGTE;
+    typedef Setting<bool, TYPESTRING("DynarecGTEFlagElision"), false> SettingDynarecGTEFlagElision;
     typedef Setting<int, TYPESTRING("GUITheme"), 0> SettingGUITheme;
     typedef Setting<int, TYPESTRING("Dither"), 1> SettingDither;
-    typedef Setting<bool, TYPESTRING("UseCachedDithering"), false> SettingCachedDithering;
+    typedef Setting<bool, TYPESTRING("UseCachedDithering"), true> SettingCachedDithering;
+    typedef Setting<int, TYPESTRING("SoftGPUThreads"), 0> SettingSoftGPUThreads;
+    typedef Setting<bool, TYPESTRING("ThreadedGPU"), false> SettingThreadedGPU;
     typedef Setting<bool, TYPESTRING("ReportGLErrors"), false> SettingGLErrorReporting;
     typedef Setting<int, TYPESTRING("ReportGLErrorsSeverity"), 1> SettingGLErrorReportingSeverity;
     typedef Setting<bool, TYPESTRING("FullCaching"), false> SettingFullCaching;
+    typedef Setting<bool, TYPESTRING("ShareCachedFiles"), false> SettingShareCachedFiles;
     typedef Setting<bool, TYPESTRING("HardwareRenderer"), false> SettingHardwareRenderer;
     typedef Setting<bool, TYPESTRING("ShownAutoUpdateConfig"), false> SettingShownAutoUpdateConfig;
     typedef Setting<bool, TYPESTRING("AutoUpdate"), false> SettingAutoUpdate;
     typedef Setting<int, TYPESTRING("MSAA"), 1> SettingMSAA;
+    typedef Setting<int, TYPESTRING("InternalResolution"), 1> SettingInternalResolution;
+    typedef Setting<bool, TYPESTRING("TexturePageCache"), false> SettingTexturePageCache;
+    typedef Setting<bool, TYPESTRING("IdleSkipping"), false> SettingIdleSkipping;
+    typedef Setting<bool, TYPESTRING("BiosHLE"), false> SettingBiosHLE;
     typedef Setting<bool, TYPESTRING("LinearFiltering"), true> SettingLinearFiltering;
     typedef Setting<bool, TYPESTRING("KioskMode"), false> SettingKioskMode;
     typedef Setting<bool, TYPESTRING("Mcd1Pocketstation"), false> SettingMcd1Pocketstation;
@@ -191,6 +243,21 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("PIOConnected")> SettingPIOConnected;
     typedef SettingPath<TYPESTRING("MapBrowsePath")> SettingMapBrowsePath;
     typedef SettingVector<std::string, TYPESTRING("OpenDialogFavorites")> SettingOpenDialogFavorites;
+    typedef Setting<bool, TYPESTRING("Rewind"), false> SettingRewind;
+    // In frames
+    typedef Setting<int, TYPESTRING("RewindInterval"), 10> SettingRewindInterval;
+    // In snapshots
+    typedef Setting<int, TYPESTRING("RewindKeyframeInterval"), 30> SettingRewindKeyframeInterval;
+    // In megabytes
+    typedef Setting<int, TYPESTRING("RewindMemoryBudget"), 256> SettingRewindMemoryBudget;
+    // In frames, 0 being off
+    typedef Setting<int, TYPESTRING("RunAhead"), 0> SettingRunAhead;
+    typedef Setting<bool, TYPESTRING("RunAheadOverlay"), false> SettingRunAheadOverlay;
+    typedef Setting<bool, TYPESTRING("PerformanceOverlay"), false> SettingPerformanceOverlay;
+    // How many times faster than the drive's own speed the data reads and seeks go, 1 being off
+    typedef Setting<int, TYPESTRING("FastCDSpeed"), 1> SettingFastCDSpeed;
+    // The IDs of the discs which keep the drive's own speed regardless
+    typedef SettingVector<std::string, TYPESTRING("FastCDExclusions")> SettingFastCDExclusions;
 
     Settings<SettingMcd1, SettingMcd2, SettingBios, SettingPpfDir, SettingPsxExe, SettingXa, SettingSpuIrq,
              SettingBnWMdec, SettingScaler, SettingAutoVideo, SettingVideo, SettingFastBoot, SettingDebugSettings,
@@ -199,7 +266,12 @@ class Emulator {
              SettingGLErrorReportingSeverity, SettingFullCaching, SettingHardwareRenderer, SettingShownAutoUpdateConfig,
              SettingAutoUpdate, SettingMSAA, SettingLinearFiltering, SettingKioskMode, SettingMcd1Pocketstation,
              SettingMcd2Pocketstation, SettingBiosBrowsePath, SettingEXP1Filepath, SettingEXP1BrowsePath,
-             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites>
+             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites, SettingDynarecBlockHints,
+             SettingSoftGPUThreads, SettingThreadedGPU, SettingRewind, SettingRewindInterval,
+             SettingRewindKeyframeInterval, SettingRewindMemoryBudget, SettingRunAhead, SettingRunAheadOverlay,
+             SettingPerformanceOverlay, SettingInternalResolution, SettingTexturePageCache,
+             SettingIdleSkipping, SettingBiosHLE, SettingLargePages, SettingFastCDSpeed, SettingFastCDExclusions,
+             SettingShareCachedFiles, SettingDynarecNativeGTE, SettingDynarecGTEFlagElision>
         settings;
     class PcsxConfig {
       public:
@@ -209,8 +281,6 @@ class Emulator {
         bool HideCursor = false;
         bool SaveWindowPos = false;
         int32_t WindowPos[2] = {0, 0};
-        uint32_t RewindCount = 0;
-        uint32_t RewindInterval = 0;
         uint32_t AltSpeed1 = 0;  // Percent relative to natural speed.
         uint32_t AltSpeed2 = 0;
         bool OverClock = false;  // enable overclocking
@@ -224,6 +294,8 @@ class Emulator {
 
     // It is safe if these overflow
     uint32_t m_rewind_counter = 0;
+    // Where the CPU was at the previous vsync, for the profiler
+    uint64_t m_lastVSyncCycle = 0;
 
     // Used for overclocking
     // Make the timing events trigger faster as we are currently assuming everything
@@ -247,6 +319,14 @@ class Emulator {
     void shutdown();
     void vsync();
     void setPGXPMode(uint32_t pgxpMode);
+    // Clones the running emulator into a new process, which carries on from the very same point. Both share
+    // their memory copy-on-write, so a branch only costs setting up page tables, instead of a save state.
+    // Returns the child's pid to the parent, 0 to the child, and -1 if forking failed or isn't possible: this
+    // only works for a headless emulator, on POSIX systems. Memory cards are only ever written by the parent.
+    int fork();
+    bool isFork() const { return m_isFork; }
+    // How many emulators are alive in this process.
+    static unsigned instances() { return s_instances.load(std::memory_order_relaxed); }
 
     void setLua();
 
@@ -255,11 +335,17 @@ class Emulator {
     std::unique_ptr<CallStacks> m_callStacks;
     std::unique_ptr<CDRom> m_cdrom;
     std::unique_ptr<Counters> m_counters;
+    std::unique_ptr<CycleAccounting> m_cycleAccounting;
     std::unique_ptr<Debug> m_debug;
+    std::unique_ptr<EventQueue> m_eventQueue;
+    std::unique_ptr<FrameHashes> m_frameHashes;
+    std::unique_ptr<FrameStats> m_frameStats;
     std::unique_ptr<GdbServer> m_gdbServer;
     std::unique_ptr<GPU> m_gpu;
     std::unique_ptr<GPULogger> m_gpuLogger;
     std::unique_ptr<GTE> m_gte;
+    std::unique_ptr<GuestCoverage> m_guestCoverage;
+    std::unique_ptr<GuestProfiler> m_guestProfiler;
     std::unique_ptr<HW> m_hw;
     std::unique_ptr<Lua> m_lua;
     std::unique_ptr<MDEC> m_mdec;
@@ -268,15 +354,22 @@ class Emulator {
     std::unique_ptr<PatchManager> m_patchManager;
     std::unique_ptr<PIOCart> m_pioCart;
     std::unique_ptr<R3000Acpu> m_cpu;
+    std::unique_ptr<Rewind> m_rewind;
+    std::unique_ptr<RunAhead> m_runAhead;
+    std::unique_ptr<Movie> m_movie;
+    std::unique_ptr<Netplay> m_netplay;
     std::unique_ptr<SIO> m_sio;
     std::unique_ptr<SIO1> m_sio1;
     std::unique_ptr<SIO1Server> m_sio1Server;
     std::unique_ptr<SIO1Client> m_sio1Client;
     std::unique_ptr<SPUInterface> m_spu;
+    std::unique_ptr<TraceRecorder> m_traceRecorder;
     std::unique_ptr<WebServer> m_webServer;
 
   private:
     PcsxConfig m_config;
+    bool m_isFork = false;
+    static std::atomic<unsigned> s_instances;
 };
 
 }  // namespace PCSX
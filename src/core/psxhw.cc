@@ -23,6 +23,7 @@
 
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
 #include "core/logger.h"
 #include "core/mdec.h"
@@ -33,6 +34,7 @@
 #include "lua/luawrapper.h"
 #include "spu/interface.h"
 #include "supportpsx/memory.h"
+#include "tracy/Tracy.hpp"
 
 static constexpr bool between(uint32_t val, uint32_t beg, uint32_t end) {
     return (beg > end) ? false : (val >= beg && val <= end - 3);
@@ -466,6 +468,7 @@ void PCSX::HW::write8(uint32_t add, uint32_t rawvalue) {
                 L.gettable();
                 if (L.isfunction()) {
                     try {
+                        FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
                         L.pcall();
                     } catch (...) {
                     }
@@ -626,18 +629,25 @@ void PCSX::HW::write16(uint32_t add, uint32_t rawvalue) {
 }
 
 inline void PCSX::HW::dma0(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    ZoneScopedN("DMA0 MDEC in");
     PSXDMA_LOG("*** DMA0 MDEC *** %x addr = %x size = %x\n", chcr, madr, bcr);
     g_emulator->m_mdec->dma0(madr, bcr, chcr);
 }
 
 inline void PCSX::HW::dma1(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    ZoneScopedN("DMA1 MDEC out");
     PSXDMA_LOG("*** DMA1 MDEC *** %x addr = %x size = %x\n", chcr, madr, bcr);
     g_emulator->m_mdec->dma1(madr, bcr, chcr);
 }
 
-inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) { g_emulator->m_gpu->dma(madr, bcr, chcr); }
+inline void PCSX::HW::dma2(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    ZoneScopedN("DMA2 GPU");
+    FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::GPU);
+    g_emulator->m_gpu->dma(madr, bcr, chcr);
+}
 
 inline void PCSX::HW::dma3(uint32_t madr, uint32_t bcr, uint32_t chcr) {
+    ZoneScopedN("DMA3 CD-ROM");
     PSXDMA_LOG("*** DMA3 CDROM *** %x addr = %x size = %x\n", chcr, madr, bcr);
     g_emulator->m_cdrom->dma(madr, bcr, chcr);
 }
@@ -57,6 +57,8 @@ class HW {
             }
             uint32_t bcr = mem->template getBCR<n>();
             uint32_t mode = (chcr & 0x00000600) >> 9;
+            // These advance MADR and BCR themselves as their chunks go, see stepBlockDMA
+            const bool stepped = ((n == 2) && (chcr == 0x01000201)) || ((n == 4) && ((chcr & ~1) == 0x01000200));
             if constexpr (n == 0) {
                 dma0(madr, bcr, chcr);
             } else if constexpr (n == 1) {
@@ -70,6 +72,7 @@ class HW {
             } else if constexpr (n == 6) {
                 dma6(madr, bcr, chcr);
             }
+            if (stepped) return;
             if (mode == 2) {
                 uint32_t usedAddr[3] = {0xffffff, 0xffffff, 0xffffff};
                 uint32_t DMACommandCounter = 0;
@@ -18,14 +18,17 @@
  ***************************************************************************/
 
 #include "core/callstacks.h"
+#include "core/cycleaccounting.h"
 #include "core/debug.h"
 #include "core/disr3000a.h"
 #include "core/gte.h"
+#include "core/guestcoverage.h"
 #include "core/pgxp_cpu.h"
 #include "core/pgxp_debug.h"
 #include "core/pgxp_gte.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
+#include "core/tracerecorder.h"
 #include "tracy/Tracy.hpp"
 
 #undef _PC_
@@ -94,6 +97,10 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     virtual void Shutdown() override;
     virtual void SetPGXPMode(uint32_t pgxpMode) override;
     virtual bool isDynarec() override { return false; }
+    virtual void invalidateCache() override {
+        R3000Acpu::invalidateCache();
+        invalidateDecodedCache();
+    }
     void maybeCancelDelayedLoad(uint32_t index) {
         unsigned other = m_currentDelayedLoad ^ 1;
         if (m_delayedLoadInfo[other].index == index) m_delayedLoadInfo[other].active = false;
@@ -101,6 +108,7 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     // For the GUI dynarec disassembly widget
     virtual const uint8_t *getBufferPtr() final { return nullptr; }
     virtual const size_t getBufferSize() final { return 0; }
+    virtual const size_t getBufferCapacity() final { return 0; }
 
     void psxTestSWInts();
 
@@ -114,8 +122,36 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     cIntFunc_t *s_pPsxCP2 = NULL;
     cIntFunc_t *s_pPsxCP2BSC = NULL;
 
-    template <bool debug, bool trace>
+    // Decoded instruction cache, shadowing the emulated instruction cache slot for slot. Each entry holds
+    // the leaf handler for the opcode, with the SPECIAL / REGIMM / COP0 sub-tables already resolved, so
+    // that a cache hit skips both the fetch and the secondary dispatch. An entry is only trusted while the
+    // emulated cache line still holds the same address and opcode it was decoded from; flushICacheLine,
+    // Clear and invalidateCache drop entries eagerly, and changing the PGXP mode goes through Reset.
+    struct DecodedOp {
+        intFunc_t func = nullptr;
+        uint32_t code = 0;
+        uint32_t tag = 0xffffffff;
+    };
+    DecodedOp m_decoded[0x1000 / 4];
+    void invalidateDecodedCache() {
+        for (auto &op : m_decoded) op = DecodedOp{};
+    }
+    void invalidateDecodedLine(uint32_t pc) {
+        DecodedOp *line = m_decoded + ((pc & 0xff0) >> 2);
+        for (unsigned i = 0; i < 4; i++) line[i] = DecodedOp{};
+    }
+    intFunc_t decode(uint32_t code) const {
+        intFunc_t func = s_pPsxBSC[code >> 26];
+        if (func == &InterpretedCPU::psxSPECIAL) return s_pPsxSPC[_Funct_];
+        if (func == &InterpretedCPU::psxREGIMM) return s_pPsxREG[_Rt_];
+        if (func == &InterpretedCPU::psxCOP0) return s_pPsxCP0[_Rs_];
+        return func;
+    }
+    intFunc_t fetchDecoded(uint32_t pc, uint32_t &code);
+
+    template <bool debug, bool trace, bool account = false>
     void execBlock();
+    void runUntilNextEvent();
     void doBranch(uint32_t target, bool fromLink);
 
     void MTC0(int reg, uint32_t val);
@@ -1575,39 +1611,90 @@ void InterpretedCPU::Reset() {
 }
 void InterpretedCPU::Execute() {
     ZoneScoped;
+    // The settings objects are stable for the lifetime of the emulator, so bind to the
+    // underlying values once, instead of walking the settings tree on every block.
+    auto &debugSettings = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>();
+    const bool &debug = debugSettings.get<PCSX::Emulator::DebugSettings::Debug>().value;
+    const bool &traceSetting = debugSettings.get<PCSX::Emulator::DebugSettings::Trace>().value;
+    const bool &skipISR = debugSettings.get<PCSX::Emulator::DebugSettings::SkipISR>().value;
+    auto &cycleAccounting = PCSX::g_emulator->m_cycleAccounting;
+    auto &traceRecorder = PCSX::g_emulator->m_traceRecorder;
     while (hasToRun()) {
-        const bool &debug = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
-                                .get<PCSX::Emulator::DebugSettings::Debug>();
-        const bool &trace = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
-                                .get<PCSX::Emulator::DebugSettings::Trace>();
-        const bool &skipISR = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
-                                  .get<PCSX::Emulator::DebugSettings::SkipISR>();
-        if (debug) {
+        // Recording a binary trace goes through the same path as the text one, minus the formatting.
+        const bool trace = traceSetting || traceRecorder->recording();
+        if (cycleAccounting->enabled()) [[unlikely]] {
+            if (debug) {
+                execBlock<true, false, true>();
+            } else {
+                execBlock<false, false, true>();
+            }
+        } else if (debug) {
             if (!trace || (skipISR && m_inISR)) {
                 execBlock<true, false>();
             } else {
                 execBlock<true, true>();
             }
+        } else if (!trace) {
+            runUntilNextEvent();
+        } else if (skipISR && m_inISR) {
+            execBlock<false, false>();
         } else {
-            if (!trace || (skipISR && m_inISR)) {
-                execBlock<false, false>();
-            } else {
-                execBlock<false, true>();
-            }
+            execBlock<false, true>();
         }
     }
 }
 
+// Nothing outside of the CPU can flip the debug settings or the running state while
+// we are between two root counter deadlines, since the UI only gets to run from the
+// vsync handler. The plain execution mode can therefore chain blocks back to back
+// until then, and only return to the outer loop once something may have changed.
+void InterpretedCPU::runUntilNextEvent() {
+    const uint64_t deadline = PCSX::g_emulator->m_counters->m_psxNextCounter;
+    do {
+        execBlock<false, false>();
+    } while ((m_regs.cycle < deadline) && hasToRun());
+}
+
 void InterpretedCPU::Clear(uint32_t Addr, uint32_t Size) {
     for (auto i = 0; i < Size; i += 4) {
         flushICacheLine(Addr);
+        invalidateDecodedLine(Addr);
         Addr += 16;
     }
 }
 
+inline InterpretedCPU::intFunc_t InterpretedCPU::fetchDecoded(uint32_t pc, uint32_t &code) {
+    if (!isICached(pc)) {
+        code = readICache(pc);
+        return decode(code);
+    }
+
+    // The decoded entry rides on the emulated cache line: it's good as long as the line still holds the
+    // address and the opcode it got decoded from.
+    const uint32_t tag = iCacheTag(pc);
+    ICacheLine &line = iCacheLine(pc);
+    DecodedOp &op = m_decoded[(pc & 0xfff) >> 2];
+    if ((line.tag == tag) && (op.tag == tag)) [[likely]] {
+        code = line.words[(pc >> 2) & 3];
+        if (code == op.code) [[likely]] {
+            return op.func;
+        }
+    }
+
+    // Either the emulated cache is about to refill this line, or our entry is stale. The refill
+    // replaces all four words, so the whole decoded line has to go.
+    if (line.tag != tag) invalidateDecodedLine(pc);
+    code = readICache(pc);
+    intFunc_t func = decode(code);
+    op.func = func;
+    op.code = code;
+    op.tag = tag;
+    return func;
+}
+
 void InterpretedCPU::Shutdown() {}
 // interpreter execution
-template <bool debug, bool trace>
+template <bool debug, bool trace, bool account>
 inline void InterpretedCPU::execBlock() {
     bool ranDelaySlot = false;
     do {
@@ -1618,23 +1705,35 @@ inline void InterpretedCPU::execBlock() {
         // TODO: throw an exception here if pc is out of range
         const uint32_t pc = m_regs.pc;
         // TODO: throw an exception here if we don't have a pointer
-        uint32_t code = readICache(pc);
+        uint32_t code;
+        cIntFunc_t func = fetchDecoded(pc, code);
 
         m_regs.code = code;
+        PCSX::g_emulator->m_guestCoverage->mark(pc);
 
         if constexpr (trace) {
-            std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
-            PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            auto &recorder = PCSX::g_emulator->m_traceRecorder;
+            if (recorder->recording()) {
+                recorder->begin(pc, code, m_regs.GPR.r, PCSX::g_emulator->m_mem.get());
+            } else {
+                std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
+                PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            }
         }
 
+        if constexpr (account) PCSX::g_emulator->m_cycleAccounting->account(pc, code, m_regs.GPR.r);
+
         m_regs.pc += 4;
         m_regs.cycle += PCSX::Emulator::BIAS;
 
-        cIntFunc_t func = s_pPsxBSC[code >> 26];
         (*this.*func)(code);
 
         m_currentDelayedLoad ^= 1;
         flushCurrentDelayedLoad();
+        if constexpr (trace) {
+            auto &recorder = PCSX::g_emulator->m_traceRecorder;
+            if (recorder->recording()) recorder->end(m_regs.GPR.r);
+        }
         auto &delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
         bool fromLink = false;
         if (delayedLoad.pcActive) {
@@ -1646,7 +1745,17 @@ inline void InterpretedCPU::execBlock() {
         if (m_inDelaySlot) {
             m_inDelaySlot = false;
             ranDelaySlot = true;
+            if constexpr (account) PCSX::g_emulator->m_cycleAccounting->endBlock();
             InterceptBIOS<true>(m_regs.pc);
+            if constexpr (!debug && !trace && !account) {
+                // A short branch back, taken: this might be an idle loop.
+                const uint32_t target = m_regs.pc;
+                if ((target < pc) && ((pc - target) < 32) &&
+                    PCSX::g_emulator->settings.get<PCSX::Emulator::SettingIdleSkipping>() &&
+                    isIdleLoop(target, pc - 4)) {
+                    skipIdleLoop();
+                }
+            }
             branchTest();
         }
         if constexpr (debug) {
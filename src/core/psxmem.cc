@@ -19,16 +19,19 @@
 
 #include "core/psxmem.h"
 
-#include <zlib.h>
-
+#include <algorithm>
 #include <map>
+#include <mutex>
 #include <string_view>
+#include <vector>
 
+#include "core/framestats.h"
 #include "core/pio-cart.h"
 #include "core/psxhw.h"
 #include "core/r3000a.h"
 #include "mips/common/util/encoder.hh"
 #include "support/file.h"
+#include "support/hashing.h"
 #include "supportpsx/binloader.h"
 
 static const std::map<uint32_t, std::string_view> s_knownBioses = {
@@ -88,30 +91,58 @@ static const std::map<uint32_t, std::string_view> s_knownBioses = {
 PCSX::Memory::Memory() : m_listener(g_system->m_eventBus) {
     m_listener.listen<Events::ExecutionFlow::Reset>([this](auto &) {
         free(m_msanRAM);
-        free(m_msanUsableBitmap);
-        free(m_msanInitializedBitmap);
+        free(m_msanShadow);
         m_msanRAM = nullptr;
-        m_msanUsableBitmap = nullptr;
-        m_msanInitializedBitmap = nullptr;
+        m_msanShadow = nullptr;
         m_msanAllocs.clear();
     });
 }
 
+// The "wram" names in use by the emulators of this process, so that they can be given back.
+static std::mutex s_wramNamesMutex;
+static std::vector<bool> s_wramNames;
+
+std::string PCSX::Memory::WramName::claim() {
+    std::unique_lock<std::mutex> lock(s_wramNamesMutex);
+    if (m_index < 0) {
+        auto free = std::find(s_wramNames.begin(), s_wramNames.end(), false);
+        m_index = static_cast<int>(free - s_wramNames.begin());
+        if (free == s_wramNames.end()) {
+            s_wramNames.push_back(true);
+        } else {
+            *free = true;
+        }
+    }
+    return m_index == 0 ? "wram" : "wram-" + std::to_string(m_index);
+}
+
+PCSX::Memory::WramName::~WramName() {
+    if (m_index < 0) return;
+    std::unique_lock<std::mutex> lock(s_wramNamesMutex);
+    s_wramNames[m_index] = false;
+}
+
 int PCSX::Memory::init() {
     m_readLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
     m_writeLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
+    m_regionLUT = (const RegionLeaves **)calloc(0x10000, sizeof(void *));
 
-    // Init all memory as named mappings
-    bool success = m_wramShared.init("wram", 0x00800000, true);
+    // Init all memory as named mappings. The first emulator of the process gets the name external tools look for,
+    // and any other one running alongside gets a number.
+    const std::string id = m_wramName.claim();
+    const bool largePages = g_emulator->settings.get<Emulator::SettingLargePages>();
+    bool success = m_wramShared.init(id.c_str(), c_ramSize, true, largePages);
     if (!success) g_system->message(_("SharedMem failed to share memory for wram, falling back to memory alloc\n"));
+    if (largePages) g_system->printf(_("Main RAM is using %s\n"), SharedMem::describe(m_wramShared.pages()));
     m_wram = m_wramShared.getPtr();
 
     m_exp1 = (uint8_t *)calloc(0x00800000, 1);
     m_hard = (uint8_t *)calloc(0x00010000, 1);
-    m_bios = (uint8_t *)calloc(0x00080000, 1);
+    m_biosMemory.init(nullptr, 0x00080000, true);
+    m_bios = m_biosMemory.getPtr();
 
-    if (m_readLUT == NULL || m_writeLUT == NULL || m_wram == NULL || m_exp1 == NULL || m_bios == NULL ||
-        m_hard == NULL) {
+    if (m_readLUT == NULL || m_writeLUT == NULL || m_regionLUT == NULL || m_wram == NULL || m_exp1 == NULL ||
+        m_bios == NULL || m_hard == NULL) {
         g_system->message("%s", _("Error allocating memory!"));
         return -1;
     }
@@ -130,6 +161,7 @@ int PCSX::Memory::init() {
     memcpy(m_readLUT + 0xbfc0, m_readLUT + 0x1fc0, 0x08 * sizeof(void *));
 
     setLuts();
+    setRegionLuts();
 
     m_memoryAsFile = new MemoryAsFile(this);
 
@@ -171,7 +203,8 @@ bool PCSX::Memory::loadEXP1FromFile(std::filesystem::path rom_path) {
 void PCSX::Memory::reset() {
     const uint32_t bios_size = 0x00080000;
     const uint32_t exp1_size = 0x00040000;
-    memset(m_wram, 0, 0x00800000);
+    memset(m_wram, 0, c_ramSize);
+    m_dirtyRAM.markAll();
     memset(m_exp1, 0xff, exp1_size);
     memset(m_bios, 0, bios_size);
     static const uint32_t nobios[6] = {
@@ -201,8 +234,7 @@ Set a BIOS file into the configuration, and do a hard reset of the emulator.
 The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
 )"));
 
-    uint32_t nobioscrc = crc32(0L, Z_NULL, 0);
-    nobioscrc = crc32(nobioscrc, m_bios, bios_size);
+    uint32_t nobioscrc = Hashing::crc32(0, m_bios, bios_size);
 
     // Load BIOS
     {
@@ -233,6 +265,7 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
                 f->rSeek(0);
                 f->read(m_bios, bios_size);
             }
+            g_emulator->m_cpu->symbolsChanged();
             f->close();
             g_system->printf(_("Loaded BIOS: %s\n"), biosPath.string());
         }
@@ -242,8 +275,8 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
         loadEXP1FromFile(g_emulator->settings.get<Emulator::SettingEXP1Filepath>().value);
     }
 
-    uint32_t crc = crc32(0L, Z_NULL, 0);
-    m_biosCRC = crc = crc32(crc, m_bios, bios_size);
+    uint32_t crc = Hashing::crc32(0, m_bios, bios_size);
+    m_biosCRC = crc;
     auto it = s_knownBioses.find(crc);
     if (it != s_knownBioses.end()) {
         g_system->printf(_("Known BIOS detected: %s (%08x)\n"), it->second, crc);
@@ -252,23 +285,36 @@ The distributed OpenBIOS.bin file can be an appropriate BIOS replacement.
     } else if (crc != nobioscrc) {
         g_system->printf(_("Unknown bios loaded (%08x)\n"), crc);
     }
+    shareBios();
     m_BIU = 0;
 }
 
+// All of the emulators of the host running the same BIOS share its pages, until one of them writes into them.
+void PCSX::Memory::shareBios() {
+    const uint32_t bios_size = 0x00080000;
+    const std::string key = fmt::format("bios-{:016x}", Hashing::xxh64(m_bios, bios_size));
+    auto shared = std::make_unique<SharedMem>();
+    if (!shared->initPublished(key, bios_size)) {
+        memcpy(shared->getPtr(), m_bios, bios_size);
+        shared->publish();
+    } else if (memcmp(shared->getPtr(), m_bios, bios_size) != 0) {
+        return;
+    }
+    if (m_biosMemory.mapCopyOnWrite(*shared)) m_biosShared = std::move(shared);
+}
+
 void PCSX::Memory::shutdown() {
     free(m_exp1);
     free(m_hard);
-    free(m_bios);
 
     free(m_readLUT);
     free(m_writeLUT);
+    free(m_regionLUT);
 
     free(m_msanRAM);
-    free(m_msanUsableBitmap);
-    free(m_msanInitializedBitmap);
+    free(m_msanShadow);
     m_msanRAM = nullptr;
-    m_msanUsableBitmap = nullptr;
-    m_msanInitializedBitmap = nullptr;
+    m_msanShadow = nullptr;
     m_msanAllocs.clear();
 }
 
@@ -297,15 +343,22 @@ uint8_t PCSX::Memory::read8(uint32_t address) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         return *(pointer + offset);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            return m_hard[address & 0x3ff];
-        } else {
+    }
+
+    switch (classifySlowAccess(address, false)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) return m_hard[address & 0x3ff];
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             return g_emulator->m_hw->read8(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
-    } else if (sendReadToLua(address, 1)) {
+        case Region::EXP1:
+            if (pioConnected) return g_emulator->m_pioCart->read8(address);
+            break;
+        default:
+            break;
+    }
+
+    if (sendReadToLua(address, 1)) {
         auto L = *g_emulator->m_lua;
         const uint8_t ret = L.tonumber();
         L.pop();
@@ -348,16 +401,22 @@ uint16_t PCSX::Memory::read16(uint32_t address) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         return SWAP_LEu16(*(uint16_t *)(pointer + offset));
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
-            return SWAP_LEu16(*ptr);
-        } else {
+    }
+
+    switch (classifySlowAccess(address, false)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) return SWAP_LEu16(*(uint16_t *)&m_hard[address & 0x3ff]);
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             return g_emulator->m_hw->read16(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
-    } else if (sendReadToLua(address, 2)) {
+        case Region::EXP1:
+            if (pioConnected) return g_emulator->m_pioCart->read8(address);
+            break;
+        default:
+            break;
+    }
+
+    if (sendReadToLua(address, 2)) {
         auto L = *g_emulator->m_lua;
         const uint16_t ret = L.tonumber();
         L.pop();
@@ -396,16 +455,22 @@ uint32_t PCSX::Memory::read32(uint32_t address, ReadType readType) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         return SWAP_LEu32(*(uint32_t *)(pointer + offset));
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
-            return SWAP_LEu32(*ptr);
-        } else {
+    }
+
+    switch (classifySlowAccess(address, false)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) return SWAP_LEu32(*(uint32_t *)&m_hard[address & 0x3ff]);
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             return g_emulator->m_hw->read32(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read32(address);
-    } else if (address == 0xfffe0130) {
+        case Region::EXP1:
+            if (pioConnected) return g_emulator->m_pioCart->read32(address);
+            break;
+        default:
+            break;
+    }
+
+    if (address == 0xfffe0130) {
         return m_BIU;
     } else if (sendReadToLua(address, 4)) {
         auto L = *g_emulator->m_lua;
@@ -436,6 +501,7 @@ int PCSX::Memory::sendReadToLua(const uint32_t address, const size_t size) {
             const int top = L.gettop();
             L.push(lua_Number(address));
             L.push(lua_Number(size));
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
             nresult = L.pcall(2);
             // Discard anything more than 1 result
             for (int n = 1; n < nresult; n++) {
@@ -471,6 +537,7 @@ bool PCSX::Memory::sendWriteToLua(const uint32_t address, const size_t size, uin
             L.push(lua_Number(address));
             L.push(lua_Number(size));
             L.push(lua_Number(value));
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
             int nresult = L.pcall(3);
 
             if (nresult > 0) {
@@ -513,16 +580,32 @@ void PCSX::Memory::write8(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(pointer + offset) = static_cast<uint8_t>(value);
+        markPointerDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            m_hard[address & 0x3ff] = value;
-        } else {
+        return;
+    }
+
+    switch (classifySlowAccess(address, true)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) {
+                m_hard[address & 0x3ff] = value;
+                return;
+            }
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             g_emulator->m_hw->write8(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write8(address, value);
-    } else if (sendWriteToLua(address, 1, value)) {
+            return;
+        case Region::EXP1:
+            if (pioConnected) {
+                g_emulator->m_pioCart->write8(address, value);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (sendWriteToLua(address, 1, value)) {
     } else if (isiCacheEnabled()) {
         g_emulator->m_cpu->Clear(address, 1);
         g_system->log(LogClass::CPU, _("8-bit write to unknown address: %8.8lx\n"), address);
@@ -550,17 +633,32 @@ void PCSX::Memory::write16(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint16_t *)(pointer + offset) = SWAP_LEu16(static_cast<uint16_t>(value));
+        markPointerDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
-            *ptr = SWAP_LEu16(value);
-        } else {
+        return;
+    }
+
+    switch (classifySlowAccess(address, true)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) {
+                *(uint16_t *)&m_hard[address & 0x3ff] = SWAP_LEu16(value);
+                return;
+            }
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             g_emulator->m_hw->write16(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write16(address, value);
-    } else if (sendWriteToLua(address, 2, value)) {
+            return;
+        case Region::EXP1:
+            if (pioConnected) {
+                g_emulator->m_pioCart->write16(address, value);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (sendWriteToLua(address, 2, value)) {
     } else if (isiCacheEnabled()) {
         g_emulator->m_cpu->Clear(address, 1);
         g_system->log(LogClass::CPU, _("16-bit write to unknown address: %8.8lx\n"), address);
@@ -588,17 +686,32 @@ void PCSX::Memory::write32(uint32_t address, uint32_t value) {
         [[likely]];
         const uint32_t offset = address & 0xffff;
         *(uint32_t *)(pointer + offset) = SWAP_LEu32(value);
+        markPointerDirty(pointer + offset);
         g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
-            *ptr = SWAP_LEu32(value);
-        } else {
+        return;
+    }
+
+    switch (classifySlowAccess(address, true)) {
+        case Region::Scratchpad:
+            if ((address & 0xffff) < 0x400) {
+                *(uint32_t *)&m_hard[address & 0x3ff] = SWAP_LEu32(value);
+                return;
+            }
+            [[fallthrough]];  // The rest of the scratchpad's 4KB leaf belongs to the hardware registers handler
+        case Region::Hardware:
             g_emulator->m_hw->write32(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write32(address, value);
-    } else if (address == 0xfffe0130) {
+            return;
+        case Region::EXP1:
+            if (pioConnected) {
+                g_emulator->m_pioCart->write32(address, value);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (address == 0xfffe0130) {
         m_BIU = value;
         switch (value) {
             case 0x00000800:
@@ -727,6 +840,50 @@ void PCSX::Memory::setLuts() {
     g_system->m_eventBus->signal(PCSX::Events::Memory::SetLuts{});
 }
 
+// Most pages belong to a single region. The only one that doesn't is the one the scratchpad and the hardware registers
+// share, where the scratchpad is in the first 4KB leaf and the hardware registers in the rest
+static constexpr PCSX::Memory::RegionLeaves uniformRegionLeaves(PCSX::Memory::Region region) {
+    PCSX::Memory::RegionLeaves leaves;
+    leaves.fill(region);
+    return leaves;
+}
+
+static constexpr PCSX::Memory::RegionLeaves s_regionLeaves[PCSX::Memory::c_regionCount] = {
+    uniformRegionLeaves(PCSX::Memory::Region::RAM),      uniformRegionLeaves(PCSX::Memory::Region::Scratchpad),
+    uniformRegionLeaves(PCSX::Memory::Region::Hardware), uniformRegionLeaves(PCSX::Memory::Region::BIOS),
+    uniformRegionLeaves(PCSX::Memory::Region::EXP1),     uniformRegionLeaves(PCSX::Memory::Region::Unmapped),
+};
+
+static constexpr PCSX::Memory::RegionLeaves s_hardwareRegionLeaves = [] {
+    auto leaves = uniformRegionLeaves(PCSX::Memory::Region::Hardware);
+    leaves[0] = PCSX::Memory::Region::Scratchpad;
+    return leaves;
+}();
+
+// The memory map doesn't depend on any setting, so this only needs to run once
+void PCSX::Memory::setRegionLuts() {
+    for (uint32_t page = 0; page < 0x10000; page++) {
+        const uint32_t segment = page >> 13;  // KUSEG's first 512MB, KSEG0 and KSEG1 all map to physical memory
+        const uint32_t physicalPage = page & 0x1fff;
+        const bool directlyMapped = segment == 0 || segment == 4 || segment == 5;
+        auto region = Region::Unmapped;
+
+        // The parallel port check has always ignored the segment, keep classifying it the same way
+        if (physicalPage >= 0x1f00 && physicalPage < 0x1f80) {
+            region = Region::EXP1;
+        } else if (directlyMapped && physicalPage < 0x80) {
+            region = Region::RAM;
+        } else if (directlyMapped && physicalPage >= 0x1fc0 && physicalPage < 0x1fc8) {
+            region = Region::BIOS;
+        } else if (directlyMapped && physicalPage == 0x1f80) {
+            m_regionLUT[page] = &s_hardwareRegionLeaves;
+            continue;
+        }
+
+        m_regionLUT[page] = &s_regionLeaves[static_cast<unsigned>(region)];
+    }
+}
+
 std::string_view PCSX::Memory::getBiosVersionString() {
     auto it = s_knownBioses.find(m_biosCRC);
     if (it == s_knownBioses.end()) return "Unknown";
@@ -802,6 +959,20 @@ void PCSX::Memory::MemoryAsFile::readBlock(void *dest, size_t size, size_t ptr)
     memcpy(dest, block + offset, toCopy);
 }
 
+const uint8_t *PCSX::Memory::MemoryAsFile::contiguous(size_t size, size_t ptr) const {
+    if (ptr >= c_size) return nullptr;
+    size = cappedSize(size, ptr);
+    const uint8_t *block = m_memory->m_readLUT[ptr / c_blockSize];
+    if (!block) return nullptr;
+    const uint8_t *start = block + ptr % c_blockSize;
+    // Mirrors, and regions next to each other in the address space, aren't necessarily next to each other
+    // in host memory, so each block the range spans over has to follow the previous one.
+    for (size_t next = (ptr / c_blockSize + 1) * c_blockSize; next < ptr + size; next += c_blockSize) {
+        if (m_memory->m_readLUT[next / c_blockSize] != start + (next - ptr)) return nullptr;
+    }
+    return start;
+}
+
 void PCSX::Memory::MemoryAsFile::writeBlock(const void *src, size_t size, size_t ptr) {
     // Yes. That's not a bug nor a typo.
     auto block = m_memory->m_readLUT[ptr / c_blockSize];
@@ -811,16 +982,15 @@ void PCSX::Memory::MemoryAsFile::writeBlock(const void *src, size_t size, size_t
     auto offset = ptr % c_blockSize;
     auto toCopy = std::min(size, c_blockSize - offset);
     memcpy(block + offset, src, toCopy);
+    m_memory->markPointerDirty(block + offset, toCopy);
 }
 
 void PCSX::Memory::initMsan(bool reset) {
     if (reset) {
         free(m_msanRAM);
-        free(m_msanUsableBitmap);
-        free(m_msanInitializedBitmap);
+        free(m_msanShadow);
         m_msanRAM = nullptr;
-        m_msanUsableBitmap = nullptr;
-        m_msanInitializedBitmap = nullptr;
+        m_msanShadow = nullptr;
         m_msanAllocs.clear();
         m_msanChainRegistry.clear();
     }
@@ -830,10 +1000,9 @@ void PCSX::Memory::initMsan(bool reset) {
         return;
     }
 
-    // 1.5GB of RAM, with 384MB worth of bitmap, between 0x20000000 and 0x80000000
+    // 1.5GB of RAM, with 384MB worth of shadow, between 0x20000000 and 0x80000000
     m_msanRAM = (uint8_t *)calloc(c_msanSize, 1);
-    m_msanUsableBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
-    m_msanInitializedBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
+    m_msanShadow = (uint8_t *)calloc(c_msanSize / 4 + 1, 1);
     m_msanPtr = 1024;
     for (uint32_t segment = c_msanStart; segment < c_msanEnd; segment += 0x10000) {
         m_readLUT[segment >> 16] = m_msanRAM + (segment - c_msanStart);
@@ -859,9 +1028,7 @@ uint32_t PCSX::Memory::msanAlloc(uint32_t size) {
     uint32_t ptr = m_msanPtr;
     m_msanPtr += actualSize;
     // Mark the allocation as usable.
-    for (uint32_t i = 0; i < size; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] |= 1 << ((ptr + i) % 8);
-    }
+    msanMarkRange(ptr, size, c_msanUsable);
 
     // Insert the allocation into the list of allocations.
     m_msanAllocs.insert({ptr, size});
@@ -886,9 +1053,7 @@ void PCSX::Memory::msanFree(uint32_t ptr) {
         return;
     }
     // Mark the allocation as unusable.
-    for (uint32_t i = 0; i < m_msanAllocs[ptr]; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] &= ~(1 << ((ptr + i) % 8));
-    }
+    msanMarkRange(ptr, it->second, 0);
     // Remove the allocation from the list of allocations.
     m_msanAllocs.erase(ptr);
 }
@@ -925,19 +1090,91 @@ uint32_t PCSX::Memory::msanRealloc(uint32_t ptr, uint32_t size) {
     memcpy(m_msanRAM + newPtr, m_msanRAM + ptr, std::min(size, oldSize));
 
     // Mark the old allocation as unusable
-    for (uint32_t i = 0; i < oldSize; i++) {
-        m_msanUsableBitmap[(ptr + i) / 8] &= ~(1 << ((ptr + i) % 8));
-    }
+    msanMarkRange(ptr, oldSize, 0);
     // Mark the new allocation as written to
-    auto toCopy = std::min(size, oldSize);
-    for (uint32_t i = 0; i < toCopy; i++) {
-        m_msanInitializedBitmap[(newPtr + i) / 8] |= 1 << ((newPtr + i) % 8);
-    }
+    msanMarkRange(newPtr, std::min(size, oldSize), c_msanOK);
     // Remove the allocation from the list of allocations.
     m_msanAllocs.erase(ptr);
     return newPtr + c_msanStart;
 }
 
+void PCSX::Memory::msanMarkRange(uint32_t offset, uint32_t size, uint8_t state) {
+    const uint32_t end = offset + size;
+    // The unaligned head and tail go a byte at a time, the rest of the shadow gets filled directly.
+    for (; (offset < end) && (offset % 4); offset++) {
+        auto &shadow = m_msanShadow[offset / 4];
+        const unsigned shift = (offset % 4) * 2;
+        shadow = (shadow & ~(3 << shift)) | (state << shift);
+    }
+    const uint32_t alignedEnd = std::max(offset, end & ~3);
+    memset(m_msanShadow + offset / 4, state * 0x55, (alignedEnd - offset) / 4);
+    for (offset = alignedEnd; offset < end; offset++) {
+        auto &shadow = m_msanShadow[offset / 4];
+        const unsigned shift = (offset % 4) * 2;
+        shadow = (shadow & ~(3 << shift)) | (state << shift);
+    }
+}
+
+PCSX::MsanStatus PCSX::Memory::msanGetRangeStatus(uint32_t addr, uint32_t size) const {
+    uint32_t offset = addr - c_msanStart;
+    const uint32_t end = std::min(offset + size, c_msanSize);
+    bool initialized = true;
+    auto check = [&initialized](uint8_t state) {
+        if ((state & c_msanUsable) == 0) return false;
+        if (state != c_msanOK) initialized = false;
+        return true;
+    };
+    for (; (offset < end) && (offset % 32); offset++) {
+        if (!check(msanShadowByte(offset))) return MsanStatus::UNUSABLE;
+    }
+    // 32 bytes of memory at a time: everything initialized is all ones, and everything usable
+    // has all of the low bits set.
+    constexpr uint64_t c_usableBits = 0x5555555555555555ULL;
+    for (; offset + 32 <= end; offset += 32) {
+        uint64_t shadow;
+        memcpy(&shadow, m_msanShadow + offset / 4, sizeof(shadow));
+        if (shadow == ~uint64_t(0)) [[likely]] {
+            continue;
+        }
+        if ((shadow & c_usableBits) != c_usableBits) return MsanStatus::UNUSABLE;
+        initialized = false;
+    }
+    for (; offset < end; offset++) {
+        if (!check(msanShadowByte(offset))) return MsanStatus::UNUSABLE;
+    }
+    return initialized ? MsanStatus::OK : MsanStatus::UNINITIALIZED;
+}
+
+bool PCSX::Memory::msanValidateWriteRange(uint32_t addr, uint32_t size) {
+    if (msanGetRangeStatus(addr, size) == MsanStatus::UNUSABLE) return false;
+    const uint32_t offset = addr - c_msanStart;
+    msanMarkRange(offset, std::min(size, c_msanSize - offset), c_msanOK);
+    return true;
+}
+
+void PCSX::Memory::msanCheckDMARange(unsigned channel, uint32_t madr, uint32_t size, bool write) {
+    if (write) {
+        if (msanValidateWriteRange(madr, size)) return;
+        g_system->log(LogClass::DMA, _("DMA channel %u wrote to unusable msan memory: %8.8lx-%8.8lx\n"), channel,
+                      madr, madr + size - 1);
+    } else {
+        switch (msanGetRangeStatus(madr, size)) {
+            case MsanStatus::UNINITIALIZED:
+                g_system->log(LogClass::DMA,
+                              _("DMA channel %u read from usable but uninitialized msan memory: %8.8lx-%8.8lx\n"),
+                              channel, madr, madr + size - 1);
+                break;
+            case MsanStatus::UNUSABLE:
+                g_system->log(LogClass::DMA, _("DMA channel %u read from unusable msan memory: %8.8lx-%8.8lx\n"),
+                              channel, madr, madr + size - 1);
+                break;
+            case MsanStatus::OK:
+                return;
+        }
+    }
+    g_system->pause();
+}
+
 uint32_t PCSX::Memory::msanSetChainPtr(uint32_t headerAddr, uint32_t nextPtr, uint32_t wordCount) {
     if (!inMsanRange(headerAddr)) {
         headerAddr &= 0xffffff;
@@ -19,12 +19,18 @@
 
 #pragma once
 
+#include <string.h>
+
+#include <array>
+#include <memory>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "core/psxemulator.h"
+#include "support/dirtypages.h"
 #include "support/eventbus.h"
+#include "support/flathashtable.h"
 #include "support/polyfills.h"
 #include "support/sharedmem.h"
 
@@ -73,6 +79,38 @@ class Memory {
     const void *pointerRead(uint32_t address);
     const void *pointerWrite(uint32_t address, int size);
 
+    // The parts of the memory map the slow paths of the read/write functions dispatch to
+    enum class Region : uint8_t { RAM, Scratchpad, Hardware, BIOS, EXP1, Unmapped };
+    static constexpr unsigned c_regionCount = 6;
+
+    // The region table has two levels: 64KB pages like the read/write LUTs, split into 16 leaves of 4KB
+    static constexpr uint32_t c_regionLeafShift = 12;
+    static constexpr unsigned c_regionLeafCount = 16;
+    using RegionLeaves = std::array<Region, c_regionLeafCount>;
+
+    Region getRegion(uint32_t address) const {
+        return (*m_regionLUT[address >> 16])[(address >> c_regionLeafShift) & (c_regionLeafCount - 1)];
+    }
+
+    // Optional counters of the accesses that missed the read/write LUTs, to see what dominates the slow paths
+    struct SlowAccessCounters {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+    };
+    bool m_countSlowAccesses = false;
+    const SlowAccessCounters &getSlowAccessCounters(Region region) const {
+        return m_slowAccessCounters[static_cast<unsigned>(region)];
+    }
+    void resetSlowAccessCounters() { m_slowAccessCounters = {}; }
+
+    // Which 4KB pages of RAM were written to since the last clear, so snapshots can skip over the rest.
+    // Anything writing to m_wram behind the back of the write functions has to mark what it wrote.
+    static constexpr uint32_t c_ramSize = 0x00800000;
+    DirtyPages &getDirtyRAM() { return m_dirtyRAM; }
+    void markRAMDirty(uint32_t address, uint32_t size) { m_dirtyRAM.markRange(address & (c_ramSize - 1), size); }
+    // RAM is shared with other processes by default, but a forked emulator needs a copy of its own.
+    bool unshareRAM() { return m_wramShared.detach(); }
+
     static constexpr uint16_t ISTAT = 0x1070;
     static constexpr uint16_t IMASK = 0x1074;
 
@@ -91,48 +129,56 @@ class Memory {
     uint32_t msanSetChainPtr(uint32_t headerAddr, uint32_t ptrToNext, uint32_t size);
     uint32_t msanGetChainPtr(uint32_t addr) const;
 
+    // The msan shadow holds two bits per byte of msan memory: the low one is set when the byte is usable,
+    // that is, allocated, and the high one when it got written to since. Four bytes fit in a byte of shadow,
+    // so the shadow of any access, which spans 4 bytes at most, is within a 16 bits window, and the whole
+    // access is checked at once against a mask.
+    static constexpr uint8_t c_msanUsable = 1;
+    static constexpr uint8_t c_msanOK = 3;
+
     template <uint32_t length>
     MsanStatus msanGetStatus(uint32_t addr) const {
-        uint32_t bitmapIndex = (addr - c_msanStart) / 8;
-        uint32_t bitmask = ((1 << length) - 1) << addr % 8;
-        MsanStatus bestCase = MsanStatus::OK;
-        if (uint32_t nextBitmask = bitmask >> 8) [[unlikely]] {
-            if ((m_msanInitializedBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                if ((m_msanUsableBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                    return MsanStatus::UNUSABLE;
-                }
-                bestCase = MsanStatus::UNINITIALIZED;
-            }
-            bitmask &= 0xFF;
-        }
-        if ((m_msanInitializedBitmap[bitmapIndex] & bitmask) != bitmask) [[unlikely]] {
-            if ((m_msanUsableBitmap[bitmapIndex] & bitmask) != bitmask) {
-                return MsanStatus::UNUSABLE;
-            }
-            return MsanStatus::UNINITIALIZED;
+        static_assert(length <= 4);
+        constexpr uint32_t mask = (1 << (length * 2)) - 1;
+        constexpr uint32_t usable = 0x5555 & mask;
+        const uint32_t offset = addr - c_msanStart;
+        const uint32_t bits = (msanShadowWindow(offset) >> ((offset % 4) * 2)) & mask;
+        if (bits == mask) [[likely]] {
+            return MsanStatus::OK;
         }
-        return bestCase;
+        if ((bits & usable) == usable) return MsanStatus::UNINITIALIZED;
+        return MsanStatus::UNUSABLE;
     }
 
     // if the write is valid, marks the address as initialized, otherwise returns false
     template <uint32_t length>
     bool msanValidateWrite(uint32_t addr) {
-        uint32_t bitmapIndex = (addr - c_msanStart) / 8;
-        uint32_t bitmask = ((1 << length) - 1) << addr % 8;
-        if (uint32_t nextBitmask = bitmask >> 8) [[unlikely]] {
-            if ((m_msanUsableBitmap[bitmapIndex + 1] & nextBitmask) != nextBitmask) {
-                return false;
-            }
-            m_msanInitializedBitmap[bitmapIndex + 1] |= nextBitmask;
-            bitmask &= 0xFF;
-        }
-        if ((m_msanUsableBitmap[bitmapIndex] & bitmask) != bitmask) [[unlikely]] {
+        static_assert(length <= 4);
+        constexpr uint32_t mask = (1 << (length * 2)) - 1;
+        constexpr uint32_t usable = 0x5555 & mask;
+        const uint32_t offset = addr - c_msanStart;
+        const unsigned shift = (offset % 4) * 2;
+        uint16_t window = msanShadowWindow(offset);
+        if (((window >> shift) & usable) != usable) [[unlikely]] {
             return false;
         }
-        m_msanInitializedBitmap[bitmapIndex] |= bitmask;
+        window |= mask << shift;
+        memcpy(m_msanShadow + offset / 4, &window, sizeof(window));
         return true;
     }
 
+    // Same as the above, for whole ranges at once, such as DMAs.
+    MsanStatus msanGetRangeStatus(uint32_t addr, uint32_t size) const;
+    bool msanValidateWriteRange(uint32_t addr, uint32_t size);
+    // For the DMA channels going straight to memory: complains if the range a DMA reads from isn't fully
+    // initialized, or if the range it writes to isn't usable, and marks the latter as initialized otherwise.
+    void msanCheckDMA(unsigned channel, uint32_t madr, uint32_t size, bool write) {
+        if (!msanInitialized() || !inMsanRange(madr)) [[likely]] {
+            return;
+        }
+        msanCheckDMARange(channel, madr, size, write);
+    }
+
     static inline bool inMsanRange(uint32_t addr) { return addr >= c_msanStart && addr < c_msanEnd; }
 
     template <unsigned n>
@@ -273,6 +319,9 @@ class Memory {
         }
         ssize_t readAt(void *dest, size_t size, size_t ptr) final override;
         ssize_t writeAt(const void *src, size_t size, size_t ptr) final override;
+        // Where the given range sits in host memory, if all of it is mapped, and in one piece there. Reading
+        // through the returned pointer is live: it sees whatever the emulated machine writes afterwards.
+        const uint8_t *contiguous(size_t size, size_t ptr) const;
 
       private:
         MemoryAsFile(Memory *memory) : File(File::FileType::RW_SEEKABLE), m_memory(memory) {}
@@ -296,13 +345,65 @@ class Memory {
     friend class MemoryAsFile;
     IO<MemoryAsFile> m_memoryAsFile;
 
+    const RegionLeaves **m_regionLUT = nullptr;
+    std::array<SlowAccessCounters, c_regionCount> m_slowAccessCounters;
+
+    void setRegionLuts();
+    Region classifySlowAccess(uint32_t address, bool write) {
+        const auto region = getRegion(address);
+        if (m_countSlowAccesses) [[unlikely]] {
+            auto &counters = m_slowAccessCounters[static_cast<unsigned>(region)];
+            write ? counters.writes++ : counters.reads++;
+        }
+        return region;
+    }
+
     uint32_t m_biosCRC = 0;
 
+    // Which of the process' "wram" names this one holds. It's declared ahead of the mapping, so that the name only
+    // goes back to the pool once the mapping is gone.
+    class WramName {
+      public:
+        ~WramName();
+        std::string claim();
+
+      private:
+        int m_index = -1;
+    };
+    WramName m_wramName;
+
     // Shared memory wrappers, pointers below point to these where appropriate
     SharedMem m_wramShared;
+    SharedMem m_biosMemory;
+    // What the BIOS pages are a copy-on-write mapping of, when they're shared with the other processes running it.
+    std::unique_ptr<SharedMem> m_biosShared;
+    void shareBios();
 
     uint32_t m_BIU = 0;
 
+    DirtyPages m_dirtyRAM = DirtyPages(c_ramSize);
+
+    // The shadow has a byte of padding at its end, so that the window of the last bytes can be read.
+    uint16_t msanShadowWindow(uint32_t offset) const {
+        uint16_t window;
+        memcpy(&window, m_msanShadow + offset / 4, sizeof(window));
+        return window;
+    }
+    uint8_t msanShadowByte(uint32_t offset) const { return (m_msanShadow[offset / 4] >> ((offset % 4) * 2)) & 3; }
+    // Sets the shadow of a range to either 0, c_msanUsable, or c_msanOK.
+    void msanMarkRange(uint32_t offset, uint32_t size, uint8_t state);
+    void msanCheckDMARange(unsigned channel, uint32_t madr, uint32_t size, bool write);
+
+    // The write LUTs don't only point to RAM, the msan memory goes through them too
+    void markPointerDirty(const uint8_t *pointer) {
+        const uintptr_t offset = pointer - m_wram;
+        if (offset < c_ramSize) m_dirtyRAM.mark(offset);
+    }
+    void markPointerDirty(const uint8_t *pointer, uint32_t size) {
+        const uintptr_t offset = pointer - m_wram;
+        if (offset < c_ramSize) m_dirtyRAM.markRange(offset, size);
+    }
+
     // hopefully this should become private eventually, with only certain classes having direct access.
   public:
     uint8_t *m_wram = nullptr;  // Kernel & User Memory (8 Meg)
@@ -317,14 +418,13 @@ class Memory {
     static constexpr uint32_t c_msanStart = 0x20000000;
     static constexpr uint32_t c_msanEnd = c_msanStart + c_msanSize;
     uint8_t *m_msanRAM = nullptr;
-    uint8_t *m_msanUsableBitmap = nullptr;
-    uint8_t *m_msanInitializedBitmap = nullptr;
+    uint8_t *m_msanShadow = nullptr;
     uint32_t m_msanPtr = 1024;
     EventBus::Listener m_listener;
 
-    std::unordered_map<uint32_t, uint32_t> m_msanAllocs;
+    FlatHashTable<uint32_t, uint32_t> m_msanAllocs;
     static constexpr uint32_t c_msanChainMarker = 0x7ffffd;
-    std::unordered_map<uint32_t, uint32_t> m_msanChainRegistry;
+    FlatHashTable<uint32_t, uint32_t> m_msanChainRegistry;
 
     template <typename T = void>
     T *getPointer(uint32_t address) {
@@ -23,18 +23,24 @@
 
 #include "core/r3000a.h"
 
+#include <algorithm>
+#include <bit>
+#include <limits>
 #include <magic_enum_all.hpp>
+#include <optional>
 
 #include "core/cdrom.h"
 #include "core/debug.h"
 #include "core/gpu.h"
 #include "core/gte.h"
+#include "core/guestprofiler.h"
 #include "core/mdec.h"
 #include "core/pgxp_mem.h"
 #include "core/sio.h"
 #include "core/sio1.h"
 #include "core/spu.h"
 #include "fmt/format.h"
+#include "support/uvfile.h"
 #include "supportpsx/memory.h"
 
 int PCSX::R3000Acpu::psxInit() {
@@ -44,6 +50,9 @@ int PCSX::R3000Acpu::psxInit() {
 
     if (g_emulator->settings.get<Emulator::SettingDynarec>()) {
         g_emulator->m_cpu = Cpus::DynaRec();
+        if (!g_emulator->m_cpu) {
+            g_system->printf(_("Dynarec unavailable, or in use by another emulator of this process\n"));
+        }
     }
 
     if (!g_emulator->m_cpu) g_emulator->m_cpu = Cpus::Interpreted();
@@ -54,6 +63,53 @@ int PCSX::R3000Acpu::psxInit() {
     return g_emulator->m_cpu->Init();
 }
 
+void PCSX::R3000Acpu::fillICacheLine(ICacheLine &line, uint32_t pc) {
+    const uint32_t base = pc & ~0xf;
+    line.tag = iCacheTag(pc);
+    // A line never straddles two pages of the memory map, so RAM can be copied in one go.
+    const auto words = g_emulator->m_mem->getPointer<const uint32_t>(base);
+    if (words) [[likely]] {
+        for (unsigned i = 0; i < 4; i++) line.words[i] = SWAP_LEu32(words[i]);
+        return;
+    }
+    for (unsigned i = 0; i < 4; i++) line.words[i] = g_emulator->m_mem->read32(base + i * 4, Memory::ReadType::Instr);
+}
+
+void PCSX::R3000Acpu::saveICache() {
+    auto put = [](uint8_t *dest, uint32_t value) {
+        for (unsigned i = 0; i < 4; i++) dest[i] = value >> (i * 8);
+    };
+    for (unsigned index = 0; index < 256; index++) {
+        const auto &line = m_iCache[index];
+        const bool valid = line.tag != c_invalidICacheTag;
+        for (unsigned i = 0; i < 4; i++) {
+            const uint32_t offset = index * 16 + i * 4;
+            put(m_regs.iCacheAddr + offset, valid ? line.tag + i * 4 : 0xffffffff);
+            put(m_regs.iCacheCode + offset, valid ? line.words[i] : 0xffffffff);
+        }
+    }
+}
+
+void PCSX::R3000Acpu::loadICache() {
+    auto get = [](const uint8_t *src) {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < 4; i++) value |= uint32_t(src[i]) << (i * 8);
+        return value;
+    };
+    for (unsigned index = 0; index < 256; index++) {
+        auto &line = m_iCache[index];
+        const uint32_t offset = index * 16;
+        const uint32_t tag = get(m_regs.iCacheAddr + offset);
+        // Lines get filled as a whole, so anything else than four consecutive addresses is an invalid line.
+        bool valid = (tag & 0xff00000f) == 0 && ((tag & 0xff0) == offset);
+        for (unsigned i = 0; i < 4; i++) {
+            valid = valid && (get(m_regs.iCacheAddr + offset + i * 4) == tag + i * 4);
+            line.words[i] = get(m_regs.iCacheCode + offset + i * 4);
+        }
+        line.tag = valid ? tag : c_invalidICacheTag;
+    }
+}
+
 void PCSX::R3000Acpu::psxReset() {
     Reset();
 
@@ -115,7 +171,7 @@ void PCSX::R3000Acpu::exception(uint32_t code, bool bd, bool cop0) {
                     memFile->rSeek(m_regs.GPR.n.a0);
                     auto filename = memFile->gets<false>();
                     fd = m_availableFDs.front();
-                    auto file = m_pcdrvFiles.insert(fd, new PCdrvFile(basepath / filename, FileOps::TRUNCATE));
+                    auto file = m_pcdrvFiles.insert(fd, new PCdrvFile(new UvFile(basepath / filename, FileOps::TRUNCATE)));
                     file->m_relativeFilename = filename;
                     if ((*file)->failed()) {
                         regs.v0 = -1;
@@ -143,9 +199,9 @@ void PCSX::R3000Acpu::exception(uint32_t code, bool bd, bool cop0) {
                     auto path = basepath / filename;
                     fd = m_availableFDs.front();
                     if (regs.a2 == 0) {
-                        file = m_pcdrvFiles.insert(fd, new PCdrvFile(path));
+                        file = m_pcdrvFiles.insert(fd, new PCdrvFile(new UvFile(path)));
                     } else {
-                        file = m_pcdrvFiles.insert(fd, new PCdrvFile(path, FileOps::READWRITE));
+                        file = m_pcdrvFiles.insert(fd, new PCdrvFile(new UvFile(path, FileOps::READWRITE)));
                     }
                     file->m_relativeFilename = filename;
                     if ((*file)->failed()) {
@@ -191,10 +247,19 @@ void PCSX::R3000Acpu::exception(uint32_t code, bool bd, bool cop0) {
                         m_regs.pc += 4;
                         return;
                     }
-                    auto slice = file->read(regs.a2);
+                    const size_t pos = file->rTell();
+                    if (!filei->prefetched(pos, regs.a2)) {
+                        // The guest runs its break instruction again until the data is there, unless it's in a
+                        // delay slot, where this would lose the branch.
+                        if (!bd) return;
+                        do {
+                            filei->waitWindows();
+                        } while (!filei->prefetched(pos, regs.a2));
+                    }
+                    const size_t size = filei->consume(pos, regs.a2, regs.a3, memFile);
+                    file->rSeek(size, SEEK_CUR);
                     regs.v0 = 0;
-                    regs.v1 = slice.size();
-                    memFile->writeAt(std::move(slice), regs.a3);
+                    regs.v1 = size;
                     m_regs.pc += 4;
                     return;
                 }
@@ -207,12 +272,18 @@ void PCSX::R3000Acpu::exception(uint32_t code, bool bd, bool cop0) {
                         return;
                     }
                     IO<File> file = *filei;
-                    auto slice = memFile->readAt(regs.a2, regs.a3);
-                    if ((regs.v1 = file->write(slice.data(), slice.size())) < 0) {
+                    if (!file->writable()) {
                         regs.v0 = -1;
-                    } else {
-                        regs.v0 = 0;
+                        regs.v1 = -1;
+                        m_regs.pc += 4;
+                        return;
                     }
+                    filei->dropWindows();
+                    // The data is copied out of the guest memory right away, and written out on the uv thread.
+                    auto slice = memFile->readAt(regs.a2, regs.a3);
+                    regs.v0 = 0;
+                    regs.v1 = slice.size();
+                    file->write(std::move(slice));
                     m_regs.pc += 4;
                     return;
                 }
@@ -304,7 +375,7 @@ void PCSX::R3000Acpu::restorePCdrvFile(const std::filesystem::path& filename, ui
     auto& emuSettings = g_emulator->settings;
     auto& debugSettings = emuSettings.get<Emulator::SettingDebugSettings>();
     std::filesystem::path basepath = debugSettings.get<Emulator::DebugSettings::PCdrvBase>();
-    m_pcdrvFiles.insert(fd, new PCdrvFile(basepath / filename));
+    m_pcdrvFiles.insert(fd, new PCdrvFile(new UvFile(basepath / filename)));
     for (auto f = m_availableFDs.begin(); f != m_availableFDs.end(); f++) {
         if (*f == fd) {
             m_availableFDs.erase(f);
@@ -317,7 +388,7 @@ void PCSX::R3000Acpu::restorePCdrvFile(const std::filesystem::path& filename, ui
     auto& emuSettings = g_emulator->settings;
     auto& debugSettings = emuSettings.get<Emulator::SettingDebugSettings>();
     std::filesystem::path basepath = debugSettings.get<Emulator::DebugSettings::PCdrvBase>();
-    auto f = new PCdrvFile(basepath / filename, FileOps::CREATE);
+    auto f = new PCdrvFile(new UvFile(basepath / filename, FileOps::CREATE));
     (*f)->wSeek(0, SEEK_END);
     m_pcdrvFiles.insert(fd, f);
     for (auto f = m_availableFDs.begin(); f != m_availableFDs.end(); f++) {
@@ -328,76 +399,83 @@ void PCSX::R3000Acpu::restorePCdrvFile(const std::filesystem::path& filename, ui
     }
 }
 
-void PCSX::R3000Acpu::branchTest() {
-#if 0
-    if( SPU_async )
-    {
-        static int init;
-        int elapsed;
-
-        if( init == 0 ) {
-            // 10 apu cycles
-            // - Final Fantasy Tactics (distorted - dropped sound effects)
-            m_regs.intCycle[PSXINT_SPUASYNC].cycle = g_emulator->m_psxClockSpeed / 44100 * 10;
-
-            init = 1;
-        }
+void PCSX::R3000Acpu::processScheduledEvents() {
+    const uint64_t cycle = m_regs.cycle;
 
-        elapsed = m_regs.cycle - m_regs.intCycle[PSXINT_SPUASYNC].sCycle;
-        if (elapsed >= m_regs.intCycle[PSXINT_SPUASYNC].cycle) {
-            SPU_async( elapsed );
+    if (cycle >= g_emulator->m_counters->m_psxNextCounter) g_emulator->m_counters->update();
 
-            m_regs.intCycle[PSXINT_SPUASYNC].sCycle = m_regs.cycle;
+    // Only walk the interrupts that are actually pending. Handlers are allowed to schedule
+    // new interrupts, which will lower lowestTarget on their own through scheduleInterrupt.
+    if (cycle >= m_regs.lowestTarget) {
+        uint32_t pending = m_regs.interrupt;
+        m_regs.lowestTarget = std::numeric_limits<uint64_t>::max();
+        while (pending != 0) {
+            const unsigned irq = std::countr_zero(pending);
+            pending &= pending - 1;
+            const uint64_t target = m_regs.intTargets[irq];
+            if (target > cycle) {
+                if (target < m_regs.lowestTarget) m_regs.lowestTarget = target;
+                continue;
+            }
+            m_regs.interrupt &= ~(1 << irq);
+            PSXIRQ_LOG("Triggering interrupt %08x\n", irq);
+            switch (irq) {
+                case PSXINT_SIO:
+                    g_emulator->m_sio->interrupt();
+                    break;
+                case PSXINT_SIO1:
+                    g_emulator->m_sio1->interrupt();
+                    break;
+                case PSXINT_CDR:
+                    g_emulator->m_cdrom->interrupt();
+                    break;
+                case PSXINT_CDREAD:
+                    g_emulator->m_cdrom->readInterrupt();
+                    break;
+                case PSXINT_GPUDMA:
+                    GPU::gpuInterrupt();
+                    break;
+                case PSXINT_MDECOUTDMA:
+                    g_emulator->m_mdec->mdec1Interrupt();
+                    break;
+                case PSXINT_SPUDMA:
+                    spuInterrupt();
+                    break;
+                case PSXINT_MDECINDMA:
+                    g_emulator->m_mdec->mdec0Interrupt();
+                    break;
+                case PSXINT_GPUOTCDMA:
+                    gpuotcInterrupt();
+                    break;
+                case PSXINT_CDRDMA:
+                    g_emulator->m_cdrom->dmaInterrupt();
+                    break;
+                case PSXINT_CDRDBUF:
+                    g_emulator->m_cdrom->decodedBufferInterrupt();
+                    break;
+                case PSXINT_CDRLID:
+                    g_emulator->m_cdrom->lidSeekInterrupt();
+                    break;
+                case PSXINT_CDRPLAY:
+                    g_emulator->m_cdrom->playInterrupt();
+                    break;
+                case PSXINT_PROFILER:
+                    g_emulator->m_guestProfiler->sample();
+                    break;
+            }
         }
     }
-#endif
 
-    const uint64_t cycle = m_regs.cycle;
+    m_regs.nextEventTarget = std::min(m_regs.lowestTarget, g_emulator->m_counters->m_psxNextCounter);
+}
 
-    if (cycle >= g_emulator->m_counters->m_psxNextCounter) g_emulator->m_counters->update();
+void PCSX::R3000Acpu::branchTest() {
+    if (m_regs.cycle >= m_regs.nextEventTarget) processScheduledEvents();
 
-    if (m_regs.spuInterrupt.exchange(false)) g_emulator->m_spu->interrupt();
-
-    const uint32_t interrupts = m_regs.interrupt;
-
-    int32_t lowestDistance = std::numeric_limits<int64_t>::max();
-    uint64_t lowestTarget = cycle;
-    uint64_t* targets = m_regs.intTargets;
-
-    if ((interrupts != 0) && (m_regs.lowestTarget < cycle)) {
-#define checkAndUpdate(irq, act)                                                          \
-    {                                                                                     \
-        constexpr uint32_t mask = 1 << irq;                                               \
-        if ((interrupts & mask) != 0) {                                                   \
-            uint64_t target = targets[irq];                                               \
-            int64_t dist = target - cycle;                                                \
-            if (dist > 0) {                                                               \
-                if (lowestDistance > dist) {                                              \
-                    lowestDistance = dist;                                                \
-                    lowestTarget = target;                                                \
-                }                                                                         \
-            } else {                                                                      \
-                m_regs.interrupt &= ~mask;                                                \
-                PSXIRQ_LOG("Triggering interrupt %08x\n", magic_enum::enum_integer(irq)); \
-                act();                                                                    \
-            }                                                                             \
-        }                                                                                 \
-    }
-        checkAndUpdate(PSXINT_SIO, g_emulator->m_sio->interrupt);
-        checkAndUpdate(PSXINT_SIO1, g_emulator->m_sio1->interrupt);
-        checkAndUpdate(PSXINT_CDR, g_emulator->m_cdrom->interrupt);
-        checkAndUpdate(PSXINT_CDREAD, g_emulator->m_cdrom->readInterrupt);
-        checkAndUpdate(PSXINT_GPUDMA, GPU::gpuInterrupt);
-        checkAndUpdate(PSXINT_MDECOUTDMA, g_emulator->m_mdec->mdec1Interrupt);
-        checkAndUpdate(PSXINT_SPUDMA, spuInterrupt);
-        checkAndUpdate(PSXINT_MDECINDMA, g_emulator->m_mdec->mdec0Interrupt);
-        checkAndUpdate(PSXINT_GPUOTCDMA, gpuotcInterrupt);
-        checkAndUpdate(PSXINT_CDRDMA, g_emulator->m_cdrom->dmaInterrupt);
-        checkAndUpdate(PSXINT_CDRPLAY, g_emulator->m_cdrom->playInterrupt);
-        checkAndUpdate(PSXINT_CDRDBUF, g_emulator->m_cdrom->decodedBufferInterrupt);
-        checkAndUpdate(PSXINT_CDRLID, g_emulator->m_cdrom->lidSeekInterrupt);
-        m_regs.lowestTarget = lowestTarget;
+    if (m_regs.spuInterrupt.load(std::memory_order_relaxed) && m_regs.spuInterrupt.exchange(false)) {
+        g_emulator->m_spu->interrupt();
     }
+
     auto& mem = g_emulator->m_mem;
     auto istat = mem->readHardwareRegister<Memory::ISTAT>();
     auto imask = mem->readHardwareRegister<Memory::IMASK>();
@@ -417,6 +495,227 @@ void PCSX::R3000Acpu::branchTest() {
     }
 }
 
+namespace {
+
+constexpr unsigned c_maxIdleLoopSize = 8;
+
+// What an instruction allowed in an idle loop reads and writes. Anything else, such as stores, jumps,
+// coprocessor instructions, or multiplications, makes the loop not idle.
+struct IdleOp {
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    unsigned loadWidth = 0;
+    bool branch = false;
+};
+
+bool decodeIdleOp(uint32_t code, IdleOp& op) {
+    const uint32_t rs = (code >> 21) & 0x1f;
+    const uint32_t rt = (code >> 16) & 0x1f;
+    const uint32_t rd = (code >> 11) & 0x1f;
+    op = {};
+    switch (code >> 26) {
+        case 0x00:
+            switch (code & 0x3f) {
+                case 0x00:  // sll
+                case 0x02:  // srl
+                case 0x03:  // sra
+                    op.reads = 1 << rt;
+                    op.writes = 1 << rd;
+                    break;
+                case 0x04:  // sllv
+                case 0x06:  // srlv
+                case 0x07:  // srav
+                case 0x21:  // addu
+                case 0x23:  // subu
+                case 0x24:  // and
+                case 0x25:  // or
+                case 0x26:  // xor
+                case 0x27:  // nor
+                case 0x2a:  // slt
+                case 0x2b:  // sltu
+                    op.reads = (1 << rs) | (1 << rt);
+                    op.writes = 1 << rd;
+                    break;
+                default:
+                    return false;
+            }
+            break;
+        case 0x01:
+            // bltz and bgez, but not the linking ones
+            if (rt > 1) return false;
+            op.reads = 1 << rs;
+            op.branch = true;
+            break;
+        case 0x04:  // beq
+        case 0x05:  // bne
+            op.reads = (1 << rs) | (1 << rt);
+            op.branch = true;
+            break;
+        case 0x06:  // blez
+        case 0x07:  // bgtz
+            op.reads = 1 << rs;
+            op.branch = true;
+            break;
+        case 0x09:  // addiu
+        case 0x0a:  // slti
+        case 0x0b:  // sltiu
+        case 0x0c:  // andi
+        case 0x0d:  // ori
+        case 0x0e:  // xori
+            op.reads = 1 << rs;
+            op.writes = 1 << rt;
+            break;
+        case 0x0f:  // lui
+            op.writes = 1 << rt;
+            break;
+        case 0x20:  // lb
+        case 0x24:  // lbu
+            op.loadWidth = 1;
+            break;
+        case 0x21:  // lh
+        case 0x25:  // lhu
+            op.loadWidth = 2;
+            break;
+        case 0x23:  // lw
+            op.loadWidth = 4;
+            break;
+        default:
+            return false;
+    }
+    if (op.loadWidth) {
+        op.reads = 1 << rs;
+        op.writes = 1 << rt;
+    }
+    op.writes &= ~1;
+    return true;
+}
+
+// The value an alu instruction accepted by decodeIdleOp computes.
+uint32_t evalIdleOp(uint32_t code, const uint32_t* r) {
+    const uint32_t rs = r[(code >> 21) & 0x1f];
+    const uint32_t rt = r[(code >> 16) & 0x1f];
+    const uint32_t imm = int16_t(code);
+    const uint32_t sa = (code >> 6) & 0x1f;
+    switch (code >> 26) {
+        case 0x00:
+            switch (code & 0x3f) {
+                case 0x00:
+                    return rt << sa;
+                case 0x02:
+                    return rt >> sa;
+                case 0x03:
+                    return int32_t(rt) >> sa;
+                case 0x04:
+                    return rt << (rs & 0x1f);
+                case 0x06:
+                    return rt >> (rs & 0x1f);
+                case 0x07:
+                    return int32_t(rt) >> (rs & 0x1f);
+                case 0x21:
+                    return rs + rt;
+                case 0x23:
+                    return rs - rt;
+                case 0x24:
+                    return rs & rt;
+                case 0x25:
+                    return rs | rt;
+                case 0x26:
+                    return rs ^ rt;
+                case 0x27:
+                    return ~(rs | rt);
+                case 0x2a:
+                    return int32_t(rs) < int32_t(rt);
+                case 0x2b:
+                    return rs < rt;
+            }
+            break;
+        case 0x09:
+            return rs + imm;
+        case 0x0a:
+            return int32_t(rs) < int32_t(imm);
+        case 0x0b:
+            return rs < imm;
+        case 0x0c:
+            return rs & (code & 0xffff);
+        case 0x0d:
+            return rs | (code & 0xffff);
+        case 0x0e:
+            return rs ^ (code & 0xffff);
+        case 0x0f:
+            return code << 16;
+    }
+    return 0;
+}
+
+// Memory which only changes through something scheduled: RAM and the scratchpad, changed by the interrupt
+// handlers or by DMAs, and I_STAT.
+bool isIdleAddress(uint32_t address, unsigned width) {
+    if (address & (width - 1)) return false;
+    const uint32_t physical = address & 0x1fffffff;
+    if (physical < 0x00800000) return true;
+    if (((physical & ~0x3ff) == 0x1f800000) && ((address >> 29) != 5)) return true;
+    return (physical & ~3) == 0x1f801070;
+}
+
+}  // namespace
+
+bool PCSX::R3000Acpu::isIdleLoop(uint32_t start, uint32_t branchPC, bool checkAddresses) {
+    if ((branchPC < start) || (((branchPC - start) / 4 + 2) > c_maxIdleLoopSize)) return false;
+    if ((start == m_notIdleLoop.start) && (branchPC == m_notIdleLoop.branchPC)) return false;
+    auto reject = [this, start, branchPC]() {
+        m_notIdleLoop.start = start;
+        m_notIdleLoop.branchPC = branchPC;
+        return false;
+    };
+
+    // The loop includes the delay slot of its branch.
+    const unsigned count = (branchPC - start) / 4 + 2;
+    uint32_t codes[c_maxIdleLoopSize];
+    IdleOp ops[c_maxIdleLoopSize];
+    uint32_t written = 0;
+    uint32_t readFirst = 0;
+    for (unsigned i = 0; i < count; i++) {
+        auto p = reinterpret_cast<const uint8_t*>(g_emulator->m_mem->pointerRead(start + i * 4));
+        if (!p) return reject();
+        const uint32_t code = codes[i] = p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+        auto& op = ops[i];
+        if (!decodeIdleOp(code, op)) return reject();
+        const uint32_t pc = start + i * 4;
+        if (op.branch != (pc == branchPC)) return reject();
+        if (op.branch && ((pc + 4 + (uint32_t(int16_t(code)) << 2)) != start)) return reject();
+        readFirst |= op.reads & ~written;
+        written |= op.writes;
+    }
+    // A register read before getting written carries something from the previous iteration over, such
+    // as a counter would.
+    if (readFirst & written) return reject();
+
+    // Registers the loop doesn't write keep their current values, and whatever gets computed from them
+    // too. Loads need to know where they read from.
+    uint32_t known = ~written;
+    uint32_t values[32];
+    std::copy_n(m_regs.GPR.r, 32, values);
+    values[0] = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const auto& op = ops[i];
+        const uint32_t code = codes[i];
+        if (op.branch) continue;
+        if (op.loadWidth) {
+            const uint32_t base = (code >> 21) & 0x1f;
+            if (!(known & (1 << base))) return reject();
+            if (checkAddresses && !isIdleAddress(values[base] + int16_t(code), op.loadWidth)) return false;
+            known &= ~op.writes;
+        } else if ((op.reads & known) == op.reads) {
+            const uint32_t result = evalIdleOp(code, values);
+            if (op.writes) values[std::countr_zero(op.writes)] = result;
+            known |= op.writes;
+        } else {
+            known &= ~op.writes;
+        }
+    }
+    return true;
+}
+
 void PCSX::R3000Acpu::psxSetPGXPMode(uint32_t pgxpMode) {
     SetPGXPMode(pgxpMode);
     // g_emulator->m_cpu->Reset();
@@ -504,27 +803,245 @@ void PCSX::R3000Acpu::processB0KernelCall(uint32_t call) {
     }
 }
 
+namespace {
+
+// Where a range of guest memory lives in the emulated RAM, when it's entirely in the same mirror of it.
+// Anything else, such as the scratchpad, the BIOS, or the msan memory, is left to the BIOS code.
+uint8_t* hleRAM(uint32_t address, uint32_t size) {
+    const uint32_t segment = address >> 29;
+    if ((segment != 0) && (segment != 4) && (segment != 5)) return nullptr;
+    const uint32_t physical = address & 0x1fffffff;
+    if (physical >= PCSX::Memory::c_ramSize) return nullptr;
+    const uint32_t mask = PCSX::g_emulator->getRamMask();
+    const uint32_t offset = physical & mask;
+    if (size > (mask + 1 - offset)) return nullptr;
+    return PCSX::g_emulator->m_mem->m_wram + offset;
+}
+
+// The length of the string at this address, if it ends before the end of the RAM mirror it starts in.
+std::optional<uint32_t> hleStringLength(uint32_t address) {
+    const uint8_t* start = hleRAM(address, 1);
+    if (!start) return std::nullopt;
+    const uint32_t mask = PCSX::g_emulator->getRamMask();
+    const uint32_t available = mask + 1 - ((address & 0x1fffffff) & mask);
+    auto end = reinterpret_cast<const uint8_t*>(memchr(start, 0, available));
+    if (!end) return std::nullopt;
+    return end - start;
+}
+
+void hleWritten(uint32_t address, uint32_t size) {
+    PCSX::g_emulator->m_cpu->Clear(address & ~3, ((address & 3) + size + 3) / 4);
+    PCSX::g_emulator->m_mem->markRAMDirty(address, size);
+}
+
+// Rough costs, in instructions, of the BIOS versions: the dispatch through the A0 table and the argument
+// checks, and then their byte loops.
+constexpr uint32_t c_hleCallCost = 16;
+constexpr uint32_t c_hleCopyCost = 5;
+constexpr uint32_t c_hleFillCost = 4;
+constexpr uint32_t c_hleScanCost = 4;
+
+}  // namespace
+
+bool PCSX::R3000Acpu::hleA0KernelCall(uint32_t call) {
+    auto& r = m_regs.GPR.n;
+    uint32_t cost = c_hleCallCost;
+
+    // The BIOS copies and fills byte by byte, which matters when the ranges overlap.
+    auto copy = [&cost](uint32_t dst, uint32_t src, uint32_t size) {
+        uint8_t* d = hleRAM(dst, size);
+        const uint8_t* s = hleRAM(src, size);
+        if (!d || !s) return false;
+        for (uint32_t i = 0; i < size; i++) d[i] = s[i];
+        hleWritten(dst, size);
+        cost += size * c_hleCopyCost;
+        return true;
+    };
+    auto fill = [&cost](uint32_t dst, uint8_t value, uint32_t size) {
+        uint8_t* d = hleRAM(dst, size);
+        if (!d) return false;
+        memset(d, value, size);
+        hleWritten(dst, size);
+        cost += size * c_hleFillCost;
+        return true;
+    };
+
+    // Calls which aren't here either call back into the guest, keep some state in the BIOS' own memory,
+    // such as rand, or don't return the same thing with all of the BIOS versions, such as the comparisons.
+    switch (call) {
+        case 0x19: {  // strcpy
+            if (!r.a0 || !r.a1) {
+                r.v0 = 0;
+                break;
+            }
+            auto length = hleStringLength(r.a1);
+            if (!length || !copy(r.a0, r.a1, *length + 1)) return false;
+            r.v0 = r.a0;
+            break;
+        }
+        case 0x1b: {  // strlen
+            if (!r.a0) {
+                r.v0 = 0;
+                break;
+            }
+            auto length = hleStringLength(r.a0);
+            if (!length) return false;
+            cost += *length * c_hleScanCost;
+            r.v0 = *length;
+            break;
+        }
+        case 0x27: {  // bcopy
+            if (!r.a0) {
+                r.v0 = 0;
+                break;
+            }
+            if ((int32_t(r.a2) > 0) && !copy(r.a1, r.a0, r.a2)) return false;
+            r.v0 = r.a0;
+            break;
+        }
+        case 0x28: {  // bzero
+            if (!r.a0 || (int32_t(r.a1) <= 0)) {
+                r.v0 = 0;
+                break;
+            }
+            if (!fill(r.a0, 0, r.a1)) return false;
+            r.v0 = r.a0;
+            break;
+        }
+        case 0x2a: {  // memcpy
+            if (!r.a0 || (int32_t(r.a2) <= 0)) {
+                r.v0 = 0;
+                break;
+            }
+            if (!copy(r.a0, r.a1, r.a2)) return false;
+            r.v0 = r.a0;
+            break;
+        }
+        case 0x2b: {  // memset
+            if (!r.a0 || (int32_t(r.a2) <= 0)) {
+                r.v0 = 0;
+                break;
+            }
+            if (!fill(r.a0, r.a1, r.a2)) return false;
+            r.v0 = r.a0;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    m_regs.cycle += cost * Emulator::BIAS;
+    m_regs.pc = r.ra;
+    return true;
+}
+
+std::shared_ptr<PCSX::R3000Acpu::PCdrvFile::Window> PCSX::R3000Acpu::PCdrvFile::fetch(size_t offset, size_t size) {
+    auto window = std::make_shared<Window>();
+    window->offset = offset;
+    window->size = size;
+    Slice buffer;
+    buffer.resize(size);
+    // The callback runs on the uv thread, and keeps the window alive if it got dropped in the meantime.
+    (*this)->readAtAsync(std::move(buffer), offset, [window](Slice&& data) {
+        window->data = std::move(data);
+        window->done.store(true, std::memory_order_release);
+        window->done.notify_all();
+    });
+    return window;
+}
+
+bool PCSX::R3000Acpu::PCdrvFile::prefetched(size_t pos, size_t size) {
+    const size_t end = pos + size;
+    size_t covered = pos;
+    if (covered >= end) return true;
+    for (auto& window : m_windows) {
+        if (!window || (covered < window->offset) || (covered >= window->offset + window->size)) continue;
+        if (!window->done.load(std::memory_order_acquire)) return false;
+        covered = window->offset + window->data.size();
+        // A short window means the end of the file.
+        if ((covered >= end) || (window->data.size() < window->size)) return true;
+    }
+    m_windows[0] = fetch(pos, std::max(size, c_pcdrvWindowSize));
+    m_windows[1].reset();
+    return false;
+}
+
+size_t PCSX::R3000Acpu::PCdrvFile::consume(size_t pos, size_t size, uint32_t address, IO<File> memFile) {
+    size_t copied = 0;
+    for (auto& window : m_windows) {
+        const size_t at = pos + copied;
+        if (!window || (copied == size) || (at < window->offset)) continue;
+        if (at >= window->offset + window->data.size()) continue;
+        const size_t skip = at - window->offset;
+        const size_t chunk = std::min(size - copied, window->data.size() - skip);
+        auto src = reinterpret_cast<const uint8_t*>(window->data.data()) + skip;
+        const uint32_t dest = address + copied;
+        uint8_t* ram = hleRAM(dest, chunk);
+        if (ram) {
+            memcpy(ram, src, chunk);
+            hleWritten(dest, chunk);
+        } else {
+            memFile->writeAt(src, chunk, dest);
+        }
+        copied += chunk;
+    }
+    if (copied < size) return copied;
+
+    // Past the first window, the second one takes its place, and the one after gets fetched right away, so that
+    // sequential reads find their data already there.
+    const size_t end = pos + copied;
+    if (m_windows[0] && (end >= m_windows[0]->offset + m_windows[0]->size)) {
+        m_windows[0] = std::move(m_windows[1]);
+        m_windows[1].reset();
+    }
+    if (!m_windows[0]) m_windows[0] = fetch(end, c_pcdrvWindowSize);
+    auto& first = m_windows[0];
+    const bool lastWindow = first->done.load(std::memory_order_acquire) && (first->data.size() < first->size);
+    if (!m_windows[1] && !lastWindow) m_windows[1] = fetch(first->offset + first->size, c_pcdrvWindowSize);
+    return copied;
+}
+
+void PCSX::R3000Acpu::PCdrvFile::waitWindows() {
+    for (auto& window : m_windows) {
+        if (window) window->done.wait(false, std::memory_order_acquire);
+    }
+}
+
+void PCSX::R3000Acpu::rebuildSymbolIndex() {
+    m_symbolIndexAddresses.clear();
+    m_symbolIndexEntries.clear();
+    m_symbolIndexAddresses.reserve(m_symbols.size());
+    m_symbolIndexEntries.reserve(m_symbols.size());
+    for (auto& symbol : m_symbols) {
+        m_symbolIndexAddresses.push_back(symbol.first);
+        m_symbolIndexEntries.push_back(&symbol);
+    }
+    m_symbolIndexGeneration = m_symbolsGeneration;
+}
+
 std::pair<const uint32_t, std::string>* PCSX::R3000Acpu::findContainingSymbol(uint32_t addr) {
-    auto symBefore = m_symbols.upper_bound(addr);
-    if (symBefore != m_symbols.begin()) {  // verify there is actually a symbol before addr
+    if (m_symbolIndexGeneration != m_symbolsGeneration) rebuildSymbolIndex();
+    auto symBefore = std::upper_bound(m_symbolIndexAddresses.begin(), m_symbolIndexAddresses.end(), addr);
+    if (symBefore != m_symbolIndexAddresses.begin()) {  // verify there is actually a symbol before addr
         symBefore--;
-        if (symBefore->first != addr) {
+        if (*symBefore != addr) {
             PCSX::PSXAddress addrInfo(addr);
-            PCSX::PSXAddress symbolInfo(symBefore->first);
+            PCSX::PSXAddress symbolInfo(*symBefore);
             if (addrInfo.segment != symbolInfo.segment) {
                 // if the symbol is different and not in the same memory region, it'd be wrong
                 return nullptr;
             }
         }
-        return &*symBefore;
+        return m_symbolIndexEntries[symBefore - m_symbolIndexAddresses.begin()];
     }
     return nullptr;
 }
 
 std::string* PCSX::R3000Acpu::getSymbolAt(uint32_t addr) {
-    auto symBefore = m_symbols.find(addr);
-    if (symBefore != m_symbols.end()) {
-        return &symBefore->second;
+    if (m_symbolIndexGeneration != m_symbolsGeneration) rebuildSymbolIndex();
+    auto sym = std::lower_bound(m_symbolIndexAddresses.begin(), m_symbolIndexAddresses.end(), addr);
+    if ((sym != m_symbolIndexAddresses.end()) && (*sym == addr)) {
+        return &m_symbolIndexEntries[sym - m_symbolIndexAddresses.begin()]->second;
     }
     return nullptr;
 }
@@ -25,8 +25,10 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "core/kernel.h"
 #include "core/psxcounters.h"
@@ -189,7 +191,8 @@ enum {
     PSXINT_SPUASYNC,
     PSXINT_CDRDBUF,
     PSXINT_CDRLID,
-    PSXINT_CDRPLAY
+    PSXINT_CDRPLAY,
+    PSXINT_PROFILER
 };
 
 struct psxRegisters {
@@ -204,7 +207,10 @@ struct psxRegisters {
     uint32_t interrupt;
     std::atomic<bool> spuInterrupt;
     uint64_t intTargets[32];
-    uint64_t lowestTarget;
+    uint64_t lowestTarget;     // Earliest target among the pending intTargets
+    uint64_t nextEventTarget;  // Earliest of lowestTarget and the next root counter deadline
+    // The instruction cache, as save states carry it: the address of each word, then its opcode, as little
+    // endian. This only gets filled in from R3000Acpu::m_iCache when saving, and read back when loading.
     uint8_t iCacheAddr[0x1000];
     uint8_t iCacheCode[0x1000];
 };
@@ -285,10 +291,42 @@ class R3000Acpu {
     // For the GUI dynarec disassembly widget
     virtual const uint8_t *getBufferPtr() = 0;
     virtual const size_t getBufferSize() = 0;
+    // How much code the buffer can hold, for the performance overlay
+    virtual const size_t getBufferCapacity() = 0;
+    // The parts of the buffer which fill up and get flushed on their own, if the CPU splits it. Offsets are
+    // relative to getBufferPtr, and the counters go since the CPU got initialized.
+    struct CodeBufferRegion {
+        const char *name;
+        size_t start;
+        size_t used;
+        size_t capacity;
+        uint64_t compiles;
+        uint64_t bytes;
+        uint64_t flushes;
+    };
+    virtual std::vector<CodeBufferRegion> getCodeBufferRegions() { return {}; }
+    // How the blocks entered with a load from the previous one still pending went, for the CPUs compiling them
+    // without load delay emulation. The counters go since the CPU got initialized.
+    struct LoadDelayStats {
+        // The first instruction of the block had nothing to do with the loaded register, so the load landed first.
+        uint64_t resolvedAtEntry = 0;
+        // It did, so the block got entered through its variant emulating load delays, which got compiled this many
+        // times.
+        uint64_t fullEntries = 0;
+        uint64_t fullCompiles = 0;
+    };
+    virtual LoadDelayStats getLoadDelayStats() { return {}; }
+    // One bit per word of RAM the compiled blocks currently come from, least significant bit first, for the
+    // debugging tools to see what ran. Empty when the CPU doesn't keep track of that.
+    virtual std::span<const uint64_t> getCodeCoverage() { return {}; }
 
     const std::string &getName() { return m_name; }
 
     std::map<uint32_t, std::string> m_symbols;
+    // Anything touching m_symbols needs to call this afterwards, so that the
+    // flat lookup index below gets rebuilt, and the GUI caches get dropped.
+    void symbolsChanged() { m_symbolsGeneration++; }
+    uint64_t symbolsGeneration() const { return m_symbolsGeneration; }
 
     std::pair<const uint32_t, std::string> *findContainingSymbol(uint32_t addr);
     std::string *getSymbolAt(uint32_t addr);
@@ -315,6 +353,25 @@ class R3000Acpu {
     }
     void exception(uint32_t code, bool bd, bool cop0 = false);
     void branchTest();
+    void processScheduledEvents();
+
+    // Anything that can produce an event calls this with its deadline, so that branchTest
+    // only has to compare the current cycle against a single target. It is fine for the
+    // deadline to be early; processScheduledEvents will recompute it from scratch.
+    void scheduleEventTarget(uint64_t target) {
+        if (target < m_regs.nextEventTarget) m_regs.nextEventTarget = target;
+    }
+
+    // Idle loops are short loops polling memory which only an event can change, such as waiting on a vsync
+    // flag set by an interrupt handler. The loop going from start to the branch at branchPC, and the branch
+    // going back to start, checks that it doesn't compute anything from one iteration to the next, and that
+    // it only loads from RAM, the scratchpad, or I_STAT. Without checkAddresses, only the code gets looked at,
+    // for the recompilers to know whether they should bother checking at runtime.
+    bool isIdleLoop(uint32_t start, uint32_t branchPC, bool checkAddresses = true);
+    // Nothing can happen in an idle loop until the next event, so the time spent spinning can go at once.
+    void skipIdleLoop() {
+        if (m_regs.cycle < m_regs.nextEventTarget) m_regs.cycle = m_regs.nextEventTarget;
+    }
 
     void psxSetPGXPMode(uint32_t pgxpMode);
 
@@ -326,16 +383,18 @@ class R3000Acpu {
         m_regs.interrupt |= (1 << interrupt);
         m_regs.intTargets[interrupt] = target;
         if (target < m_regs.lowestTarget) m_regs.lowestTarget = target;
+        scheduleEventTarget(target);
     }
 
     psxRegisters m_regs;
-    float m_interruptScales[15] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-                                   1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    float m_interruptScales[16] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+                                   1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
     bool m_shellStarted = false;
 
     virtual void Reset() {
         invalidateCache();
         m_regs.interrupt = 0;
+        m_notIdleLoop = {};
     }
     bool m_inISR = false;
     bool m_nextIsDelaySlot = false;
@@ -404,18 +463,23 @@ class R3000Acpu {
     }
     void processA0KernelCall(uint32_t call);
     void processB0KernelCall(uint32_t call);
+    // Runs the A0 libc call natively if it's one of the few which only touch their arguments, charging roughly
+    // what the BIOS code would have cost, and returning to $ra. Returns false if the BIOS has to run it instead.
+    bool hleA0KernelCall(uint32_t call);
     void logA0KernelCall(uint32_t call);
     void logB0KernelCall(uint32_t call);
     void logC0KernelCall(uint32_t call);
+    void queueKernelCall(uint32_t vector, uint32_t call);
 
   public:
+    // Returns true if the call got emulated natively, in which case the pc is now the caller's $ra.
     template <bool checkPC = true>
-    inline void InterceptBIOS(uint32_t currentPC) {
+    inline bool InterceptBIOS(uint32_t currentPC) {
         const uint32_t pc = currentPC & g_emulator->getRamMask();
 
         if constexpr (checkPC) {
             const uint32_t base = (currentPC >> 20) & 0xffc;
-            if ((base != 0x000) && (base != 0x800) && (base != 0xa00)) return;
+            if ((base != 0x000) && (base != 0x800) && (base != 0xa00)) return false;
         }
 
         auto r = m_regs.GPR.n;
@@ -436,6 +500,7 @@ class R3000Acpu {
                 processB0KernelCall(call);
                 break;
         }
+        if (pc == 0xa0 || pc == 0xb0 || pc == 0xc0) queueKernelCall(pc, call);
 
         if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::KernelLog>()) {
             switch (pc) {
@@ -450,6 +515,13 @@ class R3000Acpu {
                     break;
             }
         }
+
+        // Stepping through the BIOS with the debugger should still be possible.
+        if ((pc == 0xa0) && g_emulator->settings.get<Emulator::SettingBiosHLE>() &&
+            !g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+            return hleA0KernelCall(call);
+        }
+        return false;
     }
 
     /*
@@ -458,91 +530,104 @@ Formula One 2001
   updated with new code (affects in-game racing)
 */
 
-    virtual void invalidateCache() {
-        memset(m_regs.iCacheAddr, 0xff, sizeof(m_regs.iCacheAddr));
-        memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
+    virtual void invalidateCache() { invalidateICache(); }
+
+    // Called when an execution breakpoint gets added on this range, for the CPUs caching compiled code
+    virtual void invalidateBreakpoint(uint32_t address, uint32_t width) {}
+
+    // The emulated instruction cache, which only covers the cached RAM segments: 256 lines of 4 words, indexed
+    // by bits 4 to 11 of the address. The tag of a line is the low 24 bits of the address of its first word,
+    // which is never 16 bytes aligned for invalid lines.
+    static constexpr uint32_t c_invalidICacheTag = 0xffffffff;
+    struct ICacheLine {
+        uint32_t tag = c_invalidICacheTag;
+        uint32_t words[4] = {};
+    };
+    ICacheLine m_iCache[256];
+
+    static bool isICached(uint32_t pc) {
+        const uint32_t pcBank = pc >> 24;
+        return (pcBank == 0x00) || (pcBank == 0x80);
     }
+    ICacheLine &iCacheLine(uint32_t pc) { return m_iCache[(pc >> 4) & 0xff]; }
+    static uint32_t iCacheTag(uint32_t pc) { return pc & 0xfffff0; }
 
+    void invalidateICache() {
+        for (auto &line : m_iCache) line.tag = c_invalidICacheTag;
+    }
     inline void flushICacheLine(uint32_t pc) {
-        uint32_t pcBank = pc >> 24;
-        if (pcBank == 0x00 || pcBank == 0x80) {
-            uint32_t pcCache = pc & 0xfff;
-            pcCache &= ~0xf;
-
-            uint8_t *iAddr = m_regs.iCacheAddr;
-            uint8_t *iCode = m_regs.iCacheCode;
-
-            *(uint32_t *)(iAddr + pcCache + 0x0) = 0xff;
-            *(uint32_t *)(iAddr + pcCache + 0x4) = 0xff;
-            *(uint32_t *)(iAddr + pcCache + 0x8) = 0xff;
-            *(uint32_t *)(iAddr + pcCache + 0xc) = 0xff;
-
-            *(uint32_t *)(iCode + pcCache + 0x0) = 0xff;
-            *(uint32_t *)(iCode + pcCache + 0x4) = 0xff;
-            *(uint32_t *)(iCode + pcCache + 0x8) = 0xff;
-            *(uint32_t *)(iCode + pcCache + 0xc) = 0xff;
-        }
+        if (isICached(pc)) iCacheLine(pc).tag = c_invalidICacheTag;
     }
+    void fillICacheLine(ICacheLine &line, uint32_t pc);
+    // Going from and to the save states' layout, see psxRegisters.
+    void saveICache();
+    void loadICache();
 
     inline uint32_t readICache(uint32_t pc) {
-        uint32_t pcBank = pc >> 24;
-
-        // cached - RAM
-        if (pcBank == 0x00 || pcBank == 0x80) {
-            uint32_t pcOffset = pc & 0xffffff;
-            uint32_t pcCache = pc & 0xfff;
-
-            uint8_t *iAddr = m_regs.iCacheAddr;
-            uint8_t *iCode = m_regs.iCacheCode;
-            if (SWAP_LE32(*(uint32_t *)(iAddr + pcCache)) == pcOffset) {
-                // Cache hit - return last opcode used
-                return SWAP_LE32(*((uint32_t *)(iCode + pcCache)));
-            } else {
-                // Cache miss - addresses don't match
-                // - default: 0xffffffff (not init)
-
-                // cache line is 4 words wide
-                pcOffset &= ~0xf;
-                pcCache &= ~0xf;
-
-                // address line
-                *(uint32_t *)(iAddr + pcCache + 0x0) = SWAP_LE32(pcOffset + 0x0);
-                *(uint32_t *)(iAddr + pcCache + 0x4) = SWAP_LE32(pcOffset + 0x4);
-                *(uint32_t *)(iAddr + pcCache + 0x8) = SWAP_LE32(pcOffset + 0x8);
-                *(uint32_t *)(iAddr + pcCache + 0xc) = SWAP_LE32(pcOffset + 0xc);
-
-                // opcode line
-                pcOffset = pc & ~0xf;
-                *(uint32_t *)(iCode + pcCache + 0x0) =
-                    g_emulator->m_mem->read32(pcOffset + 0x0, Memory::ReadType::Instr);
-                *(uint32_t *)(iCode + pcCache + 0x4) =
-                    g_emulator->m_mem->read32(pcOffset + 0x4, Memory::ReadType::Instr);
-                *(uint32_t *)(iCode + pcCache + 0x8) =
-                    g_emulator->m_mem->read32(pcOffset + 0x8, Memory::ReadType::Instr);
-                *(uint32_t *)(iCode + pcCache + 0xc) =
-                    g_emulator->m_mem->read32(pcOffset + 0xc, Memory::ReadType::Instr);
+        if (isICached(pc)) {
+            ICacheLine &line = iCacheLine(pc);
+            if (line.tag != iCacheTag(pc)) [[unlikely]] {
+                fillICacheLine(line, pc);
             }
+            return line.words[(pc >> 2) & 3];
         }
-
-        // default
         return g_emulator->m_mem->read32(pc, Memory::ReadType::Instr);
     }
 
   private:
     const std::string m_name;
 
+    // The last loop which got turned down for its code alone, as the same one tends to be asked about
+    // again and again. Loops turned down for what they load aren't remembered, as that can change.
+    struct {
+        uint32_t start = 0;
+        uint32_t branchPC = 0;
+    } m_notIdleLoop;
+
+    // Sorted addresses of m_symbols, alongside pointers to the map's nodes,
+    // so that lookups are a binary search over a contiguous array instead
+    // of a walk through the tree. Rebuilt lazily when the generation moves.
+    void rebuildSymbolIndex();
+    std::vector<uint32_t> m_symbolIndexAddresses;
+    std::vector<std::pair<const uint32_t, std::string> *> m_symbolIndexEntries;
+    uint64_t m_symbolsGeneration = 1;
+    uint64_t m_symbolIndexGeneration = 0;
+
     struct PCdrvFile;
     typedef Intrusive::HashTable<uint32_t, PCdrvFile> PCdrvFiles;
+    // The host files are UvFiles: writes go out on the uv thread without the emulation waiting for them, and reads
+    // are done ahead of the guest asking for them, in windows of c_pcdrvWindowSize bytes. A read which isn't
+    // entirely within windows the uv thread is done with stalls the guest on its break instruction, so that
+    // emulated time goes on while the host is busy, instead of the emulation thread blocking.
+    static constexpr size_t c_pcdrvWindowSize = 256 * 1024;
     struct PCdrvFile : public IO<File>, public PCdrvFiles::Node {
-        PCdrvFile(const std::filesystem::path &filename) : IO<File>(new PosixFile(filename)) {}
-        PCdrvFile(const std::filesystem::path &filename, FileOps::ReadWrite)
-            : IO<File>(new PosixFile(filename, FileOps::READWRITE)) {}
-        PCdrvFile(const std::filesystem::path &filename, FileOps::Truncate)
-            : IO<File>(new PosixFile(filename, FileOps::TRUNCATE)) {}
-        PCdrvFile(const std::filesystem::path &filename, FileOps::Create)
-            : IO<File>(new PosixFile(filename, FileOps::CREATE)) {}
+        PCdrvFile(File *file) : IO<File>(file) {}
         virtual ~PCdrvFile() = default;
         std::string m_relativeFilename;
+
+        struct Window {
+            size_t offset;
+            size_t size;
+            Slice data;
+            std::atomic<bool> done = false;
+        };
+        // Returns true once the range is in windows the uv thread is done with, or if these reach the end of
+        // the file. Otherwise, fetches whatever is missing, and returns false.
+        bool prefetched(size_t pos, size_t size);
+        // Copies the range into the guest memory, and slides the windows forward.
+        size_t consume(size_t pos, size_t size, uint32_t address, IO<File> memFile);
+        // Blocks until the uv thread is done with the windows in flight.
+        void waitWindows();
+        // Called when the file gets written to, since the windows may not have what's in it anymore.
+        void dropWindows() {
+            m_windows[0].reset();
+            m_windows[1].reset();
+        }
+
+      private:
+        std::shared_ptr<Window> fetch(size_t offset, size_t size);
+        // The one being consumed, and the one right after it.
+        std::shared_ptr<Window> m_windows[2];
     };
     PCdrvFiles m_pcdrvFiles;
     std::list<uint16_t> m_availableFDs;
@@ -0,0 +1,243 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/rewind.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+PCSX::Rewind::Rewind() {
+    m_thread = std::thread([this]() { worker(); });
+}
+
+PCSX::Rewind::~Rewind() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void PCSX::Rewind::setMemoryBudget(size_t bytes) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+    trim();
+}
+
+void PCSX::Rewind::setKeyframeInterval(unsigned interval) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_keyframeInterval = std::max(interval, 1u);
+}
+
+void PCSX::Rewind::capture(std::string&& state) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_forked || (m_pending.size() >= c_maxPending)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_pending.push_back(std::move(state));
+    }
+    m_cv.notify_all();
+}
+
+void PCSX::Rewind::waitForWorker(std::unique_lock<std::mutex>& lock) {
+    m_cv.wait(lock, [this]() { return m_pending.empty() && !m_busy; });
+}
+
+std::string PCSX::Rewind::rewind(unsigned steps) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitForWorker(lock);
+    if ((steps == 0) || m_snapshots.empty()) return {};
+    size_t index = m_snapshots.size() - std::min(size_t(steps), m_snapshots.size());
+    std::string state = restore(index);
+    while (m_snapshots.size() > index) {
+        auto& snapshot = m_snapshots.back();
+        if (snapshot.keyframe) m_keyframes--;
+        m_memoryUsed -= snapshot.data.size();
+        m_snapshots.pop_back();
+    }
+    // The keyframe the next deltas would be made against may be gone; start over with a new one.
+    m_memoryUsed -= m_keyframe.size();
+    m_keyframe.clear();
+    m_keyframe.shrink_to_fit();
+    m_sinceKeyframe = 0;
+    return state;
+}
+
+void PCSX::Rewind::clear() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitForWorker(lock);
+    m_snapshots.clear();
+    m_keyframes = 0;
+    m_keyframe.clear();
+    m_keyframe.shrink_to_fit();
+    m_sinceKeyframe = 0;
+    m_memoryUsed = 0;
+}
+
+void PCSX::Rewind::prepareFork() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitForWorker(lock);
+    lock.release();
+}
+
+void PCSX::Rewind::afterFork(bool child) {
+    if (child) m_forked = true;
+    m_mutex.unlock();
+}
+
+size_t PCSX::Rewind::count() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_snapshots.size();
+}
+
+size_t PCSX::Rewind::memoryUsed() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_memoryUsed;
+}
+
+void PCSX::Rewind::worker() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+        if (m_stop) return;
+        std::string state = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_busy = true;
+        bool keyframe = m_keyframe.empty() || (++m_sinceKeyframe >= m_keyframeInterval);
+        lock.unlock();
+
+        Snapshot snapshot;
+        if (keyframe) {
+            snapshot.keyframe = true;
+            snapshot.size = snapshot.deflatedSize = state.size();
+            snapshot.data = deflate(state);
+        } else {
+            snapshot = makeDelta(state);
+        }
+
+        lock.lock();
+        if (keyframe) {
+            m_memoryUsed -= m_keyframe.size();
+            m_keyframe = std::move(state);
+            m_memoryUsed += m_keyframe.size();
+            m_sinceKeyframe = 0;
+            m_keyframes++;
+        }
+        m_memoryUsed += snapshot.data.size();
+        m_snapshots.push_back(std::move(snapshot));
+        trim();
+        m_busy = false;
+        m_cv.notify_all();
+    }
+}
+
+// A bitmap of the pages which are different from the keyframe, followed by these pages XORed against it.
+// Whatever is past the end of the keyframe is compared against zeroes.
+PCSX::Rewind::Snapshot PCSX::Rewind::makeDelta(const std::string& state) {
+    const size_t pages = (state.size() + c_pageSize - 1) / c_pageSize;
+    const size_t bitmapSize = (pages + 7) / 8;
+    std::string delta(bitmapSize, '\0');
+    delta.reserve(bitmapSize + state.size() / 4);
+    uint8_t reference[c_pageSize];
+
+    for (size_t page = 0; page < pages; page++) {
+        const size_t offset = page * c_pageSize;
+        const size_t length = std::min(c_pageSize, state.size() - offset);
+        const uint8_t* current = reinterpret_cast<const uint8_t*>(state.data()) + offset;
+        memset(reference, 0, length);
+        if (offset < m_keyframe.size()) {
+            memcpy(reference, m_keyframe.data() + offset, std::min(length, m_keyframe.size() - offset));
+        }
+        if (memcmp(current, reference, length) == 0) continue;
+        delta[page / 8] |= char(1 << (page % 8));
+        for (size_t i = 0; i < length; i++) reference[i] ^= current[i];
+        delta.append(reinterpret_cast<const char*>(reference), length);
+    }
+
+    Snapshot snapshot;
+    snapshot.keyframe = false;
+    snapshot.size = state.size();
+    snapshot.deflatedSize = delta.size();
+    snapshot.data = deflate(delta);
+    return snapshot;
+}
+
+std::string PCSX::Rewind::restore(size_t index) {
+    size_t keyframeIndex = index;
+    while (!m_snapshots[keyframeIndex].keyframe) keyframeIndex--;
+    const auto& keyframe = m_snapshots[keyframeIndex];
+    std::string state = inflate(keyframe.data, keyframe.deflatedSize);
+    if (keyframeIndex == index) return state;
+
+    const auto& snapshot = m_snapshots[index];
+    std::string delta = inflate(snapshot.data, snapshot.deflatedSize);
+    state.resize(snapshot.size);
+    const size_t pages = (snapshot.size + c_pageSize - 1) / c_pageSize;
+    const uint8_t* bitmap = reinterpret_cast<const uint8_t*>(delta.data());
+    const uint8_t* changes = bitmap + (pages + 7) / 8;
+    for (size_t page = 0; page < pages; page++) {
+        if ((bitmap[page / 8] & (1 << (page % 8))) == 0) continue;
+        const size_t offset = page * c_pageSize;
+        const size_t length = std::min(c_pageSize, snapshot.size - offset);
+        uint8_t* target = reinterpret_cast<uint8_t*>(state.data()) + offset;
+        for (size_t i = 0; i < length; i++) target[i] ^= changes[i];
+        changes += length;
+    }
+    return state;
+}
+
+void PCSX::Rewind::trim() {
+    // The keyframe with the most recent deltas always stays, even if it alone is over the budget.
+    while ((m_memoryUsed > m_memoryBudget) && (m_keyframes > 1)) {
+        do {
+            m_memoryUsed -= m_snapshots.front().data.size();
+            m_snapshots.pop_front();
+        } while (!m_snapshots.front().keyframe);
+        m_keyframes--;
+    }
+}
+
+std::string PCSX::Rewind::deflate(std::string_view data) {
+    uLongf size = compressBound(data.size());
+    std::string ret(size, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(ret.data()), &size, reinterpret_cast<const Bytef*>(data.data()),
+                  data.size(), Z_BEST_SPEED) != Z_OK) {
+        throw std::runtime_error("Rewind: unable to compress snapshot");
+    }
+    ret.resize(size);
+    ret.shrink_to_fit();
+    return ret;
+}
+
+std::string PCSX::Rewind::inflate(const std::string& data, size_t size) {
+    std::string ret(size, '\0');
+    uLongf outSize = size;
+    if ((uncompress(reinterpret_cast<Bytef*>(ret.data()), &outSize, reinterpret_cast<const Bytef*>(data.data()),
+                    data.size()) != Z_OK) ||
+        (outSize != size)) {
+        throw std::runtime_error("Rewind: corrupted snapshot");
+    }
+    return ret;
+}
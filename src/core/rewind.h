@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace PCSX {
+
+// Keeps the last moments of emulation around as a ring of save states, so that it can be stepped back
+// through. Each save state captured gets compared against the last keyframe, 4KB page by page: only the
+// pages which changed are kept, XORed against the keyframe, and the whole is deflated on a worker thread,
+// so that the emulation thread only pays for SaveStates::save(). Every so often, a save state is kept
+// whole as a new keyframe, so that getting any of them back only needs to undo one keyframe and one delta.
+// The oldest keyframe, with all of its deltas, goes away when the memory budget runs out.
+class Rewind {
+  public:
+    static constexpr size_t c_pageSize = 4096;
+
+    Rewind();
+    ~Rewind();
+
+    // This counts the compressed snapshots, and the uncompressed keyframe new deltas are made against.
+    void setMemoryBudget(size_t bytes);
+    // One snapshot out of this many gets stored as a keyframe.
+    void setKeyframeInterval(unsigned interval);
+
+    // Hands over a save state, as made by SaveStates::save(), to the worker thread. This never waits:
+    // if the worker is falling behind by more than a few save states already, this one gets dropped.
+    void capture(std::string&& state);
+    // Throws away the last steps snapshots, and returns the oldest of these, for SaveStates::load().
+    // Returns an empty string if there's nothing to go back to. Waits for the worker to be done first.
+    std::string rewind(unsigned steps = 1);
+    void clear();
+    // Waits for the worker, and keeps it away until afterFork(), so that it can't be in the middle of anything
+    // when forking. The child has no worker thread: what it captures gets dropped.
+    void prepareFork();
+    void afterFork(bool child);
+
+    size_t count();
+    size_t memoryUsed();
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr unsigned c_maxPending = 4;
+
+    struct Snapshot {
+        bool keyframe;
+        // The size of the save state, and of what deflating has been done on.
+        size_t size;
+        size_t deflatedSize;
+        std::string data;
+    };
+
+    void worker();
+    Snapshot makeDelta(const std::string& state);
+    std::string restore(size_t index);
+    void trim();
+    void waitForWorker(std::unique_lock<std::mutex>& lock);
+
+    static std::string deflate(std::string_view data);
+    static std::string inflate(const std::string& data, size_t size);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_pending;
+    bool m_busy = false;
+    bool m_stop = false;
+    bool m_forked = false;
+
+    std::deque<Snapshot> m_snapshots;
+    unsigned m_keyframes = 0;
+    size_t m_memoryUsed = 0;
+    size_t m_memoryBudget = 256 * 1024 * 1024;
+    unsigned m_keyframeInterval = 30;
+    // Only touched by the worker, or while it's waited on.
+    std::string m_keyframe;
+    unsigned m_sinceKeyframe = 0;
+
+    std::atomic<uint64_t> m_dropped = 0;
+    std::thread m_thread;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/runahead.h"
+
+#include <algorithm>
+
+#include "core/psxemulator.h"
+#include "core/spu.h"
+#include "core/sstate.h"
+#include "core/system.h"
+
+PCSX::RunAhead::RunAhead() : m_listener(g_system->m_eventBus) {
+    // Whatever happened to the machine while presenting is what counts from now on
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { abandon(); });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) { abandon(); });
+}
+
+void PCSX::RunAhead::start(unsigned frames) {
+    const auto start = Clock::now();
+    m_snapshot = SaveStates::snapshot();
+    g_emulator->m_spu->setAudioSuppressed(true);
+    m_frames = std::max(frames, 1u);
+    m_ahead = 1;
+    m_aheadStart = Clock::now();
+    m_timings.snapshot[m_timings.index] = microseconds(m_aheadStart - start);
+}
+
+bool PCSX::RunAhead::frameDone() {
+    if (m_ahead++ < m_frames) return false;
+    m_timings.ahead[m_timings.index] = microseconds(Clock::now() - m_aheadStart);
+    return true;
+}
+
+void PCSX::RunAhead::finish() {
+    if (!m_ahead) return;
+    const auto start = Clock::now();
+    SaveStates::rollback(m_snapshot);
+    m_timings.restore[m_timings.index] = microseconds(Clock::now() - start);
+    m_timings.frames = m_frames;
+    m_timings.index = (m_timings.index + 1) % c_timings;
+    abandon();
+}
+
+void PCSX::RunAhead::abandon() {
+    if (!m_ahead) return;
+    m_ahead = 0;
+    g_emulator->m_spu->setAudioSuppressed(false);
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Hides some of the input latency of games by emulating a few frames ahead of what's shown. At the end of each
+// frame, the machine gets saved, the next frames get emulated with whatever the pads are at right now, and the
+// last of them is presented before going back to the saved state. So these frames are only there to be looked at:
+// the VSync event, rewind, and audio only ever see the frames which are emulated for real.
+//
+// Going back only copies the pages of RAM, VRAM and SPU RAM which were written to while running ahead, out of
+// the saved state, which means their dirty maps get cleared at each frame while this is on.
+class RunAhead {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr unsigned c_timings = 240;
+
+    static constexpr unsigned c_maxFrames = 8;
+
+    // How long each part of the last frames took, in microseconds. These are rings, the next frame going at index,
+    // so index is also where the oldest one is.
+    struct Timings {
+        float snapshot[c_timings] = {};
+        float ahead[c_timings] = {};
+        float restore[c_timings] = {};
+        unsigned index = 0;
+        // How many frames ahead the last one ran.
+        unsigned frames = 0;
+    };
+
+    RunAhead();
+
+    // Whether the frame being emulated is one of the frames ahead, which are thrown away afterwards.
+    bool isAhead() const { return m_ahead != 0; }
+
+    // Called at the end of a frame emulated for real, to start running ahead of it by this many frames.
+    void start(unsigned frames);
+    // Called at the end of a frame emulated ahead. Returns true when it was the last one, in which case it
+    // now needs presenting, before calling finish().
+    bool frameDone();
+    // Goes back to the state saved by start().
+    void finish();
+
+    const Timings& getTimings() const { return m_timings; }
+
+  private:
+    void abandon();
+    static float microseconds(Clock::duration duration) {
+        return std::chrono::duration<float, std::micro>(duration).count();
+    }
+
+    std::string m_snapshot;
+    unsigned m_ahead = 0;
+    unsigned m_frames = 0;
+    Clock::time_point m_aheadStart;
+    Timings m_timings;
+
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
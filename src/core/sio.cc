@@ -43,6 +43,19 @@ void PCSX::SIO::acknowledge() {
     }
 }
 
+PCSX::SIO::SIO() : m_listener(g_system->m_eventBus) {
+    reset();
+    m_listener.listen<Events::GPU::VSync>([this](const auto &event) {
+        for (auto &card : m_memoryCard) card.idle();
+    });
+    m_listener.listen<Events::Quitting>([this](const auto &event) {
+        for (auto &card : m_memoryCard) {
+            card.flush();
+            card.waitFlush();
+        }
+    });
+}
+
 void PCSX::SIO::init() {
     reset();
     togglePocketstationMode();
@@ -99,6 +112,7 @@ void PCSX::SIO::reset() {
     m_regs.control = 0;
     m_regs.baud = 0;
     m_bufferIndex = 0;
+    m_padPrefetched = false;
     m_memoryCard[0].deselect();
     m_memoryCard[1].deselect();
     m_currentDevice = DeviceType::None;
@@ -130,6 +144,7 @@ void PCSX::SIO::writePad(uint8_t value) {
 
             m_maxBufferIndex = 2;
             m_bufferIndex = 0;
+            m_padPrefetched = false;
             m_padState = Pads::PAD_STATE_READ_COMMAND;
             break;
 
@@ -150,21 +165,35 @@ void PCSX::SIO::writePad(uint8_t value) {
             } else {
                 m_maxBufferIndex = 2 + (m_buffer[m_bufferIndex] & 0x0f) * 2;
             }
+
+            // Nothing the console sends during a read changes its response, so all of it gets polled now.
+            if (m_fastPath && (value == PAD_Commands::Read) && (m_padState == Pads::PAD_STATE_READ_DATA)) {
+                const auto port = (m_regs.control & ControlFlags::WHICH_PORT) == SelectedPort::Port1
+                                      ? Pads::Port::Port1
+                                      : Pads::Port::Port2;
+                PCSX::g_emulator->m_pads->pollResponse(port, m_buffer + 2, m_maxBufferIndex - 1);
+                m_padPrefetched = true;
+            }
             break;
 
         case Pads::PAD_STATE_READ_DATA:
             m_bufferIndex++;
-            switch (m_regs.control & ControlFlags::WHICH_PORT) {
-                case SelectedPort::Port1:
-                    m_buffer[m_bufferIndex] = PCSX::g_emulator->m_pads->poll(value, Pads::Port::Port1, m_padState);
-                    break;
-                case SelectedPort::Port2:
-                    m_buffer[m_bufferIndex] = PCSX::g_emulator->m_pads->poll(value, Pads::Port::Port2, m_padState);
-                    break;
+            if (!m_padPrefetched) {
+                switch (m_regs.control & ControlFlags::WHICH_PORT) {
+                    case SelectedPort::Port1:
+                        m_buffer[m_bufferIndex] =
+                            PCSX::g_emulator->m_pads->poll(value, Pads::Port::Port1, m_padState);
+                        break;
+                    case SelectedPort::Port2:
+                        m_buffer[m_bufferIndex] =
+                            PCSX::g_emulator->m_pads->poll(value, Pads::Port::Port2, m_padState);
+                        break;
+                }
             }
 
             if (m_bufferIndex == m_maxBufferIndex) {
                 m_padState = Pads::PAD_STATE_IDLE;
+                m_padPrefetched = false;
                 m_currentDevice = DeviceType::Ignore;
                 return;
             }
@@ -186,6 +215,7 @@ void PCSX::SIO::transmitData() {
 
     if (m_currentDevice == DeviceType::None) {
         m_currentDevice = m_regs.data;
+        m_fastPath = !g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>();
     }
 
     switch (m_currentDevice) {
@@ -200,7 +230,7 @@ void PCSX::SIO::transmitData() {
                 case SelectedPort::Port1:
                     if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingMcd1Inserted>()) {
                         m_rxBuffer = m_memoryCard[0].transceive(m_regs.data);
-                        if (m_memoryCard[0].dataChanged()) {
+                        if (m_memoryCard[0].sectorWritten()) {
                             m_memoryCard[0].commit(
                                 PCSX::g_emulator->settings.get<PCSX::Emulator::SettingMcd1>().string().c_str());
                         }
@@ -214,7 +244,7 @@ void PCSX::SIO::transmitData() {
                 case SelectedPort::Port2:
                     if (PCSX::g_emulator->settings.get<PCSX::Emulator::SettingMcd2Inserted>()) {
                         m_rxBuffer = m_memoryCard[1].transceive(m_regs.data);
-                        if (m_memoryCard[1].dataChanged()) {
+                        if (m_memoryCard[1].sectorWritten()) {
                             m_memoryCard[1].commit(
                                 PCSX::g_emulator->settings.get<PCSX::Emulator::SettingMcd2>().string().c_str());
                         }
@@ -233,6 +263,7 @@ void PCSX::SIO::transmitData() {
         default:
             m_currentDevice = DeviceType::None;
             m_padState = Pads::PAD_STATE_IDLE;
+            m_padPrefetched = false;
             m_memoryCard[0].deselect();
             m_memoryCard[1].deselect();
             break;
@@ -284,6 +315,7 @@ void PCSX::SIO::writeCtrl16(uint16_t value) {
         // Select line de-activated, reset state machines
         m_currentDevice = DeviceType::None;
         m_padState = Pads::PAD_STATE_IDLE;
+        m_padPrefetched = false;
         m_memoryCard[0].deselect();
         m_memoryCard[1].deselect();
         m_bufferIndex = 0;
@@ -302,6 +334,7 @@ void PCSX::SIO::writeCtrl16(uint16_t value) {
     if (m_regs.control & ControlFlags::RESET) {
         m_rxFIFO.clear();
         m_padState = Pads::PAD_STATE_IDLE;
+        m_padPrefetched = false;
         m_memoryCard[0].deselect();
         m_memoryCard[1].deselect();
         m_bufferIndex = 0;
@@ -77,7 +77,7 @@ class SIO {
     static constexpr size_t c_cardSize = c_blockSize * 16;    // 16 blocks per frame(directory+15 saves)
     static constexpr size_t c_cardCount = 2;
 
-    SIO() { reset(); }
+    SIO();
 
     void write8(uint8_t value);
     void writeStatus16(uint16_t value);
@@ -117,6 +117,10 @@ class SIO {
         m_memoryCard[1].loadMcd(mcd2);
     }
     void saveMcd(int mcd);
+    // Memory cards get written back in the background; this makes sure none of that is in flight.
+    void prepareFork() {
+        for (auto &card : m_memoryCard) card.waitFlush();
+    }
     static constexpr int otherMcd(int mcd) {
         if ((mcd != 1) && (mcd != 2)) throw std::runtime_error("Bad memory card number");
         if (mcd == 1) return 2;
@@ -250,6 +254,13 @@ class SIO {
     };
 
     uint8_t m_currentDevice = DeviceType::None;
+    // Decided when a device gets selected. Without the debugger, the parts of a transaction which are known
+    // ahead of time, such as the rest of a pad read, or of a memory card sector read, get computed at once,
+    // then sent back byte by byte, still with an acknowledge for each, instead of going through the device's
+    // state machine for each of them.
+    bool m_fastPath = false;
+    // The rest of the current pad read is in m_buffer already.
+    bool m_padPrefetched = false;
 
     // Pads
     uint8_t m_buffer[c_padBufferSize];
@@ -260,6 +271,8 @@ class SIO {
     MemoryCard m_memoryCard[c_cardCount] = {this, this};
 
     FIFO<uint8_t, 8> m_rxFIFO;
+
+    EventBus::Listener m_listener;
 };
 
 }  // namespace PCSX
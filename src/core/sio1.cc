@@ -19,6 +19,8 @@
 
 #include "core/sio1.h"
 
+#include <algorithm>
+
 PCSX::SIOPayload PCSX::SIO1::makeFlowControlMessage() {
     return SIOPayload{
         DataTransfer{},
@@ -42,14 +44,14 @@ void PCSX::SIO1::transmitMessage(std::string &&message) {
     m_fifo->write(std::move(message));
 }
 
-std::string PCSX::SIO1::encodeMessage(SIOPayload message) {
-    Protobuf::OutSlice outslice;
-    message.serialize(&outslice);
-    return std::string(outslice.finalize());
-}
+std::string PCSX::SIO1::encodeMessage(SIOPayload message) { return message.serialize(); }
 
 void PCSX::SIO1::sendDataMessage() {
     if (fifoError()) return;
+    if (batching()) {
+        queueBatch(true);
+        return;
+    }
 
     std::string txByte(1, m_regs.data);
     SIOPayload payload = makeDataMessage(std::move(txByte));
@@ -65,6 +67,11 @@ void PCSX::SIO1::sendFlowControlMessage() {
         if (m_flowControl == m_prevFlowControl) return;
     }
     m_prevFlowControl = m_flowControl;
+    // The very first one announces the connection, so it doesn't wait
+    if (!initialMessage && batching()) {
+        queueBatch(false);
+        return;
+    }
 
     SIOPayload payload = makeFlowControlMessage();
     std::string message = encodeMessage(payload);
@@ -95,7 +102,99 @@ void PCSX::SIO1::decodeMessage() {
     processMessage(payload);
 }
 
+bool PCSX::SIO1::batching() {
+    return g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::SIO1Batching>();
+}
+
+uint64_t PCSX::SIO1::batchLatency() {
+    const int latency = g_emulator->settings.get<Emulator::SettingDebugSettings>()
+                            .get<Emulator::DebugSettings::SIO1BatchLatency>();
+    return uint64_t(std::max(latency, 0)) * g_emulator->m_psxClockSpeed / 1000000;
+}
+
+void PCSX::SIO1::queueBatch(bool hasByte) {
+    const uint64_t now = g_emulator->m_cpu->m_regs.cycle;
+    if (!m_batchPending) {
+        m_batchStart = m_batchLast = now;
+        m_batchPending = true;
+    }
+    if (!hasByte) return;
+
+    Protobuf::OutSlice delay;
+    delay.putVarInt(now - m_batchLast);
+    m_batchDelays += delay.finalize();
+    m_batchData.push_back(static_cast<char>(m_regs.data));
+    m_batchLast = now;
+    if (m_batchData.size() + m_batchDelays.size() >= c_maxBatchPayload) flushBatch();
+}
+
+void PCSX::SIO1::flushBatch() {
+    if (!m_batchPending) return;
+    m_batchPending = false;
+    const uint32_t flowControl = 4 | (m_flowControl.dxr ? 1 : 0) | (m_flowControl.xts ? 2 : 0);
+    SIOPayload payload{
+        DataTransfer{},
+        FlowControl{},
+        Batch{BatchData{std::move(m_batchData)}, BatchDelays{std::move(m_batchDelays)}, BatchFlowControl{flowControl}},
+    };
+    m_batchData.clear();
+    m_batchDelays.clear();
+    transmitMessage(encodeMessage(payload));
+}
+
+void PCSX::SIO1::resetBatches() {
+    m_batchData.clear();
+    m_batchDelays.clear();
+    m_batchPending = false;
+    m_deliveries.clear();
+}
+
+void PCSX::SIO1::processBatch(const Batch &batch) {
+    const std::string &data = batch.get<BatchData>().value;
+    const std::string &delays = batch.get<BatchDelays>().value;
+    Protobuf::InSlice inslice(reinterpret_cast<const uint8_t *>(delays.data()), delays.size());
+    // Missing or broken delays only cost the timing
+    const auto nextDelay = [&inslice]() -> uint64_t {
+        try {
+            return inslice.getVarInt();
+        } catch (...) {
+            return 0;
+        }
+    };
+
+    // A batch arriving late still gets its bytes spaced the way they were sent, so only the first one is late
+    uint64_t cycle = g_emulator->m_cpu->m_regs.cycle;
+    if (!m_deliveries.empty()) cycle = std::max(cycle, m_deliveries.back().cycle);
+    for (auto byte : data) {
+        cycle += nextDelay();
+        m_deliveries.push_back({cycle, static_cast<uint8_t>(byte), false});
+    }
+    m_deliveries.push_back({cycle, batch.get<BatchFlowControl>().value, true});
+    deliverBatched();
+}
+
+void PCSX::SIO1::deliverBatched() {
+    const uint64_t now = g_emulator->m_cpu->m_regs.cycle;
+    while (!m_deliveries.empty() && m_deliveries.front().cycle <= now) {
+        const auto delivery = m_deliveries.front();
+        m_deliveries.pop_front();
+        if (delivery.isFlowControl) {
+            setDsr(delivery.value & 1);
+            setCts(delivery.value & 2);
+        } else if (m_regs.control & CR_RTS) {
+            PCSX::Slice pushByte;
+            pushByte.acquire(std::string(1, static_cast<char>(delivery.value)));
+            m_sio1fifo.asA<Fifo>()->pushSlice(std::move(pushByte));
+            receiveCallback();
+        }
+    }
+}
+
 void PCSX::SIO1::processMessage(SIOPayload payload) {
+    if (payload.get<BatchField>().get<BatchFlowControl>().hasData()) {
+        processBatch(payload.get<BatchField>());
+        return;
+    }
     if (!payload.get<DataTransferField>().get<DataTransferData>().hasData()) {
         setDsr(payload.get<FlowControlField>().get<FlowControlDXR>().value);
         setCts(payload.get<FlowControlField>().get<FlowControlXTS>().value);
@@ -143,6 +242,7 @@ void PCSX::SIO1::interrupt() {
 }
 
 uint8_t PCSX::SIO1::readData8() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     if (m_sio1fifo && !m_sio1fifo->eof()) {
         if (m_regs.status & SR_RXRDY) {
@@ -155,6 +255,7 @@ uint8_t PCSX::SIO1::readData8() {
 }
 
 uint16_t PCSX::SIO1::readData16() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     if (m_sio1fifo && !m_sio1fifo->eof()) {
         if (m_regs.status & SR_RXRDY) {
@@ -167,6 +268,7 @@ uint16_t PCSX::SIO1::readData16() {
 }
 
 uint32_t PCSX::SIO1::readData32() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     if (m_sio1fifo && !m_sio1fifo->eof()) {
         if (m_regs.status & SR_RXRDY) {
@@ -179,16 +281,19 @@ uint32_t PCSX::SIO1::readData32() {
 }
 
 uint8_t PCSX::SIO1::readStat8() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     return m_regs.status;
 }
 
 uint16_t PCSX::SIO1::readStat16() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     return m_regs.status;
 }
 
 uint32_t PCSX::SIO1::readStat32() {
+    if (!m_deliveries.empty()) deliverBatched();
     updateStat();
     return m_regs.status;
 }
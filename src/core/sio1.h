@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <compare>
+#include <deque>
 #include <string>
 
 #include "core/psxemulator.h"
@@ -50,7 +51,15 @@ typedef Protobuf::MessageField<FlowControl, TYPESTRING("flow_control"), 2> FlowC
 typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("data"), 1> DataTransferData;
 typedef Protobuf::Message<TYPESTRING("DataTransfer"), DataTransferData> DataTransfer;
 typedef Protobuf::MessageField<DataTransfer, TYPESTRING("data_transfer"), 1> DataTransferField;
-typedef Protobuf::Message<TYPESTRING("SIOPayload"), DataTransferField, FlowControlField> SIOPayload;
+// Everything the sender did over an emulated time slice, in one message. The delays are varints, one per byte of
+// data, counting the cycles since the previous byte, or since the start of the slice for the first one. The flow
+// control is the state at the end of the slice, with bit 0 being DXR, bit 1 XTS, and bit 2 always set.
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("data"), 1> BatchData;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("delays"), 2> BatchDelays;
+typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("flow_control"), 3> BatchFlowControl;
+typedef Protobuf::Message<TYPESTRING("Batch"), BatchData, BatchDelays, BatchFlowControl> Batch;
+typedef Protobuf::MessageField<Batch, TYPESTRING("batch"), 3> BatchField;
+typedef Protobuf::Message<TYPESTRING("SIOPayload"), DataTransferField, FlowControlField, BatchField> SIOPayload;
 
 // SIO1Info Message for future use
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("version_number"), 1> SIO1Version;
@@ -76,6 +85,8 @@ class SIO1 {
         if (fifoError()) return;
         if (m_sio1Mode == SIO1Mode::Protobuf) {
             sio1StateMachine();
+            deliverBatched();
+            if (m_batchPending && (g_emulator->m_cpu->m_regs.cycle - m_batchStart >= batchLatency())) flushBatch();
         } else {
             if (m_sio1fifo->size() >= 1) {
                 receiveCallback();
@@ -93,6 +104,7 @@ class SIO1 {
         m_decodeState = READ_SIZE;
         messageSize = 0;
         initialMessage = true;
+        resetBatches();
         g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO1);
     }
 
@@ -100,6 +112,7 @@ class SIO1 {
         m_decodeState = READ_SIZE;
         messageSize = 0;
         initialMessage = true;
+        resetBatches();
         if (m_sio1fifo.isA<Fifo>()) {
             m_sio1fifo.asA<Fifo>()->reset();
         } else if (m_sio1fifo) {
@@ -179,6 +192,32 @@ class SIO1 {
     void processMessage(SIOPayload payload);
     void calcCycleCount();
 
+    // With batching on, the bytes written and the flow control changes pile up until the slice gets older than
+    // the latency setting, or until there's enough to fill a message, and then go out as one Batch. Messages are
+    // prefixed with a single byte for their size, and this leaves room for the last byte's delay and the framing.
+    static constexpr unsigned c_maxBatchPayload = 192;
+    bool batching();
+    uint64_t batchLatency();
+    void queueBatch(bool hasByte);
+    void flushBatch();
+    void resetBatches();
+    std::string m_batchData;
+    std::string m_batchDelays;
+    uint64_t m_batchStart = 0;
+    uint64_t m_batchLast = 0;
+    bool m_batchPending = false;
+
+    // The receiving side of the batches: each byte gets into the RX FIFO when the local clock reaches the time it
+    // was sent at, the first one of a batch being due when it arrives. The flow control goes last.
+    struct Delivery {
+        uint64_t cycle;
+        uint32_t value;
+        bool isFlowControl;
+    };
+    std::deque<Delivery> m_deliveries;
+    void processBatch(const Batch &batch);
+    void deliverBatched();
+
     struct flowControl {
         bool dxr;
         bool xts;
@@ -26,6 +26,7 @@
 #include "core/sstate.h"
 #include "json.hpp"
 #include "lua/luawrapper.h"
+#include "support/dirtypages.h"
 
 namespace PCSX {
 
@@ -47,8 +48,6 @@ class SPUInterface {
     virtual void async(uint32_t) = 0;
     virtual void writeDMAMem(uint16_t *, int) = 0;
     virtual void readDMAMem(uint16_t *, int) = 0;
-    virtual void lockSPURAM() = 0;
-    virtual void unlockSPURAM() = 0;
     virtual void resetCaptureBuffer() = 0;
     virtual json getCfg() = 0;
     virtual void setCfg(const json &j) = 0;
@@ -56,11 +55,29 @@ class SPUInterface {
     virtual bool configure() = 0;
     virtual void save(SaveStates::SPU &) = 0;
     virtual void load(const SaveStates::SPU &) = 0;
+    // Like load(), but only puts back the pages of SPU RAM written to since the dirty map got cleared.
+    virtual void rollback(const SaveStates::SPU &) = 0;
     virtual uint32_t getCurrentFrames() = 0;
     virtual void waitForGoal(uint32_t goal) = 0;
     virtual uint32_t getFrameCount() = 0;
+    // Buffer levels, latencies, underruns and mixing times of the audio output, over the last few seconds.
+    virtual json getAudioTelemetry() = 0;
+    virtual void resetAudioTelemetry() = 0;
+    // While suppressed, whatever gets mixed is thrown away instead of going to the audio output.
+    virtual void setAudioSuppressed(bool suppressed) = 0;
+    // The mixing thread needs to be out of the way while forking. The child never gets to touch the audio
+    // device of its parent, and mixes synchronously, without being throttled.
+    virtual void prepareFork() = 0;
+    virtual void afterFork(bool child) = 0;
     virtual void setLua(Lua L) = 0;
 
+    // Which 4KB pages of SPU RAM were written to since the last clear. The areas the SPU keeps writing to on its
+    // own, that is, the capture buffers and the reverb work area, are reported as dirty when they're in use.
+    static constexpr uint32_t c_ramSize = 512 * 1024;
+    virtual DirtyPages &getDirtyRAM() = 0;
+    virtual const uint8_t *getRAM() = 0;
+    virtual void writeRAM(uint32_t offset, const uint8_t *data, uint32_t size) = 0;
+
     bool m_showDebug = false;
     bool m_showCfg = false;
 
@@ -19,6 +19,8 @@
 
 #include "core/sstate.h"
 
+#include <algorithm>
+
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
@@ -27,8 +29,10 @@
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/sio.h"
 #include "spu/interface.h"
+#include "tracy/Tracy.hpp"
 
 PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
     // clang-format off
@@ -179,8 +183,10 @@ struct SaveStateWrapper {
 }  // namespace PCSX
 
 std::string PCSX::SaveStates::save() {
+    ZoneScoped;
     SaveState state = constructSaveState();
     SaveStateWrapper wrapper(state);
+    g_emulator->m_cpu->saveICache();
 
     state.get<SaveStateInfoField>().get<VersionString>().value = "PCSX-Redux SaveState v4";
     state.get<SaveStateInfoField>().get<Version>().value = 4;
@@ -197,9 +203,7 @@ std::string PCSX::SaveStates::save() {
 
     g_emulator->m_callStacks->serialize(&wrapper);
 
-    Protobuf::OutSlice slice;
-    state.serialize(&slice);
-    return slice.finalize();
+    return state.serialize();
 }
 
 void PCSX::CallStacks::serialize(SaveStateWrapper* w) {
@@ -278,10 +282,18 @@ void PCSX::Counters::serialize(SaveStateWrapper* w) {
     counters.get<PSXNextCounter>().value = m_psxNextCounter;
 }
 
-bool PCSX::SaveStates::load(std::string_view data) {
+namespace {
+
+// When rolling back, only the dirty pages get copied, and the CPU isn't reset. ROM and EXP1 are left alone too,
+// as games don't write to them.
+bool loadState(std::string_view data, bool rollback) {
+    ZoneScoped;
+    using namespace PCSX;
+    using namespace PCSX::SaveStates;
     SaveState state = constructSaveState();
 
-    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    // The state doesn't outlive the data, so RAM, VRAM and SPU RAM get copied straight from it when committed
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size(), Protobuf::InSlice::BORROW);
     try {
         state.deserialize(&slice, 0);
     } catch (...) {
@@ -293,15 +305,41 @@ bool PCSX::SaveStates::load(std::string_view data) {
     }
 
     SaveStateWrapper wrapper(state);
-    PCSX::g_emulator->m_cpu->Reset();
-    state.commit();
+    if (rollback) {
+        auto& mem = g_emulator->m_mem;
+        auto& memory = state.get<MemoryField>();
+        const uint8_t* ram = memory.get<RAM>().deserialized().value;
+        if (!ram) return false;
+        auto& dirty = mem->getDirtyRAM();
+        const uint32_t pageSize = dirty.pageSize();
+        dirty.forEachDirty([&](uint32_t page) {
+            const uint32_t offset = page * pageSize;
+            memcpy(mem->m_wram + offset, ram + offset, pageSize);
+            g_emulator->m_cpu->Clear(offset, pageSize / 4);
+        });
+        memory.get<HardwareMemory>().commit();
+        state.get<RegistersField>().commit();
+        state.get<SIOField>().commit();
+        state.get<CDRomField>().commit();
+    } else {
+        g_emulator->m_cpu->Reset();
+        state.commit();
+        g_emulator->m_mem->getDirtyRAM().markAll();
+    }
+    g_emulator->m_cpu->loadICache();
     g_emulator->m_cpu->m_regs.lowestTarget = g_emulator->m_cpu->m_regs.cycle;
+    g_emulator->m_cpu->m_regs.nextEventTarget = g_emulator->m_cpu->m_regs.cycle;
     g_emulator->m_cpu->m_regs.previousCycles = g_emulator->m_cpu->m_regs.cycle;
     // x86-64 recompiler might make save states with an unaligned PC, since it ignores the bottom 2 bits
     // So we just force-align it here, since it's never meant to be misaligned
     g_emulator->m_cpu->m_regs.pc &= ~3;
-    g_emulator->m_gpu->deserialize(&wrapper);
-    g_emulator->m_spu->load(state.get<SPUField>());
+    if (rollback) {
+        g_emulator->m_gpu->rollback(&wrapper);
+        g_emulator->m_spu->rollback(state.get<SPUField>());
+    } else {
+        g_emulator->m_gpu->deserialize(&wrapper);
+        g_emulator->m_spu->load(state.get<SPUField>());
+    }
     g_emulator->m_cdrom->load();
 
     g_emulator->m_counters->deserialize(&wrapper);
@@ -335,17 +373,33 @@ bool PCSX::SaveStates::load(std::string_view data) {
     }
     g_emulator->m_callStacks->deserialize(&wrapper);
 
-    g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
+    if (!rollback) g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
 
     return true;
 }
 
+}  // namespace
+
+bool PCSX::SaveStates::load(std::string_view data) { return loadState(data, false); }
+
+std::string PCSX::SaveStates::snapshot() {
+    std::string state = save();
+    g_emulator->m_mem->getDirtyRAM().clear();
+    g_emulator->m_gpu->syncCommands();
+    g_emulator->m_gpu->getDirtyVRAM().clear();
+    g_emulator->m_spu->getDirtyRAM().clear();
+    return state;
+}
+
+bool PCSX::SaveStates::rollback(std::string_view data) { return loadState(data, true); }
+
 void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
     using namespace SaveStates;
-    m_callstacks.destroyAll();
+    clear();
+    // Stacks from the save state would be going stale right away, with nothing tracking them.
+    if (!m_subscribers) return;
 
     auto& callstacks = w->state.get<CallStacksField>().get<CallStacksMessageField>().value;
-    m_current = nullptr;
 
     for (auto& sscallstack : callstacks) {
         auto& calls = sscallstack.get<Calls>().value;
@@ -354,7 +408,7 @@ void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
         uint32_t ra = sscallstack.get<PresumedRA>().value;
         uint32_t fp = sscallstack.get<PresumedFP>().value;
         bool isCurrent = sscallstack.get<CallstackIsCurrent>().value;
-        CallStack* callstack = new CallStack();
+        CallStack* callstack = createCallStack();
         callstack->ra = ra;
         callstack->fp = fp;
         for (auto& call : calls) {
@@ -362,7 +416,7 @@ void PCSX::CallStacks::deserialize(const SaveStateWrapper* w) {
             uint32_t sp = call.get<CallSP>().value;
             uint32_t fp = call.get<CallFP>().value;
             bool shadow = call.get<Shadow>().value;
-            callstack->calls.push_back(new CallStack::Call(sp, fp, ra, shadow));
+            callstack->calls.push_back(createCall(sp, fp, ra, shadow));
         }
         if (isCurrent) m_current = callstack;
         m_callstacks.insert(lowSP, highSP, callstack);
@@ -383,8 +437,34 @@ void PCSX::GPU::deserialize(const SaveStateWrapper* w) {
     } else {
         clearVRAM();
     }
-    const auto control = gpu.get<GPUControl>().value;
+    restoreControl(gpu.get<GPUControl>().value);
+}
 
+void PCSX::GPU::rollback(const SaveStateWrapper* w) {
+    using namespace SaveStates;
+    // Resetting the backend would clear VRAM, so this only resets the command stream
+    syncCommands();
+    m_dataRet = 0;
+    m_readFifo->reset();
+    m_processor->reset();
+    m_defaultProcessor.setActive();
+    auto& gpu = w->state.get<GPUField>();
+    restoreStatus(gpu.get<GPUStatus>().value);
+    const uint8_t* vram = gpu.get<GPUVRam>().value;
+    if (vram) {
+        const uint32_t pageSize = m_dirtyVRAM.pageSize();
+        const int lines = pageSize / c_vramStride;
+        m_dirtyVRAM.forEachDirty([&](uint32_t page) {
+            partialUpdateVRAM(0, page * lines, 1024, lines, reinterpret_cast<const uint16_t*>(vram + page * pageSize),
+                              PartialUpdateVram::Synchronous);
+        });
+    } else {
+        clearVRAM();
+    }
+    restoreControl(gpu.get<GPUControl>().value);
+}
+
+void PCSX::GPU::restoreControl(const uint8_t* control) {
     for (unsigned i = 0; i < 256; i++) {
         m_statusControl[i] = getU32(control + i * 4);
     }
@@ -450,3 +530,216 @@ void PCSX::Counters::deserialize(const SaveStateWrapper* w) {
 
     m_audioFrames = g_emulator->m_spu->getCurrentFrames();
 }
+
+static void saveDirty(PCSX::DirtyPages& dirty, const uint8_t* memory, std::string& map, std::string& pages) {
+    map.assign(reinterpret_cast<const char*>(dirty.data()), dirty.pageCount());
+    pages.reserve(dirty.countDirty() * dirty.pageSize());
+    dirty.forEachDirty([&](uint32_t page) {
+        pages.append(reinterpret_cast<const char*>(memory) + page * dirty.pageSize(), dirty.pageSize());
+    });
+    dirty.clear();
+}
+
+// An empty map means nothing changed, otherwise there needs to be as many pages as the map says
+static bool checkDirty(const PCSX::DirtyPages& dirty, const std::string& map, const std::string& pages) {
+    if (map.empty()) return pages.empty();
+    if (map.size() != dirty.pageCount()) return false;
+    size_t count = 0;
+    for (auto c : map) count += c != 0;
+    return pages.size() == count * dirty.pageSize();
+}
+
+template <typename F>
+static void loadDirty(const PCSX::DirtyPages& dirty, const std::string& map, const std::string& pages, F&& restore) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(pages.data());
+    for (uint32_t page = 0; page < map.size(); page++) {
+        if (!map[page]) continue;
+        restore(page * dirty.pageSize(), data);
+        data += dirty.pageSize();
+    }
+}
+
+std::string PCSX::SaveStates::saveDirtyPages() {
+    ZoneScoped;
+    auto& mem = g_emulator->m_mem;
+    auto& gpu = g_emulator->m_gpu;
+    auto& spu = g_emulator->m_spu;
+    DirtyPagesState state;
+
+    state.get<DirtyPageSize>().value = mem->getDirtyRAM().pageSize();
+    saveDirty(mem->getDirtyRAM(), mem->m_wram, state.get<DirtyRAMMap>().value, state.get<DirtyRAMPages>().value);
+    gpu->syncCommands();
+    // Reading VRAM back can be expensive, depending on the backend
+    if (gpu->getDirtyVRAM().countDirty() != 0) {
+        auto vram = gpu->getVRAM();
+        saveDirty(gpu->getDirtyVRAM(), vram.data<uint8_t>(), state.get<DirtyVRAMMap>().value,
+                  state.get<DirtyVRAMPages>().value);
+    }
+    saveDirty(spu->getDirtyRAM(), spu->getRAM(), state.get<DirtySPURAMMap>().value,
+              state.get<DirtySPURAMPages>().value);
+
+    return state.serialize();
+}
+
+bool PCSX::SaveStates::loadDirtyPages(std::string_view data) {
+    ZoneScoped;
+    auto& mem = g_emulator->m_mem;
+    auto& gpu = g_emulator->m_gpu;
+    auto& spu = g_emulator->m_spu;
+    DirtyPagesState state;
+
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    try {
+        state.deserialize(&slice, 0);
+    } catch (...) {
+        return false;
+    }
+
+    const auto& ramMap = state.get<DirtyRAMMap>().value;
+    const auto& ramPages = state.get<DirtyRAMPages>().value;
+    const auto& vramMap = state.get<DirtyVRAMMap>().value;
+    const auto& vramPages = state.get<DirtyVRAMPages>().value;
+    const auto& spuMap = state.get<DirtySPURAMMap>().value;
+    const auto& spuPages = state.get<DirtySPURAMPages>().value;
+    const uint32_t pageSize = mem->getDirtyRAM().pageSize();
+    if (state.get<DirtyPageSize>().value != pageSize) return false;
+    if (!checkDirty(mem->getDirtyRAM(), ramMap, ramPages)) return false;
+    if (!checkDirty(gpu->getDirtyVRAM(), vramMap, vramPages)) return false;
+    if (!checkDirty(spu->getDirtyRAM(), spuMap, spuPages)) return false;
+
+    loadDirty(mem->getDirtyRAM(), ramMap, ramPages, [&](uint32_t offset, const uint8_t* page) {
+        memcpy(mem->m_wram + offset, page, pageSize);
+        g_emulator->m_cpu->Clear(offset, pageSize / 4);
+        mem->markRAMDirty(offset, pageSize);
+    });
+    const int lines = pageSize / GPU::c_vramStride;
+    loadDirty(gpu->getDirtyVRAM(), vramMap, vramPages, [&](uint32_t offset, const uint8_t* page) {
+        gpu->partialUpdateVRAM(0, offset / GPU::c_vramStride, 1024, lines, reinterpret_cast<const uint16_t*>(page),
+                               GPU::PartialUpdateVram::Synchronous);
+    });
+    loadDirty(spu->getDirtyRAM(), spuMap, spuPages,
+              [&](uint32_t offset, const uint8_t* page) { spu->writeRAM(offset, page, pageSize); });
+    return true;
+}
+
+bool PCSX::SaveStates::rewind(unsigned steps) {
+    auto state = g_emulator->m_rewind->rewind(steps);
+    if (state.empty()) return false;
+    return load(state);
+}
+
+namespace {
+
+constexpr int c_thumbnailWidth = 160;
+constexpr int c_thumbnailHeight = 120;
+
+// Box filters the displayed area of VRAM down to at most c_thumbnailWidth by c_thumbnailHeight. The display
+// area is computed the same way GPU::Display::updateDispArea() does, out of the control registers saved alongside
+// VRAM, so that this works the same way for all the GPU backends.
+bool buildThumbnail(const PCSX::SaveStates::GPU& gpu, PCSX::SaveStates::Thumbnail& thumbnail) {
+    using namespace PCSX::SaveStates;
+    const uint8_t* vram = gpu.get<GPUVRam>().value;
+    const uint8_t* control = gpu.get<GPUControl>().value;
+    if (!vram || !control) return false;
+
+    const uint32_t start = getU32(control + 5 * 4);
+    const uint32_t horizontalRange = getU32(control + 6 * 4);
+    const uint32_t verticalRange = getU32(control + 7 * 4);
+    const PCSX::GPU::CtrlDisplayMode mode(getU32(control + 8 * 4));
+
+    static constexpr int dividers[] = {10, 8, 5, 4, 7, 7};
+    const int divider = dividers[mode.hres];
+    const bool pal = mode.mode == PCSX::GPU::CtrlDisplayMode::VM_PAL;
+    const int cyclesPerScanline = pal ? 3406 : 3413;
+    const int totalScanlines = pal ? 314 : 263;
+    const int x1 = std::min<int>(horizontalRange & 0xfff, cyclesPerScanline) / divider * divider;
+    const int x2 = std::min<int>((horizontalRange >> 12) & 0xfff, cyclesPerScanline) / divider * divider;
+    const int y1 = std::min<int>(verticalRange & 0x3ff, totalScanlines);
+    const int y2 = std::min<int>((verticalRange >> 10) & 0x3ff, totalScanlines);
+    const int width = std::min((((x2 > x1) ? (x2 - x1) : 0) / divider + 2) & ~3, 1024);
+    const int height = std::min((y2 - y1) * (mode.interlace ? 2 : 1), 512);
+    if ((width <= 0) || (height <= 0)) return false;
+
+    const int factor = std::max({1, (width + c_thumbnailWidth - 1) / c_thumbnailWidth,
+                                 (height + c_thumbnailHeight - 1) / c_thumbnailHeight});
+    const int thumbnailWidth = width / factor;
+    const int thumbnailHeight = height / factor;
+    const unsigned startX = start & 0x3ff;
+    const unsigned startY = (start >> 10) & 0x1ff;
+    const bool rgb24 = mode.depth == PCSX::GPU::CtrlDisplayMode::CD_24BITS;
+
+    auto& red = thumbnail.get<Red>().value;
+    auto& green = thumbnail.get<Green>().value;
+    auto& blue = thumbnail.get<Blue>().value;
+    red.resize(thumbnailWidth * thumbnailHeight);
+    green.resize(thumbnailWidth * thumbnailHeight);
+    blue.resize(thumbnailWidth * thumbnailHeight);
+    thumbnail.get<Width>().value = thumbnailWidth;
+    thumbnail.get<Height>().value = thumbnailHeight;
+
+    const unsigned pixels = factor * factor;
+    for (int ty = 0; ty < thumbnailHeight; ty++) {
+        for (int tx = 0; tx < thumbnailWidth; tx++) {
+            unsigned r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < factor; dy++) {
+                const uint8_t* line = vram + ((startY + ty * factor + dy) & 511) * 2048;
+                for (int dx = 0; dx < factor; dx++) {
+                    const unsigned x = tx * factor + dx;
+                    if (rgb24) {
+                        const unsigned offset = startX * 2 + x * 3;
+                        r += line[offset & 2047];
+                        g += line[(offset + 1) & 2047];
+                        b += line[(offset + 2) & 2047];
+                    } else {
+                        const unsigned offset = ((startX + x) & 1023) * 2;
+                        const unsigned color = line[offset] | (line[offset + 1] << 8);
+                        r += ((color << 3) & 0xf8) | ((color >> 2) & 7);
+                        g += ((color >> 2) & 0xf8) | ((color >> 7) & 7);
+                        b += ((color >> 7) & 0xf8) | ((color >> 12) & 7);
+                    }
+                }
+            }
+            const unsigned index = ty * thumbnailWidth + tx;
+            red[index] = r / pixels;
+            green[index] = g / pixels;
+            blue[index] = b / pixels;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+std::string PCSX::SaveStates::makeThumbnail(std::string_view state) {
+    SaveStatePreview preview;
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(state.data()), state.size(), Protobuf::InSlice::BORROW);
+    try {
+        preview.deserialize(&slice, 0);
+    } catch (...) {
+        return {};
+    }
+
+    Protobuf::Message<TYPESTRING("SaveState"), ThumbnailField> thumbnail;
+    if (!buildThumbnail(preview.get<GPUField>(), thumbnail.get<ThumbnailField>())) return {};
+    return thumbnail.serialize();
+}
+
+bool PCSX::SaveStates::loadThumbnail(std::string_view state, Thumbnail& thumbnail) {
+    SaveStatePreview preview;
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(state.data()), state.size(), Protobuf::InSlice::BORROW);
+    try {
+        preview.deserialize(&slice, 0);
+    } catch (...) {
+        return false;
+    }
+
+    const auto& saved = preview.get<ThumbnailField>();
+    const size_t size = saved.get<Width>().value * saved.get<Height>().value;
+    if ((size != 0) && (saved.get<Red>().value.size() == size) && (saved.get<Green>().value.size() == size) &&
+        (saved.get<Blue>().value.size() == size)) {
+        thumbnail = saved;
+        return true;
+    }
+    return buildThumbnail(preview.get<GPUField>(), thumbnail);
+}
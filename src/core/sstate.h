@@ -314,15 +314,53 @@ typedef Protobuf::Message<TYPESTRING("SaveState"), SaveStateInfoField, Thumbnail
                           PCdrvFilesField, CallStacksField>
     SaveState;
 
+// The pages of RAM, VRAM and SPU RAM which changed since the last time their dirty maps were cleared. Each map
+// holds a byte per page, 1 for the pages present, in order, in the matching pages field.
+typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("page_size"), 1> DirtyPageSize;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("ram_map"), 2> DirtyRAMMap;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("ram_pages"), 3> DirtyRAMPages;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("vram_map"), 4> DirtyVRAMMap;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("vram_pages"), 5> DirtyVRAMPages;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("spu_ram_map"), 6> DirtySPURAMMap;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("spu_ram_pages"), 7> DirtySPURAMPages;
+typedef Protobuf::Message<TYPESTRING("DirtyPages"), DirtyPageSize, DirtyRAMMap, DirtyRAMPages, DirtyVRAMMap,
+                          DirtyVRAMPages, DirtySPURAMMap, DirtySPURAMPages>
+    DirtyPagesState;
+
+// The parts of a save state its thumbnail gets made out of. Unlike SaveState, this doesn't point to the emulated
+// machine, so states can be parsed into it from any thread.
+typedef Protobuf::Message<TYPESTRING("SaveState"), ThumbnailField, GPUField> SaveStatePreview;
+
 typedef Protobuf::ProtoFile<SaveStateInfo, Thumbnail, Memory, DelaySlotInfo, Registers, GPU, ADPCMDecode, XA,
                             ::PCSX::SPU::Chan::Data, ::PCSX::SPU::ADSRInfo, ::PCSX::SPU::ADSRInfoEx, Channel, SPU, SIO,
-                            CDRom, Hardware, Rcnt, Counters, MDEC, PCdrvFile, Call, CallStack, CallStacks, SaveState>
+                            CDRom, Hardware, Rcnt, Counters, MDEC, PCdrvFile, Call, CallStack, CallStacks, SaveState,
+                            DirtyPagesState>
     ProtoFile;
 
 SaveState constructSaveState();
 
 std::string save();
 bool load(std::string_view data);
+// For going back to a recent state again and again, the way run-ahead does. snapshot() is save(), which also
+// clears the dirty maps of RAM, VRAM and SPU RAM; rollback() then only copies back the pages written to since,
+// and doesn't reset the CPU, so the recompiled code is only dropped for these pages. The state needs to have
+// been made by snapshot() in the same session, with nothing else clearing the dirty maps in the meantime.
+std::string snapshot();
+bool rollback(std::string_view data);
+// Only the pages of RAM, VRAM and SPU RAM written to since the previous call, or since the last snapshot(), or
+// the last load(), which marks everything. Loading them back over the state they were taken against brings these
+// memories to where they were; the rest of the machine state is small enough to go through save() and load().
+std::string saveDirtyPages();
+bool loadDirtyPages(std::string_view data);
+// Makes the thumbnail of a state made by save(), out of the displayed area of its VRAM, and serializes it as a
+// thumbnail field. Protobuf merges messages when they're concatenated, so appending this to the state adds the
+// thumbnail to it. This only reads the state, so it can run on another thread while the state gets compressed.
+std::string makeThumbnail(std::string_view state);
+// Gets the thumbnail of a state, making it out of its VRAM if it was saved without one. Returns false when the
+// state has no VRAM to make one out of. This can also run on any thread.
+bool loadThumbnail(std::string_view state, Thumbnail& thumbnail);
+// Goes back this many snapshots in the rewind buffer, and returns false if there weren't any left.
+bool rewind(unsigned steps = 1);
 }  // namespace SaveStates
 
 }  // namespace PCSX
@@ -61,6 +61,8 @@ namespace Events {
 struct SettingsLoaded {
     bool safe = false;
 };
+// Signalled from the UI's tick when anything changed settings since the previous one, see SettingsChanges.
+struct SettingsChanged {};
 struct Quitting {};
 struct LogMessage {
     LogClass logClass;
@@ -273,7 +275,8 @@ class System {
     bool m_emergencyExit = false;
 };
 
-extern System *g_system;
+// Several emulators can run in the same process, so this is per thread: see EmulatorContext.
+extern thread_local System *g_system;
 
 }  // namespace PCSX
 
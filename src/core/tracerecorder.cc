@@ -0,0 +1,308 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/tracerecorder.h"
+
+#include <string.h>
+
+#include "core/psxmem.h"
+#include "support/gzchunks.h"
+
+namespace {
+
+constexpr char c_signature[8] = {'P', 'C', 'S', 'X', 'T', 'R', 'C', 'E'};
+constexpr size_t c_headerSize = sizeof(c_signature) + 4 + 4 + PCSX::TraceRecorder::c_registers * 4;
+constexpr uint8_t c_explicitPC = 0x01;
+constexpr uint8_t c_memoryAccess = 0x02;
+
+void putU32(std::string& out, uint32_t value) {
+    for (unsigned i = 0; i < 4; i++) out.push_back(char(value >> (i * 8)));
+}
+
+uint32_t getU32(const std::string& data, size_t offset) {
+    uint32_t value = 0;
+    for (unsigned i = 0; i < 4; i++) value |= uint32_t(uint8_t(data[offset + i])) << (i * 8);
+    return value;
+}
+
+// The width of the memory access this instruction does, or 0 if it doesn't.
+unsigned accessWidth(uint32_t code) {
+    switch (code >> 26) {
+        case 0x20:  // lb
+        case 0x24:  // lbu
+        case 0x28:  // sb
+            return 1;
+        case 0x21:  // lh
+        case 0x25:  // lhu
+        case 0x29:  // sh
+            return 2;
+        case 0x22:  // lwl
+        case 0x23:  // lw
+        case 0x26:  // lwr
+        case 0x2a:  // swl
+        case 0x2b:  // sw
+        case 0x2e:  // swr
+        case 0x32:  // lwc2
+        case 0x3a:  // swc2
+            return 4;
+    }
+    return 0;
+}
+
+}  // namespace
+
+PCSX::TraceRecorder::TraceRecorder() {
+    m_thread = std::thread([this]() { worker(); });
+}
+
+PCSX::TraceRecorder::~TraceRecorder() {
+    stop();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+bool PCSX::TraceRecorder::start(IO<File> file, const uint32_t* registers) {
+    stop();
+    if (file.isNull() || file->failed() || !file->writable()) return false;
+    m_file = file;
+    m_instructions = 0;
+    m_nextPC = 0;
+    m_inRecord = false;
+    memcpy(m_registers.data(), registers, sizeof(m_registers));
+    m_buffer.clear();
+    m_buffer.reserve(c_bufferSize + 256);
+    m_buffer.append(c_signature, sizeof(c_signature));
+    putU32(m_buffer, c_version);
+    m_headerPC = m_buffer.size();
+    putU32(m_buffer, 0);
+    for (auto r : m_registers) putU32(m_buffer, r);
+    m_recording = true;
+    return true;
+}
+
+void PCSX::TraceRecorder::stop() {
+    if (!m_recording) return;
+    m_recording = false;
+    flushBuffer();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitForWorker(lock);
+    m_file.reset();
+}
+
+void PCSX::TraceRecorder::begin(uint32_t pc, uint32_t code, const uint32_t* registers, Memory* memory) {
+    // The header only gets the pc of the first instruction once it's known.
+    if (m_instructions == 0) {
+        for (unsigned i = 0; i < 4; i++) m_buffer[m_headerPC + i] = char(pc >> (i * 8));
+        m_nextPC = pc;
+    }
+    m_recordStart = m_buffer.size();
+    m_inRecord = true;
+    uint8_t tag = 0;
+    m_buffer.push_back(0);
+    if (pc != m_nextPC) {
+        tag |= c_explicitPC;
+        putU32(m_buffer, pc);
+    }
+    putU32(m_buffer, code);
+    m_nextPC = pc + 4;
+
+    const unsigned width = accessWidth(code);
+    if (width) {
+        tag |= c_memoryAccess;
+        const uint32_t op = code >> 26;
+        const uint32_t address = registers[(code >> 21) & 0x1f] + int16_t(code);
+        uint32_t value = 0;
+        if (op == 0x3a) {
+            // The value comes out of the GTE, which isn't part of the trace.
+        } else if (op >= 0x28) {
+            value = registers[(code >> 16) & 0x1f];
+            if (width == 1) value &= 0xff;
+            if (width == 2) value &= 0xffff;
+        } else if (memory) {
+            const uint32_t aligned = address & ~(width - 1);
+            auto p = reinterpret_cast<const uint8_t*>(memory->pointerRead(aligned));
+            if (p) {
+                for (unsigned i = 0; i < width; i++) value |= uint32_t(p[i]) << (i * 8);
+            }
+        }
+        putU32(m_buffer, address);
+        putU32(m_buffer, value);
+    }
+    m_buffer[m_recordStart] = char(tag);
+}
+
+void PCSX::TraceRecorder::end(const uint32_t* registers) {
+    if (!m_inRecord) return;
+    m_inRecord = false;
+    unsigned count = 0;
+    for (unsigned i = 0; i < c_registers; i++) {
+        if (registers[i] == m_registers[i]) continue;
+        m_registers[i] = registers[i];
+        m_buffer.push_back(char(i));
+        putU32(m_buffer, registers[i]);
+        count++;
+    }
+    m_buffer[m_recordStart] = char(uint8_t(m_buffer[m_recordStart]) | (count << 2));
+    m_instructions++;
+    if (m_buffer.size() >= c_bufferSize) flushBuffer();
+}
+
+void PCSX::TraceRecorder::flushBuffer() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Dropping parts of a trace would make the rest of it meaningless, so the emulator waits instead.
+        m_cv.wait(lock, [this]() { return m_pending.size() < c_maxPending; });
+        if (!m_forked) m_pending.push_back(std::move(m_buffer));
+    }
+    m_cv.notify_all();
+    m_buffer = std::string();
+    m_buffer.reserve(c_bufferSize + 256);
+}
+
+void PCSX::TraceRecorder::waitForWorker(std::unique_lock<std::mutex>& lock) {
+    m_cv.wait(lock, [this]() { return m_pending.empty() && !m_busy; });
+}
+
+void PCSX::TraceRecorder::prepareFork() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waitForWorker(lock);
+    lock.release();
+}
+
+void PCSX::TraceRecorder::afterFork(bool child) {
+    if (child) {
+        m_forked = true;
+        m_recording = false;
+        m_file.reset();
+    }
+    m_mutex.unlock();
+}
+
+void PCSX::TraceRecorder::worker() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+        if (m_stop) return;
+        std::string data = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_busy = true;
+        lock.unlock();
+        m_cv.notify_all();
+
+        GZipChunks::compress(data, m_file, 1, 1);
+
+        lock.lock();
+        m_busy = false;
+        m_cv.notify_all();
+    }
+}
+
+bool PCSX::TraceRecorder::Reader::open(IO<File> file) {
+    m_data.clear();
+    m_checkpoints.clear();
+    m_size = 0;
+    if (file.isNull() || file->failed()) return false;
+    Slice compressed = file->readAt(file->size(), 0);
+    if (!GZipChunks::isChunked(compressed.asStringView())) return false;
+    if (!GZipChunks::decompress(compressed.asStringView(), m_data)) return false;
+    if (m_data.size() < c_headerSize) return false;
+    if (memcmp(m_data.data(), c_signature, sizeof(c_signature)) != 0) return false;
+    if (getU32(m_data, sizeof(c_signature)) != c_version) return false;
+
+    Cursor cursor;
+    cursor.index = 0;
+    cursor.pc = getU32(m_data, sizeof(c_signature) + 4);
+    for (unsigned i = 0; i < c_registers; i++) {
+        cursor.registers[i] = getU32(m_data, sizeof(c_signature) + 8 + i * 4);
+    }
+    cursor.offset = c_headerSize;
+    m_cursor = cursor;
+
+    Record record;
+    while (cursor.offset < m_data.size()) {
+        if ((cursor.index % c_checkpointInterval) == 0) {
+            m_checkpoints.push_back({cursor.offset, cursor.pc, cursor.registers});
+        }
+        if (!parse(cursor, record)) {
+            m_data.clear();
+            m_checkpoints.clear();
+            return false;
+        }
+    }
+    m_size = cursor.index;
+    return true;
+}
+
+bool PCSX::TraceRecorder::Reader::parse(Cursor& cursor, Record& record) const {
+    size_t offset = cursor.offset;
+    auto need = [this, &offset](size_t size) { return (m_data.size() - offset) >= size; };
+    if (!need(1)) return false;
+    const uint8_t tag = m_data[offset++];
+    record.changedCount = tag >> 2;
+    if (record.changedCount > c_registers) return false;
+    if (tag & c_explicitPC) {
+        if (!need(4)) return false;
+        cursor.pc = getU32(m_data, offset);
+        offset += 4;
+    }
+    if (!need(4)) return false;
+    record.pc = cursor.pc;
+    record.code = getU32(m_data, offset);
+    offset += 4;
+    record.memory = tag & c_memoryAccess;
+    record.address = 0;
+    record.value = 0;
+    if (record.memory) {
+        if (!need(8)) return false;
+        record.address = getU32(m_data, offset);
+        record.value = getU32(m_data, offset + 4);
+        offset += 8;
+    }
+    if (!need(record.changedCount * 5)) return false;
+    for (unsigned i = 0; i < record.changedCount; i++) {
+        const uint8_t index = m_data[offset];
+        if (index >= c_registers) return false;
+        record.changed[i] = index;
+        record.values[i] = getU32(m_data, offset + 1);
+        cursor.registers[index] = record.values[i];
+        offset += 5;
+    }
+    cursor.offset = offset;
+    cursor.pc = record.pc + 4;
+    cursor.index++;
+    return true;
+}
+
+bool PCSX::TraceRecorder::Reader::read(uint64_t index, Record& record, Registers* registers) {
+    if (index >= m_size) return false;
+    if ((index < m_cursor.index) || ((index - m_cursor.index) >= c_checkpointInterval)) {
+        const auto& checkpoint = m_checkpoints[index / c_checkpointInterval];
+        m_cursor.index = index - (index % c_checkpointInterval);
+        m_cursor.offset = checkpoint.offset;
+        m_cursor.pc = checkpoint.pc;
+        m_cursor.registers = checkpoint.registers;
+    }
+    while (m_cursor.index < index) parse(m_cursor, record);
+    if (registers) *registers = m_cursor.registers;
+    return parse(m_cursor, record);
+}
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+class Memory;
+
+// Records every instruction the interpreter runs into a binary trace, instead of the text the Trace debug
+// setting logs. After an 8 bytes signature, the version, the pc of the first instruction, and the 34 general
+// purpose registers (lo and hi being the last two) the trace starts from, come the records, each starting
+// with a tag byte:
+//  - bit 0: the pc follows, because it's not the one right after the previous record's,
+//  - bit 1: the instruction accesses memory, and its address and value follow the code,
+//  - bits 2 to 7: how many registers the instruction changed, each following as an index byte and a value.
+// Registers are seen changing once the instruction is done, which means that loads show up on the
+// instruction in their delay slot, like they do on the hardware. The value of a store is what got written,
+// and the value of a load is what was in memory beforehand, when it's something else than hardware
+// registers. The stream gets deflated by chunks on a worker thread as it goes, into a GZipChunks file.
+class TraceRecorder {
+  public:
+    static constexpr unsigned c_version = 1;
+    static constexpr unsigned c_registers = 34;
+    using Registers = std::array<uint32_t, c_registers>;
+
+    struct Record {
+        uint32_t pc;
+        uint32_t code;
+        bool memory;
+        uint32_t address;
+        uint32_t value;
+        unsigned changedCount;
+        std::array<uint8_t, c_registers> changed;
+        std::array<uint32_t, c_registers> values;
+    };
+
+    class Reader {
+      public:
+        // Returns false if this isn't a trace, or if it's damaged. Goes through the whole of it once, so that
+        // reading records afterwards can't go wrong.
+        bool open(IO<File> file);
+        uint64_t size() const { return m_size; }
+        // Reads a record, and optionally the registers as they were right before it ran. Returns false past
+        // the end. Reading forward is cheap; seeking elsewhere replays from the closest checkpoint.
+        bool read(uint64_t index, Record& record, Registers* registers = nullptr);
+
+      private:
+        static constexpr unsigned c_checkpointInterval = 4096;
+        struct Checkpoint {
+            size_t offset;
+            uint32_t pc;
+            Registers registers;
+        };
+        struct Cursor {
+            uint64_t index;
+            size_t offset;
+            uint32_t pc;
+            Registers registers;
+        };
+        bool parse(Cursor& cursor, Record& record) const;
+
+        std::string m_data;
+        std::vector<Checkpoint> m_checkpoints;
+        uint64_t m_size = 0;
+        Cursor m_cursor;
+    };
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    // The registers are the ones the trace starts from; the pc is the one of the first instruction recorded.
+    bool start(IO<File> file, const uint32_t* registers);
+    // Flushes whatever is left, and waits for it to be written out.
+    void stop();
+    bool recording() const { return m_recording; }
+    uint64_t instructions() const { return m_instructions; }
+
+    // Called by the interpreter around each instruction, with the registers before and after it ran.
+    // The memory is only used to peek at what a load is going to read; it can be null.
+    void begin(uint32_t pc, uint32_t code, const uint32_t* registers, Memory* memory);
+    void end(const uint32_t* registers);
+
+    // Same as Rewind: the worker can't be in the middle of anything while forking, and the child doesn't
+    // keep on writing into the parent's file.
+    void prepareFork();
+    void afterFork(bool child);
+
+  private:
+    static constexpr size_t c_bufferSize = 1024 * 1024;
+    static constexpr unsigned c_maxPending = 4;
+
+    void flushBuffer();
+    void worker();
+    void waitForWorker(std::unique_lock<std::mutex>& lock);
+
+    bool m_recording = false;
+    uint64_t m_instructions = 0;
+    Registers m_registers;
+    uint32_t m_nextPC = 0;
+    std::string m_buffer;
+    // Where the first pc goes in the header, and where the record of the instruction currently running starts.
+    size_t m_headerPC = 0;
+    size_t m_recordStart = 0;
+    bool m_inRecord = false;
+
+    IO<File> m_file;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::string> m_pending;
+    bool m_busy = false;
+    bool m_stop = false;
+    bool m_forked = false;
+    std::thread m_thread;
+};
+
+}  // namespace PCSX
@@ -23,10 +23,12 @@
 
 #include "core/callstacks.h"
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gpu.h"
 #include "core/pad.h"
 #include "core/psxemulator.h"
 #include "core/spu.h"
+#include "support/uvfile.h"
 #include "supportpsx/binloader.h"
 
 PCSX::UI::UI() : m_listener(g_system->m_eventBus) {
@@ -57,6 +59,7 @@ bool PCSX::UI::loadSettings() {
 void PCSX::UI::finishLoadSettings() {
     auto& emuSettings = g_emulator->settings;
     g_system->activateLocale(emuSettings.get<Emulator::SettingLocale>());
+    UvFile::shareCaches(emuSettings.get<Emulator::SettingShareCachedFiles>());
     g_system->m_eventBus->signal(Events::SettingsLoaded{g_system->getArgs().isSafeModeEnabled()});
 }
 
@@ -77,10 +80,12 @@ end)(jit.status()))
 
 void PCSX::UI::tick() {
     uv_run(g_system->getLoop(), UV_RUN_NOWAIT);
+    if (SettingsChanges::consume()) g_system->m_eventBus->signal(Events::SettingsChanged{});
     auto L = *g_emulator->m_lua;
     L.getfield("AfterPollingCleanup", LUA_GLOBALSINDEX);
     if (!L.isnil()) {
         try {
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
             L.pcall();
         } catch (...) {
         }
@@ -114,6 +119,7 @@ void PCSX::UI::shellReached() {
             throw std::runtime_error("Failed to open file.");
         }
         success = BinaryLoader::load(in, g_emulator->m_mem->getMemoryAsFile(), info, g_emulator->m_cpu->m_symbols);
+        g_emulator->m_cpu->symbolsChanged();
         if (!info.pc.has_value()) {
             throw std::runtime_error("Binary loaded without any PC to jump to.");
         }
@@ -154,6 +160,7 @@ void PCSX::UI::shellReached() {
                     if (!addressValid) continue;
                     g_emulator->m_cpu->m_symbols[address] = name;
                 }
+                g_emulator->m_cpu->symbolsChanged();
             }
         }
     } else {
@@ -0,0 +1,131 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/vramdelta.h"
+
+#include <string.h>
+
+namespace {
+
+constexpr unsigned c_tilesX = PCSX::VRAMDelta::c_width / PCSX::VRAMDelta::c_tileWidth;
+constexpr unsigned c_tilesY = PCSX::VRAMDelta::c_height / PCSX::VRAMDelta::c_tileHeight;
+
+template <typename T>
+void append(std::string& out, T value) {
+    for (unsigned i = 0; i < sizeof(T); i++) out.push_back(char(value >> (i * 8)));
+}
+
+template <typename T>
+bool fetch(const std::string& in, size_t& pos, T& value) {
+    if (in.size() - pos < sizeof(T)) return false;
+    value = 0;
+    for (unsigned i = 0; i < sizeof(T); i++) value |= T(uint8_t(in[pos++])) << (i * 8);
+    return true;
+}
+
+bool tileChanged(const uint16_t* a, const uint16_t* b, unsigned tx, unsigned ty) {
+    const unsigned offset = ty * PCSX::VRAMDelta::c_tileHeight * PCSX::VRAMDelta::c_width +
+                            tx * PCSX::VRAMDelta::c_tileWidth;
+    for (unsigned y = 0; y < PCSX::VRAMDelta::c_tileHeight; y++) {
+        const unsigned line = offset + y * PCSX::VRAMDelta::c_width;
+        if (memcmp(a + line, b + line, PCSX::VRAMDelta::c_tileWidth * sizeof(uint16_t)) != 0) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+std::string PCSX::VRAMDelta::encode(const uint16_t* vram, uint32_t sequence) {
+    struct Rect {
+        uint16_t x, y, w, h;
+    };
+    std::vector<Rect> rects;
+    const bool keyframe = m_previous.empty();
+    if (keyframe) {
+        rects.push_back({0, 0, c_width, c_height});
+    } else {
+        for (unsigned ty = 0; ty < c_tilesY; ty++) {
+            unsigned tx = 0;
+            while (tx < c_tilesX) {
+                if (!tileChanged(vram, m_previous.data(), tx, ty)) {
+                    tx++;
+                    continue;
+                }
+                const unsigned start = tx;
+                while ((tx < c_tilesX) && tileChanged(vram, m_previous.data(), tx, ty)) tx++;
+                rects.push_back({uint16_t(start * c_tileWidth), uint16_t(ty * c_tileHeight),
+                                 uint16_t((tx - start) * c_tileWidth), uint16_t(c_tileHeight)});
+            }
+        }
+        if (rects.empty()) return {};
+    }
+
+    size_t pixels = 0;
+    for (auto& rect : rects) pixels += rect.w * rect.h;
+    std::string out;
+    out.reserve(12 + rects.size() * 8 + pixels * 2);
+    append(out, c_magic);
+    append(out, sequence);
+    append(out, uint16_t(rects.size()));
+    append(out, uint16_t(keyframe ? c_keyframe : 0));
+    for (auto& rect : rects) {
+        append(out, rect.x);
+        append(out, rect.y);
+        append(out, rect.w);
+        append(out, rect.h);
+        for (unsigned y = 0; y < rect.h; y++) {
+            // Same as the raw VRAM endpoint, the pixels go out the way they are in memory
+            const uint16_t* line = vram + (rect.y + y) * c_width + rect.x;
+            out.append(reinterpret_cast<const char*>(line), rect.w * sizeof(uint16_t));
+        }
+    }
+
+    if (keyframe) {
+        m_previous.assign(vram, vram + c_width * c_height);
+    } else {
+        for (auto& rect : rects) {
+            for (unsigned y = rect.y; y < rect.y + rect.h; y++) {
+                memcpy(m_previous.data() + y * c_width + rect.x, vram + y * c_width + rect.x,
+                       rect.w * sizeof(uint16_t));
+            }
+        }
+    }
+    return out;
+}
+
+bool PCSX::VRAMDelta::decode(const std::string& frame, uint16_t* vram) {
+    size_t pos = 0;
+    uint32_t magic, sequence;
+    uint16_t count, flags;
+    if (!fetch(frame, pos, magic) || (magic != c_magic)) return false;
+    if (!fetch(frame, pos, sequence) || !fetch(frame, pos, count) || !fetch(frame, pos, flags)) return false;
+    for (unsigned i = 0; i < count; i++) {
+        uint16_t x, y, w, h;
+        if (!fetch(frame, pos, x) || !fetch(frame, pos, y) || !fetch(frame, pos, w) || !fetch(frame, pos, h)) {
+            return false;
+        }
+        if ((x + w > c_width) || (y + h > c_height)) return false;
+        if (frame.size() - pos < size_t(w) * h * sizeof(uint16_t)) return false;
+        for (unsigned line = 0; line < h; line++) {
+            memcpy(vram + (y + line) * c_width + x, frame.data() + pos, w * sizeof(uint16_t));
+            pos += w * sizeof(uint16_t);
+        }
+    }
+    return pos == frame.size();
+}
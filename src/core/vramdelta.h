@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace PCSX {
+
+// Encodes VRAM as a stream of frames holding only what changed since the previous frame, for the web server
+// to push to remote viewers without sending the whole megabyte every time. VRAM is cut into tiles of
+// 64x16 pixels, and the horizontal runs of tiles which changed in the same band of lines are sent as one
+// rectangle. Each viewer needs its own encoder, since they don't all get the same frames.
+//
+// A frame is, in little endian:
+//   uint32_t magic ("VRMD"), uint32_t sequence, uint16_t rectangle count, uint16_t flags (bit 0: keyframe)
+// followed by each rectangle, as uint16_t x, y, width, height, and its pixels line by line.
+class VRAMDelta {
+  public:
+    static constexpr uint32_t c_magic = 0x444d5256;  // "VRMD"
+    static constexpr unsigned c_width = 1024;
+    static constexpr unsigned c_height = 512;
+    static constexpr unsigned c_tileWidth = 64;
+    static constexpr unsigned c_tileHeight = 16;
+    static constexpr uint16_t c_keyframe = 1;
+
+    // Encodes this VRAM against the last one encoded. The first frame, and the first one after reset(), is
+    // a keyframe holding the whole of VRAM. Returns an empty string, and keeps the previous frame as it was,
+    // if nothing changed.
+    std::string encode(const uint16_t* vram, uint32_t sequence);
+    void reset() { m_previous.clear(); }
+
+    // Applies an encoded frame onto a VRAM, the way a viewer would; returns false if it isn't a proper frame.
+    static bool decode(const std::string& frame, uint16_t* vram);
+
+  private:
+    std::vector<uint16_t> m_previous;
+};
+
+}  // namespace PCSX
@@ -21,29 +21,38 @@
 
 #include <llhttp.h>
 #include <multipart_parser.h>
+#include <zlib.h>
 
 #include <charconv>
+#include <chrono>
 #include <magic_enum_all.hpp>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "GL/gl3w.h"
 #include "cdrom/cdriso.h"
+#include "cdrom/dischasher.h"
 #include "cdrom/file.h"
 #include "cdrom/iso9660-builder.h"
 #include "cdrom/iso9660-reader.h"
+#include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
+#include "core/spu.h"
+#include "core/sstate.h"
 #include "core/system.h"
+#include "core/vramdelta.h"
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
 #include "support/file.h"
-#include "support/hashtable.h"
 #include "support/strings-helpers.h"
+#include "tracy/Tracy.hpp"
 #include "uriparser/Uri.h"
 
 namespace {
@@ -54,10 +63,7 @@ class VramExecutor : public PCSX::WebExecutor {
     }
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            client->write(
-                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 1048576\r\n\r\n");
-            client->write(PCSX::g_emulator->m_gpu->getVRAM());
-
+            write200(client, "application/octet-stream", PCSX::g_emulator->m_gpu->getVRAMSnapshot());
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
             auto vars = parseQuery(request.urlData.query);
@@ -108,19 +114,17 @@ class RamExecutor : public PCSX::WebExecutor {
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
         const auto& ram8M = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>().value;
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
-            if (ram8M) {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 8388608\r\n\r\n");
-            } else {
-                client->write(
-                    "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 2097152\r\n\r\n");
-            }
             uint32_t size = 1024 * 1024 * (ram8M ? 8 : 2);
-            uint8_t* data = (uint8_t*)malloc(size);
-            memcpy(data, PCSX::g_emulator->m_mem->m_wram, size);
             PCSX::Slice slice;
-            slice.acquire(data, size);
-            client->write(std::move(slice));
+            if (PCSX::g_system->running()) {
+                // The write may only complete after more of the game ran, so it needs to be a snapshot
+                uint8_t* data = (uint8_t*)malloc(size);
+                memcpy(data, PCSX::g_emulator->m_mem->m_wram, size);
+                slice.acquire(data, size);
+            } else {
+                slice.borrow(PCSX::g_emulator->m_mem->m_wram, size);
+            }
+            write200(client, "application/octet-stream", std::move(slice));
             return true;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
             const auto ramSize = (ram8M ? 8 : 2) * 1024 * 1024;
@@ -144,6 +148,7 @@ class RamExecutor : public PCSX::WebExecutor {
             }
 
             memcpy(PCSX::g_emulator->m_mem->m_wram + offset, request.body.data<uint8_t>(), size);
+            PCSX::g_emulator->m_mem->markRAMDirty(offset, size);
             client->write("HTTP/1.1 200 OK\r\n\r\n");
             return true;
         }
@@ -171,6 +176,7 @@ class AssemblyExecutor : public PCSX::WebExecutor {
             auto& cpu = PCSX::g_emulator->m_cpu;
             if (function.compare("reset") == 0) {
                 cpu->m_symbols.clear();
+                cpu->symbolsChanged();
                 client->write("HTTP/1.1 200 OK\r\n\r\n");
                 return true;
             }
@@ -192,6 +198,7 @@ class AssemblyExecutor : public PCSX::WebExecutor {
 
                     cpu->m_symbols[address] = name;
                 }
+                cpu->symbolsChanged();
                 client->write("HTTP/1.1 200 OK\r\n\r\n");
                 return true;
             }
@@ -206,6 +213,71 @@ class AssemblyExecutor : public PCSX::WebExecutor {
     virtual ~AssemblyExecutor() = default;
 };
 
+// Everything the reverse engineering tools sync from the emulator, in one little endian binary blob, so tens of
+// thousands of entries don't need to go through text. After the "PCSXSYMX" signature come the version, then the
+// amount of symbols, call frames, and coverage words, all as 32 bits integers, followed by:
+//  - the symbols, each as its address, the length of its name, and the name itself,
+//  - the frames of all the call stacks being tracked, each as the lowest and highest stack pointers of its call
+//    stack, and the stack pointer, frame pointer, and return address of the call,
+//  - the dynarec's coverage bitmap, as 64 bits words, one bit per word of RAM, see R3000Acpu::getCodeCoverage.
+class SymbolsExportExecutor : public PCSX::WebExecutor {
+    static constexpr uint32_t c_version = 1;
+
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/assembly/export";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_GET) return false;
+        auto& cpu = PCSX::g_emulator->m_cpu;
+        auto& callStacks = PCSX::g_emulator->m_callStacks;
+        const auto coverage = cpu->getCodeCoverage();
+
+        uint32_t frameCount = 0;
+        size_t size = 8 + 4 * 4 + coverage.size() * 8;
+        for (auto& [address, name] : cpu->m_symbols) size += 8 + name.size();
+        for (auto& stack : callStacks->getCallstacks()) frameCount += stack.calls.size();
+        size += frameCount * 20;
+
+        std::string out;
+        out.reserve(size);
+        auto put32 = [&out](uint32_t value) {
+            for (unsigned i = 0; i < 4; i++) out.push_back(char(value >> (i * 8)));
+        };
+        out.append("PCSXSYMX", 8);
+        put32(c_version);
+        put32(cpu->m_symbols.size());
+        put32(frameCount);
+        put32(coverage.size());
+        for (auto& [address, name] : cpu->m_symbols) {
+            put32(address);
+            put32(name.size());
+            out.append(name);
+        }
+        for (auto& stack : callStacks->getCallstacks()) {
+            for (auto& call : stack.calls) {
+                put32(stack.getLow());
+                put32(stack.getHigh());
+                put32(call.sp);
+                put32(call.fp);
+                put32(call.ra);
+            }
+        }
+        for (auto word : coverage) {
+            put32(word);
+            put32(word >> 32);
+        }
+
+        PCSX::Slice slice;
+        slice.acquire(std::move(out));
+        write200(client, "application/octet-stream", std::move(slice));
+        return true;
+    }
+
+  public:
+    SymbolsExportExecutor() = default;
+    virtual ~SymbolsExportExecutor() = default;
+};
+
 class CacheExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return urldata.path == "/api/v1/cpu/cache";
@@ -404,6 +476,244 @@ class LuaExecutor : public PCSX::WebExecutor {
     virtual ~LuaExecutor() = default;
 };
 
+// Runs Lua code as jobs, for code which takes longer than a request should:
+//   POST /api/v1/lua-jobs with the code as the body starts a job, and replies with {"id": ...}
+//   GET /api/v1/lua-jobs/<id> replies with its status, and whatever it output since the last time; once it replies
+//     with the job being done or failed, the job is forgotten
+//   GET /api/v1/lua-jobs/<id>/stream streams the same as lines of json, up to the end of the job
+//   DELETE /api/v1/lua-jobs/<id> cancels it
+// Jobs run as coroutines from the server's polls, so in between frames, sharing a small time budget. They need to
+// call coroutine.yield() every so often to let the emulator go on, and whatever they yield is their output. The
+// value they return is their result. One running for too long without yielding gets stopped with an error.
+class LuaJobsExecutor : public PCSX::WebExecutor {
+    using Clock = std::chrono::steady_clock;
+    enum class Status { Running, Done, Failed };
+    struct Job {
+        Status status = Status::Running;
+        lua_State* thread = nullptr;
+        std::string output;
+        nlohmann::json result;
+        std::string error;
+        PCSX::WebClient* streamer = nullptr;
+        // Once streamed to its end, there's nobody left to fetch it.
+        bool forget = false;
+    };
+
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return (urldata.path == c_path) || PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.urlData.path == c_path) {
+            if (request.method != PCSX::RequestData::Method::HTTP_POST) return false;
+            submit(client, request);
+            return true;
+        }
+
+        std::string_view rest = request.urlData.path;
+        rest.remove_prefix(c_prefix.length());
+        bool stream = PCSX::StringsHelpers::endsWith(rest, "/stream");
+        if (stream) rest.remove_suffix(7);
+        uint64_t id;
+        auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), id);
+        auto job = m_jobs.end();
+        if ((ec == std::errc()) && (ptr == rest.data() + rest.size())) job = m_jobs.find(id);
+        if (job == m_jobs.end()) {
+            client->write("HTTP/1.1 404 Not Found\r\n\r\nNo such job.\r\n");
+            return true;
+        }
+
+        if (request.method == PCSX::RequestData::Method::HTTP_DELETE) {
+            if (stream) return false;
+            cancel(job->first, job->second);
+            m_jobs.erase(job);
+            client->write("HTTP/1.1 200 OK\r\n\r\n");
+            return true;
+        }
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+
+        if (!stream) {
+            auto j = state(id, job->second);
+            j["output"] = std::move(job->second.output);
+            job->second.output.clear();
+            if (job->second.status != Status::Running) m_jobs.erase(job);
+            write200(client, j);
+            return true;
+        }
+
+        if (job->second.streamer) {
+            client->write("HTTP/1.1 409 Conflict\r\n\r\nThis job is already being streamed.\r\n");
+            return true;
+        }
+        client->write(
+            "HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nCache-Control: no-cache\r\n"
+            "Transfer-Encoding: chunked\r\n\r\n");
+        if (job->second.status != Status::Running) {
+            // Nothing left to wait for, so this goes out as a regular response.
+            writeOutput(client, job->second);
+            writeChunk(client, state(id, job->second).dump() + "\n");
+            writeChunk(client, "");
+            m_jobs.erase(job);
+            return true;
+        }
+        job->second.streamer = client;
+        writeOutput(client, job->second);
+        client->startStreaming([this, id]() {
+            auto job = m_jobs.find(id);
+            if (job != m_jobs.end()) job->second.streamer = nullptr;
+        });
+        return true;
+    }
+
+    void submit(PCSX::WebClient* client, PCSX::RequestData& request) {
+        if (m_jobs.size() >= c_maxJobs) {
+            client->write("HTTP/1.1 503 Service Unavailable\r\n\r\nToo many jobs.\r\n");
+            return;
+        }
+        auto L = *PCSX::g_emulator->m_lua;
+        auto body = request.body.data<char>();
+        if (luaL_loadbuffer(L.getState(), body, request.body.size(), "web job") != 0) {
+            std::string message = "HTTP/1.1 400 Bad Request\r\n\r\n";
+            message += L.tostring();
+            message += "\r\n";
+            L.pop();
+            client->write(std::move(message));
+            return;
+        }
+        // The thread stays referenced from the registry until the job is over, so it doesn't get collected.
+        auto thread = L.thread(true);  // -2 = function, -1 = thread
+        L.copy(-2);                    // -3 = function, -2 = thread, -1 = function
+        lua_xmove(L.getState(), thread.getState(), 1);
+        L.pop(2);
+        uint64_t id = m_nextId++;
+        m_jobs[id].thread = thread.getState();
+        write200(client, nlohmann::json{{"id", id}});
+    }
+
+    virtual void poll() final {
+        auto deadline = Clock::now() + c_budget;
+        bool running = true;
+        while (running && (Clock::now() < deadline)) {
+            running = false;
+            for (auto& [id, job] : m_jobs) {
+                if (job.status != Status::Running) continue;
+                resume(job);
+                if (job.streamer) flush(id, job);
+                running = true;
+                if (Clock::now() >= deadline) break;
+            }
+        }
+        std::erase_if(m_jobs, [](const auto& job) { return job.second.forget; });
+    }
+
+    void resume(Job& job) {
+        PCSX::Lua L(job.thread);
+        // Hooks are global to the whole VM with LuaJIT, so this one only stays around while the job runs.
+        auto hook = lua_gethook(job.thread);
+        auto mask = lua_gethookmask(job.thread);
+        auto count = lua_gethookcount(job.thread);
+        s_watchdog = Clock::now() + c_watchdog;
+        L.sethook(watchdog, LUA_MASKCOUNT, c_watchdogCount);
+        int r = lua_resume(job.thread, 0);
+        L.sethook(hook, mask, count);
+        if (r == LUA_YIELD) {
+            for (int i = 1; i <= L.gettop(); i++) {
+                if (L.isstring(i)) job.output += L.tostring(i);
+            }
+            lua_settop(job.thread, 0);
+            return;
+        }
+        if (r == 0) {
+            job.status = Status::Done;
+            if (L.gettop() >= 1) {
+                if (L.isboolean(1)) {
+                    job.result = L.toboolean(1);
+                } else if (L.isnumber(1)) {
+                    job.result = L.tonumber(1);
+                } else if (L.isstring(1)) {
+                    job.result = L.tostring(1);
+                } else if (L.istable(1)) {
+                    job.result = L.toJson(1);
+                }
+            }
+        } else {
+            job.status = Status::Failed;
+            job.error = L.isstring() ? L.tostring() : "Unknown error while running the job.";
+        }
+        release(job);
+    }
+
+    static void watchdog(lua_State* L, lua_Debug*) {
+        if (Clock::now() >= s_watchdog) luaL_error(L, "The job ran for too long without yielding.");
+    }
+
+    static void release(Job& job) {
+        if (!job.thread) return;
+        lua_settop(job.thread, 0);
+        PCSX::Lua(job.thread).weaken();
+        job.thread = nullptr;
+    }
+
+    void cancel(uint64_t id, Job& job) {
+        release(job);
+        if (!job.streamer) return;
+        auto streamer = job.streamer;
+        job.streamer = nullptr;
+        writeChunk(streamer, nlohmann::json{{"id", id}, {"status", "cancelled"}}.dump() + "\n");
+        writeChunk(streamer, "");
+        streamer->endStreaming();
+    }
+
+    static nlohmann::json state(uint64_t id, const Job& job) {
+        nlohmann::json j = {{"id", id}};
+        switch (job.status) {
+            case Status::Running:
+                j["status"] = "running";
+                break;
+            case Status::Done:
+                j["status"] = "done";
+                j["result"] = job.result;
+                break;
+            case Status::Failed:
+                j["status"] = "failed";
+                j["error"] = job.error;
+                break;
+        }
+        return j;
+    }
+
+    void writeOutput(PCSX::WebClient* client, Job& job) {
+        if (job.output.empty()) return;
+        writeChunk(client, nlohmann::json{{"output", std::move(job.output)}}.dump() + "\n");
+        job.output.clear();
+    }
+
+    // Sends what the job output since the last time to its streamer, and ends the stream if the job is over.
+    void flush(uint64_t id, Job& job) {
+        writeOutput(job.streamer, job);
+        if (job.status == Status::Running) return;
+        auto streamer = job.streamer;
+        job.streamer = nullptr;
+        writeChunk(streamer, state(id, job).dump() + "\n");
+        writeChunk(streamer, "");
+        streamer->endStreaming();
+        job.forget = true;
+    }
+
+    static constexpr size_t c_maxJobs = 64;
+    static constexpr std::chrono::milliseconds c_budget{4};
+    static constexpr std::chrono::seconds c_watchdog{1};
+    static constexpr int c_watchdogCount = 10000;
+    static inline Clock::time_point s_watchdog;
+    std::map<uint64_t, Job> m_jobs;
+    uint64_t m_nextId = 1;
+
+  public:
+    const std::string_view c_path = "/api/v1/lua-jobs";
+    const std::string_view c_prefix = "/api/v1/lua-jobs/";
+    LuaJobsExecutor() = default;
+    virtual ~LuaJobsExecutor() = default;
+};
+
 class CDExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
@@ -455,9 +765,46 @@ class CDExecutor : public PCSX::WebExecutor {
                 auto buffer = file->read(size);
                 client->write(std::move(buffer));
                 return true;
+            } else if (path == "hash") {
+                writeHashStatus(client);
+                return true;
+            } else if (path == "fast-stats") {
+                nlohmann::json j;
+                const auto& stats = cdrom->getFastCDStats();
+                j["active"] = cdrom->fastCDActive();
+                j["speed"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingFastCDSpeed>().value;
+                j["clock"] = PCSX::g_emulator->m_psxClockSpeed;
+                j["totalSaved"] = stats.totalSaved;
+                j["lastSaved"] = stats.lastSaved;
+                j["lastSectors"] = stats.lastSectors;
+                j["loads"] = stats.loads;
+                write200(client, j);
+                return true;
             }
             return false;
         } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            if (path == "hash") {
+                auto vars = parseQuery(request.urlData.query);
+                auto function = vars.find("function");
+                if (function == vars.end()) {
+                    client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                    return true;
+                }
+                if (function->second == "start") {
+                    if (iso->failed()) {
+                        client->write("HTTP/1.1 404 File Not Found\r\n\r\nNo disc image currently loaded.");
+                        return true;
+                    }
+                    m_hasher.reset(new PCSX::DiscHasher(iso));
+                } else if (function->second == "cancel") {
+                    if (m_hasher) m_hasher->cancel();
+                } else {
+                    client->write("HTTP/1.1 400 Bad Request\r\n\r\nUnknown function.");
+                    return true;
+                }
+                writeHashStatus(client);
+                return true;
+            }
             if (path == "patch") {
                 auto vars = parseQuery(request.urlData.query);
                 auto filename = vars.find("filename");
@@ -531,6 +878,33 @@ class CDExecutor : public PCSX::WebExecutor {
         return false;
     }
 
+    // The last hashing job that got started, which keeps running in the background between requests.
+    void writeHashStatus(PCSX::WebClient* client) {
+        nlohmann::json j;
+        if (!m_hasher) {
+            j["status"] = "IDLE";
+            write200(client, j);
+            return;
+        }
+        const auto status = m_hasher->status();
+        j["status"] = magic_enum::enum_name(status);
+        j["progress"] = m_hasher->progress();
+        if (status == PCSX::DiscHasher::Status::DONE) {
+            j["crc32"] = fmt::format("{:08x}", m_hasher->fullCRC32());
+            const auto& tracks = m_hasher->tracks();
+            for (unsigned t = 0; t < tracks.size(); t++) {
+                j["tracks"][t]["track"] = t + 1;
+                j["tracks"][t]["sectors"] = tracks[t].sectors;
+                j["tracks"][t]["crc32"] = fmt::format("{:08x}", tracks[t].crc32);
+                j["tracks"][t]["md5"] = tracks[t].md5String();
+                j["tracks"][t]["sha1"] = tracks[t].sha1String();
+            }
+        }
+        write200(client, j);
+    }
+
+    std::unique_ptr<PCSX::DiscHasher> m_hasher;
+
   public:
     const std::string_view c_prefix = "/api/v1/cd/";
     CDExecutor() = default;
@@ -542,11 +916,42 @@ class StateExecutor : public PCSX::WebExecutor {
         return PCSX::StringsHelpers::startsWith(urldata.path, c_prefix);
     }
     virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto path = request.urlData.path.substr(c_prefix.length());
+        // The rewind buffer lives in memory, and doesn't need the UI.
+        if ((request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) && (path == "rewind")) {
+            auto vars = parseQuery(request.urlData.query);
+            auto isteps = vars.find("steps");
+            unsigned steps = 1;
+            if ((isteps != vars.end()) && isteps->second.has_value()) {
+                try {
+                    steps = std::stoul(isteps->second.value());
+                } catch (std::exception const& ex) {
+                    client->write(
+                        fmt::format("HTTP/1.1 400 Bad Request\r\n\r\nFailed to parse steps value \"{}\".",
+                                    isteps->second.value()));
+                    return true;
+                }
+            }
+            if ((steps == 0) || !PCSX::SaveStates::rewind(steps)) {
+                client->write("HTTP/1.1 500 Internal Server Error\r\n\r\nNothing to rewind to.");
+                return true;
+            }
+            client->write(fmt::format("HTTP/1.1 200 OK\r\n\r\nRewound {} step(s).", steps));
+            return true;
+        } else if ((request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) && (path == "rewind-info")) {
+            nlohmann::json j;
+            auto& rewind = PCSX::g_emulator->m_rewind;
+            j["enabled"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingRewind>().value;
+            j["count"] = rewind->count();
+            j["memoryUsed"] = rewind->memoryUsed();
+            j["dropped"] = rewind->dropped();
+            write200(client, j);
+            return true;
+        }
         if (PCSX::g_gui == nullptr) {
             client->write("HTTP/1.1 500 Internal Server Error\r\n\r\nSave states unavailable in CLI/no-UI mode.");
             return false;
         }
-        auto path = request.urlData.path.substr(c_prefix.length());
 
         if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
             if (path == "usage") {
@@ -765,8 +1170,282 @@ class ScreenExecutor : public PCSX::WebExecutor {
     virtual ~ScreenExecutor() = default;
 };
 
+// Pushes VRAM to the viewer at every vblank, as the tiles which changed since the last frame it got, in the
+// VRAMDelta format, each frame being one chunk of a chunked response. The "interval" query parameter only sends
+// one vblank out of that many. A viewer which doesn't keep up gets frames dropped until its socket drains; since
+// the deltas are against the last frame it actually got, it doesn't miss anything besides the intermediate frames.
+class VramStreamExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/gpu/vram/stream";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto vars = parseQuery(request.urlData.query);
+        unsigned interval = 1;
+        auto iinterval = vars.find("interval");
+        if ((iinterval != vars.end()) && iinterval->second.has_value()) {
+            auto& str = iinterval->second.value();
+            auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), interval);
+            if ((ec != std::errc()) || (interval == 0)) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\nInvalid interval.\r\n");
+                return true;
+            }
+        }
+        client->write(
+            "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nCache-Control: no-cache\r\n"
+            "Transfer-Encoding: chunked\r\n\r\n");
+        Viewer* viewer = new Viewer();
+        viewer->client = client;
+        viewer->interval = interval;
+        m_viewers.push_back(viewer);
+        client->startStreaming([viewer]() { delete viewer; });
+        return true;
+    }
+
+    void vsync() {
+        m_frame++;
+        if (m_viewers.empty()) return;
+        PCSX::Slice vram;
+        for (auto& viewer : m_viewers) {
+            if ((m_frame % viewer.interval) != 0) continue;
+            if (viewer.client->pendingBytes() > c_maxPendingBytes) continue;
+            if (vram.size() == 0) vram = PCSX::g_emulator->m_gpu->getVRAMSnapshot();
+            std::string frame = viewer.delta.encode(vram.data<uint16_t>(), m_frame);
+            if (frame.empty()) continue;
+            writeChunk(viewer.client, std::move(frame));
+        }
+    }
+
+    struct Viewer : public PCSX::Intrusive::List<Viewer>::Node {
+        PCSX::WebClient* client;
+        PCSX::VRAMDelta delta;
+        unsigned interval;
+    };
+    // Enough for a keyframe and then some
+    static constexpr size_t c_maxPendingBytes = 2 * 1024 * 1024;
+    PCSX::Intrusive::List<Viewer> m_viewers;
+    PCSX::EventBus::Listener m_listener;
+    uint32_t m_frame = 0;
+
+  public:
+    VramStreamExecutor() : m_listener(PCSX::g_system->m_eventBus) {
+        m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) { vsync(); });
+    }
+    virtual ~VramStreamExecutor() = default;
+};
+
+// Reads a list of ranges of memory in one go. They're in the "ranges" query parameter, comma separated, each as
+// region:offset:size, in hex, with the region being one of ram, scratchpad, vram, or spu. The reply is a little
+// endian uint32_t vblank counter, followed by the bytes of all the ranges back to back. While the emulator runs,
+// the reply waits for the next vblank, so that all of the ranges come from the same frame. With the "interval"
+// query parameter, the connection stays open instead, and gets the ranges again every that many vblanks, as the
+// chunks of a chunked response, skipping them while the client is behind.
+class MemoryBatchExecutor : public PCSX::WebExecutor {
+    enum class Region { RAM, Scratchpad, VRAM, SPU };
+    struct Range {
+        Region region;
+        uint32_t offset;
+        uint32_t size;
+    };
+    struct Reader : public PCSX::Intrusive::List<Reader>::Node {
+        PCSX::WebClient* client;
+        std::vector<Range> ranges;
+        unsigned interval = 0;
+    };
+
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/memory/read";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto vars = parseQuery(request.urlData.query);
+        auto iranges = vars.find("ranges");
+        if ((iranges == vars.end()) || !iranges->second.has_value()) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nMissing ranges.\r\n");
+            return true;
+        }
+        auto reader = std::make_unique<Reader>();
+        reader->client = client;
+        if (!parseRanges(iranges->second.value(), reader->ranges)) {
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\nInvalid ranges.\r\n");
+            return true;
+        }
+        auto iinterval = vars.find("interval");
+        if ((iinterval != vars.end()) && iinterval->second.has_value()) {
+            auto& str = iinterval->second.value();
+            auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), reader->interval);
+            if ((ec != std::errc()) || (reader->interval == 0)) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\nInvalid interval.\r\n");
+                return true;
+            }
+        }
+
+        if (reader->interval != 0) {
+            client->write(
+                "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nCache-Control: no-cache\r\n"
+                "Transfer-Encoding: chunked\r\n\r\n");
+        } else if (!PCSX::g_system->running()) {
+            // Nothing is moving, so now is as good as any vblank
+            PCSX::Slice vram;
+            writeReply(client, read(reader->ranges, vram));
+            return true;
+        }
+        Reader* pending = reader.release();
+        m_readers.push_back(pending);
+        client->startStreaming([pending]() { delete pending; });
+        return true;
+    }
+
+    static bool parseRanges(const std::string& str, std::vector<Range>& ranges) {
+        const auto& ram8M = PCSX::g_emulator->settings.get<PCSX::Emulator::Setting8MB>().value;
+        const uint32_t ramSize = (ram8M ? 8 : 2) * 1024 * 1024;
+        for (auto& rangeStr : PCSX::StringsHelpers::split(std::string_view(str), ",")) {
+            auto fields = PCSX::StringsHelpers::split(rangeStr, ":", true);
+            if ((fields.size() != 3) || (ranges.size() == c_maxRanges)) return false;
+            Range range;
+            uint32_t regionSize;
+            if (fields[0] == "ram") {
+                range.region = Region::RAM;
+                regionSize = ramSize;
+            } else if (fields[0] == "scratchpad") {
+                range.region = Region::Scratchpad;
+                regionSize = 1024;
+            } else if (fields[0] == "vram") {
+                range.region = Region::VRAM;
+                regionSize = 1024 * 1024;
+            } else if (fields[0] == "spu") {
+                range.region = Region::SPU;
+                regionSize = 512 * 1024;
+            } else {
+                return false;
+            }
+            auto parse = [](std::string_view field, uint32_t& value) {
+                auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value, 16);
+                return (ec == std::errc()) && (ptr == field.data() + field.size());
+            };
+            if (!parse(fields[1], range.offset) || !parse(fields[2], range.size)) return false;
+            if ((range.offset >= regionSize) || (range.size > regionSize - range.offset)) return false;
+            ranges.push_back(range);
+        }
+        return !ranges.empty();
+    }
+
+    // The VRAM only gets fetched if one of the ranges needs it, and then once for all of the readers of a vblank
+    std::string read(const std::vector<Range>& ranges, PCSX::Slice& vram) {
+        std::string out;
+        for (unsigned i = 0; i < 4; i++) out.push_back(char(m_frame >> (i * 8)));
+        for (auto& range : ranges) {
+            const uint8_t* base = nullptr;
+            switch (range.region) {
+                case Region::RAM:
+                    base = PCSX::g_emulator->m_mem->m_wram;
+                    break;
+                case Region::Scratchpad:
+                    base = PCSX::g_emulator->m_mem->m_hard;
+                    break;
+                case Region::VRAM:
+                    if (vram.size() == 0) vram = PCSX::g_emulator->m_gpu->getVRAMSnapshot();
+                    base = vram.data<uint8_t>();
+                    break;
+                case Region::SPU:
+                    base = PCSX::g_emulator->m_spu->getRAM();
+                    break;
+            }
+            out.append(reinterpret_cast<const char*>(base + range.offset), range.size);
+        }
+        return out;
+    }
+
+    void writeReply(PCSX::WebClient* client, std::string&& data) {
+        write200(client, "application/octet-stream", PCSX::Slice(std::move(data)));
+    }
+
+    void vsync() {
+        m_frame++;
+        PCSX::Slice vram;
+        for (auto it = m_readers.begin(); it != m_readers.end();) {
+            Reader& reader = *it++;
+            if (reader.interval == 0) {
+                writeReply(reader.client, read(reader.ranges, vram));
+                // The reader goes away along with the connection
+                reader.unlink();
+                reader.client->endStreaming();
+            } else if (((m_frame % reader.interval) == 0) && (reader.client->pendingBytes() <= c_maxPendingBytes)) {
+                writeChunk(reader.client, read(reader.ranges, vram));
+            }
+        }
+    }
+
+    static constexpr size_t c_maxRanges = 1024;
+    static constexpr size_t c_maxPendingBytes = 2 * 1024 * 1024;
+    PCSX::Intrusive::List<Reader> m_readers;
+    PCSX::EventBus::Listener m_listener;
+    uint32_t m_frame = 0;
+
+  public:
+    MemoryBatchExecutor() : m_listener(PCSX::g_system->m_eventBus) {
+        m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) { vsync(); });
+    }
+    virtual ~MemoryBatchExecutor() = default;
+};
+
+class AudioTelemetryExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/spu/telemetry";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            write200(client, PCSX::g_emulator->m_spu->getAudioTelemetry());
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            auto vars = parseQuery(request.urlData.query);
+            auto ifunction = vars.find("function");
+            if ((ifunction == vars.end()) || (ifunction->second.value_or("") != "reset")) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            PCSX::g_emulator->m_spu->resetAudioTelemetry();
+            client->write("HTTP/1.1 200 OK\r\n\r\n");
+            return true;
+        }
+        return false;
+    }
+
+  public:
+    AudioTelemetryExecutor() = default;
+    virtual ~AudioTelemetryExecutor() = default;
+};
+
+class GPUCountersExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/gpu/counters";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        if (request.method != PCSX::RequestData::Method::HTTP_HTTP_GET) return false;
+        auto& counters = PCSX::g_emulator->m_gpu->lastFrameCounters();
+        nlohmann::json j;
+        for (unsigned i = 0; i < PCSX::GPU::c_counters; i++) {
+            j[std::string(PCSX::GPU::counterName(static_cast<PCSX::GPU::Counter>(i)))] = counters[i];
+        }
+        write200(client, j);
+        return true;
+    }
+
+  public:
+    GPUCountersExecutor() = default;
+    virtual ~GPUCountersExecutor() = default;
+};
+
 }  // namespace
 
+void PCSX::WebExecutor::writeChunk(PCSX::WebClient* client, std::string&& data) {
+    SliceChain chunk;
+    chunk.append(fmt::format("{:x}\r\n", data.size()));
+    chunk.append(std::move(data));
+    chunk.append("\r\n");
+    client->write(std::move(chunk));
+}
+
 std::multimap<std::string, std::optional<std::string>> PCSX::WebExecutor::parseQuery(std::string_view query) {
     UriQueryListA* queryList;
     int itemCount;
@@ -786,25 +1465,62 @@ std::multimap<std::string, std::optional<std::string>> PCSX::WebExecutor::parseQ
 }
 
 void PCSX::WebExecutor::write200(PCSX::WebClient* client, const nlohmann::json& j) {
-    std::string json = j.dump();
-    std::string message = std::string(
-                              "HTTP/1.1 200 OK\r\n"
-                              "Content-Type: application/json\r\n"
-                              "Content-Length: ") +
-                          std::to_string(json.size()) + std::string("\r\n\r\n") + json;
-    client->write(std::move(message));
+    write200(client, "application/json", Slice(j.dump()));
+}
+
+void PCSX::WebExecutor::write200(PCSX::WebClient* client, std::string_view contentType, Slice&& body) {
+    // Not worth the trouble below a packet's worth
+    static constexpr size_t c_minCompressedSize = 1024;
+    auto encoding = client->acceptedEncoding();
+    if ((encoding != WebClient::Encoding::Identity) && (body.size() >= c_minCompressedSize)) {
+        z_stream zstr = {};
+        // Gzip wants the gzip wrapper, and HTTP's deflate is the zlib one
+        int windowBits = encoding == WebClient::Encoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+        if (deflateInit2(&zstr, Z_BEST_SPEED, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+            std::string compressed;
+            compressed.resize(deflateBound(&zstr, body.size()));
+            zstr.next_in = const_cast<Bytef*>(body.data<Bytef>());
+            zstr.avail_in = body.size();
+            zstr.next_out = reinterpret_cast<Bytef*>(compressed.data());
+            zstr.avail_out = compressed.size();
+            int result = deflate(&zstr, Z_FINISH);
+            compressed.resize(zstr.total_out);
+            deflateEnd(&zstr);
+            if (result == Z_STREAM_END) {
+                SliceChain response;
+                response.append(fmt::format(
+                    "HTTP/1.1 200 OK\r\nContent-Type: {}\r\nContent-Encoding: {}\r\nVary: Accept-Encoding\r\n"
+                    "Content-Length: {}\r\n\r\n",
+                    contentType, encoding == WebClient::Encoding::Gzip ? "gzip" : "deflate", compressed.size()));
+                response.append(std::move(compressed));
+                client->write(std::move(response));
+                return;
+            }
+        }
+    }
+    SliceChain response;
+    response.append(fmt::format("HTTP/1.1 200 OK\r\nContent-Type: {}\r\nContent-Length: {}\r\n\r\n", contentType,
+                                body.size()));
+    response.append(std::move(body));
+    client->write(std::move(response));
 }
 
 PCSX::WebServer::WebServer() : m_listener(g_system->m_eventBus) {
     m_executors.push_back(new VramExecutor());
     m_executors.push_back(new RamExecutor());
     m_executors.push_back(new AssemblyExecutor());
+    m_executors.push_back(new SymbolsExportExecutor());
     m_executors.push_back(new CacheExecutor());
     m_executors.push_back(new FlowExecutor());
     m_executors.push_back(new LuaExecutor());
+    m_executors.push_back(new LuaJobsExecutor());
     m_executors.push_back(new CDExecutor());
     m_executors.push_back(new StateExecutor());
     m_executors.push_back(new ScreenExecutor());
+    m_executors.push_back(new VramStreamExecutor());
+    m_executors.push_back(new MemoryBatchExecutor());
+    m_executors.push_back(new AudioTelemetryExecutor());
+    m_executors.push_back(new GPUCountersExecutor());
     m_listener.listen<Events::SettingsLoaded>([this](const auto& event) {
         auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
         if (debugSettings.get<Emulator::DebugSettings::WebServer>() && (m_serverStatus != SERVER_STARTED)) {
@@ -820,35 +1536,27 @@ void PCSX::WebServer::stopServer() {
     assert(m_serverStatus == SERVER_STARTED);
     m_serverStatus = SERVER_STOPPING;
     for (auto& client : m_clients) client.close();
-    uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
+    reapClients();
+    m_fifoListener.stop();
 }
 
 void PCSX::WebServer::startServer(uv_loop_t* loop, int port) {
     assert(m_serverStatus == SERVER_STOPPED);
-    m_loop = loop;
-    uv_tcp_init(loop, &m_server);
-    m_server.data = this;
-
-    struct sockaddr_in bindAddr;
-    int result = uv_ip4_addr("0.0.0.0", port, &bindAddr);
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
-    result = uv_tcp_bind(&m_server, reinterpret_cast<const sockaddr*>(&bindAddr), 0);
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
-    result = uv_listen((uv_stream_t*)&m_server, 16, [](uv_stream_t* handle, int status) {
-        WebServer* self = static_cast<WebServer*>(handle->data);
-        self->onNewConnection(status);
-    });
-    if (result != 0) {
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_server), closeCB);
-        return;
-    }
     m_serverStatus = SERVER_STARTED;
+    uv_check_init(loop, &m_poll);
+    m_poll.data = this;
+    uv_check_start(&m_poll, [](uv_check_t* handle) { static_cast<WebServer*>(handle->data)->poll(); });
+    // Polling alone isn't a reason for the loop to keep on running.
+    uv_unref(reinterpret_cast<uv_handle_t*>(&m_poll));
+    m_fifoListener.start(port, loop, &m_async, [this](UvFifo* fifo) {
+        if (fifo) {
+            onNewConnection(fifo);
+        } else {
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_poll), nullptr);
+            m_async.data = this;
+            uv_close(reinterpret_cast<uv_handle_t*>(&m_async), closeCB);
+        }
+    });
 }
 
 void PCSX::WebServer::closeCB(uv_handle_t* handle) {
@@ -857,34 +1565,8 @@ void PCSX::WebServer::closeCB(uv_handle_t* handle) {
 }
 
 struct PCSX::WebClient::WebClientImpl {
-    struct WriteRequest : public Intrusive::HashTable<uintptr_t, WriteRequest>::Node {
-        WriteRequest() {}
-        WriteRequest(Slice&& slice) : m_slice(std::move(slice)) {}
-        void enqueue(WebClientImpl* client) {
-            if (client->m_closeScheduled) {
-                delete this;
-                return;
-            }
-            m_buf.base = static_cast<char*>(const_cast<void*>(m_slice.data()));
-            m_buf.len = m_slice.size();
-            client->m_requests.insert(reinterpret_cast<uintptr_t>(&m_req), this);
-            uv_write(&m_req, reinterpret_cast<uv_stream_t*>(&client->m_tcp), &m_buf, 1, writeCB);
-        }
-        static void writeCB(uv_write_t* request, int status) {
-            WebClientImpl* client = static_cast<WebClientImpl*>(request->handle->data);
-            auto self = client->m_requests.find(reinterpret_cast<uintptr_t>(request));
-            delete &*self;
-            if ((status != 0) || (client->m_closeScheduled && (client->m_requests.size() == 0))) client->close();
-        }
-        uv_buf_t m_buf;
-        uv_write_t m_req;
-        Slice m_slice;
-    };
-    Intrusive::HashTable<uintptr_t, WriteRequest> m_requests;
-
-    WebClientImpl(WebServer* server, WebClient* parent) : m_server(server), m_parent(parent) {
-        uv_tcp_init(server->m_loop, &m_tcp);
-        m_tcp.data = this;
+    WebClientImpl(WebServer* server, WebClient* parent, UvFifo* fifo)
+        : m_server(server), m_parent(parent), m_fifo(fifo) {
         llhttp_settings_init(&m_httpParserSettings);
         m_httpParserSettings.on_message_begin = [](auto* parser) {
             return static_cast<WebClientImpl*>(parser->data)->onMessageBegin();
@@ -929,30 +1611,32 @@ struct PCSX::WebClient::WebClientImpl {
         llhttp_init(&m_httpParser, HTTP_REQUEST, &m_httpParserSettings);
         m_httpParser.data = this;
     }
+    // The client goes away at the server's next poll; until then, whatever still gets written to it is dropped.
     void close() {
         if (m_status != OPEN) return;
-        m_status = CLOSING;
-        uv_close(reinterpret_cast<uv_handle_t*>(&m_tcp), closeCB);
-    }
-    bool accept(uv_tcp_t* srv) {
-        assert(m_status == CLOSED);
-        if (uv_accept(reinterpret_cast<uv_stream_t*>(srv), reinterpret_cast<uv_stream_t*>(&m_tcp)) == 0) {
-            uv_read_start(
-                reinterpret_cast<uv_stream_t*>(&m_tcp),
-                [](uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
-                    WebClientImpl* client = static_cast<WebClientImpl*>(handle->data);
-                    client->alloc(suggestedSize, buf);
-                },
-                [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
-                    WebClientImpl* client = static_cast<WebClientImpl*>(stream->data);
-                    client->read(nread, buf);
-                });
-            m_status = OPEN;
+        m_status = CLOSED;
+        m_fifo->close();
+    }
+    void poll() {
+        while ((m_status == OPEN) && (m_fifo->size() != 0)) {
+            auto nread = m_fifo->read(m_buffer, sizeof(m_buffer));
+            if (nread <= 0) break;
+            // Whatever comes after a request which ends the connection, or opens a stream, is ignored
+            if (m_streaming || m_closeScheduled) continue;
+            Slice slice;
+            slice.borrow(m_buffer, nread);
+            processData(slice);
         }
-        return m_status == OPEN;
+        if (m_status != OPEN) return;
+        if (m_fifo->eof() && !m_closeScheduled) onEOF();
+        if (m_closeScheduled && (m_fifo->pendingWrites() == 0)) close();
     }
 
     void onEOF() {
+        if (m_streaming || m_closeScheduled) {
+            scheduleClose();
+            return;
+        }
         auto error = llhttp_finish(&m_httpParser);
         if (error == HPE_PAUSED_UPGRADE) {
             onUpgrade();
@@ -964,7 +1648,19 @@ struct PCSX::WebClient::WebClientImpl {
     }
 
     void onUpgrade() {}
-    int onMessageBegin() { return 0; }
+    // The connection is kept alive between requests, so everything about the previous one needs to go
+    int onMessageBegin() {
+        m_requestData = RequestData();
+        m_currentHeader.clear();
+        m_currentValue.clear();
+        m_currentFormHeader.clear();
+        m_currentFormValue.clear();
+        m_headerState = PARSING_HEADER;
+        m_formHeaderState = PARSING_HEADER;
+        m_multipart = false;
+        m_encoding = Encoding::Identity;
+        return 0;
+    }
     int onUrl(const Slice& slice) {
         UriUriA uri;
         std::string urlString = slice.asString();
@@ -1027,8 +1723,31 @@ struct PCSX::WebClient::WebClientImpl {
         m_currentFormValue += slice.asString();
         return 0;
     }
+    void parseAcceptEncoding(std::string_view value) {
+        for (auto coding : StringsHelpers::split(value, ",")) {
+            auto params = StringsHelpers::split(coding, ";");
+            if (params.empty()) continue;
+            auto name = StringsHelpers::trim(params[0]);
+            bool refused = false;
+            for (unsigned i = 1; i < params.size(); i++) {
+                auto param = StringsHelpers::trim(params[i]);
+                if (param.starts_with("q=") && (std::strtod(std::string(param.substr(2)).c_str(), nullptr) <= 0.0)) {
+                    refused = true;
+                }
+            }
+            if (refused) continue;
+            if (StringsHelpers::strcasecmp(name, "gzip")) {
+                m_encoding = Encoding::Gzip;
+            } else if (StringsHelpers::strcasecmp(name, "deflate") && (m_encoding == Encoding::Identity)) {
+                m_encoding = Encoding::Deflate;
+            }
+        }
+    }
     int onHeadersComplete() {
         headerComplete();
+        for (auto& [name, value] : m_requestData.headers) {
+            if (StringsHelpers::strcasecmp(name, "Accept-Encoding")) parseAcceptEncoding(value);
+        }
         auto& ct = m_requestData.headers;
         auto it = ct.find("Content-Type");
         if (it != ct.end()) {
@@ -1094,37 +1813,16 @@ struct PCSX::WebClient::WebClientImpl {
         if (m_multipart) {
             multipart_parser_free(m_multipartParser);
         }
-        executeRequest();
-        return 0;
+        return executeRequest();
     }
     int onChunkHeader() { return 0; }
     int onChunkComplete() { return 0; }
-    void alloc(size_t suggestedSize, uv_buf_t* buf) {
-        assert(!m_allocated);
-        m_allocated = true;
-        buf->base = m_buffer;
-        buf->len = sizeof(m_buffer);
-    }
-    void read(ssize_t nread, const uv_buf_t* buf) {
-        m_allocated = false;
-        if (nread <= 0) {
-            onEOF();
-            return;
-        }
-        Slice slice;
-        slice.borrow(m_buffer, nread);
-        processData(slice);
-    }
-    static void closeCB(uv_handle_t* handle) {
-        WebClientImpl* client = static_cast<WebClientImpl*>(handle->data);
-        delete client->m_parent;
-    }
     void processData(const Slice& slice) {
         const char* ptr = reinterpret_cast<const char*>(slice.data());
         auto size = slice.size();
 
         auto error = llhttp_execute(&m_httpParser, ptr, size);
-        if (m_status != OPEN) return;
+        if ((m_status != OPEN) || (error == HPE_PAUSED)) return;
         if (error == HPE_PAUSED_UPGRADE) {
             onUpgrade();
         } else if (error != HPE_OK) {
@@ -1140,9 +1838,36 @@ struct PCSX::WebClient::WebClientImpl {
         write(std::move(slice));
     }
 
-    void write(Slice&& slice) {
-        auto* req = new WriteRequest(std::move(slice));
-        req->enqueue(this);
+    void write(Slice&& slice) { write(SliceChain(std::move(slice))); }
+
+    void write(SliceChain&& chain) {
+        if (m_inspectingResponse) {
+            for (auto& slice : chain) {
+                if (m_inspectingResponse) inspectResponse(slice);
+            }
+        }
+        if (m_closeScheduled || (m_status != OPEN)) return;
+        m_fifo->write(std::move(chain));
+    }
+
+    // The connection can only carry on with the next request if the client can tell where this response ends,
+    // which it can't when the executor didn't say how long it is, so look for that in the response's headers.
+    void inspectResponse(const Slice& slice) {
+        static constexpr size_t c_maxHeadSize = 4096;
+        m_responseHead.append(slice.data<char>(), std::min<size_t>(slice.size(), c_maxHeadSize));
+        auto end = m_responseHead.find("\r\n\r\n");
+        if ((end == std::string::npos) && (m_responseHead.size() < c_maxHeadSize)) return;
+        m_inspectingResponse = false;
+        auto lines = StringsHelpers::split(std::string_view(m_responseHead).substr(0, end), "\r\n");
+        for (auto line : lines) {
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            auto name = StringsHelpers::trim(line.substr(0, colon));
+            auto value = StringsHelpers::trim(line.substr(colon + 1));
+            bool chunked = StringsHelpers::strcasecmp(name, "Transfer-Encoding") &&
+                           StringsHelpers::strcasecmp(value, "chunked");
+            if (StringsHelpers::strcasecmp(name, "Content-Length") || chunked) m_responseFramed = true;
+        }
     }
 
     void write(std::string&& str) {
@@ -1175,14 +1900,23 @@ struct PCSX::WebClient::WebClientImpl {
         send404();
         return false;
     }
+    // Requests which are pipelined behind this one get parsed and executed once it's done, and their responses
+    // go out in order, since the socket writes are queued in order.
     int executeRequest() {
+        ZoneScoped;
         m_requestData.method = static_cast<RequestData::Method>(m_httpParser.method);
+        m_responseHead.clear();
+        m_responseFramed = false;
+        m_inspectingResponse = true;
         m_currentExecutor->execute(m_parent, m_requestData);
+        m_inspectingResponse = false;
+        if (m_streaming) return HPE_PAUSED;
+        if (llhttp_should_keep_alive(&m_httpParser) && m_responseFramed) return HPE_OK;
         scheduleClose();
-        return 0;
+        return HPE_PAUSED;
     }
     void scheduleClose() {
-        if (m_requests.size() == 0) {
+        if (m_fifo->pendingWrites() == 0) {
             close();
         } else {
             m_closeScheduled = true;
@@ -1190,11 +1924,10 @@ struct PCSX::WebClient::WebClientImpl {
     }
 
     WebServer* m_server;
-    uv_tcp_t m_tcp;
-    static constexpr size_t BUFFER_SIZE = 256;
+    IO<UvFifo> m_fifo;
+    static constexpr size_t BUFFER_SIZE = 4096;
     char m_buffer[BUFFER_SIZE];
-    bool m_allocated = false;
-    enum { CLOSED, OPEN, CLOSING } m_status = CLOSED;
+    enum { OPEN, CLOSED } m_status = OPEN;
     llhttp_settings_t m_httpParserSettings;
     llhttp_t m_httpParser;
     Intrusive::List<WebExecutor>::iterator m_currentExecutor;
@@ -1217,21 +1950,56 @@ struct PCSX::WebClient::WebClientImpl {
     multipart_parser_settings m_multipartParserCallbacks;
 
     bool m_closeScheduled = false;
+    bool m_streaming = false;
+    std::function<void()> m_onClosed;
+
+    Encoding m_encoding = Encoding::Identity;
+    bool m_inspectingResponse = false;
+    bool m_responseFramed = false;
+    std::string m_responseHead;
 };
 
-PCSX::WebClient::WebClient(WebServer* server) : m_impl(std::make_unique<WebClientImpl>(server, this)) {}
+PCSX::WebClient::WebClient(WebServer* server, UvFifo* fifo)
+    : m_impl(std::make_unique<WebClientImpl>(server, this, fifo)) {}
 void PCSX::WebClient::close() { m_impl->close(); }
-bool PCSX::WebClient::accept(uv_tcp_t* srv) { return m_impl->accept(srv); }
 void PCSX::WebClient::write(Slice&& slice) { m_impl->write(std::move(slice)); }
+void PCSX::WebClient::write(SliceChain&& chain) { m_impl->write(std::move(chain)); }
 void PCSX::WebClient::write(std::string&& str) { m_impl->write(std::move(str)); }
 void PCSX::WebClient::write(const std::string& str) { m_impl->write(str); }
+void PCSX::WebClient::startStreaming(std::function<void()>&& onClosed) {
+    m_impl->m_streaming = true;
+    m_impl->m_onClosed = std::move(onClosed);
+}
+void PCSX::WebClient::endStreaming() {
+    m_impl->m_streaming = false;
+    m_impl->scheduleClose();
+}
+size_t PCSX::WebClient::pendingBytes() const { return m_impl->m_fifo->pendingWrites(); }
+PCSX::WebClient::Encoding PCSX::WebClient::acceptedEncoding() const { return m_impl->m_encoding; }
+
+void PCSX::WebServer::onNewConnection(UvFifo* fifo) {
+    if (m_serverStatus != SERVER_STARTED) {
+        IO<UvFifo> closing(fifo);
+        return;
+    }
+    m_clients.push_back(new WebClient(this, fifo));
+}
+
+void PCSX::WebServer::poll() {
+    for (auto& client : m_clients) client.m_impl->poll();
+    for (auto& executor : m_executors) executor.poll();
+    reapClients();
+}
 
-void PCSX::WebServer::onNewConnection(int status) {
-    if (status < 0) return;
-    WebClient* client = new WebClient(this);
-    if (client->accept(&m_server)) {
-        m_clients.push_back(client);
-    } else {
-        delete client;
+void PCSX::WebServer::reapClients() {
+    for (auto client = m_clients.begin(); client != m_clients.end();) {
+        if (client->m_impl->m_status == WebClient::WebClientImpl::OPEN) {
+            client++;
+            continue;
+        }
+        WebClient* closed = &*client;
+        client = m_clients.erase(client);
+        if (closed->m_impl->m_onClosed) closed->m_impl->m_onClosed();
+        delete closed;
     }
 }
@@ -21,6 +21,7 @@
 
 #include <uv.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -31,6 +32,7 @@
 #include "support/eventbus.h"
 #include "support/list.h"
 #include "support/slice.h"
+#include "support/uvfile.h"
 
 namespace PCSX {
 
@@ -94,17 +96,28 @@ class WebExecutor : public Intrusive::List<WebExecutor>::Node {
   public:
     virtual bool match(WebClient* client, const UrlData&) = 0;
     virtual bool execute(WebClient* client, RequestData&) = 0;
+    // Called at each of the server's polls, for the executors which have work of their own to get on with.
+    virtual void poll() {}
     std::multimap<std::string, std::optional<std::string>> parseQuery(std::string_view);
     void write200(WebClient* client, const nlohmann::json& j);
+    // Sends the body as it is, or compressed if the client accepts it. Borrowed slices go out without a copy, so
+    // whatever they point to needs to stay around until the write completes.
+    void write200(WebClient* client, std::string_view contentType, Slice&& body);
+    // Sends this as the next chunk of a response with "Transfer-Encoding: chunked"
+    void writeChunk(WebClient* client, std::string&& data);
 };
 
+// The socket itself lives on the uv thread, with everything else happening when the server polls its clients, so
+// executors can look at the emulator, and writing never waits on the network.
 class WebClient : public Intrusive::List<WebClient>::Node {
   public:
-    WebClient(WebServer* server);
+    enum class Encoding { Identity, Gzip, Deflate };
+    WebClient(WebServer* server, UvFifo* fifo);
     typedef Intrusive::List<WebClient> ListType;
     void close();
-    bool accept(uv_tcp_t* srv);
     void write(Slice&& slice);
+    // Writes all of the slices at once, without gathering them first.
+    void write(SliceChain&& chain);
     template <size_t L>
     void write(const char (&str)[L]) {
         static_assert((L - 1) <= std::numeric_limits<uint32_t>::max());
@@ -114,6 +127,16 @@ class WebClient : public Intrusive::List<WebClient>::Node {
     }
     void write(std::string&& str);
     void write(const std::string& str);
+    // Keeps the connection open once the executor returns, for executors which push data over time, such as
+    // the streaming endpoints. The callback runs when the connection closes, right before the client goes away.
+    void startStreaming(std::function<void()>&& onClosed);
+    // Goes back to closing the connection once everything written got sent.
+    void endStreaming();
+    // How many bytes were written which didn't make it onto the socket yet; streams look at this to drop
+    // what they were about to send to a viewer which can't keep up, rather than piling it up in memory.
+    size_t pendingBytes() const;
+    // The best content encoding the current request said it accepts
+    Encoding acceptedEncoding() const;
 
   private:
     struct WebClientImpl;
@@ -132,15 +155,20 @@ class WebServer {
     };
     WebServerStatus getServerStatus() { return m_serverStatus; }
 
+    // The connections are accepted and served on the uv thread; the loop is where the clients get polled, at each
+    // of its iterations, which means at the same safe points as everything else running on it.
     void startServer(uv_loop_t* loop, int port = 8080);
     void stopServer();
 
   private:
-    void onNewConnection(int status);
+    void onNewConnection(UvFifo* fifo);
+    void poll();
+    void reapClients();
     static void closeCB(uv_handle_t* handle);
     WebServerStatus m_serverStatus = SERVER_STOPPED;
-    uv_tcp_t m_server;
-    uv_loop_t* m_loop;
+    UvFifoListener m_fifoListener;
+    uv_async_t m_async;
+    uv_check_t m_poll;
     WebClient::ListType m_clients;
     EventBus::Listener m_listener;
     Intrusive::List<WebExecutor> m_executors;
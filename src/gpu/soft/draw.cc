@@ -30,18 +30,8 @@ void PCSX::SoftGPU::impl::doBufferSwap(bool fromGui) {
         return;
     }
     gui->setViewport();
-    GLuint textureID;
-
-    if (m_softDisplay.RGB24) {
-        auto offset = (m_softDisplay.DisplayPosition.x * 2) % 3;
-        textureID = m_vramTexture24;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 682, 512, GL_RGB, GL_UNSIGNED_BYTE, m_vram + offset);
-    } else {
-        textureID = m_vramTexture16;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, m_vram16);
-    }
+    uploadDirtyTextures(m_softDisplay.RGB24);
+    GLuint textureID = m_softDisplay.RGB24 ? m_vramTexture24 : m_vramTexture16;
 
     float xRatio = m_softDisplay.RGB24 ? ((1.0f / 1.5f) * (1.0f / 1024.0f)) : (1.0f / 1024.0f);
 
@@ -61,11 +51,59 @@ void PCSX::SoftGPU::impl::doBufferSwap(bool fromGui) {
     if (!fromGui) gui->flip();
 }
 
+// Only sends what changed since the last upload. The 16 bits texture is always kept up to date, as it is
+// what the VRAM viewers and the GPU logger look at, even when the display is in 24 bits mode.
+void PCSX::SoftGPU::impl::uploadDirtyTextures(bool rgb24) {
+    GLint oldAlignment, oldRowLength;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &oldRowLength);
+    // 682 pixels of 3 bytes are 2046 bytes, which an alignment of 4 turns into the 2048 bytes of a VRAM line
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (!m_textureDirty16.empty()) {
+        const auto &r = m_textureDirty16;
+        glBindTexture(GL_TEXTURE_2D, m_vramTexture16);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 1024);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0, GL_RGBA,
+                        GL_UNSIGNED_SHORT_1_5_5_5_REV, m_vram16 + r.y0 * 1024 + r.x0);
+        m_textureDirty16.clear();
+    }
+
+    if (rgb24) {
+        const int offset = (m_softDisplay.DisplayPosition.x * 2) % 3;
+        if (offset != m_texture24Offset) {
+            m_textureDirty24.markAll();
+            m_texture24Offset = offset;
+        }
+        if (!m_textureDirty24.empty()) {
+            const auto &r = m_textureDirty24;
+            // Converts the bytes covered by the 16 bits area into whole 24 bits pixels
+            const int x0 = std::max(0, (r.x0 * 2 - offset) / 3);
+            const int x1 = std::min(682, (r.x1 * 2 - offset + 2) / 3);
+            if (x1 > x0) {
+                glBindTexture(GL_TEXTURE_2D, m_vramTexture24);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, 682);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, x0, r.y0, x1 - x0, r.y1 - r.y0, GL_RGB, GL_UNSIGNED_BYTE,
+                                m_vram + offset + r.y0 * 2048 + x0 * 3);
+            }
+            m_textureDirty24.clear();
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, oldRowLength);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
+}
+
 void PCSX::SoftGPU::impl::clearVRAM() {
     GUI *gui = dynamic_cast<GUI *>(m_ui);
     if (!gui) return;
     const auto oldTex = OpenGL::getTex2D();
+    syncCommands();
+    m_tiles.sync();
     std::memset(m_allocatedVRAM, 0x00, (GPU_HEIGHT * 2) * 1024 + (1024 * 1024));
+    getDirtyVRAM().markAll();
+    m_textureDirty16.markAll();
+    m_textureDirty24.markAll();
 
     glBindTexture(GL_TEXTURE_2D, m_vramTexture16);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1024, 512, GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, m_allocatedVRAM);
@@ -44,7 +44,14 @@ int32_t PCSX::SoftGPU::impl::initBackend(UI *ui) {
     initDisplay();
 
     // always alloc one extra MB for soft drawing funcs security
-    m_allocatedVRAM = new uint8_t[(GPU_HEIGHT * 2) * 1024 + (1024 * 1024)]();
+    if (m_vramMemory.getPtr() == nullptr) {
+        const bool largePages = g_emulator->settings.get<Emulator::SettingLargePages>();
+        m_vramMemory.init(nullptr, (GPU_HEIGHT * 2) * 1024 + (1024 * 1024), true, largePages);
+        if (largePages) g_system->printf(_("VRAM is using %s\n"), SharedMem::describe(m_vramMemory.pages()));
+    } else {
+        std::memset(m_vramMemory.getPtr(), 0, m_vramMemory.getSize());
+    }
+    m_allocatedVRAM = m_vramMemory.getPtr();
     if (!m_allocatedVRAM) return -1;
 
     //!!! ATTENTION !!!
@@ -72,15 +79,30 @@ int32_t PCSX::SoftGPU::impl::initBackend(UI *ui) {
     m_statusRet |= GPUSTATUS_IDLE;
     m_statusRet |= GPUSTATUS_READYFORCOMMANDS;
 
+    if (!m_renderer) return 0;
+    m_tiles.start(g_emulator->settings.get<Emulator::SettingSoftGPUThreads>());
+    if (g_emulator->settings.get<Emulator::SettingThreadedGPU>()) startCommandThread();
+
     return 0;
 }
 
 int32_t PCSX::SoftGPU::impl::shutdown() {
-    delete[] m_allocatedVRAM;
+    stopCommandThread();
+    m_tiles.stop();
+    disableCachedDithering();
     return 0;
 }
 
+void PCSX::SoftGPU::impl::afterFork() {
+    if (!m_renderer) return;
+    m_tiles.start(g_emulator->settings.get<Emulator::SettingSoftGPUThreads>());
+    if (g_emulator->settings.get<Emulator::SettingThreadedGPU>()) startCommandThread();
+}
+
 std::unique_ptr<PCSX::GPU> PCSX::GPU::getSoft() { return std::unique_ptr<PCSX::GPU>(new PCSX::SoftGPU::impl()); }
+std::unique_ptr<PCSX::GPU> PCSX::GPU::getNull() {
+    return std::unique_ptr<PCSX::GPU>(new PCSX::SoftGPU::impl(false));
+}
 
 void PCSX::SoftGPU::impl::updateDisplay(bool fromGui) {
     if (m_softDisplay.Disabled) {
@@ -210,7 +232,13 @@ void PCSX::SoftGPU::impl::updateDisplayIfChanged() {
 }
 
 void PCSX::SoftGPU::impl::vblank(bool fromGui) {
+    ZoneScoped;
+    syncCommands();
+    m_tiles.sync();
     m_statusRet ^= 0x80000000;  // odd/even bit
+    if (!m_renderer) return;
+    // Whatever got drawn this frame is missing most of it
+    if (m_skipFrame) m_doVSyncUpdate = false;
 
     if (m_softDisplay.Interlaced) {
         // interlaced mode?
@@ -224,6 +252,7 @@ void PCSX::SoftGPU::impl::vblank(bool fromGui) {
     }
 
     m_doVSyncUpdate = false;  // vsync done
+    m_skipFrame = m_frameSkip && ((++m_frameSkipCounter % (m_frameSkip + 1)) != 0);
 }
 
 uint32_t PCSX::SoftGPU::impl::readStatusInternal() { return m_statusRet; }
@@ -238,6 +267,8 @@ bool PCSX::SoftGPU::impl::configure() {
                                   _("Always dither g-shaded polygons (slowest)")};
 
     if (ImGui::Begin(_("Soft GPU configuration"), &m_showCfg)) {
+        // The widgets below poke at the renderer state directly.
+        syncCommands();
         if (ImGui::Combo(_("Dithering"), &m_useDither, ditherValues, 3)) {
             changed = true;
             g_emulator->settings.get<Emulator::SettingDither>() = m_useDither;
@@ -249,8 +280,7 @@ bool PCSX::SoftGPU::impl::configure() {
             setCachedDithering(g_emulator->settings.get<Emulator::SettingCachedDithering>());
         }
         ImGuiHelpers::ShowHelpMarker(
-            _("Dithering tables are cached in memory for faster processing. Dithering will be done much faster, at the "
-              "cost of a 512MB cache."));
+            _("Dithering goes through a small precomputed table, instead of being computed for each pixel."));
 
         if (ImGui::Checkbox(_("Use linear filtering"),
                             &g_emulator->settings.get<Emulator::SettingLinearFiltering>().value)) {
@@ -258,6 +288,29 @@ bool PCSX::SoftGPU::impl::configure() {
             setLinearFiltering();
         }
 
+        auto &threads = g_emulator->settings.get<Emulator::SettingSoftGPUThreads>().value;
+        if (ImGui::SliderInt(_("Rasterizer threads"), &threads, 0, TiledRasterizer::c_maxThreads)) {
+            changed = true;
+            m_tiles.start(threads);
+        }
+        ImGuiHelpers::ShowHelpMarker(
+            _("Spreads the drawing over multiple threads, each one owning horizontal bands of the VRAM. 0 draws "
+              "everything on the emulation thread."));
+
+        auto &threadedGPU = g_emulator->settings.get<Emulator::SettingThreadedGPU>().value;
+        if (ImGui::Checkbox(_("Threaded command processing"), &threadedGPU)) {
+            changed = true;
+            if (threadedGPU) {
+                startCommandThread();
+            } else {
+                stopCommandThread();
+            }
+        }
+        ImGuiHelpers::ShowHelpMarker(
+            _("Decodes and runs the GPU commands on a thread of their own, letting the emulation thread carry on "
+              "until it needs to read something back from the GPU. Commands are processed on the emulation thread "
+              "while the GPU logger is enabled."));
+
         ImGui::Checkbox(_("Disable textures for polygons"), &m_disableTexturesInPolygons);
         ImGui::Checkbox(_("Disable textures for sprites"), &m_disableTexturesInRectangles);
 
@@ -286,6 +339,7 @@ static constexpr inline uint16_t BGR24to16(PCSX::GPU::EmptyColor) { return 0; }
 void PCSX::SoftGPU::impl::write0(ClearCache *) {}
 
 void PCSX::SoftGPU::impl::write0(FastFill *prim) {
+    ZoneScoped;
     int16_t sX = prim->x;
     int16_t sY = prim->y;
     int16_t sW = prim->w;
@@ -301,14 +355,65 @@ void PCSX::SoftGPU::impl::write0(FastFill *prim) {
     sW += sX;
     sH += sY;
 
-    fillSoftwareArea(sX, sY, sW, sH, BGR24to16(prim->color));
-
+    const uint16_t color = BGR24to16(prim->color);
+    markTextureDirty(sX, sY, sW - sX, sH - sY);
     m_doVSyncUpdate = true;
+
+    const TiledRasterizer::Bounds bounds{sX, sY, sW - 1, sH - 1};
+    if (queueTransfer<&SoftRenderer::fillSoftwareAreaRows>(bounds, nullptr, sX, sY, sW, sH, color)) return;
+    m_tiles.sync();
+    fillSoftwareArea(sX, sY, sW, sH, color);
+}
+
+PCSX::SoftGPU::TiledRasterizer::Bounds PCSX::SoftGPU::impl::vertexBounds(unsigned count) const {
+    const int16_t xs[] = {m_x0, m_x1, m_x2, m_x3};
+    const int16_t ys[] = {m_y0, m_y1, m_y2, m_y3};
+    TiledRasterizer::Bounds ret{xs[0], ys[0], xs[0], ys[0]};
+    for (unsigned i = 1; i < count; i++) {
+        ret.x0 = std::min<int>(ret.x0, xs[i]);
+        ret.y0 = std::min<int>(ret.y0, ys[i]);
+        ret.x1 = std::max<int>(ret.x1, xs[i]);
+        ret.y1 = std::max<int>(ret.y1, ys[i]);
+    }
+    return ret;
+}
+
+// The whole texture page, and the CLUT row if there's one, as the texture window can move things around.
+PCSX::SoftGPU::TiledRasterizer::Bounds PCSX::SoftGPU::impl::textureBounds(int16_t clX, int16_t clY) const {
+    int width = 256;
+    int clutWidth = 0;
+    switch (m_globalTextTP) {
+        case GPU::TexDepth::Tex4Bits:
+            width = 64;
+            clutWidth = 16;
+            break;
+        case GPU::TexDepth::Tex8Bits:
+            width = 128;
+            clutWidth = 256;
+            break;
+        case GPU::TexDepth::Tex16Bits:
+            break;
+    }
+    TiledRasterizer::Bounds ret{m_globalTextAddrX, m_globalTextAddrY, m_globalTextAddrX + width - 1,
+                                m_globalTextAddrY + 255};
+    if (clutWidth) {
+        ret.x0 = std::min<int>(ret.x0, clX);
+        ret.y0 = std::min<int>(ret.y0, clY);
+        ret.x1 = std::max<int>(ret.x1, clX + clutWidth - 1);
+        ret.y1 = std::max<int>(ret.y1, clY);
+    }
+    return ret;
 }
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::Shape shape, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend,
           PCSX::GPU::Modulation modulation>
 void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulation> *prim) {
+    ZoneScoped;
+    if (!m_renderer) {
+        // The texture page still shows up in GPUSTAT
+        if constexpr (textured == Textured::Yes) texturePage(&prim->tpage);
+        return;
+    }
     m_x0 = prim->x[0];
     m_y0 = prim->y[0];
     m_x1 = prim->x[1];
@@ -335,6 +440,8 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
         m_m1 = m_m2 = m_m3 = 128;
     }
 
+    const auto bounds = vertexBounds(shape == Shape::Quad ? 4 : 3);
+
     if constexpr (shading == Shading::Flat) {
         if ((textured == Textured::Yes) && !m_disableTexturesInPolygons) {
             if constexpr (textured == Textured::Yes) {
@@ -343,45 +450,55 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
                     prim->tpage.raw |= 0x200;
                 }
                 texturePage(&prim->tpage);
+                const auto texture = textureBounds(prim->clutX(), prim->clutY());
                 if constexpr (shape == Shape::Quad) {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
-                            drawPoly4TEx4(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                          prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
-                                          prim->clutX(), prim->clutY());
+                            rasterize<&SoftRenderer::drawPoly4TEx4>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0],
+                                prim->v[0], prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
+                                prim->clutX(), prim->clutY());
                             break;
                         case GPU::TexDepth::Tex8Bits:
-                            drawPoly4TEx8(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                          prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
-                                          prim->clutX(), prim->clutY());
+                            rasterize<&SoftRenderer::drawPoly4TEx8>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0],
+                                prim->v[0], prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
+                                prim->clutX(), prim->clutY());
                             break;
                         case GPU::TexDepth::Tex16Bits:
-                            drawPoly4TD(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                        prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2]);
+                            rasterize<&SoftRenderer::drawPoly4TD>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3,
+                                                                  m_y3, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
+                                                                  prim->v[1], prim->u[3], prim->v[3], prim->u[2],
+                                                                  prim->v[2]);
                             break;
                     }
                 } else {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
-                            drawPoly3TEx4(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                          prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY());
+                            rasterize<&SoftRenderer::drawPoly3TEx4>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1,
+                                                                    m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
+                                                                    prim->v[1], prim->u[2], prim->v[2], prim->clutX(),
+                                                                    prim->clutY());
                             break;
                         case GPU::TexDepth::Tex8Bits:
-                            drawPoly3TEx8(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                          prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY());
+                            rasterize<&SoftRenderer::drawPoly3TEx8>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1,
+                                                                    m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
+                                                                    prim->v[1], prim->u[2], prim->v[2], prim->clutX(),
+                                                                    prim->clutY());
                             break;
                         case GPU::TexDepth::Tex16Bits:
-                            drawPoly3TD(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                        prim->v[1], prim->u[2], prim->v[2]);
+                            rasterize<&SoftRenderer::drawPoly3TD>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2,
+                                                                  m_y2, prim->u[0], prim->v[0], prim->u[1], prim->v[1],
+                                                                  prim->u[2], prim->v[2]);
                             break;
                     }
                 }
             }
         } else {
             if constexpr (shape == Shape::Quad) {
-                drawPolyFlat4(prim->colors[0]);
+                rasterize<&SoftRenderer::drawPolyFlat4>(bounds, nullptr, true, prim->colors[0]);
             } else {
-                drawPolyFlat3(prim->colors[0]);
+                rasterize<&SoftRenderer::drawPolyFlat3>(bounds, nullptr, true, prim->colors[0]);
             }
         }
     } else {
@@ -392,51 +509,60 @@ void PCSX::SoftGPU::impl::polyExec(Poly<shading, shape, textured, blend, modulat
                     prim->tpage.raw |= 0x200;
                 }
                 texturePage(&prim->tpage);
+                const auto texture = textureBounds(prim->clutX(), prim->clutY());
                 if constexpr (shape == Shape::Quad) {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
-                            drawPoly4TGEx4(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                           prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
-                                           prim->clutX(), prim->clutY(), prim->colors[0], prim->colors[1],
-                                           prim->colors[2], prim->colors[3]);
+                            rasterize<&SoftRenderer::drawPoly4TGEx4>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0],
+                                prim->v[0], prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
+                                prim->clutX(), prim->clutY(), prim->colors[0], prim->colors[1], prim->colors[2],
+                                prim->colors[3]);
                             break;
                         case GPU::TexDepth::Tex8Bits:
-                            drawPoly4TGEx8(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                           prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
-                                           prim->clutX(), prim->clutY(), prim->colors[0], prim->colors[1],
-                                           prim->colors[2], prim->colors[3]);
+                            rasterize<&SoftRenderer::drawPoly4TGEx8>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0],
+                                prim->v[0], prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
+                                prim->clutX(), prim->clutY(), prim->colors[0], prim->colors[1], prim->colors[2],
+                                prim->colors[3]);
                             break;
                         case GPU::TexDepth::Tex16Bits:
-                            drawPoly4TGD(m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0], prim->v[0],
-                                         prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
-                                         prim->colors[0], prim->colors[1], prim->colors[2], prim->colors[3]);
+                            rasterize<&SoftRenderer::drawPoly4TGD>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, prim->u[0],
+                                prim->v[0], prim->u[1], prim->v[1], prim->u[3], prim->v[3], prim->u[2], prim->v[2],
+                                prim->colors[0], prim->colors[1], prim->colors[2], prim->colors[3]);
                             break;
                     }
                 } else {
                     switch (m_globalTextTP) {
                         case GPU::TexDepth::Tex4Bits:
-                            drawPoly3TGEx4(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                           prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY(),
-                                           prim->colors[0], prim->colors[1], prim->colors[2]);
+                            rasterize<&SoftRenderer::drawPoly3TGEx4>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0],
+                                prim->u[1], prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY(),
+                                prim->colors[0], prim->colors[1], prim->colors[2]);
                             break;
                         case GPU::TexDepth::Tex8Bits:
-                            drawPoly3TGEx8(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                           prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY(),
-                                           prim->colors[0], prim->colors[1], prim->colors[2]);
+                            rasterize<&SoftRenderer::drawPoly3TGEx8>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0],
+                                prim->u[1], prim->v[1], prim->u[2], prim->v[2], prim->clutX(), prim->clutY(),
+                                prim->colors[0], prim->colors[1], prim->colors[2]);
                             break;
                         case GPU::TexDepth::Tex16Bits:
-                            drawPoly3TGD(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0], prim->u[1],
-                                         prim->v[1], prim->u[2], prim->v[2], prim->colors[0], prim->colors[1],
-                                         prim->colors[2]);
+                            rasterize<&SoftRenderer::drawPoly3TGD>(
+                                bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, prim->u[0], prim->v[0],
+                                prim->u[1], prim->v[1], prim->u[2], prim->v[2], prim->colors[0], prim->colors[1],
+                                prim->colors[2]);
                             break;
                     }
                 }
             }
         } else {
             if constexpr (shape == Shape::Quad) {
-                drawPolyShade4(prim->colors[0], prim->colors[1], prim->colors[2], prim->colors[3]);
+                rasterize<&SoftRenderer::drawPolyShade4>(bounds, nullptr, true, prim->colors[0], prim->colors[1],
+                                                         prim->colors[2], prim->colors[3]);
             } else {
-                drawPolyShade3(prim->colors[0], prim->colors[1], prim->colors[2]);
+                rasterize<&SoftRenderer::drawPolyShade3>(bounds, nullptr, true, prim->colors[0], prim->colors[1],
+                                                         prim->colors[2]);
             }
         }
     }
@@ -465,6 +591,8 @@ static constexpr inline bool CheckCoordL(int16_t slx0, int16_t sly0, int16_t slx
 
 template <PCSX::GPU::Shading shading, PCSX::GPU::LineType lineType, PCSX::GPU::Blend blend>
 void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
+    ZoneScoped;
+    if (!m_renderer) return;
     auto count = prim->colors.size();
 
     m_drawSemiTrans = blend == Blend::Semi;
@@ -484,10 +612,11 @@ void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
         m_x1 = x1;
 
         applyOffset2();
+        const auto bounds = vertexBounds(2);
         if constexpr (shading == Shading::Gouraud) {
-            drawSoftwareLineShade(c0, c1);
+            rasterize<&SoftRenderer::drawSoftwareLineShade>(bounds, nullptr, false, c0, c1);
         } else {
-            drawSoftwareLineFlat(c0);
+            rasterize<&SoftRenderer::drawSoftwareLineFlat>(bounds, nullptr, false, c0);
         }
     }
     m_doVSyncUpdate = true;
@@ -495,6 +624,8 @@ void PCSX::SoftGPU::impl::lineExec(Line<shading, lineType, blend> *prim) {
 
 template <PCSX::GPU::Size size, PCSX::GPU::Textured textured, PCSX::GPU::Blend blend, PCSX::GPU::Modulation modulation>
 void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim) {
+    ZoneScoped;
+    if (!m_renderer) return;
     int16_t w, h;
 
     m_x0 = prim->x;
@@ -526,6 +657,8 @@ void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim
     m_y2 = m_y3 = m_y0 + h + m_softDisplay.DrawOffset.y;
     m_y0 = m_y1 = m_y0 + m_softDisplay.DrawOffset.y;
 
+    const auto bounds = vertexBounds(4);
+
     if ((textured == Textured::Yes) && !m_disableTexturesInRectangles) {
         if constexpr (textured == Textured::Yes) {
             int16_t tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3;
@@ -533,30 +666,35 @@ void PCSX::SoftGPU::impl::rectExec(Rect<size, textured, blend, modulation> *prim
             tx1 = tx2 = tx0 + w;
             ty0 = ty1 = prim->v;
             ty2 = ty3 = ty0 + h;
+            const auto texture = textureBounds(prim->clutX(), prim->clutY());
 
             switch (m_globalTextTP) {
                 case GPU::TexDepth::Tex4Bits:
-                    drawPoly4TEx4_S(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3,
-                                    ty3, prim->clutX(), prim->clutY());
+                    rasterize<&SoftRenderer::drawPoly4TEx4_S>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2,
+                                                              m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3,
+                                                              prim->clutX(), prim->clutY());
                     break;
                 case GPU::TexDepth::Tex8Bits:
-                    drawPoly4TEx8_S(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3,
-                                    ty3, prim->clutX(), prim->clutY());
+                    rasterize<&SoftRenderer::drawPoly4TEx8_S>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2,
+                                                              m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3,
+                                                              prim->clutX(), prim->clutY());
                     break;
                 case GPU::TexDepth::Tex16Bits:
-                    drawPoly4TD_S(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3,
-                                  ty3);
+                    rasterize<&SoftRenderer::drawPoly4TD_S>(bounds, &texture, true, m_x0, m_y0, m_x1, m_y1, m_x2,
+                                                            m_y2, m_x3, m_y3, tx0, ty0, tx1, ty1, tx2, ty2, tx3, ty3);
                     break;
             }
         }
     } else {
-        fillSoftwareAreaTrans(m_x0, m_y0, m_x2, m_y2, BGR24to16(prim->color));
+        rasterize<&SoftRenderer::fillSoftwareAreaTrans>(bounds, nullptr, true, m_x0, m_y0, m_x2, m_y2,
+                                                        BGR24to16(prim->color));
     }
 
     m_doVSyncUpdate = true;
 }
 
 void PCSX::SoftGPU::impl::write0(BlitVramVram *prim) {
+    ZoneScoped;
     int16_t imageY0, imageX0, imageY1, imageX1, imageSX, imageSY, i, j;
 
     imageX0 = prim->sX;
@@ -570,6 +708,23 @@ void PCSX::SoftGPU::impl::write0(BlitVramVram *prim) {
     if (imageSX <= 0) return;
     if (imageSY <= 0) return;
 
+    markTextureDirty(imageX1, imageY1, imageSX, imageSY);
+
+    // The tiled rasterizer turns down copies with a source overlapping their destination, which are left to the
+    // code below, as the rows then need to go in order.
+    if (((imageY0 + imageSY) <= GPU_HEIGHT) && ((imageX0 + imageSX) <= 1024) && ((imageY1 + imageSY) <= GPU_HEIGHT) &&
+        ((imageX1 + imageSX) <= 1024)) {
+        const TiledRasterizer::Bounds source{imageX0, imageY0, imageX0 + imageSX - 1, imageY0 + imageSY - 1};
+        const TiledRasterizer::Bounds bounds{imageX1, imageY1, imageX1 + imageSX - 1, imageY1 + imageSY - 1};
+        if (queueTransfer<&SoftRenderer::copySoftwareAreaRows>(bounds, &source, imageX0, imageY0, imageX1, imageY1,
+                                                               imageSX, imageSY)) {
+            m_doVSyncUpdate = true;
+            return;
+        }
+    }
+
+    m_tiles.sync();
+
     if ((imageY0 + imageSY) > GPU_HEIGHT || (imageX0 + imageSX) > 1024 || (imageY1 + imageSY) > GPU_HEIGHT ||
         (imageX1 + imageSX) > 1024) {
         int i, j;
@@ -632,6 +787,8 @@ void PCSX::SoftGPU::impl::write0(DrawingOffset *prim) { drawingOffset(prim); }
 void PCSX::SoftGPU::impl::write0(MaskBit *prim) { maskBit(prim); }
 
 PCSX::GPU::ScreenShot PCSX::SoftGPU::impl::takeScreenShot() {
+    syncCommands();
+    m_tiles.sync();
     ScreenShot ss;
     auto startX = m_softDisplay.DisplayPosition.x;
     auto startY = m_softDisplay.DisplayPosition.y;
@@ -665,6 +822,15 @@ PCSX::GPU::ScreenShot PCSX::SoftGPU::impl::takeScreenShot() {
     return ss;
 }
 
+uint64_t PCSX::SoftGPU::impl::hashDisplay() {
+    syncCommands();
+    m_tiles.sync();
+    if (m_softDisplay.Disabled) return 0;
+    const auto &start = m_softDisplay.DisplayPosition;
+    const auto &end = m_softDisplay.DisplayEnd;
+    return hashVRAMArea(m_vram, start.x, start.y, end.x - start.x, end.y - start.y, m_softDisplay.RGB24);
+}
+
 void PCSX::SoftGPU::impl::write1(CtrlReset *) {
     m_statusRet = 0x14802000;
     m_softDisplay.Disabled = 1;
@@ -19,8 +19,12 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "core/gpu.h"
 #include "gpu/soft/soft.h"
+#include "gpu/soft/tiled.h"
+#include "support/sharedmem.h"
 
 namespace PCSX {
 
@@ -29,14 +33,29 @@ class UI;
 namespace SoftGPU {
 
 class impl final : public GPU, public SoftRenderer {
+  public:
+    // Without a renderer, only what lands in VRAM through transfers and fills is there, and nothing gets
+    // displayed; the rest of the GPU state and timings still follow what the game does.
+    explicit impl(bool renderer = true) : m_renderer(renderer) {}
+
+  private:
     int32_t initBackend(UI *) override;
     int32_t shutdown() override;
+    void prepareFork() override {
+        stopCommandThread();
+        m_tiles.sync();
+        m_tiles.stop();
+    }
+    void afterFork() override;
     uint32_t readStatusInternal() override;
     void vblank(bool fromGui) override;
     bool configure() override;
     void debug() override;
 
-    void setDither(int setting) override { m_useDither = setting; }
+    void setDither(int setting) override {
+        syncCommands();
+        m_useDither = setting;
+    }
     void clearVRAM() override;
     void resetBackend() override {
         clearVRAM();
@@ -45,6 +64,8 @@ class impl final : public GPU, public SoftRenderer {
     GLuint getVRAMTexture() override { return m_vramTexture16; }
     void setLinearFiltering() override;
     void setCachedDithering(bool value) override {
+        syncCommands();
+        m_tiles.sync();
         if (value) {
             enableCachedDithering();
         } else {
@@ -53,6 +74,11 @@ class impl final : public GPU, public SoftRenderer {
     }
 
     void restoreStatus(uint32_t status) override;
+    void setFrameSkip(unsigned frames) override {
+        syncCommands();
+        m_frameSkip = frames;
+        m_skipFrame = false;
+    }
 
     void updateDisplay(bool fromGui);
     void initDisplay();
@@ -63,6 +89,8 @@ class impl final : public GPU, public SoftRenderer {
     void updateDisplayIfChanged();
 
     Slice getVRAM(Ownership ownership) override {
+        syncCommands();
+        m_tiles.sync();
         Slice ret;
         if (ownership == Ownership::BORROW) {
             ret.borrow(m_vram16, 1024 * 512 * 2);
@@ -73,6 +101,10 @@ class impl final : public GPU, public SoftRenderer {
     }
 
     void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels, PartialUpdateVram) override {
+        syncCommands();
+        m_tiles.sync();
+        markVRAMDirty(x, y, w, h);
+        markTextureDirty(x, y, w, h);
         auto ptr = m_vram16;
         ptr += y * 1024 + x;
         for (int i = 0; i < h; i++) {
@@ -83,17 +115,98 @@ class impl final : public GPU, public SoftRenderer {
     }
 
     virtual ScreenShot takeScreenShot() override;
+    virtual uint64_t hashDisplay() override;
+    uint64_t flushCount() override { return m_tiles.flushes(); }
 
     GLuint m_vramTexture16;
     GLuint m_vramTexture24;
 
+    // The part of VRAM which changed since the textures were last uploaded, in 16 bits pixels, with exclusive
+    // ends. Written by the command thread, and read at vblank or from the GUI, once the commands are synced.
+    struct DirtyRect {
+        int x0 = 0, y0 = 0, x1 = 1024, y1 = 512;
+        bool empty() const { return (x0 >= x1) || (y0 >= y1); }
+        void add(int ax0, int ay0, int ax1, int ay1) {
+            x0 = std::min(x0, std::max(ax0, 0));
+            y0 = std::min(y0, std::max(ay0, 0));
+            x1 = std::max(x1, std::min(ax1, 1024));
+            y1 = std::max(y1, std::min(ay1, 512));
+        }
+        void markAll() { *this = DirtyRect(); }
+        void clear() {
+            x0 = 1024;
+            y0 = 512;
+            x1 = y1 = 0;
+        }
+    };
+    DirtyRect m_textureDirty16;
+    DirtyRect m_textureDirty24;
+    int m_texture24Offset = -1;
+    void markTextureDirty(int x, int y, int w, int h) {
+        if ((w <= 0) || (h <= 0)) return;
+        x &= 1023;
+        y &= 511;
+        int x1 = x + w;
+        int y1 = y + h;
+        // Writes wrap around the edges of VRAM, which a single rectangle can't express
+        if (x1 > 1024) {
+            x = 0;
+            x1 = 1024;
+        }
+        if (y1 > 512) {
+            y = 0;
+            y1 = 512;
+        }
+        m_textureDirty16.add(x, y, x1, y1);
+        m_textureDirty24.add(x, y, x1, y1);
+    }
+    void uploadDirtyTextures(bool rgb24);
+
     UI *m_ui;
 
+    const bool m_renderer;
     bool m_doVSyncUpdate = false;
+    unsigned m_frameSkip = 0;
+    unsigned m_frameSkipCounter = 0;
+    // Only changes at vblank, once the command thread is done, so it's stable while the commands run.
+    bool m_skipFrame = false;
     SoftDisplay m_previousDisplay;
+    SharedMem m_vramMemory;
     unsigned char *m_allocatedVRAM;
     static constexpr int16_t s_displayWidths[] = {256, 320, 512, 640, 368, 384};
 
+    TiledRasterizer m_tiles;
+    // Draws in place, or queues the drawing call when the tiled rasterizer is running.
+    template <auto function, typename... Args>
+    void rasterize(TiledRasterizer::Bounds bounds, const TiledRasterizer::Bounds *texture, bool splittable,
+                   Args... args) {
+        // Drawing areas smaller than the screen are more likely to be textures than frame buffers
+        if (m_skipFrame && ((m_drawW - m_drawX + 1) >= m_softDisplay.DisplayMode.x) &&
+            ((m_drawH - m_drawY + 1) >= m_softDisplay.DisplayMode.y)) {
+            return;
+        }
+        // Nothing lands outside of both the primitive and the drawing area
+        markTextureDirty(std::max<int>(bounds.x0, m_drawX), std::max<int>(bounds.y0, m_drawY),
+                         std::min<int>(bounds.x1, m_drawW) - std::max<int>(bounds.x0, m_drawX) + 1,
+                         std::min<int>(bounds.y1, m_drawH) - std::max<int>(bounds.y0, m_drawY) + 1);
+        if (m_tiles.enabled() && m_tiles.submit<function>(*this, bounds, texture, splittable, args...)) return;
+        (this->*function)(args...);
+    }
+    // Fills and copies go around the drawing area, so they get queued with one spanning the whole VRAM, which
+    // the workers then narrow down to their own bands. This takes clearing a frame buffer, or moving a large
+    // area, off of the thread running the commands. When this returns false, the caller needs to do it in place.
+    template <auto function, typename... Args>
+    bool queueTransfer(TiledRasterizer::Bounds bounds, const TiledRasterizer::Bounds *source, Args... args) {
+        if (!m_tiles.enabled()) return false;
+        SoftRenderer state = *this;
+        state.m_drawX = state.m_drawY = 0;
+        state.m_drawW = GPU_WIDTH - 1;
+        state.m_drawH = GPU_HEIGHT - 1;
+        return m_tiles.submit<function>(state, bounds, source, true, args...);
+    }
+    TiledRasterizer::Bounds vertexBounds(unsigned count) const;
+    TiledRasterizer::Bounds textureBounds(int16_t clX, int16_t clY) const;
+
     void write0(ClearCache *) override;
     void write0(FastFill *) override;
 
@@ -20,8 +20,11 @@
 #include "gpu/soft/soft.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 #include "gpu/soft/soft.h"
+#include "gpu/soft/spans.h"
 
 #define XCOL1(x) (x & 0x1f)
 #define XCOL2(x) (x & 0x3e0)
@@ -272,58 +275,23 @@ void PCSX::SoftGPU::SoftRenderer::applyOffset4() {
 
 static constexpr uint8_t s_dithertable[16] = {7, 0, 6, 1, 2, 5, 3, 4, 1, 6, 0, 7, 4, 3, 5, 2};
 
-static uint16_t *s_ditherLUT = nullptr;
-
-static void prepareDitherLut() {
-    uint32_t r, g, b, s;
-    assert(s_ditherLUT == nullptr);
-    s_ditherLUT = new uint16_t[256 * 256 * 256 * 16];
-    uint16_t *ditherLUT = s_ditherLUT;
-    for (r = 0; r < 256; r++) {
-        for (g = 0; g < 256; g++) {
-            for (b = 0; b < 256; b++) {
-                for (s = 0; s < 16; s++) {
-                    uint8_t coeff;
-                    uint8_t rlow, glow, blow;
-                    uint8_t rc, gc, bc;
-                    rc = r;
-                    gc = g;
-                    bc = b;
-
-                    coeff = s_dithertable[s];
-
-                    rlow = rc & 7;
-                    glow = gc & 7;
-                    blow = bc & 7;
-
-                    rc >>= 3;
-                    gc >>= 3;
-                    bc >>= 3;
-
-                    if ((rc < 0x1f) && rlow > coeff) rc++;
-                    if ((gc < 0x1f) && glow > coeff) gc++;
-                    if ((bc < 0x1f) && blow > coeff) bc++;
-
-                    *ditherLUT++ = ((uint16_t)bc << 10) | ((uint16_t)gc << 5) | (uint16_t)rc;
-                }
-            }
+// For each of the 16 spots of the 4x4 dithering matrix, and each 8 bits value of a channel, the 5 bits value it
+// ends up as. All three channels go through the same table, which is only 4KB, and stays in the cache.
+static constexpr auto s_ditherLUT = []() {
+    std::array<std::array<uint8_t, 256>, 16> lut = {};
+    for (unsigned s = 0; s < 16; s++) {
+        for (unsigned value = 0; value < 256; value++) {
+            uint8_t c = value >> 3;
+            if ((c < 0x1f) && ((value & 7) > s_dithertable[s])) c++;
+            lut[s][value] = c;
         }
     }
-}
-
-void PCSX::SoftGPU::SoftRenderer::enableCachedDithering() {
-    if (!s_ditherLUT) prepareDitherLut();
-}
+    return lut;
+}();
 
-void PCSX::SoftGPU::SoftRenderer::disableCachedDithering() {
-    if (s_ditherLUT) delete[] s_ditherLUT;
-    s_ditherLUT = nullptr;
-}
+void PCSX::SoftGPU::SoftRenderer::enableCachedDithering() { m_cachedDithering = true; }
 
-PCSX::SoftGPU::SoftRenderer::~SoftRenderer() {
-    if (s_ditherLUT) delete[] s_ditherLUT;
-    s_ditherLUT = nullptr;
-}
+void PCSX::SoftGPU::SoftRenderer::disableCachedDithering() { m_cachedDithering = false; }
 
 static void applyDitherCached(uint16_t *pdest, uint16_t *base, uint32_t r, uint32_t g, uint32_t b, uint16_t sM) {
     int x, y;
@@ -332,15 +300,8 @@ static void applyDitherCached(uint16_t *pdest, uint16_t *base, uint32_t r, uint3
     y = x >> 10;
     x -= (y << 10);
 
-    uint32_t index = r;
-    index <<= 8;
-    index |= g;
-    index <<= 8;
-    index |= b;
-    index <<= 4;
-    index |= (y & 3) * 4 + (x & 3);
-
-    *pdest = s_ditherLUT[index] | sM;
+    const auto &lut = s_ditherLUT[(y & 3) * 4 + (x & 3)];
+    *pdest = ((uint16_t)lut[b] << 10) | ((uint16_t)lut[g] << 5) | (uint16_t)lut[r] | sM;
 }
 
 static void applyDither(uint16_t *pdest, uint16_t *base, uint32_t r, uint32_t g, uint32_t b, uint16_t sM) {
@@ -377,7 +338,7 @@ template <bool useCachedDither>
 void PCSX::SoftGPU::SoftRenderer::getShadeTransColDither(uint16_t *pdest, int32_t m1, int32_t m2, int32_t m3) {
     int32_t r, g, b;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     if (m_drawSemiTrans) {
         r = ((XCOL1D(*pdest)) << 3);
@@ -424,7 +385,7 @@ void PCSX::SoftGPU::SoftRenderer::getShadeTransColDither(uint16_t *pdest, int32_
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SoftGPU::SoftRenderer::getShadeTransCol(uint16_t *pdest, uint16_t color) {
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     if (m_drawSemiTrans) {
         int32_t r, g, b;
@@ -515,24 +476,11 @@ void PCSX::SoftGPU::SoftRenderer::getShadeTransCol32(uint32_t *pdest, uint32_t c
         if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
         if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-        if (m_checkMask) {
-            uint32_t ma = *pdest;
-            *pdest = (X32PSXCOL(r, g, b)) | m_setMask32;  // 0x80008000;
-            if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-            if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-            return;
-        }
-        *pdest = (X32PSXCOL(r, g, b)) | m_setMask32;  // 0x80008000;
+        const uint32_t dest = *pdest;
+        *pdest = keepMasked32(dest, (X32PSXCOL(r, g, b)) | m_setMask32, maskedKeep32(dest));
     } else {
-        if (m_checkMask) {
-            uint32_t ma = *pdest;
-            *pdest = color | m_setMask32;  // 0x80008000;
-            if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-            if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-            return;
-        }
-
-        *pdest = color | m_setMask32;  // 0x80008000;
+        const uint32_t dest = *pdest;
+        *pdest = keepMasked32(dest, color | m_setMask32, maskedKeep32(dest));
     }
 }
 
@@ -544,7 +492,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade(uint16_t *pdest, uint1
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     l = m_setMask16 | (color & 0x8000);
 
@@ -614,7 +562,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeSemi(uint16_t *pdest, u
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     l = m_setMask16 | (color & 0x8000);
 
@@ -725,28 +673,8 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32(uint32_t *pdest, uin
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if (m_checkMask) {
-        uint32_t ma = *pdest;
-
-        *pdest = (X32PSXCOL(r, g, b)) | l;
-
-        if ((color & 0xffff) == 0) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-        if ((color & 0xffff0000) == 0) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-        if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-        if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-
-        return;
-    }
-    if ((color & 0xffff) == 0) {
-        *pdest = (*pdest & 0xffff) | (((X32PSXCOL(r, g, b)) | l) & 0xffff0000);
-        return;
-    }
-    if ((color & 0xffff0000) == 0) {
-        *pdest = (*pdest & 0xffff0000) | (((X32PSXCOL(r, g, b)) | l) & 0xffff);
-        return;
-    }
-
-    *pdest = (X32PSXCOL(r, g, b)) | l;
+    const uint32_t dest = *pdest;
+    *pdest = keepMasked32(dest, (X32PSXCOL(r, g, b)) | l, maskedKeep32(dest) | transparentKeep32(color));
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -767,16 +695,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShade32Solid(uint32_t *pdest
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if ((color & 0xffff) == 0) {
-        *pdest = (*pdest & 0xffff) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff0000);
-        return;
-    }
-    if ((color & 0xffff0000) == 0) {
-        *pdest = (*pdest & 0xffff0000) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff);
-        return;
-    }
-
-    *pdest = (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000);
+    *pdest = keepMasked32(*pdest, (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000), transparentKeep32(color));
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -847,28 +766,9 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColG32Semi(uint32_t *pdest, uin
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if (m_checkMask) {
-        uint32_t ma = *pdest;
-
-        *pdest = (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000);
-
-        if ((color & 0xffff) == 0) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-        if ((color & 0xffff0000) == 0) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-        if (ma & 0x80000000) *pdest = (ma & 0xffff0000) | (*pdest & 0xffff);
-        if (ma & 0x00008000) *pdest = (ma & 0xffff) | (*pdest & 0xffff0000);
-
-        return;
-    }
-    if ((color & 0xffff) == 0) {
-        *pdest = (*pdest & 0xffff) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff0000);
-        return;
-    }
-    if ((color & 0xffff0000) == 0) {
-        *pdest = (*pdest & 0xffff0000) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff);
-        return;
-    }
-
-    *pdest = (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000);
+    const uint32_t dest = *pdest;
+    *pdest = keepMasked32(dest, (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000),
+                          maskedKeep32(dest) | transparentKeep32(color));
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -880,7 +780,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeXDither(uint16_t *pdest
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     m1 = (((XCOL1D(color))) * m1) >> 4;
     m2 = (((XCOL2D(color))) * m2) >> 4;
@@ -937,7 +837,7 @@ void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeX(uint16_t *pdest, uint
 
     if (color == 0) return;
 
-    if (m_checkMask && *pdest & 0x8000) return;
+    if (*pdest & checkMask16()) return;
 
     l = m_setMask16 | (color & 0x8000);
 
@@ -1016,16 +916,7 @@ inline void PCSX::SoftGPU::SoftRenderer::getTextureTransColShadeX32Solid(uint32_
     if (g & 0x7fe00000) g = 0x1f0000 | (g & 0xffff);
     if (g & 0x7fe0) g = 0x1f | (g & 0xffff0000);
 
-    if ((color & 0xffff) == 0) {
-        *pdest = (*pdest & 0xffff) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff0000);
-        return;
-    }
-    if ((color & 0xffff0000) == 0) {
-        *pdest = (*pdest & 0xffff0000) | (((X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000)) & 0xffff);
-        return;
-    }
-
-    *pdest = (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000);
+    *pdest = keepMasked32(*pdest, (X32PSXCOL(r, g, b)) | m_setMask32 | (color & 0x80008000), transparentKeep32(color));
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -1089,9 +980,11 @@ void PCSX::SoftGPU::SoftRenderer::fillSoftwareAreaTrans(int16_t x0, int16_t y0,
                 DSTPtr += LineOffset;
             }
         } else {
+            const auto flatSpan = Spans::getFlatSpanKernel();
+            const auto blend = spanBlend();
             for (i = 0; i < dy; i++) {
-                for (j = 0; j < dx; j++) getShadeTransCol32(DSTPtr++, lcol);
-                DSTPtr += LineOffset;
+                flatSpan(DSTPtr, dx, lcol, blend);
+                DSTPtr += 512;
             }
         }
     }
@@ -1140,6 +1033,20 @@ void PCSX::SoftGPU::SoftRenderer::fillSoftwareArea(int16_t x0, int16_t y0, int16
     }
 }
 
+void PCSX::SoftGPU::SoftRenderer::fillSoftwareAreaRows(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                                       uint16_t col) {
+    fillSoftwareArea(x0, std::max<int>(y0, m_drawY), x1, std::min<int>(y1, m_drawH + 1), col);
+}
+
+void PCSX::SoftGPU::SoftRenderer::copySoftwareAreaRows(int16_t sX, int16_t sY, int16_t dX, int16_t dY, int16_t w,
+                                                       int16_t h) {
+    const int first = std::max(0, m_drawY - dY);
+    const int last = std::min<int>(h, m_drawH + 1 - dY);
+    for (int j = first; j < last; j++) {
+        std::memcpy(m_vram16 + GPU_WIDTH * (dY + j) + dX, m_vram16 + GPU_WIDTH * (sY + j) + sX, w * sizeof(uint16_t));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
@@ -1148,67 +1055,38 @@ void PCSX::SoftGPU::SoftRenderer::fillSoftwareArea(int16_t x0, int16_t y0, int16
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::rightSectionFlat3() {
+int PCSX::SoftGPU::SoftRenderer::rightSectionFlat4() {
     SoftVertex *v1 = m_rightArray[m_rightSection];
     SoftVertex *v2 = m_rightArray[m_rightSection - 1];
 
     int height = v2->y - v1->y;
+    m_rightSectionHeight = height;
+    m_rightX = v1->x;
     if (height == 0) return 0;
     m_deltaRightX = (v2->x - v1->x) / height;
-    m_rightX = v1->x;
 
-    m_rightSectionHeight = height;
     return height;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionFlat3() {
+int PCSX::SoftGPU::SoftRenderer::leftSectionFlat4() {
     SoftVertex *v1 = m_leftArray[m_leftSection];
     SoftVertex *v2 = m_leftArray[m_leftSection - 1];
 
     int height = v2->y - v1->y;
+    m_leftSectionHeight = height;
+    m_leftX = v1->x;
     if (height == 0) return 0;
     m_deltaLeftX = (v2->x - v1->x) / height;
-    m_leftX = v1->x;
 
-    m_leftSectionHeight = height;
     return height;
 }
 
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::nextRowFlat3() {
-    if (--m_leftSectionHeight <= 0) {
-        if (--m_leftSection <= 0) {
-            return true;
-        }
-        if (leftSectionFlat3() <= 0) {
-            return true;
-        }
-    } else {
-        m_leftX += m_deltaLeftX;
-    }
-
-    if (--m_rightSectionHeight <= 0) {
-        if (--m_rightSection <= 0) {
-            return true;
-        }
-        if (rightSectionFlat3() <= 0) {
-            return true;
-        }
-    } else {
-        m_rightX += m_deltaRightX;
-    }
-    return false;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                     int16_t y3) {
-    SoftVertex *v1, *v2, *v3;
-    int height, longest;
+bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                     int16_t y3, int16_t x4, int16_t y4) {
+    SoftVertex *v1, *v2, *v3, *v4;
+    int height, width, longest1, longest2;
 
     v1 = m_vtx;
     v1->x = x1 << 16;
@@ -1219,6 +1097,9 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat3(int16_t x1, int16_t y1, int
     v3 = m_vtx + 2;
     v3->x = x3 << 16;
     v3->y = y3;
+    v4 = m_vtx + 3;
+    v4->x = x4 << 16;
+    v4->y = y4;
 
     if (v1->y > v2->y) {
         SoftVertex *v = v1;
@@ -1230,53 +1111,129 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat3(int16_t x1, int16_t y1, int
         v1 = v3;
         v3 = v;
     }
+    if (v1->y > v4->y) {
+        SoftVertex *v = v1;
+        v1 = v4;
+        v4 = v;
+    }
     if (v2->y > v3->y) {
         SoftVertex *v = v2;
         v2 = v3;
         v3 = v;
     }
-
-    height = v3->y - v1->y;
-    if (height == 0) {
-        return false;
+    if (v2->y > v4->y) {
+        SoftVertex *v = v2;
+        v2 = v4;
+        v4 = v;
     }
-    longest = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-    if (longest == 0) {
-        return false;
+    if (v3->y > v4->y) {
+        SoftVertex *v = v3;
+        v3 = v4;
+        v4 = v;
     }
 
-    if (longest < 0) {
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v2;
-        m_rightArray[2] = v1;
-        m_rightSection = 2;
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v1;
-        m_leftSection = 1;
-
-        if (leftSectionFlat3() <= 0) return false;
-        if (rightSectionFlat3() <= 0) {
-            m_rightSection--;
-            if (rightSectionFlat3() <= 0) return false;
+    height = v4->y - v1->y;
+    if (height == 0) height = 1;
+    width = (v4->x - v1->x) >> 16;
+    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
+    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
+
+    if (longest1 < 0) {
+        // 2 is right
+        if (longest2 < 0) {
+            // 3 is right
+            m_leftArray[0] = v4;
+            m_leftArray[1] = v1;
+            m_leftSection = 1;
+
+            height = v3->y - v1->y;
+            if (height == 0) height = 1;
+            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
+            if (longest1 >= 0) {
+                m_rightArray[0] = v4;  //  1
+                m_rightArray[1] = v3;  //     3
+                m_rightArray[2] = v1;  //  4
+                m_rightSection = 2;
+            } else {
+                height = v4->y - v2->y;
+                if (height == 0) height = 1;
+                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
+                if (longest1 >= 0) {
+                    m_rightArray[0] = v4;  //  1
+                    m_rightArray[1] = v2;  //     2
+                    m_rightArray[2] = v1;  //  4
+                    m_rightSection = 2;
+                } else {
+                    m_rightArray[0] = v4;  //  1
+                    m_rightArray[1] = v3;  //     2
+                    m_rightArray[2] = v2;  //     3
+                    m_rightArray[3] = v1;  //  4
+                    m_rightSection = 3;
+                }
+            }
+        } else {
+            m_leftArray[0] = v4;
+            m_leftArray[1] = v3;   //    1
+            m_leftArray[2] = v1;   //      2
+            m_leftSection = 2;     //  3
+            m_rightArray[0] = v4;  //    4
+            m_rightArray[1] = v2;
+            m_rightArray[2] = v1;
+            m_rightSection = 2;
         }
     } else {
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v2;
-        m_leftArray[2] = v1;
-        m_leftSection = 2;
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v1;
-        m_rightSection = 1;
-
-        if (rightSectionFlat3() <= 0) return false;
-        if (leftSectionFlat3() <= 0) {
-            m_leftSection--;
-            if (leftSectionFlat3() <= 0) return false;
+        if (longest2 < 0) {
+            m_leftArray[0] = v4;  //    1
+            m_leftArray[1] = v2;  //  2
+            m_leftArray[2] = v1;  //      3
+            m_leftSection = 2;    //    4
+            m_rightArray[0] = v4;
+            m_rightArray[1] = v3;
+            m_rightArray[2] = v1;
+            m_rightSection = 2;
+        } else {
+            m_rightArray[0] = v4;
+            m_rightArray[1] = v1;
+            m_rightSection = 1;
+
+            height = v3->y - v1->y;
+            if (height == 0) height = 1;
+            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
+            if (longest1 < 0) {
+                m_leftArray[0] = v4;  //    1
+                m_leftArray[1] = v3;  //  3
+                m_leftArray[2] = v1;  //    4
+                m_leftSection = 2;
+            } else {
+                height = v4->y - v2->y;
+                if (height == 0) height = 1;
+                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
+                if (longest1 < 0) {
+                    m_leftArray[0] = v4;  //    1
+                    m_leftArray[1] = v2;  //  2
+                    m_leftArray[2] = v1;  //    4
+                    m_leftSection = 2;
+                } else {
+                    m_leftArray[0] = v4;  //    1
+                    m_leftArray[1] = v3;  //  2
+                    m_leftArray[2] = v2;  //  3
+                    m_leftArray[3] = v1;  //     4
+                    m_leftSection = 3;
+                }
+            }
         }
     }
 
+    while (leftSectionFlat4() <= 0) {
+        if (--m_leftSection <= 0) break;
+    }
+
+    while (rightSectionFlat4() <= 0) {
+        if (--m_rightSection <= 0) break;
+    }
+
     m_yMin = v1->y;
-    m_yMax = std::min(v3->y - 1, m_drawH);
+    m_yMax = std::min(v4->y - 1, m_drawH);
 
     return true;
 }
@@ -1284,88 +1241,103 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat3(int16_t x1, int16_t y1, int
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::rightSectionShade3() {
+int PCSX::SoftGPU::SoftRenderer::rightSectionFlatTextured4() {
     SoftVertex *v1 = m_rightArray[m_rightSection];
     SoftVertex *v2 = m_rightArray[m_rightSection - 1];
 
     int height = v2->y - v1->y;
+    m_rightSectionHeight = height;
+    m_rightX = v1->x;
+    m_rightU = v1->u;
+    m_rightV = v1->v;
     if (height == 0) return 0;
     m_deltaRightX = (v2->x - v1->x) / height;
-    m_rightX = v1->x;
+    m_deltaRightU = (v2->u - v1->u) / height;
+    m_deltaRightV = (v2->v - v1->v) / height;
 
-    m_rightSectionHeight = height;
     return height;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionShade3() {
+int PCSX::SoftGPU::SoftRenderer::leftSectionFlatTextured4() {
     SoftVertex *v1 = m_leftArray[m_leftSection];
     SoftVertex *v2 = m_leftArray[m_leftSection - 1];
 
     int height = v2->y - v1->y;
+    m_leftSectionHeight = height;
+    m_leftX = v1->x;
+    m_leftU = v1->u;
+    m_leftV = v1->v;
     if (height == 0) return 0;
     m_deltaLeftX = (v2->x - v1->x) / height;
-    m_leftX = v1->x;
-
-    deltaLeftR = ((v2->R - v1->R)) / height;
-    m_leftR = v1->R;
-    m_deltaLeftG = ((v2->G - v1->G)) / height;
-    m_leftG = v1->G;
-    m_deltaLeftB = ((v2->B - v1->B)) / height;
-    m_leftB = v1->B;
+    m_deltaLeftU = (v2->u - v1->u) / height;
+    m_deltaLeftV = (v2->v - v1->v) / height;
 
-    m_leftSectionHeight = height;
     return height;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-bool PCSX::SoftGPU::SoftRenderer::nextRowShade3() {
+bool PCSX::SoftGPU::SoftRenderer::nextRowFlatTextured4() {
     if (--m_leftSectionHeight <= 0) {
-        if (--m_leftSection <= 0) return true;
-        if (leftSectionShade3() <= 0) return true;
+        if (--m_leftSection > 0) {
+            while (leftSectionFlatTextured4() <= 0) {
+                if (--m_leftSection <= 0) break;
+            }
+        }
     } else {
         m_leftX += m_deltaLeftX;
-        m_leftR += deltaLeftR;
-        m_leftG += m_deltaLeftG;
-        m_leftB += m_deltaLeftB;
+        m_leftU += m_deltaLeftU;
+        m_leftV += m_deltaLeftV;
     }
 
     if (--m_rightSectionHeight <= 0) {
-        if (--m_rightSection <= 0) return true;
-        if (rightSectionShade3() <= 0) return true;
+        if (--m_rightSection > 0) {
+            while (rightSectionFlatTextured4() <= 0) {
+                if (--m_rightSection <= 0) break;
+            }
+        }
     } else {
         m_rightX += m_deltaRightX;
+        m_rightU += m_deltaRightU;
+        m_rightV += m_deltaRightV;
     }
     return false;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsShade3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                      int16_t y3, int32_t rgb1, int32_t rgb2, int32_t rgb3) {
-    SoftVertex *v1, *v2, *v3;
-    int height, longest, temp;
+bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlatTextured4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                             int16_t y3, int16_t x4, int16_t y4, int16_t tx1,
+                                                             int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                             int16_t ty3, int16_t tx4, int16_t ty4) {
+    SoftVertex *v1, *v2, *v3, *v4;
+    int height, width, longest1, longest2;
 
     v1 = m_vtx;
     v1->x = x1 << 16;
     v1->y = y1;
-    v1->R = rgb1 & 0x00ff0000;
-    v1->G = (rgb1 << 8) & 0x00ff0000;
-    v1->B = (rgb1 << 16) & 0x00ff0000;
+    v1->u = tx1 << 16;
+    v1->v = ty1 << 16;
+
     v2 = m_vtx + 1;
     v2->x = x2 << 16;
     v2->y = y2;
-    v2->R = rgb2 & 0x00ff0000;
-    v2->G = (rgb2 << 8) & 0x00ff0000;
-    v2->B = (rgb2 << 16) & 0x00ff0000;
+    v2->u = tx2 << 16;
+    v2->v = ty2 << 16;
+
     v3 = m_vtx + 2;
     v3->x = x3 << 16;
     v3->y = y3;
-    v3->R = rgb3 & 0x00ff0000;
-    v3->G = (rgb3 << 8) & 0x00ff0000;
-    v3->B = (rgb3 << 16) & 0x00ff0000;
+    v3->u = tx3 << 16;
+    v3->v = ty3 << 16;
+
+    v4 = m_vtx + 3;
+    v4->x = x4 << 16;
+    v4->y = y4;
+    v4->u = tx4 << 16;
+    v4->v = ty4 << 16;
 
     if (v1->y > v2->y) {
         SoftVertex *v = v1;
@@ -1377,139 +1349,231 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsShade3(int16_t x1, int16_t y1, in
         v1 = v3;
         v3 = v;
     }
+    if (v1->y > v4->y) {
+        SoftVertex *v = v1;
+        v1 = v4;
+        v4 = v;
+    }
     if (v2->y > v3->y) {
         SoftVertex *v = v2;
         v2 = v3;
         v3 = v;
     }
+    if (v2->y > v4->y) {
+        SoftVertex *v = v2;
+        v2 = v4;
+        v4 = v;
+    }
+    if (v3->y > v4->y) {
+        SoftVertex *v = v3;
+        v3 = v4;
+        v4 = v;
+    }
+
+    height = v4->y - v1->y;
+    if (height == 0) height = 1;
+    width = (v4->x - v1->x) >> 16;
+    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
+    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
+
+    if (longest1 < 0) {
+        // 2 is right
+        if (longest2 < 0) {
+            // 3 is right
+            m_leftArray[0] = v4;
+            m_leftArray[1] = v1;
+            m_leftSection = 1;
 
-    height = v3->y - v1->y;
-    if (height == 0) return false;
-    temp = (((v2->y - v1->y) << 16) / height);
-    longest = temp * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-    if (longest == 0) return false;
-
-    if (longest < 0) {
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v2;
-        m_rightArray[2] = v1;
-        m_rightSection = 2;
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v1;
-        m_leftSection = 1;
-
-        if (leftSectionShade3() <= 0) return false;
-        if (rightSectionShade3() <= 0) {
-            m_rightSection--;
-            if (rightSectionShade3() <= 0) return false;
+            height = v3->y - v1->y;
+            if (height == 0) height = 1;
+            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
+            if (longest1 >= 0) {
+                m_rightArray[0] = v4;  //  1
+                m_rightArray[1] = v3;  //     3
+                m_rightArray[2] = v1;  //  4
+                m_rightSection = 2;
+            } else {
+                height = v4->y - v2->y;
+                if (height == 0) height = 1;
+                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
+                if (longest1 >= 0) {
+                    m_rightArray[0] = v4;  //  1
+                    m_rightArray[1] = v2;  //     2
+                    m_rightArray[2] = v1;  //  4
+                    m_rightSection = 2;
+                } else {
+                    m_rightArray[0] = v4;  //  1
+                    m_rightArray[1] = v3;  //     2
+                    m_rightArray[2] = v2;  //     3
+                    m_rightArray[3] = v1;  //  4
+                    m_rightSection = 3;
+                }
+            }
+        } else {
+            m_leftArray[0] = v4;
+            m_leftArray[1] = v3;   //    1
+            m_leftArray[2] = v1;   //      2
+            m_leftSection = 2;     //  3
+            m_rightArray[0] = v4;  //    4
+            m_rightArray[1] = v2;
+            m_rightArray[2] = v1;
+            m_rightSection = 2;
         }
-        if (longest > -0x1000) longest = -0x1000;
     } else {
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v2;
-        m_leftArray[2] = v1;
-        m_leftSection = 2;
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v1;
-        m_rightSection = 1;
-
-        if (rightSectionShade3() <= 0) return false;
-        if (leftSectionShade3() <= 0) {
-            m_leftSection--;
-            if (leftSectionShade3() <= 0) return false;
+        if (longest2 < 0) {
+            m_leftArray[0] = v4;  //    1
+            m_leftArray[1] = v2;  //  2
+            m_leftArray[2] = v1;  //      3
+            m_leftSection = 2;    //    4
+            m_rightArray[0] = v4;
+            m_rightArray[1] = v3;
+            m_rightArray[2] = v1;
+            m_rightSection = 2;
+        } else {
+            m_rightArray[0] = v4;
+            m_rightArray[1] = v1;
+            m_rightSection = 1;
+
+            height = v3->y - v1->y;
+            if (height == 0) height = 1;
+            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
+            if (longest1 < 0) {
+                m_leftArray[0] = v4;  //    1
+                m_leftArray[1] = v3;  //  3
+                m_leftArray[2] = v1;  //    4
+                m_leftSection = 2;
+            } else {
+                height = v4->y - v2->y;
+                if (height == 0) height = 1;
+                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
+                if (longest1 < 0) {
+                    m_leftArray[0] = v4;  //    1
+                    m_leftArray[1] = v2;  //  2
+                    m_leftArray[2] = v1;  //    4
+                    m_leftSection = 2;
+                } else {
+                    m_leftArray[0] = v4;  //    1
+                    m_leftArray[1] = v3;  //  2
+                    m_leftArray[2] = v2;  //  3
+                    m_leftArray[3] = v1;  //     4
+                    m_leftSection = 3;
+                }
+            }
         }
-        if (longest < 0x1000) longest = 0x1000;
     }
 
-    m_yMin = v1->y;
-    m_yMax = std::min(v3->y - 1, m_drawH);
+    while (leftSectionFlatTextured4() <= 0) {
+        if (--m_leftSection <= 0) break;
+    }
 
-    m_deltaRightR = shl10idiv(temp * ((v3->R - v1->R) >> 10) + ((v1->R - v2->R) << 6), longest);
-    m_deltaRightG = shl10idiv(temp * ((v3->G - v1->G) >> 10) + ((v1->G - v2->G) << 6), longest);
-    m_deltaRightB = shl10idiv(temp * ((v3->B - v1->B) >> 10) + ((v1->B - v2->B) << 6), longest);
+    while (rightSectionFlatTextured4() <= 0) {
+        if (--m_rightSection <= 0) break;
+    }
+
+    m_yMin = v1->y;
+    m_yMax = std::min(v4->y - 1, m_drawH);
 
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::rightSectionFlatTextured3() {
+int PCSX::SoftGPU::SoftRenderer::rightSectionShadeTextured4() {
     SoftVertex *v1 = m_rightArray[m_rightSection];
     SoftVertex *v2 = m_rightArray[m_rightSection - 1];
 
     int height = v2->y - v1->y;
+    m_rightSectionHeight = height;
+    m_rightX = v1->x;
+    m_rightU = v1->u;
+    m_rightV = v1->v;
+    m_rightR = v1->R;
+    m_rightG = v1->G;
+    m_rightB = v1->B;
+
     if (height == 0) return 0;
     m_deltaRightX = (v2->x - v1->x) / height;
-    m_rightX = v1->x;
+    m_deltaRightU = (v2->u - v1->u) / height;
+    m_deltaRightV = (v2->v - v1->v) / height;
+    m_deltaRightR = (v2->R - v1->R) / height;
+    m_deltaRightG = (v2->G - v1->G) / height;
+    m_deltaRightB = (v2->B - v1->B) / height;
 
-    m_rightSectionHeight = height;
     return height;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionFlatTextured3() {
+int PCSX::SoftGPU::SoftRenderer::leftSectionShadeTextured4() {
     SoftVertex *v1 = m_leftArray[m_leftSection];
     SoftVertex *v2 = m_leftArray[m_leftSection - 1];
 
     int height = v2->y - v1->y;
-    if (height == 0) return 0;
-    m_deltaLeftX = (v2->x - v1->x) / height;
+    m_leftSectionHeight = height;
     m_leftX = v1->x;
-
-    m_deltaLeftU = ((v2->u - v1->u)) / height;
     m_leftU = v1->u;
-    m_deltaLeftV = ((v2->v - v1->v)) / height;
     m_leftV = v1->v;
+    m_leftR = v1->R;
+    m_leftG = v1->G;
+    m_leftB = v1->B;
 
-    m_leftSectionHeight = height;
-    return height;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::nextRowFlatTextured3() {
-    if (--m_leftSectionHeight <= 0) {
-        if (--m_leftSection <= 0) return true;
-        if (leftSectionFlatTextured3() <= 0) return true;
-    } else {
-        m_leftX += m_deltaLeftX;
-        m_leftU += m_deltaLeftU;
-        m_leftV += m_deltaLeftV;
-    }
+    if (height == 0) return 0;
+    m_deltaLeftX = (v2->x - v1->x) / height;
+    m_deltaLeftU = (v2->u - v1->u) / height;
+    m_deltaLeftV = (v2->v - v1->v) / height;
+    deltaLeftR = (v2->R - v1->R) / height;
+    m_deltaLeftG = (v2->G - v1->G) / height;
+    m_deltaLeftB = (v2->B - v1->B) / height;
 
-    if (--m_rightSectionHeight <= 0) {
-        if (--m_rightSection <= 0) return true;
-        if (rightSectionFlatTextured3() <= 0) return true;
-    } else {
-        m_rightX += m_deltaRightX;
-    }
-    return false;
+    return height;
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlatTextured3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                             int16_t y3, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                             int16_t ty2, int16_t tx3, int16_t ty3) {
-    SoftVertex *v1, *v2, *v3;
-    int height, longest, temp;
+bool PCSX::SoftGPU::SoftRenderer::setupSectionsShadeTextured4(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                                              int16_t x3, int16_t y3, int16_t x4, int16_t y4,
+                                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
+                                                              int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                              int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4) {
+    SoftVertex *v1, *v2, *v3, *v4;
+    int height, width, longest1, longest2;
 
     v1 = m_vtx;
     v1->x = x1 << 16;
     v1->y = y1;
     v1->u = tx1 << 16;
     v1->v = ty1 << 16;
+    v1->R = rgb1 & 0x00ff0000;
+    v1->G = (rgb1 << 8) & 0x00ff0000;
+    v1->B = (rgb1 << 16) & 0x00ff0000;
+
     v2 = m_vtx + 1;
     v2->x = x2 << 16;
     v2->y = y2;
     v2->u = tx2 << 16;
     v2->v = ty2 << 16;
+    v2->R = rgb2 & 0x00ff0000;
+    v2->G = (rgb2 << 8) & 0x00ff0000;
+    v2->B = (rgb2 << 16) & 0x00ff0000;
+
     v3 = m_vtx + 2;
     v3->x = x3 << 16;
     v3->y = y3;
     v3->u = tx3 << 16;
     v3->v = ty3 << 16;
+    v3->R = rgb3 & 0x00ff0000;
+    v3->G = (rgb3 << 8) & 0x00ff0000;
+    v3->B = (rgb3 << 16) & 0x00ff0000;
+
+    v4 = m_vtx + 3;
+    v4->x = x4 << 16;
+    v4->y = y4;
+    v4->u = tx4 << 16;
+    v4->v = ty4 << 16;
+    v4->R = rgb4 & 0x00ff0000;
+    v4->G = (rgb4 << 8) & 0x00ff0000;
+    v4->B = (rgb4 << 16) & 0x00ff0000;
 
     if (v1->y > v2->y) {
         SoftVertex *v = v1;
@@ -1521,327 +1585,40 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlatTextured3(int16_t x1, int16_t
         v1 = v3;
         v3 = v;
     }
+    if (v1->y > v4->y) {
+        SoftVertex *v = v1;
+        v1 = v4;
+        v4 = v;
+    }
     if (v2->y > v3->y) {
         SoftVertex *v = v2;
         v2 = v3;
         v3 = v;
     }
-
-    height = v3->y - v1->y;
-    if (height == 0) return false;
-
-    temp = (((v2->y - v1->y) << 16) / height);
-    longest = temp * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-
-    if (longest == 0) return false;
-
-    if (longest < 0) {
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v2;
-        m_rightArray[2] = v1;
-        m_rightSection = 2;
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v1;
-        m_leftSection = 1;
-
-        if (leftSectionFlatTextured3() <= 0) return false;
-        if (rightSectionFlatTextured3() <= 0) {
-            m_rightSection--;
-            if (rightSectionFlatTextured3() <= 0) return false;
-        }
-        if (longest > -0x1000) longest = -0x1000;
-    } else {
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v2;
-        m_leftArray[2] = v1;
-        m_leftSection = 2;
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v1;
-        m_rightSection = 1;
-
-        if (rightSectionFlatTextured3() <= 0) return false;
-        if (leftSectionFlatTextured3() <= 0) {
-            m_leftSection--;
-            if (leftSectionFlatTextured3() <= 0) return false;
-        }
-        if (longest < 0x1000) longest = 0x1000;
+    if (v2->y > v4->y) {
+        SoftVertex *v = v2;
+        v2 = v4;
+        v4 = v;
+    }
+    if (v3->y > v4->y) {
+        SoftVertex *v = v3;
+        v3 = v4;
+        v4 = v;
     }
 
-    m_yMin = v1->y;
-    m_yMax = std::min(v3->y - 1, m_drawH);
-
-    m_deltaRightU = shl10idiv(temp * ((v3->u - v1->u) >> 10) + ((v1->u - v2->u) << 6), longest);
-    m_deltaRightV = shl10idiv(temp * ((v3->v - v1->v) >> 10) + ((v1->v - v2->v) << 6), longest);
-
-    return true;
-}
-
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-
-int PCSX::SoftGPU::SoftRenderer::rightSectionShadeTextured3() {
-    SoftVertex *v1 = m_rightArray[m_rightSection];
-    SoftVertex *v2 = m_rightArray[m_rightSection - 1];
-
-    int height = v2->y - v1->y;
-    if (height == 0) return 0;
-    m_deltaRightX = (v2->x - v1->x) / height;
-    m_rightX = v1->x;
-
-    m_rightSectionHeight = height;
-    return height;
-}
-
-////////////////////////////////////////////////////////////////////////
+    height = v4->y - v1->y;
+    if (height == 0) height = 1;
+    width = (v4->x - v1->x) >> 16;
+    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
+    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionShadeTextured3() {
-    SoftVertex *v1 = m_leftArray[m_leftSection];
-    SoftVertex *v2 = m_leftArray[m_leftSection - 1];
-
-    int height = v2->y - v1->y;
-    if (height == 0) return 0;
-    m_deltaLeftX = (v2->x - v1->x) / height;
-    m_leftX = v1->x;
-
-    m_deltaLeftU = ((v2->u - v1->u)) / height;
-    m_leftU = v1->u;
-    m_deltaLeftV = ((v2->v - v1->v)) / height;
-    m_leftV = v1->v;
-
-    deltaLeftR = ((v2->R - v1->R)) / height;
-    m_leftR = v1->R;
-    m_deltaLeftG = ((v2->G - v1->G)) / height;
-    m_leftG = v1->G;
-    m_deltaLeftB = ((v2->B - v1->B)) / height;
-    m_leftB = v1->B;
-
-    m_leftSectionHeight = height;
-    return height;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::nextRowShadeTextured3() {
-    if (--m_leftSectionHeight <= 0) {
-        if (--m_leftSection <= 0) return true;
-        if (leftSectionShadeTextured3() <= 0) return true;
-    } else {
-        m_leftX += m_deltaLeftX;
-        m_leftU += m_deltaLeftU;
-        m_leftV += m_deltaLeftV;
-        m_leftR += deltaLeftR;
-        m_leftG += m_deltaLeftG;
-        m_leftB += m_deltaLeftB;
-    }
-
-    if (--m_rightSectionHeight <= 0) {
-        if (--m_rightSection <= 0) return true;
-        if (rightSectionShadeTextured3() <= 0) return true;
-    } else {
-        m_rightX += m_deltaRightX;
-    }
-    return false;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsShadeTextured3(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
-                                                              int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
-                                                              int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3,
-                                                              int32_t rgb1, int32_t rgb2, int32_t rgb3) {
-    SoftVertex *v1, *v2, *v3;
-    int height, longest, temp;
-
-    v1 = m_vtx;
-    v1->x = x1 << 16;
-    v1->y = y1;
-    v1->u = tx1 << 16;
-    v1->v = ty1 << 16;
-    v1->R = rgb1 & 0x00ff0000;
-    v1->G = (rgb1 << 8) & 0x00ff0000;
-    v1->B = (rgb1 << 16) & 0x00ff0000;
-
-    v2 = m_vtx + 1;
-    v2->x = x2 << 16;
-    v2->y = y2;
-    v2->u = tx2 << 16;
-    v2->v = ty2 << 16;
-    v2->R = rgb2 & 0x00ff0000;
-    v2->G = (rgb2 << 8) & 0x00ff0000;
-    v2->B = (rgb2 << 16) & 0x00ff0000;
-
-    v3 = m_vtx + 2;
-    v3->x = x3 << 16;
-    v3->y = y3;
-    v3->u = tx3 << 16;
-    v3->v = ty3 << 16;
-    v3->R = rgb3 & 0x00ff0000;
-    v3->G = (rgb3 << 8) & 0x00ff0000;
-    v3->B = (rgb3 << 16) & 0x00ff0000;
-
-    if (v1->y > v2->y) {
-        SoftVertex *v = v1;
-        v1 = v2;
-        v2 = v;
-    }
-    if (v1->y > v3->y) {
-        SoftVertex *v = v1;
-        v1 = v3;
-        v3 = v;
-    }
-    if (v2->y > v3->y) {
-        SoftVertex *v = v2;
-        v2 = v3;
-        v3 = v;
-    }
-
-    height = v3->y - v1->y;
-    if (height == 0) return false;
-
-    temp = (((v2->y - v1->y) << 16) / height);
-    longest = temp * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-
-    if (longest == 0) return false;
-
-    if (longest < 0) {
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v2;
-        m_rightArray[2] = v1;
-        m_rightSection = 2;
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v1;
-        m_leftSection = 1;
-
-        if (leftSectionShadeTextured3() <= 0) return false;
-        if (rightSectionShadeTextured3() <= 0) {
-            m_rightSection--;
-            if (rightSectionShadeTextured3() <= 0) return false;
-        }
-
-        if (longest > -0x1000) longest = -0x1000;
-    } else {
-        m_leftArray[0] = v3;
-        m_leftArray[1] = v2;
-        m_leftArray[2] = v1;
-        m_leftSection = 2;
-        m_rightArray[0] = v3;
-        m_rightArray[1] = v1;
-        m_rightSection = 1;
-
-        if (rightSectionShadeTextured3() <= 0) return false;
-        if (leftSectionShadeTextured3() <= 0) {
-            m_leftSection--;
-            if (leftSectionShadeTextured3() <= 0) return false;
-        }
-        if (longest < 0x1000) longest = 0x1000;
-    }
-
-    m_yMin = v1->y;
-    m_yMax = std::min(v3->y - 1, m_drawH);
-
-    m_deltaRightR = shl10idiv(temp * ((v3->R - v1->R) >> 10) + ((v1->R - v2->R) << 6), longest);
-    m_deltaRightG = shl10idiv(temp * ((v3->G - v1->G) >> 10) + ((v1->G - v2->G) << 6), longest);
-    m_deltaRightB = shl10idiv(temp * ((v3->B - v1->B) >> 10) + ((v1->B - v2->B) << 6), longest);
-
-    m_deltaRightU = shl10idiv(temp * ((v3->u - v1->u) >> 10) + ((v1->u - v2->u) << 6), longest);
-    m_deltaRightV = shl10idiv(temp * ((v3->v - v1->v) >> 10) + ((v1->v - v2->v) << 6), longest);
-
-    return true;
-}
-
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-
-int PCSX::SoftGPU::SoftRenderer::rightSectionFlat4() {
-    SoftVertex *v1 = m_rightArray[m_rightSection];
-    SoftVertex *v2 = m_rightArray[m_rightSection - 1];
-
-    int height = v2->y - v1->y;
-    m_rightSectionHeight = height;
-    m_rightX = v1->x;
-    if (height == 0) return 0;
-    m_deltaRightX = (v2->x - v1->x) / height;
-
-    return height;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-int PCSX::SoftGPU::SoftRenderer::leftSectionFlat4() {
-    SoftVertex *v1 = m_leftArray[m_leftSection];
-    SoftVertex *v2 = m_leftArray[m_leftSection - 1];
-
-    int height = v2->y - v1->y;
-    m_leftSectionHeight = height;
-    m_leftX = v1->x;
-    if (height == 0) return 0;
-    m_deltaLeftX = (v2->x - v1->x) / height;
-
-    return height;
-}
-
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                     int16_t y3, int16_t x4, int16_t y4) {
-    SoftVertex *v1, *v2, *v3, *v4;
-    int height, width, longest1, longest2;
-
-    v1 = m_vtx;
-    v1->x = x1 << 16;
-    v1->y = y1;
-    v2 = m_vtx + 1;
-    v2->x = x2 << 16;
-    v2->y = y2;
-    v3 = m_vtx + 2;
-    v3->x = x3 << 16;
-    v3->y = y3;
-    v4 = m_vtx + 3;
-    v4->x = x4 << 16;
-    v4->y = y4;
-
-    if (v1->y > v2->y) {
-        SoftVertex *v = v1;
-        v1 = v2;
-        v2 = v;
-    }
-    if (v1->y > v3->y) {
-        SoftVertex *v = v1;
-        v1 = v3;
-        v3 = v;
-    }
-    if (v1->y > v4->y) {
-        SoftVertex *v = v1;
-        v1 = v4;
-        v4 = v;
-    }
-    if (v2->y > v3->y) {
-        SoftVertex *v = v2;
-        v2 = v3;
-        v3 = v;
-    }
-    if (v2->y > v4->y) {
-        SoftVertex *v = v2;
-        v2 = v4;
-        v4 = v;
-    }
-    if (v3->y > v4->y) {
-        SoftVertex *v = v3;
-        v3 = v4;
-        v4 = v;
-    }
-
-    height = v4->y - v1->y;
-    if (height == 0) height = 1;
-    width = (v4->x - v1->x) >> 16;
-    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
-    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
-
-    if (longest1 < 0) {
-        // 2 is right
-        if (longest2 < 0) {
-            // 3 is right
-            m_leftArray[0] = v4;
-            m_leftArray[1] = v1;
-            m_leftSection = 1;
+    if (longest1 < 0) {
+        // 2 is right
+        if (longest2 < 0) {
+            // 3 is right
+            m_leftArray[0] = v4;
+            m_leftArray[1] = v1;
+            m_leftSection = 1;
 
             height = v3->y - v1->y;
             if (height == 0) height = 1;
@@ -1921,11 +1698,11 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat4(int16_t x1, int16_t y1, int
         }
     }
 
-    while (leftSectionFlat4() <= 0) {
+    while (leftSectionShadeTextured4() <= 0) {
         if (--m_leftSection <= 0) break;
     }
 
-    while (rightSectionFlat4() <= 0) {
+    while (rightSectionShadeTextured4() <= 0) {
         if (--m_rightSection <= 0) break;
     }
 
@@ -1937,562 +1714,299 @@ bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlat4(int16_t x1, int16_t y1, int
 
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
-
-int PCSX::SoftGPU::SoftRenderer::rightSectionFlatTextured4() {
-    SoftVertex *v1 = m_rightArray[m_rightSection];
-    SoftVertex *v2 = m_rightArray[m_rightSection - 1];
-
-    int height = v2->y - v1->y;
-    m_rightSectionHeight = height;
-    m_rightX = v1->x;
-    m_rightU = v1->u;
-    m_rightV = v1->v;
-    if (height == 0) return 0;
-    m_deltaRightX = (v2->x - v1->x) / height;
-    m_deltaRightU = (v2->u - v1->u) / height;
-    m_deltaRightV = (v2->v - v1->v) / height;
-
-    return height;
-}
-
 ////////////////////////////////////////////////////////////////////////
+// TRIANGLE RASTERIZATION
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+// Triangles are walked by blocks of c_triangleBlock by c_triangleBlock pixels, testing the 3 edge functions at
+// the corners of each block first: blocks entirely outside of an edge get skipped, and blocks entirely inside of
+// all three get filled without testing any pixel. Pixels are sampled at their top left corner, and the ones
+// falling exactly on an edge only get drawn when it's a top or a left edge, which is what the hardware does: the
+// right and bottom sides of a triangle are left out, so that two triangles sharing an edge never overlap.
+//
+// Attributes are interpolated from gradients computed once per triangle, with 32 bits of fraction, instead of
+// being stepped along the edges. This gives the same value to a pixel no matter where the drawing area, or a
+// band of the tiled rasterizer, starts.
+template <PCSX::SoftGPU::SoftRenderer::TextureMode texture, bool shaded, bool solid,
+          PCSX::SoftGPU::SoftRenderer::TriangleDither dither>
+void PCSX::SoftGPU::SoftRenderer::rasterizeTriangle(const TriangleVertex *vertices, int16_t clX, int16_t clY) {
+    static constexpr bool textured = texture != TextureMode::None;
+    static constexpr int c_attributes = (textured ? 2 : 0) + (shaded ? 3 : 0);
+    static constexpr int c_u = 0;
+    static constexpr int c_v = 1;
+    static constexpr int c_r = textured ? 2 : 0;
+    static constexpr int c_g = c_r + 1;
+    static constexpr int c_b = c_r + 2;
+    // Makes up for the gradients being truncated, so that a texel or a colour sitting exactly on an integer
+    // doesn't end up one below it after a few hundred pixels.
+    static constexpr int64_t c_bias = int64_t(1) << 12;
+
+    const TriangleVertex *v0 = &vertices[0];
+    const TriangleVertex *v1 = &vertices[1];
+    const TriangleVertex *v2 = &vertices[2];
+
+    int64_t area = int64_t(v1->x - v0->x) * (v2->y - v0->y) - int64_t(v1->y - v0->y) * (v2->x - v0->x);
+    if (area == 0) return;
+    if (area < 0) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    const int minX = std::max<int>({std::min({v0->x, v1->x, v2->x}), m_drawX, 0});
+    const int minY = std::max<int>({std::min({v0->y, v1->y, v2->y}), m_drawY, 0});
+    const int maxX = std::min<int>({std::max({v0->x, v1->x, v2->x}) - 1, m_drawW, GPU_WIDTH - 1});
+    const int maxY = std::min<int>({std::max({v0->y, v1->y, v2->y}) - 1, m_drawH, GPU_HEIGHT - 1});
+    if ((minX > maxX) || (minY > maxY)) return;
+
+    // The edge functions are positive inside of the triangle, and biased by one for the edges which don't own
+    // the pixels right on them.
+    struct Edge {
+        int32_t dx, dy;
+        int32_t origin;  // At minX, minY
+    };
+    std::array<Edge, 3> edges;
+    const TriangleVertex *corners[3] = {v0, v1, v2};
+    for (unsigned i = 0; i < 3; i++) {
+        const auto a = corners[i];
+        const auto b = corners[(i + 1) % 3];
+        const int32_t ex = b->x - a->x;
+        const int32_t ey = b->y - a->y;
+        const bool topLeft = (ey < 0) || ((ey == 0) && (ex > 0));
+        edges[i].dx = -ey;
+        edges[i].dy = ex;
+        edges[i].origin = ex * (minY - a->y) - ey * (minX - a->x) - (topLeft ? 0 : 1);
+    }
+
+    struct Attribute {
+        int64_t dx, dy;
+        int64_t origin;  // At minX, minY
+    };
+    std::array<Attribute, c_attributes> attributes;
+    auto setup = [&](Attribute &attribute, int a0, int a1, int a2) {
+        const int64_t d1 = a1 - a0;
+        const int64_t d2 = a2 - a0;
+        attribute.dx = ((d1 * (v2->y - v0->y) - d2 * (v1->y - v0->y)) * (int64_t(1) << 32)) / area;
+        attribute.dy = ((d2 * (v1->x - v0->x) - d1 * (v2->x - v0->x)) * (int64_t(1) << 32)) / area;
+        attribute.origin = (int64_t(a0) << 32) + c_bias + attribute.dx * (minX - v0->x) + attribute.dy * (minY - v0->y);
+    };
+    if constexpr (textured) {
+        setup(attributes[c_u], v0->u, v1->u, v2->u);
+        setup(attributes[c_v], v0->v, v1->v, v2->v);
+    }
+    if constexpr (shaded) {
+        setup(attributes[c_r], v0->rgb & 0xff, v1->rgb & 0xff, v2->rgb & 0xff);
+        setup(attributes[c_g], (v0->rgb >> 8) & 0xff, (v1->rgb >> 8) & 0xff, (v2->rgb >> 8) & 0xff);
+        setup(attributes[c_b], (v0->rgb >> 16) & 0xff, (v1->rgb >> 16) & 0xff, (v2->rgb >> 16) & 0xff);
+    }
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionFlatTextured4() {
-    SoftVertex *v1 = m_leftArray[m_leftSection];
-    SoftVertex *v2 = m_leftArray[m_leftSection - 1];
-
-    int height = v2->y - v1->y;
-    m_leftSectionHeight = height;
-    m_leftX = v1->x;
-    m_leftU = v1->u;
-    m_leftV = v1->v;
-    if (height == 0) return 0;
-    m_deltaLeftX = (v2->x - v1->x) / height;
-    m_deltaLeftU = (v2->u - v1->u) / height;
-    m_deltaLeftV = (v2->v - v1->v) / height;
-
-    return height;
+    const auto vram16 = m_vram16;
+    const auto sampler = textureSampler<texture>(clX, clY);
+    const uint16_t flatColor = ((vertices[0].rgb & 0x00f80000) >> 9) | ((vertices[0].rgb & 0x0000f800) >> 6) |
+                               ((vertices[0].rgb & 0x000000f8) >> 3);
+    const uint16_t setMask16 = m_setMask16;
+
+    auto plot = [&](uint16_t *pdest, const int64_t *values) {
+        if constexpr (!textured && !shaded) {
+            if constexpr (solid) {
+                *pdest = flatColor | setMask16;
+            } else {
+                getShadeTransCol(pdest, flatColor);
+            }
+        } else if constexpr (!textured) {
+            const int32_t r = values[c_r] >> 32;
+            const int32_t g = values[c_g] >> 32;
+            const int32_t b = values[c_b] >> 32;
+            if constexpr (dither != TriangleDither::Off) {
+                getShadeTransColDither<dither == TriangleDither::Cached>(pdest, r, g, b);
+            } else if constexpr (solid) {
+                *pdest = ((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10)) | setMask16;
+            } else {
+                getShadeTransCol(pdest, (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10));
+            }
+        } else if constexpr (!shaded) {
+            const uint16_t texel = sampler.template fetch<texture>(values[c_u] >> 32, values[c_v] >> 32);
+            if constexpr (solid) {
+                getTextureTransColShadeSolid(pdest, texel);
+            } else {
+                getTextureTransColShade(pdest, texel);
+            }
+        } else {
+            const uint16_t texel = sampler.template fetch<texture>(values[c_u] >> 32, values[c_v] >> 32);
+            const int32_t r = values[c_r] >> 32;
+            const int32_t g = values[c_g] >> 32;
+            const int32_t b = values[c_b] >> 32;
+            if constexpr (dither != TriangleDither::Off) {
+                getTextureTransColShadeXDither<dither == TriangleDither::Cached>(pdest, texel, r, g, b);
+            } else if constexpr (solid) {
+                getTextureTransColShadeXSolid(pdest, texel, r, g, b);
+            } else {
+                getTextureTransColShadeX(pdest, texel, r, g, b);
+            }
+        }
+    };
+
+    // The rows of a block lying entirely inside of the triangle go through the span kernels, once their colors or
+    // their texels are worked out. Fetching texels, from a CLUT or not, is a gather, so it stays scalar: only the
+    // modulation and the blending get vectorized. Flat triangles are cheap enough as is, and dithering is left to
+    // the helpers.
+    static constexpr bool c_spans = (textured || shaded) && (dither == TriangleDither::Off);
+    // A row of texels gets fetched ahead of being drawn, so the kernels are also left out whenever the triangle may
+    // draw over its own texture page or CLUT, as the texels drawn over wouldn't be read back the same.
+    bool spans = c_spans;
+    if constexpr (c_spans && textured) {
+        const auto overlaps = [&](int x, int y, int w, int h) {
+            return (x <= maxX) && (x + w > minX) && (y <= maxY) && (y + h > minY);
+        };
+        if (overlaps(m_globalTextAddrX, m_globalTextAddrY, 256, 256)) spans = false;
+        if ((texture != TextureMode::Direct) && overlaps(clX, clY, 256, 1)) spans = false;
+    }
+    const auto shadedSpan = Spans::getShadedSpanKernel();
+    const auto texturedSpan = Spans::getTexturedSpanKernel();
+    const auto blend = spanBlend();
+    uint16_t spanPixels[c_triangleBlock];
+    int16_t spanModulation[3][c_triangleBlock];
+    if constexpr (textured && !shaded) {
+        std::fill_n(spanModulation[0], c_triangleBlock, m_m1);
+        std::fill_n(spanModulation[1], c_triangleBlock, m_m2);
+        std::fill_n(spanModulation[2], c_triangleBlock, m_m3);
+    }
+    const Spans::TexturedSpan texturedPixels = {spanPixels, spanModulation[0], spanModulation[1], spanModulation[2]};
+    auto drawSpan = [&](uint16_t *pdest, int count, std::array<int64_t, c_attributes> &values) {
+        if constexpr (c_spans) {
+            for (int x = 0; x < count; x++) {
+                if constexpr (textured) {
+                    spanPixels[x] = sampler.template fetch<texture>(values[c_u] >> 32, values[c_v] >> 32);
+                    if constexpr (shaded) {
+                        spanModulation[0][x] = values[c_r] >> 32;
+                        spanModulation[1][x] = values[c_g] >> 32;
+                        spanModulation[2][x] = values[c_b] >> 32;
+                    }
+                } else {
+                    const int32_t r = values[c_r] >> 32;
+                    const int32_t g = values[c_g] >> 32;
+                    const int32_t b = values[c_b] >> 32;
+                    spanPixels[x] = (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10);
+                }
+                for (int i = 0; i < c_attributes; i++) values[i] += attributes[i].dx;
+            }
+            if constexpr (textured) {
+                texturedSpan(pdest, count, texturedPixels, blend);
+            } else {
+                shadedSpan(pdest, count, spanPixels, blend);
+            }
+        }
+    };
+
+    static constexpr int c_last = c_triangleBlock - 1;
+    for (int by = minY; by <= maxY; by += c_triangleBlock) {
+        const int rows = std::min(c_triangleBlock, maxY - by + 1);
+        for (int bx = minX; bx <= maxX; bx += c_triangleBlock) {
+            const int columns = std::min(c_triangleBlock, maxX - bx + 1);
+            std::array<int32_t, 3> rowEdges;
+            bool outside = false;
+            bool inside = true;
+            for (unsigned i = 0; i < 3; i++) {
+                const auto &edge = edges[i];
+                const int32_t e = edge.origin + edge.dx * (bx - minX) + edge.dy * (by - minY);
+                const int32_t lowest = e + std::min(0, edge.dx) * c_last + std::min(0, edge.dy) * c_last;
+                const int32_t highest = e + std::max(0, edge.dx) * c_last + std::max(0, edge.dy) * c_last;
+                if (highest < 0) outside = true;
+                if (lowest < 0) inside = false;
+                rowEdges[i] = e;
+            }
+            if (outside) continue;
+
+            std::array<int64_t, c_attributes> rowValues;
+            for (int i = 0; i < c_attributes; i++) {
+                rowValues[i] = attributes[i].origin + attributes[i].dx * (bx - minX) + attributes[i].dy * (by - minY);
+            }
+
+            for (int y = 0; y < rows; y++) {
+                uint16_t *pdest = &vram16[((by + y) << 10) + bx];
+                std::array<int64_t, c_attributes> values = rowValues;
+                if (inside && spans) {
+                    drawSpan(pdest, columns, values);
+                } else if (inside) {
+                    for (int x = 0; x < columns; x++) {
+                        plot(pdest + x, values.data());
+                        for (int i = 0; i < c_attributes; i++) values[i] += attributes[i].dx;
+                    }
+                } else {
+                    int32_t e0 = rowEdges[0], e1 = rowEdges[1], e2 = rowEdges[2];
+                    for (int x = 0; x < columns; x++) {
+                        if ((e0 | e1 | e2) >= 0) plot(pdest + x, values.data());
+                        e0 += edges[0].dx;
+                        e1 += edges[1].dx;
+                        e2 += edges[2].dx;
+                        for (int i = 0; i < c_attributes; i++) values[i] += attributes[i].dx;
+                    }
+                }
+                for (unsigned i = 0; i < 3; i++) rowEdges[i] += edges[i].dy;
+                for (int i = 0; i < c_attributes; i++) rowValues[i] += attributes[i].dy;
+            }
+        }
+    }
 }
 
-////////////////////////////////////////////////////////////////////////
+// Picks the inner loop matching the state of the renderer. Dithering only ever applies to shaded triangles.
+template <PCSX::SoftGPU::SoftRenderer::TextureMode texture, bool shaded>
+void PCSX::SoftGPU::SoftRenderer::drawTriangle(const TriangleVertex *vertices, int16_t clX, int16_t clY) {
+    const auto drawX = m_drawX;
+    const auto drawY = m_drawY;
+    const auto drawW = m_drawW;
+    const auto drawH = m_drawH;
 
-bool PCSX::SoftGPU::SoftRenderer::nextRowFlatTextured4() {
-    if (--m_leftSectionHeight <= 0) {
-        if (--m_leftSection > 0) {
-            while (leftSectionFlatTextured4() <= 0) {
-                if (--m_leftSection <= 0) break;
+    if ((vertices[0].x > drawW) && (vertices[1].x > drawW) && (vertices[2].x > drawW)) return;
+    if ((vertices[0].y > drawH) && (vertices[1].y > drawH) && (vertices[2].y > drawH)) return;
+    if ((vertices[0].x < drawX) && (vertices[1].x < drawX) && (vertices[2].x < drawX)) return;
+    if ((vertices[0].y < drawY) && (vertices[1].y < drawY) && (vertices[2].y < drawY)) return;
+    if ((drawY > drawH) || (drawX > drawW)) return;
+
+    const bool solid = !m_checkMask && !m_drawSemiTrans;
+    if constexpr (shaded) {
+        if (m_ditherMode) {
+            if (m_cachedDithering) {
+                rasterizeTriangle<texture, true, false, TriangleDither::Cached>(vertices, clX, clY);
+            } else {
+                rasterizeTriangle<texture, true, false, TriangleDither::On>(vertices, clX, clY);
             }
+            return;
         }
+    }
+    if (solid) {
+        rasterizeTriangle<texture, shaded, true, TriangleDither::Off>(vertices, clX, clY);
     } else {
-        m_leftX += m_deltaLeftX;
-        m_leftU += m_deltaLeftU;
-        m_leftV += m_deltaLeftV;
-    }
-
-    if (--m_rightSectionHeight <= 0) {
-        if (--m_rightSection > 0) {
-            while (rightSectionFlatTextured4() <= 0) {
-                if (--m_rightSection <= 0) break;
-            }
-        }
-    } else {
-        m_rightX += m_deltaRightX;
-        m_rightU += m_deltaRightU;
-        m_rightV += m_deltaRightV;
+        rasterizeTriangle<texture, shaded, false, TriangleDither::Off>(vertices, clX, clY);
     }
-    return false;
 }
 
 ////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsFlatTextured4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                             int16_t y3, int16_t x4, int16_t y4, int16_t tx1,
-                                                             int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                             int16_t ty3, int16_t tx4, int16_t ty4) {
-    SoftVertex *v1, *v2, *v3, *v4;
-    int height, width, longest1, longest2;
-
-    v1 = m_vtx;
-    v1->x = x1 << 16;
-    v1->y = y1;
-    v1->u = tx1 << 16;
-    v1->v = ty1 << 16;
-
-    v2 = m_vtx + 1;
-    v2->x = x2 << 16;
-    v2->y = y2;
-    v2->u = tx2 << 16;
-    v2->v = ty2 << 16;
-
-    v3 = m_vtx + 2;
-    v3->x = x3 << 16;
-    v3->y = y3;
-    v3->u = tx3 << 16;
-    v3->v = ty3 << 16;
-
-    v4 = m_vtx + 3;
-    v4->x = x4 << 16;
-    v4->y = y4;
-    v4->u = tx4 << 16;
-    v4->v = ty4 << 16;
-
-    if (v1->y > v2->y) {
-        SoftVertex *v = v1;
-        v1 = v2;
-        v2 = v;
-    }
-    if (v1->y > v3->y) {
-        SoftVertex *v = v1;
-        v1 = v3;
-        v3 = v;
-    }
-    if (v1->y > v4->y) {
-        SoftVertex *v = v1;
-        v1 = v4;
-        v4 = v;
-    }
-    if (v2->y > v3->y) {
-        SoftVertex *v = v2;
-        v2 = v3;
-        v3 = v;
-    }
-    if (v2->y > v4->y) {
-        SoftVertex *v = v2;
-        v2 = v4;
-        v4 = v;
-    }
-    if (v3->y > v4->y) {
-        SoftVertex *v = v3;
-        v3 = v4;
-        v4 = v;
-    }
-
-    height = v4->y - v1->y;
-    if (height == 0) height = 1;
-    width = (v4->x - v1->x) >> 16;
-    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
-    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
-
-    if (longest1 < 0) {
-        // 2 is right
-        if (longest2 < 0) {
-            // 3 is right
-            m_leftArray[0] = v4;
-            m_leftArray[1] = v1;
-            m_leftSection = 1;
-
-            height = v3->y - v1->y;
-            if (height == 0) height = 1;
-            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-            if (longest1 >= 0) {
-                m_rightArray[0] = v4;  //  1
-                m_rightArray[1] = v3;  //     3
-                m_rightArray[2] = v1;  //  4
-                m_rightSection = 2;
-            } else {
-                height = v4->y - v2->y;
-                if (height == 0) height = 1;
-                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
-                if (longest1 >= 0) {
-                    m_rightArray[0] = v4;  //  1
-                    m_rightArray[1] = v2;  //     2
-                    m_rightArray[2] = v1;  //  4
-                    m_rightSection = 2;
-                } else {
-                    m_rightArray[0] = v4;  //  1
-                    m_rightArray[1] = v3;  //     2
-                    m_rightArray[2] = v2;  //     3
-                    m_rightArray[3] = v1;  //  4
-                    m_rightSection = 3;
-                }
-            }
-        } else {
-            m_leftArray[0] = v4;
-            m_leftArray[1] = v3;   //    1
-            m_leftArray[2] = v1;   //      2
-            m_leftSection = 2;     //  3
-            m_rightArray[0] = v4;  //    4
-            m_rightArray[1] = v2;
-            m_rightArray[2] = v1;
-            m_rightSection = 2;
-        }
-    } else {
-        if (longest2 < 0) {
-            m_leftArray[0] = v4;  //    1
-            m_leftArray[1] = v2;  //  2
-            m_leftArray[2] = v1;  //      3
-            m_leftSection = 2;    //    4
-            m_rightArray[0] = v4;
-            m_rightArray[1] = v3;
-            m_rightArray[2] = v1;
-            m_rightSection = 2;
-        } else {
-            m_rightArray[0] = v4;
-            m_rightArray[1] = v1;
-            m_rightSection = 1;
-
-            height = v3->y - v1->y;
-            if (height == 0) height = 1;
-            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-            if (longest1 < 0) {
-                m_leftArray[0] = v4;  //    1
-                m_leftArray[1] = v3;  //  3
-                m_leftArray[2] = v1;  //    4
-                m_leftSection = 2;
-            } else {
-                height = v4->y - v2->y;
-                if (height == 0) height = 1;
-                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
-                if (longest1 < 0) {
-                    m_leftArray[0] = v4;  //    1
-                    m_leftArray[1] = v2;  //  2
-                    m_leftArray[2] = v1;  //    4
-                    m_leftSection = 2;
-                } else {
-                    m_leftArray[0] = v4;  //    1
-                    m_leftArray[1] = v3;  //  2
-                    m_leftArray[2] = v2;  //  3
-                    m_leftArray[3] = v1;  //     4
-                    m_leftSection = 3;
-                }
-            }
-        }
-    }
-
-    while (leftSectionFlatTextured4() <= 0) {
-        if (--m_leftSection <= 0) break;
-    }
-
-    while (rightSectionFlatTextured4() <= 0) {
-        if (--m_rightSection <= 0) break;
-    }
-
-    m_yMin = v1->y;
-    m_yMax = std::min(v4->y - 1, m_drawH);
-
-    return true;
-}
-
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+// POLY FUNCS
+////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::rightSectionShadeTextured4() {
-    SoftVertex *v1 = m_rightArray[m_rightSection];
-    SoftVertex *v2 = m_rightArray[m_rightSection - 1];
-
-    int height = v2->y - v1->y;
-    m_rightSectionHeight = height;
-    m_rightX = v1->x;
-    m_rightU = v1->u;
-    m_rightV = v1->v;
-    m_rightR = v1->R;
-    m_rightG = v1->G;
-    m_rightB = v1->B;
-
-    if (height == 0) return 0;
-    m_deltaRightX = (v2->x - v1->x) / height;
-    m_deltaRightU = (v2->u - v1->u) / height;
-    m_deltaRightV = (v2->v - v1->v) / height;
-    m_deltaRightR = (v2->R - v1->R) / height;
-    m_deltaRightG = (v2->G - v1->G) / height;
-    m_deltaRightB = (v2->B - v1->B) / height;
+////////////////////////////////////////////////////////////////////////
+// POLY 3/4 FLAT SHADED
+////////////////////////////////////////////////////////////////////////
 
-    return height;
+void PCSX::SoftGPU::SoftRenderer::drawPoly3Fi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                              int32_t rgb) {
+    const TriangleVertex vertices[3] = {{x1, y1, 0, 0, rgb}, {x2, y2, 0, 0, rgb}, {x3, y3, 0, 0, rgb}};
+    drawTriangle<TextureMode::None, false>(vertices, 0, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-int PCSX::SoftGPU::SoftRenderer::leftSectionShadeTextured4() {
-    SoftVertex *v1 = m_leftArray[m_leftSection];
-    SoftVertex *v2 = m_leftArray[m_leftSection - 1];
-
-    int height = v2->y - v1->y;
-    m_leftSectionHeight = height;
-    m_leftX = v1->x;
-    m_leftU = v1->u;
-    m_leftV = v1->v;
-    m_leftR = v1->R;
-    m_leftG = v1->G;
-    m_leftB = v1->B;
-
-    if (height == 0) return 0;
-    m_deltaLeftX = (v2->x - v1->x) / height;
-    m_deltaLeftU = (v2->u - v1->u) / height;
-    m_deltaLeftV = (v2->v - v1->v) / height;
-    deltaLeftR = (v2->R - v1->R) / height;
-    m_deltaLeftG = (v2->G - v1->G) / height;
-    m_deltaLeftB = (v2->B - v1->B) / height;
+void PCSX::SoftGPU::SoftRenderer::drawPolyFlat3(int32_t rgb) { drawPoly3Fi(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb); }
 
-    return height;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-bool PCSX::SoftGPU::SoftRenderer::setupSectionsShadeTextured4(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
-                                                              int16_t x3, int16_t y3, int16_t x4, int16_t y4,
-                                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
-                                                              int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                              int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4) {
-    SoftVertex *v1, *v2, *v3, *v4;
-    int height, width, longest1, longest2;
-
-    v1 = m_vtx;
-    v1->x = x1 << 16;
-    v1->y = y1;
-    v1->u = tx1 << 16;
-    v1->v = ty1 << 16;
-    v1->R = rgb1 & 0x00ff0000;
-    v1->G = (rgb1 << 8) & 0x00ff0000;
-    v1->B = (rgb1 << 16) & 0x00ff0000;
-
-    v2 = m_vtx + 1;
-    v2->x = x2 << 16;
-    v2->y = y2;
-    v2->u = tx2 << 16;
-    v2->v = ty2 << 16;
-    v2->R = rgb2 & 0x00ff0000;
-    v2->G = (rgb2 << 8) & 0x00ff0000;
-    v2->B = (rgb2 << 16) & 0x00ff0000;
-
-    v3 = m_vtx + 2;
-    v3->x = x3 << 16;
-    v3->y = y3;
-    v3->u = tx3 << 16;
-    v3->v = ty3 << 16;
-    v3->R = rgb3 & 0x00ff0000;
-    v3->G = (rgb3 << 8) & 0x00ff0000;
-    v3->B = (rgb3 << 16) & 0x00ff0000;
-
-    v4 = m_vtx + 3;
-    v4->x = x4 << 16;
-    v4->y = y4;
-    v4->u = tx4 << 16;
-    v4->v = ty4 << 16;
-    v4->R = rgb4 & 0x00ff0000;
-    v4->G = (rgb4 << 8) & 0x00ff0000;
-    v4->B = (rgb4 << 16) & 0x00ff0000;
-
-    if (v1->y > v2->y) {
-        SoftVertex *v = v1;
-        v1 = v2;
-        v2 = v;
-    }
-    if (v1->y > v3->y) {
-        SoftVertex *v = v1;
-        v1 = v3;
-        v3 = v;
-    }
-    if (v1->y > v4->y) {
-        SoftVertex *v = v1;
-        v1 = v4;
-        v4 = v;
-    }
-    if (v2->y > v3->y) {
-        SoftVertex *v = v2;
-        v2 = v3;
-        v3 = v;
-    }
-    if (v2->y > v4->y) {
-        SoftVertex *v = v2;
-        v2 = v4;
-        v4 = v;
-    }
-    if (v3->y > v4->y) {
-        SoftVertex *v = v3;
-        v3 = v4;
-        v4 = v;
-    }
-
-    height = v4->y - v1->y;
-    if (height == 0) height = 1;
-    width = (v4->x - v1->x) >> 16;
-    longest1 = (((v2->y - v1->y) << 16) / height) * width + (v1->x - v2->x);
-    longest2 = (((v3->y - v1->y) << 16) / height) * width + (v1->x - v3->x);
-
-    if (longest1 < 0) {
-        // 2 is right
-        if (longest2 < 0) {
-            // 3 is right
-            m_leftArray[0] = v4;
-            m_leftArray[1] = v1;
-            m_leftSection = 1;
-
-            height = v3->y - v1->y;
-            if (height == 0) height = 1;
-            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-            if (longest1 >= 0) {
-                m_rightArray[0] = v4;  //  1
-                m_rightArray[1] = v3;  //     3
-                m_rightArray[2] = v1;  //  4
-                m_rightSection = 2;
-            } else {
-                height = v4->y - v2->y;
-                if (height == 0) height = 1;
-                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
-                if (longest1 >= 0) {
-                    m_rightArray[0] = v4;  //  1
-                    m_rightArray[1] = v2;  //     2
-                    m_rightArray[2] = v1;  //  4
-                    m_rightSection = 2;
-                } else {
-                    m_rightArray[0] = v4;  //  1
-                    m_rightArray[1] = v3;  //     2
-                    m_rightArray[2] = v2;  //     3
-                    m_rightArray[3] = v1;  //  4
-                    m_rightSection = 3;
-                }
-            }
-        } else {
-            m_leftArray[0] = v4;
-            m_leftArray[1] = v3;   //    1
-            m_leftArray[2] = v1;   //      2
-            m_leftSection = 2;     //  3
-            m_rightArray[0] = v4;  //    4
-            m_rightArray[1] = v2;
-            m_rightArray[2] = v1;
-            m_rightSection = 2;
-        }
-    } else {
-        if (longest2 < 0) {
-            m_leftArray[0] = v4;  //    1
-            m_leftArray[1] = v2;  //  2
-            m_leftArray[2] = v1;  //      3
-            m_leftSection = 2;    //    4
-            m_rightArray[0] = v4;
-            m_rightArray[1] = v3;
-            m_rightArray[2] = v1;
-            m_rightSection = 2;
-        } else {
-            m_rightArray[0] = v4;
-            m_rightArray[1] = v1;
-            m_rightSection = 1;
-
-            height = v3->y - v1->y;
-            if (height == 0) height = 1;
-            longest1 = (((v2->y - v1->y) << 16) / height) * ((v3->x - v1->x) >> 16) + (v1->x - v2->x);
-            if (longest1 < 0) {
-                m_leftArray[0] = v4;  //    1
-                m_leftArray[1] = v3;  //  3
-                m_leftArray[2] = v1;  //    4
-                m_leftSection = 2;
-            } else {
-                height = v4->y - v2->y;
-                if (height == 0) height = 1;
-                longest1 = (((v3->y - v2->y) << 16) / height) * ((v4->x - v2->x) >> 16) + (v2->x - v3->x);
-                if (longest1 < 0) {
-                    m_leftArray[0] = v4;  //    1
-                    m_leftArray[1] = v2;  //  2
-                    m_leftArray[2] = v1;  //    4
-                    m_leftSection = 2;
-                } else {
-                    m_leftArray[0] = v4;  //    1
-                    m_leftArray[1] = v3;  //  2
-                    m_leftArray[2] = v2;  //  3
-                    m_leftArray[3] = v1;  //     4
-                    m_leftSection = 3;
-                }
-            }
-        }
-    }
-
-    while (leftSectionShadeTextured4() <= 0) {
-        if (--m_leftSection <= 0) break;
-    }
-
-    while (rightSectionShadeTextured4() <= 0) {
-        if (--m_rightSection <= 0) break;
-    }
-
-    m_yMin = v1->y;
-    m_yMax = std::min(v4->y - 1, m_drawH);
-
-    return true;
-}
-
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-// POLY FUNCS
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////
-
-////////////////////////////////////////////////////////////////////////
-// POLY 3/4 FLAT SHADED
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly3Fi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int32_t rgb) {
-    int i, j, xmin, xmax, ymin, ymax;
-    uint16_t color;
-    uint32_t lcolor;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawW = m_drawW;
-    const auto drawH = m_drawH;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlat3(x1, y1, x2, y2, x3, y3)) return;
-
-    ymax = m_yMax;
-
-    color = ((rgb & 0x00f80000) >> 9) | ((rgb & 0x0000f800) >> 6) | ((rgb & 0x000000f8) >> 3);
-    lcolor = m_setMask32 | (((uint32_t)(color)) << 16) | color;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlat3()) return;
-    }
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        color |= m_setMask16;
-        for (i = ymin; i <= ymax; i++) {
-            xmin = m_leftX >> 16;
-            if (drawX > xmin) xmin = drawX;
-            xmax = (m_rightX >> 16) - 1;
-            if (drawW < xmax) xmax = drawW;
-
-            for (j = xmin; j < xmax; j += 2) {
-                *((uint32_t *)&vram16[(i << 10) + j]) = lcolor;
-            }
-            if (j == xmax) vram16[(i << 10) + j] = color;
-
-            if (nextRowFlat3()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = m_leftX >> 16;
-        if (drawX > xmin) xmin = drawX;
-        xmax = (m_rightX >> 16) - 1;
-        if (drawW < xmax) xmax = drawW;
-
-        for (j = xmin; j < xmax; j += 2) {
-            getShadeTransCol32((uint32_t *)&vram16[(i << 10) + j], lcolor);
-        }
-        if (j == xmax) getShadeTransCol(&vram16[(i << 10) + j], color);
-
-        if (nextRowFlat3()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPolyFlat3(int32_t rgb) { drawPoly3Fi(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb); }
-
-void PCSX::SoftGPU::SoftRenderer::drawPolyFlat4(int32_t rgb) {
-    drawPoly3Fi(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb);
-    drawPoly3Fi(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb);
+void PCSX::SoftGPU::SoftRenderer::drawPolyFlat4(int32_t rgb) {
+    drawPoly3Fi(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb);
+    drawPoly3Fi(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb);
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -2500,686 +2014,20 @@ void PCSX::SoftGPU::SoftRenderer::drawPolyFlat4(int32_t rgb) {
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                 int16_t ty3, int16_t clX, int16_t clY) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, XAdjust;
-    int32_t clutP;
-    int16_t tC1, tC2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawW = m_drawW;
-    const auto drawH = m_drawH;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured3()) return;
-    }
-
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0 >> 1);
-
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16);  //-1; //!!!!!!!!!!!!!!!!
-            if (xmax > xmin) xmax--;
-
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-
-                for (j = xmin; j < xmax; j += 2) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    XAdjust = ((posX + difX) >> 16) & maskX;
-                    tC2 =
-                        vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                    getTextureTransColShade32Solid(pdest, color);
-
-                    posX += difX2;
-                    posY += difY2;
-                }
-                if (j == xmax) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-                }
-            }
-            if (nextRowFlatTextured3()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-
-            for (j = xmin; j < xmax; j += 2) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                XAdjust = ((posX + difX) >> 16) & maskX;
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
-
-                posX += difX2;
-                posY += difY2;
-            }
-            if (j == xmax) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-            }
-        }
-        if (nextRowFlatTextured3()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                int16_t clX, int16_t clY) {
-    int32_t num;
-    int32_t i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP, XAdjust;
-    int16_t tC1, tC2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured4()) return;
-    }
-
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0 >> 1);
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16);
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                num = (xmax - xmin);
-                if (num == 0) num = 1;
-                difX = (m_rightU - posX) / num;
-                difY = (m_rightV - posY) / num;
-                difX2 = difX << 1;
-                difY2 = difY << 1;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-                xmax--;
-                if (drawW < xmax) xmax = drawW;
-
-                for (j = xmin; j < xmax; j += 2) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    XAdjust = ((posX + difX) >> 16) & maskX;
-                    tC2 =
-                        vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                    getTextureTransColShade32Solid(pdest, color);
-                    posX += difX2;
-                    posY += difY2;
-                }
-                if (j == xmax) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-                }
-            }
-            if (nextRowFlatTextured4()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16);
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            num = (xmax - xmin);
-            if (num == 0) num = 1;
-            difX = (m_rightU - posX) / num;
-            difY = (m_rightV - posY) / num;
-            difX2 = difX << 1;
-            difY2 = difY << 1;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-            xmax--;
-            if (drawW < xmax) xmax = drawW;
-
-            for (j = xmin; j < xmax; j += 2) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                XAdjust = ((posX + difX) >> 16) & maskX;
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
-                posX += difX2;
-                posY += difY2;
-            }
-            if (j == xmax) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-            }
-        }
-        if (nextRowFlatTextured4()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
-                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
-                                                  int16_t ty4, int16_t clX, int16_t clY) {
-    int32_t num;
-    int32_t i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP, XAdjust;
-    int16_t tC1, tC2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured4()) return;
-    }
-
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0 >> 1);
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16);
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                num = (xmax - xmin);
-                if (num == 0) num = 1;
-                difX = (m_rightU - posX) / num;
-                difY = (m_rightV - posY) / num;
-                difX2 = difX << 1;
-                difY2 = difY << 1;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-                xmax--;
-                if (drawW < xmax) xmax = drawW;
-
-                for (j = xmin; j < xmax; j += 2) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    XAdjust = ((posX + difX) >> 16) & maskX;
-                    tC2 =
-                        vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                    getTextureTransColShade32Solid(pdest, color);
-                    posX += difX2;
-                    posY += difY2;
-                }
-                if (j == xmax) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-                }
-            }
-            if (nextRowFlatTextured4()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16);
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            num = (xmax - xmin);
-            if (num == 0) num = 1;
-            difX = (m_rightU - posX) / num;
-            difY = (m_rightV - posY) / num;
-            difX2 = difX << 1;
-            difY2 = difY << 1;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-            xmax--;
-            if (drawW < xmax) xmax = drawW;
-
-            for (j = xmin; j < xmax; j += 2) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                XAdjust = ((posX + difX) >> 16) & maskX;
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-
-                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColG32Semi(pdest, color);
-                posX += difX2;
-                posY += difY2;
-            }
-            if (j == xmax) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                getTextureTransColShadeSemi(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-            }
-        }
-        if (nextRowFlatTextured4()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                int16_t ty3, int16_t clX, int16_t clY) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP;
-    int16_t tC1, tC2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured3()) return;
-    }
-
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0);
-
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16);  //-1; //!!!!!!!!!!!!!!!!
-            if (xmax > xmin) xmax--;
-
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-
-                for (j = xmin; j < xmax; j += 2) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    (((posX + difX) >> 16) & maskX))];
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                    getTextureTransColShade32Solid(pdest, color);
-                    posX += difX2;
-                    posY += difY2;
-                }
-
-                if (j == xmax) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-                }
-            }
-            if (nextRowFlatTextured3()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-
-            for (j = xmin; j < xmax; j += 2) {
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                (((posX + difX) >> 16) & maskX))];
-                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
-                posX += difX2;
-                posY += difY2;
-            }
-
-            if (j == xmax) {
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-            }
-        }
-        if (nextRowFlatTextured3()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                int16_t clX, int16_t clY) {
-    int32_t num;
-    int32_t i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP;
-    int16_t tC1, tC2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured4()) return;
-    }
-
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0);
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16);
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                num = (xmax - xmin);
-                if (num == 0) num = 1;
-                difX = (m_rightU - posX) / num;
-                difY = (m_rightV - posY) / num;
-                difX2 = difX << 1;
-                difY2 = difY << 1;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-                xmax--;
-                if (drawW < xmax) xmax = drawW;
-
-                for (j = xmin; j < xmax; j += 2) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    (((posX + difX) >> 16) & maskX))];
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                    getTextureTransColShade32Solid(pdest, color);
-                    posX += difX2;
-                    posY += difY2;
-                }
-                if (j == xmax) {
-                    tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    ((posX >> 16) & maskX))];
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-                }
-            }
-            if (nextRowFlatTextured4()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16);
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            num = (xmax - xmin);
-            if (num == 0) num = 1;
-            difX = (m_rightU - posX) / num;
-            difY = (m_rightV - posY) / num;
-            difX2 = difX << 1;
-            difY2 = difY << 1;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-            xmax--;
-            if (drawW < xmax) xmax = drawW;
-
-            for (j = xmin; j < xmax; j += 2) {
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                (((posX + difX) >> 16) & maskX))];
-                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColShade32(pdest, color);
-                posX += difX2;
-                posY += difY2;
-            }
-            if (j == xmax) {
-                tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                ((posX >> 16) & maskX))];
-                getTextureTransColShade(&vram16[(i << 10) + j], vram16[clutP + tC1]);
-            }
-        }
-        if (nextRowFlatTextured4()) return;
-    }
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, 0}, {x2, y2, tx2, ty2, 0}, {x3, y3, tx3, ty3, 0}};
+    drawTriangle<TextureMode::Clut4, false>(vertices, clX, clY);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
-                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
-                                                  int16_t ty4, int16_t clX, int16_t clY) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP;
-    int16_t tC1, tC2;
+    int32_t posX, posY;
 
     const auto drawX = m_drawX;
     const auto drawY = m_drawY;
@@ -3201,15 +2049,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_
         if (nextRowFlatTextured4()) return;
     }
 
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0);
-
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
+    const auto sampler = textureSampler<TextureMode::Clut4>(clX, clY);
 
     if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
@@ -3237,19 +2078,15 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_
                 if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    (((posX + difX) >> 16) & maskX))];
                     uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
+                    const uint32_t color = sampler.clut4(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.clut4((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
                     getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
                 }
                 if (j == xmax) {
-                    tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    ((posX >> 16) & maskX))];
-                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], sampler.clut4(posX >> 16, posY >> 16));
                 }
             }
             if (nextRowFlatTextured4()) return;
@@ -3282,156 +2119,27 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_
             if (drawW < xmax) xmax = drawW;
 
             for (j = xmin; j < xmax; j += 2) {
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                (((posX + difX) >> 16) & maskX))];
                 uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                uint32_t color = vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16;
-                getTextureTransColG32Semi(pdest, color);
+                const uint32_t color = sampler.clut4(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.clut4((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColShade32(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
             if (j == xmax) {
-                tC1 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                ((posX >> 16) & maskX))];
-                getTextureTransColShadeSemi(&vram16[(i << 10) + j], vram16[clutP + tC1]);
+                getTextureTransColShade(&vram16[(i << 10) + j], sampler.clut4(posX >> 16, posY >> 16));
             }
         }
         if (nextRowFlatTextured4()) return;
     }
 }
 
-////////////////////////////////////////////////////////////////////////
-// POLY 3 F-SHADED TEX 15 BIT
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                              int16_t ty3) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsFlatTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowFlatTextured3()) return;
-    }
-
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
-
-    if (!m_checkMask && !m_drawSemiTrans) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                posX = m_leftU;
-                posY = m_leftV;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    posX += j * difX;
-                    posY += j * difY;
-                }
-
-                for (j = xmin; j < xmax; j += 2) {
-                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
-                    auto upX = (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0;
-                    auto upY = (((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0;
-                    auto dnX = ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0;
-                    auto dnY = ((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0;
-                    uint32_t color = vram16[upX + (upY << 10)];
-                    color <<= 16;
-                    color |= vram16[dnX + (dnY << 10)];
-                    getTextureTransColShade32Solid(pdest, color);
-
-                    posX += difX2;
-                    posY += difY2;
-                }
-                if (j == xmax) {
-                    uint16_t *pdest = &vram16[(i << 10) + j];
-                    auto x = ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0;
-                    auto y = ((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0;
-                    uint16_t color = vram16[x + (y << 10)];
-                    getTextureTransColShadeSolid(pdest, color);
-                }
-            }
-            if (nextRowFlatTextured3()) return;
-        }
-        return;
-    }
-
-    for (i = ymin; i <= ymax; i++) {
-        xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
-
-        if (xmax >= xmin) {
-            posX = m_leftU;
-            posY = m_leftV;
-
-            if (xmin < drawX) {
-                j = drawX - xmin;
-                xmin = drawX;
-                posX += j * difX;
-                posY += j * difY;
-            }
-
-            for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColShade32(
-                    (uint32_t *)&vram16[(i << 10) + j],
-                    (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                      (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                     << 16) |
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               (((posX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-
-                posX += difX2;
-                posY += difY2;
-            }
-            if (j == xmax) {
-                getTextureTransColShade(&vram16[(i << 10) + j],
-                                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-            }
-        }
-        if (nextRowFlatTextured3()) return;
-    }
-}
-
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                              int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx4_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                  int16_t ty4, int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3457,13 +2165,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
         if (nextRowFlatTextured4()) return;
     }
 
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
+    const auto sampler = textureSampler<TextureMode::Clut4>(clX, clY);
 
     if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
@@ -3491,23 +2194,15 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
                 if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    getTextureTransColShade32Solid(
-                        (uint32_t *)&vram16[(i << 10) + j],
-                        (((int32_t)
-                              vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                     (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                         << 16) |
-                            vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                   ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-
+                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                    const uint32_t color = sampler.clut4(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.clut4((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                    getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
                 }
                 if (j == xmax) {
-                    getTextureTransColShadeSolid(
-                        &vram16[(i << 10) + j],
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], sampler.clut4(posX >> 16, posY >> 16));
                 }
             }
             if (nextRowFlatTextured4()) return;
@@ -3540,21 +2235,15 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
             if (drawW < xmax) xmax = drawW;
 
             for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColShade32(
-                    (uint32_t *)&vram16[(i << 10) + j],
-                    (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                      (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                     << 16) |
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-
+                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                const uint32_t color = sampler.clut4(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.clut4((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColG32Semi(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
             if (j == xmax) {
-                getTextureTransColShade(&vram16[(i << 10) + j],
-                                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                getTextureTransColShadeSemi(&vram16[(i << 10) + j], sampler.clut4(posX >> 16, posY >> 16));
             }
         }
         if (nextRowFlatTextured4()) return;
@@ -3563,9 +2252,19 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2
 
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                int16_t ty3, int16_t clX, int16_t clY) {
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, 0}, {x2, y2, tx2, ty2, 0}, {x3, y3, tx3, ty3, 0}};
+    drawTriangle<TextureMode::Clut8, false>(vertices, clX, clY);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                int16_t clX, int16_t clY) {
     int32_t num;
     int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
@@ -3591,13 +2290,8 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
         if (nextRowFlatTextured4()) return;
     }
 
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
+    const auto sampler = textureSampler<TextureMode::Clut8>(clX, clY);
 
     if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
@@ -3625,23 +2319,16 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
                 if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    getTextureTransColShade32Solid(
-                        (uint32_t *)&vram16[(i << 10) + j],
-                        (((int32_t)
-                              vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                     (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                         << 16) |
-                            vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                   ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-
+                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                    const uint32_t color = sampler.clut8(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.clut8((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                    getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
                 }
                 if (j == xmax) {
-                    getTextureTransColShadeSolid(
-                        &vram16[(i << 10) + j],
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j],
+                                                 sampler.clut8(posX >> 16, (posY + difY) >> 16));
                 }
             }
             if (nextRowFlatTextured4()) return;
@@ -3674,576 +2361,271 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t
             if (drawW < xmax) xmax = drawW;
 
             for (j = xmin; j < xmax; j += 2) {
-                getTextureTransColG32Semi(
-                    (uint32_t *)&vram16[(i << 10) + j],
-                    (((int32_t)vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                      (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                     << 16) |
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
-
+                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                const uint32_t color = sampler.clut8(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.clut8((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColShade32(pdest, color);
                 posX += difX2;
                 posY += difY2;
             }
             if (j == xmax) {
-                getTextureTransColShadeSemi(
-                    &vram16[(i << 10) + j],
-                    vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                           ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0]);
+                getTextureTransColShade(&vram16[(i << 10) + j], sampler.clut8(posX >> 16, (posY + difY) >> 16));
             }
         }
         if (nextRowFlatTextured4()) return;
     }
 }
 
-////////////////////////////////////////////////////////////////////////
-// POLY 3/4 G-SHADED
-////////////////////////////////////////////////////////////////////////
-
-template <bool useCachedDither>
-void PCSX::SoftGPU::SoftRenderer::drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                              int32_t rgb1, int32_t rgb2, int32_t rgb3) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t cR1, cG1, cB1;
-    int32_t difR, difB, difG, difR2, difB2, difG2;
-
-    const auto drawX = m_drawX;
-    const auto drawY = m_drawY;
-    const auto drawH = m_drawH;
-    const auto drawW = m_drawW;
-
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
-    if (drawY >= drawH) return;
-    if (drawX >= drawW) return;
-
-    if (!setupSectionsShade3(x1, y1, x2, y2, x3, y3, rgb1, rgb2, rgb3)) return;
-
-    ymax = m_yMax;
-
-    for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowShade3()) return;
-    }
-
-    difR = m_deltaRightR;
-    difG = m_deltaRightG;
-    difB = m_deltaRightB;
-    difR2 = difR << 1;
-    difG2 = difG << 1;
-    difB2 = difB << 1;
-
-    const auto vram = m_vram;
-    const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
-    const auto setMask16 = m_setMask16;
-    const auto setMask32 = m_setMask32;
-
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
-                }
-
-                for (j = xmin; j < xmax; j += 2) {
-                    *((uint32_t *)&vram16[(i << 10) + j]) =
-                        ((((cR1 + difR) << 7) & 0x7c000000) | (((cG1 + difG) << 2) & 0x03e00000) |
-                         (((cB1 + difB) >> 3) & 0x001f0000) | (((cR1) >> 9) & 0x7c00) | (((cG1) >> 14) & 0x03e0) |
-                         (((cB1) >> 19) & 0x001f)) |
-                        setMask32;
-
-                    cR1 += difR2;
-                    cG1 += difG2;
-                    cB1 += difB2;
-                }
-                if (j == xmax) {
-                    vram16[(i << 10) + j] =
-                        (((cR1 >> 9) & 0x7c00) | ((cG1 >> 14) & 0x03e0) | ((cB1 >> 19) & 0x001f)) | setMask16;
-                }
-            }
-            if (nextRowShade3()) return;
-        }
-        return;
-    }
-
-    if (m_ditherMode) {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
-                }
-
-                for (j = xmin; j <= xmax; j++) {
-                    getShadeTransColDither<useCachedDither>(&vram16[(i << 10) + j], (cB1 >> 16), (cG1 >> 16),
-                                                            (cR1 >> 16));
-
-                    cR1 += difR;
-                    cG1 += difG;
-                    cB1 += difB;
-                }
-            }
-            if (nextRowShade3()) return;
-        }
-    } else {
-        for (i = ymin; i <= ymax; i++) {
-            xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;
-            if (drawW < xmax) xmax = drawW;
-
-            if (xmax >= xmin) {
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
-
-                if (xmin < drawX) {
-                    j = drawX - xmin;
-                    xmin = drawX;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
-                }
-
-                for (j = xmin; j <= xmax; j++) {
-                    getShadeTransCol(&vram16[(i << 10) + j],
-                                     ((cR1 >> 9) & 0x7c00) | ((cG1 >> 14) & 0x03e0) | ((cB1 >> 19) & 0x001f));
-
-                    cR1 += difR;
-                    cG1 += difG;
-                    cB1 += difB;
-                }
-            }
-            if (nextRowShade3()) return;
-        }
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPolyShade3(int32_t rgb1, int32_t rgb2, int32_t rgb3) {
-    if (s_ditherLUT) {
-        drawPoly3Gi<true>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    } else {
-        drawPoly3Gi<false>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    }
-}
-
-// draw two g-shaded tris for right psx shading emulation
-
-void PCSX::SoftGPU::SoftRenderer::drawPolyShade4(int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4) {
-    if (s_ditherLUT) {
-        drawPoly3Gi<true>(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb2, rgb4, rgb3);
-        drawPoly3Gi<true>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    } else {
-        drawPoly3Gi<false>(m_x1, m_y1, m_x3, m_y3, m_x2, m_y2, rgb2, rgb4, rgb3);
-        drawPoly3Gi<false>(m_x0, m_y0, m_x1, m_y1, m_x2, m_y2, rgb1, rgb2, rgb3);
-    }
-}
-
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
-                                                  int16_t tx3, int16_t ty3, int16_t clX, int16_t clY, int32_t col1,
-                                                  int32_t col2, int32_t col3) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t cR1, cG1, cB1;
-    int32_t difR, difB, difG, difR2, difB2, difG2;
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TEx8_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
+                                                  int16_t y3, int16_t x4, int16_t y4, int16_t tx1, int16_t ty1,
+                                                  int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
+                                                  int16_t ty4, int16_t clX, int16_t clY) {
+    int32_t num;
+    int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP, XAdjust;
-    int16_t tC1, tC2;
+    int32_t posX, posY;
 
     const auto drawX = m_drawX;
     const auto drawY = m_drawY;
     const auto drawH = m_drawH;
     const auto drawW = m_drawW;
 
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
+    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
+    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
+    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
+    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
     if (drawY >= drawH) return;
     if (drawX >= drawW) return;
 
-    if (!setupSectionsShadeTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3)) return;
+    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
 
     ymax = m_yMax;
 
     for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowShadeTextured3()) return;
+        if (nextRowFlatTextured4()) return;
     }
 
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0 >> 1);
-
-    difR = m_deltaRightR;
-    difG = m_deltaRightG;
-    difB = m_deltaRightB;
-    difR2 = difR << 1;
-    difG2 = difG << 1;
-    difB2 = difB << 1;
-
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
-    const auto setMask16 = m_setMask16;
-    const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
+    const auto sampler = textureSampler<TextureMode::Clut8>(clX, clY);
 
-    if (!m_checkMask && !m_drawSemiTrans && !ditherMode) {
+    if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
-            xmin = ((m_leftX) >> 16);
-            xmax = ((m_rightX) >> 16) - 1;  //!!!!!!!!!!!!!
-            if (drawW < xmax) xmax = drawW;
+            xmin = (m_leftX >> 16);
+            xmax = (m_rightX >> 16);
 
             if (xmax >= xmin) {
                 posX = m_leftU;
                 posY = m_leftV;
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
+
+                num = (xmax - xmin);
+                if (num == 0) num = 1;
+                difX = (m_rightU - posX) / num;
+                difY = (m_rightV - posY) / num;
+                difX2 = difX << 1;
+                difY2 = difY << 1;
 
                 if (xmin < drawX) {
                     j = drawX - xmin;
                     xmin = drawX;
                     posX += j * difX;
                     posY += j * difY;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
                 }
+                xmax--;
+                if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    XAdjust = ((posX + difX) >> 16) & maskX;
-                    tC2 =
-                        vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC2 = (tC2 >> ((XAdjust & 1) << 2)) & 0xf;
-                    getTextureTransColShadeX32Solid(
-                        (uint32_t *)&vram16[(i << 10) + j], vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16,
-                        (cB1 >> 16) | ((cB1 + difB) & 0xff0000), (cG1 >> 16) | ((cG1 + difG) & 0xff0000),
-                        (cR1 >> 16) | ((cR1 + difR) & 0xff0000));
+                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                    const uint32_t color = sampler.clut8(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.clut8((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                    getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
-                    cR1 += difR2;
-                    cG1 += difG2;
-                    cB1 += difB2;
                 }
                 if (j == xmax) {
-                    XAdjust = (posX >> 16) & maskX;
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                    tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                    getTextureTransColShadeXSolid(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                                  (cR1 >> 16));
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j],
+                                                 sampler.clut8(posX >> 16, (posY + difY) >> 16));
                 }
             }
-            if (nextRowShadeTextured3()) return;
+            if (nextRowFlatTextured4()) return;
         }
         return;
     }
 
     for (i = ymin; i <= ymax; i++) {
         xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
+        xmax = (m_rightX >> 16);
 
         if (xmax >= xmin) {
             posX = m_leftU;
             posY = m_leftV;
-            cR1 = m_leftR;
-            cG1 = m_leftG;
-            cB1 = m_leftB;
+
+            num = (xmax - xmin);
+            if (num == 0) num = 1;
+            difX = (m_rightU - posX) / num;
+            difY = (m_rightV - posY) / num;
+            difX2 = difX << 1;
+            difY2 = difY << 1;
 
             if (xmin < drawX) {
                 j = drawX - xmin;
                 xmin = drawX;
                 posX += j * difX;
                 posY += j * difY;
-                cR1 += j * difR;
-                cG1 += j * difG;
-                cB1 += j * difB;
             }
+            xmax--;
+            if (drawW < xmax) xmax = drawW;
 
-            for (j = xmin; j <= xmax; j++) {
-                XAdjust = (posX >> 16) & maskX;
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + (XAdjust >> 1))];
-                tC1 = (tC1 >> ((XAdjust & 1) << 2)) & 0xf;
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(&vram16[(i << 10) + j], vram16[clutP + tC1],
-                                                                    (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
-                } else {
-                    getTextureTransColShadeX(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                             (cR1 >> 16));
-                }
-                posX += difX;
-                posY += difY;
-                cR1 += difR;
-                cG1 += difG;
-                cB1 += difB;
+            for (j = xmin; j < xmax; j += 2) {
+                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                const uint32_t color = sampler.clut8(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.clut8((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColG32Semi(pdest, color);
+                posX += difX2;
+                posY += difY2;
+            }
+            if (j == xmax) {
+                getTextureTransColShadeSemi(&vram16[(i << 10) + j], sampler.clut8(posX >> 16, (posY + difY) >> 16));
             }
         }
-        if (nextRowShadeTextured3()) return;
+        if (nextRowFlatTextured4()) return;
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+// POLY 3 F-SHADED TEX 15 BIT
 ////////////////////////////////////////////////////////////////////////
 
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                 int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
-                                                 int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx4i<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx4i<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    }
-}
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                 int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
-                                                 int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx4i<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx4i<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx4i<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx4i<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    }
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                              int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                              int16_t ty3) {
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, 0}, {x2, y2, tx2, ty2, 0}, {x3, y3, tx3, ty3, 0}};
+    drawTriangle<TextureMode::Direct, false>(vertices, 0, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3,
-                                                  int16_t y3, int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2,
-                                                  int16_t tx3, int16_t ty3, int16_t clX, int16_t clY, int32_t col1,
-                                                  int32_t col2, int32_t col3) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t cR1, cG1, cB1;
-    int32_t difR, difB, difG, difR2, difB2, difG2;
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                              int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                              int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+    int32_t num;
+    int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
-    int32_t posX, posY, YAdjust, clutP;
-    int16_t tC1, tC2;
+    int32_t posX, posY;
 
     const auto drawX = m_drawX;
     const auto drawY = m_drawY;
     const auto drawH = m_drawH;
     const auto drawW = m_drawW;
 
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
+    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
+    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
+    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
+    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
     if (drawY >= drawH) return;
     if (drawX >= drawW) return;
 
-    if (!setupSectionsShadeTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3)) return;
+    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
 
     ymax = m_yMax;
 
     for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowShadeTextured3()) return;
+        if (nextRowFlatTextured4()) return;
     }
 
-    clutP = (clY << 10) + clX;
-
-    YAdjust = ((m_globalTextAddrY) << 11) + (m_globalTextAddrX << 1);
-    YAdjust += (m_textureWindow.y0 << 11) + (m_textureWindow.x0);
-
-    difR = m_deltaRightR;
-    difG = m_deltaRightG;
-    difB = m_deltaRightB;
-    difR2 = difR << 1;
-    difG2 = difG << 1;
-    difB2 = difB << 1;
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
-    const auto setMask16 = m_setMask16;
-    const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
+    const auto sampler = textureSampler<TextureMode::Direct>(0, 0);
 
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
+    if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;  // !!!!!!!!!!!!!
-            if (drawW < xmax) xmax = drawW;
+            xmax = (m_rightX >> 16);
 
             if (xmax >= xmin) {
                 posX = m_leftU;
                 posY = m_leftV;
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
+
+                num = (xmax - xmin);
+                if (num == 0) num = 1;
+                difX = (m_rightU - posX) / num;
+                difY = (m_rightV - posY) / num;
+                difX2 = difX << 1;
+                difY2 = difY << 1;
 
                 if (xmin < drawX) {
                     j = drawX - xmin;
                     xmin = drawX;
                     posX += j * difX;
                     posY += j * difY;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
                 }
+                xmax--;
+                if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    tC2 = vram[static_cast<int32_t>(((((posY + difY) >> 16) & maskY) << 11) + YAdjust +
-                                                    (((posX + difX) >> 16) & maskX))];
-
-                    getTextureTransColShadeX32Solid(
-                        (uint32_t *)&vram16[(i << 10) + j], vram16[clutP + tC1] | ((int32_t)vram16[clutP + tC2]) << 16,
-                        (cB1 >> 16) | ((cB1 + difB) & 0xff0000), (cG1 >> 16) | ((cG1 + difG) & 0xff0000),
-                        (cR1 >> 16) | ((cR1 + difR) & 0xff0000));
+                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                    const uint32_t color = sampler.direct(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.direct((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                    getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
-                    cR1 += difR2;
-                    cG1 += difG2;
-                    cB1 += difB2;
                 }
                 if (j == xmax) {
-                    tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                    getTextureTransColShadeXSolid(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                                  (cR1 >> 16));
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], sampler.direct(posX >> 16, posY >> 16));
                 }
             }
-            if (nextRowShadeTextured3()) return;
+            if (nextRowFlatTextured4()) return;
         }
         return;
     }
 
     for (i = ymin; i <= ymax; i++) {
         xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
+        xmax = (m_rightX >> 16);
 
         if (xmax >= xmin) {
             posX = m_leftU;
             posY = m_leftV;
-            cR1 = m_leftR;
-            cG1 = m_leftG;
-            cB1 = m_leftB;
+
+            num = (xmax - xmin);
+            if (num == 0) num = 1;
+            difX = (m_rightU - posX) / num;
+            difY = (m_rightV - posY) / num;
+            difX2 = difX << 1;
+            difY2 = difY << 1;
 
             if (xmin < drawX) {
                 j = drawX - xmin;
                 xmin = drawX;
                 posX += j * difX;
                 posY += j * difY;
-                cR1 += j * difR;
-                cG1 += j * difG;
-                cB1 += j * difB;
             }
+            xmax--;
+            if (drawW < xmax) xmax = drawW;
 
-            for (j = xmin; j <= xmax; j++) {
-                tC1 = vram[static_cast<int32_t>((((posY >> 16) & maskY) << 11) + YAdjust + ((posX >> 16) & maskX))];
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(&vram16[(i << 10) + j], vram16[clutP + tC1],
-                                                                    (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
-                } else {
-                    getTextureTransColShadeX(&vram16[(i << 10) + j], vram16[clutP + tC1], (cB1 >> 16), (cG1 >> 16),
-                                             (cR1 >> 16));
-                }
-                posX += difX;
-                posY += difY;
-                cR1 += difR;
-                cG1 += difG;
-                cB1 += difB;
+            for (j = xmin; j < xmax; j += 2) {
+                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                const uint32_t color = sampler.direct(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.direct((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColShade32(pdest, color);
+                posX += difX2;
+                posY += difY2;
+            }
+            if (j == xmax) {
+                getTextureTransColShade(&vram16[(i << 10) + j], sampler.direct(posX >> 16, posY >> 16));
             }
         }
-        if (nextRowShadeTextured3()) return;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                 int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
-                                                 int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx8i<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx8i<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, clX, clY, col1, col2, col3);
-    }
-}
-
-void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
-                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
-                                                 int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
-                                                 int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGEx8i<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx8i<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
-    } else {
-        drawPoly3TGEx8i<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, clX, clY, col2, col4, col3);
-        drawPoly3TGEx8i<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, clX, clY, col1, col2, col3);
+        if (nextRowFlatTextured4()) return;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////
 
-template <bool useCachedDither>
-void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
-                                                int16_t ty3, int32_t col1, int32_t col2, int32_t col3) {
-    int i, j, xmin, xmax, ymin, ymax;
-    int32_t cR1, cG1, cB1;
-    int32_t difR, difB, difG, difR2, difB2, difG2;
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4) {
+    int32_t num;
+    int32_t i, j, xmin, xmax, ymin, ymax;
     int32_t difX, difY, difX2, difY2;
     int32_t posX, posY;
 
@@ -4252,166 +2634,183 @@ void PCSX::SoftGPU::SoftRenderer::drawPoly3TGDi(int16_t x1, int16_t y1, int16_t
     const auto drawH = m_drawH;
     const auto drawW = m_drawW;
 
-    if (x1 > drawW && x2 > drawW && x3 > drawW) return;
-    if (y1 > drawH && y2 > drawH && y3 > drawH) return;
-    if (x1 < drawX && x2 < drawX && x3 < drawX) return;
-    if (y1 < drawY && y2 < drawY && y3 < drawY) return;
+    if (x1 > drawW && x2 > drawW && x3 > drawW && x4 > drawW) return;
+    if (y1 > drawH && y2 > drawH && y3 > drawH && y4 > drawH) return;
+    if (x1 < drawX && x2 < drawX && x3 < drawX && x4 < drawX) return;
+    if (y1 < drawY && y2 < drawY && y3 < drawY && y4 < drawY) return;
     if (drawY >= drawH) return;
     if (drawX >= drawW) return;
 
-    if (!setupSectionsShadeTextured3(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3)) return;
+    if (!setupSectionsFlatTextured4(x1, y1, x2, y2, x3, y3, x4, y4, tx1, ty1, tx2, ty2, tx3, ty3, tx4, ty4)) return;
 
     ymax = m_yMax;
 
     for (ymin = m_yMin; ymin < drawY; ymin++) {
-        if (nextRowShadeTextured3()) return;
+        if (nextRowFlatTextured4()) return;
     }
 
-    difR = m_deltaRightR;
-    difG = m_deltaRightG;
-    difB = m_deltaRightB;
-    difR2 = difR << 1;
-    difG2 = difG << 1;
-    difB2 = difB << 1;
-    difX = m_deltaRightU;
-    difX2 = difX << 1;
-    difY = m_deltaRightV;
-    difY2 = difY << 1;
-
-    const auto vram = m_vram;
     const auto vram16 = m_vram16;
-    const auto maskX = m_textureWindow.x1 - 1;
-    const auto maskY = m_textureWindow.y1 - 1;
-    const auto globalTextAddrX = m_globalTextAddrX;
-    const auto globalTextAddrY = m_globalTextAddrY;
-    const auto textureWindow = m_textureWindow;
-    const auto setMask16 = m_setMask16;
-    const auto setMask32 = m_setMask32;
-    const auto ditherMode = m_ditherMode;
+    const auto sampler = textureSampler<TextureMode::Direct>(0, 0);
 
-    if (!m_checkMask && !m_drawSemiTrans && !m_ditherMode) {
+    if (!m_checkMask && !m_drawSemiTrans) {
         for (i = ymin; i <= ymax; i++) {
             xmin = (m_leftX >> 16);
-            xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!!!!
-            if (drawW < xmax) xmax = drawW;
+            xmax = (m_rightX >> 16);
 
             if (xmax >= xmin) {
                 posX = m_leftU;
                 posY = m_leftV;
-                cR1 = m_leftR;
-                cG1 = m_leftG;
-                cB1 = m_leftB;
+
+                num = (xmax - xmin);
+                if (num == 0) num = 1;
+                difX = (m_rightU - posX) / num;
+                difY = (m_rightV - posY) / num;
+                difX2 = difX << 1;
+                difY2 = difY << 1;
 
                 if (xmin < drawX) {
                     j = drawX - xmin;
                     xmin = drawX;
                     posX += j * difX;
                     posY += j * difY;
-                    cR1 += j * difR;
-                    cG1 += j * difG;
-                    cB1 += j * difB;
                 }
+                xmax--;
+                if (drawW < xmax) xmax = drawW;
 
                 for (j = xmin; j < xmax; j += 2) {
-                    getTextureTransColShadeX32Solid(
-                        (uint32_t *)&vram16[(i << 10) + j],
-                        (((int32_t)
-                              vram16[(((((posY + difY) >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                     (((posX + difX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0])
-                         << 16) |
-                            vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                                   (((posX) >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
-                        (cB1 >> 16) | ((cB1 + difB) & 0xff0000), (cG1 >> 16) | ((cG1 + difG) & 0xff0000),
-                        (cR1 >> 16) | ((cR1 + difR) & 0xff0000));
+                    uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                    const uint32_t color = sampler.direct(posX >> 16, posY >> 16) |
+                                           uint32_t(sampler.direct((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                    getTextureTransColShade32Solid(pdest, color);
                     posX += difX2;
                     posY += difY2;
-                    cR1 += difR2;
-                    cG1 += difG2;
-                    cB1 += difB2;
                 }
                 if (j == xmax) {
-                    getTextureTransColShadeXSolid(
-                        &vram16[(i << 10) + j],
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
-                        (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
+                    getTextureTransColShadeSolid(&vram16[(i << 10) + j], sampler.direct(posX >> 16, posY >> 16));
                 }
             }
-            if (nextRowShadeTextured3()) return;
+            if (nextRowFlatTextured4()) return;
         }
         return;
     }
 
     for (i = ymin; i <= ymax; i++) {
         xmin = (m_leftX >> 16);
-        xmax = (m_rightX >> 16) - 1;  //!!!!!!!!!!!!!!!!!!
-        if (drawW < xmax) xmax = drawW;
+        xmax = (m_rightX >> 16);
 
         if (xmax >= xmin) {
             posX = m_leftU;
             posY = m_leftV;
-            cR1 = m_leftR;
-            cG1 = m_leftG;
-            cB1 = m_leftB;
+
+            num = (xmax - xmin);
+            if (num == 0) num = 1;
+            difX = (m_rightU - posX) / num;
+            difY = (m_rightV - posY) / num;
+            difX2 = difX << 1;
+            difY2 = difY << 1;
 
             if (xmin < drawX) {
                 j = drawX - xmin;
                 xmin = drawX;
                 posX += j * difX;
                 posY += j * difY;
-                cR1 += j * difR;
-                cG1 += j * difG;
-                cB1 += j * difB;
             }
+            xmax--;
+            if (drawW < xmax) xmax = drawW;
 
-            for (j = xmin; j <= xmax; j++) {
-                if (ditherMode) {
-                    getTextureTransColShadeXDither<useCachedDither>(
-                        &vram16[(i << 10) + j],
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
-                        (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
-                } else {
-                    getTextureTransColShadeX(
-                        &vram16[(i << 10) + j],
-                        vram16[((((posY >> 16) & maskY) + globalTextAddrY + textureWindow.y0) << 10) +
-                               ((posX >> 16) & maskX) + globalTextAddrX + textureWindow.x0],
-                        (cB1 >> 16), (cG1 >> 16), (cR1 >> 16));
-                }
-                posX += difX;
-                posY += difY;
-                cR1 += difR;
-                cG1 += difG;
-                cB1 += difB;
+            for (j = xmin; j < xmax; j += 2) {
+                uint32_t *pdest = (uint32_t *)&vram16[(i << 10) + j];
+                const uint32_t color = sampler.direct(posX >> 16, posY >> 16) |
+                                       uint32_t(sampler.direct((posX + difX) >> 16, (posY + difY) >> 16)) << 16;
+                getTextureTransColG32Semi(pdest, color);
+                posX += difX2;
+                posY += difY2;
+            }
+            if (j == xmax) {
+                getTextureTransColShadeSemi(&vram16[(i << 10) + j], sampler.direct(posX >> 16, posY >> 16));
             }
         }
-        if (nextRowShadeTextured3()) return;
+        if (nextRowFlatTextured4()) return;
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+// POLY 3/4 G-SHADED
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPolyShade3(int32_t rgb1, int32_t rgb2, int32_t rgb3) {
+    const TriangleVertex vertices[3] = {{m_x0, m_y0, 0, 0, rgb1}, {m_x1, m_y1, 0, 0, rgb2}, {m_x2, m_y2, 0, 0, rgb3}};
+    drawTriangle<TextureMode::None, true>(vertices, 0, 0);
+}
+
+// draw two g-shaded tris for right psx shading emulation
+
+void PCSX::SoftGPU::SoftRenderer::drawPolyShade4(int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4) {
+    const TriangleVertex first[3] = {{m_x1, m_y1, 0, 0, rgb2}, {m_x3, m_y3, 0, 0, rgb4}, {m_x2, m_y2, 0, 0, rgb3}};
+    const TriangleVertex second[3] = {{m_x0, m_y0, 0, 0, rgb1}, {m_x1, m_y1, 0, 0, rgb2}, {m_x2, m_y2, 0, 0, rgb3}};
+    drawTriangle<TextureMode::None, true>(first, 0, 0);
+    drawTriangle<TextureMode::None, true>(second, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                 int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
+                                                 int32_t col3) {
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col3}};
+    drawTriangle<TextureMode::Clut4, true>(vertices, clX, clY);
+}
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                 int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
+                                                 int32_t col4) {
+    const TriangleVertex first[3] = {{x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col4}, {x4, y4, tx4, ty4, col3}};
+    const TriangleVertex second[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x4, y4, tx4, ty4, col3}};
+    drawTriangle<TextureMode::Clut4, true>(first, clX, clY);
+    drawTriangle<TextureMode::Clut4, true>(second, clX, clY);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly3TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
+                                                 int16_t ty3, int16_t clX, int16_t clY, int32_t col1, int32_t col2,
+                                                 int32_t col3) {
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col3}};
+    drawTriangle<TextureMode::Clut8, true>(vertices, clX, clY);
+}
+
+void PCSX::SoftGPU::SoftRenderer::drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+                                                 int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
+                                                 int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
+                                                 int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3,
+                                                 int32_t col4) {
+    const TriangleVertex first[3] = {{x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col4}, {x4, y4, tx4, ty4, col3}};
+    const TriangleVertex second[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x4, y4, tx4, ty4, col3}};
+    drawTriangle<TextureMode::Clut8, true>(first, clX, clY);
+    drawTriangle<TextureMode::Clut8, true>(second, clX, clY);
+}
+
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SoftGPU::SoftRenderer::drawPoly3TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3,
                                                int16_t ty3, int32_t col1, int32_t col2, int32_t col3) {
-    if (s_ditherLUT) {
-        drawPoly3TGDi<true>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3);
-    } else {
-        drawPoly3TGDi<false>(x1, y1, x2, y2, x3, y3, tx1, ty1, tx2, ty2, tx3, ty3, col1, col2, col3);
-    }
+    const TriangleVertex vertices[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col3}};
+    drawTriangle<TextureMode::Direct, true>(vertices, 0, 0);
 }
 
 void PCSX::SoftGPU::SoftRenderer::drawPoly4TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
                                                int16_t x4, int16_t y4, int16_t tx1, int16_t ty1, int16_t tx2,
                                                int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4, int16_t ty4,
                                                int32_t col1, int32_t col2, int32_t col3, int32_t col4) {
-    if (s_ditherLUT) {
-        drawPoly3TGDi<true>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, col2, col4, col3);
-        drawPoly3TGDi<true>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, col1, col2, col3);
-    } else {
-        drawPoly3TGDi<false>(x2, y2, x3, y3, x4, y4, tx2, ty2, tx3, ty3, tx4, ty4, col2, col4, col3);
-        drawPoly3TGDi<false>(x1, y1, x2, y2, x4, y4, tx1, ty1, tx2, ty2, tx4, ty4, col1, col2, col3);
-    }
+    const TriangleVertex first[3] = {{x2, y2, tx2, ty2, col2}, {x3, y3, tx3, ty3, col4}, {x4, y4, tx4, ty4, col3}};
+    const TriangleVertex second[3] = {{x1, y1, tx1, ty1, col1}, {x2, y2, tx2, ty2, col2}, {x4, y4, tx4, ty4, col3}};
+    drawTriangle<TextureMode::Direct, true>(first, 0, 0);
+    drawTriangle<TextureMode::Direct, true>(second, 0, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////
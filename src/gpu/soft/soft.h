@@ -22,13 +22,13 @@
 #include <stdint.h>
 
 #include "core/gpu.h"
+#include "gpu/soft/spans.h"
 
 namespace PCSX {
 
 namespace SoftGPU {
 
 struct SoftRenderer {
-    ~SoftRenderer();
     inline void resetRenderer() {
         m_globalTextAddrX = 0;
         m_globalTextAddrY = 0;
@@ -42,6 +42,8 @@ struct SoftRenderer {
     }
 
     int m_useDither = 0;
+    // Whether dithering goes through the precomputed lookup table, rather than being computed for each pixel.
+    bool m_cachedDithering = false;
     bool m_disableTexturesInPolygons = false;
     bool m_disableTexturesInRectangles = false;
 
@@ -121,6 +123,11 @@ struct SoftRenderer {
 
     void fillSoftwareAreaTrans(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t col);
     void fillSoftwareArea(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t col);
+    // Fills and copies don't care about the drawing area, but these only touch the rows from m_drawY to m_drawH,
+    // so that the tiled rasterizer can hand out their bands like for the primitives. Exclusive ends, no wrapping,
+    // and the source of a copy can't overlap its destination.
+    void fillSoftwareAreaRows(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t col);
+    void copySoftwareAreaRows(int16_t sX, int16_t sY, int16_t dX, int16_t dY, int16_t w, int16_t h);
     void drawPolyShade3(int32_t rgb1, int32_t rgb2, int32_t rgb3);
     void drawPolyShade4(int32_t rgb1, int32_t rgb2, int32_t rgb3, int32_t rgb4);
     void drawPolyFlat3(int32_t rgb);
@@ -131,14 +138,6 @@ struct SoftRenderer {
     int16_t m_yMin;
     int16_t m_yMax;
 
-    bool setupSectionsFlat3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3);
-    bool setupSectionsShade3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int32_t rgb1,
-                             int32_t rgb2, int32_t rgb3);
-    bool setupSectionsFlatTextured3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
-                                    int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3);
-    bool setupSectionsShadeTextured3(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3,
-                                     int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3,
-                                     int32_t rgb1, int32_t rgb2, int32_t rgb3);
     bool setupSectionsFlat4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4,
                             int16_t y4);
     bool setupSectionsFlatTextured4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4,
@@ -189,32 +188,18 @@ struct SoftRenderer {
     void drawPoly4TD_S(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                        int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                        int16_t ty4);
-    template <bool useCachedDither>
-    void drawPoly3Gi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int32_t rgb1, int32_t rgb2,
-                     int32_t rgb3);
-    template <bool useCachedDither>
-    void drawPoly3TGEx4i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
-                         int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
-                         int32_t col1, int32_t col2, int32_t col3);
     void drawPoly3TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
                         int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
                         int32_t col1, int32_t col2, int32_t col3);
     void drawPoly4TGEx4(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                         int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                         int16_t ty4, int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3, int32_t col4);
-    template <bool useCachedDither>
-    void drawPoly3TGEx8i(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
-                         int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
-                         int32_t col1, int32_t col2, int32_t col3);
     void drawPoly3TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1,
                         int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t clX, int16_t clY,
                         int32_t col1, int32_t col2, int32_t col3);
     void drawPoly4TGEx8(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
                         int16_t tx1, int16_t ty1, int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int16_t tx4,
                         int16_t ty4, int16_t clX, int16_t clY, int32_t col1, int32_t col2, int32_t col3, int32_t col4);
-    template <bool useCachedDither>
-    void drawPoly3TGDi(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
-                       int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int32_t col1, int32_t col2, int32_t col3);
     void drawPoly3TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t tx1, int16_t ty1,
                       int16_t tx2, int16_t ty2, int16_t tx3, int16_t ty3, int32_t col1, int32_t col2, int32_t col3);
     void drawPoly4TGD(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, int16_t x4, int16_t y4,
@@ -236,19 +221,88 @@ struct SoftRenderer {
     void enableCachedDithering();
     void disableCachedDithering();
 
+    Spans::Blend spanBlend() const {
+        return {m_drawSemiTrans, static_cast<unsigned>(m_globalTextABR), m_checkMask, m_setMask32};
+    }
+
   private:
-    int rightSectionFlat3();
-    int leftSectionFlat3();
-    bool nextRowFlat3();
-    int rightSectionShade3();
-    int leftSectionShade3();
-    bool nextRowShade3();
-    int rightSectionFlatTextured3();
-    int leftSectionFlatTextured3();
-    bool nextRowFlatTextured3();
-    int rightSectionShadeTextured3();
-    int leftSectionShadeTextured3();
-    bool nextRowShadeTextured3();
+    enum class TextureMode { None, Clut4, Clut8, Direct };
+    // How texels get fetched for one primitive. The texture page, the offset of the texture window and the CLUT
+    // position are folded into a base address, and the size of the window into two masks, once per primitive,
+    // so that each fetch is a couple of ANDs and adds, without any branch.
+    struct TextureSampler {
+        const uint8_t *vram;
+        const uint16_t *vram16;
+        const uint16_t *clut;
+        int32_t maskU, maskV;
+        // In bytes for the CLUT textures, in pixels for the direct ones.
+        int32_t base;
+
+        uint16_t clut4(int32_t u, int32_t v) const {
+            u &= maskU;
+            const uint8_t pair = vram[((v & maskV) << 11) + base + (u >> 1)];
+            return clut[(pair >> ((u & 1) << 2)) & 0xf];
+        }
+        uint16_t clut8(int32_t u, int32_t v) const { return clut[vram[((v & maskV) << 11) + base + (u & maskU)]]; }
+        uint16_t direct(int32_t u, int32_t v) const { return vram16[((v & maskV) << 10) + base + (u & maskU)]; }
+        template <TextureMode texture>
+        uint16_t fetch(int32_t u, int32_t v) const {
+            if constexpr (texture == TextureMode::Clut4) {
+                return clut4(u, v);
+            } else if constexpr (texture == TextureMode::Clut8) {
+                return clut8(u, v);
+            } else {
+                return direct(u, v);
+            }
+        }
+    };
+    template <TextureMode texture>
+    TextureSampler textureSampler(int16_t clX, int16_t clY) const {
+        TextureSampler sampler;
+        sampler.vram = m_vram;
+        sampler.vram16 = m_vram16;
+        sampler.clut = m_vram16 + (clY << 10) + clX;
+        sampler.maskU = m_textureWindow.x1 - 1;
+        sampler.maskV = m_textureWindow.y1 - 1;
+        if constexpr (texture == TextureMode::Clut4) {
+            sampler.base = ((m_globalTextAddrY + m_textureWindow.y0) << 11) + (m_globalTextAddrX << 1) +
+                           (m_textureWindow.x0 >> 1);
+        } else if constexpr (texture == TextureMode::Clut8) {
+            sampler.base =
+                ((m_globalTextAddrY + m_textureWindow.y0) << 11) + (m_globalTextAddrX << 1) + m_textureWindow.x0;
+        } else {
+            sampler.base = ((m_globalTextAddrY + m_textureWindow.y0) << 10) + m_globalTextAddrX + m_textureWindow.x0;
+        }
+        return sampler;
+    }
+
+    // Mask bit checking as masks rather than branches: the bits to look at in the destination, and for a pair of
+    // pixels, which halves are left alone, as all ones. These are the pixels whose mask bit is set when checking
+    // it, and for textures, the transparent texels.
+    uint16_t checkMask16() const { return uint16_t(m_checkMask) << 15; }
+    uint32_t maskedKeep32(uint32_t dest) const {
+        return ((dest & (uint32_t(m_checkMask) * 0x80008000)) >> 15) * 0xffff;
+    }
+    static uint32_t transparentKeep32(uint32_t color) {
+        return (uint32_t((color & 0xffff) == 0) * 0x0000ffff) | (uint32_t((color & 0xffff0000) == 0) * 0xffff0000);
+    }
+    static uint32_t keepMasked32(uint32_t dest, uint32_t value, uint32_t keep) {
+        return (dest & keep) | (value & ~keep);
+    }
+
+    enum class TriangleDither { Off, On, Cached };
+    struct TriangleVertex {
+        int16_t x, y;
+        int16_t u, v;
+        int32_t rgb;
+    };
+    static constexpr int c_triangleBlock = 8;
+
+    template <TextureMode texture, bool shaded>
+    void drawTriangle(const TriangleVertex *vertices, int16_t clX, int16_t clY);
+    template <TextureMode texture, bool shaded, bool solid, TriangleDither dither>
+    void rasterizeTriangle(const TriangleVertex *vertices, int16_t clX, int16_t clY);
+
     int rightSectionFlat4();
     int leftSectionFlat4();
     int rightSectionFlatTextured4();
@@ -0,0 +1,573 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gpu/soft/spans.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define SPANS_X86
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SPANS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using PCSX::SoftGPU::Spans::Blend;
+using PCSX::SoftGPU::Spans::TexturedSpan;
+
+// The 4 semi transparency functions, plus plain opaque drawing
+constexpr unsigned c_opaque = 4;
+
+// Unpacking getShadeTransCol32, each 5-bit component d of the destination gets blended with the same component c
+// of the color this way, for the 4 functions: (d >> 1) + (c >> 1), min(d + c, 31), max(d - c, 0), min(d + c / 4, 31)
+// The subtractive one is odd in that it always uses the color's first pixel, even to blend the second one.
+// The term is what gets added to, or subtracted from, the destination component, so it can be computed only once.
+constexpr uint32_t blendTerm(uint32_t color, unsigned function) {
+    switch (function) {
+        case 0:
+            return color >> 1;
+        case 3:
+            return color >> 2;
+        default:
+            return color;
+    }
+}
+
+constexpr uint32_t blendComponent(uint32_t dest, uint32_t term, unsigned function) {
+    switch (function) {
+        case 0:
+            return (dest >> 1) + term;
+        case 2:
+            return dest > term ? dest - term : 0;
+        default:
+            return std::min(dest + term, uint32_t(0x1f));
+    }
+}
+
+// The terms of both pixels for one component, packed the same way as the pixels
+constexpr uint32_t blendTerms(uint32_t color, unsigned function, int shift) {
+    const uint32_t low = (color >> shift) & 0x1f;
+    const uint32_t high = function == 2 ? low : (color >> (shift + 16)) & 0x1f;
+    return blendTerm(low, function) | (blendTerm(high, function) << 16);
+}
+
+void flatSpanScalar(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend) {
+    const unsigned function = blend.semiTransparent ? blend.function : c_opaque;
+    const uint32_t terms[3] = {blendTerms(color, function, 0), blendTerms(color, function, 5),
+                               blendTerms(color, function, 10)};
+
+    for (unsigned i = 0; i < count; i++) {
+        uint32_t d;
+        std::memcpy(&d, dest + i, sizeof(d));
+        uint32_t out = color;
+        if (function != c_opaque) {
+            out = 0;
+            for (unsigned pixel = 0; pixel < 2; pixel++) {
+                const unsigned pixelShift = pixel * 16;
+                for (unsigned c = 0; c < 3; c++) {
+                    const unsigned shift = pixelShift + c * 5;
+                    const uint32_t component = blendComponent((d >> shift) & 0x1f, (terms[c] >> pixelShift) & 0x1f,
+                                                              function);
+                    out |= component << shift;
+                }
+            }
+        }
+        out |= blend.setMask32;
+        if (blend.checkMask) {
+            if (d & 0x80000000) out = (d & 0xffff0000) | (out & 0xffff);
+            if (d & 0x00008000) out = (d & 0xffff) | (out & 0xffff0000);
+        }
+        std::memcpy(dest + i, &out, sizeof(out));
+    }
+}
+
+// getShadeTransCol blends each pixel on its own, so there's none of the quirk above.
+void shadedSpanScalar(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend) {
+    const unsigned function = blend.semiTransparent ? blend.function : c_opaque;
+    const uint16_t setMask = blend.setMask32 & 0xffff;
+
+    for (unsigned i = 0; i < count; i++) {
+        const uint16_t d = dest[i];
+        if (blend.checkMask && (d & 0x8000)) continue;
+        const uint16_t color = colors[i];
+        uint16_t out = color;
+        if (function != c_opaque) {
+            out = 0;
+            for (unsigned shift = 0; shift < 15; shift += 5) {
+                const uint32_t term = blendTerm((color >> shift) & 0x1f, function);
+                out |= blendComponent((d >> shift) & 0x1f, term, function) << shift;
+            }
+        }
+        dest[i] = out | setMask;
+    }
+}
+
+// getTextureTransColShadeX works on the components where they sit in the pixel, so the rounding of the modulated
+// texel depends on which one it is: the red one gets truncated before being modulated for the quarter function,
+// and the subtraction rounds the green and blue ones up.
+constexpr uint32_t texturedComponent(uint32_t d, uint32_t c, uint32_t m, unsigned function, int shift) {
+    switch (function) {
+        case 0:
+            return std::min((d >> 1) + (((c >> 1) * m) >> 7), uint32_t(0x1f));
+        case 1:
+            return std::min(d + ((c * m) >> 7), uint32_t(0x1f));
+        case 2: {
+            const uint32_t x = d << shift;
+            const uint32_t t = ((c * m) << shift) >> 7;
+            return x > t ? (x - t) >> shift : 0;
+        }
+        case 3:
+            return std::min(d + (shift == 0 ? ((c >> 2) * m) >> 7 : (c * m) >> 9), uint32_t(0x1f));
+        default:
+            return std::min((c * m) >> 7, uint32_t(0x1f));
+    }
+}
+
+void texturedSpanScalar(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend) {
+    const uint16_t setMask = blend.setMask32 & 0xffff;
+
+    for (unsigned i = 0; i < count; i++) {
+        const uint16_t texel = span.texels[i];
+        if (texel == 0) continue;
+        const uint16_t d = dest[i];
+        if (blend.checkMask && (d & 0x8000)) continue;
+        // Only the texels with their top bit set get blended
+        const unsigned function = (blend.semiTransparent && (texel & 0x8000)) ? blend.function : c_opaque;
+        const uint32_t m[3] = {uint32_t(span.m1[i]), uint32_t(span.m2[i]), uint32_t(span.m3[i])};
+        uint16_t out = setMask | (texel & 0x8000);
+        for (unsigned c = 0; c < 3; c++) {
+            const int shift = c * 5;
+            out |= texturedComponent((d >> shift) & 0x1f, (texel >> shift) & 0x1f, m[c], function, shift) << shift;
+        }
+        dest[i] = out;
+    }
+}
+
+#if defined(SPANS_X86)
+// SSE2 is part of x86-64, so this one is always available
+template <unsigned function, int shift>
+__m128i blendComponentSSE2(__m128i dest, __m128i term) {
+    const __m128i mask = _mm_set1_epi16(0x1f);
+    const __m128i d = _mm_and_si128(_mm_srli_epi16(dest, shift), mask);
+    __m128i r;
+    if constexpr (function == 0) {
+        r = _mm_add_epi16(_mm_srli_epi16(d, 1), term);
+    } else if constexpr (function == 2) {
+        r = _mm_subs_epu16(d, term);
+    } else {
+        r = _mm_min_epi16(_mm_add_epi16(d, term), mask);
+    }
+    return _mm_slli_epi16(r, shift);
+}
+
+template <unsigned function>
+void flatSpanSSE2(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend) {
+    const __m128i terms[3] = {_mm_set1_epi32(blendTerms(color, function, 0)),
+                              _mm_set1_epi32(blendTerms(color, function, 5)),
+                              _mm_set1_epi32(blendTerms(color, function, 10))};
+    const __m128i setMask = _mm_set1_epi32(blend.setMask32);
+    const __m128i opaque = _mm_or_si128(_mm_set1_epi32(color), setMask);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+        __m128i out = opaque;
+        if constexpr (function != c_opaque) {
+            out = _mm_or_si128(blendComponentSSE2<function, 0>(d, terms[0]),
+                               blendComponentSSE2<function, 5>(d, terms[1]));
+            out = _mm_or_si128(out, blendComponentSSE2<function, 10>(d, terms[2]));
+            out = _mm_or_si128(out, setMask);
+        }
+        if (blend.checkMask) {
+            const __m128i keep = _mm_srai_epi16(d, 15);
+            out = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, out));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), out);
+    }
+    flatSpanScalar(dest + i, count - i, color, blend);
+}
+
+template <unsigned function, int shift>
+__m128i shadedTermSSE2(__m128i color) {
+    const __m128i c = _mm_and_si128(_mm_srli_epi16(color, shift), _mm_set1_epi16(0x1f));
+    if constexpr (function == 0) {
+        return _mm_srli_epi16(c, 1);
+    } else if constexpr (function == 3) {
+        return _mm_srli_epi16(c, 2);
+    } else {
+        return c;
+    }
+}
+
+template <unsigned function>
+void shadedSpanSSE2(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend) {
+    const __m128i setMask = _mm_set1_epi16(int16_t(blend.setMask32));
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+        __m128i out = c;
+        if constexpr (function != c_opaque) {
+            out = _mm_or_si128(blendComponentSSE2<function, 0>(d, shadedTermSSE2<function, 0>(c)),
+                               blendComponentSSE2<function, 5>(d, shadedTermSSE2<function, 5>(c)));
+            out = _mm_or_si128(out, blendComponentSSE2<function, 10>(d, shadedTermSSE2<function, 10>(c)));
+        }
+        out = _mm_or_si128(out, setMask);
+        if (blend.checkMask) {
+            const __m128i keep = _mm_srai_epi16(d, 15);
+            out = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, out));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), out);
+    }
+    shadedSpanScalar(dest + i, count - i, colors + i, blend);
+}
+
+// See texturedComponent for the rounding. The products of a component and its modulation fit in 13 bits.
+template <unsigned function, int shift>
+__m128i texturedComponentSSE2(__m128i dest, __m128i texel, __m128i m) {
+    const __m128i mask = _mm_set1_epi16(0x1f);
+    const __m128i d = _mm_and_si128(_mm_srli_epi16(dest, shift), mask);
+    const __m128i c = _mm_and_si128(_mm_srli_epi16(texel, shift), mask);
+    __m128i r;
+    if constexpr (function == 0) {
+        r = _mm_add_epi16(_mm_srli_epi16(d, 1), _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(c, 1), m), 7));
+    } else if constexpr (function == 1) {
+        r = _mm_add_epi16(d, _mm_srli_epi16(_mm_mullo_epi16(c, m), 7));
+    } else if constexpr (function == 2) {
+        const __m128i cm = _mm_mullo_epi16(c, m);
+        __m128i t;
+        if constexpr (shift > 7) {
+            t = _mm_slli_epi16(cm, shift - 7);
+        } else {
+            t = _mm_srli_epi16(cm, 7 - shift);
+        }
+        r = _mm_srli_epi16(_mm_subs_epu16(_mm_slli_epi16(d, shift), t), shift);
+    } else if constexpr (function == 3) {
+        if constexpr (shift == 0) {
+            r = _mm_add_epi16(d, _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(c, 2), m), 7));
+        } else {
+            r = _mm_add_epi16(d, _mm_srli_epi16(_mm_mullo_epi16(c, m), 9));
+        }
+    } else {
+        r = _mm_srli_epi16(_mm_mullo_epi16(c, m), 7);
+    }
+    return _mm_slli_epi16(_mm_min_epi16(r, mask), shift);
+}
+
+template <unsigned function>
+__m128i texturedPixelsSSE2(__m128i d, __m128i t, const __m128i m[3]) {
+    return _mm_or_si128(_mm_or_si128(texturedComponentSSE2<function, 0>(d, t, m[0]),
+                                     texturedComponentSSE2<function, 5>(d, t, m[1])),
+                        texturedComponentSSE2<function, 10>(d, t, m[2]));
+}
+
+template <unsigned function>
+void texturedSpanSSE2(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend) {
+    const __m128i setMask = _mm_set1_epi16(int16_t(blend.setMask32));
+    const __m128i topBit = _mm_set1_epi16(int16_t(0x8000));
+    const __m128i checkMask = _mm_set1_epi16(blend.checkMask ? -1 : 0);
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(span.texels + i));
+        const __m128i m[3] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(span.m1 + i)),
+                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(span.m2 + i)),
+                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(span.m3 + i))};
+        __m128i out = texturedPixelsSSE2<c_opaque>(d, t, m);
+        if constexpr (function != c_opaque) {
+            const __m128i semi = _mm_srai_epi16(t, 15);
+            out = _mm_or_si128(_mm_and_si128(semi, texturedPixelsSSE2<function>(d, t, m)), _mm_andnot_si128(semi, out));
+        }
+        out = _mm_or_si128(out, _mm_or_si128(setMask, _mm_and_si128(t, topBit)));
+        const __m128i keep =
+            _mm_or_si128(_mm_cmpeq_epi16(t, _mm_setzero_si128()), _mm_and_si128(_mm_srai_epi16(d, 15), checkMask));
+        out = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, out));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), out);
+    }
+    const TexturedSpan rest = {span.texels + i, span.m1 + i, span.m2 + i, span.m3 + i};
+    texturedSpanScalar(dest + i, count - i, rest, blend);
+}
+#endif  // SPANS_X86
+
+#if defined(SPANS_NEON)
+// NEON is mandatory on AArch64, so there's nothing to detect
+template <unsigned function, int shift>
+uint16x8_t blendComponentNEON(uint16x8_t dest, uint16x8_t term) {
+    const uint16x8_t mask = vdupq_n_u16(0x1f);
+    // Immediate right shifts go from 1 to 16
+    uint16x8_t d = dest;
+    if constexpr (shift != 0) d = vshrq_n_u16(dest, shift);
+    d = vandq_u16(d, mask);
+    uint16x8_t r;
+    if constexpr (function == 0) {
+        r = vaddq_u16(vshrq_n_u16(d, 1), term);
+    } else if constexpr (function == 2) {
+        r = vqsubq_u16(d, term);
+    } else {
+        r = vminq_u16(vaddq_u16(d, term), mask);
+    }
+    return vshlq_n_u16(r, shift);
+}
+
+template <unsigned function>
+void flatSpanNEON(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend) {
+    const uint16x8_t terms[3] = {vreinterpretq_u16_u32(vdupq_n_u32(blendTerms(color, function, 0))),
+                                 vreinterpretq_u16_u32(vdupq_n_u32(blendTerms(color, function, 5))),
+                                 vreinterpretq_u16_u32(vdupq_n_u32(blendTerms(color, function, 10)))};
+    const uint16x8_t setMask = vreinterpretq_u16_u32(vdupq_n_u32(blend.setMask32));
+    const uint16x8_t opaque = vorrq_u16(vreinterpretq_u16_u32(vdupq_n_u32(color)), setMask);
+
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint16_t* ptr = reinterpret_cast<uint16_t*>(dest + i);
+        const uint16x8_t d = vld1q_u16(ptr);
+        uint16x8_t out = opaque;
+        if constexpr (function != c_opaque) {
+            out = vorrq_u16(blendComponentNEON<function, 0>(d, terms[0]), blendComponentNEON<function, 5>(d, terms[1]));
+            out = vorrq_u16(out, blendComponentNEON<function, 10>(d, terms[2]));
+            out = vorrq_u16(out, setMask);
+        }
+        if (blend.checkMask) {
+            const uint16x8_t keep = vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(d), 15));
+            out = vbslq_u16(keep, d, out);
+        }
+        vst1q_u16(ptr, out);
+    }
+    flatSpanScalar(dest + i, count - i, color, blend);
+}
+
+template <unsigned function, int shift>
+uint16x8_t shadedTermNEON(uint16x8_t color) {
+    uint16x8_t c = color;
+    if constexpr (shift != 0) c = vshrq_n_u16(color, shift);
+    c = vandq_u16(c, vdupq_n_u16(0x1f));
+    if constexpr (function == 0) {
+        return vshrq_n_u16(c, 1);
+    } else if constexpr (function == 3) {
+        return vshrq_n_u16(c, 2);
+    } else {
+        return c;
+    }
+}
+
+template <unsigned function>
+void shadedSpanNEON(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend) {
+    const uint16x8_t setMask = vdupq_n_u16(uint16_t(blend.setMask32));
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t d = vld1q_u16(dest + i);
+        const uint16x8_t c = vld1q_u16(colors + i);
+        uint16x8_t out = c;
+        if constexpr (function != c_opaque) {
+            out = vorrq_u16(blendComponentNEON<function, 0>(d, shadedTermNEON<function, 0>(c)),
+                            blendComponentNEON<function, 5>(d, shadedTermNEON<function, 5>(c)));
+            out = vorrq_u16(out, blendComponentNEON<function, 10>(d, shadedTermNEON<function, 10>(c)));
+        }
+        out = vorrq_u16(out, setMask);
+        if (blend.checkMask) {
+            const uint16x8_t keep = vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(d), 15));
+            out = vbslq_u16(keep, d, out);
+        }
+        vst1q_u16(dest + i, out);
+    }
+    shadedSpanScalar(dest + i, count - i, colors + i, blend);
+}
+
+// See texturedComponent for the rounding. The products of a component and its modulation fit in 13 bits.
+template <unsigned function, int shift>
+uint16x8_t texturedComponentNEON(uint16x8_t dest, uint16x8_t texel, uint16x8_t m) {
+    const uint16x8_t mask = vdupq_n_u16(0x1f);
+    uint16x8_t d = dest;
+    uint16x8_t c = texel;
+    if constexpr (shift != 0) {
+        d = vshrq_n_u16(dest, shift);
+        c = vshrq_n_u16(texel, shift);
+    }
+    d = vandq_u16(d, mask);
+    c = vandq_u16(c, mask);
+    uint16x8_t r;
+    if constexpr (function == 0) {
+        r = vaddq_u16(vshrq_n_u16(d, 1), vshrq_n_u16(vmulq_u16(vshrq_n_u16(c, 1), m), 7));
+    } else if constexpr (function == 1) {
+        r = vaddq_u16(d, vshrq_n_u16(vmulq_u16(c, m), 7));
+    } else if constexpr (function == 2) {
+        const uint16x8_t cm = vmulq_u16(c, m);
+        uint16x8_t t;
+        if constexpr (shift > 7) {
+            t = vshlq_n_u16(cm, shift - 7);
+        } else {
+            t = vshrq_n_u16(cm, 7 - shift);
+        }
+        r = vqsubq_u16(vshlq_n_u16(d, shift), t);
+        if constexpr (shift != 0) r = vshrq_n_u16(r, shift);
+    } else if constexpr (function == 3) {
+        if constexpr (shift == 0) {
+            r = vaddq_u16(d, vshrq_n_u16(vmulq_u16(vshrq_n_u16(c, 2), m), 7));
+        } else {
+            r = vaddq_u16(d, vshrq_n_u16(vmulq_u16(c, m), 9));
+        }
+    } else {
+        r = vshrq_n_u16(vmulq_u16(c, m), 7);
+    }
+    return vshlq_n_u16(vminq_u16(r, mask), shift);
+}
+
+template <unsigned function>
+uint16x8_t texturedPixelsNEON(uint16x8_t d, uint16x8_t t, const uint16x8_t m[3]) {
+    return vorrq_u16(vorrq_u16(texturedComponentNEON<function, 0>(d, t, m[0]),
+                               texturedComponentNEON<function, 5>(d, t, m[1])),
+                     texturedComponentNEON<function, 10>(d, t, m[2]));
+}
+
+template <unsigned function>
+void texturedSpanNEON(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend) {
+    const uint16x8_t setMask = vdupq_n_u16(uint16_t(blend.setMask32));
+    const uint16x8_t topBit = vdupq_n_u16(0x8000);
+    const uint16x8_t checkMask = vdupq_n_u16(blend.checkMask ? 0xffff : 0);
+
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t d = vld1q_u16(dest + i);
+        const uint16x8_t t = vld1q_u16(span.texels + i);
+        const uint16x8_t m[3] = {vreinterpretq_u16_s16(vld1q_s16(span.m1 + i)),
+                                 vreinterpretq_u16_s16(vld1q_s16(span.m2 + i)),
+                                 vreinterpretq_u16_s16(vld1q_s16(span.m3 + i))};
+        uint16x8_t out = texturedPixelsNEON<c_opaque>(d, t, m);
+        if constexpr (function != c_opaque) {
+            const uint16x8_t semi = vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(t), 15));
+            out = vbslq_u16(semi, texturedPixelsNEON<function>(d, t, m), out);
+        }
+        out = vorrq_u16(out, vorrq_u16(setMask, vandq_u16(t, topBit)));
+        const uint16x8_t keep =
+            vorrq_u16(vceqq_u16(t, vdupq_n_u16(0)),
+                      vandq_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(d), 15)), checkMask));
+        out = vbslq_u16(keep, d, out);
+        vst1q_u16(dest + i, out);
+    }
+    const TexturedSpan rest = {span.texels + i, span.m1 + i, span.m2 + i, span.m3 + i};
+    texturedSpanScalar(dest + i, count - i, rest, blend);
+}
+#endif  // SPANS_NEON
+
+// Turns one of the templated kernels above into a span kernel, picking the blending function once per span. The
+// kernel structures have a run overload for each kind of span.
+template <template <unsigned> class Kernel, typename Pixel, typename Source>
+void dispatch(Pixel* dest, unsigned count, Source source, const Blend& blend) {
+    switch (blend.semiTransparent ? blend.function : c_opaque) {
+        case 0:
+            Kernel<0>::run(dest, count, source, blend);
+            break;
+        case 1:
+            Kernel<1>::run(dest, count, source, blend);
+            break;
+        case 2:
+            Kernel<2>::run(dest, count, source, blend);
+            break;
+        case 3:
+            Kernel<3>::run(dest, count, source, blend);
+            break;
+        default:
+            Kernel<c_opaque>::run(dest, count, source, blend);
+            break;
+    }
+}
+
+#if defined(SPANS_X86)
+template <unsigned function>
+struct SSE2 {
+    static void run(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend) {
+        flatSpanSSE2<function>(dest, count, color, blend);
+    }
+    static void run(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend) {
+        shadedSpanSSE2<function>(dest, count, colors, blend);
+    }
+    static void run(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend) {
+        texturedSpanSSE2<function>(dest, count, span, blend);
+    }
+};
+#elif defined(SPANS_NEON)
+template <unsigned function>
+struct NEON {
+    static void run(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend) {
+        flatSpanNEON<function>(dest, count, color, blend);
+    }
+    static void run(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend) {
+        shadedSpanNEON<function>(dest, count, colors, blend);
+    }
+    static void run(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend) {
+        texturedSpanNEON<function>(dest, count, span, blend);
+    }
+};
+#endif
+
+}  // namespace
+
+std::vector<PCSX::SoftGPU::Spans::FlatSpanImplementation> PCSX::SoftGPU::Spans::getSupportedFlatSpanImplementations() {
+    std::vector<FlatSpanImplementation> implementations = {{"Scalar", flatSpanScalar}};
+#if defined(SPANS_X86)
+    implementations.push_back({"SSE2", dispatch<SSE2, uint32_t, uint32_t>});
+#elif defined(SPANS_NEON)
+    implementations.push_back({"NEON", dispatch<NEON, uint32_t, uint32_t>});
+#endif
+    return implementations;
+}
+
+std::vector<PCSX::SoftGPU::Spans::ShadedSpanImplementation>
+PCSX::SoftGPU::Spans::getSupportedShadedSpanImplementations() {
+    std::vector<ShadedSpanImplementation> implementations = {{"Scalar", shadedSpanScalar}};
+#if defined(SPANS_X86)
+    implementations.push_back({"SSE2", dispatch<SSE2, uint16_t, const uint16_t*>});
+#elif defined(SPANS_NEON)
+    implementations.push_back({"NEON", dispatch<NEON, uint16_t, const uint16_t*>});
+#endif
+    return implementations;
+}
+
+std::vector<PCSX::SoftGPU::Spans::TexturedSpanImplementation>
+PCSX::SoftGPU::Spans::getSupportedTexturedSpanImplementations() {
+    std::vector<TexturedSpanImplementation> implementations = {{"Scalar", texturedSpanScalar}};
+#if defined(SPANS_X86)
+    implementations.push_back({"SSE2", dispatch<SSE2, uint16_t, const TexturedSpan&>});
+#elif defined(SPANS_NEON)
+    implementations.push_back({"NEON", dispatch<NEON, uint16_t, const TexturedSpan&>});
+#endif
+    return implementations;
+}
+
+PCSX::SoftGPU::Spans::FlatSpanKernel PCSX::SoftGPU::Spans::getFlatSpanKernel() {
+    static const FlatSpanKernel kernel = getSupportedFlatSpanImplementations().back().kernel;
+    return kernel;
+}
+
+PCSX::SoftGPU::Spans::ShadedSpanKernel PCSX::SoftGPU::Spans::getShadedSpanKernel() {
+    static const ShadedSpanKernel kernel = getSupportedShadedSpanImplementations().back().kernel;
+    return kernel;
+}
+
+PCSX::SoftGPU::Spans::TexturedSpanKernel PCSX::SoftGPU::Spans::getTexturedSpanKernel() {
+    static const TexturedSpanKernel kernel = getSupportedTexturedSpanImplementations().back().kernel;
+    return kernel;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+namespace SoftGPU {
+
+namespace Spans {
+
+// The bits of the renderer state the blending helpers look at
+struct Blend {
+    bool semiTransparent;
+    unsigned function;  // A GPU::BlendFunction
+    bool checkMask;
+    uint32_t setMask32;
+};
+
+// Draws count pairs of pixels of the specified color, which is also a pair of pixels, and leaves the VRAM
+// exactly the way calling getShadeTransCol32 on each of them would. The destination doesn't need to be aligned.
+using FlatSpanKernel = void (*)(uint32_t* dest, unsigned count, uint32_t color, const Blend& blend);
+
+// Draws count pixels, each of its own 15-bit color, the way getShadeTransCol would. This is what gouraud shaded
+// triangles draw once their colors are interpolated.
+using ShadedSpanKernel = void (*)(uint16_t* dest, unsigned count, const uint16_t* colors, const Blend& blend);
+
+// The texels of a span, already fetched, and the color each of them gets modulated with.
+struct TexturedSpan {
+    const uint16_t* texels;
+    const int16_t* m1;
+    const int16_t* m2;
+    const int16_t* m3;
+};
+
+// Draws count texels the way getTextureTransColShadeX would, whichever the kind of texture they came from.
+using TexturedSpanKernel = void (*)(uint16_t* dest, unsigned count, const TexturedSpan& span, const Blend& blend);
+
+template <typename Kernel>
+struct SpanImplementation {
+    const char* name;
+    Kernel kernel;
+};
+using FlatSpanImplementation = SpanImplementation<FlatSpanKernel>;
+using ShadedSpanImplementation = SpanImplementation<ShadedSpanKernel>;
+using TexturedSpanImplementation = SpanImplementation<TexturedSpanKernel>;
+
+// All the implementations the host CPU can run, from the slowest (the scalar one) to the fastest
+std::vector<FlatSpanImplementation> getSupportedFlatSpanImplementations();
+std::vector<ShadedSpanImplementation> getSupportedShadedSpanImplementations();
+std::vector<TexturedSpanImplementation> getSupportedTexturedSpanImplementations();
+
+// The fastest implementation the host CPU can run. Feature detection only happens on the first call.
+FlatSpanKernel getFlatSpanKernel();
+ShadedSpanKernel getShadedSpanKernel();
+TexturedSpanKernel getTexturedSpanKernel();
+
+}  // namespace Spans
+
+}  // namespace SoftGPU
+
+}  // namespace PCSX
@@ -0,0 +1,175 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gpu/soft/tiled.h"
+
+#include "tracy/Tracy.hpp"
+
+void PCSX::SoftGPU::TiledRasterizer::start(unsigned threads) {
+    stop();
+    threads = std::min(threads, c_maxThreads);
+    if (threads == 0) return;
+
+    if (!m_jobs) m_jobs.reset(new Job[c_queueSize]);
+    m_submitted = m_retired = 0;
+    m_idle = 0;
+    m_stopping = false;
+    m_pending = false;
+    m_reading = false;
+
+    for (unsigned i = 0; i < threads; i++) m_workers.emplace_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < threads; i++) {
+        auto &worker = *m_workers[i];
+        worker.thread = std::thread([this, &worker, i]() { workerLoop(worker, i); });
+    }
+}
+
+void PCSX::SoftGPU::TiledRasterizer::stop() {
+    if (m_workers.empty()) return;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobsAvailable.notify_all();
+    for (auto &worker : m_workers) worker->thread.join();
+    m_workers.clear();
+    m_pending = false;
+    m_reading = false;
+}
+
+void PCSX::SoftGPU::TiledRasterizer::sync() {
+    if (!m_pending) return;
+    ZoneScoped;
+    m_flushes.store(m_flushes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobsDone.wait(lock, [this]() { return retired() == m_submitted; });
+    m_retired = m_submitted;
+    m_pending = false;
+    m_reading = false;
+}
+
+bool PCSX::SoftGPU::TiledRasterizer::queueable(const SoftRenderer &state, const Bounds &bounds, const Bounds *texture,
+                                               bool splittable) {
+    // A primitive sampling its own output needs to see the rows above it being drawn first.
+    if (texture && overlaps(bounds, *texture)) return false;
+
+    // Read after write, and write after read: the workers may be at different points of the queue.
+    if (m_pending) {
+        if (texture && overlaps(m_written, *texture)) sync();
+        if (m_reading && overlaps(m_read, bounds)) sync();
+    }
+
+    const int firstTile = bounds.y0 / c_tileHeight;
+    const int lastTile = bounds.y1 / c_tileHeight;
+    if (firstTile == lastTile) return true;
+    if (!splittable) return false;
+
+    // The polygon rasterizers bail out on a drawing area with a single row, so a band which would only get
+    // the first or last row of the drawing area can't do its share of the work.
+    if ((bounds.y0 == state.m_drawY) && ((bounds.y0 % c_tileHeight) == (c_tileHeight - 1))) return false;
+    if ((bounds.y1 == state.m_drawH) && ((bounds.y1 % c_tileHeight) == 0)) return false;
+
+    return true;
+}
+
+PCSX::SoftGPU::TiledRasterizer::Job &PCSX::SoftGPU::TiledRasterizer::reserve() {
+    if ((m_submitted - m_retired) >= c_queueSize) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobsDone.wait(lock, [this]() { return (m_submitted - retired()) < c_queueSize; });
+        m_retired = retired();
+    }
+    return m_jobs[m_submitted % c_queueSize];
+}
+
+void PCSX::SoftGPU::TiledRasterizer::commit(const Bounds &bounds, const Bounds *texture) {
+    if (m_pending) {
+        merge(m_written, bounds);
+    } else {
+        m_written = bounds;
+    }
+    if (texture) {
+        if (m_reading) {
+            merge(m_read, *texture);
+        } else {
+            m_read = *texture;
+        }
+        m_reading = true;
+    }
+    m_pending = true;
+
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_submitted++;
+        wake = m_idle != 0;
+    }
+    if (wake) m_jobsAvailable.notify_all();
+}
+
+// Needs to be called with the mutex held.
+uint64_t PCSX::SoftGPU::TiledRasterizer::retired() const {
+    uint64_t ret = m_submitted;
+    for (auto &worker : m_workers) ret = std::min(ret, worker->done);
+    return ret;
+}
+
+void PCSX::SoftGPU::TiledRasterizer::workerLoop(Worker &worker, unsigned index) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t cursor = worker.done;
+    while (true) {
+        if (cursor == m_submitted) {
+            if (m_stopping) return;
+            m_idle++;
+            m_jobsAvailable.wait(lock, [this, cursor]() { return m_stopping || (cursor != m_submitted); });
+            m_idle--;
+            continue;
+        }
+        const uint64_t end = m_submitted;
+        lock.unlock();
+        for (; cursor < end; cursor++) runJob(worker, index, m_jobs[cursor % c_queueSize]);
+        lock.lock();
+        worker.done = end;
+        m_jobsDone.notify_all();
+    }
+}
+
+void PCSX::SoftGPU::TiledRasterizer::runJob(Worker &worker, unsigned index, const Job &job) {
+    ZoneScoped;
+    const int count = m_workers.size();
+    const int self = index;
+    const int firstTile = job.bounds.y0 / c_tileHeight;
+    const int lastTile = job.bounds.y1 / c_tileHeight;
+    auto &renderer = worker.renderer;
+
+    // Contained in a single band, which means there's no need to clip anything further.
+    if (firstTile == lastTile) {
+        if ((firstTile % count) != self) return;
+        renderer = job.state;
+        job.run(renderer, job.args);
+        return;
+    }
+
+    int tile = firstTile + (self + count - (firstTile % count)) % count;
+    for (; tile <= lastTile; tile += count) {
+        renderer = job.state;
+        renderer.m_drawY = std::max(job.state.m_drawY, tile * c_tileHeight);
+        renderer.m_drawH = std::min(job.state.m_drawH, tile * c_tileHeight + c_tileHeight - 1);
+        job.run(renderer, job.args);
+    }
+}
@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "gpu/soft/soft.h"
+
+namespace PCSX {
+
+namespace SoftGPU {
+
+// Spreads the work of the soft renderer over a pool of threads. The VRAM is cut into bands of c_tileHeight
+// rows, and each band belongs to a single worker, so that no two threads ever touch the same pixel. Primitives
+// are queued along with a copy of the renderer state at the time they were submitted, and every worker replays
+// the queue in order, clipping each primitive to its own bands. Blending and mask checks thus see the exact same
+// pixels as when drawing in place. Primitives reading from an area of the VRAM still being drawn drain the queue
+// first, and so does anything reading back or writing the VRAM outside of the rasterizers, by calling sync().
+class TiledRasterizer {
+  public:
+    static constexpr int c_tileHeight = 16;
+    static constexpr unsigned c_maxThreads = 16;
+
+    // Inclusive on all sides, like the drawing area.
+    struct Bounds {
+        int x0, y0, x1, y1;
+    };
+
+    TiledRasterizer() = default;
+    TiledRasterizer(const TiledRasterizer &) = delete;
+    TiledRasterizer &operator=(const TiledRasterizer &) = delete;
+    ~TiledRasterizer() { stop(); }
+
+    // Restarts the pool with the specified amount of workers; 0 stops it.
+    void start(unsigned threads);
+    void stop();
+    bool enabled() const { return !m_workers.empty(); }
+
+    // Queues a call to one of the SoftRenderer drawing functions, to be run against a copy of the state.
+    // The bounds need to cover all the pixels the primitive may write, and texture, if present, all the ones
+    // it may read. Lines aren't splittable, as their clipping doesn't follow the drawing area the same way the
+    // polygons do. When this returns false, the queue has been drained, and the caller needs to draw in place.
+    template <auto function, typename... Args>
+    bool submit(const SoftRenderer &state, Bounds bounds, const Bounds *texture, bool splittable, Args... args) {
+        using Storage = std::tuple<Args...>;
+        static_assert(sizeof(Storage) <= c_argsSize, "Too many arguments for a queued primitive");
+        static_assert(std::is_trivially_destructible_v<Storage>);
+
+        // Nothing outside of the drawing area is ever going to be written.
+        bounds.x0 = std::max(bounds.x0, state.m_drawX);
+        bounds.y0 = std::max({bounds.y0, state.m_drawY, 0});
+        bounds.x1 = std::min(bounds.x1, state.m_drawW);
+        bounds.y1 = std::min(bounds.y1, state.m_drawH);
+        if ((bounds.x0 > bounds.x1) || (bounds.y0 > bounds.y1)) return true;
+
+        if (!queueable(state, bounds, texture, splittable)) {
+            sync();
+            return false;
+        }
+
+        Job &job = reserve();
+        job.state = state;
+        job.bounds = bounds;
+        job.run = [](SoftRenderer &renderer, const std::byte *storage) {
+            std::apply([&renderer](auto... args) { (renderer.*function)(args...); },
+                       *std::launder(reinterpret_cast<const Storage *>(storage)));
+        };
+        new (job.args) Storage(args...);
+        commit(bounds, texture);
+        return true;
+    }
+
+    // Waits until all of the queued primitives have been drawn.
+    void sync();
+    // How many times sync() had to wait for anything so far.
+    uint64_t flushes() const { return m_flushes.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr unsigned c_queueSize = 1024;
+    static constexpr size_t c_argsSize = 26 * sizeof(int32_t);
+
+    struct Job {
+        SoftRenderer state;
+        Bounds bounds;
+        void (*run)(SoftRenderer &, const std::byte *);
+        alignas(std::max_align_t) std::byte args[c_argsSize];
+    };
+
+    struct Worker {
+        std::thread thread;
+        uint64_t done = 0;
+        SoftRenderer renderer;
+    };
+
+    static bool overlaps(const Bounds &a, const Bounds &b) {
+        return (a.x0 <= b.x1) && (b.x0 <= a.x1) && (a.y0 <= b.y1) && (b.y0 <= a.y1);
+    }
+    static void merge(Bounds &into, const Bounds &from) {
+        into.x0 = std::min(into.x0, from.x0);
+        into.y0 = std::min(into.y0, from.y0);
+        into.x1 = std::max(into.x1, from.x1);
+        into.y1 = std::max(into.y1, from.y1);
+    }
+
+    bool queueable(const SoftRenderer &state, const Bounds &bounds, const Bounds *texture, bool splittable);
+    Job &reserve();
+    void commit(const Bounds &bounds, const Bounds *texture);
+    uint64_t retired() const;
+    void workerLoop(Worker &worker, unsigned index);
+    void runJob(Worker &worker, unsigned index, const Job &job);
+
+    std::unique_ptr<Job[]> m_jobs;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobsAvailable;
+    std::condition_variable m_jobsDone;
+    uint64_t m_submitted = 0;
+    unsigned m_idle = 0;
+    bool m_stopping = false;
+
+    // Only touched by the submitting thread.
+    uint64_t m_retired = 0;
+    bool m_pending = false;
+    Bounds m_written;
+    Bounds m_read;
+    bool m_reading = false;
+    // Only written by the submitting thread, but read from the emulation one.
+    std::atomic<uint64_t> m_flushes = 0;
+};
+
+}  // namespace SoftGPU
+
+}  // namespace PCSX
@@ -41,6 +41,7 @@ extern "C" {
 #include <ctime>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <magic_enum_all.hpp>
 #include <numbers>
@@ -51,6 +52,7 @@ extern "C" {
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/framestats.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
@@ -58,6 +60,7 @@ extern "C" {
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/runahead.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
 #include "core/sstate.h"
@@ -84,6 +87,7 @@ extern "C" {
 #include "nanovg/src/nanovg_gl_utils.h"
 #include "spu/interface.h"
 #include "support/bezier.h"
+#include "support/gzchunks.h"
 #include "support/mem4g.h"
 #include "support/uvfile.h"
 #include "support/zfile.h"
@@ -179,6 +183,7 @@ PCSX::GUI::GUI(std::vector<std::string>& favorites)
       m_selectBiosDialog(l_("Select BIOS"), favorites),
       m_selectEXP1Dialog(l_("Select EXP1"), favorites),
       m_isoBrowser(settings.get<ShowIsoBrowser>().value, favorites),
+      m_traceBrowser(settings.get<ShowTraceBrowser>().value, favorites),
       m_pioCart(settings.get<ShowPIOCartConfig>().value, favorites) {
     assert(g_gui == nullptr);
     g_gui = this;
@@ -551,10 +556,16 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
     m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) {
         glfwSwapInterval(m_idleSwapInterval);
         glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        damage();
     });
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](const auto& event) { damage(); });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](const auto& event) { damage(); });
+    m_listener.listen<Events::GUI::JumpToPC>([this](const auto& event) { damage(); });
+    m_listener.listen<Events::GUI::JumpToMemory>([this](const auto& event) { damage(); });
     m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) {
         glfwSwapInterval(0);
         setRawMouseMotion();
+        updateRefreshRate();
     });
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -777,6 +788,10 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
             m_stringHolder = (_("Memory Editor #") + std::to_string(counter));
             return m_stringHolder.c_str();
         };
+        editor.editor.WriteFn = [](uint8_t* data, size_t offset, uint8_t writtenByte) {
+            data[offset] = writtenByte;
+            g_emulator->m_mem->markRAMDirty(offset, 1);
+        };
         counter++;
     }
     m_parallelPortEditor.title = l_("Parallel Port");
@@ -966,6 +981,8 @@ void PCSX::GUI::startFrame() {
 
         glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenDepthBuffer);
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_renderSize.x, m_renderSize.y);
+        // Going fullscreen, or back, can change the monitor the window is on.
+        updateRefreshRate();
         m_setupScreenSize = false;
     }
 
@@ -989,9 +1006,15 @@ void PCSX::GUI::startFrame() {
             for (auto e : g_system->getLocaleExtra()) {
                 loadFont(e.first, settings.get<MainFontSize>().value * scale, io, e.second, true, false);
             }
-            // try loading the japanese font for memory card manager
-            m_hasJapanese = loadFont(MAKEU8("NotoSansCJKjp-Regular.otf"), settings.get<MainFontSize>().value * scale,
-                                     io, reinterpret_cast<const ImWchar*>(PCSX::System::Range::JAPANESE), true, true);
+            // try loading the japanese font for memory card manager; it also has the pad symbols, which are
+            // needed all the time
+            static const ImWchar c_noRanges[] = {0};
+            const ImWchar* japanese = m_wantJapanese
+                                          ? reinterpret_cast<const ImWchar*>(PCSX::System::Range::JAPANESE)
+                                          : c_noRanges;
+            ImFont* japaneseFont = loadFont(MAKEU8("NotoSansCJKjp-Regular.otf"),
+                                            settings.get<MainFontSize>().value * scale, io, japanese, true, true);
+            m_hasJapanese = m_wantJapanese && japaneseFont;
             m_monoFonts[scale] = loadFont(MAKEU8("NotoMono-Regular.ttf"), settings.get<MonoFontSize>().value * scale,
                                           io, nullptr, false, false);
         }
@@ -1038,6 +1061,10 @@ void PCSX::GUI::startFrame() {
         loadSaveState(saveStateName);
     }
 
+    if (ImGui::IsKeyPressed(ImGuiKey_F3, true)) {  // Step back through the rewind buffer, for as long as it's held
+        SaveStates::rewind();
+    }
+
     if (!g_system->running()) {
         if (ImGui::IsKeyPressed(ImGuiKey_F10)) {
             g_emulator->m_debug->stepOver();
@@ -1276,6 +1303,10 @@ void PCSX::GUI::endFrame() {
                 if (ImGui::MenuItem(_("Load global state"))) loadSaveState(globalSaveStateName);
                 ImGui::EndDisabled();
 
+                ImGui::BeginDisabled(!emuSettings.get<Emulator::SettingRewind>());
+                if (ImGui::MenuItem(_("Rewind"), "F3")) SaveStates::rewind();
+                ImGui::EndDisabled();
+
                 ImGui::Separator();
                 if (ImGui::MenuItem(_("Open LID"))) {
                     PCSX::g_emulator->m_cdrom->setLidOpenTime(-1);
@@ -1366,6 +1397,10 @@ void PCSX::GUI::endFrame() {
             ImGui::Separator();
             if (ImGui::BeginMenu(_("Debug"))) {
                 ImGui::MenuItem(_("Show Logs"), nullptr, &m_log.m_show);
+                if (ImGui::MenuItem(_("Show Performance Overlay"), nullptr,
+                                    &emuSettings.get<Emulator::SettingPerformanceOverlay>().value)) {
+                    changed = true;
+                }
                 if (ImGui::BeginMenu(_("Lua"))) {
                     ImGui::MenuItem(_("Show Lua Console"), nullptr, &m_luaConsole.m_show);
                     ImGui::MenuItem(_("Show Lua Inspector"), nullptr, &m_luaInspector.m_show);
@@ -1386,6 +1421,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
                     }
                     ImGui::MenuItem(_("Show Breakpoints"), nullptr, &m_breakpoints.m_show);
                     ImGui::MenuItem(_("Show Callstacks"), nullptr, &m_callstacks.m_show);
+                    ImGui::MenuItem(_("Show Trace Browser"), nullptr, &m_traceBrowser.m_show);
                     if (ImGui::BeginMenu(_("Memory Editors"))) {
                         for (auto& editor : m_mainMemEditors) {
                             editor.MenuItem();
@@ -1401,6 +1437,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
                     ImGui::MenuItem(_("Show Typed Debugger"), nullptr, &m_typedDebugger.m_show);
                     ImGui::MenuItem(_("Show Patches"), nullptr, &m_patches.m_show);
                     ImGui::MenuItem(_("Show Interrupts Scaler"), nullptr, &m_showInterruptsScaler);
+                    ImGui::MenuItem(_("Show Memory Access Counters"), nullptr, &m_showMemoryAccessCounters);
                     if (ImGui::BeginMenu(_("First Chance Exceptions"))) {
                         ImGui::PushItemFlag(ImGuiItemFlags_AutoClosePopups, false);
                         constexpr auto& exceptions = magic_enum::enum_entries<PCSX::R3000Acpu::Exception>();
@@ -1603,9 +1640,14 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
     if (m_kernelLog.m_show) {
         changed |= m_kernelLog.draw(g_emulator->m_cpu.get(), _("Kernel Calls"));
     }
+    // The Assembly widget's step out goes by the call stacks too.
+    m_callstacks.track(m_callstacks.m_show || m_assembly.m_show);
     if (m_callstacks.m_show) {
         m_callstacks.draw(_("Callstacks"), this);
     }
+    if (m_traceBrowser.m_show) {
+        m_traceBrowser.draw(this, _("Trace Browser"));
+    }
 
     {
         unsigned counter = 0;
@@ -1647,7 +1689,7 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
 
             // This const_cast is disgusting but we only use it to satisfy the type system
             // The slice data is indeed treated as read-only
-            const Slice vram = g_emulator->m_gpu->getVRAM();
+            const Slice vram = g_emulator->m_gpu->getVRAMSnapshot();
             m_vramEditor.draw(const_cast<void*>(vram.data()), vram.size());
         }
     }
@@ -1690,15 +1732,16 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
 
     if (m_showAbout) changed |= about();
     if (m_showInterruptsScaler) interruptsScaler();
+    if (m_showMemoryAccessCounters) memoryAccessCounters();
 
+    m_outputShaderEditor.pollCompile(this);
     if (m_outputShaderEditor.m_show && m_outputShaderEditor.draw(this, _("Output Video"))) {
-        // maybe throttle this?
-        m_outputShaderEditor.compile(this);
+        m_outputShaderEditor.compileAsync(this);
     }
 
+    m_offscreenShaderEditor.pollCompile(this);
     if (m_offscreenShaderEditor.m_show && m_offscreenShaderEditor.draw(this, _("Offscreen Render"))) {
-        // maybe throttle this?
-        m_offscreenShaderEditor.compile(this);
+        m_offscreenShaderEditor.compileAsync(this);
     }
 
     if (m_pioCart.m_show) {
@@ -1717,6 +1760,10 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
     if (g_emulator->m_spu->m_showCfg) changed |= g_emulator->m_spu->configure();
     g_emulator->m_spu->debug();
     changed |= g_emulator->m_pads->configure(this);
+    if (emuSettings.get<Emulator::SettingRunAhead>() > 0 && emuSettings.get<Emulator::SettingRunAheadOverlay>()) {
+        showRunAheadTimings();
+    }
+    if (emuSettings.get<Emulator::SettingPerformanceOverlay>()) showPerformanceOverlay();
 
     if (g_emulator->m_gpu->m_showCfg) changed |= g_emulator->m_gpu->configure();
     if (g_emulator->m_gpu->m_showDebug) g_emulator->m_gpu->debug();
@@ -1775,6 +1822,16 @@ their TV set to match the aspect ratio of the game.)"));
         if (ImGui::Begin(_("System Configuration"), &m_showSysCfg)) {
             changed |=
                 ImGui::Checkbox(_("Preload Disk Image files"), &emuSettings.get<Emulator::SettingFullCaching>().value);
+            if (ImGui::Checkbox(_("Share preloaded files"),
+                                &emuSettings.get<Emulator::SettingShareCachedFiles>().value)) {
+                UvFile::shareCaches(emuSettings.get<Emulator::SettingShareCachedFiles>());
+                changed = true;
+            }
+            ImGuiHelpers::ShowHelpMarker(_(R"(Preloaded files get put in memory shared with
+the other instances of PCSX-Redux preloading the
+same files, so they only get read once. This
+memory stays around for as long as one of them
+is still using it.)"));
             changed |= ImGui::Checkbox(_("Enable Auto Update"), &emuSettings.get<Emulator::SettingAutoUpdate>().value);
         }
         ImGui::End();
@@ -1924,6 +1981,7 @@ the update and manually apply it.)")));
     if (!L.isnil()) {
         ScopedOnlyLog(this);
         try {
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
             L.pcall();
             bool gotGLerror = false;
             for (const auto& error : m_glErrors) {
@@ -1980,6 +2038,7 @@ the update and manually apply it.)")));
         L.copy(-2);
         L.push(lua_Number(platform_io.Viewports[0]->ID));
         try {
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
             L.pcall(2);
             bool gotGLerror = false;
             for (const auto& error : m_glErrors) {
@@ -2020,6 +2079,7 @@ the update and manually apply it.)")));
                     L.copy(-2);
                     L.push(lua_Number(viewport->ID));
                     try {
+                        FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Lua);
                         L.pcall(2);
                         bool gotGLerror = false;
                         for (const auto& error : m_glErrors) {
@@ -2038,12 +2098,16 @@ the update and manually apply it.)")));
                     while (L.gettop()) L.pop();
                 }
             }
+            FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Present);
             if (platform_io.Platform_SwapBuffers) platform_io.Platform_SwapBuffers(viewport, nullptr);
             if (platform_io.Renderer_SwapBuffers) platform_io.Renderer_SwapBuffers(viewport, nullptr);
         }
         glfwMakeContextCurrent(m_window);
     }
-    glfwSwapBuffers(m_window);
+    {
+        FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::Present);
+        glfwSwapBuffers(m_window);
+    }
 
     L.getfieldtable("nvg", LUA_GLOBALSINDEX);
     L.push("_gui");
@@ -2054,7 +2118,10 @@ the update and manually apply it.)")));
     L.settable();
     while (L.gettop()) L.pop();
 
-    if (changed) saveCfg();
+    if (changed) {
+        SettingsChanges::mark();
+        saveCfg();
+    }
     if (m_gotImguiUserError) {
         g_system->log(LogClass::UI, "Got ImGui User Error: %s\n", m_imguiUserError.c_str());
         m_gotImguiUserError = false;
@@ -2081,6 +2148,18 @@ bool PCSX::GUI::configure() {
             changed = true;
             if (!g_system->running()) glfwSwapInterval(m_idleSwapInterval);
         }
+        changed |= ImGui::Checkbox(_("Idle Throttling"), &m_idleThrottling);
+        ImGuiHelpers::ShowHelpMarker(_(R"(While the emulation is paused, only redraw the interface when something
+happens, such as user input, instead of every frame. This lowers the host CPU and GPU usage of idle instances
+to almost nothing.)"));
+        if (ImGui::Checkbox(_("Pace presentation to the display"), &m_presentPacing)) {
+            changed = true;
+            updateRefreshRate();
+        }
+        ImGuiHelpers::ShowHelpMarker(_(R"(Only present as many emulated frames as the display can show, based on
+its refresh rate. When the emulated machine runs faster than the display, such as NTSC games on a 50Hz
+display, or when fast forwarding, the frames which would never get seen are skipped instead of being drawn,
+leaving more time to the emulation. Input is still read on every emulated frame.)"));
         ImGui::Separator();
         if (ImGui::Button(_("Reset Scaler"))) {
             changed = true;
@@ -2107,10 +2186,29 @@ however it doesn't play nicely with the debugger.
 Changing this setting requires a reboot to take effect.
 The dynarec core isn't available for all CPUs, so
 this setting may not have any effect for you.)"));
+        changed |= ImGui::Checkbox(_("Skip idle loops"), &settings.get<Emulator::SettingIdleSkipping>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Detects the short loops which wait on
+memory changed by an interrupt, such as a
+vsync flag, and skips ahead to the next
+event instead of running them. This saves
+host time, but may upset timing sensitive code.)"));
+        changed |= ImGui::Checkbox(_("Emulate BIOS libc calls"), &settings.get<Emulator::SettingBiosHLE>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Runs a few of the BIOS memory and string
+functions, such as memcpy, memset, or strlen,
+natively instead of emulating the BIOS code.
+Their cost in cycles is approximated. This is
+disabled while the debugger is enabled.)"));
         bool memChanged = ImGui::Checkbox(_("8MB"), &settings.get<Emulator::Setting8MB>().value);
         ImGuiHelpers::ShowHelpMarker(_(R"(Emulates an installed 8MB system,
 instead of the normal 2MB. Useful for working
 with development binaries and games.)"));
+        changed |= ImGui::Checkbox(_("Large pages"), &settings.get<Emulator::SettingLargePages>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Allocates the emulated RAM, the VRAM, and the
+dynarec's code buffer on large pages when the
+system allows it, which relieves the host's TLB.
+On Windows, this requires the "Lock pages in memory"
+right. The log says what was obtained. Requires a
+restart when changing this setting.)"));
         changed |=
             ImGui::Checkbox(_("OpenGL GPU *ALPHA STATE*"), &settings.get<Emulator::SettingHardwareRenderer>().value);
         ImGuiHelpers::ShowHelpMarker(_(R"(Enables the OpenGL GPU renderer.
@@ -2152,6 +2250,62 @@ when changing this setting.)"));
 which may include additional checks.
 Also will make the boot time substantially
 faster by not displaying the logo.)"));
+        changed |= ImGui::SliderInt(_("Fast CD-ROM speed"), &settings.get<Emulator::SettingFastCDSpeed>().value, 1,
+                                    CDRom::c_maxFastCDSpeed, "%dx");
+        ImGuiHelpers::ShowHelpMarker(_(R"(Makes the CD-ROM drive seek and read data this
+many times faster than it normally does, which
+shortens the loading times. The game still sees
+the drive's commands and interrupts in the same
+order. XA audio streams keep their normal speed.
+Some games may not like it, and it can be turned
+off for the disc in the drive only.)"));
+        if (settings.get<Emulator::SettingFastCDSpeed>() > 1) {
+            auto& cdrom = g_emulator->m_cdrom;
+            const auto& id = cdrom->getCDRomID();
+            if (!id.empty()) {
+                auto& exclusions = settings.get<Emulator::SettingFastCDExclusions>().value;
+                auto exclusion = std::find(exclusions.begin(), exclusions.end(), id);
+                bool normalSpeed = exclusion != exclusions.end();
+                if (ImGui::Checkbox(fmt::format(f_("Normal CD-ROM speed for {}"), id).c_str(), &normalSpeed)) {
+                    changed = true;
+                    if (normalSpeed) {
+                        exclusions.push_back(id);
+                    } else {
+                        exclusions.erase(exclusion);
+                    }
+                }
+            }
+            const auto& stats = cdrom->getFastCDStats();
+            const float clock = g_emulator->m_psxClockSpeed;
+            ImGui::Text(_("Saved %.2fs over %u loads, %.2fs on the last one (%u sectors)"), stats.totalSaved / clock,
+                        stats.loads, stats.lastSaved / clock, stats.lastSectors);
+        }
+        changed |= ImGui::Checkbox(_("Enable rewind"), &settings.get<Emulator::SettingRewind>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Keeps save states of the last moments of emulation
+in memory, to go back through them by holding F3.
+Each of them costs a few milliseconds to make, so
+emulation can get less smooth with short intervals.)"));
+        if (settings.get<Emulator::SettingRewind>()) {
+            changed |= ImGui::SliderInt(_("Frames between rewind states"),
+                                        &settings.get<Emulator::SettingRewindInterval>().value, 1, 60);
+            changed |= ImGui::SliderInt(_("Rewind states between keyframes"),
+                                        &settings.get<Emulator::SettingRewindKeyframeInterval>().value, 1, 120);
+            changed |= ImGui::SliderInt(_("Rewind memory budget (MB)"),
+                                        &settings.get<Emulator::SettingRewindMemoryBudget>().value, 16, 4096);
+        }
+        changed |= ImGui::SliderInt(_("Run-ahead frames"), &settings.get<Emulator::SettingRunAhead>().value, 0,
+                                    RunAhead::c_maxFrames);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Hides input lag by emulating this many frames ahead
+of what's shown, with the current input, then going
+back. Games which take a frame or more to react to
+their pads feel more responsive, but every frame
+costs this many more to emulate. Set it to the
+amount of lag frames of the game, and not higher.
+This is turned off while the debugger is enabled.)"));
+        if (settings.get<Emulator::SettingRunAhead>() > 0) {
+            changed |= ImGui::Checkbox(_("Show run-ahead timings"),
+                                       &settings.get<Emulator::SettingRunAheadOverlay>().value);
+        }
         auto bios = settings.get<Emulator::SettingBios>().string();
         ImGui::InputText(_("BIOS file"), const_cast<char*>(reinterpret_cast<const char*>(bios.c_str())), bios.length(),
                          ImGuiInputTextFlags_ReadOnly);
@@ -2300,6 +2454,14 @@ See the wiki for details.)"));
             }
             ImGui::EndCombo();
         }
+        changed |= ImGui::Checkbox(_("Batch SIO1 messages"),
+                                   &debugSettings.get<Emulator::DebugSettings::SIO1Batching>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(In Protobuf mode, sends what the emulated software wrote during a time
+slice as a single message, instead of one per byte. The receiving side
+still gets the bytes spaced the way they were sent. Both sides need to
+be running a version which understands batches.)"));
+        changed |= ImGui::InputInt(_("SIO1 batch latency (us)"),
+                                   &debugSettings.get<Emulator::DebugSettings::SIO1BatchLatency>().value);
     }
     ImGui::End();
 
@@ -2323,14 +2485,14 @@ See the wiki for details.)"));
     }
     if (showDynarecDebugWarning && showDynarecWarning) {
         addNotification(R"(Debugger and dynarec enabled at the same time.
-Consider turning either one off, otherwise
-debugging features may not work. Additionally,
+Execution breakpoints work with the dynarec,
+but other debugging features may not. Additionally,
 changing the dynarec option requires a restart
 of the emulator to take effect.)");
     } else if (showDynarecDebugWarning) {
         addNotification(R"(Debugger and dynarec enabled at the same time.
-Consider turning either one off, otherwise
-debugging features may not work.)");
+Execution breakpoints work with the dynarec,
+but other debugging features may not.)");
     } else if (showDynarecWarning) {
         addNotification(R"(Toggling the Dynarec option requires a restart
 of the emulator to take effect.)");
@@ -2342,7 +2504,7 @@ void PCSX::GUI::interruptsScaler() {
     static const char* names[] = {
         "SIO",      "SIO1",        "CDR",         "CDR Read", "GPU DMA", "MDEC Out DMA",       "SPU DMA",
         "GPU Busy", "MDEC In DMA", "GPU OTC DMA", "CDR DMA",  "SPU",     "CDR Decoded Buffer", "CDR Lid Seek",
-        "CDR Play",
+        "CDR Play", "Profiler",
     };
     if (ImGui::Begin(_("Interrupt Scaler"), &m_showInterruptsScaler)) {
         if (ImGui::Button(_("Reset all"))) {
@@ -2359,6 +2521,127 @@ void PCSX::GUI::interruptsScaler() {
     ImGui::End();
 }
 
+void PCSX::GUI::memoryAccessCounters() {
+    auto& memory = g_emulator->m_mem;
+    if (ImGui::Begin(_("Memory Access Counters"), &m_showMemoryAccessCounters)) {
+        ImGui::TextWrapped("%s", _("Counts the memory accesses that miss the fast memory lookup tables, per region."));
+        ImGui::Checkbox(_("Enable counters"), &memory->m_countSlowAccesses);
+        ImGui::SameLine();
+        if (ImGui::Button(_("Reset"))) memory->resetSlowAccessCounters();
+
+        if (ImGui::BeginTable("MemoryAccessCounters", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn(_("Region"));
+            ImGui::TableSetupColumn(_("Reads"));
+            ImGui::TableSetupColumn(_("Writes"));
+            ImGui::TableHeadersRow();
+            for (auto [region, name] : magic_enum::enum_entries<Memory::Region>()) {
+                const auto& counters = memory->getSlowAccessCounters(region);
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%llu", (unsigned long long)counters.reads);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%llu", (unsigned long long)counters.writes);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
+void PCSX::GUI::showRunAheadTimings() {
+    const auto& timings = g_emulator->m_runAhead->getTimings();
+    ImGui::SetNextWindowPos(ImVec2(60, 60), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    if (ImGui::Begin(_("Run-ahead timings"), &g_emulator->settings.get<Emulator::SettingRunAheadOverlay>().value,
+                     ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing |
+                         ImGuiWindowFlags_NoNav)) {
+        ImGui::Text(_("%u frames ahead"), timings.frames);
+        auto plot = [&timings](const char* label, const float* values) {
+            float total = 0.0f;
+            float max = 0.0f;
+            for (unsigned i = 0; i < RunAhead::c_timings; i++) {
+                total += values[i];
+                max = std::max(max, values[i]);
+            }
+            const std::string overlay =
+                fmt::format(f_("average {:.0f}us, max {:.0f}us"), total / RunAhead::c_timings, max);
+            ImGui::PlotLines(label, values, RunAhead::c_timings, timings.index, overlay.c_str(), 0.0f, FLT_MAX,
+                             ImVec2(320, 48));
+        };
+        plot(_("Snapshot"), timings.snapshot);
+        plot(_("Ahead"), timings.ahead);
+        plot(_("Rollback"), timings.restore);
+    }
+    ImGui::End();
+}
+
+void PCSX::GUI::showPerformanceOverlay() {
+    const auto& stats = *g_emulator->m_frameStats;
+    const auto& history = stats.history();
+    ImGui::SetNextWindowPos(ImVec2(60, 60), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    if (ImGui::Begin(_("Performance"), &g_emulator->settings.get<Emulator::SettingPerformanceOverlay>().value,
+                     ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing |
+                         ImGuiWindowFlags_NoNav)) {
+        ImGui::Text(_("%.1f FPS, emulating %.1f FPS"), stats.hostFPS(), stats.emulatedFPS());
+        auto& cpu = g_emulator->m_cpu;
+        if (cpu->isDynarec()) {
+            const size_t used = cpu->getBufferSize();
+            const size_t capacity = cpu->getBufferCapacity();
+            ImGui::Text(_("Dynarec code buffer: %.1f / %.1f MB (%.1f%%)"), used / (1024.0f * 1024.0f),
+                        capacity / (1024.0f * 1024.0f), capacity ? 100.0f * used / capacity : 0.0f);
+        }
+        const unsigned last = (history.index + FrameStats::c_frames - 1) % FrameStats::c_frames;
+        auto plot = [&history, last](const char* label, const float* values) {
+            float total = 0.0f;
+            float max = 0.0f;
+            for (unsigned i = 0; i < FrameStats::c_frames; i++) {
+                total += values[i];
+                max = std::max(max, values[i]);
+            }
+            const std::string overlay =
+                fmt::format(f_("{:.2f}ms, average {:.2f}ms, max {:.2f}ms"), values[last],
+                            history.frames ? total / history.frames : 0.0f, max);
+            ImGui::PlotLines(label, values, FrameStats::c_frames, history.index, overlay.c_str(), 0.0f, FLT_MAX,
+                             ImVec2(320, 32));
+        };
+        plot(_("Frame"), history.frameTime);
+        plot(_("CPU"), history.counters[unsigned(FrameStats::Counter::CPU)]);
+        plot(_("GPU"), history.counters[unsigned(FrameStats::Counter::GPU)]);
+        plot(_("SPU"), history.counters[unsigned(FrameStats::Counter::SPU)]);
+        plot(_("Lua"), history.counters[unsigned(FrameStats::Counter::Lua)]);
+        plot(_("GUI"), history.counters[unsigned(FrameStats::Counter::GUI)]);
+        plot(_("Present"), history.counters[unsigned(FrameStats::Counter::Present)]);
+        const auto& gpuCounters = g_emulator->m_gpu->lastFrameCounters();
+        auto gpuCounter = [&gpuCounters](GPU::Counter counter) { return gpuCounters[unsigned(counter)]; };
+        ImGui::TextUnformatted(
+            fmt::format(f_("Last frame: {} triangles, {} lines, {} rectangles, {} fills, {} copies, {:.1f}K pixels"),
+                        gpuCounter(GPU::Counter::Triangles), gpuCounter(GPU::Counter::Lines),
+                        gpuCounter(GPU::Counter::Rectangles), gpuCounter(GPU::Counter::Fills),
+                        gpuCounter(GPU::Counter::VRAMCopies), gpuCounter(GPU::Counter::Pixels) / 1000.0f)
+                .c_str());
+        ImGui::TextUnformatted(fmt::format(f_("VRAM: {:.1f}KB uploaded, {:.1f}KB downloaded; {} flushes"),
+                                           gpuCounter(GPU::Counter::VRAMUploadBytes) / 1024.0f,
+                                           gpuCounter(GPU::Counter::VRAMDownloadBytes) / 1024.0f,
+                                           gpuCounter(GPU::Counter::Flushes))
+                                   .c_str());
+        ImGui::TextUnformatted(fmt::format(f_("DMA: {} chains, {} packets, {} words"),
+                                           gpuCounter(GPU::Counter::DMAChains),
+                                           gpuCounter(GPU::Counter::DMAChainPackets),
+                                           gpuCounter(GPU::Counter::DMAChainWords))
+                                   .c_str());
+        const auto latency = g_emulator->m_pads->inputLatency();
+        if (latency.samples) {
+            ImGui::Text(_("Keyboard to pad poll: %.2fms, average %.2fms, max %.2fms"), latency.last, latency.average,
+                        latency.max);
+        }
+        ImGui::TextUnformatted(_("The GPU command thread and the SPU thread run alongside the others."));
+    }
+    ImGui::End();
+}
+
 bool PCSX::GUI::showThemes() {
     static const std::function<const char*()> imgui_themes[] = {
         l_("Default theme##Theme name"), l_("Classic##Theme name"), l_("Light##Theme name"), l_("Cherry##Theme name"),
@@ -2588,7 +2871,42 @@ bool PCSX::GUI::about() {
     return changed;
 }
 
+bool PCSX::GUI::idle() {
+    if (g_system->running() || !m_idleThrottling) return false;
+    const auto now = std::chrono::steady_clock::now();
+    if ((now - m_lastDamage) < c_idleSettle) return false;
+    if ((now - m_lastFrame) >= c_idleRefresh) return false;
+    if (glfwWindowShouldClose(m_window)) return false;
+    // This feeds imgui whatever input comes in, the same as polling would, and the next frame gets it.
+    glfwWaitEventsTimeout(std::chrono::duration<double>(c_idlePoll).count());
+    tick();
+    if (m_setupScreenSize || (ImGui::GetCurrentContext()->InputEventsQueue.Size != 0) || g_system->running()) {
+        damage();
+        return false;
+    }
+    return true;
+}
+
+void PCSX::GUI::updateRefreshRate() {
+    GLFWmonitor* monitor = glfwGetWindowMonitor(m_window);
+    if (!monitor) monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    m_presentPacer.setRefreshRate(mode ? mode->refreshRate : 0);
+}
+
 void PCSX::GUI::update(bool vsync) {
+    if (idle()) return;
+    // Emulated frames the display wouldn't have the time to show are skipped, but the input still gets polled
+    // for the emulation, and the frame drawn to the offscreen texture is simply replaced by the next one.
+    if (vsync && m_presentPacing && g_system->running() &&
+        !m_presentPacer.shouldPresent(std::chrono::steady_clock::now())) {
+        FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::GUI);
+        tick();
+        glfwPollEvents();
+        return;
+    }
+    m_lastFrame = std::chrono::steady_clock::now();
+    FrameStats::Scope scope(*g_emulator->m_frameStats, FrameStats::Counter::GUI);
     glDisable(GL_SCISSOR_TEST);
     endFrame();
     startFrame();
@@ -2596,6 +2914,7 @@ void PCSX::GUI::update(bool vsync) {
     // We do this by having the emulated GPU have it most of the time, then let the GUI steal it when it needs it.
     // And in the line afterwards, the GUI gives the GL context back to the emulated GPU.
     g_emulator->m_gpu->setOpenGLContext();
+    g_emulator->m_frameStats->endFrame();
 }
 
 void PCSX::GUI::magicOpen(const char* pathStr) {
@@ -2712,10 +3031,17 @@ bool PCSX::GUI::saveSaveState(std::filesystem::path filename) {
         filename = g_system->getPersistentDir() / filename;
     }
     // TODO: yeet this to libuv's threadpool.
-    ZWriter save(new UvFile(filename, FileOps::TRUNCATE), ZWriter::GZIP);
-    bool success = !save.failed();
-    if (success) save.writeString(SaveStates::save());
-    save.close();
+    IO<File> save(new UvFile(filename, FileOps::TRUNCATE));
+    bool success = !save->failed();
+    if (success) {
+        const std::string state = SaveStates::save();
+        // The thumbnail gets made while the state is being compressed, and goes into a chunk of its own
+        auto thumbnail = std::async(std::launch::async, SaveStates::makeThumbnail, std::string_view(state));
+        GZipChunks::compress(state, save);
+        const std::string serializedThumbnail = thumbnail.get();
+        if (!serializedThumbnail.empty()) GZipChunks::compress(serializedThumbnail, save);
+    }
+    save->close();
     return success;
 }
 
@@ -2723,28 +3049,59 @@ bool PCSX::GUI::loadSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    ZReader save(new PosixFile(filename));
-    if (save.failed()) return false;
-    std::ostringstream os;
-    constexpr unsigned buff_size = 1 << 16;
-    char* buff = new char[buff_size];
+    return readSaveState(filename, [](std::string_view state) { return SaveStates::load(state); });
+}
+
+bool PCSX::GUI::readSaveState(const std::filesystem::path& filename,
+                              std::function<bool(std::string_view)> consumer) {
+    IO<MappedFile> mapped(new MappedFile(filename));
+    if (mapped->failed()) return false;
+    const uint8_t* data = mapped->data();
+    const size_t size = mapped->size();
+
+    // Uncompressed save states get parsed straight out of the mapping, so their RAM, VRAM and SPU RAM only
+    // get copied once, into the emulated hardware.
+    const bool gzip = (size >= 18) && (data[0] == 0x1f) && (data[1] == 0x8b);
+    const bool zlib = (size >= 2) && ((data[0] & 0x0f) == 8) && ((((data[0] << 8) | data[1]) % 31) == 0);
+    if (!gzip && !zlib) return consumer({reinterpret_cast<const char*>(data), size});
+
+    // The ones we write are made of chunks which get inflated in parallel.
+    const std::string_view compressed(reinterpret_cast<const char*>(data), size);
+    std::string state;
+    if (GZipChunks::isChunked(compressed)) {
+        if (!GZipChunks::decompress(compressed, state)) return false;
+        return consumer(state);
+    }
+
+    // Older ones get inflated into a single buffer. The gzip trailer holds the size of the uncompressed
+    // data, modulo 4GB, so the buffer usually has the right size from the start; the extra byte is so that
+    // reading the end of the stream doesn't need to grow it.
+    size_t expected = size * 4;
+    if (gzip) {
+        const uint8_t* trailer = data + size - 4;
+        expected = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (uint32_t(trailer[3]) << 24);
+    }
+    state.resize(expected + 1);
+    size_t total = 0;
+    ZReader save(mapped);
     bool error = false;
 
     while (!save.eof()) {
-        auto cnt = save.read(buff, buff_size);
+        if (total == state.size()) state.resize(state.size() * 2);
+        auto cnt = save.read(state.data() + total, state.size() - total);
         if (cnt == 0) break;
         if (cnt < 0) {
             error = true;
             break;
         }
-        os.write(buff, cnt);
+        total += cnt;
     }
 
     save.close();
-    delete[] buff;
 
-    if (!error) SaveStates::load(os.str());
-    return !error;
+    if (error) return false;
+    state.resize(total);
+    return consumer(state);
 }
 
 bool PCSX::GUI::deleteSaveState(std::filesystem::path filename) {
@@ -22,6 +22,7 @@
 #include <GL/gl3w.h>
 #include <stdarg.h>
 
+#include <chrono>
 #include <functional>
 #include <magic_enum_all.hpp>
 #include <map>
@@ -56,11 +57,13 @@
 #include "gui/widgets/registers.h"
 #include "gui/widgets/shader-editor.h"
 #include "gui/widgets/sio1.h"
+#include "gui/widgets/tracebrowser.h"
 #include "gui/widgets/vram-viewer.h"
 #include "imgui.h"
 #include "imgui_md/imgui_md.h"
 #include "imgui_memory_editor/imgui_memory_editor.h"
 #include "support/eventbus.h"
+#include "support/presentpacer.h"
 #include "support/settings.h"
 #include "support/version.h"
 #include "widgets/memory_observer.h"
@@ -112,12 +115,15 @@ class GUI final : public UI {
     typedef Setting<bool, TYPESTRING("ShowSIO1")> ShowSIO1;
     typedef Setting<bool, TYPESTRING("ShowIsoBrowser")> ShowIsoBrowser;
     typedef Setting<bool, TYPESTRING("ShowGPULogger")> ShowGPULogger;
+    typedef Setting<bool, TYPESTRING("ShowTraceBrowser")> ShowTraceBrowser;
     typedef Setting<int, TYPESTRING("WindowPosX"), 0> WindowPosX;
     typedef Setting<int, TYPESTRING("WindowPosY"), 0> WindowPosY;
     typedef Setting<int, TYPESTRING("WindowSizeX"), 1280> WindowSizeX;
     typedef Setting<int, TYPESTRING("WindowSizeY"), 800> WindowSizeY;
     typedef Setting<bool, TYPESTRING("WindowMaximized"), false> WindowMaximized;
     typedef Setting<int, TYPESTRING("IdleSwapInterval"), 1> IdleSwapInterval;
+    typedef Setting<bool, TYPESTRING("IdleThrottling"), true> IdleThrottling;
+    typedef Setting<bool, TYPESTRING("PresentPacing"), false> PresentPacing;
     typedef Setting<int, TYPESTRING("MainFontSize"), 16> MainFontSize;
     typedef Setting<int, TYPESTRING("MonoFontSize"), 16> MonoFontSize;
     typedef Setting<int, TYPESTRING("GUITheme"), 0> GUITheme;
@@ -156,13 +162,13 @@ class GUI final : public UI {
              ShowCLUTVRAMViewer, ShowVRAMViewer1, ShowVRAMViewer2, ShowVRAMViewer3, ShowVRAMViewer4, ShowMemoryObserver,
              ShowTypedDebugger, ShowPatches, ShowMemcardManager, ShowRegisters, ShowAssembly, ShowDisassembly,
              ShowBreakpoints, ShowNamedSaveStates, ShowEvents, ShowHandlers, ShowKernelLog, ShowCallstacks, ShowSIO1,
-             ShowIsoBrowser, ShowGPULogger, MainFontSize, MonoFontSize, GUITheme, AllowMouseCaptureToggle,
-             EnableRawMouseMotion, WidescreenRatio, ShowPIOCartConfig, ShowMemoryEditor1, ShowMemoryEditor2,
-             ShowMemoryEditor3, ShowMemoryEditor4, ShowMemoryEditor5, ShowMemoryEditor6, ShowMemoryEditor7,
-             ShowMemoryEditor8, ShowParallelPortEditor, ShowScratchpadEditor, ShowHWRegsEditor, ShowBiosEditor,
-             ShowVRAMEditor, MemoryEditor1Addr, MemoryEditor2Addr, MemoryEditor3Addr, MemoryEditor4Addr,
+             ShowIsoBrowser, ShowGPULogger, ShowTraceBrowser, MainFontSize, MonoFontSize, GUITheme,
+             AllowMouseCaptureToggle, EnableRawMouseMotion, WidescreenRatio, ShowPIOCartConfig, ShowMemoryEditor1,
+             ShowMemoryEditor2, ShowMemoryEditor3, ShowMemoryEditor4, ShowMemoryEditor5, ShowMemoryEditor6,
+             ShowMemoryEditor7, ShowMemoryEditor8, ShowParallelPortEditor, ShowScratchpadEditor, ShowHWRegsEditor,
+             ShowBiosEditor, ShowVRAMEditor, MemoryEditor1Addr, MemoryEditor2Addr, MemoryEditor3Addr, MemoryEditor4Addr,
              MemoryEditor5Addr, MemoryEditor6Addr, MemoryEditor7Addr, MemoryEditor8Addr, ParallelPortEditorAddr,
-             ScratchpadEditorAddr, HWRegsEditorAddr, BiosEditorAddr, VRAMEditorAddr>
+             ScratchpadEditorAddr, HWRegsEditorAddr, BiosEditorAddr, VRAMEditorAddr, IdleThrottling, PresentPacing>
         settings;
 
     // imgui can't handle more than one "instance", so...
@@ -214,6 +220,9 @@ class GUI final : public UI {
     void setLua(Lua L);
     void close();
     void update(bool vsync = false);
+    // Keeps the GUI drawing for a little while, even when idle. Anything which changes what the widgets show
+    // while the emulator is paused, without going through user input, should call this.
+    void damage() { m_lastDamage = std::chrono::steady_clock::now(); }
     void flip();
     void setViewport();
     void setFullscreen(bool fullscreen);
@@ -287,6 +296,9 @@ class GUI final : public UI {
     bool showThemes();  // Theme window : Allows for custom imgui themes
     bool about();
     void interruptsScaler();
+    void memoryAccessCounters();
+    void showRunAheadTimings();
+    void showPerformanceOverlay();
 
   public:
     const ImVec2 &getRenderSize() { return m_renderSize; }
@@ -319,11 +331,14 @@ class GUI final : public UI {
     bool &m_fullWindowRender = {settings.get<FullWindowRender>().value};
     bool &m_showMenu = {settings.get<ShowMenu>().value};
     int &m_idleSwapInterval = {settings.get<IdleSwapInterval>().value};
+    bool &m_idleThrottling = {settings.get<IdleThrottling>().value};
+    bool &m_presentPacing = {settings.get<PresentPacing>().value};
     bool m_showThemes = false;
     bool m_showDemo = false;
     bool m_showHandles = false;
     bool m_showAbout = false;
     bool m_showInterruptsScaler = false;
+    bool m_showMemoryAccessCounters = false;
     Widgets::Log m_log = {settings.get<ShowLog>().value};
     struct MemoryEditorWrapper {
         MemoryEditorWrapper(GUI *gui, bool &show, size_t &offsetAddr, size_t baseAddr = 0x0000)
@@ -397,6 +412,7 @@ class GUI final : public UI {
     Widgets::KernelLog m_kernelLog = {settings.get<ShowKernelLog>().value};
 
     Widgets::CallStacks m_callstacks = {settings.get<ShowCallstacks>().value};
+    Widgets::TraceBrowser m_traceBrowser;
 
     Widgets::PIOCart m_pioCart;
     Widgets::SIO1 m_sio1 = {settings.get<ShowSIO1>().value};
@@ -408,6 +424,9 @@ class GUI final : public UI {
   public:
     bool saveSaveState(std::filesystem::path filename);
     bool loadSaveState(std::filesystem::path filename);
+    // Decompresses the save state in this file, if it needs to, and hands it over. This doesn't touch the GUI
+    // nor the emulator, so it can be called from any thread.
+    static bool readSaveState(const std::filesystem::path& filename, std::function<bool(std::string_view)> consumer);
     bool deleteSaveState(std::filesystem::path filename);
     bool saveSaveStateSlot(uint32_t slot);
     bool loadSaveStateSlot(uint32_t slot);
@@ -440,6 +459,7 @@ class GUI final : public UI {
     ImFont *findClosestFont(const std::map<float, ImFont *> &fonts);
     std::set<float> m_allScales;
     bool m_hasJapanese = false;
+    bool m_wantJapanese = false;
     float m_currentScale = 1.0f;
 
     ImFont *loadFont(const PCSX::u8string &name, int size, ImGuiIO &io, const ImWchar *ranges, bool combine,
@@ -450,6 +470,20 @@ class GUI final : public UI {
 
     static void byteRateToString(float rate, std::string &out);
 
+    // While the emulator is paused, frames only get drawn after something happened, and for a little while after
+    // that, plus every so often regardless, for what changes on its own, such as Lua scripts or the debug and web
+    // servers poking at the machine. The rest of the time is spent waiting for input, while still polling the
+    // libuv loop.
+    static constexpr std::chrono::milliseconds c_idleSettle{500};
+    static constexpr std::chrono::milliseconds c_idleRefresh{500};
+    static constexpr std::chrono::milliseconds c_idlePoll{50};
+    bool idle();
+    std::chrono::steady_clock::time_point m_lastDamage;
+    std::chrono::steady_clock::time_point m_lastFrame;
+    // Picks the refresh rate of the monitor the window is on, or of the primary one when windowed.
+    void updateRefreshRate();
+    PresentPacer m_presentPacer;
+
     Update m_update;
     bool m_updateAvailable = false;
     bool m_updateDownloading = false;
@@ -458,7 +492,15 @@ class GUI final : public UI {
     void setDefaultShaders();
 
   public:
-    bool hasJapanese() { return m_hasJapanese; }
+    // The Japanese glyphs take a while to build, and only the memory card manager needs them, so they only get
+    // loaded from the next frame on, once this gets called.
+    bool hasJapanese() {
+        if (!m_wantJapanese) {
+            m_wantJapanese = true;
+            m_reloadFonts = true;
+        }
+        return m_hasJapanese;
+    }
     bool m_setupScreenSize = true;
     bool m_clearTextures = true;
     Widgets::ShaderEditor m_offscreenShaderEditor = {"offscreen"};
@@ -29,11 +29,116 @@ float imguiGetViewportDpiScale(unsigned id);
 void imguiLogText(const char* text);
 void guiUseMainFont();
 void guiUseMonoFont();
+
+typedef struct {
+    uint32_t type;
+    uint32_t color;
+    float x0, y0, x1, y1;
+    float thickness;
+    uint32_t text;
+} DrawCommand;
+void imguiDrawBatch(const DrawCommand* commands, unsigned count, const char* const* strings, unsigned target);
 ]]
 
 local C = ffi.load 'IMGUIEXTRA'
 
+-- A batch of draw commands, filled from Lua without crossing over to C, and submitted all at once to either
+-- ImGui, with imgui.extra.drawBatch, or NanoVG, with nvg:drawBatch. Colors are packed as 0xAABBGGRR, like
+-- ImGui's IM_COL32. A batch can be submitted as many times as needed, until cleared.
+local DrawBatch = {}
+DrawBatch.__index = DrawBatch
+DrawBatch.Type = { RECT_FILLED = 0, RECT = 1, LINE = 2, CIRCLE_FILLED = 3, CIRCLE = 4, TEXT = 5 }
+
+function DrawBatch:_push(type, color, x0, y0, x1, y1, thickness, text)
+    local count = self.count
+    if count == self._capacity then
+        local capacity = self._capacity * 2
+        local commands = ffi.new('DrawCommand[?]', capacity)
+        ffi.copy(commands, self.commands, ffi.sizeof('DrawCommand') * count)
+        self.commands = commands
+        self._capacity = capacity
+    end
+    local c = self.commands[count]
+    c.type = type
+    c.color = color
+    c.x0 = x0
+    c.y0 = y0
+    c.x1 = x1
+    c.y1 = y1
+    c.thickness = thickness or 0
+    c.text = text or 0
+    self.count = count + 1
+end
+
+function DrawBatch:clear()
+    self.count = 0
+    self._strings = {}
+    self._stringIndices = {}
+    self._stringCount = 0
+end
+
+function DrawBatch:rect(x, y, w, h, color, thickness)
+    self:_push(DrawBatch.Type.RECT, color, x, y, x + w, y + h, thickness)
+end
+function DrawBatch:rectFilled(x, y, w, h, color)
+    self:_push(DrawBatch.Type.RECT_FILLED, color, x, y, x + w, y + h)
+end
+function DrawBatch:line(x0, y0, x1, y1, color, thickness)
+    self:_push(DrawBatch.Type.LINE, color, x0, y0, x1, y1, thickness)
+end
+function DrawBatch:circle(x, y, radius, color, thickness)
+    self:_push(DrawBatch.Type.CIRCLE, color, x, y, radius, 0, thickness)
+end
+function DrawBatch:circleFilled(x, y, radius, color)
+    self:_push(DrawBatch.Type.CIRCLE_FILLED, color, x, y, radius, 0)
+end
+-- Identical strings only get stored once per batch.
+function DrawBatch:text(x, y, str, color, size)
+    local index = self._stringIndices[str]
+    if index == nil then
+        index = self._stringCount
+        self._strings[index] = str
+        self._stringIndices[str] = index
+        self._stringCount = index + 1
+    end
+    self:_push(DrawBatch.Type.TEXT, color, x, y, 0, 0, size, index)
+end
+
+-- The strings are only referenced by the C side, so they stay anchored in the batch until the next clear.
+function DrawBatch:_stringsArray()
+    local strings = ffi.new('const char*[?]', self._stringCount + 1)
+    for i = 0, self._stringCount - 1 do strings[i] = self._strings[i] end
+    return strings
+end
+
 imgui.extra = {
+    DrawBatch = {
+        New = function(capacity)
+            capacity = capacity or 1024
+            local batch = setmetatable({
+                commands = ffi.new('DrawCommand[?]', capacity),
+                count = 0,
+                _capacity = capacity,
+            }, DrawBatch)
+            batch:clear()
+            return batch
+        end,
+        Type = DrawBatch.Type,
+        Color = function(r, g, b, a)
+            a = a or 255
+            return bit.bor(bit.lshift(a, 24), bit.lshift(b, 16), bit.lshift(g, 8), r)
+        end,
+    },
+    -- The target can be 'window' (the default), 'foreground', or 'background'.
+    drawBatch = function(batch, target)
+        local t = 0
+        if target == 'foreground' then
+            t = 1
+        elseif target == 'background' then
+            t = 2
+        end
+        C.imguiDrawBatch(batch.commands, batch.count, batch:_stringsArray(), t)
+    end,
     ImVec2 = {
         New = function(x, y)
             local ret = ffi.new('ImVec2')
@@ -42,6 +42,42 @@ void imguiLogText(const char* text) { ImGui::LogText("%s", text); }
 void guiUseMainFont() { s_gui->useMainFont(); }
 void guiUseMonoFont() { s_gui->useMonoFont(); }
 
+// The target is 0 for the current window, 1 for the foreground of the current viewport, and 2 for its background.
+void imguiDrawBatch(const PCSX::LuaFFI::DrawCommand* commands, unsigned count, const char* const* strings,
+                    unsigned target) {
+    using Command = PCSX::LuaFFI::DrawCommand;
+    ImDrawList* drawList = target == 1   ? ImGui::GetForegroundDrawList()
+                           : target == 2 ? ImGui::GetBackgroundDrawList()
+                                         : ImGui::GetWindowDrawList();
+    ImFont* font = ImGui::GetFont();
+    const float fontSize = ImGui::GetFontSize();
+    for (unsigned i = 0; i < count; i++) {
+        const auto& c = commands[i];
+        const float thickness = c.thickness > 0.0f ? c.thickness : 1.0f;
+        switch (c.type) {
+            case Command::RECT_FILLED:
+                drawList->AddRectFilled({c.x0, c.y0}, {c.x1, c.y1}, c.color);
+                break;
+            case Command::RECT:
+                drawList->AddRect({c.x0, c.y0}, {c.x1, c.y1}, c.color, 0.0f, 0, thickness);
+                break;
+            case Command::LINE:
+                drawList->AddLine({c.x0, c.y0}, {c.x1, c.y1}, c.color, thickness);
+                break;
+            case Command::CIRCLE_FILLED:
+                drawList->AddCircleFilled({c.x0, c.y0}, c.x1, c.color);
+                break;
+            case Command::CIRCLE:
+                drawList->AddCircle({c.x0, c.y0}, c.x1, c.color, 0, thickness);
+                break;
+            case Command::TEXT:
+                drawList->AddText(font, c.thickness > 0.0f ? c.thickness : fontSize, {c.x0, c.y0}, c.color,
+                                  strings[c.text]);
+                break;
+        }
+    }
+}
+
 template <typename T, size_t S>
 void registerSymbol(PCSX::Lua L, const char (&name)[S], const T ptr) {
     L.push<S>(name);
@@ -67,6 +103,7 @@ void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, imguiLogText);
     REGISTER(L, guiUseMainFont);
     REGISTER(L, guiUseMonoFont);
+    REGISTER(L, imguiDrawBatch);
 
     L.settable();
     L.pop();
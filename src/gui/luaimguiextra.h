@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "lua/luawrapper.h"
 
 namespace PCSX {
@@ -29,6 +31,22 @@ namespace LuaFFI {
 
 void open_imguiextra(GUI*, Lua L);
 
+// One entry of the draw batches Lua scripts fill up, to then submit them all at once to either ImGui or NanoVG.
+// This has to match the DrawCommand declaration in imguiextraffi.lua.
+struct DrawCommand {
+    enum Type : uint32_t { RECT_FILLED = 0, RECT = 1, LINE = 2, CIRCLE_FILLED = 3, CIRCLE = 4, TEXT = 5 };
+    uint32_t type;
+    // Packed the same way as ImGui's IM_COL32, which is 0xAABBGGRR.
+    uint32_t color;
+    // Rectangles and lines go from (x0, y0) to (x1, y1). Circles are centered on (x0, y0), with a radius of x1.
+    // Text starts at (x0, y0).
+    float x0, y0, x1, y1;
+    // The stroke width, or the font size for text, where 0 means the current one.
+    float thickness;
+    // For text, the index of its string in the batch.
+    uint32_t text;
+};
+
 }
 
 }  // namespace PCSX
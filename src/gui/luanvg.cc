@@ -20,6 +20,7 @@
 #include "gui/luanvg.h"
 
 #include "gui/gui.h"
+#include "gui/luaimguiextra.h"
 #include "lua/luawrapper.h"
 #include "nanovg/src/nanovg.h"
 
@@ -59,6 +60,58 @@ void nvgImagePatternWrapper(NVGcontext* ctx, float ox, float oy, float ex, float
     *ret = nvgImagePattern(ctx, ox, oy, ex, ey, angle, image, alpha);
 }
 
+NVGcolor unpackColor(uint32_t color) {
+    return nvgRGBA(color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, color >> 24);
+}
+
+// Consecutive shapes of the same kind, color, and width, end up in the same path, filled or stroked only once.
+void nvgDrawBatch(NVGcontext* ctx, const PCSX::LuaFFI::DrawCommand* commands, unsigned count,
+                  const char* const* strings) {
+    using Command = PCSX::LuaFFI::DrawCommand;
+    nvgSave(ctx);
+    for (unsigned i = 0; i < count;) {
+        const auto& first = commands[i];
+        if (first.type == Command::TEXT) {
+            if (first.thickness > 0.0f) nvgFontSize(ctx, first.thickness);
+            nvgFillColor(ctx, unpackColor(first.color));
+            nvgText(ctx, first.x0, first.y0, strings[first.text], nullptr);
+            i++;
+            continue;
+        }
+        nvgBeginPath(ctx);
+        unsigned j = i;
+        for (; j < count; j++) {
+            const auto& c = commands[j];
+            if ((c.type != first.type) || (c.color != first.color) || (c.thickness != first.thickness)) break;
+            switch (c.type) {
+                case Command::RECT_FILLED:
+                case Command::RECT:
+                    nvgRect(ctx, c.x0, c.y0, c.x1 - c.x0, c.y1 - c.y0);
+                    break;
+                case Command::LINE:
+                    nvgMoveTo(ctx, c.x0, c.y0);
+                    nvgLineTo(ctx, c.x1, c.y1);
+                    break;
+                case Command::CIRCLE_FILLED:
+                case Command::CIRCLE:
+                    nvgCircle(ctx, c.x0, c.y0, c.x1);
+                    break;
+            }
+        }
+        const auto color = unpackColor(first.color);
+        if ((first.type == Command::RECT_FILLED) || (first.type == Command::CIRCLE_FILLED)) {
+            nvgFillColor(ctx, color);
+            nvgFill(ctx);
+        } else {
+            nvgStrokeColor(ctx, color);
+            nvgStrokeWidth(ctx, first.thickness > 0.0f ? first.thickness : 1.0f);
+            nvgStroke(ctx);
+        }
+        i = j;
+    }
+    nvgRestore(ctx);
+}
+
 template <typename T, size_t S>
 void registerSymbol(PCSX::Lua L, const char (&name)[S], const T ptr) {
     L.push<S>(name);
@@ -170,6 +223,7 @@ void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, nvgTextBreakLines);
 
     REGISTER(L, guiDrawBezierArrow);
+    REGISTER(L, nvgDrawBatch);
 
     L.settable();
     L.pop();
@@ -152,6 +152,7 @@ void nvgTextMetrics(NVGcontext* ctx, float* ascender, float* descender, float* l
 int nvgTextBreakLines(NVGcontext* ctx, const char* string, const char* end, float breakRowWidth, NVGtextRow* rows, int maxRows);
 
 void guiDrawBezierArrow(void* gui, float width, ImVec2 p1, ImVec2 c1, ImVec2 c2, ImVec2 p2, NVGcolor innerColor, NVGcolor outerColor);
+void nvgDrawBatch(NVGcontext* ctx, const DrawCommand* commands, unsigned count, const char* const* strings);
 ]]
 
 -- )EOF"
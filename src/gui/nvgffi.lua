@@ -253,6 +253,9 @@ nvg = {
         local p2 = imgui.extra.ImVec2.New(p2.x, p2.y)
         C.nvgDrawBezierArrow(self._gui, width, p1, c1, c2, p2, innerColor, outerColor)
     end,
+    -- Draws a batch made with imgui.extra.DrawBatch.New. Consecutive shapes of the same kind, color, and width
+    -- get filled or stroked all at once.
+    drawBatch = function(self, batch) C.nvgDrawBatch(self._ctx, batch.commands, batch.count, batch:_stringsArray()) end,
 
     queueNvgRender = function(self, func)
         local viewportId = imgui.extra.getCurrentViewportId()
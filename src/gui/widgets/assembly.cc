@@ -24,10 +24,12 @@
 #include <GLFW/glfw3.h>
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <functional>
 #include <iostream>
 
+#include "core/cycleaccounting.h"
 #include "core/debug.h"
 #include "core/disr3000a.h"
 #include "core/patchmanager.h"
@@ -46,6 +48,7 @@ static ImVec4 s_bpColor = ImColor(0xba, 0x00, 0x0d);
 static ImVec4 s_currentColor = ImColor(0xff, 0xeb, 0x3b);
 static ImVec4 s_arrowColor = ImColor(0x61, 0x61, 0x61);
 static ImVec4 s_arrowOutlineColor = ImColor(0x37, 0x37, 0x37);
+static ImVec4 s_heatColor = ImColor(0xe6, 0x4a, 0x19);
 
 namespace {
 
@@ -87,26 +90,135 @@ void DButton(const char* label, bool enabled, std::function<void(void)> clicked)
     if (!enabled) ImGui::PopStyleColor(3);
 }
 
-class DummyAsm : public PCSX::Disasm {
-    virtual void Invalid() final {}
-    virtual void OpCode(std::string_view str) final {}
-    virtual void GPR(uint8_t reg) final {}
-    virtual void CP0(uint8_t reg) final {}
-    virtual void CP2C(uint8_t reg) final {}
-    virtual void CP2D(uint8_t reg) final {}
-    virtual void HI() final {}
-    virtual void LO() final {}
-    virtual void Imm16(int16_t value) final {}
-    virtual void Imm16u(uint16_t value) final {}
-    virtual void Imm32(uint32_t value) final {}
-    virtual void Target(uint32_t value) final {}
-    virtual void Sa(uint8_t value) final {}
-    virtual void OfB(int16_t offset, uint8_t reg, int size) final {}
-    virtual void BranchDest(uint32_t offset) final {}
-    virtual void Offset(uint32_t offset, int size) final {}
+}  // namespace
+
+class PCSX::Widgets::Assembly::DisasmRecorder : public PCSX::Disasm {
+  public:
+    DisasmRecorder(CachedLine& line) : m_line(line) {}
+
+  private:
+    void push(CachedOperand::Type type, uint32_t value = 0, uint8_t reg = 0, uint8_t size = 0) {
+        m_line.operands.push_back({type, reg, size, value});
+    }
+    virtual void reset() final {
+        m_line.opcode.clear();
+        m_line.operands.clear();
+    }
+    virtual void Invalid() final { push(CachedOperand::Type::Invalid); }
+    virtual void OpCode(std::string_view str) final {
+        m_line.opcode = str;
+        push(CachedOperand::Type::OpCode);
+    }
+    virtual void GPR(uint8_t reg) final { push(CachedOperand::Type::GPR, 0, reg); }
+    virtual void CP0(uint8_t reg) final { push(CachedOperand::Type::CP0, 0, reg); }
+    virtual void CP2C(uint8_t reg) final { push(CachedOperand::Type::CP2C, 0, reg); }
+    virtual void CP2D(uint8_t reg) final { push(CachedOperand::Type::CP2D, 0, reg); }
+    virtual void HI() final { push(CachedOperand::Type::HI); }
+    virtual void LO() final { push(CachedOperand::Type::LO); }
+    virtual void Imm16(int16_t value) final { push(CachedOperand::Type::Imm16, uint16_t(value)); }
+    virtual void Imm16u(uint16_t value) final { push(CachedOperand::Type::Imm16u, value); }
+    virtual void Imm32(uint32_t value) final { push(CachedOperand::Type::Imm32, value); }
+    virtual void Target(uint32_t value) final { push(CachedOperand::Type::Target, value); }
+    virtual void Sa(uint8_t value) final { push(CachedOperand::Type::Sa, value); }
+    virtual void OfB(int16_t offset, uint8_t reg, int size) final {
+        push(CachedOperand::Type::OfB, uint16_t(offset), reg, size);
+    }
+    virtual void BranchDest(uint32_t value) final { push(CachedOperand::Type::BranchDest, value); }
+    virtual void Offset(uint32_t addr, int size) final { push(CachedOperand::Type::Offset, addr, 0, size); }
+
+    CachedLine& m_line;
 };
 
-}  // namespace
+const PCSX::Widgets::Assembly::CachedLine& PCSX::Widgets::Assembly::getCachedLine(uint32_t absAddr, uint32_t code,
+                                                                                   uint32_t nextCode, uint32_t pc) {
+    if (m_disasmCachePseudo != m_pseudo) {
+        m_disasmCache.clear();
+        m_disasmCachePseudo = m_pseudo;
+    }
+    uint32_t pageIndex = absAddr >> c_cachePageShift;
+    auto& page = m_disasmCache[pageIndex];
+    if (!page) {
+        // The listing only ever shows a handful of pages at once, so there's
+        // no need for anything smarter than starting over when it gets big.
+        if (m_disasmCache.size() > c_cacheMaxPages) {
+            m_disasmCache.clear();
+            return getCachedLine(absAddr, code, nextCode, pc);
+        }
+        page.reset(new CachedPage());
+    }
+    CachedLine* line = &(*page)[(absAddr >> 2) & (page->size() - 1)];
+    if (line->valid && ((line->code != code) || (line->nextCode != nextCode))) {
+        page.reset(new CachedPage());
+        line = &(*page)[(absAddr >> 2) & (page->size() - 1)];
+    }
+    if (!line->valid) {
+        DisasmRecorder recorder(*line);
+        bool skipNext = false;
+        bool delaySlotNext = false;
+        recorder.process(code, nextCode, pc, m_pseudo ? &skipNext : nullptr, &delaySlotNext);
+        line->code = code;
+        line->nextCode = nextCode;
+        line->skipNext = skipNext;
+        line->delaySlotNext = delaySlotNext;
+        line->valid = true;
+    }
+    return *line;
+}
+
+void PCSX::Widgets::Assembly::replay(const CachedLine& line) {
+    for (auto& operand : line.operands) {
+        switch (operand.type) {
+            case CachedOperand::Type::Invalid:
+                Invalid();
+                break;
+            case CachedOperand::Type::OpCode:
+                OpCode(line.opcode);
+                break;
+            case CachedOperand::Type::GPR:
+                GPR(operand.reg);
+                break;
+            case CachedOperand::Type::CP0:
+                CP0(operand.reg);
+                break;
+            case CachedOperand::Type::CP2C:
+                CP2C(operand.reg);
+                break;
+            case CachedOperand::Type::CP2D:
+                CP2D(operand.reg);
+                break;
+            case CachedOperand::Type::HI:
+                HI();
+                break;
+            case CachedOperand::Type::LO:
+                LO();
+                break;
+            case CachedOperand::Type::Imm16:
+                Imm16(int16_t(operand.value));
+                break;
+            case CachedOperand::Type::Imm16u:
+                Imm16u(uint16_t(operand.value));
+                break;
+            case CachedOperand::Type::Imm32:
+                Imm32(operand.value);
+                break;
+            case CachedOperand::Type::Target:
+                Target(operand.value);
+                break;
+            case CachedOperand::Type::Sa:
+                Sa(uint8_t(operand.value));
+                break;
+            case CachedOperand::Type::OfB:
+                OfB(int16_t(operand.value), operand.reg, operand.size);
+                break;
+            case CachedOperand::Type::BranchDest:
+                BranchDest(operand.value);
+                break;
+            case CachedOperand::Type::Offset:
+                Offset(operand.value, operand.size);
+                break;
+        }
+    }
+}
 
 uint8_t PCSX::Widgets::Assembly::mem8(uint32_t addr) { return *ptr(addr); }
 uint16_t PCSX::Widgets::Assembly::mem16(uint32_t addr) { return SWAP_LE16(*(int16_t*)ptr(addr)); }
@@ -480,6 +592,7 @@ bool PCSX::Widgets::Assembly::draw(GUI* gui, psxRegisters* registers, Memory* me
             openSymbolsDialog = ImGui::MenuItem(_("Load symbols map"));
             if (ImGui::MenuItem(_("Reset symbols map"))) {
                 cpu->m_symbols.clear();
+                cpu->symbolsChanged();
             }
             ImGui::EndMenu();
         }
@@ -534,11 +647,33 @@ bool PCSX::Widgets::Assembly::draw(GUI* gui, psxRegisters* registers, Memory* me
             ImGui::SliderInt(_("Columns"), &m_numColumns, 0, 32);
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu(_("Cycles"))) {
+            auto& accounting = g_emulator->m_cycleAccounting;
+            bool enabled = accounting->enabled();
+            if (ImGui::MenuItem(_("Cycle accounting"), nullptr, &enabled)) {
+                if (enabled) {
+                    accounting->enable();
+                } else {
+                    accounting->disable();
+                }
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::PushTextWrapPos(glyphWidth * 35.0f);
+                ImGui::TextUnformatted(
+                    _("Attribute what each instruction would cost on the console, including memory waitstates, GTE "
+                      "latencies and DMA stalls, to its address. Only the interpreter does this, and the CPU trace "
+                      "is ignored while it's on."));
+                ImGui::PopTextWrapPos();
+                ImGui::EndTooltip();
+            }
+            if (ImGui::MenuItem(_("Clear cycle accounting"))) accounting->clear();
+            ImGui::MenuItem(_("Heat column"), nullptr, &m_heatColumn);
+            ImGui::EndMenu();
+        }
         ImGui::EndMenuBar();
     }
 
-    DummyAsm dummy;
-
     uint32_t pc = virtToReal(m_registers->pc);
     auto& debugSettings = g_emulator->settings.get<Emulator::SettingDebugSettings>();
     if (ImGui::Checkbox(_("Enable Debugger"), &debugSettings.get<Emulator::DebugSettings::Debug>().value)) {
@@ -607,7 +742,7 @@ settings, otherwise debugging features may not work.)");
         bool skipNext = false;
         bool delaySlotNext = false;
         typedef std::function<void(uint32_t, const char*, uint32_t, uint32_t, uint32_t)> prependType;
-        auto process = [&](uint32_t addr, prependType prepend, PCSX::Disasm* disasm) {
+        auto process = [&](uint32_t addr, prependType prepend, bool render) {
             uint32_t code = 0;
             uint32_t nextCode = 0;
             uint32_t base = 0;
@@ -638,15 +773,24 @@ settings, otherwise debugging features may not work.)");
                 base = 0xbfc00000;
             }
             prepend(code, section, addr | base, absAddr, base);
-            disasm->process(code, nextCode, addr | base, m_pseudo ? &skipNext : nullptr, &delaySlotNext);
+            if (m_pseudo && skipNext) {
+                skipNext = false;
+            } else {
+                const CachedLine& line = getCachedLine(absAddr, code, nextCode, addr | base);
+                if (m_pseudo) skipNext = line.skipNext;
+                delaySlotNext = line.delaySlotNext;
+                if (render) replay(line);
+            }
             m_notch = delaySlotNext && m_delaySlotNotch;
             m_notchAfterSkip[1] = delaySlotNext && m_delaySlotNotch && m_pseudo && skipNext;
         };
         if (clipper.DisplayStart != 0) {
             uint32_t addr = clipper.DisplayStart * 4 - 4;
-            process(addr, [](uint32_t, const char*, uint32_t, uint32_t, uint32_t) {}, &dummy);
+            process(addr, [](uint32_t, const char*, uint32_t, uint32_t, uint32_t) {}, false);
         }
         auto& tree = g_emulator->m_debug->getTree();
+        const uint64_t heatMax = m_heatColumn ? g_emulator->m_cycleAccounting->maxCycles() : 0;
+        const float heatWidth = ImGui::CalcTextSize("000000000000").x;
         for (int x = clipper.DisplayStart; x < clipper.DisplayEnd; x++) {
             uint32_t addr = x * 4;
             const Debug::Breakpoint* currentBP = nullptr;
@@ -700,6 +844,26 @@ settings, otherwise debugging features may not work.)");
                     }
                 }
 
+                if (heatMax) {
+                    const uint64_t cycles = g_emulator->m_cycleAccounting->cycles(dispAddr);
+                    ImVec2 heatPos = ImGui::GetCursorScreenPos();
+                    if (cycles) {
+                        float heat = std::log1p(double(cycles)) / std::log1p(double(heatMax));
+                        ImVec4 color = s_heatColor;
+                        color.w = 0.15f + 0.85f * heat;
+                        drawList->AddRectFilled(
+                            heatPos, ImVec2(heatPos.x + heatWidth, heatPos.y + ImGui::GetTextLineHeight()),
+                            ImColor(color));
+                        ImGui::Text("%12llu", (unsigned long long)cycles);
+                        if (ImGui::IsItemHovered()) {
+                            ImGui::SetTooltip(_("%llu cycles over %llu executions"), (unsigned long long)cycles,
+                                              (unsigned long long)g_emulator->m_cycleAccounting->executions(dispAddr));
+                        }
+                    } else {
+                        ImGui::Text("%12s", "");
+                    }
+                    ImGui::SameLine();
+                }
                 for (int i = 0; i < m_numColumns * ImGui::GetWindowDpiScale(); i++) {
                     ImGui::TextUnformatted(" ");
                     ImGui::SameLine(0.0f, 0.0f);
@@ -770,6 +934,7 @@ settings, otherwise debugging features may not work.)");
                     if (symbol) {
                         if (ImGui::MenuItem(_("Remove symbol"))) {
                             cpu->m_symbols.erase(dispAddr);
+                            cpu->symbolsChanged();
                         }
                     } else {
                         if (ImGui::MenuItem(_("Create symbol here"))) {
@@ -847,7 +1012,7 @@ settings, otherwise debugging features may not work.)");
                 }
             };
             m_notchAfterSkip[0] = m_notchAfterSkip[1];
-            process(addr, l, this);
+            process(addr, l, true);
         }
     }
     std::sort(m_arrows.begin(), m_arrows.end(), [](const auto& a, const auto& b) -> bool {
@@ -1024,6 +1189,7 @@ settings, otherwise debugging features may not work.)");
         ImGui::InputText("##symbol", &m_addSymbolName);
         if (ImGui::Button(_("Add"))) {
             cpu->m_symbols[m_symbolAddress] = m_addSymbolName;
+            cpu->symbolsChanged();
             m_addSymbolName.clear();
             ImGui::CloseCurrentPopup();
         }
@@ -1097,6 +1263,7 @@ if not success then return msg else return nil end
                 if (!addressValid) continue;
                 cpu->m_symbols[address] = name;
             }
+            cpu->symbolsChanged();
         }
     }
 
@@ -21,11 +21,14 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <list>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "core/disr3000a.h"
@@ -62,6 +65,7 @@ class Assembly : private Disasm {
     bool m_pseudo = false;
     bool m_delaySlotNotch = true;
     bool m_displayArrowForJumps = false;
+    bool m_heatColumn = true;
     int m_numColumns = 4;
     char m_jumpAddressString[20];
     uint32_t m_previousPC = 0;
@@ -113,6 +117,54 @@ class Assembly : private Disasm {
     std::map<std::string, uint32_t> m_symbolsCache;
     bool m_symbolsCacheValid = false;
 
+    // Decoded instructions, so that the visible lines don't go through the
+    // disassembler on every frame. A line is the list of calls the
+    // disassembler made for it, which get replayed into the callbacks above.
+    // Lines are keyed on their code words, and grouped by 4kB pages of the
+    // flat address space the listing uses: as soon as a line doesn't match
+    // the memory anymore, its whole page got written to, and gets dropped.
+    struct CachedOperand {
+        enum class Type : uint8_t {
+            Invalid,
+            OpCode,
+            GPR,
+            CP0,
+            CP2C,
+            CP2D,
+            HI,
+            LO,
+            Imm16,
+            Imm16u,
+            Imm32,
+            Target,
+            Sa,
+            OfB,
+            BranchDest,
+            Offset,
+        };
+        Type type;
+        uint8_t reg;
+        uint8_t size;
+        uint32_t value;
+    };
+    struct CachedLine {
+        uint32_t code = 0;
+        uint32_t nextCode = 0;
+        bool valid = false;
+        bool skipNext = false;
+        bool delaySlotNext = false;
+        std::string opcode;
+        std::vector<CachedOperand> operands;
+    };
+    class DisasmRecorder;
+    static constexpr unsigned c_cachePageShift = 12;
+    static constexpr unsigned c_cacheMaxPages = 64;
+    typedef std::array<CachedLine, (1 << c_cachePageShift) / 4> CachedPage;
+    std::unordered_map<uint32_t, std::unique_ptr<CachedPage>> m_disasmCache;
+    bool m_disasmCachePseudo = false;
+    const CachedLine& getCachedLine(uint32_t absAddr, uint32_t code, uint32_t nextCode, uint32_t pc);
+    void replay(const CachedLine& line);
+
     void rebuildSymbolsCache();
     void addMemoryEditorContext(uint32_t addr, int size);
     void addMemoryEditorSubMenu(uint32_t addr, int size);
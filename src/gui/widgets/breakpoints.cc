@@ -83,7 +83,7 @@ void PCSX::Widgets::Breakpoints::draw(const char* title) {
     ImGuiStyle& style = ImGui::GetStyle();
     const float heightSeparator = style.ItemSpacing.y;
     float footerHeight = 0;
-    footerHeight += (heightSeparator * 2 + ImGui::GetTextLineHeightWithSpacing()) * 5;  // 5 footer rows
+    footerHeight += (heightSeparator * 2 + ImGui::GetTextLineHeightWithSpacing()) * 7;  // 7 footer rows
     float glyphWidth = ImGui::GetFontSize();
     ImDrawList* drawList = ImGui::GetWindowDrawList();
 
@@ -130,6 +130,11 @@ void PCSX::Widgets::Breakpoints::draw(const char* title) {
             m_bpEditPopupLabel[sizeof(m_bpEditPopupLabel) - 1] = 0;
         }
         ImGui::PopStyleColor(bp->enabled() ? 1 : 2);
+        if (bp->condition()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled(_("if %s (%llu hits)"), bp->condition()->expression().c_str(),
+                                static_cast<unsigned long long>(bp->hits()));
+        }
 
         if (debugger->lastBP() != &*bp) continue;
         ImVec2 a, b, c, d, e;
@@ -163,17 +168,34 @@ void PCSX::Widgets::Breakpoints::draw(const char* title) {
     ImGui::SliderInt(_("Breakpoint Width"), &m_breakpointWidth, 1, 4);
     addBreakpoint = addBreakpoint || ImGui::InputText(_("Label"), m_bpLabelString, sizeof(m_bpLabelString),
                                                       ImGuiInputTextFlags_EnterReturnsTrue);
+    addBreakpoint = addBreakpoint || ImGui::InputText(_("Condition"), m_bpConditionString, sizeof(m_bpConditionString),
+                                                      ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGuiHelpers::ShowHelpMarker(
+        _("Only break when this expression is true, such as a0 == 3 && u16[sp + 8] > 100, or hits % 10 == 0. "
+          "Registers can be named as r4 or a0, plus pc, hi and lo; memory can be read with u8[], u16[], u32[], "
+          "s8[] and s16[]; address and width are the access which hit the breakpoint, and hits how many times it "
+          "did."));
     if (ImGui::Button(_("Add Breakpoint")) || addBreakpoint) {
         char* endPtr;
         uint32_t breakpointAddress = strtoul(m_bpAddressString, &endPtr, 16);
         if (*m_bpAddressString && !*endPtr) {
-            debugger->addBreakpoint(breakpointAddress, Debug::BreakpointType(m_breakpointType), m_breakpointWidth,
-                                    _("GUI"), m_bpLabelString);
-            // we clear the label string because it seems more likely that the user would forget to clear the field
-            // than that they want to use the same label twice
-            m_bpLabelString[0] = 0;
+            auto bp = debugger->addBreakpoint(breakpointAddress, Debug::BreakpointType(m_breakpointType),
+                                              m_breakpointWidth, _("GUI"), m_bpLabelString);
+            m_bpConditionError.clear();
+            if (bp->condition(m_bpConditionString, m_bpConditionError)) {
+                // we clear the label string because it seems more likely that the user would forget to clear the
+                // field than that they want to use the same label twice
+                m_bpLabelString[0] = 0;
+                m_bpConditionString[0] = 0;
+            } else {
+                debugger->removeBreakpoint(bp);
+            }
         }
     }
+    if (!m_bpConditionError.empty()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), _("Invalid condition: %s"), m_bpConditionError.c_str());
+    }
     ImGui::End();
 
     if (!editorToOpen.empty()) {
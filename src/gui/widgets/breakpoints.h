@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "core/debug.h"
 
 namespace PCSX {
@@ -45,6 +47,8 @@ class Breakpoints {
     int m_breakpointType = 0;
     int m_breakpointWidth = 1;
     char m_bpLabelString[100] = "";
+    char m_bpConditionString[200] = "";
+    std::string m_bpConditionError;
     char m_bpEditPopupLabel[100] = "";
 };
 
@@ -41,6 +41,16 @@ static void drawSymbol(uint32_t pc) {
     }
 }
 
+void PCSX::Widgets::CallStacks::track(bool needed) {
+    if (m_tracking == needed) return;
+    m_tracking = needed;
+    if (needed) {
+        g_emulator->m_callStacks->subscribe();
+    } else {
+        g_emulator->m_callStacks->unsubscribe();
+    }
+}
+
 void PCSX::Widgets::CallStacks::draw(const char* title, PCSX::GUI* gui) {
     if (!ImGui::Begin(title, &m_show)) {
         ImGui::End();
@@ -54,13 +64,13 @@ void PCSX::Widgets::CallStacks::draw(const char* title, PCSX::GUI* gui) {
     ImGui::Separator();
 
     auto& callstacks = g_emulator->m_callStacks;
-    auto& current = callstacks->getCurrent();
+    const PCSX::CallStacks::CallStack* current = callstacks->hasCurrent() ? &callstacks->getCurrent() : nullptr;
 
     for (auto& stack : callstacks->getCallstacks()) {
         uint32_t low = stack.getLow();
         uint32_t high = stack.getHigh();
         if (stack.calls.size() == 0) continue;
-        bool isCurrent = &current == &stack;
+        bool isCurrent = current == &stack;
         std::string label = fmt::format("0x{:08x} - 0x{:08x}", low, high);
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Bullet | ImGuiTreeNodeFlags_DefaultOpen;
         if (isCurrent) flags |= ImGuiTreeNodeFlags_Selected;
@@ -31,8 +31,13 @@ class CallStacks {
   public:
     CallStacks(bool& show) : m_show(show) {}
     void draw(const char* title, GUI*);
+    // Subscribes to the core's call stacks tracking while needed, and unsubscribes once not anymore.
+    void track(bool needed);
 
     bool& m_show;
+
+  private:
+    bool m_tracking = false;
 };
 
 }  // namespace Widgets
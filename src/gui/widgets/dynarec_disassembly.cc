@@ -111,6 +111,7 @@ void PCSX::Widgets::Disassembly::draw(GUI* gui, const char* title) {
     // Show buffer size returned from disassembly function
     ImGui::Text(_("Code size: %.2fMB"), (double)m_codeSize / (1024 * 1024));
     ImGui::Separator();
+    drawRegions();
 
     if (m_mono) {
         gui->useMonoFont();
@@ -151,6 +152,38 @@ void PCSX::Widgets::Disassembly::draw(GUI* gui, const char* title) {
     ImGui::End();
 }
 
+void PCSX::Widgets::Disassembly::drawRegions() {
+    const auto regions = PCSX::g_emulator->m_cpu->getCodeBufferRegions();
+    if (regions.empty()) return;
+    const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (!ImGui::BeginTable("Regions", 5, flags)) return;
+    ImGui::TableSetupColumn(_("Region"));
+    ImGui::TableSetupColumn(_("Used"));
+    ImGui::TableSetupColumn(_("Compiles"));
+    ImGui::TableSetupColumn(_("Emitted"));
+    ImGui::TableSetupColumn(_("Flushes"));
+    ImGui::TableHeadersRow();
+    for (const auto& region : regions) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(region.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f / %.2fMB", region.used / (1024.0 * 1024.0), region.capacity / (1024.0 * 1024.0));
+        ImGui::TableNextColumn();
+        ImGui::Text("%" PRIu64, region.compiles);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2fMB", region.bytes / (1024.0 * 1024.0));
+        ImGui::TableNextColumn();
+        ImGui::Text("%" PRIu64, region.flushes);
+    }
+    ImGui::EndTable();
+    const auto loadDelays = PCSX::g_emulator->m_cpu->getLoadDelayStats();
+    ImGui::Text(_("Pending loads on block entry: %" PRIu64 " landed right away, %" PRIu64
+                  " needed full load delays (%" PRIu64 " variants compiled)"),
+                loadDelays.resolvedAtEntry, loadDelays.fullEntries, loadDelays.fullCompiles);
+    ImGui::Separator();
+}
+
 size_t PCSX::Widgets::Disassembly::disassembleBuffer() {
     csh handle;
     cs_insn* insn;
@@ -177,9 +210,15 @@ size_t PCSX::Widgets::Disassembly::disassembleBuffer() {
     }
     // Set SKIPDATA option as to not break disassembler
     cs_option(handle, CS_OPT_SKIPDATA, CS_OPT_ON);
+    // The buffer may be split in regions, with nothing but garbage past the used part of each
+    auto regions = PCSX::g_emulator->m_cpu->getCodeBufferRegions();
+    if (regions.empty()) regions.push_back({"", 0, bufferSize, bufferSize, 0, 0, 0});
     // Walk code buffer and try to disassemble
-    count = cs_disasm(handle, buffer, bufferSize, 0x0, 0, &insn);
-    if (count > 0) {
+    size_t total = 0;
+    for (const auto& region : regions) {
+        if (region.used == 0) continue;
+        if (region.name[0]) addInstruction(fmt::sprintf("----%s----\n", region.name));
+        count = cs_disasm(handle, buffer + region.start, region.used, region.start, 0, &insn);
         for (size_t j = 0; j < count; j++) {
             // Write instruction (address, mnemonic, and operand to string
             std::string s =
@@ -188,7 +227,10 @@ size_t PCSX::Widgets::Disassembly::disassembleBuffer() {
             addInstruction(s);
         }
         // Call free to clean up memory allocated by capstone
-        cs_free(insn, count);
+        if (count > 0) cs_free(insn, count);
+        total += count;
+    }
+    if (total > 0) {
         // to show the end of the disassembly for the disassembled buffer
         addInstruction("----End of disassembly----\n");
         // If disassembly failed, log the error and close out disassembler
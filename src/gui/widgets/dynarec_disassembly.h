@@ -61,6 +61,7 @@ class Disassembly {
 
     // Class Methods
     size_t disassembleBuffer();
+    void drawRegions();
     void addInstruction(const std::string& str) {
         if (m_items.size() >= 320000) m_items.clear();
         m_items.push_back(str);
@@ -19,6 +19,8 @@
 
 #include "gui/widgets/gpulogger.h"
 
+#include <algorithm>
+
 #include "core/gpulogger.h"
 #include "core/psxemulator.h"
 #include "core/system.h"
@@ -68,8 +70,9 @@ void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title)
         ImGui::EndMenuBar();
     }
 
-    if (ImGui::Checkbox(_("GPU logging"), &logger->m_enabled)) {
-        if (logger->m_enabled) {
+    bool enabled = logger->isEnabled();
+    if (ImGui::Checkbox(_("GPU logging"), &enabled)) {
+        if (enabled) {
             logger->enable();
         } else {
             logger->disable();
@@ -77,8 +80,15 @@ void PCSX::Widgets::GPULogger::draw(PCSX::GPULogger* logger, const char* title)
     }
     ImGuiHelpers::ShowHelpMarker(
         _("Logs each frame's draw calls. When enabled, all the commands sent to the GPU will be logged and displayed "
-          "here. This will contain only a single frame worth of commands. The feature can be pretty demanding in CPU "
-          "and memory."));
+          "here. This will contain only the number of frames worth of commands set below. The feature can be pretty "
+          "demanding in CPU and memory."));
+    int framesToKeep = logger->getFramesToKeep();
+    if (ImGui::InputInt(_("Frames to keep"), &framesToKeep)) {
+        logger->setFramesToKeep(std::clamp(framesToKeep, 1, 60));
+    }
+    ImGuiHelpers::ShowHelpMarker(
+        _("The number of frames the logger keeps the commands of, for captures spanning multiple frames. Changing "
+          "this clears the log."));
     ImGui::Checkbox(_("Breakpoint on vsync"), &logger->m_breakOnVSync);
     ImGui::SameLine();
     if (ImGui::Button(_("Resume"))) {
@@ -19,9 +19,8 @@
 
 #include "gui/widgets/isobrowser.h"
 
-#include <zlib.h>
-
 #include <chrono>
+#include <cinttypes>
 
 #include "core/cdrom.h"
 #include "fmt/format.h"
@@ -29,31 +28,6 @@
 #include "support/imgui-helpers.h"
 #include "support/uvfile.h"
 
-PCSX::Coroutine<> PCSX::Widgets::IsoBrowser::computeCRC(PCSX::CDRIso* iso) {
-    auto time = std::chrono::steady_clock::now();
-
-    uint32_t fullCRC = crc32(0L, Z_NULL, 0);
-    uint32_t lba = 0;
-    for (unsigned t = 1; t <= iso->getTN(); t++) {
-        uint32_t len = iso->getLength(t).toLBA();
-        uint32_t crc = crc32(0L, Z_NULL, 0);
-        uint8_t buffer[2352];
-        for (unsigned s = 0; s < len; s++) {
-            iso->readSectors(lba++, buffer, 1);
-            fullCRC = crc32(fullCRC, buffer, 2352);
-            crc = crc32(crc, buffer, 2352);
-            if (std::chrono::steady_clock::now() - time > std::chrono::milliseconds(50)) {
-                m_crcProgress = (float)s / (float)len;
-                co_yield m_crcCalculator.awaiter();
-                time = std::chrono::steady_clock::now();
-            }
-        }
-        m_crcs[t] = crc;
-    }
-
-    m_fullCRC = fullCRC;
-};
-
 void PCSX::Widgets::IsoBrowser::draw(CDRom* cdrom, const char* title) {
     if (!ImGui::Begin(title, &m_show, ImGuiWindowFlags_MenuBar)) {
         ImGui::End();
@@ -90,7 +64,10 @@ void PCSX::Widgets::IsoBrowser::draw(CDRom* cdrom, const char* title) {
             g_emulator->m_cdrom->check();
         }
     }
-    auto iso = cdrom->m_iso.get();
+    auto isoPtr = cdrom->getIso();
+    auto iso = isoPtr.get();
+    // The results are for a disc that's not there anymore
+    if (m_hasher && (m_hashedIso.lock() != isoPtr)) m_hasher.reset();
 
     if (iso->failed()) {
         ImGui::PushTextWrapPos(0.0f);
@@ -124,32 +101,59 @@ void PCSX::Widgets::IsoBrowser::draw(CDRom* cdrom, const char* title) {
         if (!canCache) ImGui::EndDisabled();
     }
 
-    if (m_crcCalculator.done()) {
-        if (ImGui::Button(_("Compute CRCs"))) {
-            m_crcProgress = 0.0f;
-            m_crcCalculator = computeCRC(iso);
-        }
+    {
+        auto& readAhead = iso->getDataReadAhead();
+        const uint64_t hits = readAhead.hits();
+        const uint64_t misses = readAhead.misses();
+        const double stall = std::chrono::duration<double, std::milli>(readAhead.stallTime()).count();
+        ImGui::Text(_("Read-ahead: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%%), %.1fms stalled"), hits, misses,
+                    (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0, stall);
+        ImGui::SameLine();
+        if (ImGui::Button(_("Reset counters"))) readAhead.resetCounters();
+        ImGuiHelpers::ShowHelpMarker(_(R"(The data sectors following the one the
+emulated drive is reading are read in the background,
+so that it doesn't have to wait on the disk image. The
+stall time is how long the emulation had to wait on
+the sectors which weren't read ahead.)"));
+    }
 
-        ImGuiHelpers::ShowHelpMarker(_(R"(Computes the CRC32 of each track, and of
-the whole disk. The CRC32 is computed on the raw data,
-after decompression of the tracks. This is useful to
-check the disk image against redump's information.
+    const auto status = m_hasher ? m_hasher->status() : DiscHasher::Status::CANCELLED;
+    const bool hashed = m_hasher && (status == DiscHasher::Status::DONE);
+    if (status != DiscHasher::Status::RUNNING) {
+        if (ImGui::Button(_("Compute hashes"))) {
+            m_hasher.reset(new DiscHasher(isoPtr));
+            m_hashedIso = isoPtr;
+        }
 
-The computation can be slow, and can be sped up
-significantly by caching the files beforehand.)"));
+        ImGuiHelpers::ShowHelpMarker(_(R"(Computes the CRC32, MD5 and SHA1 of each
+track, and the CRC32 of the whole disk. The hashes are
+computed on the raw data, after decompression of the
+tracks. This is useful to check the disk image against
+redump's information.
+
+The computation runs in the background, and can be
+sped up significantly by caching the files beforehand.)"));
+        if (m_hasher && (status == DiscHasher::Status::FAILED)) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(_("Reading the disk image failed."));
+        }
     } else {
-        ImGui::ProgressBar(m_crcProgress);
-        m_crcCalculator.resume();
+        ImGui::ProgressBar(m_hasher->progress());
+        ImGui::SameLine();
+        if (ImGui::Button(_("Cancel"))) m_hasher->cancel();
     }
 
-    auto str = fmt::format(f_("Disc size: {} ({}) - CRC32: {:08x}"), iso->getTD(0), iso->getTD(0).toLBA(), m_fullCRC);
+    auto str = fmt::format(f_("Disc size: {} ({}) - CRC32: {:08x}"), iso->getTD(0), iso->getTD(0).toLBA(),
+                           hashed ? m_hasher->fullCRC32() : 0);
     ImGui::TextUnformatted(str.c_str());
-    if (ImGui::BeginTable("Tracks", 5, ImGuiTableFlags_Resizable)) {
+    if (ImGui::BeginTable("Tracks", 7, ImGuiTableFlags_Resizable)) {
         ImGui::TableSetupColumn(_("Track"));
         ImGui::TableSetupColumn(_("Start"));
         ImGui::TableSetupColumn(_("Length"));
         ImGui::TableSetupColumn(_("Pregap"));
         ImGui::TableSetupColumn("CRC32");
+        ImGui::TableSetupColumn("MD5");
+        ImGui::TableSetupColumn("SHA1");
         ImGui::TableHeadersRow();
         for (unsigned t = 1; t <= iso->getTN(); t++) {
             ImGui::TableNextRow();
@@ -164,9 +168,15 @@ significantly by caching the files beforehand.)"));
             ImGui::TableSetColumnIndex(3);
             str = fmt::format("{} ({})", iso->getPregap(t), iso->getPregap(t).toLBA());
             ImGui::TextUnformatted(str.c_str());
+            if (!hashed || (t > m_hasher->tracks().size())) continue;
+            const auto& track = m_hasher->tracks()[t - 1];
             ImGui::TableSetColumnIndex(4);
-            str = fmt::format("{:08x}", m_crcs[t]);
+            str = fmt::format("{:08x}", track.crc32);
             ImGui::TextUnformatted(str.c_str());
+            ImGui::TableSetColumnIndex(5);
+            ImGui::TextUnformatted(track.md5String().c_str());
+            ImGui::TableSetColumnIndex(6);
+            ImGui::TextUnformatted(track.sha1String().c_str());
         }
         ImGui::EndTable();
     }
@@ -22,11 +22,12 @@
 #include <stdint.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "cdrom/dischasher.h"
 #include "gui/widgets/filedialog.h"
-#include "support/coroutine.h"
 
 namespace PCSX {
 
@@ -44,12 +45,8 @@ class IsoBrowser {
     bool& m_show;
 
   private:
-    uint32_t m_fullCRC = 0;
-    uint32_t m_crcs[100] = {0};
-    Coroutine<> m_crcCalculator;
-    float m_crcProgress = 0.0f;
-
-    Coroutine<> computeCRC(CDRIso*);
+    std::unique_ptr<DiscHasher> m_hasher;
+    std::weak_ptr<CDRIso> m_hashedIso;
     FileDialog<> m_openIsoFileDialog;
 };
 
@@ -50,11 +50,13 @@ void PCSX::Widgets::Log::deserialize(const json& j) {
             c->displayed = j[name]["displayed"];
         }
     }
+    rebuildActive();
 }
 
-PCSX::Widgets::Log::Log(bool& show) : m_show(show) {
+PCSX::Widgets::Log::Log(bool& show) : m_show(show), m_store(magic_enum::enum_count<LogClass>()) {
+    unsigned index = 0;
     for (auto logClass : magic_enum::enum_values<LogClass>()) {
-        addClass(magic_enum::enum_integer(logClass), std::string{magic_enum::enum_name(logClass)});
+        addClass(magic_enum::enum_integer(logClass), index++, std::string{magic_enum::enum_name(logClass)});
     }
 }
 
@@ -144,21 +146,21 @@ bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
     if (copy) ImGui::LogToClipboard();
 
     ImGuiListClipper clipper;
-    clipper.Begin(m_activeLogs.size());
+    clipper.Begin(m_store.size());
 
     if (filter.IsActive()) {  // Filter for logs if filter is active
-        for (auto& m_activeLog : m_activeLogs) {
-            auto& s = m_activeLog.entry;
-            if (filter.PassFilter(s.c_str(), s.c_str() + s.length()))
-                ImGui::TextUnformatted(s.c_str(), s.c_str() + s.length());
+        for (size_t i = 0; i < m_store.size(); i++) {
+            auto s = m_store[i];
+            if (filter.PassFilter(s.data(), s.data() + s.length())) {
+                ImGui::TextUnformatted(s.data(), s.data() + s.length());
+            }
         }
     } else {
         // Otherwise, Display logs for selected log class as normal when filter is not active
         while (clipper.Step()) {
-            for (auto i = m_activeLogs.find(clipper.DisplayStart);
-                 i != m_activeLogs.end() && i->getLow() < clipper.DisplayEnd; i++) {
-                auto& s = i->entry;
-                ImGui::TextUnformatted(s.c_str(), s.c_str() + s.length());
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                auto s = m_store[i];
+                ImGui::TextUnformatted(s.data(), s.data() + s.length());
             }
         }
     }
@@ -174,16 +176,7 @@ bool PCSX::Widgets::Log::draw(GUI* gui, const char* title) {
 }
 
 void PCSX::Widgets::Log::rebuildActive() {
-    m_activeLogs.clear();
-
-    for (auto& e : m_allLogs) {
-        ClassElement* c = nullptr;
-        for (auto& cl : m_classes) {
-            if (cl.list.contains(&e)) {
-                c = &cl;
-                break;
-            }
-        }
-        if (c && c->enabled && c->displayed) m_activeLogs.insert(m_activeLogs.size(), &e);
-    }
+    std::vector<bool> visible(magic_enum::enum_count<LogClass>());
+    for (auto& c : m_classes) visible[c.index] = c.enabled && c.displayed;
+    m_store.setVisible(visible);
 }
@@ -25,9 +25,8 @@
 #include "imgui.h"
 #include "json.hpp"
 #include "support/hashtable.h"
-#include "support/list.h"
+#include "support/logstore.h"
 #include "support/strings-helpers.h"
-#include "support/tree.h"
 
 namespace PCSX {
 class GUI;
@@ -39,11 +38,8 @@ class Log {
     json serialize() const;
     void deserialize(const json& j);
     Log(bool& show);
-    ~Log() {
-        clear();
-        m_classes.destroyAll();
-    }
-    void clear() { m_allLogs.destroyAll(); }
+    ~Log() { m_classes.destroyAll(); }
+    void clear() { m_store.clear(); }
     template <size_t L>
     bool addLog(unsigned logClass, const char (&log)[L]) {
         std::string str(log);
@@ -61,12 +57,7 @@ class Log {
         auto lines = StringsHelpers::split(c->buffer, "\n", true);
         c->buffer = lines.back();
         lines.pop_back();
-        for (auto& line : lines) {
-            Element* element = new Element(std::move(line));
-            c->list.push_back(element);
-            m_allLogs.push_back(element);
-            if (c->displayed) m_activeLogs.insert(m_activeLogs.size(), element);
-        }
+        for (auto& line : lines) m_store.append(c->index, line);
         return true;
     }
     bool draw(GUI* gui, const char* title);
@@ -74,32 +65,25 @@ class Log {
     bool& m_show;
 
   private:
-    void addClass(unsigned logClass, const std::string& s) { m_classes.insert(logClass, new ClassElement(s)); }
+    void addClass(unsigned logClass, unsigned index, const std::string& s) {
+        m_classes.insert(logClass, new ClassElement(s, index));
+    }
     void rebuildActive();
-    struct Element;
-    struct Class {};
-    typedef Intrusive::List<Element> All;
-    typedef Intrusive::Tree<unsigned, Element> ActiveTree;
-    typedef Intrusive::List<Element, Class> ClassList;
-    struct Element : public All::Node, public ActiveTree::Node, public ClassList::Node {
-        Element(const std::string& e) : entry(e) {}
-        Element(std::string&& e) : entry(std::move(e)) {}
-        const std::string entry;
-    };
 
-    All m_allLogs;
-    ActiveTree m_activeLogs;
     struct ClassElement;
     typedef Intrusive::HashTable<unsigned, ClassElement> ClassMap;
     struct ClassElement : public ClassMap::Node {
-        ClassElement(const std::string& n) : name(n) {}
+        ClassElement(const std::string& n, unsigned i) : name(n), index(i) {}
         const std::string name;
+        // The class' channel in the log store
+        const unsigned index;
         std::string buffer;
-        ClassList list;
         bool enabled = true;
         bool displayed = true;
     };
     ClassMap m_classes;
+    // Each class keeps up to 256k lines, after which its oldest lines go away
+    LogStore m_store;
 
     bool m_scrollToBottom = false;
     bool m_follow = true;
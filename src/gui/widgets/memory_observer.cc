@@ -34,12 +34,9 @@
 
 PCSX::Widgets::MemoryObserver::MemoryObserver(bool& show) : m_show(show), m_listener(g_system->m_eventBus) {
     m_listener.listen<PCSX::Events::GPU::VSync>([this](const auto& event) {
-        for (const auto& addressValuePair : m_addressValuePairs) {
-            if (addressValuePair.frozen) {
-                const auto dataSize = getStrideFromValueType(m_scanValueType);
-                memcpy(g_emulator->m_mem->m_wram + addressValuePair.address - 0x80000000, &addressValuePair.frozenValue,
-                       dataSize);
-            }
+        for (const auto& [address, frozenValue] : m_frozenValues) {
+            memcpy(g_emulator->m_mem->m_wram + address - 0x80000000, &frozenValue.value, frozenValue.stride);
+            g_emulator->m_mem->markRAMDirty(address, frozenValue.stride);
         }
     });
 
@@ -195,101 +192,51 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
         }
 
         if (ImGui::BeginTabItem(_("Delta-over-time search"))) {
-            const auto stride = getStrideFromValueType(m_scanValueType);
-
-            if (m_addressValuePairs.empty() && ImGui::Button(_("First scan"))) {
-                int64_t memValue = 0;
-
-                for (uint32_t i = 0; i < memSize; ++i) {
-                    if (i != 0 && i % stride == 0) {
-                        switch (m_scanType) {
-                            case ScanType::ExactValue:
-                                if (memValue == m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::GreaterThan:
-                                if (memValue > m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::LessThan:
-                                if (memValue < m_value) {
-                                    m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                }
-                                break;
-                            case ScanType::Changed:
-                            case ScanType::Unchanged:
-                            case ScanType::Increased:
-                            case ScanType::Decreased:
-                                break;
-                            case ScanType::UnknownInitialValue:
-                                m_addressValuePairs.push_back({memBase + i - stride, memValue});
-                                break;
-                        }
-
-                        memValue = 0;
-                    }
-
-                    const uint8_t currentByte = memData[i];
-                    const uint8_t leftShift = 8 * (i % stride);
-                    const uint32_t mask = 0xffffffff ^ (0xff << leftShift);
-                    const int byteToWrite = currentByte << leftShift;
-                    memValue = (memValue & mask) | byteToWrite;
-                    memValue = getValueAsSelectedType(memValue);
-                }
+            // The scans run on a snapshot of RAM, on the scanner's own thread, so they can take all the time they need
+            if (m_scanner.poll() && m_scanner.count() == 0) {
+                m_scanner.reset();
+                m_scanType = ScanType::ExactValue;
             }
-
-            if (!m_addressValuePairs.empty() && ImGui::Button(_("Next scan"))) {
-                auto doesntMatchCriterion = [this, memData, memSize, stride](const AddressValuePair& addressValuePair) {
-                    const uint32_t address = addressValuePair.address;
-                    const int64_t memValue =
-                        getValueAsSelectedType(getMemValue(address, memData, memSize, memBase, stride));
-
-                    switch (m_scanType) {
-                        case ScanType::ExactValue:
-                            return memValue != m_value;
-                        case ScanType::GreaterThan:
-                            return memValue <= m_value;
-                        case ScanType::LessThan:
-                            return memValue >= m_value;
-                        case ScanType::Changed:
-                            return memValue == addressValuePair.scannedValue;
-                        case ScanType::Unchanged:
-                            return memValue != addressValuePair.scannedValue;
-                        case ScanType::Increased:
-                            return memValue <= addressValuePair.scannedValue;
-                        case ScanType::Decreased:
-                            return memValue >= addressValuePair.scannedValue;
-                        case ScanType::UnknownInitialValue:
-                            return true;
-                    }
-
-                    return true;
-                };
-
-                std::erase_if(m_addressValuePairs, doesntMatchCriterion);
-
-                if (m_addressValuePairs.empty()) {
+            const bool busy = m_scanner.busy();
+            const bool started = !busy && m_scanner.started();
+            const bool isFloat = m_scanValueType == ScanValueType::Float;
+            const auto stride = MemScanner::getStride(m_scanValueType);
+            auto snapshot = [memData, memSize]() { return std::vector<uint8_t>(memData, memData + memSize); };
+
+            if (busy) {
+                ImGui::TextUnformatted(_("Scanning..."));
+            } else if (!started) {
+                if (ImGui::Button(_("First scan"))) {
+                    m_scanner.firstScanAsync(snapshot(), m_scanValueType, getCriterion());
+                }
+            } else {
+                if (ImGui::Button(_("Next scan"))) {
+                    m_scanner.nextScanAsync(snapshot(), getCriterion());
+                }
+                if (ImGui::Button(_("New scan"))) {
+                    m_scanner.reset();
+                    m_frozenValues.clear();
                     m_scanType = ScanType::ExactValue;
-                } else {
-                    for (auto& addressValuePair : m_addressValuePairs) {
-                        addressValuePair.scannedValue = getValueAsSelectedType(
-                            getMemValue(addressValuePair.address, memData, memSize, memBase, stride));
-                    }
                 }
             }
 
-            if (!m_addressValuePairs.empty() && ImGui::Button(_("New scan"))) {
-                m_addressValuePairs.clear();
-                m_scanType = ScanType::ExactValue;
-            }
-
             ImGui::Checkbox(_("Hex"), &m_hex);
-            ImGui::InputScalar(_("Value"), ImGuiDataType_S64, &m_value, NULL, NULL, m_hex ? "%x" : "%i",
-                               m_hex ? ImGuiInputTextFlags_CharsHexadecimal : ImGuiInputTextFlags_CharsDecimal);
-            m_value = getValueAsSelectedType(m_value);
+            if (isFloat) {
+                ImGui::InputDouble(_("Value"), &m_floatValue);
+                if (m_scanType == ScanType::InRange) ImGui::InputDouble(_("Up to"), &m_floatHighValue);
+            } else {
+                ImGui::InputScalar(_("Value"), ImGuiDataType_S64, &m_value, NULL, NULL, m_hex ? "%x" : "%i",
+                                   m_hex ? ImGuiInputTextFlags_CharsHexadecimal : ImGuiInputTextFlags_CharsDecimal);
+                m_value = getValueAsSelectedType(m_value);
+                if (m_scanType == ScanType::InRange) {
+                    ImGui::InputScalar(_("Up to"), ImGuiDataType_S64, &m_highValue, NULL, NULL, m_hex ? "%x" : "%i",
+                                       m_hex ? ImGuiInputTextFlags_CharsHexadecimal : ImGuiInputTextFlags_CharsDecimal);
+                    m_highValue = getValueAsSelectedType(m_highValue);
+                }
+            }
 
+            // The type of the values is set in stone for the whole search
+            if (busy || started) ImGui::BeginDisabled();
             const auto currentScanValueType = magic_enum::enum_name(m_scanValueType);
             if (ImGui::BeginCombo(_("Value type"), currentScanValueType.data())) {
                 for (auto v : magic_enum::enum_values<ScanValueType>()) {
@@ -304,6 +251,7 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                 }
                 ImGui::EndCombo();
             }
+            if (busy || started) ImGui::EndDisabled();
 
             const auto currentScanType = magic_enum::enum_name(m_scanType);
             if (ImGui::BeginCombo(_("Scan type"), currentScanType.data())) {
@@ -320,7 +268,7 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                 ImGui::EndCombo();
             }
 
-            if (!m_hex && stride > 1) {
+            if (!m_hex && !isFloat && stride > 1) {
                 ImGui::Checkbox(_("Display as fixed-point values"), &m_fixedPoint);
             }
 
@@ -334,41 +282,56 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
                 ImGui::TableHeadersRow();
 
                 bool as_uint = (m_scanValueType == ScanValueType::Uint);
-                const auto valueDisplayFormat = m_hex                          ? "%x"
-                                                : (m_fixedPoint && stride > 1) ? (as_uint ? "%u.%u" : "%i.%i")
-                                                                               : (as_uint ? "%u" : "%i");
+                const bool displayAsFixedPoint = !m_hex && !isFloat && m_fixedPoint && stride > 1;
+                const auto valueDisplayFormat = m_hex                 ? "%x"
+                                                : displayAsFixedPoint ? (as_uint ? "%u.%u" : "%i.%i")
+                                                                      : (as_uint ? "%u" : "%i");
+                auto displayValue = [&](int memValue) {
+                    if (isFloat) {
+                        float floatValue;
+                        memcpy(&floatValue, &memValue, sizeof(floatValue));
+                        ImGui::Text(m_hex ? "%a" : "%g", floatValue);
+                        return;
+                    }
+                    const auto value = getValueAsSelectedType(memValue);
+                    if (displayAsFixedPoint) {
+                        ImGui::Text(valueDisplayFormat, value >> 12, value & 0xfff);
+                    } else {
+                        ImGui::Text(valueDisplayFormat, value);
+                    }
+                };
 
+                // A scan may have just been started by one of the buttons above
+                const bool showResults = !m_scanner.busy() && m_scanner.started();
                 ImGuiListClipper clipper;
-                clipper.Begin(m_addressValuePairs.size());
+                clipper.Begin(showResults ? m_scanner.count() : 0);
                 while (clipper.Step()) {
+                    const auto offsets = m_scanner.getOffsets(clipper.DisplayStart,
+                                                              clipper.DisplayEnd - clipper.DisplayStart);
+                    const auto& scannedData = m_scanner.getSnapshot();
                     for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
-                        auto& addressValuePair = m_addressValuePairs[row];
-                        const uint32_t currentAddress = addressValuePair.address;
-                        const auto memValue =
-                            getValueAsSelectedType(getMemValue(currentAddress, memData, memSize, memBase, stride));
-                        const auto scannedValue = addressValuePair.scannedValue;
-                        const bool displayAsFixedPoint = !m_hex && m_fixedPoint && stride > 1;
+                        const uint32_t currentAddress = memBase + offsets[row - clipper.DisplayStart];
+                        const auto memValue = getMemValue(currentAddress, memData, memSize, memBase, stride);
+                        const auto scannedValue =
+                            getMemValue(currentAddress, scannedData.data(), scannedData.size(), memBase, stride);
 
                         ImGui::TableNextRow();
                         ImGui::TableSetColumnIndex(0);
                         ImGui::Text("%x", currentAddress);
                         ImGui::TableSetColumnIndex(1);
-                        if (displayAsFixedPoint) {
-                            ImGui::Text(valueDisplayFormat, memValue >> 12, memValue & 0xfff);
-                        } else {
-                            ImGui::Text(valueDisplayFormat, memValue);
-                        }
+                        displayValue(memValue);
                         ImGui::SameLine();
                         auto CheckboxName = fmt::format(f_("Freeze##{}"), row);
-                        if (ImGui::Checkbox(CheckboxName.c_str(), &addressValuePair.frozen)) {
-                            addressValuePair.frozenValue = memValue;
+                        bool frozen = m_frozenValues.contains(currentAddress);
+                        if (ImGui::Checkbox(CheckboxName.c_str(), &frozen)) {
+                            if (frozen) {
+                                m_frozenValues[currentAddress] = {memValue, static_cast<uint8_t>(stride)};
+                            } else {
+                                m_frozenValues.erase(currentAddress);
+                            }
                         }
                         ImGui::TableSetColumnIndex(2);
-                        if (displayAsFixedPoint) {
-                            ImGui::Text(valueDisplayFormat, scannedValue >> 12, scannedValue & 0xfff);
-                        } else {
-                            ImGui::Text(valueDisplayFormat, scannedValue);
-                        }
+                        displayValue(scannedValue);
                         ImGui::TableSetColumnIndex(3);
                         auto showInMemEditorButtonName = fmt::format(f_("Show in memory editor##{}"), row);
                         if (ImGui::Button(showInMemEditorButtonName.c_str())) {
@@ -455,22 +418,6 @@ void PCSX::Widgets::MemoryObserver::draw(const char* title) {
     ImGui::End();
 }
 
-uint8_t PCSX::Widgets::MemoryObserver::getStrideFromValueType(ScanValueType valueType) {
-    switch (valueType) {
-        case ScanValueType::Char:
-        case ScanValueType::Uchar:
-            return 1;
-        case ScanValueType::Short:
-        case ScanValueType::Ushort:
-            return 2;
-        case ScanValueType::Int:
-        case ScanValueType::Uint:
-            return 4;
-        default:
-            throw std::runtime_error("Invalid value type.");
-    }
-}
-
 int64_t PCSX::Widgets::MemoryObserver::getValueAsSelectedType(int64_t memValue) {
     switch (m_scanValueType) {
         case ScanValueType::Char:
@@ -497,11 +444,26 @@ int64_t PCSX::Widgets::MemoryObserver::getValueAsSelectedType(int64_t memValue)
             unsigned int uint_val;
             memcpy(&uint_val, &memValue, 4);
             return uint_val;
+        case ScanValueType::Float:
+            return memValue;
         default:
             throw std::runtime_error("Invalid value type.");
     }
 }
 
+PCSX::MemScanner::Criterion PCSX::Widgets::MemoryObserver::getCriterion() const {
+    MemScanner::Criterion criterion;
+    criterion.scanType = m_scanType;
+    if (m_scanValueType == ScanValueType::Float) {
+        criterion.value = m_floatValue;
+        criterion.high = m_floatHighValue;
+    } else {
+        criterion.value = static_cast<double>(m_value);
+        criterion.high = static_cast<double>(m_highValue);
+    }
+    return criterion;
+}
+
 int PCSX::Widgets::MemoryObserver::getMemValue(uint32_t absoluteAddress, const uint8_t* memData, uint32_t memSize,
                                                uint32_t memBase, uint8_t stride) {
     int memValue = 0;
@@ -23,10 +23,12 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "core/memscanner.h"
 #include "imgui.h"
 #include "support/eventbus.h"
 #if defined(__i386__) || defined(_M_IX86) || defined(__x86_64) || defined(_M_AMD64)
@@ -67,36 +69,27 @@ class MemoryObserver {
      * Delta-over-time search.
      */
 
-    enum class ScanType {
-        ExactValue,
-        GreaterThan,
-        LessThan,
-        Changed,
-        Unchanged,
-        Increased,
-        Decreased,
-        UnknownInitialValue
-    };
-
-    enum class ScanValueType { Char, Uchar, Short, Ushort, Int, Uint };
-    static uint8_t getStrideFromValueType(ScanValueType valueType);
+    using ScanType = MemScanner::ScanType;
+    using ScanValueType = MemScanner::ValueType;
     int64_t getValueAsSelectedType(int64_t memValue);
+    MemScanner::Criterion getCriterion() const;
 
-    struct AddressValuePair {
-        uint32_t address = 0;
-        int64_t scannedValue = 0;
-
-        bool frozen = false;
-        int64_t frozenValue = 0;
+    struct FrozenValue {
+        int64_t value = 0;
+        uint8_t stride = 0;
     };
 
     ScanType m_scanType = ScanType::ExactValue;
     ScanValueType m_scanValueType = ScanValueType::Short;
-    std::vector<AddressValuePair> m_addressValuePairs;
+    MemScanner m_scanner;
+    std::map<uint32_t, FrozenValue> m_frozenValues;
     bool m_hex = false;
     bool m_fixedPoint = false;
     bool m_useSIMD = false;
     int64_t m_value = 0;
+    int64_t m_highValue = 0;
+    double m_floatValue = 0;
+    double m_floatHighValue = 0;
     EventBus::Listener m_listener;  // For value freezing.
 
     /**
@@ -19,8 +19,11 @@
 
 #include "gui/widgets/named_savestates.h"
 
+#include <chrono>
+
 #include "core/cdrom.h"
 #include "core/debug.h"
+#include "core/sstate.h"
 #include "gui/gui.h"
 #include "imgui.h"
 #include "imgui_internal.h"
@@ -45,6 +48,7 @@ void PCSX::Widgets::NamedSaveStates::draw(GUI* gui, const char* title) {
     // Create a button for each named save state
     ImGui::BeginChild("SaveStatesList", ImVec2(0, -footerHeight), true);
     auto saveStates = getNamedSaveStates(gui);
+    updatePreviews(saveStates);
     for (const auto& saveStatePair : saveStates) {
         // The button is invisible so we can adjust the highlight separately
         if (ImGui::InvisibleButton(saveStatePair.second.c_str(),
@@ -57,6 +61,7 @@ void PCSX::Widgets::NamedSaveStates::draw(GUI* gui, const char* title) {
                 loadSaveState(gui, saveStatePair.first);
             }
         }
+        if (ImGui::IsItemVisible()) requestPreview(saveStatePair.first);
         // Add a base coloured rect - highlight it if hovering over the button or the current InputText below matches it
         bool matches = StringsHelpers::strcasecmp(m_namedSaveNameString, saveStatePair.second.c_str());
         bool hovered = ImGui::IsItemHovered();
@@ -70,6 +75,7 @@ void PCSX::Widgets::NamedSaveStates::draw(GUI* gui, const char* title) {
             ImVec2(ImGui::GetCurrentContext()->LastItemData.Rect.Min.x + style.FramePadding.y,
                    ImGui::GetCurrentContext()->LastItemData.Rect.Min.y + style.FramePadding.y),
             ImGui::GetColorU32(ImGuiCol_Text), saveStatePair.second.c_str());
+        if (hovered) drawPreview(saveStatePair.first);
     }
     ImGui::EndChild();
 
@@ -167,6 +173,80 @@ std::vector<std::pair<std::filesystem::path, std::string>> PCSX::Widgets::NamedS
     return names;
 }
 
+void PCSX::Widgets::NamedSaveStates::updatePreviews(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& saveStates) {
+    if (m_loading.valid() && (m_loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+        auto pixels = m_loading.get();
+        auto preview = m_previews.find(m_loadingPath);
+        if ((preview != m_previews.end()) && !pixels.rgba.empty()) {
+            glGenTextures(1, &preview->second.texture);
+            glBindTexture(GL_TEXTURE_2D, preview->second.texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pixels.width, pixels.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pixels.rgba.data());
+            glBindTexture(GL_TEXTURE_2D, 0);
+            preview->second.width = pixels.width;
+            preview->second.height = pixels.height;
+        }
+    }
+
+    // Forget about the save states which went away
+    for (auto preview = m_previews.begin(); preview != m_previews.end();) {
+        auto found = std::find_if(saveStates.begin(), saveStates.end(),
+                                  [&](const auto& saveStatePair) { return saveStatePair.first == preview->first; });
+        if (found != saveStates.end()) {
+            preview++;
+            continue;
+        }
+        if (preview->second.texture) glDeleteTextures(1, &preview->second.texture);
+        preview = m_previews.erase(preview);
+    }
+}
+
+void PCSX::Widgets::NamedSaveStates::requestPreview(const std::filesystem::path& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return;
+    auto preview = m_previews.find(path);
+    if ((preview != m_previews.end()) && (preview->second.time == time)) return;
+    if (m_loading.valid()) return;
+
+    if (preview == m_previews.end()) preview = m_previews.emplace(path, Preview{}).first;
+    if (preview->second.texture) glDeleteTextures(1, &preview->second.texture);
+    preview->second = {};
+    preview->second.time = time;
+    m_loadingPath = path;
+    m_loading = std::async(std::launch::async, [path]() {
+        Pixels pixels;
+        GUI::readSaveState(path, [&pixels](std::string_view state) {
+            SaveStates::Thumbnail thumbnail;
+            if (!SaveStates::loadThumbnail(state, thumbnail)) return false;
+            const auto& red = thumbnail.get<SaveStates::Red>().value;
+            const auto& green = thumbnail.get<SaveStates::Green>().value;
+            const auto& blue = thumbnail.get<SaveStates::Blue>().value;
+            pixels.width = thumbnail.get<SaveStates::Width>().value;
+            pixels.height = thumbnail.get<SaveStates::Height>().value;
+            pixels.rgba.resize(red.size());
+            for (size_t i = 0; i < red.size(); i++) {
+                pixels.rgba[i] = uint8_t(red[i]) | (uint8_t(green[i]) << 8) | (uint8_t(blue[i]) << 16) | 0xff000000;
+            }
+            return true;
+        });
+        return pixels;
+    });
+}
+
+void PCSX::Widgets::NamedSaveStates::drawPreview(const std::filesystem::path& path) {
+    auto preview = m_previews.find(path);
+    if ((preview == m_previews.end()) || !preview->second.texture) return;
+    ImGui::BeginTooltip();
+    ImGui::Image(preview->second.texture, ImVec2(preview->second.width * 2, preview->second.height * 2));
+    ImGui::EndTooltip();
+}
+
 bool PCSX::Widgets::NamedSaveStates::saveSaveState(GUI* gui, std::filesystem::path saveStatePath) {
     g_system->log(LogClass::UI, "Saving named save state: %s\n", saveStatePath.filename().string().c_str());
     return gui->saveSaveState(saveStatePath);
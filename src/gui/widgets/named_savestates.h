@@ -19,7 +19,12 @@
 
 #pragma once
 
+#include <GL/gl3w.h>
+#include <stdint.h>
+
 #include <filesystem>
+#include <future>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -55,6 +60,26 @@ class NamedSaveStates {
     bool loadSaveState(GUI* gui, std::filesystem::path saveStatePath);
     bool deleteSaveState(GUI* gui, std::filesystem::path saveStatePath);
 
+    // The thumbnails only get loaded for the save states the list shows, one at a time, on a thread of their
+    // own, and get loaded again whenever their file changes.
+    struct Pixels {
+        std::vector<uint32_t> rgba;
+        int width = 0;
+        int height = 0;
+    };
+    struct Preview {
+        std::filesystem::file_time_type time;
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+    };
+    void updatePreviews(const std::vector<std::pair<std::filesystem::path, std::string>>& saveStates);
+    void requestPreview(const std::filesystem::path& path);
+    void drawPreview(const std::filesystem::path& path);
+    std::map<std::filesystem::path, Preview> m_previews;
+    std::filesystem::path m_loadingPath;
+    std::future<Pixels> m_loading;
+
     char m_namedSaveNameString[NAMED_SAVE_STATE_LENGTH_MAX] = "";
 };
 
@@ -19,9 +19,12 @@
 
 #include "gui/widgets/shader-editor.h"
 
+#include <string.h>
+
 #include <filesystem>
 #include <fstream>
 #include <istream>
+#include <iterator>
 #include <ostream>
 #include <sstream>
 #include <streambuf>
@@ -31,6 +34,11 @@
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
 #include "support/opengl.h"
+#include "support/sha1.h"
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 lua_Number PCSX::Widgets::ShaderEditor::s_index = 0;
 
@@ -268,6 +276,7 @@ PCSX::Widgets::ShaderEditor::ShaderEditor(const std::string &base) : m_baseFilen
 }
 
 PCSX::Widgets::ShaderEditor::~ShaderEditor() {
+    discardProgram(m_pending);
     if (m_shaderProgram != 0) {
         glDeleteProgram(m_shaderProgram);
     }
@@ -299,91 +308,216 @@ void PCSX::Widgets::ShaderEditor::init() {
     m_quadVertices[3].positions[1] = 1.0;
 }
 
-PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
-                                                          const std::vector<std::string_view> &mandatoryAttributes) {
-    m_setupVAO = true;
-    m_shaderProjMtxLoc = -1;
-    GLint status = 0;
-    GUI::ScopedOnlyLog scopedOnlyLog(gui);
+// Program binaries are only good for the exact same driver, which is part of their cache key.
+static bool programBinariesSupported() {
+    static const bool supported =
+        (PCSX::OpenGL::versionSupported(4, 1) || PCSX::OpenGL::extensionSupported("GL_ARB_get_program_binary")) &&
+        (PCSX::OpenGL::get<GLint>(GL_NUM_PROGRAM_BINARY_FORMATS) > 0);
+    return supported;
+}
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    auto VS = getVertexText();
-    const char *VSv = VS.data();
-    glShaderSource(vertexShader, 1, &VSv, 0);
-    glCompileShader(vertexShader);
+static bool parallelCompileSupported() {
+    static const bool supported = PCSX::OpenGL::extensionSupported("GL_KHR_parallel_shader_compile") ||
+                                  PCSX::OpenGL::extensionSupported("GL_ARB_parallel_shader_compile");
+    return supported;
+}
 
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &status);
-    if (status == 0) {
-        GLint maxLength;
-        glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &maxLength);
-        char *log = (char *)malloc(maxLength);
-        glGetShaderInfoLog(vertexShader, maxLength, &maxLength, log);
+static std::string programCacheKey(std::string_view VS, std::string_view PS) {
+    PCSX::SHA1 sha1;
+    for (auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char *str = reinterpret_cast<const char *>(glGetString(name));
+        if (str) sha1.update(str, strlen(str) + 1);
+    }
+    sha1.update(VS.data(), VS.size() + 1);
+    sha1.update(PS.data(), PS.size() + 1);
+    uint8_t digest[20];
+    sha1.finish(digest);
+    std::string key;
+    for (auto b : digest) key += fmt::format("{:02x}", b);
+    return key;
+}
 
-        m_errorMessage = fmt::format(f_("Vertex Shader compilation error: {}\n"), log);
+static std::filesystem::path programCachePath(const std::string &key) {
+    return PCSX::g_system->getPersistentDir() / "shadercache" / (key + ".bin");
+}
 
-        free(log);
-        glDeleteShader(vertexShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+// The cache files are the binary format, followed by the binary itself.
+static bool loadCachedProgram(GLuint program, const std::string &key) {
+    auto path = programCachePath(key);
+    std::ifstream in(path, std::ifstream::binary);
+    if (!in) return false;
+    GLenum format = 0;
+    in.read(reinterpret_cast<char *>(&format), sizeof(format));
+    std::string binary((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    if (binary.empty()) return false;
+    glProgramBinary(program, format, binary.data(), binary.size());
+    GLint status = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == 0) {
+        // Most likely a driver update; this one will be written over once compiled again.
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return false;
     }
+    return true;
+}
 
-    GLuint pixelShader = glCreateShader(GL_FRAGMENT_SHADER);
+static void storeCachedProgram(GLuint program, const std::string &key) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::string binary(length, '\0');
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    auto path = programCachePath(key);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream out(path, std::ofstream::binary);
+    if (!out) return;
+    out.write(reinterpret_cast<const char *>(&format), sizeof(format));
+    out.write(binary.data(), length);
+}
+
+void PCSX::Widgets::ShaderEditor::startProgram(PendingProgram &pending) {
+    auto VS = getVertexText();
     auto PS = getPixelText();
+    if (programBinariesSupported()) {
+        pending.cacheKey = programCacheKey(VS, PS);
+        pending.program = glCreateProgram();
+        if (loadCachedProgram(pending.program, pending.cacheKey)) {
+            pending.fromCache = true;
+            return;
+        }
+        glDeleteProgram(pending.program);
+    }
+
+    pending.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    const char *VSv = VS.data();
+    glShaderSource(pending.vertexShader, 1, &VSv, 0);
+    glCompileShader(pending.vertexShader);
+
+    pending.pixelShader = glCreateShader(GL_FRAGMENT_SHADER);
     const char *PSv = PS.data();
-    glShaderSource(pixelShader, 1, &PSv, 0);
-    glCompileShader(pixelShader);
+    glShaderSource(pending.pixelShader, 1, &PSv, 0);
+    glCompileShader(pending.pixelShader);
+
+    // With parallel compilation, all of the above only got queued up, and the link will wait for it; the status
+    // of all three only gets looked at once done.
+    pending.program = glCreateProgram();
+    if (programBinariesSupported()) glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(pending.program, pending.vertexShader);
+    glAttachShader(pending.program, pending.pixelShader);
+    glLinkProgram(pending.program);
+}
 
-    glGetShaderiv(pixelShader, GL_COMPILE_STATUS, &status);
-    if (status == 0) {
-        GLint maxLength;
-        glGetShaderiv(pixelShader, GL_INFO_LOG_LENGTH, &maxLength);
-        char *log = (char *)malloc(maxLength);
+bool PCSX::Widgets::ShaderEditor::isProgramReady(const PendingProgram &pending) {
+    if (pending.fromCache || !parallelCompileSupported()) return true;
+    GLint done = 0;
+    glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &done);
+    return done != 0;
+}
 
-        glGetShaderInfoLog(pixelShader, maxLength, &maxLength, log);
+void PCSX::Widgets::ShaderEditor::discardProgram(PendingProgram &pending) {
+    if (pending.program != 0) glDeleteProgram(pending.program);
+    if (pending.vertexShader != 0) glDeleteShader(pending.vertexShader);
+    if (pending.pixelShader != 0) glDeleteShader(pending.pixelShader);
+    pending = {};
+}
 
-        m_errorMessage = fmt::format(f_("Pixel Shader compilation error: {}\n"), log);
+PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
+                                                          const std::vector<std::string_view> &mandatoryAttributes) {
+    // Whatever was compiling in the background is from older sources.
+    discardProgram(m_pending);
+    PendingProgram pending;
+    startProgram(pending);
+    return finishProgram(gui, std::move(pending), mandatoryAttributes);
+}
 
-        free(log);
-        glDeleteShader(vertexShader);
-        glDeleteShader(pixelShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+void PCSX::Widgets::ShaderEditor::compileAsync(GUI *gui) {
+    if (!parallelCompileSupported()) {
+        compile(gui);
+        return;
     }
+    discardProgram(m_pending);
+    startProgram(m_pending);
+    gui->damage();
+}
 
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, pixelShader);
+void PCSX::Widgets::ShaderEditor::pollCompile(GUI *gui) {
+    if (m_pending.program == 0) return;
+    // Keep the frames coming while idle, so that this gets to see the program done.
+    gui->damage();
+    if (!isProgramReady(m_pending)) return;
+    PendingProgram pending = std::move(m_pending);
+    m_pending = {};
+    finishProgram(gui, std::move(pending), {});
+}
 
-    glLinkProgram(shaderProgram);
+PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::finishProgram(
+    GUI *gui, PendingProgram pending, const std::vector<std::string_view> &mandatoryAttributes) {
+    GLint status = 0;
+    GUI::ScopedOnlyLog scopedOnlyLog(gui);
 
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &status);
-    if (status == 0) {
-        GLint maxLength;
-        glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &maxLength);
-        char *log = (char *)malloc(maxLength);
+    if (!pending.fromCache) {
+        glGetShaderiv(pending.vertexShader, GL_COMPILE_STATUS, &status);
+        if (status == 0) {
+            GLint maxLength;
+            glGetShaderiv(pending.vertexShader, GL_INFO_LOG_LENGTH, &maxLength);
+            char *log = (char *)malloc(maxLength);
+            glGetShaderInfoLog(pending.vertexShader, maxLength, &maxLength, log);
 
-        glGetProgramInfoLog(shaderProgram, maxLength, &maxLength, log);
+            m_errorMessage = fmt::format(f_("Vertex Shader compilation error: {}\n"), log);
 
-        m_errorMessage = fmt::format(f_("Link error: {}\n"), log);
+            free(log);
+            discardProgram(pending);
+            return OpenGL::Status::makeError(m_errorMessage);
+        }
+
+        glGetShaderiv(pending.pixelShader, GL_COMPILE_STATUS, &status);
+        if (status == 0) {
+            GLint maxLength;
+            glGetShaderiv(pending.pixelShader, GL_INFO_LOG_LENGTH, &maxLength);
+            char *log = (char *)malloc(maxLength);
+
+            glGetShaderInfoLog(pending.pixelShader, maxLength, &maxLength, log);
+
+            m_errorMessage = fmt::format(f_("Pixel Shader compilation error: {}\n"), log);
+
+            free(log);
+            discardProgram(pending);
+            return OpenGL::Status::makeError(m_errorMessage);
+        }
 
-        free(log);
-        glDeleteProgram(shaderProgram);
-        glDeleteShader(vertexShader);
-        glDeleteShader(pixelShader);
-        return OpenGL::Status::makeError(m_errorMessage);
+        glGetProgramiv(pending.program, GL_LINK_STATUS, &status);
+        if (status == 0) {
+            GLint maxLength;
+            glGetProgramiv(pending.program, GL_INFO_LOG_LENGTH, &maxLength);
+            char *log = (char *)malloc(maxLength);
+
+            glGetProgramInfoLog(pending.program, maxLength, &maxLength, log);
+
+            m_errorMessage = fmt::format(f_("Link error: {}\n"), log);
+
+            free(log);
+            discardProgram(pending);
+            return OpenGL::Status::makeError(m_errorMessage);
+        }
     }
 
     for (auto attrib : mandatoryAttributes) {
-        int loc = glGetAttribLocation(shaderProgram, attrib.data());
+        int loc = glGetAttribLocation(pending.program, attrib.data());
         if (loc == -1) {
             m_errorMessage = fmt::format(f_("Missing attribute {} in shader program"), attrib);
-            glDeleteProgram(shaderProgram);
-            glDeleteShader(vertexShader);
-            glDeleteShader(pixelShader);
+            discardProgram(pending);
             return OpenGL::Status::makeError(m_errorMessage);
         }
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(pixelShader);
+    if (!pending.fromCache && !pending.cacheKey.empty()) storeCachedProgram(pending.program, pending.cacheKey);
+    const GLuint shaderProgram = pending.program;
+    pending.program = 0;
+    discardProgram(pending);
 
     m_errorMessage.clear();
     gui->getGLerrors();
@@ -481,6 +615,7 @@ PCSX::OpenGL::Status PCSX::Widgets::ShaderEditor::compile(GUI *gui,
         glDeleteProgram(m_shaderProgram);
     }
     m_shaderProgram = shaderProgram;
+    m_setupVAO = true;
     m_shaderProjMtxLoc = glGetUniformLocation(m_shaderProgram, "u_projMatrix");
     return OpenGL::Status::makeOk();
 }
@@ -541,6 +676,7 @@ bool PCSX::Widgets::ShaderEditor::draw(GUI *gui, const char *title) {
     }
     ImGui::PopFont();
     ImGui::BeginChild("Errors", ImVec2(0, 0), true);
+    if (isCompiling()) ImGui::TextUnformatted(_("Compiling..."));
     ImGui::Text("%s", m_errorMessage.c_str());
     if (m_displayError) {
         for (auto &msg : m_lastLuaErrors) {
@@ -42,6 +42,11 @@ class ShaderEditor {
                  const std::string_view& dL);
     ShaderEditor(const std::string& base);
     OpenGL::Status compile(GUI* gui, const std::vector<std::string_view>& mandatoryAttributes = {});
+    // Lets the driver compile in the background when it can, with the current program staying in use until
+    // the new one is ready, which pollCompile, called every frame, takes care of. Same as compile otherwise.
+    void compileAsync(GUI* gui);
+    void pollCompile(GUI* gui);
+    bool isCompiling() { return m_pending.program != 0; }
     bool isProgramCompiled() { return m_shaderProgram != 0; }
     GLuint getProgram() { return m_shaderProgram; }
 
@@ -79,6 +84,20 @@ class ShaderEditor {
 
     void getRegistry(Lua L);
 
+    // A program on its way, which either comes out of the binary cache, or still has its shaders compiling.
+    struct PendingProgram {
+        GLuint program = 0;
+        GLuint vertexShader = 0;
+        GLuint pixelShader = 0;
+        std::string cacheKey;
+        bool fromCache = false;
+    };
+    void startProgram(PendingProgram& pending);
+    bool isProgramReady(const PendingProgram& pending);
+    OpenGL::Status finishProgram(GUI* gui, PendingProgram pending,
+                                 const std::vector<std::string_view>& mandatoryAttributes);
+    void discardProgram(PendingProgram& pending);
+
     void imguiCB(const ImDrawList* parentList, const ImDrawCmd* cmd);
 
     const std::string m_baseFilename;
@@ -87,6 +106,7 @@ class ShaderEditor {
     ZepEditor m_pixelShaderEditor = {"PixelShader.frag"};
     ZepEditor m_luaEditor = {"LuaInvoker.lua"};
     GLuint m_shaderProgram = 0;
+    PendingProgram m_pending;
     std::string m_errorMessage;
     std::vector<std::string> m_lastLuaErrors;
     bool m_displayError = false;
@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "gui/widgets/tracebrowser.h"
+
+#include <algorithm>
+
+#include "core/disr3000a.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "gui/gui.h"
+#include "imgui.h"
+#include "support/imgui-helpers.h"
+#include "support/uvfile.h"
+
+namespace {
+
+const char* registerName(unsigned index) {
+    if (index == 32) return "lo";
+    if (index == 33) return "hi";
+    return PCSX::Disasm::s_disRNameGPR[index];
+}
+
+}  // namespace
+
+void PCSX::Widgets::TraceBrowser::draw(GUI* gui, const char* title) {
+    ImGui::SetNextWindowSize(ImVec2(800, 500), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin(title, &m_show)) {
+        ImGui::End();
+        return;
+    }
+
+    auto& recorder = g_emulator->m_traceRecorder;
+    if (recorder->recording()) {
+        if (ImGui::Button(_("Stop recording"))) recorder->stop();
+        ImGui::SameLine();
+        ImGui::Text(_("%llu instructions recorded"), (unsigned long long)recorder->instructions());
+    } else {
+        const bool dynarec = g_emulator->m_cpu->isDynarec();
+        ImGui::BeginDisabled(dynarec);
+        if (ImGui::Button(_("Record trace..."))) m_recordDialog.openDialog();
+        ImGui::EndDisabled();
+        ImGuiHelpers::ShowHelpMarker(
+            _("Records every instruction the CPU runs, along with the registers they change and the memory they "
+              "access, into a compressed file. This is much faster than the Trace debug option, but only works with "
+              "the interpreted CPU."));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(_("Open trace..."))) m_openDialog.openDialog();
+
+    if (m_recordDialog.draw()) {
+        auto selected = m_recordDialog.selected();
+        if (!selected.empty()) {
+            IO<File> out = new UvFile(selected[0], FileOps::TRUNCATE);
+            m_error.clear();
+            if (!recorder->start(out, g_emulator->m_cpu->m_regs.GPR.r)) m_error = _("Unable to create the trace file");
+        }
+    }
+    if (m_openDialog.draw()) {
+        auto selected = m_openDialog.selected();
+        if (!selected.empty()) {
+            IO<File> in = new UvFile(selected[0]);
+            m_reader.reset(new TraceRecorder::Reader());
+            m_error.clear();
+            if (!m_reader->open(in)) {
+                m_reader.reset();
+                m_error = _("Not a valid trace file");
+            }
+        }
+    }
+    if (!m_error.empty()) ImGui::TextUnformatted(m_error.c_str());
+
+    if (!m_reader) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Separator();
+    ImGui::Text(_("%llu instructions"), (unsigned long long)m_reader->size());
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150.0f);
+    if (ImGui::InputScalar(_("Go to"), ImGuiDataType_U64, &m_goTo, nullptr, nullptr, nullptr,
+                           ImGuiInputTextFlags_EnterReturnsTrue)) {
+        m_scrollToGoTo = true;
+    }
+
+    gui->useMonoFont();
+    constexpr ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV |
+                                      ImGuiTableFlags_Resizable;
+    if (ImGui::BeginTable("trace", 5, flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn(_("Index"), ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn(_("PC"), ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn(_("Instruction"), ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn(_("Memory"), ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn(_("Registers"), ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableHeadersRow();
+
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        if (m_scrollToGoTo) {
+            m_scrollToGoTo = false;
+            if (m_goTo < m_reader->size()) ImGui::SetScrollY(m_goTo * rowHeight);
+        }
+
+        ImGuiListClipper clipper;
+        // The size of traces goes way past what an int can count, but nobody is going to scroll through all of it.
+        clipper.Begin(int(std::min(m_reader->size(), uint64_t(INT32_MAX))), rowHeight);
+        TraceRecorder::Record record;
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                if (!m_reader->read(i, record)) break;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%i", i);
+                ImGui::TableNextColumn();
+                std::string label = fmt::format("{:08x}##{}", record.pc, i);
+                if (ImGui::Selectable(label.c_str(), m_goTo == uint64_t(i), ImGuiSelectableFlags_AllowDoubleClick)) {
+                    m_goTo = i;
+                    if (ImGui::IsMouseDoubleClicked(0)) {
+                        g_system->m_eventBus->signal(PCSX::Events::GUI::JumpToPC{record.pc});
+                    }
+                }
+                ImGui::TableNextColumn();
+                std::string ins = Disasm::asString(record.code, 0, record.pc);
+                ImGui::TextUnformatted(ins.c_str());
+                ImGui::TableNextColumn();
+                if (record.memory) ImGui::Text("[%08x] %08x", record.address, record.value);
+                ImGui::TableNextColumn();
+                std::string changed;
+                for (unsigned r = 0; r < record.changedCount; r++) {
+                    changed += fmt::format("{}{}={:08x}", r ? " " : "", registerName(record.changed[r]),
+                                           record.values[r]);
+                }
+                ImGui::TextUnformatted(changed.c_str());
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::PopFont();
+
+    ImGui::End();
+}
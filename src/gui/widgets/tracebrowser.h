@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/tracerecorder.h"
+#include "gui/widgets/filedialog.h"
+
+namespace PCSX {
+
+class GUI;
+
+namespace Widgets {
+
+// Starts and stops binary trace recordings, and browses through the ones saved.
+class TraceBrowser {
+  public:
+    TraceBrowser(bool& show, std::vector<std::string>& favorites)
+        : m_show(show), m_recordDialog(l_("Record trace"), favorites), m_openDialog(l_("Open trace"), favorites) {}
+    void draw(GUI* gui, const char* title);
+
+    bool& m_show;
+
+  private:
+    FileDialog<FileDialogMode::Save> m_recordDialog;
+    FileDialog<> m_openDialog;
+    std::unique_ptr<TraceRecorder::Reader> m_reader;
+    std::string m_error;
+    uint64_t m_goTo = 0;
+    bool m_scrollToGoTo = false;
+};
+
+}  // namespace Widgets
+
+}  // namespace PCSX
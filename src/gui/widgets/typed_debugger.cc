@@ -20,6 +20,10 @@
 
 #include "gui/widgets/typed_debugger.h"
 
+#include <ctype.h>
+#include <string.h>
+
+#include <algorithm>
 #include <fstream>
 #include <magic_enum_all.hpp>
 #include <regex>
@@ -120,7 +124,14 @@ void PCSX::Widgets::TypedDebugger::import(std::string_view fileContents, ImportT
         }
     }
 
+    if (importType == ImportType::Functions) {
+        std::sort(m_functionAddresses.begin(), m_functionAddresses.end());
+        m_functionAddresses.erase(std::unique(m_functionAddresses.begin(), m_functionAddresses.end()),
+                                  m_functionAddresses.end());
+    }
+
     if (importType == ImportType::DataTypes) {
+        compileLayouts();
         std::sort(m_typeNames.begin(), m_typeNames.end(), [](const std::string& left, const std::string& right) {
             const auto leftSize = left.size();
             const auto rightSize = right.size();
@@ -179,35 +190,65 @@ PCSX::Widgets::TypedDebugger::TypedDebugger(bool& show, std::vector<std::string>
     });
 }
 
-void PCSX::Widgets::TypedDebugger::populate(WatchTreeNode* node) {
-    const auto type = node->type;
-
-    const std::regex arrayRegex(R"((.*)\[(\d+)\])");
-    std::smatch matches;
-    if (std::regex_match(type, matches, arrayRegex)) {
-        const auto elementType = matches[1].str();
-        const auto numChildren = std::stoul(matches[2].str());
-
-        size_t elementSize = 0;
-        if (m_structs.contains(elementType)) {
-            for (const auto& field : m_structs[elementType]) {
-                elementSize += field.size;
-            }
-        } else {
-            elementSize = node->size / numChildren;
+void PCSX::Widgets::TypedDebugger::compileLayouts() {
+    m_layouts.clear();
+    for (const auto& [name, fields] : m_structs) {
+        auto& layout = m_layouts[name];
+        layout.offsets.reserve(fields.size());
+        for (const auto& field : fields) {
+            layout.offsets.push_back(layout.size);
+            layout.size += field.size;
         }
+    }
+}
+
+static bool parseArrayType(const std::string& type, std::string& elementType, size_t& count) {
+    if (type.empty() || (type.back() != ']')) return false;
+    const auto open = type.rfind('[');
+    if ((open == std::string::npos) || (open + 2 >= type.size())) return false;
+    count = 0;
+    for (size_t i = open + 1; i < type.size() - 1; i++) {
+        if (!isdigit(static_cast<unsigned char>(type[i]))) return false;
+        count = count * 10 + (type[i] - '0');
+    }
+    elementType = type.substr(0, open);
+    return true;
+}
+
+size_t PCSX::Widgets::TypedDebugger::typeSize(const std::string& type) const {
+    std::string elementType;
+    size_t count = 1;
+    if (!parseArrayType(type, elementType, count)) elementType = type;
+    if (!elementType.empty() && (elementType.back() == '*')) return 4 * count;
+    auto layout = m_layouts.find(elementType);
+    return layout == m_layouts.end() ? 0 : layout->second.size * count;
+}
+
+void PCSX::Widgets::TypedDebugger::populate(WatchTreeNode* node) {
+    const auto& type = node->type;
 
+    std::string elementType;
+    size_t numChildren;
+    if (parseArrayType(type, elementType, numChildren)) {
+        if (numChildren == 0) return;
+        auto layout = m_layouts.find(elementType);
+        const size_t elementSize = layout != m_layouts.end() ? layout->second.size : node->size / numChildren;
+
+        node->children.reserve(numChildren);
         for (size_t i = 0; i < numChildren; ++i) {
-            WatchTreeNode newNode{elementType, std::string(node->name + "[" + std::to_string(i) + "]"), elementSize};
+            WatchTreeNode newNode{elementType, std::string(node->name + "[" + std::to_string(i) + "]"), elementSize,
+                                  uint32_t(i * elementSize)};
             node->children.push_back(newNode);
             populate(&node->children.back());
         }
-    } else if (m_structs.contains(type)) {
-        const size_t numChildren = m_structs[type].size();
-
-        for (size_t i = 0; i < numChildren; ++i) {
-            const auto& field = m_structs[type][i];
-            WatchTreeNode newNode{field.type, field.name, field.size};
+    } else if (auto layout = m_layouts.find(type); layout != m_layouts.end()) {
+        const auto& fields = m_structs[type];
+        const auto& offsets = layout->second.offsets;
+
+        node->children.reserve(fields.size());
+        for (size_t i = 0; i < fields.size(); ++i) {
+            const auto& field = fields[i];
+            WatchTreeNode newNode{field.type, field.name, field.size, offsets[i]};
             node->children.push_back(newNode);
             populate(&node->children.back());
         }
@@ -339,32 +380,39 @@ void PCSX::Widgets::TypedDebugger::displayBreakpointOptions(WatchTreeNode* node,
 }
 
 std::string_view PCSX::Widgets::TypedDebugger::getFunctionNameFromInstructionAddress(uint32_t address) {
-    if (m_instructionAddressToFunctionMap.contains(address)) {
-        return m_instructionAddressToFunctionMap[address];
-    } else {
-        for (size_t i = 0; i < m_functionAddresses.size() - 1; ++i) {
-            if (address >= m_functionAddresses[i] && address < m_functionAddresses[i + 1]) {
-                const auto knownAddress = m_functionAddresses[i];
-                m_instructionAddressToFunctionMap[address] = m_functions[knownAddress].name;
-                return m_instructionAddressToFunctionMap[address];
-            }
-        }
+    // Past the last function, there's no telling where it ends.
+    auto next = std::upper_bound(m_functionAddresses.begin(), m_functionAddresses.end(), address);
+    if ((next == m_functionAddresses.begin()) || (next == m_functionAddresses.end())) return std::string_view();
+    return m_functions[*std::prev(next)].name;
+}
+
+PCSX::Widgets::TypedDebugger::MemoryRange PCSX::Widgets::TypedDebugger::readRange(uint32_t address, size_t size) {
+    return {address, m_memFile->readAt(size, address)};
+}
+
+PCSX::Slice PCSX::Widgets::TypedDebugger::readValue(const MemoryRange& range, uint32_t address, size_t size) {
+    const uint32_t offset = address - range.address;
+    if ((address >= range.address) && (offset + size <= range.data.size())) {
+        Slice slice;
+        slice.borrow(range.data.data<uint8_t>() + offset, size);
+        return slice;
     }
-    return std::string_view();
+    return m_memFile->readAt(size, address);
 }
 
-void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32_t currentAddress, bool watchView,
-                                               bool addressOfPointer, uint32_t extraImGuiId) {
+void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const MemoryRange& range,
+                                               const uint32_t currentAddress, bool watchView, bool addressOfPointer,
+                                               uint32_t extraImGuiId) {
     ImGui::TableNextRow();
     ImGui::TableNextColumn();  // Name.
     std::string nameColumnString = fmt::format(f_("{}\t@ {:#x}##{}"), node->name, currentAddress, extraImGuiId);
-    IO<File> memFile = g_emulator->m_mem->getMemoryAsFile();
+    IO<File>& memFile = m_memFile;
 
     const char* nodeType = node->type.c_str();
     const bool isPointer = node->type.back() == '*';
     uint32_t startAddress = currentAddress;
     if (isPointer && addressOfPointer) {
-        startAddress = memFile->readAt<uint32_t>(currentAddress);
+        memcpy(&startAddress, readValue(range, currentAddress, 4).data(), 4);
     }
 
     if (node->children.size() > 0) {  // If this is a struct, array or already populated pointer, display children.
@@ -411,10 +459,15 @@ void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32
             }
         }
         if (open) {
-            uint32_t accumulatedOffset = 0;
-            for (int child_n = 0; child_n < node->children.size(); child_n++) {
-                displayNode(&node->children[child_n], startAddress + accumulatedOffset, watchView, true);
-                accumulatedOffset += node->children[child_n].size;
+            // Children of a struct or an array are within the range already; a pointee gets read all at once.
+            MemoryRange pointee;
+            if (isPointer) {
+                const auto& last = node->children.back();
+                pointee = readRange(startAddress, last.offset + last.size);
+            }
+            const MemoryRange& childRange = isPointer ? pointee : range;
+            for (auto& child : node->children) {
+                displayNode(&child, childRange, startAddress + child.offset, watchView, true);
             }
             ImGui::TreePop();
         }
@@ -485,7 +538,7 @@ void PCSX::Widgets::TypedDebugger::displayNode(WatchTreeNode* node, const uint32
         ImGui::TableNextColumn();  // Size.
         ImGui::Text("%zu", node->size);
         ImGui::TableNextColumn();  // Value.
-        auto value = memFile->readAt(node->size, startAddress);
+        auto value = readValue(range, startAddress, node->size);
         const auto* nodeType = node->type.c_str();
         printValue(nodeType, node->size, value);
         ImGui::TableNextColumn();  // New value.
@@ -690,7 +743,6 @@ Arrays and pointers are specified as for data types)"));
                 } else {
                     m_functionAddresses.clear();
                     m_functions.clear();
-                    m_instructionAddressToFunctionMap.clear();
                 }
                 std::ifstream file(reinterpret_cast<const char*>(fileToOpen[0].c_str()));
                 std::stringstream fileContents;
@@ -701,20 +753,7 @@ Arrays and pointers are specified as for data types)"));
                     // Refresh displayed Watch data.
                     for (auto& data : m_displayedWatchData) {
                         // Refresh size.
-                        const std::regex arrayRegex(R"((.*)\[(\d+)\])");
-                        std::smatch matches;
-                        auto type = data.node.type;
-                        size_t numberOfElements = 1;
-                        if (std::regex_match(type, matches, arrayRegex)) {
-                            type = matches[1].str();
-                            numberOfElements = std::stoul(matches[2].str());
-                        }
-
-                        data.node.size = type.back() == '*' ? 4 : 0;
-                        for (const auto& field : m_structs[type]) {
-                            data.node.size += field.size;
-                        }
-                        data.node.size *= numberOfElements;
+                        data.node.size = typeSize(data.node.type);
 
                         // Refresh children.
                         data.node.children.clear();
@@ -729,6 +768,7 @@ Arrays and pointers are specified as for data types)"));
     ImGui::SameLine();
     showReimportButton(_("Reimport functions from updated file"), m_functionsFile, ImportType::Functions);
 
+    m_memFile = g_emulator->m_mem->getMemoryAsFile();
     uint8_t* const memData = g_emulator->m_mem->m_wram;
     const uint32_t memSize = 1024 * 1024 * (g_emulator->settings.get<PCSX::Emulator::Setting8MB>() ? 8 : 2);
     constexpr uint32_t memBase = 0x80000000;
@@ -782,10 +822,7 @@ Arrays and pointers are specified as for data types)"));
                 const auto inputType = createArray ? fmt::format(f_("{}[{}]"), type, numberToCreate) : type;
                 rootNode.type = inputType;
                 rootNode.name = inputType;
-                for (const auto& field : m_structs[type]) {
-                    rootNode.size += field.size;
-                }
-                rootNode.size *= numberToCreate;
+                rootNode.size = typeSize(inputType);
                 populate(&rootNode);
                 m_displayedWatchData.push_back({addressInputValue, true, rootNode});
             }
@@ -830,8 +867,11 @@ Arrays and pointers are specified as for data types)"));
                 ImGui::TableSetupColumn(_("Breakpoints"), ImGuiTableColumnFlags_NoHide);
                 ImGui::TableHeadersRow();
 
+                // Each watch is read from memory in one go, and its fields are picked out of that.
                 for (auto& addressNodePair : m_displayedWatchData) {
-                    displayNode(&addressNodePair.node, addressNodePair.address, true, addressNodePair.addressOfPointer);
+                    auto range = readRange(addressNodePair.address, addressNodePair.node.size);
+                    displayNode(&addressNodePair.node, range, addressNodePair.address, true,
+                                addressNodePair.addressOfPointer);
                 }
 
                 ImGui::EndTable();
@@ -890,7 +930,8 @@ Arrays and pointers are specified as for data types)"));
                     ImGui::TableNextColumn();  // Breakpoints.
                     for (auto& argData : functionData.argData) {
                         if (auto* addressNodeTuple = std::get_if<AddressNodeTuple>(&argData)) {
-                            displayNode(&addressNodeTuple->node, addressNodeTuple->address, false,
+                            auto range = readRange(addressNodeTuple->address, addressNodeTuple->node.size);
+                            displayNode(&addressNodeTuple->node, range, addressNodeTuple->address, false,
                                         addressNodeTuple->addressOfPointer, functionData.id);
                         } else if (auto* registerValue = std::get_if<ImmediateValue>(&argData)) {
                             ImGui::TableNextRow();
@@ -76,6 +76,8 @@ class TypedDebugger {
         std::string type;
         std::string name;
         size_t size = 0;
+        // Where this node sits within its parent, or within the pointee for the children of a pointer.
+        uint32_t offset = 0;
         std::vector<WatchTreeNode> children;
         std::vector<ReadWriteLogEntry> logEntries;
     };
@@ -111,6 +113,17 @@ class TypedDebugger {
     std::unordered_map<std::string, StructFields> m_structs;
     std::vector<std::string> m_typeNames;
 
+    // The fields of each struct, flattened once after importing into a table of offsets, along with the size of the
+    // whole, so that building and walking watches doesn't have to add up field sizes over and over.
+    struct StructLayout {
+        size_t size = 0;
+        std::vector<uint32_t> offsets;
+    };
+    std::unordered_map<std::string, StructLayout> m_layouts;
+    void compileLayouts();
+    // The size of a type, arrays included, as far as the imported structs know; 0 if they don't.
+    size_t typeSize(const std::string& type) const;
+
     /**
      * Watch.
      */
@@ -141,19 +154,29 @@ class TypedDebugger {
     std::unordered_map<uint32_t, std::array<uint8_t, 8>> m_disabledFunctions;
 
     // Returns the name of the function from which the instruction at the given address was emitted if found, an empty
-    // string otherwise.
+    // string otherwise. This is a binary search through m_functionAddresses, which is kept sorted.
     std::string_view getFunctionNameFromInstructionAddress(uint32_t address);
-    std::unordered_map<uint32_t, std::string> m_instructionAddressToFunctionMap;
 
     /**
      * Display.
      */
 
+    // A contiguous range of memory, read in one go, which the values of a watch and of its children get read from.
+    // Each watch gets one for itself, and each expanded pointer one for its pointee.
+    struct MemoryRange {
+        uint32_t address = 0;
+        Slice data;
+    };
+    MemoryRange readRange(uint32_t address, size_t size);
+    // Reads from the range if it covers what's asked for, or from memory directly otherwise.
+    Slice readValue(const MemoryRange& range, uint32_t address, size_t size);
+    IO<File> m_memFile;
+
     // The last parameter, addressOfPointer, is used for pointer nodes:
     // - if it is true, then currentAddress is the address of the pointer that *stores* the pointee address;
     // - if not, then currentAddress *is* the pointee address.
-    void displayNode(WatchTreeNode* node, const uint32_t currentAddress, bool watchView, bool addressOfPointer,
-                     uint32_t extraImGuiId = 0);
+    void displayNode(WatchTreeNode* node, const MemoryRange& range, const uint32_t currentAddress, bool watchView,
+                     bool addressOfPointer, uint32_t extraImGuiId = 0);
     void printValue(const char* type, size_t type_size, void* value);
     void printValue(const char* type, size_t type_size, Slice value);
     void displayNewValueInput(const char* type, size_t size_type, Slice value, IO<File> memFile);
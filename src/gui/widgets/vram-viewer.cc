@@ -587,6 +587,8 @@ void PCSX::Widgets::VRAMViewer::draw(GUI *gui, unsigned int VRAMTexture) {
     bool openPixelGridColorPicker = false;
     bool openTPageGridColorPicker = false;
     auto flags = ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_MenuBar;
+    // The frame may not be over yet, such as when paused in the middle of it.
+    g_emulator->m_gpuLogger->drawHeatmaps();
     if (ImGui::Begin(m_title().c_str(), &m_show, flags)) {
         m_DPI = ImGui::GetWindowDpiScale();
         if (!m_firstShown) {
@@ -19,6 +19,8 @@
 
 #include "lua/extra.h"
 
+#include <string.h>
+
 #include <filesystem>
 #include <string_view>
 #include <vector>
@@ -32,7 +34,8 @@
 
 namespace {
 
-std::vector<PCSX::ZipArchive> s_archives;
+// Each emulator of the process has its own Lua state, loading from its own archives.
+thread_local std::vector<PCSX::ZipArchive> s_archives;
 PCSX::File* load(std::string_view name, std::string_view from, bool inArchives = true) {
     bool doRelative = false;
     if (!from.empty() && (from[0] == '@')) {
@@ -81,8 +84,28 @@ PCSX::File* load(std::string_view name, std::string_view from, bool inArchives =
     return new PCSX::PosixFile(absolutePath);
 }
 
+// Runs the code of a module the first time something requires it, instead of at startup. The code and the
+// name of the chunk are the upvalues of the closure.
+int loadLazyModule(lua_State* L) {
+    auto code = static_cast<const char*>(lua_touserdata(L, lua_upvalueindex(1)));
+    auto name = static_cast<const char*>(lua_touserdata(L, lua_upvalueindex(2)));
+    if (luaL_loadbuffer(L, code, strlen(code), name) != 0) return lua_error(L);
+    lua_call(L, 0, 1);
+    return 1;
+}
+
 }  // namespace
 
+void PCSX::LuaFFI::preloadModule(Lua L, const char* module, const char* code, const char* name) {
+    L.getfieldtable("package", LUA_GLOBALSINDEX);
+    L.getfieldtable("preload");
+    L.push(const_cast<char*>(code));
+    L.push(const_cast<char*>(name));
+    L.push(loadLazyModule, 2);
+    L.setfield(module);
+    L.pop(2);
+}
+
 PCSX::ZipArchive& PCSX::LuaFFI::addArchive(Lua L, IO<File> file) {
     auto& newArchive = s_archives.emplace_back(file);
     if (newArchive.failed()) {
@@ -142,17 +165,11 @@ void PCSX::LuaFFI::open_extra(Lua L) {
     L.load(pprint_internals, "third_party:pprint.lua/pprint-internals.lua");
     L.load(reflectFFI, "third_party:ffi-reflect/reflect.lua");
 
-    L.load(protobufLexer, "third_party:lua-protobuf/lexer.lua");
-    L.setfield("pb.Lexer");
-
-    L.load(protobufTopLevel, "third_party:lua-protobuf/toplevel.lua");
-    L.setfield("pb.TopLevel");
-
-    L.load(descriptorPB, "third_party:lua-protobuf/descriptor.pb.lua");
-    L.setfield("pb.Descriptor");
-
-    L.load(protoc, "third_party:lua-protobuf/protoc.lua");
-    L.setfield("protoc");
+    // Most scripts never compile any protobuf, so this only gets loaded when they require it
+    preloadModule(L, "pb.Lexer", protobufLexer, "third_party:lua-protobuf/lexer.lua");
+    preloadModule(L, "pb.TopLevel", protobufTopLevel, "third_party:lua-protobuf/toplevel.lua");
+    preloadModule(L, "pb.Descriptor", descriptorPB, "third_party:lua-protobuf/descriptor.pb.lua");
+    preloadModule(L, "protoc", protoc, "third_party:lua-protobuf/protoc.lua");
 
     L.load(extra, "src:lua/extra.lua");
 
@@ -28,6 +28,9 @@ namespace PCSX {
 namespace LuaFFI {
 void open_extra(Lua);
 ZipArchive& addArchive(Lua, IO<File>);
+// Makes require(module) run this code the first time, instead of running it right away. Both strings need to
+// outlive the Lua state.
+void preloadModule(Lua, const char* module, const char* code, const char* name);
 }  // namespace LuaFFI
 
 }  // namespace PCSX
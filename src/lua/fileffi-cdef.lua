@@ -20,6 +20,7 @@ ffi.cdef [[
 typedef struct { char opaque[?]; } LuaFile;
 typedef struct { uint32_t size; uint8_t data[?]; } LuaBuffer;
 typedef struct { char opaque[?]; } LuaSlice;
+typedef struct { char opaque[?]; } LuaView;
 
 enum FileOps {
     READ,
@@ -27,6 +28,7 @@ enum FileOps {
     CREATE,
     READWRITE,
     DOWNLOAD_URL,
+    STREAM_URL,
 };
 
 enum SeekWheel {
@@ -51,6 +53,7 @@ LuaFile* uvFifo(const char* address, int port);
 bool uvFifoIsConnecting(LuaFile*);
 
 LuaFile* failedFile();
+LuaFile* mapFile(const char* filename);
 
 void closeFile(LuaFile* wrapper);
 
@@ -84,6 +87,7 @@ bool isFileCaching(LuaFile*);
 float fileCacheProgress(LuaFile*);
 void startFileCaching(LuaFile*);
 bool startFileCachingWithCallback(LuaFile* wrapper, void (*callback)());
+void startFileBlockCaching(LuaFile* wrapper, uint64_t memoryCap, const char* spillDirectory);
 
 LuaFile* dupFile(LuaFile*);
 
@@ -93,6 +97,14 @@ uint64_t getSliceSize(LuaSlice*);
 const void* getSliceData(LuaSlice*);
 void destroySlice(LuaSlice*);
 
+LuaView* viewFile(LuaFile* wrapper, uint64_t pos, uint64_t size);
+LuaView* viewSlice(LuaSlice* slice, uint64_t offset, uint64_t size);
+LuaView* subView(LuaView* view, uint64_t offset, uint64_t size);
+const uint8_t* getViewData(LuaView*);
+uint64_t getViewSize(LuaView*);
+int64_t viewFind(LuaView* view, const void* needle, uint64_t size, uint64_t from);
+void destroyView(LuaView*);
+
 LuaFile* mem4g();
 uint32_t mem4gLowestAddress(LuaFile*);
 uint32_t mem4gHighestAddress(LuaFile*);
@@ -103,6 +115,11 @@ enum FFmpegAudioFileEndianness { Little, Big };
 enum FFmpegAudioFileSampleFormat { U8, S16, S32, F32, D64 };
 LuaFile* ffmpegAudioFile(LuaFile* file, enum FFmpegAudioFileChannels, enum FFmpegAudioFileEndianness, enum FFmpegAudioFileSampleFormat, unsigned frequency);
 
+uint32_t crc32File(LuaFile* wrapper);
+uint64_t xxh64File(LuaFile* wrapper, uint64_t seed);
+void md5Files(LuaFile** files, unsigned count, char* hex);
+void sha1Files(LuaFile** files, unsigned count, char* hex);
+
 ]]
 
 -- )EOF"
@@ -87,9 +87,21 @@ local function writeAt(self, data, size, pos)
                                  string.len(data), size)
 end
 
-local function writeMoveSlice(self, slice) C.writeFileMoveSlice(self._wrapper, slice._wrapper) end
+local function writeMoveSlice(self, slice)
+    if rawget(slice, '_viewed') then return write(self, slice.data, slice.size) end
+    C.writeFileMoveSlice(self._wrapper, slice._wrapper)
+end
+
+local function writeAtMoveSlice(self, slice, pos)
+    if rawget(slice, '_viewed') then return writeAt(self, slice.data, slice.size, pos) end
+    C.writeFileAtMoveSlice(self._wrapper, slice._wrapper, pos)
+end
 
-local function writeAtMoveSlice(self, slice, pos) C.writeFileAtMoveSlice(self._wrapper, slice._wrapper, pos) end
+local function view(self, pos, size)
+    pos = pos or 0
+    size = size or self:size() - pos
+    return Support.File._createViewWrapper(Support.extra.safeFFI('File::view', C.viewFile, self._wrapper, pos, size))
+end
 
 local function rSeek(self, pos, wheel)
     if wheel == nil then wheel = 'SEEK_SET' end
@@ -164,6 +176,22 @@ local int16_t = ffi.typeof 'int16_t[1]'
 local int32_t = ffi.typeof 'int32_t[1]'
 local int64_t = ffi.typeof 'int64_t[1]'
 
+-- Hashes all of the files at once, which is faster than one after the other, and returns their digests in hex.
+local function hashFiles(name, hasher, digestSize, files)
+    local count = #files
+    local wrappers = ffi.new('LuaFile*[?]', count)
+    for i, file in ipairs(files) do wrappers[i - 1] = file._wrapper end
+    local hexSize = digestSize * 2 + 1
+    local hex = ffi.new('char[?]', count * hexSize)
+    Support.extra.safeFFI(name, hasher, wrappers, count, hex)
+    local ret = {}
+    for i = 1, count do ret[i] = ffi.string(hex + (i - 1) * hexSize) end
+    return ret
+end
+
+local function md5(files) return hashFiles('Support.File.md5', C.md5Files, 16, files) end
+local function sha1(files) return hashFiles('Support.File.sha1', C.sha1Files, 20, files) end
+
 local function deleteFile(wrapper) Support.extra.safeFFI('File::~File', C.deleteFile, wrapper) end
 
 local function createFileWrapper(wrapper)
@@ -192,10 +220,20 @@ local function createFileWrapper(wrapper)
         cacheProgress = function(self) return C.fileCacheProgress(self._wrapper) end,
         startCaching = function(self) return C.startFileCaching(self._wrapper) end,
         startCachingAndWait = startCachingAndWait,
+        startBlockCaching = function(self, memoryCap, spillDirectory)
+            return C.startFileBlockCaching(self._wrapper, memoryCap or 64 * 1024 * 1024, spillDirectory)
+        end,
         dup = function(self) return createFileWrapper(C.dupFile(self._wrapper)) end,
+        view = view,
         subFile = function(self, start, size)
             return createFileWrapper(C.subFile(self._wrapper, start or 0, size or -1))
         end,
+        crc32 = function(self) return Support.extra.safeFFI('File::crc32', C.crc32File, self._wrapper) end,
+        xxh64 = function(self, seed)
+            return Support.extra.safeFFI('File::xxh64', C.xxh64File, self._wrapper, seed or 0)
+        end,
+        md5 = function(self) return md5({self})[1] end,
+        sha1 = function(self) return sha1({self})[1] end,
         readU8 = function(self) return readNum(self, uint8_t) end,
         readU16 = function(self) return readNum(self, uint16_t) end,
         readU32 = function(self) return readNum(self, uint32_t) end,
@@ -255,6 +293,8 @@ local function open(filename, t)
     end
 end
 
+local function map(filename) return createFileWrapper(C.mapFile(filename)) end
+
 local function buffer(ptr, size, type)
     local f
     if ptr == nil and size == nil and type == nil then
@@ -320,11 +360,14 @@ Support.isLuaBuffer = function(obj) return ffi.istype('LuaBuffer', obj) end
 Support.File = {
     open = open,
     buffer = buffer,
+    map = map,
     zReader = zReader,
     uvFifo = uvFifo,
     mem4g = mem4g,
     failedFile = function() return createFileWrapper(C.failedFile()) end,
     ffmpegAudioFile = ffmpegAudioFile,
+    md5 = md5,
+    sha1 = sha1,
     _createFileWrapper = createFileWrapper,
 }
 
@@ -29,6 +29,14 @@ local sliceMeta = {
             return C.getSliceData(slice._wrapper)
         elseif index == 'size' then
             return tonumber(C.getSliceSize(slice._wrapper))
+        elseif index == 'view' then
+            return function(slice, offset, size)
+                offset = offset or 0
+                size = size or tonumber(C.getSliceSize(slice._wrapper)) - offset
+                -- Moving a viewed slice into a file would leave its views dangling, so it gets copied instead.
+                rawset(slice, '_viewed', true)
+                return Support.File._createViewWrapper(C.viewSlice(slice._wrapper, offset, size), slice)
+            end
         end
         error('Unknown index `' .. index .. '` for LuaSlice')
     end,
@@ -40,6 +48,52 @@ local function createSliceWrapper(wrapper)
     return setmetatable(slice, sliceMeta)
 end
 
+local viewMethods = {
+    sub = function(view, offset, size)
+        offset = offset or 0
+        size = size or view.size - offset
+        return Support.File._createViewWrapper(C.subView(view._wrapper, offset, size), view._pin)
+    end,
+    string = function(view, offset, size)
+        offset = offset or 0
+        if offset > view.size then return '' end
+        size = math.min(size or view.size - offset, view.size - offset)
+        return ffi.string(view.data + offset, size)
+    end,
+    find = function(view, pattern, init)
+        local pos = C.viewFind(view._wrapper, pattern, #pattern, init or 0)
+        if pos < 0 then return nil end
+        return tonumber(pos)
+    end,
+}
+
+local viewMeta = {
+    __tostring = function(view) return ffi.string(view.data, view.size) end,
+    __len = function(view) return view.size end,
+    __index = function(view, index)
+        if type(index) == 'number' and index >= 0 and index < view.size then
+            return view.data[index]
+        elseif viewMethods[index] then
+            return viewMethods[index]
+        end
+        error('Unknown index `' .. index .. '` for LuaView')
+    end,
+    __newindex = function(view, index, value) error('LuaView is read-only') end,
+}
+
+-- The pin is whatever Lua object owns the memory the view looks at, and which has to outlive it.
+local function createViewWrapper(wrapper, pin)
+    if wrapper == nil then return nil end
+    local view = {
+        _wrapper = ffi.gc(wrapper, C.destroyView),
+        _pin = pin,
+        _type = 'View',
+        data = C.getViewData(wrapper),
+        size = tonumber(C.getViewSize(wrapper)),
+    }
+    return setmetatable(view, viewMeta)
+end
+
 local bufferMeta = {
     __tostring = function(buffer) return ffi.string(buffer.data, buffer.size) end,
     __len = function(buffer) return buffer.size end,
@@ -71,5 +125,6 @@ local LuaBuffer = ffi.metatype('LuaBuffer', bufferMeta)
 
 Support.File._LuaBuffer = LuaBuffer
 Support.File._createSliceWrapper = createSliceWrapper
+Support.File._createViewWrapper = createViewWrapper
 
 -- )EOF"
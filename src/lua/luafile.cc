@@ -19,10 +19,17 @@
 
 #include "lua/luafile.h"
 
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "core/psxmem.h"
 #include "core/system.h"
 #include "lua-protobuf/pb.h"
 #include "lua/luawrapper.h"
 #include "support/ffmpeg-audio-file.h"
+#include "support/hashing.h"
 #include "support/mem4g.h"
 #include "support/uvfile.h"
 #include "support/zfile.h"
@@ -30,6 +37,7 @@
 namespace {
 
 using LuaFile = PCSX::LuaFFI::LuaFile;
+using LuaView = PCSX::LuaFFI::LuaView;
 
 enum FileOps {
     READ,
@@ -37,6 +45,7 @@ enum FileOps {
     CREATE,
     READWRITE,
     DOWNLOAD_URL,
+    STREAM_URL,
 };
 
 void deleteFile(LuaFile* wrapper) { delete wrapper; }
@@ -53,6 +62,8 @@ LuaFile* openFile(const char* filename, FileOps type) {
             return new LuaFile(new PCSX::UvFile(filename, PCSX::FileOps::READWRITE));
         case DOWNLOAD_URL:
             return new LuaFile(new PCSX::UvFile(filename, PCSX::UvFile::DOWNLOAD_URL));
+        case STREAM_URL:
+            return new LuaFile(new PCSX::UvFile(filename, PCSX::UvFile::STREAM_URL));
     }
 
     return nullptr;
@@ -77,6 +88,7 @@ LuaFile* subFile(LuaFile* wrapper, uint64_t start, int64_t size) {
 LuaFile* uvFifo(const char* address, int port) { return new LuaFile(new PCSX::UvFifo(address, port)); }
 bool uvFifoIsConnecting(LuaFile* wrapper) { return wrapper->file.asA<PCSX::UvFifo>()->isConnecting(); }
 LuaFile* failedFile() { return new LuaFile(new PCSX::FailedFile()); }
+LuaFile* mapFile(const char* filename) { return new LuaFile(new PCSX::MappedFile(filename)); }
 
 void closeFile(LuaFile* wrapper) { wrapper->file->close(); }
 
@@ -150,6 +162,10 @@ void startFileCaching(LuaFile* wrapper) {
     PCSX::IO<PCSX::UvFile> file = wrapper->file.asA<PCSX::UvFile>();
     if (file) file->startCaching();
 }
+void startFileBlockCaching(LuaFile* wrapper, uint64_t memoryCap, const char* spillDirectory) {
+    PCSX::IO<PCSX::UvFile> file = wrapper->file.asA<PCSX::UvFile>();
+    if (file) file->startBlockCaching(memoryCap, spillDirectory ? spillDirectory : "");
+}
 bool startFileCachingWithCallback(LuaFile* wrapper, void (*callback)()) {
     PCSX::IO<PCSX::UvFile> file = wrapper->file.asA<PCSX::UvFile>();
     if (file) {
@@ -173,6 +189,54 @@ const void* getSliceData(PCSX::Slice* slice) { return slice->data(); }
 
 void destroySlice(PCSX::Slice* slice) { delete slice; }
 
+// Only files whose contents sit still in host memory can be viewed; anything else, including buffers which
+// could get reallocated by a write, has to be read the usual way.
+LuaView* viewFile(LuaFile* wrapper, uint64_t pos, uint64_t size) {
+    auto& file = wrapper->file;
+    uint64_t fileSize = file->size();
+    if (pos > fileSize) return nullptr;
+    size = std::min(size, fileSize - pos);
+    const uint8_t* data = nullptr;
+    if (file.isA<PCSX::MappedFile>()) {
+        data = file.asA<PCSX::MappedFile>()->data();
+    } else if (file.isA<PCSX::BufferFile>() && !file->writable()) {
+        data = reinterpret_cast<const uint8_t*>(file.asA<PCSX::BufferFile>()->borrow().data());
+    } else if (file.isA<PCSX::Memory::MemoryAsFile>()) {
+        data = file.asA<PCSX::Memory::MemoryAsFile>()->contiguous(size, pos);
+        if (data) return new LuaView(file, data, size);
+    }
+    if (!data) return nullptr;
+    return new LuaView(file, data + pos, size);
+}
+
+LuaView* viewSlice(PCSX::Slice* slice, uint64_t offset, uint64_t size) {
+    if (offset > slice->size()) return nullptr;
+    size = std::min(size, slice->size() - offset);
+    return new LuaView({}, reinterpret_cast<const uint8_t*>(slice->data()) + offset, size);
+}
+
+LuaView* subView(LuaView* view, uint64_t offset, uint64_t size) {
+    if (offset > view->size) return nullptr;
+    size = std::min(size, view->size - offset);
+    return new LuaView(view->pin, view->data + offset, size);
+}
+
+const uint8_t* getViewData(LuaView* view) { return view->data; }
+
+uint64_t getViewSize(LuaView* view) { return view->size; }
+
+int64_t viewFind(LuaView* view, const void* pattern, uint64_t size, uint64_t from) {
+    if (from > view->size) return -1;
+    auto needle = static_cast<const uint8_t*>(pattern);
+    auto begin = view->data + from;
+    auto end = view->data + view->size;
+    auto found = std::search(begin, end, std::boyer_moore_horspool_searcher(needle, needle + size));
+    if (found == end && size != 0) return -1;
+    return found - view->data;
+}
+
+void destroyView(LuaView* view) { delete view; }
+
 int readFileUserData(PCSX::Lua L) {
     if (L.gettop() != 3) return L.error("Invalid number of arguments to readFileUserData");
 
@@ -278,6 +342,51 @@ LuaFile* ffmpegAudioFile(LuaFile* file, PCSX::FFmpegAudioFile::Channels channels
     return new LuaFile(new PCSX::FFmpegAudioFile(file->file, channels, endianness, sampleFormat, frequency));
 }
 
+uint32_t crc32File(LuaFile* wrapper) {
+    static constexpr size_t c_chunkSize = 1024 * 1024;
+    auto& file = wrapper->file;
+    const size_t size = file->size();
+    uint32_t crc = 0;
+    for (size_t pos = 0; pos < size; pos += c_chunkSize) {
+        PCSX::Slice chunk = file->readAt(std::min(c_chunkSize, size - pos), pos);
+        crc = PCSX::Hashing::crc32(crc, chunk.data(), chunk.size());
+    }
+    return crc;
+}
+
+uint64_t xxh64File(LuaFile* wrapper, uint64_t seed) {
+    PCSX::Slice data = wrapper->file->readAt(wrapper->file->size(), 0);
+    return PCSX::Hashing::xxh64(data.data(), data.size(), seed);
+}
+
+// Reads all of the files in memory, and writes their digests in hex, each one null terminated, back to back.
+template <typename Digest, typename Hasher>
+void hashFiles(LuaFile** files, unsigned count, char* hex, Hasher hasher) {
+    std::vector<PCSX::Slice> slices(count);
+    std::vector<std::string_view> inputs(count);
+    std::vector<Digest> digests(count);
+    for (unsigned i = 0; i < count; i++) {
+        slices[i] = files[i]->file->readAt(files[i]->file->size(), 0);
+        inputs[i] = slices[i].asStringView();
+    }
+    hasher(inputs, digests);
+    for (auto& digest : digests) {
+        for (auto byte : digest) {
+            *hex++ = "0123456789abcdef"[byte >> 4];
+            *hex++ = "0123456789abcdef"[byte & 15];
+        }
+        *hex++ = 0;
+    }
+}
+
+void md5Files(LuaFile** files, unsigned count, char* hex) {
+    hashFiles<PCSX::Hashing::MD5Digest>(files, count, hex, PCSX::Hashing::md5);
+}
+
+void sha1Files(LuaFile** files, unsigned count, char* hex) {
+    hashFiles<PCSX::Hashing::SHA1Digest>(files, count, hex, PCSX::Hashing::sha1);
+}
+
 }  // namespace
 
 template <typename T, size_t S>
@@ -306,6 +415,7 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, uvFifo);
     REGISTER(L, uvFifoIsConnecting);
     REGISTER(L, failedFile);
+    REGISTER(L, mapFile);
 
     REGISTER(L, closeFile);
 
@@ -338,6 +448,7 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, fileCacheProgress);
     REGISTER(L, startFileCaching);
     REGISTER(L, startFileCachingWithCallback);
+    REGISTER(L, startFileBlockCaching);
 
     REGISTER(L, dupFile);
 
@@ -347,6 +458,14 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, getSliceData);
     REGISTER(L, destroySlice);
 
+    REGISTER(L, viewFile);
+    REGISTER(L, viewSlice);
+    REGISTER(L, subView);
+    REGISTER(L, getViewData);
+    REGISTER(L, getViewSize);
+    REGISTER(L, viewFind);
+    REGISTER(L, destroyView);
+
     REGISTER(L, mem4g);
     REGISTER(L, mem4gLowestAddress);
     REGISTER(L, mem4gHighestAddress);
@@ -354,6 +473,11 @@ static void registerAllSymbols(PCSX::Lua L) {
 
     REGISTER(L, ffmpegAudioFile);
 
+    REGISTER(L, crc32File);
+    REGISTER(L, xxh64File);
+    REGISTER(L, md5Files);
+    REGISTER(L, sha1Files);
+
     L.settable();
     L.pop();
 }
@@ -52,6 +52,15 @@ struct LuaFile {
     IO<File> file;
 };
 
+// A read-only window onto memory which belongs to something else, which it keeps alive through its pin. Views
+// over slices have nothing to pin here, as the Lua side holds onto the slice itself.
+struct LuaView {
+    LuaView(IO<File> pin, const uint8_t* data, uint64_t size) : pin(pin), data(data), size(size) {}
+    IO<File> pin;
+    const uint8_t* data;
+    uint64_t size;
+};
+
 void open_file(Lua);
 }  // namespace LuaFFI
 
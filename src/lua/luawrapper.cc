@@ -21,6 +21,8 @@
 
 #include <assert.h>
 
+#include "tracy/Tracy.hpp"
+
 static int callwrap(lua_State* raw, lua_CFunction func) {
     PCSX::Lua L(raw);
 
@@ -226,6 +228,7 @@ void PCSX::Lua::call(int nargs) {
 }
 
 int PCSX::Lua::pcall(int nargs) {
+    ZoneScoped;
     push([](lua_State* L_) -> int {
         Lua L(L_);
         L.pushLuaContext(true);
@@ -17,16 +17,26 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <algorithm>
+#include <chrono>
 #include <csignal>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "core/arguments.h"
 #include "core/cdrom.h"
+#include "core/framehashes.h"
+#include "core/framestats.h"
+#include "core/gpucapture.h"
 #include "core/gpu.h"
+#include "core/guestcoverage.h"
 #include "core/logger.h"
+#include "core/psxmem.h"
 #include "core/psxemulator.h"
 #include "core/r3000a.h"
 #include "core/sstate.h"
@@ -36,14 +46,17 @@
 #include "gui/gui.h"
 #include "lua/extra.h"
 #include "lua/luawrapper.h"
+#include "main/main.h"
 #include "main/textui.h"
 #include "spu/interface.h"
 #include "support/binpath.h"
+#include "support/hashing.h"
 #include "support/uvfile.h"
 #include "support/version.h"
 #include "tracy/Tracy.hpp"
 
-static PCSX::UI *s_ui;
+// The emulators running in the same process each have their own UI, on the thread running them.
+static thread_local PCSX::UI *s_ui;
 
 class SystemImpl final : public PCSX::System {
     virtual void biosPutc(int c) final override {
@@ -166,8 +179,35 @@ struct Cleaner {
     std::function<void()> f;
 };
 
-int pcsxMain(int argc, char **argv) {
+// How long each part of the startup takes, printed with -startuptimes.
+class StartupTimes {
+  public:
+    void phase(const char *name) {
+        const auto now = Clock::now();
+        m_phases.emplace_back(name, now - m_last);
+        m_last = now;
+    }
+    void print() const {
+        Clock::duration total = {};
+        for (const auto &[name, time] : m_phases) {
+            PCSX::g_system->printf("Startup: %-16s %8.2fms\n", name, milliseconds(time));
+            total += time;
+        }
+        PCSX::g_system->printf("Startup: %-16s %8.2fms\n", "total", milliseconds(total));
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    static double milliseconds(Clock::duration time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+    Clock::time_point m_last = Clock::now();
+    std::vector<std::pair<const char *, Clock::duration>> m_phases;
+};
+
+int pcsxMain(int argc, char **argv, MainStats *stats) {
     ZoneScoped;
+    StartupTimes startupTimes;
     // Command line arguments are parsed after this point.
     const CommandLine::args args(argc, argv);
     // The UvFile and UvFifo should work past this point.
@@ -206,6 +246,7 @@ int pcsxMain(int argc, char **argv) {
     std::filesystem::path binDir = std::filesystem::absolute(self).parent_path();
     system->setBinDir(binDir);
     system->loadAllLocales();
+    startupTimes.phase("system");
 
     // This is another early out, which can only be done once we have a system object.
     if (args.get<bool>("version")) {
@@ -225,6 +266,7 @@ int pcsxMain(int argc, char **argv) {
     PCSX::Emulator *emulator = new PCSX::Emulator();
     PCSX::g_emulator = emulator;
     auto &favorites = emulator->settings.get<PCSX::Emulator::SettingOpenDialogFavorites>().value;
+    startupTimes.phase("emulator");
 
     s_ui = args.get<bool>("no-ui") || args.get<bool>("cli") ? reinterpret_cast<PCSX::UI *>(new PCSX::TUI())
                                                             : reinterpret_cast<PCSX::UI *>(new PCSX::GUI(favorites));
@@ -311,6 +353,34 @@ int pcsxMain(int argc, char **argv) {
         if (args.get<bool>("interpreter")) {
             emuSettings.get<PCSX::Emulator::SettingDynarec>() = false;
         }
+        if (args.get<bool>("idle-skip")) {
+            emuSettings.get<PCSX::Emulator::SettingIdleSkipping>() = true;
+        }
+        if (args.get<bool>("no-idle-skip")) {
+            emuSettings.get<PCSX::Emulator::SettingIdleSkipping>() = false;
+        }
+        if (args.get<bool>("bios-hle")) {
+            emuSettings.get<PCSX::Emulator::SettingBiosHLE>() = true;
+        }
+        if (args.get<bool>("no-bios-hle")) {
+            emuSettings.get<PCSX::Emulator::SettingBiosHLE>() = false;
+        }
+        if (args.get<bool>("dynarec-native-gte")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecNativeGTE>() = true;
+        }
+        if (args.get<bool>("no-dynarec-native-gte")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecNativeGTE>() = false;
+        }
+        if (args.get<bool>("dynarec-gte-flag-elision")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecGTEFlagElision>() = true;
+        }
+        if (args.get<bool>("no-dynarec-gte-flag-elision")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecGTEFlagElision>() = false;
+        }
+        auto argDynarecBlockHints = args.get<std::string>("dynarec-hints");
+        if (argDynarecBlockHints.has_value()) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecBlockHints>() = argDynarecBlockHints.value();
+        }
 
         if (args.get<bool>("openglgpu")) {
             emuSettings.get<PCSX::Emulator::SettingHardwareRenderer>() = true;
@@ -327,6 +397,7 @@ int pcsxMain(int argc, char **argv) {
             emuSettings.get<PCSX::Emulator::SettingKioskMode>() = false;
         }
     });
+    startupTimes.phase("ui");
 
     // Now it's time to mount our iso filesystem
     std::filesystem::path isoToOpen = args.get<std::string>("iso", "");
@@ -334,9 +405,11 @@ int pcsxMain(int argc, char **argv) {
     if (isoToOpen.empty()) isoToOpen = args.get<std::string>("disk", "");
     if (!isoToOpen.empty()) emulator->m_cdrom->setIso(new PCSX::CDRIso(isoToOpen));
     emulator->m_cdrom->check();
+    startupTimes.phase("iso");
 
     // After settings are loaded, we're fine setting the SPU part of the emulation.
     emulator->m_spu->init();
+    startupTimes.phase("spu");
 
     // Make sure the Lua environment is set.
     bool luacovEnabled = false;
@@ -369,29 +442,71 @@ runner.init({
     s_ui->setLua(*emulator->m_lua);
     emulator->m_spu->setLua(*emulator->m_lua);
     assert(emulator->m_lua->gettop() == 0);
+    startupTimes.phase("lua");
 
     // Starting up the whole emulator; we delay setting the GPU only now because why not.
     auto &emuSettings = emulator->settings;
     emulator->m_spu->open();
     emulator->init();
+    startupTimes.phase("emulator init");
     emulator->m_gpu->init(s_ui);
     emulator->m_gpu->setDither(emuSettings.get<PCSX::Emulator::SettingDither>());
     emulator->m_gpu->setCachedDithering(emuSettings.get<PCSX::Emulator::SettingCachedDithering>());
     emulator->m_gpu->setLinearFiltering();
+    emulator->m_gpu->setFrameSkip(system->getArgs().getFrameSkip());
+    startupTimes.phase("gpu");
     emulator->reset();
+    startupTimes.phase("reset");
+
+    // Guest code coverage, written out as an lcov tracefile when exiting.
+    auto guestCoverage = args.get<std::string>("guestcov");
+    if (guestCoverage.has_value()) {
+        emulator->m_guestCoverage->start(emulator->getRamMask());
+        emulator->m_cpu->invalidateCache();
+    }
+
+    // Hashes of what each frame displays, logged, or checked against the log of a golden run.
+    auto frameHashes = args.get<std::string>("framehashes");
+    if (frameHashes.has_value()) {
+        emulator->m_frameHashes->record(new PCSX::PosixFile(frameHashes.value(), PCSX::FileOps::TRUNCATE));
+    }
+    auto goldenHashes = args.get<std::string>("golden");
+    if (goldenHashes.has_value()) emulator->m_frameHashes->compare(new PCSX::PosixFile(goldenHashes.value()));
 
     // Looking at setting up what to run exactly within the emulator, if requested.
     if (args.get<bool>("run")) system->resume();
     s_ui->m_exeToLoad.set(MAKEU8(args.get<std::string>("loadexe", "").c_str()));
     if (s_ui->m_exeToLoad.empty()) s_ui->m_exeToLoad.set(MAKEU8(args.get<std::string>("exe", "").c_str()));
 
+    // Only counting the frames emulated for real, the way rewind and movies see them. With -frames, the run is
+    // over after that many of them, for the programs which never exit on their own.
+    uint64_t frames = 0;
+    const uint64_t frameBudget = std::max(args.get<int>("frames", 0), 0);
+    PCSX::EventBus::Listener statsListener(system->m_eventBus);
+    statsListener.listen<PCSX::Events::GPU::VSync>([&frames, frameBudget, system](const auto &event) {
+        if (++frames == frameBudget) system->quit(0);
+    });
+
     // And finally, let's run things.
     int exitCode = 0;
     {
         // First, set up a closer. This makes sure that everything is shut down gracefully,
         // in the right order, once we exit the scope. This is because of how we're still
         // allowing exceptions to occur.
-        Cleaner cleaner([&emulator, &system, &exitCode, luacovEnabled, sigint, sigterm]() {
+        Cleaner cleaner([&emulator, &system, &exitCode, luacovEnabled, sigint, sigterm, stats, &frames,
+                         &guestCoverage]() {
+            if (stats) {
+                stats->cycles = emulator->m_cpu->m_regs.cycle;
+                stats->frames = frames;
+                stats->dynarec = emulator->m_cpu->isDynarec();
+                stats->ramHash = PCSX::Hashing::xxh64(emulator->m_mem->m_wram, emulator->getRamMask() + 1);
+                auto vram = emulator->m_gpu->getVRAM();
+                stats->vramHash = PCSX::Hashing::xxh64(vram.data(), vram.size());
+            }
+            if (guestCoverage.has_value()) {
+                PCSX::IO<PCSX::File> file(new PCSX::PosixFile(guestCoverage.value(), PCSX::FileOps::TRUNCATE));
+                emulator->m_guestCoverage->writeLcov(file, emulator->m_cpu->m_symbols);
+            }
             emulator->m_spu->close();
             emulator->m_cdrom->clearIso();
 
@@ -441,13 +556,55 @@ runner.init({
             for (auto &luaexec : luaexecs) {
                 L->load(std::string(luaexec), "cmdline:");
             }
+            startupTimes.phase("scripts");
+            if (args.get<bool>("startuptimes")) startupTimes.print();
+
+            // Replaying a GPU capture stands in for running anything, to measure the GPU on its own, or to
+            // compare what the backends draw out of it.
+            auto gpuReplay = args.get<std::string>("gpureplay");
+            if (gpuReplay.has_value()) {
+                PCSX::GPUCapture capture;
+                if (capture.load(new PCSX::PosixFile(gpuReplay.value()))) {
+                    auto &gpu = emulator->m_gpu;
+                    const int iterations = std::max(args.get<int>("gpureplay-iterations", 1), 1);
+                    auto report = capture.replay(gpu.get(), iterations, !args.get<bool>("gpureplay-whole"));
+                    auto vram = gpu->getVRAM(PCSX::GPU::Ownership::ACQUIRE);
+                    auto saveVRAM = args.get<std::string>("gpureplay-save-vram");
+                    if (saveVRAM.has_value()) {
+                        PCSX::IO<PCSX::File> out(new PCSX::PosixFile(saveVRAM.value(), PCSX::FileOps::TRUNCATE));
+                        out->write(vram.data(), vram.size());
+                    }
+                    auto compareVRAM = args.get<std::string>("gpureplay-compare-vram");
+                    if (compareVRAM.has_value()) {
+                        PCSX::IO<PCSX::File> in(new PCSX::PosixFile(compareVRAM.value()));
+                        PCSX::Slice reference;
+                        if (!in->failed()) reference = in->read(PCSX::GPU::c_vramSize);
+                        if (reference.size() == PCSX::GPU::c_vramSize) {
+                            report["vramDifferences"] =
+                                PCSX::GPUCapture::compareVRAM(vram.data<uint16_t>(), reference.data<uint16_t>());
+                        } else {
+                            report["vramDifferences"] = nullptr;
+                        }
+                    }
+                    if (stats) stats->gpuReplay = report.dump();
+                    fmt::print("{}\n", report.dump(4));
+                    system->quit(0);
+                } else {
+                    system->printf(_("Couldn't load the GPU capture %s\n"), gpuReplay->c_str());
+                    system->quit(1);
+                }
+            }
 
             system->m_inStartup = false;
+            const auto loopStart = std::chrono::steady_clock::now();
+            const uint64_t loopStartCycle = emulator->m_cpu->m_regs.cycle;
+            const uint64_t loopStartFrames = frames;
 
             // And finally, main loop.
             while (!system->quitting()) {
                 if (system->running()) {
                     // This will run until paused or interrupted somehow.
+                    PCSX::FrameStats::Scope scope(*emulator->m_frameStats, PCSX::FrameStats::Counter::CPU);
                     emulator->m_cpu->Execute();
                 } else {
                     // The "update" method will be called periodically by the emulator while
@@ -460,6 +617,20 @@ runner.init({
                     return exitCode;
                 }
             }
+            if (system->getArgs().isUnthrottled()) {
+                const double seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+                const double emulated =
+                    double(emulator->m_cpu->m_regs.cycle - loopStartCycle) / emulator->m_psxClockSpeed;
+                system->printf(_("Emulated %.2fs and %llu frames in %.2fs, %.2fx the speed of the real machine\n"),
+                               emulated, (unsigned long long)(frames - loopStartFrames), seconds,
+                               seconds > 0 ? emulated / seconds : 0.0);
+            }
+            // A forked emulator would be tearing down threads and audio devices which only exist in its parent.
+            if (emulator->isFork()) {
+                fflush(nullptr);
+                std::_Exit(system->exitCode());
+            }
         } catch (...) {
             // This will ensure we don't do certain cleanups that are awaiting other tasks,
             // which could result in deadlocks on exit in case we encountered a serious problem.
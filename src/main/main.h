@@ -19,12 +19,28 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <filesystem>
+#include <string>
+#include <vector>
 
-int pcsxMain(int argc, char** argv);
+// What the emulator got through before exiting, for benchmarking it.
+struct MainStats {
+    uint64_t cycles = 0;
+    uint64_t frames = 0;
+    // Whether the CPU was the dynarec, which may not be there, or may be in use by another emulator of the process.
+    bool dynarec = false;
+    // The xxh64 of main RAM and of VRAM as the emulator exited, to tell whether two runs ended up the same.
+    uint64_t ramHash = 0;
+    uint64_t vramHash = 0;
+    // The report of a -gpureplay run, as JSON.
+    std::string gpuReplay;
+};
+
+int pcsxMain(int argc, char** argv, MainStats* stats = nullptr);
 
 class MainInvoker {
   public:
@@ -35,22 +51,44 @@ class MainInvoker {
         m_args[0] = strdup("pcsx-redux");
         argGenerateOne(m_args, 1, args...);
     }
+    explicit MainInvoker(const std::vector<std::string>& args) {
+        m_count = args.size() + 1;
+        m_args = new char*[m_count + 1];
+        m_args[0] = strdup("pcsx-redux");
+        for (size_t i = 0; i < args.size(); i++) m_args[i + 1] = strdup(findPath(args[i].c_str()).c_str());
+        m_args[m_count] = nullptr;
+    }
     ~MainInvoker() {
         for (char** ptr = m_args; *ptr; ptr++) {
             free(*ptr);
         }
         delete[] m_args;
     }
-    int invoke() {
+    int invoke(MainStats* stats = nullptr) {
         fprintf(stderr, "Starting PCSX-Redux test with arguments:\n");
         for (int i = 0; i < m_count; i++) {
             fprintf(stderr, "  %s\n", m_args[i]);
         }
-        int r = pcsxMain(m_count, m_args);
+        int r = pcsxMain(m_count, m_args, stats);
         fprintf(stderr, "PCSX-Redux test finished with exit code %d\n", r);
         return r;
     }
 
+    // Looks for this file from the current directory and up, so that the tests can run from anywhere in the
+    // tree. Returns the path as it is if there's nothing to find.
+    static std::string findPath(const char* path) {
+        std::filesystem::path cwd = std::filesystem::current_path();
+        while (true) {
+            std::filesystem::path maybe = cwd / path;
+            if (std::filesystem::exists(maybe)) return reinterpret_cast<const char*>(maybe.u8string().c_str());
+            if (!cwd.has_parent_path()) break;
+            auto newcwd = cwd.parent_path();
+            if (cwd == newcwd) break;
+            cwd = newcwd;
+        }
+        return path;
+    }
+
   private:
     int m_count;
     char** m_args;
@@ -59,20 +97,7 @@ class MainInvoker {
 
     template <typename Head, typename... Args>
     void argGenerateOne(char** array, int index, Head head, Args... args) {
-        std::filesystem::path cwd = std::filesystem::current_path();
-        while (true) {
-            std::filesystem::path maybe = cwd / head;
-            if (std::filesystem::exists(maybe)) {
-                array[index] = strdup(reinterpret_cast<const char*>(maybe.u8string().c_str()));
-                argGenerateOne(array, index + 1, args...);
-                return;
-            }
-            if (!cwd.has_parent_path()) break;
-            auto newcwd = cwd.parent_path();
-            if (cwd == newcwd) break;
-            cwd = newcwd;
-        }
-        array[index] = strdup(head);
+        array[index] = strdup(findPath(head).c_str());
         argGenerateOne(array, index + 1, args...);
     }
 };
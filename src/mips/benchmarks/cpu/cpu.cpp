@@ -0,0 +1,122 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "common/hardware/pcsxhw.h"
+#include "psyqo/application.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/scene.hh"
+
+// Integer work for the CPU emulation to chew through: table-less CRC32, which is all shifts and branches,
+// a shell sort, which is mostly loads and stores, and some divisions. Nothing gets drawn besides clearing
+// the screen, so this is all about how fast the interpreter or the dynarec go.
+
+namespace {
+
+constexpr unsigned c_frames = 300;
+constexpr unsigned c_bufferSize = 8192;
+constexpr unsigned c_sortSize = 256;
+
+class CPUBenchmark final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+};
+
+class CPUBenchmarkScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    uint32_t m_seed = 0x12345678;
+    uint32_t m_checksum = 0;
+    unsigned m_frames = 0;
+    uint8_t m_buffer[c_bufferSize];
+    int32_t m_sort[c_sortSize];
+
+    uint32_t random() {
+        m_seed = m_seed * 1103515245 + 12345;
+        return m_seed;
+    }
+};
+
+CPUBenchmark cpuBenchmark;
+CPUBenchmarkScene cpuBenchmarkScene;
+
+// So that none of the work gets optimized away.
+volatile uint32_t s_sink;
+
+uint32_t crc32(const uint8_t* data, unsigned size, uint32_t crc) {
+    crc = ~crc;
+    for (unsigned i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (unsigned b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+void shellSort(int32_t* values, unsigned size) {
+    for (unsigned gap = size / 2; gap > 0; gap /= 2) {
+        for (unsigned i = gap; i < size; i++) {
+            int32_t value = values[i];
+            unsigned j = i;
+            for (; (j >= gap) && (values[j - gap] > value); j -= gap) values[j] = values[j - gap];
+            values[j] = value;
+        }
+    }
+}
+
+}  // namespace
+
+void CPUBenchmark::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void CPUBenchmark::createScene() { pushScene(&cpuBenchmarkScene); }
+
+void CPUBenchmarkScene::start(StartReason reason) {
+    for (auto& byte : m_buffer) byte = random() >> 24;
+}
+
+void CPUBenchmarkScene::frame() {
+    m_checksum = crc32(m_buffer, c_bufferSize, m_checksum);
+
+    for (auto& value : m_sort) value = random();
+    shellSort(m_sort, c_sortSize);
+    m_checksum += m_sort[0] - m_sort[c_sortSize - 1];
+
+    for (unsigned i = 1; i < 1024; i++) m_checksum ^= (random() | 1) / i + random() % i;
+    s_sink = m_checksum;
+
+    gpu().clear();
+    if (++m_frames == c_frames) pcsx_exit(0);
+}
+
+int main() { return cpuBenchmark.run(); }
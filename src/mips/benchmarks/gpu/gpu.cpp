@@ -0,0 +1,112 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/array.h>
+#include <stdint.h>
+
+#include "common/hardware/pcsxhw.h"
+#include "psyqo/application.hh"
+#include "psyqo/fragments.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/primitives/triangles.hh"
+#include "psyqo/scene.hh"
+
+// Fills the screen over and over with large shaded triangles, a quarter of them semi transparent, so that
+// this is mostly about how fast the GPU emulation rasterizes. The triangles only move a bit from one frame
+// to the next, so the CPU hardly has anything to do besides sending them.
+
+namespace {
+
+constexpr unsigned c_frames = 300;
+// A fragment needs to fit in a single linked list node of the DMA.
+constexpr unsigned c_trianglesPerFragment = 40;
+constexpr unsigned c_fragments = 25;
+
+class GPUBenchmark final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+};
+
+class GPUBenchmarkScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    uint32_t m_seed = 0x12345678;
+    unsigned m_frames = 0;
+    eastl::array<psyqo::Fragments::FixedFragment<psyqo::Prim::GouraudTriangle, c_trianglesPerFragment>,
+                 c_fragments>
+        m_fragments;
+
+    uint32_t random() {
+        m_seed = m_seed * 1103515245 + 12345;
+        return m_seed >> 8;
+    }
+    psyqo::Vertex randomVertex() { return {{.x = int16_t(random() % 320), .y = int16_t(random() % 240)}}; }
+    psyqo::Color randomColor() {
+        uint32_t c = random();
+        return {{.r = uint8_t(c), .g = uint8_t(c >> 8), .b = uint8_t(c >> 16)}};
+    }
+};
+
+GPUBenchmark gpuBenchmark;
+GPUBenchmarkScene gpuBenchmarkScene;
+
+}  // namespace
+
+void GPUBenchmark::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void GPUBenchmark::createScene() { pushScene(&gpuBenchmarkScene); }
+
+void GPUBenchmarkScene::start(StartReason reason) {
+    unsigned index = 0;
+    for (auto& fragment : m_fragments) {
+        for (auto& triangle : fragment.primitives) {
+            triangle.setPointA(randomVertex()).setPointB(randomVertex()).setPointC(randomVertex());
+            triangle.setColorA(randomColor()).setColorB(randomColor()).setColorC(randomColor());
+            if ((index++ % 4) == 0) triangle.setSemiTrans();
+        }
+    }
+}
+
+void GPUBenchmarkScene::frame() {
+    // Moving a single corner of each triangle is enough for the rasterizer to see something different
+    for (auto& fragment : m_fragments) {
+        for (auto& triangle : fragment.primitives) triangle.pointA = randomVertex();
+    }
+
+    gpu().clear();
+    for (auto& fragment : m_fragments) gpu().sendFragment(fragment);
+    if (++m_frames == c_frames) pcsx_exit(0);
+}
+
+int main() { return gpuBenchmark.run(); }
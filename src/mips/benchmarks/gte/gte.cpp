@@ -0,0 +1,135 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/array.h>
+#include <stdint.h>
+
+#include "common/hardware/pcsxhw.h"
+#include "psyqo/application.hh"
+#include "psyqo/fixed-point.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/gte-kernels.hh"
+#include "psyqo/gte-registers.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/soft-math.hh"
+#include "psyqo/trigonometry.hh"
+
+// Pushes a few thousand triangles a frame through the GTE, the way a 3D game would before drawing them:
+// perspective projection, backface culling, and the average Z for the ordering table. None of them get
+// drawn, so that this is about the GTE emulation only.
+
+using namespace psyqo::fixed_point_literals;
+using namespace psyqo::trig_literals;
+
+namespace {
+
+constexpr unsigned c_frames = 300;
+constexpr unsigned c_triangles = 1024;
+
+class GTEBenchmark final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+
+  public:
+    psyqo::Trig<> m_trig;
+};
+
+class GTEBenchmarkScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    eastl::array<psyqo::GTE::PackedVec3, c_triangles * 3> m_vertices;
+    psyqo::Angle m_angle = 0.0_pi;
+    unsigned m_frames = 0;
+};
+
+GTEBenchmark gteBenchmark;
+GTEBenchmarkScene gteBenchmarkScene;
+
+// So that none of the work gets optimized away.
+volatile uint32_t s_sink;
+
+}  // namespace
+
+void GTEBenchmark::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void GTEBenchmark::createScene() { pushScene(&gteBenchmarkScene); }
+
+void GTEBenchmarkScene::start(StartReason reason) {
+    uint32_t seed = 0x12345678;
+    auto random = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        // Between -1.0 and 1.0
+        return psyqo::GTE::Short(int16_t(seed >> 16) >> 3, psyqo::GTE::Short::RAW);
+    };
+    for (auto& vertex : m_vertices) {
+        auto x = random();
+        auto y = random();
+        auto z = random();
+        vertex = psyqo::GTE::PackedVec3(x, y, z);
+    }
+    psyqo::GTE::clear<psyqo::GTE::Register::TRX, psyqo::GTE::Unsafe>();
+    psyqo::GTE::clear<psyqo::GTE::Register::TRY, psyqo::GTE::Unsafe>();
+    psyqo::GTE::write<psyqo::GTE::Register::TRZ, psyqo::GTE::Unsafe>(20000);
+    psyqo::GTE::write<psyqo::GTE::Register::H, psyqo::GTE::Unsafe>(300);
+    psyqo::GTE::write<psyqo::GTE::Register::OFX, psyqo::GTE::Unsafe>(psyqo::FixedPoint<16>(160.0).raw());
+    psyqo::GTE::write<psyqo::GTE::Register::OFY, psyqo::GTE::Unsafe>(psyqo::FixedPoint<16>(120.0).raw());
+    psyqo::GTE::write<psyqo::GTE::Register::ZSF3, psyqo::GTE::Unsafe>(1024 / 3);
+}
+
+void GTEBenchmarkScene::frame() {
+    m_angle += 0.01_pi;
+    if (m_angle >= 2.0_pi) m_angle -= 2.0_pi;
+    auto transform = psyqo::SoftMath::generateRotationMatrix33(m_angle, psyqo::SoftMath::Axis::X, gteBenchmark.m_trig);
+    auto rot = psyqo::SoftMath::generateRotationMatrix33(m_angle, psyqo::SoftMath::Axis::Y, gteBenchmark.m_trig);
+    psyqo::SoftMath::multiplyMatrix33(transform, rot, &transform);
+    psyqo::GTE::writeUnsafe<psyqo::GTE::PseudoRegister::Rotation>(transform);
+
+    uint32_t checksum = 0;
+    for (unsigned i = 0; i < m_vertices.size(); i += 3) {
+        psyqo::GTE::writeUnsafe<psyqo::GTE::PseudoRegister::V0>(m_vertices[i + 0]);
+        psyqo::GTE::writeUnsafe<psyqo::GTE::PseudoRegister::V1>(m_vertices[i + 1]);
+        psyqo::GTE::writeSafe<psyqo::GTE::PseudoRegister::V2>(m_vertices[i + 2]);
+        psyqo::GTE::Kernels::rtpt();
+        psyqo::GTE::Kernels::nclip();
+        checksum += psyqo::GTE::readRaw<psyqo::GTE::Register::MAC0>();
+        psyqo::GTE::Kernels::avsz3();
+        checksum ^= psyqo::GTE::readRaw<psyqo::GTE::Register::OTZ>();
+    }
+    s_sink = checksum;
+
+    gpu().clear();
+    if (++m_frames == c_frames) pcsx_exit(0);
+}
+
+int main() { return gteBenchmark.run(); }
@@ -0,0 +1,154 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/array.h>
+#include <stdint.h>
+
+#include "common/hardware/dma.h"
+#include "common/hardware/hwregs.h"
+#include "common/hardware/pcsxhw.h"
+#include "common/hardware/spu.h"
+#include "psyqo/application.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/spu.hh"
+
+// Keeps all 24 voices of the SPU playing a looping sample at different pitches, half of them going through
+// the reverb, and retriggers them every second. The CPU is idle for most of each frame, so this is about the
+// cost of the SPU mixing, ADPCM decoding, and reverb emulation.
+
+namespace {
+
+constexpr unsigned c_frames = 300;
+constexpr unsigned c_voices = 24;
+constexpr unsigned c_blocks = 256;
+constexpr uint32_t c_sampleAddress = 0x1010;
+constexpr uint32_t c_reverbAddress = 0x40000;
+
+#define SPU_REVERB_BASE HW_U16(0x1f801da2)
+
+class SPUBenchmark final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+};
+
+class SPUBenchmarkScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+    void keyOn();
+
+    uint32_t m_seed = 0x12345678;
+    unsigned m_frames = 0;
+
+    uint32_t random() {
+        m_seed = m_seed * 1103515245 + 12345;
+        return m_seed >> 8;
+    }
+};
+
+SPUBenchmark spuBenchmark;
+SPUBenchmarkScene spuBenchmarkScene;
+
+// Some noise, going through all of the filters, which loops over itself forever.
+eastl::array<uint8_t, c_blocks * 16> s_sample __attribute__((aligned(4)));
+
+void upload(uint32_t address, const uint8_t* data, uint32_t size) {
+    uint32_t bcr = size >> 6;
+    if (size & 0x3f) bcr++;
+    bcr <<= 16;
+    bcr |= 0x10;
+
+    SPU_RAM_DTA = address >> 3;
+    SPU_CTRL = (SPU_CTRL & ~0x0030) | 0x0020;
+    while ((SPU_CTRL & 0x0030) != 0x0020);
+    SBUS_DEV4_CTRL &= ~0x0f000000;
+    DMA_CTRL[DMA_SPU].MADR = reinterpret_cast<uintptr_t>(data);
+    DMA_CTRL[DMA_SPU].BCR = bcr;
+    DMA_CTRL[DMA_SPU].CHCR = 0x01000201;
+    while ((DMA_CTRL[DMA_SPU].CHCR & 0x01000000) != 0);
+}
+
+}  // namespace
+
+void SPUBenchmark::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void SPUBenchmark::createScene() { pushScene(&spuBenchmarkScene); }
+
+void SPUBenchmarkScene::start(StartReason reason) {
+    for (unsigned block = 0; block < c_blocks; block++) {
+        uint8_t* header = &s_sample[block * 16];
+        header[0] = (random() % 12) | ((block % 5) << 4);
+        header[1] = block == 0 ? 4 : block == (c_blocks - 1) ? 3 : 0;
+        for (unsigned i = 2; i < 16; i++) header[i] = random();
+    }
+
+    DPCR |= 0x000b0000;
+    psyqo::SPU::reset();
+    upload(c_sampleAddress, s_sample.data(), s_sample.size());
+
+    SPU_VOL_MAIN_LEFT = 0x3800;
+    SPU_VOL_MAIN_RIGHT = 0x3800;
+    SPU_REVERB_LEFT = 0x2000;
+    SPU_REVERB_RIGHT = 0x2000;
+    SPU_REVERB_BASE = c_reverbAddress >> 3;
+    SPU_REVERB_EN_LOW = 0x5555;
+    SPU_REVERB_EN_HIGH = 0x55;
+    // Unmuted, with the reverb writing to its work area
+    SPU_CTRL = 0xc080;
+    keyOn();
+}
+
+void SPUBenchmarkScene::keyOn() {
+    SPU_KEY_OFF_LOW = 0xffff;
+    SPU_KEY_OFF_HIGH = 0xff;
+    for (unsigned voice = 0; voice < c_voices; voice++) {
+        SPU_VOICES[voice].volumeLeft = 0x0800;
+        SPU_VOICES[voice].volumeRight = 0x0800;
+        // Up to twice the native rate, so that some voices need to decode two blocks at a time
+        SPU_VOICES[voice].sampleRate = 0x0400 + random() % 0x1c00;
+        SPU_VOICES[voice].sampleStartAddr = c_sampleAddress >> 3;
+        SPU_VOICES[voice].sampleRepeatAddr = c_sampleAddress >> 3;
+        SPU_VOICES[voice].ad = 0x00ff;
+        SPU_VOICES[voice].sr = 0x1fc0;
+    }
+    SPU_KEY_ON_LOW = 0xffff;
+    SPU_KEY_ON_HIGH = 0xff;
+}
+
+void SPUBenchmarkScene::frame() {
+    if ((m_frames % 60) == 59) keyOn();
+    gpu().clear();
+    if (++m_frames == c_frames) pcsx_exit(0);
+}
+
+int main() { return spuBenchmark.run(); }
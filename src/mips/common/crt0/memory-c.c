@@ -35,8 +35,9 @@ SOFTWARE.
 // a faster but bigger implementation that can be used instead, called
 // __wrap_memcpy. The user can override memcpy with __wrap_memcpy to use it using
 // the -Wl,--wrap=memcpy switch to the linker using LDFLAGS. The same file also
-// contains a fast implementation of memset, called __wrap_memset, that can be
-// used in the same way.
+// contains fast implementations of memset, memmove, and memcmp, called
+// __wrap_memset, __wrap_memmove, and __wrap_memcmp, that can be used in the
+// same way.
 
 void* memcpy(void* s1_, const void* s2_, size_t n);
 
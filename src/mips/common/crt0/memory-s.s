@@ -52,9 +52,10 @@ __wrap_memcpy:
     swr    $t8, 0($a0)
     addu   $a0, $t0
 
-    /* $a3 = end of source - 32 */
+    /* $a3 = end of source - 31, so the loop keeps going
+    as long as there are at least 32 bytes left */
     addu   $a3, $a1, $a2
-    addiu  $a3, -32
+    addiu  $a3, -31
 
     /* Copy the rest of the data, 32 bytes at a time */
     bltu   $a2, 32, .Lmemcpy_last32_aligned
@@ -126,6 +127,10 @@ __wrap_memcpy:
     sb     $t0, 0($a0)
     addu   $a0, $t4
 
+    /* $a3 = end of source - 31, same as above */
+    addu   $a3, $a1, $a2
+    addiu  $a3, -31
+
     bltu   $a2, 32, .Lmemcpy_last32_unaligned
     andi   $a2, 31
 
@@ -236,8 +241,10 @@ __wrap_memset:
     swr    $a1, 0($a0)
     addu   $a0, $t0
 
+    /* $a3 = end of destination - 31, so the loop keeps
+    going as long as there are at least 32 bytes left */
     addu   $a3, $a0, $a2
-    addiu  $a3, -32
+    addiu  $a3, -31
 
     bltu   $a2, 32, .Lmemset_last32
     andi   $a2, 31
@@ -280,3 +287,242 @@ __wrap_memset:
     nop
 
     .size __wrap_memset, .-__wrap_memset
+
+    .section .text___wrap_memmove, "ax", @progbits
+    .align 2
+    .global __wrap_memmove
+    .type __wrap_memmove, @function
+__wrap_memmove:
+    /* Unless the destination starts within the source, copying
+    forward is safe, as __wrap_memcpy reads each block before
+    writing it. */
+    subu   $t0, $a0, $a1
+    sltu   $t0, $t0, $a2
+    bnez   $t0, .Lmemmove_backward
+    /* Setting return value to $a0 (destination), in the bnez delay slot */
+    move   $v0, $a0
+    j      __wrap_memcpy
+    nop
+
+    /* Otherwise, copy backward, starting from the end of both buffers */
+.Lmemmove_backward:
+    addu   $a0, $a2
+    addu   $a1, $a2
+
+    /* Copy the last bytes one at a time, until the end of the destination is aligned */
+.Lmemmove_align:
+    andi   $t0, $a0, 3
+    beqz   $t0, .Lmemmove_aligned
+    nop
+    beqz   $a2, .Lmemmove_done
+    nop
+    lbu    $t0, -1($a1)
+    addiu  $a1, -1
+    addiu  $a2, -1
+    sb     $t0, -1($a0)
+    b      .Lmemmove_align
+    addiu  $a0, -1
+
+.Lmemmove_aligned:
+    andi   $t0, $a1, 3
+    bnez   $t0, .Lmemmove_unaligned
+    sltiu  $t8, $a2, 32
+
+    /* Copy 32 bytes at a time, backward */
+    bnez   $t8, .Lmemmove_last32_aligned
+    nop
+
+.Lmemmove_loop32_aligned:
+    lw     $t0, -4($a1)
+    lw     $t1, -8($a1)
+    lw     $t2, -12($a1)
+    lw     $t3, -16($a1)
+    lw     $t4, -20($a1)
+    lw     $t5, -24($a1)
+    lw     $t6, -28($a1)
+    lw     $t7, -32($a1)
+    addiu  $a1, -32
+    addiu  $a2, -32
+    sw     $t0, -4($a0)
+    sw     $t1, -8($a0)
+    sw     $t2, -12($a0)
+    sw     $t3, -16($a0)
+    sw     $t4, -20($a0)
+    sw     $t5, -24($a0)
+    sw     $t6, -28($a0)
+    sltiu  $t8, $a2, 32
+    sw     $t7, -32($a0)
+    beqz   $t8, .Lmemmove_loop32_aligned
+    addiu  $a0, -32
+
+.Lmemmove_last32_aligned:
+    sltiu  $t8, $a2, 4
+    bnez   $t8, .Lmemmove_last4
+    nop
+
+.Lmemmove_loop4_aligned:
+    lw     $t0, -4($a1)
+    addiu  $a1, -4
+    addiu  $a2, -4
+    sw     $t0, -4($a0)
+    sltiu  $t8, $a2, 4
+    beqz   $t8, .Lmemmove_loop4_aligned
+    addiu  $a0, -4
+
+    b      .Lmemmove_last4
+    nop
+
+.Lmemmove_unaligned:
+    /* The destination is aligned, but not the source, so
+    read it using lwr / lwl pairs. */
+    bnez   $t8, .Lmemmove_last32_unaligned
+    nop
+
+.Lmemmove_loop32_unaligned:
+    lwr    $t0, -4($a1)
+    lwl    $t0, -1($a1)
+    lwr    $t1, -8($a1)
+    lwl    $t1, -5($a1)
+    lwr    $t2, -12($a1)
+    lwl    $t2, -9($a1)
+    lwr    $t3, -16($a1)
+    lwl    $t3, -13($a1)
+    lwr    $t4, -20($a1)
+    lwl    $t4, -17($a1)
+    lwr    $t5, -24($a1)
+    lwl    $t5, -21($a1)
+    lwr    $t6, -28($a1)
+    lwl    $t6, -25($a1)
+    lwr    $t7, -32($a1)
+    lwl    $t7, -29($a1)
+    addiu  $a1, -32
+    addiu  $a2, -32
+    sw     $t0, -4($a0)
+    sw     $t1, -8($a0)
+    sw     $t2, -12($a0)
+    sw     $t3, -16($a0)
+    sw     $t4, -20($a0)
+    sw     $t5, -24($a0)
+    sw     $t6, -28($a0)
+    sltiu  $t8, $a2, 32
+    sw     $t7, -32($a0)
+    beqz   $t8, .Lmemmove_loop32_unaligned
+    addiu  $a0, -32
+
+.Lmemmove_last32_unaligned:
+    sltiu  $t8, $a2, 4
+    bnez   $t8, .Lmemmove_last4
+    nop
+
+.Lmemmove_loop4_unaligned:
+    lwr    $t0, -4($a1)
+    lwl    $t0, -1($a1)
+    addiu  $a1, -4
+    addiu  $a2, -4
+    sw     $t0, -4($a0)
+    sltiu  $t8, $a2, 4
+    beqz   $t8, .Lmemmove_loop4_unaligned
+    addiu  $a0, -4
+
+.Lmemmove_last4:
+    beqz   $a2, .Lmemmove_done
+    nop
+
+    /* Copy the first few bytes */
+.Lmemmove_loop1:
+    lbu    $t0, -1($a1)
+    addiu  $a1, -1
+    addiu  $a2, -1
+    sb     $t0, -1($a0)
+    bnez   $a2, .Lmemmove_loop1
+    addiu  $a0, -1
+
+.Lmemmove_done:
+    jr     $ra
+    nop
+
+    .size __wrap_memmove, .-__wrap_memmove
+
+    .section .text___wrap_memcmp, "ax", @progbits
+    .align 2
+    .global __wrap_memcmp
+    .type __wrap_memcmp, @function
+__wrap_memcmp:
+    move   $v0, $zero
+
+    /* Compare the first bytes one at a time, until the first buffer is aligned */
+.Lmemcmp_align:
+    andi   $t0, $a0, 3
+    beqz   $t0, .Lmemcmp_aligned
+    nop
+    beqz   $a2, .Lmemcmp_done
+    nop
+    lbu    $t0, 0($a0)
+    lbu    $t1, 0($a1)
+    addiu  $a0, 1
+    addiu  $a1, 1
+    bne    $t0, $t1, .Lmemcmp_diff
+    addiu  $a2, -1
+    b      .Lmemcmp_align
+    nop
+
+.Lmemcmp_aligned:
+    sltiu  $t2, $a2, 4
+    bnez   $t2, .Lmemcmp_last4
+    andi   $t3, $a1, 3
+    bnez   $t3, .Lmemcmp_loop4_unaligned
+    nop
+
+    /* Compare 4 bytes at a time. When two words differ, the
+    byte loop below finds out which of their bytes does. */
+.Lmemcmp_loop4_aligned:
+    lw     $t0, 0($a0)
+    lw     $t1, 0($a1)
+    addiu  $a2, -4
+    bne    $t0, $t1, .Lmemcmp_word_diff
+    sltiu  $t2, $a2, 4
+    addiu  $a0, 4
+    beqz   $t2, .Lmemcmp_loop4_aligned
+    addiu  $a1, 4
+
+    b      .Lmemcmp_last4
+    nop
+
+.Lmemcmp_loop4_unaligned:
+    lw     $t0, 0($a0)
+    lwr    $t1, 0($a1)
+    lwl    $t1, 3($a1)
+    addiu  $a2, -4
+    bne    $t0, $t1, .Lmemcmp_word_diff
+    sltiu  $t2, $a2, 4
+    addiu  $a0, 4
+    beqz   $t2, .Lmemcmp_loop4_unaligned
+    addiu  $a1, 4
+
+.Lmemcmp_last4:
+    beqz   $a2, .Lmemcmp_done
+    nop
+
+.Lmemcmp_loop1:
+    lbu    $t0, 0($a0)
+    lbu    $t1, 0($a1)
+    addiu  $a2, -1
+    addiu  $a0, 1
+    bne    $t0, $t1, .Lmemcmp_diff
+    addiu  $a1, 1
+    bnez   $a2, .Lmemcmp_loop1
+    nop
+
+.Lmemcmp_done:
+    jr     $ra
+    nop
+
+.Lmemcmp_diff:
+    jr     $ra
+    subu   $v0, $t0, $t1
+
+.Lmemcmp_word_diff:
+    b      .Lmemcmp_loop1
+    li     $a2, 4
+
+    .size __wrap_memcmp, .-__wrap_memcmp
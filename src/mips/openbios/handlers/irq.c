@@ -72,53 +72,41 @@ static __attribute__((section(".ramtext"))) int IRQVerifier(void) {
     return 0;
 }
 #else
+// The event to deliver for each IRQ, in the same order as the retail
+// BIOS checks them. This is kept in RAM, as reading from the ROM is slow.
+static struct {
+    uint32_t irq;
+    uint32_t event;
+} s_IRQEvents[11] = {
+    {IRQ_CDROM_NUMBER, EVENT_CDROM},
+    {IRQ_SPU_NUMBER, EVENT_SPU},
+    {IRQ_GPU_NUMBER, EVENT_GPU},
+    {IRQ_PIO_NUMBER, EVENT_PIO},
+    {IRQ_SIO_NUMBER, EVENT_SIO},
+    {IRQ_VBLANK_NUMBER, EVENT_VBLANK},
+    {IRQ_TIMER0_NUMBER, EVENT_RTC0},
+    {IRQ_TIMER1_NUMBER, EVENT_RTC1},
+    // Keeping this copy/paste mistake this way to avoid breaking stuff.
+    {IRQ_TIMER2_NUMBER, EVENT_RTC1},
+    {IRQ_CONTROLLER_NUMBER, EVENT_CONTROLLER},
+    {IRQ_DMA_NUMBER, EVENT_DMA},
+};
+
 static __attribute__((section(".ramtext"))) int IRQVerifier(void) {
     // This version of the IRQ verifier is a bit bigger, but it's
-    // guaranteed to not lose any IRQs.
-    if ((IMASK & IREG & IRQ_CDROM) != 0) {
-        deliverEvent(EVENT_CDROM, 0x1000);
-        if (s_IRQsAutoAck[IRQ_CDROM_NUMBER]) IREG &= ~IRQ_CDROM;
-    }
-    if ((IMASK & IREG & IRQ_SPU) != 0) {
-        deliverEvent(EVENT_SPU, 0x1000);
-        if (s_IRQsAutoAck[IRQ_SPU_NUMBER]) IREG &= ~IRQ_SPU;
-    }
-    if ((IMASK & IREG & IRQ_GPU) != 0) {
-        deliverEvent(EVENT_GPU, 0x1000);
-        if (s_IRQsAutoAck[IRQ_GPU_NUMBER]) IREG &= ~IRQ_GPU;
-    }
-    if ((IMASK & IREG & IRQ_PIO) != 0) {
-        deliverEvent(EVENT_PIO, 0x1000);
-        if (s_IRQsAutoAck[IRQ_PIO_NUMBER]) IREG &= ~IRQ_PIO;
-    }
-    if ((IMASK & IREG & IRQ_SIO) != 0) {
-        deliverEvent(EVENT_SIO, 0x1000);
-        if (s_IRQsAutoAck[IRQ_SIO_NUMBER]) IREG &= ~IRQ_SIO;
-    }
-    if ((IMASK & IREG & IRQ_VBLANK) != 0) {
-        deliverEvent(EVENT_VBLANK, 0x1000);
-        if (s_IRQsAutoAck[IRQ_VBLANK_NUMBER]) IREG &= ~IRQ_VBLANK;
-    }
-    if ((IMASK & IREG & IRQ_TIMER0) != 0) {
-        deliverEvent(EVENT_RTC0, 0x1000);
-        if (s_IRQsAutoAck[IRQ_TIMER0_NUMBER]) IREG &= ~IRQ_TIMER0;
-    }
-    if ((IMASK & IREG & IRQ_TIMER1) != 0) {
-        deliverEvent(EVENT_RTC1, 0x1000);
-        if (s_IRQsAutoAck[IRQ_TIMER1_NUMBER]) IREG &= ~IRQ_TIMER1;
-    }
-    if ((IMASK & IREG & IRQ_TIMER2) != 0) {
-        // Keeping this copy/paste mistake this way to avoid breaking stuff.
-        deliverEvent(EVENT_RTC1, 0x1000);
-        if (s_IRQsAutoAck[IRQ_TIMER2_NUMBER]) IREG &= ~IRQ_TIMER2;
-    }
-    if ((IMASK & IREG & IRQ_CONTROLLER) != 0) {
-        deliverEvent(EVENT_CONTROLLER, 0x1000);
-        if (s_IRQsAutoAck[IRQ_CONTROLLER_NUMBER]) IREG &= ~IRQ_CONTROLLER;
-    }
-    if ((IMASK & IREG & IRQ_DMA) != 0) {
-        deliverEvent(EVENT_DMA, 0x1000);
-        if (s_IRQsAutoAck[IRQ_DMA_NUMBER]) IREG &= ~IRQ_DMA;
+    // guaranteed to not lose any IRQs. The hardware registers are
+    // read only once, and only the pending IRQs get their events
+    // delivered, instead of checking all of them in turn. An IRQ
+    // raised in the meantime stays pending in IREG, and triggers
+    // the exception again as soon as this one is done.
+    uint32_t pending = IMASK & IREG & 0x7ff;
+    for (unsigned i = 0; pending && (i < 11); i++) {
+        uint32_t irq = s_IRQEvents[i].irq;
+        uint32_t mask = 1 << irq;
+        if ((pending & mask) == 0) continue;
+        pending &= ~mask;
+        deliverEvent(s_IRQEvents[i].event, 0x1000);
+        if (s_IRQsAutoAck[irq]) IREG &= ~mask;
     }
     return 0;
 }
@@ -39,6 +39,44 @@ struct EventInfo {
     uint32_t unknown1, unknown2;
 };
 
+// Delivering an event used to go through the whole EvCB table, which
+// happens several times per interrupt. On top of the table, which stays
+// the same since some software inspects it directly, each opened event
+// is now also linked into one of a few buckets, hashed by class. The
+// buckets are kept in slot order, so events still get delivered in the
+// same order as before. If the links can't be allocated, the delivery
+// falls back to scanning the table.
+#define EVENT_BUCKETS 16
+#define EVENT_LINK_END 0xffff
+
+static uint16_t s_eventBuckets[EVENT_BUCKETS];
+static uint16_t *s_eventLinks;
+
+// Needs to be inlined, as it's used from code running in RAM, which can't call into the ROM.
+static inline __attribute__((always_inline)) unsigned eventBucket(uint32_t class) {
+    return (class + (class >> 22)) & (EVENT_BUCKETS - 1);
+}
+
+static void linkEvent(unsigned slot) {
+    uint16_t *link = &s_eventBuckets[eventBucket(__globals.events[slot].class)];
+    while ((*link != EVENT_LINK_END) && (*link < slot)) link = &s_eventLinks[*link];
+    s_eventLinks[slot] = *link;
+    *link = slot;
+}
+
+static void unlinkEvent(unsigned slot) {
+    uint16_t *link = &s_eventBuckets[eventBucket(__globals.events[slot].class)];
+    while (*link != EVENT_LINK_END) {
+        if (*link == slot) {
+            // The removed event keeps its link, so that a delivery
+            // currently going through it can carry on to the next one.
+            *link = s_eventLinks[slot];
+            return;
+        }
+        link = &s_eventLinks[*link];
+    }
+}
+
 int initEvents(int count) {
     psxprintf("\nConfiguration : EvCB\t0x%02x\t\t", count);
     int size = count * sizeof(struct EventInfo);
@@ -48,6 +86,8 @@ int initEvents(int count) {
     __globals.events = array;
     struct EventInfo *ptr = array;
     while (ptr < (array + count)) ptr++->flags = 0;
+    s_eventLinks = syscall_kmalloc(count * sizeof(uint16_t));
+    for (unsigned i = 0; i < EVENT_BUCKETS; i++) s_eventBuckets[i] = EVENT_LINK_END;
     return size;
 }
 
@@ -71,29 +111,43 @@ uint32_t openEvent(uint32_t class, uint32_t spec, uint32_t mode, void (*handler)
     if (slot == -1) return -1;
 
     struct EventInfo *event = __globals.events + slot;
+    // The slot may have been freed by writing into the table directly.
+    if (s_eventLinks) unlinkEvent(slot);
     event->class = class;
     event->spec = spec;
     event->mode = mode;
     event->flags = EVENT_FLAG_DISABLED;
     event->handler = handler;
+    if (s_eventLinks) linkEvent(slot);
     return slot | 0xf1000000;
 }
 
+static __attribute__((section(".ramtext"))) void deliverTo(struct EventInfo *ptr, uint32_t class, uint32_t spec) {
+    if ((ptr->flags == EVENT_FLAG_ENABLED) && (class == ptr->class) && (spec == ptr->spec)) {
+        if (ptr->mode == EVENT_MODE_NO_CALLBACK) {
+            ptr->flags = EVENT_FLAG_PENDING;
+        } else if (ptr->mode == EVENT_MODE_CALLBACK && ptr->handler) {
+            ptr->handler();
+        }
+    }
+}
+
 __attribute__((section(".ramtext"))) void deliverEvent(uint32_t class, uint32_t spec) {
     struct EventInfo *ptr, *end;
 
     ptr = __globals.events;
-    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
-    while (ptr < end) {
-        if ((ptr->flags == EVENT_FLAG_ENABLED) && (class == ptr->class) && (spec == ptr->spec)) {
-            if (ptr->mode == EVENT_MODE_NO_CALLBACK) {
-                ptr->flags = EVENT_FLAG_PENDING;
-            } else if (ptr->mode == EVENT_MODE_CALLBACK && ptr->handler) {
-                ptr->handler();
-            }
+    if (s_eventLinks) {
+        unsigned slot = s_eventBuckets[eventBucket(class)];
+        while (slot != EVENT_LINK_END) {
+            // The handler may close this event, so move on before calling it.
+            struct EventInfo *event = ptr + slot;
+            slot = s_eventLinks[slot];
+            deliverTo(event, class, spec);
         }
-        ptr++;
+        return;
     }
+    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
+    while (ptr < end) deliverTo(ptr++, class, spec);
 }
 
 int enableEvent(uint32_t event) {
@@ -110,22 +164,32 @@ int disableEvent(uint32_t event) {
 
 int closeEvent(uint32_t event) {
     struct EventInfo *ptr = __globals.events + (event & 0xffff);
+    if (s_eventLinks && (ptr->flags != EVENT_FLAG_FREE)) unlinkEvent(event & 0xffff);
     ptr->flags = EVENT_FLAG_FREE;
     return 1;
 }
 
+static __attribute__((section(".ramtext"))) void undeliverTo(struct EventInfo *ptr, uint32_t class, uint32_t spec) {
+    if ((ptr->flags == EVENT_FLAG_PENDING) && (class == ptr->class) && (spec == ptr->spec) &&
+        (ptr->mode == EVENT_MODE_NO_CALLBACK)) {
+        ptr->flags = EVENT_FLAG_ENABLED;
+    }
+}
+
 __attribute__((section(".ramtext"))) void undeliverEvent(uint32_t class, uint32_t spec) {
     struct EventInfo *ptr, *end;
 
     ptr = __globals.events;
-    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
-    while (ptr < end) {
-        if ((ptr->flags == EVENT_FLAG_PENDING) && (class == ptr->class) && (spec == ptr->spec) &&
-            (ptr->mode == EVENT_MODE_NO_CALLBACK)) {
-            ptr->flags = EVENT_FLAG_ENABLED;
+    if (s_eventLinks) {
+        unsigned slot = s_eventBuckets[eventBucket(class)];
+        while (slot != EVENT_LINK_END) {
+            undeliverTo(ptr + slot, class, spec);
+            slot = s_eventLinks[slot];
         }
-        ptr++;
+        return;
     }
+    end = (struct EventInfo *)(((char *)ptr) + __globals.eventsSize);
+    while (ptr < end) undeliverTo(ptr++, class, spec);
 }
 
 int testEvent(uint32_t event) {
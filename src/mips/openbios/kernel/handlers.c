@@ -281,8 +281,12 @@ void *getC0table() {
 
 /* This is technically all done by our crt0, but since there's
    logic that relies on this being a thing, we're repeating
-   this code here too. We should have better code for these
-   however, instead of memcpy and memset. */
+   this code here too. Since this runs from the ROM, where each
+   instruction fetch is slow, this uses the unrolled versions
+   of memcpy and memset from common/crt0/memory-s.s, instead
+   of the byte loops of the libc. */
+void *__wrap_memcpy(void *dest, const void *src, size_t n);
+void *__wrap_memset(void *dest, int c, size_t n);
 extern uint32_t __data_start;
 extern uint32_t __rom_data_start;
 extern uint32_t __data_len;
@@ -292,17 +296,17 @@ void copyDataAndInitializeBSS() {
     /* This part is technically a chicken-and-egg problem.
        We can't rely on the code to already exist in RAM,
        so we have to do this in ROM, which will be slower. */
-    memcpy(&__data_start, &__rom_data_start, __data_len);
+    __wrap_memcpy(&__data_start, &__rom_data_start, __data_len);
     clearWatchdog();
     /* The original code does this step by jumping into 0x500.
        Likely the intend being that there's a faster memset at
        this location, for the specific purpose of handling
-       a memset using the i-cache. We can tune this later. */
-    memset(&__bss_start, 0, __bss_len);
+       a memset using the i-cache. */
+    __wrap_memset(&__bss_start, 0, __bss_len);
 }
 
 /* This also could be handled by the crt0, by putting the
    A0 table into the proper data section, but in the
    spirit of doing exactly what the original code does,
    we're going to do it manually instead. */
-void copyA0table() { memcpy(&__ramA0table, romA0table, sizeof(romA0table)); }
+void copyA0table() { __wrap_memcpy(&__ramA0table, romA0table, sizeof(romA0table)); }
@@ -39,6 +39,10 @@ extern const uint8_t _binary_shell_bin_end[];
 extern const uint32_t _binary_psexe_bin_start[];
 extern const uint32_t _binary_psexe_bin_end[];
 
+// The unrolled memcpy from common/crt0/memory-s.s, as this runs from the ROM,
+// where the libc's byte loop is especially slow.
+void *__wrap_memcpy(void *dest, const void *src, size_t n);
+
 static void copyExecutableData(uintptr_t dest, uintptr_t source, size_t length) {
     // On platforms with a watchdog (currently only the 573), larger binaries
     // must be copied in smaller chunks in order to make sure the watchdog is
@@ -48,7 +52,7 @@ static void copyExecutableData(uintptr_t dest, uintptr_t source, size_t length)
     // proceeds to chainload the actual shell into memory.
     while (length > 0) {
         size_t chunkLength = (length > 0x8000) ? 0x8000 : length;
-        memcpy((void *)dest, (const void *)source, chunkLength);
+        __wrap_memcpy((void *)dest, (const void *)source, chunkLength);
         clearWatchdog();
         dest += chunkLength;
         source += chunkLength;
@@ -191,6 +191,19 @@ class CDRomDevice final : public CDRom {
         PlaybackLocation *m_location;
     };
 
+    struct StreamAwaiter {
+        StreamAwaiter(CDRomDevice &device) : m_device(device) {}
+        bool await_ready() const { return m_device.isStreamReady(); }
+        template <typename U>
+        void await_suspend(std::coroutine_handle<U> handle) {
+            m_device.setStreamWaiter(handle);
+        }
+        const uint8_t *await_resume() { return m_device.peekStream(); }
+
+      private:
+        CDRomDevice &m_device;
+    };
+
   private:
     struct ActionBase {
         const char *name() const { return m_name; }
@@ -263,6 +276,60 @@ class CDRomDevice final : public CDRom {
     void readSectors(uint32_t sector, uint32_t count, void *buffer, eastl::function<void(bool)> &&callback) override;
     bool readSectorsBlocking(uint32_t sector, uint32_t count, void *buffer, GPU &);
 
+    /**
+     * @brief Starts streaming sectors from the CDRom into a ring buffer.
+     *
+     * @details This method will start reading `count` consecutive sectors
+     * from the CDRom, continuously, into the provided ring buffer of
+     * `ringSectors` sectors of 2048 bytes. The consumer gets the sectors
+     * in order, using `peekStream` and `releaseStream`, or by awaiting
+     * `nextStreamSector` from a coroutine. When the ring is full, the drive
+     * gets paused, which keeps it spinning, and reading resumes at the next
+     * sector once the consumer has released half of the ring. This avoids
+     * the cost of going through a full seek for each chunk of a large file,
+     * such as level data or video. The callback is called once all of the
+     * sectors have been read into the ring, which may be before the consumer
+     * is done with them, once the stream is stopped, or upon error. Like
+     * `readSectors`, no other action can be performed while streaming.
+     *
+     * @param sector The sector to start reading from.
+     * @param count The number of sectors to read.
+     * @param ring The ring buffer, which needs to be 4 bytes aligned.
+     * @param ringSectors The size of the ring buffer, in sectors. At least 2.
+     * @param callback The callback to call when the stream is done.
+     */
+    void startStream(uint32_t sector, uint32_t count, void *ring, unsigned ringSectors,
+                     eastl::function<void(bool)> &&callback);
+
+    /**
+     * @brief Returns the oldest sector of the stream not released yet, or
+     * nullptr if none is available at the moment.
+     */
+    const uint8_t *peekStream();
+
+    /**
+     * @brief Releases the oldest sectors of the stream, so that their space
+     * in the ring can be reused.
+     */
+    void releaseStream(unsigned sectors = 1);
+
+    /**
+     * @brief Stops the stream before all of its sectors have been read.
+     *
+     * @details The callback given to `startStream` will be called once the
+     * drive is paused. The sectors already in the ring can still be consumed.
+     */
+    void stopStream();
+
+    /**
+     * @brief Awaits the next sector of the stream.
+     *
+     * @details The awaiter returns the same as `peekStream`, once a sector is
+     * available, which is nullptr only when the stream is over. The sector
+     * still needs to be released using `releaseStream`.
+     */
+    StreamAwaiter nextStreamSector() { return {*this}; }
+
     /**
      * @brief Gets the size of the Table of Contents from the CDRom. Note that
      * while the blocking variant is available because it is a fairly short
@@ -442,6 +509,8 @@ class CDRomDevice final : public CDRom {
     [[nodiscard]] bool isIdle() const { return m_state == 0; }
 
   private:
+    bool isStreamReady();
+    void setStreamWaiter(std::coroutine_handle<> handle);
     void switchAction(ActionBase *action);
     void irq();
     void actionComplete();
@@ -0,0 +1,96 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <EASTL/utility.h>
+#include <stdint.h>
+
+#include "psyqo/coroutine.hh"
+
+namespace psyqo {
+
+class CDRomDevice;
+
+/**
+ * @brief Loads block compressed data from the CDRom, decompressing it while
+ * it is still being read.
+ *
+ * @details The data needs to be prepared using the `-stream` mode of
+ * `ps1-packer`, which cuts it into blocks, 32kB by default, each compressed
+ * independently using NRV2E. The loader streams the sectors of the file
+ * using `CDRomDevice::startStream`, copies them at the end of the destination
+ * buffer, and decompresses each block in place as soon as all of its bytes are
+ * in, while the drive keeps on reading the next ones in the background. This
+ * way, most of the decompression time is hidden behind the transfer, instead
+ * of having to wait for the whole file before decompressing it.
+ *
+ * The destination buffer needs to be at least the size printed by
+ * `ps1-packer`, which is the decompressed size, plus a small margin for the
+ * in place decompression to be safe.
+ *
+ * The decompressor isn't part of psyqo, due to its license. The application
+ * needs to provide one, such as the `n2e_decompress` function from the
+ * `n2e-d.S` file of the `ucl-demo` example.
+ */
+class CompressedStreamLoader {
+  public:
+    static constexpr uint32_t c_magic = 0x4e325301;
+    static constexpr uint32_t c_headerSize = 24;
+
+    /**
+     * @brief A function decompressing a whole NRV2E block from src to dst.
+     */
+    typedef void (*Decompressor)(const void *src, void *dst);
+
+    explicit CompressedStreamLoader(Decompressor decompressor) : m_decompressor(decompressor) {}
+
+    /**
+     * @brief Loads and decompresses a stream from the CDRom.
+     *
+     * @details This is a coroutine, which needs to be awaited from another
+     * coroutine. Once done, the CDRom device is idle again.
+     *
+     * @param device The CDRom device to read from.
+     * @param sector The first sector of the file.
+     * @param sectors The number of sectors of the file.
+     * @param buffer The destination buffer, 4 bytes aligned.
+     * @param bufferSize The size of the destination buffer.
+     * @param ring The ring buffer to stream sectors into, 4 bytes aligned.
+     * @param ringSectors The size of the ring buffer, in sectors. Its size
+     * should cover the time taken to decompress a block, so the drive can
+     * keep on reading meanwhile.
+     * @return The decompressed size, or 0 upon error.
+     */
+    Coroutine<uint32_t> load(CDRomDevice &device, uint32_t sector, uint32_t sectors, void *buffer,
+                             uint32_t bufferSize, void *ring, unsigned ringSectors);
+
+  private:
+    Decompressor m_decompressor;
+};
+
+}  // namespace psyqo
@@ -0,0 +1,197 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/hardware/counters.h"
+#include "common/syscalls/syscalls.h"
+#include "psyqo/application.hh"
+#include "psyqo/fixed-point.hh"
+#include "psyqo/font.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/gte-math.hh"
+#include "psyqo/kernel.hh"
+#include "psyqo/matrix.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/soft-math.hh"
+#include "psyqo/trigonometry.hh"
+
+// This example measures how many CPU cycles the various math functions of the
+// library take per call. Each function gets called on a batch of inputs, with
+// interrupts disabled, while the root counter 2 counts the system clock. The
+// results are displayed on screen, and printed on the console once.
+
+using namespace psyqo::fixed_point_literals;
+using namespace psyqo::trig_literals;
+
+namespace {
+
+static constexpr unsigned c_calls = 256;
+// The root counter is only 16 bits wide, so each chunk of calls needs to be
+// measured separately, in order not to overflow it.
+static constexpr unsigned c_chunk = 16;
+
+class MathBench final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+
+  public:
+    psyqo::Trig<> m_trig;
+    psyqo::Font<> m_font;
+};
+
+struct Result {
+    const char* name;
+    uint32_t cycles;
+};
+
+class MathBenchScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    template <typename Func>
+    uint32_t measure(Func&& func);
+    void runAll();
+
+    psyqo::Angle m_angles[c_calls];
+    psyqo::FixedPoint<16> m_fineAngles[c_calls];
+    psyqo::FixedPoint<> m_values[c_calls];
+    psyqo::FixedPoint<> m_results[c_calls];
+    psyqo::Matrix33 m_matrices[c_chunk];
+    Result m_benchmarks[10];
+    unsigned m_count = 0;
+    bool m_done = false;
+};
+
+MathBench mathBench;
+MathBenchScene mathBenchScene;
+
+}  // namespace
+
+void MathBench::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void MathBench::createScene() {
+    m_font.uploadSystemFont(gpu());
+    pushScene(&mathBenchScene);
+}
+
+void MathBenchScene::start(StartReason reason) {
+    // A spread of inputs, so that every quadrant and magnitude gets exercised.
+    for (unsigned i = 0; i < c_calls; i++) {
+        m_angles[i].value = i * 37;
+        m_fineAngles[i].value = i * 2371;
+        m_values[i].value = 1 + i * i * 97;
+    }
+}
+
+template <typename Func>
+uint32_t MathBenchScene::measure(Func&& func) {
+    uint32_t cycles = 0;
+    psyqo::Kernel::fastEnterCriticalSection();
+    COUNTERS[2].mode = 0;
+    for (unsigned first = 0; first < c_calls; first += c_chunk) {
+        uint16_t start = COUNTERS[2].value;
+        func(first, c_chunk);
+        uint16_t end = COUNTERS[2].value;
+        cycles += uint16_t(end - start);
+    }
+    psyqo::Kernel::fastLeaveCriticalSection();
+    return cycles / c_calls;
+}
+
+void MathBenchScene::runAll() {
+    auto& trig = mathBench.m_trig;
+    auto add = [this](const char* name, uint32_t cycles) {
+        m_benchmarks[m_count++] = {name, cycles};
+        ramsyscall_printf("%s: %u cycles\n", name, cycles);
+    };
+
+    add("cos", measure([this, &trig](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) m_results[i] = trig.cos(m_angles[i]);
+        }));
+    add("sin + cos", measure([this, &trig](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) {
+                m_results[i] = trig.sin(m_angles[i]) + trig.cos(m_angles[i]);
+            }
+        }));
+    add("sincos", measure([this, &trig](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) {
+                auto [s, c] = trig.sincos(m_angles[i]);
+                m_results[i] = s + c;
+            }
+        }));
+    add("interpolated cos", measure([this, &trig](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) m_results[i] = trig.cos(m_fineAngles[i]);
+        }));
+    add("rotation matrix", measure([this, &trig](unsigned first, unsigned count) {
+            for (unsigned i = 0; i < count; i++) {
+                psyqo::SoftMath::generateRotationMatrix33(&m_matrices[i], m_angles[first + i],
+                                                          psyqo::SoftMath::Axis::Y, trig);
+            }
+        }));
+    add("rotation matrices", measure([this, &trig](unsigned first, unsigned count) {
+            psyqo::SoftMath::generateRotationMatrices33(m_matrices, m_angles + first, count,
+                                                        psyqo::SoftMath::Axis::Y, trig);
+        }));
+    add("1.0 / x", measure([this](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) m_results[i] = 1.0_fp / m_values[i];
+        }));
+    add("SoftMath::reciprocal", measure([this](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) {
+                m_results[i] = psyqo::SoftMath::reciprocal(m_values[i]);
+            }
+        }));
+    psyqo::GTE::prepareReciprocal();
+    add("GTE::reciprocal", measure([this](unsigned first, unsigned count) {
+            for (unsigned i = first; i < first + count; i++) m_results[i] = psyqo::GTE::reciprocal(m_values[i]);
+        }));
+    add("GTE::reciprocal batch", measure([this](unsigned first, unsigned count) {
+            psyqo::GTE::reciprocal(m_values + first, m_results + first, count);
+        }));
+}
+
+void MathBenchScene::frame() {
+    if (!m_done) {
+        runAll();
+        m_done = true;
+    }
+
+    gpu().clear({{.r = 0x68, .g = 0xb0, .b = 0xd8}});
+    auto& font = mathBench.m_font;
+    font.print(gpu(), "Cycles per call", {{.x = 4, .y = 4}}, {{.r = 0xff, .g = 0xff, .b = 0xff}});
+    for (unsigned i = 0; i < m_count; i++) {
+        int16_t y = 24 + i * 16;
+        font.printf(gpu(), {{.x = 4, .y = y}}, {{.r = 0xff, .g = 0xff, .b = 0xff}}, "%s: %u", m_benchmarks[i].name,
+                    m_benchmarks[i].cycles);
+    }
+}
+
+int main() { return mathBench.run(); }
@@ -0,0 +1,182 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "psyqo/application.hh"
+#include "psyqo/fixed-point.hh"
+#include "psyqo/font.hh"
+#include "psyqo/frame-arena.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/gte-registers.hh"
+#include "psyqo/ordering-table.hh"
+#include "psyqo/primitives/quads.hh"
+#include "psyqo/scene.hh"
+#include "psyqo/scratchpad.hh"
+#include "psyqo/soft-math.hh"
+#include "psyqo/trigonometry.hh"
+#include "psyqo/vertex-pipeline.hh"
+
+// This example measures how much faster the GTE vertex pipeline runs when its
+// staging buffers live in the scratchpad, compared to main RAM. Each frame, a
+// torus mesh is transformed a few times over with both pipelines, and the time
+// each took gets displayed. The mesh is then drawn using the scratchpad one.
+
+using namespace psyqo::fixed_point_literals;
+using namespace psyqo::trig_literals;
+
+namespace {
+
+static constexpr unsigned c_rings = 12;
+static constexpr unsigned c_segments = 12;
+static constexpr unsigned c_vertices = c_rings * c_segments;
+static constexpr unsigned c_passes = 16;
+static constexpr unsigned c_orderingTableSize = 1024;
+
+using Pipeline = psyqo::GTE::VertexPipeline<c_vertices>;
+
+// The hot data of the frame: the pipeline's staging buffers, and the rotation
+// matrix. The layout will fail to compile if these ever grow beyond 1kB.
+using Hot = psyqo::ScratchpadLayout<Pipeline, psyqo::Matrix33>;
+
+class ScratchpadBench final : public psyqo::Application {
+    void prepare() override;
+    void createScene() override;
+
+  public:
+    psyqo::Trig<> m_trig;
+    psyqo::Font<> m_font;
+};
+
+class ScratchpadScene final : public psyqo::Scene {
+    void start(StartReason reason) override;
+    void frame() override;
+
+    template <typename Transform>
+    uint32_t measure(Transform&& transform);
+
+    psyqo::Angle m_rot = 0;
+    psyqo::Vec3 m_vertices[c_vertices];
+    Pipeline::Quad m_faces[c_vertices];
+    psyqo::OrderingTable<c_orderingTableSize> m_ots[2];
+    psyqo::Fragments::SimpleFragment<psyqo::Prim::FastFill> m_clear[2];
+    psyqo::FrameArena<c_vertices * sizeof(psyqo::Fragments::SimpleFragment<psyqo::Prim::Quad>)> m_arena{gpu()};
+    uint32_t m_ramTime = 0;
+    uint32_t m_scratchpadTime = 0;
+
+    static constexpr psyqo::Color c_bg = {.r = 0, .g = 32, .b = 64};
+};
+
+ScratchpadBench scratchpadBench;
+ScratchpadScene scratchpadScene;
+
+// The same pipeline, but in main RAM.
+Pipeline s_ramPipeline;
+
+}  // namespace
+
+void ScratchpadBench::prepare() {
+    psyqo::GPU::Configuration config;
+    config.set(psyqo::GPU::Resolution::W320)
+        .set(psyqo::GPU::VideoMode::AUTO)
+        .set(psyqo::GPU::ColorMode::C15BITS)
+        .set(psyqo::GPU::Interlace::PROGRESSIVE);
+    gpu().initialize(config);
+}
+
+void ScratchpadBench::createScene() {
+    m_font.uploadSystemFont(gpu());
+    pushScene(&scratchpadScene);
+}
+
+void ScratchpadScene::start(StartReason reason) {
+    psyqo::GTE::clear<psyqo::GTE::Register::TRX, psyqo::GTE::Unsafe>();
+    psyqo::GTE::clear<psyqo::GTE::Register::TRY, psyqo::GTE::Unsafe>();
+    psyqo::GTE::write<psyqo::GTE::Register::TRZ, psyqo::GTE::Unsafe>(640);
+    psyqo::GTE::write<psyqo::GTE::Register::OFX, psyqo::GTE::Unsafe>(psyqo::FixedPoint<16>(160.0).raw());
+    psyqo::GTE::write<psyqo::GTE::Register::OFY, psyqo::GTE::Unsafe>(psyqo::FixedPoint<16>(120.0).raw());
+    psyqo::GTE::write<psyqo::GTE::Register::H, psyqo::GTE::Unsafe>(180);
+    psyqo::GTE::write<psyqo::GTE::Register::ZSF4, psyqo::GTE::Unsafe>(c_orderingTableSize / 4);
+
+    // A torus, with its quads going around the rings and the segments.
+    auto& trig = scratchpadBench.m_trig;
+    for (unsigned r = 0; r < c_rings; r++) {
+        psyqo::Angle u = psyqo::Angle(2.0_pi) * int32_t(r) / int32_t(c_rings);
+        for (unsigned s = 0; s < c_segments; s++) {
+            psyqo::Angle v = psyqo::Angle(2.0_pi) * int32_t(s) / int32_t(c_segments);
+            psyqo::FixedPoint<> radius = 0.1_fp + trig.cos(v) * 0.04_fp;
+            m_vertices[r * c_segments + s] = {
+                .x = trig.cos(u) * radius, .y = trig.sin(v) * 0.04_fp, .z = trig.sin(u) * radius};
+            unsigned nextR = (r + 1) % c_rings;
+            unsigned nextS = (s + 1) % c_segments;
+            m_faces[r * c_segments + s] = {
+                .a = uint16_t(r * c_segments + s),
+                .b = uint16_t(r * c_segments + nextS),
+                .c = uint16_t(nextR * c_segments + s),
+                .d = uint16_t(nextR * c_segments + nextS),
+            };
+        }
+    }
+}
+
+template <typename Transform>
+uint32_t ScratchpadScene::measure(Transform&& transform) {
+    // The `now()` function only moves when `pumpCallbacks()` is called.
+    gpu().pumpCallbacks();
+    uint32_t start = gpu().now();
+    for (unsigned i = 0; i < c_passes; i++) transform();
+    gpu().pumpCallbacks();
+    return gpu().now() - start;
+}
+
+void ScratchpadScene::frame() {
+    auto parity = gpu().getParity();
+    auto& ot = m_ots[parity];
+    auto& clear = m_clear[parity];
+    gpu().getNextClear(clear.primitive, c_bg);
+    gpu().chain(clear);
+
+    auto& rotation = Hot::get<1>();
+    rotation = psyqo::SoftMath::generateRotationMatrix33(m_rot, psyqo::SoftMath::Axis::X, scratchpadBench.m_trig);
+    auto rotY = psyqo::SoftMath::generateRotationMatrix33(m_rot, psyqo::SoftMath::Axis::Y, scratchpadBench.m_trig);
+    psyqo::SoftMath::multiplyMatrix33(rotation, rotY, &rotation);
+    psyqo::GTE::writeUnsafe<psyqo::GTE::PseudoRegister::Rotation>(rotation);
+
+    auto& pipeline = Hot::get<0>();
+    m_ramTime = measure([this]() { s_ramPipeline.transform(m_vertices, c_vertices); });
+    m_scratchpadTime = measure([this, &pipeline]() { pipeline.transform(m_vertices, c_vertices); });
+
+    pipeline.emit<psyqo::Prim::Quad>(m_faces, c_vertices, ot, m_arena, [](psyqo::Prim::Quad& quad, size_t index) {
+        uint8_t shade = 96 + (index % c_segments) * 12;
+        quad.setColor({.r = shade, .g = uint8_t(shade / 2), .b = uint8_t(255 - shade)});
+        quad.setOpaque();
+    });
+    gpu().chain(ot);
+
+    scratchpadBench.m_font.chainprintf(gpu(), {{.x = 2, .y = 2}}, {{.r = 0xff, .g = 0xff, .b = 0xff}},
+                                       "RAM: %uus Scratchpad: %uus", m_ramTime, m_scratchpadTime);
+    m_rot += 0.005_pi;
+}
+
+int main() { return scratchpadBench.run(); }
@@ -0,0 +1,111 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/utility.h>
+#include <stdint.h>
+
+#include "psyqo/bump-allocator.hh"
+#include "psyqo/fragments.hh"
+#include "psyqo/gpu.hh"
+#include "psyqo/primitive-concept.hh"
+#include "psyqo/shared.hh"
+
+namespace psyqo {
+
+/**
+ * @brief A double buffered bump allocator for the fragments of a frame.
+ *
+ * @details This holds two `BumpAllocator` objects, one per GPU parity, and
+ * hands out the one matching the frame currently being built. The fragments
+ * allocated from it can be chained directly, using `GPU::chain`, or inserted
+ * into an ordering table, without any further bookkeeping.
+ *
+ * Each arena remembers the generation of the DMA chain its fragments went into,
+ * and is reset the first time it gets used after that chain has been fully
+ * transferred to the GPU. In the usual case of chaining fragments during the
+ * `frame` method and letting the frame flip send them, the chain is always done
+ * by the time its arena comes back, so this never waits. If a chain is sent
+ * manually in the middle of a frame using the non-blocking `sendChain`, the next
+ * allocation will wait for it to be done before recycling the memory.
+ *
+ * Note that fragments allocated from the arena are never destroyed, so they
+ * shouldn't hold anything requiring a destructor.
+ *
+ * @tparam N The size of each of the two memory buffers, in bytes.
+ */
+template <size_t N, Safe safety = Safe::Yes>
+class FrameArena {
+  public:
+    explicit FrameArena(GPU &gpu) : m_gpu(gpu) {}
+
+    /**
+     * @brief Allocates a fragment holding a single primitive for the current frame.
+     */
+    template <Primitive P, typename... Args>
+    Fragments::SimpleFragment<P> &allocateFragment(Args &&...args) {
+        return current().template allocateFragment<P>(eastl::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Allocates an arbitrary object, typically a fragment, for the current frame.
+     */
+    template <typename T, typename... Args>
+    T &allocate(Args &&...args) {
+        return current().template allocate<T>(eastl::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Returns the allocator for the current frame.
+     *
+     * @details If the allocator still holds fragments from a chain which has
+     * been sent since, this waits for the transfer to complete, and resets it.
+     */
+    BumpAllocator<N, safety> &current() {
+        auto &arena = m_arenas[m_gpu.getParity()];
+        uint32_t generation = m_gpu.getChainGeneration();
+        if (arena.generation != generation) {
+            while (!m_gpu.isChainGenerationTransferred(arena.generation)) m_gpu.pumpCallbacks();
+            arena.allocator.reset();
+            arena.generation = generation;
+        }
+        return arena.allocator;
+    }
+
+    size_t remaining() { return current().remaining(); }
+    size_t used() { return current().used(); }
+
+  private:
+    struct Arena {
+        BumpAllocator<N, safety> allocator;
+        uint32_t generation = 0;
+    };
+    GPU &m_gpu;
+    Arena m_arenas[2];
+};
+
+}  // namespace psyqo
@@ -220,6 +220,31 @@ class GPU {
     void uploadToVRAM(const uint16_t *data, Rect region, eastl::function<void()> &&callback,
                       DMA::DmaCallback dmaCallback = DMA::FROM_MAIN_LOOP);
 
+    /**
+     * @brief Queues a buffer to be uploaded to the VRAM in the background.
+     *
+     * @details Unlike `uploadToVRAM`, this doesn't start a transfer. The
+     * uploads queued during a frame are sent by the DMA interrupt handler
+     * right after the DMA chain of that frame, during the frame flip
+     * operation, one after the other, without the main loop ever waiting
+     * for them. Uploads which land right below the previous one queued, with
+     * the same horizontal position and width, and whose pixels follow the
+     * previous ones in memory, are merged into a single transfer. Large
+     * uploads are split so that the bulk of them uses the largest DMA block
+     * size. The GPU cache is flushed once all of the uploads are done.
+     *
+     * The pixels are read directly from `data`, so the buffer needs to stay
+     * untouched until the transfers are done, which is the case once the
+     * frame after next starts. This is the same constraint as for the
+     * fragments of a DMA chain, and the buffers can be double buffered the
+     * same way, using `getParity`.
+     * @param data The pixels to upload. Must be a contiguous array of
+     * 16-bpp pixels, with the number of pixels being equal to the area
+     * specified by the `region` parameter.
+     * @param region The region in VRAM to upload the pixels to.
+     */
+    void queueUploadToVRAM(const uint16_t *data, Rect region);
+
     /**
      * @brief Immediately sends a fragment to the GPU. This is a blocking operation.
      * See the fragments.hh file for more information.
@@ -395,6 +420,28 @@ class GPU {
      */
     bool isChainTransferred() const;
 
+    /**
+     * @brief Returns the generation of the DMA chain currently being built.
+     *
+     * @details Every DMA chain sent to the GPU, whether through `sendChain`
+     * or during the frame flip operation, gets a generation number, which
+     * increases by one for each chain. This returns the number the chain
+     * currently being built will get once it is sent. Together with
+     * `isChainGenerationTransferred`, this allows knowing when the memory
+     * holding the primitives of a chain can be reused.
+     */
+    uint32_t getChainGeneration() const { return m_chainsSent + 1; }
+
+    /**
+     * @brief Returns true if the DMA chain of the given generation has been
+     * fully transferred to the GPU.
+     *
+     * @details The generation is one returned by `getChainGeneration`. Once
+     * this returns true, the GPU DMA will no longer read from any fragment
+     * which was part of that chain, or of any chain before it.
+     */
+    bool isChainGenerationTransferred(uint32_t generation) const;
+
     /**
      * @brief Waits until the background DMA transfer operation initiated by a frame flip is complete.
      *
@@ -535,6 +582,8 @@ class GPU {
                       DMA::DmaCallback dmaCallback);
     void scheduleNormalDMA(uintptr_t data, size_t count);
     void scheduleChainedDMA(uintptr_t head);
+    void scheduleUploadDMA(const uint16_t *data, Rect region);
+    bool scheduleNextQueuedUpload();
     void chain(uint32_t *first, uint32_t *last, size_t count);
     void scheduleOTC(uint32_t *start, uint32_t count);
     void checkOTCAndTriggerCallback();
@@ -552,6 +601,8 @@ class GPU {
     uint32_t *m_chainTail = nullptr;
     size_t m_chainTailCount = 0;
     enum { CHAIN_IDLE, CHAIN_TRANSFERRING, CHAIN_TRANSFERRED } m_chainStatus = CHAIN_IDLE;
+    uint32_t m_chainsSent = 0;
+    uint32_t m_chainsTransferred = 0;
     struct Timer {
         eastl::function<void(uint32_t)> callback;
         uint32_t deadline;
@@ -567,10 +618,17 @@ class GPU {
     };
     eastl::fixed_list<ScheduledOTC, 32> m_OTCs[2];
     uint32_t *m_chainNext = nullptr;
+    struct QueuedUpload {
+        const uint16_t *data;
+        Rect region;
+    };
+    eastl::fixed_list<QueuedUpload, 32> m_uploads[2];
 
     uint16_t m_lastHSyncCounter = 0;
     bool m_interlaced = false;
     bool m_fromISR = false;
+    bool m_chainInFlight = false;
+    bool m_drainUploads = false;
     bool m_flushCacheAfterDMA = false;
 
     void flip();
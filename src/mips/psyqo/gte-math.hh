@@ -0,0 +1,105 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "psyqo/gte-kernels.hh"
+#include "psyqo/gte-registers.hh"
+
+namespace psyqo {
+
+namespace GTE {
+
+/**
+ * @brief Prepares the GTE for `reciprocal`.
+ *
+ * @details The reciprocal is computed by running a perspective
+ * transformation of a null vector, using the GTE's divider to
+ * compute H / SZ3. This needs the vector 0, the translation vector,
+ * the projection plane distance, and the depth queuing parameters
+ * to be set up a specific way, which this function does. These
+ * registers need to be restored afterwards if they are used for
+ * something else, such as actual perspective transformations. The
+ * screen XY and Z FIFOs will also be clobbered by each reciprocal.
+ */
+static inline void prepareReciprocal() {
+    clear<Register::VXY0, Unsafe>();
+    clear<Register::VZ0, Unsafe>();
+    clear<Register::TRX, Unsafe>();
+    clear<Register::TRY, Unsafe>();
+    write<Register::H, Unsafe>(0x8000);
+    write<Register::DQA, Unsafe>(1);
+    clear<Register::DQB, Safe>();
+}
+
+/**
+ * @brief Computes the reciprocal of a fixed point number using the GTE.
+ *
+ * @details The GTE has a fast unsigned Newton-Raphson divider, used
+ * for the perspective division. This function normalizes the value
+ * to 16 bits using the leading zeroes counter, has the divider
+ * compute 0x8000 / value, and denormalizes the result. This is much
+ * faster than the generic `FixedPoint` division, but the result is
+ * only precise to about one part in 4096. The GTE must have been set up
+ * with `prepareReciprocal` beforehand, and the value must not be 0.
+ *
+ * @param x The number to compute the reciprocal of.
+ * @return Long The reciprocal of the number.
+ */
+static inline Long reciprocal(Long x) {
+    int32_t value = x.value;
+    uint32_t v = value < 0 ? -value : value;
+    write<Register::LZCS, Safe>(v);
+    unsigned lz = readRaw<Register::LZCR, Safe>();
+    // Puts the most significant bit of the value at bit 15.
+    uint32_t d = lz >= 16 ? v << (lz - 16) : v >> (16 - lz);
+    write<Register::TRZ, Safe>(d);
+    Kernels::rtps();
+    // The GTE's result is 2^31 / d, and 1 / x is 2^24 / v.
+    uint32_t q = readRaw<Register::MAC0, Safe>();
+    int32_t r = lz >= 23 ? q << (lz - 23) : q >> (23 - lz);
+    return Long(value < 0 ? -r : r, Long::RAW);
+}
+
+/**
+ * @brief Computes the reciprocals of an array of fixed point numbers
+ * using the GTE.
+ *
+ * @details This calls `prepareReciprocal` once, and then computes
+ * the reciprocal of each value, with the same restrictions as
+ * `reciprocal`.
+ *
+ * @param in The array of numbers to compute the reciprocals of.
+ * @param out The array to store the reciprocals in. May be the same as in.
+ * @param count The number of values in the arrays.
+ */
+void reciprocal(const Long* in, Long* out, unsigned count);
+
+}  // namespace GTE
+
+}  // namespace psyqo
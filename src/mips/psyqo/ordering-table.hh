@@ -30,6 +30,8 @@ SOFTWARE.
 #include <stdint.h>
 
 #include "psyqo/fragment-concept.hh"
+#include "psyqo/gte-kernels.hh"
+#include "psyqo/gte-registers.hh"
 #include "psyqo/shared.hh"
 
 namespace psyqo {
@@ -41,6 +43,31 @@ class OrderingTableBase {
     static void clear(uint32_t* table, size_t size);
 };
 
+/**
+ * @brief The default depth mapping of an ordering table, using one bucket per Z value.
+ */
+struct LinearDepth {
+    int32_t operator()(int32_t z) const { return z; }
+};
+
+/**
+ * @brief A depth mapping with a different resolution for the near and far ranges.
+ *
+ * @details Z values below `nearLimit` get one bucket each, while the ones beyond
+ * share buckets, `1 << farShift` Z values at a time. This allows for precise
+ * sorting of the primitives close to the camera, where errors are the most
+ * visible, while still covering a large depth range with a small table. With
+ * an `OrderingTable<N>`, the largest Z value which still gets its own bucket is
+ * `nearLimit + ((N - 1 - nearLimit) << farShift)`.
+ *
+ * @tparam nearLimit The first Z value of the far range.
+ * @tparam farShift The log2 of how many Z values share a bucket in the far range.
+ */
+template <int32_t nearLimit, unsigned farShift>
+struct SplitDepth {
+    int32_t operator()(int32_t z) const { return z < nearLimit ? z : nearLimit + ((z - nearLimit) >> farShift); }
+};
+
 /**
  * @brief The ordering table. Used to sort fragments before sending them to the GPU.
  *
@@ -93,6 +120,65 @@ class OrderingTable : private OrderingTableBase {
         table[z] = reinterpret_cast<uint32_t>(head) & 0xffffff;
     }
 
+    /**
+     * @brief Inserts an array of fragments into the ordering table.
+     *
+     * @details This is the same as calling `insert` for each fragment, with the
+     * Z value at the same index in `zs`, but with the loop kept tight enough for
+     * the table pointer to stay in a register. The Z values are typically the
+     * `OTZ` results of the GTE, read after an `avsz3` or `avsz4` operation, which
+     * can be stored as `uint16_t`. They go through the `mapping` first, which
+     * can be used to have a different resolution for the near and far ranges,
+     * using `SplitDepth`.
+     *
+     * @param frags The fragments to insert.
+     * @param zs The Z values of the fragments.
+     * @param count The number of fragments to insert.
+     * @param mapping The mapping from Z values to buckets.
+     */
+    template <Fragment Frag, typename Z, typename Mapping = LinearDepth>
+    void insert(Frag* frags, const Z* zs, size_t count, Mapping mapping = {}) {
+        uint32_t* table = m_table + 1;
+        for (Frag* end = frags + count; frags < end; frags++, zs++) {
+            int32_t z = mapping(int32_t(*zs));
+            if constexpr (safety == Safe::Yes) {
+                z = eastl::clamp(z, int32_t(0), int32_t(N - 1));
+            }
+            uint32_t* head = &frags->head;
+            *head = (frags->getActualFragmentSize() << 24) | table[z];
+            table[z] = reinterpret_cast<uint32_t>(head) & 0xffffff;
+        }
+    }
+
+    /**
+     * @brief Inserts a fragment at the average Z of the vertices last transformed by the GTE.
+     *
+     * @details This runs the `avsz3` or `avsz4` GTE kernel, depending on
+     * `vertices`, over the screen Z values left in the GTE by the previous
+     * `rtpt` / `rtps` operations, and inserts the fragment using the resulting
+     * `OTZ` value, through the `mapping`. The `ZSF3` or `ZSF4` GTE register needs
+     * to be set beforehand, so that the `OTZ` results fit the mapping. The
+     * mapped Z value is returned, so that the caller can keep it for a later
+     * batch insertion, or detect primitives which are out of range.
+     *
+     * @tparam vertices Either 3 for triangles, or 4 for quads.
+     * @param frag The fragment to insert.
+     * @param mapping The mapping from Z values to buckets.
+     * @return The bucket the fragment went into, before clamping.
+     */
+    template <unsigned vertices, Fragment Frag, typename Mapping = LinearDepth>
+    int32_t insertAverageZ(Frag& frag, Mapping mapping = {}) {
+        static_assert((vertices == 3) || (vertices == 4), "Only triangles and quads can be averaged");
+        if constexpr (vertices == 3) {
+            GTE::Kernels::avsz3();
+        } else {
+            GTE::Kernels::avsz4();
+        }
+        int32_t z = mapping(int32_t(GTE::readRaw<GTE::Register::OTZ>()));
+        insert(frag, z);
+        return z;
+    }
+
   private:
     uint32_t m_table[N + 1];
     friend class GPU;
@@ -0,0 +1,122 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/tuple.h>
+#include <EASTL/utility.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace psyqo {
+
+/**
+ * @brief A compile-time layout of objects living in the scratchpad.
+ *
+ * @details The scratchpad is 1kB of memory embedded in the CPU, which is as
+ * fast as its registers, and which doesn't go through the data cache. It is
+ * the best place for the hottest data of a frame, such as the GTE staging
+ * buffers of a `GTE::VertexPipeline`, or lookup tables used in tight loops.
+ * Note however that the DMA controller can't access it, so it can't hold
+ * anything meant to be sent to the GPU or the SPU directly.
+ *
+ * This class computes the placement of each of the types in `Ts` within the
+ * scratchpad at compile time, respecting their alignment, and fails to compile
+ * if they don't fit. The storage itself is placed in the `.scratchpad` section,
+ * which means the linker will also complain if the sum of all the layouts and
+ * other objects placed in this section goes beyond 1kB. The scratchpad isn't
+ * initialized on boot, so the objects need to be constructed using `construct`
+ * before being used, unless they are trivially constructible and get written
+ * to before being read.
+ *
+ * Example usage:
+ * @code
+ * using Hot = psyqo::ScratchpadLayout<psyqo::GTE::VertexPipeline<64>, psyqo::Color[16]>;
+ * auto& pipeline = Hot::get<0>();
+ * @endcode
+ *
+ * @tparam Ts The types of the objects to place in the scratchpad.
+ */
+template <typename... Ts>
+class ScratchpadLayout {
+    static_assert(sizeof...(Ts) > 0, "ScratchpadLayout: the layout needs at least one object");
+    static constexpr size_t c_count = sizeof...(Ts);
+    static constexpr size_t c_sizes[] = {sizeof(Ts)...};
+    static constexpr size_t c_alignments[] = {alignof(Ts)...};
+
+    template <size_t I>
+    static constexpr size_t computeOffset() {
+        size_t offset = 0;
+        for (size_t i = 0; i <= I; i++) {
+            offset = (offset + c_alignments[i] - 1) & ~(c_alignments[i] - 1);
+            if (i != I) offset += c_sizes[i];
+        }
+        return offset;
+    }
+
+  public:
+    /**
+     * @brief The total size of the scratchpad.
+     */
+    static constexpr size_t c_scratchpadSize = 1024;
+
+    template <size_t I>
+    using Type = eastl::tuple_element_t<I, eastl::tuple<Ts...>>;
+
+    /**
+     * @brief The offset of the `I`th object, from the start of the layout.
+     */
+    template <size_t I>
+    static constexpr size_t c_offset = computeOffset<I>();
+
+    /**
+     * @brief The total size taken by the layout in the scratchpad.
+     */
+    static constexpr size_t c_size = c_offset<c_count - 1> + c_sizes[c_count - 1];
+
+    static_assert(c_size <= c_scratchpadSize, "ScratchpadLayout: the objects don't fit in the scratchpad");
+
+    /**
+     * @brief Returns a reference to the `I`th object of the layout.
+     */
+    template <size_t I>
+    static Type<I>& get() {
+        return *reinterpret_cast<Type<I>*>(s_storage + c_offset<I>);
+    }
+
+    /**
+     * @brief Constructs the `I`th object of the layout in place, and returns a reference to it.
+     */
+    template <size_t I, typename... Args>
+    static Type<I>& construct(Args&&... args) {
+        return *new (s_storage + c_offset<I>) Type<I>(eastl::forward<Args>(args)...);
+    }
+
+  private:
+    alignas(Ts...) static inline uint8_t s_storage[c_size] __attribute__((section(".scratchpad")));
+};
+
+}  // namespace psyqo
@@ -63,6 +63,22 @@ void generateRotationMatrix33(Matrix33 *m, Angle t, Axis a, const Trig<> &trig);
     return generateRotationMatrix33(t, a, *trig);
 }
 
+/**
+ * @brief Generate rotation matrices for a whole array of angles around the same axis.
+ *
+ * @details This is the batch version of `generateRotationMatrix33`, for when a lot
+ * of objects need their rotation matrices refreshed every frame. The constant
+ * parts of the matrices are written alongside the sines and cosines, so the
+ * output array doesn't need to be initialized beforehand.
+ *
+ * @param out The array of matrices to store the results in.
+ * @param angles The array of angles to rotate by.
+ * @param count The number of angles, and matrices.
+ * @param a The axis to rotate around.
+ * @param trig A trigonometry object to use for sine and cosine calculations.
+ */
+void generateRotationMatrices33(Matrix33 *out, const Angle *angles, unsigned count, Axis a, const Trig<> &trig);
+
 /**
  * @brief Multiply two 3x3 matrices.
  *
@@ -175,6 +191,22 @@ void crossProductVec3(const Vec3 &v1, const Vec3 &v2, Vec3 *out);
     return matrixDeterminant3(*m);
 }
 
+/**
+ * @brief Computes the reciprocal of a fixed point number.
+ *
+ * @details This is the same as `1.0_fp / x`, but using a single 32-bits
+ * hardware division, instead of the generic 64-bits division loop the
+ * `FixedPoint` division operator has to go through. The result is exact,
+ * and the value must not be 0. See `GTE::reciprocal` for a faster, but
+ * less precise, version.
+ *
+ * @param x The number to compute the reciprocal of.
+ * @return FixedPoint<> The reciprocal of the number.
+ */
+[[nodiscard]] static inline FixedPoint<> reciprocal(FixedPoint<> x) {
+    return FixedPoint<>((1 << 24) / x.value, FixedPoint<>::RAW);
+}
+
 /** @brief Computes the square root of a fixed point number, given an approximative hint.
  *
  * @param x The number to compute the square root of.
@@ -0,0 +1,260 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <EASTL/atomic.h>
+
+#include "common/hardware/dma.h"
+#include "psyqo/cdrom-device.hh"
+#include "psyqo/hardware/cdrom.hh"
+#include "psyqo/hardware/sbus.hh"
+#include "psyqo/kernel.hh"
+#include "psyqo/msf.hh"
+
+namespace {
+
+enum class StreamActionState : uint8_t {
+    IDLE,
+    SETLOC,
+    SETMODE,
+    READ,
+    READING,
+    PAUSE,
+    PAUSE_ACK,
+    PAUSED,
+};
+
+// Reads sectors continuously into a ring buffer. When the ring gets full, the drive is paused, which
+// keeps it spinning, and the reading resumes from the next sector once the consumer has freed half
+// of the ring. Sectors which still arrive after the pause command got sent are dropped, and get read
+// again on resume.
+class StreamAction : public psyqo::CDRomDevice::Action<StreamActionState> {
+  public:
+    StreamAction() : Action("StreamAction") {}
+    void start(psyqo::CDRomDevice *device, uint32_t sector, uint32_t count, void *ring, unsigned ringSectors,
+               eastl::function<void(bool)> &&callback) {
+        psyqo::Kernel::assert(device->isIdle(),
+                              "CDRomDevice::startStream() called while another action is in progress");
+        psyqo::Kernel::assert((reinterpret_cast<uintptr_t>(ring) & 3) == 0, "Unaligned stream ring buffer");
+        psyqo::Kernel::assert(ringSectors >= 2, "Stream ring buffer too small");
+        registerMe(device);
+        m_callback = eastl::move(callback);
+        setCallback([this](bool success) {
+            m_done = true;
+            eastl::atomic_signal_fence(eastl::memory_order_release);
+            wake(false);
+            auto callback = eastl::move(m_callback);
+            m_callback = nullptr;
+            if (callback) callback(success);
+        });
+        m_ring = reinterpret_cast<uint8_t *>(ring);
+        m_capacity = ringSectors;
+        m_read = m_write = m_filled = 0;
+        m_nextSector = sector;
+        m_remaining = count;
+        m_ending = count == 0;
+        m_done = false;
+        setLoc();
+    }
+
+    const uint8_t *peek() {
+        eastl::atomic_signal_fence(eastl::memory_order_acquire);
+        if (m_filled == 0) return nullptr;
+        // The newest sector may still be coming in through the DMA.
+        if (m_filled == 1) {
+            while (DMA_CTRL[DMA_CDROM].CHCR & 0x01000000);
+        }
+        return m_ring + m_read * 2048;
+    }
+    bool ready() {
+        eastl::atomic_signal_fence(eastl::memory_order_acquire);
+        return (m_filled != 0) || m_done || (m_ring == nullptr);
+    }
+
+    // The following are called from the main loop, with the CDRom IRQ masked.
+    void release(unsigned count) {
+        psyqo::Kernel::assert(count <= m_filled, "CDRomDevice::releaseStream() called with too many sectors");
+        m_read = (m_read + count) % m_capacity;
+        m_filled -= count;
+        if (!m_done && (getState() == StreamActionState::PAUSED)) maybeResume();
+    }
+    void stop() {
+        if (m_done || (m_ring == nullptr)) return;
+        m_ending = true;
+        switch (getState()) {
+            case StreamActionState::READING:
+            case StreamActionState::PAUSED:
+                pause();
+                break;
+            default:
+                // Whatever is in flight will notice m_ending.
+                break;
+        }
+    }
+    void setWaiter(std::coroutine_handle<> handle) {
+        if (ready()) {
+            psyqo::Kernel::queueCallback([handle]() { handle.resume(); });
+        } else {
+            m_waiter = handle;
+        }
+    }
+
+    bool dataReady(const psyqo::CDRomDevice::Response &) override {
+        psyqo::Hardware::CDRom::Ctrl.throwAway();
+        psyqo::Hardware::CDRom::DataRequest = 0;
+        if ((getState() != StreamActionState::READING) || (m_filled == m_capacity) || (m_remaining == 0)) {
+            // Late sector after a pause request, which will get read again on resume.
+            return false;
+        }
+        psyqo::Hardware::CDRom::InterruptControl.throwAway();
+        psyqo::Hardware::CDRom::DataRequest = 0x80;
+        psyqo::Hardware::SBus::Dev5Ctrl = 0x20943;
+        psyqo::Hardware::SBus::ComCtrl = 0x132c;
+        eastl::atomic_signal_fence(eastl::memory_order_acquire);
+        DMA_CTRL[DMA_CDROM].MADR = reinterpret_cast<uintptr_t>(m_ring + m_write * 2048);
+        DMA_CTRL[DMA_CDROM].BCR = 512 | 0x10000;
+        DMA_CTRL[DMA_CDROM].CHCR = 0x11000000;
+        m_write = (m_write + 1) % m_capacity;
+        m_filled++;
+        m_nextSector++;
+        if (--m_remaining == 0) m_ending = true;
+        if (m_ending || (m_filled == m_capacity)) pause();
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        wake(true);
+        return false;
+    }
+    bool complete(const psyqo::CDRomDevice::Response &) override {
+        psyqo::Kernel::assert(getState() == StreamActionState::PAUSE_ACK,
+                              "StreamAction got CDROM complete in wrong state");
+        if (m_ending) {
+            setSuccess(true);
+            return true;
+        }
+        setState(StreamActionState::PAUSED);
+        maybeResume();
+        return false;
+    }
+    bool acknowledge(const psyqo::CDRomDevice::Response &) override {
+        switch (getState()) {
+            case StreamActionState::SETLOC:
+                if (m_ending) {
+                    pause();
+                    break;
+                }
+                setState(StreamActionState::SETMODE);
+                psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::SETMODE, 0x80);
+                break;
+            case StreamActionState::SETMODE:
+                if (m_ending) {
+                    pause();
+                    break;
+                }
+                setState(StreamActionState::READ);
+                psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::READN);
+                break;
+            case StreamActionState::READ:
+                setState(StreamActionState::READING);
+                if (m_ending) pause();
+                break;
+            case StreamActionState::PAUSE:
+                setState(StreamActionState::PAUSE_ACK);
+                break;
+            default:
+                psyqo::Kernel::abort("StreamAction got CDROM acknowledge in wrong state");
+                break;
+        }
+        return false;
+    }
+
+  private:
+    void setLoc() {
+        setState(StreamActionState::SETLOC);
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        psyqo::MSF msf(m_nextSector + 150);
+        uint8_t bcd[3];
+        msf.toBCD(bcd);
+        psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::SETLOC, bcd[0], bcd[1], bcd[2]);
+    }
+    void pause() {
+        setState(StreamActionState::PAUSE);
+        eastl::atomic_signal_fence(eastl::memory_order_release);
+        psyqo::Hardware::CDRom::Command.send(psyqo::Hardware::CDRom::CDL::PAUSE);
+    }
+    // Only resuming once half of the ring is free avoids pausing again right away.
+    void maybeResume() {
+        if ((m_capacity - m_filled) >= (m_capacity / 2)) setLoc();
+    }
+    void wake(bool fromISR) {
+        auto waiter = m_waiter;
+        if (!waiter) return;
+        m_waiter = nullptr;
+        if (fromISR) {
+            psyqo::Kernel::queueCallbackFromISR([waiter]() { waiter.resume(); });
+        } else {
+            waiter.resume();
+        }
+    }
+
+    eastl::function<void(bool)> m_callback;
+    std::coroutine_handle<> m_waiter;
+    uint8_t *m_ring = nullptr;
+    unsigned m_capacity = 0;
+    unsigned m_read = 0;
+    unsigned m_write = 0;
+    unsigned m_filled = 0;
+    uint32_t m_nextSector = 0;
+    uint32_t m_remaining = 0;
+    bool m_ending = false;
+    bool m_done = false;
+};
+
+StreamAction s_streamAction;
+
+}  // namespace
+
+void psyqo::CDRomDevice::startStream(uint32_t sector, uint32_t count, void *ring, unsigned ringSectors,
+                                     eastl::function<void(bool)> &&callback) {
+    Kernel::assert(m_callback == nullptr, "CDRomDevice::startStream called with pending action");
+    s_streamAction.start(this, sector, count, ring, ringSectors, eastl::move(callback));
+}
+
+const uint8_t *psyqo::CDRomDevice::peekStream() { return s_streamAction.peek(); }
+
+void psyqo::CDRomDevice::releaseStream(unsigned sectors) {
+    MaskedIRQ masked;
+    s_streamAction.release(sectors);
+}
+
+void psyqo::CDRomDevice::stopStream() {
+    MaskedIRQ masked;
+    s_streamAction.stop();
+}
+
+bool psyqo::CDRomDevice::isStreamReady() { return s_streamAction.ready(); }
+
+void psyqo::CDRomDevice::setStreamWaiter(std::coroutine_handle<> handle) {
+    MaskedIRQ masked;
+    s_streamAction.setWaiter(handle);
+}
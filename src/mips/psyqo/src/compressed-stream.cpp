@@ -0,0 +1,90 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#include "psyqo/compressed-stream.hh"
+
+#include <EASTL/algorithm.h>
+
+#include "psyqo/cdrom-device.hh"
+
+namespace {
+
+uint32_t readU32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24); }
+
+}  // namespace
+
+psyqo::Coroutine<uint32_t> psyqo::CompressedStreamLoader::load(CDRomDevice &device, uint32_t sector,
+                                                               uint32_t sectors, void *buffer, uint32_t bufferSize,
+                                                               void *ring, unsigned ringSectors) {
+    bool success = false;
+    bool failed = false;
+    device.startStream(sector, sectors, ring, ringSectors, [&success](bool s) { success = s; });
+
+    uint8_t *out = reinterpret_cast<uint8_t *>(buffer);
+    uint8_t *in = nullptr;
+    uint32_t decompSize = 0, compSize = 0, blockSize = 0, blockCount = 0;
+    uint32_t received = 0, consumed = 0, block = 0;
+    bool first = true;
+
+    while (const uint8_t *data = co_await device.nextStreamSector()) {
+        uint32_t size = 2048;
+        if (first) {
+            first = false;
+            decompSize = readU32(data + 4);
+            compSize = readU32(data + 8);
+            blockSize = readU32(data + 12);
+            blockCount = readU32(data + 16);
+            uint32_t margin = readU32(data + 20);
+            bool valid = (readU32(data) == c_magic) && ((decompSize + margin) <= bufferSize);
+            if (!valid || (compSize > (decompSize + margin))) {
+                failed = true;
+                device.stopStream();
+            }
+            in = out + decompSize + margin - compSize;
+            data += c_headerSize;
+            size -= c_headerSize;
+        }
+        if (!failed) {
+            size = eastl::min(size, compSize - received);
+            __builtin_memcpy(in + received, data, size);
+            received += size;
+        }
+        device.releaseStream();
+
+        // Each block which has fully arrived can be decompressed now, while the
+        // drive fills the ring with the following sectors.
+        while (!failed && (block < blockCount) && ((received - consumed) >= 4)) {
+            uint32_t blockBytes = readU32(in + consumed);
+            if ((received - consumed - 4) < blockBytes) break;
+            m_decompressor(in + consumed + 4, out + block * blockSize);
+            consumed += (blockBytes + 7) & ~3;
+            if (++block == blockCount) device.stopStream();
+        }
+    }
+
+    co_return (success && !failed && (block == blockCount)) ? decompSize : 0;
+}
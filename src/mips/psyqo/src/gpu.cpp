@@ -178,6 +178,11 @@ void psyqo::GPU::initialize(const psyqo::GPU::Configuration &config) {
         }
         // GPU back in Fifo polling mode
         Hardware::GPU::Ctrl = 0x04000001;
+        if (m_chainInFlight) {
+            m_chainInFlight = false;
+            m_chainsTransferred = m_chainsSent;
+        }
+        if (m_drainUploads && scheduleNextQueuedUpload()) return;
         if (m_flushCacheAfterDMA) {
             Prim::FlushCache fc;
             sendPrimitive(fc);
@@ -247,15 +252,23 @@ void psyqo::GPU::flip() {
 
     enableScissor();
     Kernel::Internal::beginFrame();
-    if (m_chainHead) {
+    // The uploads queued during the frame which just ended get sent after its chain, if any.
+    bool hasUploads = !m_uploads[parity ^ 1].empty();
+    if (m_chainHead || hasUploads) {
         m_chainStatus = CHAIN_TRANSFERRING;
+        m_drainUploads = hasUploads;
         eastl::atomic_signal_fence(eastl::memory_order_release);
-        sendChain(
-            [this]() {
-                m_chainStatus = CHAIN_TRANSFERRED;
-                eastl::atomic_signal_fence(eastl::memory_order_release);
-            },
-            DMA::FROM_ISR);
+        auto done = [this]() {
+            m_chainStatus = CHAIN_TRANSFERRED;
+            eastl::atomic_signal_fence(eastl::memory_order_release);
+        };
+        if (m_chainHead) {
+            sendChain(eastl::move(done), DMA::FROM_ISR);
+        } else {
+            m_fromISR = true;
+            m_dmaCallback = eastl::move(done);
+            scheduleNextQueuedUpload();
+        }
     }
 }
 
@@ -342,8 +355,55 @@ void psyqo::GPU::uploadToVRAM(const uint16_t *data, Rect region, eastl::function
     Kernel::assert((ptr & 3) == 0, "Unaligned DMA transfer");
     // TODO: check region bounds
     m_fromISR = dmaCallback == DMA::FROM_ISR;
-    m_flushCacheAfterDMA = true;
     m_dmaCallback = eastl::move(callback);
+    scheduleUploadDMA(data, region);
+}
+
+void psyqo::GPU::queueUploadToVRAM(const uint16_t *data, Rect region) {
+    if (region.isEmpty()) return;
+    Kernel::assert((reinterpret_cast<uintptr_t>(data) & 3) == 0, "Unaligned DMA transfer");
+    Kernel::assert(((region.size.w * region.size.h) & 1) == 0, "Odd number of pixels to transfer");
+    auto &uploads = m_uploads[m_parity];
+    if (!uploads.empty()) {
+        auto &last = uploads.back();
+        if ((last.region.pos.x == region.pos.x) && (last.region.size.w == region.size.w) &&
+            ((last.region.pos.y + last.region.size.h) == region.pos.y) &&
+            ((last.data + last.region.size.w * last.region.size.h) == data)) {
+            last.region.size.h += region.size.h;
+            return;
+        }
+    }
+    uploads.push_back({data, region});
+}
+
+bool psyqo::GPU::scheduleNextQueuedUpload() {
+    auto &uploads = m_uploads[m_parity ^ 1];
+    if (uploads.empty()) {
+        m_drainUploads = false;
+        return false;
+    }
+    auto &upload = uploads.front();
+    const uint16_t *data = upload.data;
+    Rect region = upload.region;
+    // The bulk of the upload goes out in rows adding up to a multiple of 16 pixels, so that it can use
+    // the largest block size, and the remaining rows in a second, smaller, transfer.
+    int16_t w = region.size.w;
+    int16_t granularity = 16 / (1 << __builtin_ctz(w | 16));
+    int16_t rows = region.size.h - (region.size.h % granularity);
+    if ((rows != 0) && (rows != region.size.h)) {
+        region.size.h = rows;
+        upload.data += w * rows;
+        upload.region.pos.y += rows;
+        upload.region.size.h -= rows;
+    } else {
+        uploads.pop_front();
+    }
+    scheduleUploadDMA(data, region);
+    return true;
+}
+
+void psyqo::GPU::scheduleUploadDMA(const uint16_t *data, Rect region) {
+    m_flushCacheAfterDMA = true;
 
     uint32_t bcr = region.size.w * region.size.h;
     Kernel::assert((bcr & 1) == 0, "Odd number of pixels to transfer");
@@ -365,7 +425,7 @@ void psyqo::GPU::uploadToVRAM(const uint16_t *data, Rect region, eastl::function
     // Activating VRAM DMA upload mode
     Hardware::GPU::Ctrl = 0x04000002;
     while ((Hardware::GPU::Ctrl & uint32_t(0x10000000)) == 0);
-    DMA_CTRL[DMA_GPU].MADR = ptr;
+    DMA_CTRL[DMA_GPU].MADR = reinterpret_cast<uintptr_t>(data);
     DMA_CTRL[DMA_GPU].BCR = bcr;
     eastl::atomic_signal_fence(eastl::memory_order_release);
     DMA_CTRL[DMA_GPU].CHCR = 0x01000201;
@@ -459,6 +519,8 @@ void psyqo::GPU::sendChain(eastl::function<void()> &&callback, DMA::DmaCallback
     Kernel::assert((ptr & 3) == 0, "Unaligned DMA transfer");
     m_chainHead = m_chainTail = nullptr;
     m_fromISR = dmaCallback == DMA::FROM_ISR;
+    m_chainsSent++;
+    m_chainInFlight = true;
     m_dmaCallback = eastl::move(callback);
     uint32_t head = *chainHead;
     uint32_t count = head >> 24;
@@ -496,6 +558,11 @@ bool psyqo::GPU::isChainTransferred() const {
     return m_chainStatus == CHAIN_TRANSFERRED;
 }
 
+bool psyqo::GPU::isChainGenerationTransferred(uint32_t generation) const {
+    eastl::atomic_signal_fence(eastl::memory_order_acquire);
+    return int32_t(m_chainsTransferred - generation) >= 0;
+}
+
 uintptr_t psyqo::GPU::armTimer(uint32_t deadline, eastl::function<void(uint32_t)> &&callback) {
     m_timers.emplace_back(eastl::move(callback), deadline, 0, 0, false);
     return reinterpret_cast<uintptr_t>(&m_timers.back());
@@ -30,8 +30,7 @@ using namespace psyqo::fixed_point_literals;
 using namespace psyqo::trig_literals;
 
 void psyqo::SoftMath::generateRotationMatrix33(Matrix33 *m, Angle t, Axis a, const Trig<> &trig) {
-    auto s = trig.sin(t);
-    auto c = trig.cos(t);
+    auto [s, c] = trig.sincos(t);
     switch (a) {
         case Axis::X:
             m->vs[0].x = 1.0_fp;
@@ -70,8 +69,7 @@ void psyqo::SoftMath::generateRotationMatrix33(Matrix33 *m, Angle t, Axis a, con
 }
 
 psyqo::Matrix33 psyqo::SoftMath::generateRotationMatrix33(Angle t, Axis a, const Trig<> &trig) {
-    auto s = trig.sin(t);
-    auto c = trig.cos(t);
+    auto [s, c] = trig.sincos(t);
     switch (a) {
         case Axis::X: {
             return Matrix33{{{
@@ -128,6 +126,58 @@ psyqo::Matrix33 psyqo::SoftMath::generateRotationMatrix33(Angle t, Axis a, const
     __builtin_unreachable();
 }
 
+void psyqo::SoftMath::generateRotationMatrices33(Matrix33 *out, const Angle *angles, unsigned count, Axis a,
+                                                 const Trig<> &trig) {
+    // Deciding on the axis once for the whole array keeps the loops free of branches.
+    switch (a) {
+        case Axis::X:
+            for (unsigned i = 0; i < count; i++) {
+                auto [s, c] = trig.sincos(angles[i]);
+                auto &m = out[i];
+                m.vs[0].x = 1.0_fp;
+                m.vs[0].y = 0.0_fp;
+                m.vs[0].z = 0.0_fp;
+                m.vs[1].x = 0.0_fp;
+                m.vs[1].y = c;
+                m.vs[1].z = s;
+                m.vs[2].x = 0.0_fp;
+                m.vs[2].y = -s;
+                m.vs[2].z = c;
+            }
+            break;
+        case Axis::Y:
+            for (unsigned i = 0; i < count; i++) {
+                auto [s, c] = trig.sincos(angles[i]);
+                auto &m = out[i];
+                m.vs[0].x = c;
+                m.vs[0].y = 0.0_fp;
+                m.vs[0].z = -s;
+                m.vs[1].x = 0.0_fp;
+                m.vs[1].y = 1.0_fp;
+                m.vs[1].z = 0.0_fp;
+                m.vs[2].x = s;
+                m.vs[2].y = 0.0_fp;
+                m.vs[2].z = c;
+            }
+            break;
+        case Axis::Z:
+            for (unsigned i = 0; i < count; i++) {
+                auto [s, c] = trig.sincos(angles[i]);
+                auto &m = out[i];
+                m.vs[0].x = c;
+                m.vs[0].y = s;
+                m.vs[0].z = 0.0_fp;
+                m.vs[1].x = -s;
+                m.vs[1].y = c;
+                m.vs[1].z = 0.0_fp;
+                m.vs[2].x = 0.0_fp;
+                m.vs[2].y = 0.0_fp;
+                m.vs[2].z = 1.0_fp;
+            }
+            break;
+    }
+}
+
 void psyqo::SoftMath::multiplyMatrix33(const Matrix33 &m1, const Matrix33 &m2, Matrix33 *out) {
     auto x0 = m1.vs[0].x * m2.vs[0].x + m1.vs[1].x * m2.vs[0].y + m1.vs[2].x * m2.vs[0].z;
     auto y0 = m1.vs[0].y * m2.vs[0].x + m1.vs[1].y * m2.vs[0].y + m1.vs[2].y * m2.vs[0].z;
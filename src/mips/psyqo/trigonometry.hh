@@ -82,25 +82,8 @@ class Trig {
      * @return FixedPoint<precisionBits> The cosine of the angle.
      */
     constexpr FixedPoint<precisionBits> cos(Angle a) const {
-        using namespace trig_literals;
-        uint32_t t = a.value;
-
-        t %= (2.0_pi).value;
-        a.value = t;
-        int32_t r;
-
-        if (a < 0.5_pi) {
-            r = table[t];
-        } else if (a < 1.0_pi) {
-            r = -table[(1.0_pi).value - 1 - t];
-        } else if (a < 1.5_pi) {
-            r = -table[t - (1.0_pi).value];
-        } else {
-            r = table[(2.0_pi).value - 1 - t];
-        }
-
         FixedPoint<precisionBits> ret;
-        ret.value = r;
+        ret.value = lookup(a.value);
         return ret;
     }
 
@@ -115,7 +98,103 @@ class Trig {
         return cos(a - 0.5_pi);
     }
 
+    /**
+     * @brief The sine and cosine of an angle, as returned by `sincos`.
+     */
+    struct SinCos {
+        FixedPoint<precisionBits> sin;
+        FixedPoint<precisionBits> cos;
+    };
+
+    /**
+     * @brief Calculate both the sine and the cosine of an angle.
+     *
+     * @details This is cheaper than calling `sin` and `cos` separately,
+     * as the angle is only reduced once, and both values come out of
+     * the same pair of table entries. This is what rotation matrices
+     * should be using.
+     *
+     * @param a The angle to calculate the sine and cosine of.
+     * @return SinCos The sine and cosine of the angle.
+     */
+    constexpr SinCos sincos(Angle a) const {
+        uint32_t t = a.value;
+        unsigned quadrant = (t >> 9) & 3;
+        unsigned index = t & 511;
+        int32_t near = table[index];
+        int32_t far = table[511 - index];
+        SinCos ret;
+        switch (quadrant) {
+            case 0:
+                ret.cos.value = near;
+                ret.sin.value = far;
+                break;
+            case 1:
+                ret.cos.value = -far;
+                ret.sin.value = near;
+                break;
+            case 2:
+                ret.cos.value = -near;
+                ret.sin.value = -far;
+                break;
+            default:
+                ret.cos.value = far;
+                ret.sin.value = -near;
+                break;
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Calculate the cosine of an angle more precise than `Angle`.
+     *
+     * @details The table has one entry per step of an `Angle`, which is
+     * 1/1024th of Pi. Angles with more fractional bits than that, which
+     * are useful for slow and smooth rotations, get linearly interpolated
+     * between the two closest entries.
+     *
+     * @tparam anglePrecision The number of fractional bits of the angle.
+     * @param a The angle to calculate the cosine of, in fractions of Pi.
+     * @return FixedPoint<precisionBits> The cosine of the angle.
+     */
+    template <unsigned anglePrecision>
+        requires((anglePrecision > 10) && (anglePrecision <= 20))
+    constexpr FixedPoint<precisionBits> cos(FixedPoint<anglePrecision> a) const {
+        constexpr unsigned shift = anglePrecision - 10;
+        uint32_t t = a.value;
+        int32_t fraction = t & ((1 << shift) - 1);
+        int32_t r0 = lookup(t >> shift);
+        int32_t r1 = lookup((t >> shift) + 1);
+        FixedPoint<precisionBits> ret;
+        ret.value = r0 + (((r1 - r0) * fraction) >> shift);
+        return ret;
+    }
+
+    /**
+     * @brief Calculate the sine of an angle more precise than `Angle`.
+     *
+     * @tparam anglePrecision The number of fractional bits of the angle.
+     * @param a The angle to calculate the sine of, in fractions of Pi.
+     * @return FixedPoint<precisionBits> The sine of the angle.
+     */
+    template <unsigned anglePrecision>
+        requires((anglePrecision > 10) && (anglePrecision <= 20))
+    constexpr FixedPoint<precisionBits> sin(FixedPoint<anglePrecision> a) const {
+        FixedPoint<anglePrecision> quarter;
+        quarter.value = 1 << (anglePrecision - 1);
+        return cos(a - quarter);
+    }
+
   private:
+    // The table only holds the first quadrant; the others are mirrors of it.
+    constexpr int32_t lookup(uint32_t t) const {
+        t &= 2047;
+        if (t < 512) return table[t];
+        if (t < 1024) return -table[1023 - t];
+        if (t < 1536) return -table[t - 1024];
+        return table[2047 - t];
+    }
+
     eastl::array<int32_t, 512> table;
 };
 
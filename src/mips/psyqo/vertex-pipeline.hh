@@ -0,0 +1,230 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <EASTL/utility.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psyqo/fragments.hh"
+#include "psyqo/gte-kernels.hh"
+#include "psyqo/gte-registers.hh"
+#include "psyqo/ordering-table.hh"
+#include "psyqo/primitive-concept.hh"
+#include "psyqo/primitives/common.hh"
+#include "psyqo/shared.hh"
+#include "psyqo/vector.hh"
+
+namespace psyqo {
+
+namespace GTE {
+
+/**
+ * @brief A batch vertex transformation pipeline.
+ *
+ * @details This class transforms an array of vertices through the GTE, using
+ * the rotation, translation and projection currently loaded in it, and then
+ * emits the visible faces of a mesh indexing these vertices as screen-space
+ * primitives, straight into an ordering table.
+ *
+ * The `transform` method runs `rtpt` over the vertices three at a time, and
+ * keeps the screen coordinates and depths of each vertex in the pipeline
+ * itself, so that vertices shared between faces only get transformed once.
+ * The pipeline is trivially constructible, and is meant to be placed in the
+ * scratchpad, using `__attribute__((section(".scratchpad")))`, so that the
+ * emission pass reads its inputs without ever touching main memory. Each
+ * vertex takes 6 bytes, which means up to around 160 vertices can fit in the
+ * scratchpad at once, alongside a few other things. Bigger meshes can be
+ * processed in several batches.
+ *
+ * The `emit` method then goes over the faces, loading the screen coordinates
+ * of their vertices back into the GTE in order to cull the ones facing away
+ * using `nclip`, and compute their depth using `avsz3` or `avsz4`. This means
+ * the `ZSF3` or `ZSF4` GTE register needs to be set beforehand. Visible faces
+ * get a primitive allocated from the given allocator, typically a `FrameArena`,
+ * which gets its points set, then gets passed to a callback for the rest of its
+ * attributes, before being inserted into the ordering table.
+ *
+ * @tparam maxVertices The maximum number of vertices which can be transformed at once.
+ */
+template <size_t maxVertices>
+class VertexPipeline {
+  public:
+    struct Triangle {
+        uint16_t a, b, c;
+    };
+    struct Quad {
+        uint16_t a, b, c, d;
+    };
+
+    /**
+     * @brief Transforms an array of vertices.
+     *
+     * @param vertices The vertices, either as `Vec3` or `PackedVec3`.
+     * @param count The number of vertices, which must not exceed `maxVertices`.
+     */
+    template <typename V>
+    void transform(const V* vertices, size_t count) {
+        Vertex* screen = m_screen;
+        uint16_t* depth = m_depth;
+        const V* end = vertices + count;
+        for (; (end - vertices) >= 3; vertices += 3, screen += 3, depth += 3) {
+            load<Register::VXY0, Register::VZ0, Unsafe>(vertices[0]);
+            load<Register::VXY1, Register::VZ1, Unsafe>(vertices[1]);
+            load<Register::VXY2, Register::VZ2, Safe>(vertices[2]);
+            Kernels::rtpt();
+            read<Register::SXY0>(&screen[0].packed);
+            read<Register::SXY1>(&screen[1].packed);
+            read<Register::SXY2>(&screen[2].packed);
+            depth[0] = readRaw<Register::SZ1, Unsafe>();
+            depth[1] = readRaw<Register::SZ2, Unsafe>();
+            depth[2] = readRaw<Register::SZ3, Safe>();
+        }
+        for (; vertices < end; vertices++, screen++, depth++) {
+            load<Register::VXY0, Register::VZ0, Safe>(*vertices);
+            Kernels::rtps();
+            read<Register::SXY2>(&screen->packed);
+            *depth = readRaw<Register::SZ3, Safe>();
+        }
+    }
+
+    /**
+     * @brief Returns the screen coordinates of a vertex transformed by the last call to `transform`.
+     */
+    Vertex screen(size_t index) const { return m_screen[index]; }
+
+    /**
+     * @brief Returns the screen depth of a vertex transformed by the last call to `transform`.
+     */
+    uint16_t depth(size_t index) const { return m_depth[index]; }
+
+    /**
+     * @brief Emits the visible triangles of a mesh as primitives.
+     *
+     * @details For each triangle facing the camera, and with a depth which
+     * falls within the ordering table, this allocates a fragment of `Prim`
+     * from `allocator`, sets its three points, calls `setup(primitive, index)`
+     * with the index of the triangle, and inserts it in `ot`.
+     *
+     * @tparam Prim The primitive to emit, which needs `setPointA` to `setPointC`.
+     * @return The number of primitives emitted.
+     */
+    template <Primitive Prim, size_t N, psyqo::Safe otSafety, typename Allocator, typename Setup,
+              typename Mapping = LinearDepth>
+    size_t emit(const Triangle* faces, size_t count, OrderingTable<N, otSafety>& ot, Allocator& allocator,
+                Setup&& setup, Mapping mapping = {}) {
+        size_t emitted = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto& face = faces[i];
+            Vertex a = m_screen[face.a], b = m_screen[face.b], c = m_screen[face.c];
+            write<Register::SXY0, Unsafe>(a.packed);
+            write<Register::SXY1, Unsafe>(b.packed);
+            write<Register::SXY2, Safe>(c.packed);
+            Kernels::nclip();
+            if (int32_t(readRaw<Register::MAC0, Safe>()) <= 0) continue;
+            write<Register::SZ1, Unsafe>(m_depth[face.a]);
+            write<Register::SZ2, Unsafe>(m_depth[face.b]);
+            write<Register::SZ3, Safe>(m_depth[face.c]);
+            Kernels::avsz3();
+            int32_t z = mapping(int32_t(readRaw<Register::OTZ, Safe>()));
+            if ((z < 0) || (z >= int32_t(N))) continue;
+            auto& fragment = allocator.template allocateFragment<Prim>();
+            fragment.primitive.setPointA(a).setPointB(b).setPointC(c);
+            setup(fragment.primitive, i);
+            ot.insert(fragment, z);
+            emitted++;
+        }
+        return emitted;
+    }
+
+    /**
+     * @brief Emits the visible quads of a mesh as primitives.
+     *
+     * @details Same as the triangle version, using the first three points of
+     * each quad for culling, and the four of them for the depth. The points
+     * are in the order the GPU expects them, meaning `a`, `b`, `c` and `d` form
+     * the two triangles `abc` and `bcd`.
+     *
+     * @tparam Prim The primitive to emit, which needs `setPointA` to `setPointD`.
+     * @return The number of primitives emitted.
+     */
+    template <Primitive Prim, size_t N, psyqo::Safe otSafety, typename Allocator, typename Setup,
+              typename Mapping = LinearDepth>
+    size_t emit(const Quad* faces, size_t count, OrderingTable<N, otSafety>& ot, Allocator& allocator,
+                Setup&& setup, Mapping mapping = {}) {
+        size_t emitted = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto& face = faces[i];
+            Vertex a = m_screen[face.a], b = m_screen[face.b], c = m_screen[face.c], d = m_screen[face.d];
+            write<Register::SXY0, Unsafe>(a.packed);
+            write<Register::SXY1, Unsafe>(b.packed);
+            write<Register::SXY2, Safe>(c.packed);
+            Kernels::nclip();
+            if (int32_t(readRaw<Register::MAC0, Safe>()) <= 0) continue;
+            write<Register::SZ0, Unsafe>(m_depth[face.a]);
+            write<Register::SZ1, Unsafe>(m_depth[face.b]);
+            write<Register::SZ2, Unsafe>(m_depth[face.c]);
+            write<Register::SZ3, Safe>(m_depth[face.d]);
+            Kernels::avsz4();
+            int32_t z = mapping(int32_t(readRaw<Register::OTZ, Safe>()));
+            if ((z < 0) || (z >= int32_t(N))) continue;
+            auto& fragment = allocator.template allocateFragment<Prim>();
+            fragment.primitive.setPointA(a).setPointB(b).setPointC(c).setPointD(d);
+            setup(fragment.primitive, i);
+            ot.insert(fragment, z);
+            emitted++;
+        }
+        return emitted;
+    }
+
+  private:
+    template <Register xy, Register z, Safety safety>
+    static void load(const Vec3& v) {
+        writeUnsafe<xy>(Short(v.x), Short(v.y));
+        if constexpr (safety == Safe) {
+            writeSafe<z>(Short(v.z));
+        } else {
+            writeUnsafe<z>(Short(v.z));
+        }
+    }
+    template <Register xy, Register z, Safety safety>
+    static void load(const PackedVec3& v) {
+        writeUnsafe<xy>(v.x, v.y);
+        if constexpr (safety == Safe) {
+            writeSafe<z>(v.z);
+        } else {
+            writeUnsafe<z>(v.z);
+        }
+    }
+
+    Vertex m_screen[maxVertices];
+    uint16_t m_depth[maxVertices];
+};
+
+}  // namespace GTE
+
+}  // namespace psyqo
@@ -0,0 +1,151 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "commands.h"
+
+// The register numbers of MTC2 and friends are part of the instruction, hence all of the unrolling
+
+#define WRITE_DATA(r) __asm__ volatile("mtc2 %0, $%1" : : "r"(data[r]), "i"(r))
+#define WRITE_CONTROL(r) __asm__ volatile("ctc2 %0, $%1" : : "r"(control[r]), "i"(r))
+#define READ_DATA(r) __asm__ volatile("mfc2 %0, $%1; nop" : "=r"(result->data[r]) : "i"(r))
+#define READ_CONTROL(r) __asm__ volatile("cfc2 %0, $%1; nop" : "=r"(result->control[r]) : "i"(r))
+
+#define EIGHT(op, base) \
+    op(base + 0);       \
+    op(base + 1);       \
+    op(base + 2);       \
+    op(base + 3);       \
+    op(base + 4);       \
+    op(base + 5);       \
+    op(base + 6);       \
+    op(base + 7)
+
+static void load(const uint32_t data[32], const uint32_t control[32]) {
+    EIGHT(WRITE_CONTROL, 0);
+    EIGHT(WRITE_CONTROL, 8);
+    EIGHT(WRITE_CONTROL, 16);
+    EIGHT(WRITE_CONTROL, 24);
+    // SXYP (15) would push the screen XY FIFO, IRGB (28) would overwrite IR1-3, and ORGB (29) and LZCR (31) are
+    // read only, so these are left alone
+    EIGHT(WRITE_DATA, 0);
+    WRITE_DATA(8);
+    WRITE_DATA(9);
+    WRITE_DATA(10);
+    WRITE_DATA(11);
+    WRITE_DATA(12);
+    WRITE_DATA(13);
+    WRITE_DATA(14);
+    EIGHT(WRITE_DATA, 16);
+    WRITE_DATA(24);
+    WRITE_DATA(25);
+    WRITE_DATA(26);
+    WRITE_DATA(27);
+    WRITE_DATA(30);
+    __asm__ volatile("nop; nop");
+}
+
+static void store(struct GTEResult* result, uint32_t code, uint32_t mode, uint32_t flag) {
+    result->code = code;
+    result->mode = mode;
+    result->flag = flag;
+    EIGHT(READ_DATA, 0);
+    EIGHT(READ_DATA, 8);
+    EIGHT(READ_DATA, 16);
+    EIGHT(READ_DATA, 24);
+    EIGHT(READ_CONTROL, 0);
+    EIGHT(READ_CONTROL, 8);
+    EIGHT(READ_CONTROL, 16);
+    EIGHT(READ_CONTROL, 24);
+}
+
+#define GTE_SF (1 << 19)
+#define GTE_LM (1 << 10)
+
+#define RTPS 0x0100001
+#define RTPT 0x0200030
+#define NCLIP 0x1400006
+#define AVSZ3 0x150002d
+#define AVSZ4 0x160002e
+#define NCDS 0x0e00013
+#define CDP 0x1200014
+#define NCDT 0x0f00016
+#define NCCS 0x100001b
+#define CC 0x130001c
+#define NCS 0x0c0001e
+#define NCT 0x0d00020
+#define NCCT 0x110003f
+#define MVMVA(mx, v, cv) (0x0400012 | ((mx) << 17) | ((v) << 15) | ((cv) << 13))
+
+// Nothing between the command and the FLAG access may branch, or the dynarec won't look that far
+#define RUN(code)                                                                                 \
+    do {                                                                                          \
+        uint32_t flag;                                                                            \
+        load(data, control);                                                                      \
+        __asm__ volatile("cop2 %0; ctc2 $0, $31" : : "i"(code));                                  \
+        store(results++, code, GTE_FLAG_OVERWRITTEN, 0);                                          \
+        load(data, control);                                                                      \
+        __asm__ volatile("cop2 %1; cfc2 %0, $31; nop" : "=r"(flag) : "i"(code));                  \
+        store(results++, code, GTE_FLAG_READ, flag);                                              \
+    } while (0)
+
+#define RUN_VARIANTS(code)                \
+    RUN(code);                            \
+    RUN((code) | GTE_SF);                 \
+    RUN((code) | GTE_LM);                 \
+    RUN((code) | GTE_SF | GTE_LM)
+
+#define RUN_MVMVA(mx, v)                  \
+    RUN_VARIANTS(MVMVA(mx, v, 0));        \
+    RUN_VARIANTS(MVMVA(mx, v, 1));        \
+    RUN_VARIANTS(MVMVA(mx, v, 2));        \
+    RUN_VARIANTS(MVMVA(mx, v, 3))
+
+#define RUN_MVMVA_VECTORS(mx)             \
+    RUN_MVMVA(mx, 0);                     \
+    RUN_MVMVA(mx, 1);                     \
+    RUN_MVMVA(mx, 2);                     \
+    RUN_MVMVA(mx, 3)
+
+void runGTECommands(const uint32_t data[32], const uint32_t control[32], struct GTEResult* results) {
+    RUN_VARIANTS(RTPS);
+    RUN_VARIANTS(RTPT);
+    RUN_VARIANTS(NCLIP);
+    RUN_VARIANTS(AVSZ3);
+    RUN_VARIANTS(AVSZ4);
+    RUN_VARIANTS(NCS);
+    RUN_VARIANTS(NCT);
+    RUN_VARIANTS(NCCS);
+    RUN_VARIANTS(NCCT);
+    RUN_VARIANTS(NCDS);
+    RUN_VARIANTS(NCDT);
+    RUN_VARIANTS(CC);
+    RUN_VARIANTS(CDP);
+    // The garbage matrix (3) and the far color translation (2) are there too, even though they aren't native
+    RUN_MVMVA_VECTORS(0);
+    RUN_MVMVA_VECTORS(1);
+    RUN_MVMVA_VECTORS(2);
+    RUN_MVMVA_VECTORS(3);
+}
@@ -0,0 +1,50 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// What the GTE looks like after one command ran. The commands run twice each: once followed by a CTC2 to FLAG,
+// which lets the dynarec skip computing FLAG entirely, and once followed by a CFC2 from FLAG, which doesn't.
+enum {
+    GTE_FLAG_OVERWRITTEN = 0,
+    GTE_FLAG_READ = 1,
+};
+
+struct GTEResult {
+    uint32_t code;
+    uint32_t mode;
+    uint32_t flag;  // What the CFC2 right after the command read, in GTE_FLAG_READ mode
+    uint32_t data[32];
+    uint32_t control[32];
+};
+
+// One result per mode for each variant of each command
+#define GTE_RESULTS_PER_INPUT (2 * (13 * 4 + 64 * 4))
+
+// Loads the inputs into the GTE, then runs every command variant over them, reloading them before each one
+void runGTECommands(const uint32_t data[32], const uint32_t control[32], struct GTEResult* results);
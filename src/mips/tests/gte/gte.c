@@ -0,0 +1,93 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "common/kernel/pcdrv.h"
+#include "common/syscalls/syscalls.h"
+#include "commands.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* This runs the GTE commands the dynarecs emit natively over random inputs, half of the time biased towards the
+   values which saturate everything, and writes everything the GTE holds after each of them to gte-results.bin
+   through pcdrv. The runner then compares the files written by the interpreter and by the dynarec. */
+
+CESTER_BODY(
+    static uint32_t s_seed = 0x5eed;
+    static uint32_t s_data[32];
+    static uint32_t s_control[32];
+    static struct GTEResult s_results[GTE_RESULTS_PER_INPUT];
+
+    static uint32_t randomWord() {
+        s_seed ^= s_seed << 13;
+        s_seed ^= s_seed >> 17;
+        s_seed ^= s_seed << 5;
+        return s_seed;
+    }
+
+    static uint32_t saturatingWord() {
+        switch (randomWord() % 8) {
+            case 0: return 0x7fff7fff;
+            case 1: return 0x80008000;
+            case 2: return 0x7fffffff;
+            case 3: return 0x80000000;
+            case 4: return 0;
+            case 5: return randomWord() & 0x00ff00ff;
+            default: return randomWord();
+        }
+    }
+)
+
+CESTER_TEST(gte_commands, test_instance,
+    uint32_t sr;
+    __asm__ volatile("mfc0 %0, $12; nop" : "=r"(sr));
+    __asm__ volatile("mtc0 %0, $12; nop" : : "r"(sr | 0x40000000));
+
+    int r = PCinit();
+    cester_assert_int_eq(0, r);
+    int fd = PCcreat("gte-results.bin", 0);
+    cester_assert_cmp(fd, >=, 0);
+
+    for (unsigned input = 0; input < 16; input++) {
+        const int saturating = input & 1;
+        for (unsigned i = 0; i < 32; i++) {
+            s_data[i] = saturating ? saturatingWord() : randomWord();
+            s_control[i] = saturating ? saturatingWord() : randomWord();
+        }
+        runGTECommands(s_data, s_control, s_results);
+        r = PCwrite(fd, s_results, sizeof(s_results));
+        cester_assert_int_eq(sizeof(s_results), r);
+    }
+
+    r = PCclose(fd);
+    cester_assert_int_eq(0, r);
+)
@@ -24,6 +24,7 @@ SOFTWARE.
 
 */
 
+#include "common/hardware/counters.h"
 #include "common/syscalls/syscalls.h"
 
 #undef unix
@@ -35,10 +36,12 @@ SOFTWARE.
 
 // clang-format off
 
-/* This is to test regressions on the fast memcpy code located in common/crt0/memory.s */
+/* This is to test regressions on the fast memcpy, memmove and memcmp code located in common/crt0/memory-s.s */
 
 CESTER_BODY(
     void* __wrap_memcpy(void* dest, const void* src, size_t n);
+    void* __wrap_memmove(void* dest, const void* src, size_t n);
+    int __wrap_memcmp(const void* s1, const void* s2, size_t n);
 )
 
 CESTER_TEST(fastmemcpySmall, test_instance,
@@ -234,3 +237,166 @@ CESTER_TEST(memcpyBothUnlikeUnaligned, test_instance,
         cester_assert_equal(out[i + 1], i + 2);
     }
 )
+
+CESTER_TEST(fastmemcpyMultipleOf32, test_instance,
+    uint32_t in[32];
+    uint32_t out[33] = { 0 };
+    for (unsigned i = 0; i < 32; i++) {
+        in[i] = i * 0x01010101;
+    }
+    void* result = __wrap_memcpy(out, in, 100);
+    cester_assert_ptr_equal(result, out);
+    for (unsigned i = 0; i < 25; i++) {
+        cester_assert_uint_eq(out[i], i * 0x01010101);
+    }
+    cester_assert_uint_eq(out[25], 0);
+)
+
+CESTER_TEST(fastmemcpyLargeUnaligned, test_instance,
+    char in[201];
+    char out[200] = { 0 };
+    for (unsigned i = 0; i < 201; i++) {
+        in[i] = i;
+    }
+    void* result = __wrap_memcpy(out + 1, in + 2, 198);
+    cester_assert_ptr_equal(result, out + 1);
+    cester_assert_equal(out[0], 0);
+    for (unsigned i = 0; i < 198; i++) {
+        cester_assert_equal(out[i + 1], (char)(i + 2));
+    }
+    cester_assert_equal(out[199], 0);
+)
+
+CESTER_TEST(fastmemmoveForward, test_instance,
+    char buf[120];
+    for (unsigned i = 0; i < 120; i++) {
+        buf[i] = i;
+    }
+    void* result = __wrap_memmove(buf + 1, buf + 7, 100);
+    cester_assert_ptr_equal(result, buf + 1);
+    cester_assert_equal(buf[0], 0);
+    for (unsigned i = 0; i < 100; i++) {
+        cester_assert_equal(buf[i + 1], i + 7);
+    }
+    cester_assert_equal(buf[101], 101);
+)
+
+CESTER_TEST(fastmemmoveBackwardAligned, test_instance,
+    char buf[120];
+    for (unsigned i = 0; i < 120; i++) {
+        buf[i] = i;
+    }
+    void* result = __wrap_memmove(buf + 12, buf + 4, 100);
+    cester_assert_ptr_equal(result, buf + 12);
+    for (unsigned i = 0; i < 12; i++) {
+        cester_assert_equal(buf[i], i);
+    }
+    for (unsigned i = 0; i < 100; i++) {
+        cester_assert_equal(buf[i + 12], i + 4);
+    }
+    cester_assert_equal(buf[112], 112);
+)
+
+CESTER_TEST(fastmemmoveBackwardUnaligned, test_instance,
+    char buf[120];
+    for (unsigned i = 0; i < 120; i++) {
+        buf[i] = i;
+    }
+    void* result = __wrap_memmove(buf + 6, buf + 1, 101);
+    cester_assert_ptr_equal(result, buf + 6);
+    for (unsigned i = 0; i < 6; i++) {
+        cester_assert_equal(buf[i], i);
+    }
+    for (unsigned i = 0; i < 101; i++) {
+        cester_assert_equal(buf[i + 6], i + 1);
+    }
+    cester_assert_equal(buf[107], 107);
+)
+
+CESTER_TEST(fastmemcmpEqual, test_instance,
+    char a[101];
+    char b[102];
+    for (unsigned i = 0; i < 101; i++) {
+        a[i] = b[i + 1] = i;
+    }
+    cester_assert_int_eq(__wrap_memcmp(a, b + 1, 101), 0);
+    cester_assert_int_eq(__wrap_memcmp(a + 3, b + 4, 98), 0);
+    cester_assert_int_eq(__wrap_memcmp(a, b, 0), 0);
+)
+
+CESTER_TEST(fastmemcmpDifferent, test_instance,
+    char a[101];
+    char b[101];
+    for (unsigned i = 0; i < 101; i++) {
+        a[i] = b[i] = i;
+    }
+    b[70] = 0x80;
+    cester_assert_int_lt(__wrap_memcmp(a, b, 101), 0);
+    cester_assert_int_gt(__wrap_memcmp(b, a, 101), 0);
+    cester_assert_int_lt(__wrap_memcmp(a + 1, b + 1, 100), 0);
+    cester_assert_int_eq(__wrap_memcmp(a, b, 70), 0);
+    cester_assert_int_lt(__wrap_memcmp(a + 69, b + 69, 2), 0);
+)
+
+#ifdef BENCHMARK
+
+/* Build with BENCHMARK=true to get cycle counts of the various
+   implementations, as measured by the root counter 2. */
+
+CESTER_BODY(
+    typedef void* (*copy_function)(void*, const void*, size_t);
+    typedef int (*compare_function)(const void*, const void*, size_t);
+
+    static uint32_t s_benchSrc[260];
+    static uint32_t s_benchDst[260];
+
+    static unsigned benchCopy(copy_function f, unsigned dstOffset, unsigned srcOffset, size_t n) {
+        COUNTERS[2].mode = 0;
+        f((char*)s_benchDst + dstOffset, (char*)s_benchSrc + srcOffset, n);
+        return COUNTERS[2].value;
+    }
+
+    static unsigned benchCompare(compare_function f, unsigned offset1, unsigned offset2, size_t n) {
+        COUNTERS[2].mode = 0;
+        f((char*)s_benchDst + offset1, (char*)s_benchSrc + offset2, n);
+        return COUNTERS[2].value;
+    }
+
+    static const unsigned s_benchOffsets[][2] = { { 0, 0 }, { 1, 1 }, { 0, 1 }, { 3, 1 } };
+)
+
+CESTER_TEST(benchmarkCopies, test_instance,
+    copy_function functions[] = { memcpy, __wrap_memcpy, memmove, __wrap_memmove };
+    const char* names[] = { "memcpy", "__wrap_memcpy", "memmove", "__wrap_memmove" };
+    for (unsigned f = 0; f < 4; f++) {
+        for (unsigned o = 0; o < 4; o++) {
+            unsigned cycles = benchCopy(functions[f], s_benchOffsets[o][0], s_benchOffsets[o][1], 1024);
+            ramsyscall_printf("%s, dst+%i, src+%i, 1024 bytes: %i cycles\n", names[f], s_benchOffsets[o][0],
+                              s_benchOffsets[o][1], cycles);
+        }
+    }
+    COUNTERS[2].mode = 0;
+    __wrap_memmove((char*)s_benchDst + 16, s_benchDst, 1000);
+    unsigned backward = COUNTERS[2].value;
+    ramsyscall_printf("__wrap_memmove, overlapping backward, 1000 bytes: %i cycles\n", backward);
+)
+
+CESTER_TEST(benchmarkCompares, test_instance,
+    compare_function functions[] = { memcmp, __wrap_memcmp };
+    const char* names[] = { "memcmp", "__wrap_memcmp" };
+    __wrap_memcpy(s_benchDst, s_benchSrc, sizeof(s_benchSrc));
+    for (unsigned f = 0; f < 2; f++) {
+        for (unsigned o = 0; o < 4; o++) {
+            if (s_benchOffsets[o][0] != s_benchOffsets[o][1]) {
+                char* dst = (char*)s_benchDst + s_benchOffsets[o][0];
+                __wrap_memcpy(dst, (char*)s_benchSrc + s_benchOffsets[o][1], 1024);
+            }
+            unsigned cycles = benchCompare(functions[f], s_benchOffsets[o][0], s_benchOffsets[o][1], 1024);
+            ramsyscall_printf("%s, s1+%i, s2+%i, 1024 bytes: %i cycles\n", names[f], s_benchOffsets[o][0],
+                              s_benchOffsets[o][1], cycles);
+            __wrap_memcpy(s_benchDst, s_benchSrc, sizeof(s_benchSrc));
+        }
+    }
+)
+
+#endif
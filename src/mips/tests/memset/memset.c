@@ -24,6 +24,7 @@ SOFTWARE.
 
 */
 
+#include "common/hardware/counters.h"
 #include "common/syscalls/syscalls.h"
 
 #undef unix
@@ -35,7 +36,7 @@ SOFTWARE.
 
 // clang-format off
 
-/* This is to test regressions on the fast memcpy code located in common/crt0/memory.s */
+/* This is to test regressions on the fast memset code located in common/crt0/memory-s.s */
 
 CESTER_BODY(
     void* __wrap_memset(void* dest, int c, size_t n);
@@ -80,6 +81,16 @@ CESTER_TEST(fastmemsetUnaligned, test_instance,
     cester_assert_ptr_equal(result, buf + 1);
 )
 
+CESTER_TEST(fastmemsetMultipleOf32, test_instance,
+    uint32_t buf[32] = { 0 };
+    void * result = __wrap_memset(buf, 0x55, 100);
+    for (unsigned i = 0; i < 25; i++) {
+        cester_assert_uint_eq(buf[i], 0x55555555);
+    }
+    cester_assert_uint_eq(buf[25], 0);
+    cester_assert_ptr_equal(result, buf);
+)
+
 CESTER_TEST(memsetSmall, test_instance,
     char buf[] = { 0, 0, 0, 0 };
     void * result = __builtin_memset(buf, 0x55, 3);
@@ -118,3 +129,28 @@ CESTER_TEST(memsetUnaligned, test_instance,
     }
     cester_assert_ptr_equal(result, buf + 1);
 )
+
+#ifdef BENCHMARK
+
+/* Build with BENCHMARK=true to get cycle counts of the various
+   implementations, as measured by the root counter 2. */
+
+CESTER_BODY(
+    typedef void* (*set_function)(void*, int, size_t);
+    static uint32_t s_benchBuffer[260];
+)
+
+CESTER_TEST(benchmarkSets, test_instance,
+    set_function functions[] = { memset, __wrap_memset };
+    const char* names[] = { "memset", "__wrap_memset" };
+    for (unsigned f = 0; f < 2; f++) {
+        for (unsigned offset = 0; offset < 4; offset++) {
+            COUNTERS[2].mode = 0;
+            functions[f]((char*)s_benchBuffer + offset, 0x55, 1024);
+            unsigned cycles = COUNTERS[2].value;
+            ramsyscall_printf("%s, dst+%i, 1024 bytes: %i cycles\n", names[f], offset, cycles);
+        }
+    }
+)
+
+#endif
@@ -0,0 +1,53 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/adpcmcache.h"
+
+#include <string.h>
+
+PCSX::SPU::ADPCMCache::ADPCMCache()
+    : m_generations(new std::atomic<uint32_t>[c_units]), m_entries(new Entry[c_entries]) {
+    for (uint32_t unit = 0; unit < c_units; unit++) m_generations[unit].store(0, std::memory_order_relaxed);
+}
+
+const int* PCSX::SPU::ADPCMCache::lookup(uint32_t address, int s_1, int s_2, uint32_t& generation) {
+    const uint32_t unit = address >> 3;
+    generation = m_generations[unit].load(std::memory_order_acquire);
+    const Entry& entry = m_entries[unit & (c_entries - 1)];
+    if ((entry.unit == unit) && (entry.generation == generation) && (entry.s_1 == s_1) && (entry.s_2 == s_2)) {
+        m_hits.store(m_hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return entry.samples;
+    }
+    m_misses.store(m_misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void PCSX::SPU::ADPCMCache::store(uint32_t address, uint32_t generation, int s_1, int s_2, const int* samples) {
+    const uint32_t unit = address >> 3;
+    Entry& entry = m_entries[unit & (c_entries - 1)];
+    entry.unit = unit;
+    entry.generation = generation;
+    entry.s_1 = s_1;
+    entry.s_2 = s_2;
+    memcpy(entry.samples, samples, sizeof(entry.samples));
+}
+
+void PCSX::SPU::ADPCMCache::clear() {
+    for (unsigned i = 0; i < c_entries; i++) m_entries[i].unit = ~0u;
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+namespace PCSX {
+
+namespace SPU {
+
+// Remembers the output of the last ADPCM blocks the voices decoded, so that looping samples only get decoded
+// the first time around. A block's output depends on the two previous samples going into its filter, so
+// these are part of the key, alongside the address of the block. Once a loop has gone around once, they're
+// the same every time.
+//
+// The mixer is the only one looking up and storing blocks. Whoever writes to SPU RAM needs to call
+// invalidate() after the write; this may happen on another thread than the mixer's.
+class ADPCMCache {
+  public:
+    static constexpr unsigned c_samplesPerBlock = 28;
+    static constexpr uint32_t c_ramSize = 512 * 1024;
+
+    ADPCMCache();
+
+    // Returns the decoded samples of the 16 bytes block at this byte address in SPU RAM, if they're cached
+    // for the same filter state. Otherwise, returns nullptr, and sets generation to what store() needs once
+    // the block has been decoded. The address needs to be a multiple of 8, like all of the SPU addresses are.
+    const int* lookup(uint32_t address, int s_1, int s_2, uint32_t& generation);
+    void store(uint32_t address, uint32_t generation, int s_1, int s_2, const int* samples);
+
+    // Drops any block overlapping the SPU RAM word at this byte address.
+    void invalidate(uint32_t address) {
+        const uint32_t unit = (address & (c_ramSize - 1)) >> 3;
+        bump(unit);
+        bump((unit - 1) & (c_units - 1));
+    }
+    // Drops everything, for when all of SPU RAM changes at once. The mixer must not be running.
+    void clear();
+
+    uint64_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+    void resetCounters() {
+        m_hits.store(0, std::memory_order_relaxed);
+        m_misses.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    // SPU addresses are in 8 bytes units, so a block can start at any of these
+    static constexpr uint32_t c_units = c_ramSize / 8;
+    static constexpr unsigned c_entries = 4096;
+
+    struct Entry {
+        uint32_t unit = ~0u;
+        uint32_t generation = 0;
+        int s_1 = 0;
+        int s_2 = 0;
+        int samples[c_samplesPerBlock];
+    };
+
+    // There's only ever one thread writing to SPU RAM at a time, so this doesn't need to be a read-modify-write
+    void bump(uint32_t unit) {
+        auto& generation = m_generations[unit];
+        generation.store(generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // How many times something was written over each block; a block is only valid for the generation it was
+    // decoded from, and checking it before decoding means a write happening in the meantime can't go unnoticed.
+    std::unique_ptr<std::atomic<uint32_t>[]> m_generations;
+    std::unique_ptr<Entry[]> m_entries;
+    std::atomic<uint64_t> m_hits = 0;
+    std::atomic<uint64_t> m_misses = 0;
+};
+
+}  // namespace SPU
+
+}  // namespace PCSX
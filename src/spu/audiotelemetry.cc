@@ -0,0 +1,87 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/audiotelemetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+unsigned PCSX::SPU::RollingStat::binFor(uint32_t value) {
+    return std::min<unsigned>(std::bit_width(value), c_bins - 1);
+}
+
+PCSX::SPU::RollingStat::Snapshot PCSX::SPU::RollingStat::snapshot() const {
+    Snapshot snapshot;
+    const uint32_t index = m_index.load(std::memory_order_acquire);
+    const uint32_t count = std::min(index, c_samples);
+    if (count == 0) return snapshot;
+
+    std::vector<uint32_t> values(count);
+    for (uint32_t i = 0; i < count; i++) {
+        values[i] = m_values[(index - count + i) % c_samples].load(std::memory_order_relaxed);
+    }
+
+    uint64_t total = 0;
+    for (auto value : values) {
+        total += value;
+        snapshot.histogram[binFor(value)]++;
+    }
+    snapshot.count = count;
+    snapshot.mean = static_cast<double>(total) / count;
+
+    std::sort(values.begin(), values.end());
+    snapshot.min = values.front();
+    snapshot.max = values.back();
+    snapshot.p50 = values[(count - 1) / 2];
+    snapshot.p99 = values[(count - 1) * 99 / 100];
+    return snapshot;
+}
+
+void PCSX::SPU::AudioTelemetry::reset() {
+    bufferFill.reset();
+    cdBufferFill.reset();
+    latency.reset();
+    goalWait.reset();
+    mixTime.reset();
+    m_underruns.store(0, std::memory_order_relaxed);
+    m_underrunFrames.store(0, std::memory_order_relaxed);
+}
+
+nlohmann::json PCSX::SPU::AudioTelemetry::toJson() const {
+    auto statToJson = [](const RollingStat& stat) {
+        const auto snapshot = stat.snapshot();
+        nlohmann::json histogram = nlohmann::json::array();
+        for (unsigned bin = 0; bin < RollingStat::c_bins; bin++) {
+            histogram.push_back({{"from", RollingStat::binStart(bin)}, {"count", snapshot.histogram[bin]}});
+        }
+        return nlohmann::json({{"count", snapshot.count},
+                               {"min", snapshot.min},
+                               {"max", snapshot.max},
+                               {"mean", snapshot.mean},
+                               {"p50", snapshot.p50},
+                               {"p99", snapshot.p99},
+                               {"histogram", histogram}});
+    };
+
+    return {{"bufferFill", statToJson(bufferFill)}, {"cdBufferFill", statToJson(cdBufferFill)},
+            {"latency", statToJson(latency)},       {"goalWait", statToJson(goalWait)},
+            {"mixTime", statToJson(mixTime)},       {"underruns", underruns()},
+            {"underrunFrames", underrunFrames()}};
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "json.hpp"
+
+namespace PCSX {
+
+namespace SPU {
+
+// Keeps the last c_samples values of a measurement, so that their distribution can be looked at while the
+// emulator runs. Only one thread may be adding values to a given stat, but any thread can take a snapshot;
+// the snapshot may then be slightly off, which is fine for what this is used for.
+class RollingStat {
+  public:
+    static constexpr unsigned c_samples = 4096;
+    // Bin 0 is for the value 0, and bin n for the values in [2^(n-1), 2^n), the last one being open ended.
+    static constexpr unsigned c_bins = 20;
+
+    struct Snapshot {
+        uint32_t count = 0;
+        uint32_t min = 0;
+        uint32_t max = 0;
+        double mean = 0.0;
+        uint32_t p50 = 0;
+        uint32_t p99 = 0;
+        std::array<uint32_t, c_bins> histogram = {};
+    };
+
+    RollingStat() : m_values(new std::atomic<uint32_t>[c_samples]) {}
+
+    void add(uint32_t value) {
+        const uint32_t index = m_index.load(std::memory_order_relaxed);
+        m_values[index % c_samples].store(value, std::memory_order_relaxed);
+        m_index.store(index + 1, std::memory_order_release);
+    }
+    // Racing with add(), this may not drop everything, but nothing worse happens.
+    void reset() { m_index.store(0, std::memory_order_release); }
+
+    Snapshot snapshot() const;
+    static unsigned binFor(uint32_t value);
+    // The smallest value going into this bin.
+    static uint32_t binStart(unsigned bin) { return bin == 0 ? 0 : 1u << (bin - 1); }
+
+  private:
+    std::unique_ptr<std::atomic<uint32_t>[]> m_values;
+    std::atomic<uint32_t> m_index = 0;
+};
+
+// What the audio output looks like from the host side, to help with picking buffer sizes. Durations are in
+// microseconds unless noted otherwise, and buffer levels in frames, that is, 44.1kHz stereo samples.
+class AudioTelemetry {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // Frames waiting in the voices stream, every time the audio device asks for more. This getting close to
+    // zero means the output is about to underrun.
+    RollingStat bufferFill;
+    // Same, for the CD audio stream; this one runs dry whenever no CD audio is playing.
+    RollingStat cdBufferFill;
+    // How long the frames the mixer just produced will wait before being played, when they get queued.
+    RollingStat latency;
+    // How long the emulation got blocked, waiting for the audio device to catch up with it.
+    RollingStat goalWait;
+    // How long mixing 1ms worth of audio takes, in nanoseconds.
+    RollingStat mixTime;
+
+    // Audio device callbacks which didn't get all of the voice frames they needed, and the frames missing.
+    void addUnderrun(uint32_t frames) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        m_underrunFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+    uint64_t underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+    uint64_t underrunFrames() const { return m_underrunFrames.load(std::memory_order_relaxed); }
+
+    static uint32_t microseconds(Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
+    // Scales the time it took to mix this many frames to what it'd be for 1ms of audio.
+    static uint32_t mixTimePerMs(Clock::duration duration, unsigned frames) {
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        return frames ? ns * 441 / (frames * 10) : 0;
+    }
+
+    void reset();
+    nlohmann::json toJson() const;
+
+  private:
+    std::atomic<uint64_t> m_underruns = 0;
+    std::atomic<uint64_t> m_underrunFrames = 0;
+};
+
+}  // namespace SPU
+
+}  // namespace PCSX
@@ -71,6 +71,13 @@ XA audio and audio tracks.)"));
     changed |= ImGui::Combo(_("Volume"), &settings.get<Volume>().value, volumeValues, IM_ARRAYSIZE(volumeValues));
     ImGuiHelpers::ShowHelpMarker(_(R"(Attempts to make the CPU-to-SPU audio stream
 in sync, by changing its pitch. Consumes more CPU.)"));
+    changed |= ImGui::Checkbox(_("Synchronous mixing"), &settings.get<Synchronous>().value);
+    ImGuiHelpers::ShowHelpMarker(_(R"(Mixes the audio on the emulation thread, as the
+emulated cycles go, instead of on a thread of its own.
+Lowers the latency, and makes the audio and SPU IRQs
+reproducible from one run to the next, including
+headless and fast forwarded ones.
+Takes effect on the next start.)"));
     changed |= ImGui::Checkbox(_("Pause SPU waiting for CPU IRQ"), &settings.get<SPUIRQWait>().value);
     ImGuiHelpers::ShowHelpMarker(_(R"(Suspends the SPU processing during an IRQ, waiting
 for the main CPU to acknowledge it. Fixes issues
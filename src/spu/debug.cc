@@ -17,6 +17,9 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <cfloat>
+#include <cinttypes>
+
 #include "core/system.h"
 #include "imgui.h"
 #include "spu/interface.h"
@@ -540,6 +543,80 @@ void DrawSectionXa(const xa_decode_t* xapGlobal, const int iLeftXAVol, const int
     }
 }
 
+void DrawSectionADPCMCache(ADPCMCache& cache) {
+    if (ImGui::CollapsingHeader("ADPCM cache", ImGuiTreeNodeFlags_DefaultOpen)) {
+        const uint64_t hits = cache.hits();
+        const uint64_t misses = cache.misses();
+        if (ImGui::BeginTable("SpuADPCMCache", 3, BasicTableFlags)) {
+            ImGui::TableSetupColumn("Hits", 0, BasicTableColumnWidth);
+            ImGui::TableSetupColumn("Misses", 0, BasicTableColumnWidth);
+            ImGui::TableSetupColumn("Hit rate", 0, BasicTableColumnWidth);
+            ImGui::TableHeadersRow();
+            // @formatter:off
+            ImGui::TableNextColumn();
+            ImGui::Text("%" PRIu64, hits);
+            ImGui::TableNextColumn();
+            ImGui::Text("%" PRIu64, misses);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0);
+            // @formatter:on
+            ImGui::EndTable();
+        }
+        if (ImGui::Button(_("Reset counters"))) cache.resetCounters();
+    }
+}
+
+void DrawSectionAudioTelemetry(AudioTelemetry& telemetry) {
+    if (ImGui::CollapsingHeader("Audio output", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Text(_("Underruns: %" PRIu64 " (%" PRIu64 " frames)"), telemetry.underruns(),
+                    telemetry.underrunFrames());
+        if (ImGui::BeginTable("SpuAudioTelemetry", 8, BasicTableFlags)) {
+            ImGui::TableSetupColumn("Measurement", 0, BasicTableColumnWidth);
+            ImGui::TableSetupColumn("Unit", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("Min", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("Mean", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("Median", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("99%", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("Max", 0, BasicTableColumnWidth / 2);
+            ImGui::TableSetupColumn("Histogram (log2)", 0, BasicTableColumnWidth);
+            ImGui::TableHeadersRow();
+            auto row = [](const char* name, const char* unit, const RollingStat& stat) {
+                const auto snapshot = stat.snapshot();
+                float histogram[RollingStat::c_bins];
+                for (unsigned bin = 0; bin < RollingStat::c_bins; bin++) histogram[bin] = snapshot.histogram[bin];
+                // @formatter:off
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(unit);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", snapshot.min);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", snapshot.mean);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", snapshot.p50);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", snapshot.p99);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", snapshot.max);
+                ImGui::TableNextColumn();
+                ImGui::PushID(name);
+                ImGui::PlotHistogram("##histogram", histogram, RollingStat::c_bins, 0, nullptr, 0.0f, FLT_MAX,
+                                     ImVec2(BasicTableColumnWidth, ImGui::GetTextLineHeight()));
+                ImGui::PopID();
+                // @formatter:on
+            };
+            row("Voices buffer", "frames", telemetry.bufferFill);
+            row("CD audio buffer", "frames", telemetry.cdBufferFill);
+            row("Latency", "us", telemetry.latency);
+            row("Throttling wait", "us", telemetry.goalWait);
+            row("Mixing 1ms", "ns", telemetry.mixTime);
+            ImGui::EndTable();
+        }
+        if (ImGui::Button(_("Reset telemetry"))) telemetry.reset();
+    }
+}
+
 }  // namespace
 
 void impl::debug() {
@@ -587,6 +664,8 @@ void impl::debug() {
 
     DrawSectionSpu(spuCtrl, spuStat, spuAddr, spuMemC, pSpuIrq);
     DrawSectionXa(xapGlobal, iLeftXAVol, iRightXAVol);
+    DrawSectionADPCMCache(m_adpcmCache);
+    DrawSectionAudioTelemetry(m_audioOut.getTelemetry());
     DrawSectionChannels(s_chan, m_channelTag, m_channelDebugData, spuMemC);
 
     ImGui::End();
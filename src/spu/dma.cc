@@ -29,13 +29,10 @@
 
 // SPU RAM -> Main RAM DMA
 void PCSX::SPU::impl::readDMAMem(uint16_t* mainMem, int size) {
-    if (pMixIrq) cbMtx.lock();
-
     for (int i = 0; i < size; i++) {
         *mainMem++ = spuMem[spuAddr >> 1];  // Copy 2 bytes
         spuAddr = (spuAddr + 2) & 0x7ffff;  // Increment SPU address and wrap around
     }
-    if (pMixIrq) cbMtx.unlock();
     iSpuAsyncWait = 0;
 }
 
@@ -43,9 +40,6 @@ void PCSX::SPU::impl::readDMAMem(uint16_t* mainMem, int size) {
 // irqs? Will an irq be triggered, if new data is written to
 // the memory irq address?
 
-void PCSX::SPU::impl::lockSPURAM() { cbMtx.lock(); }
-void PCSX::SPU::impl::unlockSPURAM() { cbMtx.unlock(); }
-
 void PCSX::SPU::impl::resetCaptureBuffer() {
     if (settings.get<DBufIRQ>().value) pMixIrq = spuMemC;  // enable decoded buffer irqs by setting the address
     memset(captureBuffer.CDCapLeft, 0, CaptureBuffer::CB_SIZE);
@@ -58,13 +52,30 @@ void PCSX::SPU::impl::resetCaptureBuffer() {
 
 // Main RAM -> SPU RAM DMA
 void PCSX::SPU::impl::writeDMAMem(uint16_t* mainMem, int size) {
-    if (pMixIrq) cbMtx.lock();
-
     for (int i = 0; i < size; i++) {
         spuMem[spuAddr >> 1] = *mainMem++;  // Copy 2 bytes
+        m_adpcmCache.invalidate(spuAddr);
+        m_dirtyRAM.mark(spuAddr);
         spuAddr = (spuAddr + 2) & 0x7ffff;  // Increment SPU address and wrap around
     }
 
-    if (pMixIrq) cbMtx.unlock();
     iSpuAsyncWait = 0;
 }
+
+PCSX::DirtyPages& PCSX::SPU::impl::getDirtyRAM() {
+    // The mixer writes the decoded CD audio and voices 1 and 3 to the first 4KB all the time, and the reverb
+    // goes around its work area, which spans from its start address to the end of SPU RAM.
+    m_dirtyRAM.mark(0);
+    if ((m_reverb == 2) && rvb.StartAddr) {
+        const uint32_t start = uint32_t(rvb.StartAddr) * 2;
+        if (start < c_ramSize) m_dirtyRAM.markRange(start, c_ramSize - start);
+    }
+    return m_dirtyRAM;
+}
+
+void PCSX::SPU::impl::writeRAM(uint32_t offset, const uint8_t* data, uint32_t size) {
+    if ((offset >= c_ramSize) || (size > c_ramSize - offset)) return;
+    memcpy(spuMemC + offset, data, size);
+    for (uint32_t address = offset & ~7; address < offset + size; address += 8) m_adpcmCache.invalidate(address);
+    m_dirtyRAM.markRange(offset, size);
+}
@@ -33,6 +33,8 @@
 //
 //*************************************************************************//
 
+#include <string.h>
+
 #include "spu/externals.h"
 #include "spu/interface.h"
 #include "spu/registers.h"
@@ -93,6 +95,33 @@ void PCSX::SPU::impl::save(SaveStates::SPU &spu) {
 void PCSX::SPU::impl::load(const SaveStates::SPU &spu) {
     RemoveThread();  // we stop processing while doing the save!
 
+    spu.get<SaveStates::SPURam>().copyTo(reinterpret_cast<uint8_t *>(spuMem));
+    m_adpcmCache.clear();
+    m_dirtyRAM.markAll();
+    restore(spu);
+
+    SetupThread();  // start sound processing again
+}
+
+void PCSX::SPU::impl::rollback(const SaveStates::SPU &spu) {
+    RemoveThread();
+
+    const uint8_t *ram = spu.get<SaveStates::SPURam>().value;
+    if (ram) {
+        auto &dirty = getDirtyRAM();
+        const uint32_t pageSize = dirty.pageSize();
+        dirty.forEachDirty([&](uint32_t page) { writeRAM(page * pageSize, ram + page * pageSize, pageSize); });
+    } else {
+        memset(spuMem, 0, c_ramSize);
+        m_adpcmCache.clear();
+        m_dirtyRAM.markAll();
+    }
+    restore(spu);
+
+    SetupThread();
+}
+
+void PCSX::SPU::impl::restore(const SaveStates::SPU &spu) {
     spu.get<SaveStates::CBCDLeft>().copyTo(reinterpret_cast<uint8_t *>(captureBuffer.CDCapLeft));
     spu.get<SaveStates::CBCDRight>().copyTo(reinterpret_cast<uint8_t *>(captureBuffer.CDCapRight));
     captureBuffer.currIndex = spu.get<SaveStates::CBCurrIndex>().value;
@@ -100,7 +129,6 @@ void PCSX::SPU::impl::load(const SaveStates::SPU &spu) {
     captureBuffer.startIndex = spu.get<SaveStates::CBStartIndex>().value;
     capBufVoiceIndex = spu.get<SaveStates::CBVoiceIndex>().value;
 
-    spu.get<SaveStates::SPURam>().copyTo(reinterpret_cast<uint8_t *>(spuMem));
     spu.get<SaveStates::SPUPorts>().copyTo(reinterpret_cast<uint8_t *>(regArea));
 
 #if 0
@@ -161,6 +189,4 @@ void PCSX::SPU::impl::load(const SaveStates::SPU &spu) {
             writeRegister(0x1f801c00 + (i << 4) + 0xca, regArea[(i << 3) + 0x65]);
         }
     }
-
-    SetupThread();  // start sound processing again
 }
@@ -21,15 +21,19 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <thread>
 
 #include "core/decode_xa.h"
 #include "core/spu.h"
 #include "core/sstate.h"
 #include "json.hpp"
+#include "spu/adpcmcache.h"
 #include "spu/adsr.h"
 #include "spu/miniaudio.h"
+#include "spu/reverbmix.h"
 #include "spu/types.h"
+#include "spu/voicemix.h"
 #include "support/settings.h"
 
 namespace PCSX {
@@ -48,8 +52,6 @@ class impl final : public SPUInterface {
     // void playSample(uint8_t);
     void writeRegister(uint32_t, uint16_t) final;
     uint16_t readRegister(uint32_t) final;
-    void lockSPURAM() final;
-    void unlockSPURAM() final;
     void resetCaptureBuffer() final;
     void writeDMAMem(uint16_t *, int) final;
     void readDMAMem(uint16_t *, int) final;
@@ -57,6 +59,7 @@ class impl final : public SPUInterface {
 
     void save(SaveStates::SPU &) final;
     void load(const SaveStates::SPU &) final;
+    void rollback(const SaveStates::SPU &) final;
 
     virtual void setLua(Lua L) override;
 
@@ -85,6 +88,18 @@ class impl final : public SPUInterface {
     }
     uint32_t getCurrentFrames() override { return m_audioOut.getCurrentFrames(); }
     void waitForGoal(uint32_t goal) override { m_audioOut.waitForGoal(goal); }
+    json getAudioTelemetry() override { return m_audioOut.getTelemetry().toJson(); }
+    void resetAudioTelemetry() override { m_audioOut.getTelemetry().reset(); }
+    void setAudioSuppressed(bool suppressed) override { m_audioOut.setSuppressed(suppressed); }
+    void prepareFork() override { RemoveThread(); }
+    void afterFork(bool child) override {
+        if (child) m_audioOut.detach();
+        SetupThread();
+    }
+
+    DirtyPages &getDirtyRAM() final;
+    const uint8_t *getRAM() final { return spuMemC; }
+    void writeRAM(uint32_t offset, const uint8_t *data, uint32_t size) final;
 
   private:
     struct ADSRFlags {
@@ -154,14 +169,20 @@ class impl final : public SPUInterface {
 
     // ~ 1 ms of data
     static const size_t NSSIZE = 45;
+    // the SPU outputs one sample every 768 CPU cycles, at 44100Hz
+    static const uint32_t CYCLES_PER_SAMPLE = 768;
 
     // spu
     void MainThread();
+    void mixSamples(int count);
+    void pushCaptureBufferCD(int16_t left, int16_t right);
     void writeCaptureBufferCD(int numbSamples);
     void SetupStreams();
     void RemoveStreams();
     void SetupThread();
     void RemoveThread();
+    // Everything of a save state but SPU RAM, for load() and rollback()
+    void restore(const SaveStates::SPU &);
     void StartSound(SPUCHAN *pChannel);
     void VoiceChangeFrequency(SPUCHAN *pChannel);
     void FModChangeFrequency(SPUCHAN *pChannel, int ns);
@@ -181,15 +202,11 @@ class impl final : public SPUInterface {
     void ReverbOn(int start, int end, uint16_t val);
 
     // reverb
-    int g_buffer(int iOff);              // get_buffer content helper: takes care about wraps
-    void s_buffer(int iOff, int iVal);   // set_buffer content helper: takes care about wraps and clipping
-    void s_buffer1(int iOff, int iVal);  // set_buffer (+1 sample) content helper: takes care about wraps and clipping
     void InitREVERB();
     void SetREVERB(uint16_t val);
     void StartREVERB(SPUCHAN *pChannel);
     void StoreREVERB(SPUCHAN *pChannel, int ns);
-    int MixREVERBLeft(int ns);
-    int MixREVERBRight();
+    void MixREVERB(int count);
 
     // xa
     void FeedXA(xa_decode_t *xap);
@@ -204,6 +221,10 @@ class impl final : public SPUInterface {
     uint8_t *pSpuIrq = 0;
     uint8_t *pSpuBuffer;
     uint8_t *pMixIrq = 0;
+    // decoded ADPCM blocks; anything writing to spuMem from outside of the mixer has to invalidate it
+    ADPCMCache m_adpcmCache;
+    // only marked from outside of the mixer, see getDirtyRAM()
+    DirtyPages m_dirtyRAM = DirtyPages(c_ramSize);
 
     struct CaptureBuffer {
         static const int CB_SIZE = 1024 * 16;
@@ -211,11 +232,12 @@ class impl final : public SPUInterface {
         uint16_t CDCapLeft[CB_SIZE] = {0};
         uint16_t CDCapRight[CB_SIZE] = {0};
 
-        int32_t startIndex = 0;
-        int32_t endIndex = 0;
+        // The CD side is the only one moving endIndex forward, and the mixer is the only one moving startIndex
+        // forward, so neither needs to lock: each one publishes its own index after being done with the samples.
+        std::atomic<int32_t> startIndex = 0;
+        std::atomic<int32_t> endIndex = 0;
         int32_t currIndex = 0;
     };
-    std::mutex cbMtx;
 
     // The temporary cap buffer for CD Audio left/right.
     CaptureBuffer captureBuffer;
@@ -224,6 +246,12 @@ class impl final : public SPUInterface {
 
     // user settings
     SettingsType settings;
+    // What the mixer reads from the settings, as it may be running on a thread of its own.
+    SettingObserver<Volume> m_volume = {settings.get<Volume>()};
+    SettingObserver<Reverb> m_reverb = {settings.get<Reverb>()};
+    SettingObserver<Interpolation> m_interpolation = {settings.get<Interpolation>()};
+    SettingObserver<Streaming> m_streaming = {settings.get<Streaming>()};
+    SettingObserver<SPUIRQWait> m_irqWait = {settings.get<SPUIRQWait>()};
 
     // MAIN infos struct for each channel
 
@@ -253,9 +281,18 @@ class impl final : public SPUInterface {
     int SSumR[NSSIZE];
     int SSumL[NSSIZE];
     int iFMod[NSSIZE];
+    // the voices' output for the current chunk, laid out for the mixing kernel to do all of them at once
+    static_assert(MAXCHAN == VoiceMix::c_voices);
+    VoiceMix::VoiceSamples m_voiceSamples[NSSIZE];
+    int32_t m_voiceLeft[MAXCHAN] = {};
+    int32_t m_voiceRight[MAXCHAN] = {};
+    const VoiceMix::MixKernel m_voiceMix = VoiceMix::getMixKernel();
     int iCycle = 0;
     int16_t *pS;
 
+    bool m_synchronous = false;  // mixing from async() on the emulation thread, instead of from MainThread
+    uint32_t m_syncCycles = 0;   // cycles elapsed in synchronous mode, not yet worth a sample
+
     int lastch = -1;       // last channel processed on spu irq in timer mode
     int lastns = 0;        // last ns pos
     int iSecureStart = 0;  // secure start counter
@@ -269,6 +306,8 @@ class impl final : public SPUInterface {
     int iReverbOff = -1;  // some delay factor for reverb
     int iReverbRepeat = 0;
     int iReverbNum = 1;
+    int m_reverbCounter = 0;  // Neill's reverb only steps on every other 44.1kHz sample
+    const ReverbMix::MixKernel m_reverbMix = ReverbMix::getMixKernel();
 
     // XA
     xa_decode_t *xapGlobal = 0;
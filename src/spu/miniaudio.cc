@@ -19,11 +19,14 @@
 
 #include "spu/miniaudio.h"
 
+#include <algorithm>
 #include <limits>
 #include <stdexcept>
 
+#include "core/arguments.h"
 #include "core/system.h"
 #include "spu/interface.h"
+#include "tracy/Tracy.hpp"
 
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio/miniaudio.h"
@@ -36,7 +39,19 @@ PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
             m_backends.push_back(ma_get_backend_name(b));
         }
     }
+    auto audioDumpPath = g_system->getArgs().getAudioDumpPath();
+    if (!audioDumpPath.empty()) {
+        IO<File> file(new PosixFile(audioDumpPath, FileOps::TRUNCATE));
+        if (file->failed()) {
+            g_system->printf(_("Unable to open %s to dump audio into it\n"), std::string(audioDumpPath).c_str());
+        } else {
+            m_fileSink.open(file);
+        }
+    }
+    // Same as when forked: nothing to play the audio into, and nothing to wait for
+    if (!m_fileSink.isOpen() && g_system->getArgs().isUnthrottled()) m_detached = true;
     m_listener.listen<Events::ExecutionFlow::Run>([this](const auto& event) {
+        if (isOffline()) return;
         if (ma_device_start(&m_device) != MA_SUCCESS) {
             uninit();
             init(true);
@@ -47,6 +62,10 @@ PCSX::SPU::MiniAudio::MiniAudio(PCSX::SPU::SettingsType& settings)
         }
     });
     m_listener.listen<Events::ExecutionFlow::Pause>([this](const auto& event) {
+        if (isOffline()) {
+            if (!m_detached) m_fileSink.flush();
+            return;
+        }
         if (ma_device_stop(&m_device) != MA_SUCCESS) {
             throw std::runtime_error("Unable to stop audio device");
         };
@@ -166,7 +185,7 @@ void PCSX::SPU::MiniAudio::uninit() {
 }
 
 void PCSX::SPU::MiniAudio::maybeRestart() {
-    if (!g_system->running()) return;
+    if (!g_system->running() || isOffline()) return;
 
     if (ma_device_start(&m_device) != MA_SUCCESS) {
         uninit();
@@ -182,17 +201,22 @@ void PCSX::SPU::MiniAudio::callback(ma_device* device, float* output, ma_uint32
     if (frameCount > VoiceStream::BUFFER_SIZE) {
         throw std::runtime_error("Too many frames requested by miniaudio");
     }
-    static std::array<Buffer, STREAMS> buffers;
-    const bool mono = m_settings.get<Mono>();
-    const bool muted = m_settings.get<Mute>();
+    // each audio device, of each emulator, runs its callback from a thread of its own
+    thread_local std::array<Buffer, STREAMS> buffers;
+    const bool mono = m_mono;
+    const bool muted = m_mute;
 
     static_assert(STREAMS == 2);
 
+    m_telemetry.bufferFill.add(m_voicesStream.buffered());
+    m_telemetry.cdBufferFill.add(m_audioStream.buffered());
+    TracyPlot("Audio buffer fill", int64_t(m_voicesStream.buffered()));
     for (unsigned i = 0; i < STREAMS; i++) {
         size_t a = i == 0 ? m_voicesStream.dequeue(buffers[i].data(), frameCount)
                           : m_audioStream.dequeue(buffers[i].data(), frameCount);
+        // it's fine if stream 1 (cdda) runs dry, as it does whenever nothing is playing
+        if ((i == 0) && (a < frameCount)) m_telemetry.addUnderrun(frameCount - a);
         for (size_t f = (muted ? 0 : a); f < frameCount; f++) {
-            // maybe warn about underflow? tho it's fine if it happens on stream 1 (cdda)
             buffers[i][f] = {};
         }
     }
@@ -243,3 +267,24 @@ void PCSX::SPU::MiniAudio::callbackNull(ma_device* device, float* output, ma_uin
     m_cv.notify_one();
 #endif
 }
+
+void PCSX::SPU::MiniAudio::writeOffline(const Frame* data, size_t frames) {
+    while (frames) {
+        const size_t count = std::min(frames, m_offlineBuffer.size());
+        // the CD audio stream may run dry, which is fine, and happens all the time when nothing is playing
+        const size_t audio = m_audioStream.dequeue(m_offlineBuffer.data(), count);
+        for (size_t f = 0; f < count; f++) {
+            const int l = data[f].L + (f < audio ? m_offlineBuffer[f].L : 0);
+            const int r = data[f].R + (f < audio ? m_offlineBuffer[f].R : 0);
+            m_offlineBuffer[f].L = std::clamp<int>(l, std::numeric_limits<int16_t>::min(),
+                                                   std::numeric_limits<int16_t>::max());
+            m_offlineBuffer[f].R = std::clamp<int>(r, std::numeric_limits<int16_t>::min(),
+                                                   std::numeric_limits<int16_t>::max());
+        }
+        m_fileSink.write(reinterpret_cast<const int16_t*>(m_offlineBuffer.data()), count);
+        // the emulation paces itself on this, and will simply never have to wait for it
+        m_frames.fetch_add(count);
+        data += count;
+        frames -= count;
+    }
+}
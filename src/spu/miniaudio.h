@@ -23,6 +23,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -35,7 +36,9 @@
 #define MA_NO_WAV
 
 #include "miniaudio/miniaudio.h"
+#include "spu/audiotelemetry.h"
 #include "spu/settings.h"
+#include "spu/wavsink.h"
 #include "support/circular.h"
 #include "support/eventbus.h"
 
@@ -63,13 +66,31 @@ class MiniAudio {
     }
     const std::vector<std::string>& getBackends() { return m_backends; }
     const std::vector<std::string>& getDevices() { return m_devices; }
-    bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0) {
+    // When dumping audio to a file, nothing goes to the audio devices, and the emulation isn't throttled: the
+    // SPU needs to be mixing synchronously, so that the output still follows the emulated time.
+    bool isOffline() const { return m_detached || m_fileSink.isOpen(); }
+    // For a forked emulator: the audio devices, and the file audio gets dumped into, are its parent's. From
+    // then on, everything mixed gets thrown away, and the emulation isn't throttled anymore.
+    void detach() { m_detached = true; }
+    bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0,
+                        std::chrono::milliseconds maxWait = std::chrono::milliseconds{200}) {
+        if (m_detached || m_suppressed.load(std::memory_order_relaxed)) return true;
         switch (streamId) {
             case 0:
-                return m_voicesStream.enqueue(data, frames);
+                if (isOffline()) {
+                    writeOffline(data, frames);
+                    return true;
+                }
+                if (!m_voicesStream.enqueue(data, frames, maxWait)) return false;
+                // the last of these frames only gets played once everything queued before it has been, and
+                // the audio device only comes for more one period at a time
+                m_telemetry.latency.add(framesToMicroseconds(m_voicesStream.buffered() + m_frameCount.load()));
+                return true;
                 break;
             case 1:
-                return m_audioStream.enqueue(data, frames);
+                // the voices are what drains this stream when offline, and they're mixed from the same thread
+                if (isOffline()) maxWait = std::chrono::milliseconds{0};
+                return m_audioStream.enqueue(data, frames, maxWait);
                 break;
             default:
                 throw std::runtime_error("Invalid stream ID");
@@ -91,6 +112,17 @@ class MiniAudio {
     }
     uint32_t getCurrentFrames() { return m_frames.load(); }
     void waitForGoal(uint32_t goal) {
+        if (isOffline()) return;
+        const auto start = AudioTelemetry::Clock::now();
+        waitForGoalInternal(goal);
+        m_telemetry.goalWait.add(AudioTelemetry::microseconds(AudioTelemetry::Clock::now() - start));
+    }
+    AudioTelemetry& getTelemetry() { return m_telemetry; }
+    void setSuppressed(bool suppressed) { m_suppressed.store(suppressed, std::memory_order_relaxed); }
+
+  private:
+    static uint32_t framesToMicroseconds(size_t frames) { return frames * 1000000 / WavSink::c_sampleRate; }
+    void waitForGoalInternal(uint32_t goal) {
 #if HAS_ATOMIC_WAIT
         // for once, Visual Studio is better than clang/gcc/libc++/libstdc++. Its C++20
         // support contain the appropriate wait/notify on atomics, so we can do this:
@@ -106,14 +138,17 @@ class MiniAudio {
 #endif
     }
 
-  private:
     static constexpr unsigned STREAMS = 2;
     SettingsType& m_settings;
+    // Read by the audio callbacks, from threads of their own.
+    SettingObserver<Mono> m_mono = {m_settings.get<Mono>()};
+    SettingObserver<Mute> m_mute = {m_settings.get<Mute>()};
     void callback(ma_device* device, float* output, ma_uint32 frameCount);
     void callbackNull(ma_device* device, float* output, ma_uint32 frameCount);
     void init(bool safe = false);
     void uninit();
     void maybeRestart();
+    void writeOffline(const Frame* data, size_t frames);
 
     ma_context m_context;
     ma_device_config m_config;
@@ -123,9 +158,10 @@ class MiniAudio {
     ma_device m_deviceNull;
     EventBus::Listener m_listener;
 
-    typedef Circular<Frame, 2 * 1024> VoiceStream;
+    // Drained by the audio callback, which mustn't wait on the threads mixing into them
+    typedef CircularSPSC<Frame, 2 * 1024> VoiceStream;
     VoiceStream m_voicesStream;
-    Circular<Frame, 16 * 1024> m_audioStream;
+    CircularSPSC<Frame, 16 * 1024> m_audioStream;
     typedef std::array<Frame, VoiceStream::BUFFER_SIZE> Buffer;
     std::atomic<uint32_t> m_frames = 0;
 #if HAS_ATOMIC_WAIT
@@ -143,6 +179,14 @@ class MiniAudio {
     std::vector<std::string> m_devices;
 
     std::atomic<ma_uint32> m_frameCount;
+    // Set while emulating frames which are going to be thrown away, such as when running ahead
+    std::atomic<bool> m_suppressed = false;
+    bool m_detached = false;
+
+    WavSink m_fileSink;
+    Buffer m_offlineBuffer;
+
+    AudioTelemetry m_telemetry;
 };
 
 }  // namespace SPU
@@ -218,6 +218,8 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
 
         case H_SPUdata:
             spuMem[spuAddr >> 1] = val;
+            m_adpcmCache.invalidate(spuAddr);
+            m_dirtyRAM.mark(spuAddr);
             spuAddr += 2;
             if (spuAddr > 0x7ffff) {
                 spuAddr = 0;
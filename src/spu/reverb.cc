@@ -102,9 +102,9 @@ void PCSX::SPU::impl::SetREVERB(unsigned short val) {
 void PCSX::SPU::impl::StartREVERB(SPUCHAN *pChannel) {
     if (pChannel->data.get<Chan::Reverb>().value && (spuCtrl & ControlFlags::ReverbMasterEnable))  // reverb possible?
     {
-        if (settings.get<Reverb>() == 2)
+        if (m_reverb == 2)
             pChannel->data.get<Chan::RVBActive>().value = true;
-        else if (settings.get<Reverb>() == 1 && iReverbOff > 0)  // -> fake reverb used?
+        else if (m_reverb == 1 && iReverbOff > 0)  // -> fake reverb used?
         {
             pChannel->data.get<Chan::RVBActive>().value = true;  // -> activate it
             pChannel->data.get<Chan::RVBOffset>().value = iReverbOff * 45;
@@ -120,7 +120,7 @@ void PCSX::SPU::impl::StartREVERB(SPUCHAN *pChannel) {
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::InitREVERB() {
-    if (settings.get<Reverb>() == 2) {
+    if (m_reverb == 2) {
         memset(sRVBStart, 0, NSSIZE * 2 * 4);
     }
 }
@@ -130,9 +130,9 @@ void PCSX::SPU::impl::InitREVERB() {
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::StoreREVERB(SPUCHAN *pChannel, int ns) {
-    if (settings.get<Reverb>() == 0)
+    if (m_reverb == 0)
         return;
-    else if (settings.get<Reverb>() == 2)  // -------------------------------- // Neil's reverb
+    else if (m_reverb == 2)  // -------------------------------- // Neil's reverb
     {
         const int iRxl =
             (pChannel->data.get<Chan::sval>().value * pChannel->data.get<Chan::LeftVolume>().value) / 0x4000;
@@ -167,162 +167,23 @@ void PCSX::SPU::impl::StoreREVERB(SPUCHAN *pChannel, int ns) {
 
 ////////////////////////////////////////////////////////////////////////
 
-inline int PCSX::SPU::impl::g_buffer(int iOff)  // get_buffer content helper: takes care about wraps
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    return (int)*(p + iOff);
-}
-
-////////////////////////////////////////////////////////////////////////
-
-inline void PCSX::SPU::impl::s_buffer(int iOff,
-                                      int iVal)  // set_buffer content helper: takes care about wraps and clipping
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    if (iVal < -32768L) iVal = -32768L;
-    if (iVal > 32767L) iVal = 32767L;
-    *(p + iOff) = (short)iVal;
-}
-
-////////////////////////////////////////////////////////////////////////
-
-inline void PCSX::SPU::impl::s_buffer1(
-    int iOff, int iVal)  // set_buffer (+1 sample) content helper: takes care about wraps and clipping
-{
-    short *p = (short *)spuMem;
-    iOff = (iOff * 4) + rvb.CurrAddr + 1;
-    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
-    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
-    if (iVal < -32768L) iVal = -32768L;
-    if (iVal > 32767L) iVal = 32767L;
-    *(p + iOff) = (short)iVal;
-}
-
-////////////////////////////////////////////////////////////////////////
-int PCSX::SPU::impl::MixREVERBLeft(int ns) {
-    if (settings.get<Reverb>() == 0)
-        return 0;
-    else if (settings.get<Reverb>() == 2) {
-        static int iCnt = 0;  // this func will be called with 44.1 khz
-
-        if (!rvb.StartAddr)  // reverb is off
-        {
-            rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
-            return 0;
-        }
-
-        iCnt++;
-
-        if (iCnt & 1)  // we work on every second left value: downsample to 22 khz
-        {
-            if (spuCtrl & ControlFlags::ReverbMasterEnable)  // -> reverb on? oki
-            {
-                int ACC0, ACC1, FB_A0, FB_A1, FB_B0, FB_B1;
-
-                const int INPUT_SAMPLE_L = *(sRVBStart + (ns << 1));
-                const int INPUT_SAMPLE_R = *(sRVBStart + (ns << 1) + 1);
-
-                const int IIR_INPUT_A0 =
-                    (g_buffer(rvb.IIR_SRC_A0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
-                const int IIR_INPUT_A1 =
-                    (g_buffer(rvb.IIR_SRC_A1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
-                const int IIR_INPUT_B0 =
-                    (g_buffer(rvb.IIR_SRC_B0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
-                const int IIR_INPUT_B1 =
-                    (g_buffer(rvb.IIR_SRC_B1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
-
-                const int IIR_A0 = (IIR_INPUT_A0 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_A0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_A1 = (IIR_INPUT_A1 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_A1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_B0 = (IIR_INPUT_B0 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_B0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-                const int IIR_B1 = (IIR_INPUT_B1 * rvb.IIR_ALPHA) / 32768L +
-                                   (g_buffer(rvb.IIR_DEST_B1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
-
-                s_buffer1(rvb.IIR_DEST_A0, IIR_A0);
-                s_buffer1(rvb.IIR_DEST_A1, IIR_A1);
-                s_buffer1(rvb.IIR_DEST_B0, IIR_B0);
-                s_buffer1(rvb.IIR_DEST_B1, IIR_B1);
-
-                ACC0 = (g_buffer(rvb.ACC_SRC_A0) * rvb.ACC_COEF_A) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_B0) * rvb.ACC_COEF_B) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_C0) * rvb.ACC_COEF_C) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_D0) * rvb.ACC_COEF_D) / 32768L;
-                ACC1 = (g_buffer(rvb.ACC_SRC_A1) * rvb.ACC_COEF_A) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_B1) * rvb.ACC_COEF_B) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_C1) * rvb.ACC_COEF_C) / 32768L +
-                       (g_buffer(rvb.ACC_SRC_D1) * rvb.ACC_COEF_D) / 32768L;
-
-                FB_A0 = g_buffer(rvb.MIX_DEST_A0 - rvb.FB_SRC_A);
-                FB_A1 = g_buffer(rvb.MIX_DEST_A1 - rvb.FB_SRC_A);
-                FB_B0 = g_buffer(rvb.MIX_DEST_B0 - rvb.FB_SRC_B);
-                FB_B1 = g_buffer(rvb.MIX_DEST_B1 - rvb.FB_SRC_B);
-
-                s_buffer(rvb.MIX_DEST_A0, ACC0 - (FB_A0 * rvb.FB_ALPHA) / 32768L);
-                s_buffer(rvb.MIX_DEST_A1, ACC1 - (FB_A1 * rvb.FB_ALPHA) / 32768L);
-
-                s_buffer(rvb.MIX_DEST_B0, (rvb.FB_ALPHA * ACC0) / 32768L -
-                                              (FB_A0 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
-                                              (FB_B0 * rvb.FB_X) / 32768L);
-                s_buffer(rvb.MIX_DEST_B1, (rvb.FB_ALPHA * ACC1) / 32768L -
-                                              (FB_A1 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
-                                              (FB_B1 * rvb.FB_X) / 32768L);
-
-                rvb.iLastRVBLeft = rvb.iRVBLeft;
-                rvb.iLastRVBRight = rvb.iRVBRight;
-
-                rvb.iRVBLeft = (g_buffer(rvb.MIX_DEST_A0) + g_buffer(rvb.MIX_DEST_B0)) / 3;
-                rvb.iRVBRight = (g_buffer(rvb.MIX_DEST_A1) + g_buffer(rvb.MIX_DEST_B1)) / 3;
-
-                rvb.iRVBLeft = (rvb.iRVBLeft * rvb.VolLeft) / 0x4000;
-                rvb.iRVBRight = (rvb.iRVBRight * rvb.VolRight) / 0x4000;
-
-                rvb.CurrAddr++;
-                if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
-
-                return rvb.iLastRVBLeft + (rvb.iRVBLeft - rvb.iLastRVBLeft) / 2;
-            } else  // -> reverb off
-            {
-                rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
-            }
-
-            rvb.CurrAddr++;
-            if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
-        }
-
-        return rvb.iLastRVBLeft;
-    } else  // easy fake reverb:
-    {
-        const int iRV = *sRVBPlay;                      // -> simply take the reverb mix buf value
-        *sRVBPlay++ = 0;                                // -> init it after
-        if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
-        return iRV;                                     // -> return reverb mix buf val
-    }
-}
-
-////////////////////////////////////////////////////////////////////////
-
-int PCSX::SPU::impl::MixREVERBRight() {
-    if (settings.get<Reverb>() == 0)
-        return 0;
-    else if (settings.get<Reverb>() == 2)  // Neill's reverb:
+void PCSX::SPU::impl::MixREVERB(int count) {
+    if (m_reverb == 0)
+        return;
+    else if (m_reverb == 2)  // Neill's reverb:
     {
-        int i = rvb.iLastRVBRight + (rvb.iRVBRight - rvb.iLastRVBRight) / 2;
-        rvb.iLastRVBRight = rvb.iRVBRight;
-        return i;  // -> just return the last right reverb val (little bit scaled by the previous right val)
-    } else         // easy fake reverb:
+        m_reverbMix(rvb, reinterpret_cast<int16_t *>(spuMem), m_reverbCounter,
+                    (spuCtrl & ControlFlags::ReverbMasterEnable) != 0, sRVBStart, count, SSumL, SSumR);
+    } else  // easy fake reverb:
     {
-        const int iRV = *sRVBPlay;                      // -> simply take the reverb mix buf value
-        *sRVBPlay++ = 0;                                // -> init it after
-        if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
-        return iRV;                                     // -> return reverb mix buf val
+        for (int ns = 0; ns < count; ns++) {
+            SSumL[ns] += *sRVBPlay;                         // -> simply take the reverb mix buf value
+            *sRVBPlay++ = 0;                                // -> init it after
+            if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;  // -> and take care about wrap arounds
+            SSumR[ns] += *sRVBPlay;
+            *sRVBPlay++ = 0;
+            if (sRVBPlay >= sRVBEnd) sRVBPlay = sRVBStart;
+        }
     }
 }
 
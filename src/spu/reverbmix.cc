@@ -0,0 +1,399 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/reverbmix.h"
+
+#include <algorithm>
+
+#include "spu/simd.h"
+#include "spu/types.h"
+
+namespace {
+
+using PCSX::SPU::REVERBInfo;
+
+////////////////////////////////////////////////////////////////////////
+// The sample-per-sample reference, which is what MixREVERBLeft and MixREVERBRight used to do.
+////////////////////////////////////////////////////////////////////////
+
+// takes care about wraps; note that going under the start of the work area doesn't wrap by its full size
+int wrap(const REVERBInfo& rvb, int iOff) {
+    while (iOff > 0x3FFFF) iOff = rvb.StartAddr + (iOff - 0x40000);
+    while (iOff < rvb.StartAddr) iOff = 0x3ffff - (rvb.StartAddr - iOff);
+    return iOff;
+}
+
+// get_buffer content helper
+int g_buffer(const REVERBInfo& rvb, const int16_t* p, int iOff) { return p[wrap(rvb, (iOff * 4) + rvb.CurrAddr)]; }
+
+// set_buffer content helper: takes care about clipping
+void s_buffer(const REVERBInfo& rvb, int16_t* p, int iOff, int iVal) {
+    if (iVal < -32768L) iVal = -32768L;
+    if (iVal > 32767L) iVal = 32767L;
+    p[wrap(rvb, (iOff * 4) + rvb.CurrAddr)] = (int16_t)iVal;
+}
+
+// set_buffer (+1 sample) content helper: takes care about clipping
+void s_buffer1(const REVERBInfo& rvb, int16_t* p, int iOff, int iVal) {
+    if (iVal < -32768L) iVal = -32768L;
+    if (iVal > 32767L) iVal = 32767L;
+    p[wrap(rvb, (iOff * 4) + rvb.CurrAddr + 1)] = (int16_t)iVal;
+}
+
+int mixLeftReference(REVERBInfo& rvb, int16_t* p, int& iCnt, bool enabled, const int* input, unsigned ns) {
+    if (!rvb.StartAddr)  // reverb is off
+    {
+        rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
+        return 0;
+    }
+
+    iCnt++;
+
+    if (iCnt & 1)  // we work on every second left value: downsample to 22 khz
+    {
+        if (enabled)  // -> reverb on? oki
+        {
+            int ACC0, ACC1, FB_A0, FB_A1, FB_B0, FB_B1;
+
+            const int INPUT_SAMPLE_L = *(input + (ns << 1));
+            const int INPUT_SAMPLE_R = *(input + (ns << 1) + 1);
+
+            const int IIR_INPUT_A0 =
+                (g_buffer(rvb, p, rvb.IIR_SRC_A0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
+            const int IIR_INPUT_A1 =
+                (g_buffer(rvb, p, rvb.IIR_SRC_A1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
+            const int IIR_INPUT_B0 =
+                (g_buffer(rvb, p, rvb.IIR_SRC_B0) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_L * rvb.IN_COEF_L) / 32768L;
+            const int IIR_INPUT_B1 =
+                (g_buffer(rvb, p, rvb.IIR_SRC_B1) * rvb.IIR_COEF) / 32768L + (INPUT_SAMPLE_R * rvb.IN_COEF_R) / 32768L;
+
+            const int IIR_A0 = (IIR_INPUT_A0 * rvb.IIR_ALPHA) / 32768L +
+                               (g_buffer(rvb, p, rvb.IIR_DEST_A0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
+            const int IIR_A1 = (IIR_INPUT_A1 * rvb.IIR_ALPHA) / 32768L +
+                               (g_buffer(rvb, p, rvb.IIR_DEST_A1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
+            const int IIR_B0 = (IIR_INPUT_B0 * rvb.IIR_ALPHA) / 32768L +
+                               (g_buffer(rvb, p, rvb.IIR_DEST_B0) * (32768L - rvb.IIR_ALPHA)) / 32768L;
+            const int IIR_B1 = (IIR_INPUT_B1 * rvb.IIR_ALPHA) / 32768L +
+                               (g_buffer(rvb, p, rvb.IIR_DEST_B1) * (32768L - rvb.IIR_ALPHA)) / 32768L;
+
+            s_buffer1(rvb, p, rvb.IIR_DEST_A0, IIR_A0);
+            s_buffer1(rvb, p, rvb.IIR_DEST_A1, IIR_A1);
+            s_buffer1(rvb, p, rvb.IIR_DEST_B0, IIR_B0);
+            s_buffer1(rvb, p, rvb.IIR_DEST_B1, IIR_B1);
+
+            ACC0 = (g_buffer(rvb, p, rvb.ACC_SRC_A0) * rvb.ACC_COEF_A) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_B0) * rvb.ACC_COEF_B) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_C0) * rvb.ACC_COEF_C) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_D0) * rvb.ACC_COEF_D) / 32768L;
+            ACC1 = (g_buffer(rvb, p, rvb.ACC_SRC_A1) * rvb.ACC_COEF_A) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_B1) * rvb.ACC_COEF_B) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_C1) * rvb.ACC_COEF_C) / 32768L +
+                   (g_buffer(rvb, p, rvb.ACC_SRC_D1) * rvb.ACC_COEF_D) / 32768L;
+
+            FB_A0 = g_buffer(rvb, p, rvb.MIX_DEST_A0 - rvb.FB_SRC_A);
+            FB_A1 = g_buffer(rvb, p, rvb.MIX_DEST_A1 - rvb.FB_SRC_A);
+            FB_B0 = g_buffer(rvb, p, rvb.MIX_DEST_B0 - rvb.FB_SRC_B);
+            FB_B1 = g_buffer(rvb, p, rvb.MIX_DEST_B1 - rvb.FB_SRC_B);
+
+            s_buffer(rvb, p, rvb.MIX_DEST_A0, ACC0 - (FB_A0 * rvb.FB_ALPHA) / 32768L);
+            s_buffer(rvb, p, rvb.MIX_DEST_A1, ACC1 - (FB_A1 * rvb.FB_ALPHA) / 32768L);
+
+            s_buffer(rvb, p, rvb.MIX_DEST_B0,
+                     (rvb.FB_ALPHA * ACC0) / 32768L - (FB_A0 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
+                         (FB_B0 * rvb.FB_X) / 32768L);
+            s_buffer(rvb, p, rvb.MIX_DEST_B1,
+                     (rvb.FB_ALPHA * ACC1) / 32768L - (FB_A1 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768L -
+                         (FB_B1 * rvb.FB_X) / 32768L);
+
+            rvb.iLastRVBLeft = rvb.iRVBLeft;
+            rvb.iLastRVBRight = rvb.iRVBRight;
+
+            rvb.iRVBLeft = (g_buffer(rvb, p, rvb.MIX_DEST_A0) + g_buffer(rvb, p, rvb.MIX_DEST_B0)) / 3;
+            rvb.iRVBRight = (g_buffer(rvb, p, rvb.MIX_DEST_A1) + g_buffer(rvb, p, rvb.MIX_DEST_B1)) / 3;
+
+            rvb.iRVBLeft = (rvb.iRVBLeft * rvb.VolLeft) / 0x4000;
+            rvb.iRVBRight = (rvb.iRVBRight * rvb.VolRight) / 0x4000;
+
+            rvb.CurrAddr++;
+            if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
+
+            return rvb.iLastRVBLeft + (rvb.iRVBLeft - rvb.iLastRVBLeft) / 2;
+        } else  // -> reverb off
+        {
+            rvb.iLastRVBLeft = rvb.iLastRVBRight = rvb.iRVBLeft = rvb.iRVBRight = 0;
+        }
+
+        rvb.CurrAddr++;
+        if (rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
+    }
+
+    return rvb.iLastRVBLeft;
+}
+
+int mixRightReference(REVERBInfo& rvb) {
+    int i = rvb.iLastRVBRight + (rvb.iRVBRight - rvb.iLastRVBRight) / 2;
+    rvb.iLastRVBRight = rvb.iRVBRight;
+    return i;  // -> just return the last right reverb val (little bit scaled by the previous right val)
+}
+
+void mixReference(REVERBInfo& rvb, int16_t* workArea, int& counter, bool enabled, const int* input, unsigned count,
+                  int* sumL, int* sumR) {
+    for (unsigned ns = 0; ns < count; ns++) {
+        sumL[ns] += mixLeftReference(rvb, workArea, counter, enabled, input, ns);
+        sumR[ns] += mixRightReference(rvb);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// The block version. All of the taps move forward by one sample at each 22kHz step, so instead of wrapping each
+// of them around the work area every time, they get resolved once, together with how many steps they can go on
+// for before one of them, or the current address, gets to a wrap boundary. Only then do they need resolving again.
+////////////////////////////////////////////////////////////////////////
+
+// The taps of a step, in the order they're read or written. Each group is laid out so the stages can load it
+// as a vector: the IIR ones go A0, A1, B0, B1, and the ACC ones go A, B, C, D for each side.
+enum Tap : unsigned {
+    c_iirSrc,
+    c_iirDest = c_iirSrc + 4,
+    c_iirWrite = c_iirDest + 4,
+    c_acc0 = c_iirWrite + 4,
+    c_acc1 = c_acc0 + 4,
+    c_fb = c_acc1 + 4,
+    c_mixDest = c_fb + 4,
+    c_taps = c_mixDest + 4,
+};
+
+struct Coefficients {
+    int iirCoef;
+    int inCoef[4];
+    int iirAlpha;
+    int iirAlphaComplement;
+    int acc[4];
+};
+
+// Resolves all of the taps for the current address, and returns how many steps they stay valid for by
+// just incrementing them. Past the end of the work area, a tap wraps to the start once it reaches 0x3ffff.
+// Before the start, the reference wraps by one sample less than the size of the work area, so a tap there
+// wraps from 0x3fffe instead, or jumps to the start as soon as its unwrapped address gets to it.
+unsigned resolve(const REVERBInfo& rvb, const int* offsets, int* taps) {
+    unsigned run = 0x40000 - rvb.CurrAddr;
+    for (unsigned t = 0; t < c_taps; t++) {
+        const int unwrapped = offsets[t] + rvb.CurrAddr;
+        const int tap = wrap(rvb, unwrapped);
+        const unsigned steps =
+            unwrapped < rvb.StartAddr ? std::min(0x3ffff - tap, rvb.StartAddr - unwrapped) : 0x40000 - tap;
+        taps[t] = tap;
+        run = std::min(run, steps);
+    }
+    return run;
+}
+
+void store(int16_t* p, int tap, int value) { p[tap] = (int16_t)std::clamp(value, -32768, 32767); }
+
+struct ScalarStages {
+    static void iir(const int16_t* p, const int* taps, const Coefficients& c, int inL, int inR, int* out) {
+        const int in[4] = {inL, inR, inL, inR};
+        for (unsigned i = 0; i < 4; i++) {
+            const int input = (p[taps[c_iirSrc + i]] * c.iirCoef) / 32768 + (in[i] * c.inCoef[i]) / 32768;
+            out[i] = (input * c.iirAlpha) / 32768 + (p[taps[c_iirDest + i]] * c.iirAlphaComplement) / 32768;
+        }
+    }
+    static void acc(const int16_t* p, const int* taps, const Coefficients& c, int& acc0, int& acc1) {
+        acc0 = acc1 = 0;
+        for (unsigned i = 0; i < 4; i++) {
+            acc0 += (p[taps[c_acc0 + i]] * c.acc[i]) / 32768;
+            acc1 += (p[taps[c_acc1 + i]] * c.acc[i]) / 32768;
+        }
+    }
+};
+
+#if defined(SPU_SIMD_SSE2)
+using PCSX::SPU::SIMD::horizontalSumSSE2;
+using PCSX::SPU::SIMD::mulLow32SSE2;
+using PCSX::SPU::SIMD::scaleSSE2;
+
+__m128i gatherSSE2(const int16_t* p, const int* taps) {
+    return _mm_setr_epi32(p[taps[0]], p[taps[1]], p[taps[2]], p[taps[3]]);
+}
+
+struct SSE2Stages {
+    static void iir(const int16_t* p, const int* taps, const Coefficients& c, int inL, int inR, int* out) {
+        const __m128i src = gatherSSE2(p, taps + c_iirSrc);
+        const __m128i dest = gatherSSE2(p, taps + c_iirDest);
+        const __m128i in = _mm_setr_epi32(inL, inR, inL, inR);
+        const __m128i inCoef = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.inCoef));
+        const __m128i input = _mm_add_epi32(scaleSSE2<15>(mulLow32SSE2(src, _mm_set1_epi32(c.iirCoef))),
+                                            scaleSSE2<15>(mulLow32SSE2(in, inCoef)));
+        const __m128i result = _mm_add_epi32(scaleSSE2<15>(mulLow32SSE2(input, _mm_set1_epi32(c.iirAlpha))),
+                                             scaleSSE2<15>(mulLow32SSE2(dest, _mm_set1_epi32(c.iirAlphaComplement))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+    }
+    static void acc(const int16_t* p, const int* taps, const Coefficients& c, int& acc0, int& acc1) {
+        const __m128i coefs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.acc));
+        acc0 = horizontalSumSSE2(scaleSSE2<15>(mulLow32SSE2(gatherSSE2(p, taps + c_acc0), coefs)));
+        acc1 = horizontalSumSSE2(scaleSSE2<15>(mulLow32SSE2(gatherSSE2(p, taps + c_acc1), coefs)));
+    }
+};
+#endif  // SPU_SIMD_SSE2
+
+#if defined(SPU_SIMD_NEON)
+using PCSX::SPU::SIMD::scaleNEON;
+
+int32x4_t gatherNEON(const int16_t* p, const int* taps) {
+    const int32_t lanes[4] = {p[taps[0]], p[taps[1]], p[taps[2]], p[taps[3]]};
+    return vld1q_s32(lanes);
+}
+
+struct NEONStages {
+    static void iir(const int16_t* p, const int* taps, const Coefficients& c, int inL, int inR, int* out) {
+        const int32x4_t src = gatherNEON(p, taps + c_iirSrc);
+        const int32x4_t dest = gatherNEON(p, taps + c_iirDest);
+        const int32_t inLanes[4] = {inL, inR, inL, inR};
+        const int32x4_t in = vld1q_s32(inLanes);
+        const int32x4_t input =
+            vaddq_s32(scaleNEON<15>(vmulq_n_s32(src, c.iirCoef)), scaleNEON<15>(vmulq_s32(in, vld1q_s32(c.inCoef))));
+        const int32x4_t result = vaddq_s32(scaleNEON<15>(vmulq_n_s32(input, c.iirAlpha)),
+                                           scaleNEON<15>(vmulq_n_s32(dest, c.iirAlphaComplement)));
+        vst1q_s32(out, result);
+    }
+    static void acc(const int16_t* p, const int* taps, const Coefficients& c, int& acc0, int& acc1) {
+        const int32x4_t coefs = vld1q_s32(c.acc);
+        acc0 = vaddvq_s32(scaleNEON<15>(vmulq_s32(gatherNEON(p, taps + c_acc0), coefs)));
+        acc1 = vaddvq_s32(scaleNEON<15>(vmulq_s32(gatherNEON(p, taps + c_acc1), coefs)));
+    }
+};
+#endif  // SPU_SIMD_NEON
+
+// One 22kHz step; the reads and writes happen in the same order as in the reference,
+// since the taps are allowed to overlap each other.
+template <typename Stages>
+void step(REVERBInfo& rvb, int16_t* p, const int* taps, const Coefficients& c, int inL, int inR) {
+    int iir[4];
+    Stages::iir(p, taps, c, inL, inR, iir);
+    for (unsigned i = 0; i < 4; i++) store(p, taps[c_iirWrite + i], iir[i]);
+
+    int ACC0, ACC1;
+    Stages::acc(p, taps, c, ACC0, ACC1);
+
+    const int FB_A0 = p[taps[c_fb + 0]];
+    const int FB_A1 = p[taps[c_fb + 1]];
+    const int FB_B0 = p[taps[c_fb + 2]];
+    const int FB_B1 = p[taps[c_fb + 3]];
+
+    store(p, taps[c_mixDest + 0], ACC0 - (FB_A0 * rvb.FB_ALPHA) / 32768);
+    store(p, taps[c_mixDest + 1], ACC1 - (FB_A1 * rvb.FB_ALPHA) / 32768);
+    store(p, taps[c_mixDest + 2],
+          (rvb.FB_ALPHA * ACC0) / 32768 - (FB_A0 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768 -
+              (FB_B0 * rvb.FB_X) / 32768);
+    store(p, taps[c_mixDest + 3],
+          (rvb.FB_ALPHA * ACC1) / 32768 - (FB_A1 * (int)(rvb.FB_ALPHA ^ 0xFFFF8000)) / 32768 -
+              (FB_B1 * rvb.FB_X) / 32768);
+
+    rvb.iLastRVBLeft = rvb.iRVBLeft;
+    rvb.iLastRVBRight = rvb.iRVBRight;
+
+    rvb.iRVBLeft = ((p[taps[c_mixDest + 0]] + p[taps[c_mixDest + 2]]) / 3 * rvb.VolLeft) / 0x4000;
+    rvb.iRVBRight = ((p[taps[c_mixDest + 1]] + p[taps[c_mixDest + 3]]) / 3 * rvb.VolRight) / 0x4000;
+}
+
+template <typename Stages>
+void mixBlock(REVERBInfo& rvb, int16_t* workArea, int& counter, bool enabled, const int* input, unsigned count,
+              int* sumL, int* sumR) {
+    // Without a work area, or with the reverb disabled, there's no tap to go through,
+    // and the reference is already as cheap as it gets.
+    if (!rvb.StartAddr || !enabled) {
+        mixReference(rvb, workArea, counter, enabled, input, count, sumL, sumR);
+        return;
+    }
+
+    const Coefficients c = {
+        .iirCoef = rvb.IIR_COEF,
+        .inCoef = {rvb.IN_COEF_L, rvb.IN_COEF_R, rvb.IN_COEF_L, rvb.IN_COEF_R},
+        .iirAlpha = rvb.IIR_ALPHA,
+        .iirAlphaComplement = 32768 - rvb.IIR_ALPHA,
+        .acc = {rvb.ACC_COEF_A, rvb.ACC_COEF_B, rvb.ACC_COEF_C, rvb.ACC_COEF_D},
+    };
+
+    const int offsets[c_taps] = {
+        rvb.IIR_SRC_A0 * 4,
+        rvb.IIR_SRC_A1 * 4,
+        rvb.IIR_SRC_B0 * 4,
+        rvb.IIR_SRC_B1 * 4,
+        rvb.IIR_DEST_A0 * 4,
+        rvb.IIR_DEST_A1 * 4,
+        rvb.IIR_DEST_B0 * 4,
+        rvb.IIR_DEST_B1 * 4,
+        rvb.IIR_DEST_A0 * 4 + 1,
+        rvb.IIR_DEST_A1 * 4 + 1,
+        rvb.IIR_DEST_B0 * 4 + 1,
+        rvb.IIR_DEST_B1 * 4 + 1,
+        rvb.ACC_SRC_A0 * 4,
+        rvb.ACC_SRC_B0 * 4,
+        rvb.ACC_SRC_C0 * 4,
+        rvb.ACC_SRC_D0 * 4,
+        rvb.ACC_SRC_A1 * 4,
+        rvb.ACC_SRC_B1 * 4,
+        rvb.ACC_SRC_C1 * 4,
+        rvb.ACC_SRC_D1 * 4,
+        (rvb.MIX_DEST_A0 - rvb.FB_SRC_A) * 4,
+        (rvb.MIX_DEST_A1 - rvb.FB_SRC_A) * 4,
+        (rvb.MIX_DEST_B0 - rvb.FB_SRC_B) * 4,
+        (rvb.MIX_DEST_B1 - rvb.FB_SRC_B) * 4,
+        rvb.MIX_DEST_A0 * 4,
+        rvb.MIX_DEST_A1 * 4,
+        rvb.MIX_DEST_B0 * 4,
+        rvb.MIX_DEST_B1 * 4,
+    };
+
+    int taps[c_taps];
+    unsigned run = 0;
+
+    for (unsigned ns = 0; ns < count; ns++) {
+        if (++counter & 1) {
+            if (run == 0) run = resolve(rvb, offsets, taps);
+            step<Stages>(rvb, workArea, taps, c, input[ns * 2], input[ns * 2 + 1]);
+            for (auto& tap : taps) tap++;
+            run--;
+            // this can only happen at the end of a run, so the taps get resolved again right after
+            if (++rvb.CurrAddr > 0x3ffff) rvb.CurrAddr = rvb.StartAddr;
+            sumL[ns] += rvb.iLastRVBLeft + (rvb.iRVBLeft - rvb.iLastRVBLeft) / 2;
+        } else {
+            sumL[ns] += rvb.iLastRVBLeft;
+        }
+        sumR[ns] += rvb.iLastRVBRight + (rvb.iRVBRight - rvb.iLastRVBRight) / 2;
+        rvb.iLastRVBRight = rvb.iRVBRight;
+    }
+}
+
+}  // namespace
+
+std::vector<PCSX::SPU::ReverbMix::MixImplementation> PCSX::SPU::ReverbMix::getSupportedMixImplementations() {
+    std::vector<MixImplementation> implementations = {{"Reference", mixReference}, {"Block", mixBlock<ScalarStages>}};
+#if defined(SPU_SIMD_SSE2)
+    implementations.push_back({"SSE2", mixBlock<SSE2Stages>});
+#elif defined(SPU_SIMD_NEON)
+    implementations.push_back({"NEON", mixBlock<NEONStages>});
+#endif
+    return implementations;
+}
+
+PCSX::SPU::ReverbMix::MixKernel PCSX::SPU::ReverbMix::getMixKernel() {
+    static const MixKernel kernel = getSupportedMixImplementations().back().kernel;
+    return kernel;
+}
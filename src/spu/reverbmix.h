@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+namespace SPU {
+
+struct REVERBInfo;
+
+namespace ReverbMix {
+
+// Runs Neill's reverb over a chunk of count samples at 44.1kHz, and adds its output into sumL and sumR.
+// The work area is the whole SPU RAM, seen as 16 bits samples; the reverb itself only touches the part between
+// rvb.StartAddr and the end. The input holds the reverb send of all the voices, interleaved left / right, and
+// counter is the 44.1kHz to 22.05kHz decimation phase, which carries over from one chunk to the next.
+// All of the implementations behave exactly like the historical sample-per-sample one, wrap quirks included.
+using MixKernel = void (*)(REVERBInfo& rvb, int16_t* workArea, int& counter, bool enabled, const int* input,
+                           unsigned count, int* sumL, int* sumR);
+
+struct MixImplementation {
+    const char* name;
+    MixKernel kernel;
+};
+
+// All the implementations the host CPU can run, from the slowest (the sample-per-sample one) to the fastest
+std::vector<MixImplementation> getSupportedMixImplementations();
+
+// The fastest implementation the host CPU can run. Feature detection only happens on the first call.
+MixKernel getMixKernel();
+
+}  // namespace ReverbMix
+
+}  // namespace SPU
+
+}  // namespace PCSX
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define SPU_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SPU_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace PCSX {
+
+namespace SPU {
+
+// The building blocks the mixing kernels have in common. The SPU does all of its volume and coefficient math as
+// 16 bits fixed point, which the scalar code divides back down, hence the scaling helpers.
+namespace SIMD {
+
+#if defined(SPU_SIMD_SSE2)
+// SSE2 is part of x86-64, so this one is always available. It doesn't have a 32 bits multiplication though,
+// so this puts one together out of the two 32x32->64 bits ones; only the bottom 32 bits of each are needed.
+inline __m128i mulLow32SSE2(__m128i a, __m128i b) {
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Divides by 1 << shift rounding towards zero, like the scalar division does: negative values get biased by
+// (1 << shift) - 1 first
+template <int shift>
+inline __m128i scaleSSE2(__m128i product) {
+    const __m128i bias = _mm_srli_epi32(_mm_srai_epi32(product, 31), 32 - shift);
+    return _mm_srai_epi32(_mm_add_epi32(product, bias), shift);
+}
+
+inline int horizontalSumSSE2(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+#endif  // SPU_SIMD_SSE2
+
+#if defined(SPU_SIMD_NEON)
+// NEON is mandatory on AArch64, so there's nothing to detect. Same as scaleSSE2.
+template <int shift>
+inline int32x4_t scaleNEON(int32x4_t product) {
+    const uint32x4_t sign = vreinterpretq_u32_s32(vshrq_n_s32(product, 31));
+    const int32x4_t bias = vreinterpretq_s32_u32(vshrq_n_u32(sign, 32 - shift));
+    return vshrq_n_s32(vaddq_s32(product, bias), shift);
+}
+#endif  // SPU_SIMD_NEON
+
+}  // namespace SIMD
+
+}  // namespace SPU
+
+}  // namespace PCSX
@@ -96,10 +96,12 @@
 #include <chrono>
 #include <thread>
 
+#include "core/framestats.h"
 #include "spu/adsr.h"
 #include "spu/externals.h"
 #include "spu/gauss.h"
 #include "spu/interface.h"
+#include "tracy/Tracy.hpp"
 
 ////////////////////////////////////////////////////////////////////////
 // globals
@@ -237,7 +239,7 @@ inline void PCSX::SPU::impl::StartSound(SPUCHAN *pChannel) {
     SB[29].value = 0;  // init our interpolation helpers
     SB[30].value = 0;
 
-    if (settings.get<Interpolation>() >= 2)  // gauss interpolation?
+    if (m_interpolation >= 2)  // gauss interpolation?
     {
         pChannel->data.get<PCSX::SPU::Chan::spos>().value = 0x30000L;
         SB[28].value = 0;
@@ -258,7 +260,7 @@ inline void PCSX::SPU::impl::VoiceChangeFrequency(SPUCHAN *pChannel) {
         pChannel->data.get<PCSX::SPU::Chan::ActFreq>().value;  // -> take it and calc steps
     pChannel->data.get<PCSX::SPU::Chan::sinc>().value = pChannel->data.get<PCSX::SPU::Chan::RawPitch>().value << 4;
     if (!pChannel->data.get<PCSX::SPU::Chan::sinc>().value) pChannel->data.get<PCSX::SPU::Chan::sinc>().value = 1;
-    if (settings.get<Interpolation>() == 1) SB[32].value = 1;  // -> freq change in simle imterpolation mode: set flag
+    if (m_interpolation == 1) SB[32].value = 1;  // -> freq change in simle imterpolation mode: set flag
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -278,7 +280,7 @@ inline void PCSX::SPU::impl::FModChangeFrequency(SPUCHAN *pChannel, int ns) {
     pChannel->data.get<PCSX::SPU::Chan::UsedFreq>().value = NP;
     pChannel->data.get<PCSX::SPU::Chan::sinc>().value = (((NP / 10) << 16) / 4410);
     if (!pChannel->data.get<PCSX::SPU::Chan::sinc>().value) pChannel->data.get<PCSX::SPU::Chan::sinc>().value = 1;
-    if (settings.get<Interpolation>() == 1) SB[32].value = 1;  // freq change in simple interpolation mode
+    if (m_interpolation == 1) SB[32].value = 1;  // freq change in simple interpolation mode
 
     iFMod[ns] = 0;
 }
@@ -293,7 +295,7 @@ inline int PCSX::SPU::impl::iGetNoiseVal(SPUCHAN *pChannel) {
     auto &SB = pChannel->data.get<PCSX::SPU::Chan::SB>().value;
     const int fa = (int16_t)m_noiseVal;
 
-    if (settings.get<Interpolation>() < 2)  // no gauss/cubic interpolation?
+    if (m_interpolation < 2)  // no gauss/cubic interpolation?
         SB[29].value = fa;                  // -> store noise val in "current sample" slot
     return fa;
 }
@@ -347,13 +349,13 @@ inline void PCSX::SPU::impl::StoreInterpolationVal(SPUCHAN *pChannel, int fa) {
             if (fa < -32767L) fa = -32767L;
         }
 
-        if (settings.get<Interpolation>() >= 2)  // gauss/cubic interpolation
+        if (m_interpolation >= 2)  // gauss/cubic interpolation
         {
             int gpos = SB[28].value;
             gval0 = fa;
             gpos = (gpos + 1) & 3;
             SB[28].value = gpos;
-        } else if (settings.get<Interpolation>() == 1)  // simple interpolation
+        } else if (m_interpolation == 1)  // simple interpolation
         {
             SB[28].value = 0;
             SB[29].value = SB[30].value;  // -> helpers for simple linear interpolation: delay real val for two slots,
@@ -374,7 +376,7 @@ inline int PCSX::SPU::impl::iGetInterpolationVal(SPUCHAN *pChannel) {
 
     if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 2) return SB[29].value;
 
-    switch (settings.get<Interpolation>()) {
+    switch (m_interpolation) {
         //--------------------------------------------------//
         case 3:  // cubic interpolation
         {
@@ -437,18 +439,8 @@ inline int PCSX::SPU::impl::iGetInterpolationVal(SPUCHAN *pChannel) {
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::MainThread() {
-    int s_1, s_2, fa, ns;
-    uint8_t *start;
-    unsigned int nSample;
-    int ch, predict_nr, shift_factor, flags, d, s;
-    int bIRQReturn = 0;
-    int32_t tmpCapVoice1Index = 0;
-    int32_t tmpCapVoice3Index = 0;
-
-    SPUCHAN *pChannel;
     while (!bEndThread)  // until we are shutting down
     {
-        int voldiv = 4 - settings.get<Volume>();
         //--------------------------------------------------//
         // ok, at the beginning we are looking if there is
         // enuff free place in the dsound/oss buffer to
@@ -479,357 +471,419 @@ void PCSX::SPU::impl::MainThread() {
                     1;  // if a new channel kicks in (or, of course, sound buffer runs low), we will leave the loop
         }
 
-        //--------------------------------------------------// continue from irq handling in timer mode?
+        const auto mixStart = AudioTelemetry::Clock::now();
+        mixSamples(NSSIZE);
+        m_audioOut.getTelemetry().mixTime.add(
+            AudioTelemetry::mixTimePerMs(AudioTelemetry::Clock::now() - mixStart, NSSIZE));
 
-        if (lastch >= 0)  // will be -1 if no continue is pending
-        {
-            ch = lastch;
-            ns = lastns;
-            lastch = -1;  // -> setup all kind of vars to continue
-            pChannel = &s_chan[ch];
-            goto GOON;  // -> directly jump to the continue point
+        //////////////////////////////////////////////////////
+        // feed the sound
+        // wanna have around 1/60 sec (16.666 ms) updates
+
+        if (iCycle++ > 16) {
+            bool done = false;
+            while (!done) {
+                done =
+                    m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(pSpuBuffer),
+                                              (((uint8_t *)pS) - ((uint8_t *)pSpuBuffer)) / sizeof(MiniAudio::Frame));
+                if (bEndThread) {
+                    bThreadEnded = 1;
+                    return;
+                }
+            }
+            pS = (int16_t *)pSpuBuffer;
+            iCycle = 0;
         }
+    }
 
-        tmpCapVoice1Index = capBufVoiceIndex;
-        tmpCapVoice3Index = capBufVoiceIndex;
+    // end of big main loop...
 
-        //--------------------------------------------------//
-        //- main channel loop                              -//
-        //--------------------------------------------------//
-        {
-            pChannel = s_chan;
-            for (ch = 0; ch < MAXCHAN;
-                 ch++, pChannel++)  // loop em all... we will collect 1 ms of sound of each playing channel
-            {
-                if (pChannel->data.get<PCSX::SPU::Chan::New>().value) {
-                    StartSound(pChannel);        // start new sound
-                    dwNewChannel &= ~(1 << ch);  // clear new channel bit
-                }
+    bThreadEnded = 1;
+}
 
-                if (!pChannel->data.get<PCSX::SPU::Chan::On>().value) {
-                    // Although the voices may stop outputting audio, the capture buffer is still filling up.
-                    if (pMixIrq && ch == 1) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        for (int c = 0; c < NSSIZE; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
-                        tmpCapVoice1Index = (tmpCapVoice1Index + NSSIZE) % 0x200;
-                    } else if (pMixIrq && ch == 3) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        for (int c = 0; c < NSSIZE; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
-                        tmpCapVoice3Index = (tmpCapVoice3Index + NSSIZE) % 0x200;
-                    }
-                    continue;  // channel not playing? next
-                }
+////////////////////////////////////////////////////////////////////////
+// mixes count samples (at most NSSIZE) of all channels into pS
+////////////////////////////////////////////////////////////////////////
 
-                if (pChannel->data.get<PCSX::SPU::Chan::ActFreq>().value !=
-                    pChannel->data.get<PCSX::SPU::Chan::UsedFreq>().value)  // new psx frequency?
-                    VoiceChangeFrequency(pChannel);
+void PCSX::SPU::impl::mixSamples(int count) {
+    ZoneScoped;
+    FrameStats::Scope frameStatsScope(*g_emulator->m_frameStats, FrameStats::Counter::SPU);
+    int s_1, s_2, fa, ns;
+    uint8_t *start;
+    unsigned int nSample;
+    int ch, predict_nr, shift_factor, flags, d, s;
+    int bIRQReturn = 0;
+    int32_t tmpCapVoice1Index = 0;
+    int32_t tmpCapVoice3Index = 0;
 
-                ns = 0;
+    SPUCHAN *pChannel;
+    int voldiv = 4 - m_volume;
 
-                while (ns < NSSIZE)  // loop until 1 ms of data is reached
-                {
-                    NoiseClock();
+    memset(m_voiceSamples, 0, count * sizeof(m_voiceSamples[0]));
 
-                    if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 1 && iFMod[ns])  // fmod freq channel
-                        FModChangeFrequency(pChannel, ns);
+    //--------------------------------------------------// continue from irq handling in timer mode?
 
-                    while (pChannel->data.get<PCSX::SPU::Chan::spos>().value >= 0x10000L) {
-                        if (pChannel->data.get<PCSX::SPU::Chan::SBPos>().value == 28)  // 28 reached?
-                        {
-                            start = pChannel->pCurr;  // set up the current pos
-
-                            if (start == (uint8_t *)-1)  // special "stop" sign
-                            {
-                                pChannel->data.get<PCSX::SPU::Chan::On>().value = false;  // -> turn everything off
-                                pChannel->ADSRX.get<exVolume>().value = 0;
-                                pChannel->ADSRX.get<exEnvelopeVol>().value = 0;
-                                // Although the voices may stop outputting audio, the capture buffer is still filling
-                                // up. At this point, ns samples are already filled, we need (NSSIZE-ns) more samples.
-                                if (pMixIrq && ch == 1) {
-                                    std::unique_lock<std::mutex> lock(cbMtx);
-                                    for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
-                                    tmpCapVoice1Index = (tmpCapVoice1Index + (NSSIZE - ns)) % 0x200;
-                                } else if (pMixIrq && ch == 3) {
-                                    std::unique_lock<std::mutex> lock(cbMtx);
-                                    for (int c = ns; c < NSSIZE; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
-                                    tmpCapVoice3Index = (tmpCapVoice3Index + (NSSIZE - ns)) % 0x200;
-                                }
-                                goto ENDX;  // -> and done for this channel
-                            }
+    if (lastch >= 0)  // will be -1 if no continue is pending
+    {
+        ch = lastch;
+        ns = lastns;
+        lastch = -1;  // -> setup all kind of vars to continue
+        pChannel = &s_chan[ch];
+        goto GOON;  // -> directly jump to the continue point
+    }
 
-                            pChannel->data.get<PCSX::SPU::Chan::SBPos>().value = 0;
+    tmpCapVoice1Index = capBufVoiceIndex;
+    tmpCapVoice3Index = capBufVoiceIndex;
 
-                            //////////////////////////////////////////// spu irq handler here? mmm... do it later
+    //--------------------------------------------------//
+    //- main channel loop                              -//
+    //--------------------------------------------------//
+    {
+        pChannel = s_chan;
+        for (ch = 0; ch < MAXCHAN;
+             ch++, pChannel++)  // loop em all... we will collect 1 ms of sound of each playing channel
+        {
+            if (pChannel->data.get<PCSX::SPU::Chan::New>().value) {
+                StartSound(pChannel);        // start new sound
+                dwNewChannel &= ~(1 << ch);  // clear new channel bit
+            }
 
-                            s_1 = pChannel->data.get<PCSX::SPU::Chan::s_1>().value;
-                            s_2 = pChannel->data.get<PCSX::SPU::Chan::s_2>().value;
+            if (!pChannel->data.get<PCSX::SPU::Chan::On>().value) {
+                // Although the voices may stop outputting audio, the capture buffer is still filling up.
+                if (pMixIrq && ch == 1) {
+                    for (int c = 0; c < count; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
+                    tmpCapVoice1Index = (tmpCapVoice1Index + count) % 0x200;
+                } else if (pMixIrq && ch == 3) {
+                    for (int c = 0; c < count; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
+                    tmpCapVoice3Index = (tmpCapVoice3Index + count) % 0x200;
+                }
+                continue;  // channel not playing? next
+            }
 
-                            predict_nr = (int)*start;
-                            start++;
-                            shift_factor = predict_nr & 0xf;
-                            predict_nr >>= 4;
-                            flags = (int)*start;
-                            start++;
+            if (pChannel->data.get<PCSX::SPU::Chan::ActFreq>().value !=
+                pChannel->data.get<PCSX::SPU::Chan::UsedFreq>().value)  // new psx frequency?
+                VoiceChangeFrequency(pChannel);
 
-                            // -------------------------------------- //
-                            for (nSample = 0; nSample < 28; start++) {
-                                d = (int)*start;
-                                s = ((d & 0xf) << 12);
-                                if (s & 0x8000) s |= 0xffff0000;
+            m_voiceLeft[ch] = pChannel->data.get<PCSX::SPU::Chan::LeftVolume>().value;
+            m_voiceRight[ch] = pChannel->data.get<PCSX::SPU::Chan::RightVolume>().value;
 
-                                fa = (s >> shift_factor);
-                                fa = fa + ((s_1 * f[predict_nr][0]) >> 6) + ((s_2 * f[predict_nr][1]) >> 6);
-                                s_2 = s_1;
-                                s_1 = fa;
-                                s = ((d & 0xf0) << 8);
+            ns = 0;
 
-                                pChannel->data.get<PCSX::SPU::Chan::SB>().value[nSample++].value = fa;
+            while (ns < count)  // loop until 1 ms of data is reached
+            {
+                NoiseClock();
 
-                                if (s & 0x8000) s |= 0xffff0000;
-                                fa = (s >> shift_factor);
-                                fa = fa + ((s_1 * f[predict_nr][0]) >> 6) + ((s_2 * f[predict_nr][1]) >> 6);
-                                s_2 = s_1;
-                                s_1 = fa;
+                if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 1 && iFMod[ns])  // fmod freq channel
+                    FModChangeFrequency(pChannel, ns);
 
-                                pChannel->data.get<PCSX::SPU::Chan::SB>().value[nSample++].value = fa;
-                            }
+                while (pChannel->data.get<PCSX::SPU::Chan::spos>().value >= 0x10000L) {
+                    if (pChannel->data.get<PCSX::SPU::Chan::SBPos>().value == 28)  // 28 reached?
+                    {
+                        start = pChannel->pCurr;  // set up the current pos
 
-                            //////////////////////////////////////////// irq check
-
-                            if ((spuCtrl & ControlFlags::IRQEnable))  // some callback and irq active?
-                            {
-                                if ((pSpuIrq > start - 16 &&  // irq address reached?
-                                     pSpuIrq <= start) ||
-                                    ((flags & 1) &&  // special: irq on looping addr, when stop/loop flag is set
-                                     (pSpuIrq > pChannel->pLoop - 16 && pSpuIrq <= pChannel->pLoop))) {
-                                    pChannel->data.get<PCSX::SPU::Chan::IrqDone>().value = 1;  // -> debug flag
-                                    scheduleInterrupt();                                       // -> call main emu
-
-                                    if (settings.get<SPUIRQWait>())  // -> option: wait after irq for main emu
-                                    {
-                                        iSpuAsyncWait = 1;
-                                        bIRQReturn = 1;
-                                    }
-                                }
+                        if (start == (uint8_t *)-1)  // special "stop" sign
+                        {
+                            pChannel->data.get<PCSX::SPU::Chan::On>().value = false;  // -> turn everything off
+                            pChannel->ADSRX.get<exVolume>().value = 0;
+                            pChannel->ADSRX.get<exEnvelopeVol>().value = 0;
+                            // Although the voices may stop outputting audio, the capture buffer is still filling
+                            // up. At this point, ns samples are already filled, we need (count-ns) more samples.
+                            if (pMixIrq && ch == 1) {
+                                for (int c = ns; c < count; c++) spuMem[tmpCapVoice1Index + c + 0x400] = 0;
+                                tmpCapVoice1Index = (tmpCapVoice1Index + (count - ns)) % 0x200;
+                            } else if (pMixIrq && ch == 3) {
+                                for (int c = ns; c < count; c++) spuMem[tmpCapVoice3Index + c + 0x600] = 0;
+                                tmpCapVoice3Index = (tmpCapVoice3Index + (count - ns)) % 0x200;
                             }
+                            goto ENDX;  // -> and done for this channel
+                        }
 
-                            //////////////////////////////////////////// flag handler
-
-                            if ((flags & 4) && (!pChannel->data.get<PCSX::SPU::Chan::IgnoreLoop>().value))
-                                pChannel->pLoop = start - 16;  // loop adress
-
-                            if (flags & 1)  // 1: stop/loop
-                            {
-                                // We play this block out first...
-                                // if(!(flags&2))                          // 1+2: do loop... otherwise: stop
-                                if (flags != 3 ||
-                                    pChannel->pLoop == NULL)  // PETE: if we don't check exactly for 3, loop hang
-                                                              // ups will happen (DQ4, for example)
-                                {                             // and checking if pLoop is set avoids crashes, yeah
-                                    start = (uint8_t *)-1;
-                                } else {
-                                    start = pChannel->pLoop;
-                                }
-                            }
+                        pChannel->data.get<PCSX::SPU::Chan::SBPos>().value = 0;
 
-                            pChannel->pCurr = start;  // store values for next cycle
-                            pChannel->data.get<PCSX::SPU::Chan::s_1>().value = s_1;
-                            pChannel->data.get<PCSX::SPU::Chan::s_2>().value = s_2;
+                        //////////////////////////////////////////// spu irq handler here? mmm... do it later
 
-                            ////////////////////////////////////////////
+                        s_1 = pChannel->data.get<PCSX::SPU::Chan::s_1>().value;
+                        s_2 = pChannel->data.get<PCSX::SPU::Chan::s_2>().value;
 
-                            if (bIRQReturn)  // special return for "spu irq - wait for cpu action"
-                            {
-                                using namespace std::chrono_literals;
-                                bIRQReturn = 0;
-                                auto dwWatchTime = std::chrono::steady_clock::now() + 2500ms;
+                        predict_nr = (int)*start;
+                        start++;
+                        shift_factor = predict_nr & 0xf;
+                        predict_nr >>= 4;
+                        flags = (int)*start;
+                        start++;
 
-                                while (iSpuAsyncWait && !bEndThread && std::chrono::steady_clock::now() < dwWatchTime) {
-                                    std::this_thread::sleep_for(1ms);
+                        // -------------------------------------- //
+                        // Looping samples go through the same blocks, with the same filter state, over and
+                        // over again, so their decoded output is cached. The capture buffers and the reverb work
+                        // area get written to by the mixer itself, so anything in there is decoded every time.
+                        {
+                            const uint32_t blockAddress = start - 2 - spuMemC;
+                            const bool cacheable =
+                                blockAddress >= 0x1000 && blockAddress + 16 <= sizeof(spuMem) &&
+                                (!rvb.StartAddr || blockAddress + 16 <= uint32_t(rvb.StartAddr) * 2);
+                            auto &SB = pChannel->data.get<PCSX::SPU::Chan::SB>().value;
+                            uint32_t generation = 0;
+                            const int *decoded =
+                                cacheable ? m_adpcmCache.lookup(blockAddress, s_1, s_2, generation) : nullptr;
+
+                            if (decoded) {
+                                for (nSample = 0; nSample < 28; nSample++) SB[nSample].value = decoded[nSample];
+                                s_1 = decoded[27];
+                                s_2 = decoded[26];
+                                start += 14;
+                            } else {
+                                const int s_1In = s_1;
+                                const int s_2In = s_2;
+                                int samples[28];
+
+                                for (nSample = 0; nSample < 28; start++) {
+                                    d = (int)*start;
+                                    s = ((d & 0xf) << 12);
+                                    if (s & 0x8000) s |= 0xffff0000;
+
+                                    fa = (s >> shift_factor);
+                                    fa = fa + ((s_1 * f[predict_nr][0]) >> 6) + ((s_2 * f[predict_nr][1]) >> 6);
+                                    s_2 = s_1;
+                                    s_1 = fa;
+                                    s = ((d & 0xf0) << 8);
+
+                                    samples[nSample++] = fa;
+
+                                    if (s & 0x8000) s |= 0xffff0000;
+                                    fa = (s >> shift_factor);
+                                    fa = fa + ((s_1 * f[predict_nr][0]) >> 6) + ((s_2 * f[predict_nr][1]) >> 6);
+                                    s_2 = s_1;
+                                    s_1 = fa;
+
+                                    samples[nSample++] = fa;
                                 }
+
+                                for (nSample = 0; nSample < 28; nSample++) SB[nSample].value = samples[nSample];
+                                if (cacheable) m_adpcmCache.store(blockAddress, generation, s_1In, s_2In, samples);
                             }
+                        }
 
-                            ////////////////////////////////////////////
+                        //////////////////////////////////////////// irq check
 
-                        GOON:;
+                        if ((spuCtrl & ControlFlags::IRQEnable))  // some callback and irq active?
+                        {
+                            if ((pSpuIrq > start - 16 &&  // irq address reached?
+                                 pSpuIrq <= start) ||
+                                ((flags & 1) &&  // special: irq on looping addr, when stop/loop flag is set
+                                 (pSpuIrq > pChannel->pLoop - 16 && pSpuIrq <= pChannel->pLoop))) {
+                                pChannel->data.get<PCSX::SPU::Chan::IrqDone>().value = 1;  // -> debug flag
+                                scheduleInterrupt();                                       // -> call main emu
+
+                                // -> option: wait after irq for main emu, which can't happen when we're running
+                                // on its thread
+                                if (m_irqWait && !m_synchronous)
+                                {
+                                    iSpuAsyncWait = 1;
+                                    bIRQReturn = 1;
+                                }
+                            }
                         }
 
-                        fa = pChannel->data.get<PCSX::SPU::Chan::SB>()
-                                 .value[pChannel->data.get<PCSX::SPU::Chan::SBPos>().value++]
-                                 .value;  // get sample data
+                        //////////////////////////////////////////// flag handler
 
-                        StoreInterpolationVal(pChannel, fa);  // store val for later interpolation
+                        if ((flags & 4) && (!pChannel->data.get<PCSX::SPU::Chan::IgnoreLoop>().value))
+                            pChannel->pLoop = start - 16;  // loop adress
 
-                        pChannel->data.get<PCSX::SPU::Chan::spos>().value -= 0x10000L;
-                    }
+                        if (flags & 1)  // 1: stop/loop
+                        {
+                            // We play this block out first...
+                            // if(!(flags&2))                          // 1+2: do loop... otherwise: stop
+                            if (flags != 3 ||
+                                pChannel->pLoop == NULL)  // PETE: if we don't check exactly for 3, loop hang
+                                                          // ups will happen (DQ4, for example)
+                            {                             // and checking if pLoop is set avoids crashes, yeah
+                                start = (uint8_t *)-1;
+                            } else {
+                                start = pChannel->pLoop;
+                            }
+                        }
 
-                    ////////////////////////////////////////////////
-
-                    if (pChannel->data.get<PCSX::SPU::Chan::Noise>().value)
-                        fa = iGetNoiseVal(pChannel);  // get noise val
-                    else
-                        fa = iGetInterpolationVal(pChannel);  // get sample val
-
-                    int32_t mixedSample = (m_adsr.mix(pChannel) * fa) / 1023;  // mix adsr
-                    pChannel->data.get<PCSX::SPU::Chan::sval>().value = mixedSample;
-
-                    // Capture buffer should contain voice1/3 sample after any adsr processing but before volume
-                    // processing?
-                    mixedSample = std::min(0xFFFF, std::max(-0xFFFF, mixedSample));
-                    if (pMixIrq && ch == 1) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        spuMem[tmpCapVoice1Index + 0x400] = mixedSample;
-                        tmpCapVoice1Index = (tmpCapVoice1Index + 1) % 0x200;
-                    } else if (pMixIrq && ch == 3) {
-                        std::unique_lock<std::mutex> lock(cbMtx);
-                        spuMem[tmpCapVoice3Index + 0x600] = mixedSample;
-                        tmpCapVoice3Index = (tmpCapVoice3Index + 1) % 0x200;
-                    }
+                        pChannel->pCurr = start;  // store values for next cycle
+                        pChannel->data.get<PCSX::SPU::Chan::s_1>().value = s_1;
+                        pChannel->data.get<PCSX::SPU::Chan::s_2>().value = s_2;
 
-                    if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 2)  // fmod freq channel
-                        iFMod[ns] = pChannel->data.get<PCSX::SPU::Chan::sval>()
-                                        .value;  // -> store 1T sample data, use that to do fmod on next channel
-                    else                         // no fmod freq channel
-                    {
-                        //////////////////////////////////////////////
-                        // ok, left/right sound volume (psx volume goes from 0 ... 0x3fff)
-
-                        if (pChannel->data.get<PCSX::SPU::Chan::Mute>().value &&
-                            !pChannel->data.get<PCSX::SPU::Chan::Solo>().value)
-                            pChannel->data.get<PCSX::SPU::Chan::sval>().value = 0;  // debug mute
-                        else {
-                            SSumL[ns] += (pChannel->data.get<PCSX::SPU::Chan::sval>().value *
-                                          pChannel->data.get<PCSX::SPU::Chan::LeftVolume>().value) /
-                                         0x4000L;
-                            SSumR[ns] += (pChannel->data.get<PCSX::SPU::Chan::sval>().value *
-                                          pChannel->data.get<PCSX::SPU::Chan::RightVolume>().value) /
-                                         0x4000L;
+                        ////////////////////////////////////////////
+
+                        if (bIRQReturn)  // special return for "spu irq - wait for cpu action"
+                        {
+                            using namespace std::chrono_literals;
+                            bIRQReturn = 0;
+                            auto dwWatchTime = std::chrono::steady_clock::now() + 2500ms;
+
+                            while (iSpuAsyncWait && !bEndThread && std::chrono::steady_clock::now() < dwWatchTime) {
+                                std::this_thread::sleep_for(1ms);
+                            }
                         }
 
-                        //////////////////////////////////////////////
-                        // now let us store sound data for reverb
+                        ////////////////////////////////////////////
 
-                        if (pChannel->data.get<PCSX::SPU::Chan::RVBActive>().value) StoreREVERB(pChannel, ns);
+                    GOON:;
                     }
 
-                    ////////////////////////////////////////////////
-                    // ok, go on until 1 ms data of this channel is collected
+                    fa = pChannel->data.get<PCSX::SPU::Chan::SB>()
+                             .value[pChannel->data.get<PCSX::SPU::Chan::SBPos>().value++]
+                             .value;  // get sample data
 
-                    ns++;
-                    pChannel->data.get<PCSX::SPU::Chan::spos>().value +=
-                        pChannel->data.get<PCSX::SPU::Chan::sinc>().value;
-                }
-            ENDX:;
-            }
-        }
+                    StoreInterpolationVal(pChannel, fa);  // store val for later interpolation
 
-        // Write from our temporary capture buffer to the actual SPU RAM.
-        writeCaptureBufferCD(NSSIZE);
+                    pChannel->data.get<PCSX::SPU::Chan::spos>().value -= 0x10000L;
+                }
 
-        //---------------------------------------------------//
-        //- here we have another 1 ms of sound data
-        //---------------------------------------------------//
+                ////////////////////////////////////////////////
+
+                if (pChannel->data.get<PCSX::SPU::Chan::Noise>().value)
+                    fa = iGetNoiseVal(pChannel);  // get noise val
+                else
+                    fa = iGetInterpolationVal(pChannel);  // get sample val
+
+                int32_t mixedSample = (m_adsr.mix(pChannel) * fa) / 1023;  // mix adsr
+                pChannel->data.get<PCSX::SPU::Chan::sval>().value = mixedSample;
+
+                // Capture buffer should contain voice1/3 sample after any adsr processing but before volume
+                // processing?
+                mixedSample = std::min(0xFFFF, std::max(-0xFFFF, mixedSample));
+                if (pMixIrq && ch == 1) {
+                    spuMem[tmpCapVoice1Index + 0x400] = mixedSample;
+                    tmpCapVoice1Index = (tmpCapVoice1Index + 1) % 0x200;
+                } else if (pMixIrq && ch == 3) {
+                    spuMem[tmpCapVoice3Index + 0x600] = mixedSample;
+                    tmpCapVoice3Index = (tmpCapVoice3Index + 1) % 0x200;
+                }
 
-        ///////////////////////////////////////////////////////
-        // mix all channels (including reverb) into one buffer
+                if (pChannel->data.get<PCSX::SPU::Chan::FMod>().value == 2)  // fmod freq channel
+                    iFMod[ns] = pChannel->data.get<PCSX::SPU::Chan::sval>()
+                                    .value;  // -> store 1T sample data, use that to do fmod on next channel
+                else                         // no fmod freq channel
+                {
+                    //////////////////////////////////////////////
+                    // ok, left/right sound volume (psx volume goes from 0 ... 0x3fff)
 
-        for (ns = 0; ns < NSSIZE; ns++) {
-            SSumL[ns] += MixREVERBLeft(ns);
+                    if (pChannel->data.get<PCSX::SPU::Chan::Mute>().value &&
+                        !pChannel->data.get<PCSX::SPU::Chan::Solo>().value)
+                        pChannel->data.get<PCSX::SPU::Chan::sval>().value = 0;  // debug mute
+                    else  // -> the volumes get applied to all the voices at once, after this loop
+                        m_voiceSamples[ns][ch] = pChannel->data.get<PCSX::SPU::Chan::sval>().value;
 
-            d = SSumL[ns] / voldiv;
-            SSumL[ns] = 0;
-            if (d < -32767) d = -32767;
-            if (d > 32767) d = 32767;
-            *pS++ = d;
+                    //////////////////////////////////////////////
+                    // now let us store sound data for reverb
 
-            SSumR[ns] += MixREVERBRight();
+                    if (pChannel->data.get<PCSX::SPU::Chan::RVBActive>().value) StoreREVERB(pChannel, ns);
+                }
 
-            d = SSumR[ns] / voldiv;
-            SSumR[ns] = 0;
-            if (d < -32767) d = -32767;
-            if (d > 32767) d = 32767;
-            *pS++ = d;
-        }
+                ////////////////////////////////////////////////
+                // ok, go on until 1 ms data of this channel is collected
 
-        //////////////////////////////////////////////////////
-        // special irq handling in the decode buffers (0x0000-0x1000)
-        // we know:
-        // the decode buffers are located in spu memory in the following way:
-        // 0x0000-0x03ff  CD audio left
-        // 0x0400-0x07ff  CD audio right
-        // 0x0800-0x0bff  Voice 1
-        // 0x0c00-0x0fff  Voice 3
-        // and decoded data is 16 bit for one sample
-        // we assume:
-        // even if voices 1/3 are off or no cd audio is playing, the internal
-        // play positions will move on and wrap after 0x400 bytes.
-        // Therefore: we just need a pointer from spumem+0 to spumem+3ff, and
-        // increase this pointer on each sample by 2 bytes. If this pointer
-        // (or 0x400 offsets of this pointer) hits the spuirq address, we generate
-        // an IRQ. Only problem: the "wait for cpu" option is kinda hard to do here
-        // in some of Peops timer modes. So: we ignore this option here (for now).
-        // Also note: we abuse the channel 0-3 irq debug display for those irqs
-        // (since that's the easiest way to display such irqs in debug mode :))
-
-        if (pMixIrq)  // pMixIRQ will only be set, if the config option is active
-        {
-            for (ns = 0; ns < NSSIZE; ns++) {
-                if ((spuCtrl & ControlFlags::IRQEnable) && pSpuIrq && pSpuIrq < spuMemC + 0x1000) {
-                    for (ch = 0; ch < 4; ch++) {
-                        if (pSpuIrq >= pMixIrq + (ch * 0x400) && pSpuIrq < pMixIrq + (ch * 0x400) + 2) {
-                            scheduleInterrupt();
-                            s_chan[ch].data.get<PCSX::SPU::Chan::IrqDone>().value = 1;
-                        }
-                    }
-                }
-                pMixIrq += 2;
-                if (pMixIrq > spuMemC + 0x3ff) pMixIrq = spuMemC;
+                ns++;
+                pChannel->data.get<PCSX::SPU::Chan::spos>().value +=
+                    pChannel->data.get<PCSX::SPU::Chan::sinc>().value;
             }
+        ENDX:;
         }
+    }
 
-        InitREVERB();
+    m_voiceMix(m_voiceSamples, count, m_voiceLeft, m_voiceRight, SSumL, SSumR);
 
-        //////////////////////////////////////////////////////
-        // feed the sound
-        // wanna have around 1/60 sec (16.666 ms) updates
+    // Write from our temporary capture buffer to the actual SPU RAM.
+    writeCaptureBufferCD(count);
 
-        if (iCycle++ > 16) {
-            bool done = false;
-            while (!done) {
-                done =
-                    m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(pSpuBuffer),
-                                              (((uint8_t *)pS) - ((uint8_t *)pSpuBuffer)) / sizeof(MiniAudio::Frame));
-                if (bEndThread) {
-                    bThreadEnded = 1;
-                    return;
+    MixREVERB(count);
+
+    //---------------------------------------------------//
+    //- here we have another 1 ms of sound data
+    //---------------------------------------------------//
+
+    ///////////////////////////////////////////////////////
+    // mix all channels (including reverb) into one buffer
+
+    for (ns = 0; ns < count; ns++) {
+        d = SSumL[ns] / voldiv;
+        SSumL[ns] = 0;
+        if (d < -32767) d = -32767;
+        if (d > 32767) d = 32767;
+        *pS++ = d;
+
+        d = SSumR[ns] / voldiv;
+        SSumR[ns] = 0;
+        if (d < -32767) d = -32767;
+        if (d > 32767) d = 32767;
+        *pS++ = d;
+    }
+
+    //////////////////////////////////////////////////////
+    // special irq handling in the decode buffers (0x0000-0x1000)
+    // we know:
+    // the decode buffers are located in spu memory in the following way:
+    // 0x0000-0x03ff  CD audio left
+    // 0x0400-0x07ff  CD audio right
+    // 0x0800-0x0bff  Voice 1
+    // 0x0c00-0x0fff  Voice 3
+    // and decoded data is 16 bit for one sample
+    // we assume:
+    // even if voices 1/3 are off or no cd audio is playing, the internal
+    // play positions will move on and wrap after 0x400 bytes.
+    // Therefore: we just need a pointer from spumem+0 to spumem+3ff, and
+    // increase this pointer on each sample by 2 bytes. If this pointer
+    // (or 0x400 offsets of this pointer) hits the spuirq address, we generate
+    // an IRQ. Only problem: the "wait for cpu" option is kinda hard to do here
+    // in some of Peops timer modes. So: we ignore this option here (for now).
+    // Also note: we abuse the channel 0-3 irq debug display for those irqs
+    // (since that's the easiest way to display such irqs in debug mode :))
+
+    if (pMixIrq)  // pMixIRQ will only be set, if the config option is active
+    {
+        for (ns = 0; ns < count; ns++) {
+            if ((spuCtrl & ControlFlags::IRQEnable) && pSpuIrq && pSpuIrq < spuMemC + 0x1000) {
+                for (ch = 0; ch < 4; ch++) {
+                    if (pSpuIrq >= pMixIrq + (ch * 0x400) && pSpuIrq < pMixIrq + (ch * 0x400) + 2) {
+                        scheduleInterrupt();
+                        s_chan[ch].data.get<PCSX::SPU::Chan::IrqDone>().value = 1;
+                    }
                 }
             }
-            pS = (int16_t *)pSpuBuffer;
-            iCycle = 0;
+            pMixIrq += 2;
+            if (pMixIrq > spuMemC + 0x3ff) pMixIrq = spuMemC;
         }
     }
 
-    // end of big main loop...
+    InitREVERB();
+}
 
-    bThreadEnded = 1;
+// Called from the CD side, which is the producer of the temporary CD capture buffer.
+void PCSX::SPU::impl::pushCaptureBufferCD(int16_t left, int16_t right) {
+    const int32_t endIndex = captureBuffer.endIndex.load(std::memory_order_relaxed);
+    const int32_t nextIndex = (endIndex + 1) % CaptureBuffer::CB_SIZE;
+    captureBuffer.CDCapLeft[endIndex] = (uint16_t)left;
+    captureBuffer.CDCapRight[endIndex] = (uint16_t)right;
+    captureBuffer.endIndex.store(nextIndex, std::memory_order_release);
+    if (nextIndex == captureBuffer.startIndex.load(std::memory_order_acquire)) {
+        g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
+    }
 }
 
+// Called from the mixer, which is the consumer of the temporary CD capture buffer.
 void PCSX::SPU::impl::writeCaptureBufferCD(int numbSamples) {
     if (pMixIrq) {
-        std::unique_lock<std::mutex> lock(cbMtx);
+        int32_t startIndex = captureBuffer.startIndex.load(std::memory_order_relaxed);
+        const int32_t endIndex = captureBuffer.endIndex.load(std::memory_order_acquire);
         for (int n = 0; n < numbSamples; n++) {
-            if (captureBuffer.startIndex == captureBuffer.endIndex) {
+            if (startIndex == endIndex) {
                 // If there are no samples left in the temp buffer,
                 // we still HAVE to keep writing to the capture buffer.
                 spuMem[captureBuffer.currIndex] = 0;
                 spuMem[captureBuffer.currIndex + 0x200] = 0;
             } else {
-                spuMem[captureBuffer.currIndex] = captureBuffer.CDCapLeft[captureBuffer.startIndex];
-                spuMem[captureBuffer.currIndex + 0x200] = captureBuffer.CDCapRight[captureBuffer.startIndex];
-                captureBuffer.startIndex = (captureBuffer.startIndex + 1) % CaptureBuffer::CB_SIZE;
+                spuMem[captureBuffer.currIndex] = captureBuffer.CDCapLeft[startIndex];
+                spuMem[captureBuffer.currIndex + 0x200] = captureBuffer.CDCapRight[startIndex];
+                startIndex = (startIndex + 1) % CaptureBuffer::CB_SIZE;
             }
             captureBuffer.currIndex = (captureBuffer.currIndex + 1) % 0x200;
         }
+        captureBuffer.startIndex.store(startIndex, std::memory_order_release);
         // Update the capture buffer voice index, which in the end, should be the same as
         // tmpCapVoice1Index, tmpCapVoice3Index and captureBuffer.currIndex.
         // Unless I'm missing something in Pete's code.
@@ -850,6 +904,26 @@ void PCSX::SPU::impl::writeCaptureBufferCD(int numbSamples) {
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::async(uint32_t cycle) {
+    if (m_synchronous) {
+        if (!bSPUIsOpen) return;
+        // mix exactly as many samples as the elapsed cycles are worth, so the output only depends on the emulation
+        m_syncCycles += cycle;
+        while (m_syncCycles >= CYCLES_PER_SAMPLE) {
+            const int count = std::min<uint32_t>(m_syncCycles / CYCLES_PER_SAMPLE, NSSIZE);
+            m_syncCycles -= count * CYCLES_PER_SAMPLE;
+            const auto mixStart = AudioTelemetry::Clock::now();
+            mixSamples(count);
+            m_audioOut.getTelemetry().mixTime.add(
+                AudioTelemetry::mixTimePerMs(AudioTelemetry::Clock::now() - mixStart, count));
+            // never block the emulation on a full stream: the audio pacing from the counters keeps it from
+            // filling up at normal speed, and it's fine to drop samples when fast forwarding
+            m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(pSpuBuffer), count, 0,
+                                      std::chrono::milliseconds{0});
+            pS = (int16_t *)pSpuBuffer;
+        }
+        return;
+    }
+
     if (iSpuAsyncWait) {
         iSpuAsyncWait++;
         if (iSpuAsyncWait <= 64) return;
@@ -862,7 +936,7 @@ void PCSX::SPU::impl::async(uint32_t cycle) {
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::playADPCMchannel(xa_decode_t *xap) {
-    if (!settings.get<Streaming>()) return;  // no XA? bye
+    if (!m_streaming) return;  // no XA? bye
     if (!xap) return;
     if (!xap->freq) return;  // no xa freq ? bye
 
@@ -911,7 +985,15 @@ void PCSX::SPU::impl::SetupThread() {
     bThreadEnded = 0;
     bSpuInit = 1;  // flag: we are inited
 
-    hMainThread = std::thread([this]() { MainThread(); });
+    m_syncCycles = 0;
+    // nothing would pace the mixing thread when dumping the audio, so it's the emulated time driving it instead
+    m_synchronous = settings.get<Synchronous>() || m_audioOut.isOffline();
+    if (!m_synchronous) {
+        hMainThread = std::thread([this, context = EmulatorContext::current()]() {
+            EmulatorContext::Scope scope(context);
+            MainThread();
+        });
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -921,13 +1003,15 @@ void PCSX::SPU::impl::SetupThread() {
 void PCSX::SPU::impl::RemoveThread() {
     bEndThread = 1;  // raise flag to end thread
 
-    using namespace std::chrono_literals;
-    while (!bThreadEnded) {
+    if (hMainThread.joinable()) {
+        using namespace std::chrono_literals;
+        while (!bThreadEnded) {
+            std::this_thread::sleep_for(5ms);
+        }  // -> wait till thread has ended
         std::this_thread::sleep_for(5ms);
-    }  // -> wait till thread has ended
-    std::this_thread::sleep_for(5ms);
 
-    hMainThread.join();
+        hMainThread.join();
+    }
 
     bThreadEnded = 0;  // no more spu is running
     bSpuInit = 0;
@@ -942,7 +1026,7 @@ void PCSX::SPU::impl::SetupStreams() {
 
     pSpuBuffer = (uint8_t *)malloc(32768);  // alloc mixing buffer
 
-    if (settings.get<Reverb>() == 1)
+    if (m_reverb == 1)
         i = 88200 * 2;
     else
         i = NSSIZE * 2;
@@ -1050,6 +1134,34 @@ void PCSX::SPU::impl::playCDDAchannel(int16_t *data, int size) {
     FeedXA(&m_cdda);
 }
 
+static void pushRollingStat(PCSX::Lua L, const PCSX::SPU::RollingStat &stat) {
+    using PCSX::SPU::RollingStat;
+    const auto snapshot = stat.snapshot();
+    L.newtable();
+    L.push(lua_Number(snapshot.count));
+    L.setfield("count");
+    L.push(lua_Number(snapshot.min));
+    L.setfield("min");
+    L.push(lua_Number(snapshot.max));
+    L.setfield("max");
+    L.push(lua_Number(snapshot.mean));
+    L.setfield("mean");
+    L.push(lua_Number(snapshot.p50));
+    L.setfield("p50");
+    L.push(lua_Number(snapshot.p99));
+    L.setfield("p99");
+    L.newtable();
+    for (unsigned bin = 0; bin < RollingStat::c_bins; bin++) {
+        L.newtable();
+        L.push(lua_Number(RollingStat::binStart(bin)));
+        L.setfield("from");
+        L.push(lua_Number(snapshot.histogram[bin]));
+        L.setfield("count");
+        L.setfield(bin + 1);
+    }
+    L.setfield("histogram");
+}
+
 void PCSX::SPU::impl::setLua(Lua L) {
     L.getfieldtable("PCSX", LUA_GLOBALSINDEX);
     L.getfieldtable("settings");
@@ -1057,5 +1169,36 @@ void PCSX::SPU::impl::setLua(Lua L) {
     settings.pushValue(L);
     L.settable();
     L.pop();
+    L.getfieldtable("SPU");
+    L.declareFunc(
+        "getAudioTelemetry",
+        [this](Lua L) -> int {
+            auto &telemetry = m_audioOut.getTelemetry();
+            L.newtable();
+            pushRollingStat(L, telemetry.bufferFill);
+            L.setfield("bufferFill");
+            pushRollingStat(L, telemetry.cdBufferFill);
+            L.setfield("cdBufferFill");
+            pushRollingStat(L, telemetry.latency);
+            L.setfield("latency");
+            pushRollingStat(L, telemetry.goalWait);
+            L.setfield("goalWait");
+            pushRollingStat(L, telemetry.mixTime);
+            L.setfield("mixTime");
+            L.push(lua_Number(telemetry.underruns()));
+            L.setfield("underruns");
+            L.push(lua_Number(telemetry.underrunFrames()));
+            L.setfield("underrunFrames");
+            return 1;
+        },
+        -1);
+    L.declareFunc(
+        "resetAudioTelemetry",
+        [this](Lua L) -> int {
+            m_audioOut.getTelemetry().reset();
+            return 0;
+        },
+        -1);
+    L.pop();
     L.pop();
 }
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/voicemix.h"
+
+#include "spu/simd.h"
+
+namespace {
+
+using PCSX::SPU::VoiceMix::c_voices;
+using PCSX::SPU::VoiceMix::VoiceSamples;
+
+static_assert((c_voices % 4) == 0, "The kernels process the voices 4 at a time");
+
+void mixScalar(const VoiceSamples* samples, unsigned count, const int32_t* left, const int32_t* right, int* sumL,
+               int* sumR) {
+    for (unsigned n = 0; n < count; n++) {
+        int l = 0, r = 0;
+        for (unsigned v = 0; v < c_voices; v++) {
+            l += (samples[n][v] * left[v]) / 0x4000;
+            r += (samples[n][v] * right[v]) / 0x4000;
+        }
+        sumL[n] += l;
+        sumR[n] += r;
+    }
+}
+
+#if defined(SPU_SIMD_SSE2)
+using PCSX::SPU::SIMD::horizontalSumSSE2;
+using PCSX::SPU::SIMD::mulLow32SSE2;
+using PCSX::SPU::SIMD::scaleSSE2;
+
+void mixSSE2(const VoiceSamples* samples, unsigned count, const int32_t* left, const int32_t* right, int* sumL,
+             int* sumR) {
+    constexpr unsigned c_vectors = c_voices / 4;
+    __m128i leftVolumes[c_vectors], rightVolumes[c_vectors];
+    for (unsigned i = 0; i < c_vectors; i++) {
+        leftVolumes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i * 4));
+        rightVolumes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i * 4));
+    }
+
+    for (unsigned n = 0; n < count; n++) {
+        __m128i l = _mm_setzero_si128();
+        __m128i r = _mm_setzero_si128();
+        for (unsigned i = 0; i < c_vectors; i++) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples[n] + i * 4));
+            l = _mm_add_epi32(l, scaleSSE2<14>(mulLow32SSE2(s, leftVolumes[i])));
+            r = _mm_add_epi32(r, scaleSSE2<14>(mulLow32SSE2(s, rightVolumes[i])));
+        }
+        sumL[n] += horizontalSumSSE2(l);
+        sumR[n] += horizontalSumSSE2(r);
+    }
+}
+#endif  // SPU_SIMD_SSE2
+
+#if defined(SPU_SIMD_NEON)
+using PCSX::SPU::SIMD::scaleNEON;
+
+void mixNEON(const VoiceSamples* samples, unsigned count, const int32_t* left, const int32_t* right, int* sumL,
+             int* sumR) {
+    constexpr unsigned c_vectors = c_voices / 4;
+    int32x4_t leftVolumes[c_vectors], rightVolumes[c_vectors];
+    for (unsigned i = 0; i < c_vectors; i++) {
+        leftVolumes[i] = vld1q_s32(left + i * 4);
+        rightVolumes[i] = vld1q_s32(right + i * 4);
+    }
+
+    for (unsigned n = 0; n < count; n++) {
+        int32x4_t l = vdupq_n_s32(0);
+        int32x4_t r = vdupq_n_s32(0);
+        for (unsigned i = 0; i < c_vectors; i++) {
+            const int32x4_t s = vld1q_s32(samples[n] + i * 4);
+            l = vaddq_s32(l, scaleNEON<14>(vmulq_s32(s, leftVolumes[i])));
+            r = vaddq_s32(r, scaleNEON<14>(vmulq_s32(s, rightVolumes[i])));
+        }
+        sumL[n] += vaddvq_s32(l);
+        sumR[n] += vaddvq_s32(r);
+    }
+}
+#endif  // SPU_SIMD_NEON
+
+}  // namespace
+
+std::vector<PCSX::SPU::VoiceMix::MixImplementation> PCSX::SPU::VoiceMix::getSupportedMixImplementations() {
+    std::vector<MixImplementation> implementations = {{"Scalar", mixScalar}};
+#if defined(SPU_SIMD_SSE2)
+    implementations.push_back({"SSE2", mixSSE2});
+#elif defined(SPU_SIMD_NEON)
+    implementations.push_back({"NEON", mixNEON});
+#endif
+    return implementations;
+}
+
+PCSX::SPU::VoiceMix::MixKernel PCSX::SPU::VoiceMix::getMixKernel() {
+    static const MixKernel kernel = getSupportedMixImplementations().back().kernel;
+    return kernel;
+}
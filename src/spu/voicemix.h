@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+namespace SPU {
+
+namespace VoiceMix {
+
+static constexpr unsigned c_voices = 24;
+
+// One row per sample, holding the output of all the voices for it, after the ADSR but before the volume.
+// Voices which aren't playing, are muted, or are only used for frequency modulation, have zeroes there.
+using VoiceSamples = int32_t[c_voices];
+
+// For each of the count samples, adds up the outputs of all the voices, scaled by their left and right volume,
+// into sumL and sumR. Each voice's contribution is (sample * volume) / 0x4000, rounded towards zero, the same way
+// the voice loop used to accumulate them one at a time. The volumes are in the 0..0x3fff range.
+using MixKernel = void (*)(const VoiceSamples* samples, unsigned count, const int32_t* left, const int32_t* right,
+                           int* sumL, int* sumR);
+
+struct MixImplementation {
+    const char* name;
+    MixKernel kernel;
+};
+
+// All the implementations the host CPU can run, from the slowest (the scalar one) to the fastest
+std::vector<MixImplementation> getSupportedMixImplementations();
+
+// The fastest implementation the host CPU can run. Feature detection only happens on the first call.
+MixKernel getMixKernel();
+
+}  // namespace VoiceMix
+
+}  // namespace SPU
+
+}  // namespace PCSX
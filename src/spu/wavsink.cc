@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/wavsink.h"
+
+#include <algorithm>
+#include <bit>
+
+void PCSX::SPU::WavSink::open(IO<File> file) {
+    close();
+    m_file = file;
+    m_frames = 0;
+
+    m_file->writeString("RIFF");
+    m_file->write<uint32_t>(c_headerSize - 8);
+    m_file->writeString("WAVE");
+    m_file->writeString("fmt ");
+    m_file->write<uint32_t>(16);
+    m_file->write<uint16_t>(1);  // PCM
+    m_file->write<uint16_t>(2);
+    m_file->write<uint32_t>(c_sampleRate);
+    m_file->write<uint32_t>(c_sampleRate * 4);
+    m_file->write<uint16_t>(4);
+    m_file->write<uint16_t>(16);
+    m_file->writeString("data");
+    m_file->write<uint32_t>(0);
+}
+
+void PCSX::SPU::WavSink::close() {
+    if (!isOpen()) return;
+    flush();
+    m_file->close();
+    m_file.reset();
+}
+
+void PCSX::SPU::WavSink::write(const int16_t* samples, uint32_t frames) {
+    if (!isOpen()) return;
+    // a WAV file can't go past 4GB, which is a bit more than 6 hours of audio
+    frames = std::min(frames, (0xffffffffu - c_headerSize) / 4 - m_frames);
+    if constexpr (std::endian::native == std::endian::little) {
+        m_file->write(samples, frames * 4);
+    } else {
+        for (uint32_t i = 0; i < frames * 2; i++) m_file->write<uint16_t>(samples[i]);
+    }
+    m_frames += frames;
+}
+
+void PCSX::SPU::WavSink::flush() {
+    if (!isOpen()) return;
+    const uint32_t dataSize = m_frames * 4;
+    m_file->writeAt<uint32_t>(c_headerSize - 8 + dataSize, 4);
+    m_file->writeAt<uint32_t>(dataSize, c_headerSize - 4);
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+namespace SPU {
+
+// Writes the mixed SPU output into a 16 bits stereo 44.1kHz WAV file. The sizes in the header are only
+// known once everything has been written, so they get patched every time flush() is called, which
+// means the file is playable even if the emulator doesn't exit gracefully afterwards.
+class WavSink {
+  public:
+    static constexpr uint32_t c_sampleRate = 44100;
+    static constexpr unsigned c_headerSize = 44;
+
+    ~WavSink() { close(); }
+
+    // The file needs to be both writable and seekable.
+    void open(IO<File> file);
+    void close();
+    bool isOpen() const { return !m_file.isNull(); }
+
+    // The samples are interleaved left / right, and in the host's endianness.
+    void write(const int16_t* samples, uint32_t frames);
+    void flush();
+
+    uint32_t getFramesWritten() const { return m_frames; }
+
+  private:
+    IO<File> m_file;
+    uint32_t m_frames = 0;
+};
+
+}  // namespace SPU
+
+}  // namespace PCSX
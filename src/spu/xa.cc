@@ -41,7 +41,7 @@ static uint16_t hiword(uint32_t v) { return (v >> 16) & 0xffff; }
 ////////////////////////////////////////////////////////////////////////
 
 void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
-    int sinc, spos, i, iSize, vl, vr, voldiv = 4 - settings.get<Volume>();
+    int sinc, spos, i, iSize, vl, vr, voldiv = 4 - m_volume;
 
     MiniAudio::Frame XABuffer[32 * 1024];
     MiniAudio::Frame *XAFeed = XABuffer;
@@ -60,15 +60,12 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
     spos = 0x10000L;
     sinc = (xap->nsamples << 16) / iSize;  // calc freq by num / size
 
-    // We need the lock for capture buffers. The question is, do we put it here or in the inner loop?
-    if (pMixIrq) cbMtx.lock();
-
     if (xap->stereo) {
         uint32_t *pS = (uint32_t *)xap->pcm;
         uint32_t l = 0;
 
         for (i = 0; i < iSize; i++) {
-            if (settings.get<Interpolation>() == 2) {
+            if (m_interpolation == 2) {
                 while (spos >= 0x10000L) {
                     l = *pS++;
                     gauss_window[gauss_ptr] = (int16_t)loword(l);
@@ -97,14 +94,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             MiniAudio::Frame f;
             int16_t rawSampleL = static_cast<int16_t>(l & 0xffff);
             int16_t rawSampleR = static_cast<int16_t>(l >> 16);
-            if (pMixIrq) {
-                captureBuffer.CDCapLeft[captureBuffer.endIndex] = (uint16_t)rawSampleL;
-                captureBuffer.CDCapRight[captureBuffer.endIndex] = (uint16_t)rawSampleR;
-                captureBuffer.endIndex = (captureBuffer.endIndex + 1) % CaptureBuffer::CB_SIZE;
-                if (captureBuffer.endIndex == captureBuffer.startIndex) {
-                    g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
-                }
-            }
+            if (pMixIrq) pushCaptureBufferCD(rawSampleL, rawSampleR);
             f.L = rawSampleL / voldiv;
             f.R = rawSampleR / voldiv;
 
@@ -117,7 +107,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
         int16_t s = 0;
 
         for (i = 0; i < iSize; i++) {
-            if (settings.get<Interpolation>() == 2) {
+            if (m_interpolation == 2) {
                 while (spos >= 0x10000L) {
                     gauss_window[gauss_ptr] = (int16_t)*pS++;
                     gauss_ptr = (gauss_ptr + 1) & 3;
@@ -142,14 +132,7 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             int16_t rawSampleL = static_cast<int16_t>(l & 0xffff);
             int16_t rawSampleR = static_cast<int16_t>(l >> 16);
             // Write the CD-XA samples (left/right) to a temporary buffer. Wrap around if necessary.
-            if (pMixIrq) {
-                captureBuffer.CDCapLeft[captureBuffer.endIndex] = (uint16_t)rawSampleL;
-                captureBuffer.CDCapRight[captureBuffer.endIndex] = (uint16_t)rawSampleR;
-                captureBuffer.endIndex = (captureBuffer.endIndex + 1) % CaptureBuffer::CB_SIZE;
-                if (captureBuffer.endIndex == captureBuffer.startIndex) {
-                    g_system->log(LogClass::SPU, "Capture buffer is overflowing. Increase CB_SIZE.\n");
-                }
-            }
+            if (pMixIrq) pushCaptureBufferCD(rawSampleL, rawSampleR);
 
             f.L = rawSampleL / voldiv;
             f.R = rawSampleR / voldiv;
@@ -157,7 +140,6 @@ void PCSX::SPU::impl::FeedXA(xa_decode_t *xap) {
             spos += sinc;
         }
     }
-    if (pMixIrq) cbMtx.unlock();
 
     m_audioOut.feedStreamData(reinterpret_cast<MiniAudio::Frame *>(XABuffer), (XAFeed - XABuffer), 1);
 }
@@ -0,0 +1,154 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace PCSX {
+
+// A bump allocator, carving allocations out of large blocks, and only ever releasing them all at once.
+// The arena doesn't track what's allocated in it: destroying the objects before calling reset() is up to the caller.
+// The blocks are kept around after a reset, so an arena that's reused for similar workloads stops allocating.
+class Arena {
+  public:
+    static constexpr size_t c_defaultBlockSize = 1024 * 1024;
+
+    explicit Arena(size_t blockSize = c_defaultBlockSize) : m_blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        while (m_current < m_blocks.size()) {
+            auto& block = m_blocks[m_current];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+            const size_t offset = ((base + m_offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+            if (offset + size <= block.size) {
+                m_offset = offset + size;
+                m_used += size;
+                return block.data.get() + offset;
+            }
+            m_current++;
+            m_offset = 0;
+        }
+
+        // Oversized allocations get a block of their own
+        const size_t blockSize = std::max(m_blockSize, size + alignment);
+        m_blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+        return allocate(size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    // Releases the memory of all the blocks, on top of resetting the arena
+    void release() {
+        reset();
+        m_blocks.clear();
+    }
+
+    size_t used() const { return m_used; }
+    size_t capacity() const {
+        size_t capacity = 0;
+        for (auto& block : m_blocks) capacity += block.size;
+        return capacity;
+    }
+
+  private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_current = 0;
+    size_t m_offset = 0;
+    size_t m_used = 0;
+};
+
+// A pool of objects of the same type, on top of an arena: destroyed objects go into a free list, and the next
+// ones created reuse their storage. Like for the arena, the memory only ever grows, until the pool is cleared.
+template <typename T>
+class Pool {
+  public:
+    explicit Pool(size_t count = 256) : m_arena(sizeof(T) * count) {}
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* storage;
+        if (m_free.empty()) {
+            storage = m_arena.allocate(sizeof(T), alignof(T));
+        } else {
+            storage = m_free.back();
+            m_free.pop_back();
+        }
+        m_live++;
+        return new (storage) T(std::forward<Args>(args)...);
+    }
+    void destroy(T* object) {
+        object->~T();
+        m_free.push_back(object);
+        m_live--;
+    }
+
+    // Forgets about all of the objects, which have to be destroyed already, and keeps the storage around.
+    void clear() {
+        m_arena.reset();
+        m_free.clear();
+        m_live = 0;
+    }
+    // Allocates the storage for that many objects upfront.
+    void reserve(size_t count) {
+        m_free.reserve(count);
+        while (m_free.size() < count) m_free.push_back(m_arena.allocate(sizeof(T), alignof(T)));
+    }
+
+    size_t live() const { return m_live; }
+
+  private:
+    Arena m_arena;
+    std::vector<void*> m_free;
+    size_t m_live = 0;
+};
+
+}  // namespace PCSX
@@ -29,10 +29,12 @@ SOFTWARE.
 #include <memory.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
 
 namespace PCSX {
 
@@ -106,4 +108,70 @@ class Circular {
     std::mutex m_mu;
     std::condition_variable m_cv;
 };
+
+// Same interface as Circular, for exactly one thread enqueueing, and exactly one thread dequeueing, such as
+// an audio callback, which mustn't ever block behind a lock held by the thread feeding it. The positions are
+// free running counters, so that a full buffer and an empty one can't be mistaken for each other, and each
+// side only ever writes its own. Dequeueing never waits. Enqueueing, when there isn't enough room, sleeps in
+// short steps until there is, or until its deadline passes, so that the consumer doesn't have to signal it.
+template <typename T, size_t BS = 1024>
+class CircularSPSC {
+    using ms = std::chrono::milliseconds;
+
+  public:
+    static constexpr size_t BUFFER_SIZE = BS;
+    size_t available() const { return BUFFER_SIZE - buffered(); }
+    size_t buffered() const {
+        // The tail first: it can't go past the head loaded after it.
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return std::min(head - tail, BUFFER_SIZE);
+    }
+    bool enqueue(const T* data, size_t N, ms maxWait = ms{200}) {
+        if (N > BUFFER_SIZE) {
+            throw std::runtime_error("Trying to enqueue too much data");
+        }
+        if (!waitForRoom(N, maxWait)) return false;
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        copy(m_buffer, head % BUFFER_SIZE, data, N, true);
+        m_head.store(head + N, std::memory_order_release);
+        return true;
+    }
+    size_t dequeue(T* data, size_t N) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        N = std::min(N, head - tail);
+        copy(data, tail % BUFFER_SIZE, m_buffer, N, false);
+        m_tail.store(tail + N, std::memory_order_release);
+        return N;
+    }
+
+  private:
+    bool waitForRoom(size_t N, ms maxWait) {
+        if (available() >= N) return true;
+        const auto deadline = std::chrono::steady_clock::now() + maxWait;
+        while (available() < N) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+        }
+        return true;
+    }
+    // Copies N elements into or out of the ring, starting at the given index into it.
+    static void copy(T* dst, size_t index, const T* src, size_t N, bool intoRing) {
+        const size_t first = std::min(N, BUFFER_SIZE - index);
+        if (intoRing) {
+            memcpy(dst + index, src, first * sizeof(T));
+            memcpy(dst, src + first, (N - first) * sizeof(T));
+        } else {
+            memcpy(dst, src + index, first * sizeof(T));
+            memcpy(dst + first, src, (N - first) * sizeof(T));
+        }
+    }
+
+    // Each on its own cache line, so that the two threads don't keep stealing it from each other.
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    alignas(64) T m_buffer[BUFFER_SIZE];
+};
+
 }  // namespace PCSX
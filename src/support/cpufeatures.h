@@ -0,0 +1,96 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(__x86_64) || defined(_M_AMD64))
+#include <intrin.h>
+#endif
+
+// MSVC lets us use any intrinsic anywhere, GCC and Clang need to be told which functions may use which extension.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PCSX_TARGET(extension)
+#else
+#define PCSX_TARGET(extension) __attribute__((target(extension)))
+#endif
+
+namespace PCSX {
+
+// Runtime detection of the x86 extensions which the SIMD code paths pick their kernels from. These all return
+// false on other architectures, and are cheap enough to call once when setting things up, but not per call.
+namespace CPUFeatures {
+
+#if (defined(__x86_64) || defined(_M_AMD64)) && defined(_MSC_VER) && !defined(__clang__)
+inline bool hasSSE41() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+}
+
+inline bool hasPCLMUL() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+}
+
+inline bool hasAVX2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // The OS also needs to save the upper halves of the YMM registers on context switches
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+#elif defined(__x86_64) || defined(_M_AMD64)
+inline bool hasSSE41() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+}
+
+inline bool hasPCLMUL() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul");
+}
+
+inline bool hasAVX2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#else
+inline bool hasSSE41() { return false; }
+inline bool hasPCLMUL() { return false; }
+inline bool hasAVX2() { return false; }
+#endif
+
+}  // namespace CPUFeatures
+
+}  // namespace PCSX
@@ -0,0 +1,87 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+
+namespace PCSX {
+
+// Remembers which pages of a block of memory were written to since the last clear(). There's a byte per page
+// rather than a bit, so that marking a page is a single store, which the recompilers can inline next to the
+// writes themselves. Marking is racy on purpose: the only thing which ever gets written is a 1, and whoever
+// clears the map needs to be synchronized with the writers anyway to make sense of the memory.
+class DirtyPages {
+  public:
+    DirtyPages(uint32_t size, unsigned pageShift = 12)
+        : m_pageShift(pageShift), m_pageCount((size + (1 << pageShift) - 1) >> pageShift) {
+        m_pages.reset(new uint8_t[m_pageCount]);
+        markAll();
+    }
+
+    // The offset needs to be within the memory
+    void mark(uint32_t offset) { m_pages[offset >> m_pageShift] = 1; }
+    void markRange(uint32_t offset, uint32_t length) {
+        if (length == 0) return;
+        const uint32_t first = offset >> m_pageShift;
+        uint32_t last = (offset + length - 1) >> m_pageShift;
+        if (last >= m_pageCount) last = m_pageCount - 1;
+        if (first > last) return;
+        memset(m_pages.get() + first, 1, last - first + 1);
+    }
+    void markAll() { memset(m_pages.get(), 1, m_pageCount); }
+    void clear() { memset(m_pages.get(), 0, m_pageCount); }
+
+    bool isDirty(uint32_t page) const { return m_pages[page]; }
+    uint32_t countDirty() const {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < m_pageCount; i++) count += m_pages[i];
+        return count;
+    }
+    template <typename F>
+    void forEachDirty(F&& f) const {
+        for (uint32_t i = 0; i < m_pageCount; i++) {
+            if (m_pages[i]) f(i);
+        }
+    }
+
+    uint32_t pageCount() const { return m_pageCount; }
+    uint32_t pageSize() const { return 1 << m_pageShift; }
+    unsigned pageShift() const { return m_pageShift; }
+    // The map itself, one byte per page, for the recompilers to mark pages from the code they emit
+    uint8_t* data() { return m_pages.get(); }
+
+  private:
+    const unsigned m_pageShift;
+    const uint32_t m_pageCount;
+    std::unique_ptr<uint8_t[]> m_pages;
+};
+
+}  // namespace PCSX
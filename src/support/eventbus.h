@@ -26,33 +26,47 @@ SOFTWARE.
 
 #pragma once
 
-#include <any>
+#include <atomic>
 #include <functional>
 #include <memory>
-#include <typeindex>
-#include <typeinfo>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
-#include "support/hashtable.h"
 #include "support/list.h"
 
 namespace PCSX {
 
 namespace EventBus {
 
+// Every event type gets a small index the first time it's used, so that signalling an event only costs
+// indexing a vector, and a virtual call per listener.
+inline unsigned nextEventIndex() {
+    static std::atomic<unsigned> next = 0;
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+template <typename Event>
+unsigned eventIndex() {
+    static const unsigned index = nextEventIndex();
+    return index;
+}
+
 struct ListenerElementBaseEventBusList {};
 struct ListenerElementBase;
 typedef PCSX::Intrusive::List<ListenerElementBase> ListenerBaseListType;
 typedef PCSX::Intrusive::List<ListenerElementBase, ListenerElementBaseEventBusList> ListenerBaseEventBusList;
 struct ListenerElementBase : public ListenerBaseListType::Node, public ListenerBaseEventBusList::Node {
-    virtual std::any getCB() = 0;
+    virtual ~ListenerElementBase() = default;
 };
-template <typename M>
-struct ListenerElement : public ListenerElementBase {
-    typedef std::function<void(const M&)> Functor;
-    virtual std::any getCB() { return &cb; }
-    ListenerElement(Functor&& cb) : cb(std::move(cb)) {}
-    Functor cb;
+template <typename Event>
+struct TypedListenerElement : public ListenerElementBase {
+    virtual void call(const Event& event) = 0;
+};
+template <typename Event, typename Callback>
+struct ListenerElement final : public TypedListenerElement<Event> {
+    ListenerElement(Callback cb) : cb(std::move(cb)) {}
+    void call(const Event& event) override { cb(event); }
+    Callback cb;
 };
 
 class EventBus;
@@ -61,53 +75,47 @@ class Listener {
   public:
     Listener(std::shared_ptr<EventBus> bus) : m_bus(bus) {}
     ~Listener() { m_listeners.destroyAll(); }
-    template <typename Event>
-    void listen(typename ListenerElement<Event>::Functor&& cb);
+    template <typename Event, typename Callback>
+    void listen(Callback&& cb);
 
   private:
     std::shared_ptr<EventBus> m_bus;
     ListenerBaseListType m_listeners;
 };
 
-struct ListenerElementsHashTableList;
-typedef PCSX::Intrusive::HashTable<std::size_t, ListenerElementsHashTableList> ListenersHashTable;
-struct ListenerElementsHashTableList : public ListenersHashTable::Node {
-    ~ListenerElementsHashTableList() { list.destroyAll(); }
-    ListenerBaseEventBusList list;
-};
-
 class EventBus {
   public:
-    ~EventBus() { m_table.destroyAll(); }
+    ~EventBus() {
+        for (auto& list : m_lists) {
+            if (list) list->destroyAll();
+        }
+    }
     template <typename Event>
     void signal(const Event& event) {
-        using Functor = typename ListenerElement<Event>::Functor;
-        auto list = m_table.find(typeid(Event).hash_code());
-        if (list == m_table.end()) return;
-        for (auto& listener : list->list) {
-            std::any cb = listener.getCB();
-            Functor* func = std::any_cast<Functor*>(cb);
-            (*func)(event);
+        const unsigned index = eventIndex<Event>();
+        if ((index >= m_lists.size()) || !m_lists[index]) return;
+        // Only listeners of this type of event ever go into its list.
+        for (auto& listener : *m_lists[index]) {
+            static_cast<TypedListenerElement<Event>&>(listener).call(event);
         }
     }
 
   private:
-    void listen(std::size_t id, ListenerElementBase* listenerElement) {
-        auto list = m_table.find(id);
-        if (list == m_table.end()) {
-            list = m_table.insert(id, new ListenerElementsHashTableList());
-        }
-        list->list.push_back(listenerElement);
+    void listen(unsigned index, ListenerElementBase* listenerElement) {
+        if (index >= m_lists.size()) m_lists.resize(index + 1);
+        if (!m_lists[index]) m_lists[index] = std::make_unique<ListenerBaseEventBusList>();
+        m_lists[index]->push_back(listenerElement);
     }
-    ListenersHashTable m_table;
+    std::vector<std::unique_ptr<ListenerBaseEventBusList>> m_lists;
     friend class Listener;
 };
 
-template <typename Event>
-void Listener::listen(typename ListenerElement<Event>::Functor&& cb) {
-    ListenerElement<Event>* element = new ListenerElement(std::move(cb));
+template <typename Event, typename Callback>
+void Listener::listen(Callback&& cb) {
+    using Element = ListenerElement<Event, std::decay_t<Callback>>;
+    Element* element = new Element(std::forward<Callback>(cb));
     m_listeners.push_back(element);
-    m_bus->listen(typeid(Event).hash_code(), element);
+    m_bus->listen(eventIndex<Event>(), element);
 }
 
 }  // namespace EventBus
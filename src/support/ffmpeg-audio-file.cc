@@ -27,7 +27,9 @@ SOFTWARE.
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <bit>
+#include <cstring>
 
 AVSampleFormat PCSX::FFmpegAudioFile::getSampleFormat() const {
     switch (m_sampleFormat) {
@@ -65,7 +67,12 @@ unsigned PCSX::FFmpegAudioFile::getSampleSize() const {
 
 PCSX::FFmpegAudioFile::FFmpegAudioFile(IO<File> file, Channels channels, Endianness endianess,
                                        SampleFormat sampleFormat, unsigned frequency)
-    : File(RO_SEEKABLE), m_file(file), m_channels(channels), m_endianess(endianess), m_sampleFormat(sampleFormat) {
+    : File(RO_SEEKABLE),
+      m_file(file),
+      m_channels(channels),
+      m_endianess(endianess),
+      m_sampleFormat(sampleFormat),
+      m_frequency(frequency) {
     av_log_set_level(AV_LOG_QUIET);
 
     unsigned char *buffer = reinterpret_cast<unsigned char *>(av_malloc(4096));
@@ -175,6 +182,7 @@ PCSX::FFmpegAudioFile::FFmpegAudioFile(IO<File> file, Channels channels, Endiann
 }
 
 void PCSX::FFmpegAudioFile::closeInternal() {
+    stopDecoder();
     if (m_ioContext) {
         av_freep(&m_ioContext->buffer);
         avio_context_free(&m_ioContext);
@@ -204,37 +212,76 @@ ssize_t PCSX::FFmpegAudioFile::rSeek(ssize_t pos, int wheel) {
 
 ssize_t PCSX::FFmpegAudioFile::read(void *dest_, size_t size) {
     uint8_t *dest = reinterpret_cast<uint8_t *>(dest_);
-
-    ssize_t dumpDelta = m_filePtr - m_totalOut;
-    if (dumpDelta < 0) {
-        dumpDelta = m_filePtr;
-        m_filePtr = 0;
-        m_hitEOF = false;
-        if (av_seek_frame(m_formatContext, m_audioStreamIndex, 0, AVSEEK_FLAG_BYTE) < 0) return -1;
-        m_totalOut = 0;
+    if (m_failed || m_decoderStopping || (m_filePtr < 0)) return -1;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const size_t start = m_filePtr;
+    const size_t end = start + size;
+    if (!m_decoder.joinable()) m_decoder = std::thread([this]() { decoderLoop(); });
+    if (end > m_wanted) {
+        m_wanted = end;
+        m_readerProgress.notify_one();
     }
-    if (m_hitEOF) return -1;
-    ssize_t ret = 0;
-    while (dumpDelta) {
-        uint8_t dummy[256];
-        ssize_t toDump = std::min(ssize_t(sizeof(dummy)), dumpDelta);
-        ssize_t p = decompSome(dummy, toDump);
-        if (p < 0) return p;
-        dumpDelta -= p;
-        if (m_hitEOF || !p) break;
+    m_decoderProgress.wait(lock, [this, end]() { return m_decoderDone || (m_decoded >= end); });
+
+    if (m_decoderFailed && (m_decoded < end)) return -1;
+    size_t ptr = start;
+    while (ptr < std::min(end, m_decoded)) {
+        const size_t offset = ptr % c_chunkSize;
+        const size_t toCopy = std::min({end, m_decoded, ptr - offset + c_chunkSize}) - ptr;
+        memcpy(dest, m_chunks[ptr / c_chunkSize].get() + offset, toCopy);
+        dest += toCopy;
+        ptr += toCopy;
     }
-    while (size) {
-        if (m_hitEOF) break;
-        ssize_t p = decompSome(dest, size);
-        if (p < 0) return p;
-        if (!p) break;
-        size -= p;
-        ret += p;
-        dest += p;
-        m_filePtr += p;
+    m_filePtr = ptr;
+    m_hitEOF = m_decoderDone && (ptr >= m_decoded);
+    return ptr - start;
+}
+
+void PCSX::FFmpegAudioFile::stopDecoder() {
+    if (!m_decoder.joinable()) return;
+    m_decoderStopping = true;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_readerProgress.notify_one();
     }
+    m_decoder.join();
+}
+
+void PCSX::FFmpegAudioFile::decoderLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_readerProgress.wait(lock, [this]() {
+                return m_decoderStopping || (m_decoded < m_wanted + c_decodeAhead * c_chunkSize);
+            });
+        }
+        if (m_decoderStopping) return;
+
+        std::unique_ptr<uint8_t[]> chunk(new uint8_t[c_chunkSize]);
+        size_t filled = 0;
+        bool failed = false;
+        while ((filled < c_chunkSize) && !m_decoderEOF) {
+            if (m_decoderStopping) return;
+            ssize_t p = decompSome(chunk.get() + filled, c_chunkSize - filled);
+            if (p < 0) {
+                failed = true;
+                break;
+            }
+            filled += p;
+        }
 
-    return ret;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (filled != 0) {
+            m_chunks.push_back(std::move(chunk));
+            m_decoded += filled;
+        }
+        const bool done = failed || m_decoderEOF;
+        m_decoderDone = done;
+        m_decoderFailed = failed;
+        m_decoderProgress.notify_all();
+        if (done) return;
+    }
 }
 
 ssize_t PCSX::FFmpegAudioFile::decompSome(void *dest_, ssize_t size) {
@@ -259,7 +306,6 @@ ssize_t PCSX::FFmpegAudioFile::decompSome(void *dest_, ssize_t size) {
                 }
             }
             m_packetPtr += toCopy;
-            m_totalOut += toCopy;
             size -= toCopy;
             dest += toCopy;
             dataRead += toCopy;
@@ -275,7 +321,7 @@ ssize_t PCSX::FFmpegAudioFile::decompSome(void *dest_, ssize_t size) {
         if (available == 0) {
             while (true) {
                 if (av_read_frame(m_formatContext, m_packet) < 0) {
-                    m_hitEOF = true;
+                    m_decoderEOF = true;
                     return dataRead;
                 }
                 if (m_packet->stream_index != m_audioStreamIndex) {
@@ -34,17 +34,28 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "support/file.h"
 
 namespace PCSX {
 
+// Decoding happens on a thread of its own, started on the first read. It goes through the stream once, in order,
+// and keeps everything it decoded, in chunks of a second of CD audio. The chunks double as the seek index: reading
+// from anywhere which got decoded already is a copy, and reading further waits for the decoder to get there. The
+// decoder stays a few chunks ahead of the furthest read, so tracks only partially played don't get decoded whole.
 class FFmpegAudioFile : public File {
   public:
     enum class Channels { Stereo, Mono };
     enum class Endianness { Little, Big };
     enum class SampleFormat { U8, S16, S32, F32, D64 };
     FFmpegAudioFile(IO<File> file, Channels, Endianness, SampleFormat, unsigned frequency);
-    virtual ~FFmpegAudioFile() {}
+    virtual ~FFmpegAudioFile() { stopDecoder(); }
     virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
     virtual ssize_t rTell() final override { return m_filePtr; }
     virtual ssize_t read(void* dest, size_t size) final override;
@@ -63,6 +74,8 @@ class FFmpegAudioFile : public File {
     AVSampleFormat getSampleFormat() const;
     unsigned getSampleSize() const;
     ssize_t decompSome(void* dest, ssize_t size);
+    void stopDecoder();
+    void decoderLoop();
     IO<File> m_file;
     ssize_t m_filePtr = 0;
     ssize_t m_size = 0;
@@ -80,8 +93,23 @@ class FFmpegAudioFile : public File {
     AVCodecContext* m_codecContext = nullptr;
     SwrContext* m_resamplerContext = nullptr;
     int m_audioStreamIndex = -1;
-    ssize_t m_totalOut = 0;
     size_t m_packetPtr = 0;
+
+    static constexpr size_t c_chunkSize = 2352 * 75;
+    static constexpr size_t c_decodeAhead = 8;
+    std::thread m_decoder;
+    std::atomic<bool> m_decoderStopping = false;
+    // Only touched by the decoder thread.
+    bool m_decoderEOF = false;
+    // Everything below is protected by the mutex. All of the chunks are full, except maybe the last one.
+    std::mutex m_mutex;
+    std::condition_variable m_decoderProgress;
+    std::condition_variable m_readerProgress;
+    std::vector<std::unique_ptr<uint8_t[]>> m_chunks;
+    size_t m_decoded = 0;
+    size_t m_wanted = 0;
+    bool m_decoderDone = false;
+    bool m_decoderFailed = false;
 };
 
 }  // namespace PCSX
@@ -27,6 +27,11 @@ SOFTWARE.
 #include "support/file.h"
 
 #include <algorithm>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif
 
 #include "support/slice.h"
 #include "support/windowswrapper.h"
@@ -116,6 +121,24 @@ ssize_t PCSX::BufferFile::read(void *dest, size_t size) {
     return size;
 }
 
+ssize_t PCSX::BufferFile::readv(const IOVec *vecs, size_t count) {
+    ssize_t ret = readAtv(vecs, count, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::BufferFile::readAtv(const IOVec *vecs, size_t count, size_t ptr) {
+    if (ptr >= m_size) return -1;
+    size_t total = 0;
+    for (size_t i = 0; (i < count) && (ptr < m_size); i++) {
+        size_t size = std::min(m_size - ptr, vecs[i].size);
+        memcpy(vecs[i].data, m_data + ptr, size);
+        ptr += size;
+        total += size;
+    }
+    return total;
+}
+
 ssize_t PCSX::BufferFile::write(const void *src, size_t size) {
     if (!writable()) return -1;
     size_t newSize = m_ptrW + size;
@@ -259,6 +282,28 @@ ssize_t PCSX::PosixFile::read(void *dest, size_t size) {
     return ret;
 }
 
+ssize_t PCSX::PosixFile::readv(const IOVec *vecs, size_t count) {
+    ssize_t ret = readAtv(vecs, count, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::PosixFile::readAtv(const IOVec *vecs, size_t count, size_t ptr) {
+    if (failed()) throw std::runtime_error("Invalid file");
+#if defined(_WIN32)
+    return File::readAtv(vecs, count, ptr);
+#else
+    // A single preadv instead of a seek and a read per buffer. It bypasses the stdio buffers,
+    // so whatever is pending in them needs to go out first.
+    if (writable()) fflush(m_handle);
+    std::vector<iovec> iovs(count);
+    for (size_t i = 0; i < count; i++) iovs[i] = {vecs[i].data, vecs[i].size};
+    ssize_t ret = ::preadv(fileno(m_handle), iovs.data(), count, ptr);
+    if (ret < 0) throw std::runtime_error("Error reading file...");
+    return ret == 0 ? -1 : ret;
+#endif
+}
+
 ssize_t PCSX::PosixFile::write(const void *src, size_t size) {
     if (failed()) throw std::runtime_error("Invalid file");
     ssize_t ret = fseek(m_handle, m_ptrW, SEEK_SET);
@@ -306,6 +351,35 @@ ssize_t PCSX::SubFile::readAt(void *dest, size_t size, size_t ptr) {
     return m_file->readAt(dest, size, ptr + m_start);
 }
 
+ssize_t PCSX::MappedFile::rSeek(ssize_t pos, int wheel) {
+    switch (wheel) {
+        case SEEK_SET:
+            m_ptrR = pos;
+            break;
+        case SEEK_END:
+            m_ptrR = m_size - pos;
+            break;
+        case SEEK_CUR:
+            m_ptrR += pos;
+            break;
+    }
+    m_ptrR = std::max(std::min(m_ptrR, m_size), size_t(0));
+    return m_ptrR;
+}
+
+ssize_t PCSX::MappedFile::read(void *dest, size_t size) {
+    ssize_t ret = readAt(dest, size, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::MappedFile::readAt(void *dest, size_t size, size_t ptr) {
+    if (ptr >= m_size) return -1;
+    size = std::min(m_size - ptr, size);
+    memcpy(dest, m_data + ptr, size);
+    return size;
+}
+
 ssize_t PCSX::Fifo::read(void *dest_, size_t size) {
     if (size == 0) return 0;
     uint8_t *dest = static_cast<uint8_t *>(dest_);
@@ -35,6 +35,7 @@ SOFTWARE.
 #include <compare>
 #include <concepts>
 #include <filesystem>
+#include <functional>
 #include <queue>
 #include <string>
 #include <string_view>
@@ -54,6 +55,12 @@ enum ReadWrite { READWRITE };
 
 class File;
 
+// One of the buffers of a vectored read.
+struct IOVec {
+    void* data;
+    size_t size;
+};
+
 template <class T>
 concept FileDerived = std::is_base_of<File, T>::value;
 
@@ -94,6 +101,42 @@ class File {
         return ret;
     }
     virtual void writeAt(Slice&& slice, size_t ptr) { writeAt(slice.data(), slice.size(), ptr); }
+    // Vectored reads: fill the buffers in order, as if they were a single contiguous one, and return how
+    // much got read in total, or the error of the first read if nothing did. The defaults go through the
+    // buffers one read at a time; files which can do better, like a single system call, override them.
+    virtual ssize_t readv(const IOVec* vecs, size_t count) {
+        ssize_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (vecs[i].size == 0) continue;
+            auto ret = read(vecs[i].data, vecs[i].size);
+            if (ret < 0) return total ? total : ret;
+            total += ret;
+            if (size_t(ret) < vecs[i].size) break;
+        }
+        return total;
+    }
+    virtual ssize_t readAtv(const IOVec* vecs, size_t count, size_t ptr) {
+        ssize_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (vecs[i].size == 0) continue;
+            auto ret = readAt(vecs[i].data, vecs[i].size, ptr + total);
+            if (ret < 0) return total ? total : ret;
+            total += ret;
+            if (size_t(ret) < vecs[i].size) break;
+        }
+        return total;
+    }
+    // Reads into the buffer at the given position, then calls back with the buffer resized to what got
+    // read, which is empty on errors. The buffer needs to own its memory, as it may have to outlive the
+    // caller's stack, for instance by being made using Slice::resize. The default reads synchronously and
+    // calls back before returning, but files which can read in the background may call back later on,
+    // and from another thread.
+    typedef std::function<void(Slice&&)> ReadCallback;
+    virtual void readAtAsync(Slice&& buffer, size_t ptr, ReadCallback&& callback) {
+        auto ret = readAt(buffer.mutableData(), buffer.size(), ptr);
+        buffer.resize(ret > 0 ? ret : 0);
+        callback(std::move(buffer));
+    }
     virtual bool eof() { return rTell() == size(); }
     virtual std::filesystem::path filename() { return ""; }
     virtual File* dup() { throw std::runtime_error("Cannot duplicate file"); };
@@ -366,6 +409,8 @@ class BufferFile : public File {
     virtual size_t size() final override { return m_size; }
     virtual ssize_t read(void* dest, size_t size) final override;
     virtual ssize_t write(const void* dest, size_t size) final override;
+    virtual ssize_t readv(const IOVec* vecs, size_t count) final override;
+    virtual ssize_t readAtv(const IOVec* vecs, size_t count, size_t ptr) final override;
     virtual bool eof() final override;
     virtual File* dup() final override;
 
@@ -392,6 +437,8 @@ class PosixFile : public File {
     virtual size_t size() final override;
     virtual ssize_t read(void* dest, size_t size) final override;
     virtual ssize_t write(const void* dest, size_t size) final override;
+    virtual ssize_t readv(const IOVec* vecs, size_t count) final override;
+    virtual ssize_t readAtv(const IOVec* vecs, size_t count, size_t ptr) final override;
     virtual bool eof() final override {
         if (failed()) throw std::runtime_error("Invalid file");
         return feof(m_handle);
@@ -445,6 +492,44 @@ class PosixFile : public File {
     size_t m_ptrW = 0;
 };
 
+// Read-only view of a whole file, mapped in memory. Reads are plain memory copies,
+// and the pages are the OS' page cache, shared with anyone else mapping or reading
+// the same file. Empty files can't be mapped, and will show up as failed.
+class MappedFile : public File {
+  public:
+    virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
+    virtual ssize_t rTell() final override { return m_ptrR; }
+    virtual size_t size() final override { return m_size; }
+    virtual ssize_t read(void* dest, size_t size) final override;
+    virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual bool eof() final override { return m_ptrR == m_size; }
+    virtual File* dup() final override { return new MappedFile(m_filename); }
+    virtual bool failed() final override { return m_data == nullptr; }
+    virtual std::filesystem::path filename() final override { return m_filename; }
+    virtual int getc() final override {
+        if (m_ptrR >= m_size) return -1;
+        return m_data[m_ptrR++];
+    }
+
+    MappedFile(const std::filesystem::path& filename);
+#if defined(__cpp_lib_char8_t)
+    MappedFile(const std::u8string& filename) : MappedFile(std::filesystem::path(filename)) {}
+#endif
+    MappedFile(const std::string& filename) : MappedFile(filename.c_str()) {}
+    MappedFile(const char* filename)
+        : MappedFile(std::filesystem::path(reinterpret_cast<const char8_t*>(filename))) {}
+
+    // The whole file, for as long as this object is alive; parsing it in place avoids copying it around.
+    const uint8_t* data() const { return m_data; }
+
+  private:
+    virtual void closeInternal() final override;
+    const std::filesystem::path m_filename;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_ptrR = 0;
+};
+
 class SubFile : public File {
   public:
     SubFile(IO<File> file, size_t start, ssize_t size = -1)
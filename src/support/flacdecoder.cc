@@ -0,0 +1,317 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/flacdecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace {
+
+// CRC-8 with polynomial 0x07, over the frame headers
+uint8_t crc8(const uint8_t* data, size_t length) {
+    static const auto table = []() {
+        std::array<uint8_t, 256> table;
+        for (unsigned i = 0; i < 256; i++) {
+            uint8_t crc = i;
+            for (unsigned j = 0; j < 8; j++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+            table[i] = crc;
+        }
+        return table;
+    }();
+    uint8_t crc = 0;
+    while (length--) crc = table[crc ^ *data++];
+    return crc;
+}
+
+// CRC-16 with polynomial 0x8005, over the whole frames
+uint16_t crc16(const uint8_t* data, size_t length) {
+    static const auto table = []() {
+        std::array<uint16_t, 256> table;
+        for (unsigned i = 0; i < 256; i++) {
+            uint16_t crc = i << 8;
+            for (unsigned j = 0; j < 8; j++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1;
+            table[i] = crc;
+        }
+        return table;
+    }();
+    uint16_t crc = 0;
+    while (length--) crc = (crc << 8) ^ table[(crc >> 8) ^ *data++];
+    return crc;
+}
+
+}  // namespace
+
+// Reads most significant bit first. Reading past the end yields zeroes, which overflowed() then tells apart.
+class PCSX::FLACDecoder::BitReader {
+  public:
+    BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint32_t read(unsigned bits) {
+        if (bits == 0) return 0;
+        refill();
+        const uint32_t value = m_buffer >> (64 - bits);
+        m_buffer <<= bits;
+        m_count -= bits;
+        return value;
+    }
+    int32_t readSigned(unsigned bits) {
+        if (bits == 0) return 0;
+        return int32_t(read(bits) << (32 - bits)) >> (32 - bits);
+    }
+    // The number of zeroes before the next one
+    uint32_t readUnary() {
+        uint32_t zeroes = 0;
+        refill();
+        while (m_buffer == 0) {
+            zeroes += m_count;
+            m_count = 0;
+            if (overflowed()) return zeroes;
+            refill();
+        }
+        const unsigned count = std::countl_zero(m_buffer);
+        m_buffer <<= count;
+        m_buffer <<= 1;
+        m_count -= count + 1;
+        return zeroes + count;
+    }
+    void alignToByte() { read(m_count % 8); }
+
+    // Only meaningful when aligned to a byte
+    size_t position() const { return m_offset - m_count / 8; }
+    const uint8_t* data() const { return m_data; }
+    bool overflowed() const { return position() > m_size; }
+
+  private:
+    void refill() {
+        while (m_count <= 56) {
+            const uint64_t byte = m_offset < m_size ? m_data[m_offset] : 0;
+            m_offset++;
+            m_buffer |= byte << (56 - m_count);
+            m_count += 8;
+        }
+    }
+
+    const uint8_t* m_data;
+    const size_t m_size;
+    size_t m_offset = 0;
+    uint64_t m_buffer = 0;
+    unsigned m_count = 0;
+};
+
+size_t PCSX::FLACDecoder::decode(const uint8_t* src, size_t srcLength, int16_t* dest, unsigned count) {
+    BitReader bits(src, srcLength);
+    while (count > 0) {
+        const unsigned before = count;
+        if (!decodeFrame(bits, dest, count)) return 0;
+        dest += (before - count) * 2;
+    }
+    return bits.overflowed() ? 0 : bits.position();
+}
+
+bool PCSX::FLACDecoder::decodeFrame(BitReader& bits, int16_t* dest, unsigned& count) {
+    const size_t start = bits.position();
+    if (bits.read(14) != 0x3ffe) return false;
+    if (bits.read(1) != 0) return false;
+    bits.read(1);  // Fixed or variable block size, which doesn't change how the frame decodes
+    const unsigned blockSizeCode = bits.read(4);
+    const unsigned sampleRateCode = bits.read(4);
+    const unsigned channelAssignment = bits.read(4);
+    const unsigned sampleSizeCode = bits.read(3);
+    if (bits.read(1) != 0) return false;
+
+    // The frame or sample number, coded like UTF-8 is, on up to 7 bytes
+    const unsigned lead = std::countl_one(uint8_t(bits.read(8)));
+    if ((lead == 1) || (lead > 7)) return false;
+    for (unsigned i = 1; i < lead; i++) {
+        if ((bits.read(8) & 0xc0) != 0x80) return false;
+    }
+
+    unsigned blockSize;
+    switch (blockSizeCode) {
+        case 0:
+            return false;
+        case 1:
+            blockSize = 192;
+            break;
+        case 6:
+            blockSize = bits.read(8) + 1;
+            break;
+        case 7:
+            blockSize = bits.read(16) + 1;
+            break;
+        default:
+            blockSize = blockSizeCode < 6 ? 576 << (blockSizeCode - 2) : 256 << (blockSizeCode - 8);
+            break;
+    }
+    if (sampleRateCode == 12) {
+        bits.read(8);
+    } else if ((sampleRateCode == 13) || (sampleRateCode == 14)) {
+        bits.read(16);
+    } else if (sampleRateCode == 15) {
+        return false;
+    }
+    // Only 16 bits samples, which the stream header would have said, if there was one
+    if ((sampleSizeCode != 0) && (sampleSizeCode != 4)) return false;
+    if ((channelAssignment != 1) && ((channelAssignment < 8) || (channelAssignment > 10))) return false;
+    const size_t headerEnd = bits.position();
+    if (bits.overflowed() || (bits.read(8) != crc8(bits.data() + start, headerEnd - start))) return false;
+
+    // Left and side, side and right, or mid and side. The side channel needs one more bit
+    for (unsigned channel = 0; channel < 2; channel++) {
+        auto& samples = m_channels[channel];
+        if (samples.size() < blockSize) samples.resize(blockSize);
+        const bool side = (channelAssignment == 9) ? (channel == 0) : ((channelAssignment != 1) && (channel == 1));
+        if (!decodeSubframe(bits, samples.data(), blockSize, side ? 17 : 16)) return false;
+    }
+    bits.alignToByte();
+    const size_t frameEnd = bits.position();
+    if (bits.overflowed() || (bits.read(16) != crc16(bits.data() + start, frameEnd - start))) return false;
+
+    // A last frame larger than needed is only written up to what was asked
+    const int32_t* a = m_channels[0].data();
+    const int32_t* b = m_channels[1].data();
+    const unsigned samples = std::min(blockSize, count);
+    for (unsigned i = 0; i < samples; i++) {
+        int32_t left, right;
+        switch (channelAssignment) {
+            case 8:
+                left = a[i];
+                right = a[i] - b[i];
+                break;
+            case 9:
+                left = a[i] + b[i];
+                right = b[i];
+                break;
+            case 10: {
+                const int32_t mid = (a[i] * 2) | (b[i] & 1);
+                left = (mid + b[i]) >> 1;
+                right = (mid - b[i]) >> 1;
+                break;
+            }
+            default:
+                left = a[i];
+                right = b[i];
+                break;
+        }
+        dest[i * 2] = left;
+        dest[i * 2 + 1] = right;
+    }
+    count -= samples;
+    return true;
+}
+
+bool PCSX::FLACDecoder::decodeSubframe(BitReader& bits, int32_t* samples, unsigned blockSize, unsigned sampleBits) {
+    if (bits.read(1) != 0) return false;
+    const unsigned type = bits.read(6);
+    unsigned wasted = 0;
+    if (bits.read(1)) {
+        wasted = bits.readUnary() + 1;
+        if (wasted >= sampleBits) return false;
+        sampleBits -= wasted;
+    }
+
+    if (type == 0) {  // Constant
+        std::fill(samples, samples + blockSize, bits.readSigned(sampleBits));
+    } else if (type == 1) {  // Verbatim
+        for (unsigned i = 0; i < blockSize; i++) samples[i] = bits.readSigned(sampleBits);
+    } else if ((type >= 8) && (type <= 12)) {  // Fixed predictor
+        const unsigned order = type - 8;
+        if (order > blockSize) return false;
+        for (unsigned i = 0; i < order; i++) samples[i] = bits.readSigned(sampleBits);
+        if (!decodeResidual(bits, samples, blockSize, order)) return false;
+        for (unsigned i = order; i < blockSize; i++) {
+            int64_t prediction = 0;
+            switch (order) {
+                case 1:
+                    prediction = samples[i - 1];
+                    break;
+                case 2:
+                    prediction = 2 * int64_t(samples[i - 1]) - samples[i - 2];
+                    break;
+                case 3:
+                    prediction = 3 * (int64_t(samples[i - 1]) - samples[i - 2]) + samples[i - 3];
+                    break;
+                case 4:
+                    prediction = 4 * (int64_t(samples[i - 1]) + samples[i - 3]) - 6 * int64_t(samples[i - 2]) -
+                                 samples[i - 4];
+                    break;
+            }
+            samples[i] = int32_t(samples[i] + prediction);
+        }
+    } else if (type >= 32) {  // Linear predictor
+        const unsigned order = type - 31;
+        if (order > blockSize) return false;
+        for (unsigned i = 0; i < order; i++) samples[i] = bits.readSigned(sampleBits);
+        const unsigned precision = bits.read(4) + 1;
+        const int shift = bits.readSigned(5);
+        if ((precision == 16) || (shift < 0)) return false;
+        int32_t coefficients[32];
+        for (unsigned i = 0; i < order; i++) coefficients[i] = bits.readSigned(precision);
+        if (!decodeResidual(bits, samples, blockSize, order)) return false;
+        for (unsigned i = order; i < blockSize; i++) {
+            int64_t sum = 0;
+            for (unsigned j = 0; j < order; j++) sum += int64_t(coefficients[j]) * samples[i - 1 - j];
+            samples[i] = int32_t(samples[i] + (sum >> shift));
+        }
+    } else {
+        return false;
+    }
+
+    if (wasted) {
+        for (unsigned i = 0; i < blockSize; i++) samples[i] = int32_t(uint32_t(samples[i]) << wasted);
+    }
+    return !bits.overflowed();
+}
+
+// The residual goes right after the warm-up samples, and gets the predictions added to it afterwards
+bool PCSX::FLACDecoder::decodeResidual(BitReader& bits, int32_t* samples, unsigned blockSize, unsigned order) {
+    const unsigned method = bits.read(2);
+    if (method > 1) return false;
+    const unsigned parameterBits = method ? 5 : 4;
+    const unsigned escape = (1 << parameterBits) - 1;
+    const unsigned partitionOrder = bits.read(4);
+    const unsigned partitionSize = blockSize >> partitionOrder;
+    if (((partitionSize << partitionOrder) != blockSize) || (partitionSize < order)) return false;
+
+    unsigned index = order;
+    for (unsigned partition = 0; partition < (1u << partitionOrder); partition++) {
+        const unsigned count = partition ? partitionSize : partitionSize - order;
+        const unsigned parameter = bits.read(parameterBits);
+        if (parameter == escape) {  // Not Rice coded, but stored as is
+            const unsigned sampleBits = bits.read(5);
+            for (unsigned i = 0; i < count; i++) samples[index++] = bits.readSigned(sampleBits);
+        } else {
+            for (unsigned i = 0; i < count; i++) {
+                const uint32_t value = (bits.readUnary() << parameter) | bits.read(parameter);
+                samples[index++] = int32_t(value >> 1) ^ -int32_t(value & 1);
+            }
+        }
+        if (bits.overflowed()) return false;
+    }
+    return true;
+}
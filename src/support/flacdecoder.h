@@ -0,0 +1,54 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+// Decodes FLAC frames of 16 bits stereo audio, on their own, without the stream header and metadata that'd
+// normally come before them. That's what CD images store their audio tracks as, with the format being implied.
+class FLACDecoder {
+  public:
+    // Decodes frames until count stereo samples were written to dest, the left channel first. Returns how many bytes
+    // of src the frames took, which is where anything stored after them starts, or 0 if they're invalid.
+    size_t decode(const uint8_t* src, size_t srcLength, int16_t* dest, unsigned count);
+
+  private:
+    class BitReader;
+
+    bool decodeFrame(BitReader& bits, int16_t* dest, unsigned& count);
+    bool decodeSubframe(BitReader& bits, int32_t* samples, unsigned blockSize, unsigned sampleBits);
+    bool decodeResidual(BitReader& bits, int32_t* samples, unsigned blockSize, unsigned order);
+
+    std::vector<int32_t> m_channels[2];
+};
+
+}  // namespace PCSX
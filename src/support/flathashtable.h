@@ -0,0 +1,310 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <bit>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PCSX_FLATHASHTABLE_SSE2 1
+#endif
+
+#include "support/hashtable.h"
+
+namespace PCSX {
+
+// Open addressing hash table, holding its values directly, for when the key is small and lookups are
+// what matters, like integer keyed maps. It's the Swiss table layout: next to the slots is an array of
+// control bytes, one per slot, which are either empty, deleted, or hold 7 bits of the hash of the key
+// in the slot. Slots are grouped by 16, and a lookup compares the control bytes of a whole group at
+// once, with SSE2 when it's there, only then looking at the keys which matched. Groups are probed
+// quadratically, and the table grows when it's 7/8th full.
+//
+// Its interface is the subset of std::unordered_map's that the code base uses. Like with open addressing
+// in general, inserting may move the values around, so iterators and references to them don't survive it.
+// Erasing, on the other hand, doesn't move anything.
+template <typename Key, class T, class Hash = Intrusive::Hash<Key>>
+class FlatHashTable final {
+  public:
+    typedef std::pair<const Key, T> value_type;
+
+  private:
+    static constexpr unsigned c_groupSize = 16;
+    static constexpr int8_t c_empty = -128;
+    static constexpr int8_t c_deleted = -2;
+
+    template <class Value>
+    class IteratorBase final {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        IteratorBase() {}
+        template <class srcValue>
+        IteratorBase(const IteratorBase<srcValue>& src) : m_table(src.m_table), m_index(src.m_index) {}
+        template <class srcValue>
+        bool operator==(const IteratorBase<srcValue>& src) const {
+            return m_index == src.m_index;
+        }
+        Value& operator*() const { return m_table->m_slots[m_index]; }
+        Value* operator->() const { return m_table->m_slots + m_index; }
+        IteratorBase& operator++() {
+            m_index = m_table->findFull(m_index + 1);
+            return *this;
+        }
+        IteratorBase operator++(int) {
+            IteratorBase copy(*this);
+            ++*this;
+            return copy;
+        }
+
+      private:
+        IteratorBase(const FlatHashTable* table, size_t index) : m_table(table), m_index(index) {}
+        friend class FlatHashTable;
+        template <class>
+        friend class IteratorBase;
+
+        const FlatHashTable* m_table = nullptr;
+        size_t m_index = 0;
+    };
+
+  public:
+    typedef IteratorBase<value_type> iterator;
+    typedef IteratorBase<const value_type> const_iterator;
+
+    FlatHashTable() {}
+    FlatHashTable(const FlatHashTable&) = delete;
+    FlatHashTable& operator=(const FlatHashTable&) = delete;
+    FlatHashTable(FlatHashTable&& src) noexcept { swap(src); }
+    FlatHashTable& operator=(FlatHashTable&& src) noexcept {
+        swap(src);
+        return *this;
+    }
+    ~FlatHashTable() {
+        destroySlots();
+        release();
+    }
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    iterator begin() { return iterator(this, findFull(0)); }
+    const_iterator begin() const { return const_iterator(this, findFull(0)); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+    const_iterator cend() const { return end(); }
+
+    void clear() {
+        destroySlots();
+        if (m_capacity) memset(m_control, c_empty, m_capacity);
+        m_count = 0;
+        m_growthLeft = maxLoad(m_capacity);
+    }
+    void reserve(size_t count) {
+        size_t capacity = c_groupSize;
+        while (maxLoad(capacity) < count) capacity *= 2;
+        if (capacity > m_capacity) rehash(capacity);
+    }
+
+    iterator find(const Key& key) { return iterator(this, findIndex(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, findIndex(key)); }
+    bool contains(const Key& key) const { return findIndex(key) != m_capacity; }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        auto [index, inserted] = findOrPrepareInsert(key);
+        if (inserted) new (m_slots + index) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                                       std::forward_as_tuple(std::forward<Args>(args)...));
+        return {iterator(this, index), inserted};
+    }
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+        auto ret = try_emplace(key, std::forward<V>(value));
+        if (!ret.second) ret.first->second = std::forward<V>(value);
+        return ret;
+    }
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    size_t erase(const Key& key) {
+        size_t index = findIndex(key);
+        if (index == m_capacity) return 0;
+        eraseIndex(index);
+        return 1;
+    }
+    iterator erase(iterator i) {
+        size_t index = i.m_index;
+        eraseIndex(index);
+        return iterator(this, findFull(index + 1));
+    }
+
+    void swap(FlatHashTable& other) noexcept {
+        std::swap(m_control, other.m_control);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_count, other.m_count);
+        std::swap(m_growthLeft, other.m_growthLeft);
+    }
+
+  private:
+    // The bitmask of the bytes of a group which are equal to the given control byte.
+    static uint32_t match(const int8_t* group, int8_t control) {
+#if defined(PCSX_FLATHASHTABLE_SSE2)
+        auto bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control)));
+#else
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < c_groupSize; i++) mask |= uint32_t(group[i] == control) << i;
+        return mask;
+#endif
+    }
+    // Only full slots have their top bit clear.
+    static uint32_t matchNotFull(const int8_t* group) {
+#if defined(PCSX_FLATHASHTABLE_SSE2)
+        return _mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+        uint32_t mask = 0;
+        for (unsigned i = 0; i < c_groupSize; i++) mask |= uint32_t(group[i] < 0) << i;
+        return mask;
+#endif
+    }
+    static constexpr size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+    // The hash gets multiplied, so that weak hashes like std::hash's identity on integers still spread
+    // out; the top 7 bits go into the control byte, the rest picks the first group to probe.
+    static uint64_t mix(const Key& key) { return uint64_t(Hash::hash(key)) * 0x9e3779b97f4a7c15ULL; }
+    static int8_t control(uint64_t hash) { return int8_t(hash >> 57); }
+    size_t firstGroup(uint64_t hash) const { return size_t(hash >> 20) & (m_capacity / c_groupSize - 1); }
+
+    size_t findIndex(const Key& key) const {
+        if (m_count == 0) return m_capacity;
+        const uint64_t hash = mix(key);
+        const int8_t h2 = control(hash);
+        const size_t groupMask = m_capacity / c_groupSize - 1;
+        size_t group = firstGroup(hash);
+        for (size_t step = 1;; step++) {
+            const int8_t* controls = m_control + group * c_groupSize;
+            for (uint32_t mask = match(controls, h2); mask; mask &= mask - 1) {
+                size_t index = group * c_groupSize + std::countr_zero(mask);
+                if (Hash::isEqual(m_slots[index].first, key)) return index;
+            }
+            if (match(controls, c_empty)) return m_capacity;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    std::pair<size_t, bool> findOrPrepareInsert(const Key& key) {
+        size_t index = findIndex(key);
+        if (index != m_capacity) return {index, false};
+        if (m_growthLeft == 0) rehash(m_count >= maxLoad(m_capacity) / 2 ? m_capacity * 2 : m_capacity);
+        const uint64_t hash = mix(key);
+        const size_t groupMask = m_capacity / c_groupSize - 1;
+        size_t group = firstGroup(hash);
+        for (size_t step = 1;; step++) {
+            uint32_t mask = matchNotFull(m_control + group * c_groupSize);
+            if (mask) {
+                index = group * c_groupSize + std::countr_zero(mask);
+                break;
+            }
+            group = (group + step) & groupMask;
+        }
+        if (m_control[index] == c_empty) m_growthLeft--;
+        m_control[index] = control(hash);
+        m_count++;
+        return {index, true};
+    }
+
+    void eraseIndex(size_t index) {
+        m_slots[index].~value_type();
+        m_count--;
+        // Lookups stop at the first group with an empty slot, so if this one has any, the slot can be
+        // made empty again. Otherwise, it needs to stay as a tombstone, for the lookups going past it.
+        if (match(m_control + (index & ~size_t(c_groupSize - 1)), c_empty)) {
+            m_control[index] = c_empty;
+            m_growthLeft++;
+        } else {
+            m_control[index] = c_deleted;
+        }
+    }
+
+    size_t findFull(size_t index) const {
+        while ((index < m_capacity) && (m_control[index] < 0)) index++;
+        return index;
+    }
+
+    void rehash(size_t capacity) {
+        if (capacity < c_groupSize) capacity = c_groupSize;
+        FlatHashTable old;
+        swap(old);
+        m_control = static_cast<int8_t*>(::operator new(capacity, std::align_val_t(c_groupSize)));
+        m_slots = static_cast<value_type*>(::operator new(capacity * sizeof(value_type),
+                                                          std::align_val_t(alignof(value_type))));
+        memset(m_control, c_empty, capacity);
+        m_capacity = capacity;
+        m_growthLeft = maxLoad(capacity);
+        for (size_t i = 0; i < old.m_capacity; i++) {
+            if (old.m_control[i] < 0) continue;
+            auto& slot = old.m_slots[i];
+            auto [index, inserted] = findOrPrepareInsert(slot.first);
+            new (m_slots + index) value_type(slot.first, std::move(slot.second));
+        }
+    }
+
+    void destroySlots() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < m_capacity; i++) {
+                if (m_control[i] >= 0) m_slots[i].~value_type();
+            }
+        }
+    }
+    void release() {
+        if (!m_capacity) return;
+        ::operator delete(m_control, std::align_val_t(c_groupSize));
+        ::operator delete(m_slots, std::align_val_t(alignof(value_type)));
+    }
+
+    int8_t* m_control = nullptr;
+    value_type* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_count = 0;
+    size_t m_growthLeft = 0;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,158 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/gzchunks.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "support/hashing.h"
+#include "support/parallel.h"
+#include "support/slice.h"
+
+namespace {
+
+// ID1, ID2, CM = deflate, FLG = FEXTRA, MTIME, XFL, OS = unknown, then XLEN and our own extra subfield,
+// which holds the size of the whole member, and of its uncompressed data.
+constexpr size_t c_headerSize = 24;
+constexpr size_t c_trailerSize = 8;
+constexpr uint8_t c_header[16] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 255, 12, 0, 'P', 'X', 8, 0};
+
+void put32(uint8_t* ptr, uint32_t value) {
+    ptr[0] = value;
+    ptr[1] = value >> 8;
+    ptr[2] = value >> 16;
+    ptr[3] = value >> 24;
+}
+
+uint32_t get32(const uint8_t* ptr) {
+    return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (uint32_t(ptr[3]) << 24);
+}
+
+struct Member {
+    const uint8_t* deflated;
+    size_t deflatedSize;
+    size_t offset;
+    uint32_t size;
+    uint32_t crc;
+};
+
+// Returns the size of the member at the beginning of data, or 0 if it's not one of ours.
+size_t parseMember(const uint8_t* data, size_t size, Member& member) {
+    if (size < c_headerSize + c_trailerSize) return 0;
+    if (memcmp(data, c_header, 4) != 0) return 0;
+    if (memcmp(data + 10, c_header + 10, 6) != 0) return 0;
+    const size_t memberSize = get32(data + 16);
+    if ((memberSize < c_headerSize + c_trailerSize) || (memberSize > size)) return 0;
+    member.deflated = data + c_headerSize;
+    member.deflatedSize = memberSize - c_headerSize - c_trailerSize;
+    member.size = get32(data + 20);
+    member.crc = get32(data + memberSize - 8);
+    if (get32(data + memberSize - 4) != member.size) return 0;
+    return memberSize;
+}
+
+}  // namespace
+
+void PCSX::GZipChunks::compress(std::string_view data, IO<File> out, unsigned threads, int level) {
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(data.data());
+    const size_t chunks = std::max<size_t>((data.size() + c_chunkSize - 1) / c_chunkSize, 1);
+    std::vector<Slice> members(chunks);
+
+    parallelFor(chunks, threads, [&](size_t i) {
+        const size_t offset = i * c_chunkSize;
+        const uInt size = std::min(data.size() - offset, c_chunkSize);
+        z_stream z = {};
+        deflateInit2(&z, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        const size_t bound = deflateBound(&z, size);
+        Slice& member = members[i];
+        member.resize(c_headerSize + bound + c_trailerSize);
+        uint8_t* ptr = member.mutableData<uint8_t>();
+        z.next_in = const_cast<Bytef*>(src + offset);
+        z.avail_in = size;
+        z.next_out = ptr + c_headerSize;
+        z.avail_out = bound;
+        deflate(&z, Z_FINISH);
+        const size_t memberSize = c_headerSize + z.total_out + c_trailerSize;
+        deflateEnd(&z);
+
+        memcpy(ptr, c_header, sizeof(c_header));
+        put32(ptr + 16, memberSize);
+        put32(ptr + 20, size);
+        put32(ptr + memberSize - 8, Hashing::crc32(0, src + offset, size));
+        put32(ptr + memberSize - 4, size);
+        member.resize(memberSize);
+    });
+
+    for (auto& member : members) out->write(std::move(member));
+}
+
+bool PCSX::GZipChunks::isChunked(std::string_view data) {
+    Member member;
+    return parseMember(reinterpret_cast<const uint8_t*>(data.data()), data.size(), member) != 0;
+}
+
+bool PCSX::GZipChunks::decompress(std::string_view data, std::string& out, unsigned threads) {
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data.data());
+    size_t left = data.size();
+    size_t total = 0;
+    std::vector<Member> members;
+
+    while (left) {
+        Member member;
+        const size_t size = parseMember(ptr, left, member);
+        if (size == 0) return false;
+        member.offset = total;
+        total += member.size;
+        members.push_back(member);
+        ptr += size;
+        left -= size;
+    }
+    if (members.empty()) return false;
+
+    out.resize(total);
+    std::atomic<bool> success = true;
+    parallelFor(members.size(), threads, [&](size_t i) {
+        const Member& member = members[i];
+        uint8_t* dst = reinterpret_cast<uint8_t*>(out.data()) + member.offset;
+        z_stream z = {};
+        inflateInit2(&z, -MAX_WBITS);
+        z.next_in = const_cast<Bytef*>(member.deflated);
+        z.avail_in = member.deflatedSize;
+        z.next_out = dst;
+        z.avail_out = member.size;
+        const int res = inflate(&z, Z_FINISH);
+        const bool complete = (res == Z_STREAM_END) && (z.total_out == member.size);
+        inflateEnd(&z);
+        if (!complete || (Hashing::crc32(0, dst, member.size) != member.crc)) success = false;
+    });
+
+    return success;
+}
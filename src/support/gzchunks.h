@@ -0,0 +1,61 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// A compressed container made of independent gzip members, one per chunk of the input, so that chunks can be
+// compressed and decompressed on several threads. Concatenated gzip members are still a valid gzip stream,
+// so these files can be read back with any gzip tool. The header of each member carries an extra field,
+// with the size of the member itself and of its uncompressed data, so that a reader can find all of them
+// without decompressing anything first.
+class GZipChunks {
+  public:
+    // Large enough for the deflate window to not matter, small enough for a save state to be spread out
+    // over a few threads.
+    static constexpr size_t c_chunkSize = 256 * 1024;
+
+    // Compresses data into out. Threads is how many threads may be used; 0 means one per core.
+    static void compress(std::string_view data, IO<File> out, unsigned threads = 0, int level = 6);
+    // Whether this starts with a member written by compress(). Legacy gzip files don't, and need to go
+    // through a ZReader instead.
+    static bool isChunked(std::string_view data);
+    // Decompresses data into out. Returns false if it's not something written by compress(), or if any
+    // of its chunks is corrupted.
+    static bool decompress(std::string_view data, std::string& out, unsigned threads = 0);
+};
+
+}  // namespace PCSX
@@ -0,0 +1,484 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/hashing.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include "support/cpufeatures.h"
+#include "support/md5.h"
+#include "support/sha1.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define HASHING_X86
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define HASHING_NEON
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+#endif
+
+namespace {
+
+uint64_t read64(const uint8_t* data) {
+    uint64_t ret;
+    memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+uint32_t read32(const uint8_t* data) {
+    uint32_t ret;
+    memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+uint32_t read32BE(const uint8_t* data) {
+    return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+}
+
+#if defined(HASHING_X86)
+// Folds 64 bytes at a time with carry-less multiplications, then reduces down to 32 bits, as described in Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" paper. The constants are powers of x
+// modulo the bit-reflected CRC-32 polynomial. Works on the inverted crc, like the tables in zlib do. The size
+// needs to be at least 64, and a multiple of 16.
+__m128i loadu(const uint8_t* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+
+PCSX_TARGET("pclmul")
+__m128i fold(__m128i x, __m128i k, __m128i next) {
+    const __m128i low = _mm_clmulepi64_si128(x, k, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+PCSX_TARGET("pclmul,sse4.1")
+uint32_t crc32PCLMUL(uint32_t crc, const uint8_t* data, size_t size) {
+    alignas(16) static const uint64_t c_k1k2[2] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t c_k3k4[2] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t c_k5k0[2] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t c_poly[2] = {0x01db710641, 0x01f7011641};
+
+    __m128i x1 = loadu(data + 0x00);
+    __m128i x2 = loadu(data + 0x10);
+    __m128i x3 = loadu(data + 0x20);
+    __m128i x4 = loadu(data + 0x30);
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(int(crc)));
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(c_k1k2));
+    data += 64;
+    size -= 64;
+
+    while (size >= 64) {
+        x1 = fold(x1, k, loadu(data + 0x00));
+        x2 = fold(x2, k, loadu(data + 0x10));
+        x3 = fold(x3, k, loadu(data + 0x20));
+        x4 = fold(x4, k, loadu(data + 0x30));
+        data += 64;
+        size -= 64;
+    }
+
+    // Down to 128 bits, then go through whatever is left 16 bytes at a time.
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(c_k3k4));
+    x1 = fold(x1, k, x2);
+    x1 = fold(x1, k, x3);
+    x1 = fold(x1, k, x4);
+    while (size >= 16) {
+        x1 = fold(x1, k, loadu(data));
+        data += 16;
+        size -= 16;
+    }
+
+    // Down to 64 bits.
+    const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(c_k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction down to 32 bits.
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(c_poly));
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return _mm_extract_epi32(x1, 1);
+}
+
+#endif  // HASHING_X86
+
+constexpr uint64_t c_prime64[5] = {
+    0x9e3779b185ebca87, 0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9, 0x85ebca77c2b2ae63, 0x27d4eb2f165667c5,
+};
+
+constexpr uint64_t rotl64(uint64_t x, unsigned n) { return (x << n) | (x >> (64 - n)); }
+
+constexpr uint64_t xxh64Round(uint64_t acc, uint64_t input) {
+    acc += input * c_prime64[1];
+    return rotl64(acc, 31) * c_prime64[0];
+}
+
+constexpr uint64_t xxh64Merge(uint64_t acc, uint64_t value) {
+    acc ^= xxh64Round(0, value);
+    return acc * c_prime64[0] + c_prime64[3];
+}
+
+// Four 32 bits lanes, which is all the multi-buffer hashes need: additions, bitwise operations, and rotations.
+#if defined(HASHING_X86)
+struct Lanes {
+    __m128i v;
+    static Lanes load(const uint32_t* p) { return {_mm_load_si128(reinterpret_cast<const __m128i*>(p))}; }
+    static Lanes splat(uint32_t x) { return {_mm_set1_epi32(int(x))}; }
+    void store(uint32_t* p) const { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    friend Lanes operator+(Lanes a, Lanes b) { return {_mm_add_epi32(a.v, b.v)}; }
+    friend Lanes operator^(Lanes a, Lanes b) { return {_mm_xor_si128(a.v, b.v)}; }
+    friend Lanes operator&(Lanes a, Lanes b) { return {_mm_and_si128(a.v, b.v)}; }
+    friend Lanes operator|(Lanes a, Lanes b) { return {_mm_or_si128(a.v, b.v)}; }
+    // ~a & b
+    friend Lanes andNot(Lanes a, Lanes b) { return {_mm_andnot_si128(a.v, b.v)}; }
+    friend Lanes rotl(Lanes a, unsigned n) {
+        return {_mm_or_si128(_mm_sll_epi32(a.v, _mm_cvtsi32_si128(n)), _mm_srl_epi32(a.v, _mm_cvtsi32_si128(32 - n)))};
+    }
+};
+#elif defined(HASHING_NEON)
+struct Lanes {
+    uint32x4_t v;
+    static Lanes load(const uint32_t* p) { return {vld1q_u32(p)}; }
+    static Lanes splat(uint32_t x) { return {vdupq_n_u32(x)}; }
+    void store(uint32_t* p) const { vst1q_u32(p, v); }
+    friend Lanes operator+(Lanes a, Lanes b) { return {vaddq_u32(a.v, b.v)}; }
+    friend Lanes operator^(Lanes a, Lanes b) { return {veorq_u32(a.v, b.v)}; }
+    friend Lanes operator&(Lanes a, Lanes b) { return {vandq_u32(a.v, b.v)}; }
+    friend Lanes operator|(Lanes a, Lanes b) { return {vorrq_u32(a.v, b.v)}; }
+    // ~a & b
+    friend Lanes andNot(Lanes a, Lanes b) { return {vbicq_u32(b.v, a.v)}; }
+    friend Lanes rotl(Lanes a, unsigned n) {
+        return {vorrq_u32(vshlq_u32(a.v, vdupq_n_s32(int(n))), vshlq_u32(a.v, vdupq_n_s32(int(n) - 32)))};
+    }
+};
+#else
+struct Lanes {
+    uint32_t v[4];
+    static Lanes load(const uint32_t* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Lanes splat(uint32_t x) { return {{x, x, x, x}}; }
+    void store(uint32_t* p) const { memcpy(p, v, sizeof(v)); }
+    template <typename Op>
+    static Lanes apply(Lanes a, Lanes b, Op op) {
+        return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+    }
+    friend Lanes operator+(Lanes a, Lanes b) { return apply(a, b, [](uint32_t x, uint32_t y) { return x + y; }); }
+    friend Lanes operator^(Lanes a, Lanes b) { return apply(a, b, [](uint32_t x, uint32_t y) { return x ^ y; }); }
+    friend Lanes operator&(Lanes a, Lanes b) { return apply(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+    friend Lanes operator|(Lanes a, Lanes b) { return apply(a, b, [](uint32_t x, uint32_t y) { return x | y; }); }
+    // ~a & b
+    friend Lanes andNot(Lanes a, Lanes b) { return apply(a, b, [](uint32_t x, uint32_t y) { return ~x & y; }); }
+    friend Lanes rotl(Lanes a, unsigned n) {
+        return apply(a, a, [n](uint32_t x, uint32_t) { return (x << n) | (x >> (32 - n)); });
+    }
+};
+#endif
+
+struct MD5Lanes {
+    static constexpr unsigned c_stateWords = 4;
+    static constexpr bool c_bigEndian = false;
+    static constexpr uint32_t c_iv[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+    static void compress(uint32_t state[][4], const uint32_t words[16][4]) {
+        static constexpr uint32_t c_sine[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+        };
+        static constexpr unsigned c_shifts[4][4] = {
+            {7, 12, 17, 22},
+            {5, 9, 14, 20},
+            {4, 11, 16, 23},
+            {6, 10, 15, 21},
+        };
+
+        Lanes w[16];
+        for (unsigned i = 0; i < 16; i++) w[i] = Lanes::load(words[i]);
+        Lanes a = Lanes::load(state[0]);
+        Lanes b = Lanes::load(state[1]);
+        Lanes c = Lanes::load(state[2]);
+        Lanes d = Lanes::load(state[3]);
+        const Lanes ones = Lanes::splat(~0u);
+
+        for (unsigned i = 0; i < 64; i++) {
+            Lanes f;
+            unsigned g;
+            switch (i >> 4) {
+                case 0:
+                    f = (b & c) | andNot(b, d);
+                    g = i;
+                    break;
+                case 1:
+                    f = (b & d) | andNot(d, c);
+                    g = (5 * i + 1) & 15;
+                    break;
+                case 2:
+                    f = b ^ c ^ d;
+                    g = (3 * i + 5) & 15;
+                    break;
+                default:
+                    f = c ^ (b | (d ^ ones));
+                    g = (7 * i) & 15;
+                    break;
+            }
+            const Lanes t = d;
+            d = c;
+            c = b;
+            b = b + rotl(a + f + Lanes::splat(c_sine[i]) + w[g], c_shifts[i >> 4][i & 3]);
+            a = t;
+        }
+
+        (Lanes::load(state[0]) + a).store(state[0]);
+        (Lanes::load(state[1]) + b).store(state[1]);
+        (Lanes::load(state[2]) + c).store(state[2]);
+        (Lanes::load(state[3]) + d).store(state[3]);
+    }
+};
+
+struct SHA1Lanes {
+    static constexpr unsigned c_stateWords = 5;
+    static constexpr bool c_bigEndian = true;
+    static constexpr uint32_t c_iv[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+    static void compress(uint32_t state[][4], const uint32_t words[16][4]) {
+        // Only the last 16 words of the schedule are needed at any point.
+        Lanes w[16];
+        for (unsigned i = 0; i < 16; i++) w[i] = Lanes::load(words[i]);
+        Lanes a = Lanes::load(state[0]);
+        Lanes b = Lanes::load(state[1]);
+        Lanes c = Lanes::load(state[2]);
+        Lanes d = Lanes::load(state[3]);
+        Lanes e = Lanes::load(state[4]);
+
+        for (unsigned i = 0; i < 80; i++) {
+            if (i >= 16) w[i & 15] = rotl(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15], 1);
+            Lanes f;
+            uint32_t k;
+            if (i < 20) {
+                f = (b & c) | andNot(b, d);
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (b & c) | (d & (b | c));
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+            const Lanes t = rotl(a, 5) + f + e + Lanes::splat(k) + w[i & 15];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = t;
+        }
+
+        (Lanes::load(state[0]) + a).store(state[0]);
+        (Lanes::load(state[1]) + b).store(state[1]);
+        (Lanes::load(state[2]) + c).store(state[2]);
+        (Lanes::load(state[3]) + d).store(state[3]);
+        (Lanes::load(state[4]) + e).store(state[4]);
+    }
+};
+
+// Each lane goes through the blocks of its input, then through one or two blocks holding the end of the input
+// and its padding. Once a lane is done with its input, it picks up the next one which nobody took yet, so the
+// lanes stay busy until there are fewer inputs left than lanes.
+template <typename Algorithm, size_t DigestSize>
+void multiHash(std::span<const std::string_view> inputs, std::span<std::array<uint8_t, DigestSize>> digests) {
+    static constexpr size_t c_idle = ~size_t(0);
+    static const uint8_t c_zeroes[64] = {};
+    struct Lane {
+        size_t input;
+        const uint8_t* data;
+        size_t fullBlocks;
+        size_t blocks;
+        size_t block;
+        uint8_t tail[128];
+    };
+    Lane lanes[4];
+    alignas(16) uint32_t state[Algorithm::c_stateWords][4];
+    alignas(16) uint32_t words[16][4];
+    size_t next = 0;
+
+    auto start = [&](unsigned l) {
+        auto& lane = lanes[l];
+        if (next >= inputs.size()) {
+            lane.input = c_idle;
+            return;
+        }
+        lane.input = next++;
+        const auto& input = inputs[lane.input];
+        lane.data = reinterpret_cast<const uint8_t*>(input.data());
+        lane.fullBlocks = input.size() / 64;
+        const size_t rest = input.size() % 64;
+        const unsigned tailBlocks = rest < 56 ? 1 : 2;
+        lane.blocks = lane.fullBlocks + tailBlocks;
+        lane.block = 0;
+        memset(lane.tail, 0, sizeof(lane.tail));
+        if (rest) memcpy(lane.tail, lane.data + lane.fullBlocks * 64, rest);
+        lane.tail[rest] = 0x80;
+        const uint64_t bits = uint64_t(input.size()) * 8;
+        uint8_t* length = lane.tail + tailBlocks * 64 - 8;
+        for (unsigned i = 0; i < 8; i++) length[i] = Algorithm::c_bigEndian ? bits >> (56 - i * 8) : bits >> (i * 8);
+        for (unsigned i = 0; i < Algorithm::c_stateWords; i++) state[i][l] = Algorithm::c_iv[i];
+    };
+
+    for (unsigned l = 0; l < 4; l++) start(l);
+    while (true) {
+        bool active = false;
+        for (unsigned l = 0; l < 4; l++) {
+            const auto& lane = lanes[l];
+            const uint8_t* block = c_zeroes;
+            if (lane.input != c_idle) {
+                active = true;
+                block = lane.block < lane.fullBlocks ? lane.data + lane.block * 64
+                                                     : lane.tail + (lane.block - lane.fullBlocks) * 64;
+            }
+            for (unsigned i = 0; i < 16; i++) {
+                words[i][l] = Algorithm::c_bigEndian ? read32BE(block + i * 4) : read32(block + i * 4);
+            }
+        }
+        if (!active) break;
+        Algorithm::compress(state, words);
+        for (unsigned l = 0; l < 4; l++) {
+            auto& lane = lanes[l];
+            if ((lane.input == c_idle) || (++lane.block != lane.blocks)) continue;
+            auto& digest = digests[lane.input];
+            for (unsigned i = 0; i < Algorithm::c_stateWords; i++) {
+                for (unsigned j = 0; j < 4; j++) {
+                    digest[i * 4 + j] = state[i][l] >> (Algorithm::c_bigEndian ? 24 - j * 8 : j * 8);
+                }
+            }
+            start(l);
+        }
+    }
+}
+
+}  // namespace
+
+uint32_t PCSX::Hashing::crc32(uint32_t crc, const void* data_, size_t size) {
+    auto data = reinterpret_cast<const uint8_t*>(data_);
+#if defined(HASHING_X86)
+    // The folding also needs SSE4.1 to extract its result.
+    static const bool s_hasPCLMUL = CPUFeatures::hasPCLMUL() && CPUFeatures::hasSSE41();
+    if (s_hasPCLMUL && (size >= 64)) {
+        const size_t folded = size & ~size_t(15);
+        crc = ~crc32PCLMUL(~crc, data, folded);
+        data += folded;
+        size -= folded;
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    crc = ~crc;
+    for (; size >= 8; size -= 8, data += 8) crc = __crc32d(crc, read64(data));
+    for (; size; size--) crc = __crc32b(crc, *data++);
+    return ~crc;
+#endif
+    return size ? ::crc32_z(crc, data, size) : crc;
+}
+
+uint64_t PCSX::Hashing::xxh64(const void* data_, size_t size, uint64_t seed) {
+    auto data = reinterpret_cast<const uint8_t*>(data_);
+    const uint8_t* const end = data + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + c_prime64[0] + c_prime64[1];
+        uint64_t v2 = seed + c_prime64[1];
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - c_prime64[0];
+        for (; (end - data) >= 32; data += 32) {
+            v1 = xxh64Round(v1, read64(data + 0));
+            v2 = xxh64Round(v2, read64(data + 8));
+            v3 = xxh64Round(v3, read64(data + 16));
+            v4 = xxh64Round(v4, read64(data + 24));
+        }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64Merge(h, v1);
+        h = xxh64Merge(h, v2);
+        h = xxh64Merge(h, v3);
+        h = xxh64Merge(h, v4);
+    } else {
+        h = seed + c_prime64[4];
+    }
+    h += size;
+
+    for (; (end - data) >= 8; data += 8) {
+        h ^= xxh64Round(0, read64(data));
+        h = rotl64(h, 27) * c_prime64[0] + c_prime64[3];
+    }
+    if ((end - data) >= 4) {
+        h ^= uint64_t(read32(data)) * c_prime64[0];
+        h = rotl64(h, 23) * c_prime64[1] + c_prime64[2];
+        data += 4;
+    }
+    for (; data < end; data++) {
+        h ^= *data * c_prime64[4];
+        h = rotl64(h, 11) * c_prime64[0];
+    }
+
+    h ^= h >> 33;
+    h *= c_prime64[1];
+    h ^= h >> 29;
+    h *= c_prime64[2];
+    h ^= h >> 32;
+    return h;
+}
+
+void PCSX::Hashing::md5(std::span<const std::string_view> inputs, std::span<MD5Digest> digests) {
+    if (inputs.size() == 1) {
+        MD5 md5;
+        md5.update(inputs[0].data(), inputs[0].size());
+        md5.finish(digests[0].data());
+        return;
+    }
+    multiHash<MD5Lanes>(inputs, digests);
+}
+
+void PCSX::Hashing::sha1(std::span<const std::string_view> inputs, std::span<SHA1Digest> digests) {
+    if (inputs.size() == 1) {
+        SHA1 sha1;
+        sha1.update(inputs[0].data(), inputs[0].size());
+        sha1.finish(digests[0].data());
+        return;
+    }
+    multiHash<SHA1Lanes>(inputs, digests);
+}
@@ -0,0 +1,58 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <span>
+#include <string_view>
+
+namespace PCSX {
+
+namespace Hashing {
+
+// Same CRC as zlib's crc32(), starting from 0, and chainable the same way. Uses PCLMULQDQ folding on x86-64
+// processors which have it, and the CRC32 instructions on ARMv8 builds which enable them.
+uint32_t crc32(uint32_t crc, const void* data, size_t size);
+
+// XXH64, with the same results as the reference implementation. This is for content addressing within the
+// emulator: it is much faster than MD5, but it isn't a cryptographic hash.
+uint64_t xxh64(const void* data, size_t size, uint64_t seed = 0);
+
+// Hash several independent buffers at once, four at a time, in the lanes of SIMD registers. This is the way to
+// go when verifying a bunch of images; a single buffer is better off with the MD5 and SHA1 classes, which is
+// what these fall back to when given only one.
+using MD5Digest = std::array<uint8_t, 16>;
+using SHA1Digest = std::array<uint8_t, 20>;
+void md5(std::span<const std::string_view> inputs, std::span<MD5Digest> digests);
+void sha1(std::span<const std::string_view> inputs, std::span<SHA1Digest> digests);
+
+}  // namespace Hashing
+
+}  // namespace PCSX
@@ -0,0 +1,191 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace PCSX {
+
+// Stores log lines in a bounded amount of memory. Lines go into channels, and each channel is a ring of chunks
+// holding a fixed amount of lines: once a channel has all of its chunks filled, its oldest chunk is dropped as a
+// whole. Within a chunk, lines are stored as columns: the text of all the lines back to back, and arrays of
+// offsets, lengths and sequence numbers. Lines which are identical to one seen earlier in the same chunk only
+// get stored once, which is what usually happens with kernel call logs.
+//
+// On top of this sits a view, which is the lines of the visible channels, in the order they got appended, so
+// that it can be indexed directly by a list clipper.
+class LogStore {
+  public:
+    LogStore(unsigned channels, unsigned chunkLines = 4096, unsigned maxChunks = 64)
+        : m_chunkLines(chunkLines), m_maxChunks(maxChunks), m_channels(channels) {}
+
+    void append(unsigned channel, std::string_view line) {
+        auto& c = m_channels[channel];
+        if (c.chunks.empty() || (c.chunks.back().starts.size() >= m_chunkLines)) {
+            if (c.chunks.size() >= m_maxChunks) dropOldest(channel);
+            c.chunks.emplace_back();
+            c.chunks.back().serial = c.nextSerial++;
+        }
+        auto& chunk = c.chunks.back();
+        const uint32_t index = chunk.starts.size();
+        const size_t hash = std::hash<std::string_view>()(line);
+        auto [interned, inserted] = chunk.interned.try_emplace(hash, index);
+        if (!inserted && (chunk.line(interned->second) == line)) {
+            chunk.starts.push_back(chunk.starts[interned->second]);
+        } else {
+            chunk.starts.push_back(chunk.text.size());
+            chunk.text.append(line);
+        }
+        chunk.lengths.push_back(line.size());
+        chunk.sequences.push_back(m_sequence++);
+        c.lines++;
+        if (c.visible) m_view.push_back({channel, index, chunk.serial});
+    }
+
+    void clear() {
+        for (auto& c : m_channels) {
+            c.chunks.clear();
+            c.lines = 0;
+        }
+        m_view.clear();
+    }
+
+    bool isVisible(unsigned channel) const { return m_channels[channel].visible; }
+    // Changing the visible channels rebuilds the view, which costs a pass over all of the stored lines.
+    void setVisible(unsigned channel, bool visible) {
+        if (m_channels[channel].visible == visible) return;
+        m_channels[channel].visible = visible;
+        rebuildView();
+    }
+    void setVisible(const std::vector<bool>& visible) {
+        for (unsigned i = 0; i < m_channels.size(); i++) m_channels[i].visible = visible[i];
+        rebuildView();
+    }
+
+    size_t size() const { return m_view.size(); }
+    std::string_view operator[](size_t index) const {
+        const auto& entry = m_view[index];
+        const auto& c = m_channels[entry.channel];
+        return c.chunks[entry.serial - c.chunks.front().serial].line(entry.line);
+    }
+
+    size_t lines(unsigned channel) const { return m_channels[channel].lines; }
+    // The amount of text actually stored, after de-duplication.
+    size_t textSize() const {
+        size_t ret = 0;
+        for (auto& c : m_channels) {
+            for (auto& chunk : c.chunks) ret += chunk.text.size();
+        }
+        return ret;
+    }
+
+  private:
+    struct Chunk {
+        uint64_t serial;
+        std::string text;
+        std::vector<uint32_t> starts;
+        std::vector<uint32_t> lengths;
+        std::vector<uint64_t> sequences;
+        std::unordered_map<size_t, uint32_t> interned;
+        std::string_view line(uint32_t index) const {
+            return std::string_view(text).substr(starts[index], lengths[index]);
+        }
+    };
+    struct Channel {
+        std::deque<Chunk> chunks;
+        uint64_t nextSerial = 0;
+        size_t lines = 0;
+        bool visible = true;
+    };
+    struct ViewEntry {
+        uint32_t channel;
+        uint32_t line;
+        uint64_t serial;
+    };
+
+    void dropOldest(unsigned channel) {
+        auto& c = m_channels[channel];
+        const auto& chunk = c.chunks.front();
+        c.lines -= chunk.starts.size();
+        if (c.visible) {
+            const uint64_t serial = chunk.serial;
+            std::erase_if(m_view, [channel, serial](const ViewEntry& entry) {
+                return (entry.channel == channel) && (entry.serial == serial);
+            });
+        }
+        c.chunks.pop_front();
+    }
+
+    // Merges the visible channels back together using the sequence numbers.
+    void rebuildView() {
+        m_view.clear();
+        struct Cursor {
+            unsigned channel;
+            size_t chunk = 0;
+            uint32_t line = 0;
+        };
+        std::vector<Cursor> cursors;
+        for (unsigned i = 0; i < m_channels.size(); i++) {
+            if (m_channels[i].visible && !m_channels[i].chunks.empty()) cursors.push_back({i});
+        }
+        while (!cursors.empty()) {
+            Cursor* best = nullptr;
+            uint64_t bestSequence = UINT64_MAX;
+            for (auto& cursor : cursors) {
+                const auto& chunk = m_channels[cursor.channel].chunks[cursor.chunk];
+                if (chunk.sequences[cursor.line] < bestSequence) {
+                    bestSequence = chunk.sequences[cursor.line];
+                    best = &cursor;
+                }
+            }
+            auto& chunks = m_channels[best->channel].chunks;
+            m_view.push_back({best->channel, best->line, chunks[best->chunk].serial});
+            if (++best->line == chunks[best->chunk].starts.size()) {
+                best->line = 0;
+                if (++best->chunk == chunks.size()) {
+                    *best = cursors.back();
+                    cursors.pop_back();
+                }
+            }
+        }
+    }
+
+    const unsigned m_chunkLines;
+    const unsigned m_maxChunks;
+    std::vector<Channel> m_channels;
+    std::deque<ViewEntry> m_view;
+    uint64_t m_sequence = 0;
+};
+
+}  // namespace PCSX
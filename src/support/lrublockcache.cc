@@ -0,0 +1,164 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/lrublockcache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+
+PCSX::LRUBlockCache::LRUBlockCache(uint64_t fileSize, size_t memoryCap, const std::filesystem::path& spillDirectory,
+                                   Fetcher&& fetcher, size_t blockSize)
+    : m_blockSize(blockSize),
+      m_memoryCap(std::max(memoryCap, blockSize)),
+      m_fileSize(fileSize),
+      m_fetcher(std::move(fetcher)) {
+    if (spillDirectory.empty()) return;
+    std::random_device rd;
+    char name[64];
+    snprintf(name, sizeof(name), "pcsx-blocks-%08x%08x.cache", rd(), rd());
+    m_spillPath = spillDirectory / name;
+    m_spill.setFile(new PosixFile(m_spillPath, FileOps::TRUNCATE));
+    // Not being able to spill only means evicted blocks will have to be fetched again.
+    if (m_spill->failed()) {
+        m_spill.reset();
+        m_spillPath.clear();
+    }
+}
+
+PCSX::LRUBlockCache::~LRUBlockCache() {
+    if (!m_spill) return;
+    m_spill->close();
+    m_spill.reset();
+    std::error_code ec;
+    std::filesystem::remove(m_spillPath, ec);
+}
+
+const PCSX::LRUBlockCache::Block* PCSX::LRUBlockCache::getBlock(uint64_t index) {
+    auto i = m_blocks.find(index);
+    if (i != m_blocks.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, i->second);
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return &*i->second;
+    }
+
+    auto size = blockLength(index);
+    if (size == 0) return nullptr;
+    Block block{index, size, std::make_unique<uint8_t[]>(size)};
+    auto spilled = m_spilled.find(index);
+    if ((spilled != m_spilled.end()) && (spilled->second == size) &&
+        (m_spill->readAt(block.data.get(), size, index * m_blockSize) == ssize_t(size))) {
+        m_spillHits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        auto got = m_fetcher(index * m_blockSize, block.data.get(), size);
+        if (got <= 0) return nullptr;
+        if (size_t(got) < size) {
+            block.size = got;
+            m_partial = std::move(block);
+            return &m_partial;
+        }
+    }
+    m_residentBytes += size;
+    m_lru.push_front(std::move(block));
+    m_blocks[index] = m_lru.begin();
+    evict();
+    return &m_lru.front();
+}
+
+void PCSX::LRUBlockCache::evict() {
+    // Never evicts the block which just got in, at the front.
+    while ((m_residentBytes > m_memoryCap) && (m_lru.size() > 1)) {
+        auto& block = m_lru.back();
+        if (m_spill && !m_spilled.contains(block.index)) {
+            if (m_spill->writeAt(block.data.get(), block.size, block.index * m_blockSize) == ssize_t(block.size)) {
+                m_spilled[block.index] = block.size;
+            }
+        }
+        m_residentBytes -= block.size;
+        m_blocks.erase(block.index);
+        m_lru.pop_back();
+    }
+}
+
+void PCSX::LRUBlockCache::drop(uint64_t index) {
+    m_spilled.erase(index);
+    auto i = m_blocks.find(index);
+    if (i == m_blocks.end()) return;
+    m_residentBytes -= i->second->size;
+    m_lru.erase(i->second);
+    m_blocks.erase(i);
+}
+
+ssize_t PCSX::LRUBlockCache::read(void* dest_, size_t size, uint64_t ptr) {
+    std::unique_lock<std::mutex> l(m_mutex);
+    if (ptr >= m_fileSize) return -1;
+    size = std::min(uint64_t(size), m_fileSize - ptr);
+    uint8_t* dest = reinterpret_cast<uint8_t*>(dest_);
+    size_t done = 0;
+    while (done < size) {
+        uint64_t index = ptr / m_blockSize;
+        size_t offset = ptr % m_blockSize;
+        auto block = getBlock(index);
+        if (!block || (block->size <= offset)) break;
+        size_t toCopy = std::min(size - done, block->size - offset);
+        memcpy(dest + done, block->data.get() + offset, toCopy);
+        done += toCopy;
+        ptr += toCopy;
+        if (block == &m_partial) break;
+    }
+    m_partial.data.reset();
+    return done == 0 ? -1 : ssize_t(done);
+}
+
+void PCSX::LRUBlockCache::write(const void* src_, size_t size, uint64_t ptr) {
+    if (size == 0) return;
+    std::unique_lock<std::mutex> l(m_mutex);
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(src_);
+    uint64_t end = ptr + size;
+    uint64_t first = ptr / m_blockSize;
+    uint64_t last = (end - 1) / m_blockSize;
+    for (uint64_t index = first; index <= last; index++) {
+        uint64_t blockStart = index * m_blockSize;
+        size_t length = blockLength(index);
+        // This block gets longer, or starts existing; the next read will fetch it again.
+        if ((length < m_blockSize) && (end > blockStart + length)) {
+            drop(index);
+            continue;
+        }
+        uint64_t from = std::max(ptr, blockStart);
+        size_t count = std::min(end, blockStart + length) - from;
+        const uint8_t* data = src + (from - ptr);
+        auto i = m_blocks.find(index);
+        if (i != m_blocks.end()) memcpy(i->second->data.get() + (from - blockStart), data, count);
+        if (m_spilled.contains(index) && (m_spill->writeAt(data, count, from) != ssize_t(count))) {
+            m_spilled.erase(index);
+        }
+    }
+    m_fileSize = std::max(m_fileSize, end);
+}
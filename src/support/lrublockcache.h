@@ -0,0 +1,110 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "support/file.h"
+#include "support/ssize_t.h"
+
+namespace PCSX {
+
+// Keeps the blocks of a file which got read recently, so that random accesses into a file too big, or too slow
+// to get, to be cached whole don't have to go back to its source every time. At most memoryCap bytes worth of
+// blocks stay in memory. Past that, the least recently used ones get dropped, or moved into a file in the spill
+// directory if one was given, from where they can be read back without fetching them again.
+class LRUBlockCache {
+  public:
+    static constexpr size_t c_defaultBlockSize = 256 * 1024;
+    // Needs to fill data with size bytes of the file, starting at offset, and return how many it got,
+    // or a negative value on failure. Only ever called for whole blocks, and never concurrently.
+    using Fetcher = std::function<ssize_t(uint64_t offset, uint8_t* data, size_t size)>;
+
+    LRUBlockCache(uint64_t fileSize, size_t memoryCap, const std::filesystem::path& spillDirectory,
+                  Fetcher&& fetcher, size_t blockSize = c_defaultBlockSize);
+    ~LRUBlockCache();
+
+    ssize_t read(void* dest, size_t size, uint64_t ptr);
+    // Needs to be called when writing to the file behind the cache, so that the blocks it already
+    // has see the new data. The blocks the write extends get dropped instead.
+    void write(const void* src, size_t size, uint64_t ptr);
+
+    uint64_t size() const { return m_fileSize; }
+    size_t residentBytes() const {
+        std::unique_lock<std::mutex> l(m_mutex);
+        return m_residentBytes;
+    }
+    uint64_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t spillHits() const { return m_spillHits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+
+  private:
+    struct Block {
+        uint64_t index;
+        size_t size;
+        std::unique_ptr<uint8_t[]> data;
+    };
+    using LRU = std::list<Block>;
+
+    size_t blockLength(uint64_t index) const {
+        uint64_t start = index * m_blockSize;
+        return start >= m_fileSize ? 0 : std::min(uint64_t(m_blockSize), m_fileSize - start);
+    }
+    const Block* getBlock(uint64_t index);
+    void evict();
+    void drop(uint64_t index);
+
+    const size_t m_blockSize;
+    const size_t m_memoryCap;
+    uint64_t m_fileSize;
+    Fetcher m_fetcher;
+    // Most recently used first.
+    LRU m_lru;
+    std::unordered_map<uint64_t, LRU::iterator> m_blocks;
+    size_t m_residentBytes = 0;
+    // A block which came back short from the fetcher, kept around only for the read which asked for it.
+    Block m_partial = {};
+    std::filesystem::path m_spillPath;
+    IO<File> m_spill;
+    // The blocks in the spill file, which stores each of them at the same offset as in the cached file.
+    std::unordered_map<uint64_t, size_t> m_spilled;
+    std::atomic<uint64_t> m_hits = 0;
+    std::atomic<uint64_t> m_spillHits = 0;
+    std::atomic<uint64_t> m_misses = 0;
+    mutable std::mutex m_mutex;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,246 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "support/lzmadecoder.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr unsigned c_numStates = 12;
+constexpr unsigned c_numPosStatesMax = 16;
+constexpr unsigned c_numLenToPosStates = 4;
+constexpr unsigned c_endPosModelIndex = 14;
+constexpr unsigned c_numFullDistances = 1 << (c_endPosModelIndex >> 1);
+constexpr unsigned c_numAlignBits = 4;
+constexpr unsigned c_matchMinLen = 2;
+
+// The probabilities, all in one array: the offset of each model in it, laid out like LzmaDec does
+constexpr unsigned c_lenChoice = 0;
+constexpr unsigned c_lenChoice2 = 1;
+constexpr unsigned c_lenLow = 2;
+constexpr unsigned c_lenMid = c_lenLow + (c_numPosStatesMax << 3);
+constexpr unsigned c_lenHigh = c_lenMid + (c_numPosStatesMax << 3);
+constexpr unsigned c_lenProbs = c_lenHigh + 256;
+
+constexpr unsigned c_isMatch = 0;
+constexpr unsigned c_isRep = c_isMatch + (c_numStates << 4);
+constexpr unsigned c_isRepG0 = c_isRep + c_numStates;
+constexpr unsigned c_isRepG1 = c_isRepG0 + c_numStates;
+constexpr unsigned c_isRepG2 = c_isRepG1 + c_numStates;
+constexpr unsigned c_isRep0Long = c_isRepG2 + c_numStates;
+constexpr unsigned c_posSlot = c_isRep0Long + (c_numStates << 4);
+constexpr unsigned c_specPos = c_posSlot + (c_numLenToPosStates << 6);
+constexpr unsigned c_align = c_specPos + c_numFullDistances - c_endPosModelIndex;
+constexpr unsigned c_lenCoder = c_align + (1 << c_numAlignBits);
+constexpr unsigned c_repLenCoder = c_lenCoder + c_lenProbs;
+constexpr unsigned c_literal = c_repLenCoder + c_lenProbs;
+
+class RangeDecoder {
+  public:
+    RangeDecoder(const uint8_t* src, size_t length) : m_src(src), m_end(src + length) {
+        m_corrupted = readByte() != 0;
+        for (unsigned i = 0; i < 4; i++) m_code = (m_code << 8) | readByte();
+        m_corrupted = m_corrupted || (m_code == m_range);
+    }
+
+    // Reading past the end yields zeroes, and fails the stream
+    bool failed() const { return m_corrupted || m_overrun; }
+
+    unsigned decodeBit(uint16_t& prob) {
+        const uint32_t bound = (m_range >> 11) * prob;
+        unsigned bit;
+        if (m_code < bound) {
+            prob += (2048 - prob) >> 5;
+            m_range = bound;
+            bit = 0;
+        } else {
+            prob -= prob >> 5;
+            m_code -= bound;
+            m_range -= bound;
+            bit = 1;
+        }
+        normalize();
+        return bit;
+    }
+
+    uint32_t decodeDirectBits(unsigned count) {
+        uint32_t result = 0;
+        while (count--) {
+            m_range >>= 1;
+            m_code -= m_range;
+            const uint32_t t = 0 - (m_code >> 31);
+            m_code += m_range & t;
+            m_corrupted = m_corrupted || (m_code == m_range);
+            normalize();
+            result = (result << 1) + (t + 1);
+        }
+        return result;
+    }
+
+    uint32_t decodeTree(uint16_t* probs, unsigned bits) {
+        uint32_t m = 1;
+        for (unsigned i = 0; i < bits; i++) m = (m << 1) + decodeBit(probs[m]);
+        return m - (1 << bits);
+    }
+
+    uint32_t decodeReverseTree(uint16_t* probs, unsigned bits) {
+        uint32_t m = 1;
+        uint32_t symbol = 0;
+        for (unsigned i = 0; i < bits; i++) {
+            const unsigned bit = decodeBit(probs[m]);
+            m = (m << 1) + bit;
+            symbol |= bit << i;
+        }
+        return symbol;
+    }
+
+  private:
+    uint8_t readByte() {
+        if (m_src < m_end) return *m_src++;
+        m_overrun = true;
+        return 0;
+    }
+    void normalize() {
+        if (m_range >= (1 << 24)) return;
+        m_range <<= 8;
+        m_code = (m_code << 8) | readByte();
+    }
+
+    const uint8_t* m_src;
+    const uint8_t* const m_end;
+    uint32_t m_range = 0xffffffff;
+    uint32_t m_code = 0;
+    bool m_corrupted = false;
+    bool m_overrun = false;
+};
+
+unsigned decodeLength(RangeDecoder& rc, uint16_t* probs, unsigned posState) {
+    if (rc.decodeBit(probs[c_lenChoice]) == 0) return rc.decodeTree(probs + c_lenLow + (posState << 3), 3);
+    if (rc.decodeBit(probs[c_lenChoice2]) == 0) return 8 + rc.decodeTree(probs + c_lenMid + (posState << 3), 3);
+    return 16 + rc.decodeTree(probs + c_lenHigh, 8);
+}
+
+}  // namespace
+
+PCSX::LZMADecoder::LZMADecoder(unsigned lc, unsigned lp, unsigned pb)
+    : m_lc(lc), m_lp(lp), m_pb(pb), m_probs(c_literal + (0x300 << (lc + lp))) {}
+
+bool PCSX::LZMADecoder::decode(const uint8_t* src, size_t srcLength, uint8_t* dest, size_t destLength) {
+    std::fill(m_probs.begin(), m_probs.end(), 1024);
+    uint16_t* const probs = m_probs.data();
+    RangeDecoder rc(src, srcLength);
+
+    const uint32_t pbMask = (1 << m_pb) - 1;
+    const uint32_t lpMask = (1 << m_lp) - 1;
+    uint32_t rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+    unsigned state = 0;
+    size_t pos = 0;
+
+    while (pos < destLength) {
+        if (rc.failed()) return false;
+        const unsigned posState = pos & pbMask;
+
+        if (rc.decodeBit(probs[c_isMatch + (state << 4) + posState]) == 0) {
+            const unsigned prevByte = pos ? dest[pos - 1] : 0;
+            uint16_t* literal = probs + c_literal + 0x300 * (((pos & lpMask) << m_lc) + (prevByte >> (8 - m_lc)));
+            unsigned symbol = 1;
+            if (state >= 7) {  // After a match, the byte that would have followed it steers the probabilities
+                unsigned matchByte = dest[pos - rep0 - 1];
+                do {
+                    const unsigned matchBit = (matchByte >> 7) & 1;
+                    matchByte <<= 1;
+                    const unsigned bit = rc.decodeBit(literal[((1 + matchBit) << 8) + symbol]);
+                    symbol = (symbol << 1) | bit;
+                    if (matchBit != bit) break;
+                } while (symbol < 0x100);
+            }
+            while (symbol < 0x100) symbol = (symbol << 1) | rc.decodeBit(literal[symbol]);
+            dest[pos++] = symbol;
+            state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+            continue;
+        }
+
+        unsigned length;
+        if (rc.decodeBit(probs[c_isRep + state]) != 0) {
+            if (pos == 0) return false;
+            if (rc.decodeBit(probs[c_isRepG0 + state]) == 0) {
+                if (rc.decodeBit(probs[c_isRep0Long + (state << 4) + posState]) == 0) {  // One byte from rep0
+                    state = state < 7 ? 9 : 11;
+                    dest[pos] = dest[pos - rep0 - 1];
+                    pos++;
+                    continue;
+                }
+            } else {
+                uint32_t distance;
+                if (rc.decodeBit(probs[c_isRepG1 + state]) == 0) {
+                    distance = rep1;
+                } else {
+                    if (rc.decodeBit(probs[c_isRepG2 + state]) == 0) {
+                        distance = rep2;
+                    } else {
+                        distance = rep3;
+                        rep3 = rep2;
+                    }
+                    rep2 = rep1;
+                }
+                rep1 = rep0;
+                rep0 = distance;
+            }
+            length = decodeLength(rc, probs + c_repLenCoder, posState);
+            state = state < 7 ? 8 : 11;
+        } else {
+            rep3 = rep2;
+            rep2 = rep1;
+            rep1 = rep0;
+            length = decodeLength(rc, probs + c_lenCoder, posState);
+            state = state < 7 ? 7 : 10;
+
+            const unsigned lenState = std::min(length, c_numLenToPosStates - 1);
+            const unsigned posSlot = rc.decodeTree(probs + c_posSlot + (lenState << 6), 6);
+            if (posSlot < 4) {
+                rep0 = posSlot;
+            } else {
+                const unsigned directBits = (posSlot >> 1) - 1;
+                rep0 = (2 | (posSlot & 1)) << directBits;
+                if (posSlot < c_endPosModelIndex) {
+                    rep0 += rc.decodeReverseTree(probs + c_specPos + rep0 - posSlot, directBits);
+                } else {
+                    rep0 += rc.decodeDirectBits(directBits - c_numAlignBits) << c_numAlignBits;
+                    rep0 += rc.decodeReverseTree(probs + c_align, c_numAlignBits);
+                }
+            }
+            // The end marker, which we don't want to see before the end
+            if (rep0 == 0xffffffff) return false;
+        }
+
+        if (rep0 >= pos) return false;
+        length = std::min<size_t>(length + c_matchMinLen, destLength - pos);
+        for (unsigned i = 0; i < length; i++, pos++) dest[pos] = dest[pos - rep0 - 1];
+    }
+
+    return !rc.failed();
+}
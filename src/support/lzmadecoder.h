@@ -0,0 +1,54 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace PCSX {
+
+// Decodes raw LZMA streams, the way the LZMA SDK's LzmaDec does, without the .lzma header: the literal and position
+// parameters are known beforehand. The whole output goes to one buffer, which also serves as the dictionary. The
+// decoder can be reused for any number of streams, and keeps its probabilities allocated in between.
+class LZMADecoder {
+  public:
+    LZMADecoder(unsigned lc = 3, unsigned lp = 0, unsigned pb = 2);
+
+    // Fills dest with exactly destLength bytes. The stream doesn't need an end marker, and whatever follows the
+    // last byte needed, such as one, is ignored. Returns false if the stream is corrupted or too short.
+    bool decode(const uint8_t* src, size_t srcLength, uint8_t* dest, size_t destLength);
+
+  private:
+    const unsigned m_lc;
+    const unsigned m_lp;
+    const unsigned m_pb;
+    std::vector<uint16_t> m_probs;
+};
+
+}  // namespace PCSX
@@ -352,6 +352,22 @@ struct VertexBuffer {
         glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
     }
 
+    // Immutable storage, mapped for writing once and for all. The mapping is coherent, so whatever gets written
+    // there is visible to the draw calls issued afterwards. Needs GL 4.4 or ARB_buffer_storage, and returns
+    // nullptr if the driver refused, in which case the buffer is gone and can be created again another way.
+    void* createPersistentMapped(GLsizeiptr size) {
+        static constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        create();
+        bind();
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (mapped == nullptr) {
+            glDeleteBuffers(1, &m_handle);
+            m_handle = 0;
+        }
+        return mapped;
+    }
+
     VertexBuffer(bool shouldCreate = false) {
         if (shouldCreate) {
             create();
@@ -447,12 +463,21 @@ T get(GLenum query) {
 static inline bool isEnabled(GLenum query) { return glIsEnabled(query) != GL_FALSE; }
 
 static inline GLint getDrawFramebuffer() { return get<GLint>(GL_DRAW_FRAMEBUFFER_BINDING); }
+static inline GLint getReadFramebuffer() { return get<GLint>(GL_READ_FRAMEBUFFER_BINDING); }
 static inline GLint maxSamples() { return get<GLint>(GL_MAX_INTEGER_SAMPLES); }
 static inline GLint getTex2D() { return get<GLint>(GL_TEXTURE_BINDING_2D); }
 static inline GLint getProgram() { return get<GLint>(GL_CURRENT_PROGRAM); }
 static inline bool scissorEnabled() { return isEnabled(GL_SCISSOR_TEST); }
 
 static inline bool versionSupported(int major, int minor) { return gl3wIsSupported(major, minor); }
+static inline bool extensionSupported(std::string_view name) {
+    const GLint count = get<GLint>(GL_NUM_EXTENSIONS);
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && (name == extension)) return true;
+    }
+    return false;
+}
 
 [[nodiscard]] static inline GLint uniformLocation(GLuint program, const char* name) {
     return glGetUniformLocation(program, name);
@@ -0,0 +1,59 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace PCSX {
+
+// How many threads to run count work items on, out of the threads asked for. 0 threads means one per hardware
+// thread, and there's no point in having more threads than items.
+inline unsigned parallelThreadCount(unsigned threads, size_t count) {
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::clamp<size_t>(count, 1, threads);
+}
+
+// Runs work(i) for each i in [0, count), spread over parallelThreadCount(threads, count) threads, the calling thread
+// being one of them. The items are handed out one at a time, in order, so uneven ones balance themselves out.
+template <typename Work>
+void parallelFor(size_t count, unsigned threads, Work work) {
+    std::atomic<size_t> next = 0;
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) work(i);
+    };
+    std::vector<std::thread> workers;
+    const unsigned threadCount = parallelThreadCount(threads, count);
+    for (unsigned i = 1; i < threadCount; i++) workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers) thread.join();
+}
+
+}  // namespace PCSX
@@ -0,0 +1,86 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+
+namespace PCSX {
+
+// Decides which of the emulated frames get presented, when the emulated and host refresh rates differ. The host
+// refreshes are seen as a grid of slots, and a frame gets presented only if its slot hasn't been used yet;
+// frames coming faster than the display can show them are dropped instead of being swapped for nothing, and
+// frames coming slower simply stay up for more than one refresh. The grid follows the first presented frame,
+// and frames coming a little early still count for the upcoming slot, so that jitter doesn't drop frames when
+// both rates are the same. None of this waits on anything: swapping stays unsynchronized, and the emulation
+// keeps running on its own clock.
+class PresentPacer {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // A refresh rate of 0, which is what an unknown one is, presents every frame.
+    void setRefreshRate(int hz) {
+        m_period = hz > 0 ? Clock::duration(std::chrono::nanoseconds(1000000000 / hz)) : Clock::duration::zero();
+        reset();
+    }
+    // Forgets about the grid, for instance after the emulation was paused.
+    void reset() { m_nextSlot = Clock::time_point(); }
+
+    bool shouldPresent(Clock::time_point now) {
+        if (m_period == Clock::duration::zero()) {
+            m_presented++;
+            return true;
+        }
+        const auto early = now + m_period / c_earlyFraction;
+        const bool resync = (m_nextSlot == Clock::time_point()) || ((now - m_nextSlot) >= m_period * c_maxLag);
+        if (!resync && (early < m_nextSlot)) {
+            m_dropped++;
+            return false;
+        }
+        if (resync) m_nextSlot = now;
+        if (early >= m_nextSlot) m_nextSlot += m_period * (1 + (early - m_nextSlot) / m_period);
+        m_presented++;
+        return true;
+    }
+
+    uint64_t presented() const { return m_presented; }
+    uint64_t dropped() const { return m_dropped; }
+
+  private:
+    // How early a frame may come, as a fraction of the host's refresh period.
+    static constexpr int c_earlyFraction = 4;
+    // Past that many refreshes without a frame, the grid starts over.
+    static constexpr int c_maxLag = 8;
+
+    Clock::duration m_period = Clock::duration::zero();
+    Clock::time_point m_nextSlot;
+    uint64_t m_presented = 0;
+    uint64_t m_dropped = 0;
+};
+
+}  // namespace PCSX
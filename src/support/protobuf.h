@@ -48,11 +48,22 @@ class OutOfBoundError {};
 class InSlice {
   public:
     constexpr uint64_t bytesLeft() { return m_size - m_ptr; }
+    // When the data outlives whatever gets deserialized out of it, large fixed size fields can point into it
+    // instead of holding copies, and only get copied once, when committed to their destination.
+    enum Borrow { BORROW };
     InSlice(const uint8_t *data, uint64_t size) : m_data(data), m_size(size) {}
+    InSlice(const uint8_t *data, uint64_t size, Borrow) : m_data(data), m_size(size), m_canBorrow(true) {}
     InSlice getSubSlice(uint64_t size) {
         boundsCheck(size);
         m_ptr += size;
-        return InSlice(m_data + m_ptr - size, size);
+        InSlice ret(m_data + m_ptr - size, size);
+        ret.m_canBorrow = m_canBorrow;
+        return ret;
+    }
+    constexpr bool canBorrow() const { return m_canBorrow; }
+    const uint8_t *borrowBytes(uint64_t size) {
+        skipBytes(size);
+        return m_data + m_ptr - size;
     }
     constexpr uint8_t getU8() {
         boundsCheck(1);
@@ -112,6 +123,7 @@ class InSlice {
     const uint8_t *m_data;
     const uint64_t m_size;
     uint64_t m_ptr = 0;
+    bool m_canBorrow = false;
 
     constexpr uint8_t getU8Safe() { return m_data[m_ptr++]; }
 
@@ -120,9 +132,19 @@ class InSlice {
     }
 };
 
+// How many bytes putVarInt() writes for this value
+constexpr unsigned varIntSize(uint64_t value) {
+    unsigned size = 1;
+    while (value >>= 7) size++;
+    return size;
+}
+
 class OutSlice {
   public:
-    void putU8(uint8_t value) { m_data += std::string(reinterpret_cast<const char *>(&value), 1); }
+    OutSlice() {}
+    // With the final size known upfront, through serializedSize(), everything gets appended in place
+    explicit OutSlice(uint64_t size) { m_data.reserve(size); }
+    void putU8(uint8_t value) { m_data.push_back(static_cast<char>(value)); }
     void putU16(uint16_t value) {
         putU8(value & 0xff);
         value >>= 8;
@@ -138,18 +160,18 @@ class OutSlice {
         value >>= 32;
         putU32(value & 0xffffffff);
     }
-    void putBytes(const uint8_t *bytes, uint64_t size) {
-        m_data += std::string(reinterpret_cast<const char *>(bytes), size);
-    }
+    void putBytes(const uint8_t *bytes, uint64_t size) { m_data.append(reinterpret_cast<const char *>(bytes), size); }
     void putBytes(const std::string &str) { m_data += str; }
     void putSlice(OutSlice *slice) { m_data += slice->m_data; }
     void putVarInt(uint64_t value) {
-        uint8_t b = 0;
+        char buffer[10];
+        unsigned size = 0;
         do {
-            b = value & 0x7f;
+            uint8_t b = value & 0x7f;
             value >>= 7;
-            putU8(b | (value ? 0x80 : 0x00));
+            buffer[size++] = b | (value ? 0x80 : 0x00);
         } while (value);
+        m_data.append(buffer, size);
     }
     std::string finalize() { return std::move(m_data); }
 
@@ -181,6 +203,7 @@ struct Int8 : public FieldType<int8_t, 0> {
 struct Int16 : public FieldType<int16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -188,6 +211,7 @@ struct Int16 : public FieldType<int16_t, 0> {
 struct Int32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -195,6 +219,7 @@ struct Int32 : public FieldType<int32_t, 0> {
 struct Int64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "int64";
 };
@@ -202,6 +227,7 @@ struct Int64 : public FieldType<int64_t, 0> {
 struct UInt8 : public FieldType<uint8_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint8_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -209,6 +235,7 @@ struct UInt8 : public FieldType<uint8_t, 0> {
 struct UInt16 : public FieldType<uint16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -216,6 +243,7 @@ struct UInt16 : public FieldType<uint16_t, 0> {
 struct UInt32 : public FieldType<uint32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -223,6 +251,7 @@ struct UInt32 : public FieldType<uint32_t, 0> {
 struct UInt64 : public FieldType<uint64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "uint64";
 };
@@ -230,6 +259,7 @@ struct UInt64 : public FieldType<uint64_t, 0> {
 struct SInt32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 31)); }
+    constexpr uint64_t serializedSize() const { return varIntSize((value << 1) ^ (value >> 31)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = static_cast<int32_t>(slice->getVarInt());
         value = (value >> 1) ^ -(value & 1);
@@ -240,6 +270,7 @@ struct SInt32 : public FieldType<int32_t, 0> {
 struct SInt64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 63)); }
+    constexpr uint64_t serializedSize() const { return varIntSize((value << 1) ^ (value >> 63)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = slice->getVarInt();
         value = (value >> 1) ^ -(value & 1);
@@ -250,6 +281,7 @@ struct SInt64 : public FieldType<int64_t, 0> {
 struct Bool : public FieldType<bool, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "bool";
 };
@@ -257,6 +289,7 @@ struct Bool : public FieldType<bool, 0> {
 struct Fixed64 : public FieldType<uint64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "fixed64";
 };
@@ -264,6 +297,7 @@ struct Fixed64 : public FieldType<uint64_t, 1> {
 struct SFixed64 : public FieldType<int64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "sfixed64";
 };
@@ -277,6 +311,7 @@ struct Double : public FieldType<double, 1> {
         } u = {value};
         slice->putU64(u.v);
     }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -293,6 +328,7 @@ struct String : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    uint64_t serializedSize() const { return varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "string";
 };
@@ -303,17 +339,18 @@ struct Bytes : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    uint64_t serializedSize() const { return varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "bytes";
 };
 
 template <size_t amount>
 struct FixedBytes {
-    ~FixedBytes() { delete[] value; }
+    ~FixedBytes() {
+        if (!m_borrowed) delete[] value;
+    }
     FixedBytes() {}
     FixedBytes(const FixedBytes &s) {
-        delete[] value;
-        value = nullptr;
         if (!s.value) return;
         allocate();
         memcpy(value, s.value, amount);
@@ -321,26 +358,44 @@ struct FixedBytes {
     FixedBytes(FixedBytes &&s) {
         if (!s.value) return;
         value = s.value;
+        m_borrowed = s.m_borrowed;
         s.value = nullptr;
+        s.m_borrowed = false;
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const {
         slice->putVarInt(amount);
         slice->putBytes(value, amount);
     }
+    static constexpr uint64_t serializedSize() { return varIntSize(amount) + amount; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         uint64_t size = slice->getVarInt();
         if (size > amount) throw OutOfBoundError();
+        if ((size == amount) && slice->canBorrow()) {
+            if (!m_borrowed) delete[] value;
+            // Only ever read from, until allocate() or reset() give it a buffer of its own
+            value = const_cast<uint8_t *>(slice->borrowBytes(size));
+            m_borrowed = true;
+            return;
+        }
         reset();
         slice->getBytes(value, size);
     }
     static constexpr char const typeName[] = "bytes";
     uint8_t *value = nullptr;
     constexpr void allocate() {
+        if (m_borrowed) {
+            const uint8_t *borrowed = value;
+            value = new uint8_t[amount];
+            memcpy(value, borrowed, amount);
+            m_borrowed = false;
+        }
         if (!value) value = new uint8_t[amount];
     }
+    // FieldPtr calls this on the pointer to its destination, as if it was a FixedBytes, so this must not touch
+    // anything else than the value itself. Which also means it can't be called on borrowed bytes.
     void copyFrom(const uint8_t *src) {
-        allocate();
+        if (!value) value = new uint8_t[amount];
         memcpy(value, src, amount);
     }
     constexpr void copyTo(uint8_t *dst) const {
@@ -352,17 +407,25 @@ struct FixedBytes {
     }
     typedef uint8_t *type;
     constexpr void reset() {
+        if (m_borrowed) {
+            value = nullptr;
+            m_borrowed = false;
+        }
         allocate();
         memset(value, 0, amount);
     }
     static constexpr unsigned wireType = 2;
     static constexpr bool matches(unsigned otherWireType) { return otherWireType == 2; }
     constexpr bool hasData() const { return value; }
+
+  private:
+    bool m_borrowed = false;
 };
 
 struct Fixed32 : public FieldType<uint32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "fixed32";
 };
@@ -370,6 +433,7 @@ struct Fixed32 : public FieldType<uint32_t, 5> {
 struct SFixed32 : public FieldType<int32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "sfixed32";
 };
@@ -383,6 +447,7 @@ struct Float : public FieldType<float, 5> {
         } u = {value};
         slice->putU32(u.v);
     }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -434,6 +499,10 @@ struct FieldRef<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         FieldType *field = reinterpret_cast<FieldType *>(&copy);
         field->deserialize(slice, wireType);
@@ -472,12 +541,18 @@ struct FieldPtr<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) { copy.deserialize(slice, wireType); }
     constexpr void reset() {}
     constexpr void commit() {
         FieldType *field = reinterpret_cast<FieldType *>(&ref);
         field->copyFrom(copy.value);
     }
+    // What deserialize() read, for when only parts of it need to go to the destination
+    const FieldType &deserialized() const { return copy; }
     constexpr bool hasData() const {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         return field->hasData();
@@ -514,23 +589,32 @@ struct RepeatedField<FieldType, amount, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            uint64_t size = 0;
+            for (const auto &v : value) size += v.serializedSize();
+            slice->putVarInt(size);
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                v.serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        uint64_t size = 0;
+        if (FieldType::wireType == 2) {
+            for (const auto &v : value) {
+                const uint64_t elementSize = v.serializedSize();
+                size += varIntSize((fieldNumber << 3) | FieldType::wireType) + varIntSize(elementSize) + elementSize;
+            }
+        } else {
+            for (const auto &v : value) size += v.serializedSize();
+            size += varIntSize(size);
+        }
+        return size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -581,27 +665,36 @@ struct RepeatedFieldRef<FieldType, amount, irqus::typestring<C...>, fieldNumberV
     static constexpr bool matches(unsigned wireType) { return wireType == 2 || FieldType::matches(wireType); }
     static constexpr bool needsToSerializeHeader() { return FieldType::wireType == 2; }
     void serialize(OutSlice *slice) const {
+        const FieldType *fields = reinterpret_cast<const FieldType *>(ref);
         if (FieldType::wireType == 2) {
             for (size_t i = 0; i < amount; i++) {
-                OutSlice subSlice;
-                FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(fields[i].serializedSize());
+                fields[i].serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            uint64_t size = 0;
+            for (size_t i = 0; i < amount; i++) size += fields[i].serializedSize();
+            slice->putVarInt(size);
             for (size_t i = 0; i < amount; i++) {
-                FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
+                fields[i].serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        const FieldType *fields = reinterpret_cast<const FieldType *>(ref);
+        uint64_t size = 0;
+        if (FieldType::wireType == 2) {
+            for (size_t i = 0; i < amount; i++) {
+                const uint64_t elementSize = fields[i].serializedSize();
+                size += varIntSize((fieldNumber << 3) | FieldType::wireType) + varIntSize(elementSize) + elementSize;
+            }
+        } else {
+            for (size_t i = 0; i < amount; i++) size += fields[i].serializedSize();
+            size += varIntSize(size);
+        }
+        return size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -651,23 +744,32 @@ struct RepeatedVariableField<FieldType, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            uint64_t size = 0;
+            for (const auto &v : value) size += v.serializedSize();
+            slice->putVarInt(size);
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                v.serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        uint64_t size = 0;
+        if (FieldType::wireType == 2) {
+            for (const auto &v : value) {
+                const uint64_t elementSize = v.serializedSize();
+                size += varIntSize((fieldNumber << 3) | FieldType::wireType) + varIntSize(elementSize) + elementSize;
+            }
+        } else {
+            for (const auto &v : value) size += v.serializedSize();
+            size += varIntSize(size);
+        }
+        return size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -714,11 +816,12 @@ struct MessageField<MessageType, irqus::typestring<C...>, fieldNumberValue> : pu
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const {
-        OutSlice subSlice;
-        MessageType::serialize(&subSlice);
-        std::string subSliceData = subSlice.finalize();
-        slice->putVarInt(subSliceData.size());
-        slice->putBytes(subSliceData);
+        slice->putVarInt(MessageType::serializedSize());
+        MessageType::serialize(slice);
+    }
+    uint64_t serializedSize() const {
+        const uint64_t size = MessageType::serializedSize();
+        return varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -760,6 +863,14 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const { serialize<0, fields...>(slice); }
+    // The amount of bytes serialize() outputs, like protobuf's ByteSizeLong(); nested messages are length
+    // prefixed, so knowing their sizes upfront lets them be written straight into their parent's output.
+    constexpr uint64_t serializedSize() const { return serializedSize<0, fields...>(); }
+    std::string serialize() const {
+        OutSlice slice(serializedSize());
+        serialize(&slice);
+        return slice.finalize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         while (slice->bytesLeft()) {
             uint64_t fieldNumber = slice->getVarInt();
@@ -822,6 +933,22 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
         serialize<index + 1, nestedFields...>(slice);
     }
     template <size_t index>
+    constexpr uint64_t serializedSize() const {
+        return 0;
+    }
+    template <size_t index, typename FieldType, typename... nestedFields>
+    constexpr uint64_t serializedSize() const {
+        const FieldType &field = std::get<index>(*this);
+        uint64_t size = 0;
+        if (field.hasData()) {
+            if (!FieldType::needsToSerializeHeader()) {
+                size += varIntSize((FieldType::fieldNumber << 3) | FieldType::wireType);
+            }
+            size += field.serializedSize();
+        }
+        return size + serializedSize<index + 1, nestedFields...>();
+    }
+    template <size_t index>
     constexpr void deserialize(uint64_t fieldNumber, unsigned wireType, InSlice *slice) {
         // Unknown field, skip it.
         switch (wireType) {
@@ -890,6 +1017,7 @@ class EmptyMessage<irqus::typestring<C...>> {
     constexpr void reset() {}
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const {}
+    static constexpr uint64_t serializedSize() { return 0; }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {}
     constexpr bool hasData() const { return false; }
     constexpr void commit() {}
@@ -27,6 +27,7 @@ SOFTWARE.
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <codecvt>
 #include <cstddef>
@@ -65,6 +66,20 @@ concept Settings = requires(S s) {
 };
 }  // namespace concepts
 
+// Settings get changed in place, by the UI, by Lua scripts, or by loading them. Whoever changes them marks it
+// here, and the UI's tick then signals Events::SettingsChanged once for everything which happened since the
+// previous tick, so that code keeping copies of settings, such as SettingObserver, can refresh them.
+struct SettingsChanges {
+    static void mark() { flag().store(true, std::memory_order_relaxed); }
+    static bool consume() { return flag().exchange(false, std::memory_order_relaxed); }
+
+  private:
+    static std::atomic<bool> &flag() {
+        static std::atomic<bool> s_flag = false;
+        return s_flag;
+    }
+};
+
 template <typename type, typename name>
 struct SettingVector;
 template <typename type, char... C>
@@ -114,6 +129,7 @@ struct Setting<type, irqus::typestring<C...>, defaultValue> {
                 } else {
                     value = type(L.checknumber());
                 }
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -121,6 +137,7 @@ struct Setting<type, irqus::typestring<C...>, defaultValue> {
             "reset",
             [this](Lua L) -> int {
                 reset();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -165,6 +182,7 @@ struct SettingString<irqus::typestring<C...>, irqus::typestring<D...>> {
             "newindex",
             [this](Lua L) -> int {
                 value = L.tostring();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -172,6 +190,7 @@ struct SettingString<irqus::typestring<C...>, irqus::typestring<D...>> {
             "reset",
             [this](Lua L) -> int {
                 reset();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -220,6 +239,7 @@ struct SettingPath<irqus::typestring<C...>, irqus::typestring<D...>> {
             "newindex",
             [this](Lua L) -> int {
                 value = L.tostring();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -227,6 +247,7 @@ struct SettingPath<irqus::typestring<C...>, irqus::typestring<D...>> {
             "reset",
             [this](Lua L) -> int {
                 reset();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -278,6 +299,7 @@ struct SettingFloat<irqus::typestring<C...>, defaultValue, divisor> {
             "newindex",
             [this](Lua L) -> int {
                 value = L.checknumber();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -285,6 +307,7 @@ struct SettingFloat<irqus::typestring<C...>, defaultValue, divisor> {
             "reset",
             [this](Lua L) -> int {
                 reset();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -330,6 +353,7 @@ struct SettingNested<irqus::typestring<C...>, nestedSettings> : public nestedSet
             "reset",
             [this](Lua L) -> int {
                 nestedSettings::reset();
+                SettingsChanges::mark();
                 return 0;
             },
             -1);
@@ -337,6 +361,30 @@ struct SettingNested<irqus::typestring<C...>, nestedSettings> : public nestedSet
     }
 };
 
+// A copy of a setting's value, for code which runs often, or on another thread than the UI's. It's refreshed
+// when the settings get loaded or changed, and reading it is a relaxed atomic load, which is fine to do from any
+// thread, unlike reading the setting itself while the UI may be writing to it.
+template <typename setting>
+class SettingObserver {
+  public:
+    using type = std::remove_cvref_t<decltype(std::declval<setting>().value)>;
+    SettingObserver(const setting &s) : m_setting(s), m_value(s.value), m_listener(g_system->m_eventBus) {
+        m_listener.listen<Events::SettingsLoaded>([this](const auto &event) { refresh(); });
+        m_listener.listen<Events::SettingsChanged>([this](const auto &event) { refresh(); });
+    }
+    SettingObserver(const SettingObserver &) = delete;
+    SettingObserver &operator=(const SettingObserver &) = delete;
+    type get() const { return m_value.load(std::memory_order_relaxed); }
+    operator type() const { return get(); }
+    // For whoever changes the setting and needs the copy to follow right away.
+    void refresh() { m_value.store(m_setting.value, std::memory_order_relaxed); }
+
+  private:
+    const setting &m_setting;
+    std::atomic<type> m_value;
+    EventBus::Listener m_listener;
+};
+
 template <concepts::Setting... settings>
 struct Settings : private std::tuple<settings...> {
     using json = nlohmann::json;
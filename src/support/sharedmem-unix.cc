@@ -27,15 +27,78 @@ SOFTWARE.
 #if !defined(_WIN32) && !defined(_WIN64)
 
 #include <assert.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#if defined(__APPLE__)
+#include <mach/vm_statistics.h>
+#endif
+
 #include "support/sharedmem.h"
 
-bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
+namespace {
+
+constexpr size_t c_largePageSize = 2 * 1024 * 1024;
+
+uintptr_t alignToLargePage(uintptr_t value) { return (value + c_largePageSize - 1) & ~(c_largePageSize - 1); }
+
+std::string getLockPath(const std::string& name) {
+    const char* tmpdir = getenv("TMPDIR");
+    return std::string((tmpdir != nullptr) && (tmpdir[0] != 0) ? tmpdir : "/tmp") + "/" + name + ".lock";
+}
+
+}  // namespace
+
+bool PCSX::SharedMem::adviseLargePages(void* ptr, size_t size) {
+#if defined(MADV_HUGEPAGE)
+    const uintptr_t start = alignToLargePage(reinterpret_cast<uintptr_t>(ptr));
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~(c_largePageSize - 1);
+    if (end <= start) return false;
+    return madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
+
+bool PCSX::SharedMem::allocLarge(size_t size) {
+    const size_t rounded = alignToLargePage(size);
+    void* basePointer = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    // Only works if the administrator reserved some huge pages beforehand.
+    basePointer = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#elif defined(VM_FLAGS_SUPERPAGE_SIZE_2MB)
+    basePointer =
+        mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, VM_FLAGS_SUPERPAGE_SIZE_2MB, 0);
+#endif
+    if (basePointer != MAP_FAILED) {
+        m_mem = static_cast<uint8_t*>(basePointer);
+        m_mappedSize = rounded;
+        m_pages = Pages::Large;
+        return true;
+    }
+
+    // Transparent huge pages need the mapping to be aligned on them, so map one more, and trim around it.
+    basePointer = mmap(nullptr, rounded + c_largePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (basePointer == MAP_FAILED) return false;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(basePointer);
+    const uintptr_t start = alignToLargePage(base);
+    if (start != base) munmap(basePointer, start - base);
+    if (start + rounded != base + rounded + c_largePageSize) {
+        munmap(reinterpret_cast<void*>(start + rounded), base + c_largePageSize - start);
+    }
+    m_mem = reinterpret_cast<uint8_t*>(start);
+    m_mappedSize = rounded;
+    m_pages = adviseLargePages(m_mem, rounded) ? Pages::Advised : Pages::Regular;
+    return true;
+}
+
+bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero, bool largePages) {
     assert(m_mem == nullptr);
     bool doRawAlloc = true;
     m_size = size;
@@ -59,6 +122,8 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
                 if (basePointer != MAP_FAILED) {
                     doRawAlloc = false;
                     m_mem = static_cast<uint8_t*>(basePointer);
+                    // Shared memory can't come from reserved huge pages, but may get transparent ones.
+                    if (largePages && adviseLargePages(m_mem, size)) m_pages = Pages::Advised;
                     // Initialise memory to zero, if requested
                     if (initToZero) {
                         memset(m_mem, 0, size);
@@ -73,16 +138,146 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     }
     // Alloc memory directly if we opted out or had problems creating the memory map
     if (doRawAlloc) {
-        // calloc will automatically init memory to zero
-        m_mem = (uint8_t*)calloc(size, 1);
+        // Anonymous mappings are zeroed already, and so is calloc's memory. Mapping it ourselves keeps it on page
+        // boundaries, for mapCopyOnWrite.
+        if (!largePages || !allocLarge(size)) {
+            void* basePointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (basePointer != MAP_FAILED) {
+                m_mem = static_cast<uint8_t*>(basePointer);
+                m_mappedSize = size;
+            } else {
+                m_mem = (uint8_t*)calloc(size, 1);
+            }
+        }
     }
 
     // Return false if we had to fall back to a raw alloc
     return !(doRawAlloc && id != nullptr);
 }
 
+bool PCSX::SharedMem::initPublished(std::string_view key, size_t size) {
+    assert(m_mem == nullptr);
+    m_size = size;
+    m_owner = static_cast<uint32_t>(getpid());
+    const std::string name = getPublishedName(key);
+    const size_t total = c_publishedHeaderSize + size;
+    // Names outlive their processes, crashed or not. Every user of the memory holds a shared lock on this file
+    // instead, which the kernel drops along with the process, so whoever gets it exclusively knows that nobody
+    // uses the memory anymore. The lock files stay behind, but they're empty.
+    int lockFd = open(getLockPath(name).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (lockFd >= 0) {
+        if (flock(lockFd, LOCK_EX | LOCK_NB) == 0) {
+            // Whatever is there got left behind, possibly half filled.
+            shm_unlink(name.c_str());
+            int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+            void* basePointer = MAP_FAILED;
+            if ((fd >= 0) && (ftruncate(fd, static_cast<off_t>(total)) == 0)) {
+                basePointer = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            if (basePointer != MAP_FAILED) {
+                // Going down to a shared lock isn't atomic, so someone else may take the name over in between.
+                // This memory then just ends up private to us, which is fine.
+                flock(lockFd, LOCK_SH);
+                // The memory comes zeroed, so the state starts as Filling.
+                m_header = static_cast<PublishedHeader*>(basePointer);
+                m_header->size = size;
+                m_mem = static_cast<uint8_t*>(basePointer) + c_publishedHeaderSize;
+                m_fd = fd;
+                m_lockFd = lockFd;
+                m_sharedName = name;
+                m_publisher = true;
+                return false;
+            }
+            if (fd >= 0) {
+                shm_unlink(name.c_str());
+                close(fd);
+            }
+        } else if (flock(lockFd, LOCK_SH) == 0) {
+            int fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd >= 0) {
+                struct stat st;
+                void* basePointer = MAP_FAILED;
+                if ((fstat(fd, &st) == 0) && (static_cast<size_t>(st.st_size) == total)) {
+                    basePointer = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                }
+                if (basePointer != MAP_FAILED) {
+                    auto header = static_cast<PublishedHeader*>(basePointer);
+                    if ((header->state.load(std::memory_order_acquire) == PublishedHeader::Published) &&
+                        (header->size == size)) {
+                        m_header = header;
+                        m_mem = static_cast<uint8_t*>(basePointer) + c_publishedHeaderSize;
+                        mprotect(m_mem, size, PROT_READ);
+                        m_fd = fd;
+                        m_lockFd = lockFd;
+                        m_sharedName = name;
+                        return true;
+                    }
+                    munmap(basePointer, total);
+                }
+                close(fd);
+            }
+        }
+        close(lockFd);
+    }
+
+    // Someone else is still filling it, or it can't be shared at all.
+    m_mem = (uint8_t*)calloc(size, 1);
+    return false;
+}
+
+void PCSX::SharedMem::publish() {
+    if (!m_publisher || (m_owner != static_cast<uint32_t>(getpid()))) return;
+    m_publisher = false;
+    mprotect(m_mem, m_size, PROT_READ);
+    m_header->state.store(PublishedHeader::Published, std::memory_order_release);
+}
+
+bool PCSX::SharedMem::mapCopyOnWrite(const SharedMem& published) {
+    if ((published.m_header == nullptr) || (published.m_size != m_size) || (m_mappedSize == 0)) return false;
+    if (published.m_header->state.load(std::memory_order_acquire) != PublishedHeader::Published) return false;
+    // The whole of the memory gets replaced, so it needs to cover whole pages.
+    if ((m_size % static_cast<size_t>(sysconf(_SC_PAGESIZE))) != 0) return false;
+    void* basePointer = mmap(m_mem, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, published.m_fd,
+                             static_cast<off_t>(c_publishedHeaderSize));
+    return basePointer != MAP_FAILED;
+}
+
+bool PCSX::SharedMem::detach() {
+    // Nobody writes into published memory, so it can stay shared.
+    if ((m_fd == -1) || (m_header != nullptr)) return true;
+    // Swapping the shared mapping for a private one, at the same address, so that the pointers into it which
+    // are lying around stay valid.
+    uint8_t* copy = static_cast<uint8_t*>(malloc(m_size));
+    if (copy == nullptr) return false;
+    memcpy(copy, m_mem, m_size);
+    void* basePointer = mmap(m_mem, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (basePointer == MAP_FAILED) {
+        free(copy);
+        return false;
+    }
+    memcpy(m_mem, copy, m_size);
+    free(copy);
+    // The segment's name belongs to the parent, which will unlink it.
+    close(m_fd);
+    m_fd = -1;
+    m_detached = true;
+    return true;
+}
+
 PCSX::SharedMem::~SharedMem() {
-    if (m_fd == -1) {
+    if (m_header != nullptr) {
+        // The last one out takes the name down, and so does whoever was filling it, as nobody else is going to.
+        // A forked process shares its parent's lock, so it's not for it to tell.
+        const bool owner = m_owner == static_cast<uint32_t>(getpid());
+        if (owner && (m_publisher || (flock(m_lockFd, LOCK_EX | LOCK_NB) == 0))) shm_unlink(m_sharedName.c_str());
+        munmap(m_header, c_publishedHeaderSize + m_size);
+        close(m_fd);
+        close(m_lockFd);
+    } else if (m_detached) {
+        munmap(m_mem, m_size);
+    } else if (m_mappedSize != 0) {
+        munmap(m_mem, m_mappedSize);
+    } else if (m_fd == -1) {
         free(m_mem);
     } else {
         munmap(m_mem, m_size);
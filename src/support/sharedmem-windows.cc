@@ -30,7 +30,41 @@ SOFTWARE.
 #include "support/sharedmem.h"
 #include "support/windowswrapper.h"
 
-bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
+namespace {
+
+// Large pages can only be allocated by users holding the "Lock pages in memory" right,
+// and only once the process enabled it.
+bool enableLockMemoryPrivilege() {
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return false;
+    TOKEN_PRIVILEGES privileges;
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    bool ret = LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+               AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+               (GetLastError() == ERROR_SUCCESS);
+    CloseHandle(token);
+    return ret;
+}
+
+}  // namespace
+
+bool PCSX::SharedMem::adviseLargePages(void* ptr, size_t size) { return false; }
+
+bool PCSX::SharedMem::allocLarge(size_t size) {
+    static const bool privileged = enableLockMemoryPrivilege();
+    const size_t pageSize = GetLargePageMinimum();
+    if (!privileged || (pageSize == 0)) return false;
+    const size_t rounded = (size + pageSize - 1) & ~(pageSize - 1);
+    void* basePointer = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    if (basePointer == nullptr) return false;
+    m_mem = static_cast<uint8_t*>(basePointer);
+    m_mappedSize = rounded;
+    m_pages = Pages::Large;
+    return true;
+}
+
+bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero, bool largePages) {
     assert(m_mem == nullptr);
     bool doRawAlloc = true;
     m_size = size;
@@ -63,19 +97,80 @@ bool PCSX::SharedMem::init(const char* id, size_t size, bool initToZero) {
     }
     // Alloc memory directly if we opted out or had problems creating the memory map
     if (doRawAlloc) {
-        // calloc will automatically init memory to zero
-        m_mem = (uint8_t*)calloc(size, 1);
+        // VirtualAlloc zeroes its memory, and so does calloc.
+        if (!largePages || !allocLarge(size)) m_mem = (uint8_t*)calloc(size, 1);
     }
     // Return false if we had to fall back to a raw alloc
     return !(doRawAlloc && id != nullptr);
 }
 
+// Mappings go away with their last handle, so there's nobody to count here.
+bool PCSX::SharedMem::initPublished(std::string_view key, size_t size) {
+    assert(m_mem == nullptr);
+    m_size = size;
+    const std::string name = "Local\\" + getPublishedName(key);
+    const size_t total = c_publishedHeaderSize + size;
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<uint32_t>(total >> 32),
+                                       static_cast<uint32_t>(total), name.c_str());
+    if (handle != nullptr) {
+        const bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+        // This fails if an existing mapping is smaller than what we need.
+        void* basePointer = MapViewOfFileEx(handle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, total, nullptr);
+        if (basePointer != nullptr) {
+            auto header = static_cast<PublishedHeader*>(basePointer);
+            if (!existed) {
+                // The memory comes zeroed, so the state starts as Filling.
+                header->size = size;
+                m_header = header;
+                m_mem = static_cast<uint8_t*>(basePointer) + c_publishedHeaderSize;
+                m_fileHandle = handle;
+                m_publisher = true;
+                return false;
+            }
+            if ((header->state.load(std::memory_order_acquire) == PublishedHeader::Published) &&
+                (header->size == size)) {
+                m_header = header;
+                m_mem = static_cast<uint8_t*>(basePointer) + c_publishedHeaderSize;
+                m_fileHandle = handle;
+                DWORD oldProtect;
+                VirtualProtect(m_mem, size, PAGE_READONLY, &oldProtect);
+                return true;
+            }
+            UnmapViewOfFile(basePointer);
+        }
+        CloseHandle(handle);
+    }
+
+    // Someone else is still filling it, or it can't be shared at all.
+    m_mem = (uint8_t*)calloc(size, 1);
+    return false;
+}
+
+void PCSX::SharedMem::publish() {
+    if (!m_publisher) return;
+    m_publisher = false;
+    DWORD oldProtect;
+    VirtualProtect(m_mem, m_size, PAGE_READONLY, &oldProtect);
+    m_header->state.store(PublishedHeader::Published, std::memory_order_release);
+}
+
+// Views can't be mapped over memory which is already there.
+bool PCSX::SharedMem::mapCopyOnWrite(const SharedMem& published) { return false; }
+
+// There's no forking on Windows, so a shared view can't be anything but shared.
+bool PCSX::SharedMem::detach() { return m_fileHandle == nullptr; }
+
 PCSX::SharedMem::~SharedMem() {
-    if (m_fileHandle != nullptr) {
+    if (m_header != nullptr) {
+        UnmapViewOfFile(m_header);
+        CloseHandle(m_fileHandle);
+    } else if (m_fileHandle != nullptr) {
         UnmapViewOfFile(m_mem);
         m_mem = nullptr;
         CloseHandle(m_fileHandle);
         m_fileHandle = nullptr;
+    } else if (m_mappedSize != 0) {
+        VirtualFree(m_mem, 0, MEM_RELEASE);
     } else {
         free(m_mem);
     }
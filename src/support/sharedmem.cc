@@ -27,8 +27,25 @@ SOFTWARE.
 #include "support/sharedmem.h"
 
 #include "fmt/format.h"
+#include "support/hashing.h"
 
 std::string PCSX::SharedMem::getSharedName(const char* id, uint32_t pid) {
     // Example name: pcsx-redux-wram-37045
     return fmt::format("pcsx-redux-{}-{}", id, pid);
 }
+
+std::string PCSX::SharedMem::getPublishedName(std::string_view key) {
+    // Example name: pcsx-redux-8a4f16c2d9e0b153. Keys can be anything, but names can't be long on all systems.
+    return fmt::format("pcsx-redux-{:016x}", Hashing::xxh64(key.data(), key.size()));
+}
+
+const char* PCSX::SharedMem::describe(Pages pages) {
+    switch (pages) {
+        case Pages::Large:
+            return "large pages";
+        case Pages::Advised:
+            return "transparent huge pages, when available";
+        default:
+            return "regular pages";
+    }
+}
@@ -28,7 +28,9 @@ SOFTWARE.
 
 #include <stdint.h>
 
+#include <atomic>
 #include <string>
+#include <string_view>
 
 namespace PCSX {
 
@@ -44,13 +46,69 @@ class SharedMem {
      * Returns false if:
      *  - the memory failed to successfully share and defaulted to a raw alloc
      */
-    bool init(const char* id, size_t size, bool initToZero);
+    bool init(const char* id, size_t size, bool initToZero, bool largePages = false);
 
     uint8_t* getPtr() { return m_mem; }
     size_t getSize() { return m_size; }
 
+    /**
+     * What backs the memory, when large pages got asked for. These can run out,
+     * or need privileges the user doesn't have, in which case the memory silently
+     * falls back to the next best thing:
+     *  - Large: the memory is guaranteed to sit on large pages,
+     *  - Advised: the kernel got told to use transparent huge pages when it can,
+     *  - Regular: nothing special happened.
+     */
+    enum class Pages { Regular, Advised, Large };
+    Pages pages() const { return m_pages; }
+    static const char* describe(Pages pages);
+
+    /**
+     * Asks for the part of an existing allocation which covers whole large pages
+     * to be backed by them. Only Linux' transparent huge pages can do this, so
+     * this returns false anywhere else.
+     */
+    static bool adviseLargePages(void* ptr, size_t size);
+
+    /**
+     * Shares the memory with all of the processes of the host asking for the
+     * same key, for data which never changes once written, such as ROMs, or
+     * whole files read in memory. Returns true if another process already
+     * published its contents, which are then ready, and read only. Otherwise,
+     * the memory is for this process to fill, and then publish for the others
+     * to get from then on. When the memory can't be shared, it's a private
+     * allocation, which publishing does nothing to.
+     */
+    bool initPublished(std::string_view key, size_t size);
+    void publish();
+
+    /**
+     * Swaps the pages of this memory, which needs to be a raw allocation, for
+     * copy-on-write mappings of the published memory, which has to hold the
+     * same contents. Writing into them afterwards only ever changes this
+     * process' copy. Returns false if this isn't possible on this platform.
+     */
+    bool mapCopyOnWrite(const SharedMem& published);
+
+    /**
+     * Stops sharing the memory, keeping its contents and its address. This is
+     * for a forked process, which would otherwise keep writing into the memory
+     * of its parent. Returns false if this isn't possible on this platform.
+     */
+    bool detach();
+
   private:
+    // Leaves room for the largest pages around, so that the published contents sit on a page boundary.
+    static constexpr size_t c_publishedHeaderSize = 64 * 1024;
+    struct PublishedHeader {
+        enum : uint32_t { Filling, Published };
+        std::atomic<uint32_t> state;
+        uint64_t size;
+    };
+
     std::string getSharedName(const char* id, uint32_t pid);
+    std::string getPublishedName(std::string_view key);
+    bool allocLarge(size_t size);
 
   private:
     uint8_t* m_mem = nullptr;
@@ -59,6 +117,17 @@ class SharedMem {
     void* m_fileHandle = nullptr;
     std::string m_sharedName;
     int m_fd = -1;
+    // Held shared by the users of published memory, on systems where it doesn't go away with its last user.
+    int m_lockFd = -1;
+    bool m_detached = false;
+    // Non zero when the raw allocation got mapped directly, instead of coming from calloc.
+    size_t m_mappedSize = 0;
+    Pages m_pages = Pages::Regular;
+    PublishedHeader* m_header = nullptr;
+    // Whether this process is the one filling the published memory.
+    bool m_publisher = false;
+    // A forked process inherits the published memory, and its parent's lock on it, but isn't one of its users.
+    uint32_t m_owner = 0;
 };
 
 }  // namespace PCSX
@@ -33,9 +33,11 @@ SOFTWARE.
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 #include "fmt/format.h"
 
@@ -144,6 +146,29 @@ class Slice {
         m_data = Borrowed{L - 1, data};
     }
     void borrow(const void *data, uint32_t size) { m_data = Borrowed{size, data}; }
+    // Shared slices hold a reference on whatever owns their data, so copying them never copies the data, and
+    // the data stays around for as long as any of the copies does. The data can't be modified through them.
+    void share(std::string &&str) {
+        auto owner = std::make_shared<const std::string>(std::move(str));
+        share(owner, owner->data(), owner->size());
+    }
+    void share(std::shared_ptr<const void> owner, const void *data, uint32_t size) {
+        m_data = Shared{size, data, std::move(owner)};
+    }
+    // Another slice of the same data, holding the same reference when this one is shared.
+    Slice subSlice(uint32_t from, uint32_t amount = std::numeric_limits<uint32_t>::max()) const {
+        Slice ret;
+        if (std::holds_alternative<Shared>(m_data)) {
+            auto &data = std::get<Shared>(m_data);
+            if (from < data.size) {
+                ret.share(data.owner, static_cast<const uint8_t *>(data.ptr) + from, std::min(amount, data.size - from));
+            }
+        } else {
+            ret.borrow(*this, from, amount);
+        }
+        return ret;
+    }
+    bool isShared() const { return std::holds_alternative<Shared>(m_data); }
     template <typename T = void>
     const T *data() const {
         const void *ret = nullptr;
@@ -155,6 +180,8 @@ class Slice {
             ret = std::get<Owned>(m_data).ptr;
         } else if (std::holds_alternative<Borrowed>(m_data)) {
             ret = std::get<Borrowed>(m_data).ptr;
+        } else if (std::holds_alternative<Shared>(m_data)) {
+            ret = std::get<Shared>(m_data).ptr;
         }
         return static_cast<const T *>(ret);
     }
@@ -169,6 +196,8 @@ class Slice {
             ret = std::get<Owned>(m_data).ptr;
         } else if (std::holds_alternative<Borrowed>(m_data)) {
             throw std::runtime_error("Cannot modify borrowed data");
+        } else if (std::holds_alternative<Shared>(m_data)) {
+            throw std::runtime_error("Cannot modify shared data");
         }
         return static_cast<T *>(ret);
     }
@@ -181,6 +210,8 @@ class Slice {
             return std::get<Owned>(m_data).size;
         } else if (std::holds_alternative<Borrowed>(m_data)) {
             return std::get<Borrowed>(m_data).size;
+        } else if (std::holds_alternative<Shared>(m_data)) {
+            return std::get<Shared>(m_data).size;
         }
         return 0;
     }
@@ -259,7 +290,57 @@ class Slice {
         uint32_t size;
         const void *ptr;
     };
-    std::variant<std::monostate, std::string, Inlined, Owned, Borrowed> m_data;
+    struct Shared {
+        uint32_t size;
+        const void *ptr;
+        std::shared_ptr<const void> owner;
+    };
+    std::variant<std::monostate, std::string, Inlined, Owned, Borrowed, Shared> m_data;
+};
+
+// A list of slices meant to go out back to back, such as a response made of its headers, then a body borrowed
+// from the emulator, or shared between several clients, so that it can be handed over to a vectored write
+// without first gathering it all into one buffer.
+class SliceChain {
+  public:
+    SliceChain() {}
+    SliceChain(Slice &&slice) { append(std::move(slice)); }
+    void append(Slice &&slice) {
+        if (slice.size() == 0) return;
+        m_size += slice.size();
+        m_slices.push_back(std::move(slice));
+    }
+    void append(std::string &&str) { append(Slice(std::move(str))); }
+    template <size_t L>
+    void append(const char (&data)[L]) {
+        append(Slice(data));
+    }
+    void append(SliceChain &&other) {
+        for (auto &slice : other.m_slices) append(std::move(slice));
+        other.reset();
+    }
+    size_t size() const { return m_size; }
+    size_t count() const { return m_slices.size(); }
+    const Slice &operator[](size_t index) const { return m_slices[index]; }
+    auto begin() const { return m_slices.begin(); }
+    auto end() const { return m_slices.end(); }
+    void reset() {
+        m_slices.clear();
+        m_size = 0;
+    }
+    // For whoever really needs all of it in one piece.
+    Slice flatten() const {
+        if (m_slices.size() == 1) return m_slices[0];
+        std::string ret;
+        ret.reserve(m_size);
+        for (auto &slice : m_slices) ret.append(slice.asStringView());
+        return Slice(std::move(ret));
+    }
+
+  private:
+    // Inlined slices point within themselves, so pointers into them only hold once the chain stops growing.
+    std::vector<Slice> m_slices;
+    size_t m_size = 0;
 };
 
 }  // namespace PCSX
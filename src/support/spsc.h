@@ -0,0 +1,144 @@
+/*
+
+MIT License
+
+Copyright (c) 2024 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+
+namespace PCSX {
+
+// A single producer, single consumer ring buffer. Moving data around only uses atomics; the mutex and condition
+// variable are only there for either side to sleep when the ring is full or empty, and only get touched when
+// the other side is actually sleeping.
+//
+// The producer reserves room, writes any amount of items into it, then publishes them all at once, so the
+// consumer never sees a partial batch. The consumer reads the items in place, and releases them once done
+// with them, which is what drain() waits on.
+template <typename T, size_t BS = 1024>
+class SPSC {
+    static_assert((BS & (BS - 1)) == 0, "The size of the ring needs to be a power of 2");
+
+  public:
+    static constexpr size_t BUFFER_SIZE = BS;
+
+    // Producer side.
+
+    // Waits for room for N more items, past the ones already written.
+    void reserve(size_t N) {
+        if (N > BUFFER_SIZE) {
+            throw std::runtime_error("Trying to reserve too much data");
+        }
+        if (roomFor(N)) return;
+        // The consumer can only make room out of what it's able to see.
+        publish();
+        sleepUntil(m_producerSleeping, [this, N]() { return roomFor(N); });
+    }
+    // Needs to be preceded by a reserve call covering it.
+    void write(const T* data, size_t N) {
+        for (size_t i = 0; i < N; i++) m_buffer[(m_writeCursor + i) & (BUFFER_SIZE - 1)] = data[i];
+        m_writeCursor += N;
+    }
+    void publish() {
+        m_head.store(m_writeCursor);
+        wake(m_consumerSleeping);
+    }
+    // Returns once the consumer has released everything written so far.
+    void drain() {
+        if (m_tail.load() == m_writeCursor) return;
+        publish();
+        sleepUntil(m_producerSleeping, [this]() { return m_tail.load() == m_writeCursor; });
+    }
+    // For the consumer to notice a change in the state its waitForData call is looking at.
+    void wakeConsumer() {
+        std::unique_lock<std::mutex> l(m_mu);
+        m_cv.notify_all();
+    }
+
+    // Consumer side.
+
+    // Waits until there's something to read, or stopping is set. Returns false only when the ring is empty.
+    bool waitForData(const std::atomic<bool>& stopping) {
+        if (buffered() != 0) return true;
+        sleepUntil(m_consumerSleeping, [this, &stopping]() {
+            return (m_head.load() != m_tail.load(std::memory_order_relaxed)) || stopping.load();
+        });
+        return buffered() != 0;
+    }
+    size_t buffered() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed); }
+    const T& peek(size_t offset) const {
+        return m_buffer[(m_tail.load(std::memory_order_relaxed) + offset) & (BUFFER_SIZE - 1)];
+    }
+    // Calls f on the N items starting at offset, with at most two contiguous pieces when they wrap around.
+    template <typename F>
+    void read(size_t offset, size_t N, F&& f) const {
+        const size_t begin = (m_tail.load(std::memory_order_relaxed) + offset) & (BUFFER_SIZE - 1);
+        const size_t subLen = BUFFER_SIZE - begin;
+        if (N > subLen) {
+            f(m_buffer + begin, subLen);
+            f(m_buffer, N - subLen);
+        } else if (N != 0) {
+            f(m_buffer + begin, N);
+        }
+    }
+    void release(size_t N) {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + N);
+        wake(m_producerSleeping);
+    }
+
+  private:
+    bool roomFor(size_t N) const { return (BUFFER_SIZE - (m_writeCursor - m_tail.load())) >= N; }
+
+    // The sleeping flag is set before checking the condition one last time, and the other side checks the flag
+    // after updating its cursor. Both being sequentially consistent, one of them is bound to see the other.
+    template <typename P>
+    void sleepUntil(std::atomic<bool>& sleeping, P&& predicate) {
+        std::unique_lock<std::mutex> l(m_mu);
+        sleeping.store(true);
+        m_cv.wait(l, predicate);
+        sleeping.store(false);
+    }
+    void wake(const std::atomic<bool>& sleeping) {
+        if (!sleeping.load()) return;
+        std::unique_lock<std::mutex> l(m_mu);
+        m_cv.notify_all();
+    }
+
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    alignas(64) size_t m_writeCursor = 0;
+    alignas(64) std::atomic<bool> m_producerSleeping = false;
+    std::atomic<bool> m_consumerSleeping = false;
+    alignas(64) T m_buffer[BUFFER_SIZE];
+
+    std::mutex m_mu;
+    std::condition_variable m_cv;
+};
+
+}  // namespace PCSX
@@ -27,10 +27,14 @@ SOFTWARE.
 #pragma once
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 namespace PCSX {
 
@@ -359,6 +363,7 @@ class Tree final {
     }
 
     unsigned m_count = 0;
+    uint64_t m_generation = 0;
     Node* m_root = nullptr;
 
     template <class Derived, class Base>
@@ -434,6 +439,9 @@ class Tree final {
     }
 
     unsigned size() const { return m_count; }
+    // Bumped each time a node gets inserted or unlinked, including when deleted, so that copies
+    // of the tree's contents, like IntervalSnapshot, can tell when they are stale.
+    uint64_t generation() const { return m_generation; }
     iterator begin() {
         Node* min = m_root;
         while (min->m_left != &m_nil) min = min->m_left;
@@ -464,6 +472,7 @@ class Tree final {
         insertInternal(z);
 
         m_count++;
+        m_generation++;
         return iterator(z);
     }
     iterator insert(const Key& low, const Key& high, Node* const z) {
@@ -474,6 +483,7 @@ class Tree final {
         insertInternal(z);
 
         m_count++;
+        m_generation++;
         return iterator(z);
     }
     iterator find(const Key& key) {
@@ -542,6 +552,7 @@ class Tree final {
         z->m_tree = nullptr;
 
         m_count--;
+        m_generation++;
     }
     bool contains(Node* node) const { return this == node->m_root; }
     void destroyAll() {
@@ -551,4 +562,78 @@ class Tree final {
 
 }  // namespace Intrusive
 
+// Flattened, read-only copy of some of the intervals of a Tree, for when they rarely change but get
+// looked up all the time, like breakpoints from the memory access paths. The intervals are kept in
+// plain arrays, sorted by their low end, along with the running maximum of their high ends. Finding the
+// ones overlapping a range is then two binary searches, which compile to conditional moves, and a
+// forward scan, instead of chasing the tree's pointers. It doesn't follow changes made to the tree;
+// compare the tree's generation against the snapshot's and rebuild it when they differ.
+template <typename Key, class T>
+class IntervalSnapshot final {
+  public:
+    template <class Tree, class Filter>
+    void rebuild(Tree& tree, Filter&& filter) {
+        m_lows.clear();
+        m_highs.clear();
+        m_maxHighs.clear();
+        m_values.clear();
+        for (auto& value : tree) {
+            if (!filter(value)) continue;
+            Key high = value.getHigh();
+            m_lows.push_back(value.getLow());
+            m_highs.push_back(high);
+            m_maxHighs.push_back(m_maxHighs.empty() ? high : std::max(m_maxHighs.back(), high));
+            m_values.push_back(&value);
+        }
+        m_generation = tree.generation();
+    }
+    template <class Tree>
+    void rebuild(Tree& tree) {
+        rebuild(tree, [](const T&) { return true; });
+    }
+
+    uint64_t generation() const { return m_generation; }
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    // Calls back with each interval overlapping [low, high], in the tree's order.
+    template <class Callback>
+    void forEachOverlapping(const Key& low, const Key& high, Callback&& callback) const {
+        // Intervals past the last one starting at or before high can't overlap, nor can the
+        // ones before the first which has an interval ending at or after low somewhere up to it.
+        const size_t end = search(m_lows, [&high](const Key& key) { return key <= high; });
+        for (size_t i = search(m_maxHighs, [&low](const Key& key) { return key < low; }); i < end; i++) {
+            if (m_highs[i] >= low) callback(m_values[i]);
+        }
+    }
+    bool overlaps(const Key& low, const Key& high) const {
+        const size_t end = search(m_lows, [&high](const Key& key) { return key <= high; });
+        for (size_t i = search(m_maxHighs, [&low](const Key& key) { return key < low; }); i < end; i++) {
+            if (m_highs[i] >= low) return true;
+        }
+        return false;
+    }
+
+  private:
+    // The number of leading keys the predicate holds for, given that it's true for a prefix of the array.
+    template <class Predicate>
+    static size_t search(const std::vector<Key>& keys, Predicate&& predicate) {
+        size_t count = keys.size();
+        if (count == 0) return 0;
+        const Key* base = keys.data();
+        while (count > 1) {
+            const size_t half = count / 2;
+            base += predicate(base[half - 1]) ? half : 0;
+            count -= half;
+        }
+        return (base - keys.data()) + (predicate(*base) ? 1 : 0);
+    }
+
+    std::vector<Key> m_lows;
+    std::vector<Key> m_highs;
+    std::vector<Key> m_maxHighs;
+    std::vector<T*> m_values;
+    uint64_t m_generation = 0;
+};
+
 }  // namespace PCSX
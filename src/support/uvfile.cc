@@ -29,6 +29,9 @@ SOFTWARE.
 
 #include <cstdint>
 #include <exception>
+#include <vector>
+
+#include "fmt/format.h"
 
 struct CurlContext {
     CurlContext(curl_socket_t sockfd, uv_loop_t *loop) : sockfd(sockfd) {
@@ -47,6 +50,8 @@ struct CurlContext {
 
 std::thread PCSX::UvThreadOp::s_uvThread;
 bool PCSX::UvThreadOp::s_threadRunning = false;
+std::mutex PCSX::UvThreadOp::s_threadUsersMutex;
+unsigned PCSX::UvThreadOp::s_threadUsers = 0;
 uv_async_t PCSX::UvThreadOp::s_kicker;
 uv_timer_t PCSX::UvThreadOp::s_timer;
 size_t PCSX::UvThreadOp::s_dataReadTotal;
@@ -67,6 +72,16 @@ CURLM *PCSX::UvThreadOp::s_curlMulti = nullptr;
 uint64_t PCSX::UvThreadOp::s_readSequence = 0;
 uint64_t PCSX::UvThreadOp::s_writeSequence = 0;
 
+void PCSX::UvThreadOp::acquireThread() {
+    std::unique_lock<std::mutex> lock(s_threadUsersMutex);
+    if (s_threadUsers++ == 0) startThread();
+}
+
+void PCSX::UvThreadOp::releaseThread() {
+    std::unique_lock<std::mutex> lock(s_threadUsersMutex);
+    if (--s_threadUsers == 0) stopThread();
+}
+
 void PCSX::UvThreadOp::startThread() {
     if (s_threadRunning) throw std::runtime_error("UV thread already running");
     std::promise<void> barrier;
@@ -209,16 +224,24 @@ void PCSX::UvFile::closeInternal() {
         m_cancelDownload.store(true, std::memory_order_release);
         m_cacheBarrier.get_future().wait();
     } else if (m_cache && (m_cacheProgress.load(std::memory_order_acquire) != 1.0)) {
-        request([this](auto loop) { m_cachePtr = m_size; });
+        request([this](auto loop) {
+            m_cachePtr = m_size;
+            m_cacheAborted = true;
+        });
         m_cacheBarrier.get_future().wait();
     }
-    free(m_cache);
+    if (m_sharedCache) {
+        m_sharedCache.reset();
+    } else {
+        free(m_cache);
+    }
     m_cache = nullptr;
+    m_blocks.reset();
     m_download = false;
     m_cacheProgress.store(0.0f);
     if (m_handle < 0) return;
     request([handle = m_handle, pendingCloseInfo = m_pendingCloseInfo](auto loop) {
-        if (pendingCloseInfo->pendingWrites != 0) {
+        if (pendingCloseInfo->pendingOps != 0) {
             pendingCloseInfo->closePending = true;
             return;
         }
@@ -243,6 +266,7 @@ void PCSX::UvFile::openwrapper(const char *filename, int flags) {
     struct Info {
         std::promise<uv_file> handle;
         std::promise<size_t> size;
+        uint64_t mtime = 0;
         uv_fs_t req;
     };
     Info info;
@@ -261,6 +285,7 @@ void PCSX::UvFile::openwrapper(const char *filename, int flags) {
             int ret = uv_fs_fstat(loop, req, handle, [](uv_fs_t *req) {
                 auto info = reinterpret_cast<Info *>(req->data);
                 auto size = req->statbuf.st_size;
+                info->mtime = req->statbuf.st_mtim.tv_sec * 1'000'000'000ULL + req->statbuf.st_mtim.tv_nsec;
                 uv_fs_req_cleanup(req);
                 info->size.set_value(size);
             });
@@ -279,6 +304,7 @@ void PCSX::UvFile::openwrapper(const char *filename, int flags) {
     }
     m_handle = handle;
     m_size = size;
+    m_mtime = info.mtime;
     if (handle >= 0) {
         m_failed = false;
         m_pendingCloseInfo = new PendingCloseInfo();
@@ -319,6 +345,92 @@ PCSX::UvFile::UvFile(const std::string_view &url, std::function<void()> &&callba
     });
 }
 
+// A transfer of a single range of a URL, or of only its headers, which the calling thread waits on.
+struct PCSX::UvFile::RangeRequest final : public UvThreadOp {
+    RangeRequest(const std::string &url, uint64_t offset, uint8_t *data, size_t size)
+        : m_url(url), m_offset(offset), m_data(data), m_size(size) {}
+    // Returns how many bytes of the range came back, or -1 on failure.
+    ssize_t perform(bool headersOnly) {
+        request([this, headersOnly](auto loop) {
+            m_curlHandle = curl_easy_init();
+            curl_easy_setopt(m_curlHandle, CURLOPT_URL, m_url.c_str());
+            curl_easy_setopt(m_curlHandle, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(m_curlHandle, CURLOPT_FAILONERROR, 1L);
+            curl_easy_setopt(m_curlHandle, CURLOPT_PRIVATE, static_cast<UvThreadOp *>(this));
+            if (headersOnly) {
+                curl_easy_setopt(m_curlHandle, CURLOPT_NOBODY, 1L);
+            } else {
+                m_range = std::to_string(m_offset) + "-" + std::to_string(m_offset + m_size - 1);
+                curl_easy_setopt(m_curlHandle, CURLOPT_RANGE, m_range.c_str());
+                curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, this);
+                curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, writeTrampoline);
+            }
+            curl_multi_add_handle(s_curlMulti, m_curlHandle);
+        });
+        return m_result.get_future().get();
+    }
+    curl_off_t contentLength() const { return m_contentLength; }
+
+  private:
+    virtual bool canCache() const override { return false; }
+    virtual void downloadDone(CURLMsg *message) override {
+        auto result = message->data.result;
+        // Stopping the transfer ourselves once the range is complete shows up as a write error.
+        bool success = (result == CURLE_OK) || ((result == CURLE_WRITE_ERROR) && (m_received == m_size));
+        curl_easy_getinfo(m_curlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &m_contentLength);
+        curl_multi_remove_handle(s_curlMulti, m_curlHandle);
+        curl_easy_cleanup(m_curlHandle);
+        m_curlHandle = nullptr;
+        m_result.set_value(success ? ssize_t(m_received) : -1);
+    }
+    static size_t writeTrampoline(char *ptr, size_t size, size_t nmemb, void *userdata) {
+        RangeRequest *self = reinterpret_cast<RangeRequest *>(userdata);
+        return self->write(ptr, size * nmemb);
+    }
+    size_t write(const char *ptr, size_t size) {
+        s_dataDownloadTotal += size;
+        if (!m_gotStatus) {
+            long code = 0;
+            curl_easy_getinfo(m_curlHandle, CURLINFO_RESPONSE_CODE, &code);
+            // A server which doesn't do ranges sends the whole file instead, which we need to skip through.
+            m_position = code == 206 ? m_offset : 0;
+            m_gotStatus = true;
+        }
+        uint64_t end = m_offset + m_size;
+        uint64_t from = std::max(m_position, m_offset);
+        uint64_t to = std::min(m_position + size, end);
+        if (to > from) {
+            memcpy(m_data + (from - m_offset), ptr + (from - m_position), to - from);
+            m_received += to - from;
+        }
+        m_position += size;
+        return m_position > end ? 0 : size;
+    }
+
+    const std::string m_url;
+    std::string m_range;
+    const uint64_t m_offset;
+    uint8_t *m_data;
+    const size_t m_size;
+    CURL *m_curlHandle = nullptr;
+    bool m_gotStatus = false;
+    uint64_t m_position = 0;
+    size_t m_received = 0;
+    curl_off_t m_contentLength = -1;
+    std::promise<ssize_t> m_result;
+};
+
+PCSX::UvFile::UvFile(const std::string_view &url, StreamUrl, size_t memoryCap,
+                     const std::filesystem::path &spillDirectory)
+    : File(RO_SEEKABLE), m_stream(true), m_filename(url) {
+    s_allOps.push_back(this);
+    RangeRequest head(std::string(url), 0, nullptr, 0);
+    if ((head.perform(true) < 0) || (head.contentLength() < 0)) return;
+    m_size = head.contentLength();
+    m_failed = false;
+    startBlockCaching(memoryCap, spillDirectory);
+}
+
 size_t PCSX::UvFile::curlWriteFunctionTrampoline(char *ptr, size_t size, size_t nmemb, void *userdata) {
     UvFile *file = reinterpret_cast<UvFile *>(userdata);
     return file->curlWriteFunction(ptr, size * nmemb);
@@ -428,6 +540,12 @@ ssize_t PCSX::UvFile::read(void *dest, size_t size) {
     size = std::min(m_size - m_ptrR, size);
     if (size == 0) return -1;
 
+    if (m_blocks) {
+        auto ret = m_blocks->read(dest, size, m_ptrR);
+        if (ret > 0) m_ptrR += ret;
+        return ret;
+    }
+
     float progress = m_cacheProgress.load(std::memory_order_relaxed);
 
     if (progress != 1.0f) {
@@ -448,17 +566,27 @@ ssize_t PCSX::UvFile::read(void *dest, size_t size) {
         m_ptrR += size;
         return size;
     }
+    auto ret = readDirect(dest, size, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::UvFile::readDirect(void *dest, size_t size, size_t ptr) {
+    uv_buf_t buf;
+    buf.base = reinterpret_cast<decltype(buf.base)>(dest);
+    buf.len = size;
+    return readDirect(&buf, 1, ptr);
+}
+
+ssize_t PCSX::UvFile::readDirect(const uv_buf_t *bufs, unsigned count, size_t ptr) {
     struct Info {
         std::promise<ssize_t> res;
-        uv_buf_t buf;
         uv_fs_t req;
     };
     Info info;
     info.req.data = &info;
-    info.buf.base = reinterpret_cast<decltype(info.buf.base)>(dest);
-    info.buf.len = size;
-    request([&info, handle = m_handle, offset = m_ptrR](auto loop) {
-        int ret = uv_fs_read(loop, &info.req, handle, &info.buf, 1, offset, [](uv_fs_t *req) {
+    request([&info, bufs, count, handle = m_handle, offset = ptr](auto loop) {
+        int ret = uv_fs_read(loop, &info.req, handle, bufs, count, offset, [](uv_fs_t *req) {
             auto info = reinterpret_cast<Info *>(req->data);
             ssize_t ret = req->result;
             uv_fs_req_cleanup(req);
@@ -469,13 +597,79 @@ ssize_t PCSX::UvFile::read(void *dest, size_t size) {
             info.res.set_exception(std::make_exception_ptr(std::runtime_error("uv_fs_read failed")));
         }
     });
-    size = -1;
+    ssize_t ret = -1;
     try {
-        size = info.res.get_future().get();
+        ret = info.res.get_future().get();
     } catch (...) {
     }
-    if (size > 0) m_ptrR += size;
-    return size;
+    return ret;
+}
+
+// Whether reads are served by the block cache or the full cache, in which case the
+// generic vectored and asynchronous reads, going through readAt, are as good as it gets.
+bool PCSX::UvFile::readsFromMemory() {
+    if (m_blocks || m_download) return true;
+    return m_cacheProgress.load(std::memory_order_acquire) == 1.0f;
+}
+
+ssize_t PCSX::UvFile::readv(const IOVec *vecs, size_t count) {
+    ssize_t ret = readAtv(vecs, count, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+ssize_t PCSX::UvFile::readAtv(const IOVec *vecs, size_t count, size_t ptr) {
+    if (readsFromMemory()) return File::readAtv(vecs, count, ptr);
+    std::vector<uv_buf_t> bufs(count);
+    for (size_t i = 0; i < count; i++) {
+        bufs[i].base = reinterpret_cast<decltype(bufs[i].base)>(vecs[i].data);
+        bufs[i].len = vecs[i].size;
+    }
+    return readDirect(bufs.data(), unsigned(bufs.size()), ptr);
+}
+
+void PCSX::UvFile::readAtAsync(Slice &&buffer, size_t ptr, ReadCallback &&callback) {
+    if (readsFromMemory() || (m_handle < 0)) {
+        File::readAtAsync(std::move(buffer), ptr, std::move(callback));
+        return;
+    }
+    struct Info {
+        Slice slice;
+        ReadCallback callback;
+        uv_file handle;
+        PendingCloseInfo *pendingCloseInfo;
+        uv_buf_t buf;
+        uv_fs_t req;
+    };
+    auto info = new Info();
+    info->req.data = info;
+    info->slice = std::move(buffer);
+    info->callback = std::move(callback);
+    info->handle = m_handle;
+    info->pendingCloseInfo = m_pendingCloseInfo;
+    info->buf.base = info->slice.mutableData<char>();
+    info->buf.len = info->slice.size();
+    request([info, offset = ptr](auto loop) {
+        info->pendingCloseInfo->pendingOps++;
+        int ret = uv_fs_read(loop, &info->req, info->handle, &info->buf, 1, offset, [](uv_fs_t *req) {
+            auto info = reinterpret_cast<Info *>(req->data);
+            ssize_t ret = req->result;
+            uv_fs_req_cleanup(req);
+            if (ret >= 0) s_dataReadTotal += ret;
+            info->slice.resize(ret > 0 ? ret : 0);
+            info->callback(std::move(info->slice));
+            if ((--info->pendingCloseInfo->pendingOps == 0) && info->pendingCloseInfo->closePending) {
+                closeUVHandle(info->handle, req->loop, info->pendingCloseInfo);
+            }
+            delete info;
+        });
+        if (ret != 0) {
+            info->pendingCloseInfo->pendingOps--;
+            info->slice.resize(0);
+            info->callback(std::move(info->slice));
+            delete info;
+        }
+    });
 }
 
 ssize_t PCSX::UvFile::write(const void *src, size_t size) {
@@ -491,6 +685,7 @@ ssize_t PCSX::UvFile::write(const void *src, size_t size) {
 
         memcpy(m_cache + m_ptrW, src, size);
     }
+    if (m_blocks) m_blocks->write(src, size, m_ptrW);
     struct Info {
         uv_buf_t buf;
         uv_fs_t req;
@@ -506,13 +701,13 @@ ssize_t PCSX::UvFile::write(const void *src, size_t size) {
     info->handle = m_handle;
     info->pendingCloseInfo = m_pendingCloseInfo;
     request([info, offset = m_ptrW](auto loop) {
-        info->pendingCloseInfo->pendingWrites++;
+        info->pendingCloseInfo->pendingOps++;
         uv_fs_write(loop, &info->req, info->handle, &info->buf, 1, offset, [](uv_fs_t *req) {
             ssize_t ret = req->result;
             if (ret >= 0) s_dataWrittenTotal += ret;
             auto info = reinterpret_cast<Info *>(req->data);
             uv_fs_req_cleanup(req);
-            if ((--info->pendingCloseInfo->pendingWrites == 0) && info->pendingCloseInfo->closePending) {
+            if ((--info->pendingCloseInfo->pendingOps == 0) && info->pendingCloseInfo->closePending) {
                 closeUVHandle(info->handle, req->loop, info->pendingCloseInfo);
             }
             delete info;
@@ -538,6 +733,7 @@ void PCSX::UvFile::write(Slice &&slice) {
 
         memcpy(m_cache + m_ptrW, slice.data(), slice.size());
     }
+    if (m_blocks) m_blocks->write(slice.data(), slice.size(), m_ptrW);
     struct Info {
         uv_buf_t buf;
         uv_fs_t req;
@@ -554,13 +750,13 @@ void PCSX::UvFile::write(Slice &&slice) {
     info->pendingCloseInfo = m_pendingCloseInfo;
     request([info, offset = m_ptrW](auto loop) {
         info->buf.base = reinterpret_cast<decltype(info->buf.base)>(const_cast<void *>(info->slice.data()));
-        info->pendingCloseInfo->pendingWrites++;
+        info->pendingCloseInfo->pendingOps++;
         uv_fs_write(loop, &info->req, info->handle, &info->buf, 1, offset, [](uv_fs_t *req) {
             ssize_t ret = req->result;
             if (ret >= 0) s_dataWrittenTotal += ret;
             auto info = reinterpret_cast<Info *>(req->data);
             uv_fs_req_cleanup(req);
-            if ((--info->pendingCloseInfo->pendingWrites == 0) && info->pendingCloseInfo->closePending) {
+            if ((--info->pendingCloseInfo->pendingOps == 0) && info->pendingCloseInfo->closePending) {
                 closeUVHandle(info->handle, req->loop, info->pendingCloseInfo);
             }
             delete info;
@@ -576,6 +772,7 @@ ssize_t PCSX::UvFile::readAt(void *dest, size_t size, size_t ptr) {
     if (ptr >= m_size) return -1;
     size = std::min(m_size - ptr, size);
     if (size == 0) return -1;
+    if (m_blocks) return m_blocks->read(dest, size, ptr);
     float progress = m_cacheProgress.load(std::memory_order_acquire);
 
     if (progress != 1.0f) {
@@ -595,33 +792,7 @@ ssize_t PCSX::UvFile::readAt(void *dest, size_t size, size_t ptr) {
         memcpy(dest, m_cache + ptr, size);
         return size;
     }
-    struct Info {
-        std::promise<ssize_t> res;
-        uv_buf_t buf;
-        uv_fs_t req;
-    };
-    Info info;
-    info.req.data = &info;
-    info.buf.base = reinterpret_cast<decltype(info.buf.base)>(dest);
-    info.buf.len = size;
-    request([&info, handle = m_handle, offset = ptr](auto loop) {
-        int ret = uv_fs_read(loop, &info.req, handle, &info.buf, 1, offset, [](uv_fs_t *req) {
-            auto info = reinterpret_cast<Info *>(req->data);
-            ssize_t ret = req->result;
-            uv_fs_req_cleanup(req);
-            info->res.set_value(ret);
-            if (ret >= 0) s_dataReadTotal += ret;
-        });
-        if (ret != 0) {
-            info.res.set_exception(std::make_exception_ptr(std::runtime_error("uv_fs_read failed")));
-        }
-    });
-    size = -1;
-    try {
-        size = info.res.get_future().get();
-    } catch (...) {
-    }
-    return size;
+    return readDirect(dest, size, ptr);
 }
 
 ssize_t PCSX::UvFile::writeAt(const void *src, size_t size, size_t ptr) {
@@ -637,6 +808,7 @@ ssize_t PCSX::UvFile::writeAt(const void *src, size_t size, size_t ptr) {
 
         memcpy(m_cache + ptr, src, size);
     }
+    if (m_blocks) m_blocks->write(src, size, ptr);
     struct Info {
         uv_buf_t buf;
         uv_fs_t req;
@@ -652,13 +824,13 @@ ssize_t PCSX::UvFile::writeAt(const void *src, size_t size, size_t ptr) {
     info->handle = m_handle;
     info->pendingCloseInfo = m_pendingCloseInfo;
     request([info, offset = ptr](auto loop) {
-        info->pendingCloseInfo->pendingWrites++;
+        info->pendingCloseInfo->pendingOps++;
         uv_fs_write(loop, &info->req, info->handle, &info->buf, 1, offset, [](uv_fs_t *req) {
             ssize_t ret = req->result;
             if (ret >= 0) s_dataWrittenTotal += ret;
             auto info = reinterpret_cast<Info *>(req->data);
             uv_fs_req_cleanup(req);
-            if ((--info->pendingCloseInfo->pendingWrites == 0) && info->pendingCloseInfo->closePending) {
+            if ((--info->pendingCloseInfo->pendingOps == 0) && info->pendingCloseInfo->closePending) {
                 closeUVHandle(info->handle, req->loop, info->pendingCloseInfo);
             }
             delete info;
@@ -680,6 +852,7 @@ void PCSX::UvFile::writeAt(Slice &&slice, size_t ptr) {
 
         memcpy(m_cache + ptr, slice.data(), slice.size());
     }
+    if (m_blocks) m_blocks->write(slice.data(), slice.size(), ptr);
     struct Info {
         uv_buf_t buf;
         uv_fs_t req;
@@ -696,13 +869,13 @@ void PCSX::UvFile::writeAt(Slice &&slice, size_t ptr) {
     info->pendingCloseInfo = m_pendingCloseInfo;
     request([info, offset = ptr](auto loop) {
         info->buf.base = reinterpret_cast<decltype(info->buf.base)>(const_cast<void *>(info->slice.data()));
-        info->pendingCloseInfo->pendingWrites++;
+        info->pendingCloseInfo->pendingOps++;
         uv_fs_write(loop, &info->req, info->handle, &info->buf, 1, offset, [](uv_fs_t *req) {
             ssize_t ret = req->result;
             if (ret >= 0) s_dataWrittenTotal += ret;
             auto info = reinterpret_cast<Info *>(req->data);
             uv_fs_req_cleanup(req);
-            if ((--info->pendingCloseInfo->pendingWrites == 0) && info->pendingCloseInfo->closePending) {
+            if ((--info->pendingCloseInfo->pendingOps == 0) && info->pendingCloseInfo->closePending) {
                 closeUVHandle(info->handle, req->loop, info->pendingCloseInfo);
             }
             delete info;
@@ -714,6 +887,7 @@ bool PCSX::UvFile::eof() { return m_size == m_ptrR; }
 
 void PCSX::UvFile::readCacheChunk(uv_loop_t *loop) {
     if (m_cachePtr >= m_size) {
+        if (m_sharedCache && !m_cacheAborted) m_sharedCache->publish();
         m_cacheProgress.store(1.0f, std::memory_order_release);
         if (m_cachingDoneCB) {
             uv_async_send(m_cbAsync);
@@ -751,13 +925,44 @@ void PCSX::UvFile::readCacheChunkResult() {
 }
 
 void PCSX::UvFile::startCaching(std::function<void()> &&completed, uv_loop_t *loop) {
-    if (m_cache || m_download) throw std::runtime_error("File is already cached");
+    if (m_cache || m_download || m_blocks) throw std::runtime_error("File is already cached");
     cacheCallbackSetup(std::move(completed), loop);
     if (failed()) return;
-    m_cache = reinterpret_cast<uint8_t *>(malloc(m_size));
+    m_cacheAborted = false;
+    if (!writable() && (m_size != 0) && s_shareCaches.load(std::memory_order_relaxed)) {
+        // Files are told apart by what they are on the disk, as hashing their contents would mean reading them.
+        std::error_code ec;
+        auto path = std::filesystem::absolute(m_filename, ec);
+        auto key = fmt::format("file-{}-{}-{}", (ec ? m_filename : path).string(), m_size, m_mtime);
+        m_sharedCache.reset(new SharedMem());
+        // Already there, so the read below completes right away.
+        if (m_sharedCache->initPublished(key, m_size)) m_cachePtr = m_size;
+        m_cache = m_sharedCache->getPtr();
+    } else {
+        m_cache = reinterpret_cast<uint8_t *>(malloc(m_size));
+    }
     request([this](auto loop) { readCacheChunk(loop); });
 }
 
+void PCSX::UvFile::startBlockCaching(size_t memoryCap, const std::filesystem::path &spillDirectory) {
+    if (m_cache || m_download || m_blocks) throw std::runtime_error("File is already cached");
+    if (failed()) return;
+    m_blockCacheCap = memoryCap;
+    m_spillDirectory = spillDirectory;
+    LRUBlockCache::Fetcher fetcher;
+    if (m_stream) {
+        fetcher = [url = m_filename.string()](uint64_t offset, uint8_t *data, size_t size) -> ssize_t {
+            RangeRequest range(url, offset, data, size);
+            return range.perform(false);
+        };
+    } else {
+        fetcher = [this](uint64_t offset, uint8_t *data, size_t size) -> ssize_t {
+            return readDirect(data, size, offset);
+        };
+    }
+    m_blocks.reset(new LRUBlockCache(m_size, memoryCap, spillDirectory, std::move(fetcher)));
+}
+
 void PCSX::UvFile::cacheCallbackSetup(std::function<void()> &&callbackDone, uv_loop_t *otherLoop) {
     if (otherLoop && callbackDone) {
         m_cachingDoneCB = std::move(callbackDone);
@@ -889,16 +1094,20 @@ ssize_t PCSX::UvFifo::write(const void *src, size_t size) {
         uv_buf_t buf;
         uv_write_t req;
         Slice slice;
+        std::shared_ptr<std::atomic<size_t>> pending;
     };
     auto info = new Info();
     info->req.data = info;
     info->slice.copy(src, size);
     info->buf.base = reinterpret_cast<decltype(info->buf.base)>(const_cast<void *>(info->slice.data()));
     info->buf.len = size;
+    info->pending = m_pendingWrites;
+    info->pending->fetch_add(size);
     request([info, tcp = m_tcp](auto loop) {
         info->buf.base = reinterpret_cast<decltype(info->buf.base)>(const_cast<void *>(info->slice.data()));
         uv_write(&info->req, reinterpret_cast<uv_stream_t *>(tcp), &info->buf, 1, [](uv_write_t *req, int status) {
             auto info = reinterpret_cast<Info *>(req->data);
+            info->pending->fetch_sub(info->buf.len);
             delete info;
         });
     });
@@ -910,21 +1119,52 @@ void PCSX::UvFifo::write(Slice &&slice) {
         uv_buf_t buf;
         uv_write_t req;
         Slice slice;
+        std::shared_ptr<std::atomic<size_t>> pending;
     };
     auto size = slice.size();
     auto info = new Info();
     info->req.data = info;
     info->buf.len = size;
     info->slice = std::move(slice);
+    info->pending = m_pendingWrites;
+    info->pending->fetch_add(size);
     request([info, tcp = m_tcp](auto loop) {
         info->buf.base = reinterpret_cast<decltype(info->buf.base)>(const_cast<void *>(info->slice.data()));
         uv_write(&info->req, reinterpret_cast<uv_stream_t *>(tcp), &info->buf, 1, [](uv_write_t *req, int status) {
             auto info = reinterpret_cast<Info *>(req->data);
+            info->pending->fetch_sub(info->buf.len);
             delete info;
         });
     });
 }
 
+void PCSX::UvFifo::write(SliceChain &&chain) {
+    struct Info {
+        std::vector<uv_buf_t> bufs;
+        uv_write_t req;
+        SliceChain chain;
+        std::shared_ptr<std::atomic<size_t>> pending;
+    };
+    if (chain.count() == 0) return;
+    auto info = new Info();
+    info->req.data = info;
+    info->chain = std::move(chain);
+    info->pending = m_pendingWrites;
+    info->pending->fetch_add(info->chain.size());
+    request([info, tcp = m_tcp](auto loop) {
+        info->bufs.reserve(info->chain.count());
+        for (auto &slice : info->chain) {
+            info->bufs.push_back(uv_buf_init(const_cast<char *>(slice.data<char>()), slice.size()));
+        }
+        uv_write(&info->req, reinterpret_cast<uv_stream_t *>(tcp), info->bufs.data(), info->bufs.size(),
+                 [](uv_write_t *req, int status) {
+                     auto info = reinterpret_cast<Info *>(req->data);
+                     info->pending->fetch_sub(info->chain.size());
+                     delete info;
+                 });
+    });
+}
+
 void PCSX::UvFifoListener::start(unsigned port, uv_loop_t *loop, uv_async_t *async,
                                  std::function<void(UvFifo *)> &&cb) {
     m_cb = std::move(cb);
@@ -944,12 +1184,12 @@ void PCSX::UvFifoListener::start(unsigned port, uv_loop_t *loop, uv_async_t *asy
         struct sockaddr_in bindAddr;
         int result = uv_ip4_addr("0.0.0.0", port, &bindAddr);
         if (result != 0) {
-            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), [](uv_handle_t *handle) {});
+            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), closeCB);
             return;
         }
         result = uv_tcp_bind(&m_server, reinterpret_cast<const sockaddr *>(&bindAddr), 0);
         if (result != 0) {
-            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), [](uv_handle_t *handle) {});
+            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), closeCB);
             return;
         }
         result = uv_listen((uv_stream_t *)&m_server, 16, [](uv_stream_t *server, int status) {
@@ -968,18 +1208,19 @@ void PCSX::UvFifoListener::start(unsigned port, uv_loop_t *loop, uv_async_t *asy
             }
         });
         if (result != 0) {
-            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), [](uv_handle_t *handle) {});
+            uv_close(reinterpret_cast<uv_handle_t *>(&m_server), closeCB);
             return;
         }
     });
 }
 
 void PCSX::UvFifoListener::stop() {
-    request([this](auto loop) {
-        uv_close(reinterpret_cast<uv_handle_t *>(&m_server), [](uv_handle_t *handle) {
-            UvFifoListener *listener = reinterpret_cast<UvFifoListener *>(handle->data);
-            listener->m_pending.Enqueue(nullptr);
-            uv_async_send(listener->m_async);
-        });
-    });
+    request([this](auto loop) { uv_close(reinterpret_cast<uv_handle_t *>(&m_server), closeCB); });
+}
+
+// Failing to listen ends up the same way as stopping, so the owner gets to know it isn't listening anymore.
+void PCSX::UvFifoListener::closeCB(uv_handle_t *handle) {
+    UvFifoListener *listener = reinterpret_cast<UvFifoListener *>(handle->data);
+    listener->m_pending.Enqueue(nullptr);
+    uv_async_send(listener->m_async);
 }
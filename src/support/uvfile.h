@@ -31,12 +31,16 @@ SOFTWARE.
 #include <atomic>
 #include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
 #include "cq/concurrent_queue.h"
 #include "support/file.h"
 #include "support/list.h"
+#include "support/lrublockcache.h"
+#include "support/sharedmem.h"
 
 namespace PCSX {
 
@@ -46,18 +50,28 @@ typedef Intrusive::List<UvThreadOp> UvThreadOpListType;
 class UvThreadOp : public UvThreadOpListType::Node {
   public:
     enum DownloadUrl { DOWNLOAD_URL };
+    enum StreamUrl { STREAM_URL };
+    // There's only the one thread for all of the emulators running in the process: the first UvThread starts it,
+    // and the last one stops it.
     struct UvThread {
         void setEmergencyExit() { m_emergencyExit = true; }
-        UvThread() { PCSX::UvThreadOp::startThread(); }
+        UvThread() { PCSX::UvThreadOp::acquireThread(); }
         ~UvThread() {
-            if (!m_emergencyExit) PCSX::UvThreadOp::stopThread();
+            if (!m_emergencyExit) PCSX::UvThreadOp::releaseThread();
         }
 
       private:
         bool m_emergencyExit = false;
     };
 
+    // The thread doesn't survive a fork: it gets stopped before, and started again after, in both processes.
+    // Whatever is still in flight, such as a file being cached or downloaded, gets to finish first.
+    static void prepareFork() { stopThread(); }
+    static void afterFork() { startThread(); }
+
   private:
+    static void acquireThread();
+    static void releaseThread();
     static void startThread();
     static void stopThread();
 
@@ -113,6 +127,8 @@ class UvThreadOp : public UvThreadOpListType::Node {
 
     // This isn't really safe, but it's not meant to.
     static bool s_threadRunning;
+    static std::mutex s_threadUsersMutex;
+    static unsigned s_threadUsers;
     static std::thread s_uvThread;
     static uv_async_t s_kicker;
     static uv_timer_t s_timer;
@@ -148,11 +164,17 @@ class UvFile : public File, public UvThreadOp {
     virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
     virtual ssize_t writeAt(const void* src, size_t size, size_t ptr) final override;
     virtual void writeAt(Slice&& slice, size_t ptr) final override;
+    virtual ssize_t readv(const IOVec* vecs, size_t count) final override;
+    virtual ssize_t readAtv(const IOVec* vecs, size_t count, size_t ptr) final override;
+    // While the file is still being read from the disk, the read is queued on the uv thread, and the
+    // callback is called from there once it's done.
+    virtual void readAtAsync(Slice&& buffer, size_t ptr, ReadCallback&& callback) final override;
     virtual bool failed() final override { return m_failed; }
     virtual bool eof() final override;
     virtual std::filesystem::path filename() final override { return m_filename; }
     virtual File* dup() final override {
         return m_download   ? new UvFile(m_filename.string(), DOWNLOAD_URL)
+               : m_stream   ? new UvFile(m_filename.string(), STREAM_URL, m_blockCacheCap, m_spillDirectory)
                : writable() ? new UvFile(m_filename, FileOps::READWRITE)
                             : new UvFile(m_filename);
     }
@@ -169,6 +191,10 @@ class UvFile : public File, public UvThreadOp {
     // Download a URL
     UvFile(const std::string_view& url, DownloadUrl) : UvFile(url, nullptr, nullptr, DOWNLOAD_URL) {}
     UvFile(const std::string_view& url, std::function<void()>&& completed, uv_loop_t* other, DownloadUrl);
+    // Stream a URL, fetching the blocks being read with range requests, and block caching them.
+    // See startBlockCaching for the meaning of the other arguments.
+    UvFile(const std::string_view& url, StreamUrl, size_t memoryCap = c_defaultBlockCacheCap,
+           const std::filesystem::path& spillDirectory = {});
 #if defined(__cpp_lib_char8_t)
     UvFile(const std::u8string& filename) : UvFile(reinterpret_cast<const char*>(filename.c_str())) {}
     UvFile(const std::u8string& filename, FileOps::Truncate)
@@ -189,10 +215,24 @@ class UvFile : public File, public UvThreadOp {
 
     void startCaching() { startCaching(nullptr, nullptr); }
     virtual void startCaching(std::function<void()>&& completed, uv_loop_t* loop) override;
+    // Instead of reading the whole file in memory, keep the blocks which got read, up to memoryCap bytes of
+    // them. The least recently used blocks get dropped past that, or moved into a temporary file in the
+    // spill directory if there's one, so that they're still a lot faster to get back than the original.
+    static constexpr size_t c_defaultBlockCacheCap = 64 * 1024 * 1024;
+    void startBlockCaching(size_t memoryCap = c_defaultBlockCacheCap,
+                           const std::filesystem::path& spillDirectory = {});
+    bool blockCaching() const { return !!m_blocks; }
+    // Whole-file caches can weigh hundreds of megabytes, which would then stay around for as long as another
+    // process uses them, so sharing them is opt-in.
+    static void shareCaches(bool share) { s_shareCaches.store(share, std::memory_order_relaxed); }
 
   private:
+    struct RangeRequest;
     virtual void closeInternal() final override;
-    virtual bool canCache() const override { return true; }
+    virtual bool canCache() const override { return !m_blocks; }
+    ssize_t readDirect(void* dest, size_t size, size_t ptr);
+    ssize_t readDirect(const uv_buf_t* bufs, unsigned count, size_t ptr);
+    bool readsFromMemory();
     void openwrapper(const char* filename, int flags);
     void readCacheChunk(uv_loop_t* loop);
     void readCacheChunkResult();
@@ -207,6 +247,7 @@ class UvFile : public File, public UvThreadOp {
 
     bool m_failed = true;
     bool m_download = false;
+    bool m_stream = false;
     std::atomic<bool> m_cancelDownload = false;
     std::function<void()> m_cachingDoneCB = nullptr;
     uv_async_t* m_cbAsync = nullptr;
@@ -219,8 +260,18 @@ class UvFile : public File, public UvThreadOp {
     uv_buf_t m_cacheBuf;
     uv_fs_t m_cacheReq;
     size_t m_cachePtr = 0;
+    // When shareCaches is on, read only files get cached in memory shared by all of the processes of the host
+    // caching the same file, which then only gets read from the disk once.
+    std::unique_ptr<SharedMem> m_sharedCache;
+    static inline std::atomic<bool> s_shareCaches = false;
+    bool m_cacheAborted = false;
+    uint64_t m_mtime = 0;
+    std::unique_ptr<LRUBlockCache> m_blocks;
+    size_t m_blockCacheCap = c_defaultBlockCacheCap;
+    std::filesystem::path m_spillDirectory;
+    // Closing the handle waits for the asynchronous writes and reads still in flight.
     struct PendingCloseInfo {
-        unsigned pendingWrites = 0;
+        unsigned pendingOps = 0;
         bool closePending = false;
     };
     static void closeUVHandle(uv_file handle, uv_loop_s* loop, PendingCloseInfo* pendingCloseInfo);
@@ -238,6 +289,10 @@ class UvFifo : public File, public UvThreadOp {
     virtual bool eof() final override { return m_closed.load() && (m_size.load() == 0); }
     virtual bool failed() final override { return m_failed.test(); }
     bool isConnecting() { return m_connecting.test(); }
+    // Writes all of the slices at once, straight from where they are, in a single vectored write.
+    void write(SliceChain&& chain);
+    // How many bytes were written which didn't make it onto the socket yet.
+    size_t pendingWrites() const { return m_pendingWrites->load(); }
 
   private:
     virtual void closeInternal() final override;
@@ -250,6 +305,8 @@ class UvFifo : public File, public UvThreadOp {
     const size_t c_chunkSize = 4096;
     ConcurrentQueue<Slice> m_queue;
     std::atomic<size_t> m_size = 0;
+    // The writes can complete after the fifo is gone, so what they count down has to outlive it.
+    std::shared_ptr<std::atomic<size_t>> m_pendingWrites = std::make_shared<std::atomic<size_t>>(0);
     std::atomic_flag m_failed;
     std::atomic_flag m_connecting;
     Slice m_slice;
@@ -265,6 +322,7 @@ class UvFifoListener : public UvThreadOp {
 
   private:
     virtual bool canCache() const override { return false; }
+    static void closeCB(uv_handle_t* handle);
     uv_async_t* m_async = nullptr;
     uv_tcp_t m_server = {};
     std::function<void(UvFifo*)> m_cb;
@@ -26,6 +26,10 @@ SOFTWARE.
 
 #include "support/zfile.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 ssize_t PCSX::ZReader::rSeek(ssize_t pos, int wheel) {
     switch (wheel) {
         case SEEK_SET:
@@ -98,6 +102,128 @@ ssize_t PCSX::ZReader::read(void *dest_, size_t size) {
     return ret;
 }
 
+PCSX::ZIndexedReader::ZIndexedReader(IO<File> file, size_t size, size_t span)
+    : File(RO_SEEKABLE), m_file(file), m_size(size), m_span(span) {
+    auto z = &m_zstream;
+    z->zalloc = Z_NULL;
+    z->zfree = Z_NULL;
+    z->opaque = Z_NULL;
+    z->avail_in = 0;
+    z->next_in = Z_NULL;
+    auto res = inflateInit2(z, -MAX_WBITS);
+    if (res != Z_OK) throw std::runtime_error("inflateInit2 didn't work");
+    // The start of the stream is the first restart point, with no window.
+    m_points.push_back({0, 0, 0, {}});
+}
+
+ssize_t PCSX::ZIndexedReader::rSeek(ssize_t pos, int wheel) {
+    switch (wheel) {
+        case SEEK_SET:
+            m_ptrR = pos;
+            break;
+        case SEEK_END:
+            m_ptrR = m_size + pos;
+            break;
+        case SEEK_CUR:
+            m_ptrR += pos;
+            break;
+    }
+    m_ptrR = std::min(m_ptrR, m_size);
+    return m_ptrR;
+}
+
+ssize_t PCSX::ZIndexedReader::read(void *dest, size_t size) {
+    ssize_t ret = readAt(dest, size, m_ptrR);
+    if (ret > 0) m_ptrR += ret;
+    return ret;
+}
+
+bool PCSX::ZIndexedReader::restart(const Point &point) {
+    if (inflateReset(&m_zstream) != Z_OK) return false;
+    m_in = point.in;
+    m_out = point.out;
+    m_streamEnd = false;
+    m_zstream.avail_in = 0;
+    // The restart point can be in the middle of a byte, in which case its remaining bits get fed first.
+    if (point.bits) {
+        uint8_t byte;
+        if (m_file->readAt(&byte, 1, m_in - 1) != 1) return false;
+        if (inflatePrime(&m_zstream, point.bits, byte >> (8 - point.bits)) != Z_OK) return false;
+    }
+    if (!point.window.empty()) {
+        if (inflateSetDictionary(&m_zstream, point.window.data(), point.window.size()) != Z_OK) return false;
+        for (size_t i = 0; i < point.window.size(); i++) {
+            m_window[(m_out - point.window.size() + i) % c_windowSize] = point.window[i];
+        }
+    }
+    return true;
+}
+
+void PCSX::ZIndexedReader::maybeAddPoint() {
+    // At the end of a block which isn't the last one, and far enough from the previous point.
+    if (!(m_zstream.data_type & 128) || (m_zstream.data_type & 64)) return;
+    if ((m_out - m_points.back().out) < m_span) return;
+    Point point;
+    point.out = m_out;
+    point.in = m_in - m_zstream.avail_in;
+    point.bits = m_zstream.data_type & 7;
+    const size_t windowSize = std::min(m_out, c_windowSize);
+    point.window.resize(windowSize);
+    for (size_t i = 0; i < windowSize; i++) point.window[i] = m_window[(m_out - windowSize + i) % c_windowSize];
+    m_points.push_back(std::move(point));
+}
+
+ssize_t PCSX::ZIndexedReader::readAt(void *dest_, size_t size, size_t ptr) {
+    if (m_failed || (ptr >= m_size)) return -1;
+    uint8_t *dest = reinterpret_cast<uint8_t *>(dest_);
+    size = std::min(size, m_size - ptr);
+    const size_t end = ptr + size;
+
+    // Restart from the closest point before the requested data, unless the inflater is already between
+    // that point and the data.
+    auto point = std::upper_bound(m_points.begin(), m_points.end(), ptr,
+                                  [](size_t ptr, const Point &point) { return ptr < point.out; });
+    --point;
+    if ((m_out > ptr) || (point->out > m_out)) {
+        if (!restart(*point)) {
+            m_failed = true;
+            return -1;
+        }
+    }
+
+    while ((m_out < end) && !m_streamEnd) {
+        if (m_zstream.avail_in == 0) {
+            ssize_t block = m_file->readAt(m_inBuffer, sizeof(m_inBuffer), m_in);
+            if (block <= 0) break;
+            m_in += block;
+            m_zstream.avail_in = block;
+            m_zstream.next_in = m_inBuffer;
+        }
+        // Inflate straight into the circular window, up to its end at most, stopping at block boundaries.
+        const size_t offset = m_out % c_windowSize;
+        m_zstream.avail_out = c_windowSize - offset;
+        m_zstream.next_out = m_window + offset;
+        auto res = inflate(&m_zstream, Z_BLOCK);
+        // Not being able to make progress with input left means the stream is damaged.
+        if (((res != Z_OK) && (res != Z_STREAM_END) && (res != Z_BUF_ERROR)) ||
+            ((res == Z_BUF_ERROR) && m_zstream.avail_in)) {
+            m_failed = true;
+            return -1;
+        }
+        const size_t produced = c_windowSize - offset - m_zstream.avail_out;
+        // Copy whatever overlaps with what was asked for.
+        const size_t from = std::max(m_out, ptr);
+        const size_t to = std::min(m_out + produced, end);
+        if (from < to) memcpy(dest + (from - ptr), m_window + offset + (from - m_out), to - from);
+        m_out += produced;
+        if (res == Z_STREAM_END) m_streamEnd = true;
+        maybeAddPoint();
+    }
+
+    if (m_out <= ptr) return -1;
+    return std::min(m_out, end) - ptr;
+}
+
 ssize_t PCSX::ZWriter::write(const void *dest, size_t size) {
     m_zstream.avail_in = size;
     m_zstream.next_in = static_cast<Bytef *>(const_cast<void *>(dest));
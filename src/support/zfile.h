@@ -28,6 +28,8 @@ SOFTWARE.
 
 #include <zlib.h>
 
+#include <vector>
+
 #include "support/file.h"
 
 namespace PCSX {
@@ -78,6 +80,53 @@ class ZReader : public File {
     uint8_t m_inBuffer[1024];
 };
 
+// Random access reader for raw deflate streams, such as zip entries. ZReader can only go forward, and
+// restarts from the beginning of the stream when seeking backward. This one instead remembers restart
+// points as it goes, every span bytes of output or so, at deflate block boundaries, along with the bit
+// offset in the input and the 32KB window of output preceding them. Reading anywhere then only inflates
+// from the closest restart point before it, which is how zlib's zran example works.
+class ZIndexedReader : public File {
+  public:
+    static constexpr size_t c_defaultSpan = 1024 * 1024;
+    ZIndexedReader(IO<File> file, size_t size, size_t span = c_defaultSpan);
+    virtual ssize_t rSeek(ssize_t pos, int wheel) final override;
+    virtual ssize_t rTell() final override { return m_ptrR; }
+    virtual size_t size() final override { return m_size; }
+    virtual ssize_t read(void* dest, size_t size) final override;
+    virtual ssize_t readAt(void* dest, size_t size, size_t ptr) final override;
+    virtual bool eof() final override { return m_ptrR >= m_size; }
+    virtual File* dup() final override { return new ZIndexedReader(m_file, m_size, m_span); }
+    virtual bool failed() final override { return m_file->failed() || m_failed; }
+    size_t restartPoints() const { return m_points.size(); }
+
+  private:
+    static constexpr size_t c_windowSize = 32768;
+    struct Point {
+        size_t out;
+        size_t in;
+        int bits;
+        std::vector<uint8_t> window;
+    };
+    virtual void closeInternal() final override { inflateEnd(&m_zstream); }
+    bool restart(const Point& point);
+    void maybeAddPoint();
+
+    IO<File> m_file;
+    z_stream m_zstream;
+    const size_t m_size;
+    const size_t m_span;
+    size_t m_ptrR = 0;
+    // Where the inflater currently is, in the input and output, the latter being also where it
+    // writes next into the circular window.
+    size_t m_in = 0;
+    size_t m_out = 0;
+    bool m_streamEnd = false;
+    bool m_failed = false;
+    std::vector<Point> m_points;
+    uint8_t m_window[c_windowSize];
+    uint8_t m_inBuffer[16384];
+};
+
 class ZWriter : public File {
   public:
     enum Raw { RAW };
@@ -26,7 +26,14 @@ SOFTWARE.
 
 #include "support/zip.h"
 
+#include <zlib.h>
+
+#include <atomic>
+#include <mutex>
+
 #include "support/binstruct.h"
+#include "support/hashing.h"
+#include "support/parallel.h"
 #include "support/typestring-wrapper.h"
 #include "support/zfile.h"
 
@@ -78,6 +85,7 @@ PCSX::ZipArchive::ZipArchive(IO<File> file) : m_file(file) {
                 file->skip(header.get<CompressedSize>());
                 fileInfo.size = header.get<UncompressedSize>();
                 fileInfo.compressedSize = header.get<CompressedSize>();
+                fileInfo.crc = header.get<CRC32>();
                 if ((fileInfo.size == 0xffffffff) && (fileInfo.compressedSize == 0xffffffff)) {
                     m_failed = true;
                     return;
@@ -126,6 +134,109 @@ void PCSX::ZipArchive::listDirectories(std::function<bool(std::string_view)> wal
     }
 }
 
+PCSX::File* PCSX::ZipArchive::openFile(std::string path, RandomAccess) {
+    for (auto& c : path) {
+        if (c == '\\') c = '/';
+    }
+    for (auto& file : m_files) {
+        if (file.name != path) continue;
+        SubFile* sub = new SubFile(m_file, file.offset, file.compressedSize);
+        if (!file.compressed) return sub;
+        return new ZIndexedReader(sub, file.size);
+    }
+    return new FailedFile();
+}
+
+bool PCSX::ZipArchive::extractAll(std::function<void(std::string_view name, Slice&& data)> callback,
+                                  unsigned threads) {
+    std::vector<const CompressedFile*> files;
+    for (auto& file : m_files) {
+        if (!file.isDirectory()) files.push_back(&file);
+    }
+
+    std::atomic<bool> success = true;
+    std::mutex readLock;
+    parallelFor(files.size(), threads, [&](size_t index) {
+        auto file = files[index];
+        Slice compressed;
+        {
+            std::unique_lock<std::mutex> lock(readLock);
+            compressed = m_file->readAt(file->compressedSize, file->offset);
+        }
+        if (compressed.size() != file->compressedSize) {
+            success = false;
+            return;
+        }
+        Slice data;
+        if (file->compressed) {
+            data.resize(file->size);
+            z_stream zstream = {};
+            if (inflateInit2(&zstream, -MAX_WBITS) != Z_OK) {
+                success = false;
+                return;
+            }
+            zstream.next_in = const_cast<Bytef*>(compressed.data<Bytef>());
+            zstream.avail_in = compressed.size();
+            zstream.next_out = data.mutableData<Bytef>();
+            zstream.avail_out = data.size();
+            auto res = inflate(&zstream, Z_FINISH);
+            inflateEnd(&zstream);
+            if ((res != Z_STREAM_END) || (zstream.avail_out != 0)) {
+                success = false;
+                return;
+            }
+        } else {
+            data = std::move(compressed);
+        }
+        if (Hashing::crc32(0, data.data(), data.size()) != file->crc) {
+            success = false;
+            return;
+        }
+        callback(file->name, std::move(data));
+    });
+    return success;
+}
+
+bool PCSX::ZipArchive::extractAllTo(const std::filesystem::path& destination, unsigned threads) {
+    bool success = true;
+    // Only relative names which don't go up are allowed, so that nothing lands outside of the destination.
+    auto resolve = [&destination, &success](std::string_view name, std::filesystem::path& path) {
+        std::filesystem::path relative = std::filesystem::path(name).lexically_normal();
+        if (relative.empty() || relative.has_root_path() || (*relative.begin() == "..")) {
+            success = false;
+            return false;
+        }
+        path = destination / relative;
+        return true;
+    };
+    std::filesystem::path path;
+    for (auto& file : m_files) {
+        if (!file.isDirectory() || !resolve(file.name, path)) continue;
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+    }
+    std::mutex lock;
+    success &= extractAll(
+        [&](std::string_view name, Slice&& data) {
+            std::filesystem::path path;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                if (!resolve(name, path)) return;
+                std::error_code ec;
+                std::filesystem::create_directories(path.parent_path(), ec);
+            }
+            IO<File> out(new PosixFile(path, FileOps::TRUNCATE));
+            if (out->failed()) {
+                std::unique_lock<std::mutex> guard(lock);
+                success = false;
+                return;
+            }
+            out->write(std::move(data));
+        },
+        threads);
+    return success;
+}
+
 PCSX::File* PCSX::ZipArchive::openFile(std::string path) {
     for (auto& c : path) {
         if (c == '\\') c = '/';
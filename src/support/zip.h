@@ -26,6 +26,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <filesystem>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -54,6 +55,19 @@ class ZipArchive {
     void listFiles(std::function<bool(std::string_view)> walker);
     void listDirectories(std::function<bool(std::string_view)> walker);
     File *openFile(std::string path);
+    // Same as above, but compressed files can be read at any offset cheaply, see ZIndexedReader.
+    // Good for large entries such as disc images, at the cost of keeping some memory around.
+    enum RandomAccess { RANDOM_ACCESS };
+    File *openFile(std::string path, RandomAccess);
+
+    // Extracts all of the files, inflating them on a pool of threads, and calls back with each one, from
+    // the thread which inflated it, so possibly concurrently. The reads from the archive itself are done
+    // one at a time. Files failing to inflate or their CRC check are skipped, and make this return false.
+    // Zero threads means as many as there are cores.
+    bool extractAll(std::function<void(std::string_view name, Slice &&data)> callback, unsigned threads = 0);
+    // Writes all of the directories and files into the destination directory. Files with names that
+    // would end up outside of it are skipped, and make this return false.
+    bool extractAllTo(const std::filesystem::path &destination, unsigned threads = 0);
 
     std::filesystem::path archiveFilename() { return m_file->filename(); }
 
@@ -72,6 +86,7 @@ class ZipArchive {
         uint32_t offset;
         uint32_t size;
         uint32_t compressedSize;
+        uint32_t crc;
         std::string name;
         bool compressed;
     };
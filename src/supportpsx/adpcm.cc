@@ -29,6 +29,86 @@ SOFTWARE.
 #include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
+
+#include "support/parallel.h"
+
+#if defined(__x86_64) || defined(_M_AMD64)
+#define ADPCM_X86
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ADPCM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Runs the 28 samples of a block through one of the prediction filters, and returns the largest absolute value
+// of the output. The history holds the two last samples of the previous block, followed by the 28 samples of
+// this one. Each output only depends on the input, so this can be done two samples at a time, with exactly
+// the same operations, in the same order, as the scalar version, to get bit-exact results.
+double filterBlock(const double* history, const std::array<double, 2>& filter, double* output) {
+#if defined(ADPCM_X86)
+    const __m128d c0 = _mm_set1_pd(filter[0]);
+    const __m128d c1 = _mm_set1_pd(filter[1]);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    __m128d max = _mm_setzero_pd();
+    for (unsigned i = 0; i < 28; i += 2) {
+        const __m128d s0 = _mm_loadu_pd(history + i + 1);
+        const __m128d s1 = _mm_loadu_pd(history + i);
+        const __m128d next = _mm_loadu_pd(history + i + 2);
+        const __m128d f = _mm_add_pd(_mm_add_pd(_mm_mul_pd(s0, c0), _mm_mul_pd(s1, c1)), next);
+        _mm_storeu_pd(output + i, f);
+        max = _mm_max_pd(max, _mm_andnot_pd(sign, f));
+    }
+    return std::max(_mm_cvtsd_f64(max), _mm_cvtsd_f64(_mm_unpackhi_pd(max, max)));
+#elif defined(ADPCM_NEON)
+    const float64x2_t c0 = vdupq_n_f64(filter[0]);
+    const float64x2_t c1 = vdupq_n_f64(filter[1]);
+    float64x2_t max = vdupq_n_f64(0.0);
+    for (unsigned i = 0; i < 28; i += 2) {
+        const float64x2_t s0 = vld1q_f64(history + i + 1);
+        const float64x2_t s1 = vld1q_f64(history + i);
+        const float64x2_t next = vld1q_f64(history + i + 2);
+        // no fused multiply-add here, which would round differently
+        const float64x2_t f = vaddq_f64(vaddq_f64(vmulq_f64(s0, c0), vmulq_f64(s1, c1)), next);
+        vst1q_f64(output + i, f);
+        max = vmaxq_f64(max, vabsq_f64(f));
+    }
+    return vmaxvq_f64(max);
+#else
+    double max = 0.0;
+    for (unsigned i = 0; i < 28; i++) {
+        auto f = history[i + 1] * filter[0] + history[i] * filter[1] + history[i + 2];
+        output[i] = f;
+        if (f <= 0.0) f = -f;
+        if (max < f) max = f;
+    }
+    return max;
+#endif
+}
+
+// Hands out the chunks to the worker threads, and encodes each of them with the encodeBlock callback, which
+// gets called for the warmup blocks first, then for the blocks of the chunk itself.
+template <typename EncodeBlock>
+void encodeChunks(unsigned blocks, PCSX::ADPCM::Encoder::Mode mode, const PCSX::ADPCM::BatchEncoder::Options& options,
+                  EncodeBlock encodeBlock) {
+    if (blocks == 0) return;
+    const unsigned chunkBlocks = options.chunkBlocks ? options.chunkBlocks : blocks;
+    const unsigned chunks = (blocks + chunkBlocks - 1) / chunkBlocks;
+    PCSX::parallelFor(chunks, options.threads, [&](size_t chunk) {
+        const unsigned first = chunk * chunkBlocks;
+        const unsigned last = std::min(blocks, first + chunkBlocks);
+        PCSX::ADPCM::Encoder encoder;
+        encoder.reset(mode);
+        for (unsigned b = first - std::min(first, options.warmupBlocks); b < first; b++) {
+            encodeBlock(encoder, b, true);
+        }
+        for (unsigned b = first; b < last; b++) encodeBlock(encoder, b, false);
+    });
+}
+
+}  // namespace
 
 void PCSX::ADPCM::Encoder::reset(Mode mode) {
     m_lastBlockSamples[0][0] = 0.0;
@@ -81,24 +161,16 @@ void PCSX::ADPCM::Encoder::findFilterAndShift(std::span<const double> input, std
     double minMax = 1.8e+307;
     std::array<double, 5> filteredMax;
     std::array<std::array<double, 28>, 5> allFiltered;
-    std::array<double, 2> samples;
+    std::array<double, 30> history;
+
+    history[0] = m_lastBlockSamples[channel][1];
+    history[1] = m_lastBlockSamples[channel][0];
+    std::copy(input.begin(), input.begin() + 28, history.begin() + 2);
 
     *filterPtr = 0;
 
     for (unsigned filter = 0; filter < 5; filter++) {
-        samples[0] = m_lastBlockSamples[channel][0];
-        samples[1] = m_lastBlockSamples[channel][1];
-        filteredMax[filter] = 0.0;
-        auto inputPtr = input;
-        for (unsigned i = 0; i < 28; i++) {
-            auto next = inputPtr[i];
-            auto f = samples[0] * c_filters[filter][0] + samples[1] * c_filters[filter][1] + next;
-            allFiltered[filter][i] = f;
-            if (f <= 0.0) f = -f;
-            if (filteredMax[filter] < f) filteredMax[filter] = f;
-            samples[1] = samples[0];
-            samples[0] = next;
-        }
+        filteredMax[filter] = filterBlock(history.data(), c_filters[filter], allFiltered[filter].data());
         auto factorized = m_factors[filter] * filteredMax[filter];
         if (factorized < minMax) {
             *filterPtr = filter;
@@ -106,8 +178,8 @@ void PCSX::ADPCM::Encoder::findFilterAndShift(std::span<const double> input, std
         }
         if ((filter == 0) && (filteredMax[0] <= 7.0)) break;
     }
-    m_lastBlockSamples[channel][0] = samples[0];
-    m_lastBlockSamples[channel][1] = samples[1];
+    m_lastBlockSamples[channel][0] = history[29];
+    m_lastBlockSamples[channel][1] = history[28];
     unsigned filter = *filterPtr;
     std::copy(allFiltered[filter].begin(), allFiltered[filter].end(), output.begin());
     int maxI = filteredMax[filter] * m_factors[filter + 5];
@@ -309,3 +381,33 @@ void PCSX::ADPCM::Encoder::processXABlock(const int16_t* input, uint8_t* output,
         }
     }
 }
+
+void PCSX::ADPCM::BatchEncoder::encodeSPUStream(const int16_t* input, uint8_t* output, unsigned blocks, bool loop,
+                                                Encoder::Mode mode, const Options& options) {
+    encodeChunks(blocks, mode, options, [=](Encoder& encoder, unsigned b, bool warmup) {
+        uint8_t discarded[16];
+        auto blockAttribute = Encoder::BlockAttribute::OneShot;
+        if (!loop) {
+            if (b == blocks - 1) blockAttribute = Encoder::BlockAttribute::OneShotEnd;
+        } else if (b == 0) {
+            blockAttribute = Encoder::BlockAttribute::LoopStart;
+        } else if (b == blocks - 1) {
+            blockAttribute = Encoder::BlockAttribute::LoopEnd;
+        } else {
+            blockAttribute = Encoder::BlockAttribute::LoopBody;
+        }
+        encoder.processSPUBlock(input + b * 28, warmup ? discarded : output + b * 16, blockAttribute);
+    });
+}
+
+void PCSX::ADPCM::BatchEncoder::encodeXAStream(const int16_t* input, uint8_t* output, unsigned blocks,
+                                               Encoder::XAMode xaMode, unsigned channels, const Options& options) {
+    if ((channels == 0) || (channels > 2)) {
+        throw std::invalid_argument("Channels must be 1 or 2");
+    }
+    const unsigned inputSize = xaBlockInputSize(xaMode);
+    encodeChunks(blocks, Encoder::Mode::XA, options, [=](Encoder& encoder, unsigned b, bool warmup) {
+        uint8_t discarded[128];
+        encoder.processXABlock(input + b * inputSize, warmup ? discarded : output + b * 128, xaMode, channels);
+    });
+}
@@ -144,6 +144,54 @@ class Encoder {
                  unsigned channel, XAMode xaMode);
 };
 
+// Encodes whole streams at once, splitting them into chunks which get spread over a few threads. Each chunk
+// is encoded by its own Encoder, which first goes over a few of the blocks preceding the chunk, discarding
+// the output, so that its state is warmed up the same way it would be when encoding the stream serially.
+// The state mostly consists of the last samples of the previous block, which this recovers exactly, and of
+// the rounding errors of the last encoded samples, which only ever converge. As a result, the output can
+// differ ever so slightly at the chunk boundaries from what a single Encoder would produce. It however only
+// depends on the chunking options, and never on the number of threads, so that encoding the same audio
+// twice always yields the same output.
+class BatchEncoder {
+  public:
+    struct Options {
+        // The number of blocks in each chunk, which are 28 samples blocks for SPU streams, and 128 bytes
+        // blocks for XA streams. Setting it to 0 disables the chunking, and makes the output identical to
+        // the one of a single Encoder, at the cost of only using one thread.
+        unsigned chunkBlocks = 4096;
+        // The number of blocks to encode before each chunk, in order to warm up its encoder.
+        unsigned warmupBlocks = 64;
+        // The number of threads to use, with 0 meaning one per hardware thread.
+        unsigned threads = 0;
+    };
+
+    // Encodes the blocks of 28 mono samples from the input into as many SPU blocks of 16 bytes. When loop
+    // is false, all the blocks are one shot blocks, and the last one gets the end flag; finishSPU still
+    // needs to be called afterwards. When loop is true, the stream is encoded as a single loop, with the
+    // first block starting it, and the last one jumping back.
+    static void encodeSPUStream(const int16_t* input, uint8_t* output, unsigned blocks, bool loop,
+                                Encoder::Mode mode, const Options& options);
+    static void encodeSPUStream(const int16_t* input, uint8_t* output, unsigned blocks, bool loop,
+                                Encoder::Mode mode = Encoder::Mode::Normal) {
+        encodeSPUStream(input, output, blocks, loop, mode, Options());
+    }
+
+    // Encodes the input into blocks of 128 bytes of XA audio, like Encoder::processXABlock would, using
+    // the XA mode of the encoder. The input needs the same number of samples per block as
+    // processXABlock does, and the sector headers are still left to the caller to handle.
+    static void encodeXAStream(const int16_t* input, uint8_t* output, unsigned blocks, Encoder::XAMode xaMode,
+                               unsigned channels, const Options& options);
+    static void encodeXAStream(const int16_t* input, uint8_t* output, unsigned blocks, Encoder::XAMode xaMode,
+                               unsigned channels) {
+        encodeXAStream(input, output, blocks, xaMode, channels, Options());
+    }
+
+    // The number of int16_t values processXABlock and encodeXAStream need per block.
+    static constexpr unsigned xaBlockInputSize(Encoder::XAMode xaMode) {
+        return xaMode == Encoder::XAMode::FourBits ? 224 : 112;
+    }
+};
+
 }  // namespace ADPCM
 
 }  // namespace PCSX
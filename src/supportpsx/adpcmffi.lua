@@ -55,6 +55,10 @@ void adpcmEncoderProcessSPUBlock(LuaAdpcmEncoder* encoder, const void* input, vo
 void adpcmEncoderFinishSPU(LuaAdpcmEncoder* encoder, uint8_t* output);
 void adpcmEncoderProcessXABlock(LuaAdpcmEncoder* encoder, const int16_t* input, uint8_t* output,
                                 enum XAMode, unsigned channels);
+void adpcmEncodeSPUStream(const void* input, void* output, unsigned blocks, bool loop, enum AdpcmEncoderMode mode,
+                          int chunkBlocks, int warmupBlocks, int threads);
+void adpcmEncodeXAStream(const void* input, void* output, unsigned blocks, enum XAMode mode, unsigned channels,
+                         int chunkBlocks, int warmupBlocks, int threads);
 
 ]]
 
@@ -62,6 +66,22 @@ local C = ffi.load 'SUPPORTPSX_ADPCM'
 
 local uint8_t = ffi.typeof 'uint8_t'
 
+-- Pads the input buffer with silence up to a whole number of blocks, returning a pointer to its data
+local function padInput(inData, blockSize)
+    local size = #inData
+    local blocks = math.ceil(size / blockSize)
+    if size == blocks * blockSize then return inData.data, blocks end
+    local inp = Support.NewLuaBuffer(blocks * blockSize)
+    ffi.fill(inp.data, blocks * blockSize, 0)
+    ffi.copy(inp.data, inData.data, size)
+    return inp.data, blocks, inp
+end
+
+local function batchOptions(options)
+    if type(options) ~= 'table' then options = {} end
+    return options.chunkBlocks or -1, options.warmupBlocks or -1, options.threads or -1
+end
+
 PCSX.Adpcm = {
     NewEncoder = function()
         local wrapped = C.newAdpcmEncoder()
@@ -173,6 +193,26 @@ PCSX.Adpcm = {
         debug.setmetatable(encoder._proxy, { __gc = function() C.destroyAdpcmEncoder(encoder._wrapped) end })
         return encoder
     end,
+    -- Encodes a whole buffer of mono samples into SPU blocks, using several threads. The options table
+    -- can hold chunkBlocks, warmupBlocks and threads; see supportpsx/adpcm.h for their meaning.
+    encodeSPUStream = function(inData, loop, mode, options)
+        if mode == nil then mode = 'Normal' end
+        -- keepAlive holds on to the padded copy of the input, if any, until after the call
+        local inp, blocks, keepAlive = padInput(inData, 56)
+        local outData = Support.NewLuaBuffer(blocks * 16)
+        C.adpcmEncodeSPUStream(inp, outData.data, blocks, loop == true, mode, batchOptions(options))
+        return outData
+    end,
+    -- Encodes a whole buffer of samples into 128 bytes XA blocks, using several threads. The sector headers
+    -- are left to the caller.
+    encodeXAStream = function(inData, mode, channels, options)
+        if mode == nil then mode = 'XAFourBits' end
+        if channels == nil then channels = 1 end
+        local inp, blocks, keepAlive = padInput(inData, mode == 'XAFourBits' and 448 or 224)
+        local outData = Support.NewLuaBuffer(blocks * 128)
+        C.adpcmEncodeXAStream(inp, outData.data, blocks, mode, channels, batchOptions(options))
+        return outData
+    end,
 }
 
 -- )EOF"
@@ -49,6 +49,25 @@ void adpcmEncoderProcessXABlock(PCSX::ADPCM::Encoder* encoder, const int16_t* in
     encoder->processXABlock(input, output, mode, channels);
 }
 
+// Negative values leave the corresponding option to its default.
+PCSX::ADPCM::BatchEncoder::Options batchOptions(int chunkBlocks, int warmupBlocks, int threads) {
+    PCSX::ADPCM::BatchEncoder::Options options;
+    if (chunkBlocks >= 0) options.chunkBlocks = chunkBlocks;
+    if (warmupBlocks >= 0) options.warmupBlocks = warmupBlocks;
+    if (threads >= 0) options.threads = threads;
+    return options;
+}
+void adpcmEncodeSPUStream(const int16_t* input, uint8_t* output, unsigned blocks, bool loop,
+                          PCSX::ADPCM::Encoder::Mode mode, int chunkBlocks, int warmupBlocks, int threads) {
+    PCSX::ADPCM::BatchEncoder::encodeSPUStream(input, output, blocks, loop, mode,
+                                               batchOptions(chunkBlocks, warmupBlocks, threads));
+}
+void adpcmEncodeXAStream(const int16_t* input, uint8_t* output, unsigned blocks, PCSX::ADPCM::Encoder::XAMode mode,
+                         unsigned channels, int chunkBlocks, int warmupBlocks, int threads) {
+    PCSX::ADPCM::BatchEncoder::encodeXAStream(input, output, blocks, mode, channels,
+                                              batchOptions(chunkBlocks, warmupBlocks, threads));
+}
+
 template <typename T, size_t S>
 void registerSymbol(PCSX::Lua L, const char (&name)[S], const T ptr) {
     L.push<S>(name);
@@ -69,6 +88,8 @@ void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, adpcmEncoderProcessSPUBlock);
     REGISTER(L, adpcmEncoderFinishSPU);
     REGISTER(L, adpcmEncoderProcessXABlock);
+    REGISTER(L, adpcmEncodeSPUStream);
+    REGISTER(L, adpcmEncodeXAStream);
     L.settable();
     L.pop();
 }
@@ -25,8 +25,19 @@ SOFTWARE.
 */
 #include "supportpsx/assembler.h"
 
+#include <string.h>
+
 #include "lua/luawrapper.h"
 
+namespace {
+
+struct Chunk {
+    const char* code;
+    const char* name;
+};
+
+}  // namespace
+
 void PCSX::LuaSupportPSX::open_assembler(Lua L) {
     static int lualoader = 8;
     static const char* assembler = (
@@ -53,12 +64,33 @@ void PCSX::LuaSupportPSX::open_assembler(Lua L) {
     static const char* symbols = (
 #include "supportpsx/assembler/symbols.lua"
     );
-    L.load(assembler, "src:supportpsx/assembler/assembler.lua");
-    L.load(registers, "src:supportpsx/assembler/registers.lua");
-    L.load(simple, "src:supportpsx/assembler/simple.lua");
-    L.load(loadstore, "src:supportpsx/assembler/loadstore.lua");
-    L.load(extra, "src:supportpsx/assembler/extra.lua");
-    L.load(gte, "src:supportpsx/assembler/gte.lua");
-    L.load(pseudo, "src:supportpsx/assembler/pseudo.lua");
-    L.load(symbols, "src:supportpsx/assembler/symbols.lua");
+    static const Chunk chunks[] = {
+        {assembler, "src:supportpsx/assembler/assembler.lua"}, {registers, "src:supportpsx/assembler/registers.lua"},
+        {simple, "src:supportpsx/assembler/simple.lua"},       {loadstore, "src:supportpsx/assembler/loadstore.lua"},
+        {extra, "src:supportpsx/assembler/extra.lua"},         {gte, "src:supportpsx/assembler/gte.lua"},
+        {pseudo, "src:supportpsx/assembler/pseudo.lua"},       {symbols, "src:supportpsx/assembler/symbols.lua"},
+    };
+
+    // Few scripts ever assemble anything, so the assembler only gets loaded the first time something looks
+    // for PCSX.Assembler, instead of at startup.
+    L.load(R"(
+local loadAssembler = ...
+setmetatable(PCSX, {
+    __index = function(t, key)
+        if key ~= 'Assembler' then return nil end
+        setmetatable(PCSX, nil)
+        loadAssembler()
+        return rawget(PCSX, 'Assembler')
+    end,
+})
+)",
+           "internal:lazyassembler.lua", false);
+    L.push(static_cast<lua_CFunction>([](lua_State* L_) -> int {
+        for (const auto& chunk : chunks) {
+            if (luaL_loadbuffer(L_, chunk.code, strlen(chunk.code), chunk.name) != 0) return lua_error(L_);
+            lua_call(L_, 0, 0);
+        }
+        return 0;
+    }));
+    L.pcall(1);
 }
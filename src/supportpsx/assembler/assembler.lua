@@ -71,12 +71,12 @@ PCSX.Assembler.Internals.checks.imm5 = function(imm, place)
 end
 
 PCSX.Assembler.New = function()
-    local function compileOne(code, baseAddress)
+    local function compileOne(code, baseAddress, resolveSymbol)
         local ret = code.base
         local hi16 = code.hi16
         if hi16 then
             if type(hi16) == 'string' then
-                local symbol = PCSX.Assembler.Internals.resolveSymbol(hi16)
+                local symbol = resolveSymbol(hi16)
                 if not symbol then error('Unknown symbol: ' .. hi16) end
                 hi16 = symbol.address
             end
@@ -86,7 +86,7 @@ PCSX.Assembler.New = function()
         local lo16 = code.lo16
         if lo16 then
             if type(lo16) == 'string' then
-                local symbol = PCSX.Assembler.Internals.resolveSymbol(lo16)
+                local symbol = resolveSymbol(lo16)
                 if not symbol then error('Unknown symbol: ' .. lo16) end
                 lo16 = symbol.address
             end
@@ -95,7 +95,7 @@ PCSX.Assembler.New = function()
         local imm26 = code.imm26
         if imm26 then
             if type(imm26) == 'string' then
-                local symbol = PCSX.Assembler.Internals.resolveSymbol(imm26)
+                local symbol = resolveSymbol(imm26)
                 if not symbol then error('Unknown symbol: ' .. imm26) end
                 if (symbol.address % 4) ~= 0 then
                     error('Jump address must be a multiple of 4: ' .. imm26)
@@ -115,7 +115,7 @@ PCSX.Assembler.New = function()
                 if bimm16:sub(1, 1) == '@' then
                     address = tonumber(bimm16:sub(2))
                 else
-                    local symbol = PCSX.Assembler.Internals.resolveSymbol(bimm16)
+                    local symbol = resolveSymbol(bimm16)
                     if not symbol then error('Unknown symbol: ' .. bimm16) end
                     address = symbol.address
                 end
@@ -169,16 +169,18 @@ PCSX.Assembler.New = function()
         end,
         compileToUint32Table = function(self, baseAddress)
             local ret = {}
+            local resolveSymbol = PCSX.Assembler.Internals.newSymbolResolver()
             for _, v in ipairs(self.__code) do
-                table.insert(ret, compileOne(v, baseAddress))
+                table.insert(ret, compileOne(v, baseAddress, resolveSymbol))
                 baseAddress = baseAddress + 4
             end
             return ret
         end,
         compileToMemory = function(self, memory, baseAddress, memoryStartAddress)
             local offset = baseAddress - memoryStartAddress
+            local resolveSymbol = PCSX.Assembler.Internals.newSymbolResolver()
             for _, v in ipairs(self.__code) do
-                local compiled = compileOne(v, baseAddress)
+                local compiled = compileOne(v, baseAddress, resolveSymbol)
                 memory[offset] = bit.band(compiled, 0xff)
                 memory[offset + 1] = bit.band(bit.rshift(compiled, 8), 0xff)
                 memory[offset + 2] = bit.band(bit.rshift(compiled, 16), 0xff)
@@ -194,8 +196,9 @@ PCSX.Assembler.New = function()
             if fileStartAddress == nil then fileStartAddress = 0 end
             if type(fileStartAddress) ~= 'number' then error('Invalid third argument: not a number') end
             local offset = baseAddress - fileStartAddress
+            local resolveSymbol = PCSX.Assembler.Internals.newSymbolResolver()
             for _, v in ipairs(self.__code) do
-                local compiled = compileOne(v, baseAddress)
+                local compiled = compileOne(v, baseAddress, resolveSymbol)
                 file:writeU32At(compiled, offset)
                 baseAddress = baseAddress + 4
                 offset = offset + 4
@@ -213,22 +216,27 @@ PCSX.Assembler.New = function()
         end
         return ret
     end
+    local instructionTables = {
+        PCSX.Assembler.Internals.simpleInstructions,
+        PCSX.Assembler.Internals.loadAndStoreInstructions,
+        PCSX.Assembler.Internals.specialInstructions,
+        PCSX.Assembler.Internals.bcondInstructions,
+        PCSX.Assembler.Internals.cop0Instructions,
+        PCSX.Assembler.Internals.gteInstructions,
+        PCSX.Assembler.Internals.pseudoInstructions,
+    }
     local meta = {
+        -- The function emitting an instruction is stored in the assembler the first time it gets looked
+        -- up, so that the next uses of the same instruction don't go through here again.
         __index = function(self, key)
-            local instr = PCSX.Assembler.Internals.simpleInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.loadAndStoreInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.specialInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.bcondInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.cop0Instructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.gteInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
-            instr = PCSX.Assembler.Internals.pseudoInstructions[key]
-            if instr then return function(...) return wrapper(self, instr, key, { ... }) end end
+            for _, instructions in ipairs(instructionTables) do
+                local instr = instructions[key]
+                if instr then
+                    local emit = function(...) return wrapper(self, instr, key, { ... }) end
+                    rawset(self, key, emit)
+                    return emit
+                end
+            end
             error('Unknown instruction ' .. key)
         end,
     }
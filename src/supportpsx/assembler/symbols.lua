@@ -27,4 +27,22 @@ PCSX.Assembler.Internals.resolveSymbol = function(name)
     return nil
 end
 
+-- Walking all of the symbols for each label gets slow with large programs and
+-- symbol tables, so compiling goes through a resolver which indexes all of the
+-- symbols by name the first time it's asked for one, and then only looks them
+-- up in that index. When several symbols share a name, the first one wins, same
+-- as with resolveSymbol.
+PCSX.Assembler.Internals.newSymbolResolver = function()
+    local index
+    return function(name)
+        if not index then
+            index = {}
+            for k, v in PCSX.iterateSymbols() do
+                if index[v] == nil then index[v] = { address = k, name = v } end
+            end
+        end
+        return index[name]
+    end
+end
+
 -- )EOF"
@@ -26,8 +26,12 @@ SOFTWARE.
 
 #include "supportpsx/binloader.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "elfio/elfio.hpp"
 #include "fmt/format.h"
@@ -41,13 +45,8 @@ namespace PCSX {
 namespace {
 
 void eraseSymbolsInSpan(uint32_t low, uint32_t high, std::map<uint32_t, std::string>& symbols) {
-    for (auto s = symbols.begin(); s != symbols.end();) {
-        if (s->first >= low && s->first < high) {
-            s = symbols.erase(s);
-        } else {
-            s++;
-        }
-    }
+    if (high <= low) return;
+    symbols.erase(symbols.lower_bound(low), symbols.lower_bound(high));
 }
 
 bool loadCPE(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols) {
@@ -212,6 +211,53 @@ bool loadPSF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
     return true;
 }
 
+// Reads the symbol table straight out of its section, instead of going through ELFIO symbol by symbol, which
+// allocates a string per symbol just to look at it. The symbols get sorted by address first, with the last
+// one of those sharing an address winning, as if they were assigned one by one. They can then be inserted
+// into the map in order, each one right after the previous one, instead of each being a full lookup.
+// Returns false for what it can't read this way, which then goes through ELFIO.
+bool importSymbols(const ELFIO::elfio& reader, ELFIO::section* symtab, std::map<uint32_t, std::string>& symbols) {
+    using namespace ELFIO;
+    if (reader.get_encoding() != ELFDATA2LSB) return false;
+    if (symtab->get_entry_size() != sizeof(Elf32_Sym)) return false;
+    if (symtab->get_link() >= reader.sections.size()) return false;
+    const section* strtab = reader.sections[symtab->get_link()];
+    auto data = reinterpret_cast<const uint8_t*>(symtab->get_data());
+    const char* strings = strtab->get_data();
+    const size_t stringsSize = strtab->get_size();
+    if (!data || !strings) return false;
+
+    auto get32 = [](const uint8_t* p) -> uint32_t {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+    };
+    struct Entry {
+        uint32_t address;
+        uint32_t name;
+    };
+    const size_t count = symtab->get_size() / sizeof(Elf32_Sym);
+    std::vector<Entry> entries(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* sym = data + i * sizeof(Elf32_Sym);
+        entries[i] = {get32(sym + offsetof(Elf32_Sym, st_value)), get32(sym + offsetof(Elf32_Sym, st_name))};
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](auto& a, auto& b) { return a.address < b.address; });
+
+    auto hint = symbols.begin();
+    for (size_t i = 0; i < count; i++) {
+        if (((i + 1) < count) && (entries[i + 1].address == entries[i].address)) continue;
+        const auto& entry = entries[i];
+        std::string name;
+        if (entry.name < stringsSize) {
+            name.assign(strings + entry.name, strnlen(strings + entry.name, stringsSize - entry.name));
+        }
+        // The hint is where the previous symbol went, unless there are others in the map in between.
+        if ((hint != symbols.end()) && (hint->first < entry.address)) hint = symbols.lower_bound(entry.address);
+        hint = symbols.insert_or_assign(hint, entry.address, std::move(name));
+        hint++;
+    }
+    return true;
+}
+
 bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<uint32_t, std::string>& symbols) {
     using namespace ELFIO;
     elfio reader;
@@ -246,6 +292,7 @@ bool loadELF(IO<File> file, IO<File> dest, BinaryLoader::Info& info, std::map<ui
 
         auto type = psec->get_type();
         if (type != SHT_SYMTAB) continue;
+        if (importSymbols(reader, psec, symbols)) continue;
         const ELFIO::symbol_section_accessor symbolstab(reader, psec);
         for (unsigned s = 0; s < symbolstab.get_symbols_num(); s++) {
             std::string name;
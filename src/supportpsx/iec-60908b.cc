@@ -27,8 +27,9 @@ SOFTWARE.
 #include "supportpsx/iec-60908b.h"
 
 #include <stdint.h>
+#include <string.h>
 
-#include "iec-60908b/edcecc.h"
+#include <array>
 
 // Lookup table for crc-16 subq calculation. This is a normal CRC-CCITT.
 static constexpr uint16_t crctab[256] = {
@@ -76,4 +77,138 @@ uint16_t PCSX::IEC60908b::subqCRC(const uint8_t* d, int len) {
     return ~crc;
 }
 
-void PCSX::IEC60908b::computeEDCECC(uint8_t* sector) { compute_edcecc(sector); }
+namespace {
+
+// The EDC is a CRC-32 using the x^32 + x^31 + x^16 + x^15 + x^4 + x^3 + x + 1 polynomial, least significant
+// bit first, like in third_party/iec-60908b/edcecc.c. It's computed here 8 bytes at a time, with one table
+// for each of these bytes.
+constexpr std::array<std::array<uint32_t, 256>, 8> c_edcTables = []() {
+    std::array<std::array<uint32_t, 256>, 8> tables = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t edc = i;
+        for (unsigned j = 0; j < 8; j++) edc = (edc >> 1) ^ ((edc & 1) ? 0xd8018001 : 0);
+        tables[0][i] = edc;
+    }
+    for (unsigned t = 1; t < 8; t++) {
+        for (unsigned i = 0; i < 256; i++) {
+            const uint32_t previous = tables[t - 1][i];
+            tables[t][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+    }
+    return tables;
+}();
+
+uint32_t computeEDC(const uint8_t* data, unsigned length) {
+    const auto& t = c_edcTables;
+    uint32_t edc = 0;
+    for (; length >= 8; length -= 8, data += 8) {
+        edc ^= data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+        edc = t[7][edc & 0xff] ^ t[6][(edc >> 8) & 0xff] ^ t[5][(edc >> 16) & 0xff] ^ t[4][edc >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    while (length--) edc = t[0][(edc ^ *data++) & 0xff] ^ (edc >> 8);
+    return edc;
+}
+
+// The ECC is a pair of Reed-Solomon codes over GF(2^8), whose generator polynomial is (x + 1)(x + 2). For
+// each line of the code, this boils down to a plain xor of all of its bytes, and a series where each byte
+// gets added to the previous value times 2, which are combined at the end using a division by 3. The 8 bytes
+// of a uint64_t are treated as 8 independent lines at once, which the multiplication by 2 can be made to
+// work on without any table.
+uint64_t mul2(uint64_t x) {
+    const uint64_t carries = (x >> 7) & 0x0101010101010101;
+    return ((x & 0x7f7f7f7f7f7f7f7f) << 1) ^ (carries * 0x1d);
+}
+
+constexpr std::array<uint8_t, 256> c_div3 = []() {
+    std::array<uint8_t, 256> table = {};
+    for (unsigned i = 0; i < 256; i++) {
+        const unsigned times2 = ((i << 1) ^ ((i & 0x80) ? 0x11d : 0)) & 0xff;
+        table[times2 ^ i] = i;
+    }
+    return table;
+}();
+
+uint64_t load64(const uint8_t* data) {
+    uint64_t r = 0;
+    for (unsigned i = 0; i < 8; i++) r |= uint64_t(data[i]) << (i * 8);
+    return r;
+}
+
+// Turns the two series of 8 lines into their two bytes of ECC each.
+void storeECC(uint64_t series, uint64_t sum, uint8_t* first, uint8_t* second, unsigned stride) {
+    series = mul2(series) ^ sum;
+    for (unsigned i = 0; i < 8; i++) {
+        const uint8_t low = c_div3[(series >> (i * 8)) & 0xff];
+        first[i * stride] = low;
+        second[i * stride] = low ^ ((sum >> (i * 8)) & 0xff);
+    }
+}
+
+// The data covered by the ECC starts at the sector's header, and is seen as 1118 words of 16 bits for Q,
+// the last 86 of which being the P parity; the lower and upper bytes are two independent codes.
+void computeECC(uint8_t* data) {
+    // P: 86 lines of 24 bytes, and lines next to each other are next to each other in memory. The last 8
+    // lines overlap with the previous 8 ones, which doesn't matter since they're computed the same way.
+    for (unsigned line = 0; line < 86; line = line == 72 ? 78 : line + 8) {
+        uint64_t series = 0, sum = 0;
+        for (unsigned j = 0; j < 24; j++) {
+            const uint64_t bytes = load64(data + 86 * j + line);
+            sum ^= bytes;
+            series = mul2(series ^ bytes);
+        }
+        storeECC(series, sum, data + 24 * 86 + line, data + 25 * 86 + line, 1);
+    }
+
+    // Q: 52 lines of 43 bytes, going diagonally through the words, so we're grabbing 4 words for 4 lines
+    // at a time. Same as above, the last 4 lines overlap with the previous ones.
+    for (unsigned word = 0; word < 26; word = word == 20 ? 22 : word + 4) {
+        unsigned offsets[4];
+        for (unsigned k = 0; k < 4; k++) offsets[k] = 43 * (word + k);
+        uint64_t series = 0, sum = 0;
+        for (unsigned j = 0; j < 43; j++) {
+            uint64_t bytes = 0;
+            for (unsigned k = 0; k < 4; k++) {
+                const uint8_t* w = data + offsets[k] * 2;
+                bytes |= (uint64_t(w[0]) | (uint64_t(w[1]) << 8)) << (k * 16);
+                offsets[k] += 44;
+                if (offsets[k] >= 1118) offsets[k] -= 1118;
+            }
+            sum ^= bytes;
+            series = mul2(series ^ bytes);
+        }
+        storeECC(series, sum, data + 43 * 26 * 2 + word * 2, data + 44 * 26 * 2 + word * 2, 1);
+    }
+}
+
+}  // namespace
+
+void PCSX::IEC60908b::computeEDCECC(uint8_t* sector) {
+    uint8_t* header = sector + 12;
+    const uint8_t mode = header[3];
+
+    if (mode == 1) {
+        // The EDC covers the sync and the header too, and is followed by 8 zeroes.
+        const uint32_t edc = computeEDC(sector, 0x810);
+        for (unsigned i = 0; i < 4; i++) sector[0x810 + i] = edc >> (i * 8);
+        memset(sector + 0x814, 0, 8);
+        computeECC(header);
+        return;
+    }
+    if (mode != 2) return;
+
+    // The EDC covers the 8 bytes of subheader, and the data, which is longer for form 2.
+    uint8_t* subheader = sector + 16;
+    const bool form2 = subheader[2] & 0x20;
+    const unsigned length = (form2 ? 2324 : 2048) + 8;
+    const uint32_t edc = computeEDC(subheader, length);
+    for (unsigned i = 0; i < 4; i++) subheader[length + i] = edc >> (i * 8);
+    if (form2) return;
+
+    // Form 1 sectors get their ECC computed as if their header was zeroes.
+    uint8_t location[4];
+    memcpy(location, header, sizeof(location));
+    memset(header, 0, sizeof(location));
+    computeECC(header);
+    memcpy(header, location, sizeof(location));
+}
@@ -142,7 +142,7 @@ struct MSF {
     };
 };
 
-// Compute the EDC and ECC for a mode2 sector.
+// Compute the EDC and ECC for a mode 1 or mode 2 sector, based on its mode and subheader.
 void computeEDCECC(uint8_t *sector);
 
 // Compute the CRC-16 for the SubQ channel.
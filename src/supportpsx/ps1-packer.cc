@@ -29,11 +29,14 @@ SOFTWARE.
 #include <assert.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
 #include <vector>
 
 #include "mips/common/util/encoder.hh"
 #include "n2e-d.h"
+#include "support/parallel.h"
 #include "support/polyfills.h"
 #include "ucl/ucl.h"
 
@@ -487,3 +490,70 @@ void PCSX::PS1Packer::pack(IO<File> src, IO<File> dest, uint32_t addr, uint32_t
     dest->write(header.data(), header.size());
     dest->write(dataOut.data(), dataOut.size());
 }
+
+uint32_t PCSX::PS1Packer::packStream(IO<File> src, IO<File> dest, uint32_t blockSize, unsigned threads) {
+    constexpr uint32_t magic = 0x4e325301;
+    constexpr uint32_t overlap = 16;
+    if ((blockSize == 0) || ((blockSize & 3) != 0)) {
+        throw std::runtime_error("Stream block size needs to be a non-zero multiple of 4.\n");
+    }
+    std::vector<uint8_t> dataIn;
+    dataIn.resize(src->size());
+    src->read(dataIn.data(), dataIn.size());
+    while ((dataIn.size() & 3) != 0) dataIn.push_back(0);
+    const uint32_t decompSize = dataIn.size();
+
+    // Each block is compressed on its own, since the decompressor can't carry
+    // its state from one call to the next. The margin is how far the compressed
+    // data needs to be pushed past the end of the decompressed data, so that
+    // decompressing any block never overwrites compressed bytes which haven't
+    // been read yet. For each block, this means its compressed data has to end
+    // at least 16 bytes after its decompressed data, same as for pack().
+    // The blocks being independent, they get compressed in parallel, and then put back together in order.
+    const uint32_t blockCount = (decompSize + blockSize - 1) / blockSize;
+    std::vector<std::vector<uint8_t>> compressed(blockCount);
+    std::atomic<bool> failed = false;
+    parallelFor(blockCount, threads, [&](size_t i) {
+        const uint32_t offset = i * blockSize;
+        const uint32_t size = std::min(blockSize, decompSize - offset);
+        auto& dataOut = compressed[i];
+        dataOut.resize(size * 1.2 + 2064);
+        ucl_uint outSize;
+        int r = ucl_nrv2e_99_compress(dataIn.data() + offset, size, dataOut.data(), &outSize, nullptr, 10, nullptr,
+                                      nullptr);
+        if (r != UCL_E_OK) failed = true;
+        dataOut.resize(r == UCL_E_OK ? outSize : 0);
+    });
+    if (failed) {
+        throw std::runtime_error("Fatal error during data compression.\n");
+    }
+
+    std::vector<uint8_t> blocks;
+    std::vector<uint32_t> ends;
+    for (auto& dataOut : compressed) {
+        pushBytes(blocks, uint32_t(dataOut.size()));
+        blocks.insert(blocks.end(), dataOut.begin(), dataOut.end());
+        ends.push_back(blocks.size());
+        while ((blocks.size() & 3) != 0) blocks.push_back(0);
+    }
+    const uint32_t compSize = blocks.size();
+
+    int64_t margin = overlap;
+    for (uint32_t i = 0; i < blockCount; i++) {
+        const int64_t decompEnd = std::min(uint64_t(i + 1) * blockSize, uint64_t(decompSize));
+        margin = std::max(margin, decompEnd + overlap + compSize - decompSize - ends[i]);
+    }
+    margin = (margin + 3) & ~3;
+
+    std::vector<uint8_t> header;
+    pushBytes(header, magic);
+    pushBytes(header, decompSize);
+    pushBytes(header, compSize);
+    pushBytes(header, blockSize);
+    pushBytes(header, blockCount);
+    pushBytes(header, uint32_t(margin));
+
+    dest->write(header.data(), header.size());
+    dest->write(blocks.data(), blocks.size());
+    return decompSize + margin;
+}
@@ -48,6 +48,16 @@ struct Options {
 
 void pack(IO<File> src, IO<File> dest, uint32_t addr, uint32_t pc, uint32_t gp, uint32_t sp, const Options &);
 
+// Compresses src into blocks of blockSize bytes, each compressed independently, so that the PS1 side can
+// decompress them one after the other while the rest of the data is still being read from the CD. The output
+// starts with a 24 bytes header, made of 32 bits little endian words: the magic number, the decompressed size,
+// the compressed size, the block size, the block count, and the margin. Then come the blocks, each prefixed by
+// its compressed size, and padded to 4 bytes. Decompressing in place is safe if the data after the header is
+// loaded at the end of a buffer of decompressed size + margin bytes. Returns the size of that buffer.
+// The blocks are compressed on this many threads, 0 meaning one per core; the output doesn't depend on it.
+uint32_t packStream(IO<File> src, IO<File> dest, uint32_t blockSize, unsigned threads = 0);
+
+
 }  // namespace PS1Packer
 
 }  // namespace PCSX
@@ -0,0 +1,566 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+// Runs a set of MIPS programs through the emulator, with both the interpreter and the dynarec, and prints
+// how fast it went through them as JSON, so that it can be tracked from one commit to the next.
+//
+// Each run gets its own process, for the peak memory usage to only be about this run, and so that a crash
+// only loses one of the results. The emulator's own output goes to stderr, leaving stdout to the JSON.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gpu/soft/soft.h"
+#include "gpu/soft/spans.h"
+#include "iec-60908b/edcecc.h"
+#include "json.hpp"
+#include "main/main.h"
+#include "spu/reverbmix.h"
+#include "spu/types.h"
+#include "support/flathashtable.h"
+#include "support/hashing.h"
+#include "support/hashtable.h"
+#include "support/md5.h"
+#include "support/sha1.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace {
+
+struct Workload {
+    const char* name;
+    const char* exe;
+};
+
+// The tests which don't need anything special to run, and the programs made for stressing each part of the
+// machine; see src/mips/benchmarks.
+constexpr Workload c_workloads[] = {
+    {"tests/basic", "src/mips/tests/basic/basic.ps-exe"},
+    {"tests/cpu", "src/mips/tests/cpu/cpu.ps-exe"},
+    {"tests/cop0", "src/mips/tests/cop0/cop0.ps-exe"},
+    {"tests/libc", "src/mips/tests/libc/libc.ps-exe"},
+    {"tests/memcpy", "src/mips/tests/memcpy/memcpy.ps-exe"},
+    {"tests/memset", "src/mips/tests/memset/memset.ps-exe"},
+    {"benchmarks/cpu", "src/mips/benchmarks/cpu/cpu.ps-exe"},
+    {"benchmarks/gte", "src/mips/benchmarks/gte/gte.ps-exe"},
+    {"benchmarks/gpu", "src/mips/benchmarks/gpu/gpu.ps-exe"},
+    {"benchmarks/spu", "src/mips/benchmarks/spu/spu.ps-exe"},
+};
+
+constexpr const char* c_cores[] = {"interpreter", "dynarec"};
+
+struct Result {
+    int exitCode = -1;
+    uint64_t cycles = 0;
+    uint64_t frames = 0;
+    double seconds = 0;
+};
+
+// Runs the emulator in a child process, adding what it got through to ret. The report of a GPU replay, if
+// any, follows the result in the pipe.
+nlohmann::json runChild(nlohmann::json ret, MainInvoker& invoker, MainStats& stats) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        ret["error"] = "pipe failed";
+        return ret;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        Result result;
+        const auto start = std::chrono::steady_clock::now();
+        result.exitCode = invoker.invoke(&stats);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.cycles = stats.cycles;
+        result.frames = stats.frames;
+        write(fds[1], &result, sizeof(result));
+        write(fds[1], stats.gpuReplay.data(), stats.gpuReplay.size());
+        close(fds[1]);
+        fflush(nullptr);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        ret["error"] = "fork failed";
+        return ret;
+    }
+
+    Result result;
+    const bool gotResult = read(fds[0], &result, sizeof(result)) == sizeof(result);
+    std::string report;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fds[0], buffer, sizeof(buffer))) > 0) report.append(buffer, count);
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage = {};
+    wait4(pid, &status, 0, &usage);
+#if defined(__APPLE__)
+    const uint64_t peakRSS = usage.ru_maxrss;
+#else
+    const uint64_t peakRSS = uint64_t(usage.ru_maxrss) * 1024;
+#endif
+
+    if (!gotResult) {
+        ret["error"] = "crashed";
+        return ret;
+    }
+    ret["exitCode"] = result.exitCode;
+    ret["seconds"] = result.seconds;
+    ret["cycles"] = result.cycles;
+    ret["frames"] = result.frames;
+    ret["cyclesPerSecond"] = result.seconds > 0 ? result.cycles / result.seconds : 0;
+    ret["framesPerSecond"] = result.seconds > 0 ? result.frames / result.seconds : 0;
+    ret["peakRSS"] = peakRSS;
+    if (!report.empty()) ret["replay"] = nlohmann::json::parse(report, nullptr, false);
+    return ret;
+}
+
+nlohmann::json run(const Workload& workload, const char* core) {
+    const std::string coreArg = std::string("-") + core;
+    MainInvoker invoker("-no-ui", "-unthrottled", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode",
+                        coreArg.c_str(), "-loadexe", workload.exe);
+    MainStats stats;
+    return runChild({{"workload", workload.name}, {"core", core}}, invoker, stats);
+}
+
+// Replays a capture made with PCSX.GPU.startCapture against the software GPU, without running anything else,
+// which measures the rasterizer on its own. Going packet by packet tells the kinds of primitives apart, and
+// going through the whole stream at once lets the GPU threads overlap, the way they would in a game.
+nlohmann::json replay(const std::string& capture, const std::string& iterations, bool whole) {
+    auto invoker = whole ? std::make_unique<MainInvoker>("-no-ui", "-softgpu", "-testmode", "-gpureplay",
+                                                         capture.c_str(), "-gpureplay-iterations", iterations.c_str(),
+                                                         "-gpureplay-whole")
+                         : std::make_unique<MainInvoker>("-no-ui", "-softgpu", "-testmode", "-gpureplay",
+                                                         capture.c_str(), "-gpureplay-iterations", iterations.c_str());
+    MainStats stats;
+    auto ret = runChild({{"capture", capture}, {"mode", whole ? "whole" : "per-packet"}}, *invoker, stats);
+    if (!ret.contains("error") && (!ret.contains("replay") || ret["replay"].is_discarded())) {
+        ret["error"] = "no replay report";
+    }
+    return ret;
+}
+
+// Converts all of the objects and libraries of a PsyQ SDK to ELF files with psyq-obj-parser, using that many
+// threads. The tool is expected to have been built alongside, in the current directory.
+nlohmann::json convertPsyq(const std::filesystem::path& sdk, unsigned threads) {
+    nlohmann::json ret = {{"psyq", sdk.string()}, {"threads", threads}};
+    std::vector<std::string> inputs;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(sdk, ec)) {
+        if (!entry.is_regular_file()) continue;
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::toupper);
+        if ((extension == ".OBJ") || (extension == ".LIB")) inputs.push_back(entry.path().string());
+    }
+    if (inputs.empty()) {
+        ret["error"] = "no input";
+        return ret;
+    }
+    std::sort(inputs.begin(), inputs.end());
+    ret["files"] = inputs.size();
+
+    char tempTemplate[] = "/tmp/pcsx-redux-bench-XXXXXX";
+    const char* temp = mkdtemp(tempTemplate);
+    if (!temp) {
+        ret["error"] = "mkdtemp failed";
+        return ret;
+    }
+    const std::string threadsArg = std::to_string(threads);
+    std::vector<const char*> argv = {"./psyq-obj-parser"};
+    for (auto& input : inputs) argv.push_back(input.c_str());
+    for (auto arg : {"-O", temp, "-j", threadsArg.c_str()}) argv.push_back(arg);
+    argv.push_back(nullptr);
+
+    const auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        execv(argv[0], const_cast<char* const*>(argv.data()));
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage = {};
+    if (pid > 0) wait4(pid, &status, 0, &usage);
+    ret["seconds"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::filesystem::remove_all(temp, ec);
+#if defined(__APPLE__)
+    const uint64_t peakRSS = usage.ru_maxrss;
+#else
+    const uint64_t peakRSS = uint64_t(usage.ru_maxrss) * 1024;
+#endif
+
+    if (pid < 0) {
+        ret["error"] = "fork failed";
+    } else if (!WIFEXITED(status)) {
+        ret["error"] = "crashed";
+    } else if (WEXITSTATUS(status) == 127) {
+        ret["error"] = "missing";
+    } else {
+        // A few objects of the SDK, such as the crt0 ones, are known not to convert, so the exit code isn't
+        // a failure of the benchmark; the time it took still counts.
+        ret["exitCode"] = WEXITSTATUS(status);
+        ret["peakRSS"] = peakRSS;
+    }
+    return ret;
+}
+
+// Times a kernel, which is run enough times for the result not to be noise.
+template <typename Function>
+double timeKernel(unsigned repeats, Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned repeat = 0; repeat < repeats; repeat++) function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The software GPU's span kernels, against the per-pixel helpers they replace, on a block of 320x256 pixels
+// blended on top of what's there, with the mask bit checked, the slowest way the helpers can go.
+void softSpans(nlohmann::json& results) {
+    using namespace PCSX::SoftGPU;
+    constexpr unsigned c_width = 320;
+    constexpr unsigned c_rows = 256;
+    constexpr unsigned c_repeats = 20;
+
+    SoftRenderer renderer;
+    renderer.m_drawSemiTrans = true;
+    renderer.m_globalTextABR = PCSX::GPU::BlendFunction::FullBackAndFullFront;
+    renderer.m_checkMask = true;
+    renderer.m_setMask32 = 0x80008000;
+    renderer.m_setMask16 = 0x8000;
+    const auto blend = renderer.spanBlend();
+
+    std::mt19937 rng(0x5eed);
+    std::vector<uint16_t> vram(1024 * c_rows);
+    for (auto& pixel : vram) pixel = rng() & 0x7fff;
+    std::vector<uint16_t> colors(c_width);
+    for (auto& color : colors) color = rng() & 0x7fff;
+    std::vector<int16_t> m1(c_width), m2(c_width), m3(c_width);
+    for (unsigned p = 0; p < c_width; p++) {
+        m1[p] = rng() % 256;
+        m2[p] = rng() % 256;
+        m3[p] = rng() % 256;
+    }
+    const Spans::TexturedSpan span = {colors.data(), m1.data(), m2.data(), m3.data()};
+    const uint32_t pair = 0x3def3def;
+
+    auto push = [&](const char* kernel, const char* implementation, double seconds) {
+        results.push_back({{"kernel", kernel}, {"implementation", implementation}, {"seconds", seconds}});
+    };
+    auto rows = [&](auto&& drawRow) {
+        return timeKernel(c_repeats, [&]() {
+            for (unsigned row = 0; row < c_rows; row++) drawRow(&vram[row * 1024]);
+        });
+    };
+
+    push("soft-spans/flat", "getShadeTransCol32", rows([&](uint16_t* dest) {
+             auto dest32 = reinterpret_cast<uint32_t*>(dest);
+             for (unsigned p = 0; p < c_width / 2; p++) renderer.getShadeTransCol32(dest32 + p, pair);
+         }));
+    for (const auto& implementation : Spans::getSupportedFlatSpanImplementations()) {
+        push("soft-spans/flat", implementation.name, rows([&](uint16_t* dest) {
+                 implementation.kernel(reinterpret_cast<uint32_t*>(dest), c_width / 2, pair, blend);
+             }));
+    }
+    push("soft-spans/shaded", "getShadeTransCol", rows([&](uint16_t* dest) {
+             for (unsigned p = 0; p < c_width; p++) renderer.getShadeTransCol(dest + p, colors[p]);
+         }));
+    for (const auto& implementation : Spans::getSupportedShadedSpanImplementations()) {
+        push("soft-spans/shaded", implementation.name,
+             rows([&](uint16_t* dest) { implementation.kernel(dest, c_width, colors.data(), blend); }));
+    }
+    push("soft-spans/textured", "getTextureTransColShadeX", rows([&](uint16_t* dest) {
+             for (unsigned p = 0; p < c_width; p++) {
+                 renderer.getTextureTransColShadeX(dest + p, colors[p], m1[p], m2[p], m3[p]);
+             }
+         }));
+    for (const auto& implementation : Spans::getSupportedTexturedSpanImplementations()) {
+        push("soft-spans/textured", implementation.name,
+             rows([&](uint16_t* dest) { implementation.kernel(dest, c_width, span, blend); }));
+    }
+}
+
+// Neill's reverb, 20000 mix chunks of 45 samples, with random registers and work area, which makes for offsets
+// that wrap past either end of the work area every so often.
+void spuReverbMix(nlohmann::json& results) {
+    constexpr unsigned c_chunk = 45;
+    constexpr unsigned c_chunks = 20000;
+
+    std::mt19937 rng(0x4e11);
+    PCSX::SPU::REVERBInfo initial = {};
+    auto coef = [&]() -> int { return (int16_t)rng(); };
+    auto offset = [&]() -> int { return rng() % 0x2000; };
+    auto signedOffset = [&]() -> int { return (int)(rng() % 0x2000) - 0x1000; };
+    initial.StartAddr = 0x30000;
+    initial.CurrAddr = initial.StartAddr;
+    initial.VolLeft = initial.VolRight = 0x3fff;
+    initial.FB_SRC_A = offset();
+    initial.FB_SRC_B = signedOffset();
+    initial.IIR_ALPHA = coef();
+    initial.ACC_COEF_A = coef();
+    initial.ACC_COEF_B = coef();
+    initial.ACC_COEF_C = coef();
+    initial.ACC_COEF_D = coef();
+    initial.IIR_COEF = coef();
+    initial.FB_ALPHA = coef();
+    initial.FB_X = coef();
+    for (auto address : {&initial.IIR_DEST_A0, &initial.IIR_DEST_A1, &initial.ACC_SRC_A0, &initial.ACC_SRC_A1,
+                         &initial.ACC_SRC_B0, &initial.ACC_SRC_B1, &initial.IIR_SRC_A0, &initial.IIR_SRC_A1,
+                         &initial.IIR_DEST_B0, &initial.IIR_DEST_B1, &initial.ACC_SRC_C0, &initial.ACC_SRC_C1,
+                         &initial.ACC_SRC_D0, &initial.ACC_SRC_D1, &initial.IIR_SRC_B1, &initial.IIR_SRC_B0,
+                         &initial.MIX_DEST_A1, &initial.MIX_DEST_B0}) {
+        *address = offset();
+    }
+    initial.MIX_DEST_A0 = signedOffset();
+    initial.MIX_DEST_B1 = signedOffset();
+    initial.IN_COEF_L = coef();
+    initial.IN_COEF_R = coef();
+
+    std::vector<int16_t> workArea(256 * 1024);
+    for (auto& sample : workArea) sample = (int16_t)rng();
+    std::vector<int> input(c_chunk * 2);
+    for (auto& sample : input) sample = (int16_t)rng();
+    std::vector<int> sumL(c_chunk), sumR(c_chunk);
+
+    for (const auto& implementation : PCSX::SPU::ReverbMix::getSupportedMixImplementations()) {
+        PCSX::SPU::REVERBInfo rvb = initial;
+        int counter = 0;
+        const double seconds = timeKernel(c_chunks, [&]() {
+            implementation.kernel(rvb, workArea.data(), counter, true, input.data(), c_chunk, sumL.data(),
+                                  sumR.data());
+        });
+        results.push_back(
+            {{"kernel", "spu-reverb-mix"}, {"implementation", implementation.name}, {"seconds", seconds}});
+    }
+}
+
+// The EDC and ECC of a full 74 minutes disc worth of mode 2 form 1 sectors, cycling through a few random ones.
+void edcEcc(nlohmann::json& results) {
+    constexpr unsigned c_sectorSize = 2352;
+    constexpr unsigned c_sectors = 74 * 60 * 75;
+    constexpr unsigned c_distinct = 64;
+
+    std::mt19937 rng(0x74);
+    std::vector<uint8_t> sectors(c_distinct * c_sectorSize);
+    for (unsigned i = 0; i < c_distinct; i++) {
+        uint8_t* sector = sectors.data() + i * c_sectorSize;
+        for (unsigned j = 0; j < c_sectorSize; j++) sector[j] = rng();
+        static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+        memcpy(sector, c_sync, sizeof(c_sync));
+        sector[15] = 2;
+        sector[18] &= ~0x20;
+        memcpy(sector + 20, sector + 16, 4);
+    }
+
+    auto run = [&](const char* implementation, void (*compute)(uint8_t*)) {
+        unsigned i = 0;
+        const double seconds =
+            timeKernel(c_sectors, [&]() { compute(sectors.data() + (i++ % c_distinct) * c_sectorSize); });
+        results.push_back({{"kernel", "edc-ecc"}, {"implementation", implementation}, {"seconds", seconds}});
+    };
+    run("compute_edcecc", compute_edcecc);
+    run("IEC60908b::computeEDCECC", PCSX::IEC60908b::computeEDCECC);
+}
+
+// The hash tables, filled with 100000 sparse 32 bits keys, like addresses, and then looked up 2 million times, with
+// half of the lookups hitting.
+void hashTables(nlohmann::json& results) {
+    constexpr unsigned c_keys = 100000;
+    constexpr unsigned c_lookups = 2000000;
+    std::mt19937 rng(0x5a15);
+    std::vector<uint32_t> keys(c_keys), lookups(c_lookups);
+    for (auto& key : keys) key = rng() & ~3;
+    for (auto& lookup : lookups) lookup = (rng() & 1) ? keys[rng() % c_keys] : rng() | 1;
+
+    auto run = [&](const char* implementation, auto&& insert, auto&& find) {
+        const double insertSeconds = timeKernel(1, [&]() {
+            for (auto key : keys) insert(key);
+        });
+        unsigned found = 0;
+        const double findSeconds = timeKernel(1, [&]() {
+            for (auto lookup : lookups) found += find(lookup);
+        });
+        results.push_back(
+            {{"kernel", "hashtable/insert"}, {"implementation", implementation}, {"seconds", insertSeconds}});
+        results.push_back({{"kernel", "hashtable/find"},
+                           {"implementation", implementation},
+                           {"seconds", findSeconds},
+                           {"found", found}});
+    };
+
+    struct Element;
+    typedef PCSX::Intrusive::HashTable<uint32_t, Element> IntrusiveType;
+    struct Element : public IntrusiveType::Node {};
+    IntrusiveType intrusive;
+    std::vector<std::unique_ptr<Element>> elements;
+    run(
+        "Intrusive::HashTable",
+        [&](uint32_t key) {
+            elements.emplace_back(new Element());
+            intrusive.insert(key, elements.back().get());
+        },
+        [&](uint32_t key) { return intrusive.find(key) != intrusive.end(); });
+
+    std::unordered_map<uint32_t, uint32_t> map;
+    run(
+        "std::unordered_map", [&](uint32_t key) { map[key] = key; },
+        [&](uint32_t key) { return map.find(key) != map.end(); });
+
+    PCSX::FlatHashTable<uint32_t, uint32_t> flat;
+    run(
+        "FlatHashTable", [&](uint32_t key) { flat[key] = key; },
+        [&](uint32_t key) { return flat.find(key) != flat.end(); });
+}
+
+// The hashes, over 64MB of random data. MD5 and SHA1 hash it as four buffers, one at a time and then all at once.
+void hashing(nlohmann::json& results) {
+    std::mt19937 rng(0x4a5e);
+    std::string data(64 * 1024 * 1024, 0);
+    for (auto& c : data) c = rng();
+    std::vector<std::string_view> inputs;
+    const size_t quarter = data.size() / 4;
+    for (unsigned i = 0; i < 4; i++) inputs.push_back(std::string_view(data).substr(i * quarter, quarter));
+
+    auto push = [&](const char* kernel, const char* implementation, double seconds) {
+        results.push_back({{"kernel", kernel}, {"implementation", implementation}, {"seconds", seconds}});
+    };
+    push("hashing/crc32", "zlib", timeKernel(1, [&]() {
+             crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size());
+         }));
+    push("hashing/crc32", "Hashing::crc32",
+         timeKernel(1, [&]() { PCSX::Hashing::crc32(0, data.data(), data.size()); }));
+    push("hashing/xxh64", "Hashing::xxh64", timeKernel(1, [&]() { PCSX::Hashing::xxh64(data.data(), data.size()); }));
+
+    std::vector<PCSX::Hashing::MD5Digest> md5s(4);
+    push("hashing/md5", "MD5", timeKernel(1, [&]() {
+             for (unsigned i = 0; i < 4; i++) {
+                 PCSX::MD5 md5;
+                 md5.update(inputs[i].data(), inputs[i].size());
+                 md5.finish(md5s[i].data());
+             }
+         }));
+    push("hashing/md5", "Hashing::md5", timeKernel(1, [&]() { PCSX::Hashing::md5(inputs, md5s); }));
+    std::vector<PCSX::Hashing::SHA1Digest> sha1s(4);
+    push("hashing/sha1", "SHA1", timeKernel(1, [&]() {
+             for (unsigned i = 0; i < 4; i++) {
+                 PCSX::SHA1 sha1;
+                 sha1.update(inputs[i].data(), inputs[i].size());
+                 sha1.finish(sha1s[i].data());
+             }
+         }));
+    push("hashing/sha1", "Hashing::sha1", timeKernel(1, [&]() { PCSX::Hashing::sha1(inputs, sha1s); }));
+}
+
+struct Kernel {
+    const char* name;
+    void (*run)(nlohmann::json& results);
+};
+
+// The hot loops which come in several flavours, timed against each other. They don't need the emulator, so they
+// run in this process, and only report how long each implementation took.
+constexpr Kernel c_kernels[] = {
+    {"kernels/soft-spans", softSpans},
+    {"kernels/spu-reverb-mix", spuReverbMix},
+    {"kernels/edc-ecc", edcEcc},
+    {"kernels/hashtable", hashTables},
+    {"kernels/hashing", hashing},
+};
+
+}  // namespace
+
+// pcsx-redux-bench [-commit <id>] [-capture <file>]... [-iterations <count>] [-psyq <sdk>] [workload...]
+// Only the workloads whose name contains one of the arguments get run, if there are any. GPU captures get
+// replayed this many times each, and then the workloads only run when asked for by name. A PsyQ SDK directory
+// gets converted by psyq-obj-parser on one thread, and then on all of them, on top of the rest. The kernels get
+// selected the same way as the workloads.
+int main(int argc, char** argv) {
+    nlohmann::json output = nlohmann::json::object();
+    std::vector<std::string> filters;
+    std::vector<std::string> captures;
+    std::string iterations = "10";
+    std::optional<std::string> psyq;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-commit") == 0) && ((i + 1) < argc)) {
+            output["commit"] = argv[++i];
+        } else if ((strcmp(argv[i], "-capture") == 0) && ((i + 1) < argc)) {
+            captures.push_back(argv[++i]);
+        } else if ((strcmp(argv[i], "-iterations") == 0) && ((i + 1) < argc)) {
+            iterations = argv[++i];
+        } else if ((strcmp(argv[i], "-psyq") == 0) && ((i + 1) < argc)) {
+            psyq = argv[++i];
+        } else {
+            filters.push_back(argv[i]);
+        }
+    }
+
+    nlohmann::json results = nlohmann::json::array();
+    bool failed = false;
+    for (const auto& capture : captures) {
+        for (bool whole : {false, true}) {
+            auto result = replay(capture, iterations, whole);
+            failed = failed || result.contains("error") || (result["exitCode"] != 0);
+            results.push_back(std::move(result));
+        }
+    }
+    for (const auto& workload : c_workloads) {
+        bool selected = filters.empty() && captures.empty();
+        for (const auto& filter : filters) selected = selected || strstr(workload.name, filter.c_str());
+        if (!selected) continue;
+        if (access(MainInvoker::findPath(workload.exe).c_str(), R_OK) != 0) {
+            results.push_back({{"workload", workload.name}, {"error", "missing"}});
+            continue;
+        }
+        for (auto core : c_cores) {
+            auto result = run(workload, core);
+            failed = failed || result.contains("error") || (result["exitCode"] != 0);
+            results.push_back(std::move(result));
+        }
+    }
+    for (const auto& kernel : c_kernels) {
+        bool selected = filters.empty() && captures.empty();
+        for (const auto& filter : filters) selected = selected || strstr(kernel.name, filter.c_str());
+        if (selected) kernel.run(results);
+    }
+    if (psyq.has_value()) {
+        for (unsigned threads : {1u, std::max(std::thread::hardware_concurrency(), 1u)}) {
+            auto result = convertPsyq(psyq.value(), threads);
+            failed = failed || result.contains("error");
+            results.push_back(std::move(result));
+        }
+    }
+    output["results"] = std::move(results);
+    printf("%s\n", output.dump(4).c_str());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,402 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+// Runs the jobs a coordinator hands out over HTTP, a few at a time, and sends each result back as soon as its job
+// is over. Any server answering these can be the coordinator:
+//
+//   GET /jobs?node=<name>&count=<n>   {"jobs": [<job>...], "done": <bool>}, with at most n jobs
+//   POST /results                     one result, as JSON
+//
+// A job is {"id", "exe" or "iso", and optionally "bios", "lua", "core", "frames", "hashes"}. The paths are as
+// seen from the node. "core" is either "interpreter", the default, or "dynarec". "frames" ends the run after that
+// many frames, and "hashes" can hold the "ram" and "vram" xxh64 expected at the end of the run, in hex.
+//
+// The nodes only ask for as many jobs as they have idle workers, and ask again as soon as one frees up, so the
+// jobs wait on the coordinator until a worker is idle somewhere. A fast node ends up taking the jobs a slow one
+// would have queued, and none of them sits on work it can't get to yet.
+//
+// Each job gets its own process, the way the benchmarks do, so that a crash only loses that job.
+
+#include <llhttp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <uv.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+#include "main/main.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One request at a time, on a loop of its own, which only runs while waiting for the answer.
+class Coordinator {
+  public:
+    Coordinator(std::string host, std::string port) : m_host(std::move(host)), m_port(std::move(port)) {
+        uv_loop_init(&m_loop);
+    }
+    ~Coordinator() { uv_loop_close(&m_loop); }
+
+    // Returns the status code of the answer, or 0 if there wasn't any.
+    int request(const char* method, const std::string& path, const std::string& body, std::string& response) {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        uv_getaddrinfo_t resolver;
+        if (uv_getaddrinfo(&m_loop, &resolver, nullptr, m_host.c_str(), m_port.c_str(), &hints) != 0) return 0;
+
+        Exchange exchange;
+        exchange.request = std::string(method) + " " + path + " HTTP/1.1\r\nHost: " + m_host +
+                           "\r\nConnection: close\r\nContent-Type: application/json\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\n\r\n" + body;
+        uv_tcp_init(&m_loop, &exchange.tcp);
+        uv_timer_init(&m_loop, &exchange.timer);
+        exchange.tcp.data = exchange.timer.data = exchange.connect.data = exchange.write.data = &exchange;
+        exchange.parser.data = &exchange;
+        uv_timer_start(&exchange.timer, [](uv_timer_t* timer) { static_cast<Exchange*>(timer->data)->close(); },
+                       c_timeout, 0);
+        const int error = uv_tcp_connect(&exchange.connect, &exchange.tcp, resolver.addrinfo->ai_addr,
+                                         [](uv_connect_t* connect, int status) {
+                                             auto exchange = static_cast<Exchange*>(connect->data);
+                                             status < 0 ? exchange->close() : exchange->start();
+                                         });
+        uv_freeaddrinfo(resolver.addrinfo);
+        if (error) exchange.close();
+        uv_run(&m_loop, UV_RUN_DEFAULT);
+        response = std::move(exchange.body);
+        return exchange.complete ? exchange.status : 0;
+    }
+
+  private:
+    static constexpr uint64_t c_timeout = 30000;
+
+    struct Exchange {
+        Exchange() {
+            llhttp_settings_init(&settings);
+            settings.on_body = [](llhttp_t* parser, const char* data, size_t size) {
+                static_cast<Exchange*>(parser->data)->body.append(data, size);
+                return 0;
+            };
+            settings.on_message_complete = [](llhttp_t* parser) {
+                auto exchange = static_cast<Exchange*>(parser->data);
+                exchange->complete = true;
+                exchange->status = parser->status_code;
+                exchange->close();
+                return 0;
+            };
+            llhttp_init(&parser, HTTP_RESPONSE, &settings);
+        }
+        void start() {
+            uv_buf_t buf = uv_buf_init(request.data(), request.size());
+            uv_write(&write, reinterpret_cast<uv_stream_t*>(&tcp), &buf, 1, [](uv_write_t* req, int status) {
+                if (status < 0) static_cast<Exchange*>(req->data)->close();
+            });
+            uv_read_start(
+                reinterpret_cast<uv_stream_t*>(&tcp),
+                [](uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf) {
+                    auto exchange = static_cast<Exchange*>(handle->data);
+                    *buf = uv_buf_init(exchange->buffer, sizeof(exchange->buffer));
+                },
+                [](uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+                    auto exchange = static_cast<Exchange*>(stream->data);
+                    if (nread > 0) {
+                        if (llhttp_execute(&exchange->parser, buf->base, nread) != HPE_OK) exchange->close();
+                    } else if (nread < 0) {
+                        // Without a length, the body goes on until the connection closes
+                        llhttp_finish(&exchange->parser);
+                        exchange->close();
+                    }
+                });
+        }
+        void close() {
+            if (closed) return;
+            closed = true;
+            uv_close(reinterpret_cast<uv_handle_t*>(&tcp), nullptr);
+            uv_close(reinterpret_cast<uv_handle_t*>(&timer), nullptr);
+        }
+
+        uv_tcp_t tcp;
+        uv_timer_t timer;
+        uv_connect_t connect;
+        uv_write_t write;
+        llhttp_settings_t settings;
+        llhttp_t parser;
+        std::string request;
+        std::string body;
+        char buffer[16384];
+        int status = 0;
+        bool complete = false;
+        bool closed = false;
+    };
+
+    uv_loop_t m_loop;
+    const std::string m_host;
+    const std::string m_port;
+};
+
+struct Result {
+    int exitCode = -1;
+    uint64_t cycles = 0;
+    uint64_t frames = 0;
+    uint64_t ramHash = 0;
+    uint64_t vramHash = 0;
+    double seconds = 0;
+};
+
+struct Running {
+    nlohmann::json job;
+    int fd;
+    Clock::time_point start;
+    bool timedOut = false;
+};
+
+std::string hex(uint64_t value) {
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)value);
+    return buffer;
+}
+
+std::vector<std::string> jobArguments(const nlohmann::json& job) {
+    std::vector<std::string> args = {"-no-ui", "-unthrottled", "-run", "-testmode"};
+    args.push_back("-bios");
+    args.push_back(job.value("bios", "src/mips/openbios/openbios.bin"));
+    args.push_back("-" + job.value("core", std::string("interpreter")));
+    if (job.contains("exe")) {
+        args.push_back("-loadexe");
+        args.push_back(job["exe"].get<std::string>());
+    } else {
+        args.push_back("-iso");
+        args.push_back(job.value("iso", ""));
+    }
+    if (job.contains("lua")) {
+        args.push_back("-dofile");
+        args.push_back(job["lua"].get<std::string>());
+    }
+    if (job.value("frames", 0) > 0) {
+        args.push_back("-frames");
+        args.push_back(std::to_string(job["frames"].get<int>()));
+    }
+    return args;
+}
+
+// The other jobs' pipes are left behind in the child, for them to be closed once their children exit.
+pid_t launch(const nlohmann::json& job, const std::map<pid_t, Running>& running, int& fd) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (const auto& [other, run] : running) close(run.fd);
+        close(fds[0]);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+        MainInvoker invoker(jobArguments(job));
+        MainStats stats;
+        Result result;
+        const auto start = Clock::now();
+        result.exitCode = invoker.invoke(&stats);
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.cycles = stats.cycles;
+        result.frames = stats.frames;
+        result.ramHash = stats.ramHash;
+        result.vramHash = stats.vramHash;
+        write(fds[1], &result, sizeof(result));
+        close(fds[1]);
+        fflush(nullptr);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return -1;
+    }
+    fd = fds[0];
+    return pid;
+}
+
+nlohmann::json collect(const std::string& node, Running& run, const struct rusage& usage) {
+    nlohmann::json ret = {{"node", node}, {"id", run.job.value("id", "")}};
+    Result result;
+    const bool gotResult = read(run.fd, &result, sizeof(result)) == sizeof(result);
+    close(run.fd);
+#if defined(__APPLE__)
+    ret["peakRSS"] = uint64_t(usage.ru_maxrss);
+#else
+    ret["peakRSS"] = uint64_t(usage.ru_maxrss) * 1024;
+#endif
+    if (run.timedOut || !gotResult) {
+        ret["error"] = run.timedOut ? "timeout" : "crashed";
+        ret["passed"] = false;
+        return ret;
+    }
+    ret["exitCode"] = result.exitCode;
+    ret["seconds"] = result.seconds;
+    ret["cycles"] = result.cycles;
+    ret["frames"] = result.frames;
+    ret["hashes"] = {{"ram", hex(result.ramHash)}, {"vram", hex(result.vramHash)}};
+    bool passed = result.exitCode == 0;
+    nlohmann::json mismatches = nlohmann::json::array();
+    if (run.job.contains("hashes")) {
+        for (auto& [name, expected] : run.job["hashes"].items()) {
+            std::string wanted = expected.get<std::string>();
+            std::transform(wanted.begin(), wanted.end(), wanted.begin(), ::tolower);
+            if (!ret["hashes"].contains(name) || (ret["hashes"][name] != wanted)) mismatches.push_back(name);
+        }
+    }
+    if (!mismatches.empty()) {
+        ret["mismatches"] = std::move(mismatches);
+        passed = false;
+    }
+    ret["passed"] = passed;
+    return ret;
+}
+
+std::atomic_bool s_stopping = false;
+
+}  // namespace
+
+// pcsx-redux-farm -coordinator <host:port> [-workers <count>] [-node <name>] [-timeout <seconds>] [-poll <seconds>]
+// Keeps running jobs until the coordinator says it's done, or until interrupted, which kills the jobs still
+// running and reports them as aborted.
+int main(int argc, char** argv) {
+    std::string coordinator;
+    unsigned workers = std::max(std::thread::hardware_concurrency(), 1u);
+    std::string node;
+    int timeout = 600;
+    int poll = 5;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-coordinator") == 0) && ((i + 1) < argc)) {
+            coordinator = argv[++i];
+        } else if ((strcmp(argv[i], "-workers") == 0) && ((i + 1) < argc)) {
+            workers = std::max(atoi(argv[++i]), 1);
+        } else if ((strcmp(argv[i], "-node") == 0) && ((i + 1) < argc)) {
+            node = argv[++i];
+        } else if ((strcmp(argv[i], "-timeout") == 0) && ((i + 1) < argc)) {
+            timeout = std::max(atoi(argv[++i]), 1);
+        } else if ((strcmp(argv[i], "-poll") == 0) && ((i + 1) < argc)) {
+            poll = std::max(atoi(argv[++i]), 1);
+        }
+    }
+    const auto colon = coordinator.rfind(':');
+    if (colon == std::string::npos) {
+        fprintf(stderr, "Usage: %s -coordinator <host:port> [-workers <count>] [-node <name>]\n", argv[0]);
+        return 1;
+    }
+    if (node.empty()) {
+        char hostname[256] = {};
+        gethostname(hostname, sizeof(hostname) - 1);
+        node = std::string(hostname) + "-" + std::to_string(getpid());
+    }
+    Coordinator http(coordinator.substr(0, colon), coordinator.substr(colon + 1));
+    signal(SIGINT, [](int) { s_stopping = true; });
+    signal(SIGTERM, [](int) { s_stopping = true; });
+    signal(SIGPIPE, SIG_IGN);
+
+    std::map<pid_t, Running> running;
+    // The results the coordinator didn't take yet, sent again until it does.
+    std::vector<std::string> unsent;
+    auto flush = [&]() {
+        while (!unsent.empty()) {
+            std::string response;
+            const int status = http.request("POST", "/results", unsent.front(), response);
+            if ((status < 200) || (status >= 300)) return;
+            unsent.erase(unsent.begin());
+        }
+    };
+
+    bool done = false;
+    unsigned failures = 0;
+    auto nextPoll = Clock::now();
+    while (!s_stopping) {
+        if (!done && (running.size() < workers) && (Clock::now() >= nextPoll)) {
+            std::string response;
+            const auto count = std::to_string(workers - running.size());
+            const int status = http.request("GET", "/jobs?node=" + node + "&count=" + count, "", response);
+            auto answer = nlohmann::json::parse(response, nullptr, false);
+            if ((status != 200) || !answer.is_object()) {
+                fprintf(stderr, "Couldn't get jobs from %s (status %i)\n", coordinator.c_str(), status);
+                failures++;
+                nextPoll = Clock::now() + std::chrono::seconds(poll * std::min(failures, 12u));
+            } else {
+                failures = 0;
+                done = answer.value("done", false);
+                auto& jobs = answer["jobs"];
+                if (!jobs.is_array() || jobs.empty()) nextPoll = Clock::now() + std::chrono::seconds(poll);
+                if (jobs.is_array()) {
+                    for (auto& job : jobs) {
+                        int fd = -1;
+                        const pid_t pid = launch(job, running, fd);
+                        if (pid < 0) {
+                            unsent.push_back(nlohmann::json({{"node", node},
+                                                             {"id", job.value("id", "")},
+                                                             {"error", "fork failed"},
+                                                             {"passed", false}})
+                                                 .dump());
+                            continue;
+                        }
+                        running.emplace(pid, Running{std::move(job), fd, Clock::now()});
+                    }
+                }
+            }
+        }
+        if (running.empty() && done) break;
+
+        int status = 0;
+        struct rusage usage = {};
+        pid_t pid;
+        while ((pid = wait4(-1, &status, WNOHANG, &usage)) > 0) {
+            auto run = running.find(pid);
+            if (run == running.end()) continue;
+            auto result = collect(node, run->second, usage);
+            fprintf(stderr, "%s: %s\n", result["id"].dump().c_str(), result.value("passed", false) ? "passed" : "failed");
+            unsent.push_back(result.dump());
+            running.erase(run);
+        }
+        const auto now = Clock::now();
+        for (auto& [pid, run] : running) {
+            if (run.timedOut || (now - run.start < std::chrono::seconds(timeout))) continue;
+            run.timedOut = true;
+            kill(pid, SIGKILL);
+        }
+        flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    for (auto& [pid, run] : running) {
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        close(run.fd);
+        unsent.push_back(
+            nlohmann::json({{"node", node}, {"id", run.job.value("id", "")}, {"error", "aborted"}, {"passed", false}})
+                .dump());
+    }
+    flush();
+    if (!unsent.empty()) fprintf(stderr, "%zu results couldn't be sent to the coordinator\n", unsent.size());
+    return unsent.empty() ? 0 : 1;
+}
@@ -147,3 +147,59 @@ function TestAdpcm:test_simpleXA()
     end
     file:close()
 end
+
+function TestAdpcm:test_streamSPU()
+    local sampleRate = 44100
+    local duration = 1
+    local samples, size = generateDTMF1(sampleRate, duration)
+    local blockCount = size / 28
+    local input = Support.NewLuaBuffer(size * 2)
+    ffi.copy(input.data, samples, size * 2)
+
+    local e = PCSX.Adpcm.NewEncoder()
+    e:reset 'Normal'
+    local ptr = ffi.cast('int16_t *', samples)
+    local expected = {}
+    local out = Support.NewLuaBuffer(16)
+    for i = 1, blockCount do
+        e:processSPUBlock(ptr, out, i == blockCount and 'OneShotEnd' or 'OneShot')
+        ptr = ptr + 28
+        expected[i] = ffi.string(out.data, 16)
+    end
+
+    -- Without chunking, the output is the same as the one of a single encoder
+    local stream = PCSX.Adpcm.encodeSPUStream(input, false, 'Normal', { chunkBlocks = 0 })
+    lu.assertEquals(#stream, blockCount * 16)
+    for i = 1, blockCount do
+        lu.assertEquals(ffi.string(stream.data + (i - 1) * 16, 16), expected[i])
+    end
+
+    -- With it, the output doesn't depend on the number of threads
+    local chunked = PCSX.Adpcm.encodeSPUStream(input, false, 'Normal', { chunkBlocks = 100, threads = 1 })
+    local threaded = PCSX.Adpcm.encodeSPUStream(input, false, 'Normal', { chunkBlocks = 100, threads = 4 })
+    lu.assertEquals(#chunked, blockCount * 16)
+    lu.assertEquals(ffi.string(chunked.data, #chunked), ffi.string(threaded.data, #threaded))
+    -- and the first chunk has nothing to warm up from
+    lu.assertEquals(ffi.string(chunked.data, 100 * 16), table.concat(expected, '', 1, 100))
+end
+
+function TestAdpcm:test_streamXA()
+    local sampleRate = 37800
+    local duration = 2
+    local samples, size = generateDTMFStereo(sampleRate, duration)
+    local blockCount = size / 112
+    local input = Support.NewLuaBuffer(size * 4)
+    ffi.copy(input.data, samples, size * 4)
+
+    local e = PCSX.Adpcm.NewEncoder()
+    e:reset 'XA'
+    local ptr = ffi.cast('int16_t *', samples)
+    local out = Support.NewLuaBuffer(128)
+    local stream = PCSX.Adpcm.encodeXAStream(input, 'XAFourBits', 2, { chunkBlocks = 0 })
+    lu.assertEquals(#stream, blockCount * 128)
+    for i = 1, blockCount do
+        e:processXABlock(ptr, out, 'XAFourBits', 2)
+        ptr = ptr + 112 * 2
+        lu.assertEquals(ffi.string(stream.data + (i - 1) * 128, 128), ffi.string(out.data, 128))
+    end
+end
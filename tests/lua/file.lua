@@ -15,6 +15,7 @@
 --   Free Software Foundation, Inc.,
 --   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+local ffi = require 'ffi'
 local lu = require 'luaunit'
 
 TestFile = {}
@@ -28,3 +29,20 @@ function TestFile:test_buffer()
     local r = buf:read(buf:size())
     lu.assertEquals(tostring(r), 'hello world')
 end
+
+function TestFile:test_view()
+    local src = ffi.new('uint8_t[?]', 11)
+    ffi.copy(src, 'hello world', 11)
+    local buf = Support.File.buffer(src, 11, 'READ')
+    local view = buf:view()
+    lu.assertEquals(view.size, 11)
+    lu.assertEquals(view[4], string.byte('o'))
+    lu.assertEquals(view:find('world'), 6)
+    lu.assertNil(view:find('planet'))
+    local sub = view:sub(6, 3)
+    lu.assertEquals(tostring(sub), 'wor')
+    lu.assertEquals(view:string(0, 5), 'hello')
+    local rw = Support.File.buffer()
+    rw:write('hello')
+    lu.assertNil(rw:view())
+end
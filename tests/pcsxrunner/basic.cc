@@ -17,6 +17,9 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "main/main.h"
 
@@ -32,4 +35,37 @@ TEST(Basic, Dynarec) {
                         "-luacov", "-loadexe", "src/mips/tests/basic/basic.ps-exe");
     int ret = invoker.invoke();
     EXPECT_EQ(ret, 0);
-}
\ No newline at end of file
+}
+
+// The emulators all live in the same process, each one on a thread of its own. Half of them ask for the dynarec:
+// whichever gets to the code cache first runs with it, and the others fall back to the interpreter.
+TEST(Basic, ConcurrentInstances) {
+    constexpr unsigned c_instances = 4;
+    std::vector<int> results(c_instances, -1);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < c_instances; i++) {
+        threads.emplace_back([&results, i]() {
+            MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode",
+                                (i & 1) ? "-interpreter" : "-dynarec", "-loadexe",
+                                "src/mips/tests/basic/basic.ps-exe");
+            results[i] = invoker.invoke();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (auto result : results) EXPECT_EQ(result, 0);
+}
+
+// Once its owner is gone, the code cache is up for grabs again.
+TEST(Basic, DynarecAfterConcurrentInstances) {
+    MainStats first, second;
+    std::thread thread([&first]() {
+        MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-dynarec",
+                            "-loadexe", "src/mips/tests/basic/basic.ps-exe");
+        EXPECT_EQ(invoker.invoke(&first), 0);
+    });
+    thread.join();
+    MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-dynarec",
+                        "-loadexe", "src/mips/tests/basic/basic.ps-exe");
+    EXPECT_EQ(invoker.invoke(&second), 0);
+    EXPECT_EQ(first.dynarec, second.dynarec);
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+#include "cdrom/blockcache.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr unsigned c_blockSize = 256;
+constexpr unsigned c_blocks = 200;
+
+void fillBlock(uint32_t block, uint8_t* data) {
+    for (unsigned i = 0; i < c_blockSize; i++) data[i] = block * 13 + i;
+}
+
+bool checkRange(uint32_t block, unsigned offset, const uint8_t* data, unsigned size) {
+    uint8_t expected[c_blockSize];
+    fillBlock(block, expected);
+    return memcmp(expected + offset, data, size) == 0;
+}
+
+}  // namespace
+
+TEST(BlockCache, Sequential) {
+    std::atomic<unsigned> decodes = 0;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    PCSX::BlockCache cache(
+        c_blockSize, c_blocks,
+        [&]() -> PCSX::BlockCache::Decoder {
+            // Each decoder is only ever used by one thread
+            auto owner = std::make_shared<std::thread::id>();
+            return [&, owner](uint32_t block, uint8_t* data) {
+                if (*owner == std::thread::id()) *owner = std::this_thread::get_id();
+                EXPECT_EQ(*owner, std::this_thread::get_id());
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+                decodes++;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                fillBlock(block, data);
+                return true;
+            };
+        },
+        3);
+
+    uint8_t data[64];
+    for (uint32_t block = 0; block < c_blocks; block++) {
+        for (unsigned offset = 0; offset < c_blockSize; offset += sizeof(data)) {
+            ASSERT_TRUE(cache.read(block, offset, data, sizeof(data)));
+            ASSERT_TRUE(checkRange(block, offset, data, sizeof(data))) << block << " " << offset;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_EQ(cache.hits() + cache.misses(), c_blocks * c_blockSize / sizeof(data));
+    EXPECT_GE(cache.misses(), 1);
+    // Only the first read of each block could have missed
+    EXPECT_LE(cache.misses(), c_blocks);
+    EXPECT_LE(decodes.load(), c_blocks);
+    EXPECT_GT(threads.size(), 1);
+    EXPECT_FALSE(cache.read(c_blocks, 0, data, sizeof(data)));
+    EXPECT_FALSE(cache.read(0, c_blockSize - 8, data, sizeof(data)));
+}
+
+TEST(BlockCache, SeeksAndFailures) {
+    PCSX::BlockCache cache(
+        c_blockSize, c_blocks,
+        []() -> PCSX::BlockCache::Decoder {
+            return [](uint32_t block, uint8_t* data) {
+                fillBlock(block, data);
+                return (block % 10) != 7;
+            };
+        },
+        2);
+
+    std::mt19937 rng(0xb10c);
+    uint8_t data[c_blockSize];
+    for (unsigned i = 0; i < 2000; i++) {
+        const uint32_t block = (rng() % 4) ? rng() % c_blocks : (i % c_blocks);
+        const unsigned offset = rng() % c_blockSize;
+        const unsigned size = rng() % (c_blockSize - offset) + 1;
+        const bool success = cache.read(block, offset, data, size);
+        ASSERT_EQ(success, (block % 10) != 7) << block;
+        if (success) ASSERT_TRUE(checkRange(block, offset, data, size)) << block;
+    }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/bpcondition.h"
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+uint8_t s_memory[0x100];
+
+const uint8_t* memory(uint32_t address) {
+    address &= 0x1fffffff;
+    if (address >= sizeof(s_memory)) return nullptr;
+    return s_memory + address;
+}
+
+struct Condition {
+    Condition() {
+        for (unsigned i = 0; i < 34; i++) registers[i] = i * 0x10;
+        for (unsigned i = 0; i < sizeof(s_memory); i++) s_memory[i] = i;
+        context.registers = registers;
+        context.pc = 0x80010000;
+        context.address = 0x80000040;
+        context.width = 4;
+        context.hits = 1;
+        context.memory = memory;
+    }
+    bool operator()(const char* expression) {
+        std::string error;
+        auto condition = PCSX::BreakpointCondition::compile(expression, error);
+        EXPECT_NE(condition, nullptr) << expression << ": " << error;
+        if (!condition) return false;
+        return condition->evaluate(context);
+    }
+    uint32_t registers[34];
+    PCSX::BreakpointCondition::Context context;
+};
+
+}  // namespace
+
+TEST(BreakpointCondition, Evaluates) {
+    Condition condition;
+    EXPECT_TRUE(condition("1"));
+    EXPECT_FALSE(condition("0"));
+    EXPECT_TRUE(condition("a0 == 0x40 && r4 == 64"));
+    EXPECT_TRUE(condition("sp == 0x1d0 && ra == 0x1f0 && s8 == fp && lo == 0x200 && hi == 0x210"));
+    EXPECT_TRUE(condition("pc == 0x80010000 && address == 0x80000040 && width == 4"));
+    EXPECT_TRUE(condition("1 + 2 * 3 == 7 && (1 + 2) * 3 == 9 && 7 / 2 == 3 && 7 % 2 == 1 && 1 / 0 == 0"));
+    EXPECT_TRUE(condition("1 << 4 == 16 && 0xff & 0x0f == 15 && (0xf0 | 0x0f) == 0xff && (5 ^ 1) == 4"));
+    EXPECT_TRUE(condition("-1 < 0 && ~0 == -1 && !0 && !!5 && 2 >= 2 && 2 <= 2 && 3 > 2 && 2 != 3"));
+    EXPECT_TRUE(condition("0 || 1") && !condition("0 && 1"));
+}
+
+TEST(BreakpointCondition, ReadsMemory) {
+    Condition condition;
+    EXPECT_TRUE(condition("u8[0x80000010] == 0x10"));
+    EXPECT_TRUE(condition("u16[0x10] == 0x1110"));
+    EXPECT_TRUE(condition("u32[a0] == 0x43424140"));
+    s_memory[0x20] = 0xff;
+    EXPECT_TRUE(condition("s8[0x20] == -1 && u8[0x20] == 255"));
+    // What can't be looked at reads as 0, even partially
+    EXPECT_TRUE(condition("u32[0x1000] == 0 && u32[0xfe] == 0"));
+}
+
+TEST(BreakpointCondition, CountsHits) {
+    Condition condition;
+    std::string error;
+    auto every = PCSX::BreakpointCondition::compile("hits % 3 == 0", error);
+    ASSERT_NE(every, nullptr);
+    unsigned fired = 0;
+    for (condition.context.hits = 1; condition.context.hits <= 9; condition.context.hits++) {
+        if (every->evaluate(condition.context)) fired++;
+    }
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(BreakpointCondition, RejectsBrokenExpressions) {
+    static const char* const c_broken[] = {
+        "", "1 +", "(1", "u8[1", "u8 1", "r32", "foo", "1 = 1", "!= 1", "0x100000000", "12ab", "1 $ 2",
+        "((((((((((((((((((((((((((((((((((1))))))))))))))))))))))))))))))))) + 1",
+    };
+    for (auto expression : c_broken) {
+        std::string error;
+        EXPECT_EQ(PCSX::BreakpointCondition::compile(expression, error), nullptr) << expression;
+        EXPECT_FALSE(error.empty()) << expression;
+    }
+}
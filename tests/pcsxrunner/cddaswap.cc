@@ -0,0 +1,42 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <random>
+
+#include "cdrom/cdriso.h"
+#include "gtest/gtest.h"
+
+TEST(CDDA, SwapEndianness) {
+    std::mt19937 rng(0xcdda);
+    uint8_t original[PCSX::IEC60908b::FRAMESIZE_RAW];
+    for (auto& byte : original) byte = rng();
+    uint8_t sector[PCSX::IEC60908b::FRAMESIZE_RAW];
+    memcpy(sector, original, sizeof(sector));
+
+    PCSX::CDRIso::swapCDDAEndianness(sector);
+    for (unsigned i = 0; i < PCSX::IEC60908b::FRAMESIZE_RAW; i += 2) {
+        ASSERT_EQ(sector[i], original[i + 1]) << i;
+        ASSERT_EQ(sector[i + 1], original[i]) << i;
+    }
+
+    PCSX::CDRIso::swapCDDAEndianness(sector);
+    EXPECT_EQ(memcmp(sector, original, sizeof(sector)), 0);
+}
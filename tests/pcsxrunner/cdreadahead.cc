@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "cdrom/readahead.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr unsigned c_sectorSize = 64;
+
+void fillSector(uint32_t sector, uint8_t* data) {
+    for (unsigned i = 0; i < c_sectorSize; i++) data[i] = sector * 7 + i;
+}
+
+bool checkSector(uint32_t sector, const uint8_t* data) {
+    uint8_t expected[c_sectorSize];
+    fillSector(sector, expected);
+    return memcmp(expected, data, c_sectorSize) == 0;
+}
+
+}  // namespace
+
+TEST(CDReadAhead, Sequential) {
+    std::atomic<unsigned> reads = 0;
+    PCSX::SectorReadAhead readAhead(c_sectorSize, 8, [&reads](uint32_t sector, uint8_t* data) {
+        reads++;
+        fillSector(sector, data);
+        return true;
+    });
+
+    uint8_t data[c_sectorSize];
+    for (uint32_t sector = 100; sector < 1100; sector++) {
+        ASSERT_TRUE(readAhead.read(sector, data));
+        ASSERT_TRUE(checkSector(sector, data)) << sector;
+        // give the worker a chance to keep up, like the emulated drive's pace would
+        if ((sector % 4) == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_EQ(readAhead.hits() + readAhead.misses(), 1000);
+    EXPECT_GE(readAhead.misses(), 1);
+    EXPECT_GT(readAhead.hits(), readAhead.misses());
+    readAhead.stop();
+    // never more than the capacity read past the last sector
+    EXPECT_LE(reads.load(), 1000 + readAhead.misses() + 8);
+
+    readAhead.resetCounters();
+    EXPECT_EQ(readAhead.hits(), 0);
+    EXPECT_EQ(readAhead.misses(), 0);
+}
+
+TEST(CDReadAhead, SeeksAndFailures) {
+    PCSX::SectorReadAhead readAhead(c_sectorSize, 4, [](uint32_t sector, uint8_t* data) {
+        if ((sector % 13) == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        fillSector(sector, data);
+        return (sector % 10) != 0;
+    });
+    readAhead.setDepth(3);
+
+    std::mt19937 rng(0x5ec7);
+    uint32_t sector = 0;
+    uint8_t data[c_sectorSize];
+    for (unsigned i = 0; i < 5000; i++) {
+        if ((rng() % 50) == 0) sector = rng() % 100000;
+        ASSERT_EQ(readAhead.read(sector, data), (sector % 10) != 0) << sector;
+        ASSERT_TRUE(checkSector(sector, data)) << sector;
+        sector++;
+    }
+}
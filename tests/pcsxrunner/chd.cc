@@ -0,0 +1,380 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+#include <zlib.h>
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cdrom/chd.h"
+#include "gtest/gtest.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace {
+
+constexpr unsigned c_framesPerHunk = 4;
+constexpr unsigned c_hunkBytes = c_framesPerHunk * PCSX::CHD::c_frameSize;
+constexpr unsigned c_hunks = 4;
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xffff;
+    while (length--) {
+        crc ^= *data++ << 8;
+        for (unsigned i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+std::vector<uint8_t> deflate(const uint8_t* data, size_t size) {
+    z_stream z = {};
+    deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> out(deflateBound(&z, size));
+    z.next_in = const_cast<uint8_t*>(data);
+    z.avail_in = size;
+    z.next_out = out.data();
+    z.avail_out = out.size();
+    deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+void put(std::vector<uint8_t>& out, size_t offset, uint64_t value, unsigned bytes) {
+    if (out.size() < offset + bytes) out.resize(offset + bytes);
+    for (unsigned i = 0; i < bytes; i++) out[offset + i] = value >> ((bytes - 1 - i) * 8);
+}
+
+class BitWriter {
+  public:
+    void write(uint32_t value, unsigned bits) {
+        for (unsigned i = bits; i-- > 0;) {
+            if ((m_bits % 8) == 0) m_data.push_back(0);
+            if (value & (1u << i)) m_data.back() |= 0x80 >> (m_bits % 8);
+            m_bits++;
+        }
+    }
+    const std::vector<uint8_t>& data() const { return m_data; }
+    unsigned size() const { return m_bits; }
+
+  private:
+    std::vector<uint8_t> m_data;
+    unsigned m_bits = 0;
+};
+
+// Just enough of an LZMA encoder for the decoder to have a stream to go through, with chdman's properties: lc = 3,
+// lp = 0 and pb = 2. Every byte is coded as a literal.
+std::vector<uint8_t> lzmaLiterals(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    uint64_t low = 0;
+    uint32_t range = 0xffffffff;
+    uint8_t cache = 0;
+    uint64_t cacheSize = 1;
+    auto shiftLow = [&]() {
+        if ((uint32_t(low) < 0xff000000) || ((low >> 32) != 0)) {
+            uint8_t temp = cache;
+            do {
+                out.push_back(uint8_t(temp + (low >> 32)));
+                temp = 0xff;
+            } while (--cacheSize != 0);
+            cache = uint8_t(low >> 24);
+        }
+        cacheSize++;
+        low = (low & 0x00ffffff) << 8;
+    };
+    auto encodeBit = [&](uint16_t& prob, unsigned bit) {
+        const uint32_t bound = (range >> 11) * prob;
+        if (bit == 0) {
+            range = bound;
+            prob += (2048 - prob) >> 5;
+        } else {
+            low += bound;
+            range -= bound;
+            prob -= prob >> 5;
+        }
+        while (range < (1 << 24)) {
+            range <<= 8;
+            shiftLow();
+        }
+    };
+
+    // Only literals means staying in state 0, so there are only the is-match bits of the 4 positions to care about
+    std::vector<uint16_t> isMatch(4, 1024);
+    std::vector<uint16_t> literals(0x300 * 8, 1024);
+    for (size_t i = 0; i < size; i++) {
+        encodeBit(isMatch[i & 3], 0);
+        uint16_t* probs = literals.data() + 0x300 * ((i ? data[i - 1] : 0) >> 5);
+        unsigned node = 1;
+        for (int bit = 7; bit >= 0; bit--) {
+            const unsigned b = (data[i] >> bit) & 1;
+            encodeBit(probs[node], b);
+            node = (node << 1) | b;
+        }
+    }
+    for (unsigned i = 0; i < 5; i++) shiftLow();
+    return out;
+}
+
+// One FLAC frame, the way cdfl stores the sectors as big endian stereo samples: the left channel as is, and the side
+// channel through the second order fixed predictor, Rice coded.
+std::vector<uint8_t> flacFrame(const uint8_t* sectors, unsigned samples) {
+    auto crc = [](const std::vector<uint8_t>& data, unsigned bits, uint32_t polynomial) {
+        uint32_t crc = 0;
+        const uint32_t top = 1u << (bits - 1);
+        for (auto byte : data) {
+            crc ^= uint32_t(byte) << (bits - 8);
+            for (unsigned i = 0; i < 8; i++) crc = (crc & top) ? (crc << 1) ^ polynomial : crc << 1;
+            crc &= (1u << bits) - 1;
+        }
+        return crc;
+    };
+    std::vector<int32_t> left(samples), side(samples);
+    for (unsigned i = 0; i < samples; i++) {
+        left[i] = int16_t((sectors[i * 4] << 8) | sectors[i * 4 + 1]);
+        side[i] = left[i] - int16_t((sectors[i * 4 + 2] << 8) | sectors[i * 4 + 3]);
+    }
+
+    BitWriter bits;
+    // Sync code, fixed block size of 16 bits stored at the end, 44.1kHz, left and side, 16 bits, frame 0
+    bits.write(0x3ffe, 14);
+    bits.write(0, 2);
+    bits.write(7, 4);
+    bits.write(9, 4);
+    bits.write(8, 4);
+    bits.write(4, 3);
+    bits.write(0, 1);
+    bits.write(0, 8);
+    bits.write(samples - 1, 16);
+    bits.write(crc(bits.data(), 8, 0x07), 8);
+
+    bits.write(1 << 1, 8);  // Verbatim
+    for (auto sample : left) bits.write(sample & 0xffff, 16);
+    bits.write(10 << 1, 8);  // Fixed, second order
+    for (unsigned i = 0; i < 2; i++) bits.write(side[i] & 0x1ffff, 17);
+    constexpr unsigned c_parameter = 14;
+    bits.write(0, 2);
+    bits.write(0, 4);
+    bits.write(c_parameter, 4);
+    for (unsigned i = 2; i < samples; i++) {
+        const int32_t residual = side[i] - (2 * side[i - 1] - side[i - 2]);
+        const uint32_t folded = residual >= 0 ? residual * 2 : -residual * 2 - 1;
+        for (uint32_t q = folded >> c_parameter; q > 0; q--) bits.write(0, 1);
+        bits.write(1, 1);
+        bits.write(folded & ((1 << c_parameter) - 1), c_parameter);
+    }
+    while (bits.data().size() * 8 != bits.size()) bits.write(0, 1);
+    bits.write(crc(bits.data(), 16, 0x8005), 16);
+    return bits.data();
+}
+
+// A small CD image, made the way chdman would: a data track of 10 frames, padded to 3 hunks, and an audio
+// track of 4 frames whose 150 frames of pregap aren't stored. The first hunk is compressed with a CD codec: with
+// cdzl or cdlz, its first sector, a mode 2 form 1 one, has its sync header and ECC removed, and cdfl takes it all
+// as audio. The second hunk is compressed with zlib or lzma, the third one isn't compressed, and the last one is a
+// copy of the second one.
+struct TestImage {
+    std::vector<uint8_t> file;
+    std::vector<uint8_t> hunks;
+    uint64_t offsets[c_hunks];
+
+    TestImage(const char* firstCodec = "cdzl", const char* secondCodec = "zlib") {
+        std::mt19937 rng(0x0cd);
+        hunks.resize(c_hunks * c_hunkBytes);
+        for (auto& b : hunks) b = rng();
+        uint8_t* sector = hunks.data();
+        memcpy(sector, "\x00\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x00\x00\x02\x00\x02", 16);
+        memcpy(sector + 16, "\x00\x00\x08\x00\x00\x00\x08\x00", 8);
+        PCSX::IEC60908b::computeEDCECC(sector);
+        memcpy(hunks.data() + 3 * c_hunkBytes, hunks.data() + c_hunkBytes, c_hunkBytes);
+
+        std::vector<uint8_t> first;
+        {
+            std::vector<uint8_t> sectors, subcodes;
+            for (unsigned frame = 0; frame < c_framesPerHunk; frame++) {
+                const uint8_t* in = hunks.data() + frame * PCSX::CHD::c_frameSize;
+                sectors.insert(sectors.end(), in, in + PCSX::CHD::c_sectorSize);
+                subcodes.insert(subcodes.end(), in + PCSX::CHD::c_sectorSize, in + PCSX::CHD::c_frameSize);
+            }
+            const auto sub = deflate(subcodes.data(), subcodes.size());
+            if (strcmp(firstCodec, "cdfl") == 0) {
+                first = flacFrame(sectors.data(), sectors.size() / 4);
+            } else {
+                memset(sectors.data(), 0, 12);
+                memset(sectors.data() + 0x81c, 0, PCSX::CHD::c_sectorSize - 0x81c);
+                const auto base = strcmp(firstCodec, "cdlz") == 0 ? lzmaLiterals(sectors.data(), sectors.size())
+                                                                   : deflate(sectors.data(), sectors.size());
+                first.push_back(0x01);
+                put(first, 1, base.size(), 2);
+                first.insert(first.end(), base.begin(), base.end());
+            }
+            first.insert(first.end(), sub.begin(), sub.end());
+        }
+        const auto second = strcmp(secondCodec, "lzma") == 0 ? lzmaLiterals(hunks.data() + c_hunkBytes, c_hunkBytes)
+                                                             : deflate(hunks.data() + c_hunkBytes, c_hunkBytes);
+
+        // The map: every code is 4 bits, which the tree stores as 16 times a length of 4.
+        BitWriter bits;
+        for (unsigned i = 0; i < 16; i++) bits.write(4, 4);
+        const uint8_t types[c_hunks] = {0, 1, 4, 5};
+        for (auto type : types) bits.write(type, 4);
+        const uint64_t firstOffset = 124 + 16 + 256;
+        const uint32_t lengths[c_hunks] = {uint32_t(first.size()), uint32_t(second.size()), c_hunkBytes, 0};
+        std::vector<uint8_t> raw;
+        uint64_t offset = firstOffset;
+        for (unsigned hunk = 0; hunk < c_hunks; hunk++) {
+            const uint16_t crc = types[hunk] == 5 ? 0 : crc16(hunks.data() + hunk * c_hunkBytes, c_hunkBytes);
+            offsets[hunk] = types[hunk] == 5 ? 1 : offset;
+            if (types[hunk] < 4) bits.write(lengths[hunk], 24);
+            if (types[hunk] == 5) {
+                bits.write(1, 8);
+            } else {
+                bits.write(crc, 16);
+            }
+            offset += lengths[hunk];
+            const size_t entry = raw.size();
+            put(raw, entry, types[hunk], 1);
+            put(raw, entry + 1, lengths[hunk], 3);
+            put(raw, entry + 4, offsets[hunk], 6);
+            put(raw, entry + 10, crc, 2);
+        }
+        EXPECT_LE(bits.data().size(), 256u);
+
+        file.resize(124);
+        memcpy(file.data(), "MComprHD", 8);
+        put(file, 8, 124, 4);
+        put(file, 12, 5, 4);
+        for (unsigned i = 0; i < 4; i++) {
+            put(file, 16 + i, firstCodec[i], 1);
+            put(file, 20 + i, secondCodec[i], 1);
+        }
+        put(file, 32, c_hunks * c_hunkBytes, 8);
+        put(file, 40, 124, 8);
+        put(file, 48, offset, 8);
+        put(file, 56, c_hunkBytes, 4);
+        put(file, 60, PCSX::CHD::c_frameSize, 4);
+
+        put(file, 124, bits.data().size(), 4);
+        put(file, 128, firstOffset, 6);
+        put(file, 134, crc16(raw.data(), raw.size()), 2);
+        put(file, 136, 24, 1);
+        put(file, 137, 8, 1);
+        put(file, 138, 0, 1);
+        file.resize(firstOffset);
+        memcpy(file.data() + 140, bits.data().data(), bits.data().size());
+        file.insert(file.end(), first.begin(), first.end());
+        file.insert(file.end(), second.begin(), second.end());
+        file.insert(file.end(), hunks.begin() + 2 * c_hunkBytes, hunks.begin() + 3 * c_hunkBytes);
+
+        const std::string tracks[] = {
+            "TRACK:1 TYPE:MODE1_RAW SUBTYPE:RW_RAW FRAMES:10 PREGAP:0 PGTYPE:MODE1 PGSUB:RW POSTGAP:0",
+            "TRACK:2 TYPE:AUDIO SUBTYPE:NONE FRAMES:4 PREGAP:150 PGTYPE:AUDIO PGSUB:RW POSTGAP:0",
+        };
+        for (unsigned i = 0; i < 2; i++) {
+            const size_t entry = file.size();
+            const size_t length = tracks[i].size() + 1;
+            put(file, entry, 0x43485432, 4);
+            put(file, entry + 4, 1, 1);
+            put(file, entry + 5, length, 3);
+            put(file, entry + 8, i == 0 ? entry + 16 + length : 0, 8);
+            file.insert(file.end(), tracks[i].c_str(), tracks[i].c_str() + length);
+        }
+    }
+
+    PCSX::IO<PCSX::File> open() { return new PCSX::BufferFile(file.data(), file.size()); }
+};
+
+}  // namespace
+
+TEST(CHD, Tracks) {
+    TestImage image;
+    PCSX::CHD chd(image.open(), 1);
+    ASSERT_FALSE(chd.failed()) << chd.error();
+    const auto& tracks = chd.tracks();
+    ASSERT_EQ(tracks.size(), 2u);
+    EXPECT_EQ(tracks[0].type, PCSX::CHD::Track::Type::DATA);
+    EXPECT_TRUE(tracks[0].subcode);
+    EXPECT_TRUE(tracks[0].subcodeRaw);
+    EXPECT_EQ(tracks[0].frames, 10u);
+    EXPECT_EQ(tracks[0].firstFrame, 0u);
+    EXPECT_EQ(tracks[1].type, PCSX::CHD::Track::Type::AUDIO);
+    EXPECT_FALSE(tracks[1].subcode);
+    EXPECT_EQ(tracks[1].frames, 4u);
+    EXPECT_EQ(tracks[1].pregap, 150u);
+    EXPECT_FALSE(tracks[1].pregapStored);
+    EXPECT_EQ(tracks[1].firstFrame, 12u);
+}
+
+TEST(CHD, ReadFrames) {
+    TestImage image;
+    for (unsigned workers : {1, 3}) {
+        PCSX::CHD chd(image.open(), workers);
+        ASSERT_FALSE(chd.failed()) << chd.error();
+        uint8_t frame[PCSX::CHD::c_frameSize];
+        // Twice, so the second time around is served from the cache
+        for (unsigned pass = 0; pass < 2; pass++) {
+            for (unsigned i = 0; i < c_hunks * c_framesPerHunk; i++) {
+                ASSERT_TRUE(chd.readFrame(i, frame)) << "frame " << i;
+                ASSERT_EQ(memcmp(frame, image.hunks.data() + i * PCSX::CHD::c_frameSize, sizeof(frame)), 0)
+                    << "frame " << i << ", " << workers << " workers";
+            }
+        }
+        EXPECT_FALSE(chd.readFrame(c_hunks * c_framesPerHunk, frame));
+        EXPECT_EQ(chd.hits() + chd.misses(), 2 * c_hunks * c_framesPerHunk);
+        EXPECT_GE(chd.hits(), c_hunks * c_framesPerHunk);
+    }
+}
+
+TEST(CHD, Corrupted) {
+    TestImage image;
+    // The hunks' checksums catch what the codecs don't
+    image.file[image.offsets[2] + 100] ^= 0xff;
+    PCSX::CHD chd(image.open(), 1);
+    ASSERT_FALSE(chd.failed()) << chd.error();
+    uint8_t frame[PCSX::CHD::c_frameSize];
+    EXPECT_TRUE(chd.readFrame(4, frame));
+    EXPECT_FALSE(chd.readFrame(8, frame));
+}
+
+TEST(CHD, OtherCodecs) {
+    for (auto codecs : {std::pair{"cdlz", "lzma"}, std::pair{"cdfl", "zlib"}}) {
+        TestImage image(codecs.first, codecs.second);
+        PCSX::CHD chd(image.open(), 1);
+        ASSERT_FALSE(chd.failed()) << chd.error();
+        uint8_t frame[PCSX::CHD::c_frameSize];
+        for (unsigned i = 0; i < c_hunks * c_framesPerHunk; i++) {
+            ASSERT_TRUE(chd.readFrame(i, frame)) << "frame " << i << ", " << codecs.first;
+            ASSERT_EQ(memcmp(frame, image.hunks.data() + i * PCSX::CHD::c_frameSize, sizeof(frame)), 0)
+                << "frame " << i << ", " << codecs.first;
+        }
+    }
+}
+
+TEST(CHD, UnsupportedCodec) {
+    TestImage image("cdzl", "zstd");
+    PCSX::CHD chd(image.open(), 1);
+    EXPECT_TRUE(chd.failed());
+    EXPECT_NE(chd.error().find("zstd"), std::string::npos);
+
+    TestImage notCHD;
+    notCHD.file[0] = 'X';
+    PCSX::CHD other(notCHD.open(), 1);
+    EXPECT_TRUE(other.failed());
+}
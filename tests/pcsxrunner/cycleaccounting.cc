@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/cycleaccounting.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+uint32_t noBCR(unsigned) { return 0; }
+
+}  // namespace
+
+TEST(CycleAccounting, CostModel) {
+    uint32_t gpr[34] = {};
+    gpr[4] = 0x80010000;
+    gpr[5] = 0x1f800000;
+    gpr[6] = 0xbfc00000;
+    gpr[7] = 0x1f801000;
+
+    // addu $2, $4, $5 from cached RAM, and then from uncached RAM
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x00851021, gpr, noBCR).total(), 1);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0xa0010000, 0x00851021, gpr, noBCR).total(), 5);
+    // lw $2, 0($4), lw $2, 0($5), lw $2, 0($6), lbu $2, 0($6)
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x8c820000, gpr, noBCR).memory, 4);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x8ca20000, gpr, noBCR).memory, 0);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x8cc20000, gpr, noBCR).memory, 24);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x90c20000, gpr, noBCR).memory, 6);
+    // sw $2, 0($4) goes through the write queue
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0xac820000, gpr, noBCR).memory, 0);
+    // div $4, $5
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x0085001a, gpr, noBCR).total(), 36);
+    // rtps, rtpt, and a mfc2 which isn't a GTE command
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x4a180001, gpr, noBCR).gte, 15);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x4a280030, gpr, noBCR).gte, 23);
+    EXPECT_EQ(PCSX::CycleCostModel::cost(0x80010000, 0x48026000, gpr, noBCR).gte, 0);
+}
+
+TEST(CycleAccounting, DMAStall) {
+    uint32_t gpr[34] = {};
+    gpr[7] = 0x1f801000;
+    // sw $2, 0xa8($7), starting the GPU channel in block mode, 16 words by 8 blocks
+    gpr[2] = 0x01000201;
+    auto cost = PCSX::CycleCostModel::cost(0x80010000, 0xace200a8, gpr, [](unsigned channel) -> uint32_t {
+        EXPECT_EQ(channel, 2);
+        return 0x00080010;
+    });
+    EXPECT_EQ(cost.dma, 128);
+    // Same, in linked list mode
+    gpr[2] = 0x01000401;
+    cost = PCSX::CycleCostModel::cost(0x80010000, 0xace200a8, gpr, [](unsigned) -> uint32_t { return 0; });
+    EXPECT_EQ(cost.dma, 0);
+    // Writing to the channel's MADR doesn't start anything
+    gpr[2] = 0x01000201;
+    cost = PCSX::CycleCostModel::cost(0x80010000, 0xace200a0, gpr, noBCR);
+    EXPECT_EQ(cost.dma, 0);
+}
+
+TEST(CycleAccounting, FunctionsAndBlocks) {
+    PCSX::CycleAccounting accounting;
+    accounting.enable();
+    const PCSX::CycleCost one{1, 0, 0, 0};
+    const PCSX::CycleCost slow{1, 4, 0, 0};
+
+    // A loop going around three times in func, then a call to a block with no symbol, from KUSEG
+    for (unsigned i = 0; i < 3; i++) {
+        accounting.record(0x80010000, one);
+        accounting.record(0x80010004, slow);
+        accounting.record(0x80010008, one);
+        accounting.endBlock();
+    }
+    accounting.record(0x0001000c, one);
+    accounting.endBlock();
+    accounting.record(0x80020000, slow);
+    accounting.record(0x80020004, one);
+    accounting.endBlock();
+
+    EXPECT_EQ(accounting.totals().instructions, 12);
+    EXPECT_EQ(accounting.totals().total(), 28);
+    EXPECT_EQ(accounting.cycles(0xa0010004), 15);
+    EXPECT_EQ(accounting.executions(0x80010004), 3);
+    EXPECT_EQ(accounting.maxCycles(), 15);
+
+    PCSX::CycleAccounting::Symbols symbols;
+    symbols[0x00010000] = "func";
+
+    auto blocks = accounting.blocks(symbols);
+    ASSERT_EQ(blocks.size(), 3);
+    EXPECT_EQ(blocks[0].address, 0x80010000);
+    EXPECT_EQ(blocks[0].size, 12);
+    EXPECT_EQ(blocks[0].cycles, 21);
+    EXPECT_EQ(blocks[0].executions, 3);
+    EXPECT_EQ(blocks[0].name, "func");
+    EXPECT_EQ(blocks[1].address, 0x8001000c);
+    EXPECT_EQ(blocks[1].name, "func+0xc");
+    EXPECT_EQ(blocks[2].address, 0x80020000);
+
+    symbols[0x80020000] = "other";
+    auto functions = accounting.functions(symbols);
+    ASSERT_EQ(functions.size(), 2);
+    EXPECT_EQ(functions[0].name, "func");
+    EXPECT_EQ(functions[0].cycles, 22);
+    EXPECT_EQ(functions[0].size, 16);
+    EXPECT_EQ(functions[0].executions, 3);
+    EXPECT_EQ(functions[1].name, "other");
+    EXPECT_EQ(functions[1].cycles, 6);
+
+    accounting.clear();
+    EXPECT_EQ(accounting.totals().total(), 0);
+    EXPECT_EQ(accounting.cycles(0x80010004), 0);
+    EXPECT_TRUE(accounting.blocks(symbols).empty());
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "cdrom/dischasher.h"
+#include "gtest/gtest.h"
+#include "support/md5.h"
+#include "support/sha1.h"
+
+namespace {
+
+constexpr unsigned c_sectorSize = 2352;
+
+PCSX::DiscHasher::Status waitFor(PCSX::DiscHasher& hasher) {
+    while (hasher.status() == PCSX::DiscHasher::Status::RUNNING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return hasher.status();
+}
+
+}  // namespace
+
+TEST(DiscHasher, MatchesSerialHashes) {
+    // An empty track in the middle, and tracks that don't end on a chunk boundary
+    const std::vector<uint32_t> tracks = {300, 0, 1000, 17};
+    uint32_t total = 0;
+    for (auto sectors : tracks) total += sectors;
+    std::mt19937 rng(0x4a54);
+    std::vector<uint8_t> disc(total * c_sectorSize);
+    for (auto& byte : disc) byte = rng();
+
+    PCSX::DiscHasher hasher(tracks, [&disc, total](uint32_t lba, uint8_t* data, unsigned count) {
+        if (lba + count > total) return false;
+        memcpy(data, disc.data() + lba * c_sectorSize, count * c_sectorSize);
+        return true;
+    });
+    ASSERT_EQ(waitFor(hasher), PCSX::DiscHasher::Status::DONE);
+    EXPECT_EQ(hasher.progress(), 1.0f);
+    ASSERT_EQ(hasher.tracks().size(), tracks.size());
+
+    uint32_t lba = 0;
+    for (unsigned t = 0; t < tracks.size(); t++) {
+        const uint8_t* data = disc.data() + lba * c_sectorSize;
+        const unsigned size = tracks[t] * c_sectorSize;
+        lba += tracks[t];
+        const auto& result = hasher.tracks()[t];
+        EXPECT_EQ(result.sectors, tracks[t]);
+        EXPECT_EQ(result.crc32, crc32(crc32(0L, Z_NULL, 0), data, size)) << t;
+        uint8_t md5[16], sha1[20];
+        PCSX::MD5 md5Hasher;
+        md5Hasher.update(data, size);
+        md5Hasher.finish(md5);
+        EXPECT_EQ(memcmp(result.md5, md5, sizeof(md5)), 0) << t;
+        PCSX::SHA1 sha1Hasher;
+        sha1Hasher.update(data, size);
+        sha1Hasher.finish(sha1);
+        EXPECT_EQ(memcmp(result.sha1, sha1, sizeof(sha1)), 0) << t;
+    }
+    EXPECT_EQ(hasher.fullCRC32(), crc32(crc32(0L, Z_NULL, 0), disc.data(), disc.size()));
+}
+
+TEST(DiscHasher, ReadFailure) {
+    PCSX::DiscHasher hasher({5000}, [](uint32_t lba, uint8_t* data, unsigned count) {
+        memset(data, 0, count * c_sectorSize);
+        return lba < 3000;
+    });
+    EXPECT_EQ(waitFor(hasher), PCSX::DiscHasher::Status::FAILED);
+    EXPECT_LT(hasher.progress(), 1.0f);
+}
+
+TEST(DiscHasher, Cancel) {
+    std::atomic<bool> release = false;
+    PCSX::DiscHasher hasher({100000}, [&release](uint32_t lba, uint8_t* data, unsigned count) {
+        memset(data, 0, count * c_sectorSize);
+        // Stall past the first few chunks, until the test has cancelled
+        while ((lba > 2000) && !release.load()) std::this_thread::yield();
+        return true;
+    });
+    hasher.cancel();
+    release.store(true);
+    EXPECT_EQ(waitFor(hasher), PCSX::DiscHasher::Status::CANCELLED);
+}
@@ -0,0 +1,153 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "cdrom/ecmindex.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using PCSX::ECMIndex;
+
+void writeRecord(std::vector<uint8_t>& stream, int type, uint32_t count) {
+    uint32_t num = count - 1;
+    stream.push_back(((num >= 32) ? 0x80 : 0) | ((num & 31) << 2) | type);
+    num >>= 5;
+    while (num) {
+        stream.push_back(((num >= 128) ? 0x80 : 0) | (num & 127));
+        num >>= 7;
+    }
+    const size_t size = type ? count * ECMIndex::c_encodedSizes[type] : count;
+    for (size_t i = 0; i < size; i++) stream.push_back(stream.size() * 13);
+}
+
+// Three mode 2 sectors, each with its header as raw bytes, five mode 1 sectors, then two and a bit raw sectors.
+std::vector<uint8_t> makeStream() {
+    std::vector<uint8_t> stream = {'E', 'C', 'M', 0};
+    for (unsigned i = 0; i < 3; i++) {
+        writeRecord(stream, 0, 16);
+        writeRecord(stream, 2, 1);
+    }
+    writeRecord(stream, 1, 5);
+    writeRecord(stream, 0, 2352 * 2 + 100);
+    // End of stream
+    stream.insert(stream.end(), {0xfc, 0xff, 0xff, 0xff, 0x3f});
+    return stream;
+}
+
+PCSX::IO<PCSX::File> makeFile(std::vector<uint8_t>& stream) {
+    return PCSX::IO<PCSX::File>(new PCSX::BufferFile(stream.data(), stream.size()));
+}
+
+}  // namespace
+
+TEST(ECMIndex, Checkpoints) {
+    auto stream = makeStream();
+    ECMIndex index(makeFile(stream), std::filesystem::temp_directory_path() / "pcsx-ecmindex-unused.idx");
+    ASSERT_TRUE(index.build());
+    EXPECT_TRUE(index.complete());
+    EXPECT_EQ(index.sectors(), 10);
+
+    ECMIndex::Checkpoint checkpoint;
+    // The first sector is the beginning of the stream
+    EXPECT_EQ(index.find(0, checkpoint), 0);
+    EXPECT_EQ(checkpoint.filepos, 4);
+    EXPECT_EQ(checkpoint.remaining, 0);
+    // The other mode 2 sectors start on their raw header
+    for (uint32_t sector = 1; sector < 3; sector++) {
+        EXPECT_EQ(index.find(sector, checkpoint), sector);
+        EXPECT_EQ(checkpoint.filepos, 4 + sector * (2 + 16 + 0x804) + 1);
+        EXPECT_EQ(checkpoint.remaining, 16);
+        EXPECT_EQ(checkpoint.type, 0);
+    }
+    // The mode 1 ones are in the middle of their record
+    const uint32_t mode1 = 4 + 3 * (2 + 16 + 0x804) + 1;
+    for (uint32_t sector = 3; sector < 8; sector++) {
+        EXPECT_EQ(index.find(sector, checkpoint), sector);
+        EXPECT_EQ(checkpoint.filepos, mode1 + (sector - 3) * 0x803);
+        EXPECT_EQ(checkpoint.remaining, 8 - sector);
+        EXPECT_EQ(checkpoint.type, 1);
+    }
+    // The raw ones count bytes instead, and the record is big enough to need three bytes of header
+    const uint32_t raw = mode1 + 5 * 0x803 + 3;
+    EXPECT_EQ(index.find(9, checkpoint), 9);
+    EXPECT_EQ(checkpoint.filepos, raw + 2352);
+    EXPECT_EQ(checkpoint.remaining, 2352 + 100);
+    EXPECT_EQ(checkpoint.type, 0);
+    // Past the end, the closest is the last one, for the sector that's cut short
+    EXPECT_EQ(index.find(1000, checkpoint), 10);
+    EXPECT_EQ(checkpoint.remaining, 100);
+}
+
+TEST(ECMIndex, PartialStream) {
+    auto stream = makeStream();
+    // Cut in the middle of the mode 1 record, as if the file was truncated
+    stream.resize(4 + 3 * (2 + 16 + 0x804) + 1 + 0x803);
+    ECMIndex index(makeFile(stream), std::filesystem::temp_directory_path() / "pcsx-ecmindex-unused.idx");
+    EXPECT_FALSE(index.build());
+    EXPECT_FALSE(index.complete());
+    ECMIndex::Checkpoint checkpoint;
+    EXPECT_EQ(index.find(5, checkpoint), 2);
+    // The decoder can still fill in what it finds
+    index.add(3, {1234, 0, 0});
+    EXPECT_EQ(index.find(5, checkpoint), 3);
+    EXPECT_EQ(checkpoint.filepos, 1234);
+    index.add(3, {5678, 0, 0});
+    EXPECT_EQ(index.find(3, checkpoint), 3);
+    EXPECT_EQ(checkpoint.filepos, 1234);
+}
+
+TEST(ECMIndex, Sidecar) {
+    auto sidecar = std::filesystem::temp_directory_path() / "pcsx-ecmindex-test.idx";
+    std::filesystem::remove(sidecar);
+    auto stream = makeStream();
+    {
+        ECMIndex index(makeFile(stream), sidecar);
+        EXPECT_FALSE(index.load());
+        index.start();
+        for (unsigned i = 0; (i < 1000) && !index.complete(); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(index.complete());
+        // Waits for it to be saved
+        index.stop();
+    }
+    ASSERT_TRUE(std::filesystem::exists(sidecar));
+
+    ECMIndex loaded(makeFile(stream), sidecar);
+    ASSERT_TRUE(loaded.load());
+    EXPECT_TRUE(loaded.complete());
+    EXPECT_EQ(loaded.sectors(), 10);
+    ECMIndex::Checkpoint checkpoint;
+    EXPECT_EQ(loaded.find(4, checkpoint), 4);
+    EXPECT_EQ(checkpoint.remaining, 4);
+    EXPECT_EQ(checkpoint.type, 1);
+
+    // Another image doesn't get to use it
+    stream[stream.size() - 10]++;
+    ECMIndex other(makeFile(stream), sidecar);
+    EXPECT_FALSE(other.load());
+    EXPECT_FALSE(other.complete());
+
+    std::filesystem::remove(sidecar);
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "iec-60908b/edcecc.h"
+#include "supportpsx/iec-60908b.h"
+
+namespace {
+
+constexpr unsigned c_sectorSize = 2352;
+
+void randomSector(std::mt19937& rng, uint8_t* sector, uint8_t mode, bool form2) {
+    for (unsigned i = 0; i < c_sectorSize; i++) sector[i] = rng();
+    static const uint8_t c_sync[12] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    memcpy(sector, c_sync, sizeof(c_sync));
+    sector[15] = mode;
+    if (mode != 2) return;
+    // The subheader is repeated twice, and only its submode's form bit matters here
+    sector[18] = form2 ? (sector[18] | 0x20) : (sector[18] & ~0x20);
+    memcpy(sector + 20, sector + 16, 4);
+}
+
+// A byte at a time version of the mode 1 EDC and ECC, straight from ECMA-130, to check the faster one against
+uint8_t gfMul2(uint8_t x) { return (x << 1) ^ ((x & 0x80) ? 0x1d : 0); }
+
+void referenceECC(uint8_t* data, unsigned majorCount, unsigned minorCount, unsigned majorMult, unsigned minorInc,
+                  uint8_t* ecc) {
+    const unsigned size = majorCount * minorCount;
+    for (unsigned major = 0; major < majorCount; major++) {
+        unsigned index = (major >> 1) * majorMult + (major & 1);
+        uint8_t a = 0, b = 0;
+        for (unsigned minor = 0; minor < minorCount; minor++) {
+            const uint8_t temp = data[index];
+            index += minorInc;
+            if (index >= size) index -= size;
+            a ^= temp;
+            b ^= temp;
+            a = gfMul2(a);
+        }
+        // 3 * ecc0 = 2 * a + b, solved by trying every value
+        const uint8_t target = gfMul2(a) ^ b;
+        uint8_t ecc0 = 0;
+        while ((gfMul2(ecc0) ^ ecc0) != target) ecc0++;
+        ecc[major] = ecc0;
+        ecc[major + majorCount] = ecc0 ^ b;
+    }
+}
+
+void referenceMode1(uint8_t* sector) {
+    uint32_t edc = 0;
+    for (unsigned i = 0; i < 0x810; i++) {
+        edc ^= sector[i];
+        for (unsigned j = 0; j < 8; j++) edc = (edc >> 1) ^ ((edc & 1) ? 0xd8018001 : 0);
+    }
+    for (unsigned i = 0; i < 4; i++) sector[0x810 + i] = edc >> (i * 8);
+    memset(sector + 0x814, 0, 8);
+    referenceECC(sector + 12, 86, 24, 2, 86, sector + 0x81c);
+    referenceECC(sector + 12, 52, 43, 86, 88, sector + 0x8c8);
+}
+
+}  // namespace
+
+TEST(EDCECC, Mode2MatchesReference) {
+    std::mt19937 rng(0xedc);
+    uint8_t expected[c_sectorSize], actual[c_sectorSize];
+    for (unsigned i = 0; i < 2000; i++) {
+        randomSector(rng, expected, 2, i & 1);
+        memcpy(actual, expected, c_sectorSize);
+        compute_edcecc(expected);
+        PCSX::IEC60908b::computeEDCECC(actual);
+        ASSERT_EQ(memcmp(actual, expected, c_sectorSize), 0) << "form " << ((i & 1) + 1);
+    }
+}
+
+TEST(EDCECC, Mode1MatchesReference) {
+    std::mt19937 rng(0xecc);
+    uint8_t expected[c_sectorSize], actual[c_sectorSize];
+    for (unsigned i = 0; i < 200; i++) {
+        randomSector(rng, expected, 1, false);
+        memcpy(actual, expected, c_sectorSize);
+        referenceMode1(expected);
+        PCSX::IEC60908b::computeEDCECC(actual);
+        ASSERT_EQ(memcmp(actual, expected, c_sectorSize), 0);
+    }
+}
+
+TEST(EDCECC, OtherModesAreLeftAlone) {
+    std::mt19937 rng(0x0);
+    uint8_t expected[c_sectorSize], actual[c_sectorSize];
+    randomSector(rng, expected, 0, false);
+    memcpy(actual, expected, c_sectorSize);
+    PCSX::IEC60908b::computeEDCECC(actual);
+    EXPECT_EQ(memcmp(actual, expected, c_sectorSize), 0);
+}
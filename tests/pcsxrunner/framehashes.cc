@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdio.h>
+
+#include <filesystem>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+// The BIOS alone, without a disc, never exits, so the frame budget is what ends these runs.
+TEST(FrameHashes, GoldenRun) {
+    const std::string log = (std::filesystem::temp_directory_path() / "pcsx-framehashes-test.bin").string();
+    std::filesystem::remove(log);
+
+    MainInvoker record("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                       "-frames", "60", "-framehashes", log.c_str());
+    ASSERT_EQ(record.invoke(), 0);
+    ASSERT_EQ(std::filesystem::file_size(log), 8 + 60 * 8);
+
+    MainInvoker compare("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                        "-frames", "60", "-golden", log.c_str());
+    EXPECT_EQ(compare.invoke(), 0);
+
+    // With the hash of the first frame changed, the run fails right there
+    FILE* file = fopen(log.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, 8, SEEK_SET);
+    const int byte = fgetc(file);
+    fseek(file, 8, SEEK_SET);
+    fputc(byte ^ 0xff, file);
+    fclose(file);
+    MainInvoker mismatch("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                         "-frames", "60", "-golden", log.c_str());
+    EXPECT_EQ(mismatch.invoke(), 1);
+    std::filesystem::remove(log);
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/framestats.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+float last(const float* values, const PCSX::FrameStats::History& history) {
+    return values[(history.index + PCSX::FrameStats::c_frames - 1) % PCSX::FrameStats::c_frames];
+}
+
+float last(const PCSX::FrameStats& stats, PCSX::FrameStats::Counter counter) {
+    return last(stats.history().counters[unsigned(counter)], stats.history());
+}
+
+}  // namespace
+
+TEST(FrameStats, NestedScopesDontOverlap) {
+    using namespace std::chrono_literals;
+    using Counter = PCSX::FrameStats::Counter;
+    PCSX::FrameStats stats;
+    {
+        PCSX::FrameStats::Scope gui(stats, Counter::GUI);
+        std::this_thread::sleep_for(20ms);
+        {
+            PCSX::FrameStats::Scope present(stats, Counter::Present);
+            std::this_thread::sleep_for(20ms);
+        }
+        stats.vsync();
+        stats.endFrame();
+    }
+
+    const auto& history = stats.history();
+    EXPECT_EQ(history.frames, 1);
+    EXPECT_EQ(history.index, 1);
+    EXPECT_GE(last(stats, Counter::GUI), 20.0f);
+    EXPECT_GE(last(stats, Counter::Present), 20.0f);
+    EXPECT_LE(last(stats, Counter::GUI) + last(stats, Counter::Present), last(history.frameTime, history));
+    EXPECT_EQ(last(stats, Counter::CPU), 0.0f);
+    EXPECT_EQ(history.vsyncs[0], 1);
+    EXPECT_GT(stats.hostFPS(), 0.0f);
+    EXPECT_EQ(stats.hostFPS(), stats.emulatedFPS());
+}
+
+TEST(FrameStats, OtherThreadsAddUp) {
+    using namespace std::chrono_literals;
+    using Counter = PCSX::FrameStats::Counter;
+    PCSX::FrameStats stats;
+    std::thread thread([&stats]() {
+        PCSX::FrameStats::Scope spu(stats, Counter::SPU);
+        std::this_thread::sleep_for(10ms);
+    });
+    thread.join();
+    stats.endFrame();
+    EXPECT_GE(last(stats, Counter::SPU), 10.0f);
+
+    // The counters start over at each frame
+    stats.endFrame();
+    EXPECT_EQ(last(stats, Counter::SPU), 0.0f);
+    EXPECT_EQ(stats.history().frames, 2);
+    EXPECT_EQ(stats.emulatedFPS(), 0.0f);
+}
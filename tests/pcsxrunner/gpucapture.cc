@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/gpucapture.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using Kind = PCSX::GP0Packet::Kind;
+
+TEST(GPUCapture, SplitsPackets) {
+    const std::vector<uint32_t> words = {
+        // tpage: 8 bits texture, blend function 2
+        0xe1000000 | (1 << 7) | (2 << 5),
+        // gouraud textured semi-transparent quad, with a 4 bits tpage in the second vertex, blend function 1
+        0x3e000000, 0x00000000, 0x00000000, 0x00000000, 0x0000000a, (1 << 5) << 16, 0, 0x000a0000, 0, 0,
+        0x000a000a, 0,
+        // variable size semi-transparent rect, which takes the tpage the quad left
+        0x62000000, 0x00000000, 0x00040003,
+        // gouraud polyline, 0,0 to 9,0 to 9,4, then the terminator
+        0x58000000, 0x00000000, 0, 0x00000009, 0, 0x00040009, 0x55555555,
+        // fill, rounding the width up to 16 pixels
+        0x02000000, 0x00000000, 0x00020011,
+        // VRAM upload of 3x1 pixels, taking 2 words
+        0xa0000000, 0x00000000, 0x00010003, 0x11111111, 0x22222222,
+        // flat triangle, cut short
+        0x20000000, 0x00000000,
+    };
+    const auto packets = PCSX::splitGP0(words);
+    ASSERT_EQ(packets.size(), 7);
+
+    EXPECT_EQ(packets[0].kind, Kind::Environment);
+
+    EXPECT_EQ(packets[1].kind, Kind::Poly);
+    EXPECT_EQ(packets[1].offset, 1);
+    EXPECT_EQ(packets[1].size, 12);
+    EXPECT_EQ(packets[1].pixels, 100);
+    EXPECT_EQ(packets[1].category(), "poly-gouraud-tex4-blend1");
+
+    EXPECT_EQ(packets[2].kind, Kind::Rect);
+    EXPECT_EQ(packets[2].size, 3);
+    EXPECT_EQ(packets[2].pixels, 12);
+    EXPECT_EQ(packets[2].category(), "rect-blend1");
+
+    EXPECT_EQ(packets[3].kind, Kind::Line);
+    EXPECT_EQ(packets[3].size, 7);
+    EXPECT_EQ(packets[3].pixels, 15);
+    EXPECT_EQ(packets[3].category(), "line-gouraud");
+
+    EXPECT_EQ(packets[4].kind, Kind::Fill);
+    EXPECT_EQ(packets[4].pixels, 64);
+
+    EXPECT_EQ(packets[5].kind, Kind::BlitRamVram);
+    EXPECT_EQ(packets[5].size, 5);
+    EXPECT_EQ(packets[5].pixels, 3);
+
+    EXPECT_EQ(packets[6].kind, Kind::Other);
+    EXPECT_EQ(packets[6].offset, words.size() - 2);
+    EXPECT_EQ(packets[6].size, 2);
+}
+
+TEST(GPUCapture, RejectsOversizedPolygons) {
+    const std::vector<uint32_t> words = {0x20000000, 0x00000000, 0x00000400, 0x00100000};
+    const auto packets = PCSX::splitGP0(words);
+    ASSERT_EQ(packets.size(), 1);
+    EXPECT_EQ(packets[0].kind, Kind::Poly);
+    EXPECT_EQ(packets[0].pixels, 0);
+}
+
+TEST(GPUCapture, SavesAndLoads) {
+    PCSX::GPUCapture capture;
+    capture.vram.resize(PCSX::GPUCapture::c_vramPixels);
+    for (size_t i = 0; i < capture.vram.size(); i++) capture.vram[i] = i * 7;
+    capture.words = {0xe1000000, 0x02000000, 0x00000000, 0x00100010};
+    capture.events = {{0, PCSX::GPUCapture::Event::Type::GP1, 0x08000001},
+                      {4, PCSX::GPUCapture::Event::Type::VSync, 0}};
+
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    capture.save(file);
+    file->rSeek(0);
+    PCSX::GPUCapture loaded;
+    ASSERT_TRUE(loaded.load(file));
+    EXPECT_EQ(loaded.vram, capture.vram);
+    EXPECT_EQ(loaded.words, capture.words);
+    EXPECT_EQ(loaded.events, capture.events);
+
+    PCSX::IO<PCSX::File> truncated(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    truncated->write<uint32_t>(PCSX::GPUCapture::c_magic);
+    truncated->write<uint32_t>(PCSX::GPUCapture::c_version);
+    truncated->write<uint32_t>(4);
+    truncated->write<uint32_t>(0);
+    truncated->rSeek(0);
+    EXPECT_FALSE(loaded.load(truncated));
+}
+
+TEST(GPUCapture, ComparesVRAM) {
+    std::vector<uint16_t> a(PCSX::GPUCapture::c_vramPixels), b(PCSX::GPUCapture::c_vramPixels);
+    EXPECT_EQ(PCSX::GPUCapture::compareVRAM(a.data(), b.data())["pixels"], 0);
+
+    b[10 * 1024 + 20] = 1;
+    b[30 * 1024 + 5] = 1;
+    const auto differences = PCSX::GPUCapture::compareVRAM(a.data(), b.data());
+    EXPECT_EQ(differences["pixels"], 2);
+    EXPECT_EQ(differences["area"]["left"], 5);
+    EXPECT_EQ(differences["area"]["top"], 10);
+    EXPECT_EQ(differences["area"]["right"], 20);
+    EXPECT_EQ(differences["area"]["bottom"], 30);
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+// The guest side, src/mips/tests/gte, writes a record per command it ran: the command, whether FLAG got
+// overwritten or read right after it, the FLAG it read, then the 32 data and 32 control registers.
+static constexpr size_t c_recordWords = 3 + 32 + 32;
+// Two records for each of the 4 sf/lm variants of the 13 commands, and of the 64 MVMVA ones
+static constexpr size_t c_recordsPerInput = 2 * (13 * 4 + 64 * 4);
+
+static std::vector<uint32_t> runGTE(const char* cpu, std::vector<std::string> extraArgs = {}) {
+    const auto base = std::filesystem::temp_directory_path() / "pcsx-gte-test";
+    const auto results = base / "gte-results.bin";
+    std::filesystem::create_directories(base);
+    std::filesystem::remove(results);
+
+    std::vector<std::string> args = {"-no-ui", "-run", "-pcdrv", "-pcdrvbase", base.string(), "-bios",
+                                     "src/mips/openbios/openbios.bin", "-testmode", cpu};
+    args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+    args.insert(args.end(), {"-loadexe", "src/mips/tests/gte/gte.ps-exe"});
+    MainInvoker invoker(args);
+    EXPECT_EQ(invoker.invoke(), 0);
+
+    std::vector<uint32_t> words;
+    std::ifstream file(results, std::ios::binary);
+    std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    words.resize(bytes.size() / sizeof(uint32_t));
+    memcpy(words.data(), bytes.data(), words.size() * sizeof(uint32_t));
+    file.close();
+    std::filesystem::remove(results);
+    return words;
+}
+
+static void compareGTE(const std::vector<uint32_t>& expected, const std::vector<uint32_t>& actual) {
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected.size() % (c_recordWords * c_recordsPerInput), 0);
+    ASSERT_EQ(actual.size(), expected.size());
+
+    unsigned mismatches = 0;
+    for (size_t record = 0; record < expected.size(); record += c_recordWords) {
+        const uint32_t code = expected[record];
+        const char* mode = expected[record + 1] ? "FLAG read" : "FLAG overwritten";
+        for (size_t i = 0; i < c_recordWords; i++) {
+            if (actual[record + i] == expected[record + i]) continue;
+            const std::string what = i == 2  ? "CFC2 from FLAG"
+                                     : i < 35 ? "data register " + std::to_string(i - 3)
+                                              : "control register " + std::to_string(i - 35);
+            ADD_FAILURE() << "command 0x" << std::hex << code << " (" << mode << "), input " << std::dec
+                          << record / c_recordWords / c_recordsPerInput << ", " << what << ": expected 0x" << std::hex
+                          << expected[record + i] << ", got 0x" << actual[record + i];
+            if (++mismatches == 32) return;  // That's plenty to go on
+        }
+    }
+}
+
+TEST(GTE, DynarecFallback) {
+    const auto expected = runGTE("-interpreter");
+    const auto actual = runGTE("-dynarec");
+    compareGTE(expected, actual);
+}
+
+TEST(GTE, DynarecNative) {
+    const auto expected = runGTE("-interpreter");
+    const auto actual = runGTE("-dynarec", {"-dynarec-native-gte"});
+    compareGTE(expected, actual);
+}
+
+TEST(GTE, DynarecNativeFlagElision) {
+    const auto expected = runGTE("-interpreter");
+    const auto actual = runGTE("-dynarec", {"-dynarec-native-gte", "-dynarec-gte-flag-elision"});
+    compareGTE(expected, actual);
+}
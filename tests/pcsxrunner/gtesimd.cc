@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <random>
+
+#include "core/gte_simd.h"
+#include "gtest/gtest.h"
+
+TEST(GTESIMD, ScalarOverflow) {
+    const auto scalar = PCSX::GTESIMD::getSupportedTripleProductImplementations().front().kernel;
+    const int16_t matrix[3][3] = {{0x7fff, 0x7fff, 0x7fff}, {0x7fff, 0, 0}, {0, 0, 0}};
+    const int16_t vectors[3][3] = {{0x7fff, 0x7fff, 0x7fff}, {0x7fff, 0x7fff, 0x7fff}, {0x7fff, 0x7fff, 0x7fff}};
+    const int64_t translation[3] = {(int64_t)INT32_MAX << 12, (int64_t)INT32_MIN << 12, 0};
+    PCSX::GTESIMD::TripleProduct product;
+    scalar(matrix, translation, vectors, product);
+
+    // Row 0 wraps around past the top of the 44-bit range, row 1 stays in range, row 2 is just 0
+    EXPECT_TRUE(product.positiveOverflow[0][0]);
+    EXPECT_FALSE(product.negativeOverflow[0][0]);
+    EXPECT_LT(product.mac[0][0], 0);
+    EXPECT_FALSE(product.positiveOverflow[0][1]);
+    EXPECT_FALSE(product.negativeOverflow[0][1]);
+    EXPECT_EQ(product.mac[0][1], ((int64_t)INT32_MIN << 12) + 0x7fff * 0x7fff);
+    EXPECT_EQ(product.mac[2][2], 0);
+}
+
+TEST(GTESIMD, ImplementationsMatchScalar) {
+    const auto implementations = PCSX::GTESIMD::getSupportedTripleProductImplementations();
+    const auto scalar = implementations.front().kernel;
+
+    std::mt19937 rng(0x5eed);
+    // Bias the inputs towards the extremes, so that overflows happen a lot
+    auto randomComponent = [&]() -> int16_t {
+        switch (rng() % 4) {
+            case 0:
+                return 0x7fff;
+            case 1:
+                return -0x8000;
+            default:
+                return (int16_t)rng();
+        }
+    };
+    auto randomTranslation = [&]() -> int64_t {
+        switch (rng() % 3) {
+            case 0:
+                return (int64_t)INT32_MAX << 12;
+            case 1:
+                return (int64_t)INT32_MIN << 12;
+            default:
+                return (int64_t)(int32_t)rng() << 12;
+        }
+    };
+
+    for (int i = 0; i < 100000; i++) {
+        int16_t matrix[3][3];
+        int16_t vectors[3][3];
+        int64_t translation[3];
+        for (int row = 0; row < 3; row++) {
+            translation[row] = randomTranslation();
+            for (int column = 0; column < 3; column++) {
+                matrix[row][column] = randomComponent();
+                vectors[row][column] = randomComponent();
+            }
+        }
+
+        PCSX::GTESIMD::TripleProduct expected;
+        scalar(matrix, translation, vectors, expected);
+        for (const auto& implementation : implementations) {
+            PCSX::GTESIMD::TripleProduct product;
+            implementation.kernel(matrix, translation, vectors, product);
+            for (int v = 0; v < 3; v++) {
+                for (int row = 0; row < 3; row++) {
+                    ASSERT_EQ(product.mac[v][row], expected.mac[v][row]) << implementation.name;
+                    ASSERT_EQ(product.positiveOverflow[v][row], expected.positiveOverflow[v][row])
+                        << implementation.name;
+                    ASSERT_EQ(product.negativeOverflow[v][row], expected.negativeOverflow[v][row])
+                        << implementation.name;
+                }
+            }
+        }
+    }
+}
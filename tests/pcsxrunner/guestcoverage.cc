@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guestcoverage.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const PCSX::GuestCoverage::Symbols c_symbols = {
+    {0x80010000, "main"},
+    {0x80010010, "update"},
+    {0xbfc00000, "bios"},
+};
+
+}  // namespace
+
+TEST(GuestCoverage, ExpandsBlocksIntoInstructions) {
+    PCSX::GuestCoverage coverage;
+    EXPECT_EQ(coverage.entry(0x80010000), nullptr);
+    coverage.start(0x1fffff);
+    EXPECT_EQ(coverage.entry(0xbfc00000), nullptr);
+    // Mirrors and segments all land on the same word.
+    EXPECT_EQ(coverage.entry(0x00010000), coverage.entry(0xa0210000));
+
+    // A block of three instructions, as the dynarec would have it, and a lone one, as the interpreter would.
+    coverage.setLength(0x80010000, 3);
+    *coverage.entry(0x80010000) = 1;
+    coverage.mark(0x80010014);
+    EXPECT_EQ(coverage.coveredInstructions(), 4);
+
+    coverage.clear();
+    EXPECT_EQ(coverage.coveredInstructions(), 0);
+    coverage.mark(0x80010000);
+    EXPECT_EQ(coverage.coveredInstructions(), 3);
+    coverage.stop();
+    coverage.mark(0x80030000);
+    EXPECT_EQ(coverage.coveredInstructions(), 3);
+}
+
+TEST(GuestCoverage, LcovHasOneRecordPerSymbol) {
+    PCSX::GuestCoverage coverage;
+    coverage.start(0x1fffff);
+    coverage.setLength(0x80010000, 2);
+    coverage.mark(0x80010000);
+    coverage.mark(0x80010018);
+    coverage.mark(0x80030000);
+    coverage.mark(0x80030004);
+
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    coverage.writeLcov(file, c_symbols);
+    const std::string lcov = file->readStringAt(file->size(), 0);
+
+    const std::string main =
+        "SF:main\nFN:1,main\nFNDA:1,main\nFNF:1\nFNH:1\nDA:1,1\nDA:2,1\nDA:3,0\nDA:4,0\nLF:4\nLH:2\nend_of_record\n";
+    EXPECT_EQ(lcov.substr(0, main.size()), main);
+    EXPECT_NE(lcov.find("SF:update\nFN:1,update\nFNDA:0,update\nFNF:1\nFNH:0\nDA:1,0\nDA:2,0\nDA:3,1\n"),
+              std::string::npos);
+    EXPECT_NE(lcov.find("SF:0x80030000\n"), std::string::npos);
+    EXPECT_NE(lcov.find("DA:2,1\nLF:2\nLH:2\nend_of_record\n"), std::string::npos);
+    EXPECT_EQ(lcov.find("bios"), std::string::npos);
+}
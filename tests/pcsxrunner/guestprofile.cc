@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guestprofiler.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "support/zfile.h"
+
+namespace {
+
+const PCSX::GuestProfile::Symbols c_symbols = {
+    {0x80010000, "main"},
+    {0x80010100, "update"},
+    {0x80010200, "draw"},
+};
+
+PCSX::GuestProfile makeProfile() {
+    PCSX::GuestProfile profile;
+    const std::vector<uint32_t> updateA = {0x80010010, 0x80010120};
+    const std::vector<uint32_t> updateB = {0x80010010, 0x80010130};
+    const std::vector<uint32_t> draw = {0x80010010, 0x80010204};
+    const std::vector<uint32_t> unknown = {0x00001000};
+    for (unsigned i = 0; i < 3; i++) profile.addSample(updateA);
+    profile.addSample(updateB);
+    for (unsigned i = 0; i < 2; i++) profile.addSample(draw);
+    profile.addSample(unknown);
+    return profile;
+}
+
+uint64_t readVarint(const std::string& data, size_t& pos) {
+    uint64_t value = 0;
+    unsigned shift = 0;
+    while (true) {
+        const uint8_t byte = data[pos++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return value;
+        shift += 7;
+    }
+}
+
+}  // namespace
+
+TEST(GuestProfile, CollapsedStacksGroupBySymbol) {
+    const auto profile = makeProfile();
+    EXPECT_EQ(profile.samples(), 7);
+
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    profile.writeCollapsed(file, c_symbols);
+    EXPECT_EQ(file->readStringAt(file->size(), 0), "0x00001000 1\nmain;draw 2\nmain;update 4\n");
+}
+
+TEST(GuestProfile, PprofHasOneLocationPerAddress) {
+    const auto profile = makeProfile();
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    profile.writePprof(file, c_symbols, 1000);
+
+    PCSX::IO<PCSX::File> reader(new PCSX::ZReader(file));
+    std::string data;
+    char buffer[256];
+    while (!reader->eof()) {
+        const auto size = reader->read(buffer, sizeof(buffer));
+        if (size <= 0) break;
+        data.append(buffer, size);
+    }
+    ASSERT_FALSE(data.empty());
+
+    std::map<uint64_t, unsigned> fields;
+    std::vector<std::string> strings;
+    uint64_t period = 0;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        const uint64_t key = readVarint(data, pos);
+        const uint64_t field = key >> 3;
+        fields[field]++;
+        if ((key & 7) == 2) {
+            const size_t size = readVarint(data, pos);
+            ASSERT_LE(pos + size, data.size());
+            if (field == 6) strings.push_back(data.substr(pos, size));
+            pos += size;
+        } else {
+            ASSERT_EQ(key & 7, 0);
+            const uint64_t value = readVarint(data, pos);
+            if (field == 12) period = value;
+        }
+    }
+    EXPECT_EQ(fields[1], 2);  // sample types
+    EXPECT_EQ(fields[2], 4);  // distinct chains
+    EXPECT_EQ(fields[4], 5);  // distinct addresses
+    EXPECT_EQ(fields[5], 4);  // the three symbols, and the address outside of them
+    EXPECT_EQ(period, 1000);
+    ASSERT_FALSE(strings.empty());
+    EXPECT_EQ(strings[0], "");
+    for (const char* name : {"main", "update", "draw", "0x00001000", "cycles", "samples"}) {
+        EXPECT_NE(std::find(strings.begin(), strings.end(), name), strings.end()) << name;
+    }
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "cdrom/iso9660-builder.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<uint8_t> contents(PCSX::IO<PCSX::File> file) {
+    std::vector<uint8_t> data(file->size());
+    file->readAt(data.data(), data.size(), 0);
+    return data;
+}
+
+}  // namespace
+
+TEST(ISO9660Builder, BatchedMatchesSectorBySector) {
+    constexpr unsigned c_sectors = 700;
+    std::mt19937 rng(0x150);
+    std::vector<uint8_t> data(c_sectors * 2336);
+    for (auto& b : data) b = rng();
+
+    for (auto mode : {PCSX::SectorMode::M2_FORM1, PCSX::SectorMode::M2_FORM2, PCSX::SectorMode::M2_RAW,
+                      PCSX::SectorMode::RAW}) {
+        const unsigned size = mode == PCSX::SectorMode::M2_FORM1   ? 2048
+                              : mode == PCSX::SectorMode::M2_FORM2 ? 2324
+                              : mode == PCSX::SectorMode::M2_RAW   ? 2336
+                                                                   : 2352;
+        const unsigned sectors = data.size() / size;
+
+        PCSX::IO<PCSX::File> expected(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+        PCSX::ISO9660Builder serial(expected);
+        for (unsigned i = 0; i < sectors; i++) serial.writeSector(data.data() + i * size, mode);
+
+        PCSX::IO<PCSX::File> actual(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+        PCSX::ISO9660Builder batched(actual);
+        batched.setThreads(4);
+        const auto first = batched.writeSectors(data.data(), 300, mode);
+        EXPECT_EQ(first, PCSX::IEC60908b::MSF(0, 2, 0));
+        batched.writeSectors(data.data() + 300 * size, sectors - 300, mode);
+        EXPECT_EQ(batched.getCurrentLocation(), serial.getCurrentLocation());
+        EXPECT_TRUE(contents(actual) == contents(expected));
+    }
+}
+
+TEST(ISO9660Builder, WriteFile) {
+    // Not a multiple of the sector size, so the last sector gets padded
+    constexpr unsigned c_size = 600 * 2048 + 1000;
+    std::mt19937 rng(0xf11e);
+    std::vector<uint8_t> data(602 * 2048);
+    for (unsigned i = 0; i < c_size; i++) data[i] = rng();
+
+    PCSX::IO<PCSX::File> expected(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    PCSX::ISO9660Builder serial(expected);
+    serial.writeLicense();
+    for (unsigned i = 0; i < 601; i++) serial.writeSector(data.data() + i * 2048, PCSX::SectorMode::M2_FORM1);
+
+    PCSX::IO<PCSX::File> actual(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    PCSX::ISO9660Builder batched(actual);
+    batched.writeLicense();
+    PCSX::IO<PCSX::File> input(new PCSX::BufferFile(data.data(), c_size));
+    const auto first = batched.writeFile(input, PCSX::SectorMode::M2_FORM1);
+    EXPECT_EQ(first, PCSX::IEC60908b::MSF(0, 2, 16));
+    EXPECT_EQ(batched.getCurrentLocation(), serial.getCurrentLocation());
+    EXPECT_TRUE(contents(actual) == contents(expected));
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cdrom/cdriso.h"
+#include "cdrom/iso9660-builder.h"
+#include "cdrom/iso9660-reader.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr unsigned c_sectors = 32;
+
+void putDirRecord(std::vector<uint8_t>& sector, unsigned& offset, const std::string& name, uint32_t lba,
+                  uint32_t size, bool isDirectory) {
+    const unsigned length = 33 + name.size() + ((name.size() & 1) ? 0 : 1);
+    uint8_t* record = sector.data() + offset;
+    record[0] = length;
+    for (unsigned i = 0; i < 4; i++) {
+        record[2 + i] = lba >> (i * 8);
+        record[9 - i] = lba >> (i * 8);
+        record[10 + i] = size >> (i * 8);
+        record[17 - i] = size >> (i * 8);
+    }
+    record[25] = isDirectory ? 2 : 0;
+    record[28] = record[31] = 1;
+    record[32] = name.size();
+    memcpy(record + 33, name.data(), name.size());
+    offset += length;
+}
+
+// A tiny disc, with a root directory at sector 20, containing a subdirectory at sector 21, which in turn
+// contains a directory pointing back to the root. The file contents are their lba, over and over.
+std::shared_ptr<PCSX::CDRIso> buildImage() {
+    std::vector<std::vector<uint8_t>> sectors(c_sectors, std::vector<uint8_t>(2048));
+    auto& pvd = sectors[16];
+    pvd[0] = 1;
+    memcpy(pvd.data() + 1, "CD001", 5);
+    pvd[6] = 1;
+    memcpy(pvd.data() + 40, "LABEL", 5);
+    unsigned offset = 156;
+    putDirRecord(pvd, offset, std::string(1, '\0'), 20, 2048, true);
+    sectors[17][0] = 255;
+    memcpy(sectors[17].data() + 1, "CD001", 5);
+    sectors[17][6] = 1;
+
+    offset = 0;
+    putDirRecord(sectors[20], offset, std::string(1, '\0'), 20, 2048, true);
+    putDirRecord(sectors[20], offset, std::string(1, '\1'), 20, 2048, true);
+    putDirRecord(sectors[20], offset, "DIR", 21, 2048, true);
+    putDirRecord(sectors[20], offset, "SYSTEM.CNF;1", 22, 100, false);
+    putDirRecord(sectors[20], offset, "BIG.BIN;1", 23, 3 * 2048, false);
+
+    offset = 0;
+    putDirRecord(sectors[21], offset, std::string(1, '\0'), 21, 2048, true);
+    putDirRecord(sectors[21], offset, std::string(1, '\1'), 20, 2048, true);
+    putDirRecord(sectors[21], offset, "FILE.DAT;1", 26, 10, false);
+    putDirRecord(sectors[21], offset, "LOOP", 20, 2048, true);
+
+    for (unsigned lba = 22; lba < c_sectors; lba++) memset(sectors[lba].data(), lba, 2048);
+
+    PCSX::IO<PCSX::File> image(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    PCSX::ISO9660Builder builder(image);
+    for (auto& sector : sectors) builder.writeSector(sector.data(), PCSX::SectorMode::M2_FORM1);
+    return std::make_shared<PCSX::CDRIso>(image);
+}
+
+}  // namespace
+
+TEST(ISO9660Reader, IndexesEverything) {
+    PCSX::ISO9660Reader reader(buildImage());
+    ASSERT_FALSE(reader.failed());
+    EXPECT_EQ(reader.getLabel().substr(0, 5), "LABEL");
+
+    ASSERT_EQ(reader.countEntries(), 5);
+    const char* c_paths[] = {"DIR", "SYSTEM.CNF;1", "BIG.BIN;1", "DIR/FILE.DAT;1", "DIR/LOOP"};
+    for (unsigned i = 0; i < 5; i++) {
+        EXPECT_EQ(reader.getEntry(i).path, c_paths[i]);
+        EXPECT_EQ(reader.findIndex(c_paths[i]), i);
+    }
+    // The loop only gets listed once, and the entries of the root directory under it don't get indexed
+    EXPECT_EQ(reader.getEntry(0).lba, 21);
+    EXPECT_TRUE(reader.getEntry(0).isDirectory);
+    EXPECT_EQ(reader.getEntry(2).size, 3 * 2048);
+    EXPECT_FALSE(reader.getEntry(2).isDirectory);
+    EXPECT_FALSE(reader.findIndex("DIR/LOOP/DIR").has_value());
+    EXPECT_FALSE(reader.findIndex("NOPE").has_value());
+    EXPECT_EQ(reader.findIndex("/DIR//FILE.DAT;1"), 3);
+}
+
+TEST(ISO9660Reader, OpensByPathAndIndex) {
+    PCSX::ISO9660Reader reader(buildImage());
+    ASSERT_FALSE(reader.failed());
+
+    PCSX::IO<PCSX::File> big(reader.open("BIG.BIN;1"));
+    ASSERT_FALSE(big->failed());
+    EXPECT_EQ(big->size(), 3 * 2048);
+    std::vector<uint8_t> data(3 * 2048);
+    EXPECT_EQ(big->read(data.data(), data.size()), data.size());
+    for (unsigned i = 0; i < data.size(); i++) ASSERT_EQ(data[i], 23 + i / 2048) << i;
+
+    PCSX::IO<PCSX::File> file(reader.open(reader.findIndex("DIR/FILE.DAT;1").value()));
+    ASSERT_FALSE(file->failed());
+    EXPECT_EQ(file->size(), 10);
+    EXPECT_EQ(file->byte(), 26);
+
+    PCSX::IO<PCSX::File> missing(reader.open("DIR/NOPE"));
+    EXPECT_TRUE(missing->failed());
+    PCSX::IO<PCSX::File> outOfRange(reader.open(size_t(100)));
+    EXPECT_TRUE(outOfRange->failed());
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <random>
+
+#include "core/mdec_simd.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// A block of dequantized coefficients the way rl2blk leaves them, along with its used columns mask.
+// Most blocks are sparse, and some only have their DC coefficient or a first row.
+int makeBlock(std::mt19937& rng, int32_t block[64]) {
+    memset(block, 0, 64 * sizeof(int32_t));
+    auto coefficient = [&]() -> int32_t {
+        switch (rng() % 8) {
+            case 0:
+                return 0x7fff;
+            case 1:
+                return -0x8000;
+            default:
+                return int32_t(rng() % 4096) - 2048;
+        }
+    };
+    block[0] = coefficient();
+    const unsigned shape = rng() % 4;
+    if (shape == 0) return -1;
+    int used = 0;
+    const unsigned count = rng() % 64;
+    for (unsigned i = 0; i < count; i++) {
+        const unsigned index = (shape == 1) ? rng() % 8 : rng() % 64;
+        block[index] = coefficient();
+        if (index > 7) used |= 1 << (index & 7);
+    }
+    return used;
+}
+
+}  // namespace
+
+TEST(MDECSIMD, IDCTMatchesScalar) {
+    const auto implementations = PCSX::MDECSIMD::getSupportedImplementations();
+    const auto scalar = implementations.front().idct;
+
+    std::mt19937 rng(0x5eed);
+    for (int i = 0; i < 100000; i++) {
+        int32_t input[64];
+        const int used = makeBlock(rng, input);
+        int32_t expected[64];
+        memcpy(expected, input, sizeof(input));
+        scalar(expected, used);
+        for (const auto& implementation : implementations) {
+            int32_t block[64];
+            memcpy(block, input, sizeof(input));
+            implementation.idct(block, used);
+            for (unsigned j = 0; j < 64; j++) ASSERT_EQ(block[j], expected[j]) << implementation.name;
+        }
+    }
+}
+
+TEST(MDECSIMD, ColourConversionMatchesScalar) {
+    const auto implementations = PCSX::MDECSIMD::getSupportedImplementations();
+    const auto& scalar = implementations.front();
+
+    std::mt19937 rng(0xc010);
+    for (int i = 0; i < 10000; i++) {
+        // Values out of the IDCT, going well past what the clamping has to deal with
+        int32_t blocks[64 * 6];
+        for (auto& v : blocks) v = int32_t(rng() % 1024) - 512;
+        const uint16_t alpha = (i & 1) ? 0x8000 : 0;
+
+        uint16_t expected15[256];
+        uint8_t expected24[256 * 3];
+        scalar.rgb15(blocks, expected15, alpha);
+        scalar.rgb24(blocks, expected24);
+        for (const auto& implementation : implementations) {
+            uint16_t image15[256];
+            uint8_t image24[256 * 3];
+            implementation.rgb15(blocks, image15, alpha);
+            implementation.rgb24(blocks, image24);
+            ASSERT_EQ(memcmp(image15, expected15, sizeof(image15)), 0) << implementation.name;
+            ASSERT_EQ(memcmp(image24, expected24, sizeof(image24)), 0) << implementation.name;
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "core/memscanner.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using PCSX::MemScanner;
+using ScanType = MemScanner::ScanType;
+using ValueType = MemScanner::ValueType;
+
+constexpr ValueType c_valueTypes[] = {ValueType::Char, ValueType::Uchar, ValueType::Short, ValueType::Ushort,
+                                      ValueType::Int,  ValueType::Uint,  ValueType::Float};
+constexpr ScanType c_scanTypes[] = {ScanType::ExactValue, ScanType::GreaterThan, ScanType::LessThan,
+                                    ScanType::InRange,    ScanType::Changed,     ScanType::Unchanged,
+                                    ScanType::Increased,  ScanType::Decreased,   ScanType::UnknownInitialValue};
+
+// Only a handful of different values, so that the comparisons between them go every which way, the extremes of each
+// type included. The floats get a NaN and both zeroes thrown into the mix.
+std::vector<uint8_t> randomMemory(std::mt19937& rng, size_t size, unsigned stride) {
+    static const uint32_t c_values[] = {0, 1, 2, 0x7f, 0x80, 0xff, 0x7fff, 0x8000, 0xffff, 0x7fffffff, 0x80000000,
+                                        0xffffffff, 0x3f800000, 0xbf800000, 0x7fc00000};
+    std::vector<uint8_t> memory(size);
+    for (size_t i = 0; i < size; i += stride) {
+        const uint32_t value = c_values[rng() % std::size(c_values)];
+        memcpy(memory.data() + i, &value, stride);
+    }
+    return memory;
+}
+
+}  // namespace
+
+TEST(MemScanner, ImplementationsMatchScalar) {
+    const auto implementations = MemScanner::getSupportedImplementations();
+    const auto scalar = implementations.front().select;
+    constexpr unsigned c_words = 16;
+
+    std::mt19937 rng(0x5ca7);
+    for (auto valueType : c_valueTypes) {
+        const unsigned stride = MemScanner::getStride(valueType);
+        for (auto scanType : c_scanTypes) {
+            for (int i = 0; i < 50; i++) {
+                const auto current = randomMemory(rng, c_words * 64 * stride, stride);
+                const auto previous = randomMemory(rng, c_words * 64 * stride, stride);
+                MemScanner::Criterion criterion;
+                criterion.scanType = scanType;
+                uint32_t value, high;
+                memcpy(&value, current.data() + (rng() % (c_words * 64)) * stride, sizeof(value));
+                memcpy(&high, previous.data() + (rng() % (c_words * 64)) * stride, sizeof(high));
+                if (valueType == ValueType::Float) {
+                    float f;
+                    memcpy(&f, &value, sizeof(f));
+                    criterion.value = f;
+                    memcpy(&f, &high, sizeof(f));
+                    criterion.high = f;
+                } else {
+                    criterion.value = value;
+                    criterion.high = high;
+                }
+                std::vector<uint64_t> initial(c_words);
+                for (auto& word : initial) word = (uint64_t(rng()) << 32) | rng();
+                initial[rng() % c_words] = 0;
+
+                std::vector<uint64_t> expected = initial;
+                scalar(valueType, scanType)(current.data(), previous.data(), criterion, expected.data(), c_words);
+                for (const auto& implementation : implementations) {
+                    std::vector<uint64_t> words = initial;
+                    implementation.select(valueType, scanType)(current.data(), previous.data(), criterion,
+                                                               words.data(), c_words);
+                    ASSERT_EQ(words, expected) << implementation.name << " value type "
+                                               << static_cast<int>(valueType) << " scan type "
+                                               << static_cast<int>(scanType);
+                }
+            }
+        }
+    }
+}
+
+TEST(MemScanner, NarrowsDownCandidates) {
+    std::vector<uint8_t> ram(2 * 1024 * 1024);
+    const uint32_t c_offsets[] = {0x10, 0x1234, 0x80000, 0x1ffffe};
+    for (auto offset : c_offsets) {
+        ram[offset] = 42;
+        ram[offset + 1] = 0;
+    }
+    ram[0x4321] = 42;  // not aligned for shorts
+
+    MemScanner scanner;
+    scanner.firstScanAsync(std::vector<uint8_t>(ram), ValueType::Short, {ScanType::ExactValue, 42});
+    while (!scanner.poll()) std::this_thread::yield();
+    ASSERT_EQ(scanner.count(), 4u);
+    EXPECT_EQ(scanner.getOffsets(0, 10), std::vector<uint32_t>(std::begin(c_offsets), std::end(c_offsets)));
+    EXPECT_EQ(scanner.getOffsets(2, 1), std::vector<uint32_t>{0x80000});
+
+    ram[0x1234] = 43;
+    ram[0x1ffffe] = 41;
+    scanner.nextScan(std::vector<uint8_t>(ram), {ScanType::Changed});
+    EXPECT_EQ(scanner.getOffsets(0, 10), (std::vector<uint32_t>{0x1234, 0x1ffffe}));
+
+    ram[0x1234] = 44;
+    scanner.nextScanAsync(std::vector<uint8_t>(ram), {ScanType::Increased});
+    while (!scanner.poll()) std::this_thread::yield();
+    EXPECT_FALSE(scanner.busy());
+    EXPECT_EQ(scanner.getOffsets(0, 10), std::vector<uint32_t>{0x1234});
+    EXPECT_EQ(scanner.getSnapshot()[0x1234], 44);
+
+    scanner.nextScan(std::vector<uint8_t>(ram), {ScanType::InRange, 0, 10});
+    EXPECT_EQ(scanner.count(), 0u);
+    EXPECT_TRUE(scanner.getOffsets(0, 10).empty());
+}
+
+TEST(MemScanner, OnlyWholeValuesAreCandidates) {
+    // Not a whole block, nor a whole number of ints
+    std::vector<uint8_t> ram(1000 * 4 + 3, 0);
+
+    MemScanner scanner;
+    scanner.firstScan(std::vector<uint8_t>(ram), ValueType::Int, {ScanType::UnknownInitialValue});
+    EXPECT_EQ(scanner.count(), 1000u);
+    EXPECT_EQ(scanner.getOffsets(999, 10), std::vector<uint32_t>{999 * 4});
+
+    scanner.firstScan(std::vector<uint8_t>(ram), ValueType::Float, {ScanType::LessThan, 0});
+    EXPECT_EQ(scanner.count(), 0u);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    memcpy(ram.data() + 8, &nan, sizeof(nan));
+    scanner.firstScan(std::vector<uint8_t>(ram), ValueType::Float, {ScanType::ExactValue, 0});
+    EXPECT_EQ(scanner.count(), 999u);
+    scanner.nextScan(std::vector<uint8_t>(ram), {ScanType::Unchanged});
+    EXPECT_EQ(scanner.count(), 999u);
+}
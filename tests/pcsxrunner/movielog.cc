@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/movielog.h"
+
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Frame {
+    PCSX::MovieLog::Inputs inputs;
+    std::vector<PCSX::MovieLog::Lid> lids;
+};
+
+// Someone mashing a few buttons, and opening the lid once in a while.
+std::vector<Frame> makeFrames(unsigned count) {
+    std::mt19937 rng(0x30f1e);
+    std::vector<Frame> frames(count);
+    PCSX::MovieLog::Inputs inputs;
+    for (auto& frame : frames) {
+        if ((rng() % 8) == 0) inputs[0].buttons ^= 1 << (rng() % 16);
+        if ((rng() % 32) == 0) inputs[1].leftJoyX = rng();
+        frame.inputs = inputs;
+        if ((rng() % 50) == 0) frame.lids.push_back({bool(rng() % 2), bool(rng() % 2)});
+    }
+    return frames;
+}
+
+std::string makeState(std::mt19937& rng, std::string previous, size_t size) {
+    if (previous.empty()) {
+        previous.resize(size);
+        for (auto& c : previous) c = rng() % 16;
+    }
+    previous.resize(size, 0x42);
+    for (unsigned i = 0; i < 20; i++) previous[rng() % size] = rng();
+    return previous;
+}
+
+std::string record(const std::vector<Frame>& frames, unsigned interval, std::vector<std::string>& states) {
+    std::mt19937 rng(0x5eed);
+    PCSX::MovieLog::Writer writer;
+    std::string data;
+    std::string state;
+    for (unsigned i = 0; i < frames.size(); i++) {
+        if ((i % interval) == 0) {
+            state = makeState(rng, state, 100000 + (i % 3) * 1000);
+            states.push_back(state);
+            writer.keyframe(i, state);
+        }
+        writer.frame(frames[i].inputs);
+        for (const auto& lid : frames[i].lids) writer.lid(lid);
+        data += writer.flush();
+    }
+    return data;
+}
+
+void expectFrame(const Frame& expected, const PCSX::MovieLog::Inputs& inputs,
+                 const std::vector<PCSX::MovieLog::Lid>& lids) {
+    EXPECT_TRUE(inputs == expected.inputs);
+    ASSERT_EQ(lids.size(), expected.lids.size());
+    for (unsigned i = 0; i < lids.size(); i++) {
+        EXPECT_EQ(lids[i].open, expected.lids[i].open);
+        EXPECT_EQ(lids[i].interrupt, expected.lids[i].interrupt);
+    }
+}
+
+}  // namespace
+
+TEST(MovieLog, PlaysBackEveryFrame) {
+    const auto frames = makeFrames(2000);
+    std::vector<std::string> states;
+    std::string data = record(frames, 60, states);
+    // Most keyframes only hold what changed since the last full one, which isn't much
+    EXPECT_LT(data.size(), states.size() * 100000 / 4);
+
+    PCSX::MovieLog::Reader reader;
+    ASSERT_TRUE(reader.open(std::move(data)));
+    EXPECT_EQ(reader.frames(), frames.size());
+    ASSERT_EQ(reader.keyframes().size(), states.size());
+    for (unsigned i = 0; i < states.size(); i++) {
+        EXPECT_EQ(reader.keyframes()[i].frame, i * 60);
+        EXPECT_EQ(reader.keyframeState(i), states[i]);
+    }
+
+    PCSX::MovieLog::Inputs inputs;
+    std::vector<PCSX::MovieLog::Lid> lids;
+    reader.seek(0);
+    for (const auto& frame : frames) {
+        ASSERT_TRUE(reader.next(inputs, lids));
+        expectFrame(frame, inputs, lids);
+    }
+    EXPECT_FALSE(reader.next(inputs, lids));
+}
+
+TEST(MovieLog, SeeksToKeyframes) {
+    const auto frames = makeFrames(1000);
+    std::vector<std::string> states;
+    PCSX::MovieLog::Reader reader;
+    ASSERT_TRUE(reader.open(record(frames, 100, states)));
+
+    EXPECT_EQ(reader.findKeyframe(0), 0);
+    EXPECT_EQ(reader.findKeyframe(99), 0);
+    EXPECT_EQ(reader.findKeyframe(100), 1);
+    EXPECT_EQ(reader.findKeyframe(555), 5);
+    EXPECT_EQ(reader.findKeyframe(100000), 9);
+
+    PCSX::MovieLog::Inputs inputs;
+    std::vector<PCSX::MovieLog::Lid> lids;
+    for (size_t index : {7, 2, 9, 0}) {
+        reader.seek(index);
+        const auto frame = reader.keyframes()[index].frame;
+        for (size_t i = frame; i < frame + 100; i++) {
+            ASSERT_TRUE(reader.next(inputs, lids));
+            expectFrame(frames[i], inputs, lids);
+        }
+    }
+}
+
+TEST(MovieLog, RejectsDamagedMovies) {
+    const auto frames = makeFrames(200);
+    std::vector<std::string> states;
+    const std::string data = record(frames, 50, states);
+
+    PCSX::MovieLog::Reader reader;
+    EXPECT_FALSE(reader.open(std::string("not a movie")));
+    // Cutting the first keyframe short
+    EXPECT_FALSE(reader.open(data.substr(0, 100)));
+    std::string version = data;
+    version[8]++;
+    EXPECT_FALSE(reader.open(std::move(version)));
+    EXPECT_TRUE(reader.open(std::string(data)));
+}
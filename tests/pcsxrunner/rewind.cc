@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/rewind.h"
+
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Something shaped a bit like a save state: a lot of memory, where only a few places change every frame.
+std::string makeState(std::mt19937& rng, std::string previous, size_t size) {
+    if (previous.empty()) {
+        previous.resize(size);
+        for (auto& c : previous) c = rng() % 16;
+    }
+    previous.resize(size, 0x42);
+    for (unsigned i = 0; i < 20; i++) previous[rng() % size] = rng();
+    return previous;
+}
+
+std::vector<std::string> capture(PCSX::Rewind& rewind, unsigned count, size_t size) {
+    std::mt19937 rng(0x5eed);
+    std::vector<std::string> states;
+    std::string state;
+    for (unsigned i = 0; i < count; i++) {
+        state = makeState(rng, state, size + (i % 7) * 1000);
+        states.push_back(state);
+        rewind.capture(std::string(state));
+        // Never drop anything here, so that the test knows what's been kept.
+        while (rewind.count() + 1 < states.size()) std::this_thread::yield();
+    }
+    return states;
+}
+
+}  // namespace
+
+TEST(Rewind, StepsBackThroughEverySnapshot) {
+    PCSX::Rewind rewind;
+    rewind.setKeyframeInterval(8);
+    auto states = capture(rewind, 50, 1024 * 1024);
+    std::string state = rewind.rewind();
+    EXPECT_EQ(rewind.count(), 49);
+    EXPECT_TRUE(state == states.back());
+    states.pop_back();
+    while (!states.empty()) {
+        state = rewind.rewind(states.size() >= 3 ? 3 : 1);
+        for (unsigned i = 0; i < (states.size() >= 3 ? 2 : 0); i++) states.pop_back();
+        ASSERT_TRUE(state == states.back());
+        states.pop_back();
+        EXPECT_EQ(rewind.count(), states.size());
+    }
+    EXPECT_TRUE(rewind.rewind().empty());
+}
+
+TEST(Rewind, DeltasMatchAfterRewinding) {
+    PCSX::Rewind rewind;
+    rewind.setKeyframeInterval(5);
+    auto states = capture(rewind, 12, 256 * 1024);
+    rewind.rewind(4);
+    // Capturing again after going back starts from a new keyframe.
+    std::mt19937 rng(0xbeef);
+    std::string extra = makeState(rng, states[7], 300000);
+    rewind.capture(std::string(extra));
+    rewind.capture(makeState(rng, extra, 300000));
+    rewind.rewind();
+    EXPECT_TRUE(rewind.rewind() == extra);
+    EXPECT_TRUE(rewind.rewind() == states[7]);
+}
+
+TEST(Rewind, StaysWithinBudget) {
+    PCSX::Rewind rewind;
+    rewind.setKeyframeInterval(10);
+    rewind.setMemoryBudget(4 * 1024 * 1024);
+    std::mt19937 rng(1);
+    std::string state;
+    for (unsigned i = 0; i < 200; i++) {
+        state = makeState(rng, state, 1024 * 1024);
+        rewind.capture(std::string(state));
+    }
+    // Zero steps only waits for the worker to be done, which makes sure the next capture gets through.
+    EXPECT_TRUE(rewind.rewind(0).empty());
+    state = makeState(rng, state, 1024 * 1024);
+    rewind.capture(std::string(state));
+    rewind.rewind(0);
+    EXPECT_LE(rewind.memoryUsed(), 4 * 1024 * 1024);
+    EXPECT_GT(rewind.count(), 10);
+    EXPECT_LT(rewind.count() + rewind.dropped(), 201);
+    EXPECT_TRUE(rewind.rewind() == state);
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gpu/soft/soft.h"
+#include "gpu/soft/spans.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+PCSX::SoftGPU::SoftRenderer randomRenderer(std::mt19937& rng) {
+    PCSX::SoftGPU::SoftRenderer renderer;
+    renderer.m_drawSemiTrans = rng() & 1;
+    renderer.m_globalTextABR = static_cast<PCSX::GPU::BlendFunction>(rng() % 4);
+    renderer.m_checkMask = rng() & 1;
+    renderer.m_setMask32 = (rng() & 1) ? 0x80008000 : 0;
+    renderer.m_setMask16 = renderer.m_setMask32 & 0xffff;
+    return renderer;
+}
+
+}  // namespace
+
+TEST(SoftSpans, FlatMatchesHelper) {
+    const auto implementations = PCSX::SoftGPU::Spans::getSupportedFlatSpanImplementations();
+
+    std::mt19937 rng(0x5eed);
+    for (int i = 0; i < 20000; i++) {
+        auto renderer = randomRenderer(rng);
+        // The drawing code always passes the same pixel twice, but the helper doesn't care
+        uint32_t color = rng();
+        if (rng() & 1) color = (color & 0xffff) * 0x10001;
+        const unsigned count = rng() % 40;
+        // Start one pixel in, so that the kernels also get to see unaligned spans
+        std::vector<uint16_t> vram(count * 2 + 2);
+        for (auto& pixel : vram) pixel = rng();
+
+        auto expected = vram;
+        for (unsigned p = 0; p < count; p++) {
+            uint32_t pair;
+            std::memcpy(&pair, &expected[1 + p * 2], sizeof(pair));
+            renderer.getShadeTransCol32(&pair, color);
+            std::memcpy(&expected[1 + p * 2], &pair, sizeof(pair));
+        }
+
+        for (const auto& implementation : implementations) {
+            auto actual = vram;
+            implementation.kernel(reinterpret_cast<uint32_t*>(&actual[1]), count, color, renderer.spanBlend());
+            ASSERT_EQ(actual, expected) << implementation.name << " function "
+                                        << static_cast<unsigned>(renderer.m_globalTextABR) << " semi "
+                                        << renderer.m_drawSemiTrans << " mask " << renderer.m_checkMask;
+        }
+    }
+}
+
+TEST(SoftSpans, ShadedMatchesHelper) {
+    const auto implementations = PCSX::SoftGPU::Spans::getSupportedShadedSpanImplementations();
+
+    std::mt19937 rng(0x5eed);
+    for (int i = 0; i < 20000; i++) {
+        auto renderer = randomRenderer(rng);
+        const unsigned count = rng() % 40;
+        std::vector<uint16_t> colors(count);
+        for (auto& color : colors) color = rng() & 0x7fff;
+        // Start one pixel in, so that the kernels also get to see unaligned spans
+        std::vector<uint16_t> vram(count + 2);
+        for (auto& pixel : vram) pixel = rng();
+
+        auto expected = vram;
+        for (unsigned p = 0; p < count; p++) renderer.getShadeTransCol(&expected[1 + p], colors[p]);
+
+        for (const auto& implementation : implementations) {
+            auto actual = vram;
+            implementation.kernel(&actual[1], count, colors.data(), renderer.spanBlend());
+            ASSERT_EQ(actual, expected) << implementation.name << " function "
+                                        << static_cast<unsigned>(renderer.m_globalTextABR) << " semi "
+                                        << renderer.m_drawSemiTrans << " mask " << renderer.m_checkMask;
+        }
+    }
+}
+
+TEST(SoftSpans, TexturedMatchesHelper) {
+    const auto implementations = PCSX::SoftGPU::Spans::getSupportedTexturedSpanImplementations();
+
+    std::mt19937 rng(0x5eed);
+    for (int i = 0; i < 20000; i++) {
+        auto renderer = randomRenderer(rng);
+        const unsigned count = rng() % 40;
+        // Fully transparent texels are skipped, and the semi transparency bit picks which ones get blended
+        std::vector<uint16_t> texels(count);
+        for (auto& texel : texels) texel = (rng() % 4) ? rng() : 0;
+        std::vector<int16_t> m1(count), m2(count), m3(count);
+        for (unsigned p = 0; p < count; p++) {
+            m1[p] = rng() % 256;
+            m2[p] = rng() % 256;
+            m3[p] = rng() % 256;
+        }
+        std::vector<uint16_t> vram(count + 2);
+        for (auto& pixel : vram) pixel = rng();
+
+        auto expected = vram;
+        for (unsigned p = 0; p < count; p++) {
+            renderer.getTextureTransColShadeX(&expected[1 + p], texels[p], m1[p], m2[p], m3[p]);
+        }
+
+        const PCSX::SoftGPU::Spans::TexturedSpan span = {texels.data(), m1.data(), m2.data(), m3.data()};
+        for (const auto& implementation : implementations) {
+            auto actual = vram;
+            implementation.kernel(&actual[1], count, span, renderer.spanBlend());
+            ASSERT_EQ(actual, expected) << implementation.name << " function "
+                                        << static_cast<unsigned>(renderer.m_globalTextABR) << " semi "
+                                        << renderer.m_drawSemiTrans << " mask " << renderer.m_checkMask;
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "spu/adpcmcache.h"
+
+#include "gtest/gtest.h"
+
+using PCSX::SPU::ADPCMCache;
+
+namespace {
+
+// Decodes nothing for real, but gives every block recognizable samples
+void fill(int* samples, int seed) {
+    for (unsigned i = 0; i < ADPCMCache::c_samplesPerBlock; i++) samples[i] = seed * 100 + i;
+}
+
+}  // namespace
+
+TEST(SPUADPCMCache, HitsOnlyWithTheSameFilterState) {
+    ADPCMCache cache;
+    int samples[ADPCMCache::c_samplesPerBlock];
+    uint32_t generation;
+
+    EXPECT_EQ(cache.lookup(0x1000, 1, 2, generation), nullptr);
+    fill(samples, 1);
+    cache.store(0x1000, generation, 1, 2, samples);
+
+    const int* decoded = cache.lookup(0x1000, 1, 2, generation);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded[0], 100);
+    EXPECT_EQ(decoded[27], 127);
+    EXPECT_EQ(cache.lookup(0x1000, 2, 1, generation), nullptr);
+    EXPECT_EQ(cache.lookup(0x1008, 1, 2, generation), nullptr);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 3);
+
+    cache.resetCounters();
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_EQ(cache.misses(), 0);
+}
+
+TEST(SPUADPCMCache, WritesInvalidateOverlappingBlocks) {
+    ADPCMCache cache;
+    int samples[ADPCMCache::c_samplesPerBlock];
+    uint32_t generation;
+    fill(samples, 2);
+
+    auto cached = [&](uint32_t address) {
+        uint32_t unused;
+        return cache.lookup(address, 0, 0, unused) != nullptr;
+    };
+    auto storeAt = [&](uint32_t address) {
+        cache.lookup(address, 0, 0, generation);
+        cache.store(address, generation, 0, 0, samples);
+    };
+
+    // Blocks are 16 bytes long, and start every 8 bytes, so 0x2006 is part of the blocks at 0x1ff8 and 0x2000
+    storeAt(0x1ff0);
+    storeAt(0x1ff8);
+    storeAt(0x2000);
+    storeAt(0x2008);
+    storeAt(0x2010);
+    cache.invalidate(0x2006);
+    EXPECT_TRUE(cached(0x1ff0));
+    EXPECT_FALSE(cached(0x1ff8));
+    EXPECT_FALSE(cached(0x2000));
+    EXPECT_TRUE(cached(0x2008));
+    EXPECT_TRUE(cached(0x2010));
+
+    cache.invalidate(0x200e);
+    EXPECT_FALSE(cached(0x2008));
+    EXPECT_TRUE(cached(0x2010));
+
+    // A write landing between the lookup and the store makes the stored block stale right away
+    cache.lookup(0x3000, 0, 0, generation);
+    cache.invalidate(0x3000);
+    cache.store(0x3000, generation, 0, 0, samples);
+    EXPECT_FALSE(cached(0x3000));
+
+    storeAt(0x4000);
+    cache.clear();
+    EXPECT_FALSE(cached(0x4000));
+}
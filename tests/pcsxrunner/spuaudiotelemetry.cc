@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "spu/audiotelemetry.h"
+
+using PCSX::SPU::AudioTelemetry;
+using PCSX::SPU::RollingStat;
+
+TEST(SPUAudioTelemetry, RollingStatSnapshot) {
+    RollingStat stat;
+    EXPECT_EQ(stat.snapshot().count, 0);
+
+    for (uint32_t i = 1; i <= 100; i++) stat.add(i);
+    auto snapshot = stat.snapshot();
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_EQ(snapshot.min, 1);
+    EXPECT_EQ(snapshot.max, 100);
+    EXPECT_DOUBLE_EQ(snapshot.mean, 50.5);
+    EXPECT_EQ(snapshot.p50, 50);
+    EXPECT_EQ(snapshot.p99, 99);
+    // 1, then 2-3, 4-7, ..., 32-63, and 64-100
+    EXPECT_EQ(snapshot.histogram[0], 0);
+    EXPECT_EQ(snapshot.histogram[1], 1);
+    EXPECT_EQ(snapshot.histogram[2], 2);
+    EXPECT_EQ(snapshot.histogram[6], 32);
+    EXPECT_EQ(snapshot.histogram[7], 37);
+
+    stat.reset();
+    EXPECT_EQ(stat.snapshot().count, 0);
+}
+
+TEST(SPUAudioTelemetry, RollingStatOnlyKeepsRecentValues) {
+    RollingStat stat;
+    for (uint32_t i = 0; i < RollingStat::c_samples; i++) stat.add(1000);
+    for (uint32_t i = 0; i < RollingStat::c_samples; i++) stat.add(0);
+    auto snapshot = stat.snapshot();
+    EXPECT_EQ(snapshot.count, RollingStat::c_samples);
+    EXPECT_EQ(snapshot.max, 0);
+    EXPECT_EQ(snapshot.histogram[0], RollingStat::c_samples);
+
+    stat.add(0xffffffff);
+    EXPECT_EQ(stat.snapshot().histogram[RollingStat::c_bins - 1], 1);
+}
+
+TEST(SPUAudioTelemetry, MixTimeScalesToOneMillisecond) {
+    // 441 frames at 44.1kHz are 10ms of audio
+    EXPECT_EQ(AudioTelemetry::mixTimePerMs(std::chrono::microseconds(50), 441), 5000);
+    EXPECT_EQ(AudioTelemetry::mixTimePerMs(std::chrono::microseconds(50), 0), 0);
+}
+
+TEST(SPUAudioTelemetry, Json) {
+    AudioTelemetry telemetry;
+    telemetry.bufferFill.add(512);
+    telemetry.addUnderrun(32);
+    auto j = telemetry.toJson();
+    EXPECT_EQ(j["bufferFill"]["count"], 1);
+    EXPECT_EQ(j["bufferFill"]["max"], 512);
+    EXPECT_EQ(j["bufferFill"]["histogram"].size(), RollingStat::c_bins);
+    EXPECT_EQ(j["bufferFill"]["histogram"][10]["from"], 512);
+    EXPECT_EQ(j["bufferFill"]["histogram"][10]["count"], 1);
+    EXPECT_EQ(j["latency"]["count"], 0);
+    EXPECT_EQ(j["underruns"], 1);
+    EXPECT_EQ(j["underrunFrames"], 32);
+
+    telemetry.reset();
+    EXPECT_EQ(telemetry.toJson()["underruns"], 0);
+}
@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spu/reverbmix.h"
+#include "spu/types.h"
+
+namespace {
+
+constexpr unsigned c_workAreaSize = 256 * 1024;
+constexpr unsigned c_chunk = 45;
+
+struct ReverbState {
+    PCSX::SPU::REVERBInfo rvb = {};
+    std::vector<int16_t> workArea = std::vector<int16_t>(c_workAreaSize);
+    int counter = 0;
+};
+
+// Random registers, with offsets big enough to wrap past either end of the work area
+ReverbState randomState(std::mt19937& rng) {
+    ReverbState state;
+    auto& rvb = state.rvb;
+    auto coef = [&]() -> int { return (int16_t)rng(); };
+    auto offset = [&]() -> int { return rng() % 0x2000; };
+    auto signedOffset = [&]() -> int { return (int)(rng() % 0x2000) - 0x1000; };
+
+    static const int c_starts[] = {0x3f000, 0x3c000, 0x30000, 0x1000, 4};
+    rvb.StartAddr = (rng() % 2) ? c_starts[rng() % 5] : ((rng() & 0xffff) << 2);
+    if (rvb.StartAddr == 0) rvb.StartAddr = 4;
+    rvb.CurrAddr = rvb.StartAddr + rng() % (0x40000 - rvb.StartAddr);
+    rvb.VolLeft = rng() & 0xffff;
+    rvb.VolRight = rng() & 0xffff;
+    rvb.iLastRVBLeft = (int16_t)rng();
+    rvb.iLastRVBRight = (int16_t)rng();
+    rvb.iRVBLeft = (int16_t)rng();
+    rvb.iRVBRight = (int16_t)rng();
+
+    rvb.FB_SRC_A = offset();
+    rvb.FB_SRC_B = signedOffset();
+    rvb.IIR_ALPHA = coef();
+    rvb.ACC_COEF_A = coef();
+    rvb.ACC_COEF_B = coef();
+    rvb.ACC_COEF_C = coef();
+    rvb.ACC_COEF_D = coef();
+    rvb.IIR_COEF = coef();
+    rvb.FB_ALPHA = coef();
+    rvb.FB_X = coef();
+    rvb.IIR_DEST_A0 = offset();
+    rvb.IIR_DEST_A1 = offset();
+    rvb.ACC_SRC_A0 = offset();
+    rvb.ACC_SRC_A1 = offset();
+    rvb.ACC_SRC_B0 = offset();
+    rvb.ACC_SRC_B1 = offset();
+    rvb.IIR_SRC_A0 = offset();
+    rvb.IIR_SRC_A1 = offset();
+    rvb.IIR_DEST_B0 = offset();
+    rvb.IIR_DEST_B1 = offset();
+    rvb.ACC_SRC_C0 = offset();
+    rvb.ACC_SRC_C1 = offset();
+    rvb.ACC_SRC_D0 = offset();
+    rvb.ACC_SRC_D1 = offset();
+    rvb.IIR_SRC_B1 = offset();
+    rvb.IIR_SRC_B0 = offset();
+    rvb.MIX_DEST_A0 = signedOffset();
+    rvb.MIX_DEST_A1 = offset();
+    rvb.MIX_DEST_B0 = offset();
+    rvb.MIX_DEST_B1 = signedOffset();
+    rvb.IN_COEF_L = coef();
+    rvb.IN_COEF_R = coef();
+
+    for (auto& sample : state.workArea) sample = (int16_t)rng();
+    state.counter = rng() % 2;
+    return state;
+}
+
+bool operator==(const PCSX::SPU::REVERBInfo& a, const PCSX::SPU::REVERBInfo& b) {
+    return memcmp(&a, &b, sizeof(PCSX::SPU::REVERBInfo)) == 0;
+}
+
+}  // namespace
+
+TEST(SPUReverbMix, ImplementationsMatchReference) {
+    const auto implementations = PCSX::SPU::ReverbMix::getSupportedMixImplementations();
+    const auto reference = implementations.front().kernel;
+
+    std::mt19937 rng(0x4e11);
+    // The reverb sends of all the voices added up; louder than this, the IIR stage overflows
+    std::uniform_int_distribution<int> inputDistribution(-0x7fff, 0x7fff);
+
+    for (int i = 0; i < 200; i++) {
+        const ReverbState initial = randomState(rng);
+        // Long enough to go around the smaller work areas a few times
+        const unsigned chunks = 1 + rng() % 40;
+        std::vector<unsigned> counts(chunks);
+        std::vector<bool> enabled(chunks);
+        for (unsigned c = 0; c < chunks; c++) {
+            counts[c] = rng() % (c_chunk + 1);
+            enabled[c] = (rng() % 8) != 0;
+        }
+        std::vector<int> input(c_chunk * 2);
+        for (auto& sample : input) sample = inputDistribution(rng);
+        std::vector<int> initialSums(c_chunk);
+        for (auto& sum : initialSums) sum = (int32_t)rng() >> 8;
+
+        auto run = [&](PCSX::SPU::ReverbMix::MixKernel kernel, ReverbState& state, std::vector<int>& outL,
+                       std::vector<int>& outR) {
+            for (unsigned c = 0; c < chunks; c++) {
+                std::vector<int> sumL = initialSums, sumR = initialSums;
+                kernel(state.rvb, state.workArea.data(), state.counter, enabled[c], input.data(), counts[c],
+                       sumL.data(), sumR.data());
+                outL.insert(outL.end(), sumL.begin(), sumL.end());
+                outR.insert(outR.end(), sumR.begin(), sumR.end());
+            }
+        };
+
+        ReverbState expected = initial;
+        std::vector<int> expectedL, expectedR;
+        run(reference, expected, expectedL, expectedR);
+
+        for (const auto& implementation : implementations) {
+            ReverbState actual = initial;
+            std::vector<int> actualL, actualR;
+            run(implementation.kernel, actual, actualL, actualR);
+            ASSERT_EQ(actualL, expectedL) << implementation.name;
+            ASSERT_EQ(actualR, expectedR) << implementation.name;
+            ASSERT_TRUE(actual.rvb == expected.rvb) << implementation.name;
+            ASSERT_EQ(actual.counter, expected.counter) << implementation.name;
+            ASSERT_TRUE(actual.workArea == expected.workArea) << implementation.name;
+        }
+    }
+}
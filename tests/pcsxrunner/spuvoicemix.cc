@@ -0,0 +1,87 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spu/voicemix.h"
+
+using PCSX::SPU::VoiceMix::c_voices;
+using PCSX::SPU::VoiceMix::VoiceSamples;
+
+TEST(SPUVoiceMix, RoundsTowardsZero) {
+    const auto scalar = PCSX::SPU::VoiceMix::getSupportedMixImplementations().front().kernel;
+    VoiceSamples samples[1] = {};
+    int32_t left[c_voices] = {}, right[c_voices] = {};
+    samples[0][0] = -1;
+    samples[0][1] = 3;
+    left[0] = right[0] = 0x3fff;
+    left[1] = 0x2000;
+    int sumL[1] = {10}, sumR[1] = {10};
+    scalar(samples, 1, left, right, sumL, sumR);
+
+    // -0x3fff / 0x4000 is 0, not -1, and 3 * 0x2000 / 0x4000 is 1
+    EXPECT_EQ(sumL[0], 11);
+    EXPECT_EQ(sumR[0], 10);
+}
+
+TEST(SPUVoiceMix, ImplementationsMatchScalar) {
+    const auto implementations = PCSX::SPU::VoiceMix::getSupportedMixImplementations();
+    const auto scalar = implementations.front().kernel;
+
+    std::mt19937 rng(0x5eed);
+    // The voices' output can go a bit past 16 bits after interpolation, and the volumes are at most 0x3fff
+    std::uniform_int_distribution<int32_t> sampleDistribution(-0x1ffff, 0x1ffff);
+    auto randomVolume = [&]() -> int32_t {
+        switch (rng() % 4) {
+            case 0:
+                return 0;
+            case 1:
+                return 0x3fff;
+            default:
+                return rng() & 0x3fff;
+        }
+    };
+
+    for (int i = 0; i < 2000; i++) {
+        const unsigned count = rng() % 46;
+        std::vector<VoiceSamples> samples(count + 1);
+        for (auto& row : samples) {
+            for (auto& sample : row) sample = (rng() % 4) == 0 ? 0 : sampleDistribution(rng);
+        }
+        int32_t left[c_voices], right[c_voices];
+        for (unsigned v = 0; v < c_voices; v++) {
+            left[v] = randomVolume();
+            right[v] = randomVolume();
+        }
+        std::vector<int> initial(count + 1);
+        for (auto& sum : initial) sum = (int32_t)rng() >> 8;
+
+        auto expectedL = initial, expectedR = initial;
+        scalar(samples.data(), count, left, right, expectedL.data(), expectedR.data());
+
+        for (const auto& implementation : implementations) {
+            auto actualL = initial, actualR = initial;
+            implementation.kernel(samples.data(), count, left, right, actualL.data(), actualR.data());
+            ASSERT_EQ(actualL, expectedL) << implementation.name;
+            ASSERT_EQ(actualR, expectedR) << implementation.name;
+        }
+    }
+}
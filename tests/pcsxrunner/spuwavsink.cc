@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "spu/wavsink.h"
+#include "support/file.h"
+
+using namespace PCSX;
+
+TEST(SPUWavSink, WritesHeaderAndSamples) {
+    IO<File> file(new BufferFile(FileOps::READWRITE));
+    SPU::WavSink sink;
+    sink.open(file);
+    ASSERT_TRUE(sink.isOpen());
+
+    std::vector<int16_t> samples;
+    for (int i = 0; i < 100; i++) {
+        samples.push_back(i * 300);
+        samples.push_back(-i * 300);
+    }
+    sink.write(samples.data(), 50);
+    sink.write(samples.data() + 100, 50);
+    EXPECT_EQ(sink.getFramesWritten(), 100);
+    sink.flush();
+
+    EXPECT_EQ(file->size(), SPU::WavSink::c_headerSize + 400);
+    EXPECT_EQ(file->readStringAt(4, 0), "RIFF");
+    EXPECT_EQ(file->readAt<uint32_t>(4), 36 + 400);
+    EXPECT_EQ(file->readStringAt(8, 8), "WAVEfmt ");
+    EXPECT_EQ(file->readAt<uint16_t>(20), 1);
+    EXPECT_EQ(file->readAt<uint16_t>(22), 2);
+    EXPECT_EQ(file->readAt<uint32_t>(24), 44100);
+    EXPECT_EQ(file->readAt<uint32_t>(28), 44100 * 4);
+    EXPECT_EQ(file->readAt<uint16_t>(34), 16);
+    EXPECT_EQ(file->readStringAt(4, 36), "data");
+    EXPECT_EQ(file->readAt<uint32_t>(40), 400);
+    for (unsigned i = 0; i < samples.size(); i++) {
+        EXPECT_EQ((int16_t)file->readAt<uint16_t>(SPU::WavSink::c_headerSize + i * 2), samples[i]);
+    }
+}
+
+TEST(SPUWavSink, KeepsWritingAfterFlush) {
+    IO<File> file(new BufferFile(FileOps::READWRITE));
+    SPU::WavSink sink;
+    sink.open(file);
+
+    const int16_t samples[4] = {1, 2, 3, 4};
+    sink.write(samples, 1);
+    sink.flush();
+    sink.write(samples + 2, 1);
+    sink.flush();
+
+    EXPECT_EQ(file->size(), SPU::WavSink::c_headerSize + 8);
+    EXPECT_EQ(file->readAt<uint32_t>(40), 8);
+    EXPECT_EQ(file->readAt<uint16_t>(SPU::WavSink::c_headerSize + 4), 3);
+    EXPECT_EQ(file->readAt<uint16_t>(SPU::WavSink::c_headerSize + 6), 4);
+}
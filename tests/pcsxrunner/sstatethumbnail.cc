@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2022 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/sstate.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void setU32(uint8_t* ptr, uint32_t value) {
+    ptr[0] = value;
+    ptr[1] = value >> 8;
+    ptr[2] = value >> 16;
+    ptr[3] = value >> 24;
+}
+
+// A 320x240 15 bits NTSC display at (64, 32), red on the left half, blue on the right half.
+std::string makeState() {
+    using namespace PCSX::SaveStates;
+    SaveStatePreview state;
+    auto& gpu = state.get<GPUField>();
+    gpu.get<GPUVRam>().reset();
+    gpu.get<GPUControl>().reset();
+    uint8_t* vram = gpu.get<GPUVRam>().value;
+    for (unsigned y = 32; y < 32 + 240; y++) {
+        for (unsigned x = 64; x < 64 + 320; x++) {
+            const uint16_t color = x < 64 + 160 ? 0x001f : 0x7c00;
+            vram[y * 2048 + x * 2] = color;
+            vram[y * 2048 + x * 2 + 1] = color >> 8;
+        }
+    }
+    uint8_t* control = gpu.get<GPUControl>().value;
+    setU32(control + 5 * 4, 0x05000000 | 64 | (32 << 10));
+    setU32(control + 6 * 4, 0x06000000 | 0x260 | ((0x260 + 320 * 8) << 12));
+    setU32(control + 7 * 4, 0x07000000 | 16 | (256 << 10));
+    setU32(control + 8 * 4, 0x08000001);
+    return state.serialize();
+}
+
+}  // namespace
+
+TEST(SaveStateThumbnail, MadeOutOfVRAM) {
+    using namespace PCSX::SaveStates;
+    Thumbnail thumbnail;
+    ASSERT_TRUE(loadThumbnail(makeState(), thumbnail));
+    EXPECT_EQ(thumbnail.get<Width>().value, 160);
+    EXPECT_EQ(thumbnail.get<Height>().value, 120);
+    const auto& red = thumbnail.get<Red>().value;
+    const auto& blue = thumbnail.get<Blue>().value;
+    EXPECT_EQ(uint8_t(red[0]), 0xff);
+    EXPECT_EQ(uint8_t(blue[0]), 0);
+    EXPECT_EQ(uint8_t(red[159]), 0);
+    EXPECT_EQ(uint8_t(blue[160 * 120 - 1]), 0xff);
+}
+
+TEST(SaveStateThumbnail, AppendedToTheState) {
+    using namespace PCSX::SaveStates;
+    const std::string state = makeState();
+    const std::string serialized = makeThumbnail(state);
+    ASSERT_FALSE(serialized.empty());
+
+    // Without VRAM to fall back on, this can only come from the appended thumbnail
+    SaveStatePreview withoutVRAM;
+    withoutVRAM.get<GPUField>().get<GPUStatus>().value = 1;
+    Thumbnail thumbnail;
+    EXPECT_FALSE(loadThumbnail(withoutVRAM.serialize(), thumbnail));
+    ASSERT_TRUE(loadThumbnail(withoutVRAM.serialize() + serialized, thumbnail));
+    EXPECT_EQ(thumbnail.get<Width>().value, 160);
+    EXPECT_EQ(uint8_t(thumbnail.get<Red>().value[0]), 0xff);
+}
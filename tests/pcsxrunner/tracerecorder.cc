@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/tracerecorder.h"
+
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Step {
+    uint32_t pc;
+    uint32_t code;
+    PCSX::TraceRecorder::Registers before;
+    PCSX::TraceRecorder::Registers after;
+};
+
+// Mostly straight code, with a few jumps, stores and loads, touching a register or two at a time.
+std::vector<Step> makeSteps(unsigned count) {
+    std::mt19937 rng(0x7ace);
+    std::vector<Step> steps(count);
+    PCSX::TraceRecorder::Registers registers = {};
+    uint32_t pc = 0x80010000;
+    for (auto& step : steps) {
+        if ((rng() % 10) == 0) pc = 0x80010000 + (rng() % 0x10000) * 4;
+        step.pc = pc;
+        pc += 4;
+        switch (rng() % 4) {
+            case 0:
+                step.code = 0xac000000 | ((rng() % 32) << 21) | ((rng() % 32) << 16) | (rng() & 0xffff);  // sw
+                break;
+            case 1:
+                step.code = 0x8c000000 | ((rng() % 32) << 21) | ((rng() % 32) << 16) | (rng() & 0xffff);  // lw
+                break;
+            default:
+                step.code = rng() & 0x03ffffff;
+                break;
+        }
+        step.before = registers;
+        for (unsigned i = rng() % 3; i > 0; i--) registers[1 + rng() % 33] = rng();
+        step.after = registers;
+    }
+    return steps;
+}
+
+}  // namespace
+
+TEST(TraceRecorder, ReadsBackWhatGotRecorded) {
+    auto steps = makeSteps(200000);
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    {
+        PCSX::TraceRecorder recorder;
+        ASSERT_TRUE(recorder.start(file, steps[0].before.data()));
+        for (auto& step : steps) {
+            recorder.begin(step.pc, step.code, step.before.data(), nullptr);
+            recorder.end(step.after.data());
+        }
+        EXPECT_EQ(recorder.instructions(), steps.size());
+        recorder.stop();
+        EXPECT_FALSE(recorder.recording());
+    }
+
+    PCSX::TraceRecorder::Reader reader;
+    ASSERT_TRUE(reader.open(file));
+    ASSERT_EQ(reader.size(), steps.size());
+
+    auto check = [&](uint64_t index) {
+        PCSX::TraceRecorder::Record record;
+        PCSX::TraceRecorder::Registers registers;
+        ASSERT_TRUE(reader.read(index, record, &registers));
+        const auto& step = steps[index];
+        EXPECT_EQ(record.pc, step.pc);
+        EXPECT_EQ(record.code, step.code);
+        EXPECT_TRUE(registers == step.before);
+        const uint32_t op = step.code >> 26;
+        EXPECT_EQ(record.memory, (op == 0x2b) || (op == 0x23));
+        if (record.memory) {
+            EXPECT_EQ(record.address, step.before[(step.code >> 21) & 0x1f] + int16_t(step.code));
+            if (op == 0x2b) EXPECT_EQ(record.value, step.before[(step.code >> 16) & 0x1f]);
+        }
+        auto after = registers;
+        for (unsigned i = 0; i < record.changedCount; i++) after[record.changed[i]] = record.values[i];
+        EXPECT_TRUE(after == step.after);
+    };
+    for (uint64_t i = 0; i < steps.size(); i++) check(i);
+    std::mt19937 rng(0x5eed);
+    for (unsigned i = 0; i < 200; i++) check(rng() % steps.size());
+
+    PCSX::TraceRecorder::Record record;
+    EXPECT_FALSE(reader.read(steps.size(), record));
+}
+
+TEST(TraceRecorder, RejectsDamagedTraces) {
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    file->writeString("PCSXTRCE, but not compressed");
+    PCSX::TraceRecorder::Reader reader;
+    EXPECT_FALSE(reader.open(file));
+    EXPECT_EQ(reader.size(), 0);
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/vramdelta.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using PCSX::VRAMDelta;
+
+std::vector<uint16_t> randomVRAM(std::mt19937& rng) {
+    std::vector<uint16_t> vram(VRAMDelta::c_width * VRAMDelta::c_height);
+    for (auto& pixel : vram) pixel = rng();
+    return vram;
+}
+
+}  // namespace
+
+TEST(VRAMDelta, StartsWithKeyframe) {
+    std::mt19937 rng(0x7a3d);
+    auto vram = randomVRAM(rng);
+    VRAMDelta delta;
+    auto frame = delta.encode(vram.data(), 1);
+    EXPECT_EQ(frame.size(), 12 + 8 + vram.size() * 2);
+    EXPECT_EQ(uint8_t(frame[10]), VRAMDelta::c_keyframe);
+    std::vector<uint16_t> decoded(vram.size());
+    ASSERT_TRUE(VRAMDelta::decode(frame, decoded.data()));
+    EXPECT_EQ(decoded, vram);
+    EXPECT_TRUE(delta.encode(vram.data(), 2).empty());
+}
+
+TEST(VRAMDelta, OnlySendsChangedTiles) {
+    std::mt19937 rng(0x7a3d);
+    auto vram = randomVRAM(rng);
+    VRAMDelta delta;
+    std::vector<uint16_t> viewer(vram.size());
+    ASSERT_TRUE(VRAMDelta::decode(delta.encode(vram.data(), 1), viewer.data()));
+
+    // Two neighbouring tiles on the same band, and one far away
+    vram[20 * VRAMDelta::c_width + 100]++;
+    vram[20 * VRAMDelta::c_width + 130]++;
+    vram[500 * VRAMDelta::c_width + 1000]++;
+    auto frame = delta.encode(vram.data(), 2);
+    EXPECT_EQ(uint8_t(frame[8]), 2);
+    EXPECT_EQ(uint8_t(frame[10]), 0);
+    EXPECT_EQ(frame.size(), 12 + 2 * 8 + (128 + 64) * VRAMDelta::c_tileHeight * 2);
+    ASSERT_TRUE(VRAMDelta::decode(frame, viewer.data()));
+    EXPECT_EQ(viewer, vram);
+
+    delta.reset();
+    EXPECT_EQ(delta.encode(vram.data(), 3).size(), 12 + 8 + vram.size() * 2);
+}
+
+TEST(VRAMDelta, RejectsBrokenFrames) {
+    std::mt19937 rng(0x7a3d);
+    auto vram = randomVRAM(rng);
+    VRAMDelta delta;
+    auto frame = delta.encode(vram.data(), 1);
+    std::vector<uint16_t> viewer(vram.size());
+    EXPECT_FALSE(VRAMDelta::decode(frame.substr(0, frame.size() - 1), viewer.data()));
+    EXPECT_FALSE(VRAMDelta::decode("", viewer.data()));
+    frame[12] = 1;
+    EXPECT_FALSE(VRAMDelta::decode(frame, viewer.data()));
+}
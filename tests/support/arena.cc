@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/arena.h"
+
+#include <stdint.h>
+
+#include "gtest/gtest.h"
+
+TEST(Arena, Alignment) {
+    PCSX::Arena arena(256);
+    arena.allocate(1, 1);
+    auto ptr = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 8, 0);
+    auto big = arena.create<uint64_t>(42);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % alignof(uint64_t), 0);
+    EXPECT_EQ(*big, 42);
+}
+
+TEST(Arena, Contiguous) {
+    PCSX::Arena arena(256);
+    auto a = static_cast<uint8_t*>(arena.allocate(16, 1));
+    auto b = static_cast<uint8_t*>(arena.allocate(16, 1));
+    EXPECT_EQ(a + 16, b);
+    EXPECT_EQ(arena.used(), 32);
+    EXPECT_EQ(arena.capacity(), 256);
+}
+
+TEST(Arena, Growth) {
+    PCSX::Arena arena(256);
+    arena.allocate(200, 1);
+    arena.allocate(200, 1);
+    EXPECT_EQ(arena.capacity(), 512);
+    arena.allocate(1000, 1);
+    EXPECT_GE(arena.capacity(), 512 + 1000);
+}
+
+TEST(Arena, ResetReusesBlocks) {
+    PCSX::Arena arena(256);
+    auto first = arena.allocate(200, 1);
+    arena.allocate(200, 1);
+    const auto capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.allocate(200, 1), first);
+    arena.allocate(200, 1);
+    EXPECT_EQ(arena.capacity(), capacity);
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0);
+}
+
+TEST(Pool, ReusesDestroyedObjects) {
+    PCSX::Pool<uint64_t> pool(4);
+    auto a = pool.create(1);
+    auto b = pool.create(2);
+    EXPECT_EQ(pool.live(), 2);
+    pool.destroy(a);
+    EXPECT_EQ(pool.live(), 1);
+    auto c = pool.create(3);
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(*b, 2);
+    EXPECT_EQ(*c, 3);
+    pool.destroy(b);
+    pool.destroy(c);
+    pool.clear();
+    pool.reserve(8);
+    for (unsigned i = 0; i < 8; i++) pool.create(i);
+    EXPECT_EQ(pool.live(), 8);
+}
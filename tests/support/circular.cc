@@ -21,6 +21,8 @@
 
 #include <stdint.h>
 
+#include <thread>
+
 #include "gtest/gtest.h"
 
 TEST(DISABLED_Circular, Basic) {
@@ -57,3 +59,65 @@ TEST(DISABLED_Circular, Basic) {
         EXPECT_EQ(data[i], i + 300);
     }
 }
+
+TEST(CircularSPSC, Basic) {
+    PCSX::CircularSPSC<uint32_t> circ;
+
+    uint32_t data[800];
+
+    for (unsigned i = 0; i < 800; i++) {
+        data[i] = i;
+    }
+
+    EXPECT_TRUE(circ.enqueue(data, 800));
+    EXPECT_EQ(circ.buffered(), 800);
+    EXPECT_EQ(circ.available(), circ.BUFFER_SIZE - 800);
+    EXPECT_FALSE(circ.enqueue(data, 800, std::chrono::milliseconds{0}));
+
+    EXPECT_EQ(circ.dequeue(data, 600), 600);
+    for (unsigned i = 0; i < 600; i++) {
+        EXPECT_EQ(data[i], i);
+    }
+
+    // This one wraps around the end of the buffer
+    for (unsigned i = 0; i < 800; i++) {
+        data[i] = i + 1000;
+    }
+    EXPECT_TRUE(circ.enqueue(data, 800));
+    EXPECT_EQ(circ.buffered(), 1000);
+
+    EXPECT_EQ(circ.dequeue(data, 800), 800);
+    for (unsigned i = 0; i < 200; i++) {
+        EXPECT_EQ(data[i], i + 600);
+    }
+    for (unsigned i = 200; i < 800; i++) {
+        EXPECT_EQ(data[i], i + 800);
+    }
+    EXPECT_EQ(circ.dequeue(data, 800), 200);
+    EXPECT_EQ(circ.buffered(), 0);
+}
+
+TEST(CircularSPSC, Threaded) {
+    PCSX::CircularSPSC<uint32_t> circ;
+    constexpr uint32_t total = 1000000;
+
+    std::thread producer([&circ]() {
+        uint32_t data[100];
+        for (uint32_t sent = 0; sent < total; sent += 100) {
+            for (unsigned i = 0; i < 100; i++) data[i] = sent + i;
+            while (!circ.enqueue(data, 100)) {
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    uint32_t data[64];
+    while (expected < total) {
+        const size_t count = circ.dequeue(data, 64);
+        for (size_t i = 0; i < count; i++) ordered &= data[i] == expected++;
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(circ.buffered(), 0);
+}
@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "support/dirtypages.h"
+
+TEST(DirtyPages, StartsDirty) {
+    PCSX::DirtyPages dirty(64 * 1024);
+    EXPECT_EQ(dirty.pageCount(), 16);
+    EXPECT_EQ(dirty.pageSize(), 4096);
+    EXPECT_EQ(dirty.countDirty(), 16);
+    dirty.clear();
+    EXPECT_EQ(dirty.countDirty(), 0);
+}
+
+TEST(DirtyPages, MarkRange) {
+    PCSX::DirtyPages dirty(64 * 1024);
+    dirty.clear();
+    dirty.mark(4095);
+    dirty.markRange(4096 * 3 + 100, 4096);
+    dirty.markRange(4096 * 6, 0);
+    // Clamped to the end of the memory
+    dirty.markRange(4096 * 15 + 8, 65536);
+
+    std::vector<uint32_t> pages;
+    dirty.forEachDirty([&](uint32_t page) { pages.push_back(page); });
+    EXPECT_EQ(pages, (std::vector<uint32_t>{0, 3, 4, 15}));
+    EXPECT_TRUE(dirty.isDirty(4));
+    EXPECT_FALSE(dirty.isDirty(5));
+}
+
+TEST(DirtyPages, PartialLastPage) {
+    PCSX::DirtyPages dirty(10000, 10);
+    EXPECT_EQ(dirty.pageCount(), 10);
+    EXPECT_EQ(dirty.pageSize(), 1024);
+    dirty.clear();
+    dirty.mark(9999);
+    EXPECT_TRUE(dirty.isDirty(9));
+    EXPECT_EQ(dirty.data()[9], 1);
+    EXPECT_EQ(dirty.countDirty(), 1);
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/file.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+void checkVectored(PCSX::IO<PCSX::File> file) {
+    uint8_t a[3], b[0x100], c[5];
+    PCSX::IOVec vecs[] = {{a, sizeof(a)}, {nullptr, 0}, {b, sizeof(b)}, {c, sizeof(c)}};
+    EXPECT_EQ(file->readAtv(vecs, 4, 0x10), 3 + 0x100 + 5);
+    for (unsigned i = 0; i < sizeof(a); i++) EXPECT_EQ(a[i], uint8_t((0x10 + i) * 7));
+    for (unsigned i = 0; i < sizeof(b); i++) EXPECT_EQ(b[i], uint8_t((0x13 + i) * 7));
+    for (unsigned i = 0; i < sizeof(c); i++) EXPECT_EQ(c[i], uint8_t((0x113 + i) * 7));
+    EXPECT_EQ(file->rTell(), 0);
+
+    // Short read at the end of the file.
+    EXPECT_EQ(file->readAtv(vecs, 4, file->size() - 0x10), 0x10);
+    for (unsigned i = 0; i < sizeof(a); i++) EXPECT_EQ(a[i], uint8_t((file->size() - 0x10 + i) * 7));
+    EXPECT_EQ(file->readAtv(vecs, 4, file->size()), -1);
+
+    file->rSeek(0x20, SEEK_SET);
+    EXPECT_EQ(file->readv(vecs, 4), 3 + 0x100 + 5);
+    EXPECT_EQ(file->rTell(), 0x20 + 3 + 0x100 + 5);
+    EXPECT_EQ(a[0], uint8_t(0x20 * 7));
+    EXPECT_EQ(c[4], uint8_t((0x20 + 3 + 0x100 + 4) * 7));
+
+    PCSX::Slice buffer;
+    buffer.resize(8);
+    bool called = false;
+    file->readAtAsync(std::move(buffer), 0x30, [&called](PCSX::Slice&& slice) {
+        called = true;
+        ASSERT_EQ(slice.size(), 8);
+        EXPECT_EQ(slice.data<uint8_t>()[0], uint8_t(0x30 * 7));
+        EXPECT_EQ(slice.data<uint8_t>()[7], uint8_t(0x37 * 7));
+    });
+    EXPECT_TRUE(called);
+}
+
+}  // namespace
+
+TEST(File, VectoredBufferFile) {
+    PCSX::IO<PCSX::File> file(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    for (size_t i = 0; i < 0x400; i++) file->write<uint8_t>(i * 7);
+    checkVectored(file);
+}
+
+TEST(File, VectoredPosixFile) {
+    auto path = std::filesystem::temp_directory_path() / "pcsx-file-vectored-test.bin";
+    {
+        PCSX::IO<PCSX::File> out(new PCSX::PosixFile(path, PCSX::FileOps::TRUNCATE));
+        for (size_t i = 0; i < 0x400; i++) out->write<uint8_t>(i * 7);
+    }
+    {
+        PCSX::IO<PCSX::File> file(new PCSX::PosixFile(path));
+        ASSERT_FALSE(file->failed());
+        checkVectored(file);
+    }
+    std::filesystem::remove(path);
+}
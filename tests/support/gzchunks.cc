@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright (C) 2022 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/gzchunks.h"
+
+#include <zlib.h>
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string makeData(size_t size) {
+    std::mt19937 rng(size);
+    std::string data(size, 0);
+    // Compressible, but not too much
+    for (auto& c : data) c = "abcdefgh"[rng() % 8];
+    return data;
+}
+
+std::string compress(const std::string& data, unsigned threads) {
+    PCSX::IO<PCSX::BufferFile> out(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    PCSX::GZipChunks::compress(data, out, threads);
+    return std::string(out->borrow().asStringView());
+}
+
+}  // namespace
+
+TEST(GZipChunks, RoundTrip) {
+    for (size_t size : {size_t(0), size_t(1), PCSX::GZipChunks::c_chunkSize, PCSX::GZipChunks::c_chunkSize * 5 + 17}) {
+        const std::string data = makeData(size);
+        for (unsigned threads : {1u, 3u, 0u}) {
+            const std::string compressed = compress(data, threads);
+            EXPECT_TRUE(PCSX::GZipChunks::isChunked(compressed));
+            std::string decompressed;
+            ASSERT_TRUE(PCSX::GZipChunks::decompress(compressed, decompressed, threads));
+            EXPECT_EQ(decompressed, data);
+        }
+    }
+}
+
+TEST(GZipChunks, IsStillGZip) {
+    const std::string data = makeData(PCSX::GZipChunks::c_chunkSize * 3 + 100);
+    const std::string compressed = compress(data, 0);
+
+    // Concatenated gzip members, the way gunzip reads them
+    std::string decompressed(data.size(), 0);
+    z_stream z = {};
+    inflateInit2(&z, MAX_WBITS + 16);
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    z.avail_in = compressed.size();
+    z.next_out = reinterpret_cast<Bytef*>(decompressed.data());
+    z.avail_out = decompressed.size();
+    int res;
+    while ((res = inflate(&z, Z_NO_FLUSH)) == Z_STREAM_END) {
+        if (z.avail_in == 0) break;
+        inflateReset(&z);
+    }
+    inflateEnd(&z);
+    EXPECT_EQ(res, Z_STREAM_END);
+    EXPECT_EQ(z.avail_out, 0);
+    EXPECT_EQ(decompressed, data);
+}
+
+TEST(GZipChunks, RejectsOthers) {
+    const std::string data = makeData(100000);
+    std::string legacy(compressBound(data.size()) + 32, 0);
+    z_stream z = {};
+    deflateInit2(&z, 6, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    z.avail_in = data.size();
+    z.next_out = reinterpret_cast<Bytef*>(legacy.data());
+    z.avail_out = legacy.size();
+    deflate(&z, Z_FINISH);
+    legacy.resize(z.total_out);
+    deflateEnd(&z);
+    EXPECT_FALSE(PCSX::GZipChunks::isChunked(legacy));
+    std::string out;
+    EXPECT_FALSE(PCSX::GZipChunks::decompress(legacy, out));
+
+    std::string corrupted = compress(data, 0);
+    corrupted[corrupted.size() / 2] ^= 0x55;
+    EXPECT_FALSE(PCSX::GZipChunks::decompress(corrupted, out));
+    EXPECT_FALSE(PCSX::GZipChunks::decompress(corrupted.substr(0, corrupted.size() - 1), out));
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/hashing.h"
+
+#include <zlib.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "support/md5.h"
+#include "support/sha1.h"
+
+namespace {
+
+std::string makeData(size_t size) {
+    std::mt19937 rng(size);
+    std::string data(size, 0);
+    for (auto& c : data) c = rng();
+    return data;
+}
+
+}  // namespace
+
+TEST(Hashing, CRC32MatchesZlib) {
+    auto data = makeData(100000);
+    for (size_t size : {0, 1, 15, 16, 63, 64, 65, 127, 128, 200, 4096, 99999, 100000}) {
+        for (size_t offset : {0, 1, 7}) {
+            if (offset > size) continue;
+            const auto* p = reinterpret_cast<const Bytef*>(data.data()) + offset;
+            EXPECT_EQ(PCSX::Hashing::crc32(0, p, size - offset), crc32(0, p, size - offset));
+        }
+    }
+    // Chaining works the same as zlib.
+    uint32_t crc = PCSX::Hashing::crc32(0, data.data(), 1000);
+    crc = PCSX::Hashing::crc32(crc, data.data() + 1000, data.size() - 1000);
+    EXPECT_EQ(crc, crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+}
+
+TEST(Hashing, XXH64) {
+    EXPECT_EQ(PCSX::Hashing::xxh64("", 0), 0xef46db3751d8e999);
+    auto data = makeData(1000);
+    // Every tail length goes through a different path, and all of them need to change the hash.
+    uint64_t previous = 0;
+    for (size_t size = 0; size < 100; size++) {
+        uint64_t hash = PCSX::Hashing::xxh64(data.data(), size);
+        EXPECT_NE(hash, previous);
+        EXPECT_NE(hash, PCSX::Hashing::xxh64(data.data(), size, 1));
+        previous = hash;
+    }
+}
+
+TEST(Hashing, MultiBufferMatchesScalar) {
+    std::vector<std::string> buffers;
+    for (size_t size : {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 4096, 10000}) buffers.push_back(makeData(size));
+    std::vector<std::string_view> inputs(buffers.begin(), buffers.end());
+    std::vector<PCSX::Hashing::MD5Digest> md5s(inputs.size());
+    std::vector<PCSX::Hashing::SHA1Digest> sha1s(inputs.size());
+    PCSX::Hashing::md5(inputs, md5s);
+    PCSX::Hashing::sha1(inputs, sha1s);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        PCSX::MD5 md5;
+        md5.update(inputs[i].data(), inputs[i].size());
+        PCSX::Hashing::MD5Digest md5Digest;
+        md5.finish(md5Digest.data());
+        EXPECT_EQ(md5s[i], md5Digest);
+        PCSX::SHA1 sha1;
+        sha1.update(inputs[i].data(), inputs[i].size());
+        PCSX::Hashing::SHA1Digest sha1Digest;
+        sha1.finish(sha1Digest.data());
+        EXPECT_EQ(sha1s[i], sha1Digest);
+    }
+}
@@ -20,8 +20,13 @@
 #include "support/hashtable.h"
 
 #include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "support/flathashtable.h"
 
 struct HashElement;
 typedef PCSX::Intrusive::HashTable<int, HashElement> HashTableType;
@@ -202,3 +207,74 @@ TEST(FlawedHashTable, DeleteMany) {
     hashtab.destroyAll();
     EXPECT_TRUE(hashtab.empty());
 }
+
+TEST(FlatHashTable, InsertFindErase) {
+    PCSX::FlatHashTable<uint32_t, uint32_t> table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.find(42) == table.end());
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto [it, inserted] = table.try_emplace(i * 4, i);
+        EXPECT_TRUE(inserted);
+        EXPECT_EQ(it->second, i);
+    }
+    EXPECT_EQ(table.size(), 1000);
+    EXPECT_FALSE(table.try_emplace(8, 42).second);
+    EXPECT_EQ(table[8], 2);
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto it = table.find(i * 4);
+        ASSERT_FALSE(it == table.end());
+        EXPECT_EQ(it->first, i * 4);
+        EXPECT_EQ(it->second, i);
+        EXPECT_FALSE(table.contains(i * 4 + 1));
+    }
+    for (uint32_t i = 0; i < 1000; i += 2) EXPECT_EQ(table.erase(i * 4), 1);
+    EXPECT_EQ(table.erase(0), 0);
+    EXPECT_EQ(table.size(), 500);
+    for (uint32_t i = 0; i < 1000; i++) EXPECT_EQ(table.contains(i * 4), (i & 1) == 1);
+
+    uint64_t sum = 0;
+    for (auto& [key, value] : table) sum += value;
+    EXPECT_EQ(sum, 500 * 500);
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.begin() == table.end());
+}
+
+TEST(FlatHashTable, Churn) {
+    // Lots of inserts and erases, to go through tombstones and rehashes, checked against std::unordered_map.
+    PCSX::FlatHashTable<uint32_t, std::string> table;
+    std::unordered_map<uint32_t, std::string> reference;
+    std::mt19937 rng(0xf1a7);
+    for (unsigned i = 0; i < 100000; i++) {
+        uint32_t key = rng() % 2048;
+        if (rng() % 3) {
+            table[key] = std::to_string(i);
+            reference[key] = std::to_string(i);
+        } else {
+            EXPECT_EQ(table.erase(key), reference.erase(key));
+        }
+    }
+    EXPECT_EQ(table.size(), reference.size());
+    for (auto& [key, value] : reference) {
+        auto it = table.find(key);
+        ASSERT_FALSE(it == table.end());
+        EXPECT_EQ(it->second, value);
+    }
+    size_t count = 0;
+    for (auto it = table.begin(); it != table.end();) {
+        EXPECT_TRUE(reference.contains(it->first));
+        it = (count++ & 1) ? table.erase(it) : ++it;
+    }
+    EXPECT_EQ(count, reference.size());
+    EXPECT_EQ(table.size(), reference.size() - reference.size() / 2);
+}
+
+TEST(FlatHashTable, FlawedHash) {
+    PCSX::FlatHashTable<int, int, FlawedHash> table;
+    for (int i = 0; i < 256; i++) table[i] = i;
+    EXPECT_EQ(table.size(), 256);
+    for (int i = 0; i < 256; i++) EXPECT_EQ(table.find(i)->second, i);
+    for (int i = 0; i < 256; i += 2) table.erase(i);
+    for (int i = 0; i < 256; i++) EXPECT_EQ(table.contains(i), (i & 1) == 1);
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/logstore.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(LogStore, KeepsOrderAcrossChannels) {
+    PCSX::LogStore store(2);
+    store.append(0, "a0");
+    store.append(1, "b0");
+    store.append(0, "a1");
+    ASSERT_EQ(store.size(), 3);
+    EXPECT_EQ(store[0], "a0");
+    EXPECT_EQ(store[1], "b0");
+    EXPECT_EQ(store[2], "a1");
+
+    store.setVisible(0, false);
+    ASSERT_EQ(store.size(), 1);
+    EXPECT_EQ(store[0], "b0");
+    store.append(0, "a2");
+    EXPECT_EQ(store.size(), 1);
+
+    store.setVisible(0, true);
+    ASSERT_EQ(store.size(), 4);
+    EXPECT_EQ(store[1], "b0");
+    EXPECT_EQ(store[3], "a2");
+}
+
+TEST(LogStore, DropsOldestChunks) {
+    PCSX::LogStore store(2, 4, 2);
+    store.append(1, "other");
+    for (unsigned i = 0; i < 20; i++) store.append(0, std::to_string(i));
+    EXPECT_EQ(store.lines(0), 8);
+    EXPECT_EQ(store.lines(1), 1);
+    ASSERT_EQ(store.size(), 9);
+    EXPECT_EQ(store[0], "other");
+    EXPECT_EQ(store[1], "12");
+    EXPECT_EQ(store[8], "19");
+
+    store.clear();
+    EXPECT_EQ(store.size(), 0);
+    EXPECT_EQ(store.lines(0), 0);
+}
+
+TEST(LogStore, InternsRepeatedLines) {
+    PCSX::LogStore store(1, 16, 1);
+    for (unsigned i = 0; i < 10; i++) store.append(0, "KernelCall B0:17:ReturnFromException()");
+    store.append(0, "different");
+    EXPECT_EQ(store.textSize(), std::string("KernelCall B0:17:ReturnFromException()different").size());
+    EXPECT_EQ(store[9], "KernelCall B0:17:ReturnFromException()");
+    EXPECT_EQ(store[10], "different");
+}
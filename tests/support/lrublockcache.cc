@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "support/lrublockcache.h"
+
+namespace {
+
+constexpr size_t c_blockSize = 4096;
+
+struct Source {
+    Source(size_t size) : data(size) {
+        for (size_t i = 0; i < size; i++) data[i] = i * 13 + (i >> 8);
+    }
+    PCSX::LRUBlockCache::Fetcher fetcher() {
+        return [this](uint64_t offset, uint8_t* dest, size_t size) -> ssize_t {
+            fetches++;
+            memcpy(dest, data.data() + offset, size);
+            return size;
+        };
+    }
+    std::vector<uint8_t> data;
+    unsigned fetches = 0;
+};
+
+}  // namespace
+
+TEST(LRUBlockCache, ReadsMatchSource) {
+    Source source(c_blockSize * 10 + 123);
+    PCSX::LRUBlockCache cache(source.data.size(), c_blockSize * 3, {}, source.fetcher(), c_blockSize);
+    std::mt19937 rng(0x1badb002);
+    std::vector<uint8_t> buffer(c_blockSize * 4);
+    for (unsigned i = 0; i < 1000; i++) {
+        size_t ptr = rng() % source.data.size();
+        size_t size = 1 + rng() % buffer.size();
+        size_t expected = std::min(size, source.data.size() - ptr);
+        ASSERT_EQ(cache.read(buffer.data(), size, ptr), ssize_t(expected));
+        ASSERT_EQ(memcmp(buffer.data(), source.data.data() + ptr, expected), 0);
+        ASSERT_LE(cache.residentBytes(), c_blockSize * 3);
+    }
+    EXPECT_EQ(cache.read(buffer.data(), 1, source.data.size()), -1);
+}
+
+TEST(LRUBlockCache, EvictsLeastRecentlyUsed) {
+    Source source(c_blockSize * 8);
+    PCSX::LRUBlockCache cache(source.data.size(), c_blockSize * 2, {}, source.fetcher(), c_blockSize);
+    uint8_t byte;
+    cache.read(&byte, 1, 0);
+    cache.read(&byte, 1, c_blockSize);
+    cache.read(&byte, 1, 0);
+    EXPECT_EQ(source.fetches, 2);
+    EXPECT_EQ(cache.hits(), 1);
+    // Block 1 is now the oldest, and makes room for block 2.
+    cache.read(&byte, 1, c_blockSize * 2);
+    cache.read(&byte, 1, 0);
+    EXPECT_EQ(source.fetches, 3);
+    cache.read(&byte, 1, c_blockSize);
+    EXPECT_EQ(source.fetches, 4);
+    EXPECT_EQ(cache.residentBytes(), c_blockSize * 2);
+}
+
+TEST(LRUBlockCache, SpillsEvictedBlocks) {
+    auto spill = std::filesystem::temp_directory_path();
+    Source source(c_blockSize * 8 + 17);
+    {
+        PCSX::LRUBlockCache cache(source.data.size(), c_blockSize, spill, source.fetcher(), c_blockSize);
+        std::vector<uint8_t> buffer(source.data.size());
+        ASSERT_EQ(cache.read(buffer.data(), buffer.size(), 0), ssize_t(buffer.size()));
+        EXPECT_EQ(source.fetches, 9);
+        std::fill(buffer.begin(), buffer.end(), 0);
+        ASSERT_EQ(cache.read(buffer.data(), buffer.size(), 0), ssize_t(buffer.size()));
+        EXPECT_TRUE(buffer == source.data);
+        EXPECT_EQ(source.fetches, 9);
+        EXPECT_EQ(cache.spillHits(), 9);
+    }
+    for (auto& entry : std::filesystem::directory_iterator(spill)) {
+        EXPECT_NE(entry.path().filename().string().rfind("pcsx-blocks-", 0), 0);
+    }
+}
+
+TEST(LRUBlockCache, WritesUpdateBlocks) {
+    auto spill = std::filesystem::temp_directory_path();
+    Source source(c_blockSize * 4 + 100);
+    PCSX::LRUBlockCache cache(source.data.size(), c_blockSize, spill, source.fetcher(), c_blockSize);
+    std::vector<uint8_t> buffer(source.data.size());
+    cache.read(buffer.data(), buffer.size(), 0);
+
+    // Straddles blocks 0 and 1, one spilled and one in memory after the read above.
+    std::vector<uint8_t> patch(200, 0xaa);
+    memcpy(source.data.data() + c_blockSize - 100, patch.data(), patch.size());
+    cache.write(patch.data(), patch.size(), c_blockSize - 100);
+    // Grows the last block, which has to be fetched again.
+    source.data.resize(source.data.size() + 50, 0x55);
+    cache.write(source.data.data() + c_blockSize * 4 + 100, 50, c_blockSize * 4 + 100);
+    EXPECT_EQ(cache.size(), source.data.size());
+
+    unsigned fetches = source.fetches;
+    buffer.resize(source.data.size());
+    ASSERT_EQ(cache.read(buffer.data(), buffer.size(), 0), ssize_t(buffer.size()));
+    EXPECT_TRUE(buffer == source.data);
+    EXPECT_EQ(source.fetches, fetches + 1);
+}
+
+TEST(LRUBlockCache, FailedFetches) {
+    PCSX::LRUBlockCache cache(c_blockSize * 2, c_blockSize * 2, {},
+                              [](uint64_t offset, uint8_t* dest, size_t size) -> ssize_t {
+                                  if (offset != 0) return -1;
+                                  memset(dest, 1, size / 2);
+                                  return size / 2;
+                              },
+                              c_blockSize);
+    std::vector<uint8_t> buffer(c_blockSize * 2);
+    EXPECT_EQ(cache.read(buffer.data(), buffer.size(), 0), ssize_t(c_blockSize / 2));
+    EXPECT_EQ(cache.read(buffer.data(), buffer.size(), c_blockSize), -1);
+    // Short blocks aren't kept.
+    EXPECT_EQ(cache.residentBytes(), 0);
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "support/file.h"
+
+namespace {
+
+std::filesystem::path makeImage(const char* name, size_t size) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(path, PCSX::FileOps::TRUNCATE));
+    for (size_t i = 0; i < size; i++) out->write<uint8_t>(i * 7);
+    out->close();
+    return path;
+}
+
+}  // namespace
+
+TEST(MappedFile, ReadsLikePosixFile) {
+    auto path = makeImage("pcsx-mappedfile-test.bin", 2352 * 3 + 100);
+    PCSX::IO<PCSX::File> mapped(new PCSX::MappedFile(path));
+    PCSX::IO<PCSX::File> posix(new PCSX::PosixFile(path));
+    ASSERT_FALSE(mapped->failed());
+    EXPECT_EQ(mapped->size(), posix->size());
+
+    uint8_t expected[2352], actual[2352];
+    for (size_t sector = 0; sector < 4; sector++) {
+        auto expectedSize = posix->readAt(expected, sizeof(expected), sector * 2352);
+        auto actualSize = mapped->readAt(actual, sizeof(actual), sector * 2352);
+        ASSERT_EQ(actualSize, expectedSize);
+        EXPECT_EQ(memcmp(actual, expected, actualSize), 0);
+    }
+    EXPECT_EQ(mapped->readAt(actual, sizeof(actual), mapped->size()), -1);
+
+    mapped->rSeek(10, SEEK_SET);
+    EXPECT_EQ(mapped->byte(), uint8_t(70));
+    EXPECT_EQ(mapped->rTell(), 11);
+    mapped->rSeek(0, SEEK_END);
+    EXPECT_TRUE(mapped->eof());
+    EXPECT_EQ(mapped->getc(), -1);
+
+    PCSX::IO<PCSX::File> dup(mapped->dup());
+    EXPECT_EQ(dup->rTell(), 0);
+    EXPECT_EQ(dup->byte(), uint8_t(0));
+
+    mapped.reset();
+    posix.reset();
+    dup.reset();
+    std::filesystem::remove(path);
+}
+
+TEST(MappedFile, FailsOnMissingOrEmptyFiles) {
+    auto path = makeImage("pcsx-mappedfile-empty.bin", 0);
+    PCSX::IO<PCSX::File> empty(new PCSX::MappedFile(path));
+    EXPECT_TRUE(empty->failed());
+    empty.reset();
+    std::filesystem::remove(path);
+
+    PCSX::IO<PCSX::File> missing(new PCSX::MappedFile(path));
+    EXPECT_TRUE(missing->failed());
+}
@@ -0,0 +1,48 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(ParallelFor, ThreadCount) {
+    EXPECT_EQ(PCSX::parallelThreadCount(4, 100), 4);
+    EXPECT_EQ(PCSX::parallelThreadCount(4, 2), 2);
+    EXPECT_EQ(PCSX::parallelThreadCount(4, 0), 1);
+    EXPECT_EQ(PCSX::parallelThreadCount(0, 1000), std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+TEST(ParallelFor, RunsEachItemOnce) {
+    for (unsigned threads : {0u, 1u, 3u, 64u}) {
+        std::vector<std::atomic<unsigned>> runs(1000);
+        PCSX::parallelFor(runs.size(), threads, [&](size_t i) { runs[i]++; });
+        for (auto& count : runs) EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(ParallelFor, Empty) {
+    bool ran = false;
+    PCSX::parallelFor(0, 4, [&](size_t) { ran = true; });
+    EXPECT_FALSE(ran);
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/presentpacer.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Feeds a second worth of frames, at the given rate and with some jitter, and counts the ones presented.
+unsigned present(PCSX::PresentPacer& pacer, double fps, std::chrono::microseconds jitter = 0us) {
+    std::mt19937 rng(0x9ace);
+    const auto start = PCSX::PresentPacer::Clock::time_point() + 1h;
+    unsigned presented = 0;
+    for (unsigned frame = 0; frame < unsigned(fps); frame++) {
+        auto when = start + std::chrono::microseconds(int64_t(frame * 1000000.0 / fps));
+        if (jitter.count() != 0) {
+            when += std::chrono::microseconds(int64_t(rng() % (jitter.count() * 2)) - jitter.count());
+        }
+        if (pacer.shouldPresent(when)) presented++;
+    }
+    return presented;
+}
+
+}  // namespace
+
+TEST(PresentPacer, PresentsEverythingWithoutRefreshRate) {
+    PCSX::PresentPacer pacer;
+    EXPECT_EQ(present(pacer, 60), 60);
+    EXPECT_EQ(pacer.dropped(), 0);
+}
+
+TEST(PresentPacer, DropsWhatTheDisplayCantShow) {
+    PCSX::PresentPacer pacer;
+    pacer.setRefreshRate(50);
+    const unsigned presented = present(pacer, 60);
+    EXPECT_GE(presented, 49);
+    EXPECT_LE(presented, 51);
+    EXPECT_EQ(pacer.presented() + pacer.dropped(), 60);
+}
+
+TEST(PresentPacer, KeepsEverythingOnFasterDisplays) {
+    PCSX::PresentPacer pacer;
+    pacer.setRefreshRate(144);
+    EXPECT_EQ(present(pacer, 50), 50);
+    pacer.setRefreshRate(60);
+    EXPECT_EQ(present(pacer, 50), 50);
+}
+
+TEST(PresentPacer, ToleratesJitterAtTheSameRate) {
+    PCSX::PresentPacer pacer;
+    pacer.setRefreshRate(60);
+    EXPECT_EQ(present(pacer, 60, 2ms), 60);
+}
+
+TEST(PresentPacer, StartsOverAfterAPause) {
+    PCSX::PresentPacer pacer;
+    pacer.setRefreshRate(60);
+    const auto start = PCSX::PresentPacer::Clock::time_point() + 1h;
+    EXPECT_TRUE(pacer.shouldPresent(start));
+    EXPECT_FALSE(pacer.shouldPresent(start + 1ms));
+    EXPECT_TRUE(pacer.shouldPresent(start + 10s));
+    EXPECT_FALSE(pacer.shouldPresent(start + 10s + 1ms));
+}
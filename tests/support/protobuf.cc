@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2022 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/protobuf.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "support/typestring-wrapper.h"
+
+using namespace PCSX::Protobuf;
+
+typedef Field<UInt32, TYPESTRING("a"), 1> A;
+typedef Field<Int32, TYPESTRING("b"), 2> B;
+typedef Field<SInt32, TYPESTRING("c"), 3> C;
+typedef Field<Bytes, TYPESTRING("d"), 4> D;
+typedef Field<FixedBytes<300>, TYPESTRING("e"), 5> E;
+typedef Field<Double, TYPESTRING("f"), 6> F;
+typedef Message<TYPESTRING("Inner"), A, B, C, D, F> Inner;
+typedef MessageField<Inner, TYPESTRING("inner"), 1> InnerField;
+typedef RepeatedField<Inner, 3, TYPESTRING("inners"), 2> Inners;
+typedef RepeatedField<Int32, 5, TYPESTRING("ints"), 3> Ints;
+typedef Message<TYPESTRING("Outer"), InnerField, Inners, Ints, E> Outer;
+
+namespace {
+
+Inner makeInner(uint32_t a, int32_t b, int32_t c, const std::string& d, double f) {
+    Inner inner;
+    inner.get<A>().value = a;
+    inner.get<B>().value = b;
+    inner.get<C>().value = c;
+    inner.get<D>().value = d;
+    inner.get<F>().value = f;
+    return inner;
+}
+
+}  // namespace
+
+TEST(Protobuf, Varint) {
+    Inner inner;
+    inner.get<A>().value = 150;
+    EXPECT_EQ(inner.serializedSize(), 3);
+    EXPECT_EQ(inner.serialize(), std::string("\x08\x96\x01", 3));
+}
+
+TEST(Protobuf, NestedSizes) {
+    Outer outer;
+    outer.get<InnerField>().get<A>().value = 0xffffffff;
+    outer.get<InnerField>().get<B>().value = -1;
+    outer.get<InnerField>().get<C>().value = -300;
+    auto& inners = outer.get<Inners>().value;
+    inners[0] = makeInner(1, 2, 3, std::string(200, 'x'), 1.5);
+    inners[2] = makeInner(1000000, -5, 70000, "", 0.0);
+    auto& ints = outer.get<Ints>().value;
+    for (unsigned i = 0; i < ints.size(); i++) ints[i].value = -(int32_t)i * 1000;
+    outer.get<E>().allocate();
+    for (unsigned i = 0; i < 300; i++) outer.get<E>().value[i] = i;
+
+    const std::string data = outer.serialize();
+    EXPECT_EQ(data.size(), outer.serializedSize());
+
+    // The nested length prefixes need to be right for this to read back
+    Outer copy;
+    InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    copy.deserialize(&slice, 2);
+    EXPECT_EQ(copy.get<InnerField>().get<A>().value, 0xffffffff);
+    EXPECT_EQ(copy.get<InnerField>().get<B>().value, -1);
+    EXPECT_EQ(copy.get<InnerField>().get<C>().value, -300);
+    EXPECT_EQ(copy.get<Inners>().value[0].get<D>().value, std::string(200, 'x'));
+    EXPECT_EQ(copy.get<Inners>().value[0].get<F>().value, 1.5);
+    EXPECT_EQ(copy.get<Inners>().value[2].get<A>().value, 1000000);
+    EXPECT_EQ(copy.get<Inners>().value[2].get<C>().value, 70000);
+    EXPECT_EQ(copy.get<Ints>().value[4].value, -4000);
+    EXPECT_EQ(copy.get<E>().value[299], 299 & 0xff);
+
+    OutSlice unsized;
+    outer.serialize(&unsized);
+    EXPECT_EQ(unsized.finalize(), data);
+}
+
+TEST(Protobuf, BorrowedFixedBytes) {
+    Outer outer;
+    outer.get<E>().allocate();
+    for (unsigned i = 0; i < 300; i++) outer.get<E>().value[i] = i * 3;
+    const std::string data = outer.serialize();
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(data.data());
+
+    Outer copy;
+    InSlice copied(begin, data.size());
+    copy.deserialize(&copied, 2);
+    EXPECT_TRUE((copy.get<E>().value < begin) || (copy.get<E>().value >= begin + data.size()));
+
+    Outer borrowed;
+    InSlice slice(begin, data.size(), InSlice::BORROW);
+    borrowed.deserialize(&slice, 2);
+    EXPECT_EQ(borrowed.get<E>().value, begin + data.size() - 300);
+    EXPECT_EQ(memcmp(borrowed.get<E>().value, copy.get<E>().value, 300), 0);
+
+    // Once it needs to be written to, it gets its own copy
+    borrowed.get<E>().allocate();
+    EXPECT_NE(borrowed.get<E>().value, begin + data.size() - 300);
+    EXPECT_EQ(borrowed.get<E>().value[299], (299 * 3) & 0xff);
+    Outer moved(std::move(borrowed));
+    EXPECT_EQ(moved.get<E>().value[1], 3);
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/sha1.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(SHA1, KnownVectors) {
+    static const char* const vectors[4] = {
+        "",
+        "abc",
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+    };
+    static const uint8_t vector_results[4][20] = {
+        {0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55,
+         0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09},
+        {0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+         0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d},
+        {0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae,
+         0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1},
+        {0x50, 0xab, 0xf5, 0x70, 0x6a, 0x15, 0x09, 0x90, 0xa0, 0x8b,
+         0x2c, 0x5e, 0xa4, 0x0f, 0xa0, 0xe5, 0x85, 0x55, 0x47, 0x32},
+    };
+
+    for (int i = 0; i < 4; i++) {
+        uint8_t result[20];
+        PCSX::SHA1 sha1;
+        sha1.update(vectors[i], strlen(vectors[i]));
+        sha1.finish(result);
+        EXPECT_EQ(0, memcmp(result, vector_results[i], 20));
+    }
+}
+
+TEST(SHA1, SplitUpdates) {
+    // A million 'a', fed in uneven pieces so that the block buffering gets exercised
+    static const uint8_t expected[20] = {0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e,
+                                         0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f};
+    const std::string a(1000, 'a');
+    PCSX::SHA1 sha1;
+    for (unsigned i = 0, total = 0; total < 1000000; i++) {
+        unsigned size = std::min(1 + (i * 37) % 1000, 1000000 - total);
+        sha1.update(a.data(), size);
+        total += size;
+    }
+    uint8_t result[20];
+    sha1.finish(result);
+    EXPECT_EQ(0, memcmp(result, expected, 20));
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/spsc.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(SPSC, Basic) {
+    PCSX::SPSC<uint32_t, 16> ring;
+    std::atomic<bool> stopping = false;
+
+    uint32_t data[12];
+    for (unsigned i = 0; i < 12; i++) data[i] = i;
+
+    ring.reserve(12);
+    ring.write(data, 12);
+    EXPECT_EQ(ring.buffered(), 0);
+    ring.publish();
+    EXPECT_EQ(ring.buffered(), 12);
+    EXPECT_TRUE(ring.waitForData(stopping));
+    EXPECT_EQ(ring.peek(3), 3);
+    ring.release(8);
+
+    // This one wraps around the end of the ring
+    ring.reserve(12);
+    ring.write(data, 12);
+    ring.publish();
+    EXPECT_EQ(ring.buffered(), 16);
+
+    std::vector<uint32_t> out;
+    unsigned pieces = 0;
+    ring.read(4, 12, [&](const uint32_t *words, size_t size) {
+        pieces++;
+        out.insert(out.end(), words, words + size);
+    });
+    EXPECT_EQ(pieces, 2);
+    ASSERT_EQ(out.size(), 12);
+    for (unsigned i = 0; i < 12; i++) EXPECT_EQ(out[i], i);
+    ring.release(16);
+    EXPECT_EQ(ring.buffered(), 0);
+
+    stopping = true;
+    EXPECT_FALSE(ring.waitForData(stopping));
+}
+
+TEST(SPSC, Threaded) {
+    PCSX::SPSC<uint32_t, 64> ring;
+    std::atomic<bool> stopping = false;
+    uint64_t sum = 0;
+    uint32_t expected = 0;
+    bool ordered = true;
+
+    std::thread consumer([&]() {
+        while (ring.waitForData(stopping)) {
+            const size_t size = ring.buffered();
+            ring.read(0, size, [&](const uint32_t *words, size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    if (words[i] != expected++) ordered = false;
+                    sum += words[i];
+                }
+            });
+            ring.release(size);
+        }
+    });
+
+    uint64_t reference = 0;
+    uint32_t value = 0;
+    for (unsigned batch = 0; batch < 10000; batch++) {
+        uint32_t data[48];
+        const unsigned count = (batch * 7) % 48 + 1;
+        for (unsigned i = 0; i < count; i++) {
+            reference += value;
+            data[i] = value++;
+        }
+        ring.reserve(count);
+        ring.write(data, count);
+        ring.publish();
+        if ((batch % 1000) == 0) ring.drain();
+    }
+    ring.drain();
+    EXPECT_EQ(ring.buffered(), 0);
+
+    stopping = true;
+    ring.wakeConsumer();
+    consumer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(sum, reference);
+}
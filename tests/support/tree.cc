@@ -20,6 +20,7 @@
 #include "support/tree.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "support/hashtable.h"
@@ -285,3 +286,50 @@ TEST(IntervalTree, Fuzzy) {
 
     tree.destroyAll();
 }
+
+TEST(IntervalTree, Generation) {
+    TreeType tree;
+    auto generation = tree.generation();
+    auto e = new TreeElement(0);
+    tree.insert(10, 20, e);
+    EXPECT_NE(tree.generation(), generation);
+    generation = tree.generation();
+    delete e;
+    EXPECT_NE(tree.generation(), generation);
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(IntervalSnapshot, MatchesTree) {
+    TreeType tree;
+    uint32_t seed = SEED;
+    for (unsigned i = 0; i < 500; i++) {
+        uint32_t low = someRand(seed) % 100000;
+        uint32_t high = low + someRand(seed) % (i & 1 ? 16 : 4000);
+        tree.insert(low, high, new TreeElement(i));
+    }
+    PCSX::IntervalSnapshot<uint32_t, TreeElement> all, even;
+    all.rebuild(tree);
+    even.rebuild(tree, [](const TreeElement& e) { return (e.m_tag & 1) == 0; });
+    EXPECT_EQ(all.generation(), tree.generation());
+    EXPECT_EQ(all.size(), 500);
+    EXPECT_EQ(even.size(), 250);
+
+    for (unsigned i = 0; i < 2000; i++) {
+        uint32_t low = someRand(seed) % 110000;
+        uint32_t high = low + someRand(seed) % 8;
+        std::vector<uint32_t> expected, actual, actualEven;
+        for (auto it = tree.find(low, high); it != tree.end(); it++) expected.push_back(it->m_tag);
+        all.forEachOverlapping(low, high, [&](TreeElement* e) { actual.push_back(e->m_tag); });
+        even.forEachOverlapping(low, high, [&](TreeElement* e) { actualEven.push_back(e->m_tag); });
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(all.overlaps(low, high), !expected.empty());
+        std::erase_if(expected, [](uint32_t tag) { return tag & 1; });
+        EXPECT_EQ(actualEven, expected);
+    }
+
+    tree.destroyAll();
+    EXPECT_NE(all.generation(), tree.generation());
+    all.rebuild(tree);
+    EXPECT_TRUE(all.empty());
+    EXPECT_FALSE(all.overlaps(0, 0xffffffff));
+}
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright (C) 2024 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/zip.h"
+
+#include <zlib.h>
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "support/zfile.h"
+
+namespace {
+
+std::string makeData(size_t size) {
+    std::mt19937 rng(size);
+    std::string data(size, 0);
+    // Compressible, but not too much
+    for (auto& c : data) c = "abcdefgh"[rng() % 8];
+    return data;
+}
+
+std::string deflateRaw(const std::string& data) {
+    z_stream zstream = {};
+    deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&zstream, data.size()), 0);
+    zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zstream.avail_in = data.size();
+    zstream.next_out = reinterpret_cast<Bytef*>(out.data());
+    zstream.avail_out = out.size();
+    deflate(&zstream, Z_FINISH);
+    out.resize(zstream.total_out);
+    deflateEnd(&zstream);
+    return out;
+}
+
+// Just the local headers and the end record, which is all ZipArchive looks at.
+PCSX::IO<PCSX::File> makeZip(const std::map<std::string, std::string>& files) {
+    PCSX::IO<PCSX::File> zip(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    bool compress = false;
+    for (auto& [name, data] : files) {
+        compress = !compress;
+        std::string stored = compress ? deflateRaw(data) : data;
+        zip->write<uint32_t>(0x04034b50);
+        zip->write<uint16_t>(20);
+        zip->write<uint16_t>(0);
+        zip->write<uint16_t>(compress ? 8 : 0);
+        zip->write<uint16_t>(0);
+        zip->write<uint16_t>(0);
+        zip->write<uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size()));
+        zip->write<uint32_t>(stored.size());
+        zip->write<uint32_t>(data.size());
+        zip->write<uint16_t>(name.size());
+        zip->write<uint16_t>(0);
+        zip->writeString(name);
+        zip->writeString(stored);
+    }
+    zip->write<uint32_t>(0x06054b50);
+    zip->write<uint32_t>(0);
+    return zip;
+}
+
+}  // namespace
+
+TEST(ZIndexedReader, RandomReads) {
+    auto data = makeData(8 * 1024 * 1024);
+    auto compressed = deflateRaw(data);
+    PCSX::IO<PCSX::File> source(new PCSX::BufferFile(compressed.data(), compressed.size()));
+    auto indexed = new PCSX::ZIndexedReader(source, data.size(), 256 * 1024);
+    PCSX::IO<PCSX::File> reader(indexed);
+    EXPECT_EQ(reader->size(), data.size());
+
+    // A first pass through builds up the index.
+    PCSX::Slice all = reader->readAt(data.size(), 0);
+    ASSERT_EQ(all.size(), data.size());
+    EXPECT_EQ(all.asStringView(), data);
+    EXPECT_GT(indexed->restartPoints(), 8);
+
+    std::mt19937 rng(0x219);
+    for (unsigned i = 0; i < 200; i++) {
+        size_t offset = rng() % data.size();
+        size_t size = std::min<size_t>(rng() % 100000, data.size() - offset);
+        PCSX::Slice slice = reader->readAt(size, offset);
+        ASSERT_EQ(slice.size(), size);
+        EXPECT_EQ(slice.asStringView(), std::string_view(data).substr(offset, size));
+    }
+    EXPECT_FALSE(reader->failed());
+}
+
+TEST(ZipArchive, ExtractAll) {
+    std::map<std::string, std::string> files;
+    for (unsigned i = 0; i < 16; i++) files["dir/file" + std::to_string(i)] = makeData(i * 37000 + 1);
+    PCSX::ZipArchive archive(makeZip(files));
+    ASSERT_FALSE(archive.failed());
+
+    std::mutex lock;
+    std::map<std::string, std::string> extracted;
+    EXPECT_TRUE(archive.extractAll(
+        [&](std::string_view name, PCSX::Slice&& data) {
+            std::unique_lock<std::mutex> guard(lock);
+            extracted[std::string(name)] = std::string(data.asStringView());
+        },
+        4));
+    EXPECT_EQ(extracted, files);
+
+    for (auto& [name, data] : files) {
+        PCSX::IO<PCSX::File> file(archive.openFile(name, PCSX::ZipArchive::RANDOM_ACCESS));
+        ASSERT_FALSE(file->failed());
+        size_t offset = data.size() / 3;
+        EXPECT_EQ(file->readAt(100, offset).asStringView(), std::string_view(data).substr(offset, 100));
+        EXPECT_EQ(file->readAt(data.size(), 0).asStringView(), data);
+    }
+}
+
+TEST(ZipArchive, ExtractAllChecksCRC) {
+    PCSX::ZipArchive archive(makeZip({{"a", "hello"}, {"b", "world"}}));
+    ASSERT_FALSE(archive.failed());
+    unsigned count = 0;
+    EXPECT_TRUE(archive.extractAll([&](std::string_view, PCSX::Slice&&) { count++; }, 1));
+    EXPECT_EQ(count, 2);
+
+    // Flip a byte of the stored file.
+    auto zip = makeZip({{"a", "hello"}, {"b", "world"}});
+    PCSX::Slice contents = zip->readAt(zip->size(), 0);
+    std::string damaged(contents.asStringView());
+    auto pos = damaged.rfind("world");
+    damaged[pos] = 'W';
+    PCSX::ZipArchive damagedArchive(new PCSX::BufferFile(damaged.data(), damaged.size()));
+    count = 0;
+    EXPECT_FALSE(damagedArchive.extractAll([&](std::string_view, PCSX::Slice&&) { count++; }, 1));
+    EXPECT_EQ(count, 1);
+}
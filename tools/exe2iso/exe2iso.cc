@@ -18,6 +18,10 @@
  ***************************************************************************/
 
 #include <stdint.h>
+#include <string.h>
+
+#include <filesystem>
+#include <vector>
 
 #include "flags.h"
 #include "fmt/format.h"
@@ -95,16 +99,19 @@ https://github.com/grumpycoders/pcsx-redux/tree/main/tools/exe2iso/
     const bool oneInput = inputs.size() == 1;
     const bool pad = args.get<bool>("pad").value_or(false);
     const bool regen = args.get<bool>("regen").value_or(false);
+    const bool incremental = args.get<bool>("incremental").value_or(false);
     const auto license = args.get<std::string>("license");
     if (asksForHelp || !oneInput || !hasOutput) {
         fmt::print(R"(
-Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output.bin
+Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] [-incremental] -o output.bin
   input.ps-exe      mandatory: specify the input ps-exe file.
   -o output.bin     mandatory: name of the output file.
   -offset value     optional: move the exe data by value sectors.
   -pad              optional: pads the iso with 150 blank sectors.
   -regen            optional: generates proper ECC/EDC.
   -license file     optional: use this license file.
+  -incremental      optional: updates the output file in place if it exists, only writing the
+                    sectors which changed.
   -h                displays this help information and exit.
 )",
                    argv[0]);
@@ -118,7 +125,22 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
         return -1;
     }
     PCSX::IO<PCSX::File> licenseFile(new PCSX::FailedFile);
-    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(output.value(), PCSX::FileOps::TRUNCATE));
+    // When updating an existing image, it gets read in whole, and each sector that gets generated is only
+    // written if it's different from the one already there. Sectors don't move when the exe changes, so
+    // a new build of it usually only rewrites the sectors of the code that changed, and the one holding
+    // the directory record if its size changed.
+    PCSX::IO<PCSX::File> out;
+    std::vector<uint8_t> previous;
+    if (incremental) {
+        out.setFile(new PCSX::PosixFile(output.value(), PCSX::FileOps::READWRITE));
+        if (out->failed()) {
+            out.reset();
+        } else {
+            previous.resize(out->size());
+            out->readAt(previous.data(), previous.size(), 0);
+        }
+    }
+    if (!out) out.setFile(new PCSX::PosixFile(output.value(), PCSX::FileOps::TRUNCATE));
     if (out->failed()) {
         fmt::print("Error opening output file {}\n", output.value());
         return -1;
@@ -134,6 +156,16 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
     uint32_t exeOffset = 19 + offset;
 
     uint8_t sector[2352];
+    size_t sectors = 0;
+    size_t written = 0;
+    auto emit = [&](const uint8_t* data) {
+        const size_t position = sectors++ * 2352;
+        if (((position + 2352) <= previous.size()) && (memcmp(previous.data() + position, data, 2352) == 0)) {
+            return;
+        }
+        out->writeAt(data, 2352, position);
+        written++;
+    };
     bool wroteLicense = false;
     // Sectors 0-15 are the license. We can keep it to zeroes and it'll work most everywhere.
     if (licenseFile && !licenseFile->failed()) {
@@ -147,7 +179,7 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
                 memcpy(sector + 16, licenseData + 2336 * i, 2336);
                 makeHeader(sector, i);
                 if (regen) compute_edcecc(sector);
-                out->write(sector, sizeof(sector));
+                emit(sector);
             }
             wroteLicense = true;
         } else if (licenseData[0x24e2] == 'L') {
@@ -156,7 +188,7 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
                 memcpy(sector, licenseData + 2352 * i, 2352);
                 makeHeader(sector, i);
                 if (regen) compute_edcecc(sector);
-                out->write(sector, sizeof(sector));
+                emit(sector);
             }
             wroteLicense = true;
         } else {
@@ -168,7 +200,7 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
             memset(sector, 0, sizeof(sector));
             makeHeader(sector, i);
             if (regen) compute_edcecc(sector);
-            out->write(sector, sizeof(sector));
+            emit(sector);
         }
     }
     // The actual structure of the iso. We're only generating 3 sectors,
@@ -180,14 +212,14 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
         // necessary for the PS1 bios.
         getSector(sector + 24, i, exeSize, exeOffset);
         if (regen) compute_edcecc(sector);
-        out->write(sector, sizeof(sector));
+        emit(sector);
     }
     // Potential padding before the start of the exe.
     for (unsigned i = 19; i < exeOffset; i++) {
         memset(sector, 0, sizeof(sector));
         makeHeader(sector, i);
         if (regen) compute_edcecc(sector);
-        out->write(sector, sizeof(sector));
+        emit(sector);
     }
     unsigned LBA = exeOffset;
     // The actual exe.
@@ -196,7 +228,7 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
         makeHeader(sector, LBA++);
         file->read(sector + 24, 2048);
         if (regen) compute_edcecc(sector);
-        out->write(sector, sizeof(sector));
+        emit(sector);
     }
     if (pad) {
         // 150 sectors padding.
@@ -204,8 +236,14 @@ Usage: {} input.ps-exe [-offset value] [-pad] [-regen] [-license file] -o output
             memset(sector, 0, sizeof(sector));
             makeHeader(sector, LBA++);
             if (regen) compute_edcecc(sector);
-            out->write(sector, sizeof(sector));
+            emit(sector);
         }
     }
+    if (previous.size() > (sectors * 2352)) {
+        out->close();
+        std::error_code ec;
+        std::filesystem::resize_file(output.value(), sectors * 2352, ec);
+    }
+    if (incremental) fmt::print("{} out of {} sectors written.\n", written, sectors);
     fmt::print("Done.");
 }
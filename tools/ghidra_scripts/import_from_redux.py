@@ -0,0 +1,38 @@
+import struct
+import urllib2
+from ghidra.program.model.symbol import SourceType
+
+url = 'http://localhost:8080/api/v1/assembly/export'
+data = urllib2.urlopen(url).read()
+
+if data[0:8] != 'PCSXSYMX':
+    raise Exception('Not a PCSX-Redux symbols export')
+version, symbol_count, frame_count, coverage_count = struct.unpack_from('<IIII', data, 8)
+if version != 1:
+    raise Exception('Unsupported export version ' + str(version))
+offset = 24
+
+st = currentProgram.getSymbolTable()
+for i in range(symbol_count):
+    address, length = struct.unpack_from('<II', data, offset)
+    name = data[offset + 8:offset + 8 + length]
+    offset += 8 + length
+    st.createLabel(toAddr(address), name, SourceType.IMPORTED)
+
+# The call frames aren't used here; skip over them.
+offset += frame_count * 20
+
+# Bookmark the start of every run of code the dynarec compiled.
+ram_base = 0x80000000
+previous = False
+for i in range(coverage_count):
+    low, high = struct.unpack_from('<II', data, offset + i * 8)
+    word = low | (high << 32)
+    for bit in range(64):
+        covered = (word >> bit) & 1 == 1
+        if covered and not previous:
+            address = toAddr(ram_base + (i * 64 + bit) * 4)
+            createBookmark(address, 'Redux coverage', 'Code executed in PCSX-Redux')
+        previous = covered
+
+print('Imported ' + str(symbol_count) + ' symbols from PCSX-Redux')
@@ -18,14 +18,21 @@
  ***************************************************************************/
 
 #include <algorithm>
+#include <array>
 #include <cctype>
-#include <memory>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include "flags.h"
 #include "fmt/format.h"
 #include "support/binstruct.h"
 #include "support/file.h"
+#include "support/parallel.h"
+#include "support/sha1.h"
 #include "support/typestring-wrapper.h"
 #include "supportpsx/adpcm.h"
 
@@ -53,48 +60,59 @@ typedef PCSX::BinStruct::Struct<TYPESTRING("ModFile"), ModTitle, ModSamples, Pos
                                 Signature>
     ModFile;
 
-int main(int argc, char** argv) {
-    CommandLine::args args(argc, argv);
-    auto output = args.get<std::string>("o");
-
-    fmt::print(R"(
-modconv by Nicolas "Pixel" Noble
-https://github.com/grumpycoders/pcsx-redux/tree/main/tools/modconv/
+namespace {
 
-)");
+struct Job {
+    std::string input;
+    std::string output;
+    std::optional<std::string> samplesFile;
+    unsigned amplification = 175;
+};
 
+// Returns false if the options don't make sense, in which case the usage gets printed.
+bool parseJob(const CommandLine::args& args, Job& job) {
     auto inputs = args.positional();
-    const bool asksForHelp = args.get<bool>("h").value_or(false);
-    const bool hasOutput = output.has_value();
-    const bool oneInput = inputs.size() == 1;
-    auto samplesFile = args.get<std::string>("s");
-    auto amplification = args.get<unsigned>("a").value_or(175);
-    if (asksForHelp || !oneInput || !hasOutput) {
-        fmt::print(R"(
-Usage: {} input.mod [-h] [-s output.smp] [-a amp] -o output.hit
-  input.mod         mandatory: specify the input mod file
-  -o output.hit     mandatory: name of the output hit file.
-  -h                displays this help information and exit.
-  -s output.smp     optional: name of the output sample file.
-  -a amplification  optional: value of sample amplification. Defaults to 175.
-
-If the -s option is specified, the .hit file will only contain the pattern data,
-and the .smp file will contain the sample data which can be loaded into the SPU
-memory separately. If the -s option is not specified, the .hit file will contain
-both the pattern and sample data.
-)",
-                   argv[0]);
-        return -1;
-    }
+    auto output = args.get<std::string>("o");
+    if ((inputs.size() != 1) || !output.has_value()) return false;
+    job.input = inputs[0];
+    job.output = output.value();
+    job.samplesFile = args.get<std::string>("s");
+    job.amplification = args.get<unsigned>("a").value_or(175);
+    return true;
+}
 
-    auto& input = inputs[0];
-    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(input));
+// A sample, as it gets fed to the encoder. Samples are keyed by their contents and by everything else which
+// changes their encoding, so that songs sharing the same instruments only get them encoded once.
+struct Sample {
+    std::vector<int16_t> pcm;
+    // The number of actual samples in pcm, which is then padded to whole blocks.
+    unsigned length = 0;
+    bool hasLoop = false;
+    unsigned loopStart = 0;
+    std::vector<uint8_t> encoded;
+};
+
+struct Song {
+    Job job;
+    ModFile modFile;
+    unsigned channels = 0;
+    PCSX::Slice patternData;
+    // Where each of the 31 samples of the song went in the list of unique samples, if it isn't empty.
+    std::array<std::optional<size_t>, 31> samples;
+    std::string report;
+    bool failed = false;
+};
+
+// Reads the header, patterns, and samples of a song, adding its samples which weren't seen yet to the list.
+bool load(Song& song, std::vector<Sample>& samples, std::map<std::string, size_t>& index) {
+    auto& job = song.job;
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(job.input));
     if (file->failed()) {
-        fmt::print("Unable to open file: {}\n", input);
-        return -1;
+        song.report = fmt::format("Unable to open file: {}\n", job.input);
+        return false;
     }
 
-    ModFile modFile;
+    auto& modFile = song.modFile;
     modFile.deserialize(file);
 
     std::string_view signature(modFile.get<Signature>().value, 4);
@@ -110,110 +128,137 @@ both the pattern and sample data.
     }
 
     if (channels == 0) {
-        fmt::print("{} doesn't have a recognized MOD file format.\n", input);
-        return -1;
+        song.report = fmt::format("{} doesn't have a recognized MOD file format.\n", job.input);
+        return false;
     }
 
     if (channels > 24) {
-        fmt::print("{} has too many channels ({}). The maximum is 24.\n", input, channels);
-        return -1;
+        song.report = fmt::format("{} has too many channels ({}). The maximum is 24.\n", job.input, channels);
+        return false;
     }
+    song.channels = channels;
 
     unsigned maxPatternID = 0;
     for (unsigned i = 0; i < 128; i++) {
         maxPatternID = std::max(maxPatternID, unsigned(modFile.get<PatternTable>()[i]));
     }
 
-    auto patternData = file->read(channels * (maxPatternID + 1) * 256);
-
-    fmt::print("Title:     {}\n", modFile.get<ModTitle>().value);
-    fmt::print("Channels:  {}\n", channels);
-    fmt::print("Positions: {}\n", modFile.get<Positions>().value);
-    fmt::print("Patterns:  {}\n", maxPatternID + 1);
-    fmt::print("Converting samples...\n");
+    song.patternData = file->read(channels * (maxPatternID + 1) * 256);
 
-    PCSX::IO<PCSX::File> encodedSamples =
-        samplesFile.has_value()
-            ? reinterpret_cast<PCSX::File*>(new PCSX::PosixFile(samplesFile.value().c_str(), PCSX::FileOps::TRUNCATE))
-            : reinterpret_cast<PCSX::File*>(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    song.report = fmt::format("\nInput file: {}\n", job.input);
+    song.report += fmt::format("Title:     {}\n", modFile.get<ModTitle>().value);
+    song.report += fmt::format("Channels:  {}\n", channels);
+    song.report += fmt::format("Positions: {}\n", modFile.get<Positions>().value);
+    song.report += fmt::format("Patterns:  {}\n", maxPatternID + 1);
 
-    constexpr uint8_t silentLoopBlock[16] = {0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-
-    std::unique_ptr<PCSX::ADPCM::Encoder> encoder(new PCSX::ADPCM::Encoder);
     for (unsigned i = 0; i < 31; i++) {
-        encoder->reset();
         auto& sample = modFile.get<ModSamples>()[i];
-        fmt::print("Sample {:2} [{:22}] - ", i + 1, sample.get<SampleName>().value);
-        auto length = sample.get<SampleLength>().value;
-        auto loopStart = sample.get<SampleLoopStart>().value;
-        auto loopLength = sample.get<SampleLoopLength>().value;
+        unsigned length = sample.get<SampleLength>().value;
+        unsigned loopStart = sample.get<SampleLoopStart>().value;
+        unsigned loopLength = sample.get<SampleLoopLength>().value;
+        if (length == 0) continue;
+        // The first two bytes of a sample are always silent, and only there for the Amiga's sake.
+        file->skip<uint16_t>();
+        auto data = file->read((length - 1) * 2);
         bool hasLoop = (loopStart > 0) && (loopLength > 1);
-        if (length == 0) {
-            fmt::print("Empty\n");
-            continue;
+
+        auto key = fmt::format("{} {} {} ", job.amplification, hasLoop, hasLoop ? loopStart : 0);
+        PCSX::SHA1 sha1;
+        sha1.update(key.data(), key.size());
+        sha1.update(data);
+        uint8_t digest[20];
+        sha1.finish(digest);
+        std::string hash(reinterpret_cast<const char*>(digest), 20);
+        auto [it, inserted] = index.try_emplace(hash, samples.size());
+        song.samples[i] = it->second;
+        if (!inserted) continue;
+
+        Sample& s = samples.emplace_back();
+        s.length = data.size();
+        s.hasLoop = hasLoop;
+        s.loopStart = loopStart * 2;
+        s.pcm.resize((s.length + 27) / 28 * 28);
+        auto bytes = reinterpret_cast<const int8_t*>(data.data());
+        for (unsigned j = 0; j < s.length; j++) {
+            s.pcm[j] = int16_t(bytes[j]) * job.amplification;
         }
-        int16_t input[28];
-        uint8_t spuBlock[16];
-        file->skip<uint16_t>();
-        length--;
-        length *= 2;
-        unsigned position = 2;
-        loopStart *= 2;
-        unsigned loopEnd = loopStart + loopLength * 2;
-        unsigned encodedLength = 0;
-        while (length >= 28) {
-            for (unsigned j = 0; j < 28; j++) {
-                input[j] = int16_t(file->read<int8_t>()) * amplification;
-            }
-            length -= 28;
-            encoder->processSPUBlock(input, spuBlock, PCSX::ADPCM::Encoder::BlockAttribute::OneShot);
-            uint8_t blockAttribute = 0;
-            if (length == 0) {
-                blockAttribute |= 1;
-            }
-            if (hasLoop && (loopStart <= position)) {
-                blockAttribute |= 2;
+    }
+
+    return true;
+}
+
+// Encodes a sample as one shot blocks, then sets their flags for the modplayer to loop it. Samples which
+// don't loop get a silent looping block appended, for the voice to idle on once they're done.
+void encode(Sample& sample) {
+    constexpr uint8_t silentLoopBlock[16] = {0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    unsigned blocks = sample.pcm.size() / 28;
+    sample.encoded.resize(blocks * 16);
+    if (blocks != 0) {
+        // The samples get encoded in parallel already, so each of them sticks to a single thread.
+        PCSX::ADPCM::BatchEncoder::Options options;
+        options.threads = 1;
+        PCSX::ADPCM::BatchEncoder::encodeSPUStream(sample.pcm.data(), sample.encoded.data(), blocks, false,
+                                                   PCSX::ADPCM::Encoder::Mode::Normal, options);
+    }
+
+    const bool partial = (sample.length % 28) != 0;
+    const unsigned loopStart = sample.loopStart;
+    unsigned position = 2;
+    for (unsigned b = 0; b < blocks; b++) {
+        const bool last = b == (blocks - 1);
+        uint8_t blockAttribute = 0;
+        if (last && partial) {
+            if (sample.hasLoop) {
+                blockAttribute = 3;
                 if (position < (loopStart + 28)) {
                     blockAttribute |= 4;
                 }
             }
-            spuBlock[1] = blockAttribute;
-            position += 28;
-            encodedSamples->write(spuBlock, 16);
-            encodedLength += 16;
-        }
-        if (length != 0) {
-            for (unsigned j = 0; j < length; j++) {
-                input[j] = int16_t(file->read<int8_t>()) * amplification;
-            }
-            for (unsigned j = length; j < 28; j++) {
-                input[j] = 0;
+        } else {
+            if (last) {
+                blockAttribute |= 1;
             }
-            encoder->processSPUBlock(input, spuBlock, PCSX::ADPCM::Encoder::BlockAttribute::OneShot);
-            uint8_t blockAttribute = 0;
-            if (hasLoop) {
-                blockAttribute = 3;
+            if (sample.hasLoop && (loopStart <= position)) {
+                blockAttribute |= 2;
                 if (position < (loopStart + 28)) {
                     blockAttribute |= 4;
                 }
             }
-            spuBlock[1] = blockAttribute;
-            position += 28;
-            encodedSamples->write(spuBlock, 16);
-            encodedLength += 16;
         }
-        if (!hasLoop) {
-            encodedSamples->write(silentLoopBlock, 16);
-            encodedLength += 16;
+        sample.encoded[b * 16 + 1] = blockAttribute;
+        position += 28;
+    }
+    if (!sample.hasLoop) {
+        sample.encoded.insert(sample.encoded.end(), std::begin(silentLoopBlock), std::end(silentLoopBlock));
+    }
+}
+
+// Puts the encoded samples back into the song, and writes it out.
+bool write(Song& song, const std::vector<Sample>& samples) {
+    auto& job = song.job;
+    auto& modFile = song.modFile;
+
+    PCSX::IO<PCSX::File> encodedSamples(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    for (unsigned i = 0; i < 31; i++) {
+        auto& sample = modFile.get<ModSamples>()[i];
+        song.report += fmt::format("Sample {:2} [{:22}] - ", i + 1, sample.get<SampleName>().value);
+        if (!song.samples[i].has_value()) {
+            song.report += "Empty\n";
+            continue;
         }
-        fmt::print("Size {} -> {}\n", sample.get<SampleLength>().value * 2 - 2, encodedLength);
+        auto& encoded = samples[song.samples[i].value()].encoded;
+        unsigned encodedLength = encoded.size();
+        encodedSamples->write(encoded.data(), encodedLength);
+        song.report += fmt::format("Size {} -> {}\n", sample.get<SampleLength>().value * 2 - 2, encodedLength);
         sample.get<SampleLength>().value = encodedLength;
         if (encodedLength >= 65536) {
-            fmt::print("Sample too big.\n");
-            return -1;
+            song.report += "Sample too big.\n";
+            return false;
         }
     }
 
+    unsigned channels = song.channels;
     if (channels >= 10) {
         modFile.get<Signature>().value[0] = 'H';
         modFile.get<Signature>().value[1] = 'M';
@@ -235,27 +280,161 @@ both the pattern and sample data.
     constexpr unsigned spuMemory = 512 * 1024 - 0x1010;
 
     if (fullLength >= spuMemory) {
-        fmt::print("Not enough SPU memory to store all samples; {} bytes required but only {} available.\n", fullLength,
-                   spuMemory);
-        return -1;
+        song.report +=
+            fmt::format("Not enough SPU memory to store all samples; {} bytes required but only {} available.\n",
+                        fullLength, spuMemory);
+        return false;
     } else {
-        fmt::print("Used {} bytes of SPU memory, {} still available.\n", fullLength, spuMemory - fullLength);
+        song.report +=
+            fmt::format("Used {} bytes of SPU memory, {} still available.\n", fullLength, spuMemory - fullLength);
     }
 
-    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(output.value().c_str(), PCSX::FileOps::TRUNCATE));
+    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(job.output.c_str(), PCSX::FileOps::TRUNCATE));
     modFile.serialize(out);
-    out->write(std::move(patternData));
-    if (!samplesFile.has_value()) {
+    out->write(std::move(song.patternData));
+    if (job.samplesFile.has_value()) {
+        PCSX::IO<PCSX::File> smp(new PCSX::PosixFile(job.samplesFile.value().c_str(), PCSX::FileOps::TRUNCATE));
+        smp->write(std::move(encodedSamples.asA<PCSX::BufferFile>()->borrow()));
+        smp->close();
+    } else {
         out->write(std::move(encodedSamples.asA<PCSX::BufferFile>()->borrow()));
     }
 
     out->close();
     encodedSamples->close();
-    if (samplesFile.has_value()) {
-        fmt::print("All done, files {} and {} written out.\n", output.value(), args.get<std::string>("s").value());
-    } else {
-        fmt::print("All done, file {} written out.\n", output.value());
+    return true;
+}
+
+// Splits a manifest line into arguments, the same way a shell would with plain words and double quotes.
+std::vector<std::string> splitLine(const std::string& line) {
+    std::vector<std::string> words;
+    std::string word;
+    bool inWord = false;
+    bool quoted = false;
+    for (auto c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            inWord = true;
+        } else if (!quoted && ((c == ' ') || (c == '\t') || (c == '\r'))) {
+            if (inWord) words.push_back(std::move(word));
+            word.clear();
+            inWord = false;
+        } else {
+            word += c;
+            inWord = true;
+        }
+    }
+    if (inWord) words.push_back(std::move(word));
+    return words;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    CommandLine::args args(argc, argv);
+
+    fmt::print(R"(
+modconv by Nicolas "Pixel" Noble
+https://github.com/grumpycoders/pcsx-redux/tree/main/tools/modconv/
+
+)");
+
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    auto manifest = args.get<std::string>("manifest");
+    unsigned threads = std::stoul(args.get<std::string>("j").value_or("0"), nullptr, 0);
+
+    std::vector<Job> jobs;
+    bool valid = !asksForHelp;
+    if (valid && manifest.has_value()) {
+        std::ifstream in(manifest.value());
+        if (!in) {
+            fmt::print("Unable to open manifest: {}\n", manifest.value());
+            return -1;
+        }
+        std::string line;
+        unsigned lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            auto words = splitLine(line);
+            if (words.empty() || (words[0][0] == '#')) continue;
+            std::vector<char*> argvLine;
+            argvLine.push_back(argv[0]);
+            for (auto& word : words) argvLine.push_back(word.data());
+            CommandLine::args lineArgs(argvLine.size(), argvLine.data());
+            Job job;
+            if (!parseJob(lineArgs, job)) {
+                fmt::print("{}:{}: invalid line.\n", manifest.value(), lineNumber);
+                valid = false;
+                break;
+            }
+            jobs.push_back(std::move(job));
+        }
+    } else if (valid) {
+        Job job;
+        valid = parseJob(args, job);
+        jobs.push_back(std::move(job));
+    }
+
+    if (!valid) {
+        fmt::print(R"(
+Usage: {} input.mod [-h] [-s output.smp] [-a amp] [-j threads] -o output.hit
+       {} -manifest songs.txt [-j threads]
+  input.mod         mandatory: specify the input mod file
+  -o output.hit     mandatory: name of the output hit file.
+  -h                displays this help information and exit.
+  -s output.smp     optional: name of the output sample file.
+  -a amplification  optional: value of sample amplification. Defaults to 175.
+  -manifest file    optional: converts the songs listed in this file, one per line, each line having
+                    the input file, the -o option, and the -s and -a options if needed, same as on the
+                    command line. Empty lines and lines starting with # are ignored.
+  -j threads        optional: how many samples to encode at the same time, one per core by default.
+
+If the -s option is specified, the .hit file will only contain the pattern data,
+and the .smp file will contain the sample data which can be loaded into the SPU
+memory separately. If the -s option is not specified, the .hit file will contain
+both the pattern and sample data.
+
+Samples which are identical between songs, and amplified the same way, only get
+encoded once.
+)",
+                   argv[0], argv[0]);
+        return -1;
+    }
+
+    // All of the songs get loaded first, so that the samples they share can be told apart, and then all
+    // of the unique samples get encoded at once.
+    std::vector<Song> songs(jobs.size());
+    std::vector<Sample> samples;
+    std::map<std::string, size_t> index;
+    unsigned totalSamples = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        songs[i].job = std::move(jobs[i]);
+        songs[i].failed = !load(songs[i], samples, index);
+        for (auto& sample : songs[i].samples) {
+            if (sample.has_value()) totalSamples++;
+        }
+    }
+
+    fmt::print("Converting {} samples...\n", samples.size());
+    PCSX::parallelFor(samples.size(), threads, [&](size_t i) { encode(samples[i]); });
+
+    bool failed = false;
+    for (auto& song : songs) {
+        if (!song.failed) song.failed = !write(song, samples);
+        fmt::print("{}", song.report);
+        if (song.failed) {
+            failed = true;
+        } else if (song.job.samplesFile.has_value()) {
+            fmt::print("Files {} and {} written out.\n", song.job.output, song.job.samplesFile.value());
+        } else {
+            fmt::print("File {} written out.\n", song.job.output);
+        }
+    }
+    if (failed) return -1;
+    if (totalSamples != samples.size()) {
+        fmt::print("\n{} samples were shared, and only encoded once.\n", totalSamples - samples.size());
     }
+    fmt::print("\nAll done, {} {} converted.\n", songs.size(), songs.size() == 1 ? "song" : "songs");
 
     return 0;
 }
@@ -19,38 +19,226 @@
 
 #include "supportpsx/ps1-packer.h"
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
 #include "flags.h"
 #include "fmt/format.h"
 #include "support/file.h"
 #include "support/mem4g.h"
+#include "support/parallel.h"
+#include "support/sha1.h"
 #include "supportpsx/binloader.h"
 
+namespace {
+
+// Bump this whenever the packer's output changes for the same input, so that stale cache entries get ignored.
+constexpr unsigned c_cacheVersion = 1;
+
+struct Job {
+    std::string input;
+    std::string output;
+    PCSX::PS1Packer::Options options;
+    bool stream = false;
+    uint32_t blocksize = 32768;
+    unsigned threads = 0;
+    // Everything which changes the output, besides the input file itself.
+    std::string key() const {
+        return fmt::format("{} {} {} {} {} {} {} {} {} {} {} {}", c_cacheVersion, options.tload, options.shell,
+                           options.nokernel, options.resetstack, options.nopad, options.booty, options.raw,
+                           options.rom, options.cpe, stream, blocksize);
+    }
+};
+
+// Returns false if the options don't make sense, in which case the usage gets printed.
+bool parseJob(const CommandLine::args& args, Job& job) {
+    auto inputs = args.positional();
+    auto output = args.get<std::string>("o");
+    job.options.tload = std::stoul(args.get<std::string>("tload").value_or("0"), nullptr, 0);
+    job.options.shell = args.get<bool>("shell").value_or(false);
+    job.options.nokernel = args.get<bool>("nokernel").value_or(false);
+    job.options.raw = args.get<bool>("raw").value_or(false);
+    job.options.booty = args.get<bool>("booty").value_or(false);
+    job.options.rom = args.get<bool>("rom").value_or(false);
+    job.options.cpe = args.get<bool>("cpe").value_or(false);
+    job.options.nopad = args.get<bool>("nopad").value_or(false);
+    job.stream = args.get<bool>("stream").value_or(false);
+    job.blocksize = std::stoul(args.get<std::string>("blocksize").value_or("32768"), nullptr, 0);
+    const auto& o = job.options;
+    unsigned outputTypeCount = (o.raw ? 1 : 0) + (o.booty ? 1 : 0) + (o.rom ? 1 : 0) + (o.cpe ? 1 : 0) +
+                               (job.stream ? 1 : 0);
+    if ((inputs.size() != 1) || !output.has_value() || (outputTypeCount > 1)) return false;
+    job.input = inputs[0];
+    job.output = output.value();
+    return true;
+}
+
+// Packs the input into out, and returns what to tell the user about it, or throws on errors.
+std::string pack(const Job& job, PCSX::IO<PCSX::File> file, PCSX::IO<PCSX::File> out) {
+    if (job.stream) {
+        uint32_t bufferSize = PCSX::PS1Packer::packStream(file, out, job.blocksize, job.threads);
+        return fmt::format(R"(
+Input file: {}
+file size: {} -> {}
+buffer size needed to load it: {}
+)",
+                           job.input, file->size(), out->size(), bufferSize);
+    }
+
+    PCSX::BinaryLoader::Info info;
+    PCSX::IO<PCSX::Mem4G> memory(new PCSX::Mem4G());
+    std::map<uint32_t, std::string> symbols;
+    bool success = PCSX::BinaryLoader::load(file, memory, info, symbols);
+    if (!success) throw std::runtime_error(fmt::format("Unable to load file: {}", job.input));
+    if (!info.pc.has_value()) throw std::runtime_error(fmt::format("File {} is invalid.", job.input));
+
+    PCSX::PS1Packer::pack(new PCSX::SubFile(memory, memory->lowestAddress(), memory->actualSize()), out,
+                          memory->lowestAddress(), info.pc.value_or(0), info.gp.value_or(0), info.sp.value_or(0),
+                          job.options);
+
+    return fmt::format(R"(
+Input file: {}
+pc: 0x{:08x}  gp: 0x{:08x}  sp: 0x{:08x}
+file size: {} -> {}
+)",
+                       job.input, info.pc.value_or(0), info.gp.value_or(0), info.sp.value_or(0), file->size(),
+                       out->size());
+}
+
+// Runs a job, going through the cache directory if there's one: its entries are named after the hash of the
+// input file and of the options, and hold the packed output as is.
+bool run(const Job& job, const std::optional<std::filesystem::path>& cache, std::string& report) {
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(job.input));
+    if (file->failed()) {
+        report = fmt::format("Unable to open file: {}\n", job.input);
+        return false;
+    }
+
+    std::filesystem::path entry;
+    if (cache.has_value()) {
+        PCSX::SHA1 sha1;
+        auto key = job.key();
+        sha1.update(key.data(), key.size());
+        sha1.update(file->readAt(file->size(), 0));
+        uint8_t digest[20];
+        sha1.finish(digest);
+        std::string name;
+        for (auto b : digest) name += fmt::format("{:02x}", b);
+        entry = cache.value() / name;
+        PCSX::IO<PCSX::File> cached(new PCSX::PosixFile(entry));
+        if (!cached->failed()) {
+            PCSX::IO<PCSX::File> out(new PCSX::PosixFile(job.output.c_str(), PCSX::FileOps::TRUNCATE));
+            out->write(cached->readAt(cached->size(), 0));
+            report = fmt::format("\nInput file: {}\nunchanged, taken from the cache.\n", job.input);
+            return true;
+        }
+    }
+
+    PCSX::IO<PCSX::File> buffer(new PCSX::BufferFile(PCSX::FileOps::READWRITE));
+    try {
+        report = pack(job, file, buffer);
+    } catch (std::exception& e) {
+        report = fmt::format("{}\n", e.what());
+        return false;
+    }
+    auto data = buffer->readAt(buffer->size(), 0);
+    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(job.output.c_str(), PCSX::FileOps::TRUNCATE));
+    out->write(data.data(), data.size());
+    if (cache.has_value()) {
+        // Written under a temporary name first, so that a concurrent run never sees a partial entry.
+        auto temp = entry;
+        temp += fmt::format(".{}", std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            PCSX::IO<PCSX::File> cached(new PCSX::PosixFile(temp, PCSX::FileOps::TRUNCATE));
+            cached->write(data.data(), data.size());
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, entry, ec);
+        if (ec) std::filesystem::remove(temp, ec);
+    }
+    return true;
+}
+
+// Splits a manifest line into arguments, the same way a shell would with plain words and double quotes.
+std::vector<std::string> splitLine(const std::string& line) {
+    std::vector<std::string> words;
+    std::string word;
+    bool inWord = false;
+    bool quoted = false;
+    for (auto c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            inWord = true;
+        } else if (!quoted && ((c == ' ') || (c == '\t') || (c == '\r'))) {
+            if (inWord) words.push_back(std::move(word));
+            word.clear();
+            inWord = false;
+        } else {
+            word += c;
+            inWord = true;
+        }
+    }
+    if (inWord) words.push_back(std::move(word));
+    return words;
+}
+
+}  // namespace
+
 int main(int argc, char** argv) {
     CommandLine::args args(argc, argv);
-    auto output = args.get<std::string>("o");
 
     fmt::print(R"(
 ps1-packer by Nicolas "Pixel" Noble
 https://github.com/grumpycoders/pcsx-redux/tree/main/tools/ps1-packer/
 )");
 
-    auto inputs = args.positional();
     const bool asksForHelp = args.get<bool>("h").value_or(false);
-    const bool hasOutput = output.has_value();
-    const uint32_t tload = std::stoul(args.get<std::string>("tload").value_or("0"), nullptr, 0);
-    const bool oneInput = inputs.size() == 1;
-    const bool shell = args.get<bool>("shell").value_or(false);
-    const bool nokernel = args.get<bool>("nokernel").value_or(false);
-    const bool resetstack = args.get<bool>("resetstack").value_or(false);
-    const bool raw = args.get<bool>("raw").value_or(false);
-    const bool booty = args.get<bool>("booty").value_or(false);
-    const bool rom = args.get<bool>("rom").value_or(false);
-    const bool cpe = args.get<bool>("cpe").value_or(false);
-    const bool nopad = args.get<bool>("nopad").value_or(false);
-    unsigned outputTypeCount = (raw ? 1 : 0) + (booty ? 1 : 0) + (rom ? 1 : 0) + (cpe ? 1 : 0);
-    if (asksForHelp || !oneInput || !hasOutput || (outputTypeCount > 1)) {
+    auto manifest = args.get<std::string>("manifest");
+    std::optional<std::filesystem::path> cache;
+    if (auto dir = args.get<std::string>("cache"); dir.has_value()) cache = dir.value();
+    unsigned threads = std::stoul(args.get<std::string>("j").value_or("0"), nullptr, 0);
+
+    std::vector<Job> jobs;
+    bool valid = !asksForHelp;
+    if (valid && manifest.has_value()) {
+        std::ifstream in(manifest.value());
+        if (!in) {
+            fmt::print("Unable to open manifest: {}\n", manifest.value());
+            return -1;
+        }
+        std::string line;
+        unsigned lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            auto words = splitLine(line);
+            if (words.empty() || (words[0][0] == '#')) continue;
+            std::vector<char*> argvLine;
+            argvLine.push_back(argv[0]);
+            for (auto& word : words) argvLine.push_back(word.data());
+            CommandLine::args lineArgs(argvLine.size(), argvLine.data());
+            Job job;
+            if (!parseJob(lineArgs, job)) {
+                fmt::print("{}:{}: invalid line.\n", manifest.value(), lineNumber);
+                valid = false;
+                break;
+            }
+            // The files get packed in parallel already, so each of them sticks to a single thread.
+            job.threads = 1;
+            jobs.push_back(std::move(job));
+        }
+    } else if (valid) {
+        Job job;
+        valid = parseJob(args, job);
+        job.threads = threads;
+        jobs.push_back(std::move(job));
+    }
+
+    if (!valid) {
         fmt::print(R"(
-Usage: {} input.ps-exe [-h] [-tload addr] [-shell] [-nokernel] [-resetstack] [-raw | -booty | -rom | -cpe] -o output.ps-exe
+Usage: {} input.ps-exe [-h] [-tload addr] [-shell] [-nokernel] [-resetstack] [-raw | -booty | -rom | -cpe | -stream] -o output.ps-exe
+       {} -manifest jobs.txt [-j threads] [-cache directory]
   input.ps-exe      mandatory: specify the input binary file.
   -o output.ps-exe  mandatory: name of the output file.
   -h                displays this help information and exit.
@@ -65,8 +253,21 @@ These options control the output format, and are mutually exclusive:
   -booty            outputs a counter-booty payload.
   -rom              outputs a bootable rom, which can be used in a cheat cart.
   -cpe              outputs a CPE file instead of a ps-exe one.
+  -stream           outputs a block compressed stream of the input file, taken as raw data, which
+                    psyqo's CompressedStreamLoader can decompress while it is being read from the CD.
+                    The other options don't apply to it, except for:
+  -blocksize size   the size of the blocks of the stream, 32768 by default.
 If none of these options is provided, a ps-exe file will be emitted by default.
 
+These options are for packing many files in one go:
+  -manifest file    packs the files listed in this file, one per line, each line having the input file,
+                    the -o option, and the other options above, same as on the command line. Empty lines
+                    and lines starting with # are ignored.
+  -j threads        how many files to pack at the same time, or how many threads to compress a stream
+                    with, one per core by default.
+  -cache directory  keeps the packed files in this directory, and reuses them when packing the same
+                    input file with the same options again.
+
 Valid input binary files can be in the following formats:
  - PS-EXE (needs the "PS-X EXE" signature)
  - ELF
@@ -74,53 +275,31 @@ Valid input binary files can be in the following formats:
  - PSF
  - MiniPSF
 )",
-                   argv[0]);
-        return -1;
-    }
-
-    auto& input = inputs[0];
-    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(input));
-    if (file->failed()) {
-        fmt::print("Unable to open file: {}\n", input);
+                   argv[0], argv[0]);
         return -1;
     }
 
-    PCSX::BinaryLoader::Info info;
-    PCSX::IO<PCSX::Mem4G> memory(new PCSX::Mem4G());
-    std::map<uint32_t, std::string> symbols;
-    bool success = PCSX::BinaryLoader::load(file, memory, info, symbols);
-    if (!success) {
-        fmt::print("Unable to load file: {}\n", input);
-        return -1;
-    }
-    if (!info.pc.has_value()) {
-        fmt::print("File {} is invalid.\n", input);
-        return -1;
+    if (cache.has_value()) {
+        std::error_code ec;
+        std::filesystem::create_directories(cache.value(), ec);
     }
 
-    PCSX::PS1Packer::Options options;
-    options.booty = booty;
-    options.raw = raw;
-    options.rom = rom;
-    options.cpe = cpe;
-    options.shell = shell;
-    options.nokernel = nokernel;
-    options.tload = tload;
-    options.nopad = nopad;
-    PCSX::IO<PCSX::File> out(new PCSX::PosixFile(output.value().c_str(), PCSX::FileOps::TRUNCATE));
-    PCSX::PS1Packer::pack(new PCSX::SubFile(memory, memory->lowestAddress(), memory->actualSize()), out,
-                          memory->lowestAddress(), info.pc.value_or(0), info.gp.value_or(0), info.sp.value_or(0),
-                          options);
-
-    fmt::print(R"(
-Input file: {}
-pc: 0x{:08x}  gp: 0x{:08x}  sp: 0x{:08x}
-file size: {} -> {}
+    // The reports are printed once everything is done, in the order of the jobs.
+    std::vector<std::string> reports(jobs.size());
+    std::vector<uint8_t> succeeded(jobs.size());
+    PCSX::parallelFor(jobs.size(), threads, [&](size_t i) { succeeded[i] = run(jobs[i], cache, reports[i]); });
 
-File {} created. All done.
-)",
-               input, info.pc.value_or(0), info.gp.value_or(0), info.sp.value_or(0), file->size(), out->size(),
-               output.value());
+    bool failed = false;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        fmt::print("{}", reports[i]);
+        if (succeeded[i]) {
+            fmt::print("\nFile {} created.{}\n", jobs[i].output, jobs.size() == 1 ? " All done." : "");
+        } else {
+            failed = true;
+        }
+    }
+    if (failed) return -1;
+    if (jobs.size() > 1) fmt::print("\n{} files packed. All done.\n", jobs.size());
 
     return 0;
 }
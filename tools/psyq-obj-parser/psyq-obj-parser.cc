@@ -19,10 +19,14 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <filesystem>
 #include <list>
 #include <map>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "elfio/elfio.hpp"
 #include "flags.h"
@@ -31,6 +35,7 @@
 #include "support/djbhash.h"
 #include "support/file.h"
 #include "support/hashtable.h"
+#include "support/parallel.h"
 #include "support/slice.h"
 #include "support/windowswrapper.h"
 
@@ -215,6 +220,8 @@ struct PsyqLnkFile {
     std::map<std::string, ELFIO::Elf_Word> localElfSymbols;
     std::map<std::string, uint32_t> functionSizes;
     std::string elfConversionError;
+    /* Silences the progress messages of the conversion, for when many files are converted at once */
+    bool quiet = false;
 
     void display();
     bool writeElf(const std::string& prefix, const std::string& out, bool abiNone, bool bigEndian);
@@ -227,6 +234,21 @@ struct PsyqLnkFile {
     }
 };
 
+/* A psyq LIB file is a list of LNK objects, each with a header naming it and listing the symbols it exports */
+struct PsyqLibFile {
+    struct Member {
+        std::string name;
+        std::vector<std::string> exports;
+        /* Where the LNK object is within the LIB file */
+        size_t offset;
+        size_t size;
+    };
+    std::vector<Member> members;
+
+    /* Only reads the directory of the library; will return nullptr on error */
+    static std::unique_ptr<PsyqLibFile> parse(PCSX::IO<PCSX::File> file, bool verbose);
+};
+
 /* The psyq LNK parser code */
 std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool verbose) {
     std::unique_ptr<PsyqLnkFile> ret = std::make_unique<PsyqLnkFile>();
@@ -378,7 +400,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint16_t symbolIndex = file->read<uint16_t>();
                 uint16_t sectionIndex = file->read<uint16_t>();
                 uint32_t offset = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("Export: id {}, section {}, offset {:08x}, name {}\n", symbolIndex, sectionIndex, offset, name);
                 Symbol* symbol = new Symbol();
                 symbol->symbolType = Symbol::Type::EXPORTED;
@@ -390,7 +412,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
             }
             case (uint8_t)PsyqOpcode::IMPORTED_SYMBOL: {
                 uint16_t symbolIndex = file->read<uint16_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("Import: id {}, name {}\n", symbolIndex, name);
                 Symbol* symbol = new Symbol();
                 symbol->symbolType = Symbol::Type::IMPORTED;
@@ -402,7 +424,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint16_t sectionIndex = file->read<uint16_t>();
                 uint16_t group = file->read<uint16_t>();
                 uint8_t alignment = file->read<uint8_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("Section: id {}, group {}, alignment {}, name {}\n", sectionIndex, group, alignment, name);
                 Section* section = new Section();
                 section->group = group;
@@ -418,7 +440,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
             case (uint8_t)PsyqOpcode::LOCAL_SYMBOL: {
                 uint16_t sectionIndex = file->read<uint16_t>();
                 uint32_t offset = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("Local: section {}, offset {}, name {}\n", sectionIndex, offset, name);
                 Symbol* symbol = new Symbol();
                 symbol->symbolType = Symbol::Type::LOCAL;
@@ -430,7 +452,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
             }
             case (uint8_t)PsyqOpcode::FILENAME: {
                 uint16_t index = file->read<uint16_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("File {}: {}\n", index, name);
                 break;
             }
@@ -452,7 +474,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint16_t symbolIndex = file->read<uint16_t>();
                 uint16_t sectionIndex = file->read<uint16_t>();
                 uint32_t size = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
 
                 Symbol* symbol = new Symbol();
                 symbol->symbolType = Symbol::Type::UNINITIALIZED;
@@ -518,7 +540,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint16_t retnPcReg = file->read<uint16_t>();
                 uint32_t mask = file->read<uint32_t>();
                 uint32_t maskOffset = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 curFunctionStart = offset;
                 vprint(
                     "FUNCTION: section {}, offset {}, _file {}, startLine {}, frameReg {}, frameSize {}, retnPcReg {}, "
@@ -555,7 +577,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint16_t _class = file->read<uint16_t>();
                 uint16_t type = file->read<uint16_t>();
                 uint32_t size = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("SECTION_DEF: section {}, value {}, _class {}, type {}, size {}\n", section, value, _class, type,
                        size);
                 break;
@@ -574,7 +596,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 }
 
                 std::string tag = readPsyqString(file);
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 vprint("SECTION_DEF2: section {}, value {}, _class {}, type {}, size {}, dims {}, tag {}, name {}\n",
                        section, value, _class, type, size, dims, tag, name);
                 break;
@@ -591,7 +613,7 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
                 uint32_t maskOffset = file->read<uint32_t>();
                 uint32_t unk1 = file->read<uint32_t>();
                 uint32_t unk2 = file->read<uint32_t>();
-                std::string name = readPsyqString(file);
+                std::string name = PsyqLnkFile::readPsyqString(file);
                 curFunctionStart = offset;
                 vprint(
                     "FUNCTION: section {}, offset {}, _file {}, startLine {}, frameReg {}, frameSize {}, retnPcReg {}, "
@@ -612,6 +634,54 @@ std::unique_ptr<PsyqLnkFile> PsyqLnkFile::parse(PCSX::IO<PCSX::File> file, bool
     return nullptr;
 }
 
+/* The psyq LIB parser code */
+std::unique_ptr<PsyqLibFile> PsyqLibFile::parse(PCSX::IO<PCSX::File> file, bool verbose) {
+    std::unique_ptr<PsyqLibFile> ret = std::make_unique<PsyqLibFile>();
+    vprint(":: Reading signature.\n");
+    std::string signature = file->readString(3);
+    if (signature != "LIB") {
+        fmt::print(stderr, "Wrong signature: {}\n", signature);
+        return nullptr;
+    }
+    vprint(" --> Signature ok.\n");
+
+    vprint(":: Reading version: ");
+    uint8_t version = file->byte();
+    vprint("{}\n", version);
+    if (version != 1) {
+        fmt::print(stderr, "Unknown version {}\n", version);
+        return nullptr;
+    }
+
+    vprint(":: Parsing directory...\n");
+    while (!file->eof()) {
+        size_t start = file->rTell();
+        Member member;
+        member.name = file->readString(8);
+        member.name.erase(member.name.find_last_not_of(' ') + 1);
+        file->read<uint32_t>();  // date
+        uint32_t headerSize = file->read<uint32_t>();
+        uint32_t size = file->read<uint32_t>();
+        vprint("  :: Member {}, {} bytes\n", member.name, size);
+        if ((headerSize > size) || (start + size > file->size())) {
+            fmt::print(stderr, "Member {} is truncated.\n", member.name);
+            return nullptr;
+        }
+        while (true) {
+            std::string name = PsyqLnkFile::readPsyqString(file);
+            if (name.empty()) break;
+            vprint("    --> Exports {}\n", name);
+            member.exports.push_back(std::move(name));
+        }
+        member.offset = start + headerSize;
+        member.size = size - headerSize;
+        ret->members.push_back(std::move(member));
+        file->rSeek(start + size, SEEK_SET);
+    }
+
+    return ret;
+}
+
 std::unique_ptr<PsyqLnkFile::Expression> PsyqLnkFile::Expression::parse(PCSX::IO<PCSX::File> file, bool verbose,
                                                                         int level) {
     std::unique_ptr<PsyqLnkFile::Expression> ret = std::make_unique<PsyqLnkFile::Expression>();
@@ -854,7 +924,7 @@ bool PsyqLnkFile::writeElf(const std::string& prefix, const std::string& out, bo
         writer.set_flags(0x1000);  // ?!
     }
 
-    fmt::print("  :: Generating sections\n");
+    if (!quiet) fmt::print("  :: Generating sections\n");
     for (auto& section : sections) {
         bool success = section.generateElfSection(this, writer);
         if (!success) return false;
@@ -872,14 +942,14 @@ bool PsyqLnkFile::writeElf(const std::string& prefix, const std::string& out, bo
 
     syma.add_symbol(stra, out.c_str(), 0, ELFIO::STB_LOCAL, ELFIO::STT_FILE, 0, ELFIO::SHN_ABS);
 
-    fmt::print("  :: Generating relocations - pass 1, local only\n");
+    if (!quiet) fmt::print("  :: Generating relocations - pass 1, local only\n");
     for (auto& section : sections) {
         bool success = section.generateElfRelocations(ElfRelocationPass::PASS1, prefix, this, writer,
                                                       sym_sec->get_index(), stra, syma);
         if (!success) return false;
     }
 
-    fmt::print("  :: Generating symbols\n");
+    if (!quiet) fmt::print("  :: Generating symbols\n");
     // Generate local symbols first
     for (auto& symbol : symbols) {
         if (symbol.symbolType == Symbol::Type::LOCAL) {
@@ -898,7 +968,7 @@ bool PsyqLnkFile::writeElf(const std::string& prefix, const std::string& out, bo
         }
     }
 
-    fmt::print("  :: Generating relocations - pass 2, globals only\n");
+    if (!quiet) fmt::print("  :: Generating relocations - pass 2, globals only\n");
     for (auto& section : sections) {
         bool success = section.generateElfRelocations(ElfRelocationPass::PASS2, prefix, this, writer,
                                                       sym_sec->get_index(), stra, syma);
@@ -913,7 +983,20 @@ bool PsyqLnkFile::writeElf(const std::string& prefix, const std::string& out, bo
     noteWriter.add_note(0x01, "pcsx-redux project", 0, 0);
     noteWriter.add_note(0x01, "https://github.com/grumpycoders/pcsx-redux", 0, 0);
 
-    writer.save(out);
+    // ELFIO seeks around a lot while saving, which flushes file streams every time, so the file gets put
+    // together in memory first, and then written out in one go.
+    std::ostringstream stream;
+    if (!writer.save(stream)) {
+        setElfConversionError("Unable to generate the ELF file");
+        return false;
+    }
+    auto data = std::move(stream).str();
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(out.c_str(), PCSX::FileOps::TRUNCATE));
+    if (file->failed()) {
+        setElfConversionError("Unable to open {} for writing", out);
+        return false;
+    }
+    file->write(data.data(), data.size());
     return true;
 }
 
@@ -1443,66 +1526,150 @@ bool PsyqLnkFile::Relocation::generateElf(ElfRelocationPass pass, const std::str
     return false;
 }
 
+namespace {
+
+/* A single LNK object to go through, either a whole input file, or a member of an input library */
+struct Job {
+    std::string name;
+    PCSX::IO<PCSX::File> file;
+    std::string output;
+};
+
+}  // namespace
+
 int main(int argc, char** argv) {
     CommandLine::args args(argc, argv);
     auto output = args.get<std::string>("o");
+    auto outputDirectory = args.get<std::string>("O");
 
     auto inputs = args.positional();
     const bool asksForHelp = args.get<bool>("h").value_or(false);
     const bool noInput = inputs.size() == 0;
     const bool hasOutput = output.has_value();
     const bool oneInput = inputs.size() == 1;
-    if (asksForHelp || noInput || (hasOutput && !oneInput)) {
+    if (asksForHelp || noInput || (hasOutput && !oneInput) || (hasOutput && outputDirectory.has_value())) {
         fmt::print(R"(
-Usage: {} input.obj [input2.obj...] [-h] [-v] [-d] [-n] [-p prefix] [-o output.o]
-  input.obj      mandatory: specify the input psyq LNK object file.
+Usage: {} input.obj [input2.obj...] [-h] [-v] [-d] [-n] [-p prefix] [-o output.o | -O directory] [-j threads]
+  input.obj      mandatory: specify the input psyq LNK object file, or psyq LIB library file.
   -h             displays this help information and exit.
   -v             turns on verbose mode for the parser.
   -d             displays the parsed input file.
   -n             use "none" ABI instead of Linux.
   -p prefix      use this prefix for local symbols.
   -o output.o    tries to dump the parsed psyq LNK file into an ELF file;
-                 can only work with a single input file.
+                 can only work with a single input object file.
+  -O directory   dumps all of the input files into ELF files in this directory, named
+                 after them; the objects of a library go into a subdirectory named
+                 after the library.
   -b             output a big-endian ELF file.
+  -j threads     how many objects to go through at the same time, one per core by
+                 default; -v and -d always go one at a time.
 )",
                    argv[0]);
         return -1;
     }
 
     bool verbose = args.get<bool>("v").value_or(false);
+    const bool display = args.get<bool>("d").value_or(false);
+    const bool abiNone = args.get<bool>("n").value_or(false);
+    const bool bigEndian = args.get<bool>("b").value_or(false);
+    const std::string prefix = args.get<std::string>("p").value_or("");
+    unsigned threads = std::stoul(args.get<std::string>("j").value_or("0"), nullptr, 0);
+    if (verbose || display) threads = 1;
 
     int ret = 0;
 
+    // The inputs are mapped in memory and parsed from there, which is a lot faster than going through the many
+    // small reads of the parser with actual file operations. The objects of a library are then parsed out of
+    // the library's memory directly, so the mappings need to stay around until everything is done.
+    std::vector<PCSX::IO<PCSX::File>> mappings;
+    std::vector<Job> jobs;
     for (auto& input : inputs) {
-        PCSX::IO<PCSX::File> file(new PCSX::PosixFile(input));
+        PCSX::IO<PCSX::MappedFile> file(new PCSX::MappedFile(input));
         if (file->failed()) {
             fmt::print(stderr, "Unable to open file: {}\n", input);
             ret = -2;
-        } else {
-            auto psyq = PsyqLnkFile::parse(file, verbose);
-            if (!psyq) {
-                ret = -3;
+            continue;
+        }
+        mappings.push_back(file);
+        auto data = const_cast<uint8_t*>(file->data());
+        std::filesystem::path path(input);
+        if (file->readString(3) != "LIB") {
+            std::string out = hasOutput ? output.value() : "";
+            if (outputDirectory.has_value()) {
+                out = (std::filesystem::path(outputDirectory.value()) / path.stem()).string() + ".o";
+            }
+            jobs.push_back({std::string(input), PCSX::IO<PCSX::File>(new PCSX::BufferFile(data, file->size())), out});
+            continue;
+        }
+        file->rSeek(0, SEEK_SET);
+        auto lib = PsyqLibFile::parse(file, verbose);
+        if (!lib) {
+            ret = -3;
+            continue;
+        }
+        if (hasOutput) {
+            fmt::print(stderr, "{} is a library, which can only be converted using -O.\n", input);
+            ret = -4;
+            continue;
+        }
+        std::filesystem::path directory;
+        if (outputDirectory.has_value()) {
+            directory = std::filesystem::path(outputDirectory.value()) / path.stem();
+            std::error_code ec;
+            std::filesystem::create_directories(directory, ec);
+        }
+        for (auto& member : lib->members) {
+            std::string out = outputDirectory.has_value() ? (directory / member.name).string() + ".o" : "";
+            jobs.push_back({fmt::format("{}({})", input, member.name),
+                            PCSX::IO<PCSX::File>(new PCSX::BufferFile(data + member.offset, member.size)), out});
+        }
+    }
+    if (outputDirectory.has_value()) {
+        std::error_code ec;
+        std::filesystem::create_directories(outputDirectory.value(), ec);
+    }
+
+    // The progress of each conversion only makes sense when they're not all going at the same time.
+    const bool quiet = PCSX::parallelThreadCount(threads, jobs.size()) > 1;
+    std::vector<int> results(jobs.size());
+    PCSX::parallelFor(jobs.size(), threads, [&](size_t i) {
+        auto& job = jobs[i];
+        auto psyq = PsyqLnkFile::parse(job.file, verbose);
+        if (!psyq) {
+            fmt::print(stderr, ":: Parsing {} failed.\n", job.name);
+            results[i] = -3;
+            return;
+        }
+        if (display) {
+            fmt::print(":: Displaying {}\n", job.name);
+            psyq->display();
+            fmt::print("\n\n\n");
+        }
+        if (job.output.empty()) return;
+        psyq->quiet = quiet;
+        if (!quiet) fmt::print(":: Converting {} to {}...\n", job.name, job.output);
+        bool success = psyq->writeElf(prefix, job.output, abiNone, bigEndian);
+        if (success) {
+            if (quiet) {
+                fmt::print(":: Converted {} to {}.\n", job.name, job.output);
             } else {
-                if (args.get<bool>("d").value_or(false)) {
-                    fmt::print(":: Displaying {}\n", input);
-                    psyq->display();
-                    fmt::print("\n\n\n");
-                }
-                if (hasOutput) {
-                    fmt::print(":: Converting {} to {}...\n", input, output.value());
-                    std::string prefix = args.get<std::string>("p").value_or("");
-                    bool success = psyq->writeElf(prefix, output.value(), args.get<bool>("n").value_or(false),
-                                                  args.get<bool>("b").value_or(false));
-                    if (success) {
-                        fmt::print(":: Conversion completed.\n");
-                    } else {
-                        fmt::print(stderr, ":: Conversion failed: {}\n", psyq->elfConversionError);
-                        ret = -4;
-                    }
-                }
+                fmt::print(":: Conversion completed.\n");
             }
+        } else {
+            fmt::print(stderr, ":: Conversion of {} failed: {}\n", job.name, psyq->elfConversionError);
+            results[i] = -4;
         }
-        file.reset();
+    });
+
+    unsigned failures = 0;
+    for (auto result : results) {
+        if (result == 0) continue;
+        failures++;
+        ret = result;
+    }
+    if (jobs.size() > 1) {
+        fmt::print(":: {} objects processed, {} failed.\n", jobs.size(), failures);
     }
 
     return ret;